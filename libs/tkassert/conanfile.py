@@ -19,7 +19,7 @@ from conan.errors import ConanInvalidConfiguration
 
 class TkassertConan(ConanFile):
     name = "tkassert"
-    version = "0.3.4"
+    version = "0.3.5"
     package_type = "library"
     license = "Apache 2"
     url = "https://github.com/CQCL/tket"
@@ -67,4 +67,4 @@ class TkassertConan(ConanFile):
         self.cpp_info.libs = ["tkassert"]
 
     def requirements(self):
-        self.requires("tklog/0.3.3@tket/stable", transitive_headers=True)
+        self.requires("tklog/0.3.4@tket/stable", transitive_headers=True)
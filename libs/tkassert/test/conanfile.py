@@ -59,5 +59,5 @@ class test_tkassertRecipe(ConanFile):
         cmake.install()
 
     def requirements(self):
-        self.requires("tkassert/0.3.4")
+        self.requires("tkassert/0.3.5")
         self.requires("catch2/3.3.2")
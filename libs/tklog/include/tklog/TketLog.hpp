@@ -17,10 +17,19 @@
 /**
  * @file
  * @brief Logging
+ *
+ * Each message is written as a single line, and lines from concurrent
+ * threads are never interleaved. Messages below the logger's level are
+ * discarded; to avoid the cost of building such messages in the first place,
+ * check \ref Logger::enabled first or use the TKET_LOG macros, which only
+ * evaluate their message if it will be written.
  */
 
+#include <atomic>
+#include <cstddef>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <string>
 
 namespace tket {
@@ -38,6 +47,10 @@ enum class LogLevel {
 class Logger {
  public:
   Logger(LogLevel level = LogLevel::Err);
+  ~Logger();
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+
   void trace(const std::string &s, std::ostream &os = std::cout);
   void debug(const std::string &s, std::ostream &os = std::cout);
   void info(const std::string &s, std::ostream &os = std::cout);
@@ -46,9 +59,56 @@ class Logger {
   void critical(const std::string &s, std::ostream &os = std::cout);
   void set_level(LogLevel lev);
 
+  /** Whether messages at level \p lev are written. */
+  bool enabled(LogLevel lev) const {
+    return level.load(std::memory_order_relaxed) <= lev;
+  }
+
+  /** Write a message at level \p lev, if that level is enabled. */
+  void log(LogLevel lev, const std::string &s, std::ostream &os = std::cout);
+
+  /**
+   * Write the concatenation of \p args, as streamed with `<<`, at level
+   * \p lev. The message is only built if that level is enabled.
+   */
+  template <typename... Args>
+  void logf(LogLevel lev, const Args &...args) {
+    if (!enabled(lev)) return;
+    std::ostringstream ss;
+    (ss << ... << args);
+    log(lev, ss.str());
+  }
+
+  /**
+   * Switch writing on a background thread on or off.
+   *
+   * When on, logging a message only formats its line and appends it to a
+   * lock-free ring buffer, from which a background thread writes it out. If
+   * the buffer is full the caller waits for space, so no message is lost and
+   * each thread's messages keep their order. Streams passed to the logger
+   * must outlive the write, which can be ensured with \ref flush.
+   *
+   * Switching off flushes the buffer. Must not be called concurrently with
+   * itself.
+   *
+   * @param async whether to write on a background thread
+   * @param capacity number of lines the buffer holds (rounded up to a power
+   *   of two); only used the first time the background thread is started
+   */
+  void set_async(bool async, std::size_t capacity = 1024);
+
+  /** Wait until every message logged so far has been written. */
+  void flush();
+
  private:
-  LogLevel level;
-  void log(const char *levstr, const std::string &s, std::ostream &os);
+  class AsyncSink;
+
+  std::atomic<LogLevel> level;
+  std::atomic<bool> async_;
+  // Created on first use and kept until the logger is destroyed, so that
+  // threads which saw async_ set can always use it.
+  std::unique_ptr<AsyncSink> sink_;
+  void write(const char *levstr, const std::string &s, std::ostream &os);
 };
 
 typedef std::shared_ptr<Logger> LogPtr_t;
@@ -57,3 +117,25 @@ typedef std::shared_ptr<Logger> LogPtr_t;
 LogPtr_t &tket_log();
 
 }  // namespace tket
+
+/**
+ * Log a message to \ref tket::tket_log at level \p lev. The message is any
+ * sequence of values joined with `<<`, and is only evaluated if the level is
+ * enabled, e.g. `TKET_LOG_DEBUG("Renamed " << a.repr() << " to " << b);`.
+ */
+#define TKET_LOG(lev, msg)                                     \
+  do {                                                         \
+    const ::tket::LogPtr_t &tket_logger_ = ::tket::tket_log(); \
+    if (tket_logger_->enabled(lev)) {                          \
+      std::ostringstream tket_log_ss_;                         \
+      tket_log_ss_ << msg;                                     \
+      tket_logger_->log(lev, tket_log_ss_.str());              \
+    }                                                          \
+  } while (0)
+
+#define TKET_LOG_TRACE(msg) TKET_LOG(::tket::LogLevel::Trace, msg)
+#define TKET_LOG_DEBUG(msg) TKET_LOG(::tket::LogLevel::Debug, msg)
+#define TKET_LOG_INFO(msg) TKET_LOG(::tket::LogLevel::Info, msg)
+#define TKET_LOG_WARN(msg) TKET_LOG(::tket::LogLevel::Warn, msg)
+#define TKET_LOG_ERROR(msg) TKET_LOG(::tket::LogLevel::Err, msg)
+#define TKET_LOG_CRITICAL(msg) TKET_LOG(::tket::LogLevel::Critical, msg)
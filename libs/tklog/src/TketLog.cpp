@@ -14,60 +14,221 @@
 
 #include "TketLog.hpp"
 
+#include <cstdint>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 namespace tket {
 
-Logger::Logger(LogLevel level) : level(level) {}
-void Logger::trace(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Trace) {
-    log("trace", s, os);
+// Serialises all output, from every logger, so that lines never interleave.
+static std::mutex &output_mutex() {
+  static std::mutex m;
+  return m;
+}
+
+static void output_line(const std::string &line, std::ostream &os) {
+  std::lock_guard<std::mutex> lock(output_mutex());
+  os << line << std::endl;
+}
+
+/**
+ * Bounded multi-producer single-consumer queue of formatted lines, drained
+ * by a background thread.
+ *
+ * Producers claim slots with a compare-and-swap on the tail and publish them
+ * by advancing the slot's sequence number (Vyukov's bounded queue), so they
+ * never take a lock.
+ */
+class Logger::AsyncSink {
+ public:
+  explicit AsyncSink(std::size_t capacity) {
+    std::size_t size = 1;
+    while (size < capacity) size <<= 1;
+    mask_ = size - 1;
+    cells_ = std::make_unique<Cell[]>(size);
+    for (std::size_t i = 0; i < size; i++) {
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    thread_ = std::thread([this] { run(); });
+  }
+
+  ~AsyncSink() {
+    stop_.store(true, std::memory_order_release);
+    wake();
+    thread_.join();
+  }
+
+  void push(std::string line, std::ostream *os) {
+    std::size_t pos = tail_.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &cells_[pos & mask_];
+      const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+      if (seq == pos) {
+        if (tail_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (seq < pos) {
+        // Full: wait for the writer to free the slot.
+        std::this_thread::yield();
+        pos = tail_.load(std::memory_order_relaxed);
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->line = std::move(line);
+    cell->os = os;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    n_pushed_.fetch_add(1, std::memory_order_release);
+    wake();
   }
+
+  void flush() {
+    const std::uint64_t target = n_pushed_.load(std::memory_order_acquire);
+    std::uint64_t written = n_written_.load(std::memory_order_acquire);
+    while (written < target) {
+      n_written_.wait(written, std::memory_order_acquire);
+      written = n_written_.load(std::memory_order_acquire);
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> seq;
+    std::string line;
+    std::ostream *os;
+  };
+
+  void wake() {
+    signal_.fetch_add(1, std::memory_order_release);
+    signal_.notify_one();
+  }
+
+  void run() {
+    std::size_t head = 0;
+    for (;;) {
+      const std::uint32_t signal = signal_.load(std::memory_order_acquire);
+      Cell &cell = cells_[head & mask_];
+      if (cell.seq.load(std::memory_order_acquire) == head + 1) {
+        output_line(cell.line, *cell.os);
+        cell.line.clear();
+        cell.seq.store(head + mask_ + 1, std::memory_order_release);
+        head++;
+        n_written_.fetch_add(1, std::memory_order_release);
+        n_written_.notify_all();
+      } else if (
+          n_pushed_.load(std::memory_order_acquire) !=
+          n_written_.load(std::memory_order_relaxed)) {
+        // A later slot is published but this one is still being filled.
+        std::this_thread::yield();
+      } else if (stop_.load(std::memory_order_acquire)) {
+        return;
+      } else {
+        signal_.wait(signal, std::memory_order_acquire);
+      }
+    }
+  }
+
+  std::unique_ptr<Cell[]> cells_;
+  std::size_t mask_;
+  std::atomic<std::size_t> tail_{0};
+  std::atomic<std::uint64_t> n_pushed_{0};
+  std::atomic<std::uint64_t> n_written_{0};
+  std::atomic<std::uint32_t> signal_{0};
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+Logger::Logger(LogLevel level) : level(level), async_(false) {}
+
+Logger::~Logger() = default;
+
+void Logger::trace(const std::string &s, std::ostream &os) {
+  log(LogLevel::Trace, s, os);
 }
 void Logger::debug(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Debug) {
-    log("debug", s, os);
-  }
+  log(LogLevel::Debug, s, os);
 }
 void Logger::info(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Info) {
-    log("info", s, os);
-  }
+  log(LogLevel::Info, s, os);
 }
 void Logger::warn(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Warn) {
-    log("warn", s, os);
-  }
+  log(LogLevel::Warn, s, os);
 }
 void Logger::error(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Err) {
-    log("error", s, os);
-  }
+  log(LogLevel::Err, s, os);
 }
 void Logger::critical(const std::string &s, std::ostream &os) {
-  if (level <= LogLevel::Critical) {
-    log("critical", s, os);
+  log(LogLevel::Critical, s, os);
+}
+
+void Logger::log(LogLevel lev, const std::string &s, std::ostream &os) {
+  if (!enabled(lev)) return;
+  switch (lev) {
+    case LogLevel::Trace:
+      write("trace", s, os);
+      break;
+    case LogLevel::Debug:
+      write("debug", s, os);
+      break;
+    case LogLevel::Info:
+      write("info", s, os);
+      break;
+    case LogLevel::Warn:
+      write("warn", s, os);
+      break;
+    case LogLevel::Err:
+      write("error", s, os);
+      break;
+    case LogLevel::Critical:
+      write("critical", s, os);
+      break;
+    case LogLevel::Off:
+      break;
   }
 }
 
-void Logger::log(const char *levstr, const std::string &s, std::ostream &os) {
-  std::tm *plt;
+void Logger::write(const char *levstr, const std::string &s, std::ostream &os) {
+  std::tm lt;
   const std::time_t t = std::time(nullptr);
 #if defined(_MSC_VER)
-  std::tm lt;
   localtime_s(&lt, &t);
-  plt = &lt;
 #else
-  plt = std::localtime(&t);
+  localtime_r(&t, &lt);
 #endif
-  os << "[" << std::put_time(plt, "%Y-%m-%d %H:%M:%S") << "]"
-     << " [tket] [" << levstr << "] " << s << std::endl;
+  std::ostringstream line;
+  line << "[" << std::put_time(&lt, "%Y-%m-%d %H:%M:%S") << "]"
+       << " [tket] [" << levstr << "] " << s;
+  if (async_.load(std::memory_order_acquire)) {
+    sink_->push(line.str(), &os);
+  } else {
+    output_line(line.str(), os);
+  }
+}
+
+void Logger::set_level(LogLevel lev) {
+  level.store(lev, std::memory_order_relaxed);
 }
 
-void Logger::set_level(LogLevel lev) { level = lev; }
+void Logger::set_async(bool async, std::size_t capacity) {
+  if (async) {
+    if (!sink_) sink_ = std::make_unique<AsyncSink>(capacity);
+    async_.store(true, std::memory_order_release);
+  } else {
+    async_.store(false, std::memory_order_release);
+    flush();
+  }
+}
+
+void Logger::flush() {
+  if (sink_) sink_->flush();
+}
 
 LogPtr_t &tket_log() {
 #ifdef ALL_LOGS
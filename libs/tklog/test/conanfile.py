@@ -59,5 +59,5 @@ class test_tklogRecipe(ConanFile):
         cmake.install()
 
     def requirements(self):
-        self.requires("tklog/0.3.3")
+        self.requires("tklog/0.3.4")
         self.requires("catch2/3.3.2")
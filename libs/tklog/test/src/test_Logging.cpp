@@ -15,7 +15,9 @@
 #include <catch2/catch_test_macros.hpp>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tklog/TketLog.hpp>
+#include <vector>
 
 namespace tket {
 
@@ -53,4 +55,67 @@ SCENARIO("Logging") {
   CHECK(s.find("(no output)") == std::string::npos);
 }
 
+SCENARIO("Deferred formatting") {
+  unsigned n_calls = 0;
+  auto expensive = [&n_calls]() {
+    n_calls++;
+    return "expensive";
+  };
+  tket_log()->set_level(LogLevel::Off);
+  TKET_LOG_CRITICAL("Test " << expensive() << " (no output).");
+  tket_log()->logf(LogLevel::Critical, "Test ", expensive(), " (no output).");
+  tket_log()->set_level(LogLevel::Err);
+  TKET_LOG_WARN("Test " << expensive() << " (no output).");
+  // The function argument of logf is evaluated, but not formatted.
+  CHECK(n_calls == 1);
+  CHECK_FALSE(tket_log()->enabled(LogLevel::Warn));
+  CHECK(tket_log()->enabled(LogLevel::Err));
+}
+
+SCENARIO("Logging from several threads") {
+  const unsigned n_threads = 4;
+  const unsigned n_messages = 200;
+  for (bool async : {false, true}) {
+    GIVEN(async ? "Asynchronous output" : "Synchronous output") {
+      std::stringstream ss;
+      Logger logger(LogLevel::Info);
+      // A small buffer, so that producers have to wait for space.
+      logger.set_async(async, 8);
+      std::vector<std::thread> threads;
+      for (unsigned t = 0; t < n_threads; t++) {
+        threads.emplace_back([&logger, &ss, t]() {
+          for (unsigned i = 0; i < n_messages; i++) {
+            logger.info(
+                "thread " + std::to_string(t) + " message " +
+                    std::to_string(i) + " end",
+                ss);
+          }
+        });
+      }
+      for (std::thread &thread : threads) thread.join();
+      logger.flush();
+      // Every line is whole, and each thread's messages are in order.
+      std::vector<int> last(n_threads, -1);
+      std::string line;
+      unsigned n_lines = 0;
+      while (std::getline(ss, line)) {
+        n_lines++;
+        const std::size_t pos = line.find("[info] thread ");
+        REQUIRE(pos != std::string::npos);
+        std::istringstream fields(line.substr(pos + 14));
+        unsigned t, i;
+        std::string word, end;
+        fields >> t >> word >> i >> end;
+        REQUIRE(t < n_threads);
+        REQUIRE(word == "message");
+        REQUIRE(end == "end");
+        REQUIRE(int(i) == last[t] + 1);
+        last[t] = i;
+      }
+      CHECK(n_lines == n_threads * n_messages);
+      logger.set_async(false);
+    }
+  }
+}
+
 }  // namespace tket
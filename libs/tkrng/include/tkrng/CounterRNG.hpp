@@ -0,0 +1,188 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace tket {
+
+/** A counter-based random number generator, for algorithms which need many
+ * independent, reproducible streams (e.g. one per thread or per task).
+ *
+ * The n-th output of a stream is a fixed function of the stream's key and n
+ * alone (the SplitMix64 output function applied to key + (n+1)*gamma), so:
+ *  - \ref split gives a new stream determined only by this stream's key and
+ *    the stream id, not by how many numbers have been drawn, so parallel
+ *    work seeded with split(task_index) gives the same results however the
+ *    tasks are scheduled;
+ *  - \ref at gives random access to any output without changing the state,
+ *    and bulk fills are simple loops which the compiler can vectorise.
+ *
+ * As with RNG, every function here is fully specified, so the results are
+ * identical across platforms and compilers. The doubles returned are exact
+ * multiples of 2^-53 made by integer operations, so they are portable too.
+ * Not suitable for cryptography!
+ */
+class CounterRNG {
+ public:
+  /**
+   * @param seed Determines the key of the initial stream.
+   */
+  explicit CounterRNG(std::uint64_t seed = 5489);
+
+  /** Returns the next 64-bit integer.
+   * @return A 64-bit unsigned integer, uniform.
+   */
+  std::uint64_t operator()() { return at(m_counter++); }
+
+  /** The output at the given position of this stream, regardless of how many
+   * numbers have been drawn so far. Calling operator() n times gives
+   * at(c), at(c+1), ..., at(c+n-1), where c is the counter beforehand.
+   * @param index Position in the stream.
+   * @return The 64-bit output at that position.
+   */
+  std::uint64_t at(std::uint64_t index) const {
+    return mix(m_key + (index + 1) * m_gamma);
+  }
+
+  /** The position of the next output of operator(). */
+  std::uint64_t get_counter() const { return m_counter; }
+
+  /** Jump to any position in the stream (and discard any cached bits).
+   * @param counter The position of the next output of operator().
+   */
+  void set_counter(std::uint64_t counter);
+
+  /**
+   * A new, statistically independent stream, determined only by this
+   * stream's key and the id: the counter and any cached bits are ignored.
+   * Different ids give different streams; splitting again is allowed.
+   * @param stream_id Identifies the new stream, e.g. a task index.
+   * @return A generator for the new stream, with counter zero.
+   */
+  CounterRNG split(std::uint64_t stream_id) const;
+
+  /**
+   * Return a random integer from 0 to N, inclusive, exactly uniformly
+   * (rejecting the few raw values which would cause bias).
+   * @param max_value The value N which is the (inclusive) maximum value
+   * which can be returned.
+   * @return A size_t from the inclusive range {0,1,2,...,N}.
+   */
+  std::size_t get_size_t(std::size_t max_value);
+
+  /**
+   * Returns a number in the inclusive interval, including the endpoints.
+   * @param min_value The smallest value (inclusive) that can be returned.
+   * @param max_value The largest value (inclusive) that can be returned.
+   * @return A size_t from the inclusive range {a, a+1, a+2, ... , b}.
+   */
+  std::size_t get_size_t(std::size_t min_value, std::size_t max_value);
+
+  /** Return true p% of the time.
+   * @param percentage The probability of returning true, expressed as
+   *  a percentage.
+   * @return A random bool, returns true with specified probability.
+   */
+  bool check_percentage(std::size_t percentage);
+
+  /** A uniform double in [0,1), taken from the top 53 bits of one output. */
+  double get_double() { return to_double(operator()()); }
+
+  /**
+   * The given number of random bits, in the lowest bits of the result.
+   * Unused bits of each 64-bit output are kept for later calls, so drawing
+   * a few bits at a time is cheap.
+   * @param number_of_bits Between 1 and 64.
+   * @return A random integer less than 2^number_of_bits.
+   */
+  std::uint64_t get_bits(unsigned number_of_bits);
+
+  /** Overwrite every element with the next outputs, in order. */
+  void fill(std::vector<std::uint64_t>& values);
+
+  /** Overwrite every element with independent fair random bits. */
+  void fill_bits(std::vector<bool>& bits);
+
+  /** Overwrite every element with a uniform double in [0,1), as from
+   * \ref get_double.
+   */
+  void fill_doubles(std::vector<double>& values);
+
+  /**
+   * Shuffle the elements uniformly at random, in O(n) time, using the
+   * Fisher-Yates algorithm. (Gives different results from RNG::do_shuffle).
+   * @param elements The vector to be shuffled randomly.
+   */
+  template <class T>
+  void do_shuffle(std::vector<T>& elements) {
+    for (std::size_t i = elements.size(); i > 1; --i) {
+      const std::size_t j = get_size_t(i - 1);
+      if (j != i - 1) {
+        std::swap(elements[i - 1], elements[j]);
+      }
+    }
+  }
+
+  /** Return a random element from the vector.
+   *  @param elements The vector to be sampled from.
+   *  @return A reference to a random element, uniform.
+   */
+  template <class T>
+  const T& get_element(const std::vector<T>& elements) {
+    if (elements.empty()) {
+      throw std::runtime_error(
+          "CounterRNG: get_element called on empty vector");
+    }
+    return elements[get_size_t(elements.size() - 1)];
+  }
+
+  /** Returns the numbers {0,1,2,...,N-1} in some random order.
+   *  @param size The size of the returned vector.
+   *  @return An interval of nonnegative numbers, starting at zero,
+   *    but rearranged randomly.
+   */
+  std::vector<std::size_t> get_permutation(std::size_t size);
+
+ private:
+  CounterRNG(std::uint64_t key, std::uint64_t gamma);
+
+  // The SplitMix64 output function, a bijection on 64-bit integers.
+  static std::uint64_t mix(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  static double to_double(std::uint64_t x) {
+    return static_cast<double>(x >> 11) * 0x1.0p-53;
+  }
+
+  std::uint64_t m_key;
+  // Always odd, so that the stream only repeats after 2^64 outputs.
+  std::uint64_t m_gamma;
+  std::uint64_t m_counter;
+
+  // Unused random bits for get_bits, in the lowest m_number_of_bits bits;
+  // the higher bits are zero.
+  std::uint64_t m_bits;
+  unsigned m_number_of_bits;
+};
+
+}  // namespace tket
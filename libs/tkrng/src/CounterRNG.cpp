@@ -0,0 +1,156 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CounterRNG.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace tket {
+
+static constexpr std::uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15;
+
+// As in SplitMix64: an odd gamma, avoiding those with too few bit
+// transitions, which give visibly poorer streams.
+static std::uint64_t make_gamma(std::uint64_t z) {
+  z = (z ^ (z >> 33)) * 0xff51afd7ed558ccd;
+  z = (z ^ (z >> 33)) * 0xc4ceb9fe1a85ec53;
+  z = (z ^ (z >> 33)) | 1;
+  if (std::popcount(z ^ (z >> 1)) < 24) {
+    z ^= 0xaaaaaaaaaaaaaaaa;
+  }
+  return z;
+}
+
+CounterRNG::CounterRNG(std::uint64_t seed)
+    : CounterRNG(mix(seed), make_gamma(seed + GOLDEN_GAMMA)) {}
+
+CounterRNG::CounterRNG(std::uint64_t key, std::uint64_t gamma)
+    : m_key(key),
+      m_gamma(gamma),
+      m_counter(0),
+      m_bits(0),
+      m_number_of_bits(0) {}
+
+void CounterRNG::set_counter(std::uint64_t counter) {
+  m_counter = counter;
+  m_bits = 0;
+  m_number_of_bits = 0;
+}
+
+CounterRNG CounterRNG::split(std::uint64_t stream_id) const {
+  // Different ids give different hashes, since mix is a bijection; the key
+  // and gamma of the child then depend on both the parent and the id.
+  const std::uint64_t hash = mix(stream_id * GOLDEN_GAMMA + m_gamma);
+  return CounterRNG(mix(m_key ^ hash), make_gamma(m_key + hash));
+}
+
+std::size_t CounterRNG::get_size_t(std::size_t max_value) {
+  if (max_value == 0) {
+    return 0;
+  }
+  if (max_value >= std::numeric_limits<std::uint64_t>::max()) {
+    return operator()();
+  }
+  const std::uint64_t range = static_cast<std::uint64_t>(max_value) + 1;
+  // Exactly 2^64 mod range values must be rejected for "x % range" to be
+  // uniform; rejecting the smallest ones makes this a single comparison.
+  // The expected number of rejections is below 1, and tiny unless the
+  // range is huge.
+  const std::uint64_t threshold = (0 - range) % range;
+  for (;;) {
+    const std::uint64_t x = operator()();
+    if (x >= threshold) {
+      return x % range;
+    }
+  }
+}
+
+std::size_t CounterRNG::get_size_t(
+    std::size_t min_value, std::size_t max_value) {
+  if (min_value > max_value) {
+    std::swap(min_value, max_value);
+  }
+  return min_value + get_size_t(max_value - min_value);
+}
+
+bool CounterRNG::check_percentage(std::size_t percentage) {
+  return get_size_t(99) < percentage;
+}
+
+std::uint64_t CounterRNG::get_bits(unsigned number_of_bits) {
+  if (number_of_bits == 0 || number_of_bits > 64) {
+    throw std::runtime_error("CounterRNG: get_bits needs 1 to 64 bits");
+  }
+  const auto mask = [](unsigned n) -> std::uint64_t {
+    return n == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+  };
+  if (number_of_bits <= m_number_of_bits) {
+    const std::uint64_t result = m_bits & mask(number_of_bits);
+    m_bits = number_of_bits == 64 ? 0 : m_bits >> number_of_bits;
+    m_number_of_bits -= number_of_bits;
+    return result;
+  }
+  // Use up the cached bits as the high bits, then take the rest from a new
+  // output, keeping what is left over.
+  const unsigned number_of_extra_bits = number_of_bits - m_number_of_bits;
+  std::uint64_t result =
+      m_number_of_bits == 0 ? 0 : m_bits << number_of_extra_bits;
+  const std::uint64_t x = operator()();
+  result |= x & mask(number_of_extra_bits);
+  m_bits = number_of_extra_bits == 64 ? 0 : x >> number_of_extra_bits;
+  m_number_of_bits = 64 - number_of_extra_bits;
+  return result;
+}
+
+void CounterRNG::fill(std::vector<std::uint64_t>& values) {
+  const std::uint64_t start = m_counter;
+  const std::size_t size = values.size();
+  for (std::size_t i = 0; i < size; ++i) {
+    values[i] = at(start + i);
+  }
+  m_counter += size;
+}
+
+void CounterRNG::fill_bits(std::vector<bool>& bits) {
+  const std::size_t size = bits.size();
+  for (std::size_t i = 0; i < size; i += 64) {
+    const std::uint64_t x = operator()();
+    const std::size_t end = std::min<std::size_t>(size, i + 64);
+    for (std::size_t j = i; j < end; ++j) {
+      bits[j] = ((x >> (j - i)) & 1) != 0;
+    }
+  }
+}
+
+void CounterRNG::fill_doubles(std::vector<double>& values) {
+  const std::uint64_t start = m_counter;
+  const std::size_t size = values.size();
+  for (std::size_t i = 0; i < size; ++i) {
+    values[i] = to_double(at(start + i));
+  }
+  m_counter += size;
+}
+
+std::vector<std::size_t> CounterRNG::get_permutation(std::size_t size) {
+  std::vector<std::size_t> numbers(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    numbers[i] = i;
+  }
+  do_shuffle(numbers);
+  return numbers;
+}
+
+}  // namespace tket
@@ -59,5 +59,5 @@ class test_tkrngRecipe(ConanFile):
         cmake.install()
 
     def requirements(self):
-        self.requires("tkrng/0.3.3")
+        self.requires("tkrng/0.3.4")
         self.requires("catch2/3.3.2")
@@ -0,0 +1,159 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <map>
+#include <numeric>
+#include <set>
+#include <thread>
+#include <tkrng/CounterRNG.hpp>
+
+using std::vector;
+
+namespace tket {
+
+// Check that the generator really is identical across all platforms.
+SCENARIO("CounterRNG: fixed outputs") {
+  CounterRNG rng;
+  CHECK(rng() == 12940112568593616143ull);
+  CHECK(rng() == 5901472800775330104ull);
+  CHECK(rng() == 3120680765705211180ull);
+  CHECK(rng.get_counter() == 3);
+
+  auto stream = CounterRNG(1).split(7);
+  CHECK(stream() == 8497050018424691218ull);
+  CHECK(stream.get_size_t(99) == 4);
+
+  const vector<std::size_t> expected_permutation{7, 2, 6, 4, 1, 3, 0, 5};
+  CHECK(CounterRNG(5).get_permutation(8) == expected_permutation);
+}
+
+SCENARIO("CounterRNG: random access and splitting") {
+  CounterRNG rng(123);
+  const std::uint64_t x5 = rng.at(5);
+  vector<std::uint64_t> values(10);
+  rng.fill(values);
+  CHECK(values[5] == x5);
+  CHECK(rng.get_counter() == 10);
+  rng.set_counter(5);
+  CHECK(rng() == x5);
+
+  // Streams depend only on the key and id, not on what has been drawn.
+  const CounterRNG fresh(123);
+  CHECK(rng.split(3).at(0) == fresh.split(3).at(0));
+  std::set<std::uint64_t> first_outputs{rng.at(0)};
+  for (std::uint64_t id = 0; id < 1000; ++id) {
+    first_outputs.insert(fresh.split(id).at(0));
+    first_outputs.insert(fresh.split(id).split(0).at(0));
+  }
+  CHECK(first_outputs.size() == 2001);
+
+  // Splitting per task gives the same results however the work is divided.
+  const std::size_t n_tasks = 64;
+  vector<std::uint64_t> sequential(n_tasks);
+  for (std::size_t i = 0; i < n_tasks; ++i) {
+    CounterRNG task_rng = fresh.split(i);
+    sequential[i] = task_rng.get_size_t(1000000);
+  }
+  vector<std::uint64_t> parallel(n_tasks);
+  vector<std::thread> threads;
+  for (std::size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&fresh, &parallel, t, n_tasks] {
+      for (std::size_t i = t; i < n_tasks; i += 4) {
+        CounterRNG task_rng = fresh.split(i);
+        parallel[i] = task_rng.get_size_t(1000000);
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+  CHECK(parallel == sequential);
+}
+
+SCENARIO("CounterRNG: distributions") {
+  CounterRNG rng;
+  GIVEN("Integers in a range") {
+    vector<std::size_t> counts(5, 0);
+    for (int nn = 0; nn < 100000; ++nn) {
+      ++counts[rng.get_size_t(counts.size() - 1)];
+    }
+    for (std::size_t count : counts) {
+      CHECK(count > 19000);
+      CHECK(count < 21000);
+    }
+    for (int nn = 0; nn < 100; ++nn) {
+      const std::size_t x = rng.get_size_t(105, 100);
+      CHECK(x >= 100);
+      CHECK(x <= 105);
+    }
+  }
+  GIVEN("Doubles") {
+    vector<double> values(100000);
+    rng.fill_doubles(values);
+    double total = 0;
+    for (double x : values) {
+      REQUIRE(x >= 0);
+      REQUIRE(x < 1);
+      total += x;
+    }
+    CHECK(total / values.size() > 0.49);
+    CHECK(total / values.size() < 0.51);
+    CHECK(rng.get_double() != values.back());
+  }
+  GIVEN("Bits") {
+    vector<bool> bits(100001);
+    rng.fill_bits(bits);
+    const std::size_t n_ones = std::count(bits.cbegin(), bits.cend(), true);
+    CHECK(n_ones > 49000);
+    CHECK(n_ones < 51000);
+  }
+  GIVEN("Small numbers of bits at a time") {
+    // Bits come from each output lowest first, with the earlier bits
+    // forming the higher part of the result.
+    CounterRNG copy = rng;
+    const std::uint64_t x = copy();
+    const std::uint64_t y = copy();
+    CHECK(rng.get_bits(3) == (x & 7));
+    CHECK(rng.get_bits(60) == ((x >> 3) & ((1ull << 60) - 1)));
+    CHECK(rng.get_bits(2) == (((x >> 63) << 1) | (y & 1)));
+    CHECK(rng.get_counter() == copy.get_counter());
+    CHECK(rng.get_bits(63) == (y >> 1));
+    CHECK(rng.get_bits(64) == copy());
+    CHECK_THROWS(rng.get_bits(0));
+  }
+  GIVEN("Shuffling") {
+    vector<std::size_t> perm = rng.get_permutation(1000);
+    vector<std::size_t> sorted = perm;
+    std::sort(sorted.begin(), sorted.end());
+    vector<std::size_t> identity(1000);
+    std::iota(identity.begin(), identity.end(), 0);
+    CHECK(sorted == identity);
+    CHECK(perm != identity);
+    // Each of the 6 permutations of 3 elements should be roughly equally
+    // likely.
+    std::map<vector<int>, unsigned> counts;
+    for (int nn = 0; nn < 60000; ++nn) {
+      vector<int> elements{0, 1, 2};
+      rng.do_shuffle(elements);
+      ++counts[elements];
+    }
+    CHECK(counts.size() == 6);
+    for (const auto& entry : counts) {
+      CHECK(entry.second > 9500);
+      CHECK(entry.second < 10500);
+    }
+  }
+}
+
+}  // namespace tket
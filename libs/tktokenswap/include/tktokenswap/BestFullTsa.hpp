@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "HybridTsa.hpp"
 #include "SwapListOptimiser.hpp"
 #include "SwapListTableOptimiser.hpp"
@@ -29,6 +31,25 @@ class BestFullTsa : public tsa_internal::PartialTsaInterface {
  public:
   BestFullTsa();
 
+  /** Extra options, for callers needing more predictable running times. */
+  struct Options {
+    /** If set, a time budget (in milliseconds) for the whole calculation.
+     *  Once exceeded, the hybrid TSA finishes with the fast trivial TSA,
+     *  and the table optimisation is skipped. Only the cheap swap list
+     *  optimisation passes are always performed, so the budget may still
+     *  be overrun somewhat; it is not a hard limit.
+     */
+    std::optional<unsigned> timeout_ms;
+
+    /** If set, bounds the number of sweeps of the (relatively expensive)
+     *  table optimiser; see SwapListTableOptimiser::Options.
+     */
+    std::optional<std::size_t> max_table_optimiser_sweeps;
+  };
+
+  /** Access the options, to change if desired. */
+  Options& get_options();
+
   /** We emphasise that, unlike the general PartialTsaInterface, the solution
    * returned is complete, AND includes all known swap list optimisations.
    * Warning: unlike most PartialTsaInterface objects, the vertex_mapping
@@ -49,6 +70,7 @@ class BestFullTsa : public tsa_internal::PartialTsaInterface {
       tsa_internal::RiverFlowPathFinder& path_finder) override;
 
  private:
+  Options m_options;
   tsa_internal::HybridTsa m_hybrid_tsa;
   tsa_internal::SwapListOptimiser m_swap_list_optimiser;
   tsa_internal::SwapListTableOptimiser m_table_optimiser;
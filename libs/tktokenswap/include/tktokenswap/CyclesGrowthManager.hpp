@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <map>
+#include <vector>
+
 #include "tktokenswap/DistancesInterface.hpp"
 #include "tktokenswap/NeighboursInterface.hpp"
 #include "tktokenswap/VertexMappingFunctions.hpp"
@@ -126,6 +129,20 @@ class CyclesGrowthManager {
      *  min_decrease_for_partial_path AND this are satisfied.
      */
     int min_power_percentage_for_partial_path = 0;
+
+    /** When growing the cycles, the possible extensions of the cycles
+     *  may be filtered on up to this many threads (1 means no extra threads).
+     *  The distances and neighbours objects are NOT assumed to be
+     *  thread-safe, so they are only ever queried from the calling thread.
+     *  The results are merged back in the original cycle order,
+     *  so they do not depend upon the number of threads.
+     */
+    unsigned number_of_threads = 1;
+
+    /** Don't start extra threads unless each would get at least this many
+     *  cycles; for smaller collections the thread start-up cost dominates.
+     */
+    std::size_t min_cycles_per_thread = 250;
   };
 
   /** Access the options, to change if desired. */
@@ -228,6 +245,45 @@ class CyclesGrowthManager {
   Cycles m_cycles;
   Options m_options;
   bool m_cycles_are_candidates = false;
+
+  /** A possible move from the back vertex of a cycle, with its L-decrease. */
+  struct Extension {
+    std::size_t vertex;
+    int decrease;
+  };
+
+  // Working data for "attempt_to_grow", stored to reuse the memory.
+
+  /** The key is the back vertex of a cycle; the value is the list of
+   *  all possible moves from it, with their L-decreases. Every cycle with
+   *  the same back vertex shares these, so they're only calculated once.
+   */
+  std::map<std::size_t, std::vector<Extension>> m_moves_from_vertex;
+
+  /** The cycle IDs, in order, at the start of the growth step. */
+  std::vector<std::size_t> m_ids;
+
+  /** Element i points to the possible moves for the cycle with ID m_ids[i]. */
+  std::vector<const std::vector<Extension>*> m_moves_for_cycle;
+
+  /** Element i is the number of good extensions of the cycle m_ids[i]. */
+  std::vector<std::size_t> m_number_of_extensions;
+
+  /** One list per thread; thread t fills in the good extensions for
+   *  the contiguous range of cycle indices ending at m_range_ends[t].
+   */
+  std::vector<std::vector<Extension>> m_extensions;
+  std::vector<std::size_t> m_range_ends;
+
+  /** Fill in the good extensions (those with a large enough L-decrease,
+   *  and not creating duplicate vertices) of the cycles with indices
+   *  in [begin, end), in order, and the counts in "m_number_of_extensions".
+   *  Does not touch the distances or neighbours objects, and writes only
+   *  to data not shared with other ranges, so is safe to call concurrently.
+   */
+  void fill_extensions(
+      std::size_t begin, std::size_t end,
+      std::vector<Extension>& extensions);
 };
 
 }  // namespace tsa_internal
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "CyclesPartialTsa.hpp"
 #include "TrivialTSA.hpp"
 
@@ -27,6 +29,20 @@ class HybridTsa : public PartialTsaInterface {
  public:
   HybridTsa();
 
+  /** Extra options to bound the running time. */
+  struct Options {
+    /** If set, once this much time (in milliseconds) has passed since
+     *  the start of "append_partial_solution", stop looking for good cycles
+     *  and finish with the fast (but lower quality) full trivial TSA.
+     *  The check is made between iterations, so a single call to the
+     *  cycles TSA may still overrun the budget somewhat.
+     */
+    std::optional<unsigned> timeout_ms;
+  };
+
+  /** Access the options, to change if desired. */
+  Options& get_options();
+
   /** For the current token configuration, calculate a sequence of swaps
    *  to move all tokens home, and append them to the given list.
    *  As this is a full TSA, it guarantees to find a solution.
@@ -44,8 +60,12 @@ class HybridTsa : public PartialTsaInterface {
       RiverFlowPathFinder& path_finder) override;
 
  private:
+  Options m_options;
   CyclesPartialTsa m_cycles_tsa;
   TrivialTSA m_trivial_tsa;
+
+  /** Used only to finish quickly when the time budget is exceeded. */
+  TrivialTSA m_full_trivial_tsa;
 };
 
 }  // namespace tsa_internal
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <optional>
 #include <set>
 
 #include "PartialMappingLookup.hpp"
@@ -34,6 +35,18 @@ namespace tsa_internal {
 /** Uses the lookup table to reduce many intervals of a swap sequence. */
 class SwapListTableOptimiser {
  public:
+  /** Extra options to bound the running time. */
+  struct Options {
+    /** If set, the maximum number of sweeps (each being one forward and
+     *  one backward pass over the whole swap list) in "optimise".
+     *  Otherwise, sweep until the swap list stops getting shorter.
+     */
+    std::optional<std::size_t> max_number_of_sweeps;
+  };
+
+  /** Access the options, to change if desired. */
+  Options& get_options();
+
   /** Reduce the given list of swap in-place, by using the big lookup table.
    * Swaps may be significantly reordered, and the final end-to-end
    * permutation of vertices may change; only the partial mapping of those
@@ -68,6 +81,7 @@ class SwapListTableOptimiser {
   SwapListSegmentOptimiser& get_segment_optimiser();
 
  private:
+  Options m_options;
   SwapListSegmentOptimiser m_segment_optimiser;
 
   /** The same interface as "optimise", which goes in both directions,
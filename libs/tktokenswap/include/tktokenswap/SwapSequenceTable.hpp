@@ -16,6 +16,7 @@
 
 #include <cstdint>
 #include <map>
+#include <span>
 #include <vector>
 
 namespace tket {
@@ -116,6 +117,20 @@ struct SwapSequenceTable {
    *  @return A large precomputed raw table of data.
    */
   static Table get_table();
+
+  /** All the codes for a single permutation hash. */
+  struct CodesList {
+    unsigned permutation_hash;
+    const Code* begin;
+    const Code* end;
+  };
+
+  /** The same data as get_table, but without constructing anything:
+   * the codes lie in constant arrays in read-only storage, in increasing
+   * order of permutation hash, so they are only paged in when first read.
+   *  @return The codes lists for all permutation hashes in the table.
+   */
+  static std::span<const CodesList> get_flat_table();
 };
 
 }  // namespace tsa_internal
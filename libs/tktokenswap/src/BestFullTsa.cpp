@@ -14,6 +14,8 @@
 
 #include "tktokenswap/BestFullTsa.hpp"
 
+#include <chrono>
+
 #include "tktokenswap/RiverFlowPathFinder.hpp"
 #include "tktokenswap/VertexMapResizing.hpp"
 
@@ -23,12 +25,16 @@ using namespace tsa_internal;
 
 BestFullTsa::BestFullTsa() { m_name = "BestFullTsa"; }
 
+BestFullTsa::Options& BestFullTsa::get_options() { return m_options; }
+
 void BestFullTsa::append_partial_solution(
     SwapList& swaps, VertexMapping& vertex_mapping,
     DistancesInterface& distances, NeighboursInterface& neighbours,
     RiverFlowPathFinder& path_finder) {
+  const auto start = std::chrono::steady_clock::now();
   auto vm_copy = vertex_mapping;
 
+  m_hybrid_tsa.get_options().timeout_ms = m_options.timeout_ms;
   m_hybrid_tsa.append_partial_solution(
       swaps, vm_copy, distances, neighbours, path_finder);
 
@@ -38,6 +44,13 @@ void BestFullTsa::append_partial_solution(
   m_swap_list_optimiser.optimise_pass_remove_empty_swaps(swaps, vertex_mapping);
   m_swap_list_optimiser.full_optimise(swaps, vertex_mapping);
 
+  if (m_options.timeout_ms &&
+      std::chrono::steady_clock::now() - start >=
+          std::chrono::milliseconds(m_options.timeout_ms.value())) {
+    return;
+  }
+  m_table_optimiser.get_options().max_number_of_sweeps =
+      m_options.max_table_optimiser_sweeps;
   VertexMapResizing map_resizing(neighbours);
   std::set<std::size_t> vertices_with_tokens_at_start;
   for (const auto& entry : vertex_mapping) {
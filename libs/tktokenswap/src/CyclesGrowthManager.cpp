@@ -14,7 +14,10 @@
 
 #include "CyclesGrowthManager.hpp"
 
+#include <algorithm>
+#include <functional>
 #include <stdexcept>
+#include <thread>
 #include <tkassert/Assert.hpp>
 
 #include "tktokenswap/DistanceFunctions.hpp"
@@ -116,6 +119,45 @@ bool CyclesGrowthManager::attempt_to_close_cycles(
   return m_cycles_are_candidates;
 }
 
+void CyclesGrowthManager::fill_extensions(
+    std::size_t begin, std::size_t end, vector<Extension>& extensions) {
+  extensions.clear();
+  for (std::size_t ii = begin; ii < end; ++ii) {
+    const auto& cycle = m_cycles.at(m_ids[ii]);
+
+    // If there are N moves, each move can only decrease L by at most one,
+    // so it's unfair to demand a huge L-decrease, because shorter cycles
+    // would be killed immediately.
+    // With N vertices there are N-1 moves, but we are about to add
+    // the new vertex adj_v to this partial cycle (unless we discard it),
+    // taking it back up to N.
+    const int num_moves = cycle.vertices.size();
+    int min_decrease = num_moves;
+    min_decrease =
+        std::min(min_decrease, m_options.min_decrease_for_partial_path);
+
+    // We want 100*(L-decr)/(num.moves) >=
+    // min_power_percentage_for_partial_path. But we need the ceiling
+    // because of interger division.
+    min_decrease = std::max(
+        min_decrease,
+        (99 + m_options.min_power_percentage_for_partial_path * num_moves) /
+            100);
+
+    const auto initial_size = extensions.size();
+    for (const auto& move : *m_moves_for_cycle[ii]) {
+      if (cycle.contains(move.vertex)) {
+        continue;
+      }
+      const int new_decr = cycle.decrease + move.decrease;
+      if (new_decr >= min_decrease) {
+        extensions.push_back({move.vertex, new_decr});
+      }
+    }
+    m_number_of_extensions[ii] = extensions.size() - initial_size;
+  }
+}
+
 CyclesGrowthManager::GrowthResult CyclesGrowthManager::attempt_to_grow(
     const VertexMapping& vertex_mapping, DistancesInterface& distances,
     NeighboursInterface& neighbours) {
@@ -129,63 +171,92 @@ CyclesGrowthManager::GrowthResult CyclesGrowthManager::attempt_to_grow(
     result.empty = true;
     return result;
   }
-  for (auto id_opt = m_cycles.front_id(); id_opt;) {
-    const auto id = id_opt.value();
-    id_opt = m_cycles.next(id);
 
-    // Add an arrow onto the back.
+  // First, serially, find the possible moves from each back vertex;
+  // this is the only place where "distances" and "neighbours" are used.
+  // The vertex mapping doesn't change while growing, so many cycles
+  // ending at the same vertex can share the same data.
+  m_moves_from_vertex.clear();
+  m_ids.clear();
+  m_moves_for_cycle.clear();
+  for (auto id_opt = m_cycles.front_id(); id_opt;
+       id_opt = m_cycles.next(id_opt.value())) {
+    const auto id = id_opt.value();
     const auto back_vertex = m_cycles.at(id).vertices.back();
-    const auto& adj_vertices = neighbours(back_vertex);
-    for (auto adj_v : adj_vertices) {
-      int new_decr;
-      {
-        // Important not to reuse this once cycles are added,
-        // as it may be invalidated
-        const auto& cycle = m_cycles.at(id);
-        if (cycle.contains(adj_v)) {
-          continue;
-        }
-        new_decr =
-            cycle.decrease +
-            get_move_decrease(vertex_mapping, back_vertex, adj_v, distances);
-
-        // If there are N moves, each move can only decrease L by at most one,
-        // so it's unfair to demand a huge L-decrease, because shorter cycles
-        // would be killed immediately.
-        // With N vertices there are N-1 moves, but we are about to add
-        // the new vertex adj_v to this partial cycle (unless we discard it),
-        // taking it back up to N.
-        const int num_moves = cycle.vertices.size();
-        int min_decrease = num_moves;
-        min_decrease =
-            std::min(min_decrease, m_options.min_decrease_for_partial_path);
-
-        // We want 100*(L-decr)/(num.moves) >=
-        // min_power_percentage_for_partial_path. But we need the ceiling
-        // because of interger division.
-        min_decrease = std::max(
-            min_decrease,
-            (99 + m_options.min_power_percentage_for_partial_path * num_moves) /
-                100);
-
-        if (new_decr < min_decrease) {
-          continue;
-        }
+    const auto [iter, inserted] = m_moves_from_vertex.try_emplace(back_vertex);
+    if (inserted) {
+      for (auto adj_v : neighbours(back_vertex)) {
+        iter->second.push_back(
+            {adj_v, get_move_decrease(
+                        vertex_mapping, back_vertex, adj_v, distances)});
       }
+    }
+    m_ids.push_back(id);
+    m_moves_for_cycle.push_back(&iter->second);
+  }
+
+  // Next, filter the extensions of each cycle, possibly in parallel,
+  // over contiguous ranges of cycles.
+  const std::size_t number_of_cycles = m_ids.size();
+  std::size_t number_of_threads = 1;
+  if (m_options.min_cycles_per_thread > 0) {
+    number_of_threads = std::min<std::size_t>(
+        m_options.number_of_threads,
+        number_of_cycles / m_options.min_cycles_per_thread);
+  }
+  number_of_threads = std::max<std::size_t>(number_of_threads, 1);
+  m_number_of_extensions.resize(number_of_cycles);
+  if (m_extensions.size() < number_of_threads) {
+    m_extensions.resize(number_of_threads);
+  }
+  m_range_ends.resize(number_of_threads);
+  for (std::size_t tt = 0; tt < number_of_threads; ++tt) {
+    m_range_ends[tt] = (number_of_cycles * (tt + 1)) / number_of_threads;
+  }
+  if (number_of_threads == 1) {
+    fill_extensions(0, number_of_cycles, m_extensions[0]);
+  } else {
+    vector<std::thread> threads;
+    threads.reserve(number_of_threads - 1);
+    for (std::size_t tt = 1; tt < number_of_threads; ++tt) {
+      threads.emplace_back(
+          &CyclesGrowthManager::fill_extensions, this, m_range_ends[tt - 1],
+          m_range_ends[tt], std::ref(m_extensions[tt]));
+    }
+    fill_extensions(0, m_range_ends[0], m_extensions[0]);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  // Finally, serially create the new cycles in the original order,
+  // so that the result is independent of the number of threads.
+  std::size_t thread_index = 0;
+  std::size_t position = 0;
+  for (std::size_t ii = 0; ii < number_of_cycles; ++ii) {
+    while (ii >= m_range_ends[thread_index]) {
+      ++thread_index;
+      position = 0;
+    }
+    const auto& extensions = m_extensions[thread_index];
+    const auto id = m_ids[ii];
+    const auto end_position = position + m_number_of_extensions[ii];
+    for (; position < end_position; ++position) {
       // A new cycle to be added. Add it before the current position,
-      // so we won't pass through it again in the main loop.
+      // so we won't pass through it again.
       const auto new_id = m_cycles.insert_before(id);
       auto& new_cycle = m_cycles.at(new_id);
-      new_cycle.decrease = new_decr;
+      new_cycle.decrease = extensions[position].decrease;
       new_cycle.vertices = m_cycles.at(id).vertices;
-      new_cycle.vertices.push_back(adj_v);
+      new_cycle.vertices.push_back(extensions[position].vertex);
       if (m_cycles.size() >= m_options.max_number_of_cycles) {
-        // Break out of the INNER loop, i.e. neighbours for this
-        // cycle endpoint. However, this cycle is about to be deleted,
-        // creating space, so continue with further cycles.
+        // Stop adding extensions of this cycle. However, this cycle
+        // is about to be deleted, creating space, so continue with
+        // further cycles.
         break;
       }
     }
+    position = end_position;
     m_cycles.erase(id);
   }
   result.empty = m_cycles.empty();
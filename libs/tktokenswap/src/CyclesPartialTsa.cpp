@@ -23,6 +23,10 @@ namespace tsa_internal {
 
 CyclesPartialTsa::CyclesPartialTsa() { m_name = "Cycles"; }
 
+CyclesGrowthManager::Options& CyclesPartialTsa::get_growth_options() {
+  return m_growth_manager.get_options();
+}
+
 void CyclesPartialTsa::append_partial_solution(
     SwapList& swaps, VertexMapping& vertex_mapping,
     DistancesInterface& distances, NeighboursInterface& neighbours,
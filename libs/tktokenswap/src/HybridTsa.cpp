@@ -14,6 +14,7 @@
 
 #include "HybridTsa.hpp"
 
+#include <chrono>
 #include <tkassert/Assert.hpp>
 
 #include "tktokenswap/DistanceFunctions.hpp"
@@ -28,12 +29,23 @@ HybridTsa::HybridTsa() {
   m_trivial_tsa.set(TrivialTSA::Options::BREAK_AFTER_PROGRESS);
 }
 
+HybridTsa::Options& HybridTsa::get_options() { return m_options; }
+
 void HybridTsa::append_partial_solution(
     SwapList& swaps, VertexMapping& vertex_mapping,
     DistancesInterface& distances, NeighboursInterface& neighbours,
     RiverFlowPathFinder& path_finder) {
+  const auto start = std::chrono::steady_clock::now();
   const auto initial_L = get_total_home_distances(vertex_mapping, distances);
   for (std::size_t counter = initial_L + 1; counter > 0; --counter) {
+    if (m_options.timeout_ms &&
+        std::chrono::steady_clock::now() - start >=
+            std::chrono::milliseconds(m_options.timeout_ms.value())) {
+      m_full_trivial_tsa.append_partial_solution(
+          swaps, vertex_mapping, distances, neighbours, path_finder);
+      TKET_ASSERT(all_tokens_home(vertex_mapping));
+      return;
+    }
     const auto swaps_before = swaps.size();
     m_cycles_tsa.append_partial_solution(
         swaps, vertex_mapping, distances, neighbours, path_finder);
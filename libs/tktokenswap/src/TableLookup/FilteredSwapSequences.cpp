@@ -225,15 +225,16 @@ std::size_t FilteredSwapSequences::get_total_number_of_entries() const {
 static std::map<unsigned, FilteredSwapSequences>
 construct_and_return_full_table() {
   std::map<unsigned, FilteredSwapSequences> result;
-  const auto raw_table = SwapSequenceTable::get_table();
-  for (const auto& entry : raw_table) {
+  for (const auto& codes_list : SwapSequenceTable::get_flat_table()) {
     // The simplest nontrivial permutation arises from a single swap (a,b),
     // which under the canonical relabelling is converted to (01),
     // which has hash 2.
-    TKET_ASSERT(entry.first >= 2);
+    TKET_ASSERT(codes_list.permutation_hash >= 2);
     // The largest possible hash comes from (01)(23)(45).
-    TKET_ASSERT(entry.first <= 222);
-    result[entry.first].initialise(entry.second);
+    TKET_ASSERT(codes_list.permutation_hash <= 222);
+    result[codes_list.permutation_hash].initialise(
+        std::vector<SwapConversion::SwapHash>(
+            codes_list.begin, codes_list.end));
   }
   return result;
 }
@@ -108,6 +108,10 @@ static bool perform_current_nonempty_swap(
   return true;
 }
 
+SwapListTableOptimiser::Options& SwapListTableOptimiser::get_options() {
+  return m_options;
+}
+
 void SwapListTableOptimiser::optimise(
     const std::set<std::size_t>& vertices_with_tokens_at_start,
     VertexMapResizing& map_resizing, SwapList& swap_list,
@@ -146,8 +150,14 @@ void SwapListTableOptimiser::optimise(
     }
   }
   // Now begin the forward/backward loop.
+  std::size_t sweeps = 0;
   for (auto infinite_loop_guard = 1 + swap_list.size(); infinite_loop_guard > 0;
        --infinite_loop_guard) {
+    if (m_options.max_number_of_sweeps &&
+        sweeps >= m_options.max_number_of_sweeps.value()) {
+      return;
+    }
+    ++sweeps;
     const auto old_size = swap_list.size();
     optimise_in_forward_direction(
         vertices_with_tokens_at_start, map_resizing, swap_list,
@@ -14,14 +14,15 @@
 
 #include "tktokenswap/SwapSequenceTable.hpp"
 
+#include <iterator>
+
 namespace tket {
 namespace tsa_internal {
 
-SwapSequenceTable::Table SwapSequenceTable::get_table() {
-  Table map;
-
-  // clang-format off
-  map[2] = {
+// The codes for each permutation hash are stored in constant arrays,
+// so that they are never constructed or copied at runtime.
+// clang-format off
+static constexpr SwapSequenceTable::Code codes_2[] = {
     0x1, 0x262, 0x373, 0x484, 0x595, 0x27a72, 0x28b82, 0x29c92,
     0x36a63, 0x38d83, 0x39e93, 0x46b64, 0x47d74, 0x49f94, 0x56c65, 0x57e75,
     0x58f85, 0x27dbd72, 0x27ece72, 0x28dad82, 0x28fcf82, 0x29eae92,
@@ -33,9 +34,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0x3d9cbd3c9, 0x3e6bfe3b6, 0x3e8bce3b8, 0x4b7ecb4e7, 0x4b9eab4e9,
     0x4d6ced4c6, 0x4d9cad4c9, 0x4f6aef4a6, 0x4f7acf4a7, 0x5c7dbc5d7,
     0x5c8dac5d8, 0x5e6bde5b6, 0x5e8bae5b8, 0x5f6adf5a6, 0x5f7abf5a7,
-  };
+};
 
-  map[3] = {
+static constexpr SwapSequenceTable::Code codes_3[] = {
     0x16, 0x21, 0x62, 0x17a7, 0x18b8, 0x19c9, 0x2373, 0x2484, 0x2595,
     0x36a3, 0x3736, 0x3a31, 0x3a73, 0x46b4, 0x4846, 0x4b41, 0x4b84, 0x56c5,
     0x5956, 0x5c51, 0x5c95, 0x7a27, 0x8b28, 0x9c29, 0x17bd7b,
@@ -68,9 +69,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0x5cf7d7f5, 0x5e6bdbe5, 0x5e78b8e5, 0x5e8d86e5, 0x5f6adaf5, 0x5f7d76f5,
     0x5f87a7f5, 0x7dcfc2d7, 0x7ebfb2e7, 0x8dcec2d8, 0x8faea2f8, 0x9ebdb2e9,
     0x9fada2f9,
-  };
+};
 
-  map[4] = {
+static constexpr SwapSequenceTable::Code codes_4[] = {
     0x16a, 0x176, 0x1a7, 0x21a, 0x316, 0x321, 0x362, 0x62a, 0x6a3, 0x736,
     0xa31, 0xa73, 0x12712, 0x16bdb, 0x16cec, 0x178b8, 0x179c9, 0x18ad8,
     0x18b8a, 0x18d86, 0x18db8, 0x19ae9, 0x19c9a, 0x19e96, 0x19ec9, 0x1bd7b,
@@ -143,9 +144,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0x5e54b45e7e5, 0x5fc8f578fcf, 0x8ced82ce2c2, 0x8fdcf82cfdf,
     0x9bde92bd2b2, 0x9febf92bfef, 0xbf4efb7ef4f, 0xcf5dfc7df5f,
     0xdf85fd25f8f, 0xef94fe24f9f,
-  };
+};
 
-  map[5] = {
+static constexpr SwapSequenceTable::Code codes_5[] = {
     0x16ad, 0x16ba, 0x16db, 0x176d, 0x186a, 0x1876, 0x18a7, 0x1ad8, 0x1b8a,
     0x1d86, 0x1db8, 0x21ad, 0x21ba, 0x21db, 0x321d, 0x3d16, 0x3d62, 0x416a,
     0x4176, 0x41a7, 0x421a, 0x4316, 0x4321, 0x4362, 0x46a3, 0x4736, 0x4a31,
@@ -278,9 +279,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0x4597954b4595, 0x4b454e54b7e5, 0x5395369b6953, 0x53c6c5386c53,
     0x5c51715bc517, 0x5f51715fbf51, 0x7d7fdcfd72cf, 0x7e7fe7bfe72b,
     0x8ced8c2cedc2, 0x8f8eaef82aef,
-  };
+};
 
-  map[6] = {
+static constexpr SwapSequenceTable::Code codes_6[] = {
     0x16adf, 0x16aed, 0x16afe, 0x16baf, 0x16cad, 0x16cba, 0x16cdb, 0x16dfc,
     0x16fec, 0x176df, 0x176ed, 0x176fe, 0x186af, 0x18f76, 0x18fa7, 0x196ad,
     0x196ba, 0x196db, 0x197d6, 0x1986a, 0x19876, 0x198a7, 0x19ad8, 0x19b8a,
@@ -521,9 +522,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0x9379437b437, 0x97f97bf92bf, 0x9c97bc974bc, 0x9fdadf92adf,
     0xa24ea249ea2, 0xa2a79a72bab, 0xbd4ed9ed4bd, 0xd7db2db7ede,
     0xef94f24f9ef, 0xf4bfe7febf4,
-  };
+};
 
-  map[22] = {
+static constexpr SwapSequenceTable::Code codes_22[] = {
     0x1a, 0x1232, 0x1676, 0x1bdb, 0x1cec, 0x2362, 0x262a, 0x3273, 0x373a,
     0x484a, 0x595a, 0x6276, 0x7367, 0x121712, 0x124d42, 0x125e52,
     0x131613, 0x134b43, 0x135c53, 0x168d86, 0x169e96, 0x178b87, 0x179c97,
@@ -581,9 +582,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0x53f5bf536bf5, 0x5956954d4596, 0x5957954b4597, 0x5bde6bde56b6,
     0x5c7dbc57d7bd, 0x86f8ef863ef8, 0x87f8cf872cf8, 0x96f9df963df9,
     0x97f9bf972bf9,
-  };
+};
 
-  map[32] = {
+static constexpr SwapSequenceTable::Code codes_32[] = {
     0x16d, 0x21d, 0x62d, 0x16343, 0x16787, 0x16efe, 0x178a7, 0x187b8,
     0x19c9d, 0x1a7ba, 0x1aba6, 0x1b8ab, 0x21343, 0x21aba, 0x21efe, 0x23473,
     0x24384, 0x2595d, 0x27387, 0x27871, 0x28478, 0x3186a, 0x34362, 0x346a3,
@@ -719,9 +720,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0xac65c45ca6c, 0xaca9c289cac, 0xaeafe8fe3ae, 0xaeafea8fea2,
     0xb8bcbecb3ec, 0xbc65c35cb6c, 0xbcb9c279cbc, 0xbfbef7ef4bf,
     0xbfbefb7efb2, 0xcafca8fca3a, 0xcbecb7ecb4b,
-  };
+};
 
-  map[33] = {
+static constexpr SwapSequenceTable::Code codes_33[] = {
     0x16df, 0x16ed, 0x16fe, 0x21df, 0x21ed, 0x21fe, 0x62df, 0x62ed, 0x62fe,
     0x1343f6, 0x1454e6, 0x1535d6, 0x163543, 0x163f53, 0x164e34, 0x165d45,
     0x16787f, 0x16797d, 0x167987, 0x16898e, 0x16abaf, 0x16acad, 0x16bcbe,
@@ -985,9 +986,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0xa616516ba6, 0xac616416a6, 0xb616316cb6, 0xd3adf9dfd3, 0xd3dfcdfd73,
     0xd7df5dfda7, 0xe5ced8ede5, 0xe5edbede95, 0xe9ed4edec9, 0xf4bfe7fef4,
     0xf4feafef84, 0xf8fe3fefb8,
-  };
+};
 
-  map[42] = {
+static constexpr SwapSequenceTable::Code codes_42[] = {
     0x16af, 0x176f, 0x1a7f, 0x316f, 0x321f, 0x362f, 0x62af, 0x6a3f, 0xa31f,
     0xa73f, 0xf21a, 0xf736, 0x14546a, 0x145476, 0x1454a7, 0x16abcb,
     0x16bcdb, 0x16cbec, 0x16dbdf, 0x16dbed, 0x16ecde, 0x16ecef, 0x176898,
@@ -1216,9 +1217,9 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0x5e545b45e7e5, 0x6b67e4b676b6, 0x6c67d5c676c6, 0x78a78ca785ca,
     0x79a79ba794ba, 0x813a31ca3181, 0x8ced8ced2ce2, 0x8d8ad8cad5ca,
     0x913a31ba3191, 0x9bde9bde2bd2, 0x9e9ae9bae4ba,
-  };
+};
 
-  map[222] = {
+static constexpr SwapSequenceTable::Code codes_222[] = {
     0x1af, 0x1232f, 0x1454a, 0x1676f, 0x1898a, 0x1abcb, 0x1aded, 0x1bcdb,
     0x1bdbf, 0x1cbec, 0x1cecf, 0x1dbed, 0x1ecde, 0x2362f, 0x3273f, 0x4584a,
     0x5495a, 0x6276f, 0x7367f, 0x8498a, 0x9589a, 0xa262f, 0xa373f, 0xa484f,
@@ -1413,8 +1414,32 @@ SwapSequenceTable::Table SwapSequenceTable::get_table() {
     0xada36a396ad, 0xaea247a27ae, 0xaea36a386ae, 0xbf49f479fbf,
     0xbf85f835fbf, 0xcf58f578fcf, 0xcf94f934fcf, 0xdf49f469fdf,
     0xdf85f825fdf, 0xef58f568fef, 0xef94f924fef,
-  };
-  // clang-format on
+};
+// clang-format on
+
+static constexpr SwapSequenceTable::CodesList codes_lists[] = {
+    {2, std::begin(codes_2), std::end(codes_2)},
+    {3, std::begin(codes_3), std::end(codes_3)},
+    {4, std::begin(codes_4), std::end(codes_4)},
+    {5, std::begin(codes_5), std::end(codes_5)},
+    {6, std::begin(codes_6), std::end(codes_6)},
+    {22, std::begin(codes_22), std::end(codes_22)},
+    {32, std::begin(codes_32), std::end(codes_32)},
+    {33, std::begin(codes_33), std::end(codes_33)},
+    {42, std::begin(codes_42), std::end(codes_42)},
+    {222, std::begin(codes_222), std::end(codes_222)},
+};
+
+std::span<const SwapSequenceTable::CodesList>
+SwapSequenceTable::get_flat_table() {
+  return codes_lists;
+}
+
+SwapSequenceTable::Table SwapSequenceTable::get_table() {
+  Table map;
+  for (const CodesList& codes_list : get_flat_table()) {
+    map[codes_list.permutation_hash].assign(codes_list.begin, codes_list.end);
+  }
   return map;
 }
 
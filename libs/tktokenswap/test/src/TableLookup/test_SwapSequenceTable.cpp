@@ -171,6 +171,18 @@ SCENARIO("Fixed table entries test") {
     total_entries += entry.second.size();
   }
   CHECK(total_entries == 7939);
+
+  // The flat table holds the same data, in increasing hash order.
+  const auto flat_table = SwapSequenceTable::get_flat_table();
+  REQUIRE(flat_table.size() == table.size());
+  auto table_citer = table.cbegin();
+  for (const auto& codes_list : flat_table) {
+    REQUIRE(codes_list.permutation_hash == table_citer->first);
+    REQUIRE(std::equal(
+        codes_list.begin, codes_list.end, table_citer->second.cbegin(),
+        table_citer->second.cend()));
+    ++table_citer;
+  }
 }
 
 }  // namespace tests
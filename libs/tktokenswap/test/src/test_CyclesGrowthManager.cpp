@@ -0,0 +1,144 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <tkrng/RNG.hpp>
+#include <tktokenswap/CyclesGrowthManager.hpp>
+#include <tktokenswap/DistanceFunctions.hpp>
+
+#include "TableLookup/NeighboursFromEdges.hpp"
+
+using std::vector;
+
+namespace tket {
+namespace tsa_internal {
+namespace tests {
+
+namespace {
+// Vertex v is at (v % width, v / width) in a rectangular grid.
+class GridDistances : public DistancesInterface {
+ public:
+  explicit GridDistances(std::size_t width) : m_width(width) {}
+
+  virtual std::size_t operator()(
+      std::size_t vertex1, std::size_t vertex2) override {
+    return diff(vertex1 % m_width, vertex2 % m_width) +
+           diff(vertex1 / m_width, vertex2 / m_width);
+  }
+
+ private:
+  const std::size_t m_width;
+
+  static std::size_t diff(std::size_t x, std::size_t y) {
+    return x > y ? x - y : y - x;
+  }
+};
+
+struct GrowthData {
+  vector<int> decreases;
+  vector<vector<std::size_t>> vertices;
+
+  bool operator==(const GrowthData& other) const {
+    return decreases == other.decreases && vertices == other.vertices;
+  }
+};
+}  // namespace
+
+// Grow the cycles until they're all gone, recording every cycle
+// seen after each growth step.
+static GrowthData get_growth_data(
+    const VertexMapping& vertex_mapping, std::size_t width,
+    NeighboursInterface& neighbours,
+    const CyclesGrowthManager::Options& options) {
+  GrowthData data;
+  GridDistances distances(width);
+  CyclesGrowthManager manager;
+  manager.get_options() = options;
+  if (!manager.reset(vertex_mapping, distances, neighbours)) {
+    return data;
+  }
+  for (;;) {
+    const auto& cycles = manager.get_cycles(false);
+    for (auto id_opt = cycles.front_id(); id_opt;
+         id_opt = cycles.next(id_opt.value())) {
+      const auto& cycle = cycles.at(id_opt.value());
+      REQUIRE(cycles.size() <= options.max_number_of_cycles);
+      REQUIRE(cycle.vertices.size() <= options.max_cycle_size);
+
+      // Check that the path is genuine, with no repeated vertices,
+      // and with the correct (open cycle) L-decrease.
+      int decrease = 0;
+      for (std::size_t ii = 0; ii + 1 < cycle.vertices.size(); ++ii) {
+        const auto v1 = cycle.vertices[ii];
+        const auto v2 = cycle.vertices[ii + 1];
+        REQUIRE(distances(v1, v2) == 1);
+        for (std::size_t jj = ii + 1; jj < cycle.vertices.size(); ++jj) {
+          REQUIRE(v1 != cycle.vertices[jj]);
+        }
+        decrease += get_move_decrease(vertex_mapping, v1, v2, distances);
+      }
+      REQUIRE(decrease == cycle.decrease);
+      data.decreases.push_back(cycle.decrease);
+      data.vertices.push_back(cycle.vertices);
+    }
+    if (manager.attempt_to_grow(vertex_mapping, distances, neighbours)
+            .empty) {
+      break;
+    }
+  }
+  return data;
+}
+
+SCENARIO("Growing cycles on several threads gives the same cycles") {
+  RNG rng;
+  for (std::size_t width = 4; width <= 10; width += 3) {
+    const std::size_t number_of_vertices = width * width;
+    NeighboursFromEdges neighbours;
+    for (std::size_t v = 0; v < number_of_vertices; ++v) {
+      if (v % width + 1 < width) {
+        neighbours.add_edge(get_swap(v, v + 1));
+      }
+      if (v + width < number_of_vertices) {
+        neighbours.add_edge(get_swap(v, v + width));
+      }
+    }
+    vector<std::size_t> targets(number_of_vertices);
+    for (std::size_t v = 0; v < number_of_vertices; ++v) {
+      targets[v] = v;
+    }
+    for (unsigned count = 0; count < 5; ++count) {
+      rng.do_shuffle(targets);
+      VertexMapping vertex_mapping;
+      for (std::size_t v = 0; v < number_of_vertices; ++v) {
+        vertex_mapping[v] = targets[v];
+      }
+      for (std::size_t max_cycles : {50, 1000}) {
+        CyclesGrowthManager::Options options;
+        options.max_number_of_cycles = max_cycles;
+        const auto serial_data =
+            get_growth_data(vertex_mapping, width, neighbours, options);
+        CHECK(!serial_data.decreases.empty());
+        options.number_of_threads = 4;
+        options.min_cycles_per_thread = 1;
+        const auto parallel_data =
+            get_growth_data(vertex_mapping, width, neighbours, options);
+        CHECK(serial_data == parallel_data);
+      }
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace tsa_internal
+}  // namespace tket
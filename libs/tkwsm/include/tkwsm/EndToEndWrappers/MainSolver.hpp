@@ -15,6 +15,7 @@
 #pragma once
 #include <chrono>
 #include <memory>
+#include <optional>
 
 #include "../GraphTheoretic/NeighboursData.hpp"
 #include "../GraphTheoretic/VertexRelabelling.hpp"
@@ -25,8 +26,10 @@
 namespace tket {
 namespace WeightedSubgraphMonomorphism {
 
+class ParallelSearch;
 struct PreSearchComponents;
 struct SearchComponents;
+struct TargetGraphData;
 
 /** The main class which takes a raw WSM problem and tries to solve it. */
 class MainSolver {
@@ -41,6 +44,18 @@ class MainSolver {
       const GraphEdgeWeights& target_edges,
       const MainSolverParameters& parameters);
 
+  /** As above, but reuse (and extend) data about the target graph
+   * calculated previously, possibly by other MainSolver objects with
+   * different pattern graphs. The data must outlive this object,
+   * and must not be used by any other MainSolver at the same time.
+   * @param pattern_edges The pattern graph, with edge weights
+   * @param target_data Data about the target graph.
+   * @param parameters Parameters which configure the solving algorithm.
+   */
+  MainSolver(
+      const GraphEdgeWeights& pattern_edges, TargetGraphData& target_data,
+      const MainSolverParameters& parameters);
+
   ~MainSolver();
 
   /** After construction, do further solving, if the original solve terminated
@@ -61,10 +76,13 @@ class MainSolver {
 
  private:
   const VertexRelabelling m_pattern_vertex_relabelling;
-  const VertexRelabelling m_target_vertex_relabelling;
-
   NeighboursData m_pattern_neighbours_data;
-  NeighboursData m_target_neighbours_data;
+
+  // Only used if the caller did not pass in the target data.
+  std::unique_ptr<TargetGraphData> m_own_target_data_ptr;
+  TargetGraphData& m_target_data;
+  const VertexRelabelling& m_target_vertex_relabelling;
+  const NeighboursData& m_target_neighbours_data;
 
   SolutionData m_solution_data;
   mutable SolutionData m_solution_data_original_vertices;
@@ -75,12 +93,36 @@ class MainSolver {
   std::unique_ptr<SearchComponents> m_search_components_ptr;
   std::unique_ptr<SearchBranch> m_search_branch_ptr;
 
-  /** Do NOT backtrack, just move down directly from the current node as far as
-   * possible, i.e. a single solve iteration. Returns TRUE if we end with a full
-   * solution, false otherwise.
+  // Only constructed if more than one thread is to be used.
+  std::unique_ptr<ParallelSearch> m_parallel_search_ptr;
+
+  // From MainSolverParameters::initial_solution, with the new labels.
+  // The single-threaded search storing only the best solution simply
+  // begins with it; otherwise it is used to bound the weight.
+  std::optional<SolutionWSM> m_initial_solution;
+
+  // When the current call to solve (or the initial solve) began.
+  std::chrono::steady_clock::time_point m_search_start_time;
+
+  /** The weight upper bound for the parallel search, or when storing
+   * multiple solutions, taking into account any initial solution. */
+  std::optional<WeightWSM> get_weight_upper_bound(
+      const MainSolverParameters& parameters) const;
+
+  /** Called by the constructors; sets up the search, and solves. */
+  void initialise(const MainSolverParameters& parameters);
+
+  /** Check and convert MainSolverParameters::initial_solution
+   * into the new vertex labels. */
+  SolutionWSM get_relabelled_initial_solution(
+      const MainSolverParameters& parameters) const;
+
+  /** Restrict the domains to the MainSolverParameters::fixed_assignments.
+   * Returns false if this makes the problem insoluble.
    */
-  bool move_down_from_reduced_node(
-      const SearchBranch::ReductionParameters& reduction_parameters);
+  bool apply_fixed_assignments(
+      const MainSolverParameters& parameters,
+      std::vector<boost::dynamic_bitset<>>& initial_domains) const;
 
   /** Performs the solve.
    * We should NOT time things by timing each individual iteration and summing
@@ -92,9 +134,17 @@ class MainSolver {
       const MainSolverParameters& parameters, std::size_t max_iterations,
       const std::chrono::steady_clock::time_point& desired_end_time);
 
-  void add_solution_from_final_node(
+  /** Returns false if the solution callback asks us to stop. */
+  bool add_solution_from_final_node(
       const MainSolverParameters& parameters,
       const SearchBranch::ReductionParameters& reduction_parameters);
+
+  /** Extend SolutionData::best_weight_trajectory, if the scalar product
+   * is better than any so far. */
+  void record_weight_improvement(WeightWSM scalar_product);
+
+  /** Convert the vertex labels in the solution back to the original ones. */
+  void relabel_to_original_vertices(SolutionWSM& solution) const;
 };
 
 }  // namespace WeightedSubgraphMonomorphism
@@ -13,9 +13,13 @@
 // limitations under the License.
 
 #pragma once
+#include <functional>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "../GraphTheoretic/GeneralStructs.hpp"
+#include "SolutionWSM.hpp"
 
 namespace tket {
 namespace WeightedSubgraphMonomorphism {
@@ -73,6 +77,47 @@ struct MainSolverParameters {
    */
   unsigned max_distance_for_distance_reduction_during_search;
 
+  /** If greater than 1, the search tree is split below its first few
+   * assignments into subtrees, which are searched concurrently by this many
+   * threads, sharing the best solution found so far for pruning.
+   * If the search runs to completion the result is the same whatever the
+   * timing of the threads, although with a single solution it need not be
+   * the solution the single-threaded search would return.
+   * Only read when the MainSolver is constructed.
+   */
+  unsigned number_of_threads;
+
+  /** Every solution must contain all of these (pv,tv) assignments,
+   * using the original vertex labels; so only the remaining pattern
+   * vertices are searched, e.g. when re-solving a slightly changed problem
+   * around an earlier solution. Throws if a pattern vertex is not in
+   * the pattern graph. Only read when the MainSolver is constructed.
+   */
+  std::vector<std::pair<VertexWSM, VertexWSM>> fixed_assignments;
+
+  /** If nonempty, a complete valid solution (using the original vertex
+   * labels) already known to the caller, e.g. from an earlier similar
+   * problem. If only the best solution is wanted, this is the initial
+   * incumbent: only strictly better solutions are searched for, and it is
+   * returned if none is found. If multiple solutions are wanted, only
+   * solutions at least as good as this are searched for.
+   * Throws if it is not a valid solution, or is inconsistent with
+   * fixed_assignments. Only read when the MainSolver is constructed.
+   */
+  std::vector<std::pair<VertexWSM, VertexWSM>> initial_solution;
+
+  /** If set, every full solution is passed to this as soon as it is found,
+   * using the original vertex labels (so the caller can rank or filter
+   * solutions as they arrive, e.g. keeping only a few of them).
+   * When storing multiple solutions, they are then NOT stored,
+   * but still count towards
+   * for_multiple_full_solutions_the_max_number_to_obtain.
+   * If it returns false, the search breaks off early (but remains
+   * UNFINISHED, so that solve can be called again).
+   * Throws if used with number_of_threads > 1.
+   */
+  std::function<bool(const SolutionWSM&)> solution_callback;
+
   /** Just set the timeout in milliseconds; the most common parameter. */
   explicit MainSolverParameters(long long timeout_ms = 1000);
 };
@@ -0,0 +1,93 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <chrono>
+#include <vector>
+
+#include "../GraphTheoretic/DomainInitialiser.hpp"
+#include "SolutionWSM.hpp"
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+class NeighboursData;
+struct MainSolverParameters;
+struct PreSearchComponents;
+struct SolutionData;
+
+/** Splits the search tree below its first few assignments into subtrees,
+ * which are searched concurrently. Each thread takes the next unsearched
+ * subtree from a shared queue as soon as it has finished its last one,
+ * so threads with easy subtrees keep taking work from the others.
+ *
+ * With a single solution wanted, the lowest scalar product found by any
+ * thread bounds the search in all of them. Solutions of EQUAL weight are
+ * not pruned, so every subtree containing an optimal solution finds one;
+ * once the search is complete, the returned solution is then found again
+ * by a single-threaded search of the first such subtree, which makes it
+ * independent of the timing of the threads.
+ */
+class ParallelSearch {
+ public:
+  /** Split the search tree below the given domains.
+   * @param initial_domains The domains at the root of the search.
+   * @param pattern_ndata Data for the pattern graph.
+   * @param target_ndata Data for the target graph.
+   * @param pre_search_components Used to reduce nodes while splitting; each
+   *    thread makes its own copy to search with.
+   * @param number_of_threads The number of threads to search with.
+   * @param max_distance_reduction_value As for SearchBranch.
+   */
+  ParallelSearch(
+      const DomainInitialiser::InitialDomains& initial_domains,
+      const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+      PreSearchComponents& pre_search_components, unsigned number_of_threads,
+      unsigned max_distance_reduction_value);
+
+  /** Search all subtrees not already searched completely, updating the
+   * solutions, iterations and "finished" flag in the solution data.
+   * A subtree whose search is cut short is searched again from the start
+   * by the next call.
+   * @param parameters The parameters which configure the solving algorithm.
+   * @param max_iterations Stop once the total number of iterations in the
+   *    solution data reaches this.
+   * @param desired_end_time Stop once this time has passed.
+   * @param solution_data The data to update.
+   */
+  void solve(
+      const MainSolverParameters& parameters, std::size_t max_iterations,
+      const std::chrono::steady_clock::time_point& desired_end_time,
+      SolutionData& solution_data);
+
+  /** The number of subtrees the search tree was split into. */
+  std::size_t get_number_of_subtrees() const;
+
+ private:
+  struct Subtree {
+    DomainInitialiser::InitialDomains domains;
+    bool finished = false;
+    // With a single solution wanted, at most one: the best found.
+    std::vector<SolutionWSM> solutions;
+  };
+
+  const NeighboursData& m_pattern_ndata;
+  const NeighboursData& m_target_ndata;
+  const unsigned m_number_of_threads;
+  const unsigned m_max_distance_reduction_value;
+  std::vector<Subtree> m_subtrees;
+};
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
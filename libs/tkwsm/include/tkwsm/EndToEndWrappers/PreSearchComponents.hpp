@@ -14,6 +14,7 @@
 
 #pragma once
 #include <limits>
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -34,10 +35,24 @@ struct PreSearchComponents {
   const NeighboursData& pattern_ndata;
   const NeighboursData& target_ndata;
   NearNeighboursData pattern_near_ndata;
-  NearNeighboursData target_near_ndata;
+
+ private:
+  // Only used if the target near neighbours data was not passed in.
+  std::unique_ptr<NearNeighboursData> m_own_target_near_ndata_ptr;
+
+ public:
+  NearNeighboursData& target_near_ndata;
 
   PreSearchComponents(
       const NeighboursData& pattern_ndata, const NeighboursData& target_ndata);
+
+  /** Reuse near neighbours data for the target graph, calculated
+   * by earlier searches with the same target graph (and updated by this one).
+   * It must outlive this object.
+   */
+  PreSearchComponents(
+      const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+      NearNeighboursData& target_near_ndata);
 };
 
 }  // namespace WeightedSubgraphMonomorphism
@@ -15,6 +15,7 @@
 #pragma once
 #include <tkrng/RNG.hpp>
 
+#include "tkwsm/Searching/SearchBranch.hpp"
 #include "tkwsm/Searching/ValueOrdering.hpp"
 #include "tkwsm/Searching/VariableOrdering.hpp"
 
@@ -28,5 +29,28 @@ struct SearchComponents {
   RNG rng;
 };
 
+struct SolutionWSM;
+
+/** Do NOT backtrack, just move down directly from the current (reduced) node
+ * of the branch as far as possible, i.e. a single solve iteration,
+ * choosing variables and values with the given components.
+ * @param search_components The variable and value orderings to use.
+ * @param search_branch The branch to move down.
+ * @param target_ndata Data for the target graph.
+ * @param reduction_parameters Parameters for reducing each new node.
+ * @return TRUE if we end with a full solution, false otherwise.
+ */
+bool move_down_from_reduced_node(
+    SearchComponents& search_components, SearchBranch& search_branch,
+    const NeighboursData& target_ndata,
+    const SearchBranch::ReductionParameters& reduction_parameters);
+
+/** Overwrite the solution with the full assignment in the current node.
+ * @param accessor Access to the current node, where every PV is assigned.
+ * @param solution The solution to overwrite.
+ */
+void write_solution_from_final_node(
+    const DomainsAccessor& accessor, SolutionWSM& solution);
+
 }  // namespace WeightedSubgraphMonomorphism
 }  // namespace tket
@@ -21,6 +21,37 @@
 namespace tket {
 namespace WeightedSubgraphMonomorphism {
 
+/** Counts of events during the search, for profiling;
+ * each is a single increment, so they are always collected.
+ */
+struct SearchCounters {
+  /** How many times did the search move down to a new node? */
+  std::size_t number_of_nodes_expanded = 0;
+
+  /** How many times did a DistancesReducer prune, i.e. reject an assignment
+   * in its check, or create new assignments or a nogood by reducing?
+   */
+  std::size_t number_of_distances_reductions = 0;
+
+  /** How many times did HallSetReduction create new assignments or a
+   * nogood?
+   */
+  std::size_t number_of_hall_set_reductions = 0;
+
+  /** How many nodes were found to be nogoods by the weight nogood detector,
+   * i.e. when WeightNogoodDetectorManager registered a success?
+   */
+  std::size_t number_of_weight_nogoods = 0;
+
+  SearchCounters& operator+=(const SearchCounters& other) {
+    number_of_nodes_expanded += other.number_of_nodes_expanded;
+    number_of_distances_reductions += other.number_of_distances_reductions;
+    number_of_hall_set_reductions += other.number_of_hall_set_reductions;
+    number_of_weight_nogoods += other.number_of_weight_nogoods;
+    return *this;
+  }
+};
+
 /** These are mainly useful for testing. It is important that
  * they are all cheap to calculate.
  */
@@ -64,6 +95,31 @@ struct ExtraStatistics {
    * included it. This is very rare, but record them here.
    */
   std::vector<VertexWSM> impossible_target_vertices;
+
+  /** Summed over all search threads. */
+  SearchCounters search_counters;
+
+  /** The part of SolutionData::initialisation_time_ms spent
+   * initialising the domains.
+   */
+  long long domain_initialisation_time_ms = 0;
+
+  /** The part of SolutionData::initialisation_time_ms spent
+   * constructing the search (including splitting it between threads).
+   */
+  long long search_setup_time_ms = 0;
+};
+
+/** Recorded each time the best solution found so far improves. */
+struct WeightImprovement {
+  /** The total number of search iterations when it was found. */
+  std::size_t iterations;
+
+  /** The total search time in milliseconds when it was found. */
+  long long search_time_ms;
+
+  /** The new best scalar product. */
+  WeightWSM scalar_product;
 };
 
 struct SolutionData {
@@ -126,6 +182,17 @@ struct SolutionData {
 
   std::vector<SolutionWSM> solutions;
 
+  /** The number of solutions passed to
+   * MainSolverParameters::solution_callback instead of being stored.
+   */
+  std::size_t number_of_unstored_solutions = 0;
+
+  /** How the best scalar product fell during the search.
+   * An initial solution is not included. With more than one thread,
+   * only the best solution at the end of each solve is recorded.
+   */
+  std::vector<WeightImprovement> best_weight_trajectory;
+
   ExtraStatistics extra_statistics;
 };
 
@@ -0,0 +1,77 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <iosfwd>
+
+#include "../GraphTheoretic/DerivedGraphs.hpp"
+#include "../GraphTheoretic/DerivedGraphsCalculator.hpp"
+#include "../GraphTheoretic/NearNeighboursData.hpp"
+#include "../GraphTheoretic/NeighboursData.hpp"
+#include "../GraphTheoretic/VertexRelabelling.hpp"
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+/** All the data calculated from a target graph alone, which can be reused
+ * by many MainSolver objects with the same target graph but different
+ * pattern graphs. Most of it is calculated lazily, as searches need it,
+ * and kept for later searches; it can also be calculated in advance,
+ * and written to and read back from a stream.
+ *
+ * Not thread safe: it may only be used by one MainSolver at a time
+ * (although that solver may itself use several threads).
+ * It cannot be copied or moved, since the members refer to each other.
+ */
+struct TargetGraphData {
+  const VertexRelabelling relabelling;
+  const NeighboursData ndata;
+  NearNeighboursData near_ndata;
+
+  // Only used by derived_graphs.
+  DerivedGraphsCalculator derived_graphs_calculator;
+  DerivedGraphs derived_graphs;
+
+  /** Only the target graph itself is processed; nothing is
+   * calculated lazily yet.
+   * @param target_edges The target graph, with edge weights.
+   */
+  explicit TargetGraphData(const GraphEdgeWeights& target_edges);
+
+  /** Read data previously written by "write".
+   * Throws if the data is invalid.
+   * @param is The stream to read from.
+   */
+  explicit TargetGraphData(std::istream& is);
+
+  TargetGraphData(const TargetGraphData&) = delete;
+  TargetGraphData& operator=(const TargetGraphData&) = delete;
+
+  /** Calculate now, for every target vertex, the data that searches
+   * would otherwise calculate lazily: the vertices up to the given distance,
+   * and the derived graphs.
+   * @param max_distance The greatest distance that searches will use; see
+   *    the "max_distance..." parameters in MainSolverParameters.
+   */
+  void precompute(unsigned max_distance);
+
+  /** Write all data, including everything calculated so far,
+   * in a plain text format.
+   * @param os The stream to write to.
+   */
+  void write(std::ostream& os) const;
+};
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <iosfwd>
+
 #include "DerivedGraphStructs.hpp"
 
 namespace tket {
@@ -62,6 +64,18 @@ class DerivedGraphs {
    */
   VertexData get_data(VertexWSM v);
 
+  /** Write the data for every vertex calculated so far,
+   * as whitespace-separated integers.
+   * @param os The stream to write to.
+   */
+  void write(std::ostream& os) const;
+
+  /** Add data previously written by "write" for the same graph,
+   * for vertices not yet calculated. Throws if the data is invalid.
+   * @param is The stream to read from.
+   */
+  void read(std::istream& is);
+
  private:
   const NeighboursData& m_neighbours_data;
   DerivedGraphsCalculator& m_calculator;
@@ -73,6 +87,9 @@ class DerivedGraphs {
   std::map<VertexWSM, VertexData> m_data_for_vertices;
 
   void fill(VertexWSM v, VertexData& vertex_data);
+
+  // Once the neighbours and counts are filled in, fill in the rest.
+  void fill_sorted_counts(VertexData& vertex_data);
 };
 
 }  // namespace WeightedSubgraphMonomorphism
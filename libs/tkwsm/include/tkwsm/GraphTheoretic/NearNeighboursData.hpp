@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <iosfwd>
 #include <map>
 #include <optional>
 #include <utility>
@@ -69,6 +70,20 @@ class NearNeighboursData {
 
   std::size_t get_n_vertices_at_exact_distance(VertexWSM v, unsigned distance);
 
+  /** Write the vertices at each distance calculated so far, for every vertex,
+   * as whitespace-separated integers; everything else is quickly recalculated
+   * from these.
+   * @param os The stream to write to.
+   */
+  void write(std::ostream& os) const;
+
+  /** Replace the vertices at each distance with data previously written
+   * by "write" for the same graph; any other calculated data is discarded.
+   * Throws if the data is invalid.
+   * @param is The stream to read from.
+   */
+  void read(std::istream& is);
+
  private:
   const NeighboursData& m_ndata;
 
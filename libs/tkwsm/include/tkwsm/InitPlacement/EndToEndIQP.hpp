@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <cstddef>
 #include <optional>
 
 #include "../GraphTheoretic/GeneralStructs.hpp"
@@ -29,6 +30,16 @@ struct IQPParameters {
   // Very crude, improve! Should be set according to number of PV, TV,
   // edges, etc. etc.
   unsigned max_wsm_iterations = 10000000;
+
+  // The Monte Carlo stage runs this many independent chains, in parallel,
+  // and keeps the best; see ParallelMonteCarloSolution.
+  unsigned mcct_number_of_chains = 1;
+
+  // The chain seeds are all derived from this, so results are reproducible.
+  std::size_t mcct_master_seed = 5489;
+
+  // Zero means use as many threads as the hardware supports.
+  unsigned mcct_number_of_threads = 0;
 };
 
 /** Using all the config IQPParameters, actually calculate a solution. */
@@ -13,25 +13,54 @@
 // limitations under the License.
 
 #pragma once
+#include <tkassert/Assert.hpp>
+
 #include "../GraphTheoretic/GeneralStructs.hpp"
 
 namespace tket {
-class RNG;
 namespace WeightedSubgraphMonomorphism {
 namespace InitialPlacement {
 
 /** We want to extract only a few random bits each time,
  * assuming that generating 64 random bits is relatively slow.
- * TODO move into Utils, or maybe RNG directly.
+ * (tkrng's CounterRNG::get_bits does the same for a single stream).
  */
 class FastRandomBits {
  public:
   FastRandomBits();
 
-  /** Will call the RNG object as little as possible. */
-  std::uint64_t get_random_bits(RNG& rng, unsigned number_of_bits);
+  /** Will call the engine as little as possible.
+   * @param rng Any engine returning 64 random bits from operator(),
+   *    e.g. RNG or CounterRNG.
+   * @param number_of_bits Between 1 and 64.
+   */
+  template <class Engine>
+  std::uint64_t get_random_bits(Engine& rng, unsigned number_of_bits) {
+    TKET_ASSERT(number_of_bits >= 1);
+    TKET_ASSERT(number_of_bits <= 64);
+    if (number_of_bits <= m_number_of_random_bits) {
+      const std::uint64_t bits_to_return = m_bits & get_mask(number_of_bits);
+      m_bits >>= number_of_bits;
+      m_number_of_random_bits -= number_of_bits;
+      return bits_to_return;
+    }
+    // There are not enough random bits, so we'll need to generate more.
+    // But first, use the existing bits.
+    std::uint64_t bits_to_return = m_bits;
+    const unsigned number_of_extra_bits =
+        number_of_bits - m_number_of_random_bits;
+    bits_to_return <<= number_of_extra_bits;
+    m_bits = rng();
+    bits_to_return |= m_bits & get_mask(number_of_extra_bits);
+    m_bits >>= number_of_extra_bits;
+    m_number_of_random_bits = 64 - number_of_bits;
+    return bits_to_return;
+  }
 
  private:
+  /** The mask to extract the given number (1 to 64) of lowest bits. */
+  static std::uint64_t get_mask(unsigned number_of_bits);
+
   std::uint64_t m_bits;
   unsigned m_number_of_random_bits;
 };
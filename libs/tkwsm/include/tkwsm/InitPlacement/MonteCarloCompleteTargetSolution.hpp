@@ -42,7 +42,9 @@ class MonteCarloCompleteTargetSolution {
       WeightWSM implicit_target_weight,
       // If left unspecified, i.e. set to zero,
       // will choose a reasonable default.
-      unsigned max_iterations = 0);
+      unsigned max_iterations = 0,
+      // The default is the standard default seed of the RNG.
+      std::size_t seed = 5489);
 
   const std::vector<unsigned>& get_best_assignments() const;
 
@@ -0,0 +1,85 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "tkwsm/GraphTheoretic/GeneralStructs.hpp"
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+class NeighboursData;
+namespace InitialPlacement {
+
+/** Runs several independent MonteCarloCompleteTargetSolution chains,
+ * each with its own RNG, on a pool of threads, and keeps the best result.
+ * The chain seeds are derived from a single master seed, and the chains
+ * do not interact while running, so the result depends only on the
+ * master seed and the number of chains, NOT on the number of threads
+ * or their scheduling. With one chain and the default master seed,
+ * this gives exactly the same result as a single
+ * MonteCarloCompleteTargetSolution.
+ */
+class ParallelMonteCarloSolution {
+ public:
+  /** Upon construction, runs all the chains through to completion.
+   * The arguments are as for MonteCarloCompleteTargetSolution.
+   * @param pattern_ndata The relabelled pattern graph.
+   * @param target_ndata The relabelled explicit target graph.
+   * @param implicit_target_weight Weight of target edges not in target_ndata.
+   * @param number_of_chains The number of independent chains to run.
+   * @param master_seed The seed from which the chain seeds are derived.
+   * @param number_of_threads The maximum number of threads to use;
+   *    zero means use as many as the hardware supports.
+   * @param max_iterations_per_chain As for MonteCarloCompleteTargetSolution;
+   *    zero means choose a default.
+   */
+  ParallelMonteCarloSolution(
+      const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+      WeightWSM implicit_target_weight, unsigned number_of_chains,
+      std::size_t master_seed = 5489, unsigned number_of_threads = 0,
+      unsigned max_iterations_per_chain = 0);
+
+  /** Element[PV] is the TV assigned to it, in the best solution found. */
+  const std::vector<unsigned>& get_best_assignments() const;
+
+  /** The scalar product of the best solution found. */
+  WeightWSM get_best_scalar_product() const;
+
+  /** The total number of iterations, over all chains. */
+  unsigned iterations() const;
+
+  /** Which chain found the best solution (the lowest index, if several
+   * chains found equally good solutions). */
+  unsigned get_best_chain_index() const;
+
+  /** The seed used by the given chain.
+   * @param master_seed The master seed passed into the constructor.
+   * @param chain_index The index of the chain.
+   * @return The seed of the RNG for that chain.
+   */
+  static std::size_t get_chain_seed(
+      std::size_t master_seed, unsigned chain_index);
+
+ private:
+  std::vector<unsigned> m_best_assignments;
+  WeightWSM m_best_scalar_product;
+  unsigned m_iterations;
+  unsigned m_best_chain_index;
+};
+
+}  // namespace InitialPlacement
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
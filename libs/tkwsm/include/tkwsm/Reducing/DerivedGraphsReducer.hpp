@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <optional>
+
 #include "../GraphTheoretic/DerivedGraphs.hpp"
 #include "../GraphTheoretic/DerivedGraphsCalculator.hpp"
 #include "ReducerWrapper.hpp"
@@ -44,8 +46,16 @@ class DomainsAccessor;
  */
 class DerivedGraphsReducer : public ReducerInterface {
  public:
+  /** @param pattern_ndata Data for the pattern graph.
+   * @param target_ndata Data for the target graph.
+   * @param derived_target_graphs_ptr If not null, the derived graphs of the
+   *    target graph (which must outlive this object), reused from earlier
+   *    searches with the same target graph and updated by this one.
+   *    Otherwise, they are calculated here.
+   */
   DerivedGraphsReducer(
-      const NeighboursData& pattern_ndata, const NeighboursData& target_ndata);
+      const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+      DerivedGraphs* derived_target_graphs_ptr = nullptr);
 
   virtual bool check(std::pair<VertexWSM, VertexWSM> assignment) override;
 
@@ -59,7 +69,10 @@ class DerivedGraphsReducer : public ReducerInterface {
   DerivedGraphsCalculator m_calculator;
 
   DerivedGraphs m_derived_pattern_graphs;
-  DerivedGraphs m_derived_target_graphs;
+
+  // Only used if the derived target graphs were not passed in.
+  std::optional<DerivedGraphs> m_own_derived_target_graphs;
+  DerivedGraphs& m_derived_target_graphs;
 
   // We will call this several times with different derived graphs data.
   ReductionResult reduce_with_derived_data(
@@ -43,13 +43,16 @@ class SearchBranch {
  public:
   /** Constructs node[0], i.e. the initial node.
    * The search branch is also entirely responsible for ExtraStatistics.
+   * If not null, the derived target graphs are reused from
+   * earlier searches; see DerivedGraphsReducer.
    */
   SearchBranch(
       const DomainInitialiser::InitialDomains& initial_domains,
       const NeighboursData& pattern_ndata,
       NearNeighboursData& pattern_near_ndata,
       const NeighboursData& target_ndata, NearNeighboursData& target_near_ndata,
-      unsigned max_distance_reduction_value, ExtraStatistics& extra_statistics);
+      unsigned max_distance_reduction_value, ExtraStatistics& extra_statistics,
+      DerivedGraphs* derived_target_graphs_ptr = nullptr);
 
   /** Extra parameters to configure reducing a single node. */
   struct ReductionParameters {
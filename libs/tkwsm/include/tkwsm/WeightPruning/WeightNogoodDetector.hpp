@@ -48,11 +48,17 @@ class WeightNogoodDetector {
    * until needed, when search progress may have cut down some
    * possibilities, and hence reduced the domains slightly,
    * giving better estimates.
+   * @param pattern_neighbours_data Data for the pattern graph.
+   * @param target_neighbours_data Data for the target graph.
+   * @param initial_used_target_vertices The set of all TV which are
+   *    possible; element[tv] is set if and only if TV is possible.
+   * @param invalid_target_vertices Any TV newly found to be impossible is
+   *    inserted here.
    */
   WeightNogoodDetector(
       const NeighboursData& pattern_neighbours_data,
       const NeighboursData& target_neighbours_data,
-      std::set<VertexWSM> initial_used_target_vertices,
+      boost::dynamic_bitset<> initial_used_target_vertices,
       std::set<VertexWSM>& invalid_target_vertices);
 
   /** Return a guaranteed lower bound for the scalar product increase
@@ -80,7 +86,10 @@ class WeightNogoodDetector {
   const NeighboursData& m_pattern_neighbours_data;
   const NeighboursData& m_target_neighbours_data;
 
-  mutable std::set<VertexWSM> m_valid_target_vertices;
+  // These are looked up very frequently, once for every neighbour
+  // of every TV in every domain, so we use a bitset indexed by TV
+  // rather than a std::set.
+  mutable boost::dynamic_bitset<> m_valid_target_vertices;
 
   // As soon as a TV is newly discovered to be invalid,
   // meaning that no p-vertex could ever be assigned to it
@@ -98,15 +107,15 @@ class WeightNogoodDetector {
   // it's not "physically" const because of lazy evaluation,
   // as well as work data to avoid memory reallocation.
 
-  // KEY: a target vertex TV.
-  // VALUE: the smallest t-edge weight which can arise
-  //    from an edge containing TV.
+  // Element[tv] is the smallest t-edge weight which can arise
+  //    from an edge containing TV, or the maximum value if not yet
+  //    calculated.
   // Excludes target edges, if any, which can never arise
   // (i.e. containing at least one vertex which no pattern vertex
   // can ever map to).
   //
   // Mutable because it's lazily initialised.
-  mutable std::map<VertexWSM, WeightWSM> m_minimum_t_weights_from_tv;
+  mutable std::vector<WeightWSM> m_minimum_t_weights_from_tv;
 
   // Calculated only on first use, and cached;
   // if non-null, the minimum edge weight of any target edge
@@ -17,11 +17,15 @@
 #include <algorithm>
 #include <chrono>
 #include <numeric>
+#include <set>
+#include <stdexcept>
 #include <tkassert/Assert.hpp>
 
 #include "tkwsm/Common/GeneralUtils.hpp"
+#include "tkwsm/EndToEndWrappers/ParallelSearch.hpp"
 #include "tkwsm/EndToEndWrappers/PreSearchComponents.hpp"
 #include "tkwsm/EndToEndWrappers/SearchComponents.hpp"
+#include "tkwsm/EndToEndWrappers/TargetGraphData.hpp"
 #include "tkwsm/GraphTheoretic/DomainInitialiser.hpp"
 #include "tkwsm/WeightPruning/WeightChecker.hpp"
 
@@ -34,11 +38,28 @@ MainSolver::MainSolver(
     const GraphEdgeWeights& pattern_edges, const GraphEdgeWeights& target_edges,
     const MainSolverParameters& parameters)
     : m_pattern_vertex_relabelling(pattern_edges),
-      m_target_vertex_relabelling(target_edges),
       m_pattern_neighbours_data(
           m_pattern_vertex_relabelling.new_edges_and_weights),
-      m_target_neighbours_data(
-          m_target_vertex_relabelling.new_edges_and_weights) {
+      m_own_target_data_ptr(std::make_unique<TargetGraphData>(target_edges)),
+      m_target_data(*m_own_target_data_ptr),
+      m_target_vertex_relabelling(m_target_data.relabelling),
+      m_target_neighbours_data(m_target_data.ndata) {
+  initialise(parameters);
+}
+
+MainSolver::MainSolver(
+    const GraphEdgeWeights& pattern_edges, TargetGraphData& target_data,
+    const MainSolverParameters& parameters)
+    : m_pattern_vertex_relabelling(pattern_edges),
+      m_pattern_neighbours_data(
+          m_pattern_vertex_relabelling.new_edges_and_weights),
+      m_target_data(target_data),
+      m_target_vertex_relabelling(m_target_data.relabelling),
+      m_target_neighbours_data(m_target_data.ndata) {
+  initialise(parameters);
+}
+
+void MainSolver::initialise(const MainSolverParameters& parameters) {
   const auto num_p_vertices =
       m_pattern_neighbours_data.get_number_of_nonisolated_vertices();
   if (num_p_vertices == 0) {
@@ -47,6 +68,11 @@ MainSolver::MainSolver(
     m_solution_data.finished = true;
     return;
   }
+  // Check this first, so that an invalid solution always throws.
+  std::optional<SolutionWSM> initial_solution;
+  if (!parameters.initial_solution.empty()) {
+    initial_solution = get_relabelled_initial_solution(parameters);
+  }
   const auto num_t_vertices =
       m_target_neighbours_data.get_number_of_nonisolated_vertices();
   {
@@ -72,10 +98,12 @@ MainSolver::MainSolver(
   const auto init_start = Clock::now();
 
   m_pre_search_components_ptr = std::make_unique<PreSearchComponents>(
-      m_pattern_neighbours_data, m_target_neighbours_data);
+      m_pattern_neighbours_data, m_target_neighbours_data,
+      m_target_data.near_ndata);
   TKET_ASSERT(m_pre_search_components_ptr);
 
   {
+    const auto domain_initialisation_start = Clock::now();
     DomainInitialiser::InitialDomains initial_domains;
     const bool initialisation_succeeded =
         DomainInitialiser::full_initialisation(
@@ -83,7 +111,15 @@ MainSolver::MainSolver(
             m_pre_search_components_ptr->pattern_near_ndata,
             m_target_neighbours_data,
             m_pre_search_components_ptr->target_near_ndata,
-            parameters.max_distance_for_domain_initialisation_distance_filter);
+            parameters
+                .max_distance_for_domain_initialisation_distance_filter) &&
+        apply_fixed_assignments(parameters, initial_domains);
+
+    const auto search_setup_start = Clock::now();
+    m_solution_data.extra_statistics.domain_initialisation_time_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            search_setup_start - domain_initialisation_start)
+            .count();
 
     if (initialisation_succeeded) {
       m_search_components_ptr = std::make_unique<SearchComponents>();
@@ -95,11 +131,23 @@ MainSolver::MainSolver(
           m_target_neighbours_data,
           m_pre_search_components_ptr->target_near_ndata,
           parameters.max_distance_for_distance_reduction_during_search,
-          m_solution_data.extra_statistics);
+          m_solution_data.extra_statistics, &m_target_data.derived_graphs);
+      if (parameters.number_of_threads > 1) {
+        m_parallel_search_ptr = std::make_unique<ParallelSearch>(
+            initial_domains, m_pattern_neighbours_data,
+            m_target_neighbours_data, *m_pre_search_components_ptr,
+            parameters.number_of_threads,
+            parameters.max_distance_for_distance_reduction_during_search);
+      }
     }
+    const auto init_end = Clock::now();
+    m_solution_data.extra_statistics.search_setup_time_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            init_end - search_setup_start)
+            .count();
     m_solution_data.initialisation_time_ms =
         std::chrono::duration_cast<std::chrono::milliseconds>(
-            Clock::now() - init_start)
+            init_end - init_start)
             .count();
 
     if (!initialisation_succeeded) {
@@ -155,6 +203,15 @@ MainSolver::MainSolver(
     }
   }
 
+  if (initial_solution) {
+    initial_solution.value().total_p_edges_weight =
+        m_solution_data.total_p_edge_weights;
+    m_initial_solution = initial_solution;
+    if (parameters.for_multiple_full_solutions_the_max_number_to_obtain == 0) {
+      m_solution_data.solutions.push_back(initial_solution.value());
+    }
+  }
+
   if (m_solution_data.trivial_weight_lower_bound !=
       m_solution_data.trivial_weight_initial_upper_bound) {
     // It's not an unweighted problem, so it's worth checking for weights.
@@ -167,6 +224,7 @@ MainSolver::MainSolver(
   }
 
   const auto search_start_time = Clock::now();
+  m_search_start_time = search_start_time;
   const auto desired_search_end_time =
       search_start_time + std::chrono::milliseconds(parameters.timeout_ms);
 
@@ -181,6 +239,110 @@ MainSolver::MainSolver(
           .count();
 }
 
+// Returns null if the vertex is not in the graph.
+static std::optional<unsigned> get_new_label_opt(
+    const VertexRelabelling& relabelling, VertexWSM v) {
+  if (relabelling.old_to_new_vertex_labels.empty()) {
+    if (v < relabelling.number_of_vertices) {
+      return v;
+    }
+    return {};
+  }
+  return get_optional_value(relabelling.old_to_new_vertex_labels, v);
+}
+
+SolutionWSM MainSolver::get_relabelled_initial_solution(
+    const MainSolverParameters& parameters) const {
+  const unsigned number_of_pv =
+      m_pattern_neighbours_data.get_number_of_nonisolated_vertices();
+  std::vector<std::optional<unsigned>> new_tv_by_new_pv(number_of_pv);
+  std::set<unsigned> used_new_tv;
+  for (const auto& [pv, tv] : parameters.initial_solution) {
+    const auto new_pv_opt = get_new_label_opt(m_pattern_vertex_relabelling, pv);
+    const auto new_tv_opt = get_new_label_opt(m_target_vertex_relabelling, tv);
+    if (!new_pv_opt || !new_tv_opt) {
+      throw std::runtime_error("Initial solution has an unknown vertex");
+    }
+    if (new_tv_by_new_pv[new_pv_opt.value()] ||
+        !used_new_tv.insert(new_tv_opt.value()).second) {
+      throw std::runtime_error("Initial solution reuses a vertex");
+    }
+    new_tv_by_new_pv[new_pv_opt.value()] = new_tv_opt.value();
+  }
+  if (used_new_tv.size() != number_of_pv) {
+    throw std::runtime_error("Initial solution is incomplete");
+  }
+  for (const auto& [pv, tv] : parameters.fixed_assignments) {
+    const auto new_pv_opt = get_new_label_opt(m_pattern_vertex_relabelling, pv);
+    if (new_pv_opt &&
+        get_new_label_opt(m_target_vertex_relabelling, tv) !=
+            new_tv_by_new_pv[new_pv_opt.value()]) {
+      throw std::runtime_error(
+          "Initial solution does not contain the fixed assignments");
+    }
+  }
+  SolutionWSM solution;
+  solution.assignments.reserve(number_of_pv);
+  for (unsigned new_pv = 0; new_pv < number_of_pv; ++new_pv) {
+    const unsigned new_tv = new_tv_by_new_pv[new_pv].value();
+    solution.assignments.emplace_back(new_pv, new_tv);
+    for (const auto& [other_pv, p_weight] :
+         m_pattern_neighbours_data.get_neighbours_and_weights(new_pv)) {
+      if (other_pv < new_pv) {
+        continue;
+      }
+      const auto t_weight_opt = m_target_neighbours_data.get_edge_weight_opt(
+          new_tv, new_tv_by_new_pv[other_pv].value());
+      if (!t_weight_opt) {
+        throw std::runtime_error("Initial solution is not a monomorphism");
+      }
+      solution.scalar_product = get_sum_or_throw(
+          solution.scalar_product,
+          get_product_or_throw(p_weight, t_weight_opt.value()));
+    }
+  }
+  return solution;
+}
+
+std::optional<WeightWSM> MainSolver::get_weight_upper_bound(
+    const MainSolverParameters& parameters) const {
+  if (!m_initial_solution) {
+    return parameters.weight_upper_bound_constraint;
+  }
+  WeightWSM bound = m_initial_solution.value().scalar_product;
+  if (parameters.for_multiple_full_solutions_the_max_number_to_obtain == 0) {
+    // Only strictly better solutions; the caller checked that this is
+    // possible.
+    TKET_ASSERT(bound > 0);
+    --bound;
+  }
+  if (parameters.weight_upper_bound_constraint) {
+    bound = std::min(bound, parameters.weight_upper_bound_constraint.value());
+  }
+  return bound;
+}
+
+bool MainSolver::apply_fixed_assignments(
+    const MainSolverParameters& parameters,
+    std::vector<boost::dynamic_bitset<>>& initial_domains) const {
+  for (const auto& [pv, tv] : parameters.fixed_assignments) {
+    const auto new_pv_opt = get_new_label_opt(m_pattern_vertex_relabelling, pv);
+    if (!new_pv_opt) {
+      throw std::runtime_error(
+          "Fixed assignment has an unknown pattern vertex");
+    }
+    boost::dynamic_bitset<>& domain = initial_domains.at(new_pv_opt.value());
+    const auto new_tv_opt = get_new_label_opt(m_target_vertex_relabelling, tv);
+    if (!new_tv_opt || !domain.test(new_tv_opt.value())) {
+      // Either tv is isolated, or cannot be the image of pv.
+      return false;
+    }
+    domain.reset();
+    domain.set(new_tv_opt.value());
+  }
+  return true;
+}
+
 MainSolver::~MainSolver() {}
 
 const SolutionData& MainSolver::get_solution_data() const {
@@ -194,22 +356,26 @@ const SolutionData& MainSolver::get_solution_data() const {
   // We must relabel some vertices.
   m_solution_data_original_vertices = m_solution_data;
   for (SolutionWSM& solution : m_solution_data_original_vertices.solutions) {
-    if (!m_pattern_vertex_relabelling.new_to_old_vertex_labels.empty()) {
-      for (std::pair<VertexWSM, VertexWSM>& assignment : solution.assignments) {
-        assignment.first =
-            m_pattern_vertex_relabelling.new_to_old_vertex_labels.at(
-                assignment.first);
-      }
+    relabel_to_original_vertices(solution);
+  }
+  return m_solution_data_original_vertices;
+}
+
+void MainSolver::relabel_to_original_vertices(SolutionWSM& solution) const {
+  if (!m_pattern_vertex_relabelling.new_to_old_vertex_labels.empty()) {
+    for (std::pair<VertexWSM, VertexWSM>& assignment : solution.assignments) {
+      assignment.first =
+          m_pattern_vertex_relabelling.new_to_old_vertex_labels.at(
+              assignment.first);
     }
-    if (!m_target_vertex_relabelling.new_to_old_vertex_labels.empty()) {
-      for (std::pair<VertexWSM, VertexWSM>& assignment : solution.assignments) {
-        assignment.second =
-            m_target_vertex_relabelling.new_to_old_vertex_labels.at(
-                assignment.second);
-      }
+  }
+  if (!m_target_vertex_relabelling.new_to_old_vertex_labels.empty()) {
+    for (std::pair<VertexWSM, VertexWSM>& assignment : solution.assignments) {
+      assignment.second =
+          m_target_vertex_relabelling.new_to_old_vertex_labels.at(
+              assignment.second);
     }
   }
-  return m_solution_data_original_vertices;
 }
 
 void MainSolver::solve(const MainSolverParameters& parameters) {
@@ -217,6 +383,7 @@ void MainSolver::solve(const MainSolverParameters& parameters) {
     return;
   }
   const auto search_start_time = Clock::now();
+  m_search_start_time = search_start_time;
   const auto desired_search_end_time =
       search_start_time + std::chrono::milliseconds(parameters.timeout_ms);
   const auto max_iterations_opt = get_checked_sum(
@@ -240,7 +407,8 @@ static bool terminate_with_enough_full_solutions(
     return parameters.terminate_with_first_full_solution &&
            !solution_data.solutions.empty();
   }
-  return solution_data.solutions.size() >=
+  return solution_data.solutions.size() +
+             solution_data.number_of_unstored_solutions >=
          parameters.for_multiple_full_solutions_the_max_number_to_obtain;
 }
 
@@ -254,6 +422,37 @@ void MainSolver::internal_solve(
   TKET_ASSERT(m_pre_search_components_ptr);
   TKET_ASSERT(m_search_branch_ptr);
 
+  if (m_parallel_search_ptr) {
+    if (parameters.solution_callback) {
+      throw std::runtime_error(
+          "A solution callback cannot be used with more than one thread");
+    }
+    // The parallel search replaces the stored solutions.
+    const bool has_initial_solution =
+        parameters.for_multiple_full_solutions_the_max_number_to_obtain == 0 &&
+        m_initial_solution;
+    if (has_initial_solution) {
+      if (m_initial_solution.value().scalar_product == 0) {
+        // We can't do better than zero!
+        m_solution_data.finished = true;
+        return;
+      }
+      m_solution_data.solutions.clear();
+    }
+    MainSolverParameters bounded_parameters = parameters;
+    bounded_parameters.weight_upper_bound_constraint =
+        get_weight_upper_bound(parameters);
+    m_parallel_search_ptr->solve(
+        bounded_parameters, max_iterations, desired_end_time, m_solution_data);
+    for (const SolutionWSM& solution : m_solution_data.solutions) {
+      record_weight_improvement(solution.scalar_product);
+    }
+    if (has_initial_solution && m_solution_data.solutions.empty()) {
+      m_solution_data.solutions.push_back(m_initial_solution.value());
+    }
+    return;
+  }
+
   SearchBranch::ReductionParameters reduction_parameters;
   decltype(reduction_parameters.max_weight) initial_weight_upper_bound;
 
@@ -263,6 +462,11 @@ void MainSolver::internal_solve(
   } else {
     set_maximum(initial_weight_upper_bound);
   }
+  if (parameters.for_multiple_full_solutions_the_max_number_to_obtain > 0 &&
+      m_initial_solution) {
+    initial_weight_upper_bound = std::min(
+        initial_weight_upper_bound, m_initial_solution.value().scalar_product);
+  }
 
   while (m_solution_data.iterations < max_iterations) {
     // Set the maximum weight.
@@ -333,13 +537,15 @@ void MainSolver::internal_solve(
         return;
       }
     }
-    if (move_down_from_reduced_node(reduction_parameters)) {
+    if (move_down_from_reduced_node(
+            *m_search_components_ptr, *m_search_branch_ptr,
+            m_target_neighbours_data, reduction_parameters)) {
       // We've GOT a complete solution! Note that it MUST be good enough
       // to add, since we've set the max weight already.
       // We also already checked that we haven't yet got too many,
       // if we're storing more than one.
-      add_solution_from_final_node(parameters, reduction_parameters);
-      if (terminate_with_enough_full_solutions(parameters, m_solution_data)) {
+      if (!add_solution_from_final_node(parameters, reduction_parameters) ||
+          terminate_with_enough_full_solutions(parameters, m_solution_data)) {
         return;
       }
     }
@@ -349,7 +555,7 @@ void MainSolver::internal_solve(
   }
 }
 
-void MainSolver::add_solution_from_final_node(
+bool MainSolver::add_solution_from_final_node(
     const MainSolverParameters& parameters,
     const SearchBranch::ReductionParameters& reduction_parameters) {
   TKET_ASSERT(m_pre_search_components_ptr);
@@ -364,67 +570,46 @@ void MainSolver::add_solution_from_final_node(
 
   TKET_ASSERT(scalar_product <= reduction_parameters.max_weight);
 
+  record_weight_improvement(scalar_product);
+  const bool store_multiple_solutions =
+      parameters.for_multiple_full_solutions_the_max_number_to_obtain > 0;
+  if (parameters.solution_callback) {
+    SolutionWSM solution;
+    write_solution_from_final_node(accessor, solution);
+    if (store_multiple_solutions) {
+      ++m_solution_data.number_of_unstored_solutions;
+    } else {
+      // We still need the best solution, to bound the search.
+      if (m_solution_data.solutions.empty()) {
+        m_solution_data.solutions.emplace_back();
+      }
+      m_solution_data.solutions.back() = solution;
+    }
+    relabel_to_original_vertices(solution);
+    return parameters.solution_callback(solution);
+  }
   // We'll overwrite the solution into back().
-  if (parameters.for_multiple_full_solutions_the_max_number_to_obtain > 0 ||
-      m_solution_data.solutions.empty()) {
+  if (store_multiple_solutions || m_solution_data.solutions.empty()) {
     m_solution_data.solutions.emplace_back();
   }
-  std::vector<std::pair<VertexWSM, VertexWSM>>& assignments =
-      m_solution_data.solutions.back().assignments;
-  const auto number_of_pv = accessor.get_number_of_pattern_vertices();
-  assignments.clear();
-  assignments.reserve(number_of_pv);
-
-  for (unsigned pv = 0; pv < number_of_pv; ++pv) {
-    const BitsetInformation bitset_information(accessor.get_domain(pv));
-    TKET_ASSERT(bitset_information.single_element);
-    assignments.emplace_back(pv, bitset_information.single_element.value());
-  }
-  m_solution_data.solutions.back().scalar_product = scalar_product;
-
-  m_solution_data.solutions.back().total_p_edges_weight =
-      m_solution_data.total_p_edge_weights;
+  write_solution_from_final_node(accessor, m_solution_data.solutions.back());
+  return true;
 }
 
-bool MainSolver::move_down_from_reduced_node(
-    const SearchBranch::ReductionParameters& reduction_parameters) {
-  TKET_ASSERT(m_search_components_ptr);
-  TKET_ASSERT(m_search_branch_ptr);
-
-  for (;;) {
-    const VariableOrdering::Result next_var_result =
-        m_search_components_ptr->variable_ordering.get_variable(
-            m_search_branch_ptr->get_domains_accessor_nonconst(),
-            m_search_components_ptr->rng);
-
-    if (next_var_result.empty_domain) {
-      return false;
-    }
-    if (!next_var_result.variable_opt) {
-      // If no variable to choose, it means we've got a full solution
-      // (every PV is assigned).
-      // Before we reached here, we already checked that any new pattern edges
-      // joining any newly assigned PV to an existing assigned PV
-      // ARE indeed mapped to valid target edges,
-      // so we don't need any further validity check.
-      break;
-    }
-    // We've chosen a variable (i.e., PV) to assign:
-    const VertexWSM& next_pv = next_var_result.variable_opt.value();
-
-    // Now choose a value (i.e., some TV in Domain(PV)).
-    // Thus the new assignment will be next_pv -> next_tv.
-    const VertexWSM next_tv =
-        m_search_components_ptr->value_ordering.get_target_value(
-            m_search_branch_ptr->get_domains_accessor().get_domain(next_pv),
-            m_target_neighbours_data, m_search_components_ptr->rng);
-
-    m_search_branch_ptr->move_down(next_pv, next_tv);
-    if (!m_search_branch_ptr->reduce_current_node(reduction_parameters)) {
-      return false;
-    }
+void MainSolver::record_weight_improvement(WeightWSM scalar_product) {
+  std::vector<WeightImprovement>& trajectory =
+      m_solution_data.best_weight_trajectory;
+  if (!trajectory.empty() &&
+      trajectory.back().scalar_product <= scalar_product) {
+    return;
   }
-  return true;
+  const long long search_time_ms =
+      m_solution_data.search_time_ms +
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          Clock::now() - m_search_start_time)
+          .count();
+  trajectory.push_back(
+      {m_solution_data.iterations, search_time_ms, scalar_product});
 }
 
 }  // namespace WeightedSubgraphMonomorphism
@@ -36,7 +36,8 @@ MainSolverParameters::MainSolverParameters(long long timeout_millisecs)
       // the WeightNogoodDetectorManager...but that would be
       // complicated.
       max_distance_for_domain_initialisation_distance_filter(2),
-      max_distance_for_distance_reduction_during_search(6) {}
+      max_distance_for_distance_reduction_during_search(6),
+      number_of_threads(1) {}
 
 }  // namespace WeightedSubgraphMonomorphism
 }  // namespace tket
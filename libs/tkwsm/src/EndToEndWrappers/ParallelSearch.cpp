@@ -0,0 +1,388 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tkwsm/EndToEndWrappers/ParallelSearch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <tkassert/Assert.hpp>
+
+#include "tkwsm/Common/GeneralUtils.hpp"
+#include "tkwsm/EndToEndWrappers/MainSolverParameters.hpp"
+#include "tkwsm/EndToEndWrappers/PreSearchComponents.hpp"
+#include "tkwsm/EndToEndWrappers/SearchComponents.hpp"
+#include "tkwsm/EndToEndWrappers/SolutionData.hpp"
+#include "tkwsm/WeightPruning/WeightChecker.hpp"
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+typedef std::chrono::steady_clock Clock;
+
+namespace {
+
+// Shared between all the threads of a single solve.
+struct SharedState {
+  std::atomic<std::size_t> next_subtree_index = 0;
+  std::atomic<std::size_t> iterations = 0;
+  std::atomic<std::size_t> number_of_solutions = 0;
+  std::atomic<WeightWSM> best_scalar_product;
+  std::atomic<bool> stop = false;
+};
+
+// Fixed for all the subtrees of a single solve.
+struct SubtreeSearchParameters {
+  WeightWSM weight_upper_bound;
+  WeightWSM weight_lower_bound;
+  // If nonzero, store every solution, and stop once this many
+  // are stored over all subtrees.
+  std::size_t max_number_of_solutions;
+  bool terminate_with_first_full_solution;
+  std::size_t max_iterations;
+  Clock::time_point end_time;
+  // If set, activate the weight checker with this total p-edge weight.
+  std::optional<WeightWSM> total_p_edge_weights_for_weight_checker;
+};
+
+}  // namespace
+
+// Search a single subtree from the start, as MainSolver does for the whole
+// tree. Returns true if the subtree was searched completely.
+static bool search_subtree(
+    const DomainInitialiser::InitialDomains& domains,
+    std::vector<SolutionWSM>& solutions, const NeighboursData& pattern_ndata,
+    const NeighboursData& target_ndata,
+    PreSearchComponents& pre_search_components,
+    unsigned max_distance_reduction_value,
+    const SubtreeSearchParameters& parameters, SharedState& shared_state,
+    SearchCounters& search_counters) {
+  SearchComponents search_components;
+  ExtraStatistics extra_statistics;
+  // Add the counters however we leave the search.
+  struct CountersAdder {
+    SearchCounters& total;
+    const SearchCounters& subtree;
+    ~CountersAdder() { total += subtree; }
+  } counters_adder{search_counters, extra_statistics.search_counters};
+  SearchBranch search_branch(
+      domains, pattern_ndata, pre_search_components.pattern_near_ndata,
+      target_ndata, pre_search_components.target_near_ndata,
+      max_distance_reduction_value, extra_statistics);
+  if (parameters.total_p_edge_weights_for_weight_checker) {
+    search_branch.activate_weight_checker(
+        parameters.total_p_edge_weights_for_weight_checker.value());
+  }
+  const bool store_all_solutions = parameters.max_number_of_solutions > 0;
+  SearchBranch::ReductionParameters reduction_parameters;
+
+  for (bool first_iteration = true;; first_iteration = false) {
+    if (shared_state.stop) {
+      return false;
+    }
+    reduction_parameters.max_weight = parameters.weight_upper_bound;
+    if (!store_all_solutions) {
+      // Solutions as good as the best found elsewhere are still allowed,
+      // so that which ones we find doesn't depend on the other threads;
+      // but within this subtree, only strictly better solutions.
+      reduction_parameters.max_weight = std::min(
+          reduction_parameters.max_weight,
+          shared_state.best_scalar_product.load());
+      if (!solutions.empty()) {
+        if (solutions[0].scalar_product == 0) {
+          // We can't do better than zero!
+          return true;
+        }
+        reduction_parameters.max_weight = std::min(
+            reduction_parameters.max_weight, solutions[0].scalar_product - 1);
+      }
+    }
+    if (reduction_parameters.max_weight < parameters.weight_lower_bound) {
+      return true;
+    }
+    if (shared_state.iterations++ >= parameters.max_iterations) {
+      --shared_state.iterations;
+      shared_state.stop = true;
+      return false;
+    }
+    // On the first move ONLY, we don't backtrack; but we also haven't reduced.
+    const bool reduced =
+        first_iteration
+            ? search_branch.reduce_current_node(reduction_parameters)
+            : search_branch.backtrack(reduction_parameters);
+    if (!reduced) {
+      return true;
+    }
+    if (move_down_from_reduced_node(
+            search_components, search_branch, target_ndata,
+            reduction_parameters)) {
+      if (store_all_solutions) {
+        solutions.emplace_back();
+        write_solution_from_final_node(
+            search_branch.get_domains_accessor(), solutions.back());
+        if (++shared_state.number_of_solutions >=
+            parameters.max_number_of_solutions) {
+          shared_state.stop = true;
+        }
+      } else {
+        solutions.resize(1);
+        write_solution_from_final_node(
+            search_branch.get_domains_accessor(), solutions[0]);
+        const WeightWSM scalar_product = solutions[0].scalar_product;
+        WeightWSM best = shared_state.best_scalar_product.load();
+        while (scalar_product < best &&
+               !shared_state.best_scalar_product.compare_exchange_weak(
+                   best, scalar_product)) {
+        }
+        if (parameters.terminate_with_first_full_solution) {
+          shared_state.stop = true;
+        }
+      }
+    }
+    if (Clock::now() >= parameters.end_time) {
+      shared_state.stop = true;
+      return false;
+    }
+  }
+}
+
+ParallelSearch::ParallelSearch(
+    const DomainInitialiser::InitialDomains& initial_domains,
+    const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+    PreSearchComponents& pre_search_components, unsigned number_of_threads,
+    unsigned max_distance_reduction_value)
+    : m_pattern_ndata(pattern_ndata),
+      m_target_ndata(target_ndata),
+      m_number_of_threads(number_of_threads),
+      m_max_distance_reduction_value(max_distance_reduction_value) {
+  // Several subtrees per thread, so that the work can be balanced
+  // when some subtrees are much harder than others.
+  const std::size_t desired_number_of_subtrees = 4 * number_of_threads;
+
+  // Split in the same way that the single-threaded search would
+  // move down, i.e. with the same variable ordering, one level at a time,
+  // so that no work is duplicated.
+  SearchComponents search_components;
+  SearchBranch::ReductionParameters reduction_parameters;
+  set_maximum(reduction_parameters.max_weight);
+  std::vector<DomainInitialiser::InitialDomains> leaves{initial_domains};
+  bool split = true;
+  while (split && leaves.size() < desired_number_of_subtrees) {
+    split = false;
+    std::vector<DomainInitialiser::InitialDomains> next_leaves;
+    for (const DomainInitialiser::InitialDomains& domains : leaves) {
+      ExtraStatistics extra_statistics;
+      SearchBranch search_branch(
+          domains, m_pattern_ndata, pre_search_components.pattern_near_ndata,
+          m_target_ndata, pre_search_components.target_near_ndata,
+          m_max_distance_reduction_value, extra_statistics);
+      if (!search_branch.reduce_current_node(reduction_parameters)) {
+        // There are no solutions below here.
+        continue;
+      }
+      const VariableOrdering::Result next_var_result =
+          search_components.variable_ordering.get_variable(
+              search_branch.get_domains_accessor_nonconst(),
+              search_components.rng);
+      if (next_var_result.empty_domain) {
+        continue;
+      }
+      if (!next_var_result.variable_opt) {
+        // A full solution; nothing to split.
+        next_leaves.push_back(domains);
+        continue;
+      }
+      const DomainsAccessor& accessor = search_branch.get_domains_accessor();
+      DomainInitialiser::InitialDomains reduced_domains(domains.size());
+      for (unsigned pv = 0; pv < domains.size(); ++pv) {
+        reduced_domains[pv] = accessor.get_domain(pv);
+      }
+      const VertexWSM pv = next_var_result.variable_opt.value();
+      const boost::dynamic_bitset<> domain = reduced_domains[pv];
+      for (auto tv = domain.find_first(); tv < domain.size();
+           tv = domain.find_next(tv)) {
+        next_leaves.push_back(reduced_domains);
+        next_leaves.back()[pv].reset();
+        next_leaves.back()[pv].set(tv);
+      }
+      split = true;
+    }
+    leaves = std::move(next_leaves);
+  }
+  m_subtrees.resize(leaves.size());
+  for (unsigned ii = 0; ii < leaves.size(); ++ii) {
+    m_subtrees[ii].domains = std::move(leaves[ii]);
+  }
+}
+
+std::size_t ParallelSearch::get_number_of_subtrees() const {
+  return m_subtrees.size();
+}
+
+void ParallelSearch::solve(
+    const MainSolverParameters& parameters, std::size_t max_iterations,
+    const std::chrono::steady_clock::time_point& desired_end_time,
+    SolutionData& solution_data) {
+  SubtreeSearchParameters subtree_parameters;
+  if (parameters.weight_upper_bound_constraint) {
+    subtree_parameters.weight_upper_bound =
+        parameters.weight_upper_bound_constraint.value();
+  } else {
+    set_maximum(subtree_parameters.weight_upper_bound);
+  }
+  subtree_parameters.weight_lower_bound =
+      solution_data.trivial_weight_lower_bound;
+  subtree_parameters.max_number_of_solutions =
+      parameters.for_multiple_full_solutions_the_max_number_to_obtain;
+  subtree_parameters.terminate_with_first_full_solution =
+      parameters.terminate_with_first_full_solution;
+  subtree_parameters.max_iterations = max_iterations;
+  subtree_parameters.end_time = desired_end_time;
+  if (solution_data.trivial_weight_lower_bound !=
+      solution_data.trivial_weight_initial_upper_bound) {
+    // As for the single-threaded search.
+    subtree_parameters.total_p_edge_weights_for_weight_checker =
+        solution_data.total_p_edge_weights;
+  }
+  const bool store_all_solutions =
+      subtree_parameters.max_number_of_solutions > 0;
+
+  SharedState shared_state;
+  shared_state.iterations = solution_data.iterations;
+  WeightWSM best_scalar_product;
+  set_maximum(best_scalar_product);
+  std::vector<std::size_t> unfinished_subtrees;
+  for (std::size_t ii = 0; ii < m_subtrees.size(); ++ii) {
+    Subtree& subtree = m_subtrees[ii];
+    if (!subtree.finished) {
+      unfinished_subtrees.push_back(ii);
+      if (store_all_solutions) {
+        // It will find these again.
+        subtree.solutions.clear();
+      }
+    }
+    shared_state.number_of_solutions += subtree.solutions.size();
+    if (!store_all_solutions && !subtree.solutions.empty()) {
+      best_scalar_product =
+          std::min(best_scalar_product, subtree.solutions[0].scalar_product);
+    }
+  }
+  shared_state.best_scalar_product = best_scalar_product;
+
+  const unsigned number_of_threads = std::min<std::size_t>(
+      m_number_of_threads, unfinished_subtrees.size());
+  std::vector<std::exception_ptr> errors(number_of_threads);
+  std::vector<SearchCounters> search_counters(number_of_threads);
+  auto work = [&](unsigned thread_index) {
+    try {
+      // The near neighbours data are filled in as they are used,
+      // so cannot be shared.
+      PreSearchComponents pre_search_components(
+          m_pattern_ndata, m_target_ndata);
+      for (;;) {
+        const std::size_t index = shared_state.next_subtree_index++;
+        if (index >= unfinished_subtrees.size() || shared_state.stop) {
+          return;
+        }
+        Subtree& subtree = m_subtrees[unfinished_subtrees[index]];
+        subtree.finished = search_subtree(
+            subtree.domains, subtree.solutions, m_pattern_ndata,
+            m_target_ndata, pre_search_components,
+            m_max_distance_reduction_value, subtree_parameters, shared_state,
+            search_counters[thread_index]);
+      }
+    } catch (...) {
+      errors[thread_index] = std::current_exception();
+      shared_state.stop = true;
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(number_of_threads);
+  for (unsigned ii = 0; ii < number_of_threads; ++ii) {
+    threads.emplace_back(work, ii);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const SearchCounters& counters : search_counters) {
+    solution_data.extra_statistics.search_counters += counters;
+  }
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  solution_data.iterations = shared_state.iterations;
+  solution_data.finished = std::all_of(
+      m_subtrees.cbegin(), m_subtrees.cend(),
+      [](const Subtree& subtree) { return subtree.finished; });
+
+  solution_data.solutions.clear();
+  if (store_all_solutions) {
+    for (const Subtree& subtree : m_subtrees) {
+      solution_data.solutions.insert(
+          solution_data.solutions.end(), subtree.solutions.cbegin(),
+          subtree.solutions.cend());
+    }
+    if (solution_data.solutions.size() >
+        subtree_parameters.max_number_of_solutions) {
+      solution_data.solutions.resize(
+          subtree_parameters.max_number_of_solutions);
+    }
+    return;
+  }
+  std::optional<std::size_t> best_index;
+  for (std::size_t ii = 0; ii < m_subtrees.size(); ++ii) {
+    if (!m_subtrees[ii].solutions.empty() &&
+        (!best_index ||
+         m_subtrees[ii].solutions[0].scalar_product <
+             m_subtrees[best_index.value()].solutions[0].scalar_product)) {
+      best_index = ii;
+    }
+  }
+  if (!best_index) {
+    return;
+  }
+  const Subtree& best_subtree = m_subtrees[best_index.value()];
+  if (!solution_data.finished) {
+    solution_data.solutions.push_back(best_subtree.solutions[0]);
+    return;
+  }
+  // Every subtree containing an optimal solution found one, so this is the
+  // first such subtree whatever the timing of the threads. Find the first
+  // optimal solution in it again, without the other threads.
+  SharedState confirmation_state;
+  confirmation_state.iterations = solution_data.iterations;
+  confirmation_state.best_scalar_product =
+      best_subtree.solutions[0].scalar_product;
+  subtree_parameters.terminate_with_first_full_solution = true;
+  set_maximum(subtree_parameters.max_iterations);
+  subtree_parameters.end_time = Clock::time_point::max();
+  PreSearchComponents pre_search_components(m_pattern_ndata, m_target_ndata);
+  search_subtree(
+      best_subtree.domains, solution_data.solutions, m_pattern_ndata,
+      m_target_ndata, pre_search_components, m_max_distance_reduction_value,
+      subtree_parameters, confirmation_state,
+      solution_data.extra_statistics.search_counters);
+  TKET_ASSERT(solution_data.solutions.size() == 1);
+  TKET_ASSERT(
+      solution_data.solutions[0].scalar_product ==
+      best_subtree.solutions[0].scalar_product);
+  solution_data.iterations = confirmation_state.iterations;
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -22,7 +22,17 @@ PreSearchComponents::PreSearchComponents(
     : pattern_ndata(pattern_nd),
       target_ndata(target_nd),
       pattern_near_ndata(pattern_ndata),
-      target_near_ndata(target_ndata) {}
+      m_own_target_near_ndata_ptr(
+          std::make_unique<NearNeighboursData>(target_ndata)),
+      target_near_ndata(*m_own_target_near_ndata_ptr) {}
+
+PreSearchComponents::PreSearchComponents(
+    const NeighboursData& pattern_nd, const NeighboursData& target_nd,
+    NearNeighboursData& target_near_nd)
+    : pattern_ndata(pattern_nd),
+      target_ndata(target_nd),
+      pattern_near_ndata(pattern_ndata),
+      target_near_ndata(target_near_nd) {}
 
 }  // namespace WeightedSubgraphMonomorphism
 }  // namespace tket
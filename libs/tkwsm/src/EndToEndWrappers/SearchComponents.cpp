@@ -0,0 +1,81 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tkwsm/EndToEndWrappers/SearchComponents.hpp"
+
+#include <tkassert/Assert.hpp>
+
+#include "tkwsm/EndToEndWrappers/SolutionWSM.hpp"
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+bool move_down_from_reduced_node(
+    SearchComponents& search_components, SearchBranch& search_branch,
+    const NeighboursData& target_ndata,
+    const SearchBranch::ReductionParameters& reduction_parameters) {
+  for (;;) {
+    const VariableOrdering::Result next_var_result =
+        search_components.variable_ordering.get_variable(
+            search_branch.get_domains_accessor_nonconst(),
+            search_components.rng);
+
+    if (next_var_result.empty_domain) {
+      return false;
+    }
+    if (!next_var_result.variable_opt) {
+      // If no variable to choose, it means we've got a full solution
+      // (every PV is assigned).
+      // Before we reached here, we already checked that any new pattern edges
+      // joining any newly assigned PV to an existing assigned PV
+      // ARE indeed mapped to valid target edges,
+      // so we don't need any further validity check.
+      break;
+    }
+    // We've chosen a variable (i.e., PV) to assign:
+    const VertexWSM& next_pv = next_var_result.variable_opt.value();
+
+    // Now choose a value (i.e., some TV in Domain(PV)).
+    // Thus the new assignment will be next_pv -> next_tv.
+    const VertexWSM next_tv = search_components.value_ordering.get_target_value(
+        search_branch.get_domains_accessor().get_domain(next_pv), target_ndata,
+        search_components.rng);
+
+    search_branch.move_down(next_pv, next_tv);
+    if (!search_branch.reduce_current_node(reduction_parameters)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void write_solution_from_final_node(
+    const DomainsAccessor& accessor, SolutionWSM& solution) {
+  std::vector<std::pair<VertexWSM, VertexWSM>>& assignments =
+      solution.assignments;
+  const auto number_of_pv = accessor.get_number_of_pattern_vertices();
+  assignments.clear();
+  assignments.reserve(number_of_pv);
+
+  for (unsigned pv = 0; pv < number_of_pv; ++pv) {
+    const BitsetInformation bitset_information(accessor.get_domain(pv));
+    TKET_ASSERT(bitset_information.single_element);
+    assignments.emplace_back(pv, bitset_information.single_element.value());
+  }
+  solution.scalar_product = accessor.get_scalar_product();
+  solution.total_p_edges_weight = accessor.get_total_p_edge_weights();
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -0,0 +1,93 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tkwsm/EndToEndWrappers/TargetGraphData.hpp"
+
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+// Bump this whenever the written format changes.
+static const std::string FORMAT_NAME = "tkwsm_target_graph_data";
+static const unsigned FORMAT_VERSION = 1;
+
+static GraphEdgeWeights read_edges(std::istream& is) {
+  std::string name;
+  unsigned version;
+  if (!(is >> name >> version) || name != FORMAT_NAME) {
+    throw std::runtime_error("TargetGraphData: unrecognised format");
+  }
+  if (version != FORMAT_VERSION) {
+    throw std::runtime_error("TargetGraphData: unsupported format version");
+  }
+  std::size_t number_of_edges;
+  if (!(is >> number_of_edges)) {
+    throw std::runtime_error("TargetGraphData: missing edges");
+  }
+  GraphEdgeWeights edges;
+  for (std::size_t ii = 0; ii < number_of_edges; ++ii) {
+    VertexWSM v1;
+    VertexWSM v2;
+    WeightWSM weight;
+    if (!(is >> v1 >> v2 >> weight)) {
+      throw std::runtime_error("TargetGraphData: invalid edge data");
+    }
+    edges[std::make_pair(v1, v2)] = weight;
+  }
+  return edges;
+}
+
+TargetGraphData::TargetGraphData(const GraphEdgeWeights& target_edges)
+    : relabelling(target_edges),
+      ndata(relabelling.new_edges_and_weights),
+      near_ndata(ndata),
+      derived_graphs(ndata, derived_graphs_calculator) {}
+
+TargetGraphData::TargetGraphData(std::istream& is)
+    : TargetGraphData(read_edges(is)) {
+  near_ndata.read(is);
+  derived_graphs.read(is);
+}
+
+void TargetGraphData::precompute(unsigned max_distance) {
+  const unsigned number_of_vertices =
+      ndata.get_number_of_nonisolated_vertices();
+  for (unsigned v = 0; v < number_of_vertices; ++v) {
+    if (max_distance >= 2) {
+      near_ndata.get_vertices_at_exact_distance(v, max_distance);
+    }
+    derived_graphs.get_data(v);
+  }
+}
+
+void TargetGraphData::write(std::ostream& os) const {
+  // Write the edges with their original labels, so that reading them back
+  // recreates exactly the same relabelling.
+  os << FORMAT_NAME << ' ' << FORMAT_VERSION << '\n'
+     << relabelling.new_edges_and_weights.size() << '\n';
+  for (const auto& entry : relabelling.new_edges_and_weights) {
+    os << relabelling.get_old_label(entry.first.first) << ' '
+       << relabelling.get_old_label(entry.first.second) << ' ' << entry.second
+       << '\n';
+  }
+  near_ndata.write(os);
+  derived_graphs.write(os);
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -14,7 +14,12 @@
 
 #include "tkwsm/GraphTheoretic/DerivedGraphs.hpp"
 
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
 #include "tkwsm/GraphTheoretic/DerivedGraphsCalculator.hpp"
+#include "tkwsm/GraphTheoretic/NeighboursData.hpp"
 
 namespace tket {
 namespace WeightedSubgraphMonomorphism {
@@ -56,7 +61,10 @@ void DerivedGraphs::fill(VertexWSM v, VertexData& vertex_data) {
   m_calculator.fill(
       m_neighbours_data, v, vertex_data.triangle_count,
       *vertex_data.d2_neighbours, *vertex_data.d3_neighbours);
+  fill_sorted_counts(vertex_data);
+}
 
+void DerivedGraphs::fill_sorted_counts(VertexData& vertex_data) {
   vertex_data.d2_sorted_counts_iter = get_new_iter(m_counts_storage);
   vertex_data.d3_sorted_counts_iter = get_new_iter(m_counts_storage);
 
@@ -66,5 +74,66 @@ void DerivedGraphs::fill(VertexWSM v, VertexData& vertex_data) {
       *vertex_data.d3_sorted_counts_iter, *vertex_data.d3_neighbours);
 }
 
+static void write_neighbours_and_counts(
+    std::ostream& os,
+    const DerivedGraphStructs::NeighboursAndCounts& neighbours_and_counts) {
+  os << " " << neighbours_and_counts.size();
+  for (const auto& entry : neighbours_and_counts) {
+    os << " " << entry.first << " " << entry.second;
+  }
+}
+
+void DerivedGraphs::write(std::ostream& os) const {
+  os << m_data_for_vertices.size() << "\n";
+  for (const auto& entry : m_data_for_vertices) {
+    os << entry.first << " " << entry.second.triangle_count;
+    write_neighbours_and_counts(os, *entry.second.d2_neighbours);
+    write_neighbours_and_counts(os, *entry.second.d3_neighbours);
+    os << "\n";
+  }
+}
+
+static std::size_t read_size(std::istream& is) {
+  std::size_t value;
+  if (!(is >> value)) {
+    throw std::runtime_error("DerivedGraphs: unexpected end of data");
+  }
+  return value;
+}
+
+static void read_neighbours_and_counts(
+    std::istream& is, std::size_t number_of_vertices,
+    DerivedGraphStructs::NeighboursAndCounts& neighbours_and_counts) {
+  neighbours_and_counts.resize(read_size(is));
+  for (auto& entry : neighbours_and_counts) {
+    entry.first = read_size(is);
+    entry.second = read_size(is);
+    if (entry.first >= number_of_vertices) {
+      throw std::runtime_error("DerivedGraphs: invalid vertex");
+    }
+  }
+}
+
+void DerivedGraphs::read(std::istream& is) {
+  const std::size_t number_of_vertices =
+      m_neighbours_data.get_number_of_nonisolated_vertices();
+  for (std::size_t count = read_size(is); count > 0; --count) {
+    const VertexWSM v = read_size(is);
+    if (v >= number_of_vertices) {
+      throw std::runtime_error("DerivedGraphs: invalid vertex");
+    }
+    VertexData vertex_data;
+    vertex_data.triangle_count = read_size(is);
+    vertex_data.d2_neighbours = get_new_iter(m_storage);
+    vertex_data.d3_neighbours = get_new_iter(m_storage);
+    read_neighbours_and_counts(
+        is, number_of_vertices, *vertex_data.d2_neighbours);
+    read_neighbours_and_counts(
+        is, number_of_vertices, *vertex_data.d3_neighbours);
+    fill_sorted_counts(vertex_data);
+    m_data_for_vertices.emplace(v, vertex_data);
+  }
+}
+
 }  // namespace WeightedSubgraphMonomorphism
 }  // namespace tket
@@ -15,6 +15,9 @@
 #include "tkwsm/GraphTheoretic/NearNeighboursData.hpp"
 
 #include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
 #include <tkassert/Assert.hpp>
 
 #include "tkwsm/GraphTheoretic/NeighboursData.hpp"
@@ -234,5 +237,51 @@ std::size_t NearNeighboursData::get_n_vertices_at_exact_distance(
   return get_vertices_at_exact_distance(v, distance).count();
 }
 
+void NearNeighboursData::write(std::ostream& os) const {
+  os << m_data.size() << "\n";
+  for (const VertexData& vertex_data : m_data) {
+    os << vertex_data.vertices_at_exact_distance.size();
+    for (const boost::dynamic_bitset<>& vertices :
+         vertex_data.vertices_at_exact_distance) {
+      os << " " << vertices.count();
+      for (auto vertex = vertices.find_first(); vertex < vertices.size();
+           vertex = vertices.find_next(vertex)) {
+        os << " " << vertex;
+      }
+    }
+    os << "\n";
+  }
+}
+
+static std::size_t read_size(std::istream& is) {
+  std::size_t value;
+  if (!(is >> value)) {
+    throw std::runtime_error("NearNeighboursData: unexpected end of data");
+  }
+  return value;
+}
+
+void NearNeighboursData::read(std::istream& is) {
+  if (read_size(is) != m_data.size()) {
+    throw std::runtime_error("NearNeighboursData: number of vertices differs");
+  }
+  for (VertexData& vertex_data : m_data) {
+    vertex_data = VertexData();
+    const std::size_t number_of_distances = read_size(is);
+    vertex_data.vertices_at_exact_distance.resize(number_of_distances);
+    for (boost::dynamic_bitset<>& vertices :
+         vertex_data.vertices_at_exact_distance) {
+      vertices.resize(m_data.size());
+      for (std::size_t count = read_size(is); count > 0; --count) {
+        const std::size_t vertex = read_size(is);
+        if (vertex >= m_data.size()) {
+          throw std::runtime_error("NearNeighboursData: invalid vertex");
+        }
+        vertices.set(vertex);
+      }
+    }
+  }
+}
+
 }  // namespace WeightedSubgraphMonomorphism
 }  // namespace tket
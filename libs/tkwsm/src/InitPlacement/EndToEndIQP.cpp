@@ -23,7 +23,7 @@
 #include "tkwsm/GraphTheoretic/NeighboursData.hpp"
 #include "tkwsm/GraphTheoretic/VertexRelabelling.hpp"
 #include "tkwsm/InitPlacement/InputStructs.hpp"
-#include "tkwsm/InitPlacement/MonteCarloCompleteTargetSolution.hpp"
+#include "tkwsm/InitPlacement/ParallelMonteCarloSolution.hpp"
 #include "tkwsm/InitPlacement/PrunedTargetEdges.hpp"
 #include "tkwsm/InitPlacement/UtilsIQP.hpp"
 
@@ -42,7 +42,8 @@ struct MCCTData {
   MCCTData(
       const GraphEdgeWeights& pattern_graph_weights,
       const GraphEdgeWeights& target_architecture_with_error_weights,
-      WeightWSM& scalar_product, unsigned& number_of_iterations)
+      const IQPParameters& iqp_parameters, WeightWSM& scalar_product,
+      unsigned& number_of_iterations)
       : pattern_relabelling(pattern_graph_weights),
         relabelled_pattern_ndata(pattern_relabelling.new_edges_and_weights),
         target_relabelling(target_architecture_with_error_weights),
@@ -53,9 +54,11 @@ struct MCCTData {
             target_relabelling))
 
   {
-    const MonteCarloCompleteTargetSolution mcct_solution(
+    const ParallelMonteCarloSolution mcct_solution(
         relabelled_pattern_ndata, relabelled_explicit_target_ndata,
-        expanded_target_graph_data.implicit_weight);
+        expanded_target_graph_data.implicit_weight,
+        iqp_parameters.mcct_number_of_chains, iqp_parameters.mcct_master_seed,
+        iqp_parameters.mcct_number_of_threads);
 
     number_of_iterations = mcct_solution.iterations();
     scalar_product = mcct_solution.get_best_scalar_product();
@@ -97,7 +100,7 @@ IQPResult::IQPResult(
   const auto start = Clock::now();
   const MCCTData mcct_data(
       pattern_graph_weights, target_architecture_with_error_weights,
-      mcct_scalar_product, mcct_iterations);
+      iqp_parameters, mcct_scalar_product, mcct_iterations);
 
   mcct_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                      Clock::now() - start)
@@ -14,9 +14,6 @@
 
 #include "tkwsm/InitPlacement/FastRandomBits.hpp"
 
-#include <tkassert/Assert.hpp>
-#include <tkrng/RNG.hpp>
-
 namespace tket {
 namespace WeightedSubgraphMonomorphism {
 namespace InitialPlacement {
@@ -38,28 +35,8 @@ static const std::vector<std::uint64_t>& get_masks_global_ref() {
 
 FastRandomBits::FastRandomBits() : m_bits(0), m_number_of_random_bits(0) {}
 
-std::uint64_t FastRandomBits::get_random_bits(
-    RNG& rng, unsigned number_of_bits) {
-  TKET_ASSERT(number_of_bits >= 1);
-  TKET_ASSERT(number_of_bits <= 64);
-  if (number_of_bits <= m_number_of_random_bits) {
-    const std::uint64_t bits_to_return =
-        m_bits & get_masks_global_ref()[number_of_bits - 1];
-    m_bits >>= number_of_bits;
-    m_number_of_random_bits -= number_of_bits;
-    return bits_to_return;
-  }
-  // There are not enough random bits, so we'll need to generate more.
-  // But first, use the existing bits.
-  std::uint64_t bits_to_return = m_bits;
-  const unsigned number_of_extra_bits =
-      number_of_bits - m_number_of_random_bits;
-  bits_to_return <<= number_of_extra_bits;
-  m_bits = rng();
-  bits_to_return |= m_bits & get_masks_global_ref()[number_of_extra_bits - 1];
-  m_bits >>= number_of_extra_bits;
-  m_number_of_random_bits = 64 - number_of_bits;
-  return bits_to_return;
+std::uint64_t FastRandomBits::get_mask(unsigned number_of_bits) {
+  return get_masks_global_ref()[number_of_bits - 1];
 }
 
 }  // namespace InitialPlacement
@@ -30,12 +30,13 @@ MonteCarloCompleteTargetSolution::MonteCarloCompleteTargetSolution(
     WeightWSM implicit_target_weight,
     // If left unspecified, i.e. set to zero,
     // will choose a reasonable default.
-    unsigned max_iterations)
+    unsigned max_iterations, std::size_t seed)
     : m_implicit_target_weight(implicit_target_weight),
 
       m_iterations(0),
       m_max_iterations(max_iterations),
       m_solution_jumper(pattern_ndata, target_ndata, implicit_target_weight) {
+  m_rng.set_seed(seed);
   const unsigned number_of_pv =
       pattern_ndata.get_number_of_nonisolated_vertices();
   if (m_max_iterations == 0) {
@@ -0,0 +1,148 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tkwsm/InitPlacement/ParallelMonteCarloSolution.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <tkassert/Assert.hpp>
+
+#include "tkwsm/Common/GeneralUtils.hpp"
+#include "tkwsm/InitPlacement/MonteCarloCompleteTargetSolution.hpp"
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+namespace InitialPlacement {
+
+namespace {
+struct ChainResult {
+  std::vector<unsigned> assignments;
+  WeightWSM scalar_product;
+  unsigned iterations;
+};
+}  // namespace
+
+std::size_t ParallelMonteCarloSolution::get_chain_seed(
+    std::size_t master_seed, unsigned chain_index) {
+  if (chain_index == 0) {
+    return master_seed;
+  }
+  // A splitmix64 step, so that nearby master seeds
+  // do not give overlapping sets of chain seeds.
+  std::uint64_t z = static_cast<std::uint64_t>(master_seed) +
+                    chain_index * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return static_cast<std::size_t>(z ^ (z >> 31));
+}
+
+ParallelMonteCarloSolution::ParallelMonteCarloSolution(
+    const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+    WeightWSM implicit_target_weight, unsigned number_of_chains,
+    std::size_t master_seed, unsigned number_of_threads,
+    unsigned max_iterations_per_chain)
+    : m_iterations(0), m_best_chain_index(0) {
+  if (number_of_chains == 0) {
+    throw std::runtime_error("ParallelMonteCarloSolution: no chains");
+  }
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  number_of_threads = std::min(number_of_threads, number_of_chains);
+
+  std::vector<std::optional<ChainResult>> results(number_of_chains);
+  const auto run_chain = [&](unsigned chain_index) {
+    const MonteCarloCompleteTargetSolution solution(
+        pattern_ndata, target_ndata, implicit_target_weight,
+        max_iterations_per_chain, get_chain_seed(master_seed, chain_index));
+    results[chain_index] = ChainResult{
+        solution.get_best_assignments(), solution.get_best_scalar_product(),
+        solution.iterations()};
+  };
+
+  if (number_of_threads == 1) {
+    for (unsigned ii = 0; ii < number_of_chains; ++ii) {
+      run_chain(ii);
+    }
+  } else {
+    // Each thread repeatedly takes the next chain not yet started.
+    std::atomic<unsigned> next_chain_index(0);
+    std::vector<std::exception_ptr> errors(number_of_threads);
+    const auto work = [&](unsigned thread_index) {
+      try {
+        for (;;) {
+          const unsigned chain_index = next_chain_index++;
+          if (chain_index >= number_of_chains) {
+            return;
+          }
+          run_chain(chain_index);
+        }
+      } catch (...) {
+        errors[thread_index] = std::current_exception();
+        next_chain_index = number_of_chains;
+      }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(number_of_threads);
+    for (unsigned ii = 0; ii < number_of_threads; ++ii) {
+      threads.emplace_back(work, ii);
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+  // Combine in chain order, so that ties are broken deterministically.
+  set_maximum(m_best_scalar_product);
+  for (unsigned ii = 0; ii < number_of_chains; ++ii) {
+    TKET_ASSERT(results[ii]);
+    ChainResult& result = results[ii].value();
+    m_iterations += result.iterations;
+    if (result.scalar_product < m_best_scalar_product) {
+      m_best_scalar_product = result.scalar_product;
+      m_best_assignments = std::move(result.assignments);
+      m_best_chain_index = ii;
+    }
+  }
+}
+
+const std::vector<unsigned>& ParallelMonteCarloSolution::get_best_assignments()
+    const {
+  return m_best_assignments;
+}
+
+WeightWSM ParallelMonteCarloSolution::get_best_scalar_product() const {
+  return m_best_scalar_product;
+}
+
+unsigned ParallelMonteCarloSolution::iterations() const { return m_iterations; }
+
+unsigned ParallelMonteCarloSolution::get_best_chain_index() const {
+  return m_best_chain_index;
+}
+
+}  // namespace InitialPlacement
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -23,10 +23,25 @@
 namespace tket {
 namespace WeightedSubgraphMonomorphism {
 
+// Returns the passed in object if it exists, otherwise constructs our own.
+static DerivedGraphs& get_derived_target_graphs(
+    DerivedGraphs* derived_target_graphs_ptr,
+    std::optional<DerivedGraphs>& own_derived_target_graphs,
+    const NeighboursData& target_ndata, DerivedGraphsCalculator& calculator) {
+  if (derived_target_graphs_ptr != nullptr) {
+    return *derived_target_graphs_ptr;
+  }
+  own_derived_target_graphs.emplace(target_ndata, calculator);
+  return own_derived_target_graphs.value();
+}
+
 DerivedGraphsReducer::DerivedGraphsReducer(
-    const NeighboursData& pattern_ndata, const NeighboursData& target_ndata)
+    const NeighboursData& pattern_ndata, const NeighboursData& target_ndata,
+    DerivedGraphs* derived_target_graphs_ptr)
     : m_derived_pattern_graphs(pattern_ndata, m_calculator),
-      m_derived_target_graphs(target_ndata, m_calculator) {}
+      m_derived_target_graphs(get_derived_target_graphs(
+          derived_target_graphs_ptr, m_own_derived_target_graphs,
+          target_ndata, m_calculator)) {}
 
 bool DerivedGraphsReducer::check(std::pair<VertexWSM, VertexWSM> assignment) {
   const DerivedGraphs::VertexData pattern_vdata =
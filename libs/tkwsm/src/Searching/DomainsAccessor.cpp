@@ -195,7 +195,11 @@ DomainsAccessor::get_unassigned_pattern_vertices_superset() const {
   if (!candidate.empty()) {
     return candidate;
   }
-  TKET_ASSERT(m_raw_data.nodes_data.size() > 1);
+  if (m_raw_data.nodes_data.size() == 1) {
+    // At the root, this means that every PV is already assigned
+    // (e.g., a subtree of a parallel search).
+    return candidate;
+  }
   return m_raw_data.nodes_data.one_below_top().unassigned_vertices_superset;
 }
 
@@ -30,11 +30,13 @@ SearchBranch::SearchBranch(
     const DomainInitialiser::InitialDomains& initial_domains,
     const NeighboursData& pattern_ndata, NearNeighboursData& pattern_near_ndata,
     const NeighboursData& target_ndata, NearNeighboursData& target_near_ndata,
-    unsigned max_distance_reduction_value, ExtraStatistics& extra_statistics)
+    unsigned max_distance_reduction_value, ExtraStatistics& extra_statistics,
+    DerivedGraphs* derived_target_graphs_ptr)
     : m_pattern_ndata(pattern_ndata),
       m_target_ndata(target_ndata),
       m_extra_statistics(extra_statistics),
-      m_derived_graphs_reducer(m_pattern_ndata, m_target_ndata),
+      m_derived_graphs_reducer(
+          m_pattern_ndata, m_target_ndata, derived_target_graphs_ptr),
       m_nodes_raw_data_wrapper(
           initial_domains, m_target_ndata.get_number_of_nonisolated_vertices()),
       m_domains_accessor(m_nodes_raw_data_wrapper),
@@ -116,8 +118,12 @@ bool SearchBranch::perform_single_assignment_checks_in_reduce_loop(
             new_assignments[ii].second) != 0) {
       continue;
     }
-    for (auto& reducer_wrapper : m_reducer_wrappers) {
-      if (!reducer_wrapper.check(new_assignments[ii])) {
+    for (unsigned jj = 0; jj < m_reducer_wrappers.size(); ++jj) {
+      if (!m_reducer_wrappers[jj].check(new_assignments[ii])) {
+        // All but the first are distance reducers.
+        if (jj > 0) {
+          ++m_extra_statistics.search_counters.number_of_distances_reductions;
+        }
         // The whole point is, the check for PV->TV does NOT depend on
         // the other domains; since it's failed the check, it was ALWAYS
         // invalid, so we remove it completely from ALL data.
@@ -168,6 +174,9 @@ bool SearchBranch::perform_weight_nogood_check_in_reduce_loop(
 
     bool node_is_valid = m_weight_checker_ptr->check(
         m_domains_accessor, max_extra_scalar_product);
+    if (!node_is_valid) {
+      ++m_extra_statistics.search_counters.number_of_weight_nogoods;
+    }
 
     const auto number_of_pv =
         m_domains_accessor.get_number_of_pattern_vertices();
@@ -191,10 +200,13 @@ bool SearchBranch::perform_weight_nogood_check_in_reduce_loop(
 }
 
 ReductionResult SearchBranch::perform_reducers_in_reduce_loop() {
-  for (auto& reducer_wrapper : m_reducer_wrappers) {
-    const auto reduction_result =
-        reducer_wrapper.reduce(m_domains_accessor, m_work_set_for_reducers);
+  for (unsigned ii = 0; ii < m_reducer_wrappers.size(); ++ii) {
+    const auto reduction_result = m_reducer_wrappers[ii].reduce(
+        m_domains_accessor, m_work_set_for_reducers);
     if (reduction_result != ReductionResult::SUCCESS) {
+      if (ii > 0) {
+        ++m_extra_statistics.search_counters.number_of_distances_reductions;
+      }
       return reduction_result;
     }
   }
@@ -265,6 +277,9 @@ bool SearchBranch::perform_main_reduce_loop(
     //*
     const auto hall_set_result =
         m_hall_set_reduction.reduce(m_domains_accessor);
+    if (hall_set_result != ReductionResult::SUCCESS) {
+      ++m_extra_statistics.search_counters.number_of_hall_set_reductions;
+    }
     if (hall_set_result == ReductionResult::NOGOOD) {
       return false;
     }
@@ -307,6 +322,7 @@ bool SearchBranch::backtrack(const ReductionParameters& parameters) {
 }
 
 void SearchBranch::move_down(VertexWSM p_vertex, VertexWSM t_vertex) {
+  ++m_extra_statistics.search_counters.number_of_nodes_expanded;
   m_node_list_traversal.move_down(p_vertex, t_vertex);
 }
 
@@ -15,10 +15,10 @@
 #include "tkwsm/WeightPruning/WeightChecker.hpp"
 
 #include <algorithm>
+#include <utility>
 #include <tkassert/Assert.hpp>
 
 #include "tkwsm/Common/GeneralUtils.hpp"
-#include "tkwsm/Common/TemporaryRefactorCode.hpp"
 #include "tkwsm/GraphTheoretic/NeighboursData.hpp"
 #include "tkwsm/Searching/DomainsAccessor.hpp"
 #include "tkwsm/Searching/SearchBranch.hpp"
@@ -83,13 +83,12 @@ bool WeightChecker::check(
 
   // Finally, we use the detector; check if it's initialised.
   if (!m_detector_ptr) {
-    std::set<VertexWSM> used_tv;
-    TemporaryRefactorCode::set_domain_from_bitset(
-        used_tv, m_search_branch.get_used_target_vertices());
-    m_tv_data.initial_number_of_tv = used_tv.size();
+    boost::dynamic_bitset<> used_tv =
+        m_search_branch.get_used_target_vertices();
+    m_tv_data.initial_number_of_tv = used_tv.count();
 
     m_detector_ptr = std::make_unique<WeightNogoodDetector>(
-        m_pattern_neighbours_data, m_target_neighbours_data, used_tv,
+        m_pattern_neighbours_data, m_target_neighbours_data, std::move(used_tv),
         m_impossible_target_vertices);
     TKET_ASSERT(m_detector_ptr);
   }
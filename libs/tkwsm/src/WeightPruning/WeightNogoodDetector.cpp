@@ -27,25 +27,32 @@ namespace WeightedSubgraphMonomorphism {
 WeightNogoodDetector::WeightNogoodDetector(
     const NeighboursData& pattern_neighbours_data,
     const NeighboursData& target_neighbours_data,
-    std::set<VertexWSM> initial_used_target_vertices,
+    boost::dynamic_bitset<> initial_used_target_vertices,
     std::set<VertexWSM>& invalid_target_vertices)
     : m_pattern_neighbours_data(pattern_neighbours_data),
       m_target_neighbours_data(target_neighbours_data),
       m_valid_target_vertices(std::move(initial_used_target_vertices)),
-      m_invalid_target_vertices(invalid_target_vertices) {}
+      m_invalid_target_vertices(invalid_target_vertices) {
+  TKET_ASSERT(
+      m_valid_target_vertices.size() ==
+      m_target_neighbours_data.get_number_of_nonisolated_vertices());
+  WeightWSM not_yet_calculated;
+  set_maximum(not_yet_calculated);
+  m_minimum_t_weights_from_tv.assign(
+      m_valid_target_vertices.size(), not_yet_calculated);
+}
 
 std::size_t WeightNogoodDetector::get_number_of_possible_tv() const {
-  return m_valid_target_vertices.size();
+  return m_valid_target_vertices.count();
 }
 
 std::optional<WeightWSM> WeightNogoodDetector::get_min_weight_for_tv(
     VertexWSM tv) const {
-  if (m_valid_target_vertices.count(tv) == 0) {
+  if (!m_valid_target_vertices.test(tv)) {
     return {};
   }
-  const auto weight_opt = get_optional_value(m_minimum_t_weights_from_tv, tv);
-  if (weight_opt) {
-    return weight_opt;
+  if (!is_maximum(m_minimum_t_weights_from_tv[tv])) {
+    return m_minimum_t_weights_from_tv[tv];
   }
   // We must find the minimum weight, by looking at all neighbours.
   WeightWSM min_weight;
@@ -54,7 +61,7 @@ std::optional<WeightWSM> WeightNogoodDetector::get_min_weight_for_tv(
       m_target_neighbours_data.get_neighbours_and_weights(tv);
   for (const std::pair<VertexWSM, WeightWSM>& entry : data) {
     const VertexWSM& neighbour_tv = entry.first;
-    if (m_valid_target_vertices.count(neighbour_tv) == 0) {
+    if (!m_valid_target_vertices.test(neighbour_tv)) {
       continue;
     }
     min_weight = std::min(min_weight, entry.second);
@@ -101,7 +108,7 @@ bool WeightNogoodDetector::fill_t_weight_lower_bounds_for_p_edges_containing_pv(
         weight = std::min(weight, weight_opt_for_tv.value());
       } else {
         m_invalid_target_vertices.insert(tv_again);
-        m_valid_target_vertices.erase(tv_again);
+        m_valid_target_vertices.reset(tv_again);
       }
     }
 
@@ -41,8 +41,9 @@ struct TempCounter {
 };
 }  // namespace
 
+// Per thread, since several solvers may run concurrently.
 static TempCounter& get_counter() {
-  static TempCounter counter;
+  thread_local TempCounter counter;
   return counter;
 }
 
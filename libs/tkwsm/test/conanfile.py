@@ -59,7 +59,7 @@ class test_tkwsmRecipe(ConanFile):
         cmake.install()
 
     def requirements(self):
-        self.requires("tkwsm/0.3.6")
-        self.requires("tkassert/0.3.4@tket/stable")
-        self.requires("tkrng/0.3.3@tket/stable")
+        self.requires("tkwsm/0.3.15")
+        self.requires("tkassert/0.3.5@tket/stable")
+        self.requires("tkrng/0.3.4@tket/stable")
         self.requires("catch2/3.3.2")
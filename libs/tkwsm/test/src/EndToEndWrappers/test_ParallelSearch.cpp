@@ -0,0 +1,151 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <set>
+#include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+// A random graph on the given number of vertices, containing a cycle
+// through all of them so that it is connected, with weights in [1,8].
+static GraphEdgeWeights get_random_graph(
+    unsigned number_of_vertices, unsigned number_of_extra_edges,
+    std::mt19937_64& engine) {
+  GraphEdgeWeights graph;
+  for (unsigned vv = 0; vv < number_of_vertices; ++vv) {
+    graph[get_edge(vv, (vv + 1) % number_of_vertices)] = 1 + engine() % 8;
+  }
+  while (graph.size() < number_of_vertices + number_of_extra_edges) {
+    const VertexWSM v1 = engine() % number_of_vertices;
+    const VertexWSM v2 = engine() % number_of_vertices;
+    if (v1 != v2) {
+      graph[get_edge(v1, v2)] = 1 + engine() % 8;
+    }
+  }
+  return graph;
+}
+
+static std::set<std::vector<std::pair<VertexWSM, VertexWSM>>>
+get_assignments(const SolutionData& solution_data) {
+  std::set<std::vector<std::pair<VertexWSM, VertexWSM>>> assignments;
+  for (const SolutionWSM& solution : solution_data.solutions) {
+    assignments.insert(solution.assignments);
+  }
+  return assignments;
+}
+
+SCENARIO("Parallel search finds optimal solutions deterministically") {
+  std::mt19937_64 engine(1234);
+  MainSolverParameters sequential_parameters(10000);
+  sequential_parameters.iterations_timeout = 10000000;
+  MainSolverParameters parallel_parameters = sequential_parameters;
+  parallel_parameters.number_of_threads = 4;
+
+  for (unsigned problem = 0; problem < 10; ++problem) {
+    const GraphEdgeWeights pattern = get_random_graph(7, 3, engine);
+    const GraphEdgeWeights target = get_random_graph(12, 12, engine);
+
+    const MainSolver sequential_solver(pattern, target, sequential_parameters);
+    const SolutionData& sequential = sequential_solver.get_solution_data();
+    REQUIRE(sequential.finished);
+
+    const MainSolver parallel_solver(pattern, target, parallel_parameters);
+    const SolutionData& parallel = parallel_solver.get_solution_data();
+    const MainSolver parallel_solver_again(
+        pattern, target, parallel_parameters);
+    const SolutionData& parallel_again =
+        parallel_solver_again.get_solution_data();
+    REQUIRE(parallel.finished);
+    REQUIRE(parallel_again.finished);
+
+    REQUIRE(parallel.solutions.size() == sequential.solutions.size());
+    REQUIRE(parallel_again.solutions.size() == sequential.solutions.size());
+    if (sequential.solutions.empty()) {
+      continue;
+    }
+    REQUIRE(sequential.solutions.size() == 1);
+    const SolutionWSM& solution = parallel.solutions[0];
+    CHECK(solution.get_errors(pattern, target) == "");
+    CHECK(
+        solution.scalar_product == sequential.solutions[0].scalar_product);
+    CHECK(
+        solution.assignments == parallel_again.solutions[0].assignments);
+  }
+}
+
+SCENARIO("Parallel search finds all solutions") {
+  std::mt19937_64 engine(5678);
+  MainSolverParameters sequential_parameters(10000);
+  sequential_parameters.iterations_timeout = 10000000;
+  sequential_parameters.for_multiple_full_solutions_the_max_number_to_obtain =
+      100000;
+  MainSolverParameters parallel_parameters = sequential_parameters;
+  parallel_parameters.number_of_threads = 3;
+
+  for (unsigned problem = 0; problem < 5; ++problem) {
+    const GraphEdgeWeights pattern = get_random_graph(5, 1, engine);
+    const GraphEdgeWeights target = get_random_graph(8, 6, engine);
+    const MainSolver sequential_solver(pattern, target, sequential_parameters);
+    const MainSolver parallel_solver(pattern, target, parallel_parameters);
+    const SolutionData& sequential = sequential_solver.get_solution_data();
+    const SolutionData& parallel = parallel_solver.get_solution_data();
+    REQUIRE(sequential.finished);
+    REQUIRE(parallel.finished);
+    REQUIRE(parallel.solutions.size() == sequential.solutions.size());
+    CHECK(get_assignments(parallel) == get_assignments(sequential));
+    for (const SolutionWSM& solution : parallel.solutions) {
+      CHECK(solution.get_errors(pattern, target) == "");
+    }
+  }
+}
+
+SCENARIO("Parallel search can be resumed") {
+  std::mt19937_64 engine(91011);
+  const GraphEdgeWeights pattern = get_random_graph(8, 4, engine);
+  const GraphEdgeWeights target = get_random_graph(14, 16, engine);
+
+  MainSolverParameters sequential_parameters(10000);
+  sequential_parameters.iterations_timeout = 10000000;
+  const MainSolver sequential_solver(pattern, target, sequential_parameters);
+  const SolutionData& sequential = sequential_solver.get_solution_data();
+  REQUIRE(sequential.finished);
+  REQUIRE(sequential.solutions.size() == 1);
+
+  MainSolverParameters parallel_parameters(10000);
+  parallel_parameters.number_of_threads = 4;
+  parallel_parameters.iterations_timeout = 20;
+  MainSolver parallel_solver(pattern, target, parallel_parameters);
+  unsigned number_of_solves = 1;
+  while (!parallel_solver.get_solution_data().finished) {
+    const SolutionData& partial = parallel_solver.get_solution_data();
+    CHECK(partial.iterations <= 20 * number_of_solves);
+    CHECK(partial.solutions.size() <= 1);
+    parallel_solver.solve(parallel_parameters);
+    ++number_of_solves;
+    REQUIRE(number_of_solves < 100000);
+  }
+  CHECK(number_of_solves > 1);
+  const SolutionData& parallel = parallel_solver.get_solution_data();
+  REQUIRE(parallel.solutions.size() == 1);
+  CHECK(parallel.solutions[0].get_errors(pattern, target) == "");
+  CHECK(
+      parallel.solutions[0].scalar_product ==
+      sequential.solutions[0].scalar_product);
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
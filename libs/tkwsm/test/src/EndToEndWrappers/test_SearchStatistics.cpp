@@ -0,0 +1,148 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+// A random connected graph with weights in [1,8].
+static GraphEdgeWeights get_random_graph(
+    unsigned number_of_vertices, unsigned number_of_extra_edges,
+    std::mt19937_64& engine) {
+  GraphEdgeWeights graph;
+  for (unsigned vv = 0; vv < number_of_vertices; ++vv) {
+    graph[get_edge(vv, (vv + 1) % number_of_vertices)] = 1 + engine() % 8;
+  }
+  while (graph.size() < number_of_vertices + number_of_extra_edges) {
+    const unsigned v1 = engine() % number_of_vertices;
+    const unsigned v2 = engine() % number_of_vertices;
+    if (v1 != v2) {
+      graph[get_edge(v1, v2)] = 1 + engine() % 8;
+    }
+  }
+  return graph;
+}
+
+static void check_times(const SolutionData& solution_data) {
+  const ExtraStatistics& statistics = solution_data.extra_statistics;
+  CHECK(statistics.domain_initialisation_time_ms >= 0);
+  CHECK(statistics.search_setup_time_ms >= 0);
+  CHECK(
+      statistics.domain_initialisation_time_ms +
+          statistics.search_setup_time_ms <=
+      solution_data.initialisation_time_ms);
+  for (const WeightImprovement& improvement :
+       solution_data.best_weight_trajectory) {
+    CHECK(improvement.iterations <= solution_data.iterations);
+    CHECK(improvement.search_time_ms <= solution_data.search_time_ms);
+  }
+}
+
+SCENARIO("Search statistics are recorded") {
+  std::mt19937_64 engine(13579);
+  MainSolverParameters parameters(10000);
+  parameters.iterations_timeout = 10000000;
+
+  unsigned number_of_problems_with_solutions = 0;
+  unsigned number_of_problems_with_reductions = 0;
+  std::size_t threaded_nodes_expanded = 0;
+  for (unsigned problem = 0; problem < 10; ++problem) {
+    const GraphEdgeWeights pattern = get_random_graph(6, 3, engine);
+    const GraphEdgeWeights target = get_random_graph(12, 12, engine);
+
+    // The trajectory is exactly the improving solutions.
+    std::vector<WeightWSM> improving_weights;
+    MainSolverParameters callback_parameters = parameters;
+    callback_parameters.solution_callback =
+        [&improving_weights](const SolutionWSM& solution) {
+          improving_weights.push_back(solution.scalar_product);
+          return true;
+        };
+    const MainSolver solver(pattern, target, callback_parameters);
+    const SolutionData& solution_data = solver.get_solution_data();
+    REQUIRE(solution_data.finished);
+    check_times(solution_data);
+    const std::vector<WeightImprovement>& trajectory =
+        solution_data.best_weight_trajectory;
+    REQUIRE(trajectory.size() == improving_weights.size());
+    for (unsigned ii = 0; ii < trajectory.size(); ++ii) {
+      REQUIRE(trajectory[ii].scalar_product == improving_weights[ii]);
+      if (ii > 0) {
+        REQUIRE(trajectory[ii].iterations >= trajectory[ii - 1].iterations);
+        REQUIRE(
+            trajectory[ii].search_time_ms >=
+            trajectory[ii - 1].search_time_ms);
+      }
+    }
+    const SearchCounters& counters =
+        solution_data.extra_statistics.search_counters;
+    if (solution_data.solutions.empty()) {
+      continue;
+    }
+    ++number_of_problems_with_solutions;
+    REQUIRE(
+        trajectory.back().scalar_product ==
+        solution_data.solutions[0].scalar_product);
+    // Each solution needs every pattern vertex to be assigned, so the
+    // search must have moved down at least once.
+    REQUIRE(counters.number_of_nodes_expanded > 0);
+    if (counters.number_of_distances_reductions +
+            counters.number_of_hall_set_reductions +
+            counters.number_of_weight_nogoods >
+        0) {
+      ++number_of_problems_with_reductions;
+    }
+
+    // The counters do not depend on how the solutions are returned.
+    const MainSolver stored_solver(pattern, target, parameters);
+    const SearchCounters& stored_counters =
+        stored_solver.get_solution_data().extra_statistics.search_counters;
+    REQUIRE(
+        stored_counters.number_of_nodes_expanded ==
+        counters.number_of_nodes_expanded);
+    REQUIRE(
+        stored_counters.number_of_distances_reductions ==
+        counters.number_of_distances_reductions);
+    REQUIRE(
+        stored_counters.number_of_hall_set_reductions ==
+        counters.number_of_hall_set_reductions);
+    REQUIRE(
+        stored_counters.number_of_weight_nogoods ==
+        counters.number_of_weight_nogoods);
+
+    // With several threads, only the final best solution is recorded.
+    MainSolverParameters threaded_parameters = parameters;
+    threaded_parameters.number_of_threads = 2;
+    const MainSolver threaded_solver(pattern, target, threaded_parameters);
+    const SolutionData& threaded_data = threaded_solver.get_solution_data();
+    REQUIRE(threaded_data.finished);
+    check_times(threaded_data);
+    threaded_nodes_expanded += threaded_data.extra_statistics.search_counters
+                                   .number_of_nodes_expanded;
+    REQUIRE(threaded_data.best_weight_trajectory.size() == 1);
+    REQUIRE(
+        threaded_data.best_weight_trajectory[0].scalar_product ==
+        solution_data.solutions[0].scalar_product);
+  }
+  CHECK(number_of_problems_with_solutions > 3);
+  CHECK(number_of_problems_with_reductions > 0);
+  // The counters from each thread are summed.
+  CHECK(threaded_nodes_expanded > 0);
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -0,0 +1,154 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <stdexcept>
+#include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+// A random connected graph with weights in [1,8],
+// with vertex labels spread out so that relabelling is needed.
+static GraphEdgeWeights get_random_graph(
+    unsigned number_of_vertices, unsigned number_of_extra_edges,
+    std::mt19937_64& engine) {
+  GraphEdgeWeights graph;
+  const auto label = [](unsigned vv) { return 3 * vv + 2; };
+  for (unsigned vv = 0; vv < number_of_vertices; ++vv) {
+    graph[get_edge(label(vv), label((vv + 1) % number_of_vertices))] =
+        1 + engine() % 8;
+  }
+  while (graph.size() < number_of_vertices + number_of_extra_edges) {
+    const unsigned v1 = engine() % number_of_vertices;
+    const unsigned v2 = engine() % number_of_vertices;
+    if (v1 != v2) {
+      graph[get_edge(label(v1), label(v2))] = 1 + engine() % 8;
+    }
+  }
+  return graph;
+}
+
+SCENARIO("Solutions are passed to the callback as they are found") {
+  std::mt19937_64 engine(24680);
+  MainSolverParameters parameters(10000);
+  parameters.iterations_timeout = 10000000;
+  parameters.for_multiple_full_solutions_the_max_number_to_obtain = 100000;
+
+  unsigned number_of_problems_with_solutions = 0;
+  for (unsigned problem = 0; problem < 10; ++problem) {
+    const GraphEdgeWeights pattern = get_random_graph(5, 2, engine);
+    const GraphEdgeWeights target = get_random_graph(9, 8, engine);
+
+    const MainSolver stored_solver(pattern, target, parameters);
+    const SolutionData& stored_data = stored_solver.get_solution_data();
+    REQUIRE(stored_data.finished);
+    REQUIRE(stored_data.number_of_unstored_solutions == 0);
+    if (stored_data.solutions.empty()) {
+      continue;
+    }
+    ++number_of_problems_with_solutions;
+
+    // All mode: identical solutions, in the same order, but not stored.
+    std::vector<SolutionWSM> streamed_solutions;
+    MainSolverParameters callback_parameters = parameters;
+    callback_parameters.solution_callback =
+        [&streamed_solutions](const SolutionWSM& solution) {
+          streamed_solutions.push_back(solution);
+          return true;
+        };
+    const MainSolver streamed_solver(pattern, target, callback_parameters);
+    const SolutionData& streamed_data = streamed_solver.get_solution_data();
+    REQUIRE(streamed_data.finished);
+    REQUIRE(streamed_data.solutions.empty());
+    REQUIRE(
+        streamed_data.number_of_unstored_solutions ==
+        stored_data.solutions.size());
+    REQUIRE(streamed_solutions.size() == stored_data.solutions.size());
+    for (unsigned ii = 0; ii < streamed_solutions.size(); ++ii) {
+      REQUIRE(
+          streamed_solutions[ii].assignments ==
+          stored_data.solutions[ii].assignments);
+      REQUIRE(
+          streamed_solutions[ii].scalar_product ==
+          stored_data.solutions[ii].scalar_product);
+      REQUIRE(
+          streamed_solutions[ii].get_errors(pattern, target).empty());
+    }
+
+    // The callback can break off the search early, and it resumes.
+    if (streamed_solutions.size() >= 2) {
+      std::vector<SolutionWSM> partial_solutions;
+      callback_parameters.solution_callback =
+          [&partial_solutions](const SolutionWSM& solution) {
+            partial_solutions.push_back(solution);
+            return partial_solutions.size() % 2 == 1;
+          };
+      MainSolver partial_solver(pattern, target, callback_parameters);
+      REQUIRE(partial_solutions.size() == 2);
+      REQUIRE_FALSE(partial_solver.get_solution_data().finished);
+      while (!partial_solver.get_solution_data().finished) {
+        partial_solver.solve(callback_parameters);
+      }
+      REQUIRE(partial_solutions.size() == streamed_solutions.size());
+      for (unsigned ii = 0; ii < partial_solutions.size(); ++ii) {
+        REQUIRE(
+            partial_solutions[ii].assignments ==
+            streamed_solutions[ii].assignments);
+      }
+    }
+
+    // Best-solution mode: each solution passed is strictly better,
+    // and the last is the optimal one, which is still stored.
+    MainSolverParameters best_parameters(10000);
+    best_parameters.iterations_timeout = 10000000;
+    std::vector<WeightWSM> improving_weights;
+    best_parameters.solution_callback =
+        [&improving_weights](const SolutionWSM& solution) {
+          improving_weights.push_back(solution.scalar_product);
+          return true;
+        };
+    const MainSolver best_solver(pattern, target, best_parameters);
+    const SolutionData& best_data = best_solver.get_solution_data();
+    REQUIRE(best_data.finished);
+    REQUIRE(best_data.solutions.size() == 1);
+    REQUIRE(!improving_weights.empty());
+    for (unsigned ii = 1; ii < improving_weights.size(); ++ii) {
+      REQUIRE(improving_weights[ii] < improving_weights[ii - 1]);
+    }
+    REQUIRE(improving_weights.back() == best_data.solutions[0].scalar_product);
+    WeightWSM optimal_weight = stored_data.solutions[0].scalar_product;
+    for (const SolutionWSM& solution : stored_data.solutions) {
+      optimal_weight = std::min(optimal_weight, solution.scalar_product);
+    }
+    REQUIRE(best_data.solutions[0].scalar_product == optimal_weight);
+  }
+  CHECK(number_of_problems_with_solutions > 3);
+
+  GIVEN("A solution callback with several threads") {
+    const GraphEdgeWeights pattern = get_random_graph(5, 2, engine);
+    const GraphEdgeWeights target = get_random_graph(9, 8, engine);
+    MainSolverParameters threaded_parameters = parameters;
+    threaded_parameters.number_of_threads = 2;
+    threaded_parameters.solution_callback = [](const SolutionWSM&) {
+      return true;
+    };
+    REQUIRE_THROWS_AS(
+        MainSolver(pattern, target, threaded_parameters), std::runtime_error);
+  }
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
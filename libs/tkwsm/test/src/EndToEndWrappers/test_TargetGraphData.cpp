@@ -0,0 +1,143 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+#include <tkwsm/EndToEndWrappers/TargetGraphData.hpp>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+// A random connected graph with weights in [1,8]. The vertex labels
+// are spread out, so that relabelling is needed.
+static GraphEdgeWeights get_random_graph(
+    unsigned number_of_vertices, unsigned number_of_extra_edges,
+    std::mt19937_64& engine) {
+  GraphEdgeWeights graph;
+  const auto label = [](unsigned vv) { return 3 * vv + 5; };
+  for (unsigned vv = 0; vv < number_of_vertices; ++vv) {
+    graph[get_edge(label(vv), label((vv + 1) % number_of_vertices))] =
+        1 + engine() % 8;
+  }
+  while (graph.size() < number_of_vertices + number_of_extra_edges) {
+    const unsigned v1 = engine() % number_of_vertices;
+    const unsigned v2 = engine() % number_of_vertices;
+    if (v1 != v2) {
+      graph[get_edge(label(v1), label(v2))] = 1 + engine() % 8;
+    }
+  }
+  return graph;
+}
+
+static void check_same_results(
+    const SolutionData& expected, const SolutionData& calculated) {
+  REQUIRE(expected.finished);
+  REQUIRE(calculated.finished);
+  CHECK(expected.iterations == calculated.iterations);
+  REQUIRE(expected.solutions.size() == calculated.solutions.size());
+  for (unsigned ii = 0; ii < expected.solutions.size(); ++ii) {
+    CHECK(
+        expected.solutions[ii].assignments ==
+        calculated.solutions[ii].assignments);
+    CHECK(
+        expected.solutions[ii].scalar_product ==
+        calculated.solutions[ii].scalar_product);
+  }
+}
+
+SCENARIO("Target graph data can be reused and serialised") {
+  std::mt19937_64 engine(2468);
+  const GraphEdgeWeights target = get_random_graph(15, 20, engine);
+  std::vector<GraphEdgeWeights> patterns;
+  for (unsigned ii = 0; ii < 8; ++ii) {
+    patterns.push_back(get_random_graph(5 + ii % 4, ii % 3, engine));
+  }
+  MainSolverParameters parameters(10000);
+  parameters.iterations_timeout = 10000000;
+
+  std::vector<SolutionData> expected_results;
+  for (const GraphEdgeWeights& pattern : patterns) {
+    const MainSolver solver(pattern, target, parameters);
+    expected_results.push_back(solver.get_solution_data());
+    for (const SolutionWSM& solution : expected_results.back().solutions) {
+      REQUIRE(solution.get_errors(pattern, target) == "");
+    }
+  }
+
+  // Lazily filled by the solvers, and reused between them.
+  TargetGraphData target_data(target);
+  for (unsigned ii = 0; ii < patterns.size(); ++ii) {
+    const MainSolver solver(patterns[ii], target_data, parameters);
+    check_same_results(expected_results[ii], solver.get_solution_data());
+  }
+
+  std::stringstream ss;
+  target_data.write(ss);
+  {
+    // Reading and writing again gives exactly the same data.
+    TargetGraphData target_data_copy(ss);
+    std::stringstream ss_again;
+    target_data_copy.write(ss_again);
+    CHECK(ss.str() == ss_again.str());
+
+    for (unsigned ii = 0; ii < patterns.size(); ++ii) {
+      const MainSolver solver(patterns[ii], target_data_copy, parameters);
+      check_same_results(expected_results[ii], solver.get_solution_data());
+    }
+  }
+  {
+    // Data fully calculated in advance.
+    TargetGraphData precomputed_data(target);
+    precomputed_data.precompute(
+        parameters.max_distance_for_distance_reduction_during_search);
+    std::stringstream precomputed_ss;
+    precomputed_data.write(precomputed_ss);
+    CHECK(precomputed_ss.str().size() >= ss.str().size());
+    TargetGraphData precomputed_data_copy(precomputed_ss);
+    for (unsigned ii = 0; ii < patterns.size(); ++ii) {
+      const MainSolver solver(patterns[ii], precomputed_data_copy, parameters);
+      check_same_results(expected_results[ii], solver.get_solution_data());
+    }
+  }
+}
+
+SCENARIO("Invalid target graph data is rejected") {
+  const GraphEdgeWeights target{
+      {get_edge(0, 1), 2}, {get_edge(1, 2), 3}, {get_edge(2, 0), 4}};
+  TargetGraphData target_data(target);
+  target_data.precompute(3);
+  std::stringstream ss;
+  target_data.write(ss);
+  const std::string data = ss.str();
+  {
+    std::stringstream bad_ss("not_target_graph_data 1");
+    REQUIRE_THROWS_AS(TargetGraphData(bad_ss), std::runtime_error);
+  }
+  {
+    std::stringstream truncated_ss(data.substr(0, data.size() / 2));
+    REQUIRE_THROWS_AS(TargetGraphData(truncated_ss), std::runtime_error);
+  }
+  {
+    // A vertex which is not in the graph.
+    std::stringstream bad_vertex_ss(
+        "tkwsm_target_graph_data 1\n3\n0 1 2\n1 2 3\n0 2 4\n3\n1 1 9\n0\n0\n");
+    REQUIRE_THROWS_AS(TargetGraphData(bad_vertex_ss), std::runtime_error);
+  }
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
@@ -0,0 +1,180 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+#include <stdexcept>
+#include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+
+// A random connected graph with weights in [1,8],
+// with vertex labels spread out so that relabelling is needed.
+static GraphEdgeWeights get_random_graph(
+    unsigned number_of_vertices, unsigned number_of_extra_edges,
+    std::mt19937_64& engine) {
+  GraphEdgeWeights graph;
+  const auto label = [](unsigned vv) { return 2 * vv + 1; };
+  for (unsigned vv = 0; vv < number_of_vertices; ++vv) {
+    graph[get_edge(label(vv), label((vv + 1) % number_of_vertices))] =
+        1 + engine() % 8;
+  }
+  while (graph.size() < number_of_vertices + number_of_extra_edges) {
+    const unsigned v1 = engine() % number_of_vertices;
+    const unsigned v2 = engine() % number_of_vertices;
+    if (v1 != v2) {
+      graph[get_edge(label(v1), label(v2))] = 1 + engine() % 8;
+    }
+  }
+  return graph;
+}
+
+SCENARIO("Initial solutions and fixed assignments") {
+  std::mt19937_64 engine(13579);
+  MainSolverParameters parameters(10000);
+  parameters.iterations_timeout = 10000000;
+  MainSolverParameters all_solutions_parameters = parameters;
+  all_solutions_parameters
+      .for_multiple_full_solutions_the_max_number_to_obtain = 100000;
+
+  for (unsigned problem = 0; problem < 10; ++problem) {
+    const GraphEdgeWeights pattern = get_random_graph(6, 2, engine);
+    const GraphEdgeWeights target = get_random_graph(10, 10, engine);
+
+    const MainSolver all_solver(pattern, target, all_solutions_parameters);
+    const SolutionData& all_data = all_solver.get_solution_data();
+    REQUIRE(all_data.finished);
+    if (all_data.solutions.empty()) {
+      continue;
+    }
+    const MainSolver cold_solver(pattern, target, parameters);
+    const SolutionData& cold = cold_solver.get_solution_data();
+    REQUIRE(cold.finished);
+    REQUIRE(cold.solutions.size() == 1);
+    const WeightWSM optimal_weight = cold.solutions[0].scalar_product;
+
+    // Warm starts from the worst and the best solutions.
+    const SolutionWSM* worst_solution_ptr = &all_data.solutions[0];
+    for (const SolutionWSM& solution : all_data.solutions) {
+      if (solution.scalar_product > worst_solution_ptr->scalar_product) {
+        worst_solution_ptr = &solution;
+      }
+    }
+    for (const SolutionWSM* start_ptr :
+         {worst_solution_ptr, &cold.solutions[0]}) {
+      MainSolverParameters warm_parameters = parameters;
+      warm_parameters.initial_solution = start_ptr->assignments;
+      for (unsigned number_of_threads : {1, 3}) {
+        warm_parameters.number_of_threads = number_of_threads;
+        const MainSolver warm_solver(pattern, target, warm_parameters);
+        const SolutionData& warm = warm_solver.get_solution_data();
+        REQUIRE(warm.finished);
+        REQUIRE(warm.solutions.size() == 1);
+        CHECK(warm.solutions[0].scalar_product == optimal_weight);
+        CHECK(warm.solutions[0].get_errors(pattern, target) == "");
+      }
+
+      // When finding all solutions, only those at least as good.
+      MainSolverParameters warm_all_parameters = all_solutions_parameters;
+      warm_all_parameters.initial_solution = start_ptr->assignments;
+      const MainSolver warm_all_solver(pattern, target, warm_all_parameters);
+      const SolutionData& warm_all = warm_all_solver.get_solution_data();
+      REQUIRE(warm_all.finished);
+      unsigned expected_number = 0;
+      for (const SolutionWSM& solution : all_data.solutions) {
+        if (solution.scalar_product <= start_ptr->scalar_product) {
+          ++expected_number;
+        }
+      }
+      CHECK(warm_all.solutions.size() == expected_number);
+    }
+
+    // Fix all but two pattern vertices of the worst solution.
+    MainSolverParameters fixed_parameters = all_solutions_parameters;
+    fixed_parameters.fixed_assignments = worst_solution_ptr->assignments;
+    fixed_parameters.fixed_assignments.resize(
+        fixed_parameters.fixed_assignments.size() - 2);
+    const MainSolver fixed_solver(pattern, target, fixed_parameters);
+    const SolutionData& fixed = fixed_solver.get_solution_data();
+    REQUIRE(fixed.finished);
+    unsigned expected_number = 0;
+    for (const SolutionWSM& solution : all_data.solutions) {
+      if (std::equal(
+              fixed_parameters.fixed_assignments.cbegin(),
+              fixed_parameters.fixed_assignments.cend(),
+              solution.assignments.cbegin())) {
+        ++expected_number;
+      }
+    }
+    CHECK(expected_number > 0);
+    CHECK(fixed.solutions.size() == expected_number);
+    for (const SolutionWSM& solution : fixed.solutions) {
+      CHECK(solution.get_errors(pattern, target) == "");
+      CHECK(std::equal(
+          fixed_parameters.fixed_assignments.cbegin(),
+          fixed_parameters.fixed_assignments.cend(),
+          solution.assignments.cbegin()));
+    }
+  }
+}
+
+SCENARIO("Invalid initial solutions and fixed assignments are rejected") {
+  const GraphEdgeWeights pattern{{get_edge(0, 1), 1}, {get_edge(1, 2), 1}};
+  const GraphEdgeWeights target{
+      {get_edge(0, 1), 1}, {get_edge(1, 2), 1}, {get_edge(2, 3), 1}};
+  MainSolverParameters parameters;
+
+  parameters.initial_solution = {{0, 0}, {1, 1}, {2, 2}};
+  const MainSolver solver(pattern, target, parameters);
+  CHECK(solver.get_solution_data().finished);
+  CHECK(solver.get_solution_data().solutions.size() == 1);
+
+  // Not a monomorphism.
+  parameters.initial_solution = {{0, 0}, {1, 2}, {2, 3}};
+  REQUIRE_THROWS_AS(
+      MainSolver(pattern, target, parameters), std::runtime_error);
+  // Incomplete.
+  parameters.initial_solution = {{0, 0}, {1, 1}};
+  REQUIRE_THROWS_AS(
+      MainSolver(pattern, target, parameters), std::runtime_error);
+  // A repeated target vertex.
+  parameters.initial_solution = {{0, 1}, {1, 2}, {2, 1}};
+  REQUIRE_THROWS_AS(
+      MainSolver(pattern, target, parameters), std::runtime_error);
+  // Unknown vertices.
+  parameters.initial_solution = {{0, 0}, {1, 1}, {2, 2}, {3, 3}};
+  REQUIRE_THROWS_AS(
+      MainSolver(pattern, target, parameters), std::runtime_error);
+  // Inconsistent with the fixed assignments.
+  parameters.initial_solution = {{0, 0}, {1, 1}, {2, 2}};
+  parameters.fixed_assignments = {{1, 2}};
+  REQUIRE_THROWS_AS(
+      MainSolver(pattern, target, parameters), std::runtime_error);
+
+  parameters.initial_solution.clear();
+  parameters.fixed_assignments = {{5, 0}};
+  REQUIRE_THROWS_AS(
+      MainSolver(pattern, target, parameters), std::runtime_error);
+
+  // A fixed assignment which cannot occur makes the problem insoluble.
+  parameters.fixed_assignments = {{1, 0}};
+  const MainSolver insoluble_solver(pattern, target, parameters);
+  CHECK(insoluble_solver.get_solution_data().finished);
+  CHECK(insoluble_solver.get_solution_data().solutions.empty());
+}
+
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
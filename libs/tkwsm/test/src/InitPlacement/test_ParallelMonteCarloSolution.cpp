@@ -0,0 +1,105 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <tkrng/RNG.hpp>
+#include <tkwsm/Common/GeneralUtils.hpp>
+#include <tkwsm/GraphTheoretic/NeighboursData.hpp>
+#include <tkwsm/InitPlacement/MonteCarloCompleteTargetSolution.hpp>
+#include <tkwsm/InitPlacement/ParallelMonteCarloSolution.hpp>
+#include <tkwsm/InitPlacement/UtilsIQP.hpp>
+
+#include "TestWeightedGraphData.hpp"
+
+namespace tket {
+namespace WeightedSubgraphMonomorphism {
+namespace InitialPlacement {
+namespace tests {
+
+SCENARIO("Parallel Monte Carlo chains are reproducible") {
+  RNG rng;
+  const NeighboursData pattern_ndata(get_graph_data(rng, 8, 12, 1000, 2000));
+  const GraphEdgeWeights explicit_target_graph_data =
+      get_graph_data(rng, 15, 25, 10, 100);
+  const NeighboursData target_ndata(explicit_target_graph_data);
+  const WeightWSM implicit_target_weight =
+      2 * get_max_weight(explicit_target_graph_data);
+  const unsigned max_iterations = 20000;
+
+  const MonteCarloCompleteTargetSolution single_chain(
+      pattern_ndata, target_ndata, implicit_target_weight, max_iterations);
+  {
+    // A single chain with the default seed is just the original solver.
+    const ParallelMonteCarloSolution solution(
+        pattern_ndata, target_ndata, implicit_target_weight, 1, 5489, 0,
+        max_iterations);
+    CHECK(
+        solution.get_best_assignments() ==
+        single_chain.get_best_assignments());
+    CHECK(
+        solution.get_best_scalar_product() ==
+        single_chain.get_best_scalar_product());
+    CHECK(solution.iterations() == single_chain.iterations());
+    CHECK(solution.get_best_chain_index() == 0);
+  }
+  const unsigned number_of_chains = 6;
+  const ParallelMonteCarloSolution sequential(
+      pattern_ndata, target_ndata, implicit_target_weight, number_of_chains,
+      1234, 1, max_iterations);
+  CHECK(
+      sequential.get_best_scalar_product() ==
+      get_scalar_product_with_complete_target(
+          pattern_ndata, target_ndata, implicit_target_weight,
+          sequential.get_best_assignments()));
+
+  // The chosen chain really did produce the best solution.
+  WeightWSM best_scalar_product;
+  set_maximum(best_scalar_product);
+  for (unsigned ii = 0; ii < number_of_chains; ++ii) {
+    const MonteCarloCompleteTargetSolution chain(
+        pattern_ndata, target_ndata, implicit_target_weight, max_iterations,
+        ParallelMonteCarloSolution::get_chain_seed(1234, ii));
+    if (ii == sequential.get_best_chain_index()) {
+      CHECK(chain.get_best_assignments() == sequential.get_best_assignments());
+    }
+    best_scalar_product =
+        std::min(best_scalar_product, chain.get_best_scalar_product());
+  }
+  CHECK(best_scalar_product == sequential.get_best_scalar_product());
+
+  // The number of threads makes no difference.
+  for (unsigned number_of_threads : {2, 3, 6}) {
+    const ParallelMonteCarloSolution parallel(
+        pattern_ndata, target_ndata, implicit_target_weight, number_of_chains,
+        1234, number_of_threads, max_iterations);
+    CHECK(
+        parallel.get_best_assignments() == sequential.get_best_assignments());
+    CHECK(
+        parallel.get_best_scalar_product() ==
+        sequential.get_best_scalar_product());
+    CHECK(parallel.iterations() == sequential.iterations());
+    CHECK(parallel.get_best_chain_index() == sequential.get_best_chain_index());
+  }
+  REQUIRE_THROWS_AS(
+      ParallelMonteCarloSolution(
+          pattern_ndata, target_ndata, implicit_target_weight, 0),
+      std::runtime_error);
+}
+
+}  // namespace tests
+}  // namespace InitialPlacement
+}  // namespace WeightedSubgraphMonomorphism
+}  // namespace tket
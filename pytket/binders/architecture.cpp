@@ -84,12 +84,22 @@ PYBIND11_MODULE(architecture, m) {
           "UnitIDs. ")
       .def(
           "to_dict",
-          [](const Architecture &arch) {
-            return py::object(json(arch)).cast<py::dict>();
+          [](const Architecture &arch, bool precomputed) {
+            json j;
+            {
+              py::gil_scoped_release release;
+              j = precomputed ? architecture_to_json_with_precomputed(arch)
+                              : json(arch);
+            }
+            return py::object(j).cast<py::dict>();
           },
           "Return a JSON serializable dict representation of "
           "the Architecture."
-          "\n\n:return: dict containing nodes and links.")
+          "\n\n:param precomputed: whether to include the distances between "
+          "nodes, the diameter and the articulation points, so that the "
+          "architecture loads without computing them"
+          "\n:return: dict containing nodes and links.",
+          py::arg("precomputed") = false)
       .def_static(
           "from_dict",
           [](const py::dict &architecture_dict) {
@@ -12,16 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include <optional>
+#include <stdexcept>
 #include <vector>
 
 #include "UnitRegister.hpp"
 #include "add_gate.hpp"
 #include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/CircuitBuilder.hpp"
 #include "tket/Circuit/ClassicalExpBox.hpp"
 #include "tket/Circuit/ConjugationBox.hpp"
 #include "tket/Circuit/DiagonalBox.hpp"
@@ -80,6 +83,43 @@ static Circuit *add_box_method(
   return add_gate_method(circ, box_ptr, args, kwargs);
 }
 
+template <typename T>
+using py_c_array_t = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+static Circuit *add_gates_method(
+    Circuit *circ, const py_c_array_t<int> &types,
+    const py_c_array_t<unsigned> &qubits,
+    const std::optional<py_c_array_t<double>> &params) {
+  const py::ssize_t n = types.size();
+  if (types.ndim() != 1 || qubits.ndim() != 2 || qubits.shape(0) != n ||
+      (params && (params->ndim() != 2 || params->shape(0) != n))) {
+    throw std::invalid_argument(
+        "types must be a vector and qubits and params matrices with one row "
+        "per gate");
+  }
+  std::vector<OpType> op_types(n);
+  for (py::ssize_t i = 0; i < n; ++i) {
+    op_types[i] = static_cast<OpType>(types.data()[i]);
+  }
+  std::vector<unsigned> qubit_data(
+      qubits.data(), qubits.data() + qubits.size());
+  const unsigned qubit_width = qubits.shape(1);
+  std::vector<double> param_data;
+  unsigned param_width = 0;
+  if (params) {
+    param_data.assign(params->data(), params->data() + params->size());
+    param_width = params->shape(1);
+  }
+  py::gil_scoped_release release;
+  unsigned n_qubits = 0;
+  while (circ->contains_unit(Qubit(n_qubits))) ++n_qubits;
+  CircuitBuilder builder(n_qubits);
+  builder.add_gates(
+      op_types, qubit_data, qubit_width, param_data, param_width);
+  circ->append(builder.build());
+  return circ;
+}
+
 void init_circuit_add_op(py::class_<Circuit, std::shared_ptr<Circuit>> &c) {
   c.def(
        "add_gate", &add_gate_method_sequence_args<unsigned>,
@@ -175,6 +215,22 @@ void init_circuit_add_op(py::class_<Circuit, std::shared_ptr<Circuit>> &c) {
           "conditions"
           "\n:return: the new :py:class:`Circuit`",
           py::arg("type"), py::arg("angles"), py::arg("args"))
+      .def(
+          "add_gates", &add_gates_method,
+          "Appends a sequence of gates given as NumPy arrays, with one "
+          "entry or row per gate, acting on qubits of the default register "
+          "('q'). This is much faster than adding the gates one at a time."
+          "\n\n>>> c.add_gates(np.array([int(OpType.H), int(OpType.CX)]), "
+          "np.array([[0, 0], [0, 1]]))"
+          "\n\n:param types: The type codes of the gates, as given by "
+          "``int(OpType.X)``. Each must be a gate acting on a fixed number "
+          "of qubits and nothing else."
+          "\n:param qubits: A matrix whose row `i` begins with the indices "
+          "of the qubits of gate `i`; any further entries are ignored"
+          "\n:param params: A matrix whose row `i` begins with the "
+          "parameters of gate `i` in halfturns, if any gate has parameters"
+          "\n:return: the new :py:class:`Circuit`",
+          py::arg("types"), py::arg("qubits"), py::arg("params") = py::none())
       .def(
           "add_barrier",
           [](Circuit *circ,
@@ -17,14 +17,22 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
 #include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "UnitRegister.hpp"
 #include "binder_json.hpp"
 #include "boost/graph/iteration_macros.hpp"
 #include "deleted_hash.hpp"
+#include "numpy_utils.hpp"
 #include "py_operators.hpp"
 #include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/Circuit.hpp"
@@ -58,6 +66,36 @@ UnitID to_cpp_unitid(const PyUnitID &py_unitid) {
   return get<Bit>(py_unitid);
 }
 
+static py::dict command_columns_to_dict(CommandColumns &&cols) {
+  py::list units;
+  for (const UnitID &u : cols.units) {
+    switch (u.type()) {
+      case UnitType::Qubit:
+        units.append(Qubit(u));
+        break;
+      case UnitType::Bit:
+        units.append(Bit(u));
+        break;
+      default:
+        units.append(u);
+    }
+  }
+  std::vector<std::int32_t> op_types(cols.op_types.size());
+  std::transform(
+      cols.op_types.begin(), cols.op_types.end(), op_types.begin(),
+      [](OpType t) { return static_cast<std::int32_t>(t); });
+  py::dict d;
+  d["units"] = units;
+  d["op_types"] = vector_to_numpy(std::move(op_types));
+  d["args"] = vector_to_numpy(std::move(cols.args));
+  d["arg_offsets"] = vector_to_numpy(std::move(cols.arg_offsets));
+  d["params"] = vector_to_numpy(std::move(cols.params));
+  d["param_offsets"] = vector_to_numpy(std::move(cols.param_offsets));
+  d["opgroups"] = cols.opgroups;
+  d["opgroup_ids"] = vector_to_numpy(std::move(cols.opgroup_ids));
+  return d;
+}
+
 void init_circuit_add_op(py::class_<Circuit, std::shared_ptr<Circuit>> &c);
 void init_circuit_add_classical_op(
     py::class_<Circuit, std::shared_ptr<Circuit>> &c);
@@ -129,14 +167,46 @@ void def_circuit(py::class_<Circuit, std::shared_ptr<Circuit>> &pyCircuit) {
             return out;
           },
           ":return: a list of all the Commands in the circuit")
+      .def(
+          "get_command_columns",
+          [](const Circuit &circ) {
+            CommandColumns cols;
+            {
+              py::gil_scoped_release release;
+              cols = circ.get_command_columns();
+            }
+            return command_columns_to_dict(std::move(cols));
+          },
+          "The commands of the circuit as NumPy arrays, for fast bulk "
+          "processing. Commands are in a topological order, which need not "
+          "be that of :py:meth:`get_commands`. Apart from the op types, the "
+          "arrays take over the buffers built in C++ without copying."
+          "\n\nThe dictionary has the following entries:"
+          "\n\n- ``units``: the qubits, then bits, of the circuit"
+          "\n- ``op_types``: the type code of each command, as given by "
+          "``int(OpType.X)``"
+          "\n- ``args``, ``arg_offsets``: the arguments of command `i` are "
+          "``args[arg_offsets[i]:arg_offsets[i + 1]]``, as indices into "
+          "``units``"
+          "\n- ``params``, ``param_offsets``: likewise the parameters of "
+          "each gate in halfturns, NaN if symbolic"
+          "\n- ``opgroups``: the distinct opgroup names"
+          "\n- ``opgroup_ids``: the index into ``opgroups`` of the opgroup "
+          "of each command, or -1"
+          "\n\n:return: a dictionary of arrays describing the commands")
       .def(
           "get_unitary",
-          [](const Circuit &circ) { return tket_sim::get_unitary(circ); },
+          [](const Circuit &circ) {
+            py::gil_scoped_release release;
+            // Returned by value, so pybind11 hands the buffer to NumPy
+            return tket_sim::get_unitary(circ);
+          },
           ":return: The numerical unitary matrix of the circuit, using ILO-BE "
           "convention.")
       .def(
           "get_unitary_times_other",
           [](const Circuit &circ, Eigen::MatrixXcd matr) {
+            py::gil_scoped_release release;
             tket_sim::apply_unitary(circ, matr);
             return matr;
           },
@@ -149,7 +219,14 @@ void def_circuit(py::class_<Circuit, std::shared_ptr<Circuit>> &pyCircuit) {
           py::arg("matr"))
       .def(
           "get_statevector",
-          [](const Circuit &circ) { return tket_sim::get_statevector(circ); },
+          [](const Circuit &circ) {
+            Eigen::MatrixXcd state;
+            {
+              py::gil_scoped_release release;
+              state = tket_sim::get_statevector_column(circ);
+            }
+            return matrix_to_flat_numpy(std::move(state));
+          },
           "Calculate the unitary matrix of the circuit, using ILO-BE "
           "convention, applied to the column vector (1,0,0...), "
           "which is thus another column vector. Due to "
@@ -592,9 +669,18 @@ void def_circuit(py::class_<Circuit, std::shared_ptr<Circuit>> &pyCircuit) {
           py::arg("filename"))
       .def(
           "to_dict",
-          [](const Circuit &c) { return py::object(json(c)).cast<py::dict>(); },
-          ":return: a JSON serializable dictionary representation of "
-          "the Circuit")
+          [](const Circuit &c, bool box_table) {
+            json j = box_table ? circuit_to_json_with_box_table(c) : json(c);
+            return py::object(j).cast<py::dict>();
+          },
+          "Convert the Circuit to a JSON serializable dictionary. With "
+          "`box_table`, each distinct box is written once in a \"boxes\" "
+          "table and referenced by id from the commands; :py:meth:`from_dict` "
+          "then shares one operation between all references to a box."
+          "\n\n:param box_table: whether to write boxes to a table"
+          "\n:return: a JSON serializable dictionary representation of "
+          "the Circuit",
+          py::arg("box_table") = false)
       .def_static(
           "from_dict",
           [](const py::dict &circuit_dict) {
@@ -602,6 +688,40 @@ void def_circuit(py::class_<Circuit, std::shared_ptr<Circuit>> &pyCircuit) {
           },
           "Construct Circuit instance from JSON serializable "
           "dictionary representation of the Circuit.")
+      .def(
+          "to_binary",
+          [](const Circuit &c) {
+            std::vector<std::uint8_t> data = c.to_binary();
+            return py::bytes(
+                reinterpret_cast<const char *>(data.data()), data.size());
+          },
+          ":return: a compact binary serialisation of the Circuit, holding "
+          "the same information as :py:meth:`to_dict`")
+      .def_static(
+          "from_binary",
+          [](const py::bytes &data) {
+            std::string_view s = data;
+            return Circuit::from_binary(
+                reinterpret_cast<const std::uint8_t *>(s.data()), s.size());
+          },
+          "Construct Circuit instance from the result of "
+          ":py:meth:`to_binary`.",
+          py::arg("data"))
+      .def_static(
+          "from_json_file",
+          [](const std::string &path) {
+            std::ifstream in(path);
+            if (!in) {
+              throw std::invalid_argument("Cannot open file " + path);
+            }
+            py::gil_scoped_release release;
+            return Circuit::from_json_stream(in);
+          },
+          "Construct Circuit instance from a file holding its JSON "
+          "serialisation, as written by ``json.dump(c.to_dict(), f)``. The "
+          "file is read incrementally, so that the whole JSON document is "
+          "never held in memory.",
+          py::arg("path"))
       .def(py::pickle(
           [](const py::object &self) {  // __getstate__
             return py::make_tuple(self.attr("to_dict")());
@@ -829,7 +949,10 @@ void def_circuit(py::class_<Circuit, std::shared_ptr<Circuit>> &pyCircuit) {
       .def("_classical_eval", &Circuit::classical_eval)
 
       .def(
-          "valid_connectivity", &respects_connectivity_constraints,
+          "valid_connectivity",
+          py::overload_cast<
+              const Circuit &, const Architecture &, bool, bool>(
+              &respects_connectivity_constraints),
           "Confirms whether all two qubit gates in given circuit are "
           "along some edge of the architecture."
           "\n\n:param arch: The architecture capturing the desired "
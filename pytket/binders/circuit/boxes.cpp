@@ -1057,7 +1057,8 @@ void init_boxes(py::module &m) {
   py::class_<StatePreparationBox, std::shared_ptr<StatePreparationBox>, Op>(
       m, "StatePreparationBox",
       "A box for preparing quantum states using multiplexed-Ry and "
-      "multiplexed-Rz gates")
+      "multiplexed-Rz gates, or for states with few non-zero amplitudes, "
+      "controlled rotations")
       .def(
           py::init<const Eigen::VectorXcd &, bool, bool>(),
           "Construct from a statevector\n\n"
@@ -1084,19 +1085,34 @@ void init_boxes(py::module &m) {
           "with_initial_reset", &StatePreparationBox::with_initial_reset,
           ":return: flag indicating whether the qubits are explicitly "
           "set to the zero state initially");
+  py::enum_<DiagonalBoxSynthStrat>(
+      m, "DiagonalBoxSynthStrat",
+      "Enum strategies for synthesising DiagonalBoxes")
+      .value(
+          "Multiplexor", DiagonalBoxSynthStrat::Multiplexor,
+          "Use a sequence of multiplexed-Rz gates")
+      .value(
+          "PhasePolynomial", DiagonalBoxSynthStrat::PhasePolynomial,
+          "Expand the phases in the Walsh basis and synthesise the resulting "
+          "phase polynomial with CX and Rz gates using GraySynth");
   py::class_<DiagonalBox, std::shared_ptr<DiagonalBox>, Op>(
       m, "DiagonalBox",
       "A box for synthesising a diagonal unitary matrix into a sequence of "
-      "multiplexed-Rz gates.")
+      "multiplexed-Rz gates, or into a phase polynomial.")
       .def(
-          py::init<const Eigen::VectorXcd &, bool>(),
+          py::init<
+              const Eigen::VectorXcd &, bool, const DiagonalBoxSynthStrat &>(),
           "Construct from the diagonal entries of the unitary operator. The "
           "size of the vector must be 2^n where n is a positive integer.\n\n"
           ":param diagonal: diagonal entries\n"
           ":param upper_triangle: indicates whether the multiplexed-Rz gates "
           "take the shape of an upper triangle or a lower triangle. Default to "
-          "true.",
-          py::arg("diagonal"), py::arg("upper_triangle") = true)
+          "true. Only applicable to the "
+          ":py:attr:`DiagonalBoxSynthStrat.Multiplexor` strategy.\n"
+          ":param strat: synthesis strategy. Default to "
+          ":py:attr:`DiagonalBoxSynthStrat.Multiplexor`.",
+          py::arg("diagonal"), py::arg("upper_triangle") = true,
+          py::arg("strat") = DiagonalBoxSynthStrat::Multiplexor)
       .def(
           "get_circuit", [](DiagonalBox &box) { return *box.to_circuit(); },
           ":return: the :py:class:`Circuit` described by the box")
@@ -1105,7 +1121,10 @@ void init_boxes(py::module &m) {
           ":return: the statevector")
       .def(
           "is_upper_triangle", &DiagonalBox::is_upper_triangle,
-          ":return: the upper_triangle flag");
+          ":return: the upper_triangle flag")
+      .def(
+          "get_strat", &DiagonalBox::get_strat,
+          ":return: the synthesis strategy");
   py::class_<ConjugationBox, std::shared_ptr<ConjugationBox>, Op>(
       m, "ConjugationBox",
       "A box to express computations that follow the compute-action-uncompute "
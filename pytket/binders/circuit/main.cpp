@@ -23,6 +23,8 @@
 #include "binder_utils.hpp"
 #include "deleted_hash.hpp"
 #include "py_operators.hpp"
+#include "tket/Circuit/CircuitArchive.hpp"
+#include "tket/Circuit/SymbolBinding.hpp"
 #include "tket/Circuit/Command.hpp"
 #include "tket/Gate/Gate.hpp"
 #include "tket/Gate/OpPtrFunctions.hpp"
@@ -655,6 +657,87 @@ PYBIND11_MODULE(circuit, m) {
   init_classical(m);
   def_circuit(pyCircuit);
 
+  py::class_<CircuitArchive, std::shared_ptr<CircuitArchive>>(
+      m, "CircuitArchive",
+      "A file holding many named circuits, each read only when asked for. "
+      "Opening an archive maps the file into memory without reading the "
+      "circuits, so it takes the same time however many it holds.")
+      .def(
+          py::init<const std::string &>(),
+          "Open an archive written by :py:meth:`write`."
+          "\n\n:param path: file holding the archive",
+          py::arg("path"))
+      .def_static(
+          "write",
+          [](const std::string &path,
+             const std::map<std::string, Circuit> &circuits) {
+            py::gil_scoped_release release;
+            CircuitArchive::write(path, circuits);
+          },
+          "Write an archive, storing each circuit in the binary "
+          "serialisation of :py:meth:`Circuit.to_binary`."
+          "\n\n:param path: file to write"
+          "\n:param circuits: circuits by name",
+          py::arg("path"), py::arg("circuits"))
+      .def(
+          "names", &CircuitArchive::names,
+          ":return: the names of the circuits, in sorted order")
+      .def("__len__", &CircuitArchive::size)
+      .def("__contains__", &CircuitArchive::contains, py::arg("name"))
+      .def(
+          "__getitem__",
+          [](const CircuitArchive &archive, const std::string &name) {
+            try {
+              py::gil_scoped_release release;
+              return archive.get(name);
+            } catch (const std::out_of_range &) {
+              throw py::key_error(name);
+            }
+          },
+          "Read the circuit with the given name.", py::arg("name"));
+
+  py::class_<SymbolBindingPlan, std::shared_ptr<SymbolBindingPlan>>(
+      m, "SymbolBindingPlan",
+      "A symbolic circuit prepared for repeated substitution of numbers for "
+      "its symbols. Each parameter that depends on the symbols is compiled "
+      "once to a numeric function, so that binding a set of values costs "
+      "little more than copying the circuit.")
+      .def(
+          py::init<const Circuit &, const std::vector<Sym> &>(),
+          "Prepare a circuit for binding."
+          "\n\n:param circuit: symbolic circuit"
+          "\n:param symbols: symbols in the order of the values to be bound, "
+          "including every free symbol of the circuit",
+          py::arg("circuit"), py::arg("symbols"))
+      .def_property_readonly(
+          "symbols", &SymbolBindingPlan::get_symbols,
+          "Symbols in the order of the values to be bound.")
+      .def(
+          "bind",
+          [](const SymbolBindingPlan &plan, const std::vector<double> &values) {
+            py::gil_scoped_release release;
+            return plan.bind(values);
+          },
+          "Substitute values for the symbols."
+          "\n\n:param values: one value for each symbol, in the order of "
+          ":py:attr:`symbols`"
+          "\n:return: a new circuit with the values substituted",
+          py::arg("values"))
+      .def(
+          "bind_all",
+          [](const SymbolBindingPlan &plan,
+             const std::vector<std::vector<double>> &values,
+             unsigned n_threads) {
+            py::gil_scoped_release release;
+            return plan.bind_all(values, n_threads);
+          },
+          "Substitute several sets of values for the symbols, in parallel."
+          "\n\n:param values: sets of values, each as for :py:meth:`bind`"
+          "\n:param n_threads: number of threads to use, or 0 to use one "
+          "for each hardware thread"
+          "\n:return: one new circuit for each set of values",
+          py::arg("values"), py::arg("n_threads") = 0);
+
   m.def(
       "fresh_symbol", &SymTable::fresh_symbol,
       "Given some preferred symbol, this finds an appropriate suffix "
@@ -0,0 +1,52 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <complex>
+#include <utility>
+#include <vector>
+
+#include "tket/Utils/EigenConfig.hpp"
+namespace py = pybind11;
+
+namespace tket {
+
+/** Hand a vector over to NumPy without copying its data. */
+template <typename T>
+py::array_t<T> vector_to_numpy(std::vector<T> &&v) {
+  auto *owned = new std::vector<T>(std::move(v));
+  py::capsule free_when_done(
+      owned, [](void *p) { delete static_cast<std::vector<T> *>(p); });
+  return py::array_t<T>(owned->size(), owned->data(), free_when_done);
+}
+
+/**
+ * Hand a matrix over to NumPy without copying its data, as a 1-dimensional
+ * array of its entries in column-major order; for a single column, the
+ * column as a vector.
+ */
+inline py::array_t<std::complex<double>> matrix_to_flat_numpy(
+    Eigen::MatrixXcd &&m) {
+  auto *owned = new Eigen::MatrixXcd(std::move(m));
+  py::capsule free_when_done(
+      owned, [](void *p) { delete static_cast<Eigen::MatrixXcd *>(p); });
+  return py::array_t<std::complex<double>>(
+      owned->size(), owned->data(), free_when_done);
+}
+
+}  // namespace tket
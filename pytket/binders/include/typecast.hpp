@@ -22,6 +22,7 @@
 #include <pybind11/pytypes.h>
 #include <pybind11/stl.h>
 
+#include "tket/Gate/SymTable.hpp"
 #include "tket/Utils/Expression.hpp"
 #include "tket/Utils/Symbols.hpp"
 #include "unit_downcast.hpp"
@@ -197,7 +198,7 @@ struct type_caster<SymEngine::Expression> {
 
     if (isinstance(py_expr, sympy.attr("Symbol"))) {
       handle expr_name = py_expr.attr("name");
-      tket::Sym sym = SymEngine::symbol(expr_name.cast<std::string>());
+      tket::Sym sym = tket::SymTable::intern(expr_name.cast<std::string>());
       return tket::Expr(sym);
     } else if (isinstance(py_expr, sympy.attr("Mul"))) {
       tuple arg_tuple = py_expr.attr("args");
@@ -460,7 +461,7 @@ struct type_caster<SymEngine::RCP<const SymEngine::Symbol>> {
   bool load(handle src, bool) {
     pybind11::module sympy = pybind11::module::import("sympy");
     if (!isinstance(src, sympy.attr("Symbol"))) return false;
-    value = SymEngine::symbol(repr(src));
+    value = tket::SymTable::intern(repr(src));
     return true;
   }
   static handle cast(
@@ -117,13 +117,18 @@ PYBIND11_MODULE(mapping, m) {
       "Defines a RoutingMethod object for commuting physically permitted "
       "multi-qubit gates to the front of the subcircuit.")
       .def(
-          py::init<unsigned, unsigned>(),
+          py::init<unsigned, unsigned, bool>(),
           "MultiGateReorderRoutingMethod constructor.\n\n:param max_depth: "
           "Maximum number of layers of gates checked for simultaneous "
           "commutation. "
           "\n:param max_size: Maximum number of gates checked for simultaneous "
-          "commutation.",
-          py::arg("max_depth") = 10, py::arg("max_size") = 10);
+          "commutation."
+          "\n:param scheduled: If True, examine the gates beyond the frontier "
+          "from a ready-list ordered by the distance between their qubits, so "
+          "that max_size gates can be examined at roughly linear cost; "
+          "max_depth is then not used.",
+          py::arg("max_depth") = 10, py::arg("max_size") = 10,
+          py::arg("scheduled") = false);
 
   py::class_<
       BoxDecompositionRoutingMethod,
@@ -148,6 +153,7 @@ PYBIND11_MODULE(mapping, m) {
           [](const MappingManager& self, Circuit& circuit,
              const py::tket_custom::SequenceVec<RoutingMethodPtr>&
                  routing_methods) {
+            py::gil_scoped_release release;
             return self.route_circuit(circuit, routing_methods);
           },
           "Maps from given logical circuit to physical circuit. Modification "
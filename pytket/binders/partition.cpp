@@ -151,6 +151,38 @@ PYBIND11_MODULE(partition, m) {
           },
           "Construct MeasurementSetup instance from dict representation.");
 
+  py::class_<PauliPartitionStream>(
+      m, "PauliPartitionStream",
+      "Partitions Pauli strings which are added in chunks, so that large "
+      "operators need not be held as a single list. Repeated strings are "
+      "dropped, and each new string joins the first compatible set, as for "
+      "`GraphColourMethod.Lazy`.")
+      .def(
+          py::init<PauliPartitionStrat>(),
+          "Constructs an empty partition."
+          "\n\n:param strat: The `PauliPartitionStrat` to use.",
+          py::arg("strat"))
+      .def(
+          "add_strings",
+          [](PauliPartitionStream &stream,
+             const py::tket_custom::SequenceList<SpPauliString> &strings) {
+            return stream.add_strings(strings);
+          },
+          "Add a chunk of strings to the partition."
+          "\n\n:param strings: A list of `QubitPauliString` objects."
+          "\n:return: the number of strings not seen before",
+          py::arg("strings"))
+      .def_property_readonly(
+          "n_strings", &PauliPartitionStream::n_strings,
+          "Number of distinct strings added so far.")
+      .def_property_readonly(
+          "n_sets", &PauliPartitionStream::n_sets,
+          "Number of sets in the partition so far.")
+      .def(
+          "get_sets", &PauliPartitionStream::get_sets,
+          "The sets so far, in order of creation."
+          "\n\n:return: a list of lists of " CLSOBJS(QubitPauliString));
+
   m.def(
       "measurement_reduction",
       [](const py::tket_custom::SequenceList<SpPauliString> &strings,
@@ -171,6 +203,19 @@ PYBIND11_MODULE(partition, m) {
       py::arg("method") = GraphColourMethod::Lazy,
       py::arg("cx_config") = CXConfigType::Snake);
 
+  m.def(
+      "measurement_reduction",
+      [](const PauliPartitionStream &stream, CXConfigType cx_config) {
+        return measurement_reduction(stream, cx_config);
+      },
+      "Diagonalises the sets of a :py:class:`PauliPartitionStream` to "
+      "reduce measurements required for its Pauli strings."
+      "\n\n:param stream: The partitioned strings."
+      "\n:param cx_config: Whenever diagonalisation is required, use "
+      "this configuration of CX gates"
+      "\n:return: a :py:class:`MeasurementSetup` object",
+      py::arg("stream"), py::arg("cx_config") = CXConfigType::Snake);
+
   m.def(
       "term_sequence",
       [](const py::tket_custom::SequenceList<SpPauliString> &strings,
@@ -21,9 +21,12 @@
 #include "tket/Mapping/LexiLabelling.hpp"
 #include "tket/Mapping/LexiRoute.hpp"
 #include "tket/Mapping/RoutingMethod.hpp"
+#include "tket/Predicates/CachedPass.hpp"
 #include "tket/Predicates/CompilerPass.hpp"
 #include "tket/Predicates/PassGenerators.hpp"
 #include "tket/Predicates/PassLibrary.hpp"
+#include "tket/Predicates/PassProfiler.hpp"
+#include "tket/Predicates/PassTuner.hpp"
 #include "tket/Transformations/ContextualReduction.hpp"
 #include "tket/Transformations/PauliOptimisation.hpp"
 #include "tket/Transformations/Transform.hpp"
@@ -42,6 +45,8 @@ typedef std::function<void(const CompilationUnit &, const py::object &)>
 PassCallback from_py_pass_callback(const PyPassCallback &py_pass_callback) {
   return [py_pass_callback](
              const CompilationUnit &compilationUnit, const json &j) {
+    // Passes are applied with the GIL released
+    py::gil_scoped_acquire acquire;
     return py_pass_callback(compilationUnit, py::object(j));
   };
 }
@@ -219,7 +224,10 @@ PYBIND11_MODULE(passes, m) {
       .def(
           "apply",
           [](const BasePass &pass, CompilationUnit &cu,
-             SafetyMode safety_mode) { return pass.apply(cu, safety_mode); },
+             SafetyMode safety_mode) {
+            py::gil_scoped_release release;
+            return pass.apply(cu, safety_mode);
+          },
           "Apply to a :py:class:`CompilationUnit`.\n\n"
           ":return: True if the pass modified the circuit. Note that in some "
           "cases the method may return True even when the circuit is "
@@ -230,6 +238,7 @@ PYBIND11_MODULE(passes, m) {
       .def(
           "apply",
           [](const BasePass &pass, Circuit &circ) {
+            py::gil_scoped_release release;
             CompilationUnit cu(circ);
             bool applied = pass.apply(cu);
             circ = cu.get_circ_ref();
@@ -243,10 +252,11 @@ PYBIND11_MODULE(passes, m) {
           [](const BasePass &pass, Circuit &circ,
              const PyPassCallback &before_apply,
              const PyPassCallback &after_apply) {
+            PassCallback before = from_py_pass_callback(before_apply);
+            PassCallback after = from_py_pass_callback(after_apply);
+            py::gil_scoped_release release;
             CompilationUnit cu(circ);
-            bool applied = pass.apply(
-                cu, SafetyMode::Default, from_py_pass_callback(before_apply),
-                from_py_pass_callback(after_apply));
+            bool applied = pass.apply(cu, SafetyMode::Default, before, after);
             circ = cu.get_circ_ref();
             return applied;
           },
@@ -261,6 +271,39 @@ PYBIND11_MODULE(passes, m) {
           "configuration are passed into the callback."
           "\n:return: True if pass modified the circuit, else False",
           py::arg("circuit"), py::arg("before_apply"), py::arg("after_apply"))
+      .def(
+          "apply_batch",
+          [](const BasePass &pass, const std::vector<Circuit *> &circuits,
+             unsigned n_threads) {
+            std::vector<CompilationUnit> cus;
+            cus.reserve(circuits.size());
+            for (const Circuit *circ : circuits) {
+              cus.emplace_back(*circ);
+            }
+            std::vector<bool> applied;
+            {
+              py::gil_scoped_release release;
+              applied = pass.apply_batch(cus, n_threads);
+            }
+            for (unsigned i = 0; i < circuits.size(); ++i) {
+              *circuits[i] = cus[i].get_circ_ref();
+            }
+            return applied;
+          },
+          "Apply to each of a list of :py:class:`Circuit` in-place, "
+          "compiling them in parallel.\n\n"
+          "The results are the same as applying the pass to each circuit in "
+          "turn. If the pass raises an error on any circuit, that error is "
+          "raised and none of the circuits is modified.\n\n"
+          "Passes that hold an architecture, such as placement and routing "
+          "passes, fill caches in the architecture as they run, so must be "
+          "applied with ``n_threads=1``."
+          "\n\n:param circuits: circuits to compile"
+          "\n:param n_threads: number of threads to use, or 0 (the default) "
+          "to use one per available CPU"
+          "\n:return: for each circuit, True if the pass modified it, else "
+          "False",
+          py::arg("circuits"), py::arg("n_threads") = 0)
       .def("__str__", [](const BasePass &) { return "<tket::BasePass>"; })
       .def("__repr__", &BasePass::to_string)
       .def(
@@ -276,6 +319,25 @@ PYBIND11_MODULE(passes, m) {
           },
           "Construct a new Pass instance from a JSON serializable dictionary "
           "representation.")
+      .def(
+          "to_bytes",
+          [](const PassPtr &base_pass) {
+            std::vector<std::uint8_t> bytes = pass_to_bytes(base_pass);
+            return py::bytes(
+                reinterpret_cast<const char *>(bytes.data()), bytes.size());
+          },
+          ":return: a compact binary encoding of the dictionary "
+          "representation of the Pass.")
+      .def_static(
+          "from_bytes",
+          [](const py::bytes &data) {
+            std::string s = data;
+            return pass_from_bytes(
+                std::vector<std::uint8_t>(s.begin(), s.end()));
+          },
+          "Construct a new Pass instance from the result of "
+          ":py:meth:`to_bytes`.",
+          py::arg("data"))
       .def(py::pickle(
           [](py::object self) {  // __getstate__
             return py::make_tuple(self.attr("to_dict")());
@@ -287,17 +349,232 @@ PYBIND11_MODULE(passes, m) {
   py::class_<SequencePass, std::shared_ptr<SequencePass>, BasePass>(
       m, "SequencePass", "A sequence of compilation passes.")
       .def(
-          py::init<const py::tket_custom::SequenceVec<PassPtr> &>(),
+          py::init<const py::tket_custom::SequenceVec<PassPtr> &, bool>(),
           "Construct from a list of compilation passes arranged in "
-          "order of application.",
-          py::arg("pass_list"))
+          "order of application."
+          "\n\n:param pass_list: passes in order of application"
+          "\n:param fuse: whether to apply each run of adjacent local rewrite "
+          "passes, such as rebases, squashes, :py:meth:`RemoveRedundancies` "
+          "and :py:meth:`DecomposeBoxes`, as a single pass. The resulting "
+          "circuit is the same, but predicates are checked once per run.",
+          py::arg("pass_list"), py::arg("fuse") = false)
       .def("__str__", [](const BasePass &) { return "<tket::SequencePass>"; })
       .def(
           "get_sequence", &SequencePass::get_sequence,
           ":return: The underlying sequence of passes.");
+  py::class_<CachedPass, std::shared_ptr<CachedPass>, BasePass>(
+      m, "CachedPass",
+      "Remember the results of applying a pass, so that applying it again "
+      "to an equal circuit returns the same result without recompiling. "
+      "Results may also be stored as files in a directory, where they are "
+      "found by later instances wrapping a pass with the same configuration. "
+      "Passes whose configuration does not determine their behaviour, such "
+      "as a :py:class:`CustomPass`, should not use a directory.")
+      .def(
+          py::init<
+              const PassPtr &, std::size_t,
+              const std::optional<std::string> &>(),
+          "Construct from a compilation pass."
+          "\n\n:param compilation_pass: pass whose results to remember"
+          "\n:param capacity: maximum number of results held in memory"
+          "\n:param directory: existing directory in which to also store the "
+          "results, if any",
+          py::arg("compilation_pass"), py::arg("capacity") = 1024,
+          py::arg("directory") = std::nullopt)
+      .def("__str__", [](const CachedPass &) { return "<tket::BasePass>"; })
+      .def(
+          "apply_with_substitution",
+          [](const CachedPass &pass, Circuit &circ,
+             const symbol_map_t &symbol_map) {
+            CompilationUnit cu(circ);
+            bool applied = pass.apply_with_substitution(cu, symbol_map);
+            circ = cu.get_circ_ref();
+            return applied;
+          },
+          "Apply to a :py:class:`Circuit` with symbolic parameters in-place, "
+          "then substitute values for the symbols in the result. Over a "
+          "parameter sweep the template circuit is compiled once. The result "
+          "is equivalent to, but not necessarily the same as, compiling the "
+          "substituted circuit."
+          "\n\n:param circuit: circuit to compile"
+          "\n:param symbol_map: values to substitute for the symbols"
+          "\n:return: True if the pass modified the circuit, else False",
+          py::arg("circuit"), py::arg("symbol_map"))
+      .def(
+          "get_pass", &CachedPass::get_pass,
+          ":return: The underlying compilation pass.")
+      .def(
+          "hits", &CachedPass::hits,
+          ":return: The number of applications that reused a result.")
+      .def(
+          "misses", &CachedPass::misses,
+          ":return: The number of applications that compiled the circuit.")
+      .def(
+          "size", &CachedPass::size,
+          ":return: The number of results held in memory.")
+      .def(
+          "clear", &CachedPass::clear,
+          "Remove all results held in memory and reset the counters.");
+  py::class_<PassProfiler>(
+      m, "PassProfiler",
+      "Records the running time of each pass applied through it, including "
+      "every pass nested in a :py:class:`SequencePass`, "
+      ":py:class:`RepeatPass` and the like, with the gate count and depth of "
+      "the circuit before and after.")
+      .def(py::init<>(), "Construct an empty profiler.")
+      .def(
+          "apply",
+          [](PassProfiler &profiler, const PassPtr &pass, Circuit &circ) {
+            CompilationUnit cu(circ);
+            bool applied = profiler.apply(pass, cu);
+            circ = cu.get_circ_ref();
+            return applied;
+          },
+          "Apply a pass to a :py:class:`Circuit` in-place, recording each "
+          "nested pass."
+          "\n\n:param compilation_pass: pass to apply"
+          "\n:param circuit: circuit to compile"
+          "\n:return: True if the pass modified the circuit, else False",
+          py::arg("compilation_pass"), py::arg("circuit"))
+      .def(
+          "get_records",
+          [](const PassProfiler &profiler) {
+            py::list records;
+            for (const PassProfiler::Record &r : profiler.get_records()) {
+              py::dict record;
+              record["name"] = r.name;
+              record["parent"] = r.parent;
+              record["start_us"] = r.start_us;
+              record["duration_us"] = r.duration_us;
+              record["gates_before"] = r.gates_before;
+              record["gates_after"] = r.gates_after;
+              record["depth_before"] = r.depth_before;
+              record["depth_after"] = r.depth_after;
+              record["modified"] = r.modified;
+              records.append(record);
+            }
+            return records;
+          },
+          ":return: a dictionary for each application of a pass, in the "
+          "order they started, giving the name of the pass, the index of the "
+          "record of the enclosing pass (or None), the start time and "
+          "duration in microseconds, the gate count and depth before and "
+          "after, and whether the circuit was modified")
+      .def(
+          "to_trace_json",
+          [](const PassProfiler &profiler) {
+            return py::object(profiler.to_trace_json());
+          },
+          ":return: the records in the Trace Event Format, for viewing as a "
+          "flame graph in chrome://tracing, Perfetto or speedscope")
+      .def(
+          "to_folded_stacks", &PassProfiler::to_folded_stacks,
+          ":return: the records as folded stacks for flamegraph.pl, giving "
+          "the time in microseconds spent in each nesting of passes")
+      .def(
+          "clear", &PassProfiler::clear,
+          "Forget all records and restart the clock.");
+  py::class_<PassTuner>(
+      m, "PassTuner",
+      "Chooses between candidate passes by applying each of them, in "
+      "parallel, to its own copy of a circuit and keeping the result that "
+      "scores lowest under a metric. Ties go to the earliest candidate. The "
+      "winner for a named class of circuits can be recorded and reused.")
+      .def(
+          py::init<const std::vector<PassPtr> &, const PassTuner::Metric &>(),
+          "Construct from candidate passes and a metric."
+          "\n\n:param candidates: passes to choose between"
+          "\n:param metric: score of a compiled circuit, lower being better. "
+          "It may be called from several threads at once.",
+          py::arg("candidates"), py::arg("metric"))
+      .def(
+          "tune",
+          [](const PassTuner &tuner, Circuit &circ, unsigned n_threads) {
+            CompilationUnit cu(circ);
+            unsigned winner;
+            {
+              py::gil_scoped_release release;
+              winner = tuner.tune(cu, n_threads);
+            }
+            circ = cu.get_circ_ref();
+            return winner;
+          },
+          "Apply every candidate to a copy of a :py:class:`Circuit` and "
+          "replace it with the best result. Candidates that raise an error "
+          "are discarded; if all of them do, the first error is raised and "
+          "the circuit is unchanged."
+          "\n\n:param circuit: circuit to compile"
+          "\n:param n_threads: number of threads to use, or 0 (the default) "
+          "to use one per available CPU"
+          "\n:return: index of the winning candidate",
+          py::arg("circuit"), py::arg("n_threads") = 0)
+      .def(
+          "apply",
+          [](PassTuner &tuner, Circuit &circ, const std::string &circuit_class,
+             unsigned n_threads) {
+            CompilationUnit cu(circ);
+            unsigned applied;
+            {
+              py::gil_scoped_release release;
+              applied = tuner.apply(cu, circuit_class, n_threads);
+            }
+            circ = cu.get_circ_ref();
+            return applied;
+          },
+          "Apply the recorded winner for a class of circuits to a "
+          ":py:class:`Circuit`, or if there is none yet, tune on this circuit "
+          "and record the winner for the class."
+          "\n\n:param circuit: circuit to compile"
+          "\n:param circuit_class: name of the class of the circuit"
+          "\n:param n_threads: number of threads to use when tuning"
+          "\n:return: index of the candidate applied",
+          py::arg("circuit"), py::arg("circuit_class"),
+          py::arg("n_threads") = 0)
+      .def(
+          "get_winner", &PassTuner::get_winner,
+          ":return: index of the recorded winner for a class of circuits, if "
+          "any",
+          py::arg("circuit_class"))
+      .def(
+          "get_winners", &PassTuner::get_winners,
+          ":return: the recorded winners, by class of circuits")
+      .def(
+          "set_winner", &PassTuner::set_winner,
+          "Record the winner for a class of circuits, for example one saved "
+          "from an earlier run."
+          "\n\n:param circuit_class: name of the class of circuits"
+          "\n:param candidate: index of the winning candidate",
+          py::arg("circuit_class"), py::arg("candidate"))
+      .def_static(
+          "two_qubit_gate_count", &PassTuner::two_qubit_gate_count,
+          ":return: metric giving the number of two-qubit gates")
+      .def_static(
+          "depth", &PassTuner::depth, ":return: metric giving the depth")
+      .def_static(
+          "infidelity",
+          [](const avg_node_errors_t &node_errors,
+             const avg_link_errors_t &link_errors,
+             const avg_readout_errors_t &readout_errors) {
+            return PassTuner::infidelity(DeviceCharacterisation(
+                node_errors, link_errors, readout_errors));
+          },
+          "Metric estimating the probability of an error, as one minus the "
+          "product of the fidelities of the gates and measurements. Gates on "
+          "more than two qubits, and nodes or links without a given error, "
+          "contribute no error."
+          "\n\n:param node_errors: average error of single-qubit gates on "
+          "each node"
+          "\n:param link_errors: average error of two-qubit gates on each "
+          "ordered pair of nodes"
+          "\n:param readout_errors: readout error of each node"
+          "\n:return: the metric",
+          py::arg("node_errors") = avg_node_errors_t{},
+          py::arg("link_errors") = avg_link_errors_t{},
+          py::arg("readout_errors") = avg_readout_errors_t{});
   py::class_<RepeatPass, std::shared_ptr<RepeatPass>, BasePass>(
       m, "RepeatPass",
-      "Repeat a pass until its `apply()` method returns False, or if "
+      "Repeat a pass until its `apply()` method returns False or the "
+      "circuit stops changing, judged by its structural hash, or if "
       "`strict_check` is True until it stops modifying the circuit.")
       .def(
           py::init<const PassPtr &, bool>(),
@@ -757,6 +1034,23 @@ PYBIND11_MODULE(passes, m) {
       "\n:return: a pass to perform the remapping",
       py::arg("arc"), py::arg("delay_measures") = true);
 
+  m.def(
+      "FastCompilePass", &gen_fast_compile_pass,
+      "Construct a pass to compile quickly to an :py:class:`Architecture`, "
+      "for interactive use. Only passes whose running time is close to "
+      "linear in the size of the circuit are used: boxes are decomposed, "
+      "the circuit is rebased to CX and TK1 and squashed, routed by "
+      "LexiRoute looking one layer ahead, then rebased and squashed again. "
+      "Edge direction is ignored. The result is typically worse than that "
+      "of :py:meth:`DefaultMappingPass` followed by "
+      ":py:meth:`SynthesiseTket`."
+      "\n\n:param arc: The Architecture used for connectivity information."
+      "\n:param routing_timeout: Time budget for routing in milliseconds, "
+      "after which the rest of the circuit is routed without lookahead; 0 "
+      "for no budget."
+      "\n:return: a pass to compile to the architecture",
+      py::arg("arc"), py::arg("routing_timeout") = 5);
+
   m.def(
       "AASRouting", &gen_default_aas_routing_pass,
       "Construct a pass to relabel :py:class:`Circuit` Qubits to "
@@ -953,6 +1247,15 @@ PYBIND11_MODULE(passes, m) {
       "For every two CnX gates, reorder their control qubits to improve "
       "the chance of gate cancellation");
 
+  m.def(
+      "CnXAncillaDecomposition", &CnXAncillaDecomposition,
+      "Decompose CnX gates with at least 3 controls to 2-qubit gates and "
+      "single qubit gates, using qubits that are idle at the point of each "
+      "gate as ancillae. Qubits known to be in the zero state give a "
+      "logarithmic-depth decomposition; otherwise, for at least 4 controls, "
+      "idle qubits in any state give a linear-depth decomposition. Gates "
+      "with too few idle qubits are left unchanged.");
+
   m.def(
       "RoundAngles", &RoundAngles,
       "Round angles to the nearest :math:`\\pi / 2^n`. "
@@ -63,6 +63,7 @@ PYBIND11_MODULE(placement, m) {
                  [](const Placement &) { return "<tket::Placement>"; })
             .def("place",
               [](const Placement &placement, Circuit &circ) {
+                py::gil_scoped_release release;
                 return placement.place(circ);
               },
               "Relabels Circuit Qubits to Architecture Nodes and 'unplaced'. For "
@@ -78,14 +79,23 @@ PYBIND11_MODULE(placement, m) {
               "\n\n:param circuit: The circuit being relabelled\n:param "
               "qmap: The map from logical to physical qubits to apply.",
               py::arg("circuit"), py::arg("qmap"))
-            .def("get_placement_map", &Placement::get_placement_map,
+            .def("get_placement_map",
+                 [](const Placement &placement, const Circuit &circ) {
+                   py::gil_scoped_release release;
+                   return placement.get_placement_map(circ);
+                 },
                  "Returns a map from logical to physical qubits that is Architecture "
                  "appropriate for the given Circuit. "
                  "\n\n:param circuit: The circuit a map is designed for."
                  "\n:return: dictionary mapping " CLSOBJS(Qubit) " to "
                  CLSOBJS(Node),
                  py::arg("circuit"))
-            .def("get_placement_maps", &Placement::get_all_placement_maps,
+            .def("get_placement_maps",
+                 [](const Placement &placement, const Circuit &circ,
+                    unsigned matches) {
+                   py::gil_scoped_release release;
+                   return placement.get_all_placement_maps(circ, matches);
+                 },
                  "Returns a list of maps from logical to physical qubits that "
                  "are Architecture appropriate for the given Circuit. Each map is "
                  "estimated to given a similar SWAP overheard after routing. "
@@ -14,6 +14,11 @@
 
 #include "tket/Predicates/Predicates.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "binder_json.hpp"
 #include "tket/Predicates/CompilationUnit.hpp"
 #include "tket/Utils/UnitID.hpp"
@@ -265,6 +270,41 @@ PYBIND11_MODULE(predicates, m) {
       .def(
           "check_all_predicates", &CompilationUnit::check_all_predicates,
           ":return: True if all predicates are satisfied, else False")
+      .def(
+          "set_timeout",
+          [](CompilationUnit &cu, double seconds) {
+            cu.set_cancellation_token(
+                CancellationToken(std::chrono::duration_cast<
+                                  std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(seconds))));
+          },
+          "Limit the time for which passes may be applied to this unit. Once "
+          "the time has passed, a pass raises a RuntimeError at the next "
+          "point where the circuit is valid, leaving the best circuit found "
+          "so far in the unit. This circuit is equivalent to the original "
+          "but need not satisfy the postconditions of the pass."
+          "\n\n:param seconds: time limit, counted from now",
+          py::arg("seconds"))
+      .def(
+          "to_bytes",
+          [](const CompilationUnit &cu) {
+            std::vector<std::uint8_t> bytes = cu.to_bytes();
+            return py::bytes(
+                reinterpret_cast<const char *>(bytes.data()), bytes.size());
+          },
+          ":return: a compact binary encoding of the unit, holding the "
+          "circuit, its initial and final maps, the target predicates and "
+          "the predicates known to be satisfied, so that compilation can be "
+          "resumed elsewhere")
+      .def_static(
+          "from_bytes",
+          [](const py::bytes &data) {
+            std::string s = data;
+            return CompilationUnit::from_bytes(
+                std::vector<std::uint8_t>(s.begin(), s.end()));
+          },
+          "Construct a unit from the result of :py:meth:`to_bytes`.",
+          py::arg("data"))
       .def_property_readonly(
           "circuit",
           [](const CompilationUnit &cu) { return Circuit(cu.get_circ_ref()); },
@@ -92,7 +92,9 @@ PYBIND11_MODULE(tailoring, m) {
           ":return: list of " CLSOBJS(Circuit),
           py::arg("circuit"))
       .def(
-          "sample_circuits", &FrameRandomisation::sample_randomisation_circuits,
+          "sample_circuits",
+          py::overload_cast<const Circuit &, unsigned>(
+              &FrameRandomisation::sample_randomisation_circuits),
           "Returns a number of instances equal to sample of frame "
           "randomisation for the given circuit. Samples individual "
           "frame gates uniformly.\n\n:param "
@@ -101,6 +103,26 @@ PYBIND11_MODULE(tailoring, m) {
           "randomised circuits to return.\n"
           ":return: list of " CLSOBJS(Circuit),
           py::arg("circuit"), py::arg("samples"))
+      .def(
+          "sample_circuits",
+          [](FrameRandomisation &fr, const Circuit &circuit, unsigned samples,
+             std::size_t seed, unsigned n_threads) {
+            return fr.sample_randomisation_circuits(
+                circuit, samples, seed, n_threads);
+          },
+          "Returns a number of instances equal to sample of frame "
+          "randomisation for the given circuit, reproducibly for a given "
+          "seed. Samples individual frame gates uniformly, each sample "
+          "from its own random stream, so that the result does not depend "
+          "on the number of threads.\n\n:param "
+          "circuit: The circuit to perform frame randomisation with "
+          "Pauli gates on\n:param samples: the number of frame "
+          "randomised circuits to return.\n:param seed: the random seed"
+          "\n:param n_threads: the number of threads to use, or 0 for one "
+          "per hardware thread\n"
+          ":return: list of " CLSOBJS(Circuit),
+          py::arg("circuit"), py::arg("samples"), py::arg("seed"),
+          py::arg("n_threads") = 0)
       .def("__repr__", &FrameRandomisation::to_string);
 
   py::class_<PauliFrameRandomisation>(
@@ -125,7 +147,8 @@ PYBIND11_MODULE(tailoring, m) {
           py::arg("circuit"))
       .def(
           "sample_circuits",
-          &PauliFrameRandomisation::sample_randomisation_circuits,
+          py::overload_cast<const Circuit &, unsigned>(
+              &PauliFrameRandomisation::sample_randomisation_circuits),
           "Returns a number of instances equal to sample of frame "
           "randomisation for the given circuit. Samples individual "
           "frame gates uniformly from the Pauli gates.\n\n:param "
@@ -134,6 +157,26 @@ PYBIND11_MODULE(tailoring, m) {
           "randomised circuits to return.\n"
           ":return: list of " CLSOBJS(Circuit),
           py::arg("circuit"), py::arg("samples"))
+      .def(
+          "sample_circuits",
+          [](PauliFrameRandomisation &fr, const Circuit &circuit,
+             unsigned samples, std::size_t seed, unsigned n_threads) {
+            return fr.sample_randomisation_circuits(
+                circuit, samples, seed, n_threads);
+          },
+          "Returns a number of instances equal to sample of frame "
+          "randomisation for the given circuit, reproducibly for a given "
+          "seed. Samples individual frame gates uniformly from the Pauli "
+          "gates, each sample from its own random stream, so that the "
+          "result does not depend on the number of threads.\n\n:param "
+          "circuit: The circuit to perform frame randomisation with "
+          "Pauli gates on\n:param samples: the number of frame "
+          "randomised circuits to return.\n:param seed: the random seed"
+          "\n:param n_threads: the number of threads to use, or 0 for one "
+          "per hardware thread\n"
+          ":return: list of " CLSOBJS(Circuit),
+          py::arg("circuit"), py::arg("samples"), py::arg("seed"),
+          py::arg("n_threads") = 0)
       .def("__repr__", &PauliFrameRandomisation::to_string);
 
   py::class_<UniversalFrameRandomisation>(
@@ -161,7 +204,8 @@ PYBIND11_MODULE(tailoring, m) {
           py::arg("circuit"))
       .def(
           "sample_circuits",
-          &UniversalFrameRandomisation::sample_randomisation_circuits,
+          py::overload_cast<const Circuit &, unsigned>(
+              &UniversalFrameRandomisation::sample_randomisation_circuits),
           "Returns a number of instances equal to sample of frame "
           "randomisation for the given circuit. Samples individual "
           "frame gates uniformly from the Pauli gates.\n\n:param "
@@ -170,6 +214,26 @@ PYBIND11_MODULE(tailoring, m) {
           "randomised circuits to return.\n"
           ":return: list of " CLSOBJS(Circuit),
           py::arg("circuit"), py::arg("samples"))
+      .def(
+          "sample_circuits",
+          [](UniversalFrameRandomisation &fr, const Circuit &circuit,
+             unsigned samples, std::size_t seed, unsigned n_threads) {
+            return fr.sample_randomisation_circuits(
+                circuit, samples, seed, n_threads);
+          },
+          "Returns a number of instances equal to sample of frame "
+          "randomisation for the given circuit, reproducibly for a given "
+          "seed. Samples individual frame gates uniformly from the Pauli "
+          "gates, each sample from its own random stream, so that the "
+          "result does not depend on the number of threads.\n\n:param "
+          "circuit: The circuit to perform frame randomisation with "
+          "Pauli gates on\n:param samples: the number of frame "
+          "randomised circuits to return.\n:param seed: the random seed"
+          "\n:param n_threads: the number of threads to use, or 0 for one "
+          "per hardware thread\n"
+          ":return: list of " CLSOBJS(Circuit),
+          py::arg("circuit"), py::arg("samples"), py::arg("seed"),
+          py::arg("n_threads") = 0)
       .def("__repr__", &UniversalFrameRandomisation::to_string);
   m.def(
       "apply_clifford_basis_change", &apply_clifford_basis_change_string,
@@ -68,14 +68,22 @@ PYBIND11_MODULE(transform, m) {
           "from Cowtan et al (https://arxiv.org/abs/1906.01734)")
       .value(
           "Sets", Transforms::PauliSynthStrat::Sets,
-          "Synthesise gadgets in commuting sets");
+          "Synthesise gadgets in commuting sets")
+      .value(
+          "Lookahead", Transforms::PauliSynthStrat::Lookahead,
+          "Synthesise gadgets one at a time, keeping the Clifford reductions "
+          "as a frame and choosing each gadget by its CX cost with a bounded "
+          "lookahead");
 
   py::class_<Transform>(
       m, "Transform", "An in-place transformation of a :py:class:`Circuit`.")
       .def(py::init<const Transform::SimpleTransformation &>())
       .def(
           "apply",
-          [](const Transform &tr, Circuit &circ) { return tr.apply(circ); },
+          [](const Transform &tr, Circuit &circ) {
+            py::gil_scoped_release release;
+            return tr.apply(circ);
+          },
           "Performs the transformation on the circuit in "
           "place.\n\n:param circuit: The circuit to be "
           "transformed\n"
@@ -98,6 +106,16 @@ PYBIND11_MODULE(transform, m) {
           "\n\n:param sequence: The list of Transforms to be "
           "composed\n:return: the combined Transform",
           py::arg("sequence"))
+      .def_static(
+          "conjugation_actions", &Transforms::conjugation_actions,
+          "Applies a given Transform to the action of every "
+          ":py:class:`~.ConjugationBox` in a circuit, including those "
+          "nested within actions, without expanding the compute and "
+          "uncompute parts. Each transformed action is replaced by a "
+          ":py:class:`~.CircBox`."
+          "\n\n:param transform: The Transform to be applied to the "
+          "actions\n:return: a new Transform acting on the actions",
+          py::arg("transform"))
       .def_static(
           "repeat", &Transforms::repeat,
           "Applies a given Transform repeatedly to a circuit until "
@@ -342,8 +360,14 @@ PYBIND11_MODULE(transform, m) {
           "ThreeQubitSquash", &Transforms::three_qubit_squash,
           "Squash three-qubit subcircuits into subcircuits having fewer "
           "2-qubit gates of the target type, when possible. The supported "
-          "target types are CX (default) and TK2.",
-          py::arg("target_2qb_gate") = OpType::CX)
+          "target types are CX (default) and TK2."
+          "\n\n:param target_2qb_gate: target 2-qubit gate"
+          "\n:param max_candidates: maximum number of candidate subcircuits "
+          "to resynthesise, or 0 for no limit"
+          "\n:param timeout: time (ms) after which no further candidates are "
+          "resynthesised, or 0 for no limit",
+          py::arg("target_2qb_gate") = OpType::CX,
+          py::arg("max_candidates") = 0, py::arg("timeout") = 0)
       .def_static(
           "CommuteSQThroughSWAP",
           [](const avg_node_errors_t &avg_node_errors) {
@@ -414,6 +438,14 @@ PYBIND11_MODULE(transform, m) {
           "Decompose CnX gates to 2-qubit gates and single qubit gates. "
           "For every two CnX gates, reorder their control qubits to improve "
           "the chance of gate cancellation.")
+      .def_static(
+          "CnXAncillaDecomposition", &Transforms::cnx_ancilla_decomposition,
+          "Decompose CnX gates with at least 3 controls to 2-qubit gates and "
+          "single qubit gates, using qubits that are idle at the point of "
+          "each gate as ancillae. Qubits known to be in the zero state give "
+          "a logarithmic-depth decomposition; otherwise, for at least 4 "
+          "controls, idle qubits in any state give a linear-depth "
+          "decomposition. Gates with too few idle qubits are left unchanged.")
       .def_static(
           "round_angles", &Transforms::round_angles,
           "Rounds angles to the nearest :math:`\\pi / 2^n`."
@@ -752,6 +752,15 @@ PYBIND11_MODULE(zx, m) {
       "circuit_to_zx", &wrapped_circuit_to_zx,
       "Construct a ZX diagram from a circuit. Return the ZX diagram and a map "
       "Between the ZX boundary vertices and the resource UIDs of the circuit.");
+  m.def(
+      "circuit_to_graphlike_zx",
+      [](const Circuit& circ) { return circuit_to_graphlike_zx(circ); },
+      "Construct a ZX diagram in graphlike form directly from a unitary "
+      "circuit, without building a subdiagram per gate. Supports H, X, Z, S, "
+      "Sdg, T, Tdg, Rx, Rz, U1, CX, CZ, SWAP, noop and Barrier. The boundary "
+      "consists of the inputs followed by the outputs, in the order of the "
+      "circuit's qubits.",
+      py::arg("circ"));
 }
 
 }  // namespace zx
@@ -22,6 +22,41 @@ namespace tket {
 namespace zx {
 
 void init_rewrite(py::module &m) {
+  py::class_<RewriteRecord>(
+      m, "RewriteRecord",
+      "Accumulated statistics for a single named :py:class:`Rewrite`. Sizes "
+      "are summed over all applications.")
+      .def_readonly(
+          "n_applications", &RewriteRecord::n_applications,
+          "Number of times the rewrite was applied.")
+      .def_readonly(
+          "n_successes", &RewriteRecord::n_successes,
+          "Number of applications which changed the diagram.")
+      .def_readonly(
+          "seconds", &RewriteRecord::seconds,
+          "Total time spent applying the rewrite, in seconds.")
+      .def_readonly(
+          "vertices_before", &RewriteRecord::vertices_before,
+          "Total number of vertices before each application.")
+      .def_readonly(
+          "vertices_after", &RewriteRecord::vertices_after,
+          "Total number of vertices after each application.")
+      .def_readonly(
+          "wires_before", &RewriteRecord::wires_before,
+          "Total number of wires before each application.")
+      .def_readonly(
+          "wires_after", &RewriteRecord::wires_after,
+          "Total number of wires after each application.");
+  py::class_<RewriteStatistics, std::shared_ptr<RewriteStatistics>>(
+      m, "RewriteStatistics",
+      "Collects a :py:class:`RewriteRecord` for each name used with "
+      ":py:meth:`Rewrite.with_statistics`.")
+      .def(py::init<>(), "Constructs an empty collector.")
+      .def(
+          "get_records", &RewriteStatistics::get_records,
+          ":return: a map from rewrite name to its accumulated record")
+      .def("clear", &RewriteStatistics::clear, "Removes all records.");
+
   py::class_<Rewrite> rewrite_cls(
       m, "Rewrite", "An in-place transformation of a ZXDiagram.");
   rewrite_cls
@@ -52,6 +87,26 @@ void init_rewrite(py::module &m) {
           "repeatedly.\n:return: A new :py:class:`Rewrite` representing the "
           "iteration.",
           py::arg("rewrite"))
+      .def_static(
+          "parallel_components", &Rewrite::parallel_components,
+          "Applies a given :py:class:`Rewrite` separately to each connected "
+          "component of a diagram, running the components in parallel, and "
+          "merges the results back together with the same boundary order. "
+          "Only suitable for rewrites which act locally within a connected "
+          "component.\n\n:param rewrite: The :py:class:`Rewrite` to be "
+          "applied to each component.\n:return: A new :py:class:`Rewrite` "
+          "acting on the components in parallel.",
+          py::arg("rewrite"))
+      .def_static(
+          "with_statistics", &Rewrite::with_statistics,
+          "Wraps a :py:class:`Rewrite` so that each application is recorded "
+          "under the given name: whether it changed the diagram, the time "
+          "taken and the numbers of vertices and wires before and after.\n\n"
+          ":param rewrite: The :py:class:`Rewrite` to be instrumented.\n"
+          ":param name: The name to record applications under.\n"
+          ":param stats: The collector to record into.\n"
+          ":return: A new :py:class:`Rewrite` which behaves as `rewrite`.",
+          py::arg("rewrite"), py::arg("name"), py::arg("stats"))
       .def_static(
           "decompose_boxes", &Rewrite::decompose_boxes,
           "Replaces every :py:class:`ZXBox` by its internal diagram "
@@ -144,6 +199,13 @@ void init_rewrite(py::module &m) {
           "and pivoting to remove as many interior Clifford-angled vertices as "
           "possible. The only remaining Clifford-angled vertices will be "
           "either the axis of a phase-gadget or near a boundary.")
+      .def_static(
+          "reduce_graphlike_form_compact",
+          &Rewrite::reduce_graphlike_form_compact,
+          "As :py:meth:`reduce_graphlike_form`, but performed on a compact "
+          "copy of the diagram, which is much faster for large diagrams. Only "
+          "applies to quantum diagrams in graphlike form without parallel "
+          "wires or self-loops.")
       .def_static(
           "to_MBQC_diag", &Rewrite::to_MBQC_diag,
           "Given a diagram in graphlike form, will rebase to MBQC generators, "
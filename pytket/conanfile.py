@@ -32,12 +32,12 @@ class pytketRecipe(ConanFile):
         cmake.install()
 
     def requirements(self):
-        self.requires("tket/1.2.71@tket/stable")
-        self.requires("tklog/0.3.3@tket/stable")
-        self.requires("tkrng/0.3.3@tket/stable")
-        self.requires("tkassert/0.3.4@tket/stable")
-        self.requires("tkwsm/0.3.6@tket/stable")
-        self.requires("tktokenswap/0.3.6@tket/stable")
+        self.requires("tket/1.2.221@tket/stable")
+        self.requires("tklog/0.3.4@tket/stable")
+        self.requires("tkrng/0.3.4@tket/stable")
+        self.requires("tkassert/0.3.5@tket/stable")
+        self.requires("tkwsm/0.3.15@tket/stable")
+        self.requires("tktokenswap/0.3.11@tket/stable")
         self.requires("symengine/0.11.1")
         self.requires("gmp/6.2.1")
         self.requires("pybind11/2.11.1")
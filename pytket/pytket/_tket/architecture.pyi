@@ -48,10 +48,11 @@ class Architecture:
         """
         given two nodes in Architecture, returns distance between them
         """
-    def to_dict(self) -> dict:
+    def to_dict(self, precomputed: bool = False) -> dict:
         """
         Return a JSON serializable dict representation of the Architecture.
         
+        :param precomputed: whether to include the distances between nodes, the diameter and the articulation points, so that the architecture loads without computing them
         :return: dict containing nodes and links.
         """
     def valid_operation(self, uids: typing.Sequence[pytket._tket.unit_id.Node]) -> bool:
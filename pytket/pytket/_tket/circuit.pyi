@@ -9,7 +9,7 @@ import pytket.circuit.logic_exp
 import pytket.wasm.wasm
 import sympy
 import typing
-__all__ = ['BarrierOp', 'BasisOrder', 'CXConfigType', 'CircBox', 'Circuit', 'ClassicalEvalOp', 'ClassicalExpBox', 'ClassicalOp', 'Command', 'Conditional', 'ConjugationBox', 'CopyBitsOp', 'CustomGate', 'CustomGateDef', 'DiagonalBox', 'DummyBox', 'EdgeType', 'ExpBox', 'MetaOp', 'MultiBitOp', 'MultiplexedRotationBox', 'MultiplexedTensoredU2Box', 'MultiplexedU2Box', 'MultiplexorBox', 'Op', 'OpType', 'PauliExpBox', 'PauliExpCommutingSetBox', 'PauliExpPairBox', 'PhasePolyBox', 'ProjectorAssertionBox', 'QControlBox', 'RangePredicateOp', 'ResourceBounds', 'ResourceData', 'SetBitsOp', 'StabiliserAssertionBox', 'StatePreparationBox', 'ToffoliBox', 'ToffoliBoxSynthStrat', 'Unitary1qBox', 'Unitary2qBox', 'Unitary3qBox', 'WASMOp', 'fresh_symbol']
+__all__ = ['BarrierOp', 'BasisOrder', 'CXConfigType', 'CircBox', 'Circuit', 'CircuitArchive', 'ClassicalEvalOp', 'ClassicalExpBox', 'ClassicalOp', 'Command', 'Conditional', 'ConjugationBox', 'CopyBitsOp', 'CustomGate', 'CustomGateDef', 'DiagonalBox', 'DiagonalBoxSynthStrat', 'DummyBox', 'EdgeType', 'ExpBox', 'MetaOp', 'MultiBitOp', 'MultiplexedRotationBox', 'MultiplexedTensoredU2Box', 'MultiplexedU2Box', 'MultiplexorBox', 'Op', 'OpType', 'PauliExpBox', 'PauliExpCommutingSetBox', 'PauliExpPairBox', 'PhasePolyBox', 'ProjectorAssertionBox', 'QControlBox', 'RangePredicateOp', 'ResourceBounds', 'ResourceData', 'SetBitsOp', 'StabiliserAssertionBox', 'StatePreparationBox', 'ToffoliBox', 'ToffoliBoxSynthStrat', 'Unitary1qBox', 'Unitary2qBox', 'Unitary3qBox', 'WASMOp', 'fresh_symbol']
 class BarrierOp(Op):
     """
     Barrier operations.
@@ -144,10 +144,20 @@ class Circuit:
     >>> c.Measure(1,0) # Measure qubit 1, saving result in bit 0
     """
     @staticmethod
+    def from_binary(data: bytes) -> Circuit:
+        """
+        Construct Circuit instance from the result of :py:meth:`to_binary`.
+        """
+    @staticmethod
     def from_dict(arg0: dict) -> Circuit:
         """
         Construct Circuit instance from JSON serializable dictionary representation of the Circuit.
         """
+    @staticmethod
+    def from_json_file(path: str) -> Circuit:
+        """
+        Construct Circuit instance from a file holding its JSON serialisation, as written by ``json.dump(c.to_dict(), f)``. The file is read incrementally, so that the whole JSON document is never held in memory.
+        """
     @typing.overload
     def CCX(self, control_0: int, control_1: int, target: int, **kwargs: Any) -> Circuit:
         """
@@ -1547,6 +1557,17 @@ class Circuit:
         :param kwargs: Additional properties for classical conditions
         :return: the new :py:class:`Circuit`
         """
+    def add_gates(self, types: NDArray[numpy.int32], qubits: NDArray[numpy.uint32], params: NDArray[numpy.float64] | None = None) -> Circuit:
+        """
+        Appends a sequence of gates given as NumPy arrays, with one entry or row per gate, acting on qubits of the default register ('q'). This is much faster than adding the gates one at a time.
+        
+        >>> c.add_gates(np.array([int(OpType.H), int(OpType.CX)]), np.array([[0, 0], [0, 1]]))
+        
+        :param types: The type codes of the gates, as given by ``int(OpType.X)``. Each must be a gate acting on a fixed number of qubits and nothing else.
+        :param qubits: A matrix whose row `i` begins with the indices of the qubits of gate `i`; any further entries are ignored
+        :param params: A matrix whose row `i` begins with the parameters of gate `i` in halfturns, if any gate has parameters
+        :return: the new :py:class:`Circuit`
+        """
     @typing.overload
     def add_multiplexed_tensored_u2(self, box: MultiplexedTensoredU2Box, args: typing.Sequence[pytket._tket.unit_id.UnitID], **kwargs: Any) -> Circuit:
         """
@@ -1986,6 +2007,21 @@ class Circuit:
         :param name: name for the register
         :return: the retrieved :py:class:`BitRegister`
         """
+    def get_command_columns(self) -> dict[str, typing.Any]:
+        """
+        The commands of the circuit as NumPy arrays, for fast bulk processing. Commands are in a topological order, which need not be that of :py:meth:`get_commands`. Apart from the op types, the arrays take over the buffers built in C++ without copying.
+        
+        The dictionary has the following entries:
+        
+        - ``units``: the qubits, then bits, of the circuit
+        - ``op_types``: the type code of each command, as given by ``int(OpType.X)``
+        - ``args``, ``arg_offsets``: the arguments of command `i` are ``args[arg_offsets[i]:arg_offsets[i + 1]]``, as indices into ``units``
+        - ``params``, ``param_offsets``: likewise the parameters of each gate in halfturns, NaN if symbolic
+        - ``opgroups``: the distinct opgroup names
+        - ``opgroup_ids``: the index into ``opgroups`` of the opgroup of each command, or -1
+        
+        :return: a dictionary of arrays describing the commands
+        """
     def get_commands(self) -> list[Command]:
         """
         :return: a list of all the Commands in the circuit
@@ -2293,8 +2329,15 @@ class Circuit:
         
         :param symbol_map: A map from SymPy symbols to floating-point values
         """
-    def to_dict(self) -> dict:
+    def to_binary(self) -> bytes:
+        """
+        :return: a compact binary serialisation of the Circuit, holding the same information as :py:meth:`to_dict`
+        """
+    def to_dict(self, box_table: bool = False) -> dict:
         """
+        Convert the Circuit to a JSON serializable dictionary. With `box_table`, each distinct box is written once in a "boxes" table and referenced by id from the commands; :py:meth:`from_dict` then shares one operation between all references to a box.
+        
+        :param box_table: whether to write boxes to a table
         :return: a JSON serializable dictionary representation of the Circuit
         """
     def to_latex_file(self, filename: str) -> None:
@@ -2413,6 +2456,36 @@ class Circuit:
         """
         A list of all qubit ids in the circuit
         """
+class CircuitArchive:
+    """
+    A file holding many named circuits, each read only when asked for. Opening an archive maps the file into memory without reading the circuits, so it takes the same time however many it holds.
+    """
+    @staticmethod
+    def write(path: str, circuits: dict[str, Circuit]) -> None:
+        """
+        Write an archive, storing each circuit in the binary serialisation of :py:meth:`Circuit.to_binary`.
+        
+        :param path: file to write
+        :param circuits: circuits by name
+        """
+    def __contains__(self, name: str) -> bool:
+        ...
+    def __getitem__(self, name: str) -> Circuit:
+        """
+        Read the circuit with the given name.
+        """
+    def __init__(self, path: str) -> None:
+        """
+        Open an archive written by :py:meth:`write`.
+        
+        :param path: file holding the archive
+        """
+    def __len__(self) -> int:
+        ...
+    def names(self) -> list[str]:
+        """
+        :return: the names of the circuits, in sorted order
+        """
 class ClassicalEvalOp(ClassicalOp):
     """
     Evaluatable classical operation.
@@ -2637,14 +2710,15 @@ class CustomGateDef:
         """
 class DiagonalBox(Op):
     """
-    A box for synthesising a diagonal unitary matrix into a sequence of multiplexed-Rz gates.
+    A box for synthesising a diagonal unitary matrix into a sequence of multiplexed-Rz gates, or into a phase polynomial.
     """
-    def __init__(self, diagonal: NDArray[numpy.complex128], upper_triangle: bool = True) -> None:
+    def __init__(self, diagonal: NDArray[numpy.complex128], upper_triangle: bool = True, strat: DiagonalBoxSynthStrat = DiagonalBoxSynthStrat.Multiplexor) -> None:
         """
         Construct from the diagonal entries of the unitary operator. The size of the vector must be 2^n where n is a positive integer.
         
         :param diagonal: diagonal entries
-        :param upper_triangle: indicates whether the multiplexed-Rz gates take the shape of an upper triangle or a lower triangle. Default to true.
+        :param upper_triangle: indicates whether the multiplexed-Rz gates take the shape of an upper triangle or a lower triangle. Default to true. Only applicable to the :py:attr:`DiagonalBoxSynthStrat.Multiplexor` strategy.
+        :param strat: synthesis strategy. Default to :py:attr:`DiagonalBoxSynthStrat.Multiplexor`.
         """
     def get_circuit(self) -> Circuit:
         """
@@ -2654,10 +2728,53 @@ class DiagonalBox(Op):
         """
         :return: the statevector
         """
+    def get_strat(self) -> DiagonalBoxSynthStrat:
+        """
+        :return: the synthesis strategy
+        """
     def is_upper_triangle(self) -> bool:
         """
         :return: the upper_triangle flag
         """
+class DiagonalBoxSynthStrat:
+    """
+    Enum strategies for synthesising DiagonalBoxes
+    
+    Members:
+    
+      Multiplexor : Use a sequence of multiplexed-Rz gates
+    
+      PhasePolynomial : Expand the phases in the Walsh basis and synthesise the resulting phase polynomial with CX and Rz gates using GraySynth
+    """
+    Multiplexor: typing.ClassVar[DiagonalBoxSynthStrat]  # value = <DiagonalBoxSynthStrat.Multiplexor: 0>
+    PhasePolynomial: typing.ClassVar[DiagonalBoxSynthStrat]  # value = <DiagonalBoxSynthStrat.PhasePolynomial: 1>
+    __members__: typing.ClassVar[dict[str, DiagonalBoxSynthStrat]]  # value = {'Multiplexor': <DiagonalBoxSynthStrat.Multiplexor: 0>, 'PhasePolynomial': <DiagonalBoxSynthStrat.PhasePolynomial: 1>}
+    def __eq__(self, other: typing.Any) -> bool:
+        ...
+    def __getstate__(self) -> int:
+        ...
+    def __hash__(self) -> int:
+        ...
+    def __index__(self) -> int:
+        ...
+    def __init__(self, value: int) -> None:
+        ...
+    def __int__(self) -> int:
+        ...
+    def __ne__(self, other: typing.Any) -> bool:
+        ...
+    def __repr__(self) -> str:
+        ...
+    def __setstate__(self, state: int) -> None:
+        ...
+    def __str__(self) -> str:
+        ...
+    @property
+    def name(self) -> str:
+        ...
+    @property
+    def value(self) -> int:
+        ...
 class DummyBox(Op):
     """
     A placeholder operation that holds resource data. This box type cannot be decomposed into a circuit. It only serves to record resource data for a region of a circuit: for example, upper and lower bounds on gate counts and depth. A circuit containing such a box cannot be executed.
@@ -3174,7 +3291,7 @@ class OpType:
     
       MultiplexedTensoredU2Box : A multiplexed tensored-U2 gate
     
-      StatePreparationBox : A box for preparing quantum states using multiplexed-Ry and multiplexed-Rz gates
+      StatePreparationBox : A box for preparing quantum states using multiplexed-Ry and multiplexed-Rz gates, or for states with few non-zero amplitudes, controlled rotations
     
       DiagonalBox : A box for synthesising a diagonal unitary matrix into a sequence of multiplexed-Rz gates
     """
@@ -3610,7 +3727,7 @@ class StabiliserAssertionBox(Op):
         """
 class StatePreparationBox(Op):
     """
-    A box for preparing quantum states using multiplexed-Ry and multiplexed-Rz gates
+    A box for preparing quantum states using multiplexed-Ry and multiplexed-Rz gates, or for states with few non-zero amplitudes, controlled rotations
     """
     def __init__(self, statevector: NDArray[numpy.complex128], is_inverse: bool = False, with_initial_reset: bool = False) -> None:
         """
@@ -3636,6 +3753,37 @@ class StatePreparationBox(Op):
         """
         :return: flag indicating whether the qubits are explicitly set to the zero state initially
         """
+class SymbolBindingPlan:
+    """
+    A symbolic circuit prepared for repeated substitution of numbers for its symbols. Each parameter that depends on the symbols is compiled once to a numeric function, so that binding a set of values costs little more than copying the circuit.
+    """
+    def __init__(self, circuit: Circuit, symbols: list[sympy.Symbol]) -> None:
+        """
+        Prepare a circuit for binding.
+        
+        :param circuit: symbolic circuit
+        :param symbols: symbols in the order of the values to be bound, including every free symbol of the circuit
+        """
+    def bind(self, values: list[float]) -> Circuit:
+        """
+        Substitute values for the symbols.
+        
+        :param values: one value for each symbol, in the order of :py:attr:`symbols`
+        :return: a new circuit with the values substituted
+        """
+    def bind_all(self, values: list[list[float]], n_threads: int = 0) -> list[Circuit]:
+        """
+        Substitute several sets of values for the symbols, in parallel.
+        
+        :param values: sets of values, each as for :py:meth:`bind`
+        :param n_threads: number of threads to use, or 0 to use one for each hardware thread
+        :return: one new circuit for each set of values
+        """
+    @property
+    def symbols(self) -> list[sympy.Symbol]:
+        """
+        Symbols in the order of the values to be bound.
+        """
 class ToffoliBox(Op):
     """
     An operation that constructs a circuit to implement the specified permutation of classical basis states.
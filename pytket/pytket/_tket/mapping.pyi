@@ -69,12 +69,13 @@ class MultiGateReorderRoutingMethod(RoutingMethod):
     """
     Defines a RoutingMethod object for commuting physically permitted multi-qubit gates to the front of the subcircuit.
     """
-    def __init__(self, max_depth: int = 10, max_size: int = 10) -> None:
+    def __init__(self, max_depth: int = 10, max_size: int = 10, scheduled: bool = False) -> None:
         """
         MultiGateReorderRoutingMethod constructor.
         
         :param max_depth: Maximum number of layers of gates checked for simultaneous commutation. 
         :param max_size: Maximum number of gates checked for simultaneous commutation.
+        :param scheduled: If True, examine the gates beyond the frontier from a ready-list ordered by the distance between their qubits, so that max_size gates can be examined at roughly linear cost; max_depth is then not used.
         """
 class RoutingMethod:
     """
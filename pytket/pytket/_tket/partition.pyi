@@ -2,7 +2,7 @@ from __future__ import annotations
 import pytket._tket.circuit
 import pytket._tket.pauli
 import typing
-__all__ = ['GraphColourMethod', 'MeasurementBitMap', 'MeasurementSetup', 'PauliPartitionStrat', 'measurement_reduction', 'term_sequence']
+__all__ = ['GraphColourMethod', 'MeasurementBitMap', 'MeasurementSetup', 'PauliPartitionStream', 'PauliPartitionStrat', 'measurement_reduction', 'term_sequence']
 class GraphColourMethod:
     """
     Enum for available methods to perform graph colouring.
@@ -130,6 +130,39 @@ class MeasurementSetup:
         """
         Map from Pauli strings to MeasurementBitMaps
         """
+class PauliPartitionStream:
+    """
+    Partitions Pauli strings which are added in chunks, so that large operators need not be held as a single list. Repeated strings are dropped, and each new string joins the first compatible set, as for `GraphColourMethod.Lazy`.
+    """
+    def __init__(self, strat: PauliPartitionStrat) -> None:
+        """
+        Constructs an empty partition.
+        
+        :param strat: The `PauliPartitionStrat` to use.
+        """
+    def add_strings(self, strings: typing.Sequence[pytket._tket.pauli.QubitPauliString]) -> int:
+        """
+        Add a chunk of strings to the partition.
+        
+        :param strings: A list of `QubitPauliString` objects.
+        :return: the number of strings not seen before
+        """
+    def get_sets(self) -> list[list[pytket._tket.pauli.QubitPauliString]]:
+        """
+        The sets so far, in order of creation.
+        
+        :return: a list of lists of :py:class:`QubitPauliString` s
+        """
+    @property
+    def n_sets(self) -> int:
+        """
+        Number of sets in the partition so far.
+        """
+    @property
+    def n_strings(self) -> int:
+        """
+        Number of distinct strings added so far.
+        """
 class PauliPartitionStrat:
     """
     Enum for available strategies to partition Pauli tensors.
@@ -169,6 +202,7 @@ class PauliPartitionStrat:
     @property
     def value(self) -> int:
         ...
+@typing.overload
 def measurement_reduction(strings: typing.Sequence[pytket._tket.pauli.QubitPauliString], strat: PauliPartitionStrat, method: GraphColourMethod = GraphColourMethod.Lazy, cx_config: pytket._tket.circuit.CXConfigType = pytket._tket.circuit.CXConfigType.Snake) -> MeasurementSetup:
     """
     Automatically performs graph colouring and diagonalisation to reduce measurements required for Pauli strings.
@@ -179,6 +213,15 @@ def measurement_reduction(strings: typing.Sequence[pytket._tket.pauli.QubitPauli
     :param cx_config: Whenever diagonalisation is required, use this configuration of CX gates
     :return: a :py:class:`MeasurementSetup` object
     """
+@typing.overload
+def measurement_reduction(stream: PauliPartitionStream, cx_config: pytket._tket.circuit.CXConfigType = pytket._tket.circuit.CXConfigType.Snake) -> MeasurementSetup:
+    """
+    Diagonalises the sets of a :py:class:`PauliPartitionStream` to reduce measurements required for its Pauli strings.
+    
+    :param stream: The partitioned strings.
+    :param cx_config: Whenever diagonalisation is required, use this configuration of CX gates
+    :return: a :py:class:`MeasurementSetup` object
+    """
 def term_sequence(strings: typing.Sequence[pytket._tket.pauli.QubitPauliString], strat: PauliPartitionStrat = PauliPartitionStrat.CommutingSets, method: GraphColourMethod = GraphColourMethod.Lazy) -> list[list[pytket._tket.pauli.QubitPauliString]]:
     """
     Takes in a list of QubitPauliString objects and partitions them into mutually commuting sets according to some PauliPartitionStrat, then sequences in an arbitrary order.
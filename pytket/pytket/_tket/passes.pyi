@@ -9,12 +9,17 @@ import pytket._tket.transform
 import pytket._tket.unit_id
 import sympy
 import typing
-__all__ = ['AASRouting', 'Audit', 'BasePass', 'CNotSynthType', 'CXMappingPass', 'CliffordSimp', 'CnXPairwiseDecomposition', 'CommuteThroughMultis', 'ComposePhasePolyBoxes', 'ContextSimp', 'CustomPass', 'CustomRoutingPass', 'DecomposeArbitrarilyControlledGates', 'DecomposeBoxes', 'DecomposeClassicalExp', 'DecomposeMultiQubitsCX', 'DecomposeSingleQubitsTK1', 'DecomposeSwapsToCXs', 'DecomposeSwapsToCircuit', 'DecomposeTK2', 'Default', 'DefaultMappingPass', 'DelayMeasures', 'EulerAngleReduction', 'FlattenRegisters', 'FlattenRelabelRegistersPass', 'FullMappingPass', 'FullPeepholeOptimise', 'GlobalisePhasedX', 'GuidedPauliSimp', 'HamPath', 'KAKDecomposition', 'NaivePlacementPass', 'NormaliseTK2', 'OptimisePhaseGadgets', 'PauliExponentials', 'PauliSimp', 'PauliSquash', 'PeepholeOptimise2Q', 'PlacementPass', 'RebaseCustom', 'RebaseTket', 'Rec', 'RemoveBarriers', 'RemoveDiscarded', 'RemoveImplicitQubitPermutation', 'RemoveRedundancies', 'RenameQubitsPass', 'RepeatPass', 'RepeatUntilSatisfiedPass', 'RepeatWithMetricPass', 'RoundAngles', 'RoutingPass', 'SWAP', 'SafetyMode', 'SequencePass', 'SimplifyInitial', 'SimplifyMeasured', 'SquashCustom', 'SquashRzPhasedX', 'SquashTK1', 'SynthesiseHQS', 'SynthesiseOQC', 'SynthesiseTK', 'SynthesiseTket', 'SynthesiseUMD', 'ThreeQubitSquash', 'ZXGraphlikeOptimisation', 'ZZPhaseToRz']
+__all__ = ['AASRouting', 'Audit', 'BasePass', 'CNotSynthType', 'CXMappingPass', 'CachedPass', 'CliffordSimp', 'CnXAncillaDecomposition', 'CnXPairwiseDecomposition', 'CommuteThroughMultis', 'ComposePhasePolyBoxes', 'ContextSimp', 'CustomPass', 'CustomRoutingPass', 'DecomposeArbitrarilyControlledGates', 'DecomposeBoxes', 'DecomposeClassicalExp', 'DecomposeMultiQubitsCX', 'DecomposeSingleQubitsTK1', 'DecomposeSwapsToCXs', 'DecomposeSwapsToCircuit', 'DecomposeTK2', 'Default', 'DefaultMappingPass', 'DelayMeasures', 'EulerAngleReduction', 'FastCompilePass', 'FlattenRegisters', 'FlattenRelabelRegistersPass', 'FullMappingPass', 'FullPeepholeOptimise', 'GlobalisePhasedX', 'GuidedPauliSimp', 'HamPath', 'KAKDecomposition', 'NaivePlacementPass', 'NormaliseTK2', 'OptimisePhaseGadgets', 'PassProfiler', 'PassTuner', 'PauliExponentials', 'PauliSimp', 'PauliSquash', 'PeepholeOptimise2Q', 'PlacementPass', 'RebaseCustom', 'RebaseTket', 'Rec', 'RemoveBarriers', 'RemoveDiscarded', 'RemoveImplicitQubitPermutation', 'RemoveRedundancies', 'RenameQubitsPass', 'RepeatPass', 'RepeatUntilSatisfiedPass', 'RepeatWithMetricPass', 'RoundAngles', 'RoutingPass', 'SWAP', 'SafetyMode', 'SequencePass', 'SimplifyInitial', 'SimplifyMeasured', 'SquashCustom', 'SquashRzPhasedX', 'SquashTK1', 'SynthesiseHQS', 'SynthesiseOQC', 'SynthesiseTK', 'SynthesiseTket', 'SynthesiseUMD', 'ThreeQubitSquash', 'ZXGraphlikeOptimisation', 'ZZPhaseToRz']
 class BasePass:
     """
     Base class for passes.
     """
     @staticmethod
+    def from_bytes(data: bytes) -> BasePass:
+        """
+        Construct a new Pass instance from the result of :py:meth:`to_bytes`.
+        """
+    @staticmethod
     def from_dict(arg0: dict) -> BasePass:
         """
         Construct a new Pass instance from a JSON serializable dictionary representation.
@@ -51,10 +56,68 @@ class BasePass:
         :param after_apply: Invoked after a pass is applied. The CompilationUnit and a summary of the pass configuration are passed into the callback.
         :return: True if pass modified the circuit, else False
         """
+    def apply_batch(self, circuits: list[pytket._tket.circuit.Circuit], n_threads: int = 0) -> list[bool]:
+        """
+        Apply to each of a list of :py:class:`Circuit` in-place, compiling them in parallel.
+        
+        The results are the same as applying the pass to each circuit in turn. If the pass raises an error on any circuit, that error is raised and none of the circuits is modified.
+        
+        Passes that hold an architecture, such as placement and routing passes, fill caches in the architecture as they run, so must be applied with ``n_threads=1``.
+        
+        :param circuits: circuits to compile
+        :param n_threads: number of threads to use, or 0 (the default) to use one per available CPU
+        :return: for each circuit, True if the pass modified it, else False
+        """
+    def to_bytes(self) -> bytes:
+        """
+        :return: a compact binary encoding of the dictionary representation of the Pass.
+        """
     def to_dict(self) -> dict:
         """
         :return: A JSON serializable dictionary representation of the Pass.
         """
+class CachedPass(BasePass):
+    """
+    Remember the results of applying a pass, so that applying it again to an equal circuit returns the same result without recompiling. Results may also be stored as files in a directory, where they are found by later instances wrapping a pass with the same configuration. Passes whose configuration does not determine their behaviour, such as a :py:class:`CustomPass`, should not use a directory.
+    """
+    def __init__(self, compilation_pass: BasePass, capacity: int = 1024, directory: str | None = None) -> None:
+        """
+        Construct from a compilation pass.
+        
+        :param compilation_pass: pass whose results to remember
+        :param capacity: maximum number of results held in memory
+        :param directory: existing directory in which to also store the results, if any
+        """
+    def __str__(self) -> str:
+        ...
+    def apply_with_substitution(self, circuit: pytket._tket.circuit.Circuit, symbol_map: dict[sympy.Symbol, sympy.Expr | float]) -> bool:
+        """
+        Apply to a :py:class:`Circuit` with symbolic parameters in-place, then substitute values for the symbols in the result. Over a parameter sweep the template circuit is compiled once. The result is equivalent to, but not necessarily the same as, compiling the substituted circuit.
+        
+        :param circuit: circuit to compile
+        :param symbol_map: values to substitute for the symbols
+        :return: True if the pass modified the circuit, else False
+        """
+    def clear(self) -> None:
+        """
+        Remove all results held in memory and reset the counters.
+        """
+    def get_pass(self) -> BasePass:
+        """
+        :return: The underlying compilation pass.
+        """
+    def hits(self) -> int:
+        """
+        :return: The number of applications that reused a result.
+        """
+    def misses(self) -> int:
+        """
+        :return: The number of applications that compiled the circuit.
+        """
+    def size(self) -> int:
+        """
+        :return: The number of results held in memory.
+        """
 class CNotSynthType:
     """
     Members:
@@ -95,9 +158,104 @@ class CNotSynthType:
     @property
     def value(self) -> int:
         ...
+class PassProfiler:
+    """
+    Records the running time of each pass applied through it, including every pass nested in a :py:class:`SequencePass`, :py:class:`RepeatPass` and the like, with the gate count and depth of the circuit before and after.
+    """
+    def __init__(self) -> None:
+        """
+        Construct an empty profiler.
+        """
+    def apply(self, compilation_pass: BasePass, circuit: pytket._tket.circuit.Circuit) -> bool:
+        """
+        Apply a pass to a :py:class:`Circuit` in-place, recording each nested pass.
+        
+        :param compilation_pass: pass to apply
+        :param circuit: circuit to compile
+        :return: True if the pass modified the circuit, else False
+        """
+    def clear(self) -> None:
+        """
+        Forget all records and restart the clock.
+        """
+    def get_records(self) -> list:
+        """
+        :return: a dictionary for each application of a pass, in the order they started, giving the name of the pass, the index of the record of the enclosing pass (or None), the start time and duration in microseconds, the gate count and depth before and after, and whether the circuit was modified
+        """
+    def to_folded_stacks(self) -> str:
+        """
+        :return: the records as folded stacks for flamegraph.pl, giving the time in microseconds spent in each nesting of passes
+        """
+    def to_trace_json(self) -> typing.Any:
+        """
+        :return: the records in the Trace Event Format, for viewing as a flame graph in chrome://tracing, Perfetto or speedscope
+        """
+class PassTuner:
+    """
+    Chooses between candidate passes by applying each of them, in parallel, to its own copy of a circuit and keeping the result that scores lowest under a metric. Ties go to the earliest candidate. The winner for a named class of circuits can be recorded and reused.
+    """
+    @staticmethod
+    def depth() -> typing.Callable[[pytket._tket.circuit.Circuit], float]:
+        """
+        :return: metric giving the depth
+        """
+    @staticmethod
+    def infidelity(node_errors: dict[pytket._tket.unit_id.Node, float] = {}, link_errors: dict[tuple[pytket._tket.unit_id.Node, pytket._tket.unit_id.Node], float] = {}, readout_errors: dict[pytket._tket.unit_id.Node, float] = {}) -> typing.Callable[[pytket._tket.circuit.Circuit], float]:
+        """
+        Metric estimating the probability of an error, as one minus the product of the fidelities of the gates and measurements. Gates on more than two qubits, and nodes or links without a given error, contribute no error.
+        
+        :param node_errors: average error of single-qubit gates on each node
+        :param link_errors: average error of two-qubit gates on each ordered pair of nodes
+        :param readout_errors: readout error of each node
+        :return: the metric
+        """
+    @staticmethod
+    def two_qubit_gate_count() -> typing.Callable[[pytket._tket.circuit.Circuit], float]:
+        """
+        :return: metric giving the number of two-qubit gates
+        """
+    def __init__(self, candidates: typing.Sequence[BasePass], metric: typing.Callable[[pytket._tket.circuit.Circuit], float]) -> None:
+        """
+        Construct from candidate passes and a metric.
+        
+        :param candidates: passes to choose between
+        :param metric: score of a compiled circuit, lower being better. It may be called from several threads at once.
+        """
+    def apply(self, circuit: pytket._tket.circuit.Circuit, circuit_class: str, n_threads: int = 0) -> int:
+        """
+        Apply the recorded winner for a class of circuits to a :py:class:`Circuit`, or if there is none yet, tune on this circuit and record the winner for the class.
+        
+        :param circuit: circuit to compile
+        :param circuit_class: name of the class of the circuit
+        :param n_threads: number of threads to use when tuning
+        :return: index of the candidate applied
+        """
+    def get_winner(self, circuit_class: str) -> int | None:
+        """
+        :return: index of the recorded winner for a class of circuits, if any
+        """
+    def get_winners(self) -> dict[str, int]:
+        """
+        :return: the recorded winners, by class of circuits
+        """
+    def set_winner(self, circuit_class: str, candidate: int) -> None:
+        """
+        Record the winner for a class of circuits, for example one saved from an earlier run.
+        
+        :param circuit_class: name of the class of circuits
+        :param candidate: index of the winning candidate
+        """
+    def tune(self, circuit: pytket._tket.circuit.Circuit, n_threads: int = 0) -> int:
+        """
+        Apply every candidate to a copy of a :py:class:`Circuit` and replace it with the best result. Candidates that raise an error are discarded; if all of them do, the first error is raised and the circuit is unchanged.
+        
+        :param circuit: circuit to compile
+        :param n_threads: number of threads to use, or 0 (the default) to use one per available CPU
+        :return: index of the winning candidate
+        """
 class RepeatPass(BasePass):
     """
-    Repeat a pass until its `apply()` method returns False, or if `strict_check` is True until it stops modifying the circuit.
+    Repeat a pass until its `apply()` method returns False or the circuit stops changing, judged by its structural hash, or if `strict_check` is True until it stops modifying the circuit.
     """
     def __init__(self, compilation_pass: BasePass, strict_check: bool = False) -> None:
         """
@@ -192,9 +350,12 @@ class SequencePass(BasePass):
     """
     A sequence of compilation passes.
     """
-    def __init__(self, pass_list: typing.Sequence[BasePass]) -> None:
+    def __init__(self, pass_list: typing.Sequence[BasePass], fuse: bool = False) -> None:
         """
         Construct from a list of compilation passes arranged in order of application.
+        
+        :param pass_list: passes in order of application
+        :param fuse: whether to apply each run of adjacent local rewrite passes, such as rebases, squashes, :py:meth:`RemoveRedundancies` and :py:meth:`DecomposeBoxes`, as a single pass. The resulting circuit is the same, but predicates are checked once per run.
         """
     def __str__(self) -> str:
         ...
@@ -231,6 +392,10 @@ def CliffordSimp(allow_swaps: bool = True) -> BasePass:
     :param allow_swaps: dictates whether the rewriting will disregard CX placement or orientation and introduce wire swaps.
     :return: a pass to perform the rewriting
     """
+def CnXAncillaDecomposition() -> BasePass:
+    """
+    Decompose CnX gates with at least 3 controls to 2-qubit gates and single qubit gates, using qubits that are idle at the point of each gate as ancillae. Qubits known to be in the zero state give a logarithmic-depth decomposition; otherwise, for at least 4 controls, idle qubits in any state give a linear-depth decomposition. Gates with too few idle qubits are left unchanged.
+    """
 def CnXPairwiseDecomposition() -> BasePass:
     """
     Decompose CnX gates to 2-qubit gates and single qubit gates. For every two CnX gates, reorder their control qubits to improve the chance of gate cancellation
@@ -349,6 +514,14 @@ def EulerAngleReduction(q: pytket._tket.circuit.OpType, p: pytket._tket.circuit.
     :param strict: Optionally performs strict P-Q-P Euler decomposition
     :return: a pass that squashes chains of P and Q rotations
     """
+def FastCompilePass(arc: pytket._tket.architecture.Architecture, routing_timeout: int = 5) -> BasePass:
+    """
+    Construct a pass to compile quickly to an :py:class:`Architecture`, for interactive use. Only passes whose running time is close to linear in the size of the circuit are used: boxes are decomposed, the circuit is rebased to CX and TK1 and squashed, routed by LexiRoute looking one layer ahead, then rebased and squashed again. Edge direction is ignored. The result is typically worse than that of :py:meth:`DefaultMappingPass` followed by :py:meth:`SynthesiseTket`.
+    
+    :param arc: The Architecture used for connectivity information.
+    :param routing_timeout: Time budget for routing in milliseconds, after which the rest of the circuit is routed without lookahead; 0 for no budget.
+    :return: a pass to compile to the architecture
+    """
 def FlattenRegisters() -> BasePass:
     """
     Merges all quantum and classical registers into their respective default registers with contiguous indexing.
@@ -24,6 +24,11 @@ class CompilationUnit:
     """
     This class comprises a circuit and the predicates that the circuit is required to satisfy, for example to run on a backend.
     """
+    @staticmethod
+    def from_bytes(data: bytes) -> CompilationUnit:
+        """
+        Construct a unit from the result of :py:meth:`to_bytes`.
+        """
     @typing.overload
     def __init__(self, circuit: pytket._tket.circuit.Circuit) -> None:
         """
@@ -42,6 +47,16 @@ class CompilationUnit:
         """
         :return: True if all predicates are satisfied, else False
         """
+    def set_timeout(self, seconds: float) -> None:
+        """
+        Limit the time for which passes may be applied to this unit. Once the time has passed, a pass raises a RuntimeError at the next point where the circuit is valid, leaving the best circuit found so far in the unit. This circuit is equivalent to the original but need not satisfy the postconditions of the pass.
+        
+        :param seconds: time limit, counted from now
+        """
+    def to_bytes(self) -> bytes:
+        """
+        :return: a compact binary encoding of the unit, holding the circuit, its initial and final maps, the target predicates and the predicates known to be satisfied, so that compilation can be resumed elsewhere
+        """
     @property
     def circuit(self) -> pytket._tket.circuit.Circuit:
         """
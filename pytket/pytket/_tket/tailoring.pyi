@@ -4,6 +4,7 @@ The tailoring module provides access to noise tailoring tools.
 from __future__ import annotations
 import pytket._tket.circuit
 import pytket._tket.pauli
+import typing
 __all__ = ['FrameRandomisation', 'PauliFrameRandomisation', 'UniversalFrameRandomisation', 'apply_clifford_basis_change', 'apply_clifford_basis_change_tensor']
 class FrameRandomisation:
     """
@@ -26,6 +27,7 @@ class FrameRandomisation:
         :param circuit: The circuit to find frames for.
         :return: list of :py:class:`Circuit` s
         """
+    @typing.overload
     def sample_circuits(self, circuit: pytket._tket.circuit.Circuit, samples: int) -> list[pytket._tket.circuit.Circuit]:
         """
         Returns a number of instances equal to sample of frame randomisation for the given circuit. Samples individual frame gates uniformly.
@@ -34,6 +36,17 @@ class FrameRandomisation:
         :param samples: the number of frame randomised circuits to return.
         :return: list of :py:class:`Circuit` s
         """
+    @typing.overload
+    def sample_circuits(self, circuit: pytket._tket.circuit.Circuit, samples: int, seed: int, n_threads: int = 0) -> list[pytket._tket.circuit.Circuit]:
+        """
+        Returns a number of instances equal to sample of frame randomisation for the given circuit, reproducibly for a given seed. Samples individual frame gates uniformly, each sample from its own random stream, so that the result does not depend on the number of threads.
+        
+        :param circuit: The circuit to perform frame randomisation with Pauli gates on
+        :param samples: the number of frame randomised circuits to return.
+        :param seed: the random seed
+        :param n_threads: the number of threads to use, or 0 for one per hardware thread
+        :return: list of :py:class:`Circuit` s
+        """
 class PauliFrameRandomisation:
     """
     The PauliFrameRandomisation class. PauliFrameRandomisation finds subcircuits (cycles) of a given circuit comprised of gates with OpType::H, OpType::CX and OpType::S, and wires gates into the boundary (frame) of these cycles. Input frame gates are sampled from another set of OpType comprised of the Pauli gates, and output frame gates deduced such that the circuit unitary doesn't change, achieved by computing the action of cycle gates on frame gates.
@@ -51,6 +64,7 @@ class PauliFrameRandomisation:
         :param circuit: The circuit to find frames for.
         :return: list of :py:class:`Circuit` s
         """
+    @typing.overload
     def sample_circuits(self, circuit: pytket._tket.circuit.Circuit, samples: int) -> list[pytket._tket.circuit.Circuit]:
         """
         Returns a number of instances equal to sample of frame randomisation for the given circuit. Samples individual frame gates uniformly from the Pauli gates.
@@ -59,6 +73,17 @@ class PauliFrameRandomisation:
         :param samples: the number of frame randomised circuits to return.
         :return: list of :py:class:`Circuit` s
         """
+    @typing.overload
+    def sample_circuits(self, circuit: pytket._tket.circuit.Circuit, samples: int, seed: int, n_threads: int = 0) -> list[pytket._tket.circuit.Circuit]:
+        """
+        Returns a number of instances equal to sample of frame randomisation for the given circuit, reproducibly for a given seed. Samples individual frame gates uniformly from the Pauli gates, each sample from its own random stream, so that the result does not depend on the number of threads.
+        
+        :param circuit: The circuit to perform frame randomisation with Pauli gates on
+        :param samples: the number of frame randomised circuits to return.
+        :param seed: the random seed
+        :param n_threads: the number of threads to use, or 0 for one per hardware thread
+        :return: list of :py:class:`Circuit` s
+        """
 class UniversalFrameRandomisation:
     """
     The UniversalFrameRandomisation class. UniversalFrameRandomisation finds subcircuits (cycles) of a given circuit comprised of gates with OpType::H, OpType::CX, and OpType::Rz, and wires gates into the boundary (frame) of these cycles. Input frame gates are sampled from another set of OpType comprised of the Pauli gates, and output frame gates deduced such that the circuit unitary doesn't change, achieved by computing the action of cycle gates on frame gates. Some gates with OpType::Rz may be substituted for their dagger to achieve this.
@@ -76,6 +101,7 @@ class UniversalFrameRandomisation:
         :param circuit: The circuit to find frames for.
         :return: list of :py:class:`Circuit` s
         """
+    @typing.overload
     def sample_circuits(self, circuit: pytket._tket.circuit.Circuit, samples: int) -> list[pytket._tket.circuit.Circuit]:
         """
         Returns a number of instances equal to sample of frame randomisation for the given circuit. Samples individual frame gates uniformly from the Pauli gates.
@@ -84,6 +110,17 @@ class UniversalFrameRandomisation:
         :param samples: the number of frame randomised circuits to return.
         :return: list of :py:class:`Circuit` s
         """
+    @typing.overload
+    def sample_circuits(self, circuit: pytket._tket.circuit.Circuit, samples: int, seed: int, n_threads: int = 0) -> list[pytket._tket.circuit.Circuit]:
+        """
+        Returns a number of instances equal to sample of frame randomisation for the given circuit, reproducibly for a given seed. Samples individual frame gates uniformly from the Pauli gates, each sample from its own random stream, so that the result does not depend on the number of threads.
+        
+        :param circuit: The circuit to perform frame randomisation with Pauli gates on
+        :param samples: the number of frame randomised circuits to return.
+        :param seed: the random seed
+        :param n_threads: the number of threads to use, or 0 for one per hardware thread
+        :return: list of :py:class:`Circuit` s
+        """
 def apply_clifford_basis_change(pauli: pytket._tket.pauli.QubitPauliString, circuit: pytket._tket.circuit.Circuit) -> pytket._tket.pauli.QubitPauliString:
     """
     Given Pauli operator P and Clifford circuit C, returns C_dagger.P.C in multiplication order. This ignores any -1 phase that could be introduced. 
@@ -16,11 +16,14 @@ class PauliSynthStrat:
       Pairwise : Synthesise gadgets using an efficient pairwise strategy from Cowtan et al (https://arxiv.org/abs/1906.01734)
     
       Sets : Synthesise gadgets in commuting sets
+    
+      Lookahead : Synthesise gadgets one at a time, keeping the Clifford reductions as a frame and choosing each gadget by its CX cost with a bounded lookahead
     """
     Individual: typing.ClassVar[PauliSynthStrat]  # value = <PauliSynthStrat.Individual: 0>
+    Lookahead: typing.ClassVar[PauliSynthStrat]  # value = <PauliSynthStrat.Lookahead: 3>
     Pairwise: typing.ClassVar[PauliSynthStrat]  # value = <PauliSynthStrat.Pairwise: 1>
     Sets: typing.ClassVar[PauliSynthStrat]  # value = <PauliSynthStrat.Sets: 2>
-    __members__: typing.ClassVar[dict[str, PauliSynthStrat]]  # value = {'Individual': <PauliSynthStrat.Individual: 0>, 'Pairwise': <PauliSynthStrat.Pairwise: 1>, 'Sets': <PauliSynthStrat.Sets: 2>}
+    __members__: typing.ClassVar[dict[str, PauliSynthStrat]]  # value = {'Individual': <PauliSynthStrat.Individual: 0>, 'Pairwise': <PauliSynthStrat.Pairwise: 1>, 'Sets': <PauliSynthStrat.Sets: 2>, 'Lookahead': <PauliSynthStrat.Lookahead: 3>}
     def __eq__(self, other: typing.Any) -> bool:
         ...
     def __getstate__(self) -> int:
@@ -52,6 +55,11 @@ class Transform:
     An in-place transformation of a :py:class:`Circuit`.
     """
     @staticmethod
+    def CnXAncillaDecomposition() -> Transform:
+        """
+        Decompose CnX gates with at least 3 controls to 2-qubit gates and single qubit gates, using qubits that are idle at the point of each gate as ancillae. Qubits known to be in the zero state give a logarithmic-depth decomposition; otherwise, for at least 4 controls, idle qubits in any state give a linear-depth decomposition. Gates with too few idle qubits are left unchanged.
+        """
+    @staticmethod
     def CnXPairwiseDecomposition() -> Transform:
         """
         Decompose CnX gates to 2-qubit gates and single qubit gates. For every two CnX gates, reorder their control qubits to improve the chance of gate cancellation.
@@ -273,9 +281,13 @@ class Transform:
         Synthesises Pauli Graphs.
         """
     @staticmethod
-    def ThreeQubitSquash(target_2qb_gate: pytket._tket.circuit.OpType = pytket._tket.circuit.OpType.CX) -> Transform:
+    def ThreeQubitSquash(target_2qb_gate: pytket._tket.circuit.OpType = pytket._tket.circuit.OpType.CX, max_candidates: int = 0, timeout: int = 0) -> Transform:
         """
         Squash three-qubit subcircuits into subcircuits having fewer 2-qubit gates of the target type, when possible. The supported target types are CX (default) and TK2.
+        
+        :param target_2qb_gate: target 2-qubit gate
+        :param max_candidates: maximum number of candidate subcircuits to resynthesise, or 0 for no limit
+        :param timeout: time (ms) after which no further candidates are resynthesised, or 0 for no limit
         """
     @staticmethod
     def UCCSynthesis(synth_strat: PauliSynthStrat = PauliSynthStrat.Sets, cx_config: pytket._tket.circuit.CXConfigType = pytket._tket.circuit.CXConfigType.Snake) -> Transform:
@@ -288,6 +300,14 @@ class Transform:
         Fixes all ZZPhase gate angles to [-1, 1) half turns.
         """
     @staticmethod
+    def conjugation_actions(transform: Transform) -> Transform:
+        """
+        Applies a given Transform to the action of every :py:class:`~.ConjugationBox` in a circuit, including those nested within actions, without expanding the compute and uncompute parts. Each transformed action is replaced by a :py:class:`~.CircBox`.
+        
+        :param transform: The Transform to be applied to the actions
+        :return: a new Transform acting on the actions
+        """
+    @staticmethod
     def repeat(transform: Transform) -> Transform:
         """
         Applies a given Transform repeatedly to a circuit until no further changes are made (i.e. it no longer returns ``True``). :py:meth:`apply` will return ``True`` if at least one run returned ``True``.
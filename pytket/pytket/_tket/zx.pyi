@@ -3,7 +3,7 @@ import pytket._tket.circuit
 import pytket._tket.unit_id
 import sympy
 import typing
-__all__ = ['CliffordGen', 'DirectedGen', 'Flow', 'PhasedGen', 'QuantumType', 'Rewrite', 'ZXBox', 'ZXDiagram', 'ZXGen', 'ZXType', 'ZXVert', 'ZXWire', 'ZXWireType', 'circuit_to_zx']
+__all__ = ['CliffordGen', 'DirectedGen', 'Flow', 'PhasedGen', 'QuantumType', 'Rewrite', 'RewriteRecord', 'RewriteStatistics', 'ZXBox', 'ZXDiagram', 'ZXGen', 'ZXType', 'ZXVert', 'ZXWire', 'ZXWireType', 'circuit_to_graphlike_zx', 'circuit_to_zx']
 class CliffordGen(ZXGen):
     """
     Specialisation of :py:class:`ZXGen` for arbitrary-arity, symmetric Clifford generators with a single boolean parameter.
@@ -177,6 +177,14 @@ class Rewrite:
         Identifies pairs of phase gadgets over the same sets of qubits and merges them.
         """
     @staticmethod
+    def parallel_components(rewrite: Rewrite) -> Rewrite:
+        """
+        Applies a given :py:class:`Rewrite` separately to each connected component of a diagram, running the components in parallel, and merges the results back together with the same boundary order. Only suitable for rewrites which act locally within a connected component.
+        
+        :param rewrite: The :py:class:`Rewrite` to be applied to each component.
+        :return: A new :py:class:`Rewrite` acting on the components in parallel.
+        """
+    @staticmethod
     def parallel_h_removal() -> Rewrite:
         """
         Remove parallel edges between ZX spiders (a.k.a. the Hopf rule). Matches either pairs of H edges between spiders of the same colour or Basic edges between spiders of different colour. This applies to Quantum edges between a pair of Classical spiders.
@@ -202,6 +210,11 @@ class Rewrite:
         Given a diagram in graphlike form, applies local complementations and pivoting to remove as many interior Clifford-angled vertices as possible. The only remaining Clifford-angled vertices will be either the axis of a phase-gadget or near a boundary.
         """
     @staticmethod
+    def reduce_graphlike_form_compact() -> Rewrite:
+        """
+        As :py:meth:`reduce_graphlike_form`, but performed on a compact copy of the diagram, which is much faster for large diagrams. Only applies to quantum diagrams in graphlike form without parallel wires or self-loops.
+        """
+    @staticmethod
     def remove_interior_cliffords() -> Rewrite:
         """
         Removes interior proper Cliffords (spiders where the phase is an odd multiple of pi/2 radians or 0.5 half-turns). Performs local complementation about the vertex and removes it.
@@ -259,6 +272,71 @@ class Rewrite:
         :param diag: The diagram to be transformed.
         :return: True if any changes were made, else False.
         """
+    @staticmethod
+    def with_statistics(rewrite: Rewrite, name: str, stats: RewriteStatistics) -> Rewrite:
+        """
+        Wraps a :py:class:`Rewrite` so that each application is recorded under the given name: whether it changed the diagram, the time taken and the numbers of vertices and wires before and after.
+        
+        :param rewrite: The :py:class:`Rewrite` to be instrumented.
+        :param name: The name to record applications under.
+        :param stats: The collector to record into.
+        :return: A new :py:class:`Rewrite` which behaves as `rewrite`.
+        """
+class RewriteRecord:
+    """
+    Accumulated statistics for a single named :py:class:`Rewrite`. Sizes are summed over all applications.
+    """
+    @property
+    def n_applications(self) -> int:
+        """
+        Number of times the rewrite was applied.
+        """
+    @property
+    def n_successes(self) -> int:
+        """
+        Number of applications which changed the diagram.
+        """
+    @property
+    def seconds(self) -> float:
+        """
+        Total time spent applying the rewrite, in seconds.
+        """
+    @property
+    def vertices_after(self) -> int:
+        """
+        Total number of vertices after each application.
+        """
+    @property
+    def vertices_before(self) -> int:
+        """
+        Total number of vertices before each application.
+        """
+    @property
+    def wires_after(self) -> int:
+        """
+        Total number of wires after each application.
+        """
+    @property
+    def wires_before(self) -> int:
+        """
+        Total number of wires before each application.
+        """
+class RewriteStatistics:
+    """
+    Collects a :py:class:`RewriteRecord` for each name used with :py:meth:`Rewrite.with_statistics`.
+    """
+    def __init__(self) -> None:
+        """
+        Constructs an empty collector.
+        """
+    def clear(self) -> None:
+        """
+        Removes all records.
+        """
+    def get_records(self) -> dict[str, RewriteRecord]:
+        """
+        :return: a map from rewrite name to its accumulated record
+        """
 class ZXBox(ZXGen):
     """
     Specialisation of :py:class:`ZXGen` for encapsulations of some other ZX diagrams. In general, arbitrary diagrams may be asymmetric tensors with both Quantum and Classical boundaries, so ports are used to distinguish each boundary.
@@ -695,6 +773,10 @@ class ZXWireType:
     @property
     def value(self) -> int:
         ...
+def circuit_to_graphlike_zx(circ: pytket._tket.circuit.Circuit) -> ZXDiagram:
+    """
+    Construct a ZX diagram in graphlike form directly from a unitary circuit, without building a subdiagram per gate. Supports H, X, Z, S, Sdg, T, Tdg, Rx, Rz, U1, CX, CZ, SWAP, noop and Barrier. The boundary consists of the inputs followed by the outputs, in the order of the circuit's qubits.
+    """
 def circuit_to_zx(arg0: pytket._tket.circuit.Circuit) -> tuple[ZXDiagram, dict[pytket._tket.unit_id.UnitID, tuple[ZXVert, ZXVert]]]:
     """
     Construct a ZX diagram from a circuit. Return the ZX diagram and a map Between the ZX boundary vertices and the resource UIDs of the circuit.
@@ -126,6 +126,21 @@ def test_arch_types() -> None:
     assert ra.nodes[0].reg_name == "ringNode"
 
 
+def test_arch_precomputed() -> None:
+    sg = SquareGrid(3, 4)
+    d = sg.to_dict(precomputed=True)
+    arch_validator.validate(d)
+    assert len(d["precomputed"]["distances"]) == 66
+    assert d["precomputed"]["diameter"] == 5
+    loaded = Architecture.from_dict(d)
+    assert loaded == sg
+    assert loaded.to_dict() == sg.to_dict()
+    assert loaded.to_dict(precomputed=True) == d
+    for n0 in sg.nodes:
+        for n1 in sg.nodes:
+            assert loaded.get_distance(n0, n1) == sg.get_distance(n0, n1)
+
+
 def test_arch_names() -> None:
     fc = FullyConnected(2, "fc_test")
     assert fc.nodes[0].reg_name == "fc_test"
@@ -160,3 +175,4 @@ if __name__ == "__main__":
     test_arch_types()
     test_valid_operation()
     test_arch_names()
+    test_arch_precomputed()
@@ -112,6 +112,16 @@ def test_universal_frame_randomisation() -> None:
     assert coms_15[7].op.type == OpType.noop
 
 
+def test_seeded_frame_randomisation() -> None:
+    ufr = UniversalFrameRandomisation()
+    circ = Circuit(3).Rz(0.2, 0).CX(0, 1).H(1).Rz(0.3, 1).CX(1, 2)
+    circs = ufr.sample_circuits(circ, 30, seed=11, n_threads=1)
+    assert len(circs) == 30
+    assert ufr.sample_circuits(circ, 30, seed=11, n_threads=4) == circs
+    assert ufr.sample_circuits(circ, 30, 11) == circs
+    assert ufr.sample_circuits(circ, 30, seed=12) != circs
+
+
 def test_apply_clifford_basis_change() -> None:
     circ_0 = Circuit(1).H(0)
     z_op = QubitPauliString(Qubit(0), Pauli.Z)
@@ -20,6 +20,8 @@ import pickle
 
 from pytket.circuit import (
     Circuit,
+    CircuitArchive,
+    SymbolBindingPlan,
     Op,
     OpType,
     Command,
@@ -34,6 +36,7 @@ from pytket.circuit import (
     MultiplexedTensoredU2Box,
     StatePreparationBox,
     DiagonalBox,
+    DiagonalBoxSynthStrat,
     ConjugationBox,
     ExpBox,
     PauliExpBox,
@@ -625,6 +628,12 @@ def test_boxes() -> None:
     diag_box = DiagonalBox(diag_vect)
     u = diag_box.get_circuit().get_unitary()
     assert np.allclose(np.diag(diag_vect), u)
+    pp_diag_box = DiagonalBox(
+        diag_vect, strat=DiagonalBoxSynthStrat.PhasePolynomial
+    )
+    assert pp_diag_box.get_strat() == DiagonalBoxSynthStrat.PhasePolynomial
+    u = pp_diag_box.get_circuit().get_unitary()
+    assert np.allclose(np.diag(diag_vect), u)
     d.add_diagonal_box(diag_box, [Qubit(0), Qubit(1), Qubit(2)])
     d.add_diagonal_box(diag_box, [0, 1, 2])
     assert d.n_gates == 21
@@ -884,6 +893,118 @@ def test_circuit_pickle_roundtrip(circuit: Circuit) -> None:
     assert pickle.loads(pickle.dumps(circuit)) == circuit
 
 
+@given(st.circuits())
+@settings(deadline=None)
+def test_circuit_binary_roundtrip(circuit: Circuit) -> None:
+    data = circuit.to_binary()
+    assert Circuit.from_binary(data) == circuit
+    assert Circuit.from_binary(data).to_dict() == circuit.to_dict()
+
+
+def test_get_command_columns() -> None:
+    a = Symbol("a")
+    c = Circuit(2, 1)
+    c.H(0).CX(0, 1, opgroup="ent").Rz(a, 1).Measure(1, 0)
+    c.add_gate(OpType.U2, [0.5, 0.25], [0], opgroup="ent")
+    cols = c.get_command_columns()
+    assert cols["units"] == [Qubit(0), Qubit(1), Bit(0)]
+    assert len(cols["op_types"]) == c.n_gates
+    assert cols["arg_offsets"][-1] == len(cols["args"])
+    assert cols["param_offsets"][-1] == len(cols["params"])
+    assert cols["opgroups"] == ["ent"]
+    coms = {}
+    for i, t in enumerate(cols["op_types"]):
+        args = cols["args"][cols["arg_offsets"][i] : cols["arg_offsets"][i + 1]]
+        params = cols["params"][cols["param_offsets"][i] : cols["param_offsets"][i + 1]]
+        coms[OpType(int(t))] = ([cols["units"][u] for u in args], list(params))
+        assert (cols["opgroup_ids"][i] == 0) == (t in (int(OpType.CX), int(OpType.U2)))
+    assert coms[OpType.CX] == ([Qubit(0), Qubit(1)], [])
+    assert coms[OpType.Measure] == ([Qubit(1), Bit(0)], [])
+    assert coms[OpType.U2] == ([Qubit(0)], [0.5, 0.25])
+    assert np.isnan(coms[OpType.Rz][1][0])
+
+
+def test_add_gates() -> None:
+    c = Circuit(3).X(2)
+    types = np.array([int(OpType.H), int(OpType.CX), int(OpType.Rz), int(OpType.CCX)])
+    qubits = np.array([[0, -1, -1], [0, 1, -1], [2, -1, -1], [0, 1, 2]])
+    params = np.array([[0.0], [0.0], [0.25], [0.0]])
+    c.add_gates(types, qubits, params)
+    assert c == Circuit(3).X(2).H(0).CX(0, 1).Rz(0.25, 2).CCX(0, 1, 2)
+    c.add_gates(np.array([int(OpType.CZ)]), np.array([[1, 2]]))
+    assert c.n_gates_of_type(OpType.CZ) == 1
+    with pytest.raises(RuntimeError):
+        c.add_gates(np.array([int(OpType.Measure)]), np.array([[0, 0]]))
+    with pytest.raises(RuntimeError):
+        c.add_gates(np.array([int(OpType.H)]), np.array([[3]]))
+    with pytest.raises(ValueError):
+        c.add_gates(np.array([int(OpType.H)]), np.array([0]))
+    assert c.n_gates == 6
+
+
+def test_circuit_to_dict_box_table() -> None:
+    inner = Circuit(2).CX(0, 1).Rz(0.25, 1)
+    box = CircBox(inner)
+    c = Circuit(3)
+    for _ in range(3):
+        c.add_circbox(box, [0, 1]).add_circbox(box, [1, 2])
+    d = c.to_dict(box_table=True)
+    validate(instance=d, schema=schema)
+    assert len(d["boxes"]) == 1
+    assert all("box_ref" in com["op"] for com in d["commands"])
+    assert len(json.dumps(d)) < len(json.dumps(c.to_dict()))
+    assert Circuit.from_dict(d) == c
+    assert Circuit(2).CX(0, 1).to_dict(box_table=True) == Circuit(2).CX(0, 1).to_dict()
+
+
+def test_circuit_from_json_file(tmp_path: Path) -> None:
+    c = Circuit(3, 1, "json_file")
+    c.H(0).CX(0, 1).Rz(0.25, 2).Measure(1, 0)
+    c.X(2, condition_bits=[0], condition_value=1)
+    path = tmp_path / "circ.json"
+    with open(path, "w") as f:
+        json.dump(c.to_dict(), f)
+    assert Circuit.from_json_file(str(path)) == c
+    with pytest.raises(ValueError):
+        Circuit.from_json_file(str(tmp_path / "missing.json"))
+
+
+def test_circuit_archive(tmp_path: Path) -> None:
+    circs = {f"c{i}": Circuit(2).Rz(0.1 * i, 0).CX(0, 1) for i in range(10)}
+    path = str(tmp_path / "circs.tkca")
+    CircuitArchive.write(path, circs)
+    archive = CircuitArchive(path)
+    assert len(archive) == 10
+    assert archive.names() == sorted(circs)
+    assert "c3" in archive
+    assert "c10" not in archive
+    for name, c in circs.items():
+        assert archive[name] == c
+    with pytest.raises(KeyError):
+        archive["c10"]
+    with pytest.raises(RuntimeError):
+        CircuitArchive(str(tmp_path / "missing.tkca"))
+
+
+def test_symbol_binding_plan() -> None:
+    a, b = Symbol("a"), Symbol("b")
+    c = Circuit(2).Rx(2 * a, 0).CX(0, 1).TK1(a, 0.3, a * b, 1).Rz(0.25, 1)
+    c.add_phase(a + b)
+    plan = SymbolBindingPlan(c, [a, b])
+    assert plan.symbols == [a, b]
+    batch = [[0.1 * i, -0.2 * i] for i in range(10)]
+    for values, bound in zip(batch, plan.bind_all(batch, n_threads=3)):
+        expected = c.copy()
+        expected.symbol_substitution({a: values[0], b: values[1]})
+        assert not bound.free_symbols()
+        assert np.allclose(bound.get_unitary(), expected.get_unitary())
+        assert bound == plan.bind(values)
+    with pytest.raises(ValueError):
+        plan.bind([0.5])
+    with pytest.raises(ValueError):
+        SymbolBindingPlan(c, [a])
+
+
 @given(st.circuits())
 @settings(deadline=None)
 def test_circuit_from_to_serializable(circuit: Circuit) -> None:
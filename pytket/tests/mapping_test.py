@@ -382,6 +382,30 @@ def test_MultiGateReorderRoutingMethod() -> None:
     assert len(circ.get_commands()) == 6
 
 
+def test_MultiGateReorderRoutingMethod_scheduled() -> None:
+    arc = Architecture([(0, 1), (1, 2), (2, 3), (3, 4)])
+    circ = Circuit(5)
+    # Invalid operation
+    circ.CZ(0, 2)
+    # Many layers of valid operations that can all be commuted to the front
+    for _ in range(20):
+        circ.Rz(0.1, 0)
+        circ.CZ(0, 1)
+        circ.ZZPhase(0.3, 2, 3)
+        circ.CZ(1, 2)
+        circ.CZ(3, 4)
+    Placement(arc).place_with_map(circ, {Qubit(i): Node(i) for i in range(5)})
+    MappingManager(arc).route_circuit(
+        circ,
+        [
+            MultiGateReorderRoutingMethod(max_size=1000, scheduled=True),
+            LexiRouteRoutingMethod(50),
+        ],
+    )
+    assert circ.valid_connectivity(arc, directed=False)
+    assert circ.n_gates_of_type(OpType.SWAP) == 1
+
+
 def test_MultiGateReorderRoutingMethod_with_LexiLabelling() -> None:
     circ = Circuit(4)
     arc = Architecture([(0, 1), (1, 2), (2, 3), (0, 3)])
@@ -17,6 +17,7 @@ from pytket.circuit import Circuit, Qubit
 from pytket.pauli import Pauli, QubitPauliString
 from pytket.partition import (
     PauliPartitionStrat,
+    PauliPartitionStream,
     MeasurementBitMap,
     MeasurementSetup,
     measurement_reduction,
@@ -63,6 +64,21 @@ def test_reduction() -> None:
         assert measurements.verify()
 
 
+def test_streamed_reduction() -> None:
+    str1 = QubitPauliString({Qubit(0): Pauli.I, Qubit(1): Pauli.Z, Qubit(2): Pauli.X})
+    str2 = QubitPauliString({Qubit(0): Pauli.Y, Qubit(1): Pauli.Z, Qubit(2): Pauli.X})
+    str3 = QubitPauliString({Qubit(0): Pauli.X, Qubit(1): Pauli.Y, Qubit(2): Pauli.Y})
+
+    stream = PauliPartitionStream(PauliPartitionStrat.CommutingSets)
+    assert stream.add_strings([str1, str2]) == 2
+    assert stream.add_strings([str2, str3]) == 1
+    assert stream.n_strings == 3
+    assert stream.n_sets == len(stream.get_sets())
+    measurements = measurement_reduction(stream)
+    assert len(measurements.measurement_circs) == 2
+    assert measurements.verify()
+
+
 def test_error_logging(capfd: Any) -> None:
     ms = MeasurementSetup()
     circ = Circuit(2, 2)
@@ -134,5 +150,6 @@ if __name__ == "__main__":
     test_empty_setup()
     test_parity_flip()
     test_reduction()
+    test_streamed_reduction()
     test_serialization()
     # test_error_logging()
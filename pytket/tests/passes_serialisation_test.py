@@ -314,6 +314,7 @@ TWO_WAY_NONPARAM_PASSES = [
     "RemoveBarriers",
     "DecomposeBridges",
     "CnXPairwiseDecomposition",
+    "CnXAncillaDecomposition",
     "RemoveImplicitQubitPermutation",
 ]
 
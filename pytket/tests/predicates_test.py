@@ -11,6 +11,9 @@
 # WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 # See the License for the specific language governing permissions and
 # limitations under the License.
+from concurrent.futures import ThreadPoolExecutor
+
+import pytest
 import sympy
 
 from pytket import logging
@@ -30,9 +33,15 @@ from pytket.circuit import (
 from pytket.circuit.named_types import ParamType, RenameUnitsMap
 from pytket.pauli import Pauli
 from pytket.passes import (
+    BasePass,
     SequencePass,
     RemoveRedundancies,
     SynthesiseTket,
+    FullPeepholeOptimise,
+    CachedPass,
+    CustomPass,
+    PassProfiler,
+    PassTuner,
     SynthesiseHQS,
     SynthesiseUMD,
     RepeatUntilSatisfiedPass,
@@ -52,6 +61,7 @@ from pytket.passes import (
     RenameQubitsPass,
     FullMappingPass,
     DefaultMappingPass,
+    FastCompilePass,
     AASRouting,
     DecomposeSwapsToCXs,
     DecomposeSwapsToCircuit,
@@ -62,10 +72,12 @@ from pytket.passes import (
     SimplifyMeasured,
     SimplifyInitial,
     RemoveBarriers,
+    CliffordSimp,
     PauliSquash,
     auto_rebase_pass,
     ZZPhaseToRz,
     CnXPairwiseDecomposition,
+    CnXAncillaDecomposition,
     RemoveImplicitQubitPermutation,
     FlattenRelabelRegistersPass,
     RoundAngles,
@@ -79,6 +91,7 @@ from pytket.predicates import (
     NoBarriersPredicate,
     CompilationUnit,
     MaxNClRegPredicate,
+    ConnectivityPredicate,
 )
 from pytket.mapping import (
     LexiLabellingMethod,
@@ -811,6 +824,16 @@ def test_cnx_pairwise_decomp() -> None:
     assert c.n_gates_of_type(OpType.CX) < 217
 
 
+def test_cnx_ancilla_decomp() -> None:
+    c = Circuit(9).H(6).H(7).H(8)
+    c.add_gate(OpType.CnX, [], [0, 1, 2, 3, 4, 5])
+    u = c.get_unitary()
+    assert CnXAncillaDecomposition().apply(c)
+    assert c.n_gates_of_type(OpType.CnX) == 0
+    assert c.n_gates_of_type(OpType.CX) == 42
+    assert np.allclose(c.get_unitary(), u)
+
+
 def test_remove_implicit_qubit_permutation() -> None:
     c = Circuit(3).X(0).SWAP(0, 1).SWAP(1, 2)
     c.replace_SWAPs()
@@ -978,6 +1001,182 @@ def test_SynthesiseHQS_deprecation(capfd: Any) -> None:
     logging.set_level(logging.level.err)
 
 
+def test_apply_batch() -> None:
+    circs = []
+    for i in range(10):
+        c = Circuit(3)
+        for j in range(3 + i):
+            c.Rz(0.1 * (i + j), j % 3).CX(j % 3, (j + 1) % 3).H((i + j) % 3)
+        circs.append(c)
+    circs.append(Circuit(2))
+    expected = [c.copy() for c in circs]
+    expected_results = [FullPeepholeOptimise().apply(c) for c in expected]
+    results = FullPeepholeOptimise().apply_batch(circs, n_threads=4)
+    assert results == expected_results
+    assert not results[-1]
+    assert circs == expected
+
+
+def test_cached_pass() -> None:
+    c = Circuit(3).H(0).CX(0, 1).CX(1, 2).CX(0, 1)
+    cp = CachedPass(FullPeepholeOptimise())
+    expected = c.copy()
+    FullPeepholeOptimise().apply(expected)
+    for _ in range(3):
+        c1 = c.copy()
+        cp.apply(c1)
+        assert c1 == expected
+    assert cp.misses() == 1
+    assert cp.hits() == 2
+    assert cp.size() == 1
+    assert cp.to_dict() == FullPeepholeOptimise().to_dict()
+    a = Symbol("a")
+    templ = Circuit(2).Rz(a, 0).CX(0, 1).Rz(a, 0).CX(0, 1)
+    sweep = CachedPass(SynthesiseTket())
+    for x in [0.1, 0.2, 0.3]:
+        c1 = templ.copy()
+        sweep.apply_with_substitution(c1, {a: x})
+        assert not c1.free_symbols()
+    assert sweep.misses() == 1
+    assert sweep.hits() == 2
+
+
+def test_pass_profiler() -> None:
+    c = Circuit(2).H(0).H(0).CX(0, 1)
+    seq = SequencePass([RemoveRedundancies(), RepeatPass(RemoveRedundancies())])
+    profiler = PassProfiler()
+    assert profiler.apply(seq, c)
+    assert c.n_gates == 1
+    records = profiler.get_records()
+    assert [r["name"] for r in records] == [
+        "SequencePass",
+        "RemoveRedundancies",
+        "RepeatPass",
+        "RemoveRedundancies",
+    ]
+    assert records[0]["parent"] is None
+    assert records[3]["parent"] == 2
+    assert records[1]["modified"]
+    assert records[1]["gates_before"] == 3
+    assert records[1]["gates_after"] == 1
+    assert not records[3]["modified"]
+    trace = profiler.to_trace_json()
+    assert len(trace["traceEvents"]) == 4
+    assert "SequencePass;RepeatPass;RemoveRedundancies " in (
+        profiler.to_folded_stacks()
+    )
+    profiler.clear()
+    assert profiler.get_records() == []
+
+
+def test_compilation_timeout() -> None:
+    c = Circuit(2).H(0).H(0).CX(0, 1)
+    cu = CompilationUnit(c)
+    cu.set_timeout(0)
+    with pytest.raises(RuntimeError, match="Compilation cancelled"):
+        FullPeepholeOptimise().apply(cu)
+    assert cu.circuit == c
+    cu = CompilationUnit(c)
+    cu.set_timeout(3600)
+    assert FullPeepholeOptimise().apply(cu)
+
+
+def test_fused_sequence_pass() -> None:
+    c = Circuit(2).H(0).H(0).Rz(0.25, 1).Rx(0.5, 1).CZ(0, 1)
+    passes = [
+        DecomposeBoxes(),
+        RebaseTket(),
+        RemoveRedundancies(),
+        SquashTK1(),
+        CliffordSimp(),
+        RemoveRedundancies(),
+    ]
+    c0 = c.copy()
+    c1 = c.copy()
+    assert SequencePass(passes).apply(c0)
+    assert SequencePass(passes, fuse=True).apply(c1)
+    assert c0 == c1
+
+
+def test_pass_tuner() -> None:
+    c = Circuit(2).H(0).CX(0, 1).CX(0, 1).Rz(0.3, 1)
+    tuner = PassTuner(
+        [DecomposeBoxes(), SynthesiseTket()], PassTuner.two_qubit_gate_count()
+    )
+    c0 = c.copy()
+    assert tuner.tune(c0) == 1
+    assert c0.n_2qb_gates() == 0
+    assert tuner.get_winners() == {}
+    c1 = c.copy()
+    assert tuner.apply(c1, "small") == 1
+    assert tuner.get_winner("small") == 1
+    tuner.set_winner("large", 0)
+    c2 = c.copy()
+    assert tuner.apply(c2, "large") == 0
+    assert c2 == c
+    by_size = PassTuner([DecomposeBoxes(), SynthesiseTket()], lambda c: c.n_gates)
+    assert by_size.tune(c.copy(), n_threads=2) == 1
+    metric = PassTuner.infidelity(node_errors={Node("q", 0): 0.1})
+    assert metric(Circuit(1).H(0)) == pytest.approx(0.1)
+
+
+def test_fast_compile_pass() -> None:
+    arc = Architecture([(Node(i), Node(i + 1)) for i in range(5)])
+    c = Circuit(6).H(0).CX(0, 5).CX(1, 4).Rz(0.3, 4).CCX(0, 2, 5).CX(3, 0)
+    cu = CompilationUnit(c)
+    assert FastCompilePass(arc).apply(cu)
+    assert ConnectivityPredicate(arc).verify(cu.circuit)
+    assert GateSetPredicate({OpType.CX, OpType.TK1}).verify(cu.circuit)
+    p = FastCompilePass(arc, routing_timeout=0)
+    assert BasePass.from_dict(p.to_dict()).to_dict() == p.to_dict()
+
+
+def test_compilation_unit_bytes() -> None:
+    c = Circuit(2).H(0).CX(0, 1).Rz(0.3, 1)
+    cu = CompilationUnit(c, [GateSetPredicate({OpType.CX, OpType.TK1})])
+    RebaseTket().apply(cu)
+    loaded = CompilationUnit.from_bytes(cu.to_bytes())
+    assert loaded.circuit == cu.circuit
+    assert loaded.initial_map == cu.initial_map
+    assert loaded.final_map == cu.final_map
+    p = BasePass.from_bytes(SynthesiseTket().to_bytes())
+    assert p.to_dict() == SynthesiseTket().to_dict()
+    p.apply(loaded)
+    SynthesiseTket().apply(cu)
+    assert loaded.circuit == cu.circuit
+    assert loaded.check_all_predicates()
+
+
+def test_apply_from_threads() -> None:
+    # Passes run with the GIL released, calling back into Python as needed
+    def add_x(c: Circuit) -> Circuit:
+        return c.copy().X(0)
+
+    seq = SequencePass([CustomPass(add_x), FullPeepholeOptimise()])
+    arc = Architecture([(0, 1), (1, 2), (2, 3)])
+    placer = GraphPlacement(arc)
+    names: List[List[str]] = [[] for _ in range(8)]
+
+    def compile_one(i: int) -> Circuit:
+        def before(cu: CompilationUnit, config: Dict[str, Any]) -> None:
+            if "StandardPass" in config:
+                names[i].append(config["StandardPass"]["name"])
+
+        c = Circuit(3).H(0).CX(0, 1).Rz(0.1 * i, 1).CX(1, 2)
+        seq.apply(c, before, lambda cu, config: None)
+        placer.place(c)
+        return c
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        results = list(pool.map(compile_one, range(8)))
+    for i, c in enumerate(results):
+        expected = Circuit(3).H(0).CX(0, 1).Rz(0.1 * i, 1).CX(1, 2)
+        seq.apply(expected)
+        placer.place(expected)
+        assert c == expected
+        assert "CustomPass" in names[i]
+
+
 if __name__ == "__main__":
     test_predicate_generation()
     test_compilation_unit_generation()
@@ -991,6 +1190,15 @@ if __name__ == "__main__":
     test_user_defined_swap_decomp()
     test_squash_chains()
     test_apply_pass_with_callbacks()
+    test_apply_batch()
+    test_cached_pass()
+    test_pass_profiler()
+    test_compilation_timeout()
+    test_fused_sequence_pass()
+    test_pass_tuner()
+    test_fast_compile_pass()
+    test_compilation_unit_bytes()
+    test_apply_from_threads()
     test_remove_barriers()
     test_RebaseOQC_and_SynthesiseOQC()
     test_ZZPhaseToRz()
@@ -13,7 +13,9 @@
 # limitations under the License.
 
 import pytest
-from pytket.circuit import Circuit, CircBox, QControlBox, Op, OpType
+from pytket.circuit import Circuit, CircBox, QControlBox, Op, OpType, PauliExpBox
+from pytket.pauli import Pauli
+from concurrent.futures import ThreadPoolExecutor
 from enum import Enum
 import numpy as np
 import math
@@ -270,6 +272,26 @@ def test_boxes() -> None:
     assert np.isclose(s[0], 1.0)
 
 
+def test_concurrent_unitaries() -> None:
+    # The GIL is released while simulating, so these run at the same time.
+    circs = []
+    for i in range(16):
+        c = Circuit(6)
+        for q in range(6):
+            c.Rx(0.1 * (i + q), q)
+        c.CCX(i % 6, (i + 1) % 6, (i + 3) % 6)
+        c.add_pauliexpbox(
+            PauliExpBox([Pauli.X, Pauli.Y, Pauli.Z], 0.05 * i), [0, 2, 4]
+        )
+        c.CX(5, 1)
+        circs.append(c)
+    expected = [c.get_unitary() for c in circs]
+    with ThreadPoolExecutor(max_workers=8) as executor:
+        results = list(executor.map(lambda c: c.get_unitary(), circs * 4))
+    for k, u in enumerate(results):
+        assert np.array_equal(u, expected[k % len(circs)])
+
+
 if __name__ == "__main__":
     test_premultiplication()
     test_circuit_unitaries_homomorphism_property()
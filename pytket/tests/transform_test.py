@@ -22,6 +22,7 @@ from pytket.circuit import (
     Circuit,
     OpType,
     CircBox,
+    ConjugationBox,
     Unitary1qBox,
     PauliExpBox,
     Node,
@@ -414,6 +415,24 @@ def test_while_repeat() -> None:
     assert c.n_gates_of_type(OpType.Rx) == 0
 
 
+def test_conjugation_actions() -> None:
+    compute = Circuit(2).CX(0, 1).CX(0, 1)
+    action = Circuit(2).H(0).H(0).Rz(0.5, 1)
+    box = ConjugationBox(CircBox(compute), CircBox(action))
+    c = Circuit(2)
+    c.add_conjugation_box(box, [Qubit(0), Qubit(1)])
+    assert Transform.conjugation_actions(Transform.RemoveRedundancies()).apply(c)
+    cmds = c.get_commands()
+    assert len(cmds) == 1
+    new_box = cmds[0].op
+    assert isinstance(new_box, ConjugationBox)
+    assert new_box.get_compute() == box.get_compute()
+    new_action = new_box.get_action()
+    assert isinstance(new_action, CircBox)
+    assert new_action.get_circuit().n_gates == 1
+    assert new_action.get_circuit().n_gates_of_type(OpType.Rz) == 1
+
+
 def test_pauli_graph_synth() -> None:
     strats = [
         PauliSynthStrat.Individual,
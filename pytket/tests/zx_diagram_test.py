@@ -27,6 +27,7 @@ from pytket.zx import (
     ZXGen,
     Rewrite,
     circuit_to_zx,
+    circuit_to_graphlike_zx,
     PhasedGen,
     CliffordGen,
     DirectedGen,
@@ -765,6 +766,29 @@ def test_converting_from_circuit() -> None:
     assert np.allclose(m * (1 / phase), np.eye(16))
 
 
+@pytest.mark.skipif(not have_quimb, reason="quimb not installed")
+def test_converting_to_graphlike() -> None:
+    c = Circuit(4)
+    c.CZ(0, 1)
+    c.CX(1, 2)
+    c.H(1)
+    c.X(0)
+    c.Rx(0.7, 0)
+    c.Rz(0.2, 1)
+    c.SWAP(1, 3)
+    c.H(2)
+    c.H(2)
+    c.T(3)
+    diag = circuit_to_graphlike_zx(c)
+    # Check the unitaries are equal up to a global phase
+    v = unitary_from_quantum_diagram(diag)
+    u = c.get_unitary()
+    m = v.dot(u.conj().T)
+    phase = m[0][0]
+    assert isclose(abs(phase), 1)
+    assert np.allclose(m * (1 / phase), np.eye(16))
+
+
 def test_constructors() -> None:
     phased_gen = PhasedGen(ZXType.ZSpider, 0.5, QuantumType.Quantum)
     assert phased_gen.param == 0.5
@@ -1054,6 +1078,7 @@ if __name__ == "__main__":
     test_spider_fusion()
     test_simplification()
     test_converting_from_circuit()
+    test_converting_to_graphlike()
     test_constructors()
     test_XY_extraction()
     test_XY_YZ_extraction()
@@ -0,0 +1,73 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include "Workloads.hpp"
+#include "tket/Circuit/Circuit.hpp"
+
+namespace tket {
+namespace bench {
+
+using namespace workloads;
+
+// Arguments are the number of qubits and the number of layers.
+
+static void BM_CircuitConstruction(benchmark::State& state) {
+  const unsigned n_qubits = state.range(0);
+  const unsigned n_layers = state.range(1);
+  for (auto _ : state) {
+    Circuit circ = random_layered_circuit(n_qubits, n_layers, 1);
+    benchmark::DoNotOptimize(circ);
+  }
+  state.SetComplexityN(state.range(0) * state.range(1));
+}
+BENCHMARK(BM_CircuitConstruction)
+    ->ArgsProduct({benchmark::CreateRange(8, 128, 4), {10, 100}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_CircuitCopy(benchmark::State& state) {
+  const Circuit circ =
+      random_layered_circuit(state.range(0), state.range(1), 1);
+  for (auto _ : state) {
+    Circuit copy(circ);
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetComplexityN(state.range(0) * state.range(1));
+}
+BENCHMARK(BM_CircuitCopy)
+    ->ArgsProduct({benchmark::CreateRange(8, 128, 4), {10, 100}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_CommandIterator(benchmark::State& state) {
+  const Circuit circ =
+      random_layered_circuit(state.range(0), state.range(1), 1);
+  for (auto _ : state) {
+    std::size_t n_args = 0;
+    for (const Command& com : circ) {
+      n_args += com.get_args().size();
+    }
+    benchmark::DoNotOptimize(n_args);
+  }
+  state.SetComplexityN(state.range(0) * state.range(1));
+}
+BENCHMARK(BM_CommandIterator)
+    ->ArgsProduct({benchmark::CreateRange(8, 128, 4), {10, 100}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace bench
+}  // namespace tket
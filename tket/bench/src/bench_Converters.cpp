@@ -0,0 +1,93 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include "Workloads.hpp"
+#include "tket/Clifford/UnitaryTableau.hpp"
+#include "tket/Converters/Converters.hpp"
+#include "tket/PauliGraph/PauliGraph.hpp"
+#include "tket/ZX/Rewrite.hpp"
+
+namespace tket {
+namespace bench {
+
+using namespace workloads;
+
+// Arguments are the number of qubits and the number of layers.
+static void BM_CircuitToPauliGraph(benchmark::State& state) {
+  const Circuit circ =
+      random_layered_circuit(state.range(0), state.range(1), 1);
+  for (auto _ : state) {
+    PauliGraph pg = circuit_to_pauli_graph(circ);
+    benchmark::DoNotOptimize(pg);
+  }
+  state.SetComplexityN(state.range(0) * state.range(1));
+}
+BENCHMARK(BM_CircuitToPauliGraph)
+    ->ArgsProduct({{4, 16, 64}, {10, 40}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of qubits and the number of layers.
+static void BM_ReduceGraphlikeForm(benchmark::State& state) {
+  const Circuit circ =
+      random_layered_circuit(state.range(0), state.range(1), 1);
+  for (auto _ : state) {
+    state.PauseTiming();
+    zx::ZXDiagram diag = circuit_to_zx(circ).first;
+    zx::Rewrite::to_graphlike_form().apply(diag);
+    state.ResumeTiming();
+    zx::Rewrite::reduce_graphlike_form().apply(diag);
+    benchmark::DoNotOptimize(diag);
+  }
+  state.SetComplexityN(state.range(0) * state.range(1));
+}
+BENCHMARK(BM_ReduceGraphlikeForm)
+    ->ArgsProduct({{4, 16, 64}, {10, 40}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of qubits and the number of gates.
+static void BM_CircuitToUnitaryTableau(benchmark::State& state) {
+  const Circuit circ =
+      random_clifford_circuit(state.range(0), state.range(1), 1);
+  for (auto _ : state) {
+    UnitaryTableau tab = circuit_to_unitary_tableau(circ);
+    benchmark::DoNotOptimize(tab);
+  }
+  state.SetComplexityN(state.range(1));
+}
+BENCHMARK(BM_CircuitToUnitaryTableau)
+    ->ArgsProduct({{16, 64, 256}, {1000, 10000}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of qubits and the number of gates.
+static void BM_UnitaryTableauToCircuit(benchmark::State& state) {
+  const UnitaryTableau tab = circuit_to_unitary_tableau(
+      random_clifford_circuit(state.range(0), state.range(1), 1));
+  for (auto _ : state) {
+    Circuit circ = unitary_tableau_to_circuit(tab);
+    benchmark::DoNotOptimize(circ);
+  }
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_UnitaryTableauToCircuit)
+    ->ArgsProduct({{16, 64, 256}, {1000}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace bench
+}  // namespace tket
@@ -0,0 +1,86 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "Workloads.hpp"
+#include "tket/Architecture/Architecture.hpp"
+#include "tket/Mapping/LexiLabelling.hpp"
+#include "tket/Mapping/LexiRouteRoutingMethod.hpp"
+#include "tket/Mapping/MappingManager.hpp"
+#include "tket/Placement/Placement.hpp"
+
+namespace tket {
+namespace bench {
+
+using namespace workloads;
+
+// Route a random circuit with one qubit per node of the architecture.
+static void route_with_lexiroute(
+    benchmark::State& state, const ArchitecturePtr& arc, unsigned n_layers) {
+  const Circuit circ = random_layered_circuit(arc->n_nodes(), n_layers, 1);
+  const MappingManager mm(arc);
+  const std::vector<RoutingMethodPtr> methods = {
+      std::make_shared<LexiLabellingMethod>(),
+      std::make_shared<LexiRouteRoutingMethod>()};
+  for (auto _ : state) {
+    state.PauseTiming();
+    Circuit copy(circ);
+    state.ResumeTiming();
+    mm.route_circuit(copy, methods);
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetComplexityN(arc->n_nodes() * n_layers);
+}
+
+// Arguments are the side of the grid and the number of layers.
+static void BM_LexiRouteSquareGrid(benchmark::State& state) {
+  route_with_lexiroute(
+      state,
+      std::make_shared<SquareGrid>(state.range(0), state.range(0)),
+      state.range(1));
+}
+BENCHMARK(BM_LexiRouteSquareGrid)
+    ->ArgsProduct({{3, 5, 7, 10}, {10, 50}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of nodes and the number of layers.
+static void BM_LexiRouteRingArch(benchmark::State& state) {
+  route_with_lexiroute(
+      state, std::make_shared<RingArch>(state.range(0)), state.range(1));
+}
+BENCHMARK(BM_LexiRouteRingArch)
+    ->ArgsProduct({{8, 16, 32, 64}, {10, 50}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the side of the grid and the number of layers.
+static void BM_GraphPlacement(benchmark::State& state) {
+  const SquareGrid arc(state.range(0), state.range(0));
+  const Circuit circ = random_layered_circuit(arc.n_nodes(), state.range(1), 1);
+  const GraphPlacement placement(arc);
+  for (auto _ : state) {
+    std::map<Qubit, Node> map = placement.get_placement_map(circ);
+    benchmark::DoNotOptimize(map);
+  }
+}
+BENCHMARK(BM_GraphPlacement)
+    ->ArgsProduct({{3, 5, 7}, {5, 20}})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace bench
+}  // namespace tket
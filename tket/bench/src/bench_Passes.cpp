@@ -0,0 +1,86 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include "Workloads.hpp"
+#include "tket/Architecture/Architecture.hpp"
+#include "tket/Predicates/CompilationUnit.hpp"
+#include "tket/Predicates/PassGenerators.hpp"
+#include "tket/Predicates/PassLibrary.hpp"
+
+namespace tket {
+namespace bench {
+
+using namespace workloads;
+
+// Arguments are the number of qubits and the number of layers.
+
+static void BM_FullPeepholeOptimise(benchmark::State& state) {
+  const Circuit circ =
+      random_layered_circuit(state.range(0), state.range(1), 1);
+  const PassPtr pass = FullPeepholeOptimise();
+  for (auto _ : state) {
+    state.PauseTiming();
+    CompilationUnit cu(circ);
+    state.ResumeTiming();
+    pass->apply(cu);
+    benchmark::DoNotOptimize(cu);
+  }
+  state.SetComplexityN(state.range(0) * state.range(1));
+}
+BENCHMARK(BM_FullPeepholeOptimise)
+    ->ArgsProduct({{4, 8, 16}, {10, 40}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+// Compile random Clifford+T circuits on 100 qubits to a 10x10 grid. The
+// argument is the number of gates.
+
+static void compile_to_grid(benchmark::State& state, const PassPtr& pass) {
+  const Circuit circ = random_clifford_t_circuit(100, state.range(0), 20, 1);
+  for (auto _ : state) {
+    state.PauseTiming();
+    CompilationUnit cu(circ);
+    state.ResumeTiming();
+    pass->apply(cu);
+    benchmark::DoNotOptimize(cu);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+// Interactive use needs this under 10 ms for 1000 gates.
+static void BM_FastCompile(benchmark::State& state) {
+  compile_to_grid(state, gen_fast_compile_pass(SquareGrid(10, 10)));
+}
+BENCHMARK(BM_FastCompile)
+    ->RangeMultiplier(4)
+    ->Range(250, 16000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+// The default pipeline, for comparison.
+static void BM_DefaultMappingSynthesiseTket(benchmark::State& state) {
+  compile_to_grid(
+      state,
+      gen_default_mapping_pass(SquareGrid(10, 10), false) >> SynthesiseTket());
+}
+BENCHMARK(BM_DefaultMappingSynthesiseTket)
+    ->RangeMultiplier(4)
+    ->Range(250, 4000)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace bench
+}  // namespace tket
@@ -0,0 +1,41 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include "Workloads.hpp"
+#include "tket/Circuit/Simulation/CircuitSimulator.hpp"
+
+namespace tket {
+namespace bench {
+
+using namespace workloads;
+
+// Arguments are the number of qubits and the number of layers.
+static void BM_GetStatevector(benchmark::State& state) {
+  const Circuit circ =
+      random_layered_circuit(state.range(0), state.range(1), 1);
+  for (auto _ : state) {
+    StateVector sv = tket_sim::get_statevector(circ);
+    benchmark::DoNotOptimize(sv);
+  }
+  state.SetComplexityN(state.range(1) << state.range(0));
+}
+BENCHMARK(BM_GetStatevector)
+    ->ArgsProduct({benchmark::CreateDenseRange(4, 16, 4), {10}})
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace bench
+}  // namespace tket
@@ -0,0 +1,136 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include "Workloads.hpp"
+#include "tket/Predicates/CompilationUnit.hpp"
+#include "tket/Predicates/PassGenerators.hpp"
+#include "tket/Predicates/PassLibrary.hpp"
+
+namespace tket {
+namespace bench {
+
+using namespace workloads;
+
+// Large workloads: these reach thousands of qubits and millions of gates,
+// so each runs for a single iteration.
+
+static void apply_pass(
+    benchmark::State& state, const Circuit& circ, const PassPtr& pass) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    CompilationUnit cu(circ);
+    state.ResumeTiming();
+    pass->apply(cu);
+    benchmark::DoNotOptimize(cu);
+  }
+  state.counters["gates"] = circ.n_gates();
+}
+
+// Arguments are the number of qubits and the number of gates.
+static void BM_GenerateCliffordT(benchmark::State& state) {
+  for (auto _ : state) {
+    Circuit circ =
+        random_clifford_t_circuit(state.range(0), state.range(1), 20, 1);
+    benchmark::DoNotOptimize(circ);
+  }
+  state.SetComplexityN(state.range(1));
+}
+BENCHMARK(BM_GenerateCliffordT)
+    ->ArgsProduct({{1024, 4096}, benchmark::CreateRange(1 << 14, 1 << 20, 8)})
+    ->Complexity()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of qubits and the number of gates.
+static void BM_RemoveRedundanciesCliffordT(benchmark::State& state) {
+  const Circuit circ =
+      random_clifford_t_circuit(state.range(0), state.range(1), 20, 1);
+  apply_pass(state, circ, RemoveRedundancies());
+  state.SetComplexityN(state.range(1));
+}
+BENCHMARK(BM_RemoveRedundanciesCliffordT)
+    ->ArgsProduct({{1024}, benchmark::CreateRange(1 << 14, 1 << 20, 8)})
+    ->Complexity()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of nodes and the number of edges per node.
+static void BM_SynthesiseTketQAOA(benchmark::State& state) {
+  const Circuit circ =
+      qaoa_circuit(state.range(0), state.range(0) * state.range(1), 4, 1);
+  apply_pass(state, circ, SynthesiseTket());
+  state.SetComplexityN(state.range(0) * state.range(1));
+}
+BENCHMARK(BM_SynthesiseTketQAOA)
+    ->ArgsProduct({benchmark::CreateRange(64, 4096, 4), {3, 8}})
+    ->Complexity()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of qubits and the number of terms.
+static void BM_DecomposeBoxesTrotter(benchmark::State& state) {
+  const Circuit circ =
+      trotter_circuit(state.range(0), state.range(1), 4, 4, 1, true);
+  apply_pass(state, circ, DecomposeBoxes());
+  state.SetComplexityN(state.range(1));
+}
+BENCHMARK(BM_DecomposeBoxesTrotter)
+    ->ArgsProduct({{1024}, benchmark::CreateRange(1 << 10, 1 << 16, 8)})
+    ->Complexity()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of qubits and the number of terms.
+static void BM_CliffordSimpTrotter(benchmark::State& state) {
+  const Circuit circ =
+      trotter_circuit(state.range(0), state.range(1), 4, 4, 1);
+  apply_pass(state, circ, gen_clifford_simp_pass());
+  state.SetComplexityN(state.range(1));
+}
+BENCHMARK(BM_CliffordSimpTrotter)
+    ->ArgsProduct({{1024}, benchmark::CreateRange(1 << 10, 1 << 14, 4)})
+    ->Complexity()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Arguments are the number of qubits and the maximum CU1 distance.
+static void BM_DecomposeMultiQubitsCXQFT(benchmark::State& state) {
+  const Circuit circ = qft_circuit(state.range(0), state.range(1));
+  apply_pass(state, circ, DecomposeMultiQubitsCX());
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_DecomposeMultiQubitsCXQFT)
+    ->ArgsProduct({benchmark::CreateRange(256, 4096, 4), {16, 64}})
+    ->Complexity()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+// Argument is the number of bits in each summand.
+static void BM_DecomposeArbitrarilyControlledGatesAdder(
+    benchmark::State& state) {
+  const Circuit circ = adder_circuit(state.range(0));
+  apply_pass(state, circ, DecomposeArbitrarilyControlledGates());
+  state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_DecomposeArbitrarilyControlledGatesAdder)
+    ->RangeMultiplier(4)
+    ->Range(256, 1 << 14)
+    ->Complexity()
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace bench
+}  // namespace tket
@@ -23,7 +23,7 @@ from conan.errors import ConanInvalidConfiguration
 
 class TketConan(ConanFile):
     name = "tket"
-    version = "1.2.71"
+    version = "1.2.221"
     package_type = "library"
     license = "Apache 2"
     homepage = "https://github.com/CQCL/tket"
@@ -35,16 +35,22 @@ class TketConan(ConanFile):
         "shared": [True, False],
         "fPIC": [True, False],
         "profile_coverage": [True, False],
+        "trace": [True, False],
+        "track_allocations": [True, False],
         "with_test": [True, False],
         "with_proptest": [True, False],
+        "with_bench": [True, False],
         "with_all_tests": [True, False],
     }
     default_options = {
         "shared": False,
         "fPIC": True,
         "profile_coverage": False,
+        "trace": False,
+        "track_allocations": False,
         "with_test": False,
         "with_proptest": False,
+        "with_bench": False,
         "with_all_tests": False,
     }
     exports_sources = (
@@ -54,6 +60,8 @@ class TketConan(ConanFile):
         "include/*",
         "test/*",
         "proptest/*",
+        "bench/*",
+        "workloads/*",
     )
 
     def config_options(self):
@@ -74,6 +82,8 @@ class TketConan(ConanFile):
         deps.generate()
         tc = CMakeToolchain(self)
         tc.variables["PROFILE_COVERAGE"] = self.options.profile_coverage
+        tc.variables["TKET_TRACE"] = self.options.trace
+        tc.variables["TKET_TRACK_ALLOCATIONS"] = self.options.track_allocations
         if self.build_test():
             tc.variables["BUILD_TKET_TEST"] = True
             architectures_dir = os.path.join(
@@ -84,6 +94,8 @@ class TketConan(ConanFile):
             copy(self, "*.json", circuits_dir, self.build_folder)
         if self.build_proptest():
             tc.variables["BUILD_TKET_PROPTEST"] = True
+        if self.options.with_bench:
+            tc.variables["BUILD_TKET_BENCH"] = True
         tc.generate()
 
     def validate(self):
@@ -107,6 +119,10 @@ class TketConan(ConanFile):
 
     def package_info(self):
         self.cpp_info.libs = ["tket"]
+        if self.options.trace:
+            self.cpp_info.defines = ["TKET_TRACE"]
+        if self.settings.os in ["Linux", "FreeBSD"]:
+            self.cpp_info.system_libs = ["pthread"]
 
     def requirements(self):
         # libraries installed from remote:
@@ -115,15 +131,17 @@ class TketConan(ConanFile):
         self.requires("symengine/0.11.1", transitive_headers=True)
         self.requires("eigen/3.4.0", transitive_headers=True)
         self.requires("nlohmann_json/3.11.3", transitive_headers=True)
-        self.requires("tklog/0.3.3@tket/stable")
-        self.requires("tkassert/0.3.4@tket/stable", transitive_headers=True)
-        self.requires("tkrng/0.3.3@tket/stable")
-        self.requires("tktokenswap/0.3.6@tket/stable")
-        self.requires("tkwsm/0.3.6@tket/stable")
+        self.requires("tklog/0.3.4@tket/stable")
+        self.requires("tkassert/0.3.5@tket/stable", transitive_headers=True)
+        self.requires("tkrng/0.3.4@tket/stable")
+        self.requires("tktokenswap/0.3.11@tket/stable")
+        self.requires("tkwsm/0.3.15@tket/stable")
         if self.build_test():
             self.test_requires("catch2/3.3.2")
         if self.build_proptest():
             self.test_requires("rapidcheck/cci.20220514")
+        if self.options.with_bench:
+            self.test_requires("benchmark/1.8.3")
 
     def build_test(self):
         return self.options.with_test or self.options.with_all_tests
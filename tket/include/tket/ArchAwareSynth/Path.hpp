@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <optional>
+#include <vector>
+
 #include "tket/Architecture/Architecture.hpp"
 #include "tket/Placement/Placement.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
@@ -136,6 +139,13 @@ class IterationOrder {
  * a connection in either direction even if only one direction is specified in
  * the architecture.
  *
+ * Paths found are cached per architecture (by nodes and connectivity), so
+ * repeated calls for the same device are cheap. Otherwise, architectures
+ * which obviously have no path (disconnected, or with more than two nodes of
+ * degree one) are rejected at once; then find_hampath_heuristic is tried,
+ * and only if that fails is the exhaustive search (which may use the whole
+ * timeout) run.
+ *
  * @param arch architecture where the path is searched
  * @param timeout give the timeout for the search of the hamiltonpath,
  *                  default value is 10000
@@ -144,5 +154,24 @@ class IterationOrder {
  */
 std::vector<Node> find_hampath(const Architecture &arch, long timeout = 10000);
 
+/**
+ * Search for a Hamiltonian path constructively, from several starting nodes.
+ * Each attempt walks depth-first, always moving to the unvisited neighbour
+ * with the fewest unvisited neighbours (Warnsdorff's rule); when it gets
+ * stuck, the path is rotated (reversing the part after some neighbour of the
+ * end node) to obtain a new end node from which to continue.
+ * This is fast, but may fail even if a path exists. The result does not
+ * depend on the number of threads.
+ *
+ * @param arch architecture where the path is searched
+ * @param n_attempts number of starting nodes to try (the first is a node
+ *   of minimum degree, the rest random)
+ * @param n_threads number of threads to divide the attempts between; 0 means
+ *   as many as the hardware supports
+ * @return ordered vector of nodes in the path, or nullopt if none was found
+ */
+std::optional<std::vector<Node>> find_hampath_heuristic(
+    const Architecture &arch, unsigned n_attempts = 64, unsigned n_threads = 0);
+
 }  // namespace aas
 }  // namespace tket
@@ -104,7 +104,10 @@ class SteinerForest {
 };
 
 /**
- * searches for the best operation in the given forest
+ * searches for the best operation in the given forest. The candidate
+ * operations are evaluated in parallel when lookahead > 1, and the search
+ * memoises the states of the forest it reaches, so that a state reached by
+ * several sequences of operations is searched once.
  * @param path pathhandler used for the calculation
  * @param forest steinerforest used for the calculation
  * @param lookahead maximum steps of recursion used for the iteration
@@ -121,7 +124,7 @@ CostedOperations best_operations_lookahead(
  * @param row_operations operations which are executed before the search starts
  */
 CostedOperations recursive_operation_search(
-    const PathHandler &path, SteinerForest forest, unsigned lookahead,
+    const PathHandler &path, const SteinerForest &forest, unsigned lookahead,
     OperationList row_operations);
 
 /**
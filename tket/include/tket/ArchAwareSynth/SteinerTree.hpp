@@ -15,6 +15,7 @@
 #pragma once
 #include "Path.hpp"
 #include "tket/Converters/Gauss.hpp"
+#include "tket/Utils/PauliTensor.hpp"
 
 namespace tket {
 namespace aas {
@@ -213,5 +214,38 @@ Circuit aas_CNOT_synth(
  */
 Circuit aas_CNOT_synth_SWAP(DiagMatrix &CNOT_matrix, const PathHandler &paths);
 
+/**
+ * Synthesises Pauli gadgets on the nodes of an architecture. The parity of
+ * each gadget is computed along a Steiner tree over its support, so every CX
+ * acts on a pair of connected nodes and the result needs no routing.
+ */
+class SteinerGadgetSynth {
+ public:
+  /**
+   * Prepare the distances between the nodes of an architecture, treating
+   * its connectivity as undirected.
+   * @param arch architecture whose nodes the gadgets act on
+   */
+  explicit SteinerGadgetSynth(const Architecture &arch);
+
+  /**
+   * Append a Pauli gadget to a circuit. Nodes that the Steiner tree passes
+   * through outside the support of the gadget are added to the circuit as
+   * qubits if they are not already present, and are returned to their
+   * original state.
+   * @param circ circuit whose qubits are nodes of the architecture
+   * @param paulis Pauli operators on nodes of the architecture; coefficient
+   * gives rotation angle in half-turns
+   * @throws CircuitInvalidity if a Pauli acts on a qubit which is not a node
+   * of the architecture
+   */
+  void append_gadget(Circuit &circ, const SpSymPauliTensor &paulis) const;
+
+ private:
+  std::vector<Node> nodes_;
+  std::map<Qubit, unsigned> node_index_;
+  PathHandler paths_;
+};
+
 }  // namespace aas
 }  // namespace tket
@@ -15,7 +15,9 @@
 #pragma once
 
 #include <iostream>
+#include <memory>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <string>
 #include <tklog/TketLog.hpp>
@@ -129,14 +131,68 @@ class Architecture : public ArchitectureBase<graphs::DirectedGraph<Node>> {
    */
   MatrixXb get_connectivity() const;
 
+  /**
+   * Precompute distances, neighbours, diameter and articulation points, and
+   * make the architecture immutable.
+   *
+   * A frozen architecture is safe to share between threads, e.g. as the
+   * ArchitecturePtr of concurrent routing jobs, without copying it.
+   *
+   * @param n_threads number of threads for computing distances; 0 means as
+   *   many as the hardware supports
+   */
+  void freeze(unsigned n_threads = 0);
+
+  /**
+   * Freeze the architecture as @ref freeze does, but with data computed
+   * earlier (e.g. read from a file) instead of computing it.
+   *
+   * @param distances distances indexed by @ref get_node_index
+   * @param diameter the diameter, if known
+   * @param articulation_points nodes that cannot be removed without breaking
+   *   connectivity
+   */
+  void freeze_with(
+      std::shared_ptr<const graphs::DistanceMatrix> distances,
+      std::optional<unsigned> diameter, const node_set_t &articulation_points);
+
+  /** Make a frozen architecture modifiable again. */
+  void thaw();
+
+  /** The diameter, if it has been computed. */
+  std::optional<unsigned> get_known_diameter() const { return diameter_; }
+
+  /**
+   * Estimated bytes held by the architecture, including its cached distances
+   * (see tket/Utils/MemoryUsage.hpp).
+   */
+  std::size_t memory_usage() const;
+
  protected:
   // Returns node with least connectivity given some distance matrix.
   std::optional<Node> find_worst_node(const Architecture &orig_g);
+
+  // As above, given the current articulation points.
+  std::optional<Node> find_worst_node(
+      const Architecture &orig_g, const node_set_t &ap);
+
+ private:
+  // Set when frozen.
+  std::optional<node_set_t> articulation_points_;
 };
 
 JSON_DECL(Architecture::Connection)
 JSON_DECL(Architecture)
 
+/**
+ * Serialise an architecture together with its distances, diameter and
+ * articulation points, computed if it is not frozen.
+ *
+ * Loading the result gives a frozen architecture without computing them
+ * again.
+ */
+nlohmann::json architecture_to_json_with_precomputed(const Architecture &ar);
+
 class FullyConnected : public ArchitectureBase<graphs::CompleteGraph<Node>> {
  public:
   FullyConnected() : ArchitectureBase<graphs::CompleteGraph<Node>>() {}
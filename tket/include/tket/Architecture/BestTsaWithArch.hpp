@@ -14,9 +14,13 @@
 
 #pragma once
 
+#include <tkrng/RNG.hpp>
+#include <tktokenswap/RiverFlowPathFinder.hpp>
 #include <tktokenswap/VertexMappingFunctions.hpp>
 
 #include "ArchitectureMapping.hpp"
+#include "DistancesFromArchitecture.hpp"
+#include "NeighboursFromArchitecture.hpp"
 
 namespace tket {
 
@@ -38,6 +42,22 @@ struct BestTsaWithArch {
       SwapList& swaps, VertexMapping& vertex_mapping,
       const ArchitectureMapping& arch_mapping);
 
+  /** As above, but working purely with size_t vertices, using
+   * distances, neighbours and paths which may be reused between calls
+   * (so that anything they have cached need not be recalculated).
+   *  @param swaps The list of swaps to append to.
+   *  @param vertex_mapping The current desired mapping.
+   *  @param distances An object to calculate distances between vertices.
+   *  @param neighbours An object to calculate adjacent vertices.
+   *  @param path_finder An object to find paths, using the same distances
+   * and neighbours. It is reset before use, so that the result does not
+   * depend upon previous calls.
+   */
+  static void append_solution(
+      SwapList& swaps, VertexMapping& vertex_mapping,
+      DistancesInterface& distances, NeighboursInterface& neighbours,
+      tsa_internal::RiverFlowPathFinder& path_finder);
+
   /** This specifies desired source->target vertex mappings.
    *  Any nodes not occurring as a key might be moved by the algorithm.
    */
@@ -60,6 +80,90 @@ struct BestTsaWithArch {
    */
   static std::vector<std::pair<Node, Node>> get_swaps(
       const Architecture& architecture, const NodeMapping& node_mapping);
+
+  /** The solution of one problem in a batch, with some statistics. */
+  struct BatchResult {
+    /** The swaps, in the vertices of the ArchitectureMapping. */
+    std::vector<Swap> swaps;
+
+    /** The sum of the distances of each token from its target,
+     *  before any swaps.
+     */
+    std::size_t total_home_distance;
+
+    /** Each swap reduces the total home distance by at most 2,
+     *  so at least this many swaps are needed.
+     */
+    std::size_t swaps_lower_bound;
+
+    /** The time taken to solve this problem. */
+    double time_ms;
+  };
+
+  /** Solve many problems on the same architecture, e.g. one for every
+   * permutation in a calibration run. Each thread keeps its own distances,
+   * neighbours, path finder and TSA objects, which are reused for all the
+   * problems it takes, so cached data is calculated once per thread rather
+   * than once per problem. The problems are shared out dynamically, but each
+   * solution is the same as from append_solution alone, so the results do
+   * not depend upon the number of threads.
+   * The reading methods of an Architecture are only safe to call from
+   * several threads once it is frozen (see Architecture::freeze);
+   * otherwise, a single thread is used.
+   *  @param arch_mapping An ArchitectureMapping object, which knows the graph.
+   *  @param problems The desired vertex mappings; each is solved separately.
+   *  @param n_threads The maximum number of threads; 0 means as many as
+   * the hardware supports.
+   *  @return The results, in the same order as the problems.
+   */
+  static std::vector<BatchResult> solve_batch(
+      const ArchitectureMapping& arch_mapping,
+      const std::vector<VertexMapping>& problems, unsigned n_threads = 0);
+};
+
+/** For many token swapping problems on the same Architecture, e.g. one
+ * for every permutation during routing. The Node <-> vertex conversion,
+ * and the distances and neighbours cached during earlier problems,
+ * are reused rather than recalculated every time; the swaps returned
+ * are the same as those from BestTsaWithArch::get_swaps.
+ */
+class ReusableBestTsaWithArch {
+ public:
+  /** The Architecture must remain valid and unchanged
+   * for the lifetime of this object.
+   *  @param architecture The raw object containing the graph.
+   */
+  explicit ReusableBestTsaWithArch(const Architecture& architecture);
+
+  // The members refer to each other, so must not be copied.
+  ReusableBestTsaWithArch(const ReusableBestTsaWithArch&) = delete;
+  ReusableBestTsaWithArch& operator=(const ReusableBestTsaWithArch&) = delete;
+
+  /** For converting between Nodes and vertices, e.g. to set up
+   * a VertexMapping for append_solution.
+   */
+  const ArchitectureMapping& get_arch_mapping() const;
+
+  /** As BestTsaWithArch::append_solution, with the vertices given
+   * by get_arch_mapping().
+   *  @param swaps The list of swaps to append to.
+   *  @param vertex_mapping The current desired mapping.
+   */
+  void append_solution(SwapList& swaps, VertexMapping& vertex_mapping);
+
+  /** As BestTsaWithArch::get_swaps.
+   *  @param node_mapping The desired source->target node mapping.
+   *  @return The required list of node pairs to swap.
+   */
+  std::vector<std::pair<Node, Node>> get_swaps(
+      const BestTsaWithArch::NodeMapping& node_mapping);
+
+ private:
+  const ArchitectureMapping m_arch_mapping;
+  DistancesFromArchitecture m_distances;
+  NeighboursFromArchitecture m_neighbours;
+  RNG m_rng;
+  tsa_internal::RiverFlowPathFinder m_path_finder;
 };
 
 }  // namespace tket
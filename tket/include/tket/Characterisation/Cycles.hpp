@@ -81,6 +81,8 @@ struct CycleHistory {
   // history.size() == key always
   // Tracks which UnitID were in which Cycle
   std::vector<std::vector<UnitID>> history;
+  // Map from UnitID to the keys of every entry of history containing it
+  std::map<UnitID, std::set<unsigned>> uid_to_history_keys;
   // Map from UnitID to key, where key maps in key_to_cycle to "active" Cycle
   std::map<UnitID, unsigned> uid_to_key;
   // Map from key to cycle, where a key n refers to the nth cycle made
@@ -107,6 +109,11 @@ class CycleFinder {
   // In Edges to a new slice are checked for equality with the last boundary out
   // edge stored for their UnitID If equal a cycle may be extended, if not equal
   std::map<Edge, UnitID> cycle_out_edges;
+  // Inverse of cycle_out_edges
+  std::map<UnitID, Edge> uid_out_edges;
+
+  // UnitID of each Edge in the unit frontier of the current cut
+  std::map<Edge, UnitID> frontier_uids;
 
   // Stores data structures for tracking created Cycles and associated UnitID's
   CycleHistory cycle_history;
@@ -119,7 +126,7 @@ class CycleFinder {
   // Return type used to identify whether cycle should be merged with previous
   // cycles
   std::pair<unsigned, std::set<unsigned>> make_cycle(
-      const Vertex& v, const EdgeVec& out_edges, const CutFrontier& cut);
+      const Vertex& v, const EdgeVec& out_edges);
 
   // Uses CycleHistory to merge Cycle attributed to new_key with Cycles
   // attributed to old_keys Cycles are merged in to Cycle with smallest key
@@ -129,9 +136,15 @@ class CycleFinder {
   // UnitID should not be new, so error thrown if not found
   void update_cycle_out_edges(const UnitID& uid, const Edge& e);
 
-  // Getter for UnitID from unit_frontier_t in Cut
-  UnitID unitid_from_unit_frontier(
-      const std::shared_ptr<unit_frontier_t>& u_frontier, const Edge& e) const;
+  // Sets cycle_out_edges and uid_out_edges to the given unit frontier
+  void reset_cycle_out_edges(
+      const std::shared_ptr<unit_frontier_t>& u_frontier);
+
+  // Getter for UnitID of an Edge in the unit frontier of the current cut
+  UnitID unitid_from_unit_frontier(const Edge& e) const;
+
+  // Appends uid to cycle_history.history[key]
+  void add_to_history(unsigned key, const UnitID& uid);
 
   // if unsigned in erase_from is <= to_erase, removes from erase_from
   void erase_keys(
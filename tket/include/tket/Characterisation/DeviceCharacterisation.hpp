@@ -14,8 +14,12 @@
 
 #pragma once
 
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <vector>
 
 #include "ErrorTypes.hpp"
 #include "tket/Architecture/Architecture.hpp"
@@ -32,10 +36,15 @@
  * possible OpTypes) If an OpType-specific value is provided, this will be used.
  * If not it will fallback to the default value for the given Node or Node pair,
  * which itself falls back to zero error.
+ *
+ * Lookups go through a tket::CompiledCharacterisation, built once when the
+ * errors are set, which can also be used directly with dense node ids.
  */
 
 namespace tket {
 
+class CompiledCharacterisation;
+
 class DeviceCharacterisation {
  public:
   DeviceCharacterisation(
@@ -58,8 +67,12 @@ class DeviceCharacterisation {
   // readout errors
   readout_error_t get_readout_error(const Node& n) const;
 
+  // flat lookup tables for the errors
+  const CompiledCharacterisation& get_compiled() const { return *compiled_; }
+
   bool operator==(const DeviceCharacterisation& other) const;
 
+  friend class CompiledCharacterisation;
   friend void to_json(nlohmann::json& j, const DeviceCharacterisation& dc);
   friend void from_json(const nlohmann::json& j, DeviceCharacterisation& dc);
 
@@ -72,6 +85,74 @@ class DeviceCharacterisation {
   // OpType-specific errors per Node
   op_node_errors_t op_node_errors_;
   op_link_errors_t op_link_errors_;
+
+  // lookup tables built from the maps above, shared between copies
+  std::shared_ptr<const CompiledCharacterisation> compiled_;
+
+  void compile();
+};
+
+/**
+ * The errors of a DeviceCharacterisation in flat arrays, for O(1) lookup in
+ * inner loops.
+ *
+ * Every Node with an error is given a dense id, in Node order. Gate errors
+ * are stored per node and per link, with one column for the default error
+ * and one for each OpType with a specific error anywhere in the
+ * characterisation; a missing OpType-specific error is filled in with the
+ * default. Links are stored in compressed sparse rows by source node, so
+ * finding a link costs a binary search over the neighbours of one node.
+ *
+ * Errors for unknown nodes and links are zero, as in DeviceCharacterisation.
+ */
+class CompiledCharacterisation {
+ public:
+  explicit CompiledCharacterisation(const DeviceCharacterisation& dc);
+
+  // number of nodes with an id
+  unsigned n_nodes() const { return nodes_.size(); }
+  // id of a node, if it has any errors
+  std::optional<unsigned> node_id(const Node& n) const;
+  // node with the given id
+  const Node& get_node(unsigned id) const { return nodes_[id]; }
+
+  // single-qubit case
+  gate_error_t get_error(unsigned node) const {
+    return node_errors_[node * n_columns_];
+  }
+  gate_error_t get_error(unsigned node, OpType op) const {
+    return node_errors_[node * n_columns_ + column(op)];
+  }
+  // two-qubit case
+  gate_error_t get_error(unsigned node0, unsigned node1) const;
+  gate_error_t get_error(unsigned node0, unsigned node1, OpType op) const;
+  // readout errors
+  readout_error_t get_readout_error(unsigned node) const {
+    return readout_errors_[node];
+  }
+
+ private:
+  std::map<Node, unsigned> node_ids_;
+  std::vector<Node> nodes_;
+  // column of each OpType, indexed by OpType, 0 being the default column
+  std::vector<unsigned> op_columns_;
+  unsigned n_columns_;
+  // n_nodes() x n_columns_
+  std::vector<gate_error_t> node_errors_;
+  std::vector<readout_error_t> readout_errors_;
+  // links from node i are link_targets_[link_offsets_[i]:link_offsets_[i+1]],
+  // sorted by target
+  std::vector<unsigned> link_offsets_;
+  std::vector<unsigned> link_targets_;
+  // link_targets_.size() x n_columns_
+  std::vector<gate_error_t> link_errors_;
+
+  unsigned column(OpType op) const {
+    const std::size_t i = static_cast<std::size_t>(op);
+    return i < op_columns_.size() ? op_columns_[i] : 0;
+  }
+  // index of a link in link_targets_, if present
+  std::optional<unsigned> link_id(unsigned node0, unsigned node1) const;
 };
 
 JSON_DECL(DeviceCharacterisation)
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "tket/Characterisation/Cycles.hpp"
 #include "tket/Circuit/Circuit.hpp"
 
@@ -22,6 +24,64 @@ namespace tket {
 // Friend class for testing some private methods in FrameRandomisation
 class FrameRandomisationTester;
 
+// One instance of frame randomisation of a FrameTemplate: the OpType for each
+// frame slot, and the cycle gates to be replaced by their dagger
+struct FrameSample {
+  // One OpType for each slot, in the order of FrameTemplate slots
+  OpTypeVector slot_types;
+  // Indices of cycle gates (in the order of the cycles' commands) to dagger
+  std::vector<unsigned> daggered;
+
+  bool operator==(const FrameSample& other) const {
+    return slot_types == other.slot_types && daggered == other.daggered;
+  }
+};
+
+// A circuit prepared once for frame randomisation: its cycles are found and
+// a noop "slot" is wired into each cycle boundary edge. Samples are then
+// FrameSample, so that many can be drawn without a circuit for each, and
+// circuits are built from the template only when needed.
+// Slots are ordered by cycle; within a cycle the "in" frame slots come first,
+// then the "out" frame slots, each in the order of the cycle's qubits.
+class FrameTemplate {
+ public:
+  // Number of frame slots
+  unsigned n_slots() const { return slots_.size(); }
+  // Number of qubits in the frame of each cycle
+  const std::vector<unsigned>& get_frame_sizes() const { return frame_sizes_; }
+  // The cycles, with their frame slots
+  const std::vector<Cycle>& get_cycles() const { return cycles_; }
+
+  // Returns the circuit for sample
+  Circuit materialise(const FrameSample& sample);
+  // Calls f with the circuit for each of samples in turn, without copying
+  // the circuit: it is only valid during the call. E.g. f can serialise it
+  // with Circuit::to_binary.
+  void for_each_circuit(
+      const std::vector<FrameSample>& samples,
+      const std::function<void(const Circuit&)>& f);
+
+ private:
+  Circuit circuit_;
+  std::vector<Cycle> cycles_;
+  std::vector<unsigned> frame_sizes_;
+  std::vector<Vertex> slots_;
+  // Vertices of the gates of the cycles, and their ops
+  std::vector<Vertex> cycle_vertices_;
+  std::vector<Op_ptr> cycle_ops_;
+  std::map<Vertex, unsigned> cycle_vertex_index_;
+  // Daggers of cycle_ops_, computed when first needed
+  std::vector<Op_ptr> daggered_ops_;
+  std::map<OpType, Op_ptr> frame_ops_;
+
+  // Sets the slots and daggered gates of circuit_ to those of sample
+  void apply(const FrameSample& sample);
+  // Restores the gates daggered by apply
+  void restore(const FrameSample& sample);
+
+  friend class FrameRandomisation;
+};
+
 // FrameRandomisation provides methods for applying a circuit noise shaping
 // method 'Cycles' i.e. sub-circuits of a given circuit are found such that:
 // • every gate Op has a type in some allowed set of OpTypes (cycle_types_)
@@ -53,6 +113,26 @@ class FrameRandomisation {
   // Returns every combination of frame for every cycle in circ
   std::vector<Circuit> get_all_circuits(const Circuit& circ);
 
+  // Finds the cycles in circ and wires frame slots into their boundaries
+  FrameTemplate make_template(const Circuit& circ) const;
+  // Returns samples instances of frame randomisation for frame_template,
+  // without building their circuits
+  std::vector<FrameSample> sample_frames(
+      const FrameTemplate& frame_template, unsigned samples);
+  // Returns every combination of frame for every cycle in frame_template
+  std::vector<FrameSample> get_all_frames(const FrameTemplate& frame_template);
+
+  // Seeded, parallel versions of sample_randomisation_circuits and
+  // sample_frames, using n_threads threads (0 for one per hardware thread).
+  // Each sample draws from its own random stream, derived from seed and the
+  // index of the sample, so the samples depend on seed but not on n_threads.
+  std::vector<Circuit> sample_randomisation_circuits(
+      const Circuit& circ, unsigned samples, std::size_t seed,
+      unsigned n_threads = 0);
+  std::vector<FrameSample> sample_frames(
+      const FrameTemplate& frame_template, unsigned samples, std::size_t seed,
+      unsigned n_threads = 0);
+
   std::string to_string() const;
 
  protected:
@@ -84,6 +164,11 @@ class FrameRandomisation {
   std::vector<std::vector<OpTypeVector>> get_all_samples(
       const unsigned& samples, const std::vector<unsigned>& frame_sizes) const;
 
+  // Finds the out frames and daggered gates for the in frame of each cycle
+  FrameSample make_sample(
+      const FrameTemplate& frame_template,
+      const std::vector<OpTypeVector>& cycle_frames);
+
  private:
   // Returns new OpTypeVector "out_frame"
   // Sets "out_frame" equal to "in_frame"
@@ -141,6 +226,11 @@ class PowerCycle : public PauliFrameRandomisation {
   }
   std::vector<Circuit> sample_cycles(
       const Circuit& circ, unsigned cycle_repeats, unsigned samples);
+  // Seeded, parallel version of sample_cycles, reproducible for a given seed
+  // whatever n_threads, as for FrameRandomisation
+  std::vector<Circuit> sample_cycles(
+      const Circuit& circ, unsigned cycle_repeats, unsigned samples,
+      std::size_t seed, unsigned n_threads = 0);
 };
 
 // Friend class of FrameRandomisation for testing some private methods
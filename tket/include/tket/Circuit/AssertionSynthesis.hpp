@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <memory>
+#include <tuple>
+#include <vector>
+
 #include "Circuit.hpp"
 #include "tket/Utils/EigenConfig.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
@@ -32,6 +36,46 @@ namespace tket {
 std::tuple<Circuit, std::vector<bool>> projector_assertion_synthesis(
     const Eigen::MatrixXcd &P);
 
+/**
+ * An assertion circuit with all boxes decomposed, and its expected readouts.
+ */
+struct AssertionCircuit {
+  Circuit circ;
+  std::vector<bool> expected_readouts;
+};
+
+/**
+ * Synthesise an assertion circuit from a projector and decompose its boxes,
+ * reusing the result of an earlier call with the same projector if there is
+ * one.
+ *
+ * Results are cached process-wide, keyed by a hash of the projector's
+ * entries. Safe to call from several threads at once.
+ *
+ * @param P projector matrix in \ref BasisOrder::ilo
+ *
+ * @return shared, immutable synthesis result
+ */
+std::shared_ptr<const AssertionCircuit> cached_projector_assertion(
+    const Eigen::MatrixXcd &P);
+
+/**
+ * Synthesise assertion circuits for many projectors in parallel, as by
+ * \ref cached_projector_assertion.
+ *
+ * Filling the cache this way ahead of constructing many
+ * \ref ProjectorAssertionBox instances lets the boxes share the results.
+ *
+ * @param projectors projector matrices in \ref BasisOrder::ilo
+ * @param n_threads maximum number of threads, 0 to use the hardware
+ *   concurrency
+ *
+ * @return synthesis result for each projector
+ */
+std::vector<std::shared_ptr<const AssertionCircuit>>
+cached_projector_assertions(
+    const std::vector<Eigen::MatrixXcd> &projectors, unsigned n_threads = 0);
+
 /**
  * Synthesise an assertion circuit from a list of Paulis strings with +/-1
  * coefficients.
@@ -17,8 +17,12 @@
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
+#include <string>
+#include <utility>
 
 #include "tket/Circuit/Simulation/CircuitSimulator.hpp"
 #include "tket/OpType/OpTypeInfo.hpp"
@@ -64,11 +68,17 @@ class Box : public Op {
 
   static Op_ptr deserialize(const nlohmann::json &j);
 
-  /** Circuit represented by box */
-  std::shared_ptr<Circuit> to_circuit() const {
-    if (circ_ == nullptr) generate_circuit();
-    return circ_;
-  };
+  /** Includes the circuit, if it has been generated. */
+  std::size_t memory_usage() const override;
+
+  /**
+   * Circuit represented by box
+   *
+   * Safe to call from several threads at once on the same box (or on copies
+   * sharing its circuit), e.g. when circuits sharing ops are compiled in
+   * parallel: the circuit is generated on first use under a lock.
+   */
+  std::shared_ptr<Circuit> to_circuit() const;
 
   /**
    * If meaningful and implemented, return the numerical unitary matrix
@@ -83,7 +93,7 @@ class Box : public Op {
   Eigen::MatrixXcd get_unitary() const override {
     std::optional<Eigen::MatrixXcd> u = get_box_unitary();
     if (u.has_value()) {
-      return *u;
+      return std::move(*u);
     }
     return tket_sim::get_unitary(*to_circuit());
   }
@@ -101,6 +111,11 @@ class Box : public Op {
     return gen();
   }
   op_signature_t signature_;
+  /**
+   * Circuit represented by the box, generated on demand. Copies of a box
+   * share this circuit, so it must not be modified in place without first
+   * making a private copy.
+   */
   mutable std::shared_ptr<Circuit> circ_;
   boost::uuids::uuid id_;
 
@@ -128,6 +143,62 @@ Op_ptr set_box_id(BoxT &b, boost::uuids::uuid newid) {
   return std::make_shared<BoxT>(b);
 }
 
+/**
+ * A table of boxes keyed by id, shared by all the places a box occurs in a
+ * serialised circuit.
+ *
+ * While a writing table exists, each box serialised on the same thread is
+ * added to the table, once per id, and serialised as
+ * `{"type": ..., "box_ref": id}` in place of `{"type": ..., "box": ...}`.
+ * While a reading table exists, each such reference deserialised on the same
+ * thread is resolved from the table, so that all references to an id share
+ * one Op_ptr. Boxes nested inside boxes are referenced in the same way.
+ *
+ * Tables may be nested; the most recently created one is used.
+ */
+class BoxJsonTable {
+ public:
+  /** Start collecting the boxes serialised on this thread. */
+  BoxJsonTable();
+
+  /**
+   * Resolve the references deserialised on this thread from a table written
+   * by a writing instance. The table must outlive this object.
+   */
+  explicit BoxJsonTable(const nlohmann::json &table);
+
+  ~BoxJsonTable();
+  BoxJsonTable(const BoxJsonTable &) = delete;
+  BoxJsonTable &operator=(const BoxJsonTable &) = delete;
+
+  /** The table in use on this thread, if any. */
+  static BoxJsonTable *current();
+
+  /** The boxes collected so far, keyed by id. */
+  const nlohmann::json &get_table() const { return table_; }
+
+  /** Whether the table collects boxes rather than resolving references. */
+  bool is_writing() const { return entries_ == nullptr; }
+
+  /** Add a box to a writing table if not already present, returning its id. */
+  std::string add(const Op_ptr &box);
+
+  /**
+   * Resolve a reference from a reading table.
+   *
+   * @throws JsonError if the id is not in the table
+   */
+  Op_ptr get(const std::string &id);
+
+ private:
+  nlohmann::json table_;
+  const nlohmann::json *entries_;
+  std::map<std::string, Op_ptr> ops_;
+  // Ids being deserialised, to detect cyclic references
+  std::set<std::string> pending_;
+  BoxJsonTable *previous_;
+};
+
 /**
  * Operation defined as a circuit.
  */
@@ -158,6 +229,7 @@ class CircBox : public Box {
   void symbol_substitution_in_place(const symbol_map_t &sub_map);
 
   SymSet free_symbols() const override;
+  bool is_symbolic() const override { return to_circuit()->is_symbolic(); }
 
   /**
    * Equality check between two CircBox instances
@@ -519,6 +591,7 @@ class QControlBox : public Box {
       const SymEngine::map_basic_basic &sub_map) const override;
 
   SymSet free_symbols() const override;
+  bool is_symbolic() const override { return op_->is_symbolic(); }
 
   /**
    * Equality check between two QControlBox instances
@@ -499,6 +499,40 @@ Circuit CnX_normal_decomp(unsigned n);
 
 Circuit CnX_gray_decomp(unsigned n);
 
+/**
+ * @brief CnX gate using n-2 borrowed qubits in arbitrary states, which are
+ * returned to their initial states.
+ *
+ * Implements lemma 7.2 in https://arxiv.org/abs/quant-ph/9503016, with every
+ * Toffoli that does not act on the target replaced by
+ * CCX_modulo_phase_shift, whose phases cancel in pairs.
+ *
+ * Qubits 0 to n-1 are the controls, qubit n the target and qubits n+1 to
+ * 2n-2 the borrowed qubits.
+ *
+ * @param n number of controls, at least 3
+ * @return Circuit containing 12n-18 CX
+ * @throws ControlDecompError if n < 3
+ */
+Circuit CnX_vchain_decomp(unsigned n);
+
+/**
+ * @brief CnX gate with logarithmic depth using n-2 ancillae in the zero
+ * state, which are returned to the zero state.
+ *
+ * The conjunction of the controls is computed into the ancillae as a balanced
+ * tree of CCX_modulo_phase_shift gates, copied onto the target by a Toffoli,
+ * and uncomputed.
+ *
+ * Qubits 0 to n-1 are the controls, qubit n the target and qubits n+1 to
+ * 2n-2 the ancillae.
+ *
+ * @param n number of controls, at least 3
+ * @return Circuit containing 6n-6 CX
+ * @throws ControlDecompError if n < 3
+ */
+Circuit CnX_log_depth_decomp(unsigned n);
+
 Circuit CnRy_normal_decomp(const Op_ptr op, unsigned arity);
 
 /**
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <functional>
+#include <vector>
+
 #include "Circuit.hpp"
 #include "DAGDefs.hpp"
 #include "tket/Gate/GatePtr.hpp"
@@ -214,4 +217,22 @@ Circuit with_controls(const Circuit& c, unsigned n_controls = 1);
 std::tuple<Circuit, std::array<Expr, 3>, Circuit> normalise_TK2_angles(
     Expr a, Expr b, Expr c);
 
+/**
+ * Rewrite the numeric parameters of the gates of a circuit in bulk.
+ *
+ * The parameters of all gates (including conditional gates) that evaluate to
+ * numbers are gathered into one flat array, which `rewrite` updates in place.
+ * Symbolic parameters are not included. Each gate with a changed parameter
+ * is then replaced by a gate of the same type with the new values, keeping
+ * its unchanged parameters as they were, and gates with identical results
+ * share one op.
+ *
+ * @param circ circuit to rewrite
+ * @param rewrite function updating the array of parameters in place
+ * @return vertices whose ops were replaced
+ */
+VertexVec rewrite_numeric_params(
+    Circuit& circ,
+    const std::function<void(std::vector<double>&)>& rewrite);
+
 }  // namespace tket
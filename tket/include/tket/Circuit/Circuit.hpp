@@ -25,8 +25,10 @@
 // is ignored, and the amortized constant time used for scaling instead
 
 #include <algorithm>
+#include <cstdint>
 #include <exception>
 #include <functional>
+#include <istream>
 #include <list>
 #include <map>
 #include <memory>
@@ -218,9 +220,7 @@ class MissingEdge : public std::logic_error {
  public:
   explicit MissingEdge(const tket::Edge &edge)
       : std::logic_error("Edge missing") {
-    std::stringstream s;
-    s << edge;
-    tket_log()->info(s.str());
+    TKET_LOG_INFO(edge);
   }
   MissingEdge() : std::logic_error("unknown edge missing") {}
 };
@@ -246,6 +246,8 @@ enum ReverseType {
  * A circuit comprises some quantum and classical wires and a defined sequence
  * of operations on them with a defined global phase.
  */
+struct CircuitComponent;
+
 class Circuit {
   void _handle_boundaries(Circuit &circ, vertex_map_t &vmap) const;
   void _handle_interior(
@@ -392,6 +394,17 @@ class Circuit {
   // not including op_table merge: O(E+V+q), `E` edges, `V` vertices, `q` qubits
   Circuit(const Circuit &circ);
 
+  /**
+   * Move constructor.
+   *
+   * Takes over the DAG and boundary of \p circ without copying: vertex and
+   * edge descriptors of \p circ remain valid in the new circuit. \p circ is
+   * left empty.
+   *
+   * O(1)
+   */
+  Circuit(Circuit &&circ);
+
   /**
    * Constructor for an empty circuit with some given qubits/bits
    */
@@ -407,6 +420,9 @@ class Circuit {
   // copy assignment. Moves boundary pointers.
   Circuit &operator=(const Circuit &other);
 
+  // move assignment. Takes over the DAG, leaving `other` empty.
+  Circuit &operator=(Circuit &&other);
+
   /**
    * Run a suite of checks for internal circuit validity.
    *
@@ -1262,6 +1278,104 @@ class Circuit {
     return this->circuit_equality(other, {}, false);
   }
 
+  /**
+   * Equality check on canonical command lists.
+   *
+   * Checks the same attributes as @ref circuit_equality, except that the
+   * commands are compared in the order of @ref get_canonical_commands rather
+   * than @ref get_commands. Circuits whose DAGs differ only in the order in
+   * which commuting commands were added therefore compare equal. The hashes of
+   * the canonical forms are compared first, so most unequal circuits are
+   * rejected without comparing any ops.
+   *
+   * O(V log V + E)
+   */
+  bool canonical_equality(
+      const Circuit &other, const std::set<Check> &except = {}) const;
+
+  /** Whether @ref structural_hash takes parameter values into account */
+  enum class HashParams { Yes, No };
+
+  /**
+   * Hash of the circuit's structure.
+   *
+   * The hash is computed from the DAG in a single topological sweep: each
+   * vertex is hashed from its operation and the hashes and ports of its
+   * predecessors. It therefore does not depend on the order in which
+   * commuting gates on disjoint units were added, nor on the names of the
+   * units, only their positions in the boundary order. Boxes are hashed by
+   * the structure of the circuits they represent.
+   *
+   * With \p params set to HashParams::No, gate parameters, other op data and
+   * the global phase are ignored, so that circuits differing only in these
+   * hash equal. The circuit name is always ignored.
+   *
+   * Equal circuits have equal hashes; the converse holds with high
+   * probability. The value is stable across runs and platforms of the same
+   * word size.
+   *
+   * O(V + E)
+   */
+  std::size_t structural_hash(HashParams params = HashParams::Yes) const;
+
+  /**
+   * Compact binary serialisation, holding the same information as the JSON
+   * serialisation.
+   *
+   * Register names, opgroups and op types are written once each in tables,
+   * and units and distinct operations once each in further tables, so that
+   * each command is a short sequence of varint indices. Gates are stored
+   * directly; other operations, such as boxes, as the MessagePack encoding
+   * of their JSON. The format begins with a magic number and a version.
+   */
+  std::vector<std::uint8_t> to_binary() const;
+
+  /**
+   * Read a circuit written by @ref to_binary.
+   *
+   * @throws CircuitInvalidity if the data are not a valid binary circuit
+   */
+  static Circuit from_binary(const std::vector<std::uint8_t> &data);
+
+  /**
+   * Read a circuit written by @ref to_binary from a buffer, such as part of a
+   * memory-mapped file.
+   *
+   * @throws CircuitInvalidity if the data are not a valid binary circuit
+   */
+  static Circuit from_binary(const std::uint8_t *data, std::size_t size);
+
+  /**
+   * Read a circuit from a stream holding its JSON serialisation, without
+   * holding the whole document in memory.
+   *
+   * Each command is added to the circuit as soon as it has been read, so
+   * only one command at a time is held as JSON. Qubits, bits and WASM wires
+   * used by a command are added when first seen, so the keys of the object
+   * may be in any order, except that a box table (see
+   * circuit_to_json_with_box_table) must precede the commands.
+   *
+   * @throws JsonError if the stream does not hold a valid circuit
+   */
+  static Circuit from_json_stream(std::istream &in);
+
+  /**
+   * Read a circuit from a stream holding its JSON serialisation, passing
+   * each command to a callback instead of adding it to the circuit.
+   *
+   * This reads circuits too large to build: only one command at a time is
+   * held in memory.
+   *
+   * @param in stream holding the JSON serialisation of a circuit
+   * @param on_command called with each command, in order
+   * @return the circuit without its commands, but with its units, name,
+   *   phase, implicit permutation and created and discarded qubits
+   * @throws JsonError if the stream does not hold a valid circuit
+   */
+  static Circuit from_json_stream(
+      std::istream &in,
+      const std::function<void(const Command &)> &on_command);
+
   /** @brief Checks causal ordering of vertices
    *
    * @param target the target vertex
@@ -1309,6 +1423,36 @@ class Circuit {
       const Circuit &c2, const std::vector<unsigned> &qubits,
       const std::vector<unsigned> &bits = {});
 
+  /**
+   * Split the circuit into independent components.
+   *
+   * Two units are in the same component if some operation acts on both (with
+   * Boolean inputs counting as acting on a bit) or if an implicit wire swap
+   * connects them. Each component is returned as a circuit on the default
+   * registers, together with the map from its units to the original ones.
+   * Components are ordered by their first unit; units that are never acted
+   * on form components of their own. The global phase is carried by the
+   * first component, with any Phase ops folded into it; other ops without
+   * arguments are also added to the first component. A circuit without units
+   * has no components, so these are then dropped.
+   *
+   * @throws CircuitInvalidity if the circuit has WASM wires
+   */
+  std::vector<CircuitComponent> split_into_components() const;
+
+  /**
+   * Combine components, e.g. from @ref split_into_components, into a single
+   * circuit.
+   *
+   * The units of each component circuit are renamed according to its unit
+   * map (units not in the map keep their names), and the circuits are placed
+   * side by side. The resulting phase is the sum of the component phases.
+   *
+   * @throws Unsupported if the renamed components share a unit
+   */
+  static Circuit recombine_components(
+      const std::vector<CircuitComponent> &components);
+
   // O(E+V+q) -- E,V,q of c2
   friend Circuit operator*(const Circuit &c1, const Circuit &c2);
   // given two circuits, adds second circuit to first sequentially by tying
@@ -1521,6 +1665,9 @@ class Circuit {
    * Recursively replace each \ref Box operation by applying \ref
    * Box::to_circuit
    *
+   * Each distinct box is decomposed, with any boxes inside it, only once per
+   * call, and the result spliced in wherever the box occurs.
+   *
    * @param excluded_types box types excluded from decomposition
    * @param excluded_opgroups opgroups excluded from decomposition
    *
@@ -1570,6 +1717,43 @@ class Circuit {
    */
   std::vector<Command> get_commands() const;
 
+  /**
+   * Visit all commands of the circuit without constructing @ref Command
+   * objects.
+   *
+   * Commands are visited in a topological order, which need not be the
+   * order of @ref get_commands. Each command is passed as a @ref CommandView
+   * referring to storage owned by the circuit or by this call, so no heap
+   * allocation is performed per command. Suitable for read-only consumers
+   * that only need ops and arguments.
+   *
+   * O(V log V + E)
+   *
+   * @param visitor called for each command; returning false stops the visit
+   * @return false if the visit was stopped by \p visitor, true otherwise
+   */
+  bool visit_commands(
+      const std::function<bool(const CommandView &)> &visitor) const;
+
+  /**
+   * The commands of the circuit as flat arrays, in the order of
+   * @ref visit_commands.
+   *
+   * Builds only a handful of vectors, however many commands there are, for
+   * bulk export to array-based tools.
+   *
+   * O(V log V + E)
+   */
+  CommandColumns get_command_columns() const;
+
+  /**
+   * The commands of the circuit in a canonical topological order, with units
+   * interned as indices.
+   *
+   * O(V log V + E)
+   */
+  CanonicalCommands get_canonical_commands() const;
+
   /**
    * All vertices of the DAG.
    *
@@ -1637,14 +1821,74 @@ class Circuit {
   /**
    * Evaluate a classical circuit on given inputs.
    *
-   * The circuit must have only ClassicalTransform and SetBits operations. The
-   * keys of the input map must correspond to the bits of the circuit.
+   * The circuit must have only classical operations that can be evaluated
+   * (i.e. not WASM or ClassicalExpBox), possibly conditional on bits of the
+   * circuit. The keys of the input map must correspond to the bits of the
+   * circuit.
    *
    * @param values input values
    * @return output values
    */
   std::map<Bit, bool> classical_eval(const std::map<Bit, bool> &values) const;
 
+  /**
+   * Evaluate a classical circuit on many inputs at once.
+   *
+   * Each bit is given a vector of words, with bit k of word w holding its
+   * value in the (64w + k)th input, so that a single pass over the circuit
+   * evaluates 64 inputs per word using word-wise logic. All vectors must have
+   * the same length; bits of the circuit missing from the map are taken to be
+   * zero. The restrictions on operations are as for \ref classical_eval.
+   *
+   * @param values bit-sliced input values
+   * @return bit-sliced output values
+   */
+  std::map<Bit, std::vector<uint64_t>> classical_eval_sliced(
+      const std::map<Bit, std::vector<uint64_t>> &values) const;
+
+  /**
+   * A record of where the circuit has changed, so that properties known to
+   * hold before the changes need only be checked again where it changed.
+   *
+   * Each change is stamped with the number of changes recorded up to and
+   * including it.
+   */
+  struct ChangeLog {
+    /** Distinguishes the log from any other, including later logs */
+    std::size_t id;
+    /** Number of changes recorded */
+    std::size_t count = 0;
+    /** Stamp of the last change that may have affected every vertex */
+    std::size_t all = 0;
+    /** Stamp of the last change to the op of each vertex, or its addition */
+    std::map<Vertex, std::size_t> ops;
+    /** Stamp of the last change to the in-edges of each vertex */
+    std::map<Vertex, std::size_t> wires;
+  };
+
+  /**
+   * Start recording changes to the circuit, if not already doing so.
+   *
+   * The record is not copied with the circuit. Assigning to the circuit
+   * counts as a change to every vertex.
+   */
+  void record_changes();
+
+  /** Stop recording changes and discard the record. */
+  void stop_recording_changes();
+
+  /** The record of changes, or nullptr if changes are not being recorded. */
+  const ChangeLog *get_change_log() const { return change_log_.get(); }
+
+  /**
+   * Record changes to the circuit. These are called by the methods of the
+   * circuit; code that modifies @ref dag or @ref boundary directly must call
+   * them too.
+   */
+  void log_op_change(const Vertex &vert);
+  void log_wire_change(const Vertex &vert);
+  void log_all_changed();
+
   /* class members */
   // currently public (no bueno)
   DAG dag; /** Representation as directed graph */
@@ -1658,9 +1902,20 @@ class Circuit {
    * This takes account of the data stored in each \ref DummyBox within the
    * circuit, as well as other gates, to compute upper and lower bounds.
    *
+   * The bounds are accumulated in a single pass over the DAG in topological
+   * order, holding the depths at each vertex in a flat row indexed by OpType
+   * rather than in maps.
+   *
    * @return bounds on resources of the circuit
    */
-  ResourceData get_resources() /*const*/;
+  ResourceData get_resources() const;
+
+  /**
+   * Estimated bytes held by the circuit: its DAG nodes and edges, boundary
+   * and other containers, and each distinct operation once however many
+   * vertices share it (see tket/Utils/MemoryUsage.hpp).
+   */
+  std::size_t memory_usage() const;
 
  private:
   std::optional<std::string>
@@ -1669,10 +1924,35 @@ class Circuit {
 
   /** Signature associated with each named operation group */
   std::map<std::string, op_signature_t> opgroupsigs;
+
+  /** Record of changes, if they are being recorded */
+  std::unique_ptr<ChangeLog> change_log_;
+
+  // Forget a vertex that is about to be removed from the DAG
+  void log_removal(const Vertex &vert);
 };
 
 JSON_DECL(Circuit)
 
+/**
+ * Serialise a circuit to JSON with each distinct box written once.
+ *
+ * Boxes, including those nested inside other boxes, are collected in a
+ * top-level "boxes" object keyed by box id and referenced from operations by
+ * id (see BoxJsonTable). Deserialising the result with `from_json` gives one
+ * shared Op_ptr per box id. Circuits without boxes give the same JSON as
+ * `to_json`.
+ */
+nlohmann::json circuit_to_json_with_box_table(const Circuit &circ);
+
+/** An independent component of a circuit */
+struct CircuitComponent {
+  /** Component circuit */
+  Circuit circ;
+  /** Map from units of `circ` to units of the original circuit */
+  unit_map_t unit_map;
+};
+
 /** Templated method definitions */
 
 template <typename UnitA, typename UnitB>
@@ -1690,9 +1970,7 @@ bool Circuit::rename_units(const std::map<UnitA, UnitB> &qm) {
   for (const std::pair<const UnitA, UnitB> &pair : qm) {
     boundary_t::iterator found = boundary.get<TagID>().find(pair.first);
     if (found == boundary.get<TagID>().end()) {
-      std::stringstream ss;
-      ss << "unit " << pair.first.repr() << " not found in circuit";
-      tket_log()->warn(ss.str());
+      TKET_LOG_WARN("unit " << pair.first.repr() << " not found in circuit");
       continue;
     }
 
@@ -1726,6 +2004,8 @@ bool Circuit::rename_units(const std::map<UnitA, UnitB> &qm) {
     TKET_ASSERT(modified);
   }
 
+  if (modified) log_all_changed();
+
   // For every ClassicalExpBox, update its logic expressions
   if (!bm.empty()) {
     BGL_FORALL_VERTICES(v, dag, DAG) {
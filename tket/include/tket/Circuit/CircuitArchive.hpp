@@ -0,0 +1,104 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Circuit.hpp"
+
+namespace tket {
+
+/**
+ * A file holding many named circuits, each read only when asked for.
+ *
+ * The file is an index of names, sorted so that a name is found by binary
+ * search, followed by the circuits in the binary serialisation of
+ * Circuit::to_binary. Opening an archive maps the file into memory (or, where
+ * memory mapping is unavailable, reads it) and checks only the header, so
+ * it costs the same however many circuits the archive holds.
+ *
+ * An open archive is immutable and safe to read from several threads.
+ */
+class CircuitArchive {
+ public:
+  /**
+   * Write an archive.
+   *
+   * @param path file to write
+   * @param circuits circuits by name
+   * @throws std::runtime_error if the file cannot be written
+   */
+  static void write(
+      const std::string &path, const std::map<std::string, Circuit> &circuits);
+
+  /**
+   * Open an archive written by @ref write.
+   *
+   * @throws std::runtime_error if the file cannot be read
+   * @throws CircuitInvalidity if the file is not a circuit archive
+   */
+  explicit CircuitArchive(const std::string &path);
+
+  ~CircuitArchive();
+  CircuitArchive(const CircuitArchive &) = delete;
+  CircuitArchive &operator=(const CircuitArchive &) = delete;
+
+  /** Number of circuits. */
+  std::size_t size() const { return size_; }
+
+  /** Names of the circuits, in sorted order. */
+  std::vector<std::string> names() const;
+
+  /** Whether the archive holds a circuit with the given name. */
+  bool contains(const std::string &name) const;
+
+  /**
+   * Read a circuit.
+   *
+   * @throws std::out_of_range if there is no circuit with the given name
+   * @throws CircuitInvalidity if its data are invalid
+   */
+  Circuit get(const std::string &name) const;
+
+  /**
+   * Read a circuit by its position in the sorted order of names.
+   *
+   * @throws std::out_of_range if i is not less than @ref size
+   */
+  Circuit get(std::size_t i) const;
+
+ private:
+  struct Mapping;
+  std::unique_ptr<Mapping> mapping_;
+  const std::uint8_t *data_;
+  std::size_t file_size_;
+  std::size_t size_;
+
+  // Name and data of entry i, checked to lie within the file
+  std::string_view name(std::size_t i) const;
+  std::pair<const std::uint8_t *, std::size_t> circuit_data(
+      std::size_t i) const;
+  std::optional<std::size_t> find(const std::string &name) const;
+};
+
+}  // namespace tket
@@ -0,0 +1,123 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Circuit.hpp"
+
+namespace tket {
+
+/**
+ * Bulk construction of circuits on the default registers.
+ *
+ * Operations are recorded into flat buffers, without touching a circuit.
+ * @ref build then validates all of them in one pass and materialises the DAG
+ * directly, tracking the last vertex on each unit instead of looking units up
+ * in the boundary and rewiring output edges for every operation as
+ * `Circuit::add_op` does.
+ *
+ * Arguments are given as indices, interpreted according to the op signature
+ * as for `Circuit::add_op<unsigned>`: a Quantum argument `i` is `q[i]` and a
+ * Classical or Boolean argument `i` is `c[i]`.
+ */
+class CircuitBuilder {
+ public:
+  /**
+   * Start building a circuit on the default registers.
+   *
+   * @param n_qubits number of qubits
+   * @param n_bits number of bits
+   */
+  explicit CircuitBuilder(unsigned n_qubits, unsigned n_bits = 0);
+
+  /**
+   * Reserve storage for the operations to be added.
+   *
+   * @param n_ops number of operations
+   * @param n_args total number of arguments over all operations
+   */
+  void reserve(std::size_t n_ops, std::size_t n_args);
+
+  /**
+   * Record an operation.
+   *
+   * Arguments are not checked until @ref build.
+   */
+  void add_op(const Op_ptr &op, const std::vector<unsigned> &args);
+
+  /**
+   * Record a gate of a given type.
+   *
+   * @throws CircuitInvalidity if \p type is a meta-op or barrier
+   */
+  void add_op(
+      OpType type, const std::vector<Expr> &params,
+      const std::vector<unsigned> &args);
+
+  void add_op(OpType type, const std::vector<unsigned> &args) {
+    add_op(type, std::vector<Expr>{}, args);
+  }
+
+  /**
+   * Record a sequence of gates acting only on qubits, given as flat arrays
+   * with one row per gate.
+   *
+   * Gate `i` has type `types[i]`, acts on the first `k` entries of row `i` of
+   * the row-major matrix `qubits` with `qubit_width` columns, where `k` is
+   * the number of qubits of the type, and takes the first entries of row `i`
+   * of the row-major matrix `params` with `param_width` columns as its
+   * parameters in half-turns. Any further entries of a row are ignored.
+   * Gates without parameters share one Op_ptr per type. If any gate is
+   * rejected, none are recorded.
+   *
+   * @throws CircuitInvalidity if a type is a meta-op or barrier or does not
+   *   act on a fixed number of qubits and nothing else, if a row is too
+   *   narrow for its type, or if the matrices have the wrong size
+   */
+  void add_gates(
+      const std::vector<OpType> &types, const std::vector<unsigned> &qubits,
+      unsigned qubit_width, const std::vector<double> &params,
+      unsigned param_width);
+
+  /** Number of recorded operations */
+  std::size_t n_ops() const { return ops_.size(); }
+
+  /**
+   * Validate the recorded operations and construct the circuit.
+   *
+   * O(V + E)
+   *
+   * @throws CircuitInvalidity if an operation has the wrong number of
+   *   arguments, an argument out of range, a repeated non-Boolean argument,
+   *   or a WASM argument
+   */
+  Circuit build() const;
+
+ private:
+  unsigned n_qubits_;
+  unsigned n_bits_;
+  std::vector<Op_ptr> ops_;
+  std::vector<op_signature_t> sigs_;
+  // Arguments of all operations, concatenated; those of operation i are
+  // args_[arg_offsets_[i]] to args_[arg_offsets_[i + 1] - 1].
+  std::vector<unsigned> args_;
+  std::vector<std::size_t> arg_offsets_;
+
+  void validate() const;
+};
+
+}  // namespace tket
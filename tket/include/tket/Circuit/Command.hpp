@@ -14,10 +14,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <optional>
+#include <span>
 #include <sstream>
 #include <string>
 #include <tklog/TketLog.hpp>
+#include <vector>
 
 #include "DAGDefs.hpp"
 #include "tket/Ops/OpPtr.hpp"
@@ -91,4 +94,78 @@ class Command {
 
 JSON_DECL(Command)
 
+/**
+ * Non-owning view of a command, as passed to `Circuit::visit_commands`.
+ *
+ * Unlike @ref Command this refers to the operation and arguments held by the
+ * circuit instead of copying them. It is only valid for the duration of the
+ * visit.
+ */
+struct CommandView {
+  /** Operation */
+  const Op_ptr &op;
+  /** Arguments, indexed by port numbering as in @ref Command */
+  std::span<const UnitID> args;
+  /** Vertex in the DAG */
+  Vertex vertex;
+};
+
+/**
+ * The commands of a circuit as flat arrays, one entry per command in each of
+ * the per-command columns, as produced by `Circuit::get_command_columns`.
+ */
+struct CommandColumns {
+  /** Units of the circuit: qubits, then bits, then WASM states */
+  std::vector<UnitID> units;
+  /** Type of each command */
+  std::vector<OpType> op_types;
+  /**
+   * Arguments of all commands, as indices into @ref units; those of command
+   * `i` are `args[arg_offsets[i]]` to `args[arg_offsets[i + 1] - 1]`.
+   */
+  std::vector<std::uint32_t> args;
+  std::vector<std::uint32_t> arg_offsets;
+  /**
+   * Parameters of all gates in half-turns, NaN if symbolic; those of command
+   * `i` are `params[param_offsets[i]]` to `params[param_offsets[i + 1] - 1]`.
+   * Operations other than gates have none.
+   */
+  std::vector<double> params;
+  std::vector<std::uint32_t> param_offsets;
+  /** Distinct opgroup names */
+  std::vector<std::string> opgroups;
+  /** Index into @ref opgroups of the opgroup of each command, or -1 */
+  std::vector<std::int32_t> opgroup_ids;
+};
+
+/**
+ * The commands of a circuit in a canonical order, as produced by
+ * `Circuit::get_canonical_commands`.
+ *
+ * The order is a topological order of the DAG in which, of the commands ready
+ * to be emitted, the one with the least arguments comes first. It depends
+ * only on the DAG and the unit names, not on the order in which commuting
+ * commands were added.
+ */
+struct CanonicalCommands {
+  /** Units of the circuit: qubits, then bits, then WASM states */
+  std::vector<UnitID> units;
+  /** Operation of each command */
+  std::vector<Op_ptr> ops;
+  /** Opgroup of each command */
+  std::vector<std::optional<std::string>> opgroups;
+  /**
+   * Arguments of all commands, as indices into @ref units; those of command
+   * `i` are `args[arg_offsets[i]]` to `args[arg_offsets[i + 1] - 1]`.
+   */
+  std::vector<std::uint32_t> args;
+  std::vector<std::uint32_t> arg_offsets;
+  /**
+   * Hash of the op types, arguments and opgroups of the commands in order.
+   * Gate parameters are not included, so that ops comparing equal hash
+   * equal. Stable only within a process, as it uses unit handles.
+   */
+  std::size_t hash = 0;
+};
+
 }  // namespace tket
@@ -49,6 +49,7 @@ class Conditional : public Op {
       const SymEngine::map_basic_basic &sub_map) const override;
 
   SymSet free_symbols() const override;
+  bool is_symbolic() const override { return op_->is_symbolic(); }
 
   /**
    * Equality check between two Conditional instances
@@ -63,6 +64,8 @@ class Conditional : public Op {
 
   static Op_ptr deserialize(const nlohmann::json &j);
 
+  std::size_t memory_usage() const override;
+
   std::string get_command_str(const unit_vector_t &args) const override;
 
   Op_ptr dagger() const override;
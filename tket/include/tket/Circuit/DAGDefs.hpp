@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <boost/pool/pool_alloc.hpp>
 #include <list>
 #include <optional>
 #include <set>
@@ -51,14 +52,43 @@ struct EdgeProperties {
   std::pair<port_t, port_t> ports;
 };
 
+/**
+ * Container selector for the storage of a @ref DAG.
+ *
+ * This behaves exactly like `boost::listS`, except that list nodes are taken
+ * from a segregated storage pool (`boost::fast_pool_allocator`) instead of the
+ * general-purpose heap. Building a circuit allocates list nodes for each
+ * vertex and for each in-edge, out-edge and edge-list entry; drawing these
+ * from fixed-size pools makes construction and destruction of many circuits
+ * much cheaper. Freed nodes are returned to the pool and reused by subsequent
+ * circuits.
+ */
+struct pool_listS {};
+
+}  // namespace tket
+
+namespace boost {
+template <class ValueType>
+struct container_gen<tket::pool_listS, ValueType> {
+  typedef std::list<ValueType, boost::fast_pool_allocator<ValueType>> type;
+};
+
+template <>
+struct parallel_edge_traits<tket::pool_listS> {
+  typedef allow_parallel_edge_tag type;
+};
+}  // namespace boost
+
+namespace tket {
+
 /** Graph representing a circuit, with operations as nodes. */
 typedef boost::adjacency_list<
     // OutEdgeList
-    boost::listS,
+    pool_listS,
 
-    // VertexList (use listS because we want to be able to remove vertices
+    // VertexList (use a list because we want to be able to remove vertices
     // without invalidating iterators)
-    boost::listS,
+    pool_listS,
 
     // we want access to incoming and outgoing edges
     boost::bidirectionalS,
@@ -66,7 +96,13 @@ typedef boost::adjacency_list<
     // indexing needed for algorithms such as topological sort
     boost::property<boost::vertex_index_t, int, VertexProperties>,
 
-    EdgeProperties>
+    EdgeProperties,
+
+    // GraphProperty
+    boost::no_property,
+
+    // EdgeList
+    pool_listS>
     DAG;
 
 typedef boost::graph_traits<DAG>::vertex_descriptor Vertex;
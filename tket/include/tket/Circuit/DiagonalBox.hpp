@@ -21,6 +21,20 @@
 #include "tket/Utils/Json.hpp"
 
 namespace tket {
+
+/**
+ * @brief Strategies for synthesising DiagonalBoxes
+ * Multiplexor: use a sequence of multiplexed-Rz gates
+ * PhasePolynomial: expand the phases in the Walsh basis, and synthesise the
+ * resulting phase polynomial with CXs and Rzs using GraySynth
+ */
+enum class DiagonalBoxSynthStrat { Multiplexor, PhasePolynomial };
+
+NLOHMANN_JSON_SERIALIZE_ENUM(
+    DiagonalBoxSynthStrat,
+    {{DiagonalBoxSynthStrat::Multiplexor, "Multiplexor"},
+     {DiagonalBoxSynthStrat::PhasePolynomial, "PhasePolynomial"}});
+
 /**
  * Box to synthesise a diagonal operator
  */
@@ -33,10 +47,13 @@ class DiagonalBox : public Box {
    * @param upper_triangle the diagonal operator will be decomposed as a
    * sequence of multiplexed-Rz gates. This argument decides whether the
    * multiplexed-Rz gates take the shape of an upper triangle or a lower
-   * triangle.
+   * triangle. Only applicable to the DiagonalBoxSynthStrat::Multiplexor
+   * strategy
+   * @param strat synthesis strategy
    */
   explicit DiagonalBox(
-      const Eigen::VectorXcd &diagonal, bool upper_triangle = true);
+      const Eigen::VectorXcd &diagonal, bool upper_triangle = true,
+      const DiagonalBoxSynthStrat &strat = DiagonalBoxSynthStrat::Multiplexor);
 
   /**
    * Copy constructor
@@ -67,20 +84,25 @@ class DiagonalBox : public Box {
 
   Eigen::VectorXcd get_diagonal() const;
   bool is_upper_triangle() const;
+  DiagonalBoxSynthStrat get_strat() const;
 
  protected:
   /**
    * @brief Generate the decomposed circuit using
-   * multiplexed-Rz gates
+   * multiplexed-Rz gates, or a phase polynomial, according to the strategy
    *
    */
   void generate_circuit() const override;
 
   DiagonalBox()
-      : Box(OpType::DiagonalBox), diagonal_(), upper_triangle_(true) {}
+      : Box(OpType::DiagonalBox),
+        diagonal_(),
+        upper_triangle_(true),
+        strat_(DiagonalBoxSynthStrat::Multiplexor) {}
 
  private:
   const Eigen::VectorXcd diagonal_;
   const bool upper_triangle_;
+  const DiagonalBoxSynthStrat strat_;
 };
 }  // namespace tket
@@ -64,7 +64,7 @@ class DummyBox : public Box {
 
   unsigned get_n_qubits() const;
   unsigned get_n_bits() const;
-  ResourceData get_resource_data() const;
+  const ResourceData& get_resource_data() const;
 
   op_signature_t get_signature() const override;
 
@@ -0,0 +1,181 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Circuit.hpp"
+#include "DAGDefs.hpp"
+
+namespace tket {
+
+/**
+ * Contiguous, index-based storage of a circuit's DAG.
+ *
+ * The vertices and edges of a circuit are assigned consecutive indices and
+ * stored in flat arrays, with the in- and out-edges of each vertex held in
+ * compressed sparse row form, ordered by port. Traversals therefore touch
+ * contiguous memory instead of chasing the per-node allocations of the
+ * `listS`-based @ref DAG.
+ *
+ * Every vertex keeps its original @ref Vertex descriptor, so that code can be
+ * moved over to this representation gradually and results mapped back onto
+ * the circuit. Removed vertices are tombstoned (their linear wires being
+ * rewired around them) and their storage is reclaimed by @ref compact.
+ */
+class FlatDAG {
+ public:
+  typedef std::size_t index_t;
+
+  /** Index used for "no vertex" or "no edge" */
+  static constexpr index_t null_index = std::numeric_limits<index_t>::max();
+
+  /**
+   * Build the flat representation of a circuit's DAG.
+   *
+   * O(V + E)
+   */
+  explicit FlatDAG(const Circuit &circ);
+
+  /** Number of vertices that have not been removed */
+  unsigned n_vertices() const { return n_vertices_; }
+
+  /** Number of edges that have not been removed */
+  unsigned n_edges() const { return n_edges_; }
+
+  /** Number of vertex slots, including tombstones */
+  index_t vertex_slots() const { return vertices_.size(); }
+
+  /** Number of tombstoned vertices awaiting compaction */
+  unsigned n_removed_vertices() const {
+    return vertices_.size() - n_vertices_;
+  }
+
+  /**
+   * Whether enough vertices have been removed that calling @ref compact is
+   * worthwhile, i.e. tombstones outnumber live vertices.
+   */
+  bool needs_compaction() const { return n_removed_vertices() > n_vertices_; }
+
+  bool is_removed(index_t v) const { return vertices_[v].removed; }
+
+  /**
+   * Index of a vertex of the source circuit.
+   *
+   * @throws MissingVertex if the vertex is unknown or has been compacted away
+   */
+  index_t get_index(const Vertex &vert) const;
+
+  /** Descriptor of the vertex in the source circuit */
+  Vertex get_vertex(index_t v) const { return vertices_[v].vertex; }
+
+  const Op_ptr &get_op(index_t v) const { return vertices_[v].op; }
+  OpType get_optype(index_t v) const { return vertices_[v].op->get_type(); }
+
+  /** In-edges of a vertex, one per port, ordered by target port */
+  std::span<const index_t> in_edges(index_t v) const {
+    return {in_edges_.data() + in_offsets_[v],
+            in_offsets_[v + 1] - in_offsets_[v]};
+  }
+
+  /**
+   * Out-edges of a vertex, ordered by source port. For classical ports the
+   * Classical edge is followed by any Boolean edges from the same port.
+   */
+  std::span<const index_t> out_edges(index_t v) const {
+    return {out_edges_.data() + out_offsets_[v],
+            out_offsets_[v + 1] - out_offsets_[v]};
+  }
+
+  index_t source(index_t e) const { return edges_[e].source; }
+  index_t target(index_t e) const { return edges_[e].target; }
+  port_t source_port(index_t e) const { return edges_[e].source_port; }
+  port_t target_port(index_t e) const { return edges_[e].target_port; }
+  EdgeType get_edgetype(index_t e) const { return edges_[e].type; }
+
+  /**
+   * All live vertices in a topological order.
+   *
+   * The order is deterministic: among vertices that are simultaneously ready,
+   * lower indices come first.
+   *
+   * O(V + E)
+   */
+  std::vector<index_t> topological_order() const;
+
+  /**
+   * Remove a vertex, rewiring each linear in-edge to the target of the
+   * out-edge on the same port.
+   *
+   * The vertex is tombstoned: its index remains allocated until the next call
+   * to @ref compact. The source circuit is not modified; the same change can
+   * be applied to it by passing @ref removed_vertices to
+   * `Circuit::remove_vertices` with graph rewiring.
+   *
+   * O(alpha)
+   *
+   * @throws CircuitInvalidity if the vertex is a boundary vertex, has already
+   *   been removed, or has Boolean edges
+   */
+  void remove_vertex(index_t v);
+
+  /** Descriptors of all tombstoned vertices, ordered by index */
+  std::vector<Vertex> removed_vertices() const;
+
+  /**
+   * Reclaim the storage of removed vertices and edges.
+   *
+   * Live vertices keep their relative order. This invalidates all previously
+   * obtained indices.
+   *
+   * O(V + E)
+   *
+   * @return map from old vertex index to new vertex index, with
+   *   @ref null_index for removed vertices
+   */
+  std::vector<index_t> compact();
+
+ private:
+  struct VertexRecord {
+    Vertex vertex;
+    Op_ptr op;
+    bool removed;
+  };
+
+  struct EdgeRecord {
+    index_t source;
+    index_t target;
+    port_t source_port;
+    port_t target_port;
+    EdgeType type;
+    bool removed;
+  };
+
+  std::vector<VertexRecord> vertices_;
+  std::vector<EdgeRecord> edges_;
+  std::vector<index_t> in_offsets_;
+  std::vector<index_t> in_edges_;
+  std::vector<index_t> out_offsets_;
+  std::vector<index_t> out_edges_;
+  std::unordered_map<Vertex, index_t> index_;
+  unsigned n_vertices_;
+  unsigned n_edges_;
+};
+
+}  // namespace tket
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <vector>
+
+#include "tket/Utils/Expression.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
 
 namespace tket {
@@ -26,6 +29,8 @@ namespace tket_sim {
  *  |00...0>, using ILO-BE convention.
  *  (Note: if any OpType::Measure or OpType::Barrier occur,
  *  they are simply ignored - the same as a noop).
+ *  Gates are applied to the statevector in place, so memory use is
+ *  dominated by the statevector itself (16 * 2^n bytes).
  *  @param circ The circuit to simulate.
  *  @param abs_epsilon Used to decide if an entry of a sparse matrix is
  *              too small, i.e. if std::abs(z) <= abs_epsilon then we treat
@@ -35,7 +40,14 @@ namespace tket_sim {
  */
 StateVector get_statevector(
     const Circuit& circ, double abs_epsilon = EPS,
-    unsigned max_number_of_qubits = 11);
+    unsigned max_number_of_qubits = 25);
+
+/** As get_statevector, but returning the state as a matrix with a single
+ *  column, as computed, instead of copying it into a vector.
+ */
+Eigen::MatrixXcd get_statevector_column(
+    const Circuit& circ, double abs_epsilon = EPS,
+    unsigned max_number_of_qubits = 25);
 
 /** Calculates the unitary matrix of the circuit,
  *  using ILO-BE convention.
@@ -56,8 +68,9 @@ Eigen::MatrixXcd get_unitary(
 /** Let U be the unitary matrix which represents the given circuit
  *  using ILO-BE convention. Replace the given M with UM.
  *  OpType::Measure is ignored if it occurs.
- *  Note that U is not calculated explicitly and sparse matrices are used,
- *  so it is quicker than calling calc_unitary if M is, e.g., a column vector.
+ *  Note that U is not calculated explicitly: each gate is applied to M in
+ *  place, so it is quicker than calling calc_unitary if M is, e.g., a column
+ *  vector.
  *  @param circ The circuit to simulate.
  *  @param matr The matrix M which will be premultiplied by the unitary matrix.
  *  @param abs_epsilon Used to decide if an entry of a sparse matrix is
@@ -70,5 +83,80 @@ void apply_unitary(
     const Circuit& circ, Eigen::MatrixXcd& matr, double abs_epsilon = EPS,
     unsigned max_number_of_qubits = 11);
 
+/** Statevectors of a symbolic circuit at many points of its parameters,
+ *  e.g. the shifted points of a parameter-shift gradient.
+ *
+ *  The circuit is prepared once: the commands before the first which
+ *  depends on a symbol are simulated once and shared by all points, and the
+ *  rest are compiled for binding with a SymbolBindingPlan. Each point then
+ *  costs one binding and the simulation of the rest.
+ *  @param circ The circuit to simulate.
+ *  @param symbols The symbols, in the order of the columns of values;
+ *              every free symbol of the circuit must be one of them.
+ *  @param values One row for each point, holding the value of each symbol.
+ *  @param abs_epsilon As for get_statevector.
+ *  @param max_number_of_qubits Throw an exception if this limit is exceeded.
+ *  @return One column for each point, holding its statevector.
+ *  @throws std::invalid_argument if the symbols do not match the circuit or
+ *              the number of columns of values.
+ */
+Eigen::MatrixXcd get_statevectors(
+    const Circuit& circ, const std::vector<Sym>& symbols,
+    const Eigen::MatrixXd& values, double abs_epsilon = EPS,
+    unsigned max_number_of_qubits = 25);
+
+/** Unitaries of a symbolic circuit at many points of its parameters, as
+ *  for get_statevectors.
+ *  @return The unitary of the circuit at each point.
+ */
+std::vector<Eigen::MatrixXcd> get_unitaries(
+    const Circuit& circ, const std::vector<Sym>& symbols,
+    const Eigen::MatrixXd& values, double abs_epsilon = EPS,
+    unsigned max_number_of_qubits = 11);
+
+/** Whether circuits may differ by a global phase and still be considered
+ *  equivalent.
+ */
+enum class PhaseEquivalence { Exact, UpToGlobalPhase };
+
+/** Test whether two circuits act in the same way on a few random input
+ *  states, without calculating their unitaries; so this uses O(2^n) memory
+ *  rather than O(4^n).
+ *
+ *  Each circuit is applied to the same pseudorandom (normalised) states,
+ *  including its implicit qubit permutation and global phase, as in
+ *  apply_unitary. With PhaseEquivalence::UpToGlobalPhase a single phase
+ *  factor is allowed between the two sets of outputs.
+ *
+ *  Inequivalent circuits are detected with very high probability,
+ *  but not with certainty.
+ *
+ *  @param circ1 First circuit.
+ *  @param circ2 Second circuit.
+ *  @param equivalence Whether a global phase difference is allowed.
+ *  @param tolerance Largest allowed norm of the difference between the two
+ *              outputs for each input state.
+ *  @param number_of_states Number of random input states.
+ *  @param seed Seed for generating the input states.
+ *  @param max_number_of_qubits Throw an exception if this limit is exceeded.
+ *  @return Whether the circuits have the same qubits and the outputs agree
+ *              on every input state.
+ */
+bool compare_on_random_states(
+    const Circuit& circ1, const Circuit& circ2,
+    PhaseEquivalence equivalence = PhaseEquivalence::Exact,
+    double tolerance = 1e-10, unsigned number_of_states = 3,
+    std::size_t seed = 5489, unsigned max_number_of_qubits = 25);
+
+/** Set the number of threads used to apply gates, including the calling
+ *  thread. 0 means one per hardware thread. The default is 1.
+ *  Results do not depend on the number of threads.
+ *  Must not be called while a simulation is running.
+ */
+void set_number_of_threads(unsigned number_of_threads);
+
+/** The number of threads used to apply gates. */
+unsigned get_number_of_threads();
+
 }  // namespace tket_sim
 }  // namespace tket
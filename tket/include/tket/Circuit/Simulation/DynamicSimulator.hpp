@@ -0,0 +1,51 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace tket {
+class Circuit;
+
+namespace tket_sim {
+
+/** Sample the bits of a circuit with mid-circuit measurements and classical
+ *  control, by statevector simulation of each shot starting from |00...0>.
+ *
+ *  Each Measure samples an outcome and collapses the state, and each Reset
+ *  measures and then resets its qubit to |0>. A Conditional operation is
+ *  applied only if its condition bits hold its value in the current shot.
+ *  Consecutive classical operations (possibly conditional) are evaluated
+ *  together with Circuit::classical_eval. Boxes are decomposed first.
+ *
+ *  The state before the first measurement or reset does not depend on the
+ *  shot, so it is computed once and shared between all the shots.
+ *
+ *  @param circ The circuit to simulate.
+ *  @param n_shots Number of shots.
+ *  @param seed Seed for the pseudorandom measurement outcomes.
+ *  @param max_number_of_qubits Throw an exception if this limit is exceeded.
+ *  @return For each shot, the final value of each bit of the circuit,
+ *    in the order given by Circuit::all_bits (initially all false).
+ *  @throws Unsupported if the circuit contains an operation that cannot be
+ *    simulated, e.g. WASM or ClassicalExpBox.
+ */
+std::vector<std::vector<bool>> sample_dynamic_circuit(
+    const Circuit& circ, unsigned n_shots, std::size_t seed = 5489,
+    unsigned max_number_of_qubits = 20);
+
+}  // namespace tket_sim
+}  // namespace tket
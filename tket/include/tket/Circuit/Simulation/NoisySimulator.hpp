@@ -0,0 +1,56 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace tket {
+class Circuit;
+class DeviceCharacterisation;
+
+namespace tket_sim {
+
+/** Sample measurement outcomes of a circuit under the noise model of a
+ *  DeviceCharacterisation, by Monte Carlo simulation of statevector
+ *  trajectories starting from |00...0>.
+ *
+ *  After each gate a depolarising error is applied with the probability
+ *  given by the characterisation: for 1- and 2-qubit gates, the node or
+ *  link error for the gate's OpType (a 2-qubit link is looked up in either
+ *  direction); each qubit of a larger gate gets its own node error. A
+ *  depolarising error is a uniformly random non-identity Pauli on the
+ *  gate's qubits. Each recorded measurement outcome is flipped with the
+ *  readout error of the measured node. Qubits are treated as Nodes.
+ *
+ *  Supported operations are gates, Measure, Reset, Barrier, and Conditional
+ *  versions of these.
+ *
+ *  @param circ The circuit to simulate.
+ *  @param characterisation The errors of the device nodes and links.
+ *  @param n_shots Number of shots, i.e. trajectories.
+ *  @param seed Seed for the pseudorandom errors and outcomes.
+ *  @param max_number_of_qubits Throw an exception if this limit is exceeded.
+ *  @return For each shot, the final value of each bit of the circuit,
+ *    in the order given by Circuit::all_bits (initially all false).
+ *  @throws Unsupported if the circuit contains an unsupported operation.
+ */
+std::vector<std::vector<bool>> sample_noisy_circuit(
+    const Circuit& circ, const DeviceCharacterisation& characterisation,
+    unsigned n_shots, std::size_t seed = 5489,
+    unsigned max_number_of_qubits = 20);
+
+}  // namespace tket_sim
+}  // namespace tket
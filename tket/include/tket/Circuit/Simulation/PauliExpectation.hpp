@@ -0,0 +1,62 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "tket/Utils/PauliTensor.hpp"
+
+namespace tket {
+typedef Eigen::VectorXcd StateVector;
+
+namespace tket_sim {
+
+/** Expectation value <psi|H|psi> of an operator H = sum_i c_i P_i, given as
+ *  a sum of Pauli strings with coefficients, for a statevector psi.
+ *
+ *  Each Pauli string is applied to the amplitudes directly using bit masks
+ *  (flipping the bits where it has X or Y, and taking the parity of those
+ *  where it has Y or Z), so no operator matrices are built. Terms are
+ *  divided between the threads set by set_number_of_threads, and the result
+ *  does not depend on the number of threads.
+ *
+ *  @param state The statevector, in ILO-BE convention on the default
+ *      register q[0], ..., q[n-1].
+ *  @param terms The terms P_i with coefficients c_i; string element j is
+ *      the Pauli on q[j]. Strings may be shorter than n (the remaining
+ *      qubits have I), but not longer.
+ *  @throws SymbolsNotSupported if a coefficient is symbolic.
+ *  @throws std::invalid_argument if the state does not have size a power of
+ *      two or a string is too long.
+ */
+Complex get_operator_expectation_value(
+    const StateVector& state, const std::vector<SymPauliTensor>& terms);
+
+/** Expectation value <psi|H|psi> of an operator H = sum_i c_i P_i, for a
+ *  statevector psi on the given qubits.
+ *
+ *  @param state The statevector, in ILO-BE convention on \p qubits.
+ *  @param terms The terms P_i with coefficients c_i.
+ *  @param qubits The qubits of the state, most significant first.
+ *  @throws SymbolsNotSupported if a coefficient is symbolic.
+ *  @throws std::invalid_argument if the state size does not match the
+ *      number of qubits, or a term acts on a qubit not in \p qubits.
+ */
+Complex get_operator_expectation_value(
+    const StateVector& state, const std::vector<SpSymPauliTensor>& terms,
+    const qubit_vector_t& qubits);
+
+}  // namespace tket_sim
+}  // namespace tket
@@ -0,0 +1,49 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace tket {
+class Circuit;
+
+namespace tket_sim {
+
+/** Sample measurement outcomes of a Clifford circuit by stabiliser
+ *  simulation, using a SymplecticTableau of stabilisers and
+ *  destabilisers (Aaronson-Gottesman), starting from |00...0>.
+ *
+ *  Supported operations are the Clifford gates accepted by
+ *  SymplecticTableau::apply_gate, Measure, Reset, Barrier, and Conditional
+ *  versions of any of these. The part of the circuit before the first
+ *  measurement, reset or conditional is simulated once and shared by all
+ *  shots.
+ *
+ *  Memory is O(n^2) bits and each measurement takes O(n^2) time, for
+ *  n qubits, so this works for circuits far too large for get_statevector.
+ *
+ *  @param circ The circuit to simulate.
+ *  @param n_shots Number of shots.
+ *  @param seed Seed for the pseudorandom measurement outcomes.
+ *  @return For each shot, the final value of each bit of the circuit,
+ *    in the order given by Circuit::all_bits (initially all false).
+ *  @throws BadOpType if the circuit contains an unsupported operation.
+ */
+std::vector<std::vector<bool>> sample_stabiliser_circuit(
+    const Circuit& circ, unsigned n_shots, std::size_t seed = 5489);
+
+}  // namespace tket_sim
+}  // namespace tket
@@ -0,0 +1,157 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "Circuit.hpp"
+#include "DAGDefs.hpp"
+
+namespace tket {
+
+/**
+ * Cached assignment of the vertices of a circuit to slices (layers).
+ *
+ * Each non-boundary vertex is assigned the index of the slice it would occupy
+ * when slicing the circuit with \ref Circuit::SliceIterator, i.e. one more
+ * than the latest slice among the vertices it must follow. Slices are numbered
+ * from 1; initial boundary vertices are at layer 0 and final boundary vertices
+ * share the layer of their latest predecessor.
+ *
+ * Vertices for which the optional skip function returns true (for example
+ * barriers, when computing depth) occupy no slice of their own: they share
+ * the layer of their latest predecessor. With such a function the number of
+ * slices is the corresponding restricted depth of the circuit.
+ *
+ * The cache also records the height of each vertex: the number of slices
+ * occupied by the longest chain of vertices that must follow it. A
+ * non-skipped vertex lies on a critical path, whose length is the depth, if
+ * and only if its layer plus its height equals the depth.
+ *
+ * After the circuit has been modified locally the cache can be brought up to
+ * date with @ref update and @ref erase, which recompute layers downstream of
+ * the change and heights upstream of it.
+ *
+ * The cache refers to the circuit it was built from, which must outlive it.
+ */
+class SliceCache {
+ public:
+  /**
+   * Compute the slices of a circuit.
+   *
+   * O(V + E)
+   *
+   * @param circ circuit
+   * @param skip_func optional predicate selecting operations that do not
+   *   occupy a slice
+   */
+  explicit SliceCache(
+      const Circuit &circ, const std::function<bool(Op_ptr)> &skip_func = {});
+
+  /** Number of slices (the depth, ignoring skipped operations). O(1) */
+  unsigned depth() const { return slices_.size() - 1; }
+
+  /**
+   * Layer of a vertex.
+   *
+   * @throws MissingVertex if the vertex is not known to the cache
+   */
+  unsigned get_layer(const Vertex &vert) const;
+
+  /**
+   * Height of a vertex: the number of slices after it on the longest path
+   * to the output. Initial boundary vertices have height equal to the depth;
+   * final boundary vertices have height 0.
+   *
+   * @throws MissingVertex if the vertex is not known to the cache
+   */
+  unsigned get_height(const Vertex &vert) const;
+
+  /**
+   * Whether a vertex lies on a longest path through the circuit.
+   *
+   * @throws MissingVertex if the vertex is not known to the cache
+   */
+  bool on_critical_path(const Vertex &vert) const {
+    return get_layer(vert) + get_height(vert) == depth();
+  }
+
+  /**
+   * Non-skipped vertices in the given slice, in no particular order.
+   *
+   * @param i slice index, between 1 and @ref depth
+   */
+  const VertexSet &get_slice(unsigned i) const { return slices_.at(i); }
+
+  /**
+   * All slices in order, each as a vector of vertices in no particular
+   * order. The first slice is at index 0 in the returned vector.
+   */
+  SliceVec get_slices() const;
+
+  /**
+   * Recompute layers after a local change to the circuit.
+   *
+   * \p changed should contain every vertex whose in-edges have changed, for
+   * example the vertices immediately after a substituted region or a removed
+   * vertex, and any newly added vertex that has no successor in \p changed.
+   * Vertices unknown to the cache that precede these are picked up
+   * automatically. Layers downstream of \p changed and heights upstream of
+   * it are recomputed.
+   *
+   * O(size of affected region)
+   */
+  void update(const VertexVec &changed);
+
+  /**
+   * Forget a vertex that has been (or is about to be) removed from the
+   * circuit.
+   *
+   * This does not update the layers of its successors, which should be
+   * passed to @ref update.
+   *
+   * O(1)
+   */
+  void erase(const Vertex &vert);
+
+ private:
+  const Circuit &circ_;
+  std::function<bool(Op_ptr)> skip_func_;
+  std::unordered_map<Vertex, unsigned> layers_;
+  std::unordered_map<Vertex, unsigned> heights_;
+  // slices_[i] holds slice i; slices_[0] is always empty.
+  std::vector<VertexSet> slices_;
+
+  // Vertices that must be in earlier slices than (or the same layer as,
+  // if skipped) `vert`.
+  VertexVec predecessors(const Vertex &vert) const;
+
+  // Vertices whose layers depend directly on that of `vert`.
+  VertexVec successors(const Vertex &vert) const;
+
+  bool occupies_slice(const Vertex &vert) const;
+
+  void set_layer(const Vertex &vert, unsigned layer);
+
+  void update_layers(const VertexVec &changed);
+
+  void update_heights(const VertexVec &changed);
+
+  void trim();
+};
+
+}  // namespace tket
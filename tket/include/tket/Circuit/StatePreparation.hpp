@@ -75,7 +75,8 @@ class StatePreparationBox : public Box {
  protected:
   /**
    * @brief Generate the state preparation circuit using
-   * multiplexed-Ry gates and multiplexed-Rz gates
+   * multiplexed-Ry gates and multiplexed-Rz gates, or, for a state with few
+   * non-zero amplitudes, a sequence of controlled rotations merging them
    *
    */
   void generate_circuit() const override;
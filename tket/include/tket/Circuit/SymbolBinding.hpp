@@ -0,0 +1,100 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Circuit.hpp"
+
+namespace tket {
+
+/**
+ * A symbolic circuit prepared for repeated substitution of numbers for its
+ * symbols.
+ *
+ * Construction finds every parameter of the circuit that depends on a symbol
+ * and compiles it, once, to a function of a vector of doubles. Binding then
+ * copies the circuit and evaluates those functions, without any symbolic
+ * substitution. Operations other than gates whose parameters depend on
+ * symbols, such as boxes, are substituted symbolically as by
+ * Circuit::symbol_substitution.
+ *
+ * A plan is immutable once built and safe to bind from several threads.
+ */
+class SymbolBindingPlan {
+ public:
+  /**
+   * Prepare a circuit for binding.
+   *
+   * @param circ symbolic circuit
+   * @param symbols symbols in the order of the values to be bound
+   * @throws std::invalid_argument if a symbol is repeated, or the circuit
+   *   has a free symbol not in @p symbols
+   */
+  SymbolBindingPlan(const Circuit &circ, const std::vector<Sym> &symbols);
+
+  ~SymbolBindingPlan();
+  SymbolBindingPlan(const SymbolBindingPlan &) = delete;
+  SymbolBindingPlan &operator=(const SymbolBindingPlan &) = delete;
+
+  /** Symbols in the order of the values to be bound. */
+  const std::vector<Sym> &get_symbols() const { return symbols_; }
+
+  /**
+   * Number of parameters compiled to functions of the symbol values,
+   * including the phase.
+   */
+  std::size_t n_compiled_params() const;
+
+  /**
+   * Substitute values for the symbols.
+   *
+   * @param values one value for each symbol, in the order of @ref get_symbols
+   * @return circuit with the values substituted
+   * @throws std::invalid_argument if the number of values is wrong
+   */
+  Circuit bind(const std::vector<double> &values) const;
+
+  /**
+   * Substitute several sets of values for the symbols, in parallel.
+   *
+   * @param values sets of values, each as for @ref bind
+   * @param n_threads number of threads to use, or 0 to use one for each
+   *   hardware thread
+   * @return one circuit for each set of values
+   * @throws std::invalid_argument if the number of values in any set is
+   *   wrong
+   */
+  std::vector<Circuit> bind_all(
+      const std::vector<std::vector<double>> &values,
+      unsigned n_threads = 0) const;
+
+ private:
+  struct Entry;
+  struct Lambda;
+  Circuit circ_;
+  std::vector<Sym> symbols_;
+  // Operations with symbolic parameters, in the order of the circuit's
+  // vertices
+  std::vector<Entry> entries_;
+  // Phase, when it depends on a symbol
+  std::unique_ptr<Lambda> phase_;
+
+  void check_size(const std::vector<double> &values) const;
+};
+
+}  // namespace tket
@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "Boxes.hpp"
 #include "Circuit.hpp"
@@ -39,6 +42,14 @@ NLOHMANN_JSON_SERIALIZE_ENUM(
  */
 typedef std::map<std::vector<bool>, std::vector<bool>> state_perm_t;
 
+/**
+ * @brief Map basis states to basis states, each packed into an integer whose
+ * most significant bit is the first bit of the bitstring
+ *
+ */
+typedef std::vector<std::pair<std::uint32_t, std::uint32_t>>
+    packed_state_perm_t;
+
 /**
  * Box to synthesise a state permutation
  */
@@ -59,6 +70,20 @@ class ToffoliBox : public Box {
       const ToffoliBoxSynthStrat &strat = ToffoliBoxSynthStrat::Matching,
       const OpType &rotation_axis = OpType::Ry);
 
+  /**
+   * @brief Construct a circuit that synthesise the given state permutation,
+   * given with packed basis states
+   *
+   * @param n_qubits number of qubits
+   * @param permutation map between basis states, in any order
+   * @param strat synthesis strategy
+   * @param rotation_axis as for the other constructor
+   */
+  ToffoliBox(
+      unsigned n_qubits, const packed_state_perm_t &permutation,
+      const ToffoliBoxSynthStrat &strat = ToffoliBoxSynthStrat::Matching,
+      const OpType &rotation_axis = OpType::Ry);
+
   /**
    * Copy constructor
    */
@@ -89,6 +114,10 @@ class ToffoliBox : public Box {
   static nlohmann::json to_json(const Op_ptr &op);
 
   state_perm_t get_permutation() const;
+  /** The permutation with packed basis states, sorted by source state */
+  const packed_state_perm_t &get_packed_permutation() const {
+    return permutation_;
+  }
   OpType get_rotation_axis() const;
   ToffoliBoxSynthStrat get_strat() const;
 
@@ -111,7 +140,7 @@ class ToffoliBox : public Box {
  private:
   const unsigned n_;
   const unsigned pow2n_;
-  const state_perm_t permutation_;
+  const packed_state_perm_t permutation_;
   const ToffoliBoxSynthStrat strat_;
   const OpType rotation_axis_;
 };
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <tkrng/RNG.hpp>
+
 #include "SymplecticTableau.hpp"
 
 namespace tket {
@@ -206,6 +208,34 @@ class ChoiMixTableau {
   void collapse_qubit(
       const Qubit& qb, TableauSegment seg = TableauSegment::Output);
 
+  /**
+   * Measures a Pauli observable over the output qubits of the Choi state,
+   * updating the tableau to the post-measurement state.
+   * Throws an exception if the observable is not Hermitian or acts on a
+   * qubit that is not an output.
+   *
+   * @param pauli The observable, including its sign
+   * @param rng Source of randomness for non-deterministic outcomes
+   * @return false for the +1 eigenvalue, true for the -1 eigenvalue
+   */
+  bool measure_pauli(const SpPauliStabiliser& pauli, RNG& rng);
+
+  /**
+   * Samples the outcomes of measuring every output qubit in the Z basis,
+   * with the input qubits initialised in |0>. The tableau itself is not
+   * changed.
+   *
+   * Only one Gaussian elimination is needed: the outcomes are uniformly
+   * distributed over the bit strings satisfying the diagonal stabilizers, so
+   * each shot just fills the free bits at random and solves for the rest.
+   *
+   * @param shots The number of shots
+   * @param rng Source of randomness
+   * @return The outcomes of each shot, ordered as output_qubits()
+   */
+  std::vector<std::vector<bool>> sample_measurements(
+      unsigned shots, RNG& rng) const;
+
   /**
    * Removes a row from the tableau.
    * The final row is shifted into its place.
@@ -223,6 +253,19 @@ class ChoiMixTableau {
    */
   void gaussian_form();
 
+  /**
+   * Canonical form: the canonical column order with inputs first, and the
+   * canonical form of the rows. Tableaux representing the same process
+   * have equal canonical forms.
+   */
+  ChoiMixTableau canonical_form() const;
+
+  /**
+   * Hash of the tableau contents and column names. Equal tableaux hash
+   * equally; hash the canonical_form() to identify equivalent tableaux.
+   */
+  std::size_t hash_value() const;
+
   /**
    * Renames qubits.
    */
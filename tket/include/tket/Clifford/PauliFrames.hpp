@@ -0,0 +1,105 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <tkrng/RNG.hpp>
+#include <vector>
+
+#include "tket/OpType/OpType.hpp"
+#include "tket/Utils/BitMatrix.hpp"
+#include "tket/Utils/PauliTensor.hpp"
+
+namespace tket {
+
+class Circuit;
+
+/**
+ * Pauli frames for many shots at once, for pushing Pauli errors or
+ * randomisations through Clifford circuits.
+ *
+ * The frames are stored as bit-planes: for each qubit, one bit per shot
+ * records whether the frame of that shot has an X (resp. Z) component on
+ * the qubit. A Clifford gate updates the frames of all shots with a few
+ * word operations on the planes of the qubits it acts on.
+ *
+ * Frames are tracked up to sign, so Pauli gates leave them unchanged.
+ */
+class PauliFrames {
+ public:
+  /**
+   * Construct identity frames over the given number of qubits, for each of
+   * the given number of shots.
+   */
+  PauliFrames(unsigned n_qubits, unsigned n_shots);
+
+  unsigned get_n_qubits() const { return xs_.rows(); }
+  unsigned get_n_shots() const { return xs_.cols(); }
+
+  /**
+   * Bit-planes of the frames: entry (q, s) is set if the frame of shot s has
+   * an X (resp. Z) component on qubit q.
+   */
+  const BitMatrix &x_planes() const { return xs_; }
+  const BitMatrix &z_planes() const { return zs_; }
+
+  /** Read off the frame of a single shot. */
+  PauliStabiliser get_frame(unsigned shot) const;
+
+  /** Overwrite the frame of a single shot. */
+  void set_frame(unsigned shot, const DensePauliMap &paulis);
+
+  /**
+   * Multiply the frame of every shot by an independent uniformly random
+   * Pauli on a qubit.
+   */
+  void randomise(unsigned qb, RNG &rng);
+
+  /**
+   * Conjugate the frames by a Clifford gate. Throws BadOpType for gates
+   * which are not Clifford.
+   */
+  void apply_S(unsigned qb);
+  void apply_Z(unsigned) {}
+  void apply_V(unsigned qb);
+  void apply_X(unsigned) {}
+  void apply_H(unsigned qb);
+  void apply_CX(unsigned qc, unsigned qt);
+  void apply_gate(OpType type, const std::vector<unsigned> &qbs);
+
+  /** Clear the frames on a qubit, as after a reset. */
+  void reset(unsigned qb);
+
+  /**
+   * Propagate the frames through a circuit of Clifford gates, measurements
+   * and resets, with qubits indexed by their position in
+   * Circuit::all_qubits(). Any implicit qubit permutation of the circuit is
+   * applied at the end.
+   *
+   * Throws an exception if the circuit is not over the same number of qubits
+   * or contains conditional or non-Clifford operations.
+   *
+   * @param circ circuit to propagate through
+   * @return for each bit of the circuit (ordered as in Circuit::all_bits())
+   * one bit per shot, set if the last measurement into that bit is flipped
+   * by the frame
+   */
+  BitMatrix propagate(const Circuit &circ);
+
+ private:
+  BitMatrix xs_;
+  BitMatrix zs_;
+};
+
+}  // namespace tket
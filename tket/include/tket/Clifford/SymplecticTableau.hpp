@@ -15,6 +15,7 @@
 #pragma once
 
 #include "tket/OpType/OpType.hpp"
+#include "tket/Utils/BitMatrix.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
 #include "tket/Utils/PauliTensor.hpp"
 
@@ -129,6 +130,14 @@ class SymplecticTableau {
    */
   void row_mult(unsigned ra, unsigned rw, Complex coeff = 1.);
 
+  /**
+   * Power of i (mod 4) picked up by multiplying the Pauli strings packed in
+   * (xa, za) and (xb, zb), in that order, ignoring the phases of the strings
+   */
+  static unsigned product_exponent(
+      const BitMatrix::Word *xa, const BitMatrix::Word *za,
+      const BitMatrix::Word *xb, const BitMatrix::Word *zb, unsigned n_words);
+
   /**
    * Applies a chosen gate to the given qubit(s)
    */
@@ -171,10 +180,27 @@ class SymplecticTableau {
   void gaussian_form();
 
   /**
-   * Tableau contents
+   * Canonical form of the stabilizer group generated by the rows: the
+   * Gaussian form, without any rows reduced to the identity. Tableaux whose
+   * rows generate the same group have equal canonical forms.
+   */
+  SymplecticTableau canonical_form() const;
+
+  /**
+   * Hash of the tableau contents over the bit-packed words. Equal tableaux
+   * hash equally; hash the canonical_form() to identify tableaux generating
+   * the same group.
+   */
+  std::size_t hash_value() const;
+
+  /** Estimated bytes held, including the object itself. */
+  std::size_t memory_usage() const;
+
+  /**
+   * Tableau contents, with the x and z components bit-packed by row
    */
-  MatrixXb xmat;
-  MatrixXb zmat;
+  BitMatrix xmat;
+  BitMatrix zmat;
   VectorXb phase;
 
   /**
@@ -184,15 +210,51 @@ class SymplecticTableau {
 
  private:
   /**
-   * Helper methods for manipulating the tableau when applying gates
+   * Helper method for row multiplication on the packed words of rows, each
+   * of xmat.words_per_row() words; the result row may alias either input
    */
   void row_mult(
-      const MatrixXb::RowXpr &xa, const MatrixXb::RowXpr &za, const bool &pa,
-      const MatrixXb::RowXpr &xb, const MatrixXb::RowXpr &zb, const bool &pb,
-      Complex phase, MatrixXb::RowXpr &xw, MatrixXb::RowXpr &zw, bool &pw);
-  void col_mult(
-      const MatrixXb::ColXpr &a, const MatrixXb::ColXpr &b, bool flip,
-      MatrixXb::ColXpr &w, VectorXb &pw);
+      const BitMatrix::Word *xa, const BitMatrix::Word *za, bool pa,
+      const BitMatrix::Word *xb, const BitMatrix::Word *zb, bool pb,
+      Complex phase, BitMatrix::Word *xw, BitMatrix::Word *zw, bool &pw);
+};
+
+/**
+ * A SymplecticTableau transposed so that the column of each qubit is
+ * bit-packed, for applying long sequences of gates: each gate then acts on
+ * whole words of its columns instead of on every row in turn.
+ *
+ * Construct from a tableau, apply the gates and read the result back with
+ * to_tableau(). Gates act exactly as on the SymplecticTableau.
+ */
+class ColumnPackedTableau {
+ public:
+  explicit ColumnPackedTableau(const SymplecticTableau &tab);
+
+  SymplecticTableau to_tableau() const;
+
+  unsigned get_n_rows() const { return phase_.cols(); }
+  unsigned get_n_qubits() const { return xcols_.rows(); }
+
+  /**
+   * Read off a row as a Pauli string, gathering one bit from each column
+   */
+  PauliStabiliser get_pauli(unsigned i) const;
+
+  void apply_S(unsigned qb);
+  void apply_Z(unsigned qb);
+  void apply_V(unsigned qb);
+  void apply_X(unsigned qb);
+  void apply_H(unsigned qb);
+  void apply_CX(unsigned qc, unsigned qt);
+  void apply_gate(OpType type, const std::vector<unsigned> &qbs);
+
+ private:
+  /** Row q holds the x (resp. z) components of qubit q in every row */
+  BitMatrix xcols_;
+  BitMatrix zcols_;
+  /** Single row holding the phase of every row */
+  BitMatrix phase_;
 };
 
 JSON_DECL(SymplecticTableau)
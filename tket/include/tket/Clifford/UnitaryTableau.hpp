@@ -147,6 +147,32 @@ class UnitaryTableau {
   UnitaryTableau dagger() const;
   UnitaryTableau transpose() const;
 
+  /**
+   * Versions of compose and dagger for tableaux whose qubits are aligned by
+   * index, for composing many small tableaux quickly. Qubit names are
+   * ignored: qubit i of one tableau is matched to qubit i of the other.
+   *
+   * The result is written into @p result, which keeps its own qubit names.
+   * If it is already over the right number of qubits nothing is allocated;
+   * otherwise it is replaced by a tableau over default qubits first. Will
+   * throw an exception if @p first and @p second differ in size.
+   *
+   * @param first first tableau
+   * @param second second tableau
+   * @param result tableau corresponding to applying \p first, followed by
+   * \p second
+   */
+  static void compose_aligned(
+      const UnitaryTableau& first, const UnitaryTableau& second,
+      UnitaryTableau& result);
+
+  /**
+   * Write the tableau of the inverse unitary into @p result, as for
+   * compose_aligned. Allocates nothing for up to 64 qubits when @p result is
+   * already of the right size.
+   */
+  void dagger_aligned(UnitaryTableau& result) const;
+
   /**
    * Gives the UnitaryTableau corresponding to the complex conjugate unitary.
    * This calls conjugate() on the underlying SymplecticTableau.
@@ -164,6 +190,16 @@ class UnitaryTableau {
       std::ostream& os, const UnitaryRevTableau& tab);
   bool operator==(const UnitaryTableau& other) const;
 
+  /**
+   * Hash over the bit-packed words of the tableau and the qubit names.
+   * The tableau of a unitary is already canonical, and tableaux which are
+   * equal up to the order of their qubits hash equally.
+   */
+  std::size_t hash_value() const;
+
+  /** Estimated bytes held, including the object itself. */
+  std::size_t memory_usage() const;
+
  private:
   /**
    * The actual binary tableau.
@@ -304,6 +340,9 @@ class UnitaryRevTableau {
       std::ostream& os, const UnitaryRevTableau& tab);
   bool operator==(const UnitaryRevTableau& other) const;
 
+  /** Estimated bytes held, including the object itself. */
+  std::size_t memory_usage() const { return tab_.memory_usage(); }
+
  private:
   UnitaryTableau tab_;
 };
@@ -159,6 +159,21 @@ Circuit pauli_graph_to_pauli_exp_box_circuit_pairwise(
 Circuit pauli_graph_to_pauli_exp_box_circuit_sets(
     const PauliGraph &pg, CXConfigType cx_config = CXConfigType::Snake);
 
+/**
+ * Synthesises a circuit equivalent to the PauliGraph by reducing each gadget
+ * in turn to a single-qubit rotation, without undoing the Clifford reductions.
+ * These accumulate in a frame which later gadgets are seen through; it is
+ * undone together with the tableau at the end.
+ * The next gadget and the qubit it is reduced onto are chosen to minimise the
+ * CX count of the reduction plus an estimate for the next few gadgets in
+ * causal order.
+ *
+ * @param pg the PauliGraph to synthesise
+ * @param lookahead number of gadgets considered at each step
+ */
+Circuit pauli_graph_to_circuit_lookahead(
+    const PauliGraph &pg, unsigned lookahead = 8);
+
 /**
  * Construct a zx diagram from a given circuit.
  * Return the zx diagram and a map between the zx boundary vertices and the
@@ -167,6 +182,25 @@ Circuit pauli_graph_to_pauli_exp_box_circuit_sets(
 std::pair<zx::ZXDiagram, boost::bimap<zx::ZXVert, Vertex>> circuit_to_zx(
     const Circuit &circuit);
 
+/**
+ * Construct a zx diagram in graphlike form directly from a unitary circuit,
+ * without building a subdiagram per gate. Hadamards are kept on the wires
+ * and become Hadamard edges, phases accumulate on the spider at the end of
+ * each wire, and CZs toggle Hadamard edges between spiders, so the result
+ * needs no further rebasing, fusion or boundary separation.
+ *
+ * Supports H, X, Z, S, Sdg, T, Tdg, Rx, Rz, U1, CX, CZ, SWAP, noop and
+ * Barrier; the circuit phase is ignored, as in circuit_to_zx.
+ *
+ * @param circuit the circuit to convert
+ * @param bmap if given, filled with the map between the zx boundary vertices
+ *    and the circuit boundary vertices
+ * @throws Unsupported for circuits with bits or other operations
+ */
+zx::ZXDiagram circuit_to_graphlike_zx(
+    const Circuit &circuit,
+    boost::bimap<zx::ZXVert, Vertex> *bmap = nullptr);
+
 /**
  * Takes a unitary ZX diagram in MBQC form with the promise that a gflow exists.
  * Produces an equivalent circuit using the gate extraction method from
@@ -16,6 +16,7 @@
 
 #include "Converters.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Utils/BitMatrix.hpp"
 
 namespace tket {
 
@@ -28,6 +29,10 @@ class CXMaker {
   bool _reverse_cx_dirs;
 };
 
+/**
+ * Boolean matrix for linear reversible synthesis, stored with its rows
+ * bit-packed so that row additions act on whole words.
+ */
 class DiagMatrix {
  public:
   DiagMatrix() {}
@@ -41,7 +46,7 @@ class DiagMatrix {
   unsigned n_rows() const;
   unsigned n_cols() const;
 
-  MatrixXb _matrix;
+  BitMatrix _matrix;
 };
 
 }  // namespace tket
@@ -13,9 +13,15 @@
 // limitations under the License.
 
 #pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/CircUtils.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Utils/BitMatrix.hpp"
 #include "tket/Utils/HelperFunctions.hpp"
 #include "tket/Utils/Json.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
@@ -37,6 +43,40 @@ Circuit gray_synth(
     unsigned n_qubits, const std::list<phase_term_t> &parities,
     const MatrixXb &linear_transformation);
 
+/**
+ * Accumulates the phase polynomial and linear transformation of a sequence of
+ * CX and Rz gates, one gate at a time.
+ *
+ * The parity held by each qubit is a row of a BitMatrix, and the terms of the
+ * phase polynomial are kept in a hash map keyed by the packed parity, so that
+ * each gate costs time linear in the number of 64-bit words per parity.
+ */
+class PhasePolyBuilder {
+ public:
+  /** The identity on @p n_qubits qubits, with no terms. */
+  explicit PhasePolyBuilder(unsigned n_qubits);
+
+  unsigned get_n_qubits() const { return parities_.rows(); }
+
+  void add_cx(unsigned control, unsigned target);
+
+  void add_rz(unsigned qubit, const Expr &angle);
+
+  /** Return to the identity with no terms. */
+  void clear();
+
+  PhasePolynomial get_phase_polynomial() const;
+
+  MatrixXb get_linear_transformation() const;
+
+ private:
+  struct WordsHash {
+    std::size_t operator()(const std::vector<BitMatrix::Word> &words) const;
+  };
+  BitMatrix parities_;
+  std::unordered_map<std::vector<BitMatrix::Word>, Expr, WordsHash> terms_;
+};
+
 /**
  * A PhasePolyBox is capable of representing arbitrary Circuits made up of CNOT
  * and RZ, as a PhasePolynomial plus a boolean matrix representing an additional
@@ -127,6 +167,9 @@ class CircToPhasePolyConversion {
 
  private:
   enum class QubitType { pre, in, post };
+  // A gate with the indices of its qubits and bits
+  typedef std::pair<Op_ptr, std::vector<unsigned>> gate_t;
+  void add_to_box(const Op_ptr &op, const std::vector<unsigned> &args);
   void add_phase_poly_box();
   unsigned nq_;
   unsigned nb_;
@@ -134,13 +177,14 @@ class CircToPhasePolyConversion {
   unsigned box_size_;
   std::map<Qubit, unsigned> qubit_indices_;
   std::map<Bit, unsigned> bit_indices_;
+  boost::bimap<Qubit, unsigned> box_qubit_indices_;
   std::vector<QubitType> qubit_types_;
   qubit_vector_t all_qu_;
-  Circuit input_circ_;
-  Circuit box_circ_;
-  Circuit post_circ_;
+  // The box under construction, and the gates in it and after it
+  PhasePolyBuilder box_;
+  std::vector<gate_t> box_gates_;
+  std::vector<gate_t> post_gates_;
   Circuit circ_;
-  Circuit empty_circ_;
 };
 
 }  // namespace tket
@@ -14,7 +14,11 @@
 
 #pragma once
 
+#include <unordered_set>
+#include <vector>
+
 #include "DiagUtils.hpp"
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
 
 namespace tket {
 
@@ -91,6 +95,8 @@ class PauliPartitionerGraph {
 
  private:
   PauliACGraph pac_graph;
+  /** The same graph in compressed form, for the exhaustive colouring. */
+  graphs::CompressedAdjacencyData adjacency;
 };
 
 /**
@@ -103,4 +109,80 @@ std::list<std::list<SpPauliString>> term_sequence(
     const std::list<SpPauliString>& strings, PauliPartitionStrat strat,
     GraphColourMethod method = GraphColourMethod::Lazy);
 
+/**
+ * Partitions weighted Pauli terms into sets by sorted insertion, without
+ * building a graph.
+ *
+ * Terms are taken in order of decreasing coefficient magnitude, and each is
+ * added to the first existing set it is compatible with under \p strat, or
+ * else starts a new set. Checks use bit-packed strings; for
+ * NonConflictingSets each set is checked as a single combined string, so the
+ * time is O(m * sets) for m terms.
+ *
+ * @param terms Pauli terms with their coefficients
+ * @param strat compatibility required within each set
+ * @return the sets in order of creation, each with its terms in order of
+ * insertion
+ */
+std::list<std::list<SpCxPauliTensor>> term_sequence_sorted_insertion(
+    const std::list<SpCxPauliTensor>& terms, PauliPartitionStrat strat);
+
+/**
+ * Partitions Pauli strings which arrive in chunks, for operators too large to
+ * hold as a single list of SpPauliStrings.
+ *
+ * Each string is stored once, bit-packed over a numbering of the qubits in
+ * the order they are first seen, and repeats are dropped through a hash set
+ * of the packed strings. New strings are added to the first compatible set as
+ * they arrive, as for GraphColourMethod::Lazy, so after all chunks have been
+ * added the sets are those term_sequence would give for the de-duplicated
+ * strings in the same order.
+ */
+class PauliPartitionStream {
+ public:
+  explicit PauliPartitionStream(PauliPartitionStrat strat);
+
+  PauliPartitionStream(const PauliPartitionStream&) = delete;
+  PauliPartitionStream& operator=(const PauliPartitionStream&) = delete;
+  PauliPartitionStream(PauliPartitionStream&&) = default;
+  PauliPartitionStream& operator=(PauliPartitionStream&&) = default;
+
+  /**
+   * Add a chunk of strings to the partition.
+   *
+   * @return the number of strings which had not been seen before
+   */
+  std::size_t add_strings(const std::list<SpPauliString>& strings);
+
+  /** Number of distinct strings added so far. */
+  std::size_t n_strings() const { return strings_.size(); }
+
+  /** Number of sets in the partition so far. */
+  std::size_t n_sets() const { return sets_.size(); }
+
+  /** The sets so far, in order of creation, each in order of insertion. */
+  std::list<std::list<SpPauliString>> get_sets() const;
+
+ private:
+  struct PackedHash {
+    std::size_t operator()(const PackedPauliMap& paulis) const;
+  };
+  struct PackedEqual {
+    bool operator()(
+        const PackedPauliMap& first, const PackedPauliMap& second) const;
+  };
+  struct Set {
+    std::vector<const PackedPauliMap*> members;
+    // For NonConflictingSets, the Paulis of all members together
+    PackedPauliMap combined;
+  };
+
+  PauliPartitionStrat strat_;
+  std::map<Qubit, unsigned> qubit_index_;
+  std::vector<Qubit> qubits_;
+  // Elements of an unordered_set keep their addresses, so sets point to them
+  std::unordered_set<PackedPauliMap, PackedHash, PackedEqual> strings_;
+  std::vector<Set> sets_;
+};
+
 }  // namespace tket
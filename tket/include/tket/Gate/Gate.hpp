@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "tket/Ops/Op.hpp"
 #include "tket/Utils/Json.hpp"
 
@@ -51,7 +53,29 @@ class Gate : public Op {
   std::vector<Expr> get_tk1_angles() const;
   std::vector<Expr> get_params() const override;
   std::vector<Expr> get_params_reduced() const override;
+
+  /**
+   * Whether every parameter is a number, so that @ref get_numeric_params
+   * is available.
+   */
+  bool has_numeric_params() const { return numeric_; }
+
+  /**
+   * Parameter values, read without any symbolic evaluation.
+   *
+   * @throws SymbolsNotSupported unless @ref has_numeric_params
+   */
+  std::vector<double> get_numeric_params() const;
+
+  /**
+   * Value of a parameter, read without any symbolic evaluation.
+   *
+   * @param i index of the parameter
+   * @return the value, or nullopt unless @ref has_numeric_params
+   */
+  std::optional<double> get_numeric_param(unsigned i) const;
   SymSet free_symbols() const override;
+  bool is_symbolic() const override { return !symbols_.empty(); }
 
   unsigned n_qubits() const override;
 
@@ -72,6 +96,8 @@ class Gate : public Op {
 
   Eigen::MatrixXcd get_unitary() const override;
 
+  std::size_t memory_usage() const override;
+
   ~Gate() override {}
 
   /**
@@ -88,6 +114,11 @@ class Gate : public Op {
   // vector of symbolic params
   const std::vector<Expr> params_;
   unsigned n_qubits_; /**< Number of qubits, when not deducible from type */
+  // Values of params_, evaluated on construction when they are all numbers
+  std::array<double, 3> values_;
+  bool numeric_;
+  // Free symbols of params_, found on construction
+  SymSet symbols_;
 };
 
 }  // namespace tket
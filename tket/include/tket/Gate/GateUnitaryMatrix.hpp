@@ -14,12 +14,35 @@
 
 #pragma once
 
+#include <optional>
+
 #include "tket/OpType/OpType.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
 
 namespace tket {
 class Gate;
 
+/** The unitary of a gate on a variable number of qubits, in a form which
+ *  a simulator can apply directly, without the O(4^n) dense matrix or the
+ *  O(2^n) triplets. Uses ILO-BE convention.
+ */
+struct GateUnitaryStructure {
+  enum class Kind {
+    /** The identity unless every qubit but the last (the controls) is |1>,
+     *  in which case u acts on the last qubit (e.g. CnX, CnRy).
+     */
+    Controlled,
+    /** Diagonal, multiplying each basis state by u(p, p), where p is the
+     *  parity of its bits (PhaseGadget).
+     */
+    ParityPhase,
+    /** u acting on every qubit (NPhasedX). */
+    Product
+  };
+  Kind kind;
+  Eigen::Matrix2cd u;
+};
+
 /** Functions to return the unitary matrix which a gate represents.
  *  All functions can throw GateUnitaryMatrixError exceptions.
  *  All functions will detect size mismatches (i.e., wrong number
@@ -50,6 +73,31 @@ struct GateUnitaryMatrix {
    */
   static std::vector<TripletCd> get_unitary_triplets(
       const Gate& gate, double abs_epsilon = EPS);
+
+  /** The unitary of the gate in structured form, if it is one of CnX, CnY,
+   *  CnZ, CCX, CnRy, PhaseGadget or NPhasedX; otherwise null.
+   *  Throws GateUnitaryMatrixError upon error.
+   */
+  static std::optional<GateUnitaryStructure> get_unitary_structure(
+      const Gate& gate);
+
+  /** The unitary matrices of one gate type at many parameter values,
+   *  computed together with vectorised trigonometric functions.
+   *  Supports Rx, Ry, Rz, PhasedX and TK1 (2x2 matrices), and XXPhase,
+   *  YYPhase, ZZPhase and TK2 (4x4 matrices). Uses ILO-BE convention.
+   *  Throws GateUnitaryMatrixError if the type is not supported or the
+   *  number of parameters is wrong, but does not check if the parameter
+   *  values are all finite.
+   *  @param optype The gate type.
+   *  @param parameters One row for each gate and one column for each
+   *          parameter.
+   *  @return One column for each gate, holding the entries of its matrix in
+   *          column-major order; so column k of the result, mapped as a
+   *          2x2 or 4x4 matrix, is the unitary of the gate with the
+   *          parameters in row k.
+   */
+  static Eigen::MatrixXcd get_unitaries(
+      OpType optype, const Eigen::MatrixXd& parameters);
 };
 
 }  // namespace tket
@@ -20,12 +20,29 @@
 
 namespace tket {
 
-/** A faithful representation of SU(2). */
+/**
+ * A faithful representation of SU(2).
+ *
+ * While every angle applied is numeric, the rotation is held in doubles and
+ * only converted to expressions when it is read out or composed with a
+ * symbolic rotation.
+ */
 class Rotation {
  public:
   /** Identity */
   Rotation()
-      : rep_(Rep::id), s_(1), i_(0), j_(0), k_(0), optype_(OpType::noop) {}
+      : rep_(Rep::id),
+        s_(1),
+        i_(0),
+        j_(0),
+        k_(0),
+        optype_(OpType::noop),
+        numeric_(true),
+        ns_(1.),
+        ni_(0.),
+        nj_(0.),
+        nk_(0.),
+        na_(0.) {}
 
   /**
    * Represent an X, Y or Z rotation
@@ -89,6 +106,20 @@ class Rotation {
   // If rep_ == Rep::orth_rot, we represent the rotation as an axis and angle:
   OpType optype_;
   Expr a_;
+
+  // If numeric_, the coefficients and angle above are unused and these hold
+  // their values instead:
+  bool numeric_;
+  double ns_;
+  double ni_;
+  double nj_;
+  double nk_;
+  double na_;
+
+  void apply_numeric(const Rotation& other);
+  void apply_symbolic(const Rotation& other);
+  // Switch from the numeric to the symbolic representation
+  void make_symbolic();
 };
 
 /**
@@ -29,19 +29,30 @@ void clear_symbol_table();
  * All members are static. There are no instances of this class.
  *
  * When an operation is created using \p get_op_ptr, any symbols in its
- * parameters are added to a global registry of symbols.
+ * parameters are added to a global registry of symbols. The registry also
+ * interns symbols, so that all symbols obtained from it with the same name
+ * share one instance.
+ *
+ * The registry is split into independently locked shards by name, so it may
+ * be used from several threads with little contention.
  */
 struct SymTable {
   /** Create a new symbol (not currently registered), and register it */
   static Sym fresh_symbol(const std::string &preferred = "a");
 
+  /**
+   * Get the registered symbol with a given name, registering it if there is
+   * none
+   */
+  static Sym intern(const std::string &name);
+
   static void register_symbol(const std::string &symbol);
 
   static void register_symbols(const SymSet &ss);
 
  private:
   friend void test_Ops::clear_symbol_table();
-  static std::unordered_set<std::string> &get_registered_symbols();
+  static void clear();
 };
 
 }  // namespace tket
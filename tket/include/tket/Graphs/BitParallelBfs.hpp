@@ -0,0 +1,70 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "tket/Utils/MemoryUsage.hpp"
+
+namespace tket::graphs {
+
+/**
+ * Breadth-first search over an adjacency bit matrix: each level of the
+ * search ORs together the rows of the frontier vertices, 64 vertices per
+ * word, rather than visiting neighbours one at a time. For a dense graph
+ * (e.g. a device with all-to-all or near all-to-all couplers) this is
+ * much faster than an adjacency-list search from every root.
+ * The vertices are {0,1,2,...,n-1}.
+ */
+class BitParallelBfs {
+ public:
+  /**
+   * @param number_of_vertices The number of vertices, n.
+   * @param edges The undirected edges (i,j); duplicates are allowed.
+   */
+  BitParallelBfs(
+      std::size_t number_of_vertices,
+      const std::vector<std::pair<std::size_t, std::size_t>>& edges);
+
+  /**
+   * Whether a graph with this many vertices and (undirected) edges is
+   * dense enough that searching over the bit matrix is expected to beat
+   * an ordinary adjacency-list search.
+   */
+  static bool is_dense(
+      std::size_t number_of_vertices, std::size_t number_of_edges);
+
+  /**
+   * The distances from the root to every vertex, indexed by vertex.
+   * As with run_bfs, unreachable vertices (and the root) get 0.
+   * @param root The vertex to search from.
+   */
+  std::vector<std::size_t> get_distances(std::size_t root) const;
+
+  /** Estimated bytes held, including the object itself. */
+  std::size_t memory_usage() const {
+    return sizeof(BitParallelBfs) + memory::container_bytes(m_bits);
+  }
+
+ private:
+  std::size_t m_number_of_vertices;
+  std::size_t m_words_per_row;
+  std::vector<std::uint64_t> m_bits;
+};
+
+}  // namespace tket::graphs
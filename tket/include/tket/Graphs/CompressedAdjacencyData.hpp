@@ -0,0 +1,103 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tket {
+namespace graphs {
+
+class AdjacencyData;
+
+/**
+ * Data for an undirected graph, with the same meaning as AdjacencyData,
+ * but immutable and stored in compressed sparse row (CSR) format:
+ * the neighbours of every vertex are stored contiguously, in increasing
+ * order, in a single array. This avoids the per-node overhead of std::set,
+ * which dominates the memory for the large graphs built during
+ * Pauli partitioning.
+ * If the graph is dense enough that an adjacency bit matrix would not
+ * take more memory than the neighbour array, one is also stored,
+ * so that edge_exists is a single bit lookup rather than a binary search.
+ * The vertices are {0,1,2,...,v-1}.
+ */
+class CompressedAdjacencyData {
+ public:
+  /**
+   * Initialise with N vertices, no edges.
+   */
+  explicit CompressedAdjacencyData(std::size_t number_of_vertices = 0);
+
+  /**
+   * Copy the graph from an existing AdjacencyData object.
+   */
+  explicit CompressedAdjacencyData(const AdjacencyData& adjacency_data);
+
+  /**
+   * Construct from a list of edges, in any order. Duplicate edges
+   * (including i-j listed as both (i,j) and (j,i)) are allowed,
+   * and simply ignored. Throws if a vertex is invalid.
+   * @param number_of_vertices The number of vertices, v.
+   *   The actual vertices will be {0,1,2,...,v-1}.
+   * @param edges The undirected edges (i,j).
+   */
+  CompressedAdjacencyData(
+      std::size_t number_of_vertices,
+      const std::vector<std::pair<std::size_t, std::size_t>>& edges);
+
+  /** For a given vertex v, return all vertices j such that j-v is an edge,
+   * in increasing order.
+   */
+  std::span<const std::size_t> get_neighbours(std::size_t vertex) const;
+
+  /** Returns the total number of vertices in the graph.
+   */
+  std::size_t get_number_of_vertices() const;
+
+  /** Returns the total number of edges in the graph (i->j and j->i counting as
+   * one edge).
+   */
+  std::size_t get_number_of_edges() const;
+
+  /** Returns true if and only if the edge i-j exists. */
+  bool edge_exists(std::size_t i, std::size_t j) const;
+
+  /** Returns true if the adjacency bit matrix is stored. */
+  bool has_bit_matrix() const;
+
+ private:
+  // Element i is the position in m_neighbours of the first neighbour of
+  // vertex i; there is one extra element at the end, the total size.
+  std::vector<std::size_t> m_offsets;
+  std::vector<std::size_t> m_neighbours;
+  std::size_t m_number_of_edges;
+
+  // If nonempty, row i (of m_words_per_row words) has bit j set
+  // if and only if i-j is an edge.
+  std::vector<std::uint64_t> m_bit_matrix;
+  std::size_t m_words_per_row;
+
+  // Once m_offsets and m_neighbours are filled (with the rows sorted
+  // and without duplicates), count the edges and fill the bit matrix
+  // if it's worthwhile.
+  void finish_construction();
+};
+
+}  // namespace graphs
+}  // namespace tket
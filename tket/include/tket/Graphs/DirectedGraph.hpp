@@ -17,18 +17,24 @@
 #include <algorithm>
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/iterator_range_core.hpp>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "tket/Graphs/AbstractGraph.hpp"
+#include "tket/Graphs/BitParallelBfs.hpp"
 #include "tket/Graphs/TreeSearch.hpp"
 #include "tket/Graphs/Utils.hpp"
 #include "tket/Utils/GraphHeaders.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 
 namespace tket::graphs {
 
@@ -45,6 +51,48 @@ class NodesNotConnected : public std::logic_error {
             node1.repr() + " and " + node2.repr() + " are not connected") {}
 };
 
+/**
+ * Distances between all pairs of vertices of a graph, stored densely.
+ *
+ * A value of zero for distinct vertices means that they are disconnected.
+ */
+class DistanceMatrix {
+ public:
+  explicit DistanceMatrix(std::size_t n) : n_(n), distances_(n * n, 0) {}
+
+  /**
+   * Construct from distances stored row by row.
+   *
+   * @throws std::invalid_argument if there are not n * n distances
+   */
+  DistanceMatrix(std::size_t n, std::vector<uint16_t> distances)
+      : n_(n), distances_(std::move(distances)) {
+    if (distances_.size() != n * n) {
+      throw std::invalid_argument("Distance matrix has the wrong size");
+    }
+  }
+
+  /** Number of vertices. */
+  std::size_t size() const { return n_; }
+
+  /** Distance between two vertices, given by index. */
+  uint16_t operator()(std::size_t i, std::size_t j) const {
+    return distances_[i * n_ + j];
+  }
+
+  /** Distances from vertex i, for writing. */
+  uint16_t* row(std::size_t i) { return distances_.data() + i * n_; }
+
+  /** Estimated bytes held, including the object itself. */
+  std::size_t memory_usage() const {
+    return sizeof(DistanceMatrix) + memory::container_bytes(distances_);
+  }
+
+ private:
+  std::size_t n_;
+  std::vector<uint16_t> distances_;
+};
+
 /** Weighted edge */
 struct WeightedEdge {
   explicit WeightedEdge(unsigned w = 1) : weight(w) {}
@@ -409,10 +457,11 @@ class DirectedGraph : public DirectedGraphBase<T> {
   const std::vector<std::size_t>& get_distances(const T& root) const& {
     // We cache distances. A value of zero in the cache implies that the nodes
     // are disconnected (unless they are equal).
-    if (distance_cache.find(root) == distance_cache.end()) {
-      distance_cache[root] = Base::get_distances(root);
+    auto found = distance_cache.find(root);
+    if (found == distance_cache.end()) {
+      found = distance_cache.insert({root, compute_distances(root)}).first;
     }
-    return distance_cache[root];
+    return found->second;
   }
 
   /**
@@ -420,7 +469,7 @@ class DirectedGraph : public DirectedGraphBase<T> {
    */
   std::vector<std::size_t>&& get_distances(const T& root) const&& {
     if (distance_cache.find(root) == distance_cache.end()) {
-      distance_cache[root] = Base::get_distances(root);
+      distance_cache[root] = compute_distances(root);
     }
     return std::move(distance_cache[root]);
   }
@@ -430,12 +479,15 @@ class DirectedGraph : public DirectedGraphBase<T> {
       return 0;
     }
     std::size_t d;
-    if (distance_cache.find(node1) != distance_cache.end()) {
+    if (distance_matrix) {
+      d = (*distance_matrix)(
+          this->to_vertices(node1), this->to_vertices(node2));
+    } else if (distance_cache.find(node1) != distance_cache.end()) {
       d = distance_cache[node1][this->to_vertices(node2)];
     } else if (distance_cache.find(node2) != distance_cache.end()) {
       d = distance_cache[node2][this->to_vertices(node1)];
     } else {
-      distance_cache[node1] = Base::get_distances(node1);
+      distance_cache[node1] = compute_distances(node1);
       d = distance_cache[node1][this->to_vertices(node2)];
     }
     if (d == 0) {
@@ -444,24 +496,203 @@ class DirectedGraph : public DirectedGraphBase<T> {
     return d;
   }
 
+  /**
+   * Compute the distances between all pairs of nodes, with one breadth-first
+   * search from each node, divided between threads. For dense graphs the
+   * searches run over an adjacency bit matrix (see BitParallelBfs).
+   *
+   * Until the graph is modified, get_distance then looks distances up in
+   * the matrix, and copies of the graph share it, so it can be used by many
+   * routing jobs on the same device without recomputation.
+   *
+   * @param n_threads number of threads; 0 means as many as the hardware
+   *   supports
+   * @return the matrix, indexed by @ref get_node_index
+   * @throws std::invalid_argument if the graph has more than 65536 nodes
+   */
+  std::shared_ptr<const DistanceMatrix> precompute_distances(
+      unsigned n_threads = 0) const {
+    const std::size_t n = n_nodes();
+    if (n > 65536) {
+      throw std::invalid_argument(
+          "Too many nodes for a precomputed distance matrix");
+    }
+    const UndirectedConnGraph& undirected = get_undirected_connectivity();
+    const BitParallelBfs* bit_parallel_bfs = get_bit_parallel_bfs();
+    std::shared_ptr<DistanceMatrix> matrix =
+        std::make_shared<DistanceMatrix>(n);
+    auto run_searches = [&](std::size_t first, std::size_t stride) {
+      for (std::size_t i = first; i < n; i += stride) {
+        const std::vector<std::size_t> dists =
+            bit_parallel_bfs ? bit_parallel_bfs->get_distances(i)
+                             : run_bfs(i, undirected).get_dists();
+        std::copy(dists.begin(), dists.end(), matrix->row(i));
+      }
+    };
+    if (n_threads == 0) {
+      n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    n_threads = std::min<std::size_t>(n_threads, std::max<std::size_t>(n, 1));
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < n_threads; t++) {
+      threads.emplace_back(run_searches, t, n_threads);
+    }
+    run_searches(0, n_threads);
+    for (std::thread& thread : threads) thread.join();
+    distance_matrix = matrix;
+    return distance_matrix;
+  }
+
+  /** The precomputed distance matrix, or null if there is none. */
+  std::shared_ptr<const DistanceMatrix> get_distance_matrix() const {
+    return distance_matrix;
+  }
+
+  /** Index of a node in the distance matrix. */
+  std::size_t get_node_index(const T& node) const {
+    return this->to_vertices(node);
+  }
+
+  /**
+   * Estimated bytes held by the graph and by its caches of distances,
+   * neighbours and search structures (see tket/Utils/MemoryUsage.hpp). For
+   * large graphs the distances, at two bytes per pair of nodes once frozen,
+   * usually dominate.
+   */
+  std::size_t memory_usage() const {
+    // Each edge is a list node, referenced from the out-edges of its source
+    // and the in-edges of its target.
+    std::size_t bytes =
+        sizeof(*this) + memory::container_bytes(this->nodes_) +
+        n_nodes() * (sizeof(T) + 2 * sizeof(std::vector<Vertex>)) +
+        boost::num_edges(this->graph) *
+            (2 * sizeof(Vertex) + sizeof(WeightedEdge) +
+             memory::LIST_NODE_OVERHEAD + 4 * sizeof(void*)) +
+        memory::multi_index_bytes(this->node_to_vertex, 2);
+    bytes += memory::container_bytes(distance_cache);
+    for (const auto& [node, distances] : distance_cache) {
+      bytes += memory::container_bytes(distances);
+    }
+    if (distance_matrix) {
+      bytes +=
+          memory::SHARED_CONTROL_OVERHEAD + distance_matrix->memory_usage();
+    }
+    bytes += memory::container_bytes(neighbour_cache);
+    for (const std::set<T>& neighbours : neighbour_cache) {
+      bytes += memory::container_bytes(neighbours);
+    }
+    if (undir_graph) {
+      // Here each edge is referenced from a set at each end.
+      bytes += boost::num_vertices(*undir_graph) *
+                   (sizeof(T) + sizeof(std::set<Vertex>)) +
+               boost::num_edges(*undir_graph) *
+                   (2 * sizeof(Vertex) + sizeof(WeightedEdge) +
+                    memory::LIST_NODE_OVERHEAD +
+                    2 * (2 * sizeof(void*) + memory::TREE_NODE_OVERHEAD));
+    }
+    if (bit_parallel_search && *bit_parallel_search) {
+      bytes += memory::SHARED_CONTROL_OVERHEAD +
+               (*bit_parallel_search)->memory_usage();
+    }
+    return bytes;
+  }
+
   unsigned get_diameter() override {
     unsigned N = n_nodes();
     if (N == 0) {
       throw std::logic_error("Graph is empty.");
     }
     if (!this->diameter_) {
-      this->diameter_ = 0;
+      // Only store the diameter once it is known, so that a disconnected
+      // graph always throws.
+      unsigned diameter = 0;
       const std::vector<T> nodes = get_all_nodes_vec();
       for (unsigned i = 0; i < N; i++) {
         for (unsigned j = i + 1; j < N; j++) {
           unsigned d = get_distance(nodes[i], nodes[j]);
-          if (d > *this->diameter_) this->diameter_ = d;
+          if (d > diameter) diameter = d;
         }
       }
+      this->diameter_ = diameter;
     }
     return *this->diameter_;
   }
 
+  /**
+   * Precompute the distances between all pairs of nodes, the neighbours of
+   * each node, the undirected connectivity and (if the graph is connected)
+   * the diameter, and make the graph immutable.
+   *
+   * Reading methods then only look up this data, so that a frozen graph
+   * (e.g. an architecture shared between routing jobs) may be read from
+   * several threads at once. Copies of a frozen graph are also frozen.
+   *
+   * @param n_threads number of threads for computing distances; 0 means as
+   *   many as the hardware supports
+   */
+  void freeze(unsigned n_threads = 0) {
+    if (frozen) return;
+    freeze_with(precompute_distances(n_threads));
+  }
+
+  /**
+   * Freeze the graph as @ref freeze does, but with distances computed
+   * earlier (e.g. read from a file) instead of computing them.
+   *
+   * @param matrix distances indexed by @ref get_node_index
+   * @param diameter the diameter, if known; ignored unless the graph is
+   *   connected
+   * @throws std::invalid_argument if the matrix has the wrong size
+   */
+  void freeze_with(
+      std::shared_ptr<const DistanceMatrix> matrix,
+      std::optional<unsigned> diameter = std::nullopt) {
+    if (frozen) return;
+    const std::size_t n = matrix->size();
+    if (n != n_nodes()) {
+      throw std::invalid_argument(
+          "Distance matrix does not match the number of nodes");
+    }
+    distance_matrix = std::move(matrix);
+    neighbour_cache.resize(n);
+    bool connected = true;
+    for (std::size_t i = 0; i < n; i++) {
+      const T node = this->get_node(i);
+      std::vector<std::size_t>& dists = distance_cache[node];
+      dists.resize(n);
+      for (std::size_t j = 0; j < n; j++) {
+        dists[j] = (*distance_matrix)(i, j);
+        if (i != j && dists[j] == 0) connected = false;
+      }
+      neighbour_cache[i] = Base::get_neighbour_nodes(node);
+    }
+    if (connected && n > 0) {
+      if (diameter) this->diameter_ = diameter;
+      get_diameter();
+    }
+    frozen = true;
+  }
+
+  /** Whether the graph has been frozen by @ref freeze */
+  bool is_frozen() const { return frozen; }
+
+  /**
+   * Make a frozen graph modifiable again, e.g. a copy of a frozen graph
+   * that is to be modified. Precomputed data is kept until it is modified.
+   */
+  void thaw() {
+    frozen = false;
+    neighbour_cache.clear();
+  }
+
+  /** Get all neighbours of a node. */
+  std::set<T> get_neighbour_nodes(const T& node) const {
+    if (frozen && node_exists(node)) {
+      return neighbour_cache[this->to_vertices(node)];
+    }
+    return Base::get_neighbour_nodes(node);
+  }
+
   /** Returns all nodes at a given distance from a given 'source' node */
   std::vector<T> nodes_at_distance(const T& root, std::size_t distance) const {
     auto dists = get_distances(root);
@@ -531,11 +762,49 @@ class DirectedGraph : public DirectedGraphBase<T> {
 
  private:
   inline void invalidate_cache() {
+    if (frozen) {
+      throw std::logic_error("Cannot modify a frozen graph");
+    }
     distance_cache.clear();
+    distance_matrix = nullptr;
     undir_graph = std::nullopt;
+    bit_parallel_search = std::nullopt;
+  }
+
+  // The bit matrix search, if the graph is dense enough to benefit,
+  // or null otherwise.
+  const BitParallelBfs* get_bit_parallel_bfs() const {
+    if (!bit_parallel_search) {
+      const UndirectedConnGraph& undirected = get_undirected_connectivity();
+      const std::size_t n = boost::num_vertices(undirected);
+      bit_parallel_search = nullptr;
+      if (BitParallelBfs::is_dense(n, boost::num_edges(undirected))) {
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        for (auto [it, end] = boost::edges(undirected); it != end; ++it) {
+          edges.emplace_back(
+              boost::source(*it, undirected), boost::target(*it, undirected));
+        }
+        bit_parallel_search = std::make_shared<const BitParallelBfs>(n, edges);
+      }
+    }
+    return bit_parallel_search->get();
   }
+
+  std::vector<std::size_t> compute_distances(const T& root) const {
+    const BitParallelBfs* bit_parallel_bfs = get_bit_parallel_bfs();
+    if (bit_parallel_bfs == nullptr || !node_exists(root)) {
+      return Base::get_distances(root);
+    }
+    return bit_parallel_bfs->get_distances(this->to_vertices(root));
+  }
+
   mutable std::map<T, std::vector<std::size_t>> distance_cache;
+  mutable std::shared_ptr<const DistanceMatrix> distance_matrix;
+  std::vector<std::set<T>> neighbour_cache;
+  bool frozen = false;
   mutable std::optional<UndirectedConnGraph> undir_graph;
+  mutable std::optional<std::shared_ptr<const BitParallelBfs>>
+      bit_parallel_search;
 };
 
 }  // namespace tket::graphs
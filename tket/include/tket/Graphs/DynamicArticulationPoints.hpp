@@ -0,0 +1,96 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace tket {
+namespace graphs {
+
+/**
+ * The articulation points of an undirected graph, kept up to date while
+ * vertices are removed one at a time.
+ *
+ * The graph is stored as its blocks (biconnected components, each a set of
+ * vertices; a bridge is a block of two vertices). A vertex is an
+ * articulation point exactly when it lies in two or more blocks.
+ * Removing a vertex v can only change the blocks containing v, so only
+ * the subgraph spanned by those blocks is re-split, rather than the whole
+ * graph. For a sparse, tree-like device this is much cheaper than
+ * recomputing; for a graph which is a single block it is no worse.
+ * The vertices are {0,1,2,...,v-1}.
+ */
+class DynamicArticulationPoints {
+ public:
+  /**
+   * Construct from a list of undirected edges, in any order.
+   * Duplicate edges and loops are ignored.
+   * @param number_of_vertices The number of vertices, v.
+   * @param edges The undirected edges (i,j).
+   */
+  DynamicArticulationPoints(
+      std::size_t number_of_vertices,
+      const std::vector<std::pair<std::size_t, std::size_t>>& edges);
+
+  /**
+   * Remove a vertex and all its edges, updating the blocks
+   * and articulation points. Does nothing if it is already removed.
+   * @param vertex The vertex to remove.
+   */
+  void remove_vertex(std::size_t vertex);
+
+  /** Whether the vertex has not been removed. */
+  bool contains(std::size_t vertex) const;
+
+  /** Whether removing the vertex would disconnect its component. */
+  bool is_articulation_point(std::size_t vertex) const;
+
+  /** All current articulation points. */
+  const std::set<std::size_t>& get_articulation_points() const;
+
+  /** The number of vertices not yet removed. */
+  std::size_t get_number_of_vertices() const;
+
+ private:
+  std::vector<std::set<std::size_t>> m_neighbours;
+  std::vector<bool> m_removed;
+  std::size_t m_number_of_vertices;
+
+  // Element i is the vertex set of block i (empty if it no longer exists).
+  std::vector<std::vector<std::size_t>> m_blocks;
+  std::vector<std::size_t> m_unused_block_ids;
+
+  // The ids of the blocks containing each vertex.
+  std::vector<std::set<std::size_t>> m_vertex_blocks;
+  std::set<std::size_t> m_articulation_points;
+
+  // Scratch data for the search: discovery times (0 meaning unvisited,
+  // or not in the subgraph being searched) and low points.
+  std::vector<std::size_t> m_discovery;
+  std::vector<std::size_t> m_low;
+
+  // Split the subgraph induced by the given vertices into blocks,
+  // and add them.
+  void add_blocks(const std::vector<std::size_t>& vertices);
+
+  void add_block(std::vector<std::size_t> block);
+  void update_status(std::size_t vertex);
+};
+
+}  // namespace graphs
+}  // namespace tket
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cstddef>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -22,6 +23,7 @@ namespace tket {
 namespace graphs {
 
 class AdjacencyData;
+class CompressedAdjacencyData;
 
 /**
  * The calculated colouring for a graph.
@@ -53,6 +55,28 @@ struct GraphColouringResult {
   explicit GraphColouringResult(const std::vector<std::size_t>& colours);
 };
 
+/**
+ * Options for GraphColouringRoutines::get_colouring. The defaults give
+ * the same (exact, single-threaded) colouring as the overload without options.
+ */
+struct GraphColouringOptions {
+  /**
+   * Connected components are independent, so they can be coloured
+   * concurrently on this many threads (0 means one per hardware thread).
+   * Every component then starts from the largest clique size over the
+   * whole graph, so the number of colours is unchanged.
+   */
+  unsigned number_of_threads = 1;
+
+  /**
+   * If set, the exact (exponential-time) colouring of any component
+   * still unfinished after this many milliseconds is abandoned, and the
+   * component is instead coloured greedily, which is fast but may use
+   * more colours than necessary.
+   */
+  std::optional<unsigned> timeout_ms;
+};
+
 /**
  * It's expected that more routines will be added over time!
  */
@@ -63,6 +87,68 @@ struct GraphColouringRoutines {
    */
   static GraphColouringResult get_colouring(
       const AdjacencyData& adjacency_data);
+
+  /** As above, for a graph in compressed format, which uses much less
+   * memory for large graphs.
+   * @param adjacency_data The graph to be coloured.
+   */
+  static GraphColouringResult get_colouring(
+      const CompressedAdjacencyData& adjacency_data);
+
+  /**
+   * The main colouring function, with threads and a time limit.
+   * @param adjacency_data The graph to be coloured.
+   * @param options How much effort to spend.
+   */
+  static GraphColouringResult get_colouring(
+      const AdjacencyData& adjacency_data,
+      const GraphColouringOptions& options);
+
+  /** As above, for a graph in compressed format.
+   * @param adjacency_data The graph to be coloured.
+   * @param options How much effort to spend.
+   */
+  static GraphColouringResult get_colouring(
+      const CompressedAdjacencyData& adjacency_data,
+      const GraphColouringOptions& options);
+
+  /**
+   * A fast greedy (DSatur) colouring, for graphs too large to
+   * colour exactly. The colouring is valid, but may not be optimal.
+   * @param adjacency_data The graph to be coloured.
+   */
+  static GraphColouringResult get_greedy_colouring(
+      const AdjacencyData& adjacency_data);
+
+  /** As above, for a graph in compressed format.
+   * @param adjacency_data The graph to be coloured.
+   */
+  static GraphColouringResult get_greedy_colouring(
+      const CompressedAdjacencyData& adjacency_data);
+
+  /**
+   * Repair a colouring of a slightly different graph (e.g., after a few
+   * vertices or edges were added or removed), without recolouring from
+   * scratch. Previous colours are kept where they are still valid;
+   * new vertices, and one endpoint of each edge whose endpoints now clash,
+   * are then coloured greedily. Colours are relabelled to remove gaps.
+   * @param adjacency_data The new graph.
+   * @param previous_colours Element i is the previous colour of vertex i,
+   *  or std::numeric_limits<std::size_t>::max() if vertex i is new.
+   *  If it is shorter than the number of vertices, the remaining vertices
+   *  are also new; extra elements are ignored.
+   */
+  static GraphColouringResult update_colouring(
+      const AdjacencyData& adjacency_data,
+      const std::vector<std::size_t>& previous_colours);
+
+  /** As above, for a graph in compressed format.
+   * @param adjacency_data The new graph.
+   * @param previous_colours The previous colour of each vertex.
+   */
+  static GraphColouringResult update_colouring(
+      const CompressedAdjacencyData& adjacency_data,
+      const std::vector<std::size_t>& previous_colours);
 };
 
 }  // namespace graphs
@@ -23,11 +23,12 @@ namespace tket {
 namespace graphs {
 
 class AdjacencyData;
+class CompressedAdjacencyData;
 
 /**
  * General easily reusable routines related to graphs. These are not
  * methods of the class AdjacencyData because they can be done efficiently
- * just with public methods of AdjacencyData.
+ * just with public methods of AdjacencyData, or CompressedAdjacencyData.
  */
 struct GraphRoutines {
   /**
@@ -38,6 +39,10 @@ struct GraphRoutines {
    */
   static std::vector<std::set<std::size_t>> get_connected_components(
       const AdjacencyData& adjacency_data);
+
+  /** As above, for a graph in compressed format. */
+  static std::vector<std::set<std::size_t>> get_connected_components(
+      const CompressedAdjacencyData& adjacency_data);
 };
 
 }  // namespace graphs
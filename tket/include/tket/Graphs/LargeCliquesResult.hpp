@@ -22,6 +22,7 @@ namespace tket {
 namespace graphs {
 
 class AdjacencyData;
+class CompressedAdjacencyData;
 
 /** Try to find large cliques in a single connected component of a graph. */
 struct LargeCliquesResult {
@@ -55,6 +56,12 @@ struct LargeCliquesResult {
       const AdjacencyData& adjacency_data,
       const std::set<std::size_t>& vertices_in_component,
       std::size_t internal_size_limit = 100);
+
+  /** As above, for a graph in compressed format. */
+  LargeCliquesResult(
+      const CompressedAdjacencyData& adjacency_data,
+      const std::set<std::size_t>& vertices_in_component,
+      std::size_t internal_size_limit = 100);
 };
 
 }  // namespace graphs
@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include "tket/Mapping/LexiRouteSwapCache.hpp"
 #include "tket/Mapping/LexicographicalComparison.hpp"
+#include "tket/Mapping/LinkErrorDistances.hpp"
 #include "tket/Mapping/MappingFrontier.hpp"
 #include "tket/Mapping/RoutingMethod.hpp"
 #include "tket/Mapping/RoutingMethodJson.hpp"
@@ -40,10 +42,17 @@ class LexiRoute {
    * Class Constructor
    * @param _architecture Architecture object added operations must respect
    * @param _mapping_frontier Contains Circuit object to be modified
+   * @param _swap_cache If given, SWAPs chosen by solve are memoised by
+   * frontier here
+   * @param _error_distances If given, solve only considers the SWAPs that
+   * minimise the expected error of bringing interacting Nodes together, and
+   * uses lookahead to break ties between them
    */
   LexiRoute(
       const ArchitecturePtr& _architecture,
-      MappingFrontier_ptr& _mapping_frontier);
+      MappingFrontier_ptr& _mapping_frontier,
+      std::shared_ptr<LexiRouteSwapCache> _swap_cache = nullptr,
+      std::shared_ptr<const LinkErrorDistances> _error_distances = nullptr);
 
   /**
    * When called, LexiRoute::solve will modify the Circuit held in
@@ -55,10 +64,17 @@ class LexiRoute {
    *
    * @param lookahead Number of slices to lookahead at when determining best
    * SWAP or BRIDGE
+   * @param n_threads Maximum number of threads for comparing candidate SWAPs
+   * (see LexicographicalComparison::remove_swaps_lexicographical)
+   * @param deadline If set, the lookahead stops once this point has passed
+   * and the best SWAP found so far is used
    *
    * @return True if solve has modified circuit for mapping purposes
    */
-  bool solve(unsigned lookahead);
+  bool solve(
+      unsigned lookahead, unsigned n_threads = 1,
+      std::optional<std::chrono::steady_clock::time_point> deadline =
+          std::nullopt);
 
   /**
    * When called an "unlabelled" Qubit in the Circuit may be relabelled to a
@@ -168,6 +184,14 @@ class LexiRoute {
    */
   void remove_swaps_decreasing(swap_set_t& swaps);
 
+  /**
+   * Keep only the swaps minimising the cost of the SWAP plus the sum of
+   * error weighted distances between interacting Nodes after it.
+   *
+   * @param swaps Potential swaps to remove from
+   */
+  void remove_swaps_by_error(swap_set_t& swaps);
+
   /**
    * In some cases, we may want to assign an unlabelled Qubit
    * to a Node that's already been used (but can reasonably be reassigned)
@@ -222,6 +246,10 @@ class LexiRoute {
   unit_map_t labelling_;
   //   Set tracking which Architecture Node are present in Circuit
   std::set<Node> assigned_nodes_;
+  //   Memo table of chosen SWAP by frontier, if any
+  std::shared_ptr<LexiRouteSwapCache> swap_cache_;
+  //   Link error weighted distances for scoring SWAPs, if any
+  std::shared_ptr<const LinkErrorDistances> error_distances_;
 };
 
 }  // namespace tket
@@ -25,9 +25,22 @@ class LexiRouteRoutingMethod : public RoutingMethod {
    * Checking and Routing methods redefined using LexiRoute. Only circuit depth,
    * corresponding to lookahead, is a required parameter.
    *
+   * Candidate SWAPs are compared on up to \p _n_threads threads if the
+   * architecture has a precomputed distance matrix (which is computed on
+   * first use if needed). This does not change the result, and is not
+   * serialized.
+   *
+   * If \p _swap_cache_size is non-zero, SWAPs are memoised by frontier in a
+   * LexiRouteSwapCache of that many entries, shared by every call. This can
+   * change the result and is not serialized.
+   *
    * @param _max_depth Number of layers of gates checked inr outed subcircuit.
+   * @param _n_threads Maximum number of threads for comparing SWAPs.
+   * @param _swap_cache_size Number of frontiers to memoise SWAPs for.
    */
-  LexiRouteRoutingMethod(unsigned _max_depth = 100);
+  LexiRouteRoutingMethod(
+      unsigned _max_depth = 100, unsigned _n_threads = 1,
+      std::size_t _swap_cache_size = 0);
 
   /**
    * @param mapping_frontier Contains boundary of routed/unrouted circuit for
@@ -47,12 +60,24 @@ class LexiRouteRoutingMethod : public RoutingMethod {
    */
   unsigned get_max_depth() const;
 
+  /**
+   * @return Maximum number of threads used for comparing SWAPs
+   */
+  unsigned get_n_threads() const;
+
+  /**
+   * @return Memo table of SWAPs, or null if not memoising
+   */
+  std::shared_ptr<LexiRouteSwapCache> get_swap_cache() const;
+
   nlohmann::json serialize() const override;
 
   static LexiRouteRoutingMethod deserialize(const nlohmann::json& j);
 
  private:
   unsigned max_depth_;
+  unsigned n_threads_;
+  std::shared_ptr<LexiRouteSwapCache> swap_cache_;
 };
 
 JSON_DECL(LexiRouteRoutingMethod);
@@ -0,0 +1,78 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+
+#include "tket/Mapping/LexicographicalComparison.hpp"
+
+namespace tket {
+
+/**
+ * Memo table of the SWAP chosen by LexiRoute for a frontier.
+ *
+ * Keyed on the pairs of Architecture Node interacting at the frontier,
+ * i.e. the interaction pattern under the current labelling. Layered
+ * circuits present the same frontier repeatedly, and a hit skips the
+ * candidate comparison and lookahead of LexiRoute::solve. As lookahead
+ * past the frontier is not part of the key, a hit may differ from what a
+ * full search would choose at that point in the Circuit.
+ *
+ * The least recently used entry is evicted once full. Safe to share between
+ * threads.
+ */
+class LexiRouteSwapCache {
+ public:
+  /**
+   * @param capacity Maximum number of entries, at least 1
+   */
+  explicit LexiRouteSwapCache(std::size_t capacity);
+
+  /**
+   * Look up the SWAP chosen for a frontier, counting a hit or a miss.
+   */
+  std::optional<swap_t> find(const interacting_nodes_t& frontier);
+
+  /**
+   * Record the SWAP chosen for a frontier, evicting the least recently used
+   * entry if full.
+   */
+  void insert(const interacting_nodes_t& frontier, const swap_t& swap);
+
+  std::size_t capacity() const { return capacity_; }
+  std::size_t size() const;
+  unsigned hits() const;
+  unsigned misses() const;
+
+  /** Remove all entries and reset the counters. */
+  void clear();
+
+ private:
+  typedef std::list<std::pair<interacting_nodes_t, swap_t>> entries_t;
+
+  std::size_t capacity_;
+  // Most recently used first.
+  entries_t entries_;
+  std::map<interacting_nodes_t, entries_t::iterator> lookup_;
+  unsigned hits_;
+  unsigned misses_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace tket
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "tket/Architecture/Architecture.hpp"
 #include "tket/Utils/BiMapHeaders.hpp"
 #include "tket/Utils/UnitID.hpp"
@@ -90,12 +92,39 @@ class LexicographicalComparison {
    * way, only swaps with lexicographically identical swap for the given
    * interacting nodes remain after the method is called.
    *
+   * If the architecture has a precomputed distance matrix, the distance
+   * vectors of large candidate sets are computed on up to \p n_threads
+   * threads. The result does not depend on the number of threads.
+   *
    * @param candidate_swaps Potential pairs of nodes for comparing and removing
+   * @param n_threads Maximum number of threads to use
    */
-  void remove_swaps_lexicographical(swap_set_t& candidate_swaps) const;
+  void remove_swaps_lexicographical(
+      swap_set_t& candidate_swaps, unsigned n_threads = 1) const;
 
  private:
+  // Changes to lexicographical_distances made by a swap: at most four
+  // entries, in increasing order of index.
+  struct DistancesDelta {
+    std::array<std::pair<unsigned, int>, 4> changes;
+    unsigned size = 0;
+
+    // Add increment at index, checking that base + delta stays non-negative.
+    void add(
+        const lexicographical_distances_t& base, unsigned index,
+        int increment);
+  };
+
+  unsigned get_distances_index(const std::pair<Node, Node>& interaction) const;
+
+  DistancesDelta get_distances_delta(const swap_t& swap) const;
+
+  // Sign of the lexicographical comparison of the distances updated by a and
+  // by b.
+  int compare_deltas(const DistancesDelta& a, const DistancesDelta& b) const;
+
   ArchitecturePtr architecture_;
+  unsigned diameter_;
   lexicographical_distances_t lexicographical_distances;
   interacting_nodes_t interacting_nodes_;
 };
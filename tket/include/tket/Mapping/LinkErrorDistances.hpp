@@ -0,0 +1,68 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "tket/Architecture/Architecture.hpp"
+#include "tket/Characterisation/DeviceCharacterisation.hpp"
+
+namespace tket {
+
+/**
+ * All-pairs shortest paths of an Architecture weighted by link error.
+ *
+ * A link with error \f$ e \f$ costs \f$ -\log(1 - e) \f$, so that the cost
+ * of a sequence of gates is minus the log of the probability that none of
+ * them fails. A SWAP costs three times its link, and the distance between
+ * two nodes is the cost of the cheapest sequence of SWAPs along a path
+ * between them, one per edge. Link errors are taken from a
+ * DeviceCharacterisation, as the greater of the two directions.
+ */
+class LinkErrorDistances {
+ public:
+  /**
+   * Compute all distances with Dijkstra's algorithm from every node.
+   *
+   * O(N E log N) for N nodes and E edges
+   */
+  LinkErrorDistances(
+      const Architecture& architecture,
+      const DeviceCharacterisation& characterisation);
+
+  /**
+   * Cost of a SWAP on an edge of the Architecture.
+   *
+   * @throws std::out_of_range if there is no such edge
+   */
+  double get_swap_cost(const Node& node0, const Node& node1) const;
+
+  /**
+   * Cost of the cheapest path of SWAPs between two nodes, infinite if
+   * they are not connected.
+   *
+   * @throws std::out_of_range if either node is not in the Architecture
+   */
+  double get_distance(const Node& node0, const Node& node1) const;
+
+ private:
+  std::map<Node, unsigned> index_;
+  std::map<std::pair<Node, Node>, double> swap_costs_;
+  // Row-major, index_.size() squared.
+  std::vector<double> distances_;
+};
+
+}  // namespace tket
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <optional>
+
 #include "tket/Architecture/Architecture.hpp"
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Utils/BiMapHeaders.hpp"
@@ -66,6 +69,12 @@ struct MappingFrontier {
 
   std::shared_ptr<unit_bimaps_t> bimaps_;
 
+  /**
+   * If set, routing methods should fall back to cheaper heuristics once this
+   * point has passed, so that routing finishes as soon as possible.
+   */
+  std::optional<std::chrono::steady_clock::time_point> deadline_;
+
   MappingFrontier(Circuit& _circuit);
 
   MappingFrontier(Circuit& _circuit, std::shared_ptr<unit_bimaps_t> _bimaps);
@@ -212,6 +221,13 @@ struct MappingFrontier {
    * @param uid UnitID in the circuit
    */
   UnitID get_qubit_from_circuit_uid(const UnitID& uid);
+
+  /**
+   * Estimated bytes held by the boundaries, node sets and maps (see
+   * tket/Utils/MemoryUsage.hpp). The circuit, which is only referenced, is
+   * not included.
+   */
+  std::size_t memory_usage() const;
 };
 
 typedef std::shared_ptr<MappingFrontier> MappingFrontier_ptr;
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <chrono>
+#include <optional>
+
 #include "tket/Architecture/Architecture.hpp"
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Mapping/RoutingMethod.hpp"
@@ -45,11 +48,15 @@ class MappingManager {
    * @param circuit Circuit to be routed
    * @param routing_methods Ranked RoutingMethod objects to use for routing
    * segments.
+   * @param window_slices If non-zero, route in windows of this many slices,
+   * see route_circuit_with_maps
+   * @param timeout Time budget in milliseconds, or 0 for no budget, see
+   * route_circuit_with_maps
    * @return True if circuit is modified
    */
   bool route_circuit(
-      Circuit& circuit,
-      const std::vector<RoutingMethodPtr>& routing_methods) const;
+      Circuit& circuit, const std::vector<RoutingMethodPtr>& routing_methods,
+      unsigned window_slices = 0, unsigned timeout = 0) const;
 
   /**
    * route_circuit_maps
@@ -62,14 +69,100 @@ class MappingManager {
    * @param circuit Circuit to be routed
    * @param routing_methods Ranked RoutingMethod objects to use for routing
    * segments.
+   * If window_slices is non-zero, the Circuit is consumed from the front in
+   * windows of that many slices. Each window is routed on its own, starting
+   * from the permutation left by the previous one, and appended to the
+   * routed prefix, so that the DAG is never held twice and each routing
+   * method only sees one window. Routing methods can't look ahead past the
+   * end of a window, so more SWAP gates may be added. Every Qubit of the
+   * Circuit must already be an Architecture Node.
+   *
+   * If timeout is non-zero, routing methods are asked to cut their search
+   * short once it has passed (see MappingFrontier::deadline_), and the rest
+   * of the Circuit is routed by LexiRoute with no lookahead wherever it
+   * applies. The result is always a fully routed Circuit, but its quality
+   * drops once the budget is exhausted.
+   *
+   * @param circuit Circuit to be routed
+   * @param routing_methods Ranked RoutingMethod objects to use for routing
+   * segments.
    * @param maps For tracking placed and permuted qubits during Compilation
+   * @param window_slices If non-zero, route in windows of this many slices
+   * @param timeout Time budget in milliseconds, or 0 for no budget
    * @return True if circuit is modified
    */
   bool route_circuit_with_maps(
       Circuit& circuit, const std::vector<RoutingMethodPtr>& routing_methods,
-      std::shared_ptr<unit_bimaps_t> maps) const;
+      std::shared_ptr<unit_bimaps_t> maps, unsigned window_slices = 0,
+      unsigned timeout = 0) const;
+
+  /**
+   * route_circuit_portfolio
+   * Route copies of the Circuit with several configurations of ranked
+   * RoutingMethod objects concurrently, one thread per configuration, and
+   * keep the result with the fewest added SWAP and BRIDGE gates, breaking
+   * ties by depth and then by configuration order.
+   *
+   * A configuration that throws, or that exceeds the time budget, is
+   * discarded. If the Architecture is not frozen each configuration routes
+   * against its own copy of it.
+   *
+   * @param circuit Circuit to be routed
+   * @param portfolio Ranked RoutingMethod objects for each configuration
+   * @param maps For tracking placed and permuted qubits during Compilation
+   * @param timeout Time budget of each configuration in milliseconds, or 0
+   * for no budget
+   * @return Index in portfolio of the configuration kept
+   * @throws MappingManagerError if no configuration routes the Circuit
+   */
+  unsigned route_circuit_portfolio(
+      Circuit& circuit,
+      const std::vector<std::vector<RoutingMethodPtr>>& portfolio,
+      std::shared_ptr<unit_bimaps_t> maps, unsigned timeout = 0) const;
+
+  /**
+   * route_circuit_bidirectional
+   * Refine the initial placement of the Circuit by routing it forwards and
+   * backwards in turn. Each forward sweep routes a copy of the Circuit from
+   * the current placement; the Node each Qubit finishes on is then used to
+   * place the reversed Circuit, and routing that gives the placement for the
+   * next forward sweep. The forward result with the fewest added SWAP and
+   * BRIDGE gates is kept, breaking ties by depth and then by earliest sweep,
+   * so the result is never worse than routing from the given placement.
+   *
+   * All sweeps share this->architecture_, so distances it has cached are
+   * only computed once.
+   *
+   * @param circuit Circuit to be routed
+   * @param routing_methods Ranked RoutingMethod objects to use for routing
+   * segments.
+   * @param maps For tracking placed and permuted qubits during Compilation
+   * @param n_sweeps Number of backward sweeps, each followed by a forward
+   * sweep; 0 routes the Circuit once
+   * @return True if circuit is modified
+   */
+  bool route_circuit_bidirectional(
+      Circuit& circuit, const std::vector<RoutingMethodPtr>& routing_methods,
+      std::shared_ptr<unit_bimaps_t> maps, unsigned n_sweeps) const;
 
  private:
   ArchitecturePtr architecture_;
+  // Routing is abandoned after this point, if set.
+  std::optional<std::chrono::steady_clock::time_point> abandon_after_;
+
+  /**
+   * Run routing methods from the current boundary of mapping_frontier until
+   * the end of its Circuit is reached.
+   *
+   * @return True if the Circuit was not already fully routed
+   */
+  bool route_frontier(
+      MappingFrontier_ptr mapping_frontier,
+      const std::vector<RoutingMethodPtr>& routing_methods) const;
+
+  bool route_circuit_in_windows(
+      Circuit& circuit, const std::vector<RoutingMethodPtr>& routing_methods,
+      std::shared_ptr<unit_bimaps_t> maps, unsigned window_slices,
+      std::optional<std::chrono::steady_clock::time_point> deadline) const;
 };
 }  // namespace tket
\ No newline at end of file
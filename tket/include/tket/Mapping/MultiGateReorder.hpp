@@ -41,6 +41,23 @@ class MultiGateReorder {
    */
   bool solve(unsigned max_depth, unsigned max_size);
 
+  /**
+   * Try to commute multi-qubit gates to the quantum frontier, scheduling the
+   * gates beyond it from a ready-list instead of a fixed window of layers.
+   *
+   * Gates whose predecessors have all been examined are taken from a
+   * priority queue keyed on the architecture distance between their nodes,
+   * so that the search spends its budget where gates can be executed. The
+   * operations left in place on each qubit are summarised by the Pauli basis
+   * they commute with, so each gate is examined once, and gates that can be
+   * commuted past them are moved, in order, to the front of the subcircuit.
+   *
+   * @param max_size Maximum number of gates examined.
+   *
+   * @return true if modification made
+   */
+  bool solve_scheduled(unsigned max_size);
+
  private:
   // Architecture all new physical operations must respect
   ArchitecturePtr architecture_;
@@ -56,9 +73,13 @@ class MultiGateReorderRoutingMethod : public RoutingMethod {
    * simultaneous commutation.
    * @param _max_size Maximum number of gates checked for simultaneous
    * commutation.
+   * @param _scheduled Whether to use MultiGateReorder::solve_scheduled, in
+   * which case _max_size bounds the number of gates examined and _max_depth
+   * is not used.
    */
   MultiGateReorderRoutingMethod(
-      unsigned _max_depth = 10, unsigned _max_size = 10);
+      unsigned _max_depth = 10, unsigned _max_size = 10,
+      bool _scheduled = false);
 
   /**
    * @param mapping_frontier Contains boundary of routed/unrouted circuit for
@@ -87,9 +108,15 @@ class MultiGateReorderRoutingMethod : public RoutingMethod {
    */
   unsigned get_max_size() const;
 
+  /**
+   * @return Whether gates are scheduled from a ready-list.
+   */
+  bool is_scheduled() const;
+
  private:
   unsigned max_depth_;
   unsigned max_size_;
+  bool scheduled_;
 };
 
 }  // namespace tket
@@ -0,0 +1,85 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mutex>
+
+#include "tket/Characterisation/DeviceCharacterisation.hpp"
+#include "tket/Mapping/LexiRoute.hpp"
+#include "tket/Mapping/LinkErrorDistances.hpp"
+#include "tket/Mapping/RoutingMethod.hpp"
+
+namespace tket {
+
+class NoiseAwareRoutingMethod : public RoutingMethod {
+ public:
+  /**
+   * Routing with LexiRoute, choosing among candidate SWAPs those that
+   * minimise expected error rather than hop distance (see
+   * LinkErrorDistances). Lookahead is used to break ties.
+   *
+   * Error weighted distances are precomputed on first use for each
+   * Architecture.
+   *
+   * @param _characterisation Link errors of the device
+   * @param _max_depth Number of layers of gates checked in routed subcircuit.
+   */
+  NoiseAwareRoutingMethod(
+      const DeviceCharacterisation& _characterisation,
+      unsigned _max_depth = 100);
+
+  /**
+   * @param mapping_frontier Contains boundary of routed/unrouted circuit for
+   * modifying
+   * @param architecture Architecture providing physical constraints
+   *
+   * @return True if modification made, map between relabelled Qubit, always
+   * empty.
+   */
+  std::pair<bool, unit_map_t> routing_method(
+      MappingFrontier_ptr& mapping_frontier,
+      const ArchitecturePtr& architecture) const override;
+
+  /**
+   * @return Max depth used in lookahead
+   */
+  unsigned get_max_depth() const;
+
+  /**
+   * @return Device errors used to weight links
+   */
+  const DeviceCharacterisation& get_characterisation() const;
+
+  nlohmann::json serialize() const override;
+
+  static NoiseAwareRoutingMethod deserialize(const nlohmann::json& j);
+
+ private:
+  // Distances for the last Architecture routed on, which is held so that it
+  // cannot be replaced by another at the same address. Shared by copies.
+  struct DistancesCache {
+    std::mutex mutex;
+    ArchitecturePtr architecture;
+    std::shared_ptr<const LinkErrorDistances> distances;
+  };
+
+  DeviceCharacterisation characterisation_;
+  unsigned max_depth_;
+  std::shared_ptr<DistancesCache> distances_cache_;
+};
+
+JSON_DECL(NoiseAwareRoutingMethod);
+
+}  // namespace tket
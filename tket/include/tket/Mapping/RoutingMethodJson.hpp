@@ -20,6 +20,7 @@
 #include "tket/Mapping/LexiLabelling.hpp"
 #include "tket/Mapping/LexiRouteRoutingMethod.hpp"
 #include "tket/Mapping/MultiGateReorder.hpp"
+#include "tket/Mapping/NoiseAwareRoutingMethod.hpp"
 #include "tket/Mapping/RoutingMethod.hpp"
 #include "tket/Utils/Json.hpp"
 
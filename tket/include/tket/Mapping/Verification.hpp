@@ -14,10 +14,51 @@
 
 #pragma once
 
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
 #include "tket/Architecture/Architecture.hpp"
 #include "tket/Circuit/Circuit.hpp"
 
 namespace tket {
+
+/**
+ * Connectivity of an architecture as bit matrices over dense node ids, for
+ * checking many circuits against the same architecture.
+ */
+class ConnectivityMatrix {
+ public:
+  explicit ConnectivityMatrix(const Architecture& arch);
+
+  unsigned n_nodes() const { return node_ids_.size(); }
+  // id of a node, if it is in the architecture
+  std::optional<unsigned> node_id(const Node& node) const;
+  // whether there is an edge from node0 to node1
+  bool edge_exists(unsigned node0, unsigned node1) const {
+    return test(edges_, node0, node1);
+  }
+  // whether there is an edge between node0 and node1 in either direction
+  bool adjacent(unsigned node0, unsigned node1) const {
+    return test(adjacent_, node0, node1);
+  }
+
+ private:
+  std::map<Node, unsigned> node_ids_;
+  // 64-bit words per row
+  unsigned n_words_;
+  // rows of bits indexed by node id
+  std::vector<std::uint64_t> edges_;
+  std::vector<std::uint64_t> adjacent_;
+
+  bool test(
+      const std::vector<std::uint64_t>& bits, unsigned row,
+      unsigned col) const {
+    return (bits[row * n_words_ + col / 64] >> (col % 64)) & 1;
+  }
+};
+
 /**
  * Check that the circuit respects architectural constraints
  *
@@ -31,4 +72,36 @@ bool respects_connectivity_constraints(
     const Circuit& circ, const Architecture& arch, bool directed,
     bool bridge_allowed = false);
 
+/**
+ * Check that the circuit respects architectural constraints, as above, given
+ * the connectivity of the architecture.
+ *
+ * The commands are visited once, without constructing Command objects, to
+ * gather the node ids of every multi-qubit operation; these are then checked
+ * against the bit matrices, divided between threads.
+ *
+ * @param circ circuit to check
+ * @param connectivity connectivity of the architecture
+ * @param directed if true, disallow two-qubit gates except for CX
+ * @param bridge_allowed whether 3-qubit \ref OpType::BRIDGE operations are
+ * allowed
+ * @param n_threads number of threads for the checks; 0 means as many as the
+ * hardware supports
+ */
+bool respects_connectivity_constraints(
+    const Circuit& circ, const ConnectivityMatrix& connectivity, bool directed,
+    bool bridge_allowed = false, unsigned n_threads = 1);
+
+/**
+ * Check that the given vertices of the circuit respect architectural
+ * constraints, as respects_connectivity_constraints does for the whole
+ * circuit.
+ *
+ * A quantum input vertex is checked to be on a node of the architecture;
+ * other boundary vertices are ignored.
+ */
+bool vertices_respect_connectivity_constraints(
+    const Circuit& circ, const VertexSet& verts, const Architecture& arch,
+    bool directed, bool bridge_allowed = false);
+
 }  // namespace tket
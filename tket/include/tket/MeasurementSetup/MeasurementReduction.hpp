@@ -33,4 +33,15 @@ MeasurementSetup measurement_reduction(
     GraphColourMethod method = GraphColourMethod::Lazy,
     CXConfigType cx_config = CXConfigType::Snake);
 
+/**
+ * Measurement reduction for strings which have already been partitioned
+ * incrementally, e.g. while streaming them from a file.
+ *
+ * @param stream the partitioned strings
+ * @param cx_config configuration of CXs used to diagonalise each set
+ */
+MeasurementSetup measurement_reduction(
+    const PauliPartitionStream& stream,
+    CXConfigType cx_config = CXConfigType::Snake);
+
 }  // namespace tket
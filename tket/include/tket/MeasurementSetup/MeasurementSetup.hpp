@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Utils/Json.hpp"
 #include "tket/Utils/PauliTensor.hpp"
@@ -87,6 +89,92 @@ class MeasurementSetup {
   measure_result_map_t result_map;
 };
 
+/**
+ * Shots from one measurement circuit, stored by bit: column b holds bit b of
+ * every shot, packed 64 shots to a word. The parity of several bits is then
+ * found for a word of shots at a time.
+ */
+class ShotTable {
+ public:
+  typedef std::uint64_t Word;
+  static constexpr unsigned BITS_PER_WORD = 64;
+
+  /** An empty table of shots over the given number of bits. */
+  explicit ShotTable(unsigned n_bits);
+
+  /** A table of shots given as rows, each of n_bits bits. */
+  ShotTable(unsigned n_bits, const std::vector<std::vector<bool>> &shots);
+
+  /** Append a shot, which must have exactly n_bits() bits. */
+  void add_shot(const std::vector<bool> &shot);
+
+  unsigned n_bits() const { return columns_.size(); }
+  unsigned n_shots() const { return n_shots_; }
+
+  /** Bit (s % 64) of word (s / 64) is the value of the bit in shot s. */
+  const std::vector<Word> &column(unsigned bit) const {
+    return columns_.at(bit);
+  }
+
+ private:
+  unsigned n_shots_;
+  std::vector<std::vector<Word>> columns_;
+};
+
+/**
+ * A hashed index of the result map of a MeasurementSetup, keyed by terms
+ * bit-packed over a common numbering of their qubits, so that lookups hash
+ * and compare a word of qubits at a time.
+ */
+class MeasurementResultIndex {
+ public:
+  typedef MeasurementSetup::MeasurementBitMap MeasurementBitMap;
+
+  explicit MeasurementResultIndex(const MeasurementSetup &setup);
+
+  /** The numbering of the qubits used by packed terms. */
+  const std::map<Qubit, unsigned> &get_qubit_index() const {
+    return qubit_index_;
+  }
+
+  /**
+   * Pack a term over the numbering of this index, or std::nullopt if it acts
+   * on a qubit not used by any term in the setup.
+   */
+  std::optional<PkPauliString> pack(const SpPauliString &term) const;
+
+  /** The bit maps for a term, or nullptr if it is not measured. */
+  const std::vector<MeasurementBitMap> *find(const PkPauliString &term) const;
+  const std::vector<MeasurementBitMap> *find(const SpPauliString &term) const;
+
+  /**
+   * Estimate the expectation values of terms from shots of each measurement
+   * circuit. Each estimate averages the signed parity over every shot of
+   * every circuit from which the term can be read.
+   *
+   * @param terms terms measured by the setup
+   * @param shots one table of shots for each measurement circuit
+   * @throws std::invalid_argument if there is not one table per circuit
+   * @throws std::out_of_range if a term is not measured by the setup
+   * @throws std::invalid_argument if no shots were taken for a term
+   */
+  std::vector<double> expectation_values(
+      const std::vector<SpPauliString> &terms,
+      const std::vector<ShotTable> &shots) const;
+
+ private:
+  struct PkHasher {
+    std::size_t operator()(const PkPauliString &ps) const {
+      return ps.hash_value();
+    }
+  };
+
+  unsigned n_circuits_;
+  std::map<Qubit, unsigned> qubit_index_;
+  std::unordered_map<PkPauliString, std::vector<MeasurementBitMap>, PkHasher>
+      index_;
+};
+
 JSON_DECL(MeasurementSetup::MeasurementBitMap)
 JSON_DECL(MeasurementSetup)
 
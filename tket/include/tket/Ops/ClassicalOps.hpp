@@ -19,6 +19,7 @@
  * @brief Classical operations
  */
 
+#include <cstdint>
 #include <memory>
 
 #include "Op.hpp"
@@ -113,6 +114,21 @@ class ClassicalEvalOp : public ClassicalOp {
    */
   virtual std::vector<bool> eval(const std::vector<bool> &x) const = 0;
 
+  /**
+   * Bit-sliced evaluation
+   *
+   * Each word holds the values of one bit in 64 independent evaluations: bit
+   * k of each output word is the result of \ref eval applied to bit k of the
+   * input words. The default implementation calls \ref eval once per lane;
+   * subclasses override it with word-wise logic.
+   *
+   * @param x vector of input words
+   *
+   * @return vector of output words
+   */
+  virtual std::vector<uint64_t> eval_sliced(
+      const std::vector<uint64_t> &x) const;
+
   /**
    * Equality check between two ClassicalEvalOp instances
    */
@@ -143,6 +159,9 @@ class ClassicalTransformOp : public ClassicalEvalOp {
 
   std::vector<bool> eval(const std::vector<bool> &x) const override;
 
+  std::vector<uint64_t> eval_sliced(
+      const std::vector<uint64_t> &x) const override;
+
   std::vector<uint32_t> get_values() const { return values_; }
 
  private:
@@ -290,6 +309,9 @@ class SetBitsOp : public ClassicalEvalOp {
 
   std::vector<bool> eval(const std::vector<bool> &x) const override;
 
+  std::vector<uint64_t> eval_sliced(
+      const std::vector<uint64_t> &x) const override;
+
  private:
   std::vector<bool> values_;
 };
@@ -305,6 +327,9 @@ class CopyBitsOp : public ClassicalEvalOp {
       : ClassicalEvalOp(OpType::CopyBits, n, 0, n, "CopyBits") {}
 
   std::vector<bool> eval(const std::vector<bool> &x) const override;
+
+  std::vector<uint64_t> eval_sliced(
+      const std::vector<uint64_t> &x) const override;
 };
 
 /**
@@ -353,6 +378,9 @@ class RangePredicateOp : public PredicateOp {
 
   std::vector<bool> eval(const std::vector<bool> &x) const override;
 
+  std::vector<uint64_t> eval_sliced(
+      const std::vector<uint64_t> &x) const override;
+
   /**
    * Equality check between two RangePredicateOp instances
    */
@@ -386,6 +414,9 @@ class ExplicitPredicateOp : public PredicateOp {
 
   std::vector<bool> eval(const std::vector<bool> &x) const override;
 
+  std::vector<uint64_t> eval_sliced(
+      const std::vector<uint64_t> &x) const override;
+
   std::vector<bool> get_values() const { return values_; }
 
  private:
@@ -432,6 +463,9 @@ class ExplicitModifierOp : public ModifyingOp {
 
   std::vector<bool> eval(const std::vector<bool> &x) const override;
 
+  std::vector<uint64_t> eval_sliced(
+      const std::vector<uint64_t> &x) const override;
+
   std::vector<bool> get_values() const { return values_; }
 
  private:
@@ -456,6 +490,9 @@ class MultiBitOp : public ClassicalEvalOp {
 
   std::vector<bool> eval(const std::vector<bool> &x) const override;
 
+  std::vector<uint64_t> eval_sliced(
+      const std::vector<uint64_t> &x) const override;
+
   /**
    * Equality check between two MultiBitOp instances
    */
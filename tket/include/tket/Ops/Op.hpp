@@ -101,6 +101,9 @@ class Op : public std::enable_shared_from_this<Op> {
   /** Set of all free symbols occurring in operation parameters. */
   virtual SymSet free_symbols() const = 0;
 
+  /** Whether any free symbols occur in operation parameters. */
+  virtual bool is_symbolic() const { return !free_symbols().empty(); }
+
   /**
    * Which Pauli, if any, commutes with the operation at a given qubit
    *
@@ -183,6 +186,12 @@ class Op : public std::enable_shared_from_this<Op> {
     throw JsonError("JSON serialization not yet implemented for " + get_name());
   }
 
+  /**
+   * Estimated bytes held by this operation, including any circuit it
+   * contains (see tket/Utils/MemoryUsage.hpp).
+   */
+  virtual std::size_t memory_usage() const { return sizeof(Op); }
+
   virtual ~Op() {}
 
   bool operator==(const Op &other) const {
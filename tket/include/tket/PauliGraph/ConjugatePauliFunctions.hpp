@@ -33,6 +33,9 @@ std::pair<Pauli, bool> conjugate_Pauli(
  * Transforms P to P' such that
  * reverse = false : --P'-- = --op--P--opdg--
  * reverse = true  : --P'-- = --opdg--P--op--
+ *
+ * The single-qubit gates H, S, Sdg, V, Vdg, X, Y, Z and the two-qubit gate CX
+ * are looked up in constant tables.
  */
 void conjugate_PauliTensor(
     SpPauliStabiliser &qpt, OpType op, const Qubit &q, bool reverse = false);
@@ -42,4 +45,14 @@ void conjugate_PauliTensor(
     SpPauliStabiliser &qpt, OpType op, const Qubit &q0, const Qubit &q1,
     const Qubit &qb2);
 
+/**
+ * Dense counterparts of the above, with qubits given by their index into
+ * the string. These avoid the map lookups of the sparse versions, so should
+ * be preferred when pushing a Pauli through many gates on a fixed register.
+ */
+void conjugate_PauliTensor(
+    PauliStabiliser &qpt, OpType op, unsigned q, bool reverse = false);
+void conjugate_PauliTensor(
+    PauliStabiliser &qpt, OpType op, unsigned q0, unsigned q1);
+
 }  // namespace tket
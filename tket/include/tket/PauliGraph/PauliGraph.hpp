@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <fstream>
+#include <map>
 #include <stdexcept>
 
 #include "tket/Clifford/UnitaryTableau.hpp"
@@ -104,6 +107,12 @@ class PauliGraph {
    */
   void sanity_check() const;
 
+  /**
+   * Estimated bytes held by the graph, its tableau and its commutation index
+   * (see tket/Utils/MemoryUsage.hpp).
+   */
+  std::size_t memory_usage() const;
+
   friend PauliGraph circuit_to_pauli_graph(const Circuit &circ);
   friend Circuit pauli_graph_to_pauli_exp_box_circuit_individually(
       const PauliGraph &pg, CXConfigType cx_config);
@@ -111,6 +120,8 @@ class PauliGraph {
       const PauliGraph &pg, CXConfigType cx_config);
   friend Circuit pauli_graph_to_pauli_exp_box_circuit_sets(
       const PauliGraph &pg, CXConfigType cx_config);
+  friend Circuit pauli_graph_to_circuit_lookahead(
+      const PauliGraph &pg, unsigned lookahead);
 
  private:
   /**
@@ -133,6 +144,35 @@ class PauliGraph {
   PauliVertSet start_line_;
   PauliVertSet end_line_;
 
+  /**
+   * Bit-packed copy of the string of a gadget, with qubits numbered by
+   * qubit_index_, and the position at which the gadget was added to the
+   * graph. Since edges only ever point to newer gadgets, the insertion order
+   * is a topological order of graph_.
+   */
+  struct PackedGadget {
+    unsigned order;
+    std::vector<std::uint64_t> xs;
+    std::vector<std::uint64_t> zs;
+  };
+  typedef std::map<unsigned, PauliVert> GadgetsByOrder;
+
+  /**
+   * Commutation index of the graph, so that adding a gadget only needs to
+   * check the gadgets on overlapping support.
+   *
+   * gadgets_on_qubit_[q][p - 1] holds the gadgets with Pauli p (X, Y or Z)
+   * on the qubit numbered q.
+   */
+  std::map<PauliVert, PackedGadget> packed_;
+  std::map<Qubit, unsigned> qubit_index_;
+  std::vector<std::array<GadgetsByOrder, 3>> gadgets_on_qubit_;
+  unsigned next_order_ = 0;
+
+  PackedGadget pack_gadget(const SpPauliStabiliser &pauli);
+  void index_gadget(const PauliVert &vert, PackedGadget packed);
+  void unindex_gadget(const PauliVert &vert);
+
   PauliVertSet get_successors(const PauliVert &vert) const;
   PauliVertSet get_predecessors(const PauliVert &vert) const;
   PauliEdgeSet get_in_edges(const PauliVert &vert) const;
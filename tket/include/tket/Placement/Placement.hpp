@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <tuple>
+
 #include "tket/Architecture/Architecture.hpp"
 #include "tket/Characterisation/DeviceCharacterisation.hpp"
 #include "tket/Circuit/Circuit.hpp"
@@ -21,6 +26,16 @@
 
 namespace tket {
 
+namespace WeightedSubgraphMonomorphism {
+struct TargetGraphData;
+}  // namespace WeightedSubgraphMonomorphism
+
+/** Receives each subgraph monomorphism as it is found, together
+ * with its WSM scalar product; returns false to stop the search.
+ */
+typedef std::function<bool(const boost::bimap<Qubit, Node>&, std::uint64_t)>
+    MonomorphismCallback;
+
 class Placement {
  public:
   typedef std::shared_ptr<Placement> Ptr;
@@ -140,10 +155,23 @@ class GraphPlacement : public Placement {
     void next_slicefrontier();
   };
 
+  /**
+   * @param _architecture Architecture to place onto
+   * @param maximum_matches Maximum number of matches found during WSM
+   * @param timeout Maximum time (ms) for WSM
+   * @param maximum_pattern_gates Maximum gates to construct pattern graph from
+   * @param maximum_pattern_depth Maximum depth to search for such gates
+   * @param search_threads Number of threads used by the WSM solver
+   * @param pattern_depth_decay If 0, the pattern graph is weighted by
+   * slicing the Circuit; otherwise, in a single pass over its commands,
+   * with the weight of a gate decaying by this factor per layer of depth.
+   * Must be less than 1.
+   */
   explicit GraphPlacement(
       const Architecture& _architecture, unsigned maximum_matches = 2000,
       unsigned timeout = 100, unsigned maximum_pattern_gates = 100,
-      unsigned maximum_pattern_depth = 100);
+      unsigned maximum_pattern_depth = 100, unsigned search_threads = 1,
+      double pattern_depth_decay = 0);
   /**
    * For some Circuit, returns maps between Circuit UnitID and
    * Architecture UnitID that can be used for reassigning UnitID in
@@ -158,6 +186,25 @@ class GraphPlacement : public Placement {
   std::vector<std::map<Qubit, Node>> get_all_placement_maps(
       const Circuit& circ_, unsigned matches) const override;
 
+  /**
+   * As get_all_placement_maps, but warm started from an earlier placement
+   * map, e.g. for the previous version of a circuit in a variational loop.
+   * Qubits whose interactions are not all satisfied by the previous map,
+   * and their neighbours in the interaction graph, are placed afresh;
+   * all other qubits keep their previous Nodes. If the previous map still
+   * embeds the whole interaction graph, it is the initial incumbent and only
+   * maps at least as good are returned. If no warm started map is found,
+   * falls back to get_all_placement_maps.
+   *
+   * @param circ_ Circuit relabelling map is constructed from
+   * @param previous_map An earlier map, possibly partial
+   * @param matches Maximum number of matches found during WSM.
+   * @return Map between Circuit and Architecture UnitID
+   */
+  std::vector<std::map<Qubit, Node>> get_warm_start_placement_maps(
+      const Circuit& circ_, const std::map<Qubit, Node>& previous_map,
+      unsigned matches) const;
+
   /**
    * @return maximum matches found during placement
    */
@@ -183,19 +230,46 @@ class GraphPlacement : public Placement {
     return this->maximum_pattern_depth_;
   }
 
+  /**
+   * @return number of threads used by the WSM solver
+   */
+  unsigned get_search_threads() const { return this->search_threads_; }
+
+  /**
+   * @return depth decay factor for pattern graph weights, or 0 if the
+   * pattern graph is weighted by slicing
+   */
+  double get_pattern_depth_decay() const { return this->pattern_depth_decay_; }
+
  protected:
   unsigned maximum_matches_;
   unsigned timeout_;
   unsigned maximum_pattern_gates_;
   unsigned maximum_pattern_depth_;
+  unsigned search_threads_;
+  double pattern_depth_decay_;
 
   mutable std::vector<WeightedEdge> weighted_target_edges;
 
   //   we can use a vector as we index by incrementing size
   mutable std::vector<Architecture::UndirectedConnGraph> extended_target_graphs;
 
+  // Data calculated by the WSM solver for each of extended_target_graphs,
+  // reused across pattern graphs and calls; filled lazily.
+  mutable std::vector<
+      std::shared_ptr<WeightedSubgraphMonomorphism::TargetGraphData>>
+      target_graph_data;
+
+  // Held while searching, since a search extends extended_target_graphs and
+  // target_graph_data; placements may be shared between threads.
+  mutable std::mutex search_mutex_;
+
   const std::vector<WeightedEdge> default_pattern_weighting(
       const Circuit& circuit) const;
+  // The single pass weighting used if pattern_depth_decay_ is nonzero;
+  // edges are in decreasing weight order.
+  const std::vector<WeightedEdge> decayed_pattern_weighting(
+      const Circuit& circuit) const;
   const std::vector<WeightedEdge> default_target_weighting(
       Architecture& passed_architecture) const;
 
@@ -205,25 +279,80 @@ class GraphPlacement : public Placement {
   Architecture construct_target_graph(
       const std::vector<WeightedEdge>& edges, unsigned distance) const;
 
-  std::vector<boost::bimap<Qubit, Node>>
-  get_all_weighted_subgraph_monomorphisms(
+  /**
+   * Passes each subgraph monomorphism found, from progressively smaller
+   * pattern graphs and larger target graphs until there are some, to the
+   * callback as it is found, so that only those which the caller keeps
+   * are ever stored.
+   */
+  void for_each_weighted_subgraph_monomorphism(
       const Circuit& circ_,
       const std::vector<WeightedEdge>& weighted_pattern_edges,
-      bool return_best) const;
+      const MonomorphismCallback& callback) const;
 
   std::map<Qubit, Node> convert_bimap(
-      boost::bimap<Qubit, Node>& bimap,
+      const boost::bimap<Qubit, Node>& bimap,
       const QubitGraph::UndirectedConnGraph& pattern_graph) const;
+
+  // The cached entry of target_graph_data for extended_target_graphs[index].
+  WeightedSubgraphMonomorphism::TargetGraphData* get_target_graph_data(
+      unsigned index) const;
+
+  std::vector<std::map<Qubit, Node>> convert_bimaps(
+      const std::vector<boost::bimap<Qubit, Node>>& all_bimaps,
+      const std::vector<WeightedEdge>& weighted_pattern_edges,
+      unsigned n_qubits, unsigned matches) const;
+};
+
+/** Information from an earlier, similar problem to speed up
+ * get_weighted_subgraph_monomorphisms.
+ */
+struct PlacementWarmStart {
+  /** Every solution must contain these assignments. */
+  std::map<Qubit, Node> fixed_assignments;
+
+  /** If it is a complete solution, only solutions at least as good
+   * are returned; otherwise it is ignored.
+   */
+  std::map<Qubit, Node> initial_solution;
 };
 
 /** Solves the pure unweighted subgraph monomorphism problem, trying
  * to embed the pattern graph into the target graph.
  * Note that graph edge weights are IGNORED by this function.
+ * With more than one thread, the search is split between them; the
+ * solutions found are unchanged if the search completes.
+ * If target_data is given, it must have been returned by
+ * get_wsm_target_graph_data for the same target graph; data calculated
+ * about the target graph is then reused, and extended, by the search.
+ * Pattern vertices in warm_start which are isolated are ignored.
  */
 std::vector<boost::bimap<Qubit, Node>> get_weighted_subgraph_monomorphisms(
     QubitGraph::UndirectedConnGraph& pattern_graph,
     Architecture::UndirectedConnGraph& target_graph, unsigned max_matches,
-    unsigned timeout_ms, bool return_best);
+    unsigned timeout_ms, bool return_best, unsigned n_threads = 1,
+    WeightedSubgraphMonomorphism::TargetGraphData* target_data = nullptr,
+    const PlacementWarmStart* warm_start = nullptr);
+
+/** As get_weighted_subgraph_monomorphisms (without a warm start), but
+ * rather than returning the solutions, passes each one to the callback
+ * as soon as it is found, so that the caller need not store them all.
+ * With more than one thread, they are only passed on once the search ends.
+ * Returns the number of solutions passed to the callback.
+ */
+unsigned for_each_weighted_subgraph_monomorphism(
+    QubitGraph::UndirectedConnGraph& pattern_graph,
+    Architecture::UndirectedConnGraph& target_graph, unsigned max_matches,
+    unsigned timeout_ms, const MonomorphismCallback& callback,
+    unsigned n_threads = 1,
+    WeightedSubgraphMonomorphism::TargetGraphData* target_data = nullptr);
+
+/** Data about the target graph which the WSM solver can reuse across
+ * many pattern graphs, for get_weighted_subgraph_monomorphisms.
+ * Returns null if the target graph has no edges.
+ */
+std::shared_ptr<WeightedSubgraphMonomorphism::TargetGraphData>
+get_wsm_target_graph_data(Architecture::UndirectedConnGraph& target_graph);
 
 class LinePlacement : public GraphPlacement {
  public:
@@ -259,7 +388,8 @@ class NoiseAwarePlacement : public GraphPlacement {
       std::optional<avg_readout_errors_t> _readout_errors = std::nullopt,
       unsigned _maximum_matches = 2000, unsigned _timeout = 100,
       unsigned _maximum_pattern_gates = 100,
-      unsigned _maximum_pattern_depth = 100);
+      unsigned _maximum_pattern_depth = 100, unsigned _search_threads = 1,
+      double _pattern_depth_decay = 0);
 
   /**
    * For some Circuit, returns maps between Circuit UnitID and
@@ -291,13 +421,141 @@ class NoiseAwarePlacement : public GraphPlacement {
  private:
   DeviceCharacterisation characterisation_;
 
-  std::vector<boost::bimap<Qubit, Node>> rank_maps(
-      const std::vector<boost::bimap<Qubit, Node>>& placement_maps,
-      const Circuit& circ_,
-      const std::vector<WeightedEdge>& pattern_edges) const;
+  // The errors of characterisation_ for one Node, with its links given by
+  // indices into node_costs_, so that costing a map needs no lookups.
+  struct NodeCost {
+    double gate_cost;
+    // Zero if there is no readout error.
+    double readout_cost;
+    // (neighbour index, 1 - forward error, 1 - backward error),
+    // only for links where both errors are less than 1.
+    std::vector<std::tuple<unsigned, double, double>> links;
+  };
+  std::map<Node, unsigned> node_indices_;
+  std::vector<NodeCost> node_costs_;
+
+  // The interactions of a Circuit, indexed by its qubits.
+  struct PatternCost {
+    std::map<Qubit, unsigned> qubit_indices;
+    // The weight of qubit i interacting with qubit j is
+    // weights[i * qubit_indices.size() + j].
+    std::vector<unsigned> weights;
+    int approx_depth;
+    // Every map costs nothing.
+    bool trivial;
+  };
+
+  // Fill node_indices_ and node_costs_ from characterisation_.
+  void set_node_costs();
+
+  PatternCost get_pattern_cost(
+      const Circuit& circ_, const QubitGraph& q_graph) const;
+
+  // node_qubits must have an entry for each Node, all unset (i.e. equal to
+  // the number of qubits); it is restored before returning.
   double cost_placement(
-      const boost::bimap<Qubit, Node>& map, const Circuit& circ_,
-      const QubitGraph& q_graph) const;
+      const boost::bimap<Qubit, Node>& map, const PatternCost& pattern_cost,
+      std::vector<unsigned>& node_qubits) const;
+
+  // The costs of the maps, split between the search threads.
+  std::vector<double> cost_placements(
+      const std::vector<boost::bimap<Qubit, Node>>& maps,
+      const PatternCost& pattern_cost) const;
+};
+
+/**
+ * Placement for large devices. The Architecture is split into connected
+ * regions of at most region_size Nodes, and the interaction graph of the
+ * Circuit into parts with few interactions between them. Each part is
+ * assigned to its own region, near the regions of the parts it interacts
+ * with, and placed inside it by a GraphPlacement; the regions are placed
+ * concurrently. Qubits without two qubit interactions are left unplaced.
+ */
+class HierarchicalPlacement : public Placement {
+ public:
+  /**
+   * @param _architecture Architecture to place onto
+   * @param region_size Maximum number of Nodes in each region
+   * @param maximum_matches Maximum number of matches found during WSM,
+   * in each region
+   * @param timeout Maximum time (ms) for WSM, in each region
+   * @param maximum_pattern_gates Maximum gates to construct pattern graph
+   * from, in each region
+   * @param maximum_pattern_depth Maximum depth to search for such gates
+   * @param threads Number of regions placed concurrently
+   */
+  explicit HierarchicalPlacement(
+      const Architecture& _architecture, unsigned region_size = 64,
+      unsigned maximum_matches = 2000, unsigned timeout = 100,
+      unsigned maximum_pattern_gates = 100,
+      unsigned maximum_pattern_depth = 100, unsigned threads = 1);
+
+  /**
+   * For some Circuit, returns a single map between Circuit UnitID and
+   * Architecture UnitID that can be used for reassigning UnitID in
+   * Circuit, constructed region by region.
+   *
+   * @param circ_ Circuit relabelling map is constructed from
+   * @param matches Unused, a single map is returned
+   * @return Map between Circuit and Architecture UnitID
+   */
+  std::vector<std::map<Qubit, Node>> get_all_placement_maps(
+      const Circuit& circ_, unsigned matches) const override;
+
+  /**
+   * @return The regions the Architecture is split into
+   */
+  const std::vector<node_vector_t>& get_regions() const {
+    return this->regions_;
+  }
+
+  /**
+   * @return maximum number of Nodes in each region
+   */
+  unsigned get_region_size() const { return this->region_size_; }
+
+  /**
+   * @return maximum number of matches found during WSM, per region
+   */
+  unsigned get_maximum_matches() const { return this->maximum_matches_; }
+
+  /**
+   * @return timeout for WSM, per region
+   */
+  unsigned get_timeout() const { return this->timeout_; }
+
+  /**
+   * @return maximum number of gates to construct pattern graph from
+   */
+  unsigned get_maximum_pattern_gates() const {
+    return this->maximum_pattern_gates_;
+  }
+
+  /**
+   * @return maximum depth to search to find gates to construct pattern graph
+   * from
+   */
+  unsigned get_maximum_pattern_depth() const {
+    return this->maximum_pattern_depth_;
+  }
+
+  /**
+   * @return number of regions placed concurrently
+   */
+  unsigned get_threads() const { return this->threads_; }
+
+ private:
+  unsigned region_size_;
+  unsigned maximum_matches_;
+  unsigned timeout_;
+  unsigned maximum_pattern_gates_;
+  unsigned maximum_pattern_depth_;
+  unsigned threads_;
+
+  std::vector<node_vector_t> regions_;
+  std::vector<Architecture> region_architectures_;
+  // The least distance between Nodes of each pair of regions.
+  std::vector<std::vector<unsigned>> region_distances_;
 };
 
 void to_json(nlohmann::json& j, const Placement::Ptr& placement_ptr);
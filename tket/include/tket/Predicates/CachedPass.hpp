@@ -0,0 +1,125 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "CompilerPass.hpp"
+#include "tket/Utils/Symbols.hpp"
+
+namespace tket {
+
+/**
+ * A pass that remembers the results of applying another pass.
+ *
+ * Results are looked up by the structural hash of the circuit (see
+ * Circuit::structural_hash) and confirmed by comparing the circuit with the
+ * one originally compiled, so that a hit gives exactly the circuit, unit maps
+ * and return value that the wrapped pass would. Compilation units whose
+ * initial and final maps are not the identity are passed straight to the
+ * wrapped pass and not cached.
+ *
+ * Results can also be written to a directory, one JSON file each, and are
+ * then found there by later instances wrapping a pass with the same
+ * configuration (see BasePass::get_config). Passes whose configuration does
+ * not determine their behaviour, such as a CustomPass, should only be cached
+ * in memory.
+ *
+ * The least recently used entry in memory is evicted once full. Safe to
+ * share between threads.
+ */
+class CachedPass : public BasePass {
+ public:
+  /**
+   * @param pass pass whose results to remember
+   * @param capacity maximum number of results held in memory, at least 1
+   * @param directory existing directory in which to also store the results,
+   *   if any
+   */
+  explicit CachedPass(
+      const PassPtr& pass, std::size_t capacity = 1024,
+      const std::optional<std::string>& directory = std::nullopt);
+
+  bool apply(
+      CompilationUnit& c_unit, SafetyMode safe_mode = SafetyMode::Default,
+      const PassCallback& before_apply = trivial_callback,
+      const PassCallback& after_apply = trivial_callback) const override;
+
+  /**
+   * Apply the pass to a circuit with symbolic parameters, then substitute
+   * values for the symbols in the result.
+   *
+   * Over a parameter sweep the template is compiled once and each point is
+   * substituted into the remembered result. The circuit obtained is
+   * equivalent to, but not necessarily the same as, the result of compiling
+   * the substituted circuit.
+   *
+   * @return whether the pass modified the circuit
+   */
+  bool apply_with_substitution(
+      CompilationUnit& c_unit, const symbol_map_t& symbol_map,
+      SafetyMode safe_mode = SafetyMode::Default) const;
+
+  std::string to_string() const override;
+
+  /** The configuration of the wrapped pass; the cache is not serialised. */
+  nlohmann::json get_config() const override;
+
+  PassPtr get_pass() const { return pass_; }
+  std::size_t capacity() const { return capacity_; }
+  std::size_t size() const;
+  unsigned hits() const;
+  unsigned misses() const;
+
+  /** Remove all results held in memory and reset the counters. */
+  void clear();
+
+ private:
+  struct Entry {
+    Circuit input;
+    Circuit output;
+    unit_bimaps_t maps;
+    bool modified;
+  };
+  typedef std::list<std::pair<std::size_t, Entry>> entries_t;
+
+  PassPtr pass_;
+  std::string config_;
+  std::size_t capacity_;
+  std::optional<std::string> directory_;
+  // Most recently used first.
+  mutable entries_t entries_;
+  mutable std::map<std::size_t, entries_t::iterator> lookup_;
+  mutable unsigned hits_;
+  mutable unsigned misses_;
+  mutable std::mutex mutex_;
+
+  // Result for a circuit with the given structural hash, counting a hit or a
+  // miss
+  std::optional<Entry> find(std::size_t hash, const Circuit& circ) const;
+  // Record a result in memory, evicting the least recently used if full
+  void insert(std::size_t hash, const Entry& entry) const;
+  // Read and write results in the directory, if any
+  std::optional<Entry> load(std::size_t hash, const Circuit& circ) const;
+  void store(std::size_t hash, const Entry& entry) const;
+  std::string file_path(std::size_t hash) const;
+};
+
+}  // namespace tket
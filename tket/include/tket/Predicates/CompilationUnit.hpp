@@ -14,9 +14,12 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "Predicates.hpp"
+#include "tket/Utils/Cancellation.hpp"
 
 namespace tket {
 
@@ -38,6 +41,15 @@ class CompilationUnit {
   CompilationUnit(const Circuit& circ, const std::vector<PredicatePtr>& preds);
 
   bool calc_predicate(const Predicate& pred) const;
+
+  /**
+   * Check a predicate again in full, as for SafetyMode::Audit.
+   *
+   * While the circuit records its changes (see Circuit::record_changes), a
+   * predicate found to hold by an earlier audit is only checked where the
+   * circuit changed since then.
+   */
+  bool audit_predicate(const TypePredicatePair& pred) const;
   bool check_all_predicates()
       const;  // returns false if any of the preds are unsatisfied
 
@@ -48,8 +60,45 @@ class CompilationUnit {
   const unit_bimap_t& get_final_map_ref() const { return maps->final; }
   std::string to_string() const;
 
+  /**
+   * Serialise the unit, so that a compilation can be resumed elsewhere.
+   *
+   * This holds the circuit, the initial and final maps, the target
+   * predicates, and the predicates known to be satisfied from the cache.
+   * Cached predicates that cannot be serialised are left out, so are
+   * checked again if needed. The cancellation token is not included.
+   *
+   * @throws PredicateNotSerializable if a target predicate cannot be
+   *   serialised
+   */
+  nlohmann::json serialize() const;
+  static CompilationUnit deserialize(const nlohmann::json& j);
+
+  /**
+   * Compact binary encoding of serialize(), as MessagePack.
+   */
+  std::vector<std::uint8_t> to_bytes() const;
+  static CompilationUnit from_bytes(const std::vector<std::uint8_t>& bytes);
+
+  /**
+   * Set a token with which to cancel passes applied to this unit.
+   *
+   * Passes check the token between transformations and throw
+   * CompilationCancelled once it is cancelled, leaving the best circuit
+   * found so far in the unit. The circuit is then equivalent to the original
+   * but need not satisfy the postconditions of the pass.
+   */
+  void set_cancellation_token(const CancellationToken& token) {
+    cancellation_token_ = token;
+  }
+  const CancellationToken& get_cancellation_token() const {
+    return cancellation_token_;
+  }
+
   friend class Circuit;
   friend class BasePass;
+  friend class CachedPass;
+  friend class PassTuner;
   friend class StandardPass;
 
   static TypePredicatePair make_type_pair(const PredicatePtr& ptr);
@@ -64,8 +113,19 @@ class CompilationUnit {
                      // satisfy by the end of your Compiler Passes
   mutable PredicateCache cache_;  // updated continuously
 
+  // Predicates found to hold by audit_predicate, with the change log of the
+  // circuit at the time
+  struct AuditRecord {
+    PredicatePtr pred;
+    std::size_t log_id;
+    std::size_t count;
+  };
+  mutable std::map<std::type_index, AuditRecord> audited_;
+
   // Maps from original logical qubits to corresponding current qubits
   std::shared_ptr<unit_bimaps_t> maps;
+
+  CancellationToken cancellation_token_;
 };
 
 }  // namespace tket
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include "CompilationUnit.hpp"
 #include "Predicates.hpp"
 #include "tket/Utils/Json.hpp"
@@ -34,6 +37,13 @@ typedef std::function<void(const CompilationUnit&, const nlohmann::json&)>
 
 JSON_DECL(PassPtr)
 
+/**
+ * Compact binary encoding of the JSON serialisation of a pass, as
+ * MessagePack, for sending between processes
+ */
+std::vector<std::uint8_t> pass_to_bytes(const PassPtr& pass);
+PassPtr pass_from_bytes(const std::vector<std::uint8_t>& bytes);
+
 class IncompatibleCompilerPasses : public std::logic_error {
  public:
   explicit IncompatibleCompilerPasses(const std::type_index& typeid1)
@@ -117,6 +127,36 @@ class BasePass {
       const PassCallback& before_apply = trivial_callback,
       const PassCallback& after_apply = trivial_callback) const = 0;
 
+  /**
+   * @brief Apply the pass to each of a batch of compilation units
+   *
+   * The units are shared out between threads as they become free, so that
+   * a few slow units do not hold up the rest. Each unit is compiled exactly
+   * as by `apply`, so the results do not depend on the number of threads.
+   *
+   * If applying the pass to any unit throws, no further units are started
+   * and the exception from the unit with the lowest index is rethrown once
+   * all threads have finished, as in a serial loop. Units after that one
+   * that were already claimed are restored, so they are left unmodified as
+   * in a serial loop; to allow this, each claimed unit is copied before it
+   * is compiled when using several threads.
+   *
+   * The pass must be safe to apply to different units at once. Built-in
+   * passes are, with one exception: passes holding an @ref Architecture
+   * (placement, routing and the like) fill its distance caches lazily, so
+   * the architecture must be frozen (@ref Architecture::freeze) before the
+   * pass is made, or \p n_threads set to 1. Custom transforms must not
+   * share mutable state between calls.
+   *
+   * @param c_units compilation units, modified in place
+   * @param n_threads number of threads, or 0 to use the hardware concurrency
+   * @param safe_mode
+   * @return for each unit, whether the pass modified its circuit
+   */
+  std::vector<bool> apply_batch(
+      std::vector<CompilationUnit>& c_units, unsigned n_threads = 0,
+      SafetyMode safe_mode = SafetyMode::Default) const;
+
   friend PassPtr operator>>(const PassPtr& lhs, const PassPtr& rhs);
 
   virtual std::string to_string() const = 0;
@@ -182,6 +222,7 @@ class StandardPass : public BasePass {
       const PassCallback& after_apply = trivial_callback) const override;
   std::string to_string() const override;
   nlohmann::json get_config() const override;
+  Transform get_transform() const { return trans_; }
 
  private:
   Transform trans_;
@@ -192,14 +233,20 @@ class StandardPass : public BasePass {
 class SequencePass : public BasePass {
  public:
   SequencePass() {}
-  explicit SequencePass(const std::vector<PassPtr>& ptvec);
+  /**
+   * @param ptvec passes in order of application
+   * @param fuse whether to apply each run of adjacent local rewrite passes as
+   *   a single pass (see fuse_local_rewrites); the result is the same, but
+   *   the callbacks see the fused passes instead of the originals
+   */
+  explicit SequencePass(const std::vector<PassPtr>& ptvec, bool fuse = false);
   bool apply(
       CompilationUnit& c_unit, SafetyMode safe_mode = SafetyMode::Default,
       const PassCallback& before_apply = trivial_callback,
       const PassCallback& after_apply = trivial_callback) const override {
     before_apply(c_unit, this->get_config());
     bool success = false;
-    for (const PassPtr& b : seq_)
+    for (const PassPtr& b : fuse_ ? plan_ : seq_)
       success |= b->apply(c_unit, safe_mode, before_apply, after_apply);
     after_apply(c_unit, this->get_config());
     return success;
@@ -207,15 +254,37 @@ class SequencePass : public BasePass {
   std::string to_string() const override;
   nlohmann::json get_config() const override;
   std::vector<PassPtr> get_sequence() const { return seq_; }
+  bool is_fused() const { return fuse_; }
+
+  /**
+   * Plan an equivalent sequence in which each run of two or more adjacent
+   * local rewrite passes is fused into a single StandardPass.
+   *
+   * Local rewrites are the StandardPasses that rebase, squash, decompose or
+   * remove gates in place without renaming units, such as RebaseCustom,
+   * SquashTK1, RemoveRedundancies and DecomposeBoxes. A fused pass applies
+   * their transforms in order, so it produces the same circuit, but checks
+   * preconditions and updates the predicate cache once for the whole run,
+   * using the conditions the passes have in sequence.
+   *
+   * @param ptvec passes in order of application
+   * @return passes to apply in their place
+   */
+  static std::vector<PassPtr> fuse_local_rewrites(
+      const std::vector<PassPtr>& ptvec);
 
   friend PassPtr operator>>(const PassPtr& lhs, const PassPtr& rhs);
 
  private:
   std::vector<PassPtr> seq_;
+  bool fuse_ = false;
+  // Passes applied in place of seq_ when fusing
+  std::vector<PassPtr> plan_;
 };
 
-/* Repeats a Pass until it returns `false`, or if `strict_check` is `true`
- * until it stops modifying the circuit.
+/* Repeats a Pass until it returns `false` or the structural hash of the
+ * circuit stops changing, or if `strict_check` is `true` until it stops
+ * modifying the circuit.
  */
 class RepeatPass : public BasePass {
  public:
@@ -226,6 +295,7 @@ class RepeatPass : public BasePass {
       const PassCallback& after_apply = trivial_callback) const override {
     before_apply(c_unit, this->get_config());
     bool success = false;
+    std::size_t hash = c_unit.get_circ_ref().structural_hash();
     if (strict_check_) {
       Circuit c0 = c_unit.get_circ_ref();
       bool keep_going = true;
@@ -233,20 +303,29 @@ class RepeatPass : public BasePass {
         bool rv = pass_->apply(c_unit, safe_mode, before_apply, after_apply);
         if (rv) {
           const Circuit& c1 = c_unit.get_circ_ref();
-          if (c0 == c1) {
+          // Only circuits with equal hashes need comparing in full
+          std::size_t new_hash = c1.structural_hash();
+          if (new_hash == hash && c0 == c1) {
             keep_going = false;
           } else {
             keep_going = true;
             success = true;
             c0 = c1;
+            hash = new_hash;
           }
         } else {
           keep_going = false;
         }
       }
     } else {
-      while (pass_->apply(c_unit, safe_mode, before_apply, after_apply))
+      // Stop once the circuit stops changing, judged by its hash, even if
+      // the pass reports success
+      while (pass_->apply(c_unit, safe_mode, before_apply, after_apply)) {
         success = true;
+        std::size_t new_hash = c_unit.get_circ_ref().structural_hash();
+        if (new_hash == hash) break;
+        hash = new_hash;
+      }
     }
     after_apply(c_unit, this->get_config());
     return success;
@@ -0,0 +1,209 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/**
+ * @file
+ * @brief Compiling batches of circuits on several workers.
+ *
+ * A \ref CompilationTask describes one compilation in serialisable form. A
+ * \ref CompilationWorker compiles batches of tasks, keeping the
+ * architectures and passes they use, and the results of those passes, for
+ * later tasks. A \ref CompilationCoordinator shares tasks out between
+ * workers, which may be in other processes or on other machines: it only
+ * needs a channel to each worker that delivers a request, encoded as bytes,
+ * and returns the worker's reply (see CompilationWorker::handle).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "CompilerPass.hpp"
+#include "tket/Architecture/Architecture.hpp"
+
+namespace tket {
+
+/**
+ * A compilation unit and the pass to apply to it, in serialisable form.
+ *
+ * The architecture a pass is configured with can be replaced by the id of an
+ * architecture registered with the workers, so that it is neither sent with
+ * every task nor loaded again for each one.
+ */
+struct CompilationTask {
+  /** Name identifying the task in its results. */
+  std::string id;
+  /** The compilation unit, as CompilationUnit::to_bytes. */
+  std::vector<std::uint8_t> unit;
+  /**
+   * The pass, as its JSON serialisation. If \ref architecture_id is set,
+   * every "architecture" member holds that id instead of an architecture.
+   */
+  nlohmann::json pass;
+  /** Id of the architecture registered with the workers, if any. */
+  std::optional<std::string> architecture_id;
+
+  /**
+   * @param id name identifying the task
+   * @param c_unit compilation unit to compile
+   * @param pass pass to apply
+   * @param architecture_id if set, replaces every architecture in the
+   *   configuration of \p pass, which must then be the architecture
+   *   registered with the workers under this id
+   * @throws PassNotSerializable if the pass cannot be serialised
+   */
+  static CompilationTask make(
+      const std::string& id, const CompilationUnit& c_unit,
+      const PassPtr& pass,
+      const std::optional<std::string>& architecture_id = std::nullopt);
+
+  nlohmann::json serialize() const;
+  static CompilationTask deserialize(const nlohmann::json& j);
+};
+
+/** The outcome of a \ref CompilationTask. */
+struct CompilationResult {
+  /** Id of the task. */
+  std::string id;
+  /** The compiled unit, as CompilationUnit::to_bytes, unless it failed. */
+  std::vector<std::uint8_t> unit;
+  /** Whether the pass modified the circuit. */
+  bool modified = false;
+  /** Why the task failed, if it did. */
+  std::optional<std::string> error;
+  /** Time spent compiling, in seconds, as measured by the worker. */
+  double seconds = 0;
+  /** Index of the coordinator's worker that ran the task. */
+  unsigned worker = 0;
+
+  /**
+   * The compiled unit.
+   *
+   * @throws std::runtime_error with the error message if the task failed
+   */
+  CompilationUnit get_unit() const;
+
+  nlohmann::json serialize() const;
+  static CompilationResult deserialize(const nlohmann::json& j);
+};
+
+/**
+ * Compiles tasks, keeping what can be reused between them.
+ *
+ * Each distinct pass configuration (and architecture) is deserialised once,
+ * and wrapped in a CachedPass so that repeated circuits are not compiled
+ * again. Architectures are registered once with their distances
+ * precomputed. Safe to share between threads.
+ */
+class CompilationWorker {
+ public:
+  /**
+   * @param n_threads number of threads compiling the tasks of a batch, or 0
+   *   to use the hardware concurrency
+   * @param cache_capacity number of results remembered for each pass
+   */
+  explicit CompilationWorker(
+      unsigned n_threads = 0, std::size_t cache_capacity = 1024);
+
+  /** Register an architecture for tasks to refer to by id. */
+  void add_architecture(const std::string& id, const Architecture& arc);
+
+  /**
+   * Compile a batch of tasks, shared out between threads.
+   *
+   * A task that fails, for example because the pass's preconditions are not
+   * satisfied or its architecture is not registered, gets a result with an
+   * error; the other tasks are unaffected.
+   *
+   * @return the result of each task, in order
+   */
+  std::vector<CompilationResult> run(
+      const std::vector<CompilationTask>& tasks);
+
+  /**
+   * Compile a batch of tasks sent by a CompilationCoordinator.
+   *
+   * @param request encoded batch of tasks
+   * @return encoded results
+   */
+  std::vector<std::uint8_t> handle(const std::vector<std::uint8_t>& request);
+
+  /** Number of distinct passes deserialised so far. */
+  std::size_t n_passes() const;
+
+ private:
+  unsigned n_threads_;
+  std::size_t cache_capacity_;
+  // Architectures with their precomputed distances, by id
+  std::map<std::string, nlohmann::json> architectures_;
+  // Cached passes, by architecture id and pass configuration
+  std::map<std::pair<std::optional<std::string>, std::string>, PassPtr>
+      passes_;
+  mutable std::mutex mutex_;
+
+  PassPtr get_pass(const CompilationTask& task);
+  CompilationResult compile(const CompilationTask& task);
+};
+
+/**
+ * Shares tasks out between workers and gathers their results.
+ *
+ * Tasks with the same pass and architecture go to the same worker where
+ * possible, so that its caches are reused. Each worker receives its tasks in
+ * batches; once a worker has run out of its own it takes batches meant for
+ * others, so that a busy worker does not hold up the rest.
+ */
+class CompilationCoordinator {
+ public:
+  /**
+   * Sends an encoded batch of tasks to a worker and returns its encoded
+   * results, as CompilationWorker::handle. Channels to different workers
+   * are called concurrently.
+   */
+  typedef std::function<std::vector<std::uint8_t>(
+      const std::vector<std::uint8_t>&)>
+      Channel;
+
+  /**
+   * @param workers channel to each worker, at least one
+   * @param batch_size maximum number of tasks sent in one request, at least
+   *   1
+   */
+  explicit CompilationCoordinator(
+      const std::vector<Channel>& workers, std::size_t batch_size = 16);
+
+  /**
+   * Compile tasks on the workers.
+   *
+   * If a channel throws, the tasks of that request get results with the
+   * error.
+   *
+   * @return the result of each task, in order
+   */
+  std::vector<CompilationResult> run(
+      const std::vector<CompilationTask>& tasks) const;
+
+ private:
+  std::vector<Channel> workers_;
+  std::size_t batch_size_;
+};
+
+}  // namespace tket
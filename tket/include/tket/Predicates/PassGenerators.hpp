@@ -80,12 +80,52 @@ PassPtr gen_full_mapping_pass(
     const std::vector<RoutingMethodPtr>& config);
 PassPtr gen_default_mapping_pass(
     const Architecture& arc, bool delay_measures = true);
+
+/**
+ * Compile to an architecture quickly, for interactive use.
+ *
+ * Only passes whose running time is linear, or nearly so, in the size of the
+ * circuit are used: boxes are decomposed, the circuit is rebased to CX and
+ * TK1 and squashed, then routed by LexiRoute looking one layer ahead, and
+ * finally rebased, squashed and cleaned up again. No placement search is
+ * done: qubits are labelled as routing reaches them. The architecture's
+ * distances are computed once, when the pass is created.
+ *
+ * Routing is the only step whose cost depends on the architecture as well
+ * as the circuit. Once \p routing_timeout has passed, the rest of the
+ * circuit is routed with no lookahead at all, so the result is always fully
+ * routed; a larger budget gives fewer SWAPs on large circuits. The output is
+ * typically worse than that of gen_default_mapping_pass followed by
+ * SynthesiseTket or FullPeepholeOptimise.
+ *
+ * @param arc architecture to compile to
+ * @param routing_timeout time budget for routing in milliseconds, or 0 for
+ *   no budget
+ * @return a pass producing CX and TK1 gates respecting the connectivity of
+ *   \p arc (ignoring edge direction)
+ */
+PassPtr gen_fast_compile_pass(
+    const Architecture& arc, unsigned routing_timeout = 5);
 PassPtr gen_cx_mapping_pass(
     const Architecture& arc, const Placement::Ptr& placement_ptr,
     const std::vector<RoutingMethodPtr>& config, bool directed_cx,
     bool delay_measures);
+/**
+ * Pass to route a Circuit to an Architecture.
+ *
+ * @param arc architecture to route on
+ * @param config ranked routing methods
+ * @param refinement_sweeps if non-zero, refine the initial placement by this
+ *   many rounds of routing the reversed circuit from the final placement and
+ *   routing forwards again, keeping the best result
+ *   (see MappingManager::route_circuit_bidirectional)
+ * @param timeout if non-zero and there are no refinement sweeps, time budget
+ *   in milliseconds after which the rest of the circuit is routed without
+ *   lookahead (see MappingManager::route_circuit_with_maps)
+ */
 PassPtr gen_routing_pass(
-    const Architecture& arc, const std::vector<RoutingMethodPtr>& config);
+    const Architecture& arc, const std::vector<RoutingMethodPtr>& config,
+    unsigned refinement_sweeps = 0, unsigned timeout = 0);
 PassPtr gen_directed_cx_routing_pass(
     const Architecture& arc, const std::vector<RoutingMethodPtr>& config);
 
@@ -69,6 +69,12 @@ const PassPtr &FlattenRegisters();
 /** Remove all& \ref OpType::Barrier from the circuit. */
 const PassPtr &RemoveBarriers();
 
+/**
+ * Resynthesise maximal Clifford subcircuits from their tableaux, where this
+ * reduces the number of CX gates. Global phase is not preserved.
+ */
+const PassPtr &CliffordBlockResynthesis();
+
 /** Commutes measurements to the end of the circuit.
  * @param allow_partial Whether to allow measurements that cannot be commuted to
  * the end, and delay them as much as possible instead. If false, the pass
@@ -124,6 +130,17 @@ const PassPtr &ZZPhaseToRz();
  */
 const PassPtr &CnXPairwiseDecomposition();
 
+/**
+ * @brief Decompose CnX gates using idle qubits as ancillae.
+ *
+ * Each CnX gate with at least 3 controls is decomposed with linear or
+ * logarithmic depth, borrowing qubits that are idle at that point of the
+ * circuit, where enough are available.
+ *
+ * @return compilation pass to perform this transformation
+ */
+const PassPtr &CnXAncillaDecomposition();
+
 /**
  * @brief Remove any implicit qubit permutation by appending SWAP gates.
  *
@@ -0,0 +1,102 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "CompilerPass.hpp"
+
+namespace tket {
+
+/**
+ * Records how long each pass takes and what it does to the circuit.
+ *
+ * The callbacks returned by before_apply() and after_apply() are given to
+ * BasePass::apply, which passes them on to every nested pass of a
+ * SequencePass, RepeatPass and the like, so that each application of each
+ * pass is recorded with its place in the nesting.
+ *
+ * A profiler may only be used for one compilation at a time.
+ */
+class PassProfiler {
+ public:
+  /** One application of a pass. */
+  struct Record {
+    /** Name of the pass: the name of a StandardPass, else its class */
+    std::string name;
+    /** Index of the record of the enclosing pass, if any */
+    std::optional<std::size_t> parent;
+    /** Time since the profiler started, in microseconds */
+    double start_us;
+    /** Duration, in microseconds, including any nested passes */
+    double duration_us;
+    unsigned gates_before;
+    unsigned gates_after;
+    unsigned depth_before;
+    unsigned depth_after;
+    /** Whether the circuit differs afterwards, judged by its hash */
+    bool modified;
+  };
+
+  PassProfiler();
+
+  PassCallback before_apply();
+  PassCallback after_apply();
+
+  /** Apply a pass with the profiler's callbacks. */
+  bool apply(
+      const PassPtr& pass, CompilationUnit& c_unit,
+      SafetyMode safe_mode = SafetyMode::Default);
+
+  /** Records in the order the passes started. */
+  const std::vector<Record>& get_records() const { return records_; }
+
+  /**
+   * The records in the Trace Event Format, which can be loaded into
+   * chrome://tracing, Perfetto or speedscope to view as a flame graph.
+   */
+  nlohmann::json to_trace_json() const;
+
+  /**
+   * The records as folded stacks for flamegraph.pl: one line per pass
+   * nesting, giving the time spent in the innermost pass and not in a
+   * nested pass, in microseconds.
+   */
+  std::string to_folded_stacks() const;
+
+  /** Forget all records and restart the clock. */
+  void clear();
+
+ private:
+  struct Frame {
+    std::size_t record;
+    std::chrono::steady_clock::time_point start;
+    std::size_t hash_before;
+  };
+
+  std::chrono::steady_clock::time_point origin_;
+  std::vector<Record> records_;
+  // Passes started and not yet finished, innermost last
+  std::vector<Frame> stack_;
+
+  void begin(const CompilationUnit& c_unit, const nlohmann::json& config);
+  void end(const CompilationUnit& c_unit);
+};
+
+}  // namespace tket
@@ -0,0 +1,115 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "CompilerPass.hpp"
+#include "tket/Characterisation/DeviceCharacterisation.hpp"
+
+namespace tket {
+
+/**
+ * Chooses between candidate passes, such as alternative optimisation
+ * pipelines, by trying each of them on a circuit.
+ *
+ * Each candidate is applied to its own copy of the compilation unit, the
+ * copies being shared out between threads, and the result that scores lowest
+ * under the metric is kept. Ties go to the earliest candidate, so the choice
+ * does not depend on the number of threads.
+ *
+ * The winner for a class of circuits, named by the caller, can be recorded
+ * and then applied directly to later circuits of the same class. Safe to
+ * share between threads.
+ */
+class PassTuner {
+ public:
+  /** Score of a compiled circuit; lower is better. */
+  typedef std::function<double(const Circuit&)> Metric;
+
+  /**
+   * @param candidates passes to choose between, at least one
+   * @param metric score to minimise
+   */
+  PassTuner(const std::vector<PassPtr>& candidates, const Metric& metric);
+
+  /**
+   * Apply every candidate to a copy of a compilation unit and replace the
+   * unit with the best result.
+   *
+   * Candidates that throw, for example because their preconditions are not
+   * satisfied, are discarded. If all of them throw, the exception from the
+   * first is rethrown and the unit is unchanged.
+   *
+   * @param c_unit compilation unit, modified in place
+   * @param n_threads number of threads, or 0 to use the hardware concurrency
+   * @param safe_mode
+   * @return index of the winning candidate
+   */
+  unsigned tune(
+      CompilationUnit& c_unit, unsigned n_threads = 0,
+      SafetyMode safe_mode = SafetyMode::Default) const;
+
+  /**
+   * Apply the recorded winner for a class of circuits, or if there is none
+   * yet, tune on this unit and record the winner for the class.
+   *
+   * @return index of the candidate applied
+   */
+  unsigned apply(
+      CompilationUnit& c_unit, const std::string& circuit_class,
+      unsigned n_threads = 0, SafetyMode safe_mode = SafetyMode::Default);
+
+  const std::vector<PassPtr>& get_candidates() const { return candidates_; }
+  std::optional<unsigned> get_winner(const std::string& circuit_class) const;
+  std::map<std::string, unsigned> get_winners() const;
+
+  /**
+   * Record the winner for a class of circuits, for example one saved from an
+   * earlier run.
+   *
+   * @throws std::out_of_range if there is no such candidate
+   */
+  void set_winner(const std::string& circuit_class, unsigned candidate);
+
+  /** Number of gates acting on two qubits. */
+  static Metric two_qubit_gate_count();
+
+  /** Depth of the circuit. */
+  static Metric depth();
+
+  /**
+   * Estimated probability of an error: one minus the product of the
+   * fidelities of the gates and measurements, taken from the device
+   * characterisation for the nodes they act on.
+   *
+   * Gates on more than two qubits, and units that are not nodes of the
+   * device, contribute no error.
+   */
+  static Metric infidelity(const DeviceCharacterisation& characterisation);
+
+ private:
+  std::vector<PassPtr> candidates_;
+  Metric metric_;
+  std::map<std::string, unsigned> winners_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace tket
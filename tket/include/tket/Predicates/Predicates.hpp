@@ -56,6 +56,18 @@ class Predicate {
  public:
   virtual bool verify(const Circuit& circ) const = 0;
 
+  /**
+   * Whether the circuit satisfies the predicate, given that it did before the
+   * changes recorded in \p log with stamps greater than \p since.
+   *
+   * By default the whole circuit is checked again. Predicates that depend
+   * only on parts of the circuit override this to check just the parts that
+   * changed.
+   */
+  virtual bool verify_changes(
+      const Circuit& circ, const Circuit::ChangeLog& log,
+      std::size_t since) const;
+
   // implication currently only works between predicates of the same subclass
   virtual bool implies(const Predicate& other) const = 0;
   virtual PredicatePtr meet(const Predicate& other) const = 0;
@@ -81,6 +93,9 @@ class GateSetPredicate : public Predicate {
   explicit GateSetPredicate(const OpTypeSet& allowed_types)
       : allowed_types_(allowed_types) {}
   bool verify(const Circuit& circ) const override;
+  bool verify_changes(
+      const Circuit& circ, const Circuit::ChangeLog& log,
+      std::size_t since) const override;
   bool implies(const Predicate& other) const override;
   PredicatePtr meet(const Predicate& other) const override;
 
@@ -89,6 +104,8 @@ class GateSetPredicate : public Predicate {
 
  private:
   const OpTypeSet allowed_types_;
+
+  bool allows(const Op_ptr& op) const;
 };
 
 /**
@@ -163,6 +180,9 @@ class ConnectivityPredicate : public Predicate {
  public:
   explicit ConnectivityPredicate(const Architecture& arch) : arch_(arch) {}
   bool verify(const Circuit& circ) const override;
+  bool verify_changes(
+      const Circuit& circ, const Circuit::ChangeLog& log,
+      std::size_t since) const override;
   bool implies(const Predicate& other) const override;
   PredicatePtr meet(const Predicate& other) const override;
   std::string to_string() const override;
@@ -176,6 +196,9 @@ class DirectednessPredicate : public Predicate {
  public:
   explicit DirectednessPredicate(const Architecture& arch) : arch_(arch) {}
   bool verify(const Circuit& circ) const override;
+  bool verify_changes(
+      const Circuit& circ, const Circuit::ChangeLog& log,
+      std::size_t since) const override;
   bool implies(const Predicate& other) const override;
   PredicatePtr meet(const Predicate& other) const override;
   std::string to_string() const override;
@@ -0,0 +1,66 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+
+#include "CompilerPass.hpp"
+
+namespace tket {
+
+/**
+ * Compile a circuit too large to hold in memory, reading its JSON
+ * serialisation from one stream and writing the JSON of the result to
+ * another.
+ *
+ * Commands are read (see Circuit::from_json_stream) into a segment, and
+ * once \p segment_size commands have been read the pass is applied to the
+ * segment and all but its last \p overlap layers are written out. Those
+ * layers are carried into the next segment, so that the pass can still
+ * optimise across the join, for example merging rotations or cancelling
+ * gates on either side of it. Memory use is therefore bounded by the
+ * segment size plus the overlap times the number of units, and a record of
+ * the units of the circuit.
+ *
+ * The pass must act locally and keep the units of the circuit: it may not
+ * rename, add or remove qubits or bits. Rebases, squashes and
+ * RemoveRedundancies are suitable, while placement and routing are not.
+ * Implicit qubit permutations introduced by the pass are replaced by
+ * explicit SWAP gates, which may be outside the pass's target gate set.
+ * Since no segment sees the whole circuit, the result may be less optimised
+ * than compiling the circuit whole.
+ *
+ * The result has the units, name, implicit permutation and created and
+ * discarded qubits of the input, and its commands come before the other
+ * members of the JSON object.
+ *
+ * @param in stream holding the JSON serialisation of a circuit
+ * @param out stream to which the compiled circuit is written as JSON
+ * @param pass pass applied to each segment
+ * @param segment_size number of commands read into each segment, besides
+ *   those carried over from the previous one
+ * @param overlap number of layers carried into the next segment
+ * @return number of segments compiled
+ * @throws JsonError if the input does not hold a valid circuit
+ * @throws std::invalid_argument if \p segment_size is 0
+ * @throws std::logic_error if the pass changes the units of a segment
+ */
+unsigned compile_json_stream(
+    std::istream& in, std::ostream& out, const PassPtr& pass,
+    std::size_t segment_size = 10000, std::size_t overlap = 4);
+
+}  // namespace tket
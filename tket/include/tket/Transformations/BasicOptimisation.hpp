@@ -38,6 +38,17 @@ Transform squash_1qb_to_tk1();
 // Produces: Any gates
 Transform commute_through_multis();
 
+/**
+ * Repeat commute_through_multis and remove_redundancies until neither
+ * changes the circuit.
+ *
+ * Rather than alternating whole passes, a worklist of vertices is kept, and a
+ * vertex is revisited only when one of its neighbours changes. The Pauli
+ * basis each port commutes with is memoised for the duration of the
+ * transform, so each is computed once per op.
+ */
+Transform commute_and_remove_redundancies();
+
 // commutes Rz gates through ZZMax, and combines adjacent ZZMax gates
 // Expects: ZZMax, Rz, Rx
 // Produces: ZZMax, Rz, Rx
@@ -84,6 +95,26 @@ Transform two_qubit_squash(
     bool allow_swaps = true);
 Transform two_qubit_squash(bool allow_swaps);
 
+/**
+ * Resynthesise two-qubit blocks with a single sweep over the circuit.
+ *
+ * Like two_qubit_squash, every block of two or more two-qubit gates on the
+ * same pair of qubits (with the single-qubit gates between them) is
+ * KAK-decomposed when this is an improvement. Rather than slicing the whole
+ * circuit, blocks are grown locally around each two-qubit gate up to a
+ * bounded size, and after a substitution only the gates adjacent to the new
+ * block are revisited. Single-qubit gates are then squashed to TK1.
+ *
+ * Symbolic gates, conditional gates, measurements, resets, barriers and gates
+ * on more than two qubits are left in place and bound the blocks.
+ *
+ * @param target_2qb_gate OpType to decompose to. Either TK2 or CX.
+ * @param allow_swaps Whether to allow implicit wire swaps.
+ * @return Transform
+ */
+Transform peephole_sweep(
+    OpType target_2qb_gate = OpType::CX, bool allow_swaps = true);
+
 // 1qb squashing into -Rz-Rx-Rz- or -Rx-Rz-Rx- form
 // Expects: Rx, Rz, and any multi-qubit gates
 // Produces: Rx, Rz, and any multi-qubit gates
@@ -0,0 +1,45 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "Transform.hpp"
+
+namespace tket {
+
+namespace Transforms {
+
+/**
+ * Resynthesise maximal Clifford subcircuits from their tableaux.
+ *
+ * The circuit is split into maximal convex blocks of unitary Clifford gates
+ * (those accepted by @ref SymplecticTableau::apply_gate, on quantum wires
+ * only and outside any opgroup). The unitary tableau of each block is
+ * computed, and the block is replaced by the circuit synthesised from it
+ * (see @ref unitary_tableau_to_circuit) whenever that has strictly fewer CX
+ * gates, counting other two-qubit Clifford gates by their CX cost.
+ *
+ * The tableaux of the blocks are computed in parallel. Synthesised circuits
+ * are cached by tableau, so that re-running the transform only synthesises
+ * blocks that have changed since an earlier run.
+ *
+ * Global phase is not preserved.
+ *
+ * @return Transform implementing the resynthesis
+ */
+Transform clifford_block_resynthesis();
+
+}  // namespace Transforms
+
+}  // namespace tket
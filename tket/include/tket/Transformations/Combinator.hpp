@@ -25,15 +25,23 @@ namespace Transforms {
 // overwritten later
 Transform sequence(std::vector<Transform> &tvec);
 
-// repeats a transform until it makes no changes (returns false)
+// repeats a transform until it makes no changes (returns false, or leaves
+// the structural hash of the circuit unchanged)
 Transform repeat(const Transform &trans);
 
 // repeats a transform and stops when the metric stops decreasing
 Transform repeat_with_metric(
     const Transform &trans, const Transform::Metric &eval);
 
+// repeats `body` while `cond` returns true, stopping early if an iteration
+// leaves the structural hash of the circuit unchanged
 Transform repeat_while(const Transform &cond, const Transform &body);
 
+// applies a transform to the action of every ConjugationBox, including those
+// nested within actions, leaving the compute and uncompute parts boxed; each
+// transformed action is replaced by a CircBox
+Transform conjugation_actions(const Transform &trans);
+
 }  // namespace Transforms
 
 }  // namespace tket
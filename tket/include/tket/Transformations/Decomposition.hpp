@@ -252,6 +252,16 @@ Transform decomp_arbitrary_controlled_gates();
 // when CnX gates are very close to each other.
 Transform cnx_pairwise_decomposition();
 
+// Decomposes CnX gates with at least 3 controls using qubits that are idle
+// at the point of each gate as ancillae. Where enough idle qubits are known
+// to be in the zero state (never acted on since creation, or reset) the
+// log-depth decomposition is used; otherwise, for at least 4 controls, the
+// V-chain decomposition borrows idle qubits in arbitrary states. CnX gates
+// for which too few qubits are idle are left unchanged.
+// Expects: CnX and any other gates
+// returns CX, Ry, H, T, Tdg + any previous gates
+Transform cnx_ancilla_decomposition();
+
 }  // namespace Transforms
 
 }  // namespace tket
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <span>
+
 #include "Transform.hpp"
 
 namespace tket {
@@ -57,6 +59,13 @@ std::pair<bool, bool> run_delay_measures(
  **/
 bool check_only_end_measures(const Command& com, unit_set_t& measured_units);
 
+/**
+ * As above, for an operation and its arguments, e.g. from a @ref CommandView.
+ **/
+bool check_only_end_measures(
+    const Op_ptr& op, std::span<const UnitID> args,
+    unit_set_t& measured_units);
+
 }  // namespace DelayMeasures
 
 }  // namespace Transforms
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "Transform.hpp"
+#include "tket/Architecture/Architecture.hpp"
 
 namespace tket {
 
@@ -22,13 +23,15 @@ namespace Transforms {
 
 /* Dictates whether synthesis of a PauliGraph should
     be done on the Paulis individually, making use of the pairwise
-    interactions or collecting into mutually commuting sets. */
-enum class PauliSynthStrat { Individual, Pairwise, Sets };
+    interactions, collecting into mutually commuting sets, or reducing
+    each in turn within a Clifford frame chosen with lookahead. */
+enum class PauliSynthStrat { Individual, Pairwise, Sets, Lookahead };
 
 NLOHMANN_JSON_SERIALIZE_ENUM(
     PauliSynthStrat, {{PauliSynthStrat::Individual, "Individual"},
                       {PauliSynthStrat::Pairwise, "Pairwise"},
-                      {PauliSynthStrat::Sets, "Sets"}});
+                      {PauliSynthStrat::Sets, "Sets"},
+                      {PauliSynthStrat::Lookahead, "Lookahead"}});
 
 Transform pairwise_pauli_gadgets(CXConfigType cx_config = CXConfigType::Snake);
 
@@ -37,6 +40,15 @@ Transform synthesise_pauli_graph(
     PauliSynthStrat strat = PauliSynthStrat::Sets,
     CXConfigType cx_config = CXConfigType::Snake);
 
+/**
+ * Decomposes every PauliExpBox, PauliExpPairBox and PauliExpCommutingSetBox
+ * into Pauli gadgets whose parities are computed along Steiner trees in the
+ * architecture, so that every CX acts on connected nodes. The qubits of the
+ * boxes must be nodes of the architecture; other nodes that the trees pass
+ * through are added to the circuit if necessary.
+ */
+Transform steiner_pauli_gadgets(const Architecture &arch);
+
 // Assumes incoming circuit is composed of `CircBox`es with
 // `PauliExpBox`es inside
 Transform special_UCC_synthesis(
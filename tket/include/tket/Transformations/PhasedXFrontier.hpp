@@ -15,6 +15,7 @@
 #pragma once
 
 #include <cmath>
+#include <map>
 #include <set>
 
 #include "SingleQubitSquash.hpp"
@@ -90,7 +91,8 @@ using OptEdgeVec = std::vector<OptEdge>;
  * multiple single-qb operations can accumulate and lead to inefficient
  * decompositions. This is what `globalise_PhasedX(squash=true)` does
  * (the default). This is however not necessary for the frontier to be well-
- * behaved
+ * behaved. Intervals that have not changed since they were last squashed
+ * are not squashed again.
  *
  * ### Get beta angles
  * When squashed, each interval is associated with a unique "beta angle", given
@@ -270,6 +272,16 @@ class PhasedXFrontier {
   // interval
   Edge get_interval_start(Edge e) const;
 
+  // move the interval on qubit i, keeping `ending_in_` up to date
+  void set_interval(unsigned i, Edge start, Edge end);
+
+  // beta edge (see `get_beta_edge`) of an arbitrary interval
+  OptEdge beta_edge_in(const std::pair<Edge, Edge>& interval) const;
+
+  // beta edges (see `get_all_beta_edges`) of an arbitrary frontier
+  OptEdgeVec beta_edges_in(
+      const std::vector<std::pair<Edge, Edge>>& intervals) const;
+
   struct BackupIntervals {
     std::vector<VertPort> start;
     std::vector<VertPort> end;
@@ -284,6 +296,13 @@ class PhasedXFrontier {
   // for each qubit: first and last edge of current interval
   std::vector<std::pair<Edge, Edge>> intervals_;
 
+  // for each vertex ending an interval: the qubits whose interval it ends,
+  // so that the multi-qubit gates of the frontier need not be searched for
+  std::map<Vertex, std::set<unsigned>> ending_in_;
+
+  // for each qubit: whether the current interval is already squashed
+  std::vector<bool> squashed_;
+
   // a reference to the circuit
   Circuit& circ_;
 
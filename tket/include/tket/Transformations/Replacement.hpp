@@ -14,6 +14,11 @@
 
 #pragma once
 
+#include <functional>
+#include <map>
+#include <tuple>
+#include <vector>
+
 #include "tket/Circuit/Circuit.hpp"
 
 namespace tket {
@@ -64,4 +69,33 @@ Circuit CX_ZX_circ_from_op(const Op_ptr op);
 Circuit multi_controlled_to_2q(
     const Op_ptr op, const std::optional<OpType>& two_q_type = std::nullopt);
 
+/**
+ * Table of replacement circuits for gates, built up during a pass.
+ *
+ * Gates with numeric parameters are keyed by type, parameters and number of
+ * qubits, so each distinct gate is decomposed once and the same circuit is
+ * substituted for every occurrence, instead of building a new replacement
+ * per gate. Other operations, and gates with symbolic parameters, are
+ * decomposed each time.
+ */
+class ReplacementTable {
+ public:
+  /**
+   * @param build function giving the replacement circuit for an operation
+   */
+  explicit ReplacementTable(std::function<Circuit(const Op_ptr)> build);
+
+  /**
+   * Replacement circuit for an operation, valid until the next call.
+   */
+  const Circuit& get(const Op_ptr& op);
+
+ private:
+  typedef std::tuple<OpType, std::vector<double>, unsigned> key_t;
+
+  std::function<Circuit(const Op_ptr)> build_;
+  std::map<key_t, Circuit> table_;
+  Circuit uncached_;
+};
+
 }  // namespace tket
@@ -29,10 +29,19 @@ namespace Transforms {
  * will only squash subcircuits that reduce the count of the relevant 2-qubit
  * gate.
  *
+ * The candidate subcircuits are collected in a single sweep and then
+ * resynthesised in parallel, before being substituted in order.
+ *
  * @param target_2qb_gate Target 2-qubit gate (either CX or TK2)
+ * @param max_candidates maximum number of candidate subcircuits to
+ *   resynthesise, in topological order, or 0 for no limit
+ * @param timeout time (ms) after which no further candidates are
+ *   resynthesised, or 0 for no limit
  * @return Transform implementing the squash
  */
-Transform three_qubit_squash(OpType target_2qb_gate = OpType::CX);
+Transform three_qubit_squash(
+    OpType target_2qb_gate = OpType::CX, unsigned max_candidates = 0,
+    unsigned timeout = 0);
 
 }  // namespace Transforms
 
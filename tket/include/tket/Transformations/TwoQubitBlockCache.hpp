@@ -0,0 +1,116 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "tket/Circuit/Circuit.hpp"
+
+namespace tket {
+
+namespace Transforms {
+
+/**
+ * Memo table of KAK resynthesis results for two-qubit blocks.
+ *
+ * Keyed on the sequence of gates of the block (type, numeric parameters and
+ * qubit positions), its phase and the options of the resynthesis, so that a
+ * hit skips computing the unitary of the block and its decomposition.
+ * Layered circuits present the same blocks repeatedly. Blocks containing
+ * symbolic parameters or non-gate operations have no key and are never
+ * cached.
+ *
+ * The least recently used entry is evicted once full. Safe to share between
+ * threads.
+ */
+class TwoQubitBlockCache {
+ public:
+  // (type, parameters, qubit positions) of each gate
+  typedef std::tuple<OpType, std::vector<double>, std::vector<unsigned>>
+      gate_key_t;
+
+  struct Key {
+    std::vector<gate_key_t> gates;
+    double phase;
+    OpType target;
+    double cx_fidelity;
+    bool allow_swaps;
+
+    bool operator<(const Key& other) const;
+  };
+
+  /**
+   * The replacement circuit, or std::nullopt if the block was not worth
+   * substituting.
+   */
+  typedef std::optional<Circuit> result_t;
+
+  /**
+   * @param capacity Maximum number of entries, at least 1
+   */
+  explicit TwoQubitBlockCache(std::size_t capacity);
+
+  /**
+   * Cache shared by two_qubit_squash and peephole_sweep.
+   */
+  static TwoQubitBlockCache& shared();
+
+  /**
+   * Key of a two-qubit block, or std::nullopt if it cannot be cached.
+   */
+  static std::optional<Key> make_key(
+      const Circuit& block, OpType target, double cx_fidelity,
+      bool allow_swaps);
+
+  /**
+   * Look up the result for a block, counting a hit or a miss.
+   */
+  std::optional<result_t> find(const Key& key);
+
+  /**
+   * Record the result for a block, evicting the least recently used entry if
+   * full.
+   */
+  void insert(const Key& key, const result_t& result);
+
+  std::size_t capacity() const { return capacity_; }
+  std::size_t size() const;
+  unsigned hits() const;
+  unsigned misses() const;
+
+  /** Remove all entries and reset the counters. */
+  void clear();
+
+ private:
+  typedef std::list<std::pair<Key, result_t>> entries_t;
+
+  std::size_t capacity_;
+  // Most recently used first.
+  entries_t entries_;
+  std::map<Key, entries_t::iterator> lookup_;
+  unsigned hits_;
+  unsigned misses_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace Transforms
+
+}  // namespace tket
@@ -0,0 +1,186 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "tket/Utils/MatrixAnalysis.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
+
+namespace tket {
+
+/**
+ * A dense boolean matrix with its rows packed into 64-bit words.
+ *
+ * This takes one bit per entry (a MatrixXb takes a byte), and whole-row
+ * operations such as XOR and parity act on 64 entries at once, which is what
+ * dominates tableau manipulation for large numbers of qubits. Single entries
+ * can still be read and written with operator(), as for a MatrixXb.
+ *
+ * Bits beyond the last column in the final word of each row are always zero,
+ * so that whole-word operations need no masking.
+ */
+class BitMatrix {
+ public:
+  typedef std::uint64_t Word;
+  static constexpr unsigned BITS_PER_WORD = 64;
+
+  /** A writable reference to a single entry. */
+  class Reference {
+   public:
+    operator bool() const { return (*word_ & mask_) != 0; }
+    Reference &operator=(bool value) {
+      if (value)
+        *word_ |= mask_;
+      else
+        *word_ &= ~mask_;
+      return *this;
+    }
+    Reference &operator=(const Reference &other) {
+      return *this = static_cast<bool>(other);
+    }
+    Reference &operator^=(bool value) {
+      if (value) *word_ ^= mask_;
+      return *this;
+    }
+
+   private:
+    friend class BitMatrix;
+    Reference(Word *word, Word mask) : word_(word), mask_(mask) {}
+    Word *word_;
+    Word mask_;
+  };
+
+  /** An empty matrix. */
+  BitMatrix();
+
+  /** A matrix of zeros. */
+  BitMatrix(unsigned rows, unsigned cols);
+
+  /** Pack an existing matrix. */
+  explicit BitMatrix(const MatrixXb &matrix);
+
+  unsigned rows() const { return rows_; }
+  unsigned cols() const { return cols_; }
+
+  /** Number of words storing each row. */
+  unsigned words_per_row() const { return words_per_row_; }
+
+  bool operator()(unsigned row, unsigned col) const {
+    return (words_[row * words_per_row_ + col / BITS_PER_WORD] >>
+            (col % BITS_PER_WORD)) &
+           1;
+  }
+  Reference operator()(unsigned row, unsigned col) {
+    return Reference(
+        &words_[row * words_per_row_ + col / BITS_PER_WORD],
+        Word(1) << (col % BITS_PER_WORD));
+  }
+
+  /** The words of a row, of which there are words_per_row(). */
+  const Word *row_data(unsigned row) const {
+    return words_.data() + row * words_per_row_;
+  }
+  Word *row_data(unsigned row) { return words_.data() + row * words_per_row_; }
+
+  bool operator==(const BitMatrix &other) const;
+  bool operator!=(const BitMatrix &other) const { return !(*this == other); }
+
+  /** Hash of the dimensions and packed words; equal matrices hash equally. */
+  std::size_t hash_value() const;
+
+  /** Estimated bytes held, including the object itself. */
+  std::size_t memory_usage() const {
+    return sizeof(BitMatrix) + memory::container_bytes(words_);
+  }
+
+  /** Unpack into a MatrixXb. */
+  MatrixXb to_matrix() const;
+
+  /** The transposed matrix. */
+  BitMatrix transpose() const;
+
+  /** Unpack a single row into a 1 x cols() MatrixXb. */
+  MatrixXb get_row(unsigned row) const;
+
+  /** Whether every entry of the row is zero. */
+  bool row_is_zero(unsigned row) const;
+
+  /** Set every entry of the row to zero. */
+  void set_row_zero(unsigned row);
+
+  /** Replace row @p to by its XOR with row @p from. */
+  void xor_row(unsigned from, unsigned to);
+
+  /** Copy row @p from over row @p to. */
+  void copy_row(unsigned from, unsigned to);
+
+  /** Swap two rows. */
+  void swap_rows(unsigned row1, unsigned row2);
+
+  /** Copy column @p from over column @p to. */
+  void copy_col(unsigned from, unsigned to);
+
+  /**
+   * Change the size, keeping the entries which remain in range;
+   * any new entries are zero.
+   */
+  void conservative_resize(unsigned rows, unsigned cols);
+
+  /** XOR of one word array into another. */
+  static void xor_words(const Word *from, Word *to, unsigned n_words) {
+    for (unsigned k = 0; k < n_words; ++k) to[k] ^= from[k];
+  }
+
+  /**
+   * The entries of a row from column @p start onwards, at most 64 of them,
+   * packed into a word with column @p start in the lowest bit.
+   */
+  Word get_bits(unsigned row, unsigned start, unsigned length) const;
+
+  /** Parity of the number of positions set in both word arrays. */
+  static bool and_parity(const Word *a, const Word *b, unsigned n_words);
+
+ private:
+  unsigned rows_;
+  unsigned cols_;
+  unsigned words_per_row_;
+  std::vector<Word> words_;
+};
+
+/**
+ * Row operations reducing a matrix to reduced row echelon form, as the
+ * MatrixXb overload of gaussian_elimination_row_ops; that overload delegates
+ * to this one, which acts on whole words of the packed rows.
+ *
+ * Each pair (i, j) of the result means that row i is added to row j.
+ */
+std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_row_ops(
+    const BitMatrix &a, unsigned blocksize = 6);
+
+/** As gaussian_elimination_row_ops, on the transpose of @p a. */
+std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_col_ops(
+    const BitMatrix &a, unsigned blocksize = 6);
+
+/**
+ * A block size for the Patel-Markov-Hayes elimination in
+ * gaussian_elimination_row_ops() suited to @p n rows: half of log2(n),
+ * rounded up, which keeps the number of row operations near its minimum.
+ */
+unsigned pmh_blocksize(unsigned n);
+
+}  // namespace tket
@@ -0,0 +1,85 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace tket {
+
+/** Thrown at a safe point once compilation has been cancelled. */
+class CompilationCancelled : public std::runtime_error {
+ public:
+  CompilationCancelled() : std::runtime_error("Compilation cancelled") {}
+};
+
+/**
+ * A request to stop compiling, made explicitly or by a deadline passing.
+ *
+ * Copies share their state, so that a copy held by another thread can
+ * cancel the compilation. Compilation stops at the next safe point, where
+ * the circuit is valid and equivalent to the original, by throwing
+ * CompilationCancelled.
+ */
+class CancellationToken {
+ public:
+  /** A token that is only cancelled by calling cancel(). */
+  CancellationToken();
+
+  /** A token that is also cancelled once `timeout` has passed. */
+  explicit CancellationToken(std::chrono::steady_clock::duration timeout);
+
+  /** Cancel, from any thread. */
+  void cancel() const;
+
+  /** Whether cancel() has been called or the deadline has passed. */
+  bool is_cancelled() const;
+
+  /** @throws CompilationCancelled if cancelled */
+  void throw_if_cancelled() const;
+
+ private:
+  struct State {
+    std::atomic<bool> cancelled{false};
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+  };
+  std::shared_ptr<State> state_;
+};
+
+/**
+ * Makes a token the one checked by throw_if_cancelled() on this thread, for
+ * the lifetime of the scope.
+ */
+class CancellationScope {
+ public:
+  explicit CancellationScope(const CancellationToken& token);
+  ~CancellationScope();
+  CancellationScope(const CancellationScope&) = delete;
+  CancellationScope& operator=(const CancellationScope&) = delete;
+
+ private:
+  const CancellationToken* previous_;
+};
+
+/**
+ * A safe point: throw CompilationCancelled if the token of the innermost
+ * CancellationScope on this thread is cancelled.
+ */
+void throw_if_cancelled();
+
+}  // namespace tket
@@ -22,6 +22,7 @@
 #include <map>
 #include <optional>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "Constants.hpp"
@@ -35,6 +36,16 @@ typedef SymEngine::Expression Expr;
 
 JSON_DECL(Expr)
 
+/**
+ * Parse an expression from its string form, as written by its JSON
+ * serialisation.
+ *
+ * Plain integers and decimals, such as "3" or "-0.25", are read directly;
+ * anything else goes through the SymEngine parser. The result is the same
+ * either way.
+ */
+Expr expr_from_string(const std::string& s);
+
 /** Shared pointer to an \p Expr */
 typedef SymEngine::RCP<const SymEngine::Basic> ExprPtr;
 
@@ -53,7 +64,7 @@ struct adl_serializer<tket::Expr> {
   }
 
   static void from_json(const json& j, tket::Expr& exp) {
-    exp = j.get<std::string>();
+    exp = tket::expr_from_string(j.get_ref<const std::string&>());
   }
 };
 
@@ -122,6 +133,22 @@ Expr cos_halfpi_times(const Expr& e);
  */
 Expr sin_halfpi_times(const Expr& e);
 
+/**
+ * Return SymEngine::expand(e)
+ *
+ * Results for symbolic expressions are remembered, per thread, so that the
+ * same combinations of angles recurring across a circuit (as in repeated
+ * rotation merging) are only expanded once. The cache is cleared when it
+ * holds @ref max_expand_cache_size results.
+ *
+ * @param e expression
+ * @return Expr expansion of e
+ */
+Expr expand_expr(const Expr& e);
+
+/** Number of results held by the cache of @ref expand_expr. */
+constexpr std::size_t max_expand_cache_size = 1 << 14;
+
 /**
  * Return -e
  *
@@ -156,6 +183,8 @@ double fmodn(double x, unsigned n);
 /**
  * Test approximate equality of two values modulo n
  *
+ * This is the numeric counterpart of @ref equiv_val, and uses no branches.
+ *
  * @param x first value
  * @param y second value
  * @param mod modulus
@@ -204,6 +233,17 @@ bool equiv_val(const Expr& e, double x, unsigned n = 2, double tol = EPS);
  */
 bool equiv_0(const Expr& e, unsigned n = 2, double tol = EPS);
 
+/**
+ * Test whether a value is approximately 0 modulo n
+ *
+ * @param x value
+ * @param n modulus
+ * @param tol tolerance
+ *
+ * @return whether \p x is within \p tol of 0 modulo n
+ */
+bool equiv_0(double x, unsigned n = 2, double tol = EPS);
+
 /**
  * Test whether an expression is approximately a Clifford angle (some multiple
  * of 0.5 modulo n)
@@ -218,6 +258,20 @@ bool equiv_0(const Expr& e, unsigned n = 2, double tol = EPS);
 std::optional<unsigned> equiv_Clifford(
     const Expr& e, unsigned n = 2, double tol = EPS);
 
+/**
+ * Test whether a value is approximately a Clifford angle (some multiple of
+ * 0.5 modulo n)
+ *
+ * @param x value
+ * @param n modulus
+ * @param tol tolerance
+ *
+ * @retval nullopt value is not within tolerance
+ * @retval u \f$ x \approx \frac12 u \pmod n \f$ where \f$ 0 \leq u < 2n \f$.
+ */
+std::optional<unsigned> equiv_Clifford(
+    double x, unsigned n = 2, double tol = EPS);
+
 /**
  * Exception indicating that symbolic values are not supported.
  */
@@ -72,6 +72,13 @@ Eigen::MatrixXcd apply_qubit_permutation(
 Eigen::VectorXcd apply_qubit_permutation(
     const Eigen::VectorXcd &v, const qubit_map_t &perm);
 
+/**
+ * Permute the rows of a matrix as @ref apply_qubit_permutation does, in place
+ * and without allocating a second matrix. Does nothing for the identity.
+ */
+void apply_qubit_permutation_in_place(
+    Eigen::MatrixXcd &m, const qubit_map_t &perm);
+
 std::pair<MatrixXb, MatrixXb> binary_LLT_decomposition(const MatrixXb &a);
 std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_col_ops(
     const MatrixXb &a, unsigned blocksize = 6);
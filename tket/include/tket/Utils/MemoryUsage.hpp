@@ -0,0 +1,166 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/**
+ * @file
+ * @brief Memory accounting: estimates of the footprint of data structures,
+ * and optional tracking of all allocations against a budget.
+ *
+ * The `memory_usage()` methods of Circuit, PauliGraph, ZXDiagram,
+ * MappingFrontier and the graph classes estimate the bytes held by an object,
+ * from the sizes of its containers and their typical per-node overheads. They
+ * are estimates: allocator padding and memory kept by pool allocators for
+ * reuse are not counted, and data shared between objects (such as operations
+ * used by several circuits) is counted in full for each.
+ *
+ * When tket is built with TKET_TRACK_ALLOCATIONS defined, the global
+ * `operator new` and `operator delete` are replaced with versions that keep a
+ * count of the bytes allocated, and call a hook if one is set. A budget can
+ * be set in either case; @ref check_budget, which passes call before starting
+ * work, then throws if the bytes allocated plus the bytes the work is
+ * expected to need would exceed it. Without tracking, only the expected
+ * bytes are compared with the budget.
+ */
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace tket {
+namespace memory {
+
+/** Typical heap overhead of a node of a doubly-linked list. */
+constexpr std::size_t LIST_NODE_OVERHEAD = 2 * sizeof(void *);
+
+/** Typical heap overhead of a node of a balanced tree (map or set). */
+constexpr std::size_t TREE_NODE_OVERHEAD = 4 * sizeof(void *);
+
+/** Typical heap overhead of a node of a hash table, besides its bucket. */
+constexpr std::size_t HASH_NODE_OVERHEAD = 2 * sizeof(void *);
+
+/** Typical size of the control block of a shared pointer. */
+constexpr std::size_t SHARED_CONTROL_OVERHEAD = 2 * sizeof(void *);
+
+/**
+ * Heap bytes held by a container itself, not counting memory owned by its
+ * elements.
+ */
+template <typename T, typename A>
+std::size_t container_bytes(const std::vector<T, A> &v) {
+  return v.capacity() * sizeof(T);
+}
+
+inline std::size_t container_bytes(const std::string &s) {
+  // Short strings are stored inline.
+  return s.capacity() < sizeof(std::string) ? 0 : s.capacity() + 1;
+}
+
+template <typename T, typename A>
+std::size_t container_bytes(const std::list<T, A> &l) {
+  return l.size() * (sizeof(T) + LIST_NODE_OVERHEAD);
+}
+
+template <typename K, typename V, typename C, typename A>
+std::size_t container_bytes(const std::map<K, V, C, A> &m) {
+  return m.size() * (sizeof(std::pair<const K, V>) + TREE_NODE_OVERHEAD);
+}
+
+template <typename K, typename C, typename A>
+std::size_t container_bytes(const std::set<K, C, A> &s) {
+  return s.size() * (sizeof(K) + TREE_NODE_OVERHEAD);
+}
+
+template <typename K, typename V, typename H, typename E, typename A>
+std::size_t container_bytes(const std::unordered_map<K, V, H, E, A> &m) {
+  return m.size() * (sizeof(std::pair<const K, V>) + HASH_NODE_OVERHEAD) +
+         m.bucket_count() * sizeof(void *);
+}
+
+template <typename K, typename H, typename E, typename A>
+std::size_t container_bytes(const std::unordered_set<K, H, E, A> &s) {
+  return s.size() * (sizeof(K) + HASH_NODE_OVERHEAD) +
+         s.bucket_count() * sizeof(void *);
+}
+
+/**
+ * Heap bytes held by a boost multi-index container (including bimaps) with
+ * the given numbers of ordered and sequenced indices, not counting memory
+ * owned by its elements. Each element is stored once, with a parent and two
+ * child links per ordered index and two links per sequenced index.
+ */
+template <typename C>
+std::size_t multi_index_bytes(
+    const C &c, unsigned n_ordered, unsigned n_sequenced = 0) {
+  return c.size() * (sizeof(typename C::value_type) +
+                     (3 * n_ordered + 2 * n_sequenced) * sizeof(void *));
+}
+
+/**
+ * Called with the size of every allocation, and minus the size of every
+ * deallocation, when allocation tracking is compiled in. It runs inside
+ * `operator new` and `operator delete`, so it must not allocate, and it must
+ * be thread-safe.
+ */
+typedef void (*allocation_hook_t)(std::ptrdiff_t bytes);
+
+/** Whether tket was built with allocation tracking. */
+bool allocation_tracking_enabled();
+
+/** Bytes currently allocated, or 0 without allocation tracking. */
+std::size_t allocated_bytes();
+
+/**
+ * Most bytes allocated at once since the last reset, or 0 without
+ * allocation tracking.
+ */
+std::size_t peak_allocated_bytes();
+
+/** Restart the peak from the bytes currently allocated. */
+void reset_peak_allocated_bytes();
+
+/** Set or clear (with nullptr) the allocation hook. */
+void set_allocation_hook(allocation_hook_t hook);
+
+/** Set or clear (with std::nullopt) the memory budget, in bytes. */
+void set_budget(std::optional<std::size_t> bytes);
+
+/** The memory budget in bytes, if any. */
+std::optional<std::size_t> get_budget();
+
+class MemoryBudgetExceeded : public std::runtime_error {
+ public:
+  explicit MemoryBudgetExceeded(const std::string &message)
+      : std::runtime_error(message) {}
+};
+
+/**
+ * Check that work expected to need some more memory fits in the budget.
+ *
+ * @param expected_bytes bytes the work is expected to allocate
+ * @throws MemoryBudgetExceeded if a budget is set and the bytes currently
+ *   allocated plus \p expected_bytes exceed it
+ */
+void check_budget(std::size_t expected_bytes);
+
+}  // namespace memory
+}  // namespace tket
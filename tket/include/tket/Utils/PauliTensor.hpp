@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "tket/Utils/Constants.hpp"
 #include "tket/Utils/EigenConfig.hpp"
 #include "tket/Utils/Expression.hpp"
@@ -259,13 +261,69 @@ typedef std::map<Qubit, Pauli> QubitPauliMap;
  * A DensePauliMap is generally treated the same regardless of any Pauli::Is
  * padded at the end. Each qubit index is treated as the corresponding Qubit id
  * from the default register.
- *
- * In future work, it may be interesting to consider
- * a symplectic representation (representing each Pauli by a pair of bits
- * representing X and Z) for both speed and memory efficiency.
  */
 typedef std::vector<Pauli> DensePauliMap;
 
+/**
+ * A dense, unsigned-indexed Pauli container in symplectic form.
+ *
+ * Each Pauli is represented by a pair of bits marking its X and Z components
+ * (both for Y), packed 64 qubits to a word in an X plane and a Z plane.
+ * Commutation checks and products then handle a word of qubits at a time.
+ *
+ * As for a DensePauliMap, a PackedPauliMap is generally treated the same
+ * regardless of any Pauli::Is padded at the end, and each qubit index is
+ * treated as the corresponding Qubit id from the default register.
+ */
+class PackedPauliMap {
+ public:
+  typedef std::uint64_t Word;
+  static constexpr unsigned BITS_PER_WORD = 64;
+
+  /** The empty string. */
+  PackedPauliMap() : n_qubits_(0) {}
+
+  /** The identity string over the given number of qubits. */
+  explicit PackedPauliMap(unsigned n_qubits);
+
+  /** Pack a dense string. */
+  explicit PackedPauliMap(const DensePauliMap &paulis);
+
+  /**
+   * Construct directly from bit-planes of ceil(n_qubits / 64) words each, whose
+   * bits beyond n_qubits must be clear.
+   */
+  PackedPauliMap(
+      unsigned n_qubits, std::vector<Word> xs, std::vector<Word> zs);
+
+  /** Number of qubits, including any padding Pauli::Is. */
+  unsigned size() const { return n_qubits_; }
+
+  /** The Pauli at an index, or Pauli::I beyond the end of the string. */
+  Pauli get(unsigned qb) const;
+
+  /** Set the Pauli at an index, padding the string if necessary. */
+  void set(unsigned qb, Pauli p);
+
+  /** Truncate the string or pad it with Pauli::Is. */
+  void resize(unsigned n_qubits);
+
+  /**
+   * The X and Z bit-planes; bit (qb % 64) of word (qb / 64) is qubit qb.
+   * Bits beyond size() are always clear.
+   */
+  const std::vector<Word> &xs() const { return xs_; }
+  const std::vector<Word> &zs() const { return zs_; }
+
+ private:
+  unsigned n_qubits_;
+  std::vector<Word> xs_;
+  std::vector<Word> zs_;
+};
+
+void to_json(nlohmann::json &j, const PackedPauliMap &paulis);
+void from_json(const nlohmann::json &j, PackedPauliMap &paulis);
+
 /**
  * Cast between two different Pauli container types.
  *
@@ -288,6 +346,21 @@ DensePauliMap cast_container<QubitPauliMap, DensePauliMap>(
 template <>
 DensePauliMap cast_container<DensePauliMap, DensePauliMap>(
     const DensePauliMap &cont);
+template <>
+PackedPauliMap cast_container<QubitPauliMap, PackedPauliMap>(
+    const QubitPauliMap &cont);
+template <>
+PackedPauliMap cast_container<DensePauliMap, PackedPauliMap>(
+    const DensePauliMap &cont);
+template <>
+PackedPauliMap cast_container<PackedPauliMap, PackedPauliMap>(
+    const PackedPauliMap &cont);
+template <>
+QubitPauliMap cast_container<PackedPauliMap, QubitPauliMap>(
+    const PackedPauliMap &cont);
+template <>
+DensePauliMap cast_container<PackedPauliMap, DensePauliMap>(
+    const PackedPauliMap &cont);
 
 /**
  * Compare two Pauli containers of the same type for ordering.
@@ -310,6 +383,9 @@ int compare_containers<QubitPauliMap>(
 template <>
 int compare_containers<DensePauliMap>(
     const DensePauliMap &first, const DensePauliMap &second);
+template <>
+int compare_containers<PackedPauliMap>(
+    const PackedPauliMap &first, const PackedPauliMap &second);
 
 /**
  * Find the set of Qubits on which \p first and \p second have the same
@@ -324,6 +400,8 @@ std::set<Qubit> common_qubits(
  */
 std::set<unsigned> common_indices(
     const DensePauliMap &first, const DensePauliMap &second);
+std::set<unsigned> common_indices(
+    const PackedPauliMap &first, const PackedPauliMap &second);
 
 /**
  * Find the set of Qubits on which \p first has a non-trivial Pauli (X, Y, Z)
@@ -339,6 +417,8 @@ std::set<Qubit> own_qubits(
  */
 std::set<unsigned> own_indices(
     const DensePauliMap &first, const DensePauliMap &second);
+std::set<unsigned> own_indices(
+    const PackedPauliMap &first, const PackedPauliMap &second);
 
 /**
  * Find the set of Qubits on which \p first and \p second have distinct
@@ -353,6 +433,15 @@ std::set<Qubit> conflicting_qubits(
  */
 std::set<unsigned> conflicting_indices(
     const DensePauliMap &first, const DensePauliMap &second);
+std::set<unsigned> conflicting_indices(
+    const PackedPauliMap &first, const PackedPauliMap &second);
+
+/**
+ * Return whether \p first and \p second have distinct non-trivial Paulis on
+ * any qubit, without collecting the qubits.
+ */
+bool have_conflicting_indices(
+    const PackedPauliMap &first, const PackedPauliMap &second);
 
 /**
  * Return whether two Pauli containers commute as Pauli strings (there are an
@@ -367,6 +456,9 @@ bool commuting_containers<QubitPauliMap>(
 template <>
 bool commuting_containers<DensePauliMap>(
     const DensePauliMap &first, const DensePauliMap &second);
+template <>
+bool commuting_containers<PackedPauliMap>(
+    const PackedPauliMap &first, const PackedPauliMap &second);
 
 /**
  * Generates the readable Pauli string portion of PauliTensor::to_str().
@@ -380,6 +472,9 @@ template <>
 void print_paulis<QubitPauliMap>(std::ostream &os, const QubitPauliMap &paulis);
 template <>
 void print_paulis<DensePauliMap>(std::ostream &os, const DensePauliMap &paulis);
+template <>
+void print_paulis<PackedPauliMap>(
+    std::ostream &os, const PackedPauliMap &paulis);
 
 /**
  * Hash a Pauli container, combining it with an existing hash of another
@@ -394,6 +489,9 @@ void hash_combine_paulis<QubitPauliMap>(
 template <>
 void hash_combine_paulis<DensePauliMap>(
     std::size_t &seed, const DensePauliMap &paulis);
+template <>
+void hash_combine_paulis<PackedPauliMap>(
+    std::size_t &seed, const PackedPauliMap &paulis);
 
 /**
  * Return the number of Pauli::Ys in the container. Used for
@@ -405,6 +503,8 @@ template <>
 unsigned n_ys<QubitPauliMap>(const QubitPauliMap &paulis);
 template <>
 unsigned n_ys<DensePauliMap>(const DensePauliMap &paulis);
+template <>
+unsigned n_ys<PackedPauliMap>(const PackedPauliMap &paulis);
 
 /**
  * Returns a const reference to a lookup table for multiplying individual
@@ -432,6 +532,9 @@ std::pair<quarter_turns_t, QubitPauliMap> multiply_strings<QubitPauliMap>(
 template <>
 std::pair<quarter_turns_t, DensePauliMap> multiply_strings<DensePauliMap>(
     const DensePauliMap &first, const DensePauliMap &second);
+template <>
+std::pair<quarter_turns_t, PackedPauliMap> multiply_strings<PackedPauliMap>(
+    const PackedPauliMap &first, const PackedPauliMap &second);
 
 /**
  * Evaluates a Pauli container to a sparse matrix describing the tensor product
@@ -455,6 +558,8 @@ template <>
 CmplxSpMat to_sparse_matrix<QubitPauliMap>(const QubitPauliMap &paulis);
 template <>
 CmplxSpMat to_sparse_matrix<DensePauliMap>(const DensePauliMap &paulis);
+template <>
+CmplxSpMat to_sparse_matrix<PackedPauliMap>(const PackedPauliMap &paulis);
 
 /**
  * Evaluates a Pauli container to a sparse matrix describing the tensor product
@@ -478,6 +583,9 @@ CmplxSpMat to_sparse_matrix<QubitPauliMap>(
 template <>
 CmplxSpMat to_sparse_matrix<DensePauliMap>(
     const DensePauliMap &paulis, unsigned n_qubits);
+template <>
+CmplxSpMat to_sparse_matrix<PackedPauliMap>(
+    const PackedPauliMap &paulis, unsigned n_qubits);
 
 /**
  * Evaluates a Pauli container to a sparse matrix describing the tensor product
@@ -499,6 +607,9 @@ CmplxSpMat to_sparse_matrix<QubitPauliMap>(
 template <>
 CmplxSpMat to_sparse_matrix<DensePauliMap>(
     const DensePauliMap &paulis, const qubit_vector_t &qubits);
+template <>
+CmplxSpMat to_sparse_matrix<PackedPauliMap>(
+    const PackedPauliMap &paulis, const qubit_vector_t &qubits);
 
 /*******************************************************************************
  * PauliTensor TEMPLATE CLASS
@@ -511,7 +622,8 @@ CmplxSpMat to_sparse_matrix<DensePauliMap>(
  * global scalar coefficient. It is parameterised in two ways:
  * - PauliContainer describes the data structure used to map qubits to Paulis.
  * This may be sparse or dense, and indexed by arbitrary Qubits or unsigneds
- * (referring to indices in the default register).
+ * (referring to indices in the default register). Dense strings may also be
+ * bit-packed.
  * - CoeffType describes the kind of coefficient stored, ranging from no data to
  * restricted values, to symbolic expressions.
  *
@@ -522,8 +634,9 @@ template <typename PauliContainer, typename CoeffType>
 class PauliTensor {
   static_assert(
       std::is_same<PauliContainer, QubitPauliMap>::value ||
-          std::is_same<PauliContainer, DensePauliMap>::value,
-      "PauliTensor must be either dense or qubit-indexed.");
+          std::is_same<PauliContainer, DensePauliMap>::value ||
+          std::is_same<PauliContainer, PackedPauliMap>::value,
+      "PauliTensor must be either dense, bit-packed or qubit-indexed.");
   static_assert(
       std::is_same<CoeffType, no_coeff_t>::value ||
           std::is_same<CoeffType, quarter_turns_t>::value ||
@@ -562,14 +675,15 @@ class PauliTensor {
 
   /**
    * Convenience constructor to immediately cast a dense Pauli string on the
-   * default register to a sparse representation.
+   * default register to a sparse or bit-packed representation.
    */
   template <typename PC = PauliContainer>
   PauliTensor(
       const DensePauliMap &_string, const CoeffType &_coeff = default_coeff,
-      typename std::enable_if<std::is_same<PC, QubitPauliMap>::value>::type * =
-          0)
-      : string(cast_container<DensePauliMap, QubitPauliMap>(_string)),
+      typename std::enable_if<
+          std::is_same<PC, QubitPauliMap>::value ||
+          std::is_same<PC, PackedPauliMap>::value>::type * = 0)
+      : string(cast_container<DensePauliMap, PauliContainer>(_string)),
         coeff(_coeff) {}
 
   /**
@@ -721,7 +835,9 @@ class PauliTensor {
    */
   template <typename OtherCoeffType, typename PC = PauliContainer>
   typename std::enable_if<
-      std::is_same<PC, DensePauliMap>::value, std::set<unsigned>>::type
+      std::is_same<PC, DensePauliMap>::value ||
+          std::is_same<PC, PackedPauliMap>::value,
+      std::set<unsigned>>::type
   common_indices(
       const PauliTensor<PauliContainer, OtherCoeffType> &other) const {
     return tket::common_indices(string, other.string);
@@ -734,7 +850,9 @@ class PauliTensor {
    */
   template <typename OtherCoeffType, typename PC = PauliContainer>
   typename std::enable_if<
-      std::is_same<PC, DensePauliMap>::value, std::set<unsigned>>::type
+      std::is_same<PC, DensePauliMap>::value ||
+          std::is_same<PC, PackedPauliMap>::value,
+      std::set<unsigned>>::type
   own_indices(const PauliTensor<PauliContainer, OtherCoeffType> &other) const {
     return tket::own_indices(string, other.string);
   }
@@ -745,7 +863,9 @@ class PauliTensor {
    */
   template <typename OtherCoeffType, typename PC = PauliContainer>
   typename std::enable_if<
-      std::is_same<PC, DensePauliMap>::value, std::set<unsigned>>::type
+      std::is_same<PC, DensePauliMap>::value ||
+          std::is_same<PC, PackedPauliMap>::value,
+      std::set<unsigned>>::type
   conflicting_indices(
       const PauliTensor<PauliContainer, OtherCoeffType> &other) const {
     return tket::conflicting_indices(string, other.string);
@@ -773,6 +893,11 @@ class PauliTensor {
     else
       return string.at(qb);
   }
+  template <typename PC = PauliContainer>
+  typename std::enable_if<std::is_same<PC, PackedPauliMap>::value, Pauli>::type
+  get(unsigned qb) const {
+    return string.get(qb);
+  }
 
   /**
    * Sets the Pauli at the given index within the string.
@@ -796,6 +921,11 @@ class PauliTensor {
     if (qb >= string.size()) string.resize(qb + 1, Pauli::I);
     string.at(qb) = p;
   }
+  template <typename PC = PauliContainer>
+  typename std::enable_if<std::is_same<PC, PackedPauliMap>::value>::type set(
+      unsigned qb, Pauli p) {
+    string.set(qb, p);
+  }
 
   /**
    * Asserts coefficient is real, and returns whether it is negative.
@@ -1045,6 +1175,10 @@ typedef PauliTensor<QubitPauliMap, Complex> SpCxPauliTensor;
 typedef PauliTensor<DensePauliMap, Complex> CxPauliTensor;
 typedef PauliTensor<QubitPauliMap, Expr> SpSymPauliTensor;
 typedef PauliTensor<DensePauliMap, Expr> SymPauliTensor;
+typedef PauliTensor<PackedPauliMap, no_coeff_t> PkPauliString;
+typedef PauliTensor<PackedPauliMap, quarter_turns_t> PkPauliStabiliser;
+typedef PauliTensor<PackedPauliMap, Complex> PkCxPauliTensor;
+typedef PauliTensor<PackedPauliMap, Expr> PkSymPauliTensor;
 
 typedef std::vector<PauliStabiliser> PauliStabiliserVec;
 
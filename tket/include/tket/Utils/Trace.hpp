@@ -0,0 +1,168 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/**
+ * @file
+ * @brief Lightweight tracing: scoped timers, counters and histograms.
+ *
+ * Hooks in library code use the TKET_TRACE_SCOPE, TKET_TRACE_COUNT and
+ * TKET_TRACE_HISTOGRAM macros, which expand to nothing (and do not evaluate
+ * their arguments) unless the library is built with TKET_TRACE defined.
+ *
+ * When compiled in, recording is still off until enabled at runtime with
+ * \ref trace::set_enabled, and a disabled hook costs one relaxed atomic load.
+ * Each thread records into its own buffers without locking; a lock is only
+ * taken the first time a thread records anything and when a counter or
+ * histogram name is first registered. Timed events go into a fixed-size
+ * per-thread buffer; events that do not fit are counted and dropped.
+ *
+ * Reading the results (\ref trace::counter_totals, \ref
+ * trace::histogram_totals, \ref trace::write_chrome_trace) is safe while
+ * other threads are recording, though their latest records may be missed.
+ * \ref trace::reset must not run concurrently with recording.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+namespace tket {
+namespace trace {
+
+/**
+ * Number of buckets in a histogram. Bucket 0 counts the value 0, and bucket
+ * i > 0 counts the values in [2^(i-1), 2^i).
+ */
+constexpr unsigned N_HISTOGRAM_BUCKETS = 65;
+
+/** Maximum number of timed events retained per thread. */
+constexpr std::size_t MAX_EVENTS_PER_THREAD = 1 << 16;
+
+typedef std::array<std::uint64_t, N_HISTOGRAM_BUCKETS> histogram_t;
+
+/** Turn recording on or off (off by default). */
+void set_enabled(bool enabled);
+
+/** Whether recording is on. */
+bool is_enabled();
+
+/** Discard everything recorded so far, on all threads. */
+void reset();
+
+/** Totals of all counters over all threads, by name. */
+std::map<std::string, std::uint64_t> counter_totals();
+
+/** Totals of all histograms over all threads, by name. */
+std::map<std::string, histogram_t> histogram_totals();
+
+/** Number of timed events dropped because a thread's buffer was full. */
+std::uint64_t n_dropped_events();
+
+/**
+ * Write everything recorded so far in the Chrome trace event format, which
+ * can be loaded in chrome://tracing or Perfetto.
+ *
+ * Timed events are complete ("X") events with one track per thread, and
+ * counter totals are counter ("C") events at the time of writing. Histograms
+ * and the number of dropped events go in "otherData".
+ */
+void write_chrome_trace(std::ostream &os);
+
+/**
+ * A named counter. Counters with the same name share their totals.
+ */
+class Counter {
+ public:
+  explicit Counter(const char *name);
+
+  /** Add to this thread's count, if recording is on. */
+  void add(std::uint64_t n) const;
+
+ private:
+  unsigned id_;
+};
+
+/**
+ * A named histogram with logarithmic buckets. Histograms with the same name
+ * share their totals.
+ */
+class Histogram {
+ public:
+  explicit Histogram(const char *name);
+
+  /** Count a value in this thread's histogram, if recording is on. */
+  void record(std::uint64_t value) const;
+
+ private:
+  unsigned id_;
+};
+
+/**
+ * Records a timed event covering its own lifetime, if recording was on when
+ * it was constructed.
+ *
+ * @param name name of the event; must outlive all use of the trace data, so
+ *   normally a string literal
+ */
+class ScopedTimer {
+ public:
+  explicit ScopedTimer(const char *name);
+  ~ScopedTimer();
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+ private:
+  const char *name_;
+  std::uint64_t start_ns_;
+};
+
+}  // namespace trace
+}  // namespace tket
+
+#ifdef TKET_TRACE
+
+#define TKET_TRACE_CONCAT_(a, b) a##b
+#define TKET_TRACE_CONCAT(a, b) TKET_TRACE_CONCAT_(a, b)
+
+/** Time the rest of the enclosing scope. */
+#define TKET_TRACE_SCOPE(name)     \
+  const ::tket::trace::ScopedTimer \
+  TKET_TRACE_CONCAT(tket_trace_scope_, __LINE__)(name)
+
+/** Add n to the named counter. */
+#define TKET_TRACE_COUNT(name, n)                                  \
+  do {                                                             \
+    static const ::tket::trace::Counter tket_trace_counter_(name); \
+    tket_trace_counter_.add(n);                                    \
+  } while (0)
+
+/** Record a value in the named histogram. */
+#define TKET_TRACE_HISTOGRAM(name, value)                              \
+  do {                                                                 \
+    static const ::tket::trace::Histogram tket_trace_histogram_(name); \
+    tket_trace_histogram_.record(value);                               \
+  } while (0)
+
+#else
+
+#define TKET_TRACE_SCOPE(name) static_cast<void>(0)
+#define TKET_TRACE_COUNT(name, n) static_cast<void>(0)
+#define TKET_TRACE_HISTOGRAM(name, value) static_cast<void>(0)
+
+#endif
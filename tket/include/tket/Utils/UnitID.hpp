@@ -63,16 +63,22 @@ class InvalidUnitConversion : public std::logic_error {
  *
  * Each location has a name (signifying the 'register' to which it belongs) and
  * an index within that register (which may be multi-dimensional).
+ *
+ * Names and indices are interned in a global table, so that each distinct
+ * (name, index) pair is stored once and identified by a compact integer
+ * @ref handle. Copying a UnitID copies a pointer, equality and hashing
+ * compare handles, and ordering only compares strings between units of
+ * different registers.
  */
 class UnitID {
  public:
-  UnitID() : data_(std::make_shared<UnitData>()) {}
+  UnitID() : data_(intern("", {})), type_(UnitType::Qubit) {}
 
   /** String representation including name and index */
   std::string repr() const;
 
   /** Register name */
-  std::string reg_name() const { return data_->name_; }
+  std::string reg_name() const { return *data_->name_; }
 
   /** Index dimension */
   unsigned reg_dim() const { return data_->index_.size(); }
@@ -81,29 +87,33 @@ class UnitID {
   std::vector<unsigned> index() const { return data_->index_; }
 
   /** Unit type */
-  UnitType type() const { return data_->type_; }
+  UnitType type() const { return type_; }
 
   /** Register dimension and type */
   register_info_t reg_info() const { return {type(), reg_dim()}; }
 
+  /**
+   * Integer identifying the name and index of this unit within the current
+   * process. Units with equal name and index have equal handles.
+   */
+  unsigned handle() const { return data_->handle_; }
+
   bool operator<(const UnitID &other) const {
-    int n = data_->name_.compare(other.data_->name_);
-    if (n > 0) return false;
-    if (n < 0) return true;
+    if (data_ == other.data_) return false;
+    // Interned names are equal exactly when their pointers are.
+    if (data_->name_ != other.data_->name_) {
+      return *data_->name_ < *other.data_->name_;
+    }
     return data_->index_ < other.data_->index_;
   }
   bool operator>(const UnitID &other) const { return other < *this; }
-  bool operator==(const UnitID &other) const {
-    return (this->data_->name_ == other.data_->name_) &&
-           (this->data_->index_ == other.data_->index_);
-  }
+  bool operator==(const UnitID &other) const { return data_ == other.data_; }
   bool operator!=(const UnitID &other) const { return !(*this == other); }
 
   friend std::size_t hash_value(UnitID const &unitid) {
     std::size_t seed = 0;
-    boost::hash_combine(seed, unitid.data_->name_);
-    boost::hash_combine(seed, unitid.data_->index_);
-    boost::hash_combine(seed, unitid.data_->type_);
+    boost::hash_combine(seed, unitid.data_->handle_);
+    boost::hash_combine(seed, unitid.type_);
     return seed;
   }
 
@@ -111,30 +121,27 @@ class UnitID {
   UnitID(
       const std::string &name, const std::vector<unsigned> &index,
       UnitType type)
-      : data_(std::make_shared<UnitData>(name, index, type)) {}
+      : data_(intern(name, index)), type_(type) {}
 
  private:
+  /** Interned name and index, never destroyed */
   struct UnitData {
-    std::string name_;
+    const std::string *name_;
     std::vector<unsigned> index_;
-    UnitType type_;
-
-    UnitData() : name_(), index_(), type_(UnitType::Qubit) {}
-    UnitData(
-        const std::string &name, const std::vector<unsigned> &index,
-        UnitType type)
-        : name_(name), index_(index), type_(type) {
-      static const std::string id_regex_str = "[a-z][A-Za-z0-9_]*";
-      static const std::regex id_regex(id_regex_str);
-      if (!name.empty() && !std::regex_match(name, id_regex)) {
-        std::stringstream msg;
-        msg << "UnitID name '" << name << "' does not match '" << id_regex_str
-            << "', as required for QASM conversion.";
-        tket_log()->warn(msg.str());
-      }
-    }
+    unsigned handle_;
   };
-  std::shared_ptr<UnitData> data_;
+
+  /**
+   * Find or create the table entry for a name and index.
+   *
+   * Thread-safe. Warns the first time a name that is not a valid QASM
+   * identifier is seen.
+   */
+  static const UnitData *intern(
+      const std::string &name, const std::vector<unsigned> &index);
+
+  const UnitData *data_;
+  UnitType type_;
 };
 
 template <class Unit_T>
@@ -307,6 +314,13 @@ typedef struct {
   unit_bimap_t final;
 } unit_bimaps_t;
 
+/**
+ * JSON for a correspondence between unit IDs, as a list of pairs of units,
+ * each unit given by its type, register name and index
+ */
+nlohmann::json unit_bimap_to_json(const unit_bimap_t &m);
+unit_bimap_t unit_bimap_from_json(const nlohmann::json &j);
+
 typedef std::vector<UnitID> unit_vector_t;
 typedef std::map<UnitID, UnitID> unit_map_t;
 typedef std::set<UnitID> unit_set_t;
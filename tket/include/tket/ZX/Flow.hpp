@@ -58,6 +58,26 @@ class Flow {
   // Throws a ZXError if any condition is violated
   void verify(const ZXDiagram& diag) const;
 
+  /**
+   * Updates the flow after a local rewrite of `diag` without identifying a
+   * new flow from scratch.
+   *
+   * `changed` lists the vertices of the rewritten diagram which were added or
+   * whose type or incident wires changed, and `removed` those which were
+   * removed. New vertices are given the smallest depth at which they can be
+   * corrected. Every vertex whose conditions may have been broken is checked
+   * and, where necessary, given a new correction set at its existing depth,
+   * searching correctors near it before all correctors of lower depth.
+   * Depths of existing measured vertices never change.
+   *
+   * Returns false if some vertex cannot be corrected this way, in which case
+   * the flow is only partially updated and should be recomputed with
+   * identify_pauli_flow.
+   */
+  bool update(
+      const ZXDiagram& diag, const ZXVertVec& changed,
+      const ZXVertVec& removed);
+
   // Focusses a flow according to Lemma B.5, Simmons "Relating Measurement
   // Patterns to Circuits via Pauli Flow" https://arxiv.org/pdf/2109.05654.pdf
   void focus(const ZXDiagram& diag);
@@ -86,6 +106,17 @@ class Flow {
   std::map<ZXVert, unsigned> d_;
 
  private:
+  // Checks the Pauli flow conditions for a single measured vertex, throwing a
+  // ZXError if any is violated
+  void verify_vertex(const ZXDiagram& diag, const ZXVert& u) const;
+
+  // Finds a correction set for `u` at depth `depth`, keeping every other
+  // depth fixed. If `local`, only correctors within distance two of `u` or in
+  // its current correction set are considered
+  std::optional<ZXVertSeqSet> solve_at_depth(
+      const ZXDiagram& diag, const ZXVert& u, unsigned depth,
+      const std::set<ZXVert>& inputs, bool local) const;
+
   // Solve for corrections using Gaussian elimination and back substitution
   // Used within identify_pauli_flow
   // correctors are those vertices which may be included in the correction sets
@@ -0,0 +1,105 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "tket/ZX/ZXDiagram.hpp"
+
+namespace tket {
+
+namespace zx {
+
+/**
+ * A compact representation of a quantum ZXDiagram in graphlike form, for
+ * simplifying large diagrams.
+ *
+ * Vertices are numbered consecutively, with phases held in a separate array
+ * and each neighbourhood held as a sorted vector of vertex ids. Every wire
+ * between spiders is a Hadamard wire and every wire at a boundary is a Basic
+ * wire, so wire types are not stored. Local complementations and pivots then
+ * update neighbourhoods by merging sorted vectors rather than searching
+ * through lists of directed edges.
+ *
+ * The simplifications mirror the corresponding Rewrites on ZXDiagram and
+ * return whether they changed the diagram.
+ */
+class GraphLikeDiagram {
+ public:
+  typedef unsigned Vert;
+
+  /**
+   * Convert a graphlike ZXDiagram whose vertices and wires are all
+   * QuantumType::Quantum and which has no parallel wires or self-loops.
+   *
+   * @throws ZXError if the diagram is not of this form
+   */
+  explicit GraphLikeDiagram(const ZXDiagram& diag);
+
+  /** Whether a ZXDiagram can be converted. */
+  static bool can_convert(const ZXDiagram& diag);
+
+  /** Convert back, keeping the order of the boundary and the scalar. */
+  ZXDiagram to_diagram() const;
+
+  /** Number of spiders currently in the diagram. */
+  unsigned n_spiders() const;
+
+  /** Number of wires currently in the diagram. */
+  unsigned n_wires() const;
+
+  /** As Rewrite::remove_interior_cliffords. */
+  bool remove_interior_cliffords();
+
+  /** As Rewrite::remove_interior_paulis. */
+  bool remove_interior_paulis();
+
+  /** As Rewrite::gadgetise_interior_paulis. */
+  bool gadgetise_interior_paulis();
+
+  /** As Rewrite::extend_at_boundary_paulis. */
+  bool extend_at_boundary_paulis();
+
+  /** As Rewrite::merge_gadgets. */
+  bool merge_gadgets();
+
+  /** As Rewrite::reduce_graphlike_form. */
+  bool reduce();
+
+ private:
+  // The type of each vertex: ZSpider or a boundary type
+  std::vector<ZXType> types_;
+  std::vector<Expr> phases_;
+  // Sorted neighbourhoods; empty for removed vertices
+  std::vector<std::vector<Vert>> neighbours_;
+  std::vector<bool> removed_;
+  std::vector<Vert> boundary_;
+  Expr scalar_;
+
+  Vert add_spider(const Expr& phase);
+  void add_wire(Vert u, Vert v);
+  void remove_wire(Vert u, Vert v);
+  void remove_vertex(Vert v);
+  bool is_spider(Vert v) const;
+  bool is_pauli(Vert v) const;
+  bool is_proper_clifford(Vert v) const;
+  // Whether all neighbours of a spider are spiders
+  bool is_interior(Vert v) const;
+  // Toggle the wires between every vertex of `as` and every vertex of `bs`,
+  // which must be disjoint and sorted
+  void complement(const std::vector<Vert>& as, const std::vector<Vert>& bs);
+};
+
+}  // namespace zx
+
+}  // namespace tket
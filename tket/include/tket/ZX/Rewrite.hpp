@@ -14,12 +14,50 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include "tket/ZX/ZXDiagram.hpp"
 
 namespace tket {
 
 namespace zx {
 
+/**
+ * Accumulated statistics for a single named rewrite. Sizes are summed over
+ * all applications.
+ */
+struct RewriteRecord {
+  unsigned n_applications = 0;
+  // Applications which changed the diagram
+  unsigned n_successes = 0;
+  double seconds = 0.;
+  unsigned long vertices_before = 0;
+  unsigned long vertices_after = 0;
+  unsigned long wires_before = 0;
+  unsigned long wires_after = 0;
+};
+
+/**
+ * Collects a RewriteRecord per name from Rewrites wrapped by
+ * Rewrite::with_statistics. Recording is guarded by a mutex, so a collector
+ * can be shared between the workers of Rewrite::parallel_components.
+ */
+class RewriteStatistics {
+ public:
+  void record(
+      const std::string& name, bool success, double seconds,
+      unsigned vertices_before, unsigned wires_before,
+      unsigned vertices_after, unsigned wires_after);
+
+  std::map<std::string, RewriteRecord> get_records() const;
+  void clear();
+
+ private:
+  mutable std::mutex mutex_;
+  std::map<std::string, RewriteRecord> records_;
+};
+
 /**
  * Class for compositional rewrites.
  * The broad structure is similar to the Transform class for Circuits.
@@ -59,6 +97,27 @@ class Rewrite {
   static Rewrite repeat_with_metric(const Rewrite& rw, const Metric& eval);
   static Rewrite repeat_while(const Rewrite& cond, const Rewrite& body);
 
+  /**
+   * Applies `rw` separately to each connected component of the diagram,
+   * running the components in parallel, and merges the results back into a
+   * single diagram with the same boundary order.
+   *
+   * Only suitable for rewrites which act locally within a connected
+   * component, such as the graphlike simplifications. Diagrams with a single
+   * component are rewritten in place.
+   */
+  static Rewrite parallel_components(const Rewrite& rw);
+
+  /**
+   * Behaves as `rw`, recording each application under `name` in `stats`:
+   * whether it changed the diagram, the time taken and the numbers of
+   * vertices and wires before and after. Wrap the members of a sequence
+   * individually to see which rules fire and what they cost.
+   */
+  static Rewrite with_statistics(
+      const Rewrite& rw, const std::string& name,
+      const std::shared_ptr<RewriteStatistics>& stats);
+
   ////////////////////
   // Decompositions //
   ////////////////////
@@ -210,6 +269,14 @@ class Rewrite {
    */
   static Rewrite reduce_graphlike_form();
 
+  /**
+   * As reduce_graphlike_form, but performed on a compact GraphLikeDiagram,
+   * which is much faster on large diagrams. Only applies to quantum diagrams
+   * in graphlike form without parallel wires or self-loops, otherwise returns
+   * false without changing the diagram.
+   */
+  static Rewrite reduce_graphlike_form_compact();
+
   /**
    * Given a diagram in graphlike form, will rebase to MBQC generators, ensure
    * that output qubits are PX(0) (i.e. they match unmeasured qubits) and
@@ -0,0 +1,116 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "tket/Utils/Constants.hpp"
+#include "tket/Utils/EigenConfig.hpp"
+#include "tket/ZX/ZXDiagram.hpp"
+
+namespace tket {
+
+namespace zx {
+
+/**
+ * A tensor network for numerically evaluating a quantum ZXDiagram, for
+ * checking the correctness of rewrites on diagrams too large to convert back
+ * to a circuit and simulate.
+ *
+ * Each generator becomes a dense tensor with one index of dimension 2 per
+ * wire end, following the conventions of pytket.zx.tensor_eval: the scalar of
+ * the diagram is for the doubled diagram, so the network is scaled by its
+ * square root, and each Hadamard wire is an unnormalised Hbox of parameter -1.
+ *
+ * Contraction repeatedly merges the pair of connected tensors whose result
+ * grows the total size of the network the least, and finally takes the outer
+ * product of any disconnected parts.
+ */
+class TensorNetwork {
+ public:
+  /**
+   * Build the network for a diagram whose vertices and wires are all
+   * QuantumType::Quantum, including inside any ZXBoxes.
+   *
+   * @throws ZXError if the diagram is not quantum or has symbolic parameters
+   */
+  explicit TensorNetwork(const ZXDiagram& diag);
+
+  /**
+   * Fix the boundary at position `i` of the boundary of the diagram to a
+   * computational basis state.
+   */
+  void fix_boundary(unsigned i, bool value);
+
+  /** Number of tensors in the network, excluding a global scalar. */
+  unsigned n_tensors() const;
+
+  /**
+   * Contract the network.
+   *
+   * The result is indexed by the unfixed boundaries in the order of the
+   * boundary of the diagram, with the first being the most significant bit.
+   * A network with no unfixed boundaries gives a vector of size 1.
+   *
+   * @param n_threads number of threads to split each large contraction
+   *   between, or 0 to use the hardware concurrency
+   *
+   * @throws ZXError if an intermediate tensor would have too many indices
+   */
+  Eigen::VectorXcd contract(unsigned n_threads = 1) const;
+
+ private:
+  struct Tensor {
+    // Wire end identifiers, with the first as the most significant bit
+    std::vector<unsigned> indices;
+    Eigen::VectorXcd data;
+  };
+
+  std::vector<Tensor> tensors_;
+  // Index of each boundary, in the order of the boundary of the diagram
+  std::vector<unsigned> boundary_indices_;
+  std::vector<bool> fixed_;
+  Complex scalar_;
+  unsigned n_indices_;
+
+  unsigned new_index();
+};
+
+/**
+ * Evaluate a quantum ZXDiagram to a tensor over its boundary, in the order of
+ * the boundary with the first boundary as the most significant bit.
+ * A diagram with no boundary evaluates to its scalar.
+ */
+Eigen::VectorXcd tensor_from_quantum_diagram(
+    const ZXDiagram& diag, unsigned n_threads = 1);
+
+/**
+ * Evaluate a quantum ZXDiagram with only Input and Output boundaries to the
+ * matrix from its inputs to its outputs, with the first input and output as
+ * the most significant bits.
+ */
+Eigen::MatrixXcd unitary_from_quantum_diagram(
+    const ZXDiagram& diag, unsigned n_threads = 1);
+
+/**
+ * Evaluate a single amplitude of a quantum ZXDiagram, fixing each boundary to
+ * the corresponding computational basis state of `values`, given in the
+ * order of the boundary.
+ */
+Complex amplitude_from_quantum_diagram(
+    const ZXDiagram& diag, const std::vector<bool>& values,
+    unsigned n_threads = 1);
+
+}  // namespace zx
+
+}  // namespace tket
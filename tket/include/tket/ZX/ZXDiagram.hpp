@@ -20,10 +20,13 @@ namespace tket {
 
 namespace zx {
 
-// Forward declare Rewrite, ZXDiagramPybind, Flow for friend access
+// Forward declare Rewrite, ZXDiagramPybind, Flow, GraphLikeDiagram,
+// TensorNetwork for friend access
 class Rewrite;
 class ZXDiagramPybind;
 class Flow;
+class GraphLikeDiagram;
+class TensorNetwork;
 
 class ZXDiagram {
  private:
@@ -81,6 +84,12 @@ class ZXDiagram {
   unsigned n_vertices() const;
   unsigned n_wires() const;
 
+  /**
+   * Estimated bytes held by the diagram, counting each distinct generator
+   * once however many vertices share it (see tket/Utils/MemoryUsage.hpp).
+   */
+  std::size_t memory_usage() const;
+
   // Count number of vertices with certain types & properties
   unsigned count_vertices(ZXType type) const;
   unsigned count_vertices(ZXType zxtype, QuantumType qtype) const;
@@ -323,6 +332,8 @@ class ZXDiagram {
   friend Rewrite;
   friend ZXDiagramPybind;
   friend Flow;
+  friend GraphLikeDiagram;
+  friend TensorNetwork;
 
  private:
   /**
@@ -175,6 +175,12 @@ class ZXGen {
 
   bool operator==(const ZXGen& other) const;
 
+  /**
+   * Estimated bytes held by this generator, including any diagram it
+   * contains (see tket/Utils/MemoryUsage.hpp).
+   */
+  virtual std::size_t memory_usage() const { return sizeof(ZXGen); }
+
   virtual ~ZXGen();
 
   /**
@@ -252,7 +258,20 @@ class PhasedGen : public BasicGen {
   PhasedGen(
       ZXType type, const Expr& param, QuantumType qtype = QuantumType::Quantum);
 
-  Expr get_param() const;
+  const Expr& get_param() const;
+
+  /**
+   * The phase modulo 2, if it has no free symbols (always nullopt for Hbox).
+   * Evaluated once on construction so that rewrites can test and combine
+   * numeric phases without symbolic arithmetic.
+   */
+  const std::optional<double>& get_numeric_param() const;
+
+  /**
+   * As `equiv_Clifford(get_param())`, using the numeric phase when there is
+   * one.
+   */
+  std::optional<unsigned> get_clifford_multiple() const;
 
   // Overrides from ZXGen
   virtual SymSet free_symbols() const override;
@@ -260,11 +279,25 @@ class PhasedGen : public BasicGen {
       const SymEngine::map_basic_basic& sub_map) const override;
   virtual std::string get_name(bool latex = false) const override;
   virtual bool is_equal(const ZXGen& other) const override;
+  virtual std::size_t memory_usage() const override {
+    return sizeof(PhasedGen);
+  }
 
  protected:
   const Expr param_;
+  const std::optional<double> numeric_param_;
 };
 
+/**
+ * Sum of the phase of `gen` and `phase`, where `numeric_phase` is the value of
+ * `phase` if it has no free symbols. When both are numeric the sum is taken in
+ * double arithmetic modulo 2, so Expr arithmetic is only used for phases that
+ * really are symbolic.
+ */
+Expr add_phase(
+    const PhasedGen& gen, const Expr& phase,
+    const std::optional<double>& numeric_phase);
+
 /**
  * Implementation of BasicGen for Clifford generators.
  * The basis is determined by the ZX type, and the boolean parameter determines
@@ -354,6 +387,7 @@ class ZXBox : public ZXDirected {
       const SymEngine::map_basic_basic& sub_map) const override;
   virtual std::string get_name(bool latex = false) const override;
   virtual bool is_equal(const ZXGen& other) const override;
+  virtual std::size_t memory_usage() const override;
 
   // Overrides from ZXDirected
   virtual unsigned n_ports() const override;
@@ -12,11 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 
 #include "ComparisonFunctions.hpp"
+#include "Workloads.hpp"
 #include "rapidcheck.h"
 #include "tket/Architecture/Architecture.hpp"
+#include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Circuit/Simulation/CircuitSimulator.hpp"
 #include "tket/Predicates/PassGenerators.hpp"
@@ -24,6 +29,7 @@
 #include "tket/Predicates/Predicates.hpp"
 #include "tket/Transformations/ContextualReduction.hpp"
 #include "tket/Transformations/Transform.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 
 using namespace tket;
 
@@ -54,6 +60,7 @@ using namespace tket;
   DO(NormaliseTK2)                        \
   DO(SquashRzPhasedX)                     \
   DO(CnXPairwiseDecomposition)            \
+  DO(CnXAncillaDecomposition)             \
   DO(RemoveImplicitQubitPermutation)
 
 static const std::map<PassPtr, std::string> &pass_name() {
@@ -395,11 +402,180 @@ bool check_initial_simplification() {
       });
 }
 
+// Generate a small instance of one of the synthetic workloads.
+static Circuit random_workload() {
+  const std::size_t seed = *rc::gen::arbitrary<std::size_t>();
+  const unsigned n_qb = *rc::gen::inRange(2, 6);
+  switch (*rc::gen::inRange(0, 6)) {
+    case 0:
+      return workloads::random_layered_circuit(n_qb, 3, seed);
+    case 1:
+      return workloads::random_clifford_t_circuit(n_qb, 20, 20, seed);
+    case 2:
+      return workloads::qaoa_circuit(n_qb, n_qb - 1, 2, seed);
+    case 3:
+      return workloads::trotter_circuit(
+          n_qb, 4, *rc::gen::inRange(1u, n_qb + 1), 2, seed,
+          *rc::gen::arbitrary<bool>());
+    case 4:
+      return workloads::qft_circuit(n_qb, *rc::gen::inRange(0u, n_qb));
+    default:
+      return workloads::adder_circuit(n_qb / 2);
+  }
+}
+
+bool check_workloads() {
+  return rc::check(
+      "passes preserve the unitary of synthetic workloads",
+      [](const PassPtr &p) {
+        const Circuit c = random_workload();
+        PredicatePtrMap precons = p->get_conditions().first;
+        if (!std::all_of(precons.begin(), precons.end(), [&c](auto precon) {
+              return precon.second->verify(c);
+            })) {
+          return;
+        }
+        RC_LOG() << "\nCircuit (" << c.n_qubits() << " qubits, "
+                 << c.n_gates() << " gates): " << c << std::endl;
+        RC_LOG() << "Pass: " << pass_name().at(p) << std::endl;
+        CompilationUnit cu(c);
+        if (p->apply(cu)) {
+          check_correctness(c, cu);
+        } else {
+          RC_ASSERT(c == cu.get_circ_ref());
+        }
+      });
+}
+
+bool check_adder() {
+  return rc::check("ripple-carry adder computes the sum", [] {
+    const unsigned n_bits = *rc::gen::inRange(1, 4);
+    const unsigned a = *rc::gen::inRange(0u, 1u << n_bits);
+    const unsigned b = *rc::gen::inRange(0u, 1u << n_bits);
+    const unsigned carry_in = *rc::gen::inRange(0u, 2u);
+    const unsigned n_qb = 2 * n_bits + 2;
+    // Qubit 0 is the most significant bit of a basis state index.
+    auto bit = [n_qb](unsigned q) { return 1u << (n_qb - 1 - q); };
+    Circuit c(n_qb);
+    unsigned input = 0;
+    if (carry_in) {
+      c.add_op<unsigned>(OpType::X, {0});
+      input |= bit(0);
+    }
+    for (unsigned i = 0; i < n_bits; i++) {
+      if ((a >> i) & 1) {
+        c.add_op<unsigned>(OpType::X, {1 + i});
+        input |= bit(1 + i);
+      }
+      if ((b >> i) & 1) {
+        c.add_op<unsigned>(OpType::X, {1 + n_bits + i});
+      }
+    }
+    c.append(workloads::adder_circuit(n_bits));
+    const unsigned sum = a + b + carry_in;
+    unsigned expected = input;
+    for (unsigned i = 0; i <= n_bits; i++) {
+      if ((sum >> i) & 1) expected |= bit(1 + n_bits + i);
+    }
+    const auto sv = tket_sim::get_statevector(c);
+    RC_ASSERT(std::abs(sv(expected)) > 1 - 1e-9);
+  });
+}
+
+// Number of allocations made while the counting hook is installed. The hook
+// runs inside operator new, so it must not allocate itself.
+static std::atomic<std::size_t> n_allocations{0};
+
+static void count_allocation(std::ptrdiff_t bytes) {
+  if (bytes > 0) n_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+struct PassCost {
+  // Fastest of several runs, which is least affected by noise.
+  std::chrono::nanoseconds time;
+  // Only counted if the library was built with allocation tracking.
+  std::size_t allocations;
+};
+
+static PassCost measure_pass(const PassPtr &p, const Circuit &c) {
+  PassCost cost{std::chrono::nanoseconds::max(), 0};
+  for (unsigned i = 0; i < 5; i++) {
+    CompilationUnit cu(c);
+    n_allocations.store(0);
+    memory::set_allocation_hook(count_allocation);
+    const auto start = std::chrono::steady_clock::now();
+    p->apply(cu);
+    const auto end = std::chrono::steady_clock::now();
+    memory::set_allocation_hook(nullptr);
+    cost.time = std::min(
+        cost.time,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+    cost.allocations = n_allocations.load();
+  }
+  return cost;
+}
+
+// Layered circuit of n_layers layers, each wrapped in a CircBox.
+static Circuit boxed_layers(unsigned n_qb, unsigned n_layers, unsigned seed) {
+  Circuit c(n_qb);
+  std::vector<unsigned> qbs(n_qb);
+  std::iota(qbs.begin(), qbs.end(), 0);
+  for (unsigned i = 0; i < n_layers; i++) {
+    c.add_box(
+        CircBox(workloads::random_layered_circuit(n_qb, 1, seed + i)), qbs);
+  }
+  return c;
+}
+
+/**
+ * Check that a pass's cost grows roughly linearly in the circuit size.
+ *
+ * Doubling the size of a linear-time pass doubles its cost, while a
+ * quadratic one would quadruple it. To leave room for noise, the cost on the
+ * doubled circuit may be up to three times the cost on the original, plus a
+ * millisecond of slack for the time.
+ *
+ * @param name description of the property
+ * @param p pass to run
+ * @param make circuit generator taking a number of qubits, a size and a seed
+ */
+template <typename Make>
+static bool check_linear_scaling(
+    const std::string &name, const PassPtr &p, Make make) {
+  return rc::check(name, [&p, &make] {
+    const unsigned n_qb = *rc::gen::inRange(2u, 9u);
+    const unsigned n = *rc::gen::inRange(50u, 101u);
+    const unsigned seed = *rc::gen::arbitrary<unsigned>();
+    const PassCost cost = measure_pass(p, make(n_qb, n, seed));
+    const PassCost cost2 = measure_pass(p, make(n_qb, 2 * n, seed));
+    RC_LOG() << n_qb << " qubits, size " << n << ": " << cost.time.count()
+             << " ns, " << cost.allocations << " allocations; size " << 2 * n
+             << ": " << cost2.time.count() << " ns, " << cost2.allocations
+             << " allocations" << std::endl;
+    RC_ASSERT(cost2.time <= 3 * cost.time + std::chrono::milliseconds(1));
+    RC_ASSERT(cost2.allocations <= 3 * cost.allocations);
+  });
+}
+
+bool check_scaling() {
+  return check_linear_scaling(
+             "RemoveRedundancies scales linearly", RemoveRedundancies(),
+             [](unsigned n_qb, unsigned n, unsigned seed) {
+               return workloads::random_layered_circuit(n_qb, n, seed);
+             }) &&
+         check_linear_scaling(
+             "DecomposeBoxes scales linearly", DecomposeBoxes(),
+             boxed_layers);
+}
+
 int main() {
   bool ok = true;
   ok = ok && check_n_qubits();
   ok = ok && check_passes();
   ok = ok && check_mapping();
   ok = ok && check_initial_simplification();
+  ok = ok && check_workloads();
+  ok = ok && check_adder();
+  ok = ok && check_scaling();
   return ok ? 0 : 1;
 }
@@ -14,7 +14,13 @@
 
 #include "tket/ArchAwareSynth/Path.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <tkrng/RNG.hpp>
 
 namespace tket {
 
@@ -150,7 +156,233 @@ std::list<unsigned> PathHandler::find_path(unsigned i, unsigned j) {
   return path;
 }
 
-std::vector<Node> find_hampath(const Architecture &arch, long timeout) {
+namespace {
+
+// The architecture as an undirected graph on node indices,
+// with the nodes in increasing order.
+struct IndexGraph {
+  std::vector<Node> nodes;
+  std::vector<std::vector<unsigned>> neighbours;
+  // Each undirected edge once, as (i,j) with i < j, sorted.
+  std::vector<std::pair<unsigned, unsigned>> edges;
+
+  explicit IndexGraph(const Architecture &arch) {
+    nodes = arch.get_all_nodes_vec();
+    std::sort(nodes.begin(), nodes.end());
+    std::map<Node, unsigned> indices;
+    for (unsigned i = 0; i < nodes.size(); ++i) {
+      indices[nodes[i]] = i;
+    }
+    for (const auto &[node1, node2] : arch.get_all_edges_vec()) {
+      unsigned i = indices.at(node1);
+      unsigned j = indices.at(node2);
+      if (i > j) std::swap(i, j);
+      if (i != j) edges.emplace_back(i, j);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    neighbours.resize(nodes.size());
+    for (const auto &[i, j] : edges) {
+      neighbours[i].push_back(j);
+      neighbours[j].push_back(i);
+    }
+  }
+
+  std::vector<Node> to_nodes(const std::vector<unsigned> &path) const {
+    std::vector<Node> result;
+    result.reserve(path.size());
+    for (unsigned i : path) {
+      result.push_back(nodes[i]);
+    }
+    return result;
+  }
+
+  // True if there is obviously no Hamiltonian path: the graph is
+  // disconnected, or more than two nodes (which would all have to be
+  // endpoints) have only one neighbour.
+  bool has_no_path() const {
+    const unsigned n = nodes.size();
+    if (n <= 1) return false;
+    unsigned n_leaves = 0;
+    for (const auto &node_neighbours : neighbours) {
+      if (node_neighbours.size() == 1) ++n_leaves;
+    }
+    if (n_leaves > 2) return true;
+    std::vector<bool> reached(n, false);
+    std::vector<unsigned> stack{0};
+    reached[0] = true;
+    unsigned n_reached = 1;
+    while (!stack.empty()) {
+      const unsigned i = stack.back();
+      stack.pop_back();
+      for (unsigned j : neighbours[i]) {
+        if (!reached[j]) {
+          reached[j] = true;
+          ++n_reached;
+          stack.push_back(j);
+        }
+      }
+    }
+    return n_reached < n;
+  }
+};
+
+// One attempt of the heuristic from the given start. Returns an empty
+// vector on failure.
+std::vector<unsigned> attempt_hampath(
+    const IndexGraph &graph, unsigned start, RNG &rng) {
+  const unsigned n = graph.nodes.size();
+  const auto &neighbours = graph.neighbours;
+  std::vector<bool> visited(n, false);
+  // The number of unvisited neighbours of each node.
+  std::vector<unsigned> free_degree(n);
+  for (unsigned i = 0; i < n; ++i) {
+    free_degree[i] = neighbours[i].size();
+  }
+  std::vector<unsigned> path;
+  path.reserve(n);
+  const auto visit = [&](unsigned i) {
+    path.push_back(i);
+    visited[i] = true;
+    for (unsigned j : neighbours[i]) {
+      --free_degree[j];
+    }
+  };
+  visit(start);
+  bool reversed = false;
+  // Each rotation costs O(n), so bound their number.
+  unsigned rotations_left = 4 * n;
+  std::vector<unsigned> candidates;
+
+  while (path.size() < n) {
+    const unsigned end = path.back();
+    if (free_degree[end] > 0) {
+      // Warnsdorff's rule, breaking ties at random.
+      candidates.clear();
+      unsigned min_degree = n;
+      for (unsigned j : neighbours[end]) {
+        if (visited[j]) continue;
+        if (free_degree[j] < min_degree) {
+          min_degree = free_degree[j];
+          candidates.clear();
+        }
+        if (free_degree[j] == min_degree) candidates.push_back(j);
+      }
+      visit(rng.get_element(candidates));
+      continue;
+    }
+    // Stuck. First try continuing from the other end instead.
+    if (!reversed && free_degree[path.front()] > 0) {
+      std::reverse(path.begin(), path.end());
+      reversed = true;
+      continue;
+    }
+    if (rotations_left == 0) return {};
+    --rotations_left;
+    // Rotate: for a neighbour path[k] of the end, reversing
+    // path[k+1..] keeps a path, with new end path[k+1].
+    // Prefer a new end from which the path can be extended.
+    std::vector<unsigned> position(n);
+    for (unsigned k = 0; k < path.size(); ++k) {
+      position[path[k]] = k;
+    }
+    candidates.clear();
+    std::vector<unsigned> extendable;
+    for (unsigned j : neighbours[end]) {
+      const unsigned k = position[j];
+      if (k + 2 >= path.size()) continue;
+      candidates.push_back(k);
+      if (free_degree[path[k + 1]] > 0) extendable.push_back(k);
+    }
+    if (candidates.empty()) return {};
+    const unsigned k = extendable.empty() ? rng.get_element(candidates)
+                                          : rng.get_element(extendable);
+    std::reverse(path.begin() + k + 1, path.end());
+  }
+  return path;
+}
+
+// Paths already found, keyed by the nodes and edges of the architecture.
+typedef std::pair<std::vector<Node>, std::vector<std::pair<unsigned, unsigned>>>
+    HampathCacheKey;
+std::mutex hampath_cache_mutex;
+std::map<HampathCacheKey, std::vector<Node>> hampath_cache;
+// Bound the memory used by many different architectures.
+constexpr std::size_t max_hampath_cache_size = 64;
+
+std::optional<std::vector<unsigned>> find_hampath_indices(
+    const IndexGraph &graph, unsigned n_attempts, unsigned n_threads) {
+  const unsigned n = graph.nodes.size();
+  if (n <= 1) {
+    return std::vector<unsigned>(n, 0);
+  }
+  if (graph.has_no_path()) return std::nullopt;
+
+  // Nodes of degree one must be endpoints, so start from one if possible.
+  std::vector<unsigned> starts;
+  unsigned min_degree = n;
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned degree = graph.neighbours[i].size();
+    if (degree < min_degree) {
+      min_degree = degree;
+      starts.clear();
+    }
+    if (degree == min_degree) starts.push_back(i);
+  }
+  if (min_degree > 1) {
+    starts.resize(n);
+    for (unsigned i = 0; i < n; ++i) starts[i] = i;
+  }
+
+  // To be independent of the thread scheduling, the result is the path
+  // from the lowest-numbered successful attempt.
+  std::atomic<unsigned> next_attempt = 0;
+  std::atomic<unsigned> best_attempt = n_attempts;
+  std::vector<unsigned> best_path;
+  std::mutex best_path_mutex;
+  const auto work = [&]() {
+    RNG rng;
+    for (unsigned attempt = next_attempt++; attempt < best_attempt;
+         attempt = next_attempt++) {
+      rng.set_seed(attempt);
+      const unsigned start = attempt == 0 ? starts[0] : rng.get_element(starts);
+      std::vector<unsigned> path = attempt_hampath(graph, start, rng);
+      if (path.empty()) continue;
+      std::lock_guard<std::mutex> lock(best_path_mutex);
+      if (attempt < best_attempt) {
+        best_attempt = attempt;
+        best_path = std::move(path);
+      }
+    }
+  };
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  n_threads = std::max(1u, std::min(n_threads, n_attempts));
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < n_threads; t++) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread &thread : threads) thread.join();
+  if (best_path.empty()) return std::nullopt;
+  return best_path;
+}
+
+}  // namespace
+
+std::optional<std::vector<Node>> find_hampath_heuristic(
+    const Architecture &arch, unsigned n_attempts, unsigned n_threads) {
+  const IndexGraph graph(arch);
+  std::optional<std::vector<unsigned>> path =
+      find_hampath_indices(graph, n_attempts, n_threads);
+  if (!path) return std::nullopt;
+  return graph.to_nodes(*path);
+}
+
+// Exhaustive search, by finding a monomorphism from a line.
+static std::vector<Node> find_hampath_exhaustive(
+    const Architecture &arch, long timeout) {
   unsigned n_nodes = arch.n_nodes();
   std::vector<Qubit> arch_qubits;
   for (unsigned i = 0; i < n_nodes; i++) {
@@ -171,9 +403,7 @@ std::vector<Node> find_hampath(const Architecture &arch, long timeout) {
 
   /* Architecture has no hampath, sad. */
   if (all_maps.empty()) {
-    throw NoHamiltonPath(
-        "[AAS]: no Hamilton path found in the given architecture, CNOT "
-        "synthesis stopped. Please try an alternative CNotSynthType.");
+    return {};
   }
 
   /* Left: line, Right: input architecture. */
@@ -185,6 +415,32 @@ std::vector<Node> find_hampath(const Architecture &arch, long timeout) {
   return hampath;
 }
 
+std::vector<Node> find_hampath(const Architecture &arch, long timeout) {
+  const IndexGraph graph(arch);
+  HampathCacheKey key(graph.nodes, graph.edges);
+  {
+    std::lock_guard<std::mutex> lock(hampath_cache_mutex);
+    auto found = hampath_cache.find(key);
+    if (found != hampath_cache.end()) return found->second;
+  }
+  std::vector<Node> hampath;
+  if (!graph.has_no_path()) {
+    std::optional<std::vector<unsigned>> path =
+        find_hampath_indices(graph, 64, 0);
+    hampath = path ? graph.to_nodes(*path)
+                   : find_hampath_exhaustive(arch, timeout);
+  }
+  if (hampath.empty() && !graph.nodes.empty()) {
+    throw NoHamiltonPath(
+        "[AAS]: no Hamilton path found in the given architecture, CNOT "
+        "synthesis stopped. Please try an alternative CNotSynthType.");
+  }
+  std::lock_guard<std::mutex> lock(hampath_cache_mutex);
+  if (hampath_cache.size() >= max_hampath_cache_size) hampath_cache.clear();
+  hampath_cache.emplace(std::move(key), hampath);
+  return hampath;
+}
+
 IterationOrder::IterationOrder(const Architecture &arch) {
   std::set<Node> visited_nodes;
 
@@ -15,6 +15,13 @@
 #include "tket/ArchAwareSynth/SteinerForest.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <boost/functional/hash.hpp>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "tket/ArchAwareSynth/SteinerTree.hpp"
@@ -33,6 +40,59 @@ ParityList parity_column_to_list(const std::vector<bool> &parity_column) {
   return parity_list;
 }
 
+// Trees without their expressions, as used by the lookahead search
+typedef std::map<unsigned, std::list<SteinerTree>> SearchTrees;
+
+static SteinerTree &tree_of(SteinerTree &tree) { return tree; }
+static const SteinerTree &tree_of(const SteinerTree &tree) { return tree; }
+static SteinerTree &tree_of(std::pair<SteinerTree, Expr> &tree_expr) {
+  return tree_expr.first;
+}
+static const SteinerTree &tree_of(
+    const std::pair<SteinerTree, Expr> &tree_expr) {
+  return tree_expr.first;
+}
+
+/* Apply a CNOT with control j and target i to every tree, updating the global
+ * cost; trees which become fully reduced are passed to on_reduced and
+ * dropped. */
+template <typename T, typename F>
+static std::map<unsigned, std::list<T>> apply_row(
+    const std::map<unsigned, std::list<T>> &trees, unsigned i, unsigned j,
+    unsigned &global_cost, F on_reduced) {
+  std::map<unsigned, std::list<T>> new_trees;
+  for (const auto &cost_trees : trees) {
+    for (T element : cost_trees.second) {
+      SteinerTree &tree = tree_of(element);
+      tree.add_row(i, j);
+      if (tree.fully_reduced()) {
+        on_reduced(element);
+      } else {
+        unsigned cost_change = tree.last_operation_cost;
+        global_cost += cost_change;
+        new_trees[tree.tree_cost].push_back(std::move(element));
+      }
+    }
+  }
+  return new_trees;
+}
+
+template <typename T>
+static OperationList operations_under_index(
+    const std::map<unsigned, std::list<T>> &trees, const PathHandler &path,
+    unsigned index) {
+  OperationList operations;
+  for (unsigned i = 0; i != index; ++i) {
+    auto iter = trees.find(i);
+    if (iter == trees.end()) continue;
+    for (const T &element : iter->second) {
+      operations.splice(
+          operations.begin(), tree_of(element).operations_available(path));
+    }
+  }
+  return operations;
+}
+
 SteinerForest::SteinerForest(
     const PathHandler &paths, const PhasePolyBox &phasepolybox) {
   global_cost = 0;
@@ -104,31 +164,14 @@ void SteinerForest::add_row_globally(unsigned i, unsigned j) {
   linear_function.col_add(
       i, j);  // prepend a CNOT to the linear reversible function
 
-  CostedTrees new_trees;
-
-  for (const auto &cost_trees : current_trees) {
-    for (auto tree_expr : cost_trees.second) {
-      tree_expr.first.add_row(i, j);
-      /* If the tree has been fully reduced, remove it from the
-      forest */
-      if (tree_expr.first.fully_reduced()) {
+  current_trees = apply_row(
+      current_trees, i, j, global_cost,
+      [&](const std::pair<SteinerTree, Expr> &tree_expr) {
+        /* The tree has been fully reduced, so remove it from the forest */
         std::vector<unsigned> qubit{i};
         synth_circuit.add_op(OpType::Rz, tree_expr.second, qubit);
         --tree_count;
-      }
-      /* Otherwise, update the forest */
-      else {
-        CostedTrees::iterator iter = new_trees.find(tree_expr.first.tree_cost);
-        if (iter == new_trees.end())
-          new_trees.insert({tree_expr.first.tree_cost, {tree_expr}});
-        else
-          iter->second.push_back(tree_expr);
-        unsigned cost_change = tree_expr.first.last_operation_cost;
-        global_cost += cost_change;
-      }
-    }
-  }
-  current_trees = new_trees;
+      });
 }
 
 void SteinerForest::add_operation_list(const OperationList &oper_list) {
@@ -139,16 +182,7 @@ void SteinerForest::add_operation_list(const OperationList &oper_list) {
 
 OperationList SteinerForest::operations_available_under_the_index(
     const PathHandler &path, unsigned index) const {
-  OperationList operations;
-  for (unsigned i = 0; i != index; ++i) {
-    CostedTrees::const_iterator iter = current_trees.find(i);
-    if (iter == current_trees.end()) continue;
-    for (const auto &tree_pair : iter->second) {
-      operations.splice(
-          operations.begin(), tree_pair.first.operations_available(path));
-    }
-  }
-  return operations;
+  return operations_under_index(current_trees, path, index);
 }
 
 OperationList SteinerForest::operations_available_at_index(
@@ -178,6 +212,124 @@ OperationList SteinerForest::operations_available_at_min_costs(
   return operations;
 }
 
+/* Whether candidate operations are better than the best so far: cheaper, or
+ * as cheap with fewer operations. */
+static bool better_operations(
+    const CostedOperations &candidate, const CostedOperations &best) {
+  return (candidate.first < best.first) ||
+         ((candidate.first == best.first) &&
+          (candidate.second.size() < best.second.size()));
+}
+
+/* The state of a forest during the lookahead search. The trees are shared
+ * between the branches of the search, and copied only by applying an
+ * operation. */
+struct SearchState {
+  std::shared_ptr<const SearchTrees> trees;
+  unsigned global_cost;
+};
+
+static SearchState make_search_state(const SteinerForest &forest) {
+  auto trees = std::make_shared<SearchTrees>();
+  for (const auto &cost_trees : forest.current_trees) {
+    std::list<SteinerTree> &cost_list = (*trees)[cost_trees.first];
+    for (const auto &tree_expr : cost_trees.second) {
+      cost_list.push_back(tree_expr.first);
+    }
+  }
+  return {trees, forest.global_cost};
+}
+
+/* Lookahead search with the results for each state of the trees memoised, so
+ * that a state reached by several sequences of operations is searched once.
+ * Safe to call from several threads. */
+class LookaheadSearch {
+ public:
+  explicit LookaheadSearch(const PathHandler &path) : path_(path) {}
+
+  /* Best cost and operations after applying op and looking ahead a further
+   * lookahead steps; the operations start with op. */
+  CostedOperations search(
+      const SearchState &state, const Operation &op, unsigned lookahead) {
+    SearchState next{nullptr, state.global_cost};
+    next.trees = std::make_shared<const SearchTrees>(apply_row(
+        *state.trees, op.first, op.second, next.global_cost,
+        [](const SteinerTree &) {}));
+    if ((lookahead == 0) || next.trees->empty()) {
+      return {next.global_cost, {op}};
+    }
+    const Key key = make_key(*next.trees, lookahead);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto found = memo_.find(key);
+      if (found != memo_.end()) {
+        OperationList operations = found->second.second;
+        operations.push_front(op);
+        return {next.global_cost + found->second.first, operations};
+      }
+    }
+    unsigned index = next.trees->rbegin()->first;
+    OperationList operations_available =
+        operations_under_index(*next.trees, path_, index);
+    if (operations_available.empty()) {
+      return {next.global_cost, {op}};
+    }
+    CostedOperations costed_operations =
+        search(next, operations_available.front(), lookahead - 1);
+    operations_available.pop_front();
+    for (const Operation &next_op : operations_available) {
+      CostedOperations candidate_operations =
+          search(next, next_op, lookahead - 1);
+      if (better_operations(candidate_operations, costed_operations)) {
+        costed_operations = std::move(candidate_operations);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      memo_.insert(
+          {key,
+           {costed_operations.first - next.global_cost,
+            costed_operations.second}});
+    }
+    costed_operations.second.push_front(op);
+    return costed_operations;
+  }
+
+ private:
+  /* The remaining lookahead and, for each tree in order, its cost, node
+   * types and numbers of neighbours, which determine the rest of the
+   * search. */
+  typedef std::vector<unsigned> Key;
+  struct KeyHash {
+    std::size_t operator()(const Key &key) const {
+      return boost::hash_range(key.begin(), key.end());
+    }
+  };
+
+  static Key make_key(const SearchTrees &trees, unsigned lookahead) {
+    Key key{lookahead};
+    for (const auto &cost_trees : trees) {
+      for (const SteinerTree &tree : cost_trees.second) {
+        key.push_back(tree.tree_cost);
+        key.push_back(tree.root);
+        key.push_back(tree.tree_nodes.size());
+        key.insert(key.end(), tree.tree_nodes.begin(), tree.tree_nodes.end());
+        for (SteinerNodeType t : tree.node_types) {
+          key.push_back(static_cast<unsigned>(t));
+        }
+        key.insert(
+            key.end(), tree.num_neighbours.begin(), tree.num_neighbours.end());
+      }
+    }
+    return key;
+  }
+
+  const PathHandler &path_;
+  std::mutex mutex_;
+  // Increase of the global cost, and operations after the state
+  std::unordered_map<Key, CostedOperations, KeyHash> memo_;
+};
+
 CostedOperations best_operations_lookahead(
     const PathHandler &path, const SteinerForest &forest, unsigned lookahead) {
   if (lookahead == 0) {
@@ -193,71 +345,66 @@ CostedOperations best_operations_lookahead(
 
   TKET_ASSERT(!operations_available.empty());  // Cannot find any operations
 
-  // set up base case
-  OperationList ops{operations_available.front()};
-  CostedOperations costed_operations =
-      recursive_operation_search(path, forest, lookahead - 1, ops);
-  operations_available.pop_front();
-
-  for (OperationList::iterator op_iter = operations_available.begin();
-       op_iter != operations_available.end(); ++op_iter) {
-    ops = {*op_iter};
-    CostedOperations candidate_operations =
-        recursive_operation_search(path, forest, lookahead - 1, ops);
-
-    if ((candidate_operations.first < costed_operations.first) ||
-        ((candidate_operations.first == costed_operations.first) &&
-         (candidate_operations.second.size() <
-          costed_operations.second.size()))) {
-      costed_operations = std::move(candidate_operations);
+  // Evaluate the candidate operations in parallel when they look ahead
+  const std::vector<Operation> candidates(
+      operations_available.begin(), operations_available.end());
+  const std::size_t n = candidates.size();
+  std::vector<CostedOperations> results(n);
+  const SearchState state = make_search_state(forest);
+  LookaheadSearch search(path);
+  std::atomic<std::size_t> next_index{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&]() {
+    try {
+      for (std::size_t i = next_index++; i < n; i = next_index++) {
+        results[i] = search.search(state, candidates[i], lookahead - 1);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_index = n;
     }
+  };
+  const std::size_t number_of_threads =
+      (lookahead == 1)
+          ? 1
+          : std::min<std::size_t>(
+                n, std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
   }
 
+  // Reduce in order, so that ties are broken as by a serial search
+  CostedOperations costed_operations = std::move(results[0]);
+  for (std::size_t i = 1; i < n; ++i) {
+    if (better_operations(results[i], costed_operations)) {
+      costed_operations = std::move(results[i]);
+    }
+  }
   return costed_operations;
 }
 
 CostedOperations recursive_operation_search(
-    const PathHandler &path, SteinerForest forest, unsigned lookahead,
+    const PathHandler &path, const SteinerForest &forest, unsigned lookahead,
     OperationList row_operations) {
-  CostedOperations costed_operations;
-  CostedOperations candidate_operations;
-
-  forest.add_row_globally(
-      row_operations.back().first, row_operations.back().second);
-
-  if ((lookahead == 0) || (forest.current_trees.empty())) {
-    return {forest.global_cost, row_operations};
-  }
-  CostedTrees::const_reverse_iterator r_iter = forest.current_trees.rbegin();
-  unsigned index = r_iter->first;
-  OperationList operations_available =
-      forest.operations_available_under_the_index(path, index);
-  if (operations_available.empty()) {
-    return {forest.global_cost, row_operations};
-  } else {
-    row_operations.push_back(operations_available.front());
-    costed_operations =
-        recursive_operation_search(path, forest, lookahead - 1, row_operations);
-    row_operations.pop_back();
-    operations_available.pop_front();
-
-    for (OperationList::iterator op_iter = operations_available.begin();
-         op_iter != operations_available.end(); ++op_iter) {
-      row_operations.push_back(*op_iter);
-      candidate_operations = recursive_operation_search(
-          path, forest, lookahead - 1, row_operations);
-
-      row_operations.pop_back();
-
-      if ((candidate_operations.first < costed_operations.first) ||
-          ((candidate_operations.first == costed_operations.first) &&
-           (candidate_operations.second.size() <
-            costed_operations.second.size()))) {
-        costed_operations = std::move(candidate_operations);
-      }
-    }
-    return costed_operations;
-  }
+  LookaheadSearch search(path);
+  const Operation op = row_operations.back();
+  row_operations.pop_back();
+  CostedOperations costed_operations =
+      search.search(make_search_state(forest), op, lookahead);
+  row_operations.splice(row_operations.end(), costed_operations.second);
+  return {costed_operations.first, row_operations};
 }
 
 Circuit phase_poly_synthesis_int(
@@ -805,5 +805,114 @@ unsigned CNotSwapSynth::swap_to_root(
 
 bool CNotSwapSynth::valid_result() { return CNOT_matrix.is_id(); }
 
+static MatrixXb undirected_connectivity(
+    const Architecture &arch, const std::vector<Node> &nodes) {
+  unsigned n = nodes.size();
+  MatrixXb connectivity = MatrixXb::Zero(n, n);
+  for (unsigned i = 0; i != n; ++i) {
+    for (unsigned j = 0; j != n; ++j) {
+      connectivity(i, j) = arch.edge_exists(nodes[i], nodes[j]) ||
+                           arch.edge_exists(nodes[j], nodes[i]);
+    }
+  }
+  return connectivity;
+}
+
+SteinerGadgetSynth::SteinerGadgetSynth(const Architecture &arch)
+    : nodes_(arch.get_all_nodes_vec()),
+      paths_(undirected_connectivity(arch, nodes_)) {
+  for (unsigned i = 0; i != nodes_.size(); ++i) {
+    node_index_.insert({nodes_[i], i});
+  }
+}
+
+void SteinerGadgetSynth::append_gadget(
+    Circuit &circ, const SpSymPauliTensor &paulis) const {
+  std::vector<Pauli> support_paulis(nodes_.size(), Pauli::I);
+  std::list<unsigned> support;
+  for (const std::pair<const Qubit, Pauli> &qp : paulis.string) {
+    if (qp.second == Pauli::I) continue;
+    std::map<Qubit, unsigned>::const_iterator found =
+        node_index_.find(qp.first);
+    if (found == node_index_.end()) {
+      throw CircuitInvalidity(
+          "Pauli gadget acts on " + qp.first.repr() +
+          ", which is not a node of the architecture");
+    }
+    support_paulis[found->second] = qp.second;
+    support.push_back(found->second);
+  }
+  if (support.empty()) {
+    circ.add_phase(-paulis.coeff / 2);
+    return;
+  }
+  support.sort();
+  const unsigned root = support.front();
+  std::list<unsigned> nodes_to_add = support;
+  SteinerTree tree(paths_, nodes_to_add, root);
+
+  // Orient the tree from the root by a breadth-first search through the
+  // connections between its nodes
+  std::vector<bool> in_tree(nodes_.size(), false);
+  for (unsigned v : tree.nodes()) in_tree[v] = true;
+  const MatrixXb connectivity = paths_.get_connectivity_matrix();
+  std::vector<unsigned> parent(nodes_.size(), nodes_.size());
+  std::vector<unsigned> order{root};
+  parent[root] = root;
+  for (unsigned k = 0; k < order.size(); ++k) {
+    for (unsigned w = 0; w != nodes_.size(); ++w) {
+      if (in_tree[w] && parent[w] == nodes_.size() &&
+          connectivity(order[k], w)) {
+        parent[w] = order[k];
+        order.push_back(w);
+      }
+    }
+  }
+  // Only keep branches which reach the support
+  std::vector<bool> needed(nodes_.size(), false);
+  for (unsigned v : support) needed[v] = true;
+  for (unsigned k = order.size(); k-- > 1;) {
+    if (needed[order[k]]) needed[parent[order[k]]] = true;
+  }
+  std::vector<std::vector<unsigned>> children(nodes_.size());
+  for (unsigned k = 1; k < order.size(); ++k) {
+    if (needed[order[k]]) children[parent[order[k]]].push_back(order[k]);
+  }
+
+  // Change basis onto Z, then gather the parity onto the root from the
+  // leaves up. A node outside the support first cancels its own value by
+  // copying it into a child and back.
+  std::vector<std::pair<OpType, qubit_vector_t>> compute;
+  for (unsigned v : support) {
+    if (support_paulis[v] == Pauli::X) {
+      compute.push_back({OpType::H, {nodes_[v]}});
+    } else if (support_paulis[v] == Pauli::Y) {
+      compute.push_back({OpType::V, {nodes_[v]}});
+    }
+  }
+  for (unsigned k = order.size(); k-- > 0;) {
+    const unsigned v = order[k];
+    if (children[v].empty()) continue;
+    if (support_paulis[v] == Pauli::I) {
+      compute.push_back({OpType::CX, {nodes_[v], nodes_[children[v][0]]}});
+    }
+    for (unsigned c : children[v]) {
+      compute.push_back({OpType::CX, {nodes_[c], nodes_[v]}});
+    }
+  }
+
+  for (unsigned v = 0; v != nodes_.size(); ++v) {
+    if (needed[v] && !circ.contains_unit(nodes_[v])) circ.add_qubit(nodes_[v]);
+  }
+  for (const std::pair<OpType, qubit_vector_t> &gate : compute) {
+    circ.add_op<Qubit>(gate.first, gate.second);
+  }
+  circ.add_op<Qubit>(OpType::Rz, paulis.coeff, {nodes_[root]});
+  for (auto it = compute.rbegin(); it != compute.rend(); ++it) {
+    circ.add_op<Qubit>(
+        it->first == OpType::V ? OpType::Vdg : it->first, it->second);
+  }
+}
+
 }  // namespace aas
 }  // namespace tket
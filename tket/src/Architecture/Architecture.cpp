@@ -15,12 +15,18 @@
 #include "tket/Architecture/Architecture.hpp"
 
 #include <boost/graph/biconnected_components.hpp>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <tkassert/Assert.hpp>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "tket/Graphs/ArticulationPoints.hpp"
+#include "tket/Graphs/DynamicArticulationPoints.hpp"
 #include "tket/Utils/Json.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 #include "tket/Utils/UnitID.hpp"
 
 namespace tket {
@@ -92,6 +98,7 @@ std::set<Node> Architecture::get_articulation_points(
 }
 
 std::set<Node> Architecture::get_articulation_points() const {
+  if (articulation_points_) return *articulation_points_;
   std::set<Vertex> aps;
   UndirectedConnGraph undir_g = get_undirected_connectivity();
   boost::articulation_points(undir_g, std::inserter(aps, aps.begin()));
@@ -102,6 +109,35 @@ std::set<Node> Architecture::get_articulation_points() const {
   return ret;
 }
 
+void Architecture::freeze(unsigned n_threads) {
+  if (is_frozen()) return;
+  articulation_points_ = get_articulation_points();
+  graphs::DirectedGraph<Node>::freeze(n_threads);
+}
+
+void Architecture::freeze_with(
+    std::shared_ptr<const graphs::DistanceMatrix> distances,
+    std::optional<unsigned> diameter, const node_set_t& articulation_points) {
+  if (is_frozen()) return;
+  graphs::DirectedGraph<Node>::freeze_with(std::move(distances), diameter);
+  articulation_points_ = articulation_points;
+}
+
+void Architecture::thaw() {
+  articulation_points_ = std::nullopt;
+  graphs::DirectedGraph<Node>::thaw();
+}
+
+std::size_t Architecture::memory_usage() const {
+  std::size_t bytes = graphs::DirectedGraph<Node>::memory_usage() +
+                      sizeof(Architecture) -
+                      sizeof(graphs::DirectedGraph<Node>);
+  if (articulation_points_) {
+    bytes += memory::container_bytes(*articulation_points_);
+  }
+  return bytes;
+}
+
 static bool lexicographical_comparison(
     const std::vector<std::size_t>& dist1,
     const std::vector<std::size_t>& dist2) {
@@ -111,7 +147,11 @@ static bool lexicographical_comparison(
 
 std::optional<Node> Architecture::find_worst_node(
     const Architecture& original_arch) {
-  node_set_t ap = get_articulation_points();
+  return find_worst_node(original_arch, get_articulation_points());
+}
+
+std::optional<Node> Architecture::find_worst_node(
+    const Architecture& original_arch, const node_set_t& ap) {
   node_set_t min_nodes = min_degree_nodes();
 
   std::set<Node> bad_nodes;
@@ -159,11 +199,30 @@ std::optional<Node> Architecture::find_worst_node(
 node_set_t Architecture::remove_worst_nodes(unsigned num) {
   node_set_t out;
   Architecture original_arch(*this);
+  // Keep the articulation points up to date as nodes are removed,
+  // rather than recomputing them for the whole graph every time.
+  const node_vector_t nodes = get_all_nodes_vec();
+  std::map<Node, std::size_t> node_indices;
+  for (std::size_t i = 0; i < nodes.size(); ++i) {
+    node_indices[nodes[i]] = i;
+  }
+  std::vector<std::pair<std::size_t, std::size_t>> edges;
+  for (const Connection& edge : get_all_edges_vec()) {
+    edges.emplace_back(
+        node_indices.at(edge.first), node_indices.at(edge.second));
+  }
+  graphs::DynamicArticulationPoints dynamic_aps(nodes.size(), edges);
+
   for (unsigned k = 0; k < num; k++) {
-    std::optional<Node> v = find_worst_node(original_arch);
+    node_set_t ap;
+    for (std::size_t i : dynamic_aps.get_articulation_points()) {
+      ap.insert(nodes[i]);
+    }
+    std::optional<Node> v = find_worst_node(original_arch, ap);
     if (v.has_value()) {
       remove_node(v.value());
       out.insert(v.value());
+      dynamic_aps.remove_vertex(node_indices.at(v.value()));
     }
   }
   return out;
@@ -227,8 +286,39 @@ void to_json(nlohmann::json& j, const Architecture& ar) {
   j["links"] = links;
 }
 
+nlohmann::json architecture_to_json_with_precomputed(const Architecture& ar) {
+  nlohmann::json j = ar;
+  Architecture frozen = ar;
+  frozen.freeze();
+  std::shared_ptr<const graphs::DistanceMatrix> matrix =
+      frozen.get_distance_matrix();
+  // Distances are symmetric, so only those above the diagonal are stored, row
+  // by row, in the order of "nodes"
+  const std::size_t n = matrix->size();
+  std::vector<uint16_t> distances;
+  distances.reserve(n * (n - 1) / 2);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t k = i + 1; k < n; ++k) {
+      distances.push_back((*matrix)(i, k));
+    }
+  }
+  std::vector<std::size_t> articulation_points;
+  for (const Node& node : frozen.get_articulation_points()) {
+    articulation_points.push_back(frozen.get_node_index(node));
+  }
+  nlohmann::json precomputed;
+  precomputed["distances"] = distances;
+  precomputed["articulation_points"] = articulation_points;
+  if (std::optional<unsigned> diameter = frozen.get_known_diameter()) {
+    precomputed["diameter"] = *diameter;
+  }
+  j["precomputed"] = precomputed;
+  return j;
+}
+
 void from_json(const nlohmann::json& j, Architecture& ar) {
-  for (const Node& n : j.at("nodes").get<node_vector_t>()) {
+  const node_vector_t nodes = j.at("nodes").get<node_vector_t>();
+  for (const Node& n : nodes) {
     ar.add_node(n);
   }
   for (const auto& j_entry : j.at("links")) {
@@ -237,6 +327,39 @@ void from_json(const nlohmann::json& j, Architecture& ar) {
     unsigned w = j_entry.at("weight").get<unsigned>();
     ar.add_connection(l.first, l.second, w);
   }
+  if (!j.contains("precomputed")) return;
+  const nlohmann::json& precomputed = j.at("precomputed");
+  const std::size_t n = nodes.size();
+  if (ar.n_nodes() != n) {
+    throw JsonError("Architecture JSON must list each node once");
+  }
+  const std::vector<uint16_t> upper =
+      precomputed.at("distances").get<std::vector<uint16_t>>();
+  if (upper.size() != n * (n - 1) / 2) {
+    throw JsonError("Architecture JSON has the wrong number of distances");
+  }
+  std::vector<uint16_t> distances(n * n, 0);
+  std::size_t next = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t k = i + 1; k < n; ++k) {
+      distances[i * n + k] = distances[k * n + i] = upper[next++];
+    }
+  }
+  node_set_t articulation_points;
+  for (std::size_t index :
+       precomputed.at("articulation_points").get<std::vector<std::size_t>>()) {
+    if (index >= n) {
+      throw JsonError("Architecture JSON has an invalid articulation point");
+    }
+    articulation_points.insert(nodes[index]);
+  }
+  std::optional<unsigned> diameter;
+  if (precomputed.contains("diameter")) {
+    diameter = precomputed.at("diameter").get<unsigned>();
+  }
+  ar.freeze_with(
+      std::make_shared<const graphs::DistanceMatrix>(n, std::move(distances)),
+      diameter, articulation_points);
 }
 
 void to_json(nlohmann::json& j, const FullyConnected& ar) {
@@ -14,12 +14,14 @@
 
 #include "tket/Architecture/BestTsaWithArch.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
 #include <tkassert/Assert.hpp>
-#include <tkrng/RNG.hpp>
 #include <tktokenswap/BestFullTsa.hpp>
-
-#include "tket/Architecture/DistancesFromArchitecture.hpp"
-#include "tket/Architecture/NeighboursFromArchitecture.hpp"
+#include <tktokenswap/DistanceFunctions.hpp>
 
 namespace tket {
 
@@ -36,23 +38,30 @@ void BestTsaWithArch::append_solution(
       swaps, vertex_mapping, distances, neighbours, path_finder);
 }
 
-std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
-    const Architecture& architecture, const NodeMapping& node_mapping) {
-  std::vector<std::pair<Node, Node>> swaps;
-  // Before all the conversion and object construction,
-  // doesn't take long to check if it's actually trivial
-  bool trivial = true;
+void BestTsaWithArch::append_solution(
+    SwapList& swaps, VertexMapping& vertex_mapping,
+    DistancesInterface& distances, NeighboursInterface& neighbours,
+    RiverFlowPathFinder& path_finder) {
+  path_finder.reset();
+  BestFullTsa().append_partial_solution(
+      swaps, vertex_mapping, distances, neighbours, path_finder);
+}
+
+// Doesn't take long to check if it's actually trivial,
+// before all the conversion and object construction.
+static bool is_trivial(const BestTsaWithArch::NodeMapping& node_mapping) {
   for (const auto& entry : node_mapping) {
     if (entry.first != entry.second) {
-      trivial = false;
-      break;
+      return false;
     }
   }
-  if (trivial) {
-    return swaps;
-  }
-  // Now convert the Nodes into raw vertices for use in TSA objects.
-  const ArchitectureMapping arch_mapping(architecture);
+  return true;
+}
+
+// Convert the Nodes into raw vertices for use in TSA objects.
+static VertexMapping get_vertex_mapping(
+    const ArchitectureMapping& arch_mapping,
+    const BestTsaWithArch::NodeMapping& node_mapping) {
   VertexMapping vertex_mapping;
   for (const auto& node_entry : node_mapping) {
     vertex_mapping[arch_mapping.get_vertex(node_entry.first)] =
@@ -60,11 +69,13 @@ std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
   }
   TKET_ASSERT(vertex_mapping.size() == node_mapping.size());
   check_mapping(vertex_mapping);
+  return vertex_mapping;
+}
 
-  SwapList raw_swap_list;
-  BestTsaWithArch::append_solution(raw_swap_list, vertex_mapping, arch_mapping);
-
-  // Finally, convert the raw swaps back to nodes.
+// Convert the raw swaps back to nodes.
+static std::vector<std::pair<Node, Node>> get_node_swaps(
+    const ArchitectureMapping& arch_mapping, const SwapList& raw_swap_list) {
+  std::vector<std::pair<Node, Node>> swaps;
   swaps.reserve(raw_swap_list.size());
   for (auto id_opt = raw_swap_list.front_id(); id_opt;
        id_opt = raw_swap_list.next(id_opt.value())) {
@@ -76,4 +87,110 @@ std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
   return swaps;
 }
 
+std::vector<std::pair<Node, Node>> BestTsaWithArch::get_swaps(
+    const Architecture& architecture, const NodeMapping& node_mapping) {
+  if (is_trivial(node_mapping)) {
+    return {};
+  }
+  const ArchitectureMapping arch_mapping(architecture);
+  VertexMapping vertex_mapping = get_vertex_mapping(arch_mapping, node_mapping);
+  SwapList raw_swap_list;
+  BestTsaWithArch::append_solution(raw_swap_list, vertex_mapping, arch_mapping);
+  return get_node_swaps(arch_mapping, raw_swap_list);
+}
+
+std::vector<BestTsaWithArch::BatchResult> BestTsaWithArch::solve_batch(
+    const ArchitectureMapping& arch_mapping,
+    const std::vector<VertexMapping>& problems, unsigned n_threads) {
+  std::vector<BatchResult> results(problems.size());
+  if (n_threads == 0) {
+    n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  if (!arch_mapping.get_architecture().is_frozen()) {
+    n_threads = 1;
+  }
+  n_threads = std::max<unsigned>(
+      1, std::min<std::size_t>(n_threads, problems.size()));
+
+  std::atomic<std::size_t> next_index = 0;
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+  const auto work = [&]() {
+    try {
+      DistancesFromArchitecture distances(arch_mapping);
+      NeighboursFromArchitecture neighbours(arch_mapping);
+      RNG rng;
+      RiverFlowPathFinder path_finder(distances, neighbours, rng);
+      BestFullTsa full_tsa;
+      SwapList swaps;
+      for (std::size_t index = next_index++; index < problems.size();
+           index = next_index++) {
+        const auto start = std::chrono::steady_clock::now();
+        auto& result = results[index];
+        VertexMapping vertex_mapping = problems[index];
+        check_mapping(vertex_mapping);
+        result.total_home_distance =
+            get_total_home_distances(vertex_mapping, distances);
+        result.swaps_lower_bound = (result.total_home_distance + 1) / 2;
+        swaps.clear();
+        path_finder.reset();
+        full_tsa.append_partial_solution(
+            swaps, vertex_mapping, distances, neighbours, path_finder);
+        result.swaps = swaps.to_vector();
+        result.time_ms = std::chrono::duration<double, std::milli>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(exception_mutex);
+      if (!exception) {
+        exception = std::current_exception();
+      }
+      // Stop the other threads taking any more problems.
+      next_index = problems.size();
+    }
+  };
+  std::vector<std::thread> workers;
+  for (unsigned i = 1; i < n_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+  return results;
+}
+
+ReusableBestTsaWithArch::ReusableBestTsaWithArch(
+    const Architecture& architecture)
+    : m_arch_mapping(architecture),
+      m_distances(m_arch_mapping),
+      m_neighbours(m_arch_mapping),
+      m_path_finder(m_distances, m_neighbours, m_rng) {}
+
+const ArchitectureMapping& ReusableBestTsaWithArch::get_arch_mapping() const {
+  return m_arch_mapping;
+}
+
+void ReusableBestTsaWithArch::append_solution(
+    SwapList& swaps, VertexMapping& vertex_mapping) {
+  BestTsaWithArch::append_solution(
+      swaps, vertex_mapping, m_distances, m_neighbours, m_path_finder);
+}
+
+std::vector<std::pair<Node, Node>> ReusableBestTsaWithArch::get_swaps(
+    const BestTsaWithArch::NodeMapping& node_mapping) {
+  if (is_trivial(node_mapping)) {
+    return {};
+  }
+  VertexMapping vertex_mapping =
+      get_vertex_mapping(m_arch_mapping, node_mapping);
+  SwapList raw_swap_list;
+  append_solution(raw_swap_list, vertex_mapping);
+  return get_node_swaps(m_arch_mapping, raw_swap_list);
+}
+
 }  // namespace tket
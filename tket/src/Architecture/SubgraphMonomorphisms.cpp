@@ -18,6 +18,8 @@
 #include <tkassert/Assert.hpp>
 #include <tkwsm/EndToEndWrappers/MainSolver.hpp>
 
+#include "tket/Utils/Trace.hpp"
+
 namespace tket {
 
 using namespace WeightedSubgraphMonomorphism;
@@ -134,8 +136,13 @@ SubgraphMonomorphisms::SubgraphMonomorphisms(
       parameters.max_number_of_mappings;
   solver_parameters.timeout_ms = parameters.timeout_ms;
 
-  const MainSolver main_solver(
-      pattern_edges_and_weights, target_edges_and_weights, solver_parameters);
+  // The search runs in the constructor.
+  const MainSolver main_solver = [&]() {
+    TKET_TRACE_SCOPE("MainSolver::solve");
+    return MainSolver(
+        pattern_edges_and_weights, target_edges_and_weights,
+        solver_parameters);
+  }();
 
   const auto& solution_data = main_solver.get_solution_data();
 
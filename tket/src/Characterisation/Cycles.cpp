@@ -33,27 +33,38 @@ std::vector<std::pair<Vertex, Vertex>> Cycle::get_frame() const {
   return frame_vertices;
 }
 
-UnitID CycleFinder::unitid_from_unit_frontier(
-    const std::shared_ptr<unit_frontier_t>& u_frontier, const Edge& e) const {
-  for (const std::pair<UnitID, Edge>& pair : u_frontier->get<TagKey>()) {
-    if (pair.second == e) {
-      return pair.first;
-    }
+UnitID CycleFinder::unitid_from_unit_frontier(const Edge& e) const {
+  std::map<Edge, UnitID>::const_iterator it = frontier_uids.find(e);
+  if (it == frontier_uids.end()) {
+    throw CycleError(std::string("Edge not in unit_frontier_t object."));
   }
-  throw CycleError(std::string("Edge not in unit_frontier_t object."));
+  return it->second;
 }
 
 void CycleFinder::update_cycle_out_edges(const UnitID& uid, const Edge& e) {
-  for (std::pair<const Edge, UnitID>& pair : cycle_out_edges) {
-    if (pair.second == uid) {
-      cycle_out_edges.erase(pair.first);
-      cycle_out_edges[e] = uid;
-      return;
-    }
+  std::map<UnitID, Edge>::iterator it = uid_out_edges.find(uid);
+  if (it == uid_out_edges.end()) {
+    throw CycleError(std::string(
+        "UnitID " + uid.repr() + " not in std::map<Edge, UnitID> object."));
   }
-  throw CycleError(std::string(
-      "UnitID " + uid.repr() + " not in std::map<Edge, UnitID> object."));
-  return;
+  cycle_out_edges.erase(it->second);
+  cycle_out_edges[e] = uid;
+  it->second = e;
+}
+
+void CycleFinder::reset_cycle_out_edges(
+    const std::shared_ptr<unit_frontier_t>& u_frontier) {
+  cycle_out_edges.clear();
+  uid_out_edges.clear();
+  for (const std::pair<UnitID, Edge>& pair : u_frontier->get<TagKey>()) {
+    cycle_out_edges.insert({pair.second, pair.first});
+    uid_out_edges.insert({pair.first, pair.second});
+  }
+}
+
+void CycleFinder::add_to_history(unsigned key, const UnitID& uid) {
+  this->cycle_history.history[key].push_back(uid);
+  this->cycle_history.uid_to_history_keys[uid].insert(key);
 }
 
 void Cycle::update_boundary(
@@ -81,7 +92,7 @@ void CycleFinder::erase_keys(
 
 // Adds a new cycle to this->cycle_history.key_to_cycle
 std::pair<unsigned, std::set<unsigned>> CycleFinder::make_cycle(
-    const Vertex& v, const EdgeVec& out_edges, const CutFrontier& cut) {
+    const Vertex& v, const EdgeVec& out_edges) {
   // Make a new boundary, add it to "all_boundaries", update "boundary_key" map
   std::vector<edge_pair_t> new_cycle_boundary;
   std::set<UnitID> new_boundary_uids;
@@ -94,7 +105,7 @@ std::pair<unsigned, std::set<unsigned>> CycleFinder::make_cycle(
   // cycle out edges if the edge can't be found
 
   for (const Edge& e : out_edges) {
-    UnitID uid = unitid_from_unit_frontier(cut.u_frontier, e);
+    UnitID uid = unitid_from_unit_frontier(e);
     new_boundary_uids.insert(uid);
     old_boundary_keys.insert(this->cycle_history.uid_to_key[uid]);
     // boundary key associated with given edge e not included
@@ -128,8 +139,10 @@ std::pair<unsigned, std::set<unsigned>> CycleFinder::make_cycle(
       new_cycle_boundary, {{circ.get_OpType_from_Vertex(v), op_indices, v}});
   this->cycle_history.key_to_cycle[this->cycle_history.key] = {new_cycle};
 
-  this->cycle_history.history.push_back(
-      std::vector<UnitID>(new_boundary_uids.begin(), new_boundary_uids.end()));
+  this->cycle_history.history.push_back({});
+  for (const UnitID& uid : new_boundary_uids) {
+    add_to_history(this->cycle_history.key, uid);
+  }
   for (const unsigned& key : not_mergeable_keys) {
     erase_keys(key, old_boundary_keys);
   }
@@ -142,7 +155,7 @@ std::pair<unsigned, std::set<unsigned>> CycleFinder::make_cycle(
   // If a cycle contains both "uid" and any "uid" from "cycle"
   // Set the key as not to be merged
   for (const unsigned& candidate_cycle_key : old_boundary_keys) {
-    std::vector<UnitID> candidate_cycle_uid =
+    const std::vector<UnitID>& candidate_cycle_uid =
         this->cycle_history.history[candidate_cycle_key];
     std::set<UnitID> not_present_uids;
     for (const UnitID& candidate_uids : new_boundary_uids) {
@@ -161,23 +174,25 @@ std::pair<unsigned, std::set<unsigned>> CycleFinder::make_cycle(
     // If any of these cycles have both a non-present uid and any uid in the
     // target cycle then this key is not mergeable and would lead to a "cycle in
     // the DAG" (different type of cycle)
+    // Only the cycles containing the non-present uid are visited, found from
+    // the index of history by UnitID
     for (const UnitID& not_present_uid : not_present_uids) {
-      for (unsigned i = candidate_cycle_key;
-           i < this->cycle_history.uid_to_key[not_present_uid]; i++) {
-        std::vector<UnitID> history_uids = this->cycle_history.history[i];
-        if (std::find(
-                history_uids.begin(), history_uids.end(), not_present_uid) !=
-            history_uids.end()) {
-          std::vector<UnitID> intersection;
-          std::vector<UnitID> candidates =
-              cycle_history.history[candidate_cycle_key];
-          std::set_intersection(
-              candidates.begin(), candidates.end(), history_uids.begin(),
-              history_uids.end(), std::back_inserter(intersection));
-          if (!intersection.empty()) {
-            not_mergeable_keys.insert(candidate_cycle_key);
-            break;
-          }
+      const std::set<unsigned>& uid_keys =
+          this->cycle_history.uid_to_history_keys[not_present_uid];
+      const unsigned end_key = this->cycle_history.uid_to_key[not_present_uid];
+      for (std::set<unsigned>::const_iterator it =
+               uid_keys.lower_bound(candidate_cycle_key);
+           it != uid_keys.end() && *it < end_key; ++it) {
+        const std::vector<UnitID>& history_uids =
+            this->cycle_history.history[*it];
+        std::vector<UnitID> intersection;
+        std::set_intersection(
+            candidate_cycle_uid.begin(), candidate_cycle_uid.end(),
+            history_uids.begin(), history_uids.end(),
+            std::back_inserter(intersection));
+        if (!intersection.empty()) {
+          not_mergeable_keys.insert(candidate_cycle_key);
+          break;
         }
       }
     }
@@ -239,27 +254,32 @@ void Cycle::update_coms_indices(
 // 2) add "new_key" to "old_keys", merge all boundaries into corresponding
 // boundary to highest value "old_key"
 void Cycle::merge(Cycle& new_cycle) {
+  // index of each out edge of *this in boundary_edges_
+  std::map<Edge, unsigned> out_edge_index;
+  for (unsigned j = 0; j < boundary_edges_.size(); j++) {
+    out_edge_index.insert({boundary_edges_[j].second, j});
+  }
   // iterate through edges in boundary of new_cycle
   std::map<unsigned, unsigned> new_indices;
   for (unsigned i = 0; i < new_cycle.boundary_edges_.size(); i++) {
-    bool match = false;
-    for (unsigned j = 0; j < boundary_edges_.size(); j++) {
-      // if in edge of boundary of new_cycle matches out of edge *this, update
-      // *this out edge
-      if (boundary_edges_[j].second == new_cycle.boundary_edges_[i].first) {
-        boundary_edges_[j].second = new_cycle.boundary_edges_[i].second;
-        // As CycleCom are labelled by basic indexing system, where indexing is
-        // related to position edge has in boundary Update CycleCom in new_cycle
-        // s.t. edges with index i now have index j update commands in new_cycle
-        // to match edgesindexing of *this for now, store new indexing
-        new_indices[i] = j;
-        match = true;
-        break;
-      }
-    }
-    if (!match) {
-      boundary_edges_.push_back(new_cycle.boundary_edges_[i]);
+    const edge_pair_t& new_pair = new_cycle.boundary_edges_[i];
+    std::map<Edge, unsigned>::iterator it = out_edge_index.find(new_pair.first);
+    // if in edge of boundary of new_cycle matches out of edge *this, update
+    // *this out edge
+    if (it != out_edge_index.end()) {
+      unsigned j = it->second;
+      boundary_edges_[j].second = new_pair.second;
+      out_edge_index.erase(it);
+      out_edge_index.insert({new_pair.second, j});
+      // As CycleCom are labelled by basic indexing system, where indexing is
+      // related to position edge has in boundary Update CycleCom in new_cycle
+      // s.t. edges with index i now have index j update commands in new_cycle
+      // to match edgesindexing of *this for now, store new indexing
+      new_indices[i] = j;
+    } else {
+      boundary_edges_.push_back(new_pair);
       new_indices[i] = boundary_edges_.size() - 1;
+      out_edge_index.insert({new_pair.second, new_indices[i]});
     }
   }
   // update CycleCom indices in new_cycle
@@ -283,14 +303,16 @@ void CycleFinder::merge_cycles(unsigned new_key, std::set<unsigned>& old_keys) {
     // update this->cycle_history.history for "base_key"
     for (const UnitID& u0 : this->cycle_history.history[merge_key]) {
       this->cycle_history.uid_to_key[u0] = base_key;
-      for (const UnitID& u1 : this->cycle_history.history[base_key])
-        if (u0 == u1) break;
-      this->cycle_history.history[base_key].push_back(u0);
+      add_to_history(base_key, u0);
     }
   }
 }
 
 void CycleFinder::extend_cycles(const CutFrontier& cut) {
+  frontier_uids.clear();
+  for (const std::pair<UnitID, Edge>& pair : cut.u_frontier->get<TagKey>()) {
+    frontier_uids.insert({pair.second, pair.first});
+  }
   // For each vertex in slice
   // Make a new "cycle"
   // If any in edge to new cycle matches an out edge to a previous cycle,
@@ -302,7 +324,7 @@ void CycleFinder::extend_cycles(const CutFrontier& cut) {
     // an out edge from "active" boundary, implies vertex needs to start a new
     // boundary
     std::pair<unsigned, std::set<unsigned>> all_keys =
-        make_cycle(v, out_edges, cut);
+        make_cycle(v, out_edges);
     if (all_keys.second.size() > 0) {
       merge_cycles(all_keys.first, all_keys.second);
     }
@@ -331,22 +353,20 @@ std::vector<Cycle> CycleFinder::get_cycles() {
           in_edge = circ.get_last_edge(in_vert, pair.second);
         }
         cycle_out_edges.insert({in_edge, pair.first});
+        uid_out_edges.insert({pair.first, in_edge});
         this->cycle_history.uid_to_key.insert(
             {pair.first, this->cycle_history.key});
         Cycle new_cycle({{in_edge, in_edge}}, {{}});
         this->cycle_history.key_to_cycle[this->cycle_history.key] = new_cycle;
-        this->cycle_history.history.push_back({pair.first});
+        this->cycle_history.history.push_back({});
+        add_to_history(this->cycle_history.key, pair.first);
         this->cycle_history.key++;
       }
     }
     // extend cycles automatically merges cycles that can be merge due to
     // overlapping multi-qubit gates
     this->extend_cycles(slice_iter.cut_);
-    cycle_out_edges = {};
-    for (const std::pair<UnitID, Edge>& pair :
-         slice_iter.cut_.u_frontier->get<TagKey>()) {
-      cycle_out_edges.insert({pair.second, pair.first});
-    }
+    reset_cycle_out_edges(slice_iter.cut_.u_frontier);
   }
   while (!slice_iter.finished()) {
     slice_iter.cut_ = circ.next_cut(
@@ -359,7 +379,8 @@ std::vector<Cycle> CycleFinder::get_cycles() {
   // Skim Cycle type from CycleHistory.key_to_cycle
   // Discard any Cycles with only Input Gates
   std::vector<Cycle> output_cycles;
-  for (std::pair<unsigned, Cycle> entry : this->cycle_history.key_to_cycle) {
+  for (const std::pair<const unsigned, Cycle>& entry :
+       this->cycle_history.key_to_cycle) {
     if (entry.second.coms_.size() == 0) {
       throw CycleError(std::string("Cycle with no internal gates."));
     }
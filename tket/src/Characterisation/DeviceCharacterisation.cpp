@@ -14,7 +14,9 @@
 
 #include "tket/Characterisation/DeviceCharacterisation.hpp"
 
+#include <algorithm>
 #include <optional>
+#include <set>
 
 namespace tket {
 
@@ -27,6 +29,110 @@ static std::optional<typename T::mapped_type> maybe_get(
                                  : std::nullopt;
 }
 
+// fills one row of errors: the default, then the OpType-specific errors
+template <typename K>
+static void fill_error_row(
+    gate_error_t* row, const K& key,
+    const std::map<K, gate_error_t>& default_errors,
+    const std::map<K, op_errors_t>& op_errors,
+    const std::vector<unsigned>& op_columns, unsigned n_columns) {
+  std::fill(
+      row, row + n_columns, maybe_get(default_errors, key).value_or(0.));
+  const auto it = op_errors.find(key);
+  if (it == op_errors.end()) return;
+  for (const auto& [op, error] : it->second) {
+    row[op_columns[static_cast<std::size_t>(op)]] = error;
+  }
+}
+
+CompiledCharacterisation::CompiledCharacterisation(
+    const DeviceCharacterisation& dc) {
+  std::set<Node> nodes;
+  std::set<OpType> op_types;
+  for (const auto& [node, error] : dc.default_node_errors_) nodes.insert(node);
+  for (const auto& [node, error] : dc.default_readout_errors_) {
+    nodes.insert(node);
+  }
+  for (const auto& [link, error] : dc.default_link_errors_) {
+    nodes.insert(link.first);
+    nodes.insert(link.second);
+  }
+  for (const auto& [node, errors] : dc.op_node_errors_) {
+    nodes.insert(node);
+    for (const auto& [op, error] : errors) op_types.insert(op);
+  }
+  for (const auto& [link, errors] : dc.op_link_errors_) {
+    nodes.insert(link.first);
+    nodes.insert(link.second);
+    for (const auto& [op, error] : errors) op_types.insert(op);
+  }
+  for (const Node& node : nodes) {
+    node_ids_.emplace_hint(node_ids_.end(), node, nodes_.size());
+    nodes_.push_back(node);
+  }
+
+  n_columns_ = 1;
+  if (!op_types.empty()) {
+    op_columns_.assign(static_cast<std::size_t>(*op_types.rbegin()) + 1, 0);
+    for (OpType op : op_types) {
+      op_columns_[static_cast<std::size_t>(op)] = n_columns_++;
+    }
+  }
+
+  const unsigned n = nodes_.size();
+  node_errors_.resize(n * n_columns_);
+  readout_errors_.resize(n);
+  for (unsigned i = 0; i < n; i++) {
+    fill_error_row(
+        node_errors_.data() + i * n_columns_, nodes_[i],
+        dc.default_node_errors_, dc.op_node_errors_, op_columns_, n_columns_);
+    readout_errors_[i] =
+        maybe_get(dc.default_readout_errors_, nodes_[i]).value_or(0.);
+  }
+
+  // links in order of (source id, target id), as node ids follow Node order
+  std::set<Architecture::Connection> links;
+  for (const auto& [link, error] : dc.default_link_errors_) links.insert(link);
+  for (const auto& [link, errors] : dc.op_link_errors_) links.insert(link);
+  link_offsets_.assign(n + 1, 0);
+  link_errors_.resize(links.size() * n_columns_);
+  for (const Architecture::Connection& link : links) {
+    const unsigned source = node_ids_.at(link.first);
+    fill_error_row(
+        link_errors_.data() + link_targets_.size() * n_columns_, link,
+        dc.default_link_errors_, dc.op_link_errors_, op_columns_, n_columns_);
+    link_targets_.push_back(node_ids_.at(link.second));
+    link_offsets_[source + 1]++;
+  }
+  for (unsigned i = 0; i < n; i++) link_offsets_[i + 1] += link_offsets_[i];
+}
+
+std::optional<unsigned> CompiledCharacterisation::node_id(
+    const Node& n) const {
+  return maybe_get(node_ids_, n);
+}
+
+std::optional<unsigned> CompiledCharacterisation::link_id(
+    unsigned node0, unsigned node1) const {
+  const auto begin = link_targets_.begin() + link_offsets_[node0];
+  const auto end = link_targets_.begin() + link_offsets_[node0 + 1];
+  const auto it = std::lower_bound(begin, end, node1);
+  if (it == end || *it != node1) return std::nullopt;
+  return it - link_targets_.begin();
+}
+
+gate_error_t CompiledCharacterisation::get_error(
+    unsigned node0, unsigned node1) const {
+  std::optional<unsigned> link = link_id(node0, node1);
+  return link ? link_errors_[*link * n_columns_] : 0.;
+}
+
+gate_error_t CompiledCharacterisation::get_error(
+    unsigned node0, unsigned node1, OpType op) const {
+  std::optional<unsigned> link = link_id(node0, node1);
+  return link ? link_errors_[*link * n_columns_ + column(op)] : 0.;
+}
+
 DeviceCharacterisation::DeviceCharacterisation(
     avg_node_errors_t _node_errors, avg_link_errors_t _link_errors,
     avg_readout_errors_t _readout_errors)
@@ -34,7 +140,9 @@ DeviceCharacterisation::DeviceCharacterisation(
       default_link_errors_(_link_errors),
       default_readout_errors_(_readout_errors),
       op_node_errors_(),
-      op_link_errors_() {}
+      op_link_errors_() {
+  compile();
+}
 
 DeviceCharacterisation::DeviceCharacterisation(
     op_node_errors_t _node_errors, op_link_errors_t _link_errors,
@@ -43,46 +151,44 @@ DeviceCharacterisation::DeviceCharacterisation(
       default_link_errors_(),
       default_readout_errors_(_readout_errors),
       op_node_errors_(_node_errors),
-      op_link_errors_(_link_errors) {}
+      op_link_errors_(_link_errors) {
+  compile();
+}
+
+void DeviceCharacterisation::compile() {
+  compiled_ = std::make_shared<const CompiledCharacterisation>(*this);
+}
 
 // single-qubit case
 gate_error_t DeviceCharacterisation::get_error(const Node& n) const {
-  std::optional<gate_error_t> maybe_err = maybe_get(default_node_errors_, n);
-  return maybe_err ? *maybe_err : 0.;
+  std::optional<unsigned> id = compiled_->node_id(n);
+  return id ? compiled_->get_error(*id) : 0.;
 }
 gate_error_t DeviceCharacterisation::get_error(
     const Node& n, const OpType& op) const {
-  std::optional<op_errors_t> maybe_dict = maybe_get(op_node_errors_, n);
-  if (maybe_dict) {
-    std::optional<gate_error_t> maybe_err = maybe_get(*maybe_dict, op);
-    if (maybe_err) {
-      return *maybe_err;
-    }
-  }
-  return get_error(n);
+  std::optional<unsigned> id = compiled_->node_id(n);
+  return id ? compiled_->get_error(*id, op) : 0.;
 }
 
 // two-qubit case
 gate_error_t DeviceCharacterisation::get_error(
     const Architecture::Connection& link) const {
-  std::optional<gate_error_t> maybe_err = maybe_get(default_link_errors_, link);
-  return maybe_err ? *maybe_err : 0.;
+  std::optional<unsigned> id0 = compiled_->node_id(link.first);
+  if (!id0) return 0.;
+  std::optional<unsigned> id1 = compiled_->node_id(link.second);
+  return id1 ? compiled_->get_error(*id0, *id1) : 0.;
 }
 gate_error_t DeviceCharacterisation::get_error(
     const Architecture::Connection& link, const OpType& op) const {
-  std::optional<op_errors_t> maybe_dict = maybe_get(op_link_errors_, link);
-  if (maybe_dict) {
-    std::optional<gate_error_t> maybe_err = maybe_get(*maybe_dict, op);
-    if (maybe_err) {
-      return *maybe_err;
-    }
-  }
-  return get_error(link);
+  std::optional<unsigned> id0 = compiled_->node_id(link.first);
+  if (!id0) return 0.;
+  std::optional<unsigned> id1 = compiled_->node_id(link.second);
+  return id1 ? compiled_->get_error(*id0, *id1, op) : 0.;
 }
 
 readout_error_t DeviceCharacterisation::get_readout_error(const Node& n) const {
-  std::optional<gate_error_t> maybe_err = maybe_get(default_readout_errors_, n);
-  return maybe_err ? *maybe_err : 0.;
+  std::optional<unsigned> id = compiled_->node_id(n);
+  return id ? compiled_->get_readout_error(*id) : 0.;
 }
 
 bool DeviceCharacterisation::operator==(
@@ -108,6 +214,7 @@ void from_json(const nlohmann::json& j, DeviceCharacterisation& dc) {
   dc.default_readout_errors_ = j.at("readouts").get<avg_readout_errors_t>();
   dc.op_node_errors_ = j.at("op_node_errors").get<op_node_errors_t>();
   dc.op_link_errors_ = j.at("op_link_errors").get<op_link_errors_t>();
+  dc.compile();
 }
 
 }  // namespace tket
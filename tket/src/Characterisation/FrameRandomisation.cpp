@@ -14,7 +14,14 @@
 
 #include "tket/Characterisation/FrameRandomisation.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
 #include <random>
+#include <thread>
+#include <tkrng/RNG.hpp>
 
 #include "tket/Ops/BarrierOp.hpp"
 #include "tket/PauliGraph/ConjugatePauliFunctions.hpp"
@@ -196,20 +203,20 @@ std::pair<OpTypeVector, std::vector<Vertex>> FrameRandomisation::get_out_frame(
 std::pair<OpTypeVector, std::vector<Vertex>>
 PauliFrameRandomisation::get_out_frame(
     const OpTypeVector& in_frame, const Cycle& cycle) {
-  QubitPauliMap qpm;
+  DensePauliMap frame(in_frame.size());
   for (unsigned i = 0; i < in_frame.size(); i++) {
     switch (in_frame[i]) {
       case OpType::noop:
-        qpm[Qubit("frame", i)] = Pauli::I;
+        frame[i] = Pauli::I;
         break;
       case OpType::X:
-        qpm[Qubit("frame", i)] = Pauli::X;
+        frame[i] = Pauli::X;
         break;
       case OpType::Y:
-        qpm[Qubit("frame", i)] = Pauli::Y;
+        frame[i] = Pauli::Y;
         break;
       case OpType::Z:
-        qpm[Qubit("frame", i)] = Pauli::Z;
+        frame[i] = Pauli::Z;
         break;
       default: {
         throw FrameRandomisationError(std::string(
@@ -219,7 +226,7 @@ PauliFrameRandomisation::get_out_frame(
     }
   }
 
-  SpPauliStabiliser qpt(qpm);
+  PauliStabiliser qpt(frame);
 
   for (const CycleCom& cycle_op : cycle.coms_) {
     switch (cycle_op.type) {
@@ -236,17 +243,16 @@ PauliFrameRandomisation::get_out_frame(
       case OpType::Z:
       case OpType::Y:
         conjugate_PauliTensor(
-            qpt, cycle_op.type, Qubit("frame", cycle_op.indices[0]), false);
+            qpt, cycle_op.type, cycle_op.indices[0], false);
         break;
       case OpType::Vdg:
       case OpType::Sdg:
         conjugate_PauliTensor(
-            qpt, cycle_op.type, Qubit("frame", cycle_op.indices[0]), true);
+            qpt, cycle_op.type, cycle_op.indices[0], true);
         break;
       case OpType::CX:
         conjugate_PauliTensor(
-            qpt, cycle_op.type, Qubit("frame", cycle_op.indices[0]),
-            Qubit("frame", cycle_op.indices[1]));
+            qpt, cycle_op.type, cycle_op.indices[0], cycle_op.indices[1]);
         break;
       default: {
         throw FrameRandomisationError(std::string(
@@ -257,19 +263,19 @@ PauliFrameRandomisation::get_out_frame(
   }
 
   OpTypeVector out_frame(in_frame.size(), OpType::noop);
-  for (const auto& entry : qpt.string) {
-    switch (entry.second) {
+  for (unsigned i = 0; i < out_frame.size(); i++) {
+    switch (qpt.get(i)) {
       case Pauli::I:
-        out_frame[entry.first.index()[0]] = OpType::noop;
+        out_frame[i] = OpType::noop;
         break;
       case Pauli::X:
-        out_frame[entry.first.index()[0]] = OpType::X;
+        out_frame[i] = OpType::X;
         break;
       case Pauli::Y:
-        out_frame[entry.first.index()[0]] = OpType::Y;
+        out_frame[i] = OpType::Y;
         break;
       case Pauli::Z:
-        out_frame[entry.first.index()[0]] = OpType::Z;
+        out_frame[i] = OpType::Z;
         break;
     }
   }
@@ -279,21 +285,21 @@ PauliFrameRandomisation::get_out_frame(
 std::pair<OpTypeVector, std::vector<Vertex>>
 UniversalFrameRandomisation::get_out_frame(
     const OpTypeVector& in_frame, const Cycle& cycle) {
-  QubitPauliMap qpm;
+  DensePauliMap frame(in_frame.size());
   std::vector<Vertex> to_dagger;
   for (unsigned i = 0; i < in_frame.size(); i++) {
     switch (in_frame[i]) {
       case OpType::noop:
-        qpm[Qubit("frame", i)] = Pauli::I;
+        frame[i] = Pauli::I;
         break;
       case OpType::X:
-        qpm[Qubit("frame", i)] = Pauli::X;
+        frame[i] = Pauli::X;
         break;
       case OpType::Y:
-        qpm[Qubit("frame", i)] = Pauli::Y;
+        frame[i] = Pauli::Y;
         break;
       case OpType::Z:
-        qpm[Qubit("frame", i)] = Pauli::Z;
+        frame[i] = Pauli::Z;
         break;
       default: {
         throw FrameRandomisationError(std::string(
@@ -303,11 +309,11 @@ UniversalFrameRandomisation::get_out_frame(
     }
   }
 
-  SpPauliStabiliser qpt(qpm);
+  PauliStabiliser qpt(frame);
 
   for (const CycleCom& cycle_op : cycle.coms_) {
     if (cycle_op.type == OpType::Rz) {
-      Pauli frame_type = qpt.get(Qubit("frame", cycle_op.indices[0]));
+      Pauli frame_type = qpt.get(cycle_op.indices[0]);
       if (frame_type == Pauli::X || frame_type == Pauli::Y) {
         to_dagger.push_back(cycle_op.address);
       }
@@ -315,29 +321,28 @@ UniversalFrameRandomisation::get_out_frame(
     }
     if (cycle_op.type == OpType::H) {
       conjugate_PauliTensor(
-          qpt, cycle_op.type, Qubit("frame", cycle_op.indices[0]), false);
+          qpt, cycle_op.type, cycle_op.indices[0], false);
     }
     if (cycle_op.type == OpType::CX) {
       conjugate_PauliTensor(
-          qpt, cycle_op.type, Qubit("frame", cycle_op.indices[0]),
-          Qubit("frame", cycle_op.indices[1]));
+          qpt, cycle_op.type, cycle_op.indices[0], cycle_op.indices[1]);
     }
   }
 
   OpTypeVector out_frame(in_frame.size(), OpType::noop);
-  for (const auto& entry : qpt.string) {
-    switch (entry.second) {
+  for (unsigned i = 0; i < out_frame.size(); i++) {
+    switch (qpt.get(i)) {
       case Pauli::I:
-        out_frame[entry.first.index()[0]] = OpType::noop;
+        out_frame[i] = OpType::noop;
         break;
       case Pauli::X:
-        out_frame[entry.first.index()[0]] = OpType::X;
+        out_frame[i] = OpType::X;
         break;
       case Pauli::Y:
-        out_frame[entry.first.index()[0]] = OpType::Y;
+        out_frame[i] = OpType::Y;
         break;
       case Pauli::Z:
-        out_frame[entry.first.index()[0]] = OpType::Z;
+        out_frame[i] = OpType::Z;
         break;
     }
   }
@@ -400,32 +405,271 @@ std::pair<std::vector<unsigned>, unsigned> get_frame_sizes(
   return {frame_sizes, max_frame_size};
 }
 
-std::vector<Circuit> FrameRandomisation::get_all_circuits(const Circuit& circ) {
-  // Get all cycle boundaries
-  // Get all sizes
-  // Get all possible frames for all possible cycles
-  // Apply every permutation of frames to cycles
-  // Return as vector
-  // get all cycles in circuit, wire noop vertices for relabelling into
-  // boundaries
-  this->circuit_ = circ;
-  std::vector<Cycle> all_cycles = get_cycles(circuit_);
-  if (all_cycles.size() == 0) {
+void FrameTemplate::apply(const FrameSample& sample) {
+  if (sample.slot_types.size() != slots_.size()) {
+    throw FrameRandomisationError(
+        std::string("Number of gates in sampled frame doesn't match "
+                    "number of frame slots"));
+  }
+  for (unsigned i = 0; i < slots_.size(); i++) {
+    const OpType type = sample.slot_types[i];
+    std::map<OpType, Op_ptr>::iterator it = frame_ops_.find(type);
+    if (it == frame_ops_.end()) {
+      it = frame_ops_.insert({type, get_op_ptr(type)}).first;
+    }
+    circuit_.set_vertex_Op_ptr(slots_[i], it->second);
+  }
+  for (const unsigned& i : sample.daggered) {
+    if (!daggered_ops_[i]) daggered_ops_[i] = cycle_ops_[i]->dagger();
+    circuit_.set_vertex_Op_ptr(cycle_vertices_[i], daggered_ops_[i]);
+  }
+}
+
+void FrameTemplate::restore(const FrameSample& sample) {
+  for (const unsigned& i : sample.daggered) {
+    circuit_.set_vertex_Op_ptr(cycle_vertices_[i], cycle_ops_[i]);
+  }
+}
+
+Circuit FrameTemplate::materialise(const FrameSample& sample) {
+  apply(sample);
+  Circuit circ(circuit_);
+  restore(sample);
+  return circ;
+}
+
+void FrameTemplate::for_each_circuit(
+    const std::vector<FrameSample>& samples,
+    const std::function<void(const Circuit&)>& f) {
+  for (const FrameSample& sample : samples) {
+    apply(sample);
+    try {
+      f(circuit_);
+    } catch (...) {
+      restore(sample);
+      throw;
+    }
+    restore(sample);
+  }
+}
+
+FrameTemplate FrameRandomisation::make_template(const Circuit& circ) const {
+  FrameTemplate frame_template;
+  frame_template.circuit_ = circ;
+  frame_template.cycles_ = get_cycles(frame_template.circuit_);
+  if (frame_template.cycles_.size() == 0) {
     throw FrameRandomisationError(
         std::string("Circuit has no gates with OpType in Cycle OpTypes."));
   }
-  add_noop_frames(all_cycles, circuit_);
-  std::pair<std::vector<unsigned>, unsigned> frame_sizes =
-      get_frame_sizes(all_cycles);
+  add_noop_frames(frame_template.cycles_, frame_template.circuit_);
+  frame_template.frame_sizes_ = get_frame_sizes(frame_template.cycles_).first;
+  for (const Cycle& cycle : frame_template.cycles_) {
+    const std::vector<std::pair<Vertex, Vertex>> frame = cycle.get_frame();
+    for (const std::pair<Vertex, Vertex>& verts : frame) {
+      frame_template.slots_.push_back(verts.first);
+    }
+    for (const std::pair<Vertex, Vertex>& verts : frame) {
+      frame_template.slots_.push_back(verts.second);
+    }
+    for (const CycleCom& com : cycle.coms_) {
+      if (is_initial_q_type(com.type)) continue;
+      frame_template.cycle_vertex_index_.insert(
+          {com.address, frame_template.cycle_vertices_.size()});
+      frame_template.cycle_vertices_.push_back(com.address);
+      frame_template.cycle_ops_.push_back(
+          frame_template.circuit_.get_Op_ptr_from_Vertex(com.address));
+    }
+  }
+  frame_template.daggered_ops_.resize(frame_template.cycle_ops_.size());
+  return frame_template;
+}
+
+FrameSample FrameRandomisation::make_sample(
+    const FrameTemplate& frame_template,
+    const std::vector<OpTypeVector>& cycle_frames) {
+  const std::vector<Cycle>& cycles = frame_template.cycles_;
+  if (cycle_frames.size() != cycles.size()) {
+    throw FrameRandomisationError(
+        std::string("Length of combination of Frame Permutations does not "
+                    "equal number of Cycles."));
+  }
+  FrameSample sample;
+  sample.slot_types.reserve(frame_template.n_slots());
+  for (unsigned i = 0; i < cycles.size(); i++) {
+    if (cycle_frames[i].size() != cycles[i].size()) {
+      throw FrameRandomisationError(
+          std::string("Size of frame does not match the number "
+                      "of qubits in Cycles."));
+    }
+    std::pair<OpTypeVector, std::vector<Vertex>> frame_and_vertices =
+        get_out_frame(cycle_frames[i], cycles[i]);
+    sample.slot_types.insert(
+        sample.slot_types.end(), cycle_frames[i].begin(),
+        cycle_frames[i].end());
+    sample.slot_types.insert(
+        sample.slot_types.end(), frame_and_vertices.first.begin(),
+        frame_and_vertices.first.end());
+    for (const Vertex& v : frame_and_vertices.second) {
+      sample.daggered.push_back(frame_template.cycle_vertex_index_.at(v));
+    }
+  }
+  return sample;
+}
 
+std::vector<FrameSample> FrameRandomisation::sample_frames(
+    const FrameTemplate& frame_template, unsigned samples) {
+  // One generator for all samples: seeding is far costlier than sampling
+  const OpTypeVector frame_types(frame_types_.begin(), frame_types_.end());
+  if (frame_types.empty()) {
+    throw FrameRandomisationError(std::string("No Frame OpTypes to sample."));
+  }
+  std::mt19937 gen{std::random_device{}()};
+  std::uniform_int_distribution<std::size_t> dist(0, frame_types.size() - 1);
+  std::vector<FrameSample> output_frames;
+  output_frames.reserve(samples);
+  std::vector<OpTypeVector> cycle_frames(frame_template.cycles_.size());
+  for (unsigned i = 0; i < samples; i++) {
+    for (unsigned j = 0; j < cycle_frames.size(); j++) {
+      cycle_frames[j].resize(frame_template.frame_sizes_[j]);
+      for (OpType& type : cycle_frames[j]) type = frame_types[dist(gen)];
+    }
+    output_frames.push_back(make_sample(frame_template, cycle_frames));
+  }
+  return output_frames;
+}
+
+std::vector<FrameSample> FrameRandomisation::get_all_frames(
+    const FrameTemplate& frame_template) {
+  unsigned max_frame_size = *std::max_element(
+      frame_template.frame_sizes_.begin(), frame_template.frame_sizes_.end());
   // work out all possible permutations of given ops for all frame sizes
   std::vector<std::vector<OpTypeVector>> all_frame_perms =
-      get_all_frame_permutations(frame_sizes.second, frame_types_);
+      get_all_frame_permutations(max_frame_size, frame_types_);
   // combine all these permutations
   std::vector<std::vector<OpTypeVector>> all_permutation_combinations =
-      get_all_permutation_combinations(frame_sizes.first, all_frame_perms);
-  std::vector<Circuit> output_circuit_list =
-      label_frames(all_permutation_combinations, all_cycles);
+      get_all_permutation_combinations(
+          frame_template.frame_sizes_, all_frame_perms);
+  std::vector<FrameSample> output_frames;
+  output_frames.reserve(all_permutation_combinations.size());
+  for (const std::vector<OpTypeVector>& cycle_frames :
+       all_permutation_combinations) {
+    output_frames.push_back(make_sample(frame_template, cycle_frames));
+  }
+  return output_frames;
+}
+
+// The random stream of sample index for the given seed. Giving each sample
+// its own stream, rather than sharing one generator, makes the samples
+// independent of how they are shared between threads.
+static RNG sample_rng(std::size_t seed, unsigned index) {
+  // splitmix64 finaliser, so that nearby seeds and indices give unrelated
+  // streams
+  std::uint64_t z = static_cast<std::uint64_t>(seed) +
+                    0x9e3779b97f4a7c15ULL * (std::uint64_t{index} + 1);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z ^= z >> 31;
+  RNG rng;
+  rng.set_seed(z);
+  return rng;
+}
+
+// Frame OpTypes in a fixed order, so that seeded samples do not depend on
+// the iteration order of the set
+static OpTypeVector sorted_frame_types(const OpTypeSet& frame_types) {
+  if (frame_types.empty()) {
+    throw FrameRandomisationError(std::string("No Frame OpTypes to sample."));
+  }
+  OpTypeVector sorted(frame_types.begin(), frame_types.end());
+  std::sort(sorted.begin(), sorted.end());
+  return sorted;
+}
+
+static void sample_cycle_frames(
+    const OpTypeVector& frame_types, const std::vector<unsigned>& frame_sizes,
+    RNG& rng, std::vector<OpTypeVector>& cycle_frames) {
+  cycle_frames.resize(frame_sizes.size());
+  for (unsigned j = 0; j < frame_sizes.size(); j++) {
+    cycle_frames[j].resize(frame_sizes[j]);
+    for (OpType& type : cycle_frames[j]) type = rng.get_element(frame_types);
+  }
+}
+
+// Calls body(state, i) for each sample i, sharing the samples between
+// n_threads threads (0 for one per hardware thread). Each thread makes its
+// own state with make_state.
+template <class MakeState, class Body>
+static void for_each_sample_in_parallel(
+    unsigned samples, unsigned n_threads, const MakeState& make_state,
+    const Body& body) {
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  n_threads = std::min(n_threads, std::max(samples, 1u));
+  std::atomic<unsigned> next_index{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&]() {
+    try {
+      auto state = make_state();
+      for (unsigned i = next_index++; i < samples; i = next_index++) {
+        body(state, i);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) error = std::current_exception();
+      next_index = samples;
+    }
+  };
+  std::vector<std::thread> workers;
+  for (unsigned t = 1; t < n_threads; t++) workers.emplace_back(work);
+  work();
+  for (std::thread& worker : workers) worker.join();
+  if (error) std::rethrow_exception(error);
+}
+
+std::vector<FrameSample> FrameRandomisation::sample_frames(
+    const FrameTemplate& frame_template, unsigned samples, std::size_t seed,
+    unsigned n_threads) {
+  const OpTypeVector frame_types = sorted_frame_types(frame_types_);
+  std::vector<FrameSample> output_frames(samples);
+  for_each_sample_in_parallel(
+      samples, n_threads, []() { return std::vector<OpTypeVector>(); },
+      [&](std::vector<OpTypeVector>& cycle_frames, unsigned i) {
+        RNG rng = sample_rng(seed, i);
+        sample_cycle_frames(
+            frame_types, frame_template.frame_sizes_, rng, cycle_frames);
+        output_frames[i] = make_sample(frame_template, cycle_frames);
+      });
+  return output_frames;
+}
+
+std::vector<Circuit> FrameRandomisation::sample_randomisation_circuits(
+    const Circuit& circ, unsigned samples, std::size_t seed,
+    unsigned n_threads) {
+  // Each thread builds circuits from its own template; templates made from
+  // the same circuit have their slots and cycle gates in the same order.
+  const OpTypeVector frame_types = sorted_frame_types(frame_types_);
+  std::vector<Circuit> output_circuit_list(samples);
+  for_each_sample_in_parallel(
+      samples, n_threads, [&]() { return make_template(circ); },
+      [&](FrameTemplate& frame_template, unsigned i) {
+        RNG rng = sample_rng(seed, i);
+        std::vector<OpTypeVector> cycle_frames;
+        sample_cycle_frames(
+            frame_types, frame_template.frame_sizes_, rng, cycle_frames);
+        FrameSample sample = make_sample(frame_template, cycle_frames);
+        output_circuit_list[i] = frame_template.materialise(sample);
+      });
+  return output_circuit_list;
+}
+
+std::vector<Circuit> FrameRandomisation::get_all_circuits(const Circuit& circ) {
+  FrameTemplate frame_template = make_template(circ);
+  std::vector<Circuit> output_circuit_list;
+  frame_template.for_each_circuit(
+      get_all_frames(frame_template),
+      [&](const Circuit& c) { output_circuit_list.push_back(c); });
   return output_circuit_list;
 }
 OpTypeVector FrameRandomisation::sample_frame(const unsigned& size) const {
@@ -468,20 +712,12 @@ void FrameRandomisation::assign_vertices(
 
 std::vector<Circuit> FrameRandomisation::sample_randomisation_circuits(
     const Circuit& circ, unsigned samples) {
-  // get all cycles in circuit, wire noop vertices for relabelling into
-  // boundaries
-  this->circuit_ = circ;
-  std::vector<Cycle> all_cycles = get_cycles(circuit_);
-  if (all_cycles.size() == 0) {
-    throw FrameRandomisationError(
-        std::string("Circuit has no gates with OpType in Cycle OpTypes."));
-  }
-  add_noop_frames(all_cycles, circuit_);
-  std::vector<unsigned> frame_sizes = get_frame_sizes(all_cycles).first;
-  std::vector<std::vector<OpTypeVector>> all_samples =
-      get_all_samples(samples, frame_sizes);
-  std::vector<Circuit> output_circuit_list =
-      label_frames(all_samples, all_cycles);
+  FrameTemplate frame_template = make_template(circ);
+  std::vector<Circuit> output_circuit_list;
+  output_circuit_list.reserve(samples);
+  frame_template.for_each_circuit(
+      sample_frames(frame_template, samples),
+      [&](const Circuit& c) { output_circuit_list.push_back(c); });
   return output_circuit_list;
 }
 
@@ -535,4 +771,42 @@ std::vector<Circuit> PowerCycle::sample_cycles(
   return out;
 }
 
+std::vector<Circuit> PowerCycle::sample_cycles(
+    const Circuit& circ, unsigned total_cycles, unsigned samples,
+    std::size_t seed, unsigned n_threads) {
+  if (make_template(circ).get_cycles().size() > 1) {
+    throw FrameRandomisationError(
+        std::string("Circuit has non-Clifford gates."));
+  }
+  const OpTypeVector frame_types = sorted_frame_types(frame_types_);
+  std::vector<Circuit> out(samples);
+  for_each_sample_in_parallel(
+      samples, n_threads, [&]() { return make_template(circ); },
+      [&](FrameTemplate& frame_template, unsigned i) {
+        RNG rng = sample_rng(seed, i);
+        std::vector<OpTypeVector> cycle_frames;
+        sample_cycle_frames(
+            frame_types, frame_template.get_frame_sizes(), rng, cycle_frames);
+        const Cycle& cycle = frame_template.get_cycles()[0];
+        // The first repeat has the sampled in frame; later ones have no in
+        // frame, and each out frame is the action of the cycle on the last
+        FrameSample sample;
+        sample.slot_types = cycle_frames[0];
+        OpTypeVector out_frame = get_out_frame(cycle_frames[0], cycle).first;
+        sample.slot_types.insert(
+            sample.slot_types.end(), out_frame.begin(), out_frame.end());
+        Circuit full_circ = frame_template.materialise(sample);
+        const OpTypeVector noop_frame(out_frame.size(), OpType::noop);
+        for (unsigned r = 1; r < total_cycles; r++) {
+          out_frame = get_out_frame(out_frame, cycle).first;
+          sample.slot_types = noop_frame;
+          sample.slot_types.insert(
+              sample.slot_types.end(), out_frame.begin(), out_frame.end());
+          full_circ.append(frame_template.materialise(sample));
+        }
+        out[i] = std::move(full_circ);
+      });
+  return out;
+}
+
 }  // namespace tket
@@ -14,12 +14,19 @@
 
 #include "tket/Circuit/AssertionSynthesis.hpp"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <boost/functional/hash.hpp>
 #include <cmath>
 #include <complex>
+#include <exception>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <thread>
 #include <tkassert/Assert.hpp>
+#include <unordered_map>
 
 #include "tket/Circuit/CircUtils.hpp"
 #include "tket/Circuit/Circuit.hpp"
@@ -46,8 +53,10 @@ namespace tket {
  */
 static std::tuple<VectorXb, Eigen::MatrixXcd, int> projector_diagonalisation(
     const Eigen::MatrixXcd &P) {
-  // Solve the eigen values
-  Eigen::SelfAdjointEigenSolver<Eigen::MatrixXcd> eigen_solver(P);
+  // Solve the eigen values, reusing the solver's workspace between calls on
+  // the same thread.
+  thread_local Eigen::SelfAdjointEigenSolver<Eigen::MatrixXcd> eigen_solver;
+  eigen_solver.compute(P);
   // Make a permutation matrix to reorder D and U_dag
   Eigen::PermutationMatrix<Eigen::Dynamic> perm(P.rows());
   Eigen::MatrixXcd P1 = eigen_solver.eigenvectors() *
@@ -279,6 +288,101 @@ std::tuple<Circuit, std::vector<bool>> projector_assertion_synthesis(
   return {circ, expected_readouts};
 }
 
+// Synthesis results by hash of the projector. Each bucket holds the
+// projectors with that hash and their results.
+using ProjectorCacheBucket = std::vector<
+    std::pair<Eigen::MatrixXcd, std::shared_ptr<const AssertionCircuit>>>;
+static std::mutex projector_cache_mutex;
+static std::unordered_map<std::size_t, ProjectorCacheBucket> projector_cache;
+// The cache is cleared when it reaches this many distinct hashes.
+static constexpr std::size_t max_cached_projectors = 1024;
+
+static std::size_t projector_hash(const Eigen::MatrixXcd &P) {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, P.rows());
+  for (Eigen::Index j = 0; j < P.cols(); j++) {
+    for (Eigen::Index i = 0; i < P.rows(); i++) {
+      // Normalise -0.0 so that it hashes equal to 0.0.
+      const Complex z = P(i, j);
+      boost::hash_combine(seed, (z.real() == 0.) ? 0. : z.real());
+      boost::hash_combine(seed, (z.imag() == 0.) ? 0. : z.imag());
+    }
+  }
+  return seed;
+}
+
+std::shared_ptr<const AssertionCircuit> cached_projector_assertion(
+    const Eigen::MatrixXcd &P) {
+  const std::size_t hash = projector_hash(P);
+  {
+    std::lock_guard<std::mutex> lock(projector_cache_mutex);
+    auto found = projector_cache.find(hash);
+    if (found != projector_cache.end()) {
+      for (const auto &[Q, result] : found->second) {
+        if (Q.rows() == P.rows() && Q == P) return result;
+      }
+    }
+  }
+  // Synthesise without holding the lock, so that threads do not wait on
+  // each other's synthesis.
+  auto [c, expected_readouts] = projector_assertion_synthesis(P);
+  c.decompose_boxes_recursively();
+  auto result = std::make_shared<const AssertionCircuit>(
+      AssertionCircuit{std::move(c), std::move(expected_readouts)});
+  std::lock_guard<std::mutex> lock(projector_cache_mutex);
+  if (projector_cache.size() >= max_cached_projectors) {
+    projector_cache.clear();
+  }
+  ProjectorCacheBucket &bucket = projector_cache[hash];
+  for (const auto &[Q, other_result] : bucket) {
+    // Another thread got there first.
+    if (Q.rows() == P.rows() && Q == P) return other_result;
+  }
+  bucket.push_back({P, result});
+  return result;
+}
+
+std::vector<std::shared_ptr<const AssertionCircuit>>
+cached_projector_assertions(
+    const std::vector<Eigen::MatrixXcd> &projectors, unsigned n_threads) {
+  const std::size_t n = projectors.size();
+  std::vector<std::shared_ptr<const AssertionCircuit>> results(n);
+  if (n == 0) return results;
+  std::atomic<std::size_t> next_index = 0;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const auto work = [&]() {
+    try {
+      for (std::size_t index = next_index++; index < n;
+           index = next_index++) {
+        results[index] = cached_projector_assertion(projectors[index]);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_index = n;
+    }
+  };
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const std::size_t number_of_threads = std::min<std::size_t>(n_threads, n);
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
 static unsigned get_n_qubits_from_stabilisers(
     const PauliStabiliserVec &paulis) {
   if (paulis.size() == 0) {
@@ -14,9 +14,13 @@
 
 #include "tket/Circuit/Boxes.hpp"
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <string>
 #include <tkassert/Assert.hpp>
+#include <tuple>
 
 #include "tket/Circuit/AssertionSynthesis.hpp"
 #include "tket/Circuit/CircUtils.hpp"
@@ -30,6 +34,7 @@
 #include "tket/Utils/Expression.hpp"
 #include "tket/Utils/HelperFunctions.hpp"
 #include "tket/Utils/Json.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 #include "tket/Utils/PauliTensor.hpp"
 
 namespace tket {
@@ -57,17 +62,90 @@ op_signature_t Box::get_signature() const {
     return signature_;
 }
 
+std::size_t Box::memory_usage() const {
+  std::size_t bytes = sizeof(Box) + memory::container_bytes(signature_);
+  if (circ_) {
+    bytes += memory::SHARED_CONTROL_OVERHEAD + circ_->memory_usage();
+  }
+  return bytes;
+}
+
+std::shared_ptr<Circuit> Box::to_circuit() const {
+  // Generating a box's circuit may generate those of boxes inside it, so
+  // the lock is recursive.
+  static std::recursive_mutex generate_mutex;
+  std::lock_guard<std::recursive_mutex> lock(generate_mutex);
+  if (circ_ == nullptr) generate_circuit();
+  return circ_;
+}
+
 nlohmann::json Box::serialize() const {
   nlohmann::json j;
   j["type"] = get_type();
-  j["box"] = OpJsonFactory::to_json(shared_from_this());
+  BoxJsonTable *table = BoxJsonTable::current();
+  if (table && table->is_writing()) {
+    j["box_ref"] = table->add(shared_from_this());
+  } else {
+    j["box"] = OpJsonFactory::to_json(shared_from_this());
+  }
   return j;
 }
 
 Op_ptr Box::deserialize(const nlohmann::json &j) {
+  if (j.contains("box_ref")) {
+    BoxJsonTable *table = BoxJsonTable::current();
+    if (!table || table->is_writing()) {
+      throw JsonError("Box reference found without a box table");
+    }
+    return table->get(j.at("box_ref").get<std::string>());
+  }
   return OpJsonFactory::from_json(j.at("box"));
 }
 
+static thread_local BoxJsonTable *current_box_table = nullptr;
+
+BoxJsonTable::BoxJsonTable()
+    : table_(nlohmann::json::object()),
+      entries_(nullptr),
+      previous_(current_box_table) {
+  current_box_table = this;
+}
+
+BoxJsonTable::BoxJsonTable(const nlohmann::json &table)
+    : entries_(&table), previous_(current_box_table) {
+  current_box_table = this;
+}
+
+BoxJsonTable::~BoxJsonTable() { current_box_table = previous_; }
+
+BoxJsonTable *BoxJsonTable::current() { return current_box_table; }
+
+std::string BoxJsonTable::add(const Op_ptr &box) {
+  const std::string id = boost::lexical_cast<std::string>(
+      static_cast<const Box &>(*box).get_id());
+  if (!table_.contains(id)) {
+    // Nested boxes are added while this one is serialised
+    nlohmann::json entry = OpJsonFactory::to_json(box);
+    table_[id] = std::move(entry);
+  }
+  return id;
+}
+
+Op_ptr BoxJsonTable::get(const std::string &id) {
+  auto found = ops_.find(id);
+  if (found != ops_.end()) return found->second;
+  if (!entries_->contains(id)) {
+    throw JsonError("Box " + id + " is not in the box table");
+  }
+  if (!pending_.insert(id).second) {
+    throw JsonError("Box " + id + " refers to itself");
+  }
+  Op_ptr op = OpJsonFactory::from_json(entries_->at(id));
+  pending_.erase(id);
+  ops_.insert({id, op});
+  return op;
+}
+
 CircBox::CircBox(const Circuit &circ) : Box(OpType::CircBox) {
   if (!circ.is_simple()) throw SimpleOnly();
   signature_ = op_signature_t(circ.n_qubits(), EdgeType::Quantum);
@@ -97,6 +175,8 @@ Op_ptr CircBox::symbol_substitution(
 }
 
 void CircBox::symbol_substitution_in_place(const symbol_map_t &sub_map) {
+  // The circuit may be shared with copies of this box: detach first.
+  if (circ_.use_count() > 1) circ_ = std::make_shared<Circuit>(*circ_);
   circ_->symbol_substitution(sub_map);
 }
 
@@ -116,6 +196,43 @@ bool CircBox::is_equal(const Op &op_other) const {
   return circ_->circuit_equality(*other.circ_, {}, false);
 }
 
+/**
+ * Distinct boxes with equal contents (e.g. read from JSON, or made by
+ * repeated calls of dagger()) share the synthesis of their circuits. Copies of
+ * one box already share its circuit. Each call site, with its own key type
+ * and builder, has its own cache.
+ */
+constexpr std::size_t max_synthesis_cache_size = 4096;
+
+template <typename Key, typename F>
+static std::shared_ptr<Circuit> cached_circuit(const Key &key, F build) {
+  static std::mutex cache_mutex;
+  static std::map<Key, Circuit> cache;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto found = cache.find(key);
+    if (found != cache.end()) return std::make_shared<Circuit>(found->second);
+  }
+  Circuit circ = build();
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (cache.size() >= max_synthesis_cache_size) cache.clear();
+  cache.emplace(key, circ);
+  return std::make_shared<Circuit>(std::move(circ));
+}
+
+/**
+ * Unitary box synthesis involves several eigendecompositions. Keyed on the
+ * exact entries of the matrix.
+ */
+template <typename Matrix, typename F>
+static std::shared_ptr<Circuit> cached_synthesis(const Matrix &m, F build) {
+  // NaNs would break the ordering of keys.
+  if (!m.allFinite()) return std::make_shared<Circuit>(build());
+  const double *entries = reinterpret_cast<const double *>(m.data());
+  const std::vector<double> key(entries, entries + 2 * m.size());
+  return cached_circuit(key, build);
+}
+
 Unitary1qBox::Unitary1qBox(const Eigen::Matrix2cd &m)
     : Box(OpType::Unitary1qBox), m_(m) {
   if (!is_unitary(m)) {
@@ -147,7 +264,7 @@ void Unitary1qBox::generate_circuit() const {
   Circuit temp_circ(1);
   temp_circ.add_op<unsigned>(
       OpType::TK1, {tk1_params[0], tk1_params[1], tk1_params[2]}, {0});
-  circ_ = std::make_shared<Circuit>(temp_circ);
+  circ_ = std::make_shared<Circuit>(std::move(temp_circ));
   circ_->add_phase(tk1_params[3]);
 }
 
@@ -179,7 +296,7 @@ Op_ptr Unitary2qBox::transpose() const {
 }
 
 void Unitary2qBox::generate_circuit() const {
-  circ_ = std::make_shared<Circuit>(two_qubit_canonical(m_));
+  circ_ = cached_synthesis(m_, [this]() { return two_qubit_canonical(m_); });
 }
 
 bool Unitary2qBox::is_equal(const Op &op_other) const {
@@ -206,7 +323,8 @@ Op_ptr Unitary3qBox::transpose() const {
 }
 
 void Unitary3qBox::generate_circuit() const {
-  circ_ = std::make_shared<Circuit>(three_qubit_tk_synthesis(m_));
+  circ_ = cached_synthesis(
+      m_, [this]() { return three_qubit_tk_synthesis(m_); });
 }
 
 bool Unitary3qBox::is_equal(const Op &op_other) const {
@@ -399,20 +517,33 @@ std::string QControlBox::get_command_str(const unit_vector_t &args) const {
 }
 
 void QControlBox::generate_circuit() const {
-  Circuit c(n_inner_qubits_);
-  std::vector<unsigned> qbs(n_inner_qubits_);
-  std::iota(qbs.begin(), qbs.end(), 0);
-  c.add_op(op_, qbs);
-  // ConjugationBoxes will be handled by with_controls
-  c.decompose_boxes_recursively({OpType::ConjugationBox});
-  Circuit x_circ(n_controls_ + n_inner_qubits_);
-  for (unsigned i = 0; i < n_controls_; i++) {
-    if (!control_state_.at(i)) {
-      x_circ.add_op<unsigned>(OpType::X, {i});
+  auto build = [this]() {
+    Circuit c(n_inner_qubits_);
+    std::vector<unsigned> qbs(n_inner_qubits_);
+    std::iota(qbs.begin(), qbs.end(), 0);
+    c.add_op(op_, qbs);
+    // ConjugationBoxes will be handled by with_controls
+    c.decompose_boxes_recursively({OpType::ConjugationBox});
+    Circuit x_circ(n_controls_ + n_inner_qubits_);
+    for (unsigned i = 0; i < n_controls_; i++) {
+      if (!control_state_.at(i)) {
+        x_circ.add_op<unsigned>(OpType::X, {i});
+      }
     }
+    c = with_controls(c, n_controls_);
+    return x_circ >> c >> x_circ;
+  };
+  // Equal inner ops serialise equally, so the serialisation identifies the
+  // controlled op.
+  std::string op_key;
+  try {
+    op_key = nlohmann::json(op_).dump();
+  } catch (const std::exception &) {
+    circ_ = std::make_shared<Circuit>(build());
+    return;
   }
-  c = with_controls(c, n_controls_);
-  circ_ = std::make_shared<Circuit>(x_circ >> c >> x_circ);
+  circ_ = cached_circuit(
+      std::make_tuple(op_key, n_controls_, control_state_), build);
 }
 
 Op_ptr QControlBox::dagger() const {
@@ -476,10 +607,10 @@ op_signature_t ProjectorAssertionBox::get_signature() const {
 }
 
 void ProjectorAssertionBox::generate_circuit() const {
-  Circuit c;
-  std::tie(c, expected_readouts_) = projector_assertion_synthesis(m_);
-  c.decompose_boxes_recursively();
-  circ_ = std::make_shared<Circuit>(c);
+  std::shared_ptr<const AssertionCircuit> synth =
+      cached_projector_assertion(m_);
+  expected_readouts_ = synth->expected_readouts;
+  circ_ = std::make_shared<Circuit>(synth->circ);
 }
 
 bool ProjectorAssertionBox::is_equal(const Op &op_other) const {
@@ -519,7 +650,7 @@ void StabiliserAssertionBox::generate_circuit() const {
   Circuit c;
   std::tie(c, expected_readouts_) = stabiliser_assertion_synthesis(paulis_);
   c.decompose_boxes_recursively();
-  circ_ = std::make_shared<Circuit>(c);
+  circ_ = std::make_shared<Circuit>(std::move(c));
 }
 
 op_signature_t StabiliserAssertionBox::get_signature() const {
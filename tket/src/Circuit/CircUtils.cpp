@@ -16,11 +16,16 @@
 
 #include <cmath>
 #include <complex>
+#include <functional>
+#include <map>
+#include <optional>
 #include <sstream>
+#include <tuple>
 #include <vector>
 
 #include "tket/Circuit/CircPool.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Conditional.hpp"
 #include "tket/Circuit/ConjugationBox.hpp"
 #include "tket/Diagonalisation/Diagonalisation.hpp"
 #include "tket/Gate/GatePtr.hpp"
@@ -240,10 +245,9 @@ static void replace_TK2_2CX(Circuit &circ) {
     TKET_ASSERT(params.size() == 3);
     // Rounding errors can accumulate here; warn if so:
     if (!equiv_0(params[2], 4, 1e-6)) {
-      std::stringstream ss;
-      ss << "Rounding errors in CX decomposition: ZZPhase parameter = "
-         << params[2] << " when it should be 0 (mod 4). Ignoring.";
-      tket_log()->warn(ss.str());
+      TKET_LOG_WARN(
+          "Rounding errors in CX decomposition: ZZPhase parameter = "
+          << params[2] << " when it should be 0 (mod 4). Ignoring.");
     }
     Circuit sub = CircPool::approx_TK2_using_2xCX(params[0], params[1]);
     bin.push_back(v);
@@ -1314,4 +1318,86 @@ std::tuple<Circuit, std::array<Expr, 3>, Circuit> normalise_TK2_angles(
   return {pre, {a, b, c}, post};
 }
 
+VertexVec rewrite_numeric_params(
+    Circuit& circ,
+    const std::function<void(std::vector<double>&)>& rewrite) {
+  // Gates with numeric parameters, and where their values start in the array
+  struct Slot {
+    Vertex v;
+    Op_ptr op;  // the gate, outside any condition
+    std::size_t offset;
+    // Which parameters are numeric
+    std::vector<bool> numeric;
+  };
+  std::vector<Slot> slots;
+  std::vector<double> values;
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+    if (op->get_type() == OpType::Conditional) {
+      op = static_cast<const Conditional&>(*op).get_op();
+    }
+    if (!op->get_desc().is_gate()) continue;
+    const std::vector<Expr> params = op->get_params();
+    Slot slot{v, op, values.size(), std::vector<bool>(params.size(), false)};
+    bool any_numeric = false;
+    for (unsigned i = 0; i < params.size(); ++i) {
+      std::optional<double> x = eval_expr(params[i]);
+      if (x) {
+        values.push_back(*x);
+        slot.numeric[i] = true;
+        any_numeric = true;
+      }
+    }
+    if (any_numeric) slots.push_back(std::move(slot));
+  }
+  const std::vector<double> old_values = values;
+  rewrite(values);
+  TKET_ASSERT(values.size() == old_values.size());
+
+  // Ops built so far, keyed on type, qubit count and parameter values when
+  // all are numeric
+  std::map<std::tuple<OpType, unsigned, std::vector<double>>, Op_ptr> interned;
+  VertexVec rewritten;
+  for (const Slot& slot : slots) {
+    std::vector<Expr> params = slot.op->get_params();
+    std::vector<double> key_values;
+    bool changed = false;
+    bool all_numeric = true;
+    std::size_t k = slot.offset;
+    for (unsigned i = 0; i < params.size(); ++i) {
+      if (!slot.numeric[i]) {
+        all_numeric = false;
+        continue;
+      }
+      if (values[k] != old_values[k]) {
+        params[i] = values[k];
+        changed = true;
+      }
+      key_values.push_back(values[k]);
+      ++k;
+    }
+    if (!changed) continue;
+    const OpType type = slot.op->get_type();
+    const unsigned n_qubits = slot.op->n_qubits();
+    Op_ptr new_op;
+    if (all_numeric) {
+      auto [it, inserted] =
+          interned.insert({{type, n_qubits, key_values}, nullptr});
+      if (inserted) it->second = get_op_ptr(type, params, n_qubits);
+      new_op = it->second;
+    } else {
+      new_op = get_op_ptr(type, params, n_qubits);
+    }
+    Op_ptr vertex_op = circ.get_Op_ptr_from_Vertex(slot.v);
+    if (vertex_op->get_type() == OpType::Conditional) {
+      const Conditional& cond = static_cast<const Conditional&>(*vertex_op);
+      new_op = std::make_shared<Conditional>(
+          new_op, cond.get_width(), cond.get_value());
+    }
+    circ.set_vertex_Op_ptr(slot.v, new_op);
+    rewritten.push_back(slot.v);
+  }
+  return rewritten;
+}
+
 }  // namespace tket
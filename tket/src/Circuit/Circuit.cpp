@@ -16,12 +16,17 @@
 
 #include <algorithm>
 #include <fstream>
+#include <limits>
+#include <list>
+#include <map>
 #include <numeric>
 #include <optional>
+#include <queue>
 #include <set>
 #include <string>
 #include <tkassert/Assert.hpp>
 #include <tklog/TketLog.hpp>
+#include <unordered_set>
 #include <utility>
 
 #include "tket/Circuit/DAGDefs.hpp"
@@ -33,6 +38,7 @@
 #include "tket/Utils/Expression.hpp"
 #include "tket/Utils/GraphHeaders.hpp"
 #include "tket/Utils/HelperFunctions.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 
 namespace tket {
 
@@ -111,6 +117,215 @@ std::vector<Command> Circuit::get_commands() const {
   return coms;
 }
 
+bool Circuit::visit_commands(
+    const std::function<bool(const CommandView&)>& visitor) const {
+  // All per-vertex state lives in flat arrays indexed by the position of the
+  // vertex in `verts`, sorted so that it can be found by binary search.
+  VertexVec verts = all_vertices();
+  std::sort(verts.begin(), verts.end(), std::less<Vertex>());
+  auto index = [&verts](const Vertex& v) -> std::size_t {
+    return std::lower_bound(
+               verts.begin(), verts.end(), v, std::less<Vertex>()) -
+           verts.begin();
+  };
+  // units[offsets[i] + p] is the unit on port p of vertex i. Ports with
+  // linear edges carry the same unit in and out; inputs have one slot.
+  std::vector<std::size_t> offsets(verts.size() + 1, 0);
+  std::vector<unsigned> n_waiting(verts.size());
+  for (std::size_t i = 0; i < verts.size(); ++i) {
+    n_waiting[i] = n_in_edges(verts[i]);
+    offsets[i + 1] = offsets[i] + std::max(n_waiting[i], 1u);
+  }
+  std::vector<UnitID> units(offsets.back());
+  // `order` doubles as the queue of ready vertices.
+  std::vector<std::size_t> order;
+  order.reserve(verts.size());
+  for (const BoundaryElement& el : boundary.get<TagID>()) {
+    const std::size_t i = index(el.in_);
+    units[offsets[i]] = el.id_;
+    order.push_back(i);
+  }
+  // Ops with no arguments (e.g. Phase) have no in-edges either.
+  for (std::size_t i = 0; i < verts.size(); ++i) {
+    if (n_waiting[i] == 0 && !is_initial_type(dag[verts[i]].op->get_type())) {
+      order.push_back(i);
+    }
+  }
+  for (std::size_t k = 0; k < order.size(); ++k) {
+    const std::size_t i = order[k];
+    const Vertex v = verts[i];
+    const Op_ptr& op = dag[v].op;
+    const OpType type = op->get_type();
+    if (!is_initial_type(type)) {
+      BGL_FORALL_INEDGES(v, e, dag, DAG) {
+        units[offsets[i] + get_target_port(e)] =
+            units[offsets[index(source(e))] + get_source_port(e)];
+      }
+      if (!is_final_type(type)) {
+        const CommandView view{
+            op, {units.data() + offsets[i], n_in_edges(v)}, v};
+        if (!visitor(view)) return false;
+      }
+    }
+    BGL_FORALL_OUTEDGES(v, e, dag, DAG) {
+      const std::size_t t = index(target(e));
+      if (--n_waiting[t] == 0) order.push_back(t);
+    }
+  }
+  return true;
+}
+
+CommandColumns Circuit::get_command_columns() const {
+  CommandColumns cols;
+  std::map<UnitID, std::uint32_t> unit_index;
+  for (const Qubit& q : all_qubits()) cols.units.push_back(q);
+  for (const Bit& b : all_bits()) cols.units.push_back(b);
+  for (const WasmState& w : wasmwire) cols.units.push_back(w);
+  for (std::uint32_t u = 0; u < cols.units.size(); ++u) {
+    unit_index.insert({cols.units[u], u});
+  }
+  std::map<std::string, std::int32_t> opgroup_index;
+  const std::size_t n_coms = n_vertices() - boundary.size() * 2;
+  cols.op_types.reserve(n_coms);
+  cols.opgroup_ids.reserve(n_coms);
+  cols.arg_offsets.reserve(n_coms + 1);
+  cols.param_offsets.reserve(n_coms + 1);
+  cols.arg_offsets.push_back(0);
+  cols.param_offsets.push_back(0);
+  visit_commands([&](const CommandView& com) {
+    const OpType type = com.op->get_type();
+    cols.op_types.push_back(type);
+    for (const UnitID& u : com.args) {
+      cols.args.push_back(unit_index.at(u));
+    }
+    cols.arg_offsets.push_back(cols.args.size());
+    if (is_gate_type(type)) {
+      for (const Expr& e : com.op->get_params()) {
+        std::optional<double> x = eval_expr(e);
+        cols.params.push_back(
+            x ? *x : std::numeric_limits<double>::quiet_NaN());
+      }
+    }
+    cols.param_offsets.push_back(cols.params.size());
+    const std::optional<std::string>& opgroup =
+        get_opgroup_from_Vertex(com.vertex);
+    if (opgroup) {
+      auto [it, inserted] =
+          opgroup_index.insert({*opgroup, cols.opgroups.size()});
+      if (inserted) cols.opgroups.push_back(*opgroup);
+      cols.opgroup_ids.push_back(it->second);
+    } else {
+      cols.opgroup_ids.push_back(-1);
+    }
+    return true;
+  });
+  return cols;
+}
+
+CanonicalCommands Circuit::get_canonical_commands() const {
+  CanonicalCommands canon;
+  std::map<UnitID, std::uint32_t> unit_index;
+  for (const Qubit& q : all_qubits()) canon.units.push_back(q);
+  for (const Bit& b : all_bits()) canon.units.push_back(b);
+  for (const WasmState& w : wasmwire) canon.units.push_back(w);
+  std::vector<std::size_t> unit_hashes;
+  unit_hashes.reserve(canon.units.size());
+  for (std::uint32_t u = 0; u < canon.units.size(); ++u) {
+    unit_index.insert({canon.units[u], u});
+    unit_hashes.push_back(hash_value(canon.units[u]));
+  }
+
+  // Gather the commands and their arguments in the order of visit_commands.
+  VertexVec com_verts;
+  std::vector<std::uint32_t> com_args;
+  std::vector<std::uint32_t> com_offsets{0};
+  visit_commands([&](const CommandView& com) {
+    com_verts.push_back(com.vertex);
+    for (const UnitID& u : com.args) com_args.push_back(unit_index.at(u));
+    com_offsets.push_back(com_args.size());
+    return true;
+  });
+  const std::size_t n_coms = com_verts.size();
+  std::vector<std::size_t> by_vertex(n_coms);
+  std::iota(by_vertex.begin(), by_vertex.end(), 0);
+  std::sort(
+      by_vertex.begin(), by_vertex.end(),
+      [&com_verts](std::size_t i, std::size_t j) {
+        return std::less<Vertex>()(com_verts[i], com_verts[j]);
+      });
+  // Position of the command at `v` in the gathered order, or n_coms if `v`
+  // is a boundary vertex.
+  auto index = [&](const Vertex& v) -> std::size_t {
+    auto it = std::lower_bound(
+        by_vertex.begin(), by_vertex.end(), v,
+        [&com_verts](std::size_t i, const Vertex& w) {
+          return std::less<Vertex>()(com_verts[i], w);
+        });
+    return (it != by_vertex.end() && com_verts[*it] == v) ? *it : n_coms;
+  };
+
+  // Emit the commands in topological order, choosing among those ready the
+  // one with the least arguments, then the least op type.
+  std::vector<unsigned> n_waiting(n_coms, 0);
+  for (std::size_t i = 0; i < n_coms; ++i) {
+    BGL_FORALL_INEDGES(com_verts[i], e, dag, DAG) {
+      if (index(source(e)) < n_coms) ++n_waiting[i];
+    }
+  }
+  auto comes_after = [&](std::size_t i, std::size_t j) {
+    const auto i_begin = com_args.begin() + com_offsets[i];
+    const auto i_end = com_args.begin() + com_offsets[i + 1];
+    const auto j_begin = com_args.begin() + com_offsets[j];
+    const auto j_end = com_args.begin() + com_offsets[j + 1];
+    if (!std::equal(i_begin, i_end, j_begin, j_end)) {
+      return std::lexicographical_compare(j_begin, j_end, i_begin, i_end);
+    }
+    const OpType i_type = get_OpType_from_Vertex(com_verts[i]);
+    const OpType j_type = get_OpType_from_Vertex(com_verts[j]);
+    return (i_type != j_type) ? (j_type < i_type) : (j < i);
+  };
+  std::priority_queue<
+      std::size_t, std::vector<std::size_t>, decltype(comes_after)>
+      ready(comes_after);
+  for (std::size_t i = 0; i < n_coms; ++i) {
+    if (n_waiting[i] == 0) ready.push(i);
+  }
+  canon.ops.reserve(n_coms);
+  canon.opgroups.reserve(n_coms);
+  canon.args.reserve(com_args.size());
+  canon.arg_offsets.reserve(n_coms + 1);
+  canon.arg_offsets.push_back(0);
+  while (!ready.empty()) {
+    const std::size_t i = ready.top();
+    ready.pop();
+    const Vertex v = com_verts[i];
+    const Op_ptr op = get_Op_ptr_from_Vertex(v);
+    const OpType type = op->get_type();
+    boost::hash_combine(canon.hash, type);
+    if (type == OpType::Conditional) {
+      boost::hash_combine(
+          canon.hash,
+          static_cast<const Conditional&>(*op).get_op()->get_type());
+    }
+    canon.ops.push_back(op);
+    for (std::uint32_t k = com_offsets[i]; k < com_offsets[i + 1]; ++k) {
+      canon.args.push_back(com_args[k]);
+      boost::hash_combine(canon.hash, unit_hashes[com_args[k]]);
+    }
+    canon.arg_offsets.push_back(canon.args.size());
+    boost::hash_combine(canon.hash, canon.arg_offsets.back());
+    canon.opgroups.push_back(get_opgroup_from_Vertex(v));
+    if (canon.opgroups.back()) {
+      boost::hash_combine(canon.hash, *canon.opgroups.back());
+    }
+    BGL_FORALL_OUTEDGES(v, e, dag, DAG) {
+      const std::size_t t = index(target(e));
+      if (t < n_coms && --n_waiting[t] == 0) ready.push(t);
+    }
+  }
+  return canon;
+}
+
 VertexVec Circuit::all_vertices() const {
   VertexVec vs;
   BGL_FORALL_VERTICES(v, dag, DAG) { vs.push_back(v); }
@@ -179,6 +394,7 @@ void Circuit::symbol_substitution(const SymEngine::map_basic_basic sub_map) {
     Op_ptr new_op = get_Op_ptr_from_Vertex(v)->symbol_substitution(sub_map);
     if (new_op) {
       dag[v] = {new_op};
+      log_op_change(v);
     }
   }
   phase = phase.subs(sub_map);
@@ -187,7 +403,9 @@ void Circuit::symbol_substitution(const SymEngine::map_basic_basic sub_map) {
 const SymSet Circuit::free_symbols() const {
   SymSet symbols;
   BGL_FORALL_VERTICES(v, dag, DAG) {
-    const SymSet s = get_Op_ptr_from_Vertex(v)->free_symbols();
+    const Op_ptr op = get_Op_ptr_from_Vertex(v);
+    if (!op->is_symbolic()) continue;
+    const SymSet s = op->free_symbols();
     symbols.insert(s.begin(), s.end());
   }
   SymSet phase_s = expr_free_symbols(phase);
@@ -195,21 +413,22 @@ const SymSet Circuit::free_symbols() const {
   return symbols;
 }
 
-bool Circuit::is_symbolic() const { return !free_symbols().empty(); }
-
-// check aspects of circuit for equality, and optionally throw exceptions when
-// not met
-bool Circuit::circuit_equality(
-    const Circuit& other, const std::set<Check>& except,
-    bool throw_error) const {
-  bool check = true;
-  check &= check_iterators_equality(*this, other);
-  if (throw_error && !check) {
-    throw CircuitInequality(std::string("Circuit operations do not match."));
+bool Circuit::is_symbolic() const {
+  BGL_FORALL_VERTICES(v, dag, DAG) {
+    if (get_Op_ptr_from_Vertex(v)->is_symbolic()) return true;
   }
+  return !SymEngine::free_symbols(phase).empty();
+}
 
+// check aspects of circuits other than their commands for equality, and
+// optionally throw exceptions when not met
+static bool attributes_equal(
+    const Circuit& circ, const Circuit& other,
+    const std::set<Circuit::Check>& except, bool throw_error) {
+  using Check = Circuit::Check;
+  bool check = true;
   if (except.count(Check::Phase) == 0) {
-    const Expr thisphase = this->get_phase();
+    const Expr thisphase = circ.get_phase();
     const Expr othephase = other.get_phase();
     check &= equiv_expr(thisphase, othephase);
     if (throw_error && !check) {
@@ -220,21 +439,21 @@ bool Circuit::circuit_equality(
     }
   }
   if (except.count(Check::Units) == 0) {
-    check &= (this->all_qubits() == other.all_qubits());
+    check &= (circ.all_qubits() == other.all_qubits());
     if (throw_error && !check) {
       throw CircuitInequality(std::string("Circuit qubits do not match."));
     }
 
-    check &= (this->all_bits() == other.all_bits());
+    check &= (circ.all_bits() == other.all_bits());
     if (throw_error && !check) {
       throw CircuitInequality(std::string("Circuit bits do not match."));
     }
-    check &= (this->created_qubits() == other.created_qubits());
+    check &= (circ.created_qubits() == other.created_qubits());
     if (throw_error && !check) {
       throw CircuitInequality(
           std::string("Circuit created qubits do not match."));
     }
-    check &= (this->discarded_qubits() == other.discarded_qubits());
+    check &= (circ.discarded_qubits() == other.discarded_qubits());
     if (throw_error && !check) {
       throw CircuitInequality(
           std::string("Circuit discarded qubits do not match."));
@@ -243,7 +462,7 @@ bool Circuit::circuit_equality(
 
   if (except.count(Check::ImplicitPermutation) == 0) {
     check &=
-        (this->implicit_qubit_permutation() ==
+        (circ.implicit_qubit_permutation() ==
          other.implicit_qubit_permutation());
     if (throw_error && !check) {
       throw CircuitInequality(
@@ -251,9 +470,9 @@ bool Circuit::circuit_equality(
     }
   }
   if (except.count(Check::Name) == 0) {
-    check &= (this->get_name() == other.get_name());
+    check &= (circ.get_name() == other.get_name());
     if (throw_error && !check) {
-      const std::optional<std::string> thisname = this->get_name();
+      const std::optional<std::string> thisname = circ.get_name();
       const std::optional<std::string> othename = other.get_name();
       std::string errormsg = "Circuit names do not match: ";
       errormsg += (thisname ? thisname.value() : "None");
@@ -266,6 +485,48 @@ bool Circuit::circuit_equality(
   return check;
 }
 
+// check aspects of circuit for equality, and optionally throw exceptions when
+// not met
+bool Circuit::circuit_equality(
+    const Circuit& other, const std::set<Check>& except,
+    bool throw_error) const {
+  // Circuits with different numbers of commands cannot match, and this is
+  // much cheaper to check than iterating over the commands.
+  const bool check = (n_gates() == other.n_gates()) &&
+                     check_iterators_equality(*this, other);
+  if (!check) {
+    if (throw_error) {
+      throw CircuitInequality(std::string("Circuit operations do not match."));
+    }
+    return false;
+  }
+  return attributes_equal(*this, other, except, throw_error);
+}
+
+bool Circuit::canonical_equality(
+    const Circuit& other, const std::set<Check>& except) const {
+  if (n_gates() != other.n_gates()) return false;
+  if (!attributes_equal(*this, other, except, false)) return false;
+  const CanonicalCommands coms = get_canonical_commands();
+  const CanonicalCommands other_coms = other.get_canonical_commands();
+  if (coms.hash != other_coms.hash ||
+      coms.arg_offsets != other_coms.arg_offsets) {
+    return false;
+  }
+  for (std::size_t k = 0; k < coms.args.size(); ++k) {
+    if (coms.units[coms.args[k]] != other_coms.units[other_coms.args[k]]) {
+      return false;
+    }
+  }
+  for (std::size_t i = 0; i < coms.ops.size(); ++i) {
+    if (coms.opgroups[i] != other_coms.opgroups[i] ||
+        !(*coms.ops[i] == *other_coms.ops[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Performs a traversal from the given vertex forwards through the dag, looking
 // for something on the target qubit We can prune a path if it reaches the depth
 // of the target forward = true returns true if target is in causal future of
@@ -328,105 +589,159 @@ bool Circuit::in_causal_order(
   return false;
 }
 
-// Update depth fields of `data` for a vertex with data for the vertex's
-// predecessors `preds`, which is assumed to be already stored in `datamap`.
-static void update_from_predecessors(
-    ResourceData& data, const VertexVec& preds,
-    const std::map<Vertex, ResourceData>& datamap) {
-  std::vector<ResourceData> pre_data;
-  for (const Vertex& pre_v : preds) {
-    pre_data.push_back(datamap.at(pre_v));
-  }
-  // 1. GateDepth
-  data.GateDepth.min += std::max_element(
-                            pre_data.begin(), pre_data.end(),
-                            [](const ResourceData& a, const ResourceData& b) {
-                              return a.GateDepth.min < b.GateDepth.min;
-                            })
-                            ->GateDepth.min;
-  data.GateDepth.max += std::max_element(
-                            pre_data.begin(), pre_data.end(),
-                            [](const ResourceData& a, const ResourceData& b) {
-                              return a.GateDepth.max < b.GateDepth.max;
-                            })
-                            ->GateDepth.max;
-  // 2. OpTypeDepth
-  std::map<OpType, unsigned> min_depths;
-  std::map<OpType, unsigned> max_depths;
-  for (const ResourceData& pre_v_data : pre_data) {
-    for (const auto& pair : pre_v_data.OpTypeDepth) {
-      if (pair.second.min > min_depths[pair.first]) {
-        min_depths[pair.first] = pair.second.min;
+ResourceData Circuit::get_resources() const {
+  // Give each OpType that may appear in the result a column, so that the
+  // bounds at each vertex are a flat row rather than maps. Columns 0 and 1
+  // are the gate depth and the two-qubit gate depth.
+  std::set<OpType> depth_types;
+  std::set<OpType> count_types;
+  BGL_FORALL_VERTICES(v, dag, DAG) {
+    const OpType optype = get_OpType_from_Vertex(v);
+    if (is_initial_type(optype) || is_final_type(optype)) continue;
+    if (optype == OpType::DummyBox) {
+      const ResourceData& box_data =
+          static_cast<const DummyBox&>(*get_Op_ptr_from_Vertex(v))
+              .get_resource_data();
+      for (const auto& pair : box_data.OpTypeDepth) {
+        depth_types.insert(pair.first);
       }
-      if (pair.second.max > max_depths[pair.first]) {
-        max_depths[pair.first] = pair.second.max;
+      for (const auto& pair : box_data.OpTypeCount) {
+        count_types.insert(pair.first);
       }
+    } else {
+      depth_types.insert(optype);
+      count_types.insert(optype);
     }
   }
-  for (const auto& pair : min_depths) {
-    data.OpTypeDepth[pair.first].min += min_depths[pair.first];
-  }
-  for (const auto& pair : max_depths) {
-    data.OpTypeDepth[pair.first].max += max_depths[pair.first];
-  }
-  // 3. TwoQubitGateDepth
-  data.TwoQubitGateDepth.min +=
-      std::max_element(
-          pre_data.begin(), pre_data.end(),
-          [](const ResourceData& a, const ResourceData& b) {
-            return a.TwoQubitGateDepth.min < b.TwoQubitGateDepth.min;
-          })
-          ->TwoQubitGateDepth.min;
-  data.TwoQubitGateDepth.max +=
-      std::max_element(
-          pre_data.begin(), pre_data.end(),
-          [](const ResourceData& a, const ResourceData& b) {
-            return a.TwoQubitGateDepth.max < b.TwoQubitGateDepth.max;
-          })
-          ->TwoQubitGateDepth.max;
-}
-
-ResourceData Circuit::get_resources() /*const*/ {
-  // Traverse the DAG in topological order. At each vertex compute a new
-  // ResourceData based on the ResourceData already computed for its immediate
-  // predecessors. Compute final ResourceData based on terminal nodes.
-  const VertexVec vertices = vertices_in_order();
-  std::map<Vertex, ResourceData> datamap;
+  std::map<OpType, std::size_t> column;
+  for (OpType optype : depth_types) column.insert({optype, column.size() + 2});
+  const std::size_t width = column.size() + 2;
   std::map<OpType, ResourceBounds<unsigned>> op_type_count;
-  for (const Vertex& v : vertices) {
-    ResourceData data;
-    OpType optype = get_OpType_from_Vertex(v);
-    if (!is_initial_type(optype)) {
-      if (!is_final_type(optype)) {
-        if (optype == OpType::DummyBox) {
-          const DummyBox& dbox =
-              static_cast<const DummyBox&>(*get_Op_ptr_from_Vertex(v));
-          data = dbox.get_resource_data();
-          for (const auto& pair : data.OpTypeCount) {
-            op_type_count[pair.first].min += pair.second.min;
-            op_type_count[pair.first].max += pair.second.max;
-          }
-        } else {
-          data.GateDepth = {1};
-          data.OpTypeDepth[optype] = {1};
-          if (OpDesc(optype).is_gate() &&
-              get_Op_ptr_from_Vertex(v)->n_qubits() == 2) {
-            data.TwoQubitGateDepth = {1};
-          }
-          op_type_count[optype].min += 1;
-          op_type_count[optype].max += 1;
+  for (OpType optype : count_types) op_type_count.insert({optype, {}});
+
+  // Traverse the DAG in topological order. The row of each vertex is the
+  // elementwise maximum of the rows of its predecessors, plus the vertex's
+  // own contribution. Vertices are found by binary search in `verts`.
+  VertexVec verts = all_vertices();
+  std::sort(verts.begin(), verts.end(), std::less<Vertex>());
+  auto index = [&verts](const Vertex& v) -> std::size_t {
+    return std::lower_bound(
+               verts.begin(), verts.end(), v, std::less<Vertex>()) -
+           verts.begin();
+  };
+  std::vector<ResourceBounds<unsigned>> rows(verts.size() * width);
+  auto merge_max = [&](ResourceBounds<unsigned>* row, std::size_t pred) {
+    const ResourceBounds<unsigned>* pred_row = rows.data() + pred * width;
+    for (std::size_t c = 0; c < width; ++c) {
+      row[c].min = std::max(row[c].min, pred_row[c].min);
+      row[c].max = std::max(row[c].max, pred_row[c].max);
+    }
+  };
+  std::vector<unsigned> n_waiting(verts.size());
+  std::vector<std::size_t> order;
+  order.reserve(verts.size());
+  for (std::size_t i = 0; i < verts.size(); ++i) {
+    n_waiting[i] = n_in_edges(verts[i]);
+    if (n_waiting[i] == 0) order.push_back(i);
+  }
+  for (std::size_t k = 0; k < order.size(); ++k) {
+    const std::size_t i = order[k];
+    const Vertex v = verts[i];
+    ResourceBounds<unsigned>* row = rows.data() + i * width;
+    BGL_FORALL_INEDGES(v, e, dag, DAG) { merge_max(row, index(source(e))); }
+    const OpType optype = get_OpType_from_Vertex(v);
+    if (!is_initial_type(optype) && !is_final_type(optype)) {
+      if (optype == OpType::DummyBox) {
+        const ResourceData& box_data =
+            static_cast<const DummyBox&>(*get_Op_ptr_from_Vertex(v))
+                .get_resource_data();
+        row[0].min += box_data.GateDepth.min;
+        row[0].max += box_data.GateDepth.max;
+        row[1].min += box_data.TwoQubitGateDepth.min;
+        row[1].max += box_data.TwoQubitGateDepth.max;
+        for (const auto& pair : box_data.OpTypeDepth) {
+          ResourceBounds<unsigned>& bounds = row[column.at(pair.first)];
+          bounds.min += pair.second.min;
+          bounds.max += pair.second.max;
         }
+        for (const auto& pair : box_data.OpTypeCount) {
+          ResourceBounds<unsigned>& count = op_type_count.at(pair.first);
+          count.min += pair.second.min;
+          count.max += pair.second.max;
+        }
+      } else {
+        for (std::size_t c : {std::size_t{0}, column.at(optype)}) {
+          row[c].min += 1;
+          row[c].max += 1;
+        }
+        if (OpDesc(optype).is_gate() &&
+            get_Op_ptr_from_Vertex(v)->n_qubits() == 2) {
+          row[1].min += 1;
+          row[1].max += 1;
+        }
+        ResourceBounds<unsigned>& count = op_type_count.at(optype);
+        count.min += 1;
+        count.max += 1;
       }
-      // Aggregate with predecessors
-      update_from_predecessors(data, get_predecessors(v), datamap);
     }
-    datamap[v] = data;
+    BGL_FORALL_OUTEDGES(v, e, dag, DAG) {
+      const std::size_t t = index(target(e));
+      if (--n_waiting[t] == 0) order.push_back(t);
+    }
   }
+
   // Finally aggregate outputs
+  std::vector<ResourceBounds<unsigned>> final_row(width);
+  for (const Vertex& v : all_outputs()) {
+    merge_max(final_row.data(), index(v));
+  }
   ResourceData final_data;
-  update_from_predecessors(final_data, all_outputs(), datamap);
-  final_data.OpTypeCount = op_type_count;
+  final_data.GateDepth = final_row[0];
+  final_data.TwoQubitGateDepth = final_row[1];
+  for (const auto& [optype, c] : column) {
+    final_data.OpTypeDepth.insert({optype, final_row[c]});
+  }
+  final_data.OpTypeCount = std::move(op_type_count);
   return final_data;
 }
 
+std::size_t Circuit::memory_usage() const {
+  // Each vertex is a list node holding its properties, its index and its
+  // in- and out-edge lists. Each edge is a node in the graph's edge list,
+  // holding its ends and properties, and is referenced by a node in the
+  // out-edge list of its source and one in the in-edge list of its target.
+  constexpr std::size_t vertex_bytes =
+      sizeof(VertexProperties) + sizeof(int) + 2 * sizeof(std::list<int>) +
+      memory::LIST_NODE_OVERHEAD;
+  constexpr std::size_t edge_ref_bytes =
+      2 * sizeof(void*) + memory::LIST_NODE_OVERHEAD;
+  constexpr std::size_t edge_bytes =
+      2 * sizeof(Vertex) + sizeof(EdgeProperties) +
+      memory::LIST_NODE_OVERHEAD + 2 * edge_ref_bytes;
+
+  std::size_t bytes = sizeof(Circuit) +
+                      boost::num_vertices(dag) * vertex_bytes +
+                      boost::num_edges(dag) * edge_bytes +
+                      memory::multi_index_bytes(boundary, 5);
+  std::unordered_set<const Op*> ops;
+  BGL_FORALL_VERTICES(v, dag, DAG) {
+    const VertexProperties& props = dag[v];
+    if (props.opgroup) bytes += memory::container_bytes(*props.opgroup);
+    if (props.op && ops.insert(props.op.get()).second) {
+      bytes += memory::SHARED_CONTROL_OVERHEAD + props.op->memory_usage();
+    }
+  }
+  bytes += memory::container_bytes(wasmwire);
+  if (name) bytes += memory::container_bytes(*name);
+  bytes += memory::container_bytes(opgroupsigs);
+  for (const auto& [opgroup, sig] : opgroupsigs) {
+    bytes += memory::container_bytes(opgroup) + memory::container_bytes(sig);
+  }
+  if (change_log_) {
+    bytes += sizeof(ChangeLog) + memory::container_bytes(change_log_->ops) +
+             memory::container_bytes(change_log_->wires);
+  }
+  return bytes;
+}
+
 }  // namespace tket
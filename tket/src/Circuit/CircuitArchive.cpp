@@ -0,0 +1,207 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/CircuitArchive.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tket {
+
+// Layout, with every integer unsigned little-endian:
+//   magic "TKCA", version (4 bytes), number of circuits (8 bytes)
+//   index: for each circuit in sorted order of names, the offset and length
+//     of its name, then the offset and length of its data (8 bytes each)
+//   the names, then the data of each circuit as written by
+//     Circuit::to_binary
+static const char archive_magic[4] = {'T', 'K', 'C', 'A'};
+static constexpr std::uint32_t archive_version = 1;
+static constexpr std::size_t header_size = 16;
+static constexpr std::size_t entry_size = 32;
+
+[[noreturn]] static void fail(const std::string& message) {
+  throw CircuitInvalidity("Invalid circuit archive: " + message);
+}
+
+static std::uint64_t read_u64(const std::uint8_t* p) {
+  std::uint64_t x = 0;
+  for (unsigned i = 0; i < 8; ++i) {
+    x |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+  }
+  return x;
+}
+
+static void write_uint(std::string& out, std::uint64_t x, unsigned n_bytes) {
+  for (unsigned i = 0; i < n_bytes; ++i) {
+    out.push_back(static_cast<char>((x >> (8 * i)) & 0xff));
+  }
+}
+
+void CircuitArchive::write(
+    const std::string& path, const std::map<std::string, Circuit>& circuits) {
+  std::vector<std::vector<std::uint8_t>> data;
+  data.reserve(circuits.size());
+  std::size_t offset = header_size + entry_size * circuits.size();
+  std::string index;
+  std::size_t data_offset = offset;
+  for (const auto& [name, circ] : circuits) data_offset += name.size();
+  for (const auto& [name, circ] : circuits) {
+    data.push_back(circ.to_binary());
+    write_uint(index, offset, 8);
+    write_uint(index, name.size(), 8);
+    write_uint(index, data_offset, 8);
+    write_uint(index, data.back().size(), 8);
+    offset += name.size();
+    data_offset += data.back().size();
+  }
+  std::string header(archive_magic, 4);
+  write_uint(header, archive_version, 4);
+  write_uint(header, circuits.size(), 8);
+  std::ofstream out(path, std::ios::binary);
+  if (!out) throw std::runtime_error("Cannot write file " + path);
+  out << header << index;
+  for (const auto& [name, circ] : circuits) out << name;
+  for (const std::vector<std::uint8_t>& d : data) {
+    out.write(reinterpret_cast<const char*>(d.data()), d.size());
+  }
+  if (!out) throw std::runtime_error("Cannot write file " + path);
+}
+
+// The file contents, mapped into memory or else read into a buffer
+struct CircuitArchive::Mapping {
+  std::vector<std::uint8_t> buffer;
+  void* address = nullptr;
+  std::size_t length = 0;
+
+  ~Mapping() {
+#ifndef _WIN32
+    if (address != nullptr) munmap(address, length);
+#endif
+  }
+};
+
+CircuitArchive::CircuitArchive(const std::string& path)
+    : mapping_(std::make_unique<Mapping>()) {
+#ifndef _WIN32
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("Cannot read file " + path);
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw std::runtime_error("Cannot read file " + path);
+  }
+  file_size_ = static_cast<std::size_t>(st.st_size);
+  if (file_size_ > 0) {
+    void* address = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("Cannot map file " + path);
+    }
+    mapping_->address = address;
+    mapping_->length = file_size_;
+  }
+  close(fd);
+  data_ = static_cast<const std::uint8_t*>(mapping_->address);
+#else
+  std::ifstream in(path, std::ios::binary);
+  if (!in) throw std::runtime_error("Cannot read file " + path);
+  mapping_->buffer.assign(
+      std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  file_size_ = mapping_->buffer.size();
+  data_ = mapping_->buffer.data();
+#endif
+  if (file_size_ < header_size || std::memcmp(data_, archive_magic, 4) != 0) {
+    fail("bad magic number");
+  }
+  std::uint32_t version = 0;
+  for (unsigned i = 0; i < 4; ++i) {
+    version |= static_cast<std::uint32_t>(data_[4 + i]) << (8 * i);
+  }
+  if (version != archive_version) fail("unsupported version");
+  const std::uint64_t n = read_u64(data_ + 8);
+  if (n > (file_size_ - header_size) / entry_size) fail("truncated index");
+  size_ = n;
+}
+
+CircuitArchive::~CircuitArchive() = default;
+
+std::string_view CircuitArchive::name(std::size_t i) const {
+  const std::uint8_t* entry = data_ + header_size + i * entry_size;
+  const std::uint64_t offset = read_u64(entry);
+  const std::uint64_t length = read_u64(entry + 8);
+  if (offset > file_size_ || length > file_size_ - offset) {
+    fail("name out of range");
+  }
+  return {reinterpret_cast<const char*>(data_ + offset), length};
+}
+
+std::pair<const std::uint8_t*, std::size_t> CircuitArchive::circuit_data(
+    std::size_t i) const {
+  const std::uint8_t* entry = data_ + header_size + i * entry_size;
+  const std::uint64_t offset = read_u64(entry + 16);
+  const std::uint64_t length = read_u64(entry + 24);
+  if (offset > file_size_ || length > file_size_ - offset) {
+    fail("circuit out of range");
+  }
+  return {data_ + offset, length};
+}
+
+std::optional<std::size_t> CircuitArchive::find(const std::string& name) const {
+  std::size_t lo = 0, hi = size_;
+  while (lo < hi) {
+    const std::size_t mid = lo + (hi - lo) / 2;
+    const int cmp = this->name(mid).compare(name);
+    if (cmp == 0) return mid;
+    if (cmp < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return std::nullopt;
+}
+
+std::vector<std::string> CircuitArchive::names() const {
+  std::vector<std::string> all;
+  all.reserve(size_);
+  for (std::size_t i = 0; i < size_; ++i) all.emplace_back(name(i));
+  return all;
+}
+
+bool CircuitArchive::contains(const std::string& name) const {
+  return find(name).has_value();
+}
+
+Circuit CircuitArchive::get(const std::string& name) const {
+  std::optional<std::size_t> i = find(name);
+  if (!i) throw std::out_of_range("No circuit named " + name + " in archive");
+  return get(*i);
+}
+
+Circuit CircuitArchive::get(std::size_t i) const {
+  if (i >= size_) throw std::out_of_range("Circuit archive index out of range");
+  auto [data, length] = circuit_data(i);
+  return Circuit::from_binary(data, length);
+}
+
+}  // namespace tket
@@ -0,0 +1,393 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Gate/Gate.hpp"
+#include "tket/OpType/OpTypeInfo.hpp"
+#include "tket/Utils/Json.hpp"
+
+namespace tket {
+
+// Layout, with every integer an unsigned LEB128 varint:
+//   magic "TKCB", version
+//   string table: count, then each as length and bytes
+//   unit table: count, then each as type, name string, index length, index
+//   op type table: count, then the name string of each
+//   op table: count, then each as a tag, and for a gate (tag 0) its op type,
+//     its number of qubits if not fixed by the type, and its parameters, or
+//     for any other op (tag 1) the length and MessagePack of its JSON
+//   name (0 for none, else string + 1), phase
+//   qubits, bits: count, then units
+//   number of wasm wires
+//   commands: count, then each as op, opgroup (0 for none, else string + 1)
+//     and one unit per entry of the op signature
+//   implicit permutation: count, then pairs of units
+//   created qubits, discarded qubits: count, then units
+// Parameters are a tag, then for a floating-point number (tag 0) its 8 bytes,
+// little-endian, or for any other expression (tag 1) its string form.
+
+static const char binary_magic[] = "TKCB";
+static const unsigned binary_version = 1;
+
+namespace {
+
+class BinaryWriter {
+ public:
+  explicit BinaryWriter(std::string& out) : out_(out) {}
+
+  void varint(std::uint64_t x) {
+    while (x >= 0x80) {
+      out_.push_back(static_cast<char>((x & 0x7f) | 0x80));
+      x >>= 7;
+    }
+    out_.push_back(static_cast<char>(x));
+  }
+
+  void bytes(const std::string& s) {
+    varint(s.size());
+    out_ += s;
+  }
+
+  void expr(const Expr& e) {
+    ExprPtr p = e;
+    if (SymEngine::is_a<SymEngine::RealDouble>(*p)) {
+      out_.push_back(0);
+      double d = SymEngine::down_cast<const SymEngine::RealDouble&>(*p)
+                     .as_double();
+      std::uint64_t bits;
+      std::memcpy(&bits, &d, sizeof(bits));
+      for (unsigned i = 0; i < 8; ++i) {
+        out_.push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+      }
+    } else {
+      out_.push_back(1);
+      bytes(p->__str__());
+    }
+  }
+
+ private:
+  std::string& out_;
+};
+
+class BinaryReader {
+ public:
+  BinaryReader(const std::uint8_t* data, std::size_t size, std::size_t pos)
+      : data_(data), size_(size), pos_(pos) {}
+
+  std::uint8_t byte() {
+    if (pos_ >= size_) fail("truncated data");
+    return data_[pos_++];
+  }
+
+  std::uint64_t varint() {
+    std::uint64_t x = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+      std::uint8_t b = byte();
+      x |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+      if (!(b & 0x80)) return x;
+    }
+    fail("varint too long");
+    return 0;
+  }
+
+  // A varint that indexes a table of the given size
+  std::size_t index(std::size_t size) {
+    std::uint64_t i = varint();
+    if (i >= size) fail("index out of range");
+    return i;
+  }
+
+  std::string bytes() {
+    std::uint64_t n = varint();
+    if (n > size_ - pos_) fail("truncated data");
+    std::string s(data_ + pos_, data_ + pos_ + n);
+    pos_ += n;
+    return s;
+  }
+
+  Expr expr() {
+    if (byte() == 0) {
+      std::uint64_t bits = 0;
+      for (unsigned i = 0; i < 8; ++i) {
+        bits |= static_cast<std::uint64_t>(byte()) << (8 * i);
+      }
+      double d;
+      std::memcpy(&d, &bits, sizeof(d));
+      return Expr(d);
+    }
+    return Expr(bytes());
+  }
+
+  bool at_end() const { return pos_ == size_; }
+
+  [[noreturn]] static void fail(const std::string& message) {
+    throw CircuitInvalidity("Invalid binary circuit: " + message);
+  }
+
+ private:
+  const std::uint8_t* data_;
+  std::size_t size_;
+  std::size_t pos_;
+};
+
+// Builds the tables while the commands are written
+class BinaryEncoder {
+ public:
+  std::string body;
+
+  BinaryEncoder() : body_writer_(body) {}
+
+  BinaryWriter& writer() { return body_writer_; }
+
+  unsigned string(const std::string& s) {
+    auto [it, added] = string_index_.try_emplace(s, strings_.size());
+    if (added) strings_.push_back(s);
+    return it->second;
+  }
+
+  unsigned unit(const UnitID& u) {
+    auto [it, added] = unit_index_.try_emplace(u, units_.size());
+    if (added) units_.push_back(u);
+    return it->second;
+  }
+
+  unsigned op(const Op_ptr& op) {
+    std::unordered_map<const Op*, unsigned>::const_iterator seen =
+        op_ptr_index_.find(op.get());
+    if (seen != op_ptr_index_.end()) return seen->second;
+    std::string entry;
+    BinaryWriter w(entry);
+    const Gate* gate = dynamic_cast<const Gate*>(op.get());
+    if (gate) {
+      const OpType type = gate->get_type();
+      entry.push_back(0);
+      w.varint(op_type(type));
+      if (!optypeinfo().at(type).signature) w.varint(gate->n_qubits());
+      const std::vector<Expr> params = gate->get_params();
+      w.varint(params.size());
+      for (const Expr& e : params) w.expr(e);
+    } else {
+      entry.push_back(1);
+      std::vector<std::uint8_t> packed =
+          nlohmann::json::to_msgpack(nlohmann::json(op));
+      w.bytes(std::string(packed.begin(), packed.end()));
+    }
+    // Equal ops, such as copies of a box, are stored once
+    auto [it, added] = op_index_.try_emplace(entry, ops_.size());
+    if (added) ops_.push_back(entry);
+    // The circuit holds the op, so its address is not reused meanwhile
+    op_ptr_index_.insert({op.get(), it->second});
+    return it->second;
+  }
+
+  std::vector<std::uint8_t> finish() {
+    std::string out(binary_magic, 4);
+    BinaryWriter w(out);
+    w.varint(binary_version);
+    // Unit names and op types go in the string table first
+    std::string tables;
+    BinaryWriter t(tables);
+    t.varint(units_.size());
+    for (const UnitID& u : units_) {
+      t.varint(static_cast<unsigned>(u.type()));
+      t.varint(string(u.reg_name()));
+      const std::vector<unsigned> index = u.index();
+      t.varint(index.size());
+      for (unsigned i : index) t.varint(i);
+    }
+    t.varint(op_types_.size());
+    for (OpType type : op_types_) {
+      t.varint(string(nlohmann::json(type).get<std::string>()));
+    }
+    t.varint(ops_.size());
+    for (const std::string& entry : ops_) tables += entry;
+    w.varint(strings_.size());
+    for (const std::string& s : strings_) w.bytes(s);
+    out += tables;
+    out += body;
+    return std::vector<std::uint8_t>(out.begin(), out.end());
+  }
+
+ private:
+  BinaryWriter body_writer_;
+  std::vector<std::string> strings_;
+  std::unordered_map<std::string, unsigned> string_index_;
+  std::vector<UnitID> units_;
+  std::map<UnitID, unsigned> unit_index_;
+  std::vector<OpType> op_types_;
+  std::map<OpType, unsigned> op_type_index_;
+  std::vector<std::string> ops_;
+  std::unordered_map<std::string, unsigned> op_index_;
+  std::unordered_map<const Op*, unsigned> op_ptr_index_;
+
+  unsigned op_type(OpType type) {
+    auto [it, added] = op_type_index_.try_emplace(type, op_types_.size());
+    if (added) op_types_.push_back(type);
+    return it->second;
+  }
+};
+
+}  // namespace
+
+std::vector<std::uint8_t> Circuit::to_binary() const {
+  BinaryEncoder enc;
+  BinaryWriter& w = enc.writer();
+  w.varint(name ? enc.string(*name) + 1 : 0);
+  w.expr(phase);
+  const qubit_vector_t qubits = all_qubits();
+  w.varint(qubits.size());
+  for (const Qubit& q : qubits) w.varint(enc.unit(q));
+  const bit_vector_t bits = all_bits();
+  w.varint(bits.size());
+  for (const Bit& b : bits) w.varint(enc.unit(b));
+  w.varint(_number_of_wasm_wires);
+  std::string commands;
+  BinaryWriter c(commands);
+  std::size_t n_commands = 0;
+  for (const Command& com : *this) {
+    c.varint(enc.op(com.get_op_ptr()));
+    const std::optional<std::string> opgroup = com.get_opgroup();
+    c.varint(opgroup ? enc.string(*opgroup) + 1 : 0);
+    for (const UnitID& u : com.get_args()) c.varint(enc.unit(u));
+    ++n_commands;
+  }
+  w.varint(n_commands);
+  enc.body += commands;
+  const qubit_map_t perm = implicit_qubit_permutation();
+  w.varint(perm.size());
+  for (const std::pair<const Qubit, Qubit>& pair : perm) {
+    w.varint(enc.unit(pair.first));
+    w.varint(enc.unit(pair.second));
+  }
+  for (const qubit_vector_t& qs : {created_qubits(), discarded_qubits()}) {
+    w.varint(qs.size());
+    for (const Qubit& q : qs) w.varint(enc.unit(q));
+  }
+  return enc.finish();
+}
+
+Circuit Circuit::from_binary(const std::vector<std::uint8_t>& data) {
+  return from_binary(data.data(), data.size());
+}
+
+Circuit Circuit::from_binary(const std::uint8_t* data, std::size_t size) {
+  if (size < 4 || std::memcmp(data, binary_magic, 4) != 0) {
+    BinaryReader::fail("bad magic number");
+  }
+  BinaryReader r(data, size, 4);
+  if (r.varint() != binary_version) {
+    BinaryReader::fail("unsupported version");
+  }
+  std::vector<std::string> strings(r.varint());
+  for (std::string& s : strings) s = r.bytes();
+  std::vector<UnitID> units;
+  for (std::uint64_t n = r.varint(); n > 0; --n) {
+    const std::uint64_t type = r.varint();
+    const std::string& reg = strings[r.index(strings.size())];
+    std::vector<unsigned> index(r.varint());
+    for (unsigned& i : index) i = r.varint();
+    switch (type) {
+      case static_cast<unsigned>(UnitType::Qubit):
+        units.push_back(Qubit(reg, index));
+        break;
+      case static_cast<unsigned>(UnitType::Bit):
+        units.push_back(Bit(reg, index));
+        break;
+      case static_cast<unsigned>(UnitType::WasmState):
+        units.push_back(WasmState(reg, index));
+        break;
+      default:
+        BinaryReader::fail("unknown unit type");
+    }
+  }
+  std::vector<OpType> op_types;
+  for (std::uint64_t n = r.varint(); n > 0; --n) {
+    op_types.push_back(
+        nlohmann::json(strings[r.index(strings.size())]).get<OpType>());
+  }
+  std::vector<Op_ptr> ops;
+  for (std::uint64_t n = r.varint(); n > 0; --n) {
+    if (r.byte() == 0) {
+      const OpType type = op_types[r.index(op_types.size())];
+      const std::optional<op_signature_t>& sig =
+          optypeinfo().at(type).signature;
+      unsigned n_qb =
+          sig ? std::count(sig->begin(), sig->end(), EdgeType::Quantum)
+              : r.varint();
+      std::vector<Expr> params(r.varint());
+      for (Expr& e : params) e = r.expr();
+      ops.push_back(get_op_ptr(type, params, n_qb));
+    } else {
+      const std::string packed = r.bytes();
+      ops.push_back(
+          nlohmann::json::from_msgpack(packed.begin(), packed.end())
+              .get<Op_ptr>());
+    }
+  }
+  auto unit = [&]() -> const UnitID& { return units[r.index(units.size())]; };
+  auto qubit = [&]() {
+    const UnitID& u = unit();
+    if (u.type() != UnitType::Qubit) BinaryReader::fail("expected a qubit");
+    return Qubit(u);
+  };
+
+  Circuit circ;
+  const std::uint64_t name_index = r.varint();
+  if (name_index > 0) {
+    if (name_index > strings.size()) BinaryReader::fail("index out of range");
+    circ.set_name(strings[name_index - 1]);
+  }
+  circ.add_phase(r.expr());
+  for (std::uint64_t n = r.varint(); n > 0; --n) circ.add_qubit(qubit());
+  for (std::uint64_t n = r.varint(); n > 0; --n) {
+    const UnitID& u = unit();
+    if (u.type() != UnitType::Bit) BinaryReader::fail("expected a bit");
+    circ.add_bit(Bit(u));
+  }
+  const std::uint64_t n_wasm = r.varint();
+  if (n_wasm > 0) circ.add_wasm_register(n_wasm);
+  for (std::uint64_t n = r.varint(); n > 0; --n) {
+    const Op_ptr& op = ops[r.index(ops.size())];
+    const std::uint64_t opgroup_index = r.varint();
+    std::optional<std::string> opgroup;
+    if (opgroup_index > 0) {
+      if (opgroup_index > strings.size()) {
+        BinaryReader::fail("index out of range");
+      }
+      opgroup = strings[opgroup_index - 1];
+    }
+    unit_vector_t args(op->get_signature().size());
+    for (UnitID& arg : args) arg = unit();
+    circ.add_op(op, args, opgroup);
+  }
+  qubit_map_t perm;
+  for (std::uint64_t n = r.varint(); n > 0; --n) {
+    Qubit in = qubit();
+    perm.insert({in, qubit()});
+  }
+  circ.permute_boundary_output(perm);
+  for (std::uint64_t n = r.varint(); n > 0; --n) circ.qubit_create(qubit());
+  for (std::uint64_t n = r.varint(); n > 0; --n) circ.qubit_discard(qubit());
+  if (!r.at_end()) BinaryReader::fail("trailing data");
+  return circ;
+}
+
+}  // namespace tket
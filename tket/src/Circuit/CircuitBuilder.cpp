@@ -0,0 +1,222 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/CircuitBuilder.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "tket/Gate/OpPtrFunctions.hpp"
+#include "tket/OpType/OpTypeFunctions.hpp"
+#include "tket/OpType/OpTypeInfo.hpp"
+
+namespace tket {
+
+CircuitBuilder::CircuitBuilder(unsigned n_qubits, unsigned n_bits)
+    : n_qubits_(n_qubits), n_bits_(n_bits), arg_offsets_{0} {}
+
+void CircuitBuilder::reserve(std::size_t n_ops, std::size_t n_args) {
+  ops_.reserve(n_ops);
+  sigs_.reserve(n_ops);
+  arg_offsets_.reserve(n_ops + 1);
+  args_.reserve(n_args);
+}
+
+void CircuitBuilder::add_op(
+    const Op_ptr &op, const std::vector<unsigned> &args) {
+  ops_.push_back(op);
+  sigs_.push_back(op->get_signature());
+  args_.insert(args_.end(), args.begin(), args.end());
+  arg_offsets_.push_back(args_.size());
+}
+
+void CircuitBuilder::add_op(
+    OpType type, const std::vector<Expr> &params,
+    const std::vector<unsigned> &args) {
+  if (is_metaop_type(type) || is_barrier_type(type)) {
+    throw CircuitInvalidity(
+        "Cannot add metaop or barrier with CircuitBuilder");
+  }
+  add_op(get_op_ptr(type, params, args.size()), args);
+}
+
+void CircuitBuilder::add_gates(
+    const std::vector<OpType> &types, const std::vector<unsigned> &qubits,
+    unsigned qubit_width, const std::vector<double> &params,
+    unsigned param_width) {
+  const std::size_t n = types.size();
+  if (qubits.size() != n * qubit_width || params.size() != n * param_width) {
+    throw CircuitInvalidity(
+        "Gate argument and parameter matrices must have one row per gate");
+  }
+  std::map<OpType, Op_ptr> unparameterised;
+  reserve(ops_.size() + n, args_.size() + qubits.size());
+  // Leave the builder unchanged if any gate is rejected
+  const std::size_t n_ops = ops_.size();
+  const std::size_t n_args = args_.size();
+  try {
+    for (std::size_t i = 0; i < n; ++i) {
+      const OpType type = types[i];
+      auto info = optypeinfo().find(type);
+      if (info == optypeinfo().end()) {
+        throw CircuitInvalidity(
+            "Gate " + std::to_string(i) + ": unknown operation type");
+      }
+      const std::optional<op_signature_t> &sig = info->second.signature;
+      if (is_metaop_type(type) || is_barrier_type(type) || !sig ||
+          !std::all_of(sig->begin(), sig->end(), [](EdgeType e) {
+            return e == EdgeType::Quantum;
+          })) {
+        throw CircuitInvalidity(
+            "Gate " + std::to_string(i) + ": " + info->second.name +
+            " is not a gate on a fixed number of qubits");
+      }
+      const unsigned n_params = info->second.n_params();
+      if (sig->size() > qubit_width || n_params > param_width) {
+        throw CircuitInvalidity(
+            "Gate " + std::to_string(i) + ": " + info->second.name +
+            " needs more arguments or parameters than the rows provide");
+      }
+      Op_ptr op;
+      if (n_params == 0) {
+        auto found = unparameterised.find(type);
+        if (found == unparameterised.end()) {
+          found = unparameterised.insert({type, get_op_ptr(type)}).first;
+        }
+        op = found->second;
+      } else {
+        const double *row = params.data() + i * param_width;
+        op = get_op_ptr(type, std::vector<Expr>(row, row + n_params));
+      }
+      ops_.push_back(op);
+      sigs_.push_back(*sig);
+      const unsigned *row = qubits.data() + i * qubit_width;
+      args_.insert(args_.end(), row, row + sig->size());
+      arg_offsets_.push_back(args_.size());
+    }
+  } catch (...) {
+    ops_.resize(n_ops);
+    sigs_.resize(n_ops);
+    args_.resize(n_args);
+    arg_offsets_.resize(n_ops + 1);
+    throw;
+  }
+}
+
+void CircuitBuilder::validate() const {
+  // Index of the last operation to use each unit (qubits then bits), used to
+  // detect repeated arguments without per-operation allocation.
+  std::vector<std::size_t> last_use(
+      n_qubits_ + n_bits_, std::numeric_limits<std::size_t>::max());
+  for (std::size_t i = 0; i < ops_.size(); ++i) {
+    const op_signature_t &sig = sigs_[i];
+    const std::size_t n_args = arg_offsets_[i + 1] - arg_offsets_[i];
+    if (sig.size() != n_args) {
+      throw CircuitInvalidity(
+          "Operation " + std::to_string(i) + ": " + std::to_string(n_args) +
+          " args provided, but " + ops_[i]->get_name() + " requires " +
+          std::to_string(sig.size()));
+    }
+    for (std::size_t p = 0; p < n_args; ++p) {
+      const unsigned arg = args_[arg_offsets_[i] + p];
+      std::size_t unit;
+      switch (sig[p]) {
+        case EdgeType::Quantum: {
+          if (arg >= n_qubits_) {
+            throw CircuitInvalidity(
+                "Operation " + std::to_string(i) + ": qubit index " +
+                std::to_string(arg) + " out of range");
+          }
+          unit = arg;
+          break;
+        }
+        case EdgeType::Classical:
+        case EdgeType::Boolean: {
+          if (arg >= n_bits_) {
+            throw CircuitInvalidity(
+                "Operation " + std::to_string(i) + ": bit index " +
+                std::to_string(arg) + " out of range");
+          }
+          unit = n_qubits_ + arg;
+          break;
+        }
+        default: {
+          throw CircuitInvalidity(
+              "Operation " + std::to_string(i) +
+              ": CircuitBuilder does not support WASM arguments");
+        }
+      }
+      if (sig[p] == EdgeType::Boolean) continue;
+      if (last_use[unit] == i) {
+        throw CircuitInvalidity(
+            "Operation " + std::to_string(i) +
+            ": multiple arguments reference the same unit");
+      }
+      last_use[unit] = i;
+    }
+  }
+}
+
+Circuit CircuitBuilder::build() const {
+  validate();
+  Circuit circ(n_qubits_, n_bits_);
+  // Last (vertex, port) on each unit, qubits then bits. Start from the
+  // inputs, detaching them from the outputs.
+  std::vector<VertPort> frontier;
+  std::vector<Vertex> outputs;
+  frontier.reserve(n_qubits_ + n_bits_);
+  outputs.reserve(n_qubits_ + n_bits_);
+  for (unsigned q = 0; q < n_qubits_; ++q) {
+    frontier.push_back({circ.get_in(Qubit(q)), 0});
+    outputs.push_back(circ.get_out(Qubit(q)));
+  }
+  for (unsigned b = 0; b < n_bits_; ++b) {
+    frontier.push_back({circ.get_in(Bit(b)), 0});
+    outputs.push_back(circ.get_out(Bit(b)));
+  }
+  for (const VertPort &vp : frontier) {
+    circ.remove_edge(circ.get_nth_out_edge(vp.first, 0));
+  }
+
+  for (std::size_t i = 0; i < ops_.size(); ++i) {
+    const op_signature_t &sig = sigs_[i];
+    const unsigned *args = args_.data() + arg_offsets_[i];
+    const Vertex v = circ.add_vertex(ops_[i]);
+    // Add all in-edges before advancing the frontier, so that a Boolean
+    // and a Classical argument on the same bit both read the previous value.
+    for (port_t p = 0; p < sig.size(); ++p) {
+      const unsigned unit =
+          (sig[p] == EdgeType::Quantum) ? args[p] : n_qubits_ + args[p];
+      circ.add_edge(frontier[unit], {v, p}, sig[p]);
+    }
+    for (port_t p = 0; p < sig.size(); ++p) {
+      if (sig[p] == EdgeType::Boolean) continue;
+      const unsigned unit =
+          (sig[p] == EdgeType::Quantum) ? args[p] : n_qubits_ + args[p];
+      frontier[unit] = {v, p};
+    }
+  }
+
+  for (unsigned u = 0; u < frontier.size(); ++u) {
+    circ.add_edge(
+        frontier[u], {outputs[u], 0},
+        (u < n_qubits_) ? EdgeType::Quantum : EdgeType::Classical);
+  }
+  return circ;
+}
+
+}  // namespace tket
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <optional>
+
+#include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Utils/Json.hpp"
 
@@ -44,8 +47,21 @@ void to_json(nlohmann::json& j, const Circuit& circ) {
   j["discarded_qubits"] = circ.discarded_qubits();
 }
 
+nlohmann::json circuit_to_json_with_box_table(const Circuit& circ) {
+  BoxJsonTable table;
+  nlohmann::json j = circ;
+  if (!table.get_table().empty()) {
+    j["boxes"] = table.get_table();
+  }
+  return j;
+}
+
 void from_json(const nlohmann::json& j, Circuit& circ) {
   circ = Circuit();
+  std::optional<BoxJsonTable> boxes;
+  if (j.contains("boxes")) {
+    boxes.emplace(j.at("boxes"));
+  }
 
   if (j.contains("name")) {
     circ.set_name(j["name"].get<std::string>());
@@ -0,0 +1,269 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <functional>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tket/Circuit/Boxes.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Utils/Json.hpp"
+
+namespace tket {
+
+namespace {
+
+/**
+ * SAX handler reading the circuit_v1 schema.
+ *
+ * Each member of the top-level object, and each element of its "commands"
+ * array, is built as a small JSON value and applied to the circuit as soon as
+ * it is complete.
+ */
+class CircuitSaxHandler {
+ public:
+  using json = nlohmann::json;
+
+  /**
+   * @param circ circuit to read into
+   * @param on_command if set, called with each command instead of adding it
+   *   to the circuit
+   */
+  CircuitSaxHandler(
+      Circuit& circ, std::function<void(const Command&)> on_command = {})
+      : circ_(circ), on_command_(std::move(on_command)), level_(0) {}
+
+  bool null() { return scalar(nullptr); }
+  bool boolean(bool b) { return scalar(b); }
+  bool number_integer(json::number_integer_t n) { return scalar(n); }
+  bool number_unsigned(json::number_unsigned_t n) { return scalar(n); }
+  bool number_float(json::number_float_t x, const json::string_t&) {
+    return scalar(x);
+  }
+  bool string(json::string_t& s) { return scalar(std::move(s)); }
+  bool binary(json::binary_t& b) { return scalar(json::binary(std::move(b))); }
+
+  bool start_object(std::size_t) {
+    if (stack_.empty() && level_ == 0) {
+      level_ = 1;
+      return true;
+    }
+    begin(json::object());
+    return true;
+  }
+
+  bool key(json::string_t& k) {
+    if (stack_.empty()) {
+      key_ = k;
+    } else {
+      element_ = &(*stack_.back())[k];
+    }
+    return true;
+  }
+
+  bool end_object() {
+    if (stack_.empty()) {
+      level_ = 0;
+      return true;
+    }
+    return end();
+  }
+
+  bool start_array(std::size_t) {
+    if (stack_.empty() && level_ == 1 && key_ == "commands") {
+      level_ = 2;
+      seen_commands_ = true;
+      return true;
+    }
+    begin(json::array());
+    return true;
+  }
+
+  bool end_array() {
+    if (stack_.empty()) {
+      level_ = 1;
+      return true;
+    }
+    return end();
+  }
+
+  bool parse_error(
+      std::size_t, const std::string&, const nlohmann::detail::exception& e) {
+    error_ = e.what();
+    return false;
+  }
+
+  const std::string& error() const { return error_; }
+
+  // Apply the members that must follow the commands
+  void finish() {
+    if (!seen_phase_) throw JsonError("Circuit JSON has no \"phase\"");
+    if (!seen_commands_) throw JsonError("Circuit JSON has no \"commands\"");
+    if (!implicit_permutation_) {
+      throw JsonError("Circuit JSON has no \"implicit_permutation\"");
+    }
+    circ_.permute_boundary_output(*implicit_permutation_);
+    for (const Qubit& q : created_qubits_) circ_.qubit_create(q);
+    for (const Qubit& q : discarded_qubits_) circ_.qubit_discard(q);
+  }
+
+ private:
+  Circuit& circ_;
+  std::function<void(const Command&)> on_command_;
+  // 0 outside the circuit object, 1 inside it, 2 inside its "commands"
+  unsigned level_;
+  // Key of the member of the circuit object being read
+  std::string key_;
+  // Value being built and the open containers within it
+  json value_;
+  std::vector<json*> stack_;
+  json* element_ = nullptr;
+  std::string error_;
+  bool seen_phase_ = false;
+  bool seen_commands_ = false;
+  std::optional<qubit_map_t> implicit_permutation_;
+  qubit_vector_t created_qubits_;
+  qubit_vector_t discarded_qubits_;
+  // Box table, which precedes the commands in serialised circuits
+  nlohmann::json boxes_;
+  std::unique_ptr<BoxJsonTable> box_table_;
+
+  json* insert(json v) {
+    json* top = stack_.back();
+    if (top->is_array()) {
+      top->push_back(std::move(v));
+      return &top->back();
+    }
+    *element_ = std::move(v);
+    return element_;
+  }
+
+  void begin(json container) {
+    if (stack_.empty()) {
+      check_level();
+      value_ = std::move(container);
+      stack_.push_back(&value_);
+    } else {
+      stack_.push_back(insert(std::move(container)));
+    }
+  }
+
+  bool end() {
+    stack_.pop_back();
+    if (stack_.empty()) complete(std::move(value_));
+    return true;
+  }
+
+  bool scalar(json v) {
+    if (stack_.empty()) {
+      check_level();
+      complete(std::move(v));
+    } else {
+      insert(std::move(v));
+    }
+    return true;
+  }
+
+  void check_level() const {
+    if (level_ == 0) throw JsonError("Circuit JSON must be an object");
+  }
+
+  void complete(json v) {
+    if (level_ == 2) {
+      add_command(v.get<Command>());
+    } else {
+      add_member(std::move(v));
+    }
+  }
+
+  void add_member(json v) {
+    if (key_ == "name") {
+      circ_.set_name(v.get<std::string>());
+    } else if (key_ == "phase") {
+      circ_.add_phase(v.get<Expr>());
+      seen_phase_ = true;
+    } else if (key_ == "qubits") {
+      for (const Qubit& qb : v.get<qubit_vector_t>()) add_unit(qb);
+    } else if (key_ == "bits") {
+      for (const Bit& b : v.get<bit_vector_t>()) add_unit(b);
+    } else if (key_ == "number_of_ws") {
+      circ_.add_wasm_register(v.get<unsigned>());
+    } else if (key_ == "implicit_permutation") {
+      implicit_permutation_ = v.get<qubit_map_t>();
+    } else if (key_ == "created_qubits") {
+      created_qubits_ = v.get<qubit_vector_t>();
+    } else if (key_ == "discarded_qubits") {
+      discarded_qubits_ = v.get<qubit_vector_t>();
+    } else if (key_ == "boxes") {
+      boxes_ = std::move(v);
+      box_table_ = std::make_unique<BoxJsonTable>(boxes_);
+    } else if (key_ == "commands") {
+      throw JsonError("Circuit JSON \"commands\" must be an array");
+    }
+  }
+
+  void add_command(const Command& com) {
+    const unit_vector_t& args = com.get_args();
+    for (const UnitID& u : args) add_unit(u);
+    if (on_command_) {
+      on_command_(com);
+    } else {
+      circ_.add_op(com.get_op_ptr(), args, com.get_opgroup());
+    }
+  }
+
+  void add_unit(const UnitID& u) {
+    if (circ_.contains_unit(u)) return;
+    switch (u.type()) {
+      case UnitType::Qubit:
+        circ_.add_qubit(Qubit(u));
+        break;
+      case UnitType::Bit:
+        circ_.add_bit(Bit(u));
+        break;
+      case UnitType::WasmState:
+        circ_.add_wasm_register(u.index().at(0) + 1);
+        break;
+    }
+  }
+};
+
+}  // namespace
+
+static Circuit read_json_stream(
+    std::istream& in, std::function<void(const Command&)> on_command) {
+  Circuit circ;
+  CircuitSaxHandler handler(circ, std::move(on_command));
+  if (!nlohmann::json::sax_parse(in, &handler)) {
+    throw JsonError("Cannot read circuit JSON: " + handler.error());
+  }
+  handler.finish();
+  return circ;
+}
+
+Circuit Circuit::from_json_stream(std::istream& in) {
+  return read_json_stream(in, {});
+}
+
+Circuit Circuit::from_json_stream(
+    std::istream& in,
+    const std::function<void(const Command&)>& on_command) {
+  return read_json_stream(in, on_command);
+}
+
+}  // namespace tket
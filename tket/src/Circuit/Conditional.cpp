@@ -15,6 +15,7 @@
 #include "tket/Circuit/Conditional.hpp"
 
 #include "tket/OpType/OpType.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 
 namespace tket {
 
@@ -50,6 +51,11 @@ op_signature_t Conditional::get_signature() const {
   return signature;
 }
 
+std::size_t Conditional::memory_usage() const {
+  return sizeof(Conditional) + memory::SHARED_CONTROL_OVERHEAD +
+         op_->memory_usage();
+}
+
 nlohmann::json Conditional::serialize() const {
   nlohmann::json j;
   nlohmann::json j_cond;
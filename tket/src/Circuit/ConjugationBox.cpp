@@ -90,7 +90,7 @@ void ConjugationBox::generate_circuit() const {
   } else {
     circ.add_op<unsigned>(compute_->dagger(), args);
   }
-  circ_ = std::make_shared<Circuit>(circ);
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 Op_ptr ConjugationBox::symbol_substitution(
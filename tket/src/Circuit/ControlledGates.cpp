@@ -834,6 +834,51 @@ Circuit CnX_gray_decomp(unsigned n) {
   }
 }
 
+Circuit CnX_vchain_decomp(unsigned n) {
+  if (n < 3) {
+    throw ControlDecompError("V-chain decomposition needs at least 3 controls");
+  }
+  // Controls 0..n-1, target n, borrowed qubits n+1..2n-2
+  auto anc = [n](unsigned i) { return n + 1 + i; };
+  Circuit circ(2 * n - 1);
+  for (unsigned rep = 0; rep < 2; ++rep) {
+    circ.append_qubits(CCX_normal_decomp(), {n - 1, anc(n - 3), n});
+    for (unsigned i = n - 2; i >= 2; --i) {
+      circ.append_qubits(CCX_modulo_phase_shift(), {i, anc(i - 2), anc(i - 1)});
+    }
+    circ.append_qubits(CCX_modulo_phase_shift(), {0, 1, anc(0)});
+    for (unsigned i = 2; i <= n - 2; ++i) {
+      circ.append_qubits(CCX_modulo_phase_shift(), {i, anc(i - 2), anc(i - 1)});
+    }
+  }
+  return circ;
+}
+
+Circuit CnX_log_depth_decomp(unsigned n) {
+  if (n < 3) {
+    throw ControlDecompError(
+        "Log-depth decomposition needs at least 3 controls");
+  }
+  Circuit compute(2 * n - 1);
+  std::vector<unsigned> layer(n);
+  std::iota(layer.begin(), layer.end(), 0);
+  unsigned next_anc = n + 1;
+  while (layer.size() > 2) {
+    std::vector<unsigned> next_layer;
+    for (unsigned i = 0; i + 1 < layer.size(); i += 2) {
+      compute.append_qubits(
+          CCX_modulo_phase_shift(), {layer[i], layer[i + 1], next_anc});
+      next_layer.push_back(next_anc++);
+    }
+    if (layer.size() % 2 == 1) next_layer.push_back(layer.back());
+    layer = std::move(next_layer);
+  }
+  Circuit circ = compute;
+  circ.append_qubits(CCX_normal_decomp(), {layer[0], layer[1], n});
+  circ.append(compute.dagger());
+  return circ;
+}
+
 static void add_cu_using_cu3(
     const unsigned& ctrl, const unsigned& trgt, Circuit& circ,
     const Eigen::Matrix2cd& u) {
@@ -1032,11 +1077,11 @@ Circuit CnSU2_linear_decomp(
     unsigned cnx_arity = circ.n_in_edges(original_cnx);
     switch (cnx_arity) {
       case 2: {
-        circ.dag[original_cnx] = {get_op_ptr(OpType::CX)};
+        circ.set_vertex_Op_ptr(original_cnx, get_op_ptr(OpType::CX));
         break;
       }
       case 3: {
-        circ.dag[original_cnx] = {get_op_ptr(OpType::CCX)};
+        circ.set_vertex_Op_ptr(original_cnx, get_op_ptr(OpType::CCX));
         break;
       }
       default: {
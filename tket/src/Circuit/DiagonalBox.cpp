@@ -14,8 +14,11 @@
 
 #include "tket/Circuit/DiagonalBox.hpp"
 
+#include <list>
+
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Circuit/Multiplexor.hpp"
+#include "tket/Converters/PhasePoly.hpp"
 #include "tket/Gate/Rotation.hpp"
 #include "tket/Ops/OpJsonFactory.hpp"
 #include "tket/Utils/HelperFunctions.hpp"
@@ -23,10 +26,13 @@
 
 namespace tket {
 
-DiagonalBox::DiagonalBox(const Eigen::VectorXcd &diagonal, bool upper_triangle)
+DiagonalBox::DiagonalBox(
+    const Eigen::VectorXcd &diagonal, bool upper_triangle,
+    const DiagonalBoxSynthStrat &strat)
     : Box(OpType::DiagonalBox),
       diagonal_(diagonal),
-      upper_triangle_(upper_triangle) {
+      upper_triangle_(upper_triangle),
+      strat_(strat) {
   std::size_t length = diagonal.size();
   if (length < 2 || (length & (length - 1)) != 0) {
     throw std::invalid_argument(
@@ -45,14 +51,16 @@ DiagonalBox::DiagonalBox(const Eigen::VectorXcd &diagonal, bool upper_triangle)
 DiagonalBox::DiagonalBox(const DiagonalBox &other)
     : Box(other),
       diagonal_(other.diagonal_),
-      upper_triangle_(other.upper_triangle_) {}
+      upper_triangle_(other.upper_triangle_),
+      strat_(other.strat_) {}
 
 Op_ptr DiagonalBox::dagger() const {
-  return std::make_shared<DiagonalBox>(diagonal_.conjugate(), upper_triangle_);
+  return std::make_shared<DiagonalBox>(
+      diagonal_.conjugate(), upper_triangle_, strat_);
 }
 
 Op_ptr DiagonalBox::transpose() const {
-  return std::make_shared<DiagonalBox>(diagonal_, upper_triangle_);
+  return std::make_shared<DiagonalBox>(diagonal_, upper_triangle_, strat_);
 }
 
 op_signature_t DiagonalBox::get_signature() const {
@@ -62,6 +70,7 @@ op_signature_t DiagonalBox::get_signature() const {
 
 Eigen::VectorXcd DiagonalBox::get_diagonal() const { return diagonal_; }
 bool DiagonalBox::is_upper_triangle() const { return upper_triangle_; }
+DiagonalBoxSynthStrat DiagonalBox::get_strat() const { return strat_; }
 
 /**
  * @brief Construct a circuit that implements a diagonal operator
@@ -118,14 +127,63 @@ static Circuit diagonal_circ(
   return circ;
 };
 
+/**
+ * @brief Construct a circuit that implements a diagonal operator as a phase
+ * polynomial
+ *
+ * Writing the diagonal as exp(i*theta(x)), the phases have the expansion
+ * theta(x) = sum_s a_s (-1)^(s.x), whose coefficients are the Walsh-Hadamard
+ * transform of theta divided by 2^n. Each term with s != 0 is an Rz on the
+ * parity s, synthesised with GraySynth (https://arxiv.org/abs/1712.01859),
+ * and a_0 is a global phase.
+ *
+ * @param diagonal
+ * @return Circuit
+ */
+static Circuit diagonal_phase_poly_circ(const Eigen::VectorXcd &diagonal) {
+  const unsigned n_qubits = (unsigned)log2(diagonal.size());
+  const Eigen::Index length = diagonal.size();
+  Eigen::VectorXd coeffs(length);
+  for (Eigen::Index x = 0; x < length; x++) {
+    coeffs[x] = std::arg(diagonal[x]);
+  }
+  // in-place fast Walsh-Hadamard transform
+  for (Eigen::Index h = 1; h < length; h *= 2) {
+    for (Eigen::Index i = 0; i < length; i += 2 * h) {
+      auto a = coeffs.segment(i, h);
+      auto b = coeffs.segment(i + h, h);
+      a += b;
+      b = a - 2. * b;
+    }
+  }
+  coeffs /= (double)length;
+  std::list<phase_term_t> parities;
+  for (Eigen::Index s = 1; s < length; s++) {
+    // exp(i*a*Z_s) = Rz(-2a/pi) on the parity s
+    const double angle = -2 * coeffs[s] / PI;
+    if (std::abs(angle) > EPS) {
+      parities.push_back({dec_to_bin(s, n_qubits), angle});
+    }
+  }
+  Circuit circ = gray_synth(
+      n_qubits, parities, MatrixXb::Identity(n_qubits, n_qubits));
+  circ.add_phase(coeffs[0] / PI);
+  return circ;
+}
+
 void DiagonalBox::generate_circuit() const {
-  circ_ = std::make_shared<Circuit>(diagonal_circ(diagonal_, upper_triangle_));
+  if (strat_ == DiagonalBoxSynthStrat::PhasePolynomial) {
+    circ_ = std::make_shared<Circuit>(diagonal_phase_poly_circ(diagonal_));
+  } else {
+    circ_ =
+        std::make_shared<Circuit>(diagonal_circ(diagonal_, upper_triangle_));
+  }
 }
 
 bool DiagonalBox::is_equal(const Op &op_other) const {
   const DiagonalBox &other = dynamic_cast<const DiagonalBox &>(op_other);
   if (id_ == other.get_id()) return true;
-  return upper_triangle_ == other.upper_triangle_ &&
+  return upper_triangle_ == other.upper_triangle_ && strat_ == other.strat_ &&
          diagonal_.isApprox(other.diagonal_);
 }
 
@@ -134,13 +192,18 @@ nlohmann::json DiagonalBox::to_json(const Op_ptr &op) {
   nlohmann::json j = core_box_json(box);
   j["diagonal"] = box.get_diagonal();
   j["upper_triangle"] = box.is_upper_triangle();
+  j["strat"] = box.get_strat();
   return j;
 }
 
 Op_ptr DiagonalBox::from_json(const nlohmann::json &j) {
+  DiagonalBoxSynthStrat strat = DiagonalBoxSynthStrat::Multiplexor;
+  if (j.contains("strat")) {
+    strat = j.at("strat").get<DiagonalBoxSynthStrat>();
+  }
   DiagonalBox box = DiagonalBox(
       j.at("diagonal").get<Eigen::VectorXcd>(),
-      j.at("upper_triangle").get<bool>());
+      j.at("upper_triangle").get<bool>(), strat);
   return set_box_id(
       box,
       boost::lexical_cast<boost::uuids::uuid>(j.at("id").get<std::string>()));
@@ -42,7 +42,9 @@ bool DummyBox::is_equal(const Op &op_other) const {
 
 unsigned DummyBox::get_n_qubits() const { return n_qubits; }
 unsigned DummyBox::get_n_bits() const { return n_bits; }
-ResourceData DummyBox::get_resource_data() const { return resource_data; }
+const ResourceData& DummyBox::get_resource_data() const {
+  return resource_data;
+}
 
 op_signature_t DummyBox::get_signature() const {
   op_signature_t sig(n_qubits, EdgeType::Quantum);
@@ -0,0 +1,178 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/FlatDAG.hpp"
+
+#include <tkassert/Assert.hpp>
+
+#include "tket/OpType/OpTypeFunctions.hpp"
+
+namespace tket {
+
+FlatDAG::FlatDAG(const Circuit &circ) {
+  const unsigned n_verts = circ.n_vertices();
+  vertices_.reserve(n_verts);
+  index_.reserve(n_verts);
+  in_offsets_.reserve(n_verts + 1);
+  out_offsets_.reserve(n_verts + 1);
+  in_offsets_.push_back(0);
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+    index_.insert({v, vertices_.size()});
+    vertices_.push_back({v, circ.get_Op_ptr_from_Vertex(v), false});
+    in_offsets_.push_back(in_offsets_.back() + circ.n_in_edges(v));
+  }
+  in_edges_.assign(in_offsets_.back(), null_index);
+  edges_.reserve(in_offsets_.back());
+  out_edges_.reserve(in_offsets_.back());
+  out_offsets_.push_back(0);
+  for (index_t v = 0; v < vertices_.size(); ++v) {
+    for (const Edge &e : circ.get_all_out_edges(vertices_[v].vertex)) {
+      const index_t t = index_.at(circ.target(e));
+      const port_t t_port = circ.get_target_port(e);
+      const index_t e_index = edges_.size();
+      edges_.push_back(
+          {v, t, circ.get_source_port(e), t_port, circ.get_edgetype(e),
+           false});
+      out_edges_.push_back(e_index);
+      in_edges_[in_offsets_[t] + t_port] = e_index;
+    }
+    out_offsets_.push_back(out_edges_.size());
+  }
+  n_vertices_ = vertices_.size();
+  n_edges_ = edges_.size();
+}
+
+FlatDAG::index_t FlatDAG::get_index(const Vertex &vert) const {
+  std::unordered_map<Vertex, index_t>::const_iterator found =
+      index_.find(vert);
+  if (found == index_.end()) {
+    throw MissingVertex("Vertex not present in FlatDAG");
+  }
+  return found->second;
+}
+
+std::vector<FlatDAG::index_t> FlatDAG::topological_order() const {
+  std::vector<unsigned> n_waiting(vertices_.size(), 0);
+  std::vector<index_t> order;
+  order.reserve(n_vertices_);
+  for (index_t v = 0; v < vertices_.size(); ++v) {
+    if (vertices_[v].removed) continue;
+    n_waiting[v] = in_edges(v).size();
+    if (n_waiting[v] == 0) order.push_back(v);
+  }
+  // `order` doubles as the queue of ready vertices.
+  for (index_t i = 0; i < order.size(); ++i) {
+    for (index_t e : out_edges(order[i])) {
+      index_t t = edges_[e].target;
+      if (--n_waiting[t] == 0) order.push_back(t);
+    }
+  }
+  TKET_ASSERT(order.size() == n_vertices_);
+  return order;
+}
+
+void FlatDAG::remove_vertex(index_t v) {
+  VertexRecord &record = vertices_[v];
+  if (record.removed) {
+    throw CircuitInvalidity("Vertex has already been removed from FlatDAG");
+  }
+  OpType type = record.op->get_type();
+  if (is_boundary_type(type)) {
+    throw CircuitInvalidity("Cannot remove a boundary vertex from FlatDAG");
+  }
+  std::span<const index_t> ins = in_edges(v);
+  std::span<const index_t> outs = out_edges(v);
+  for (index_t e : ins) {
+    if (edges_[e].type == EdgeType::Boolean) {
+      throw CircuitInvalidity(
+          "Cannot remove a vertex with Boolean inputs from FlatDAG");
+    }
+  }
+  for (index_t e : outs) {
+    if (edges_[e].type == EdgeType::Boolean) {
+      throw CircuitInvalidity(
+          "Cannot remove a vertex with Boolean outputs from FlatDAG");
+    }
+  }
+  // Without Boolean edges the out-edges correspond one-to-one with the
+  // in-edges, port by port.
+  TKET_ASSERT(ins.size() == outs.size());
+  for (std::size_t p = 0; p < ins.size(); ++p) {
+    EdgeRecord &in_rec = edges_[ins[p]];
+    EdgeRecord &out_rec = edges_[outs[p]];
+    in_rec.target = out_rec.target;
+    in_rec.target_port = out_rec.target_port;
+    in_edges_[in_offsets_[out_rec.target] + out_rec.target_port] = ins[p];
+    out_rec.removed = true;
+    --n_edges_;
+  }
+  record.removed = true;
+  --n_vertices_;
+}
+
+std::vector<Vertex> FlatDAG::removed_vertices() const {
+  std::vector<Vertex> removed;
+  for (const VertexRecord &record : vertices_) {
+    if (record.removed) removed.push_back(record.vertex);
+  }
+  return removed;
+}
+
+std::vector<FlatDAG::index_t> FlatDAG::compact() {
+  std::vector<index_t> new_vertex(vertices_.size(), null_index);
+  std::vector<index_t> new_edge(edges_.size(), null_index);
+  std::vector<VertexRecord> vertices;
+  vertices.reserve(n_vertices_);
+  for (index_t v = 0; v < vertices_.size(); ++v) {
+    if (vertices_[v].removed) {
+      index_.erase(vertices_[v].vertex);
+    } else {
+      new_vertex[v] = vertices.size();
+      index_[vertices_[v].vertex] = vertices.size();
+      vertices.push_back(std::move(vertices_[v]));
+    }
+  }
+  std::vector<EdgeRecord> edges;
+  edges.reserve(n_edges_);
+  for (index_t e = 0; e < edges_.size(); ++e) {
+    if (edges_[e].removed) continue;
+    new_edge[e] = edges.size();
+    EdgeRecord record = edges_[e];
+    record.source = new_vertex[record.source];
+    record.target = new_vertex[record.target];
+    edges.push_back(record);
+  }
+  std::vector<index_t> in_offsets{0}, out_offsets{0};
+  std::vector<index_t> ins, outs;
+  in_offsets.reserve(n_vertices_ + 1);
+  out_offsets.reserve(n_vertices_ + 1);
+  ins.reserve(n_edges_);
+  outs.reserve(n_edges_);
+  for (index_t v = 0; v < new_vertex.size(); ++v) {
+    if (new_vertex[v] == null_index) continue;
+    for (index_t e : in_edges(v)) ins.push_back(new_edge[e]);
+    for (index_t e : out_edges(v)) outs.push_back(new_edge[e]);
+    in_offsets.push_back(ins.size());
+    out_offsets.push_back(outs.size());
+  }
+  vertices_ = std::move(vertices);
+  edges_ = std::move(edges);
+  in_offsets_ = std::move(in_offsets);
+  out_offsets_ = std::move(out_offsets);
+  in_edges_ = std::move(ins);
+  out_edges_ = std::move(outs);
+  return new_vertex;
+}
+
+}  // namespace tket
@@ -14,7 +14,10 @@
 
 #include "tket/Circuit/Multiplexor.hpp"
 
+#include <bit>
 #include <complex>
+#include <cstddef>
+#include <optional>
 
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Circuit/DiagonalBox.hpp"
@@ -63,22 +66,16 @@ static Circuit multiplexor_sequential_decomp(
 }
 
 /**
- * @brief Indicates whether a recursion step in recursive_demultiplex_rotation
- * is either a left child, a right child, or the root.
- *
- */
-enum class RecursionNodeType { Left = 0, Right = 1, Root = 2 };
-
-/**
- * @brief Implement multiplexed rotation gate (i.e.uniformly controlled
- * same-axis rotations (UCR)) with 2^ctrl_qubits SQ rotations, 2^ctrl_qubits
- * CXs, and 2 H gates for X-axis rotations.
+ * @brief Transform, in place, the angles of a multiplexed rotation gate (i.e.
+ * uniformly controlled same-axis rotations (UCR)) into the angles of the
+ * single-qubit rotations of its decomposition, in the order they are applied.
  *
  * https://arxiv.org/abs/quant-ph/0410066
  * This is a special case derived from equation (3)
  * A UCR gate controlled by n qubits have the decomposition UCR = CX P CX Q
  * (multiplication order), where P and Q are themselves UCR gates controlled by
- * n-1 qubits.
+ * n-1 qubits, with angles p = (a - b)/2 and q = (a + b)/2 for the two halves
+ * a and b of the angles of the UCR.
  *
  * Also notice that CX P CX Q = Q CX P CX, therefore we can control the
  * direction of each decomposition to avoid adding adjacent CX gates.
@@ -86,56 +83,66 @@ enum class RecursionNodeType { Left = 0, Right = 1, Root = 2 };
  * The two CX* can be cancelled,
  * hence UCR = CX P CX Q = (CX Q' CX P') CX (P''CX Q'')
  *
+ * Rather than recursing, each level of the recursion is one pass of
+ * butterflies over the whole vector: a block [a, b] becomes [q, p] if it is
+ * the first half of its parent block (or the whole vector), and [p, q] if it
+ * is the second half.
  *
  * @param angles list of 2^ctrl_qubits angles, angles[i] is the angle activated
  * by bitstring binary(i)
+ */
+template <typename T>
+static void demultiplex_rotation_angles(std::vector<T> &angles) {
+  const std::size_t n_rotations = angles.size();
+  for (std::size_t width = n_rotations; width > 1; width /= 2) {
+    const std::size_t mid = width / 2;
+    for (std::size_t start = 0; start < n_rotations; start += width) {
+      T *a = angles.data() + start;
+      T *b = a + mid;
+      if ((start / width) % 2 == 0) {
+        for (std::size_t i = 0; i < mid; i++) {
+          const T sum = a[i] + b[i];
+          b[i] = (a[i] - b[i]) / 2;
+          a[i] = sum / 2;
+        }
+      } else {
+        for (std::size_t i = 0; i < mid; i++) {
+          const T sum = a[i] + b[i];
+          a[i] = (a[i] - b[i]) / 2;
+          b[i] = sum / 2;
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief Implement multiplexed rotation gate with 2^ctrl_qubits SQ rotations
+ * and 2^ctrl_qubits CXs, given the angles of the rotations as computed by
+ * demultiplex_rotation_angles.
+ *
+ * The CX between rotations j and j+1 comes from the smallest block of the
+ * recursion containing both, so its control follows the Gray code: it is
+ * the qubit whose bit flips between j and j+1. The last CX comes from the
+ * root.
+ *
+ * @param angles rotation angles, in the order they are applied
  * @param axis can be either Ry or Rz
- * @param total_qubits the total number of qubits in the final output circuit
+ * @param n_controls number of control qubits; the target is the last qubit
  * @param circ circuit to update
- * @param node_type controls the decomposition of each demultiplex
- * step. Will be implemented as P CX Q if the step is a left child, and Q CX P
- * if the step is a right child. CX P CX Q will be implemented if the step is
- * the root.
- *
  */
-static void recursive_demultiplex_rotation(
-    const std::vector<Expr> &angles, const OpType &axis, unsigned total_qubits,
-    Circuit &circ, const RecursionNodeType &node_type) {
-  unsigned n_rotations = angles.size();
-  unsigned n_qubits = (unsigned)log2(n_rotations) + 1;
-  unsigned mid = (unsigned)(n_rotations / 2);
-  std::vector<Expr> p_angles;
-  std::vector<Expr> q_angles;
-  for (unsigned i = 0; i < mid; i++) {
-    p_angles.push_back((angles[i] - angles[mid + i]) / 2);
-    q_angles.push_back((angles[i] + angles[mid + i]) / 2);
-  }
-  // UCR = CX P CX Q = Q CX P CX
-  // the left recursion child implements P CX Q, and the
-  // right recursion child implements Q CX P to cancel the CXs
-  if (node_type == RecursionNodeType::Right) {
-    std::swap(p_angles, q_angles);
-  }
-  if (q_angles.size() == 1) {
-    // base step
-    circ.add_op<unsigned>(axis, q_angles[0], {total_qubits - 1});
-  } else {
-    recursive_demultiplex_rotation(
-        q_angles, axis, total_qubits, circ, RecursionNodeType::Left);
-  }
-  circ.add_op<unsigned>(
-      OpType::CX, {total_qubits - n_qubits, total_qubits - 1});
-  if (p_angles.size() == 1) {
-    // base step
-    circ.add_op<unsigned>(axis, p_angles[0], {total_qubits - 1});
-  } else {
-    recursive_demultiplex_rotation(
-        p_angles, axis, total_qubits, circ, RecursionNodeType::Right);
-  }
-  if (node_type == RecursionNodeType::Root) {
-    // for the root step, we implement UCR = CX P CX Q
-    circ.add_op<unsigned>(
-        OpType::CX, {total_qubits - n_qubits, total_qubits - 1});
+template <typename T>
+static void add_demultiplexed_rotations(
+    const std::vector<T> &angles, const OpType &axis, unsigned n_controls,
+    Circuit &circ) {
+  const std::size_t n_rotations = angles.size();
+  for (std::size_t j = 0; j < n_rotations; j++) {
+    circ.add_op<unsigned>(axis, angles[j], {n_controls});
+    const unsigned control =
+        (j + 1 == n_rotations)
+            ? 0
+            : n_controls - 1 - (unsigned)std::countr_zero(j + 1);
+    circ.add_op<unsigned>(OpType::CX, {control, n_controls});
   }
 }
 
@@ -556,18 +563,22 @@ void MultiplexedRotationBox::generate_circuit() const {
   if (n_controls_ == 0) {
     auto it = op_map_.begin();
     circ.add_op<unsigned>(it->second, {0});
-    circ_ = std::make_shared<Circuit>(circ);
+    circ_ = std::make_shared<Circuit>(std::move(circ));
     return;
   }
   unsigned long long n_rotations = 1ULL << n_controls_;
-  std::vector<Expr> rotations(n_rotations);
-  // convert op_map to a vector of 2^n_controls_ angles
-  for (unsigned long long i = 0; i < n_rotations; i++) {
-    auto it = op_map_.find(dec_to_bin(i, n_controls_));
-    if (it == op_map_.end()) {
-      rotations[i] = 0;
+  // convert op_map to a vector of 2^n_controls_ angles, numeric if possible
+  std::vector<Expr> rotations(n_rotations, 0);
+  std::vector<double> values(n_rotations, 0.);
+  bool numeric = true;
+  for (const auto &[bitstr, op] : op_map_) {
+    const unsigned long long i = bin_to_dec(bitstr);
+    rotations[i] = op->get_params()[0];
+    std::optional<double> x = eval_expr(rotations[i]);
+    if (x) {
+      values[i] = *x;
     } else {
-      rotations[i] = it->second->get_params()[0];
+      numeric = false;
     }
   }
   OpType axis = axis_;
@@ -575,12 +586,19 @@ void MultiplexedRotationBox::generate_circuit() const {
     circ.add_op<unsigned>(OpType::H, {n_controls_});
     axis = OpType::Rz;
   }
-  recursive_demultiplex_rotation(
-      rotations, axis, n_controls_ + 1, circ, RecursionNodeType::Root);
+  if (numeric) {
+    rotations.clear();
+    demultiplex_rotation_angles(values);
+    add_demultiplexed_rotations(values, axis, n_controls_, circ);
+  } else {
+    values.clear();
+    demultiplex_rotation_angles(rotations);
+    add_demultiplexed_rotations(rotations, axis, n_controls_, circ);
+  }
   if (axis_ == OpType::Rx) {
     circ.add_op<unsigned>(OpType::H, {n_controls_});
   }
-  circ_ = std::make_shared<Circuit>(circ);
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 MultiplexedU2Box::MultiplexedU2Box(const ctrl_op_map_t &op_map, bool impl_diag)
@@ -671,23 +689,20 @@ std::pair<Circuit, Eigen::VectorXcd> MultiplexedU2Box::decompose() const {
     return std::make_pair(circ, Eigen::VectorXcd::Constant(2, 1));
   }
   unsigned long long n_unitaries = 1ULL << n_controls_;
-  std::vector<Eigen::Matrix2cd> unitaries(n_unitaries);
+  std::vector<Eigen::Matrix2cd> unitaries(
+      n_unitaries, Eigen::Matrix2cd::Identity());
   // convert op_map to a vector of 2^n_controls_ unitaries
-  for (unsigned long long i = 0; i < n_unitaries; i++) {
-    auto it = op_map_.find(dec_to_bin(i, n_controls_));
-    if (it == op_map_.end()) {
-      unitaries[i] = Eigen::Matrix2cd::Identity();
+  for (const auto &[bitstr, op] : op_map_) {
+    const unsigned long long i = bin_to_dec(bitstr);
+    if (op->get_type() == OpType::Unitary1qBox) {
+      std::shared_ptr<const Unitary1qBox> u1box =
+          std::dynamic_pointer_cast<const Unitary1qBox>(op);
+      unitaries[i] = u1box->get_matrix();
     } else {
-      if (it->second->get_type() == OpType::Unitary1qBox) {
-        std::shared_ptr<const Unitary1qBox> u1box =
-            std::dynamic_pointer_cast<const Unitary1qBox>(it->second);
-        unitaries[i] = u1box->get_matrix();
-      } else {
-        if (!it->second->free_symbols().empty()) {
-          throw Unsupported("Can't decompose symbolic MultiplexedU2Box.");
-        }
-        unitaries[i] = GateUnitaryMatrix::get_unitary(*as_gate_ptr(it->second));
+      if (!op->free_symbols().empty()) {
+        throw Unsupported("Can't decompose symbolic MultiplexedU2Box.");
       }
+      unitaries[i] = GateUnitaryMatrix::get_unitary(*as_gate_ptr(op));
     }
   }
   // initialise the ucrz list
@@ -734,7 +749,7 @@ void MultiplexedU2Box::generate_circuit() const {
     std::iota(std::begin(args), std::end(args), 0);
     circ.add_box(DiagonalBox(diag_vec), args);
   }
-  circ_ = std::make_shared<Circuit>(circ);
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 MultiplexedTensoredU2Box::MultiplexedTensoredU2Box(
@@ -913,7 +928,7 @@ void MultiplexedTensoredU2Box::generate_circuit() const {
     circ.add_box(DiagonalBox(diag_vec), args);
   }
 
-  circ_ = std::make_shared<Circuit>(circ);
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 REGISTER_OPFACTORY(MultiplexorBox, MultiplexorBox)
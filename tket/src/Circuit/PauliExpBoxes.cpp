@@ -14,7 +14,10 @@
 
 #include "tket/Circuit/PauliExpBoxes.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
+#include <mutex>
 
 #include "tket/Circuit/CircUtils.hpp"
 #include "tket/Circuit/ConjugationBox.hpp"
@@ -24,6 +27,80 @@
 
 namespace tket {
 
+/**
+ * Boxes which differ only in their angles share the Clifford parts of their
+ * decompositions, so these are cached by Pauli strings and CX configuration
+ * and only the central rotations are rebuilt for each box.
+ */
+typedef std::pair<std::vector<DensePauliMap>, CXConfigType> SkeletonKey;
+
+constexpr std::size_t max_skeleton_cache_size = 4096;
+
+template <typename Skeleton, typename F>
+static Skeleton cached_skeleton(const SkeletonKey &key, F build) {
+  static std::mutex cache_mutex;
+  static std::map<SkeletonKey, Skeleton> cache;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto found = cache.find(key);
+    if (found != cache.end()) return found->second;
+  }
+  Skeleton skeleton = build();
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (cache.size() >= max_skeleton_cache_size) cache.clear();
+  cache.emplace(key, skeleton);
+  return skeleton;
+}
+
+/**
+ * Conjugating circuit for one or two rotations, with the rotation types and
+ * the (flattened) qubits they act on.
+ */
+struct RotationSkeleton {
+  Op_ptr compute;
+  qubit_vector_t qubits;
+  std::vector<std::pair<OpType, unsigned>> rotations;
+};
+
+static RotationSkeleton make_rotation_skeleton(
+    Circuit compute, const std::vector<std::pair<OpType, Qubit>> &rotations) {
+  RotationSkeleton skeleton;
+  skeleton.qubits = compute.all_qubits();
+  unit_map_t mapping = compute.flatten_registers();
+  for (const auto &[type, qb] : rotations) {
+    skeleton.rotations.push_back({type, Qubit(mapping.at(qb)).index()[0]});
+  }
+  skeleton.compute = std::make_shared<CircBox>(compute);
+  return skeleton;
+}
+
+static void add_rotation_skeleton(
+    Circuit &circ, const RotationSkeleton &skeleton,
+    const std::vector<Expr> &angles) {
+  Circuit action(skeleton.qubits.size());
+  for (unsigned i = 0; i < angles.size(); ++i) {
+    action.add_op<unsigned>(
+        skeleton.rotations[i].first, angles[i],
+        {skeleton.rotations[i].second});
+  }
+  ConjugationBox box(skeleton.compute, std::make_shared<CircBox>(action));
+  circ.add_box(box, skeleton.qubits);
+}
+
+static bool is_identity_string(const DensePauliMap &string) {
+  return std::all_of(
+      string.begin(), string.end(), [](Pauli p) { return p == Pauli::I; });
+}
+
+/**
+ * Mutual diagonalisation of a commuting set: the Clifford circuit and, for
+ * each gadget, its diagonal string and the sign picked up by its angle.
+ */
+struct CommutingSetSkeleton {
+  Op_ptr cliff;
+  std::vector<std::pair<QubitPauliMap, Expr>> diagonal;
+};
+
 PauliExpBox::PauliExpBox(
     const SymPauliTensor &paulis, CXConfigType cx_config_type)
     : Box(OpType::PauliExpBox,
@@ -64,8 +141,19 @@ void PauliExpBox::generate_circuit() const {
   // contain qubits with {X, Y, Z}; appending it to a blank circuit containing
   // all qubits makes the size of the circuit fixed
   Circuit circ(paulis_.size());
-  circ.append(pauli_gadget(paulis_, cx_config_));
-  circ_ = std::make_shared<Circuit>(circ);
+  if (is_identity_string(paulis_.string)) {
+    circ.add_phase(-paulis_.coeff / 2);
+  } else {
+    RotationSkeleton skeleton = cached_skeleton<RotationSkeleton>(
+        {{paulis_.string}, cx_config_}, [&]() {
+          std::pair<Circuit, Qubit> diag = reduce_pauli_to_z(
+              SpPauliStabiliser(paulis_.string), cx_config_);
+          return make_rotation_skeleton(
+              diag.first, {{OpType::Rz, diag.second}});
+        });
+    add_rotation_skeleton(circ, skeleton, {paulis_.coeff});
+  }
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 bool PauliExpBox::is_equal(const Op &op_other) const {
@@ -157,8 +245,30 @@ void PauliExpPairBox::generate_circuit() const {
   // appending it to a blank circuit containing all qubits makes the size of the
   // circuit fixed
   Circuit circ(paulis0_.size());
-  circ.append(pauli_gadget_pair(paulis0_, paulis1_, cx_config_));
-  circ_ = std::make_shared<Circuit>(circ);
+  if (is_identity_string(paulis0_.string) ||
+      is_identity_string(paulis1_.string)) {
+    circ.append(pauli_gadget_pair(paulis0_, paulis1_, cx_config_));
+    circ_ = std::make_shared<Circuit>(std::move(circ));
+    return;
+  }
+  RotationSkeleton skeleton = cached_skeleton<RotationSkeleton>(
+      {{paulis0_.string, paulis1_.string}, cx_config_}, [&]() {
+        SpPauliStabiliser stab0(paulis0_.string);
+        SpPauliStabiliser stab1(paulis1_.string);
+        if (stab0.commutes_with(stab1)) {
+          std::tuple<Circuit, Qubit, Qubit> diag =
+              reduce_commuting_paulis_to_zi_iz(stab0, stab1, cx_config_);
+          return make_rotation_skeleton(
+              std::get<0>(diag), {{OpType::Rz, std::get<1>(diag)},
+                                  {OpType::Rz, std::get<2>(diag)}});
+        }
+        std::pair<Circuit, Qubit> diag =
+            reduce_anticommuting_paulis_to_z_x(stab0, stab1, cx_config_);
+        return make_rotation_skeleton(
+            diag.first, {{OpType::Rz, diag.second}, {OpType::Rx, diag.second}});
+      });
+  add_rotation_skeleton(circ, skeleton, {paulis0_.coeff, paulis1_.coeff});
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 bool PauliExpPairBox::is_equal(const Op &op_other) const {
@@ -301,31 +411,47 @@ void PauliExpCommutingSetBox::generate_circuit() const {
   unsigned n_qubits = pauli_gadgets_[0].size();
   Circuit circ(n_qubits);
 
-  std::list<SpSymPauliTensor> gadgets;
+  // The diagonalisation does not depend on the angles, so it is computed with
+  // unit coefficients and the resulting signs are applied to each angle
+  std::vector<DensePauliMap> strings;
   for (const auto &pauli_gadget : pauli_gadgets_) {
-    gadgets.push_back((SpSymPauliTensor)pauli_gadget);
+    strings.push_back(pauli_gadget.string);
   }
-  std::set<Qubit> qubits;
-  for (unsigned i = 0; i < n_qubits; i++) qubits.insert(Qubit(i));
-
-  Circuit cliff_circ = mutual_diagonalise(gadgets, qubits, cx_config_);
+  CommutingSetSkeleton skeleton = cached_skeleton<CommutingSetSkeleton>(
+      {strings, cx_config_}, [&]() {
+        std::list<SpSymPauliTensor> gadgets;
+        for (const DensePauliMap &string : strings) {
+          gadgets.push_back(SpSymPauliTensor(string, 1));
+        }
+        std::set<Qubit> qubits;
+        for (unsigned i = 0; i < n_qubits; i++) qubits.insert(Qubit(i));
+        Circuit cliff_circ = mutual_diagonalise(gadgets, qubits, cx_config_);
+        CommutingSetSkeleton result;
+        result.cliff = std::make_shared<CircBox>(cliff_circ);
+        for (const SpSymPauliTensor &pgp : gadgets) {
+          result.diagonal.push_back({pgp.string, pgp.coeff});
+        }
+        return result;
+      });
 
   Circuit phase_poly_circ(n_qubits);
 
-  for (const SpSymPauliTensor &pgp : gadgets) {
-    phase_poly_circ.append(pauli_gadget(pgp, CXConfigType::Snake));
+  for (unsigned i = 0; i < pauli_gadgets_.size(); ++i) {
+    const auto &[string, sign] = skeleton.diagonal[i];
+    phase_poly_circ.append(pauli_gadget(
+        SpSymPauliTensor(string, sign * pauli_gadgets_[i].coeff),
+        CXConfigType::Snake));
   }
   phase_poly_circ.decompose_boxes_recursively();
   PhasePolyBox ppbox(phase_poly_circ);
   Circuit after_synth_circ = *ppbox.to_circuit();
 
   ConjugationBox box(
-      std::make_shared<CircBox>(cliff_circ),
-      std::make_shared<CircBox>(after_synth_circ));
+      skeleton.cliff, std::make_shared<CircBox>(after_synth_circ));
 
   circ.add_box(box, circ.all_qubits());
 
-  circ_ = std::make_shared<Circuit>(circ);
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 bool PauliExpCommutingSetBox::is_equal(const Op &op_other) const {
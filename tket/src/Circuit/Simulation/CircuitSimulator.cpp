@@ -15,10 +15,15 @@
 #include "tket/Circuit/Simulation/CircuitSimulator.hpp"
 
 #include <sstream>
+#include <stdexcept>
+#include <tkrng/RNG.hpp>
+#include <utility>
 
 #include "DecomposeCircuit.hpp"
 #include "GateNodesBuffer.hpp"
+#include "ThreadPool.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/SymbolBinding.hpp"
 #include "tket/Gate/GateUnitaryMatrixError.hpp"
 #include "tket/Utils/Expression.hpp"
 
@@ -53,7 +58,7 @@ static void apply_unitary_may_throw(
   }
   internal::GateNodesBuffer buffer(matr, abs_epsilon);
   internal::decompose_circuit(circ, buffer, abs_epsilon);
-  matr = apply_qubit_permutation(matr, circ.implicit_qubit_permutation());
+  apply_qubit_permutation_in_place(matr, circ.implicit_qubit_permutation());
 }
 
 void apply_unitary(
@@ -79,7 +84,7 @@ void apply_unitary(
   }
 }
 
-Eigen::VectorXcd get_statevector(
+Eigen::MatrixXcd get_statevector_column(
     const Circuit& circ, double abs_epsilon, unsigned max_number_of_qubits) {
   Eigen::MatrixXcd result =
       Eigen::MatrixXcd::Zero(get_matrix_size(circ.n_qubits()), 1);
@@ -88,5 +93,143 @@ Eigen::VectorXcd get_statevector(
   return result;
 }
 
+Eigen::VectorXcd get_statevector(
+    const Circuit& circ, double abs_epsilon, unsigned max_number_of_qubits) {
+  return get_statevector_column(circ, abs_epsilon, max_number_of_qubits);
+}
+
+// The commands of the circuit before the first which depends on a symbol,
+// and the rest with the phase. Neither part has an implicit qubit
+// permutation.
+static std::pair<Circuit, Circuit> split_at_first_symbolic_command(
+    const Circuit& circ) {
+  Circuit prefix;
+  Circuit rest;
+  for (Circuit* part : {&prefix, &rest}) {
+    for (const Qubit& qb : circ.all_qubits()) part->add_qubit(qb);
+    for (const Bit& b : circ.all_bits()) part->add_bit(b);
+  }
+  bool symbolic = false;
+  for (const Command& cmd : circ) {
+    const Op_ptr op = cmd.get_op_ptr();
+    const OpType type = op->get_type();
+    // Ignored by the simulator, and cannot be added with add_op.
+    if (type == OpType::noop || type == OpType::Barrier) continue;
+    symbolic = symbolic || op->is_symbolic();
+    (symbolic ? rest : prefix).add_op(op, cmd.get_args());
+  }
+  rest.add_phase(circ.get_phase());
+  return {std::move(prefix), std::move(rest)};
+}
+
+// Apply the circuit to matr at each point of values, writing the results
+// with the given function.
+template <typename F>
+static void apply_at_points(
+    const Circuit& circ, const std::vector<Sym>& symbols,
+    const Eigen::MatrixXd& values, Eigen::MatrixXcd matr, double abs_epsilon,
+    unsigned max_number_of_qubits, F write_result) {
+  if (values.cols() != Eigen::Index(symbols.size())) {
+    throw std::invalid_argument(
+        "Expected " + std::to_string(symbols.size()) +
+        " values for each point but got " + std::to_string(values.cols()));
+  }
+  auto [prefix, rest] = split_at_first_symbolic_command(circ);
+  const SymbolBindingPlan plan(rest, symbols);
+  apply_unitary(prefix, matr, abs_epsilon, max_number_of_qubits);
+  const qubit_map_t permutation = circ.implicit_qubit_permutation();
+  std::vector<double> point(symbols.size());
+  for (Eigen::Index k = 0; k < values.rows(); ++k) {
+    for (std::size_t i = 0; i < point.size(); ++i) point[i] = values(k, i);
+    Eigen::MatrixXcd result = matr;
+    apply_unitary(plan.bind(point), result, abs_epsilon, max_number_of_qubits);
+    apply_qubit_permutation_in_place(result, permutation);
+    write_result(k, std::move(result));
+  }
+}
+
+Eigen::MatrixXcd get_statevectors(
+    const Circuit& circ, const std::vector<Sym>& symbols,
+    const Eigen::MatrixXd& values, double abs_epsilon,
+    unsigned max_number_of_qubits) {
+  const auto size = get_matrix_size(circ.n_qubits());
+  Eigen::MatrixXcd initial = Eigen::MatrixXcd::Zero(size, 1);
+  initial(0, 0) = 1.0;
+  Eigen::MatrixXcd states(size, values.rows());
+  apply_at_points(
+      circ, symbols, values, std::move(initial), abs_epsilon,
+      max_number_of_qubits, [&](Eigen::Index k, Eigen::MatrixXcd&& state) {
+        states.col(k) = state.col(0);
+      });
+  return states;
+}
+
+std::vector<Eigen::MatrixXcd> get_unitaries(
+    const Circuit& circ, const std::vector<Sym>& symbols,
+    const Eigen::MatrixXd& values, double abs_epsilon,
+    unsigned max_number_of_qubits) {
+  const auto size = get_matrix_size(circ.n_qubits());
+  std::vector<Eigen::MatrixXcd> unitaries(values.rows());
+  apply_at_points(
+      circ, symbols, values, Eigen::MatrixXcd::Identity(size, size),
+      abs_epsilon, max_number_of_qubits,
+      [&](Eigen::Index k, Eigen::MatrixXcd&& u) {
+        unitaries[k] = std::move(u);
+      });
+  return unitaries;
+}
+
+bool compare_on_random_states(
+    const Circuit& circ1, const Circuit& circ2, PhaseEquivalence equivalence,
+    double tolerance, unsigned number_of_states, std::size_t seed,
+    unsigned max_number_of_qubits) {
+  if (circ1.all_qubits() != circ2.all_qubits()) return false;
+  const auto size = get_matrix_size(circ1.n_qubits());
+  Eigen::MatrixXcd states(size, number_of_states);
+  RNG rng;
+  rng.set_seed(seed);
+  // Entries with real and imaginary parts uniform in [-1, 1]; that is
+  // plenty random enough to tell circuits apart.
+  const std::size_t max_value = 1 << 20;
+  for (Eigen::Index c = 0; c < states.cols(); ++c) {
+    for (Eigen::Index r = 0; r < states.rows(); ++r) {
+      const double re = 2. * rng.get_size_t(max_value) / max_value - 1.;
+      const double im = 2. * rng.get_size_t(max_value) / max_value - 1.;
+      states(r, c) = {re, im};
+    }
+    states.col(c).normalize();
+  }
+  Eigen::MatrixXcd outputs1 = states;
+  apply_unitary(circ1, outputs1, EPS, max_number_of_qubits);
+  apply_unitary(circ2, states, EPS, max_number_of_qubits);
+  const Eigen::MatrixXcd& outputs2 = states;
+
+  if (equivalence == PhaseEquivalence::UpToGlobalPhase) {
+    // The best common phase is that of the sum of the inner products.
+    const std::complex<double> overlap =
+        (outputs2.adjoint() * outputs1).trace();
+    if (std::abs(overlap) < EPS) return false;
+    const std::complex<double> phase = overlap / std::abs(overlap);
+    for (Eigen::Index c = 0; c < outputs1.cols(); ++c) {
+      if ((outputs1.col(c) - phase * outputs2.col(c)).norm() > tolerance) {
+        return false;
+      }
+    }
+    return true;
+  }
+  for (Eigen::Index c = 0; c < outputs1.cols(); ++c) {
+    if ((outputs1.col(c) - outputs2.col(c)).norm() > tolerance) return false;
+  }
+  return true;
+}
+
+void set_number_of_threads(unsigned number_of_threads) {
+  internal::ThreadPool::get().set_number_of_threads(number_of_threads);
+}
+
+unsigned get_number_of_threads() {
+  return internal::ThreadPool::get().get_number_of_threads();
+}
+
 }  // namespace tket_sim
 }  // namespace tket
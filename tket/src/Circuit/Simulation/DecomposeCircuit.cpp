@@ -14,12 +14,17 @@
 
 #include "DecomposeCircuit.hpp"
 
+#include <map>
+#include <numeric>
+#include <optional>
 #include <sstream>
 #include <tkassert/Assert.hpp>
+#include <tuple>
 
 #include "GateNodesBuffer.hpp"
 #include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/ConjugationBox.hpp"
 #include "tket/Circuit/PauliExpBoxes.hpp"
 #include "tket/Circuit/Simulation/PauliExpBoxUnitaryCalculator.hpp"
 #include "tket/Gate/Gate.hpp"
@@ -47,22 +52,107 @@ static QMap get_qmap_no_checks(
   return qmap;
 }
 
-// Already known to be a box, with a nonempty Op ptr.
-// If possible (if the op is able to calculate its own unitary matrix),
-// fill the node triplets with the raw unitary matrix represented by this box.
-// Return true if it found the triplets.
-static bool fill_triplets_directly_from_box(
-    GateNode& node, const std::shared_ptr<const Box>& box_ptr,
-    double abs_epsilon) {
-  std::optional<Eigen::MatrixXcd> u = box_ptr->get_box_unitary();
-  if (!u.has_value()) {
-    return false;
+namespace {
+// Nodes recorded rather than simulated, to be pushed (possibly inverted)
+// later. The qubit indices are those of the recorded op, i.e. [0,1,2,...].
+struct NodeRecord {
+  std::vector<GateNode> nodes;
+  double phase = 0.;
+
+  void push(const GateNode& node) { nodes.push_back(node); }
+  void add_global_phase(double p) { phase += p; }
+};
+
+// Unitaries already calculated in this simulation, so that repeated gates
+// and boxes (e.g. the layers of a Trotterised circuit) are only
+// calculated once.
+class UnitaryCache {
+ public:
+  explicit UnitaryCache(double abs_epsilon) : abs_epsilon_(abs_epsilon) {}
+
+  // The triplets of a gate.
+  const std::vector<TripletCd>& get_gate_triplets(const Gate& gate);
+
+  // If possible (if the op is able to calculate its own unitary matrix),
+  // the triplets of the raw unitary matrix represented by this box;
+  // otherwise null.
+  const std::vector<TripletCd>* get_box_triplets(
+      const std::shared_ptr<const Box>& box_ptr);
+
+ private:
+  typedef std::tuple<OpType, unsigned, std::vector<double>> GateKey;
+  typedef std::optional<std::vector<TripletCd>> BoxEntry;
+
+  const double abs_epsilon_;
+  std::map<GateKey, std::vector<TripletCd>> gates_;
+  // Boxes are looked up first by id (the same box used repeatedly), then
+  // by their serialisation without the id (distinct but equal boxes).
+  std::map<boost::uuids::uuid, BoxEntry*> boxes_by_id_;
+  std::map<std::string, BoxEntry> boxes_by_json_;
+  // For symbolic gates, which are not cached (calculating their unitary
+  // throws).
+  std::vector<TripletCd> uncached_;
+
+ public:
+  // Decompositions of the compute ops of ConjugationBoxes, used both to
+  // compute and (inverted) to uncompute. Holding the ops keeps the keys
+  // unique.
+  std::map<Op_ptr, NodeRecord> compute_plans;
+};
+
+const std::vector<TripletCd>& UnitaryCache::get_gate_triplets(
+    const Gate& gate) {
+  GateKey key{gate.get_type(), gate.n_qubits(), {}};
+  for (const Expr& e : gate.get_params()) {
+    const std::optional<double> x = eval_expr(e);
+    if (!x) {
+      uncached_ = GateUnitaryMatrix::get_unitary_triplets(gate, abs_epsilon_);
+      return uncached_;
+    }
+    std::get<2>(key).push_back(*x);
+  }
+  auto found = gates_.find(key);
+  if (found == gates_.end()) {
+    found = gates_
+                .emplace(
+                    std::move(key), GateUnitaryMatrix::get_unitary_triplets(
+                                        gate, abs_epsilon_))
+                .first;
   }
-  node.triplets = tket::get_triplets(*u, abs_epsilon);
-  return true;
+  return found->second;
 }
 
-static void add_global_phase(const Circuit& circ, GateNodesBuffer& buffer) {
+const std::vector<TripletCd>* UnitaryCache::get_box_triplets(
+    const std::shared_ptr<const Box>& box_ptr) {
+  const auto found_id = boxes_by_id_.find(box_ptr->get_id());
+  if (found_id != boxes_by_id_.end()) {
+    const BoxEntry& entry = *found_id->second;
+    return entry ? &*entry : nullptr;
+  }
+  // Boxes that cannot be serialised are cached by id only, under a key
+  // that no serialisation can produce.
+  std::string json_key = boost::uuids::to_string(box_ptr->get_id());
+  try {
+    nlohmann::json j = box_ptr->serialize();
+    j["box"].erase("id");
+    json_key = j.dump();
+  } catch (const JsonError&) {
+  }
+  auto found_json = boxes_by_json_.find(json_key);
+  if (found_json == boxes_by_json_.end()) {
+    BoxEntry entry;
+    std::optional<Eigen::MatrixXcd> u = box_ptr->get_box_unitary();
+    if (u.has_value()) entry = tket::get_triplets(*u, abs_epsilon_);
+    found_json = boxes_by_json_.emplace(json_key, std::move(entry)).first;
+  }
+  boxes_by_id_[box_ptr->get_id()] = &found_json->second;
+  const BoxEntry& entry = found_json->second;
+  return entry ? &*entry : nullptr;
+}
+}  // namespace
+
+template <class Sink>
+static void add_global_phase(const Circuit& circ, Sink& buffer) {
   const auto global_phase = eval_expr(circ.get_phase());
   if (!global_phase) {
     throw SymbolsNotSupported("Circuit has symbolic global phase");
@@ -90,10 +180,89 @@ static void fill_qubit_indices(
   }
 }
 
+static GateNode dagger_node(const GateNode& node) {
+  GateNode dagger;
+  dagger.qubit_indices = node.qubit_indices;
+  if (node.structure) {
+    // Each kind of structure is inverted by inverting its 2x2 unitary.
+    dagger.structure =
+        GateUnitaryStructure{node.structure->kind, node.structure->u.adjoint()};
+  }
+  dagger.triplets.reserve(node.triplets.size());
+  for (const TripletCd& t : node.triplets) {
+    dagger.triplets.emplace_back(t.col(), t.row(), std::conj(t.value()));
+  }
+  return dagger;
+}
+
+// Push recorded nodes, or their inverse, onto the given qubits.
+template <class Sink>
+static void push_record(
+    const NodeRecord& record, const std::vector<unsigned>& qubit_indices,
+    bool inverse, Sink& buffer) {
+  auto push_node = [&](GateNode node) {
+    for (unsigned& q : node.qubit_indices) q = qubit_indices[q];
+    buffer.push(node);
+  };
+  if (inverse) {
+    for (auto it = record.nodes.rbegin(); it != record.nodes.rend(); ++it) {
+      push_node(dagger_node(*it));
+    }
+    buffer.add_global_phase(-record.phase);
+  } else {
+    for (const GateNode& node : record.nodes) push_node(node);
+    buffer.add_global_phase(record.phase);
+  }
+}
+
+template <class Sink>
+static void decompose_circuit_recursive(
+    const Circuit& circ, Sink& buffer,
+    const std::vector<unsigned>& parent_circuit_qubit_indices,
+    UnitaryCache& cache);
+
+static Circuit op_circuit(const Op_ptr& op) {
+  Circuit circ(op->get_signature().size());
+  std::vector<unsigned> args(circ.n_qubits());
+  std::iota(args.begin(), args.end(), 0);
+  circ.add_op<unsigned>(op, args);
+  return circ;
+}
+
+// Simulate compute, action and uncompute directly, without building the
+// circuit of the box. The compute op is decomposed once and, unless an
+// uncompute op is given, inverted node by node to uncompute.
+template <class Sink>
+static void decompose_conjugation(
+    const ConjugationBox& box, Sink& buffer,
+    const std::vector<unsigned>& qubit_indices, UnitaryCache& cache) {
+  const Op_ptr compute = box.get_compute();
+  auto found = cache.compute_plans.find(compute);
+  if (found == cache.compute_plans.end()) {
+    NodeRecord record;
+    std::vector<unsigned> iota(qubit_indices.size());
+    std::iota(iota.begin(), iota.end(), 0);
+    decompose_circuit_recursive(op_circuit(compute), record, iota, cache);
+    found = cache.compute_plans.emplace(compute, std::move(record)).first;
+  }
+  const NodeRecord& compute_record = found->second;
+  push_record(compute_record, qubit_indices, false, buffer);
+  decompose_circuit_recursive(
+      op_circuit(box.get_action()), buffer, qubit_indices, cache);
+  const std::optional<Op_ptr> uncompute = box.get_uncompute();
+  if (uncompute) {
+    decompose_circuit_recursive(
+        op_circuit(*uncompute), buffer, qubit_indices, cache);
+  } else {
+    push_record(compute_record, qubit_indices, true, buffer);
+  }
+}
+
+template <class Sink>
 static void decompose_circuit_recursive(
-    const Circuit& circ, GateNodesBuffer& buffer,
+    const Circuit& circ, Sink& buffer,
     const std::vector<unsigned>& parent_circuit_qubit_indices,
-    double abs_epsilon) {
+    UnitaryCache& cache) {
   const auto qmap = get_qmap_no_checks(circ, parent_circuit_qubit_indices);
   unit_vector_t args;
   GateNode node;
@@ -117,8 +286,12 @@ static void decompose_circuit_recursive(
     if (desc.is_gate()) {
       const Gate* gate = dynamic_cast<const Gate*>(current_op.get());
       TKET_ASSERT(gate);
-      node.triplets =
-          GateUnitaryMatrix::get_unitary_triplets(*gate, abs_epsilon);
+      node.structure = GateUnitaryMatrix::get_unitary_structure(*gate);
+      if (node.structure) {
+        node.triplets.clear();
+      } else {
+        node.triplets = cache.get_gate_triplets(*gate);
+      }
       buffer.push(node);
       continue;
     }
@@ -130,16 +303,21 @@ static void decompose_circuit_recursive(
         std::dynamic_pointer_cast<const Box>(current_op);
     TKET_ASSERT(box_ptr.get());
 
-    node.triplets.clear();
-    const bool found_unitary =
-        fill_triplets_directly_from_box(node, box_ptr, abs_epsilon);
-
-    if (!node.triplets.empty()) {
-      TKET_ASSERT(found_unitary);
+    if (current_type == OpType::ConjugationBox) {
+      decompose_conjugation(
+          static_cast<const ConjugationBox&>(*box_ptr), buffer,
+          node.qubit_indices, cache);
+      continue;
+    }
+    const std::vector<TripletCd>* box_triplets =
+        cache.get_box_triplets(box_ptr);
+    if (box_triplets) {
+      TKET_ASSERT(!box_triplets->empty());
+      node.triplets = *box_triplets;
+      node.structure.reset();
       buffer.push(node);
       continue;
     }
-    TKET_ASSERT(!found_unitary);
     // Break this box down, recursively.
     std::shared_ptr<Circuit> box_circ = box_ptr->to_circuit();
     if (!box_circ.get()) {
@@ -148,8 +326,7 @@ static void decompose_circuit_recursive(
           "This is a box, which couldn't be "
           "broken down into a circuit");
     }
-    decompose_circuit_recursive(
-        *box_circ, buffer, node.qubit_indices, abs_epsilon);
+    decompose_circuit_recursive(*box_circ, buffer, node.qubit_indices, cache);
   }
   add_global_phase(circ, buffer);
 }
@@ -160,7 +337,8 @@ void decompose_circuit(
   std::vector<unsigned> iota(circ.n_qubits());
   std::iota(iota.begin(), iota.end(), 0);
 
-  decompose_circuit_recursive(circ, buffer, iota, abs_epsilon);
+  UnitaryCache cache(abs_epsilon);
+  decompose_circuit_recursive(circ, buffer, iota, cache);
   buffer.flush();
 }
 
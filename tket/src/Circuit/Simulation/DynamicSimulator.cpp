@@ -0,0 +1,225 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/Simulation/DynamicSimulator.hpp"
+
+#include <map>
+#include <tkrng/RNG.hpp>
+
+#include "GateNode.hpp"
+#include "Trajectory.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Conditional.hpp"
+#include "tket/Gate/Gate.hpp"
+#include "tket/Gate/GateUnitaryMatrix.hpp"
+#include "tket/Gate/GateUnitaryMatrixError.hpp"
+#include "tket/OpType/OpTypeFunctions.hpp"
+#include "tket/Ops/ClassicalOps.hpp"
+
+namespace tket {
+namespace tket_sim {
+
+namespace {
+
+// A command of the circuit, with units replaced by their indices and gate
+// unitaries precomputed; or a run of consecutive classical commands.
+struct DynamicInstruction {
+  OpType type;
+  // For gates: the unitary, acting on node.qubit_indices.
+  internal::GateNode node;
+  // For Measure: the target bit.
+  unsigned bit = 0;
+  std::vector<unsigned> condition_bits;
+  unsigned condition_value = 0;
+  // For classical commands: a circuit on all the bits.
+  Circuit classical;
+};
+
+bool is_classical_command(const Op_ptr& op) {
+  if (op->get_type() == OpType::Conditional) {
+    return is_classical_type(
+        static_cast<const Conditional&>(*op).get_op()->get_type());
+  }
+  return is_classical_type(op->get_type());
+}
+
+DynamicInstruction make_instruction(
+    const Op_ptr& op, const unit_vector_t& args,
+    const std::map<UnitID, unsigned>& indices) {
+  DynamicInstruction instr;
+  instr.type = op->get_type();
+  if (instr.type == OpType::Conditional) {
+    const Conditional& cond = static_cast<const Conditional&>(*op);
+    const unsigned width = cond.get_width();
+    const unit_vector_t inner_args(args.begin() + width, args.end());
+    instr = make_instruction(cond.get_op(), inner_args, indices);
+    if (!instr.condition_bits.empty()) {
+      throw Unsupported("Nested conditionals are not supported");
+    }
+    for (unsigned i = 0; i < width; ++i) {
+      instr.condition_bits.push_back(indices.at(args[i]));
+    }
+    instr.condition_value = cond.get_value();
+    return instr;
+  }
+  const op_signature_t sig = op->get_signature();
+  for (unsigned i = 0; i < args.size(); ++i) {
+    if (sig[i] == EdgeType::Quantum) {
+      instr.node.qubit_indices.push_back(indices.at(args[i]));
+    } else {
+      instr.bit = indices.at(args[i]);
+    }
+  }
+  switch (instr.type) {
+    case OpType::Measure:
+    case OpType::Reset:
+    case OpType::Barrier: {
+      return instr;
+    }
+    default: {
+    }
+  }
+  if (!op->get_desc().is_gate()) {
+    throw Unsupported(
+        "Cannot simulate " + op->get_name() + " with dynamic simulation");
+  }
+  try {
+    const Gate& gate = static_cast<const Gate&>(*op);
+    instr.node.structure = GateUnitaryMatrix::get_unitary_structure(gate);
+    if (!instr.node.structure) {
+      instr.node.triplets = GateUnitaryMatrix::get_unitary_triplets(gate);
+    }
+  } catch (const GateUnitaryMatrixError& e) {
+    throw Unsupported(
+        "Cannot simulate " + op->get_name() + ": " + std::string(e.what()));
+  }
+  return instr;
+}
+
+// Until the first of these, the state and the bits are the same in every
+// shot.
+bool is_random(const DynamicInstruction& instr) {
+  return instr.type == OpType::Measure || instr.type == OpType::Reset;
+}
+
+void run_instruction(
+    const DynamicInstruction& instr, const bit_vector_t& all_bits,
+    internal::Trajectory& trajectory, std::vector<bool>& bits, RNG& rng) {
+  for (unsigned i = 0; i < instr.condition_bits.size(); ++i) {
+    if (bits[instr.condition_bits[i]] !=
+        bool((instr.condition_value >> i) & 1)) {
+      return;
+    }
+  }
+  const std::vector<unsigned>& qubits = instr.node.qubit_indices;
+  switch (instr.type) {
+    case OpType::Measure: {
+      bits[instr.bit] = trajectory.measure(qubits.at(0), rng);
+      return;
+    }
+    case OpType::Reset: {
+      trajectory.reset(qubits.at(0), rng);
+      return;
+    }
+    case OpType::Barrier: {
+      return;
+    }
+    case OpType::ClassicalTransform: {
+      std::map<Bit, bool> values;
+      for (unsigned i = 0; i < all_bits.size(); ++i) {
+        values[all_bits[i]] = bits[i];
+      }
+      values = instr.classical.classical_eval(values);
+      for (unsigned i = 0; i < all_bits.size(); ++i) {
+        bits[i] = values.at(all_bits[i]);
+      }
+      return;
+    }
+    default: {
+    }
+  }
+  // Global phases do not affect the outcomes.
+  if (!qubits.empty()) trajectory.apply(instr.node);
+}
+
+}  // namespace
+
+std::vector<std::vector<bool>> sample_dynamic_circuit(
+    const Circuit& circ, unsigned n_shots, std::size_t seed,
+    unsigned max_number_of_qubits) {
+  if (circ.n_qubits() > max_number_of_qubits) {
+    throw Unsupported("Circuit to simulate has too many qubits");
+  }
+  Circuit flat = circ;
+  flat.decompose_boxes_recursively();
+  std::map<UnitID, unsigned> indices;
+  const qubit_vector_t qubits = flat.all_qubits();
+  const bit_vector_t bits = flat.all_bits();
+  for (unsigned i = 0; i < qubits.size(); ++i) indices[qubits[i]] = i;
+  for (unsigned i = 0; i < bits.size(); ++i) indices[bits[i]] = i;
+
+  // Runs of classical commands are collected into a single instruction of
+  // type ClassicalTransform.
+  std::vector<DynamicInstruction> instructions;
+  for (const Command& com : flat) {
+    const Op_ptr op = com.get_op_ptr();
+    if (!is_classical_command(op)) {
+      instructions.push_back(make_instruction(op, com.get_args(), indices));
+      continue;
+    }
+    const Op_ptr inner = (op->get_type() == OpType::Conditional)
+                             ? static_cast<const Conditional&>(*op).get_op()
+                             : op;
+    if (!std::dynamic_pointer_cast<const ClassicalEvalOp>(inner)) {
+      throw Unsupported(
+          "Cannot simulate " + inner->get_name() + " with dynamic simulation");
+    }
+    if (instructions.empty() ||
+        instructions.back().type != OpType::ClassicalTransform) {
+      DynamicInstruction instr;
+      instr.type = OpType::ClassicalTransform;
+      for (const Bit& b : bits) instr.classical.add_bit(b);
+      instructions.push_back(std::move(instr));
+    }
+    instructions.back().classical.add_op<UnitID>(op, com.get_args());
+  }
+
+  RNG rng;
+  rng.set_seed(seed);
+  // The shared part of every shot.
+  internal::Trajectory initial(qubits.size());
+  std::vector<bool> initial_bits(bits.size(), false);
+  std::size_t n_shared = 0;
+  while (n_shared < instructions.size() &&
+         !is_random(instructions[n_shared])) {
+    run_instruction(
+        instructions[n_shared], bits, initial, initial_bits, rng);
+    ++n_shared;
+  }
+
+  std::vector<std::vector<bool>> results;
+  results.reserve(n_shots);
+  for (unsigned shot = 0; shot < n_shots; ++shot) {
+    internal::Trajectory trajectory = initial;
+    std::vector<bool> shot_bits = initial_bits;
+    for (std::size_t i = n_shared; i < instructions.size(); ++i) {
+      run_instruction(instructions[i], bits, trajectory, shot_bits, rng);
+    }
+    results.push_back(std::move(shot_bits));
+  }
+  return results;
+}
+
+}  // namespace tket_sim
+}  // namespace tket
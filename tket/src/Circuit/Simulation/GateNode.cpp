@@ -14,9 +14,13 @@
 
 #include "GateNode.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <functional>
 #include <tkassert/Assert.hpp>
 
 #include "BitOperations.hpp"
+#include "ThreadPool.hpp"
 
 /*
 The following is intended to be helpful, but there are no guarantees
@@ -134,6 +138,15 @@ for n=8, with 560 gates, the full unitary M is found in <1 second.
 A single statevector for n=16, with 1120 gates, is found in ~3 seconds.
 This is without any really fancy, clever optimisation.
 
+IN PLACE: we never need to build M. For each setting of the free bits
+(those not in positions [q0, q1, ...]) the 2^k entries x of the matrix column
+with g(x) = 0, 1, ..., 2^k - 1 are mixed together by U exactly as a length
+2^k vector would be, and no other entries are involved. So we gather those
+entries, multiply by U (using only its nonzero entries) and scatter them back:
+O(2^{n-k}.s.4^k) = O(s.2^{n+k}) work per column but only O(2^k) extra memory,
+which makes statevectors on 25+ qubits feasible. For k = 1 the entries come in
+pairs a fixed stride apart, and we loop over them directly.
+
 */
 
 namespace tket {
@@ -205,73 +218,300 @@ void LiftedBitsResult::set(
 }
 }  // namespace
 
-static void set_lifted_triplets(
-    const std::vector<TripletCd>& triplets, LiftedBitsResult& lifted_bits,
-    std::vector<TripletCd>& lifted_triplets, ExpansionData& expansion_data,
-    const std::vector<unsigned>& qubits, unsigned full_number_of_qubits) {
-  // translated_bits[j] gives the bits within the length n binary string,
-  // which correspond to the length k binary representation of j,
-  // but permuted and moved around so as to fit in the "slots" for qubits
-  // [q0, q1, q2,...].
-  // Since U is unitary of size 2^k, no column or row can be all zeros,
-  // so every index j will be needed at least once.
-  // Hence, it is not a waste of time to compute all,
-  // even if U is very sparse.
-  lifted_bits.set(qubits, full_number_of_qubits);
-  lifted_triplets.clear();
-
-  expansion_data = get_expansion_data(
-      lifted_bits.translated_bits_mask, full_number_of_qubits);
+namespace {
+// Contains data potentially of size roughly 2^k, for a gate acting on k
+// qubits, to avoid expensive memory reallocation. Each thread calling into
+// the simulator has its own; pool tasks only read the caller's.
+struct WorkData {
+  LiftedBitsResult lifted_bits;
+  ExpansionData expansion_data;
+
+  static WorkData& get_work_data();
+};
+
+WorkData& WorkData::get_work_data() {
+  thread_local WorkData data;
+  return data;
+}
+}  // namespace
+
+// Complex multiplication without the IEEE special-case handling of
+// std::complex (which calls into the runtime library), so that the loops
+// below can be vectorised by the compiler. Entries of unitaries and
+// statevectors are always finite.
+static inline std::complex<double> mul(
+    const std::complex<double>& a, const std::complex<double>& b) {
+  return {
+      a.real() * b.real() - a.imag() * b.imag(),
+      a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// Kernels are split into tasks of at least this many matrix entries,
+// so that small gates on small matrices do not pay for synchronisation.
+static constexpr std::size_t MIN_ENTRIES_PER_TASK = std::size_t(1) << 14;
+
+// Split [0, size) into consecutive ranges, one per task, and run them on the
+// thread pool. The ranges write to disjoint rows, so the result is the same
+// however they are scheduled.
+static void run_in_ranges(
+    SimUInt size, std::size_t entries_per_element,
+    const std::function<void(SimUInt, SimUInt)>& kernel) {
+  ThreadPool& pool = ThreadPool::get();
+  const std::size_t max_tasks = std::max<std::size_t>(
+      size * entries_per_element / MIN_ENTRIES_PER_TASK, 1);
+  const std::size_t number_of_tasks = std::min<std::size_t>(
+      {max_tasks, pool.get_number_of_threads(), std::size_t(size)});
+  if (number_of_tasks <= 1) {
+    kernel(0, size);
+    return;
+  }
+  pool.run(number_of_tasks, [&](std::size_t task) {
+    kernel(size * task / number_of_tasks, size * (task + 1) / number_of_tasks);
+  });
+}
+
+// The bit of a row index for the given qubit, in ILO-BE convention.
+static SimUInt get_qubit_bit(unsigned qubit, unsigned full_number_of_qubits) {
+  return SimUInt(1) << (full_number_of_qubits - 1 - qubit);
+}
+
+// The 1-qubit case: the rows come in pairs (r, r + stride), where r has a
+// zero in the bit position of the qubit. Diagonal gates (e.g. Rz) and
+// anti-diagonal gates (e.g. X, Y) have dedicated loops.
+static void apply_single_qubit(
+    const Eigen::Matrix2cd& u, unsigned qubit, Eigen::MatrixXcd& matr,
+    unsigned full_number_of_qubits) {
+  const std::complex<double> u00 = u(0, 0), u01 = u(0, 1), u10 = u(1, 0),
+                             u11 = u(1, 1);
+  const bool diagonal = u01 == 0. && u10 == 0.;
+  const bool anti_diagonal = u00 == 0. && u11 == 0.;
+  const SimUInt stride = get_qubit_bit(qubit, full_number_of_qubits);
+  const SimUInt number_of_pairs = get_matrix_size(full_number_of_qubits) / 2;
+
+  // Pair p is (r, r + stride) where r = 2 * stride * (p / stride) +
+  // (p % stride); a range of pairs is processed in runs of consecutive r.
+  const auto kernel = [&](SimUInt pairs_begin, SimUInt pairs_end) {
+    for (Eigen::Index col = 0; col < matr.cols(); ++col) {
+      std::complex<double>* const amps = matr.col(col).data();
+      SimUInt pair = pairs_begin;
+      while (pair < pairs_end) {
+        const SimUInt offset = pair % stride;
+        const SimUInt length = std::min(stride - offset, pairs_end - pair);
+        std::complex<double>* const amps0 =
+            amps + 2 * (pair - offset) + offset;
+        std::complex<double>* const amps1 = amps0 + stride;
+        if (diagonal) {
+          for (SimUInt r = 0; r < length; ++r) {
+            amps0[r] = mul(u00, amps0[r]);
+            amps1[r] = mul(u11, amps1[r]);
+          }
+        } else if (anti_diagonal) {
+          for (SimUInt r = 0; r < length; ++r) {
+            const std::complex<double> a0 = amps0[r];
+            amps0[r] = mul(u01, amps1[r]);
+            amps1[r] = mul(u10, a0);
+          }
+        } else {
+          for (SimUInt r = 0; r < length; ++r) {
+            const std::complex<double> a0 = amps0[r];
+            const std::complex<double> a1 = amps1[r];
+            amps0[r] = mul(u00, a0) + mul(u01, a1);
+            amps1[r] = mul(u10, a0) + mul(u11, a1);
+          }
+        }
+        pair += length;
+      }
+    }
+  };
+  run_in_ranges(number_of_pairs, 2 * matr.cols(), kernel);
+}
+
+static void apply_single_qubit(
+    const std::vector<TripletCd>& triplets, unsigned qubit,
+    Eigen::MatrixXcd& matr, unsigned full_number_of_qubits) {
+  Eigen::Matrix2cd u = Eigen::Matrix2cd::Zero();
+  for (const auto& triplet : triplets) {
+    u(triplet.row(), triplet.col()) += triplet.value();
+  }
+  apply_single_qubit(u, qubit, matr, full_number_of_qubits);
+}
 
+// Controlled gates: only the 2^(n-k) pairs of rows with every control bit
+// set are touched, and they are enumerated directly from the free bits.
+static void apply_controlled(
+    const Eigen::Matrix2cd& u, const std::vector<unsigned>& qubits,
+    Eigen::MatrixXcd& matr, unsigned full_number_of_qubits) {
+  SimUInt control_bits = 0;
+  for (unsigned i = 0; i + 1 < qubits.size(); ++i) {
+    control_bits |= get_qubit_bit(qubits[i], full_number_of_qubits);
+  }
+  const SimUInt target_bit =
+      get_qubit_bit(qubits.back(), full_number_of_qubits);
+  const ExpansionData expansion_data =
+      get_expansion_data(control_bits | target_bit, full_number_of_qubits);
   const SimUInt free_bits_limit =
       get_matrix_size(full_number_of_qubits - qubits.size());
-  TKET_ASSERT(free_bits_limit != 0 || !"Too many bits");
+  const std::complex<double> u00 = u(0, 0), u01 = u(0, 1), u10 = u(1, 0),
+                             u11 = u(1, 1);
+
+  const auto kernel = [&](SimUInt free_bits_begin, SimUInt free_bits_end) {
+    for (Eigen::Index col = 0; col < matr.cols(); ++col) {
+      std::complex<double>* const amps = matr.col(col).data();
+      for (SimUInt free_bits = free_bits_begin; free_bits < free_bits_end;
+           ++free_bits) {
+        const SimUInt r0 =
+            get_expanded_bits(expansion_data, free_bits) | control_bits;
+        const SimUInt r1 = r0 | target_bit;
+        const std::complex<double> a0 = amps[r0];
+        const std::complex<double> a1 = amps[r1];
+        amps[r0] = mul(u00, a0) + mul(u01, a1);
+        amps[r1] = mul(u10, a0) + mul(u11, a1);
+      }
+    }
+  };
+  run_in_ranges(free_bits_limit, 2 * matr.cols(), kernel);
+}
 
-  for (SimUInt free_bits = 0; free_bits < free_bits_limit; ++free_bits) {
-    const SimUInt expanded_free_bits =
-        get_expanded_bits(expansion_data, free_bits);
-
-    // Now go down the U matrix entries and copy them to the appropriate
-    // positions.
-    for (const auto& triplet : triplets) {
-      lifted_triplets.emplace_back(
-          lifted_bits.translated_bits.at(triplet.row()) | expanded_free_bits,
-          lifted_bits.translated_bits.at(triplet.col()) | expanded_free_bits,
-          triplet.value());
+// Diagonal gates whose entries depend only on the parity of the bits of
+// the qubits acted on.
+static void apply_parity_phase(
+    const Eigen::Matrix2cd& u, const std::vector<unsigned>& qubits,
+    Eigen::MatrixXcd& matr, unsigned full_number_of_qubits) {
+  SimUInt mask = 0;
+  for (unsigned qubit : qubits) {
+    mask |= get_qubit_bit(qubit, full_number_of_qubits);
+  }
+  const std::complex<double> phases[2] = {u(0, 0), u(1, 1)};
+
+  const auto kernel = [&](SimUInt rows_begin, SimUInt rows_end) {
+    for (Eigen::Index col = 0; col < matr.cols(); ++col) {
+      std::complex<double>* const amps = matr.col(col).data();
+      for (SimUInt r = rows_begin; r < rows_end; ++r) {
+        amps[r] = mul(phases[std::popcount(r & mask) & 1], amps[r]);
+      }
     }
+  };
+  run_in_ranges(get_matrix_size(full_number_of_qubits), matr.cols(), kernel);
+}
+
+static void apply_structured(
+    const GateUnitaryStructure& structure, const std::vector<unsigned>& qubits,
+    Eigen::MatrixXcd& matr, unsigned full_number_of_qubits) {
+  switch (structure.kind) {
+    case GateUnitaryStructure::Kind::Controlled:
+      apply_controlled(structure.u, qubits, matr, full_number_of_qubits);
+      return;
+    case GateUnitaryStructure::Kind::ParityPhase:
+      apply_parity_phase(structure.u, qubits, matr, full_number_of_qubits);
+      return;
+    case GateUnitaryStructure::Kind::Product:
+      for (unsigned qubit : qubits) {
+        apply_single_qubit(structure.u, qubit, matr, full_number_of_qubits);
+      }
+      return;
   }
 }
 
 namespace {
-// Contains data potentially of size roughly 2^n or larger,
-// to avoid expensive memeory reallocation.
-struct LargeWorkData {
-  LiftedBitsResult lifted_bits;
-  std::vector<TripletCd> lifted_triplets;
-  SparseMatrixXcd sparse_matrix;
-  ExpansionData expansion_data;
-
-  static LargeWorkData& get_work_data();
+// Shapes of gate unitary with cheaper kernels than the general one.
+enum class MatrixForm {
+  // Only diagonal entries, e.g. CZ, ZZPhase, DiagonalBox: scale each row.
+  Diagonal,
+  // Exactly one entry in each row and column, e.g. CX, SWAP, ToffoliBox:
+  // move and scale rows, with no sums.
+  Monomial,
+  General
 };
+}  // namespace
 
-LargeWorkData& LargeWorkData::get_work_data() {
-  static LargeWorkData data;
-  return data;
+static MatrixForm get_matrix_form(
+    const std::vector<TripletCd>& triplets, std::size_t matrix_size) {
+  // Every row of a unitary is nonzero, so anything with fewer entries has
+  // had entries rounded to zero and is treated generally.
+  if (triplets.size() != matrix_size) return MatrixForm::General;
+  bool diagonal = true;
+  std::vector<bool> row_used(matrix_size, false);
+  std::vector<bool> col_used(matrix_size, false);
+  for (const auto& triplet : triplets) {
+    diagonal &= triplet.row() == triplet.col();
+    if (row_used[triplet.row()] || col_used[triplet.col()]) {
+      return MatrixForm::General;
+    }
+    row_used[triplet.row()] = true;
+    col_used[triplet.col()] = true;
+  }
+  return diagonal ? MatrixForm::Diagonal : MatrixForm::Monomial;
 }
-}  // namespace
 
 void GateNode::apply_full_unitary(
     Eigen::MatrixXcd& matr, unsigned full_number_of_qubits) const {
-  auto& work_data = LargeWorkData::get_work_data();
+  if (structure) {
+    apply_structured(*structure, qubit_indices, matr, full_number_of_qubits);
+    return;
+  }
+  if (qubit_indices.size() == 1) {
+    apply_single_qubit(
+        triplets, qubit_indices[0], matr, full_number_of_qubits);
+    return;
+  }
+  auto& work_data = WorkData::get_work_data();
 
-  set_lifted_triplets(
-      triplets, work_data.lifted_bits, work_data.lifted_triplets,
-      work_data.expansion_data, qubit_indices, full_number_of_qubits);
+  // translated_bits[j] gives the bits within the length n binary string
+  // corresponding to the length k binary representation of j; the remaining
+  // "free" bits select which copy of U we are applying.
+  work_data.lifted_bits.set(qubit_indices, full_number_of_qubits);
+  const std::vector<SimUInt>& translated_bits =
+      work_data.lifted_bits.translated_bits;
+  work_data.expansion_data = get_expansion_data(
+      work_data.lifted_bits.translated_bits_mask, full_number_of_qubits);
 
-  work_data.sparse_matrix =
-      get_sparse_square_matrix(work_data.lifted_triplets, matr.rows());
+  const SimUInt free_bits_limit =
+      get_matrix_size(full_number_of_qubits - qubit_indices.size());
+  TKET_ASSERT(free_bits_limit != 0 || !"Too many bits");
+
+  const MatrixForm form = get_matrix_form(triplets, translated_bits.size());
+  const ExpansionData& expansion_data = work_data.expansion_data;
 
-  matr = work_data.sparse_matrix * matr;
+  const auto kernel = [&](SimUInt free_bits_begin, SimUInt free_bits_end) {
+    Eigen::MatrixXcd gathered;
+    if (form != MatrixForm::Diagonal) {
+      gathered.resize(translated_bits.size(), matr.cols());
+    }
+    for (SimUInt free_bits = free_bits_begin; free_bits < free_bits_end;
+         ++free_bits) {
+      const SimUInt expanded_free_bits =
+          get_expanded_bits(expansion_data, free_bits);
+
+      if (form == MatrixForm::Diagonal) {
+        for (const auto& triplet : triplets) {
+          matr.row(translated_bits[triplet.row()] | expanded_free_bits) *=
+              triplet.value();
+        }
+        continue;
+      }
+      // Copy out the 2^k rows which U mixes together, then write U times
+      // them back, using only the nonzero entries of U.
+      for (SimUInt j = 0; j < translated_bits.size(); ++j) {
+        gathered.row(j) = matr.row(translated_bits[j] | expanded_free_bits);
+      }
+      if (form == MatrixForm::Monomial) {
+        for (const auto& triplet : triplets) {
+          matr.row(translated_bits[triplet.row()] | expanded_free_bits) =
+              triplet.value() * gathered.row(triplet.col());
+        }
+        continue;
+      }
+      for (SimUInt i = 0; i < translated_bits.size(); ++i) {
+        matr.row(translated_bits[i] | expanded_free_bits).setZero();
+      }
+      for (const auto& triplet : triplets) {
+        matr.row(translated_bits[triplet.row()] | expanded_free_bits) +=
+            triplet.value() * gathered.row(triplet.col());
+      }
+    }
+  };
+  run_in_ranges(
+      free_bits_limit, translated_bits.size() * matr.cols(), kernel);
 }
 
 }  // namespace internal
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <optional>
+
+#include "tket/Gate/GateUnitaryMatrix.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
 
 namespace tket {
@@ -26,13 +29,19 @@ struct GateNode {
    */
   std::vector<TripletCd> triplets;
 
+  /** If set, the unitary in structured form, used instead of the triplets
+   *  (which are then empty).
+   */
+  std::optional<GateUnitaryStructure> structure;
+
   /** The indices in the original top-level root circuit
    *  which this unitary acts upon.
    */
   std::vector<unsigned> qubit_indices;
 
-  /** Lift the triplets to a full unitary matrix U acting on n qubits,
-   *  then premultiply the given matrix by U.
+  /** Premultiply the given matrix by the full unitary matrix U acting on
+   *  n qubits obtained by lifting the triplets, in place and without
+   *  constructing U.
    */
   void apply_full_unitary(
       Eigen::MatrixXcd& matr, unsigned full_number_of_qubits) const;
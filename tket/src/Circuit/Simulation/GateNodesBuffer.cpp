@@ -14,6 +14,7 @@
 
 #include "GateNodesBuffer.hpp"
 
+#include <algorithm>
 #include <stdexcept>
 #include <tkassert/Assert.hpp>
 
@@ -25,13 +26,26 @@ struct GateNodesBuffer::Impl {
   Eigen::MatrixXcd& matrix;
   const double abs_epsilon;
   const unsigned number_of_qubits;
+  const unsigned max_fused_qubits;
   double global_phase;
 
-  Impl(Eigen::MatrixXcd& matr, double abs_eps)
+  // The product of the gates pushed since the last application to the
+  // matrix, as a dense unitary acting on fused_qubits (in that order).
+  // Empty if there are no such gates.
+  std::vector<unsigned> fused_qubits;
+  Eigen::MatrixXcd fused_unitary;
+  unsigned number_of_fused_nodes;
+  // The first of these gates; if it is the only one, it is applied
+  // directly, which may use a cheaper kernel than the fused unitary.
+  GateNode first_fused_node;
+
+  Impl(Eigen::MatrixXcd& matr, double abs_eps, unsigned max_fused)
       : matrix(matr),
         abs_epsilon(abs_eps),
         number_of_qubits(get_number_of_qubits(matr.rows())),
-        global_phase(0.0) {
+        max_fused_qubits(max_fused),
+        global_phase(0.0),
+        number_of_fused_nodes(0) {
     if (matr.cols() == 0) {
       throw std::invalid_argument("Matrix has zero cols");
     }
@@ -42,16 +56,97 @@ struct GateNodesBuffer::Impl {
   void add_global_phase(double ph) { global_phase += ph; }
 
   void flush();
+
+  // Apply the fused unitary to the matrix, and clear it.
+  void apply_fused();
+
+  // Premultiply the fused unitary by the node, which must act only on
+  // qubits in fused_qubits.
+  void fuse(const GateNode& node);
 };
 
 void GateNodesBuffer::Impl::push(const GateNode& node) {
-  // Later, we might add fancy optimisation here:
-  // storing the gate for later use, looking for other compatible gates
-  // acting on the same qubits to merge with this, etc. etc.
+  if (node.qubit_indices.size() > max_fused_qubits) {
+    apply_fused();
+    node.apply_full_unitary(matrix, number_of_qubits);
+    return;
+  }
+  std::vector<unsigned> new_qubits;
+  for (unsigned qb : node.qubit_indices) {
+    if (std::find(fused_qubits.begin(), fused_qubits.end(), qb) ==
+        fused_qubits.end()) {
+      new_qubits.push_back(qb);
+    }
+  }
+  if (fused_qubits.size() + new_qubits.size() > max_fused_qubits) {
+    apply_fused();
+    new_qubits = node.qubit_indices;
+  }
+  if (fused_unitary.size() == 0) {
+    fused_unitary = Eigen::MatrixXcd::Identity(1, 1);
+  }
+  if (!new_qubits.empty()) {
+    // Extend to the new qubits, placed last: U becomes U (x) I.
+    const unsigned extra_size = get_matrix_size(new_qubits.size());
+    const Eigen::MatrixXcd old_unitary = std::move(fused_unitary);
+    fused_unitary = Eigen::MatrixXcd::Zero(
+        old_unitary.rows() * extra_size, old_unitary.cols() * extra_size);
+    for (Eigen::Index r = 0; r < old_unitary.rows(); ++r) {
+      for (Eigen::Index c = 0; c < old_unitary.cols(); ++c) {
+        if (old_unitary(r, c) == 0.) continue;
+        for (unsigned i = 0; i < extra_size; ++i) {
+          fused_unitary(r * extra_size + i, c * extra_size + i) =
+              old_unitary(r, c);
+        }
+      }
+    }
+    fused_qubits.insert(
+        fused_qubits.end(), new_qubits.begin(), new_qubits.end());
+  }
+  fuse(node);
+}
+
+void GateNodesBuffer::Impl::fuse(const GateNode& node) {
+  GateNode local_node;
+  local_node.triplets = node.triplets;
+  local_node.structure = node.structure;
+  local_node.qubit_indices.reserve(node.qubit_indices.size());
+  for (unsigned qb : node.qubit_indices) {
+    local_node.qubit_indices.push_back(
+        std::find(fused_qubits.begin(), fused_qubits.end(), qb) -
+        fused_qubits.begin());
+  }
+  local_node.apply_full_unitary(fused_unitary, fused_qubits.size());
+  if (number_of_fused_nodes == 0) first_fused_node = node;
+  ++number_of_fused_nodes;
+}
+
+void GateNodesBuffer::Impl::apply_fused() {
+  if (number_of_fused_nodes == 0) return;
+  if (number_of_fused_nodes == 1) {
+    first_fused_node.apply_full_unitary(matrix, number_of_qubits);
+    fused_qubits.clear();
+    fused_unitary.resize(0, 0);
+    number_of_fused_nodes = 0;
+    return;
+  }
+  GateNode node;
+  node.qubit_indices = std::move(fused_qubits);
+  for (Eigen::Index r = 0; r < fused_unitary.rows(); ++r) {
+    for (Eigen::Index c = 0; c < fused_unitary.cols(); ++c) {
+      if (std::abs(fused_unitary(r, c)) > abs_epsilon) {
+        node.triplets.emplace_back(r, c, fused_unitary(r, c));
+      }
+    }
+  }
   node.apply_full_unitary(matrix, number_of_qubits);
+  fused_qubits.clear();
+  fused_unitary.resize(0, 0);
+  number_of_fused_nodes = 0;
 }
 
 void GateNodesBuffer::Impl::flush() {
+  apply_fused();
   if (global_phase != 0.0) {
     const auto factor = std::polar(1.0, PI * global_phase);
     matrix *= factor;
@@ -59,8 +154,9 @@ void GateNodesBuffer::Impl::flush() {
   }
 }
 
-GateNodesBuffer::GateNodesBuffer(Eigen::MatrixXcd& matrix, double abs_epsilon)
-    : pimpl(std::make_unique<Impl>(matrix, abs_epsilon)) {}
+GateNodesBuffer::GateNodesBuffer(
+    Eigen::MatrixXcd& matrix, double abs_epsilon, unsigned max_fused_qubits)
+    : pimpl(std::make_unique<Impl>(matrix, abs_epsilon, max_fused_qubits)) {}
 
 GateNodesBuffer::~GateNodesBuffer() {}
 
@@ -49,6 +49,12 @@ namespace internal {
  *  Of course, this would all be simulating the exact same gates, just in a
  *  computationally more efficient way; allowing the gates themselves to be
  *  changed could give yet more speedup possibilities.
+ *
+ *  Currently, consecutive gates are fused greedily: their product is
+ *  accumulated as a dense unitary as long as the union of their qubits has
+ *  at most max_fused_qubits elements, and applied to the matrix once that
+ *  limit would be exceeded (or on flush). So, e.g., a run of 1- and 2-qubit
+ *  gates on 4 qubits costs one pass over the matrix rather than one per gate.
  */
 class GateNodesBuffer {
  public:
@@ -62,8 +68,12 @@ class GateNodesBuffer {
    *       arising the gates added in sequence, in ILO-BE convention.
    *  @param abs_epsilon Used to convert almost-zero entries to zero entries:
    *      any z with std::abs(z) <= abs_epsilon is treated as zero.
+   *  @param max_fused_qubits The largest number of qubits a fused unitary
+   *      may act on. Gates on more qubits are applied individually.
    */
-  GateNodesBuffer(Eigen::MatrixXcd& matrix, double abs_epsilon);
+  GateNodesBuffer(
+      Eigen::MatrixXcd& matrix, double abs_epsilon,
+      unsigned max_fused_qubits = 4);
 
   ~GateNodesBuffer();
 
@@ -0,0 +1,214 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/Simulation/NoisySimulator.hpp"
+
+#include <map>
+#include <tkrng/RNG.hpp>
+
+#include "GateNode.hpp"
+#include "Trajectory.hpp"
+#include "tket/Characterisation/DeviceCharacterisation.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Conditional.hpp"
+#include "tket/Gate/Gate.hpp"
+#include "tket/Gate/GateUnitaryMatrix.hpp"
+#include "tket/Gate/GateUnitaryMatrixError.hpp"
+
+namespace tket {
+namespace tket_sim {
+
+namespace {
+
+// A command of the circuit, with units replaced by their indices and
+// gate unitaries and error probabilities precomputed.
+struct NoisyInstruction {
+  OpType type;
+  // For gates: the unitary, acting on node.qubit_indices.
+  internal::GateNode node;
+  // For Measure: the target bit.
+  unsigned bit = 0;
+  // For 1- and 2-qubit gates: probability of a Pauli error on all the
+  // qubits of the gate. For larger gates: probability of an error on each
+  // qubit. For Measure: probability of flipping the outcome.
+  std::vector<double> error_probabilities;
+  std::vector<unsigned> condition_bits;
+  unsigned condition_value = 0;
+};
+
+using internal::get_uniform;
+using internal::Trajectory;
+
+gate_error_t get_link_error(
+    const DeviceCharacterisation& characterisation, const Node& n0,
+    const Node& n1, OpType type) {
+  const gate_error_t error = characterisation.get_error({n0, n1}, type);
+  return (error > 0.) ? error : characterisation.get_error({n1, n0}, type);
+}
+
+NoisyInstruction make_instruction(
+    const Op_ptr& op, const unit_vector_t& args,
+    const std::map<UnitID, unsigned>& indices,
+    const DeviceCharacterisation& characterisation) {
+  NoisyInstruction instr;
+  instr.type = op->get_type();
+  if (instr.type == OpType::Conditional) {
+    const Conditional& cond = static_cast<const Conditional&>(*op);
+    const unsigned width = cond.get_width();
+    const unit_vector_t inner_args(args.begin() + width, args.end());
+    instr = make_instruction(
+        cond.get_op(), inner_args, indices, characterisation);
+    if (!instr.condition_bits.empty()) {
+      throw Unsupported("Nested conditionals are not supported");
+    }
+    for (unsigned i = 0; i < width; ++i) {
+      instr.condition_bits.push_back(indices.at(args[i]));
+    }
+    instr.condition_value = cond.get_value();
+    return instr;
+  }
+  std::vector<Node> nodes;
+  const op_signature_t sig = op->get_signature();
+  for (unsigned i = 0; i < args.size(); ++i) {
+    if (sig[i] == EdgeType::Quantum) {
+      instr.node.qubit_indices.push_back(indices.at(args[i]));
+      nodes.push_back(Node(args[i]));
+    } else {
+      instr.bit = indices.at(args[i]);
+    }
+  }
+  switch (instr.type) {
+    case OpType::Measure: {
+      instr.error_probabilities = {
+          characterisation.get_readout_error(nodes.at(0))};
+      return instr;
+    }
+    case OpType::Reset:
+    case OpType::Barrier: {
+      return instr;
+    }
+    default: {
+    }
+  }
+  if (!op->get_desc().is_gate()) {
+    throw Unsupported(
+        "Cannot simulate " + op->get_name() + " with noisy simulation");
+  }
+  try {
+    const Gate& gate = static_cast<const Gate&>(*op);
+    instr.node.structure = GateUnitaryMatrix::get_unitary_structure(gate);
+    if (!instr.node.structure) {
+      instr.node.triplets = GateUnitaryMatrix::get_unitary_triplets(gate);
+    }
+  } catch (const GateUnitaryMatrixError& e) {
+    throw Unsupported(
+        "Cannot simulate " + op->get_name() + ": " + std::string(e.what()));
+  }
+  if (nodes.size() == 1) {
+    instr.error_probabilities = {
+        characterisation.get_error(nodes[0], instr.type)};
+  } else if (nodes.size() == 2) {
+    instr.error_probabilities = {
+        get_link_error(characterisation, nodes[0], nodes[1], instr.type)};
+  } else {
+    for (const Node& n : nodes) {
+      instr.error_probabilities.push_back(characterisation.get_error(n));
+    }
+  }
+  return instr;
+}
+
+void run_instruction(
+    const NoisyInstruction& instr, Trajectory& trajectory,
+    std::vector<bool>& bits, RNG& rng) {
+  for (unsigned i = 0; i < instr.condition_bits.size(); ++i) {
+    if (bits[instr.condition_bits[i]] != bool((instr.condition_value >> i) & 1))
+      return;
+  }
+  const std::vector<unsigned>& qubits = instr.node.qubit_indices;
+  switch (instr.type) {
+    case OpType::Measure: {
+      const bool outcome = trajectory.measure(qubits.at(0), rng);
+      const bool flip = get_uniform(rng) < instr.error_probabilities[0];
+      bits[instr.bit] = outcome ^ flip;
+      return;
+    }
+    case OpType::Reset: {
+      trajectory.reset(qubits.at(0), rng);
+      return;
+    }
+    case OpType::Barrier: {
+      return;
+    }
+    default: {
+    }
+  }
+  trajectory.apply(instr.node);
+  if (qubits.size() <= 2) {
+    if (qubits.empty() || get_uniform(rng) >= instr.error_probabilities[0]) {
+      return;
+    }
+    // A uniformly random non-identity Pauli string on the qubits.
+    const unsigned n_paulis = (qubits.size() == 1) ? 4 : 16;
+    unsigned pauli = 1 + rng.get_size_t(n_paulis - 2);
+    for (unsigned qb : qubits) {
+      trajectory.apply_pauli(qb, pauli % 4);
+      pauli /= 4;
+    }
+    return;
+  }
+  for (unsigned i = 0; i < qubits.size(); ++i) {
+    if (get_uniform(rng) < instr.error_probabilities[i]) {
+      trajectory.apply_pauli(qubits[i], 1 + rng.get_size_t(2));
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<std::vector<bool>> sample_noisy_circuit(
+    const Circuit& circ, const DeviceCharacterisation& characterisation,
+    unsigned n_shots, std::size_t seed, unsigned max_number_of_qubits) {
+  if (circ.n_qubits() > max_number_of_qubits) {
+    throw Unsupported("Circuit to simulate has too many qubits");
+  }
+  std::map<UnitID, unsigned> indices;
+  const qubit_vector_t qubits = circ.all_qubits();
+  const bit_vector_t bits = circ.all_bits();
+  for (unsigned i = 0; i < qubits.size(); ++i) indices[qubits[i]] = i;
+  for (unsigned i = 0; i < bits.size(); ++i) indices[bits[i]] = i;
+
+  std::vector<NoisyInstruction> instructions;
+  for (const Command& com : circ) {
+    instructions.push_back(make_instruction(
+        com.get_op_ptr(), com.get_args(), indices, characterisation));
+  }
+
+  RNG rng;
+  rng.set_seed(seed);
+  std::vector<std::vector<bool>> results;
+  results.reserve(n_shots);
+  for (unsigned shot = 0; shot < n_shots; ++shot) {
+    Trajectory trajectory(qubits.size());
+    std::vector<bool> shot_bits(bits.size(), false);
+    for (const NoisyInstruction& instr : instructions) {
+      run_instruction(instr, trajectory, shot_bits, rng);
+    }
+    results.push_back(std::move(shot_bits));
+  }
+  return results;
+}
+
+}  // namespace tket_sim
+}  // namespace tket
@@ -106,7 +106,8 @@ struct PauliExpBoxUnitaryCalculator {
 };
 
 PauliExpBoxUnitaryCalculator& PauliExpBoxUnitaryCalculator::get() {
-  static PauliExpBoxUnitaryCalculator calculator;
+  // One per thread, since get_triplets overwrites its contents.
+  thread_local PauliExpBoxUnitaryCalculator calculator;
   return calculator;
 }
 
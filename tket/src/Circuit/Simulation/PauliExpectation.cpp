@@ -0,0 +1,164 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/Simulation/PauliExpectation.hpp"
+
+#include <bit>
+#include <map>
+#include <stdexcept>
+
+#include "BitOperations.hpp"
+#include "ThreadPool.hpp"
+#include "tket/Utils/Expression.hpp"
+
+namespace tket {
+namespace tket_sim {
+
+namespace {
+
+// A Pauli string P with coefficient c, such that
+// c P |j> = c i^n_y (-1)^{popcount(j & z_mask)} |j ^ x_mask>.
+struct MaskedPauli {
+  internal::SimUInt x_mask = 0;
+  internal::SimUInt z_mask = 0;
+  Complex coeff = 1.;
+};
+
+Complex get_coeff(const Expr& e) {
+  const std::optional<Complex> coeff = eval_expr_c(e);
+  if (!coeff) {
+    throw SymbolsNotSupported(
+        "Cannot evaluate expectation value with symbolic coefficients");
+  }
+  return *coeff;
+}
+
+// Set the masks for Pauli p on the qubit with the given bit.
+void add_pauli(MaskedPauli& masked, Pauli p, internal::SimUInt bit) {
+  switch (p) {
+    case Pauli::I: {
+      break;
+    }
+    case Pauli::X: {
+      masked.x_mask |= bit;
+      break;
+    }
+    case Pauli::Y: {
+      masked.x_mask |= bit;
+      masked.z_mask |= bit;
+      masked.coeff *= i_;
+      break;
+    }
+    case Pauli::Z: {
+      masked.z_mask |= bit;
+      break;
+    }
+  }
+}
+
+unsigned get_number_of_qubits(const StateVector& state) {
+  const std::size_t size = state.size();
+  if (size == 0 || (size & (size - 1)) != 0) {
+    throw std::invalid_argument("Statevector size is not a power of two");
+  }
+  return std::countr_zero(size);
+}
+
+// <psi| c P |psi>
+Complex get_term_expectation(
+    const StateVector& state, const MaskedPauli& masked) {
+  const std::complex<double>* const amps = state.data();
+  const internal::SimUInt size = state.size();
+  Complex sum = 0.;
+  for (internal::SimUInt j = 0; j < size; ++j) {
+    const std::complex<double> term =
+        std::conj(amps[j ^ masked.x_mask]) * amps[j];
+    sum += (std::popcount(j & masked.z_mask) % 2 == 0) ? term : -term;
+  }
+  return masked.coeff * sum;
+}
+
+Complex get_expectation(
+    const StateVector& state, const std::vector<MaskedPauli>& terms) {
+  internal::ThreadPool& pool = internal::ThreadPool::get();
+  std::vector<Complex> values(terms.size());
+  const std::size_t n_tasks = std::min<std::size_t>(
+      terms.size(), pool.get_number_of_threads());
+  pool.run(n_tasks, [&](std::size_t task) {
+    for (std::size_t i = task; i < terms.size(); i += n_tasks) {
+      values[i] = get_term_expectation(state, terms[i]);
+    }
+  });
+  // Sum in a fixed order, so that the result is deterministic.
+  Complex total = 0.;
+  for (const Complex& value : values) total += value;
+  return total;
+}
+
+}  // namespace
+
+Complex get_operator_expectation_value(
+    const StateVector& state, const std::vector<SymPauliTensor>& terms) {
+  const unsigned n_qubits = get_number_of_qubits(state);
+  std::vector<MaskedPauli> masked_terms;
+  masked_terms.reserve(terms.size());
+  for (const SymPauliTensor& term : terms) {
+    if (term.string.size() > n_qubits) {
+      throw std::invalid_argument(
+          "Pauli string acts on more qubits than the statevector");
+    }
+    MaskedPauli masked;
+    masked.coeff = get_coeff(term.coeff);
+    for (unsigned q = 0; q < term.string.size(); ++q) {
+      add_pauli(
+          masked, term.string[q], internal::SimUInt(1) << (n_qubits - 1 - q));
+    }
+    masked_terms.push_back(masked);
+  }
+  return get_expectation(state, masked_terms);
+}
+
+Complex get_operator_expectation_value(
+    const StateVector& state, const std::vector<SpSymPauliTensor>& terms,
+    const qubit_vector_t& qubits) {
+  const unsigned n_qubits = get_number_of_qubits(state);
+  if (n_qubits != qubits.size()) {
+    throw std::invalid_argument(
+        "Size of statevector does not match number of qubits");
+  }
+  std::map<Qubit, internal::SimUInt> bits;
+  for (unsigned q = 0; q < n_qubits; ++q) {
+    bits[qubits[q]] = internal::SimUInt(1) << (n_qubits - 1 - q);
+  }
+  std::vector<MaskedPauli> masked_terms;
+  masked_terms.reserve(terms.size());
+  for (const SpSymPauliTensor& term : terms) {
+    MaskedPauli masked;
+    masked.coeff = get_coeff(term.coeff);
+    for (const std::pair<const Qubit, Pauli>& qp : term.string) {
+      const auto found = bits.find(qp.first);
+      if (found == bits.end()) {
+        throw std::invalid_argument(
+            "Pauli string acts on qubit " + qp.first.repr() +
+            " not in the statevector");
+      }
+      add_pauli(masked, qp.second, found->second);
+    }
+    masked_terms.push_back(masked);
+  }
+  return get_expectation(state, masked_terms);
+}
+
+}  // namespace tket_sim
+}  // namespace tket
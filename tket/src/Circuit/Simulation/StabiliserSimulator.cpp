@@ -0,0 +1,226 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/Simulation/StabiliserSimulator.hpp"
+
+#include <map>
+#include <tkrng/RNG.hpp>
+
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Conditional.hpp"
+#include "tket/Clifford/SymplecticTableau.hpp"
+
+namespace tket {
+namespace tket_sim {
+
+namespace {
+
+// A command of the circuit, with units replaced by their indices.
+struct Instruction {
+  OpType type;
+  std::vector<unsigned> qubits;
+  // For Measure: the target bit.
+  unsigned bit = 0;
+  // The condition, if any: the op is applied only if the bits, read as a
+  // little-endian integer, equal the value.
+  std::vector<unsigned> condition_bits;
+  unsigned condition_value = 0;
+};
+
+// Stabiliser state on n qubits. Rows 0 to n-1 of the tableau are the
+// destabilisers, rows n to 2n-1 the stabilisers and row 2n is scratch space.
+class StabiliserState {
+ public:
+  explicit StabiliserState(unsigned n_qubits)
+      : n_(n_qubits),
+        tab_(
+            initial_xmat(n_qubits), initial_zmat(n_qubits),
+            VectorXb::Zero(2 * n_qubits + 1)) {}
+
+  void apply_gate(OpType type, const std::vector<unsigned>& qubits) {
+    tab_.apply_gate(type, qubits);
+  }
+
+  bool measure(unsigned qb, RNG& rng);
+
+  void reset(unsigned qb, RNG& rng) {
+    if (measure(qb, rng)) tab_.apply_X(qb);
+  }
+
+ private:
+  unsigned n_;
+  SymplecticTableau tab_;
+
+  static MatrixXb initial_xmat(unsigned n) {
+    MatrixXb xmat = MatrixXb::Zero(2 * n + 1, n);
+    for (unsigned i = 0; i < n; ++i) xmat(i, i) = true;
+    return xmat;
+  }
+
+  static MatrixXb initial_zmat(unsigned n) {
+    MatrixXb zmat = MatrixXb::Zero(2 * n + 1, n);
+    for (unsigned i = 0; i < n; ++i) zmat(n + i, i) = true;
+    return zmat;
+  }
+
+  // Replace row h by the product of row i and row h, tracking the sign as
+  // in Aaronson-Gottesman. Products involving a destabiliser may have an
+  // imaginary phase, but the signs of destabilisers are never used.
+  void rowsum(unsigned h, unsigned i);
+};
+
+void StabiliserState::rowsum(unsigned h, unsigned i) {
+  // The tableau's row multiplication works on whole words of the packed rows
+  // and sets the sign only when the product's phase is exactly -1.
+  tab_.row_mult(i, h);
+}
+
+bool StabiliserState::measure(unsigned qb, RNG& rng) {
+  BitMatrix& xmat = tab_.xmat;
+  BitMatrix& zmat = tab_.zmat;
+  for (unsigned p = n_; p < 2 * n_; ++p) {
+    if (!xmat(p, qb)) continue;
+    // Some stabiliser anticommutes with Z_qb: the outcome is random.
+    for (unsigned i = 0; i < 2 * n_; ++i) {
+      if (i != p && xmat(i, qb)) rowsum(i, p);
+    }
+    xmat.copy_row(p, p - n_);
+    zmat.copy_row(p, p - n_);
+    tab_.phase(p - n_) = tab_.phase(p);
+    xmat.set_row_zero(p);
+    zmat.set_row_zero(p);
+    zmat(p, qb) = true;
+    const bool outcome = rng.get_size_t(1) == 1;
+    tab_.phase(p) = outcome;
+    return outcome;
+  }
+  // Z_qb is (up to sign) a product of stabilisers: the outcome is determined.
+  const unsigned scratch = 2 * n_;
+  xmat.set_row_zero(scratch);
+  zmat.set_row_zero(scratch);
+  tab_.phase(scratch) = false;
+  for (unsigned i = 0; i < n_; ++i) {
+    if (xmat(i, qb)) rowsum(scratch, n_ + i);
+  }
+  return tab_.phase(scratch);
+}
+
+Instruction make_instruction(
+    const Op_ptr& op, const unit_vector_t& args,
+    const std::map<UnitID, unsigned>& indices) {
+  Instruction instr;
+  instr.type = op->get_type();
+  if (instr.type == OpType::Conditional) {
+    const Conditional& cond = static_cast<const Conditional&>(*op);
+    const unsigned width = cond.get_width();
+    const unit_vector_t inner_args(args.begin() + width, args.end());
+    instr = make_instruction(cond.get_op(), inner_args, indices);
+    if (!instr.condition_bits.empty()) {
+      throw BadOpType(
+          "Nested conditionals are not supported in stabiliser simulation",
+          OpType::Conditional);
+    }
+    for (unsigned i = 0; i < width; ++i) {
+      instr.condition_bits.push_back(indices.at(args[i]));
+    }
+    instr.condition_value = cond.get_value();
+    return instr;
+  }
+  op_signature_t sig = op->get_signature();
+  for (unsigned i = 0; i < args.size(); ++i) {
+    if (sig[i] == EdgeType::Quantum) {
+      instr.qubits.push_back(indices.at(args[i]));
+    } else {
+      instr.bit = indices.at(args[i]);
+    }
+  }
+  return instr;
+}
+
+bool condition_holds(const Instruction& instr, const std::vector<bool>& bits) {
+  for (unsigned i = 0; i < instr.condition_bits.size(); ++i) {
+    if (bits[instr.condition_bits[i]] != bool((instr.condition_value >> i) & 1))
+      return false;
+  }
+  return true;
+}
+
+void run_instruction(
+    const Instruction& instr, StabiliserState& state, std::vector<bool>& bits,
+    RNG& rng) {
+  if (!condition_holds(instr, bits)) return;
+  switch (instr.type) {
+    case OpType::Measure: {
+      bits[instr.bit] = state.measure(instr.qubits.at(0), rng);
+      break;
+    }
+    case OpType::Reset: {
+      state.reset(instr.qubits.at(0), rng);
+      break;
+    }
+    case OpType::Barrier: {
+      break;
+    }
+    default: {
+      state.apply_gate(instr.type, instr.qubits);
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<std::vector<bool>> sample_stabiliser_circuit(
+    const Circuit& circ, unsigned n_shots, std::size_t seed) {
+  std::map<UnitID, unsigned> indices;
+  const qubit_vector_t qubits = circ.all_qubits();
+  const bit_vector_t bits = circ.all_bits();
+  for (unsigned i = 0; i < qubits.size(); ++i) indices[qubits[i]] = i;
+  for (unsigned i = 0; i < bits.size(); ++i) indices[bits[i]] = i;
+
+  std::vector<Instruction> instructions;
+  for (const Command& com : circ) {
+    instructions.push_back(
+        make_instruction(com.get_op_ptr(), com.get_args(), indices));
+  }
+
+  // Simulate the unitary prefix once.
+  RNG rng;
+  rng.set_seed(seed);
+  StabiliserState initial_state(qubits.size());
+  std::vector<bool> initial_bits(bits.size(), false);
+  unsigned prefix = 0;
+  for (; prefix < instructions.size(); ++prefix) {
+    const Instruction& instr = instructions[prefix];
+    if (instr.type == OpType::Measure || instr.type == OpType::Reset ||
+        !instr.condition_bits.empty()) {
+      break;
+    }
+    run_instruction(instr, initial_state, initial_bits, rng);
+  }
+
+  std::vector<std::vector<bool>> results;
+  results.reserve(n_shots);
+  for (unsigned shot = 0; shot < n_shots; ++shot) {
+    StabiliserState state = initial_state;
+    std::vector<bool> shot_bits = initial_bits;
+    for (unsigned i = prefix; i < instructions.size(); ++i) {
+      run_instruction(instructions[i], state, shot_bits, rng);
+    }
+    results.push_back(std::move(shot_bits));
+  }
+  return results;
+}
+
+}  // namespace tket_sim
+}  // namespace tket
@@ -0,0 +1,92 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace tket {
+namespace tket_sim {
+namespace internal {
+
+ThreadPool& ThreadPool::get() {
+  static ThreadPool pool;
+  return pool;
+}
+
+ThreadPool::~ThreadPool() { stop_workers(); }
+
+void ThreadPool::stop_workers() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  work_available.notify_all();
+  for (std::thread& worker : workers) worker.join();
+  workers.clear();
+  stopping = false;
+}
+
+void ThreadPool::set_number_of_threads(unsigned number_of_threads) {
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  if (number_of_threads == get_number_of_threads()) return;
+  stop_workers();
+  for (unsigned i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back([this]() { worker_loop(); });
+  }
+}
+
+void ThreadPool::run_tasks(std::unique_lock<std::mutex>& lock, Job& job) {
+  while (job.next_task < job.number_of_tasks) {
+    const std::size_t i = job.next_task++;
+    if (job.next_task == job.number_of_tasks) {
+      jobs.erase(std::find(jobs.begin(), jobs.end(), &job));
+    }
+    lock.unlock();
+    job.task(i);
+    lock.lock();
+    if (--job.tasks_remaining == 0) work_finished.notify_all();
+  }
+}
+
+void ThreadPool::worker_loop() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    work_available.wait(lock, [this]() { return stopping || !jobs.empty(); });
+    if (stopping) return;
+    run_tasks(lock, *jobs.front());
+  }
+}
+
+void ThreadPool::run(
+    std::size_t number_of_tasks,
+    const std::function<void(std::size_t)>& task) {
+  if (workers.empty() || number_of_tasks <= 1) {
+    for (std::size_t i = 0; i < number_of_tasks; ++i) task(i);
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  Job job{task, number_of_tasks, 0, number_of_tasks};
+  jobs.push_back(&job);
+  work_available.notify_all();
+  run_tasks(lock, job);
+  // The job must outlive any worker still running one of its tasks.
+  work_finished.wait(lock, [&job]() { return job.tasks_remaining == 0; });
+}
+
+}  // namespace internal
+}  // namespace tket_sim
+}  // namespace tket
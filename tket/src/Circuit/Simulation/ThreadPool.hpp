@@ -0,0 +1,95 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tket {
+namespace tket_sim {
+namespace internal {
+
+/** A fixed set of worker threads for splitting simulation kernels into
+ *  independent tasks.
+ *
+ *  Tasks must write to disjoint data, so that the result does not depend
+ *  on how they are scheduled.
+ */
+class ThreadPool {
+ public:
+  /** The pool used by the simulator. Initially it has 1 thread
+   *  (i.e. tasks run on the calling thread only).
+   */
+  static ThreadPool& get();
+
+  ~ThreadPool();
+
+  /** Set the number of threads, including the calling thread.
+   *  0 means std::thread::hardware_concurrency().
+   *  Must not be called while tasks are running.
+   */
+  void set_number_of_threads(unsigned number_of_threads);
+
+  unsigned get_number_of_threads() const { return workers.size() + 1; }
+
+  /** Call task(i) for each 0 <= i < number_of_tasks, using all the threads,
+   *  and return when they have all finished. Tasks must not throw.
+   *
+   *  May be called from several threads at once. Each call keeps its own
+   *  job state and queues the job behind any others; idle workers take
+   *  tasks from the oldest job with tasks left to start, while each caller
+   *  works only on its own job.
+   */
+  void run(
+      std::size_t number_of_tasks,
+      const std::function<void(std::size_t)>& task);
+
+ private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable work_available;
+  std::condition_variable work_finished;
+
+  // The state of one call to run, owned by the caller. Guarded by the mutex.
+  struct Job {
+    const std::function<void(std::size_t)>& task;
+    std::size_t number_of_tasks;
+    std::size_t next_task;
+    std::size_t tasks_remaining;
+  };
+
+  // Jobs with tasks not yet started, oldest first, guarded by the mutex.
+  std::deque<Job*> jobs;
+  bool stopping = false;
+
+  ThreadPool() = default;
+
+  void stop_workers();
+
+  void worker_loop();
+
+  // Run tasks of the job until there are none left to start.
+  // The lock is held on entry and exit.
+  void run_tasks(std::unique_lock<std::mutex>& lock, Job& job);
+};
+
+}  // namespace internal
+}  // namespace tket_sim
+}  // namespace tket
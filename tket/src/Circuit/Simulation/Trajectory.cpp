@@ -0,0 +1,67 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Trajectory.hpp"
+
+#include "tket/Utils/Constants.hpp"
+
+namespace tket {
+namespace tket_sim {
+namespace internal {
+
+double get_uniform(RNG& rng) {
+  const std::size_t max_value = (std::size_t(1) << 32) - 1;
+  return double(rng.get_size_t(max_value)) / (double(max_value) + 1.);
+}
+
+Trajectory::Trajectory(unsigned n_qubits)
+    : n_(n_qubits),
+      state_(Eigen::MatrixXcd::Zero(get_matrix_size(n_qubits), 1)) {
+  state_(0, 0) = 1.;
+}
+
+void Trajectory::apply_pauli(unsigned qb, unsigned p) {
+  if (p == 0) return;
+  static const std::vector<std::vector<TripletCd>> paulis = {
+      {},
+      {{0, 1, 1.}, {1, 0, 1.}},
+      {{0, 1, -i_}, {1, 0, i_}},
+      {{0, 0, 1.}, {1, 1, -1.}}};
+  GateNode node;
+  node.triplets = paulis[p];
+  node.qubit_indices = {qb};
+  apply(node);
+}
+
+bool Trajectory::measure(unsigned qb, RNG& rng) {
+  const std::size_t mask = std::size_t(1) << (n_ - 1 - qb);
+  double prob_one = 0.;
+  for (Eigen::Index r = 0; r < state_.rows(); ++r) {
+    if (r & mask) prob_one += std::norm(state_(r, 0));
+  }
+  const bool outcome = get_uniform(rng) < prob_one;
+  for (Eigen::Index r = 0; r < state_.rows(); ++r) {
+    if (bool(r & mask) != outcome) state_(r, 0) = 0.;
+  }
+  state_.normalize();
+  return outcome;
+}
+
+void Trajectory::reset(unsigned qb, RNG& rng) {
+  if (measure(qb, rng)) apply_pauli(qb, 1);
+}
+
+}  // namespace internal
+}  // namespace tket_sim
+}  // namespace tket
@@ -0,0 +1,57 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <tkrng/RNG.hpp>
+
+#include "GateNode.hpp"
+
+namespace tket {
+namespace tket_sim {
+namespace internal {
+
+/** Uniform in [0, 1). */
+double get_uniform(RNG& rng);
+
+/** A statevector evolving under gates and projective measurements,
+ *  starting from |00...0>. Qubit i is bit n-1-i of the amplitude index
+ *  (ILO-BE convention).
+ */
+class Trajectory {
+ public:
+  explicit Trajectory(unsigned n_qubits);
+
+  void apply(const GateNode& node) { node.apply_full_unitary(state_, n_); }
+
+  /** Apply Pauli p (0 = I, 1 = X, 2 = Y, 3 = Z) to a qubit. */
+  void apply_pauli(unsigned qb, unsigned p);
+
+  /** Measure a qubit, collapsing the state. */
+  bool measure(unsigned qb, RNG& rng);
+
+  /** Measure a qubit and reset it to |0>. */
+  void reset(unsigned qb, RNG& rng);
+
+  /** The current state, as a 2^n x 1 matrix. */
+  const Eigen::MatrixXcd& get_state() const { return state_; }
+
+ private:
+  unsigned n_;
+  Eigen::MatrixXcd state_;
+};
+
+}  // namespace internal
+}  // namespace tket_sim
+}  // namespace tket
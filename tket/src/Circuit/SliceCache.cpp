@@ -0,0 +1,229 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/SliceCache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "tket/OpType/OpTypeFunctions.hpp"
+
+namespace tket {
+
+SliceCache::SliceCache(
+    const Circuit &circ, const std::function<bool(Op_ptr)> &skip_func)
+    : circ_(circ), skip_func_(skip_func), slices_(1) {
+  layers_.reserve(circ.n_vertices());
+  heights_.reserve(circ.n_vertices());
+  VertexVec all;
+  all.reserve(circ.n_vertices());
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) { all.push_back(v); }
+  update(all);
+}
+
+unsigned SliceCache::get_layer(const Vertex &vert) const {
+  std::unordered_map<Vertex, unsigned>::const_iterator found =
+      layers_.find(vert);
+  if (found == layers_.end()) {
+    throw MissingVertex("Vertex not present in SliceCache");
+  }
+  return found->second;
+}
+
+unsigned SliceCache::get_height(const Vertex &vert) const {
+  std::unordered_map<Vertex, unsigned>::const_iterator found =
+      heights_.find(vert);
+  if (found == heights_.end()) {
+    throw MissingVertex("Vertex not present in SliceCache");
+  }
+  return found->second;
+}
+
+SliceVec SliceCache::get_slices() const {
+  SliceVec slices;
+  slices.reserve(depth());
+  for (unsigned i = 1; i < slices_.size(); ++i) {
+    slices.emplace_back(slices_[i].begin(), slices_[i].end());
+  }
+  return slices;
+}
+
+VertexVec SliceCache::predecessors(const Vertex &vert) const {
+  VertexVec preds;
+  for (const Edge &e : circ_.get_in_edges(vert)) {
+    const Vertex src = circ_.source(e);
+    preds.push_back(src);
+    if (circ_.get_edgetype(e) == EdgeType::Classical) {
+      // A write to a bit must wait for all reads of its previous value.
+      for (const Edge &b :
+           circ_.get_nth_b_out_bundle(src, circ_.get_source_port(e))) {
+        const Vertex reader = circ_.target(b);
+        if (reader != vert) preds.push_back(reader);
+      }
+    }
+  }
+  return preds;
+}
+
+VertexVec SliceCache::successors(const Vertex &vert) const {
+  VertexVec succs;
+  for (const Edge &e : circ_.get_all_out_edges(vert)) {
+    succs.push_back(circ_.target(e));
+  }
+  // The next write to any bit read by this vertex must wait for it.
+  for (const Edge &e : circ_.get_in_edges_of_type(vert, EdgeType::Boolean)) {
+    const Vertex writer = circ_.target(
+        circ_.get_nth_out_edge(circ_.source(e), circ_.get_source_port(e)));
+    if (writer != vert) succs.push_back(writer);
+  }
+  return succs;
+}
+
+bool SliceCache::occupies_slice(const Vertex &vert) const {
+  const Op_ptr op = circ_.get_Op_ptr_from_Vertex(vert);
+  if (is_boundary_type(op->get_type())) return false;
+  return !(skip_func_ && skip_func_(op));
+}
+
+void SliceCache::set_layer(const Vertex &vert, unsigned layer) {
+  const bool in_slice = occupies_slice(vert);
+  std::pair<std::unordered_map<Vertex, unsigned>::iterator, bool> inserted =
+      layers_.insert({vert, layer});
+  if (!inserted.second) {
+    unsigned &old_layer = inserted.first->second;
+    if (old_layer == layer) return;
+    if (in_slice) slices_[old_layer].erase(vert);
+    old_layer = layer;
+  }
+  if (in_slice) {
+    if (slices_.size() <= layer) slices_.resize(layer + 1);
+    slices_[layer].insert(vert);
+  }
+}
+
+void SliceCache::trim() {
+  while (slices_.size() > 1 && slices_.back().empty()) slices_.pop_back();
+}
+
+void SliceCache::update(const VertexVec &changed) {
+  update_layers(changed);
+  update_heights(changed);
+}
+
+void SliceCache::update_layers(const VertexVec &changed) {
+  // Collect everything downstream of the changed vertices; these layers are
+  // stale until recomputed.
+  VertexSet stale(changed.begin(), changed.end());
+  VertexVec to_search(changed.begin(), changed.end());
+  while (!to_search.empty()) {
+    const Vertex v = to_search.back();
+    to_search.pop_back();
+    for (const Vertex &s : successors(v)) {
+      if (stale.insert(s).second) to_search.push_back(s);
+    }
+  }
+
+  // Recompute in dependency order with an iterative depth-first search, so
+  // that each stale vertex is visited once its predecessors are up to date.
+  // Predecessors unknown to the cache (e.g. newly added vertices) are
+  // computed along the way.
+  VertexSet done;
+  std::vector<std::pair<Vertex, bool>> stack;
+  auto needs_update = [&](const Vertex &v) {
+    return !done.contains(v) && (stale.contains(v) || !layers_.contains(v));
+  };
+  for (const Vertex &root : stale) {
+    if (done.contains(root)) continue;
+    stack.push_back({root, false});
+    while (!stack.empty()) {
+      const Vertex v = stack.back().first;
+      if (done.contains(v)) {
+        stack.pop_back();
+        continue;
+      }
+      VertexVec preds = predecessors(v);
+      if (!stack.back().second) {
+        stack.back().second = true;
+        for (const Vertex &p : preds) {
+          if (needs_update(p)) stack.push_back({p, false});
+        }
+        continue;
+      }
+      stack.pop_back();
+      unsigned layer = 0;
+      for (const Vertex &p : preds) layer = std::max(layer, layers_.at(p));
+      if (occupies_slice(v)) ++layer;
+      set_layer(v, layer);
+      done.insert(v);
+    }
+  }
+  trim();
+}
+
+void SliceCache::update_heights(const VertexVec &changed) {
+  // Mirror image of update_layers: heights upstream of the changed vertices
+  // (which include any new vertices before them) are stale.
+  VertexSet stale(changed.begin(), changed.end());
+  VertexVec to_search(changed.begin(), changed.end());
+  while (!to_search.empty()) {
+    const Vertex v = to_search.back();
+    to_search.pop_back();
+    for (const Vertex &p : predecessors(v)) {
+      if (stale.insert(p).second) to_search.push_back(p);
+    }
+  }
+
+  VertexSet done;
+  std::vector<std::pair<Vertex, bool>> stack;
+  auto needs_update = [&](const Vertex &v) {
+    return !done.contains(v) && (stale.contains(v) || !heights_.contains(v));
+  };
+  for (const Vertex &root : stale) {
+    if (done.contains(root)) continue;
+    stack.push_back({root, false});
+    while (!stack.empty()) {
+      const Vertex v = stack.back().first;
+      if (done.contains(v)) {
+        stack.pop_back();
+        continue;
+      }
+      VertexVec succs = successors(v);
+      if (!stack.back().second) {
+        stack.back().second = true;
+        for (const Vertex &s : succs) {
+          if (needs_update(s)) stack.push_back({s, false});
+        }
+        continue;
+      }
+      stack.pop_back();
+      unsigned height = 0;
+      for (const Vertex &s : succs) {
+        height = std::max(height, heights_.at(s) + (occupies_slice(s) ? 1 : 0));
+      }
+      heights_[v] = height;
+      done.insert(v);
+    }
+  }
+}
+
+void SliceCache::erase(const Vertex &vert) {
+  heights_.erase(vert);
+  std::unordered_map<Vertex, unsigned>::iterator found = layers_.find(vert);
+  if (found == layers_.end()) return;
+  if (found->second < slices_.size()) slices_[found->second].erase(vert);
+  layers_.erase(found);
+  trim();
+}
+
+}  // namespace tket
@@ -14,9 +14,16 @@
 
 #include "tket/Circuit/StatePreparation.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <boost/dynamic_bitset.hpp>
+#include <cmath>
+#include <iterator>
+#include <map>
 #include <stdexcept>
+#include <utility>
 
+#include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Circuit/Multiplexor.hpp"
 #include "tket/Gate/Rotation.hpp"
@@ -189,9 +196,159 @@ static Circuit state_prep_circ(
   return circ;
 };
 
+/**
+ * @brief Construct a circuit that maps a sparse state to the computational
+ * basis 0 state, using O(k*n) gates for a state with k non-zero amplitudes on
+ * n qubits
+ *
+ * Following https://doi.org/10.1109/DAC18074.2021.9586240, each step merges
+ * two basis states of the support: CXs make them differ in a single qubit,
+ * then a rotation of that qubit, controlled on enough other qubits to single
+ * the pair out from the rest of the support, moves their combined amplitude
+ * onto one of them. Real states only need controlled Ry rotations.
+ *
+ * @param support the non-zero amplitudes, by basis state
+ * @param n_qubits
+ * @return Circuit
+ */
+static Circuit sparse_state_unprep_circ(
+    std::map<unsigned long long, Complex> support, unsigned n_qubits) {
+  Circuit circ(n_qubits);
+  bool is_real = true;
+  for (const auto &[x, amplitude] : support) {
+    is_real = is_real && std::abs(amplitude.imag()) < EPS;
+  }
+  auto bit = [n_qubits](unsigned long long x, unsigned q) {
+    return ((x >> (n_qubits - 1 - q)) & 1ULL) == 1ULL;
+  };
+  auto mask = [n_qubits](unsigned q) { return 1ULL << (n_qubits - 1 - q); };
+  while (support.size() > 1) {
+    // pick the closest pair of basis states
+    unsigned long long x0 = 0, x1 = 0;
+    int best_distance = (int)n_qubits + 1;
+    for (auto it0 = support.begin(); it0 != support.end(); it0++) {
+      for (auto it1 = std::next(it0); it1 != support.end(); it1++) {
+        const int distance = std::popcount(it0->first ^ it1->first);
+        if (distance < best_distance) {
+          best_distance = distance;
+          x0 = it0->first;
+          x1 = it1->first;
+        }
+      }
+    }
+    // make them differ only in qubit d
+    unsigned d = 0;
+    while (!bit(x0 ^ x1, d)) d++;
+    const unsigned long long cx_mask = (x0 ^ x1) ^ mask(d);
+    if (cx_mask != 0) {
+      for (unsigned q = d + 1; q < n_qubits; q++) {
+        if (bit(cx_mask, q)) circ.add_op<unsigned>(OpType::CX, {d, q});
+      }
+      std::map<unsigned long long, Complex> permuted;
+      for (const auto &[x, amplitude] : support) {
+        permuted.insert({bit(x, d) ? x ^ cx_mask : x, amplitude});
+      }
+      support = std::move(permuted);
+      if (bit(x0, d)) {
+        x0 ^= cx_mask;
+      } else {
+        x1 ^= cx_mask;
+      }
+    }
+    if (bit(x0, d)) std::swap(x0, x1);
+    // choose controls that tell x0 apart from the rest of the support
+    std::vector<unsigned long long> others;
+    for (const auto &[x, amplitude] : support) {
+      if (x != x0 && x != x1) others.push_back(x);
+    }
+    std::vector<unsigned> args;
+    std::vector<bool> control_state;
+    while (!others.empty()) {
+      unsigned best_q = 0;
+      std::size_t best_count = 0;
+      for (unsigned q = 0; q < n_qubits; q++) {
+        if (q == d) continue;
+        const std::size_t count = std::count_if(
+            others.begin(), others.end(),
+            [&](unsigned long long y) { return bit(y, q) != bit(x0, q); });
+        if (count > best_count) {
+          best_count = count;
+          best_q = q;
+        }
+      }
+      TKET_ASSERT(best_count > 0);
+      args.push_back(best_q);
+      control_state.push_back(bit(x0, best_q));
+      others.erase(
+          std::remove_if(
+              others.begin(), others.end(),
+              [&](unsigned long long y) {
+                return bit(y, best_q) != bit(x0, best_q);
+              }),
+          others.end());
+    }
+    // rotate the amplitudes [a, b] of x0 and x1 to [r, 0]
+    const Complex a = support[x0];
+    const Complex b = support[x1];
+    const double r = std::sqrt(std::norm(a) + std::norm(b));
+    Op_ptr rotation;
+    if (is_real) {
+      rotation = get_op_ptr(
+          OpType::Ry, 2 * std::atan2(-b.real(), a.real()) / PI);
+    } else {
+      Eigen::Matrix2cd u;
+      u << std::conj(a), std::conj(b), -b, a;
+      rotation = std::make_shared<Unitary1qBox>(u / r);
+    }
+    const unsigned n_controls = (unsigned)args.size();
+    args.push_back(d);
+    if (n_controls == 0) {
+      circ.add_op<unsigned>(rotation, args);
+    } else {
+      circ.add_box(QControlBox(rotation, n_controls, control_state), args);
+    }
+    support.erase(x1);
+    support[x0] = r;
+  }
+  // map the remaining basis state to 0
+  const auto &[x, amplitude] = *support.begin();
+  for (unsigned q = 0; q < n_qubits; q++) {
+    if (bit(x, q)) circ.add_op<unsigned>(OpType::X, {q});
+  }
+  circ.add_phase(-std::arg(amplitude) / PI);
+  return circ;
+}
+
+/**
+ * @brief Whether to prepare a state with n_nonzero non-zero amplitudes using
+ * sparse_state_unprep_circ rather than state_prep_circ
+ *
+ * Each merge of the sparse synthesis costs at most n_qubits CXs and a
+ * multi-controlled rotation, while the multiplexors of state_prep_circ cost
+ * about 2^(n_qubits+1) CXs whatever the state.
+ */
+static bool use_sparse_synthesis(std::size_t n_nonzero, unsigned n_qubits) {
+  return n_qubits * (n_nonzero - 1) < (1ULL << n_qubits);
+}
+
 void StatePreparationBox::generate_circuit() const {
-  circ_ = std::make_shared<Circuit>(
-      state_prep_circ(statevector_, is_inverse_, with_initial_reset_));
+  std::map<unsigned long long, Complex> support;
+  for (Eigen::Index i = 0; i < statevector_.size(); i++) {
+    if (std::abs(statevector_[i]) > EPS) {
+      support.insert({(unsigned long long)i, statevector_[i]});
+    }
+  }
+  if (!use_sparse_synthesis(support.size(), n_qubits_)) {
+    circ_ = std::make_shared<Circuit>(
+        state_prep_circ(statevector_, is_inverse_, with_initial_reset_));
+    return;
+  }
+  Circuit unprep = sparse_state_unprep_circ(support, n_qubits_);
+  Circuit circ = is_inverse_ ? unprep : unprep.dagger();
+  if (with_initial_reset_) {
+    circ.qubit_create_all();
+  }
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 bool StatePreparationBox::is_equal(const Op &op_other) const {
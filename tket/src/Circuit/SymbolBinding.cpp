@@ -0,0 +1,205 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Circuit/SymbolBinding.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <symengine/lambda_double.h>
+#include <thread>
+#include <utility>
+
+#include "tket/Gate/OpPtrFunctions.hpp"
+
+namespace tket {
+
+// A parameter compiled to a function of the symbol values
+struct SymbolBindingPlan::Lambda {
+  SymEngine::LambdaRealDoubleVisitor visitor;
+
+  Lambda(const SymEngine::vec_basic& symbols, const Expr& e) {
+    visitor.init(symbols, *e.get_basic());
+  }
+
+  double operator()(const std::vector<double>& values) const {
+    return visitor.call(values);
+  }
+};
+
+// An operation with symbolic parameters. For a gate, each parameter that
+// depends on a symbol has a compiled function; other operations are
+// substituted symbolically.
+struct SymbolBindingPlan::Entry {
+  std::size_t position;
+  Op_ptr op;
+  bool is_gate;
+  std::vector<std::unique_ptr<Lambda>> lambdas;
+};
+
+SymbolBindingPlan::SymbolBindingPlan(
+    const Circuit& circ, const std::vector<Sym>& symbols)
+    : circ_(circ), symbols_(symbols) {
+  SymSet known;
+  for (const Sym& s : symbols) {
+    if (!known.insert(s).second) {
+      throw std::invalid_argument(
+          "Symbol " + s->get_name() + " is repeated in binding plan");
+    }
+  }
+  for (const Sym& s : circ.free_symbols()) {
+    if (known.find(s) == known.end()) {
+      throw std::invalid_argument(
+          "Circuit symbol " + s->get_name() + " is missing from binding plan");
+    }
+  }
+  const SymEngine::vec_basic args(symbols.begin(), symbols.end());
+  // Copying a circuit preserves the order of its vertices, so an entry's
+  // position identifies its vertex in every copy of circ_.
+  std::size_t position = 0;
+  BGL_FORALL_VERTICES(v, circ_.dag, DAG) {
+    Op_ptr op = circ_.get_Op_ptr_from_Vertex(v);
+    if (!op->free_symbols().empty()) {
+      Entry entry{position, op, op->get_desc().is_gate(), {}};
+      if (entry.is_gate) {
+        for (const Expr& e : op->get_params()) {
+          if (expr_free_symbols(e).empty()) {
+            entry.lambdas.push_back(nullptr);
+          } else {
+            entry.lambdas.push_back(std::make_unique<Lambda>(args, e));
+          }
+        }
+      }
+      entries_.push_back(std::move(entry));
+    }
+    ++position;
+  }
+  const Expr phase = circ_.get_phase();
+  if (!expr_free_symbols(phase).empty()) {
+    phase_ = std::make_unique<Lambda>(args, phase);
+    circ_.add_phase(-phase);
+  }
+}
+
+SymbolBindingPlan::~SymbolBindingPlan() = default;
+
+std::size_t SymbolBindingPlan::n_compiled_params() const {
+  std::size_t n = phase_ ? 1 : 0;
+  for (const Entry& entry : entries_) {
+    n += std::count_if(
+        entry.lambdas.begin(), entry.lambdas.end(),
+        [](const std::unique_ptr<Lambda>& l) { return l != nullptr; });
+  }
+  return n;
+}
+
+void SymbolBindingPlan::check_size(const std::vector<double>& values) const {
+  if (values.size() != symbols_.size()) {
+    throw std::invalid_argument(
+        "Binding plan expects " + std::to_string(symbols_.size()) +
+        " values but was given " + std::to_string(values.size()));
+  }
+}
+
+Circuit SymbolBindingPlan::bind(const std::vector<double>& values) const {
+  check_size(values);
+  Circuit circ = circ_;
+  // Built only if some operation needs symbolic substitution
+  std::optional<SymEngine::map_basic_basic> sub_map;
+  auto substitute = [&](const Op_ptr& op) {
+    if (!sub_map) {
+      sub_map.emplace();
+      for (std::size_t i = 0; i < symbols_.size(); ++i) {
+        (*sub_map)[symbols_[i]] = Expr(values[i]).get_basic();
+      }
+    }
+    return op->symbol_substitution(*sub_map);
+  };
+  std::vector<Entry>::const_iterator entry = entries_.begin();
+  std::size_t position = 0;
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+    if (entry == entries_.end()) break;
+    if (position++ != entry->position) continue;
+    Op_ptr new_op;
+    if (entry->is_gate) {
+      std::vector<Expr> params = entry->op->get_params();
+      bool finite = true;
+      for (std::size_t i = 0; i < params.size(); ++i) {
+        const std::unique_ptr<Lambda>& lambda = entry->lambdas[i];
+        if (lambda) {
+          const double x = (*lambda)(values);
+          finite = finite && std::isfinite(x);
+          params[i] = x;
+        }
+      }
+      // Leave removable singularities to the symbolic substitution
+      new_op = finite ? get_op_ptr(
+                            entry->op->get_type(), params,
+                            entry->op->n_qubits())
+                      : substitute(entry->op);
+    } else {
+      new_op = substitute(entry->op);
+    }
+    if (new_op) circ.set_vertex_Op_ptr(v, new_op);
+    ++entry;
+  }
+  if (phase_) circ.add_phase((*phase_)(values));
+  return circ;
+}
+
+std::vector<Circuit> SymbolBindingPlan::bind_all(
+    const std::vector<std::vector<double>>& values, unsigned n_threads) const {
+  for (const std::vector<double>& v : values) check_size(v);
+  const std::size_t n = values.size();
+  std::vector<Circuit> circuits(n);
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::atomic<std::size_t> next_index{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&]() {
+    try {
+      for (std::size_t i = next_index++; i < n; i = next_index++) {
+        circuits[i] = bind(values[i]);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_index = n;
+    }
+  };
+  const std::size_t number_of_threads =
+      std::min<std::size_t>(n_threads, std::max<std::size_t>(n, 1));
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return circuits;
+}
+
+}  // namespace tket
@@ -14,8 +14,15 @@
 
 #include "tket/Circuit/ToffoliBox.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <boost/graph/max_cardinality_matching.hpp>
+#include <exception>
+#include <mutex>
+#include <numeric>
 #include <optional>
+#include <thread>
+#include <unordered_map>
 
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Circuit/DiagonalBox.hpp"
@@ -34,30 +41,62 @@ static unsigned get_perm_size(const state_perm_t &permutation) {
   }
   auto it = permutation.begin();
   unsigned n = it->first.size();
-  // verify the permutation is valid
+  for (; it != permutation.end(); ++it) {
+    if (it->first.size() != n || it->second.size() != n) {
+      throw std::invalid_argument(
+          "The permutation argument passed to ToffoliBox contains bitstrings "
+          "with different sizes.");
+    }
+  }
+  return n;
+}
+
+static packed_state_perm_t pack_permutation(const state_perm_t &permutation) {
+  packed_state_perm_t packed;
+  packed.reserve(permutation.size());
+  for (const auto &[from, to] : permutation) {
+    packed.push_back(
+        {(std::uint32_t)bin_to_dec(from), (std::uint32_t)bin_to_dec(to)});
+  }
+  return packed;
+}
+
+// sort the permutation by source state and verify it is valid
+static packed_state_perm_t check_permutation(
+    unsigned n, packed_state_perm_t permutation) {
+  if (permutation.size() == 0) {
+    throw std::invalid_argument(
+        "The permutation argument passed to ToffoliBox is empty.");
+  }
   if (n > 32) {
     throw std::invalid_argument(
         "ToffoliBox only supports permutation up to 32 bits.");
   }
-  // we need to check every element has the same size, and every bitstrings
-  // appears twice
-  std::set<std::vector<bool>> rhs_states;
-  std::set<std::vector<bool>> lhs_states;
-  for (; it != permutation.end(); ++it) {
-    if (it->first.size() != n || it->second.size() != n) {
+  std::sort(permutation.begin(), permutation.end());
+  // we need to check every state is below 2^n, and every state appears
+  // once on each side
+  std::vector<std::uint32_t> lhs_states, rhs_states;
+  lhs_states.reserve(permutation.size());
+  rhs_states.reserve(permutation.size());
+  for (const auto &[from, to] : permutation) {
+    if ((unsigned long long)from >> n != 0 ||
+        (unsigned long long)to >> n != 0) {
       throw std::invalid_argument(
           "The permutation argument passed to ToffoliBox contains bitstrings "
           "with different sizes.");
     }
-    lhs_states.insert(it->first);
-    rhs_states.insert(it->second);
+    lhs_states.push_back(from);
+    rhs_states.push_back(to);
   }
-  if (lhs_states != rhs_states) {
+  std::sort(rhs_states.begin(), rhs_states.end());
+  if (std::adjacent_find(lhs_states.begin(), lhs_states.end()) !=
+          lhs_states.end() ||
+      lhs_states != rhs_states) {
     throw std::invalid_argument(
         "The permutation argument passed to ToffoliBox is not complete because "
         "some states aren't mapped.");
   }
-  return n;
+  return permutation;
 }
 
 ToffoliBox::ToffoliBox(
@@ -66,7 +105,22 @@ ToffoliBox::ToffoliBox(
     : Box(OpType::ToffoliBox),
       n_(get_perm_size(permutation)),
       pow2n_(1u << n_),
-      permutation_(permutation),
+      permutation_(check_permutation(n_, pack_permutation(permutation))),
+      strat_(strat),
+      rotation_axis_(rotation_axis) {
+  if (rotation_axis != OpType::Rx && rotation_axis != OpType::Ry) {
+    throw std::invalid_argument(
+        "The rotation_axis argument passed to ToffoliBox must be Rx or Ry.");
+  }
+}
+
+ToffoliBox::ToffoliBox(
+    unsigned n_qubits, const packed_state_perm_t &permutation,
+    const ToffoliBoxSynthStrat &strat, const OpType &rotation_axis)
+    : Box(OpType::ToffoliBox),
+      n_(n_qubits),
+      pow2n_(1u << n_),
+      permutation_(check_permutation(n_, permutation)),
       strat_(strat),
       rotation_axis_(rotation_axis) {
   if (rotation_axis != OpType::Rx && rotation_axis != OpType::Ry) {
@@ -85,21 +139,21 @@ ToffoliBox::ToffoliBox(const ToffoliBox &other)
 
 std::optional<Eigen::MatrixXcd> ToffoliBox::get_box_unitary() const {
   Eigen::MatrixXcd U = Eigen::MatrixXcd::Identity(pow2n_, pow2n_);
-  for (const auto &pair : permutation_) {
-    const unsigned i = bin_to_dec(pair.second);
-    const unsigned j = bin_to_dec(pair.first);
-    U(i, i) = 0.;
-    U(i, j) = 1.;
+  for (const auto &[from, to] : permutation_) {
+    U(to, to) = 0.;
+    U(to, from) = 1.;
   }
   return U;
 }
 
 Op_ptr ToffoliBox::dagger() const {
-  state_perm_t reverse_perm;
-  for (auto it = permutation_.begin(); it != permutation_.end(); it++) {
-    reverse_perm.insert({it->second, it->first});
+  packed_state_perm_t reverse_perm;
+  reverse_perm.reserve(permutation_.size());
+  for (const auto &[from, to] : permutation_) {
+    reverse_perm.push_back({to, from});
   }
-  return std::make_shared<ToffoliBox>(reverse_perm, strat_, rotation_axis_);
+  return std::make_shared<ToffoliBox>(
+      n_, reverse_perm, strat_, rotation_axis_);
 }
 
 Op_ptr ToffoliBox::transpose() const { return dagger(); }
@@ -109,7 +163,14 @@ op_signature_t ToffoliBox::get_signature() const {
   return qubits;
 }
 
-state_perm_t ToffoliBox::get_permutation() const { return permutation_; }
+state_perm_t ToffoliBox::get_permutation() const {
+  state_perm_t permutation;
+  for (const auto &[from, to] : permutation_) {
+    permutation.insert(
+        permutation.end(), {dec_to_bin(from, n_), dec_to_bin(to, n_)});
+  }
+  return permutation;
+}
 
 OpType ToffoliBox::get_rotation_axis() const { return rotation_axis_; }
 
@@ -119,10 +180,20 @@ typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>
     cube_graph_t;
 typedef boost::graph_traits<cube_graph_t>::vertex_descriptor perm_vert_t;
 
-static std::vector<std::vector<bool>> rearrange_along_col(
-    const std::vector<bool> &prefix, unsigned n_qubits, unsigned col_idx,
-    state_perm_t &perm) {
-  unsigned n_right_columns = n_qubits - prefix.size() - 1;
+// Insert a 0 into the n-1 bit integer pair, so that it becomes bit col_idx of
+// an n bit integer, counting from the most significant bit
+static unsigned long long insert_zero(
+    unsigned long long pair, unsigned n_qubits, unsigned col_idx) {
+  const unsigned n_right = n_qubits - 1 - col_idx;
+  const unsigned long long right = pair & ((1ULL << n_right) - 1);
+  return ((pair >> n_right) << (n_right + 1)) | right;
+}
+
+static std::vector<unsigned long long> rearrange_along_col(
+    unsigned long long prefix, unsigned n_qubits, unsigned col_idx,
+    const std::vector<std::uint32_t> &perm) {
+  unsigned n_right_columns = n_qubits - col_idx - 1;
+  const unsigned long long postfix_mask = (1ULL << n_right_columns) - 1;
   // Given a group of rows identified by a shared prefix and col_idx in {0,1}
   // we rearrange these rows such that the bits(called postfix) after col_idx
   // in their indices span the entire n_right_columns-bit space
@@ -138,28 +209,22 @@ static std::vector<std::vector<bool>> rearrange_along_col(
   cube_graph_t g(1ULL << (n_right_columns + 1));
   for (unsigned long long postfix_dec = 0;
        postfix_dec < (1ULL << n_right_columns); postfix_dec++) {
-    std::vector<bool> postfix = dec_to_bin(postfix_dec, n_right_columns);
     // row0 = prefix+0+postfix
     // row1 = prefix+1+postfix
-    std::vector<bool> row0(prefix);
-    std::vector<bool> row1(prefix);
-    row0.push_back(0);
-    row0.insert(row0.end(), postfix.begin(), postfix.end());
-    row1.push_back(1);
-    row1.insert(row1.end(), postfix.begin(), postfix.end());
+    const unsigned long long row0 =
+        (prefix << (n_right_columns + 1)) | postfix_dec;
+    const unsigned long long row1 = row0 | (1ULL << n_right_columns);
     // the postfix of row0's index
-    std::vector<bool> idx0_postfix(
-        perm[row0].begin() + prefix.size() + 1, perm[row0].end());
+    const unsigned long long idx0_postfix = perm[row0] & postfix_mask;
     // the postfix of row1's index
-    std::vector<bool> idx1_postfix(
-        perm[row1].begin() + prefix.size() + 1, perm[row1].end());
+    const unsigned long long idx1_postfix = perm[row1] & postfix_mask;
     // row0 can stay where it is
     boost::add_edge(
-        postfix_dec, bin_to_dec(idx0_postfix) + (1ULL << n_right_columns), g);
+        postfix_dec, idx0_postfix + (1ULL << n_right_columns), g);
     if (idx0_postfix != idx1_postfix) {
       // row0 can also move to row1's index by a swap
       boost::add_edge(
-          postfix_dec, bin_to_dec(idx1_postfix) + (1ULL << n_right_columns), g);
+          postfix_dec, idx1_postfix + (1ULL << n_right_columns), g);
     }
   }
   // find a matching
@@ -169,41 +234,32 @@ static std::vector<std::vector<bool>> rearrange_along_col(
   // TODO: use a specialised algo for bipartite matching
   // e.g. Hopcroft-Karp for O(|E| sqrt(|V|))
   edmonds_maximum_cardinality_matching(g, &match[0]);
-  std::vector<std::vector<bool>> swap_pairs;
+  std::vector<unsigned long long> swap_pairs;
   for (unsigned long long postfix_dec = 0;
        postfix_dec < (1ULL << n_right_columns); postfix_dec++) {
-    std::vector<bool> postfix = dec_to_bin(postfix_dec, n_right_columns);
-    std::vector<bool> row0(prefix);
-    row0.push_back(0);
-    row0.insert(row0.end(), postfix.begin(), postfix.end());
-    std::vector<bool> mapped_idx = dec_to_bin(
-        match[postfix_dec] - (1ULL << n_right_columns), n_right_columns);
-    if (!std::equal(
-            perm[row0].begin() + prefix.size() + 1, perm[row0].end(),
-            mapped_idx.begin())) {
+    const unsigned long long row0 =
+        (prefix << (n_right_columns + 1)) | postfix_dec;
+    const unsigned long long mapped_idx =
+        match[postfix_dec] - (1ULL << n_right_columns);
+    if ((perm[row0] & postfix_mask) != mapped_idx) {
       // row0 matched to row1's index
-      row0.erase(row0.begin() + col_idx);
-      swap_pairs.push_back(row0);
+      swap_pairs.push_back((prefix << n_right_columns) | postfix_dec);
     }
   }
   return swap_pairs;
 }
 
 static void swap_rows(
-    const std::vector<bool> &pair, unsigned col_idx, state_perm_t &perm,
-    ctrl_op_map_t &op_map, std::vector<Complex> &phases,
-    const Op_ptr &zflip_op) {
+    unsigned long long pair, unsigned n_qubits, unsigned col_idx,
+    std::vector<std::uint32_t> &perm, ctrl_op_map_t &op_map,
+    std::vector<Complex> &phases, const Op_ptr &zflip_op) {
   // swap a pair of rows along col_idx
   // assume two rows only differ at q
   // update op_map, phases, and permutation
-  std::vector<bool> row0(pair);
-  std::vector<bool> row1(pair);
-  row0.insert(row0.begin() + col_idx, 0);
-  row1.insert(row1.begin() + col_idx, 1);
-  std::swap(perm.at(row0), perm.at(row1));
-  // phases is a vector, convert rows to decimal to track phases
-  unsigned row0_dec = bin_to_dec(row0);
-  unsigned row1_dec = bin_to_dec(row1);
+  const unsigned long long row0_dec = insert_zero(pair, n_qubits, col_idx);
+  const unsigned long long row1_dec =
+      row0_dec | (1ULL << (n_qubits - 1 - col_idx));
+  std::swap(perm[row0_dec], perm[row1_dec]);
   // we currently only support Rx(pi) and Ry(pi) for permuting states
   // we might introduce Rx(-pi) or Ry(-pi) in the future. Also, dynamically
   // choosing between these 4 might give possible phase cancellation
@@ -226,7 +282,7 @@ static void swap_rows(
         "rotations.");
   }
   std::swap(phases[row0_dec], phases[row1_dec]);
-  op_map.insert({pair, zflip_op});
+  op_map.insert({dec_to_bin(pair, n_qubits - 1), zflip_op});
 }
 
 static std::vector<unsigned> get_multiplexor_args(
@@ -241,14 +297,16 @@ static std::vector<unsigned> get_multiplexor_args(
 /**
  * @brief Construct a state permutation circuit
  *
- * @param perm permutation
+ * @param perm permutation, as the packed index of the state currently at
+ * each row
  * @param n_qubits number of qubits
  * @param zflip_op the base 1-q rotation for swap two states. Currently limited
  * to Rx(1) and Ry(1)
  * @return Circuit
  */
 static Circuit permute(
-    state_perm_t &perm, unsigned n_qubits, const Op_ptr &zflip_op) {
+    std::vector<std::uint32_t> &perm, unsigned n_qubits,
+    const Op_ptr &zflip_op) {
   // Consider the permutation map as a boolean matrix with n columns and 2^n
   // rows. Row i contains current location of the coefficient that needs to be
   // permutated to the state |i>. We want to sort the rows such that the value
@@ -267,13 +325,13 @@ static Circuit permute(
   // its row index, swap it with row R' where R and R' only differ at the jth
   // bit. All the swaps can be done with one multiplexor targeting q[j].
 
-  // In the implementation, we use a map from rows to rows indices to represent
-  // the matrix defined in the algorithm.
+  // In the implementation, we use a vector of packed row indices, indexed by
+  // packed rows, to represent the matrix defined in the algorithm.
 
   Circuit circ(n_qubits);
   // special case
   if (n_qubits == 1) {
-    if (perm.begin()->first != perm.begin()->second) {
+    if (perm[0] != 0) {
       circ.add_op<unsigned>(OpType::X, {0});
     }
     return circ;
@@ -284,19 +342,13 @@ static Circuit permute(
   for (unsigned col_idx = 0; col_idx < n_qubits - 1; col_idx++) {
     ctrl_op_map_t op_map;
     for (unsigned long long prefix = 0; prefix < (1ULL << col_idx); prefix++) {
-      std::vector<bool> prefix_bin;
-      if (col_idx != 0) {
-        // if col_idx == 0, the prefix is empty, otherwise convert the decimal
-        // prefix to its binary representation
-        prefix_bin = dec_to_bin(prefix, col_idx);
-      }
-      std::vector<std::vector<bool>> swap_pairs =
-          rearrange_along_col(prefix_bin, n_qubits, col_idx, perm);
-      for (const std::vector<bool> &pair : swap_pairs) {
+      std::vector<unsigned long long> swap_pairs =
+          rearrange_along_col(prefix, n_qubits, col_idx, perm);
+      for (unsigned long long pair : swap_pairs) {
         // swap_rows mutates the perm (current permutation), phases (phases
         // accumulated by using SU2 gates) and also updates the op_map to
         // indicate which pairs of rows to swap
-        swap_rows(pair, col_idx, perm, op_map, phases, zflip_op);
+        swap_rows(pair, n_qubits, col_idx, perm, op_map, phases, zflip_op);
       }
     }
     if (!op_map.empty()) {
@@ -308,12 +360,12 @@ static Circuit permute(
   // step 2
   for (unsigned col_idx = n_qubits; col_idx-- > 0;) {
     ctrl_op_map_t op_map;
-    for (unsigned long long row = 0; row < (1ULL << (n_qubits - 1)); row++) {
-      std::vector<bool> pair = dec_to_bin(row, n_qubits - 1);
-      pair.insert(pair.begin() + col_idx, 0);
-      if (perm[pair][col_idx] != 0) {
-        pair.erase(pair.begin() + col_idx);
-        swap_rows(pair, col_idx, perm, op_map, phases, zflip_op);
+    const unsigned col_shift = n_qubits - 1 - col_idx;
+    for (unsigned long long pair = 0; pair < (1ULL << (n_qubits - 1));
+         pair++) {
+      const unsigned long long row0 = insert_zero(pair, n_qubits, col_idx);
+      if ((perm[row0] >> col_shift) & 1U) {
+        swap_rows(pair, n_qubits, col_idx, perm, op_map, phases, zflip_op);
       }
     }
     if (!op_map.empty()) {
@@ -324,7 +376,7 @@ static Circuit permute(
   }
   // correct the phases with a diagonal operator
   Eigen::VectorXcd corrections(1ULL << n_qubits);
-  for (unsigned i = 0; i < phases.size(); i++) {
+  for (unsigned long long i = 0; i < phases.size(); i++) {
     corrections[i] = 1. / phases[i];
   }
   DiagonalBox diag(corrections);
@@ -333,23 +385,19 @@ static Circuit permute(
 }
 
 static Circuit gen_circuit_using_toffoli_gates(
-    state_perm_t &perm, unsigned n_qubits);
+    const packed_state_perm_t &perm, unsigned n_qubits);
 
 void ToffoliBox::generate_circuit() const {
-  state_perm_t perm(permutation_);
   if (this->strat_ == ToffoliBoxSynthStrat::Cycle) {
-    circ_ =
-        std::make_shared<Circuit>(gen_circuit_using_toffoli_gates(perm, n_));
+    circ_ = std::make_shared<Circuit>(
+        gen_circuit_using_toffoli_gates(permutation_, n_));
     return;
   }
   // fill the permutation with identities
-  if (perm.size() != pow2n_) {
-    for (unsigned long long i = 0; i < pow2n_; i++) {
-      std::vector<bool> state = dec_to_bin(i, n_);
-      if (perm.find(state) == perm.end()) {
-        perm.insert({state, state});
-      }
-    }
+  std::vector<std::uint32_t> perm(pow2n_);
+  std::iota(perm.begin(), perm.end(), 0);
+  for (const auto &[from, to] : permutation_) {
+    perm[from] = to;
   }
   circ_ = std::make_shared<Circuit>(
       permute(perm, n_, get_op_ptr(rotation_axis_, 1)));
@@ -357,26 +405,31 @@ void ToffoliBox::generate_circuit() const {
 
 // check every key k in a,
 // either 1. a[k] == b[k] or 2. k is not in b and a[k]==k
-static bool oneway_perm_compare(const state_perm_t &a, const state_perm_t &b) {
-  for (auto ita = a.begin(); ita != a.end(); ita++) {
-    auto b_entry = b.find(ita->first);
-    if (b_entry == b.end() && ita->first != ita->second) {
+static bool oneway_perm_compare(
+    const packed_state_perm_t &a, const packed_state_perm_t &b) {
+  for (const auto &[from, to] : a) {
+    auto b_entry = std::lower_bound(
+        b.begin(), b.end(), std::make_pair(from, std::uint32_t{0}));
+    const bool found = b_entry != b.end() && b_entry->first == from;
+    if (!found && from != to) {
       return false;
     }
-    if (b_entry != b.end() && b_entry->second != ita->second) {
+    if (found && b_entry->second != to) {
       return false;
     }
   }
   return true;
 }
-static bool perm_compare(const state_perm_t &a, const state_perm_t &b) {
+static bool perm_compare(
+    const packed_state_perm_t &a, const packed_state_perm_t &b) {
   return oneway_perm_compare(a, b) && oneway_perm_compare(b, a);
 }
 
 bool ToffoliBox::is_equal(const Op &op_other) const {
   const ToffoliBox &other = dynamic_cast<const ToffoliBox &>(op_other);
   if (id_ == other.get_id()) return true;
-  return strat_ == other.strat_ && rotation_axis_ == other.rotation_axis_ &&
+  return n_ == other.n_ && strat_ == other.strat_ &&
+         rotation_axis_ == other.rotation_axis_ &&
          perm_compare(permutation_, other.permutation_);
 }
 
@@ -438,61 +491,36 @@ static cycle_transposition_t cycle_to_transposition(cycle_permutation_t cycle) {
   return best_transposition;
 }
 
-static std::vector<cycle_transposition_t> get_transpositions(
-    const std::set<cycle_permutation_t> &cycles) {
-  std::vector<cycle_transposition_t> transpositions;
-  for (const cycle_permutation_t &cycle : cycles) {
-    // each cycle is costed via the Hamming distance to reduce the number of
-    // operations
-    transpositions.push_back(cycle_to_transposition(cycle));
-  }
-  return transpositions;
-}
-
-static cycle_transposition_t merge_cycles(
-    std::vector<cycle_transposition_t> &cycle_transpositions) {
-  cycle_transposition_t return_transposition;
-  for (unsigned k = 0; k < cycle_transpositions.size(); k++) {
-    cycle_transposition_t cycle = cycle_transpositions[k];
-    unsigned i = 0, j = 1;
-    while (j < cycle.size()) {
-      transposition_t transposition_i = cycle[i];
-      transposition_t transposition_j = cycle[j];
-
-      std::vector<bool> transposition_j_first = transposition_j.first;
-      std::vector<bool> transposition_i_last = transposition_i.last;
-      std::vector<bool> transposition_i_first = transposition_i.first;
-
-      TKET_ASSERT(transposition_i_last == transposition_j.first);
-      std::vector<bool> i_middle = transposition_i.middle;
-      std::vector<bool> j_middle = transposition_j.middle;
-
-      TKET_ASSERT(i_middle.size() == transposition_i.last.size());
-      TKET_ASSERT(j_middle.size() == transposition_i.last.size());
-      // if a transposition has already been reduced, still need to make sure we
-      // uncompute it
-      if (transposition_i_first != transposition_i_last) {
-        unsigned middle_last_distance =
-            get_hamming_distance(i_middle, transposition_i_last);
-        unsigned middle_first_distance =
-            get_hamming_distance(i_middle, transposition_i_first);
-        // this => the reduced transposition is on a good gray code between the
-        // new "first" and target
-        if (middle_first_distance < middle_last_distance &&
-            middle_first_distance > 1) {
-          transposition_i_last = transposition_i_first;
-          std::vector<bool> starting_point = transposition_i_last;
-          for (unsigned k = 0; k < i_middle.size(); k++) {
-            if (i_middle[k] == j_middle[k] &&
-                get_hamming_distance(starting_point, i_middle) > 1) {
-              starting_point[k] = i_middle[k];
-            }
-          }
-
-          cycle_transpositions[k][i].last = starting_point;
-          cycle_transpositions[k][j].first = starting_point;
-        }
-      } else {  // else in this case just find any good transposition
+static cycle_transposition_t merge_cycle(
+    cycle_transposition_t &cycle_transposition) {
+  cycle_transposition_t cycle = cycle_transposition;
+  unsigned i = 0, j = 1;
+  while (j < cycle.size()) {
+    transposition_t transposition_i = cycle[i];
+    transposition_t transposition_j = cycle[j];
+
+    std::vector<bool> transposition_j_first = transposition_j.first;
+    std::vector<bool> transposition_i_last = transposition_i.last;
+    std::vector<bool> transposition_i_first = transposition_i.first;
+
+    TKET_ASSERT(transposition_i_last == transposition_j.first);
+    std::vector<bool> i_middle = transposition_i.middle;
+    std::vector<bool> j_middle = transposition_j.middle;
+
+    TKET_ASSERT(i_middle.size() == transposition_i.last.size());
+    TKET_ASSERT(j_middle.size() == transposition_i.last.size());
+    // if a transposition has already been reduced, still need to make sure we
+    // uncompute it
+    if (transposition_i_first != transposition_i_last) {
+      unsigned middle_last_distance =
+          get_hamming_distance(i_middle, transposition_i_last);
+      unsigned middle_first_distance =
+          get_hamming_distance(i_middle, transposition_i_first);
+      // this => the reduced transposition is on a good gray code between the
+      // new "first" and target
+      if (middle_first_distance < middle_last_distance &&
+          middle_first_distance > 1) {
+        transposition_i_last = transposition_i_first;
         std::vector<bool> starting_point = transposition_i_last;
         for (unsigned k = 0; k < i_middle.size(); k++) {
           if (i_middle[k] == j_middle[k] &&
@@ -501,19 +529,26 @@ static cycle_transposition_t merge_cycles(
           }
         }
 
-        cycle[i].last = starting_point;
-        cycle[j].first = starting_point;
+        cycle_transposition[i].last = starting_point;
+        cycle_transposition[j].first = starting_point;
+      }
+    } else {  // else in this case just find any good transposition
+      std::vector<bool> starting_point = transposition_i_last;
+      for (unsigned k = 0; k < i_middle.size(); k++) {
+        if (i_middle[k] == j_middle[k] &&
+            get_hamming_distance(starting_point, i_middle) > 1) {
+          starting_point[k] = i_middle[k];
+        }
       }
 
-      ++i;
-      ++j;
+      cycle[i].last = starting_point;
+      cycle[j].first = starting_point;
     }
 
-    return_transposition.insert(
-        return_transposition.end(), cycle.begin(), cycle.end());
+    ++i;
+    ++j;
   }
-
-  return return_transposition;
+  return cycle;
 }
 
 static gray_code_t transposition_to_gray_code(
@@ -589,76 +624,120 @@ static gray_code_t transposition_to_gray_code(
   return all_gray_code_entries;
 }
 
-Circuit get_bitstring_circuit(
-    const std::vector<bool> &bitstring, const unsigned &target,
-    const unsigned &n_qubits) {
+// add a CnX targeting target, controlled on the other qubits being in the
+// state given by bitstring
+static void add_bitstring_cnx(
+    Circuit &circ, const std::vector<bool> &bitstring, unsigned target,
+    unsigned n_qubits) {
   // flip qubits that need to be state 0
-  Circuit x_circuit(n_qubits);
   std::vector<unsigned> cnx_args;
   for (unsigned i = 0; i < n_qubits; i++) {
     if (i != target) {
       if (!bitstring[i]) {
-        x_circuit.add_op<unsigned>(OpType::X, {i});
+        circ.add_op<unsigned>(OpType::X, {i});
       }
       cnx_args.push_back(i);
     }
   }
   cnx_args.push_back(target);
   TKET_ASSERT(cnx_args.size() == n_qubits);
+  circ.add_op<unsigned>(OpType::CnX, cnx_args);
+  for (unsigned i = 0; i < n_qubits; i++) {
+    if (i != target && !bitstring[i]) {
+      circ.add_op<unsigned>(OpType::X, {i});
+    }
+  }
+}
 
-  Circuit return_circuit(n_qubits);
-  return_circuit.append(x_circuit);
-  return_circuit.add_op<unsigned>(OpType::CnX, cnx_args);
-  return_circuit.append(x_circuit);
-  return return_circuit;
+// the gray codes implementing one cycle of the permutation
+static gray_code_t cycle_to_gray_code(
+    const std::vector<std::uint32_t> &packed_cycle, unsigned n_qubits) {
+  cycle_permutation_t cycle;
+  cycle.reserve(packed_cycle.size());
+  for (std::uint32_t state : packed_cycle) {
+    cycle.push_back(dec_to_bin(state, n_qubits));
+  }
+  // each cycle is costed via the Hamming distance to reduce the number of
+  // operations
+  cycle_transposition_t transpositions = cycle_to_transposition(cycle);
+  // order the transpositions to allow gate cancellation
+  cycle_transposition_t ordered_transpositions = merge_cycle(transpositions);
+  gray_code_t gray_code;
+  for (const transposition_t &transposition : ordered_transpositions) {
+    TKET_ASSERT(transposition.first.size() == n_qubits);
+    TKET_ASSERT(transposition.middle.size() == n_qubits);
+    TKET_ASSERT(transposition.last.size() == n_qubits);
+    gray_code_t entries = transposition_to_gray_code(transposition);
+    gray_code.insert(gray_code.end(), entries.begin(), entries.end());
+  }
+  return gray_code;
 }
 
 static Circuit gen_circuit_using_toffoli_gates(
-    state_perm_t &perm, unsigned n_qubits) {
-  // Convert passed permutation to cycles
-  std::set<cycle_permutation_t> cycles;
-  while (!perm.empty()) {
-    auto it = perm.begin();
-    cycle_permutation_t cycle = {it->first};
-    it = perm.find(it->second);
-    while (it->first != cycle[0]) {
-      cycle.push_back(it->first);
-      it = perm.find(it->second);
-    }
-    if (cycle.size() > 1) {
-      cycles.insert(cycle);
+    const packed_state_perm_t &perm, unsigned n_qubits) {
+  // Convert passed permutation to cycles. The states are visited in
+  // increasing order, so each cycle starts at its smallest state and the
+  // cycles come out sorted.
+  std::unordered_map<std::uint32_t, std::uint32_t> images;
+  for (const auto &[from, to] : perm) {
+    if (from != to) images.insert({from, to});
+  }
+  std::vector<std::vector<std::uint32_t>> cycles;
+  for (const auto &[from, to] : perm) {
+    if (images.find(from) == images.end()) continue;
+    std::vector<std::uint32_t> cycle = {from};
+    for (std::uint32_t state = to; state != from; state = images.at(state)) {
+      cycle.push_back(state);
     }
-    for (const std::vector<bool> &bitstring : cycle) {
-      perm.erase(bitstring);
+    for (std::uint32_t state : cycle) {
+      images.erase(state);
     }
+    cycles.push_back(std::move(cycle));
   }
 
   // This decomposition is as described on page 191, section 4.5.2 "Single
   // qubit and CNOT gates are universal" of Nielsen & Chuang
-  std::vector<cycle_transposition_t> cycle_transpositions =
-      get_transpositions(cycles);
-
-  // optionally, order the transpositions and cycles to allow gate
-  // cancellation
-  cycle_transposition_t ordered_transpositions;
-  ordered_transpositions = merge_cycles(cycle_transpositions);
-
-  if (ordered_transpositions.empty()) {
-    return Circuit(n_qubits);
+  // The cycles are independent, so synthesise them in parallel
+  const std::size_t n_cycles = cycles.size();
+  std::vector<gray_code_t> gray_codes(n_cycles);
+  std::atomic<std::size_t> next_index{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&]() {
+    try {
+      for (std::size_t i = next_index++; i < n_cycles; i = next_index++) {
+        gray_codes[i] = cycle_to_gray_code(cycles[i], n_qubits);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_index = n_cycles;
+    }
+  };
+  // only worth a thread for a reasonable number of cycles
+  const std::size_t number_of_threads = std::min<std::size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      std::max<std::size_t>(n_cycles / 64, 1));
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
   }
 
-  // Now we have ordered transpositions, produced front->middle and
-  // middle->back gray codes for each transposition and add to circuit
+  // produced front->middle and middle->back gray codes for each
+  // transposition, now add them to circuit
   Circuit circ(n_qubits);
-  for (const transposition_t &transposition : ordered_transpositions) {
-    TKET_ASSERT(transposition.first.size() == n_qubits);
-    TKET_ASSERT(transposition.middle.size() == n_qubits);
-    TKET_ASSERT(transposition.last.size() == n_qubits);
-    gray_code_t all_gray_code_entries =
-        transposition_to_gray_code(transposition);
-    for (const std::pair<std::vector<bool>, unsigned> &entry :
-         all_gray_code_entries) {
-      circ.append(get_bitstring_circuit(entry.first, entry.second, n_qubits));
+  for (const gray_code_t &gray_code : gray_codes) {
+    for (const std::pair<std::vector<bool>, unsigned> &entry : gray_code) {
+      add_bitstring_cnx(circ, entry.first, entry.second, n_qubits);
     }
   }
   return circ;
@@ -293,6 +293,7 @@ Vertex Circuit::add_vertex(
     const Op_ptr op_ptr, std::optional<std::string> opgroup) {
   Vertex new_V = boost::add_vertex(this->dag);
   this->dag[new_V] = {op_ptr, opgroup};
+  log_op_change(new_V);
   return new_V;
 }
 
@@ -316,6 +317,7 @@ Edge Circuit::add_edge(
   dag[new_E].ports.first = source.second;
   dag[new_E].ports.second = target.second;
   dag[new_E].type = type;
+  log_wire_change(target.first);
 
   return new_E;
 }
@@ -356,11 +358,19 @@ void Circuit::remove_vertex(
     }
   }
 
+  if (get_change_log()) {
+    for (const Vertex& succ : get_successors(deadvert)) {
+      log_wire_change(succ);
+    }
+  }
   boost::clear_vertex(deadvert, this->dag);
   if (vertex_deletion == VertexDeletion::Yes) {
     // Cannot remove a boundary vertex
     TKET_ASSERT(!detect_boundary_Op(deadvert));
+    log_removal(deadvert);
     boost::remove_vertex(deadvert, this->dag);
+  } else {
+    log_wire_change(deadvert);
   }
 }
 
@@ -382,6 +392,7 @@ void Circuit::remove_vertices(
 }
 
 void Circuit::remove_edge(const Edge& edge) {
+  log_wire_change(target(edge));
   boost::remove_edge(edge, this->dag);
 }
 
@@ -527,7 +538,7 @@ void Circuit::add_wasm_register(std::size_t number_of_w_) {
 
 void Circuit::qubit_create(const Qubit& id) {
   Vertex v = get_in(id);
-  dag[v].op = std::make_shared<const MetaOp>(OpType::Create);
+  set_vertex_Op_ptr(v, std::make_shared<const MetaOp>(OpType::Create));
 }
 
 void Circuit::qubit_create_all() {
@@ -538,7 +549,7 @@ void Circuit::qubit_create_all() {
 
 void Circuit::qubit_discard(const Qubit& id) {
   Vertex v = get_out(id);
-  dag[v].op = std::make_shared<const MetaOp>(OpType::Discard);
+  set_vertex_Op_ptr(v, std::make_shared<const MetaOp>(OpType::Discard));
 }
 
 void Circuit::qubit_discard_all() {
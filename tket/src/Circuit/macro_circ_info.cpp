@@ -16,13 +16,18 @@
 // ALL METHODS TO OBTAIN COMPLEX GRAPH INFORMATIION//
 ////////////////////////////////////////////////////
 
+#include <boost/functional/hash.hpp>
 #include <tklog/TketLog.hpp>
 
+#include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Conditional.hpp"
 #include "tket/Circuit/DAGDefs.hpp"
 #include "tket/OpType/EdgeType.hpp"
 #include "tket/OpType/OpType.hpp"
+#include "tket/OpType/OpTypeFunctions.hpp"
 #include "tket/Ops/OpPtr.hpp"
+#include "tket/Utils/Expression.hpp"
 #include "tket/Utils/GraphHeaders.hpp"
 
 namespace tket {
@@ -1003,4 +1008,92 @@ Command Circuit::command_from_vertex(
       get_Op_ptr_from_Vertex(vert), args, get_opgroup_from_Vertex(vert), vert);
 }
 
+static void hash_combine_expr(std::size_t& seed, const Expr& e) {
+  std::optional<double> x = eval_expr(e);
+  if (x) {
+    // Normalise -0.0 so that it hashes equal to 0.0.
+    boost::hash_combine(seed, (*x == 0.) ? 0. : *x);
+  } else {
+    boost::hash_combine(seed, e.get_basic()->hash());
+  }
+}
+
+static std::size_t op_structural_hash(
+    const Op_ptr& op, Circuit::HashParams params) {
+  std::size_t seed = 0;
+  const OpType type = op->get_type();
+  boost::hash_combine(seed, type);
+  for (EdgeType et : op->get_signature()) boost::hash_combine(seed, et);
+  if (type == OpType::Conditional) {
+    const Conditional& cond = static_cast<const Conditional&>(*op);
+    boost::hash_combine(seed, cond.get_width());
+    if (params == Circuit::HashParams::Yes) {
+      boost::hash_combine(seed, cond.get_value());
+    }
+    boost::hash_combine(seed, op_structural_hash(cond.get_op(), params));
+  } else if (is_box_type(type) && type != OpType::DummyBox) {
+    const Box& box = static_cast<const Box&>(*op);
+    boost::hash_combine(seed, box.to_circuit()->structural_hash(params));
+  } else if (params == Circuit::HashParams::Yes) {
+    if (is_gate_type(type)) {
+      for (const Expr& e : op->get_params()) hash_combine_expr(seed, e);
+    } else if (!is_boundary_type(type)) {
+      // Other ops (classical, barriers, ...) carry their data in the name.
+      boost::hash_combine(seed, op->get_name());
+    }
+  }
+  return seed;
+}
+
+std::size_t Circuit::structural_hash(HashParams params) const {
+  std::unordered_map<Vertex, std::size_t> v_hash;
+  v_hash.reserve(n_vertices());
+  std::unordered_map<Vertex, unsigned> n_waiting;
+  n_waiting.reserve(n_vertices());
+  VertexVec ready;
+  // Input vertices are distinguished by their position among the units of
+  // the same type, not by the unit names.
+  std::map<UnitType, unsigned> n_units;
+  for (const BoundaryElement& el : boundary.get<TagID>()) {
+    std::size_t seed =
+        op_structural_hash(get_Op_ptr_from_Vertex(el.in_), params);
+    boost::hash_combine(seed, el.type());
+    boost::hash_combine(seed, n_units[el.type()]++);
+    v_hash[el.in_] = seed;
+  }
+  BGL_FORALL_VERTICES(v, dag, DAG) {
+    const unsigned n_ins = n_in_edges(v);
+    if (n_ins == 0) {
+      ready.push_back(v);
+    } else {
+      n_waiting[v] = n_ins;
+    }
+  }
+  // Sweep in topological order, hashing each vertex once all of its
+  // predecessors have been hashed.
+  while (!ready.empty()) {
+    const Vertex v = ready.back();
+    ready.pop_back();
+    if (!v_hash.contains(v)) {
+      std::size_t seed = op_structural_hash(get_Op_ptr_from_Vertex(v), params);
+      for (const Edge& e : get_in_edges(v)) {
+        boost::hash_combine(seed, v_hash.at(source(e)));
+        boost::hash_combine(seed, get_source_port(e));
+        boost::hash_combine(seed, get_edgetype(e));
+      }
+      v_hash[v] = seed;
+    }
+    BGL_FORALL_OUTEDGES(v, e, dag, DAG) {
+      const Vertex t = target(e);
+      if (--n_waiting.at(t) == 0) ready.push_back(t);
+    }
+  }
+  std::size_t seed = 0;
+  for (const BoundaryElement& el : boundary.get<TagID>()) {
+    boost::hash_combine(seed, v_hash.at(el.out_));
+  }
+  if (params == HashParams::Yes) hash_combine_expr(seed, phase);
+  return seed;
+}
+
 }  // namespace tket
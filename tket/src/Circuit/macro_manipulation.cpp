@@ -16,16 +16,21 @@
 // ALL METHODS TO PERFORM COMPLEX CIRCUIT MANIPULATION//
 /////////////////////////////////////////////////////
 
+#include <map>
 #include <memory>
+#include <numeric>
 #include <tket/OpType/OpType.hpp>
 #include <tklog/TketLog.hpp>
 
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Conditional.hpp"
+#include "tket/Circuit/ConjugationBox.hpp"
 #include "tket/Gate/Gate.hpp"
 #include "tket/Gate/OpPtrFunctions.hpp"
 #include "tket/Ops/ClassicalOps.hpp"
 #include "tket/Ops/OpPtr.hpp"
 #include "tket/Utils/Expression.hpp"
+#include "tket/Utils/Trace.hpp"
 #include "tket/Utils/UnitID.hpp"
 namespace tket {
 
@@ -77,6 +82,7 @@ vertex_map_t Circuit::copy_graph(
   BGL_FORALL_VERTICES(v, c2.dag, DAG) {
     Vertex v0 = boost::add_vertex(this->dag);
     this->dag[v0].op = c2.get_Op_ptr_from_Vertex(v);
+    log_op_change(v0);
     if (opgroup_transfer == OpGroupTransfer::Preserve ||
         opgroup_transfer == OpGroupTransfer::Merge) {
       this->dag[v0].opgroup = c2.get_opgroup_from_Vertex(v);
@@ -121,6 +127,135 @@ vertex_map_t Circuit::copy_graph(
   return isomap;
 }
 
+std::vector<CircuitComponent> Circuit::split_into_components() const {
+  if (_number_of_wasm_wires > 0) {
+    throw CircuitInvalidity("Cannot split a circuit with WASM wires");
+  }
+  const unit_vector_t units = all_units();
+  std::map<UnitID, unsigned> unit_index;
+  for (unsigned i = 0; i < units.size(); ++i) unit_index[units[i]] = i;
+
+  // Union-find over unit indices, always keeping the smallest index as root
+  // so that components come out ordered by their first unit.
+  std::vector<unsigned> parent(units.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent](unsigned i) {
+    while (parent[i] != i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+  auto unite = [&](unsigned i, unsigned j) {
+    i = find(i);
+    j = find(j);
+    if (i < j) {
+      parent[j] = i;
+    } else {
+      parent[i] = j;
+    }
+  };
+
+  const std::vector<Command> commands = get_commands();
+  for (const Command& com : commands) {
+    const unit_vector_t args = com.get_args();
+    for (unsigned i = 1; i < args.size(); ++i) {
+      unite(unit_index.at(args[0]), unit_index.at(args[i]));
+    }
+  }
+  const qubit_map_t perm = implicit_qubit_permutation();
+  for (const std::pair<const Qubit, Qubit>& pair : perm) {
+    unite(unit_index.at(pair.first), unit_index.at(pair.second));
+  }
+
+  // Component units on the default registers, in the order of `units`.
+  std::vector<CircuitComponent> components;
+  std::vector<unsigned> component_of(units.size());
+  std::vector<std::pair<unsigned, unsigned>> counts;  // (qubits, bits)
+  std::vector<UnitID> new_unit(units.size());
+  for (unsigned i = 0; i < units.size(); ++i) {
+    const unsigned root = find(i);
+    if (root == i) {
+      component_of[i] = components.size();
+      components.push_back({});
+      counts.push_back({0, 0});
+    } else {
+      component_of[i] = component_of[root];
+    }
+    const unsigned c = component_of[i];
+    if (units[i].type() == UnitType::Qubit) {
+      Qubit q(counts[c].first++);
+      components[c].circ.add_qubit(q);
+      new_unit[i] = q;
+    } else {
+      Bit b(counts[c].second++);
+      components[c].circ.add_bit(b);
+      new_unit[i] = b;
+    }
+    components[c].unit_map.insert({new_unit[i], units[i]});
+  }
+
+  Expr first_phase = phase;
+  for (const Command& com : commands) {
+    const unit_vector_t args = com.get_args();
+    if (args.empty()) {
+      // Ops without arguments, such as Phase, join the first component.
+      if (components.empty()) continue;
+      const Op_ptr op = com.get_op_ptr();
+      if (op->get_type() == OpType::Phase) {
+        first_phase += op->get_params()[0];
+      } else {
+        components.front().circ.add_op(op, {}, com.get_opgroup());
+      }
+      continue;
+    }
+    unit_vector_t new_args;
+    new_args.reserve(args.size());
+    for (const UnitID& arg : args) {
+      new_args.push_back(new_unit[unit_index.at(arg)]);
+    }
+    const unsigned c = component_of[unit_index.at(args.at(0))];
+    components[c].circ.add_op(com.get_op_ptr(), new_args, com.get_opgroup());
+  }
+
+  for (const Qubit& q : all_qubits()) {
+    if (is_created(q)) {
+      const unsigned i = unit_index.at(q);
+      components[component_of[i]].circ.qubit_create(Qubit(new_unit[i]));
+    }
+  }
+  std::vector<qubit_map_t> component_perms(components.size());
+  for (const std::pair<const Qubit, Qubit>& pair : perm) {
+    const unsigned i = unit_index.at(pair.first);
+    const unsigned j = unit_index.at(pair.second);
+    component_perms[component_of[i]].insert(
+        {Qubit(new_unit[i]), Qubit(new_unit[j])});
+  }
+  for (unsigned c = 0; c < components.size(); ++c) {
+    components[c].circ.permute_boundary_output(component_perms[c]);
+  }
+  for (const Qubit& q : all_qubits()) {
+    if (is_discarded(q)) {
+      const unsigned i = unit_index.at(q);
+      components[component_of[i]].circ.qubit_discard(Qubit(new_unit[i]));
+    }
+  }
+  if (!components.empty()) components.front().circ.add_phase(first_phase);
+  return components;
+}
+
+Circuit Circuit::recombine_components(
+    const std::vector<CircuitComponent>& components) {
+  Circuit result;
+  for (const CircuitComponent& component : components) {
+    Circuit circ = component.circ;
+    circ.rename_units(component.unit_map);
+    result.copy_graph(circ);
+    result.add_phase(circ.get_phase());
+  }
+  return result;
+}
+
 // given two circuits, adds second circuit to first circuit object in parallel
 Circuit operator*(const Circuit& c1, const Circuit& c2) {
   // preliminary method to add circuit objects together
@@ -193,7 +328,7 @@ void Circuit::append_with_map(const Circuit& c2, const unit_map_t& qm) {
             reset_qbs.find(Qubit(el.id_)) == reset_qbs.end()) {
           remove_vertex(in, GraphRewiring::Yes, VertexDeletion::Yes);
         } else {
-          dag[in].op = std::make_shared<const Gate>(OpType::Reset);
+          set_vertex_Op_ptr(in, std::make_shared<const Gate>(OpType::Reset));
         }
       } else {
         Vertex new_in = vm[el.in_];
@@ -238,6 +373,8 @@ Circuit operator>>(const Circuit& ci1, const Circuit& ci2) {
 void Circuit::substitute(
     const Circuit& to_insert, const Subcircuit& to_replace,
     VertexDeletion vertex_deletion, OpGroupTransfer opgroup_transfer) {
+  TKET_TRACE_SCOPE("Circuit::substitute");
+  TKET_TRACE_HISTOGRAM("Circuit::substitute gates", to_insert.n_gates());
   if (!to_insert.is_simple()) throw SimpleOnly();
   if (to_insert.n_qubits() != to_replace.q_in_hole.size() ||
       to_insert.n_bits() != to_replace.c_in_hole.size())
@@ -268,7 +405,7 @@ void Circuit::substitute(
     Vertex inp = vm[to_insert.get_in(Qubit(i))];
     add_edge({pred_v, port1}, {inp, 0}, EdgeType::Quantum);
     if (reset_qbs.contains(Qubit(i))) {
-      dag[inp].op = reset;
+      set_vertex_Op_ptr(inp, reset);
     } else {
       dag[inp].op = noop;
       bin.push_back(inp);
@@ -414,6 +551,8 @@ void Circuit::replace_implicit_wire_swap(
   dag[out1].ports.first = 1;
   Edge out2 = outs[1];
   dag[out2].ports.first = 0;
+  log_wire_change(target(out1));
+  log_wire_change(target(out2));
 }
 
 void Circuit::replace_all_implicit_wire_swaps() {
@@ -698,7 +837,9 @@ bool Circuit::substitute_box_vertex(
   if (!op->get_desc().is_box()) return false;
   if (op->get_type() == OpType::ClassicalExpBox) return false;
   const Box& b = static_cast<const Box&>(*op);
-  Circuit replacement = *b.to_circuit();
+  // Substitute directly from the box's (possibly shared) circuit, which is
+  // not modified, rather than copying it first.
+  const Circuit& replacement = *b.to_circuit();
   if (conditional) {
     substitute_conditional(
         replacement, vert, vertex_deletion, OpGroupTransfer::Merge);
@@ -708,26 +849,167 @@ bool Circuit::substitute_box_vertex(
   return true;
 }
 
-bool Circuit::decompose_boxes_recursively(
+// Decompositions of boxes made during one call to
+// decompose_boxes_recursively, keyed by the circuit of the box (shared by all
+// copies of a box) and whether the box is under a condition
+typedef std::map<std::pair<const Circuit*, bool>, Circuit> box_templates_t;
+
+static bool decompose_boxes_with_templates(
+    Circuit& circ, const std::unordered_set<OpType>& excluded_types,
+    const std::unordered_set<std::string>& excluded_opgroups,
+    box_templates_t& templates);
+
+static const Circuit& box_template(
+    const Box& box, bool conditional,
     const std::unordered_set<OpType>& excluded_types,
-    const std::unordered_set<std::string>& excluded_opgroups) {
-  bool success = false;
+    const std::unordered_set<std::string>& excluded_opgroups,
+    box_templates_t& templates);
+
+// An op on its own, with its boxes decomposed as a box would be.
+static Circuit op_template(
+    const Op_ptr& op, bool conditional,
+    const std::unordered_set<OpType>& excluded_types,
+    const std::unordered_set<std::string>& excluded_opgroups,
+    box_templates_t& templates) {
+  if (op->get_desc().is_box() &&
+      (conditional || !excluded_types.contains(op->get_type()))) {
+    return box_template(
+        static_cast<const Box&>(*op), conditional, excluded_types,
+        excluded_opgroups, templates);
+  }
+  Circuit circ(op->get_signature().size());
+  std::vector<unsigned> args(circ.n_qubits());
+  std::iota(args.begin(), args.end(), 0);
+  circ.add_op<unsigned>(op, args);
+  return circ;
+}
+
+// The decomposition of a ConjugationBox. Without an uncompute op, the
+// uncompute part is the dagger of the decomposed compute op, rather than a
+// decomposition of compute->dagger(): the latter is a new box, so for nested
+// conjugations every level would be decomposed twice over.
+static Circuit conjugation_template(
+    const ConjugationBox& box, bool conditional,
+    const std::unordered_set<OpType>& excluded_types,
+    const std::unordered_set<std::string>& excluded_opgroups,
+    box_templates_t& templates) {
+  Circuit compute = op_template(
+      box.get_compute(), conditional, excluded_types, excluded_opgroups,
+      templates);
+  Circuit circ = compute;
+  circ.append(op_template(
+      box.get_action(), conditional, excluded_types, excluded_opgroups,
+      templates));
+  std::optional<Op_ptr> uncompute = box.get_uncompute();
+  if (uncompute) {
+    circ.append(op_template(
+        *uncompute, conditional, excluded_types, excluded_opgroups,
+        templates));
+  } else {
+    circ.append(compute.dagger());
+  }
+  return circ;
+}
+
+// The circuit of a box with all its own boxes decomposed, computed once per
+// box. Inside a conditional box every vertex is itself conditional, so box
+// types are never excluded there.
+static const Circuit& box_template(
+    const Box& box, bool conditional,
+    const std::unordered_set<OpType>& excluded_types,
+    const std::unordered_set<std::string>& excluded_opgroups,
+    box_templates_t& templates) {
+  std::shared_ptr<Circuit> box_circ = box.to_circuit();
+  std::pair<const Circuit*, bool> key{box_circ.get(), conditional};
+  box_templates_t::const_iterator found = templates.find(key);
+  if (found != templates.end()) return found->second;
+  if (box.get_type() == OpType::ConjugationBox) {
+    Circuit decomposed = conjugation_template(
+        static_cast<const ConjugationBox&>(box), conditional, excluded_types,
+        excluded_opgroups, templates);
+    return templates.emplace(key, std::move(decomposed)).first->second;
+  }
+  Circuit decomposed = *box_circ;
+  decompose_boxes_with_templates(
+      decomposed, conditional ? std::unordered_set<OpType>{} : excluded_types,
+      excluded_opgroups, templates);
+  return templates.emplace(key, std::move(decomposed)).first->second;
+}
+
+static bool decompose_boxes_with_templates(
+    Circuit& circ, const std::unordered_set<OpType>& excluded_types,
+    const std::unordered_set<std::string>& excluded_opgroups,
+    box_templates_t& templates) {
+  // Spliced templates are already decomposed, so only the vertices present
+  // at the start need visiting.
+  std::vector<Vertex> to_visit;
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) { to_visit.push_back(v); }
   VertexList bin;
-  BGL_FORALL_VERTICES(v, dag, DAG) {
-    if (excluded_types.contains(get_OpType_from_Vertex(v))) {
+  for (const Vertex& v : to_visit) {
+    if (excluded_types.contains(circ.get_OpType_from_Vertex(v))) {
       continue;
     }
-    std::optional<std::string> v_opgroup = get_opgroup_from_Vertex(v);
+    std::optional<std::string> v_opgroup = circ.get_opgroup_from_Vertex(v);
     if (v_opgroup && excluded_opgroups.contains(v_opgroup.value())) {
       continue;
     }
-    if (substitute_box_vertex(v, VertexDeletion::No)) {
-      bin.push_back(v);
-      success = true;
+    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+    bool conditional = op->get_type() == OpType::Conditional;
+    if (conditional) {
+      op = static_cast<const Conditional&>(*op).get_op();
     }
+    if (!op->get_desc().is_box()) continue;
+    if (op->get_type() == OpType::ClassicalExpBox) continue;
+    const Circuit& replacement = box_template(
+        static_cast<const Box&>(*op), conditional, excluded_types,
+        excluded_opgroups, templates);
+    if (conditional) {
+      circ.substitute_conditional(
+          replacement, v, Circuit::VertexDeletion::No,
+          Circuit::OpGroupTransfer::Merge);
+    } else {
+      circ.substitute(
+          replacement, v, Circuit::VertexDeletion::No,
+          Circuit::OpGroupTransfer::Merge);
+    }
+    bin.push_back(v);
+  }
+  circ.remove_vertices(
+      bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
+  return !bin.empty();
+}
+
+bool Circuit::decompose_boxes_recursively(
+    const std::unordered_set<OpType>& excluded_types,
+    const std::unordered_set<std::string>& excluded_opgroups) {
+  box_templates_t templates;
+  return decompose_boxes_with_templates(
+      *this, excluded_types, excluded_opgroups, templates);
+}
+
+// Evaluate a classical operation whose arguments start at args[offset].
+static void eval_classical_op(
+    const ClassicalEvalOp& op, const unit_vector_t& args, unsigned offset,
+    std::map<Bit, bool>& v) {
+  if (op.get_type() == OpType::MultiBit) {
+    const MultiBitOp& mbop = static_cast<const MultiBitOp&>(op);
+    const unsigned width = mbop.get_op()->get_signature().size();
+    for (unsigned i = 0; i < mbop.get_n(); i++) {
+      eval_classical_op(*mbop.get_op(), args, offset + i * width, v);
+    }
+    return;
+  }
+  // Arguments are inputs, then input-outputs, then outputs.
+  const unsigned n_i = op.get_n_i();
+  std::vector<bool> input(n_i + op.get_n_io());
+  for (unsigned i = 0; i < input.size(); i++) {
+    input[i] = v[Bit(args[offset + i])];
+  }
+  std::vector<bool> output = op.eval(input);
+  TKET_ASSERT(output.size() == op.get_n_io() + op.get_n_o());
+  for (unsigned i = 0; i < output.size(); i++) {
+    v[Bit(args[offset + n_i + i])] = output[i];
   }
-  remove_vertices(bin, GraphRewiring::No, VertexDeletion::Yes);
-  return success;
 }
 
 std::map<Bit, bool> Circuit::classical_eval(
@@ -735,38 +1017,106 @@ std::map<Bit, bool> Circuit::classical_eval(
   std::map<Bit, bool> v(values);
   for (CommandIterator it = begin(); it != end(); ++it) {
     Op_ptr op = it->get_op_ptr();
-    OpType optype = op->get_type();
-    if (!is_classical_type(optype)) {
+    unit_vector_t args = it->get_args();
+    unsigned offset = 0;
+    bool enabled = true;
+    if (op->get_type() == OpType::Conditional) {
+      const Conditional& cond = static_cast<const Conditional&>(*op);
+      offset = cond.get_width();
+      unsigned value = 0;
+      for (unsigned i = 0; i < offset; i++) {
+        if (v[Bit(args[i])]) value |= 1u << i;
+      }
+      enabled = (value == cond.get_value());
+      op = cond.get_op();
+    }
+    if (!is_classical_type(op->get_type())) {
       throw CircuitInvalidity("Non-classical operation");
     }
     std::shared_ptr<const ClassicalEvalOp> cop =
         std::dynamic_pointer_cast<const ClassicalEvalOp>(op);
+    if (!cop) {
+      throw CircuitInvalidity("Unexpected operation in circuit");
+    }
+    if (!enabled) continue;
+    eval_classical_op(*cop, args, offset, v);
+  }
+  return v;
+}
+
+// Evaluate a classical operation whose arguments start at args[offset] on
+// bit-sliced values, updating only the lanes set in `enabled`.
+static void eval_classical_op_sliced(
+    const ClassicalEvalOp& op, const unit_vector_t& args, unsigned offset,
+    const std::vector<uint64_t>& enabled,
+    std::map<Bit, std::vector<uint64_t>>& v) {
+  if (op.get_type() == OpType::MultiBit) {
+    const MultiBitOp& mbop = static_cast<const MultiBitOp&>(op);
+    const unsigned width = mbop.get_op()->get_signature().size();
+    for (unsigned i = 0; i < mbop.get_n(); i++) {
+      eval_classical_op_sliced(
+          *mbop.get_op(), args, offset + i * width, enabled, v);
+    }
+    return;
+  }
+  // Arguments are inputs, then input-outputs, then outputs.
+  const unsigned n_i = op.get_n_i();
+  const unsigned n_in = n_i + op.get_n_io();
+  const unsigned n_out = op.get_n_io() + op.get_n_o();
+  std::vector<uint64_t> input(n_in);
+  for (unsigned w = 0; w < enabled.size(); w++) {
+    if (enabled[w] == 0) continue;
+    for (unsigned i = 0; i < n_in; i++) {
+      input[i] = v.at(Bit(args[offset + i]))[w];
+    }
+    std::vector<uint64_t> output = op.eval_sliced(input);
+    TKET_ASSERT(output.size() == n_out);
+    for (unsigned i = 0; i < n_out; i++) {
+      uint64_t& word = v.at(Bit(args[offset + n_i + i]))[w];
+      word = (output[i] & enabled[w]) | (word & ~enabled[w]);
+    }
+  }
+}
+
+std::map<Bit, std::vector<uint64_t>> Circuit::classical_eval_sliced(
+    const std::map<Bit, std::vector<uint64_t>>& values) const {
+  const std::size_t n_words =
+      values.empty() ? 0 : values.begin()->second.size();
+  for (const auto& pair : values) {
+    if (pair.second.size() != n_words) {
+      throw std::invalid_argument("Inconsistent number of words in input");
+    }
+  }
+  std::map<Bit, std::vector<uint64_t>> v(values);
+  for (const Bit& b : all_bits()) {
+    v.insert({b, std::vector<uint64_t>(n_words, 0)});
+  }
+  for (CommandIterator it = begin(); it != end(); ++it) {
+    Op_ptr op = it->get_op_ptr();
     unit_vector_t args = it->get_args();
-    unsigned n_args = args.size();
-    switch (optype) {
-      case OpType::ClassicalTransform: {
-        std::vector<bool> input(n_args);
-        for (unsigned i = 0; i < n_args; i++) {
-          input[i] = v[Bit(args[i])];
-        }
-        std::vector<bool> output = cop->eval(input);
-        TKET_ASSERT(output.size() == n_args);
-        for (unsigned i = 0; i < n_args; i++) {
-          v[Bit(args[i])] = output[i];
-        }
-        break;
-      }
-      case OpType::SetBits: {
-        std::vector<bool> output = cop->eval({});
-        TKET_ASSERT(output.size() == n_args);
-        for (unsigned i = 0; i < n_args; i++) {
-          v[Bit(args[i])] = output[i];
+    unsigned offset = 0;
+    std::vector<uint64_t> enabled(n_words, ~uint64_t{0});
+    if (op->get_type() == OpType::Conditional) {
+      const Conditional& cond = static_cast<const Conditional&>(*op);
+      offset = cond.get_width();
+      for (unsigned i = 0; i < offset; i++) {
+        const std::vector<uint64_t>& cond_bit = v.at(Bit(args[i]));
+        const bool expected = (cond.get_value() >> i) & 1;
+        for (unsigned w = 0; w < n_words; w++) {
+          enabled[w] &= expected ? cond_bit[w] : ~cond_bit[w];
         }
-        break;
       }
-      default:
-        throw CircuitInvalidity("Unexpected operation in circuit");
+      op = cond.get_op();
+    }
+    if (!is_classical_type(op->get_type())) {
+      throw CircuitInvalidity("Non-classical operation");
+    }
+    std::shared_ptr<const ClassicalEvalOp> cop =
+        std::dynamic_pointer_cast<const ClassicalEvalOp>(op);
+    if (!cop) {
+      throw CircuitInvalidity("Unexpected operation in circuit");
     }
+    eval_classical_op_sliced(*cop, args, offset, enabled, v);
   }
   return v;
 }
@@ -16,6 +16,8 @@
 // ALL METHODS TO SET AND GET BASIC CIRCUIT INFORMATION//
 ////////////////////////////////////////////////////////
 
+#include <atomic>
+#include <memory>
 #include <stdexcept>
 #include <tkassert/Assert.hpp>
 #include <tklog/TketLog.hpp>
@@ -61,10 +63,35 @@ Circuit &Circuit::operator=(const Circuit &other)  // (1)
   phase = other.get_phase();
   name = other.name;
   add_wasm_register(other._number_of_wasm_wires);
+  log_all_changed();
 
   return *this;
 }
 
+Circuit::Circuit(Circuit &&circ) : Circuit() { *this = std::move(circ); }
+
+Circuit &Circuit::operator=(Circuit &&other) {
+  if (this == &other) return *this;
+  // Swapping the underlying lists keeps all descriptors valid.
+  dag.swap(other.dag);
+  other.dag.clear();
+  boundary = std::move(other.boundary);
+  other.boundary.clear();
+  wasmwire = std::move(other.wasmwire);
+  other.wasmwire.clear();
+  _number_of_wasm_wires = other._number_of_wasm_wires;
+  other._number_of_wasm_wires = 0;
+  phase = other.phase;
+  other.phase = 0;
+  name = std::move(other.name);
+  other.name = std::nullopt;
+  opgroupsigs = std::move(other.opgroupsigs);
+  other.opgroupsigs.clear();
+  log_all_changed();
+  other.log_all_changed();
+  return *this;
+}
+
 void Circuit::assert_valid() const {  //
   TKET_ASSERT(is_valid(dag));
 }
@@ -646,6 +673,41 @@ const std::unordered_set<std::string> Circuit::get_opgroups() const {
 
 void Circuit::set_vertex_Op_ptr(const Vertex &vert, const Op_ptr &op) {
   this->dag[vert].op = op;
+  log_op_change(vert);
+}
+
+void Circuit::record_changes() {
+  static std::atomic<std::size_t> next_id{0};
+  if (!change_log_) {
+    change_log_ = std::make_unique<ChangeLog>();
+    change_log_->id = next_id++;
+  }
+}
+
+void Circuit::stop_recording_changes() { change_log_.reset(); }
+
+void Circuit::log_op_change(const Vertex &vert) {
+  if (change_log_) change_log_->ops[vert] = ++change_log_->count;
+}
+
+void Circuit::log_wire_change(const Vertex &vert) {
+  if (change_log_) change_log_->wires[vert] = ++change_log_->count;
+}
+
+void Circuit::log_all_changed() {
+  if (change_log_) {
+    // Vertices changed earlier need not be remembered individually
+    change_log_->ops.clear();
+    change_log_->wires.clear();
+    change_log_->all = ++change_log_->count;
+  }
+}
+
+void Circuit::log_removal(const Vertex &vert) {
+  if (change_log_) {
+    change_log_->ops.erase(vert);
+    change_log_->wires.erase(vert);
+  }
 }
 
 OpDesc Circuit::get_OpDesc_from_Vertex(const Vertex &vert) const {
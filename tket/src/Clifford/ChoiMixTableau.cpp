@@ -15,6 +15,7 @@
 #include "tket/Clifford/ChoiMixTableau.hpp"
 
 #include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "tket/OpType/OpTypeInfo.hpp"
 
@@ -355,22 +356,16 @@ void ChoiMixTableau::apply_gate(
         // reinsert qubit initialised to maximally mixed state (no coherent
         // stabilizers)
         col_index_.insert({{qbs.at(0), TableauSegment::Input}, col});
-        tab_.xmat.conservativeResize(rows, col + 1);
-        tab_.xmat.col(col) = MatrixXb::Zero(rows, 1);
-        tab_.zmat.conservativeResize(rows, col + 1);
-        tab_.zmat.col(col) = MatrixXb::Zero(rows, 1);
+        tab_.xmat.conservative_resize(rows, col + 1);
+        tab_.zmat.conservative_resize(rows, col + 1);
       } else {
         discard_qubit(qbs.at(0), TableauSegment::Output);
         unsigned col = get_n_boundaries();
         unsigned rows = get_n_rows();
         // reinsert qubit initialised to |0> (add a Z stabilizer)
         col_index_.insert({{qbs.at(0), TableauSegment::Output}, col});
-        tab_.xmat.conservativeResize(rows + 1, col + 1);
-        tab_.xmat.col(col) = MatrixXb::Zero(rows + 1, 1);
-        tab_.xmat.row(rows) = MatrixXb::Zero(1, col + 1);
-        tab_.zmat.conservativeResize(rows + 1, col + 1);
-        tab_.zmat.col(col) = MatrixXb::Zero(rows + 1, 1);
-        tab_.zmat.row(rows) = MatrixXb::Zero(1, col + 1);
+        tab_.xmat.conservative_resize(rows + 1, col + 1);
+        tab_.zmat.conservative_resize(rows + 1, col + 1);
         tab_.zmat(rows, col) = true;
         tab_.phase.conservativeResize(rows + 1);
         tab_.phase(rows) = false;
@@ -515,6 +510,130 @@ void ChoiMixTableau::collapse_qubit(const Qubit& qb, TableauSegment seg) {
   }
 }
 
+bool ChoiMixTableau::measure_pauli(const SpPauliStabiliser& pauli, RNG& rng) {
+  if (pauli.coeff % 2 == 1)
+    throw std::invalid_argument("Cannot measure a non-Hermitian Pauli string");
+  for (const std::pair<const Qubit, Pauli>& qp : pauli.string) {
+    if (col_index_.left.find(col_key_t{qp.first, TableauSegment::Output}) ==
+        col_index_.left.end())
+      throw std::invalid_argument(
+          "Cannot measure " + qp.first.repr() +
+          ", which is not an output of the tableau");
+  }
+  // Append the observable as an extra row
+  const PauliStabiliser stab = row_tensor_to_stab({{}, pauli});
+  const unsigned n_rows = get_n_rows();
+  const unsigned n_cols = get_n_boundaries();
+  tab_.xmat.conservative_resize(n_rows + 1, n_cols);
+  tab_.zmat.conservative_resize(n_rows + 1, n_cols);
+  tab_.phase.conservativeResize(n_rows + 1);
+  for (unsigned c = 0; c < n_cols; ++c) {
+    const Pauli p = stab.get(c);
+    tab_.xmat(n_rows, c) = (p == Pauli::X) || (p == Pauli::Y);
+    tab_.zmat(n_rows, c) = (p == Pauli::Z) || (p == Pauli::Y);
+  }
+  tab_.phase(n_rows) = stab.is_real_negative();
+  // As in Aaronson-Gottesman, if some stabilizers anticommute with the
+  // observable, combine them so that only one does and replace it by the
+  // observable with a random sign
+  const unsigned n_words = tab_.xmat.words_per_row();
+  std::optional<unsigned> anti_row = std::nullopt;
+  for (unsigned r = 0; r < n_rows; ++r) {
+    bool anti = BitMatrix::and_parity(
+                    tab_.xmat.row_data(r), tab_.zmat.row_data(n_rows),
+                    n_words) ^
+                BitMatrix::and_parity(
+                    tab_.zmat.row_data(r), tab_.xmat.row_data(n_rows),
+                    n_words);
+    if (!anti) continue;
+    if (anti_row)
+      tab_.row_mult(*anti_row, r);
+    else
+      anti_row = r;
+  }
+  if (anti_row) {
+    const bool outcome = rng.get_size_t(1) == 1;
+    tab_.xmat.copy_row(n_rows, *anti_row);
+    tab_.zmat.copy_row(n_rows, *anti_row);
+    tab_.phase(*anti_row) = tab_.phase(n_rows) ^ outcome;
+    remove_row(n_rows);
+    return outcome;
+  }
+  // Otherwise the outcome is deterministic if the stabilizers generate the
+  // observable (leaving a row of +-I in the Gaussian form), and the
+  // observable joins the stabilizers with a random sign if not
+  SymplecticTableau reduced(tab_);
+  reduced.gaussian_form();
+  for (unsigned r = 0; r <= n_rows; ++r) {
+    if (reduced.xmat.row_is_zero(r) && reduced.zmat.row_is_zero(r)) {
+      remove_row(n_rows);
+      return reduced.phase(r);
+    }
+  }
+  const bool outcome = rng.get_size_t(1) == 1;
+  tab_.phase(n_rows) = tab_.phase(n_rows) ^ outcome;
+  return outcome;
+}
+
+std::vector<std::vector<bool>> ChoiMixTableau::sample_measurements(
+    unsigned shots, RNG& rng) const {
+  ChoiMixTableau state(*this);
+  for (const Qubit& qb : input_qubits()) {
+    state.post_select(qb, TableauSegment::Input);
+  }
+  SymplecticTableau& tab = state.tab_;
+  const unsigned n_rows = state.get_n_rows();
+  const unsigned n_cols = state.get_n_boundaries();
+  // Eliminate over the x components before the z components, so that the
+  // rows with no x component generate the diagonal stabilizers and are in
+  // reduced row echelon form
+  BitMatrix full(n_rows, 2 * n_cols);
+  for (unsigned r = 0; r < n_rows; ++r) {
+    for (unsigned c = 0; c < n_cols; ++c) {
+      full(r, c) = tab.xmat(r, c);
+      full(r, n_cols + c) = tab.zmat(r, c);
+    }
+  }
+  for (const std::pair<unsigned, unsigned>& op :
+       gaussian_elimination_row_ops(full)) {
+    tab.row_mult(op.first, op.second);
+  }
+  // Each diagonal stabilizer fixes the outcome at its leading column given
+  // the others; all other columns are free
+  const unsigned n_words = tab.zmat.words_per_row();
+  std::vector<std::pair<unsigned, unsigned>> diagonal_rows;
+  BitMatrix free_cols(1, n_cols);
+  for (unsigned c = 0; c < n_cols; ++c) free_cols(0, c) = true;
+  for (unsigned r = 0; r < n_rows; ++r) {
+    if (!tab.xmat.row_is_zero(r)) continue;
+    unsigned lead = 0;
+    while (!tab.zmat(r, lead)) ++lead;
+    diagonal_rows.push_back({r, lead});
+    free_cols(0, lead) = false;
+  }
+  const qubit_vector_t outputs = state.output_qubits();
+  std::vector<unsigned> output_cols;
+  for (const Qubit& qb : outputs) {
+    output_cols.push_back(
+        state.col_index_.left.at(col_key_t{qb, TableauSegment::Output}));
+  }
+  std::vector<std::vector<bool>> results(shots);
+  BitMatrix bits(1, n_cols);
+  for (std::vector<bool>& result : results) {
+    for (unsigned k = 0; k < n_words; ++k) {
+      bits.row_data(0)[k] = rng() & free_cols.row_data(0)[k];
+    }
+    for (const auto& [r, lead] : diagonal_rows) {
+      bool parity = BitMatrix::and_parity(
+          tab.zmat.row_data(r), bits.row_data(0), n_words);
+      bits(0, lead) = parity ^ tab.phase(r);
+    }
+    result.reserve(outputs.size());
+    for (unsigned col : output_cols) result.push_back(bits(0, col));
+  }
+  return results;
+}
+
 void ChoiMixTableau::remove_row(unsigned row) {
   if (row >= get_n_rows())
     throw std::invalid_argument(
@@ -523,12 +642,12 @@ void ChoiMixTableau::remove_row(unsigned row) {
   unsigned n_rows = get_n_rows();
   unsigned n_cols = get_n_boundaries();
   if (row < n_rows - 1) {
-    tab_.xmat.row(row) = tab_.xmat.row(n_rows - 1);
-    tab_.zmat.row(row) = tab_.zmat.row(n_rows - 1);
+    tab_.xmat.copy_row(n_rows - 1, row);
+    tab_.zmat.copy_row(n_rows - 1, row);
     tab_.phase(row) = tab_.phase(n_rows - 1);
   }
-  tab_.xmat.conservativeResize(n_rows - 1, n_cols);
-  tab_.zmat.conservativeResize(n_rows - 1, n_cols);
+  tab_.xmat.conservative_resize(n_rows - 1, n_cols);
+  tab_.zmat.conservative_resize(n_rows - 1, n_cols);
   tab_.phase.conservativeResize(n_rows - 1);
 }
 
@@ -540,11 +659,11 @@ void ChoiMixTableau::remove_col(unsigned col) {
   unsigned n_rows = get_n_rows();
   unsigned n_cols = get_n_boundaries();
   if (col < n_cols - 1) {
-    tab_.xmat.col(col) = tab_.xmat.col(n_cols - 1);
-    tab_.zmat.col(col) = tab_.zmat.col(n_cols - 1);
+    tab_.xmat.copy_col(n_cols - 1, col);
+    tab_.zmat.copy_col(n_cols - 1, col);
   }
-  tab_.xmat.conservativeResize(n_rows, n_cols - 1);
-  tab_.zmat.conservativeResize(n_rows, n_cols - 1);
+  tab_.xmat.conservative_resize(n_rows, n_cols - 1);
+  tab_.zmat.conservative_resize(n_rows, n_cols - 1);
   col_index_.right.erase(col);
   if (col < n_cols - 1) {
     tableau_col_index_t::right_iterator it = col_index_.right.find(n_cols - 1);
@@ -583,20 +702,40 @@ void ChoiMixTableau::canonical_column_order(TableauSegment first) {
     }
   }
   unsigned n_rows = get_n_rows();
-  MatrixXb xmat = MatrixXb::Zero(n_rows, i);
-  MatrixXb zmat = MatrixXb::Zero(n_rows, i);
+  BitMatrix xmat(n_rows, i);
+  BitMatrix zmat(n_rows, i);
   for (unsigned j = 0; j < i; ++j) {
     col_key_t key = new_index.right.at(j);
     unsigned c = col_index_.left.at(key);
-    xmat.col(j) = tab_.xmat.col(c);
-    zmat.col(j) = tab_.zmat.col(c);
+    for (unsigned r = 0; r < n_rows; ++r) {
+      xmat(r, j) = tab_.xmat(r, c);
+      zmat(r, j) = tab_.zmat(r, c);
+    }
   }
-  tab_ = SymplecticTableau(xmat, zmat, tab_.phase);
+  tab_.xmat = std::move(xmat);
+  tab_.zmat = std::move(zmat);
   col_index_ = new_index;
 }
 
 void ChoiMixTableau::gaussian_form() { tab_.gaussian_form(); }
 
+ChoiMixTableau ChoiMixTableau::canonical_form() const {
+  ChoiMixTableau canon(*this);
+  canon.canonical_column_order();
+  canon.tab_ = canon.tab_.canonical_form();
+  return canon;
+}
+
+std::size_t ChoiMixTableau::hash_value() const {
+  std::size_t seed = tab_.hash_value();
+  for (unsigned i = 0; i < get_n_boundaries(); ++i) {
+    const col_key_t& key = col_index_.right.at(i);
+    boost::hash_combine(seed, key.first);
+    boost::hash_combine(seed, key.second == TableauSegment::Input);
+  }
+  return seed;
+}
+
 void ChoiMixTableau::rename_qubits(
     const qubit_map_t& qmap, TableauSegment seg) {
   tableau_col_index_t new_index;
@@ -629,10 +768,10 @@ ChoiMixTableau ChoiMixTableau::compose(
   }
   MatrixXb fullx(f_rows + s_rows, f_cols + s_cols),
       fullz(f_rows + s_rows, f_cols + s_cols);
-  fullx << first.tab_.xmat, MatrixXb::Zero(f_rows, s_cols),
-      MatrixXb::Zero(s_rows, f_cols), second.tab_.xmat;
-  fullz << first.tab_.zmat, MatrixXb::Zero(f_rows, s_cols),
-      MatrixXb::Zero(s_rows, f_cols), second.tab_.zmat;
+  fullx << first.tab_.xmat.to_matrix(), MatrixXb::Zero(f_rows, s_cols),
+      MatrixXb::Zero(s_rows, f_cols), second.tab_.xmat.to_matrix();
+  fullz << first.tab_.zmat.to_matrix(), MatrixXb::Zero(f_rows, s_cols),
+      MatrixXb::Zero(s_rows, f_cols), second.tab_.zmat.to_matrix();
   VectorXb fullph(f_rows + s_rows);
   fullph << first.tab_.phase, second.tab_.phase;
   ChoiMixTableau combined(fullx, fullz, fullph, 0);
@@ -0,0 +1,143 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "tket/OpType/OpType.hpp"
+#include "tket/OpType/OpTypeInfo.hpp"
+
+namespace tket {
+
+/**
+ * Decompose a Clifford gate into the primitive gates of a tableau-like
+ * class, which must provide apply_S, apply_Z, apply_V, apply_X, apply_H and
+ * apply_CX on qubit indices.
+ *
+ * @param tab the tableau to update
+ * @param type the gate type
+ * @param qbs the qubit indices the gate acts on
+ * @param name the name of the class, for error messages
+ */
+template <typename Tableau>
+void apply_gate_to(
+    Tableau &tab, OpType type, const std::vector<unsigned> &qbs,
+    const std::string &name) {
+  switch (type) {
+    case OpType::Z: {
+      tab.apply_Z(qbs.at(0));
+      break;
+    }
+    case OpType::X: {
+      tab.apply_X(qbs.at(0));
+      break;
+    }
+    case OpType::Y: {
+      tab.apply_Z(qbs.at(0));
+      tab.apply_X(qbs.at(0));
+      break;
+    }
+    case OpType::S: {
+      tab.apply_S(qbs.at(0));
+      break;
+    }
+    case OpType::Sdg: {
+      tab.apply_S(qbs.at(0));
+      tab.apply_Z(qbs.at(0));
+      break;
+    }
+    case OpType::V:
+    case OpType::SX: {
+      tab.apply_V(qbs.at(0));
+      break;
+    }
+    case OpType::Vdg:
+    case OpType::SXdg: {
+      tab.apply_V(qbs.at(0));
+      tab.apply_X(qbs.at(0));
+      break;
+    }
+    case OpType::H: {
+      tab.apply_H(qbs.at(0));
+      break;
+    }
+    case OpType::CX: {
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      break;
+    }
+    case OpType::CY: {
+      tab.apply_S(qbs.at(1));
+      tab.apply_Z(qbs.at(1));
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      tab.apply_S(qbs.at(1));
+      break;
+    }
+    case OpType::CZ: {
+      tab.apply_H(qbs.at(1));
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      tab.apply_H(qbs.at(1));
+      break;
+    }
+    case OpType::SWAP: {
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      tab.apply_CX(qbs.at(1), qbs.at(0));
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      break;
+    }
+    case OpType::BRIDGE: {
+      tab.apply_CX(qbs.at(0), qbs.at(2));
+      break;
+    }
+    case OpType::ZZMax: {
+      tab.apply_H(qbs.at(1));
+      tab.apply_S(qbs.at(0));
+      tab.apply_V(qbs.at(1));
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      tab.apply_H(qbs.at(1));
+      break;
+    }
+    case OpType::ECR: {
+      tab.apply_S(qbs.at(0));
+      tab.apply_X(qbs.at(0));
+      tab.apply_V(qbs.at(1));
+      tab.apply_X(qbs.at(1));
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      break;
+    }
+    case OpType::ISWAPMax: {
+      tab.apply_V(qbs.at(0));
+      tab.apply_V(qbs.at(1));
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      tab.apply_V(qbs.at(0));
+      tab.apply_S(qbs.at(1));
+      tab.apply_Z(qbs.at(1));
+      tab.apply_CX(qbs.at(0), qbs.at(1));
+      tab.apply_V(qbs.at(0));
+      tab.apply_V(qbs.at(1));
+      break;
+    }
+    case OpType::noop:
+    case OpType::Phase: {
+      break;
+    }
+    default: {
+      throw BadOpType(
+          "Cannot be applied to a " + name + ": not a Clifford gate", type);
+    }
+  }
+}
+
+}  // namespace tket
@@ -0,0 +1,145 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Clifford/PauliFrames.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+#include "CliffordGates.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Clifford/SymplecticTableau.hpp"
+
+namespace tket {
+
+PauliFrames::PauliFrames(unsigned n_qubits, unsigned n_shots)
+    : xs_(n_qubits, n_shots), zs_(n_qubits, n_shots) {}
+
+PauliStabiliser PauliFrames::get_frame(unsigned shot) const {
+  const unsigned n_qubits = get_n_qubits();
+  DensePauliMap paulis(n_qubits);
+  for (unsigned q = 0; q < n_qubits; ++q) {
+    paulis[q] = BoolPauli{xs_(q, shot), zs_(q, shot)}.to_pauli();
+  }
+  return PauliStabiliser(paulis, 0);
+}
+
+void PauliFrames::set_frame(unsigned shot, const DensePauliMap &paulis) {
+  if (paulis.size() != get_n_qubits())
+    throw std::invalid_argument(
+        "Pauli frame does not match the number of qubits");
+  for (unsigned q = 0; q < paulis.size(); ++q) {
+    xs_(q, shot) = (paulis[q] == Pauli::X) || (paulis[q] == Pauli::Y);
+    zs_(q, shot) = (paulis[q] == Pauli::Z) || (paulis[q] == Pauli::Y);
+  }
+}
+
+void PauliFrames::randomise(unsigned qb, RNG &rng) {
+  const unsigned n_words = xs_.words_per_row();
+  const unsigned tail = get_n_shots() % BitMatrix::BITS_PER_WORD;
+  BitMatrix::Word *x = xs_.row_data(qb);
+  BitMatrix::Word *z = zs_.row_data(qb);
+  for (unsigned k = 0; k < n_words; ++k) {
+    // Keep the padding beyond the last shot zero
+    BitMatrix::Word mask = ~BitMatrix::Word(0);
+    if (k + 1 == n_words && tail != 0) mask = (BitMatrix::Word(1) << tail) - 1;
+    x[k] ^= rng() & mask;
+    z[k] ^= rng() & mask;
+  }
+}
+
+void PauliFrames::apply_S(unsigned qb) {
+  BitMatrix::xor_words(xs_.row_data(qb), zs_.row_data(qb), xs_.words_per_row());
+}
+
+void PauliFrames::apply_V(unsigned qb) {
+  BitMatrix::xor_words(zs_.row_data(qb), xs_.row_data(qb), xs_.words_per_row());
+}
+
+void PauliFrames::apply_H(unsigned qb) {
+  BitMatrix::Word *x = xs_.row_data(qb);
+  std::swap_ranges(x, x + xs_.words_per_row(), zs_.row_data(qb));
+}
+
+void PauliFrames::apply_CX(unsigned qc, unsigned qt) {
+  if (qc == qt)
+    throw std::logic_error(
+        "Attempting to apply a CX with equal control and target to Pauli "
+        "frames");
+  const unsigned n_words = xs_.words_per_row();
+  BitMatrix::xor_words(xs_.row_data(qc), xs_.row_data(qt), n_words);
+  BitMatrix::xor_words(zs_.row_data(qt), zs_.row_data(qc), n_words);
+}
+
+void PauliFrames::apply_gate(OpType type, const std::vector<unsigned> &qbs) {
+  apply_gate_to(*this, type, qbs, "PauliFrames");
+}
+
+void PauliFrames::reset(unsigned qb) {
+  xs_.set_row_zero(qb);
+  zs_.set_row_zero(qb);
+}
+
+BitMatrix PauliFrames::propagate(const Circuit &circ) {
+  const qubit_vector_t qubits = circ.all_qubits();
+  const bit_vector_t bits = circ.all_bits();
+  if (qubits.size() != get_n_qubits())
+    throw std::invalid_argument(
+        "Circuit does not match the number of qubits of the Pauli frames");
+  std::map<UnitID, unsigned> index;
+  for (unsigned i = 0; i < qubits.size(); ++i) index.insert({qubits[i], i});
+  for (unsigned i = 0; i < bits.size(); ++i) index.insert({bits[i], i});
+  BitMatrix flips(bits.size(), get_n_shots());
+  std::vector<unsigned> args;
+  for (const Command &com : circ) {
+    args.clear();
+    for (const UnitID &arg : com.get_args()) args.push_back(index.at(arg));
+    const OpType type = com.get_op_ptr()->get_type();
+    switch (type) {
+      case OpType::Measure: {
+        std::copy_n(
+            xs_.row_data(args[0]), xs_.words_per_row(),
+            flips.row_data(args[1]));
+        break;
+      }
+      case OpType::Reset: {
+        reset(args[0]);
+        break;
+      }
+      case OpType::Barrier:
+      case OpType::Collapse: {
+        break;
+      }
+      default: {
+        apply_gate(type, args);
+      }
+    }
+  }
+  // Move the frames from each wire to the qubit it ends on
+  const qubit_map_t perm = circ.implicit_qubit_permutation();
+  BitMatrix xs(xs_.rows(), xs_.cols());
+  BitMatrix zs(zs_.rows(), zs_.cols());
+  for (const auto &[in, out] : perm) {
+    const unsigned from = index.at(in);
+    const unsigned to = index.at(out);
+    std::copy_n(xs_.row_data(from), xs_.words_per_row(), xs.row_data(to));
+    std::copy_n(zs_.row_data(from), zs_.words_per_row(), zs.row_data(to));
+  }
+  xs_ = std::move(xs);
+  zs_ = std::move(zs);
+  return flips;
+}
+
+}  // namespace tket
@@ -14,8 +14,11 @@
 
 #include "tket/Clifford/SymplecticTableau.hpp"
 
+#include <bit>
+#include <boost/functional/hash.hpp>
 #include <stdexcept>
 
+#include "CliffordGates.hpp"
 #include "tket/OpType/OpTypeInfo.hpp"
 #include "tket/Utils/EigenConfig.hpp"
 
@@ -75,8 +78,8 @@ SymplecticTableau::SymplecticTableau(const PauliStabiliserVec &rows) {
   unsigned n_rows = rows.size();
   unsigned n_qubits = 0;
   if (n_rows != 0) n_qubits = rows[0].string.size();
-  xmat = MatrixXb::Zero(n_rows, n_qubits);
-  zmat = MatrixXb::Zero(n_rows, n_qubits);
+  xmat = BitMatrix(n_rows, n_qubits);
+  zmat = BitMatrix(n_rows, n_qubits);
   phase = VectorXb::Zero(n_rows);
   for (unsigned i = 0; i < n_rows; ++i) {
     const PauliStabiliser &stab = rows[i];
@@ -106,15 +109,13 @@ PauliStabiliser SymplecticTableau::get_pauli(unsigned i) const {
 
 std::ostream &operator<<(std::ostream &os, const SymplecticTableau &tab) {
   for (unsigned i = 0; i < tab.get_n_rows(); ++i) {
-    os << tab.xmat.row(i) << " " << tab.zmat.row(i) << " " << tab.phase(i)
-       << std::endl;
+    os << tab.xmat.get_row(i) << " " << tab.zmat.get_row(i) << " "
+       << tab.phase(i) << std::endl;
   }
   return os;
 }
 
 bool SymplecticTableau::operator==(const SymplecticTableau &other) const {
-  // Need this to short-circuit before matrix checks as comparing matrices of
-  // different sizes will throw an exception
   return (this->get_n_rows() == other.get_n_rows()) &&
          (this->get_n_qubits() == other.get_n_qubits()) &&
          (this->xmat == other.xmat) && (this->zmat == other.zmat) &&
@@ -122,17 +123,20 @@ bool SymplecticTableau::operator==(const SymplecticTableau &other) const {
 }
 
 void SymplecticTableau::row_mult(unsigned ra, unsigned rw, Complex coeff) {
-  MatrixXb::RowXpr xa = xmat.row(ra);
-  MatrixXb::RowXpr za = zmat.row(ra);
-  MatrixXb::RowXpr xw = xmat.row(rw);
-  MatrixXb::RowXpr zw = zmat.row(rw);
-  row_mult(xa, za, phase(ra), xw, zw, phase(rw), coeff, xw, zw, phase(rw));
+  bool pw = phase(rw);
+  row_mult(
+      xmat.row_data(ra), zmat.row_data(ra), phase(ra), xmat.row_data(rw),
+      zmat.row_data(rw), pw, coeff, xmat.row_data(rw), zmat.row_data(rw), pw);
+  phase(rw) = pw;
 }
 
 void SymplecticTableau::apply_S(unsigned qb) {
-  MatrixXb::ColXpr xcol = xmat.col(qb);
-  MatrixXb::ColXpr zcol = zmat.col(qb);
-  col_mult(xcol, zcol, false, zcol, phase);
+  for (unsigned i = 0; i < get_n_rows(); ++i) {
+    bool x = xmat(i, qb);
+    bool z = zmat(i, qb);
+    phase(i) = phase(i) ^ (x && z);
+    zmat(i, qb) = x ^ z;
+  }
 }
 
 void SymplecticTableau::apply_Z(unsigned qb) {
@@ -140,9 +144,12 @@ void SymplecticTableau::apply_Z(unsigned qb) {
 }
 
 void SymplecticTableau::apply_V(unsigned qb) {
-  MatrixXb::ColXpr xcol = xmat.col(qb);
-  MatrixXb::ColXpr zcol = zmat.col(qb);
-  col_mult(zcol, xcol, true, xcol, phase);
+  for (unsigned i = 0; i < get_n_rows(); ++i) {
+    bool x = xmat(i, qb);
+    bool z = zmat(i, qb);
+    phase(i) = phase(i) ^ (z && !x);
+    xmat(i, qb) = x ^ z;
+  }
 }
 
 void SymplecticTableau::apply_X(unsigned qb) {
@@ -151,10 +158,11 @@ void SymplecticTableau::apply_X(unsigned qb) {
 
 void SymplecticTableau::apply_H(unsigned qb) {
   for (unsigned i = 0; i < get_n_rows(); ++i) {
-    phase(i) = phase(i) ^ (xmat(i, qb) && zmat(i, qb));
-    bool temp = xmat(i, qb);
-    xmat(i, qb) = zmat(i, qb);
-    zmat(i, qb) = temp;
+    bool x = xmat(i, qb);
+    bool z = zmat(i, qb);
+    phase(i) = phase(i) ^ (x && z);
+    xmat(i, qb) = z;
+    zmat(i, qb) = x;
   }
 }
 
@@ -163,118 +171,19 @@ void SymplecticTableau::apply_CX(unsigned qc, unsigned qt) {
     throw std::logic_error(
         "Attempting to apply a CX with equal control and target in a tableau");
   for (unsigned i = 0; i < get_n_rows(); ++i) {
-    phase(i) =
-        phase(i) ^ (xmat(i, qc) && zmat(i, qt) && !(xmat(i, qt) ^ zmat(i, qc)));
-    xmat(i, qt) = xmat(i, qc) ^ xmat(i, qt);
-    zmat(i, qc) = zmat(i, qc) ^ zmat(i, qt);
+    bool xc = xmat(i, qc);
+    bool zc = zmat(i, qc);
+    bool xt = xmat(i, qt);
+    bool zt = zmat(i, qt);
+    phase(i) = phase(i) ^ (xc && zt && !(xt ^ zc));
+    xmat(i, qt) = xc ^ xt;
+    zmat(i, qc) = zc ^ zt;
   }
 }
 
 void SymplecticTableau::apply_gate(
     OpType type, const std::vector<unsigned> &qbs) {
-  switch (type) {
-    case OpType::Z: {
-      apply_Z(qbs.at(0));
-      break;
-    }
-    case OpType::X: {
-      apply_X(qbs.at(0));
-      break;
-    }
-    case OpType::Y: {
-      apply_Z(qbs.at(0));
-      apply_X(qbs.at(0));
-      break;
-    }
-    case OpType::S: {
-      apply_S(qbs.at(0));
-      break;
-    }
-    case OpType::Sdg: {
-      apply_S(qbs.at(0));
-      apply_Z(qbs.at(0));
-      break;
-    }
-    case OpType::V:
-    case OpType::SX: {
-      apply_V(qbs.at(0));
-      break;
-    }
-    case OpType::Vdg:
-    case OpType::SXdg: {
-      apply_V(qbs.at(0));
-      apply_X(qbs.at(0));
-      break;
-    }
-    case OpType::H: {
-      apply_H(qbs.at(0));
-      break;
-    }
-    case OpType::CX: {
-      apply_CX(qbs.at(0), qbs.at(1));
-      break;
-    }
-    case OpType::CY: {
-      apply_S(qbs.at(1));
-      apply_Z(qbs.at(1));
-      apply_CX(qbs.at(0), qbs.at(1));
-      apply_S(qbs.at(1));
-      break;
-    }
-    case OpType::CZ: {
-      apply_H(qbs.at(1));
-      apply_CX(qbs.at(0), qbs.at(1));
-      apply_H(qbs.at(1));
-      break;
-    }
-    case OpType::SWAP: {
-      apply_CX(qbs.at(0), qbs.at(1));
-      apply_CX(qbs.at(1), qbs.at(0));
-      apply_CX(qbs.at(0), qbs.at(1));
-      break;
-    }
-    case OpType::BRIDGE: {
-      apply_CX(qbs.at(0), qbs.at(2));
-      break;
-    }
-    case OpType::ZZMax: {
-      apply_H(qbs.at(1));
-      apply_S(qbs.at(0));
-      apply_V(qbs.at(1));
-      apply_CX(qbs.at(0), qbs.at(1));
-      apply_H(qbs.at(1));
-      break;
-    }
-    case OpType::ECR: {
-      apply_S(qbs.at(0));
-      apply_X(qbs.at(0));
-      apply_V(qbs.at(1));
-      apply_X(qbs.at(1));
-      apply_CX(qbs.at(0), qbs.at(1));
-      break;
-    }
-    case OpType::ISWAPMax: {
-      apply_V(qbs.at(0));
-      apply_V(qbs.at(1));
-      apply_CX(qbs.at(0), qbs.at(1));
-      apply_V(qbs.at(0));
-      apply_S(qbs.at(1));
-      apply_Z(qbs.at(1));
-      apply_CX(qbs.at(0), qbs.at(1));
-      apply_V(qbs.at(0));
-      apply_V(qbs.at(1));
-      break;
-    }
-    case OpType::noop:
-    case OpType::Phase: {
-      break;
-    }
-    default: {
-      throw BadOpType(
-          "Cannot be applied to a SymplecticTableau: not a Clifford gate",
-          type);
-    }
-  }
+  apply_gate_to(*this, type, qbs, "SymplecticTableau");
 }
 
 void SymplecticTableau::apply_pauli_gadget(
@@ -312,41 +221,41 @@ void SymplecticTableau::apply_pauli_gadget(
 
   // From here, half_pis == 1 or 3
   // They act the same except for a phase flip on the product term
-  MatrixXb pauli_xrow = MatrixXb::Zero(1, n_qubits);
-  MatrixXb pauli_zrow = MatrixXb::Zero(1, n_qubits);
+  BitMatrix pauli_xrow(1, n_qubits);
+  BitMatrix pauli_zrow(1, n_qubits);
   for (unsigned i = 0; i < n_qubits; ++i) {
     Pauli p = pauli.string.at(i);
-    pauli_xrow(i) = (p == Pauli::X) || (p == Pauli::Y);
-    pauli_zrow(i) = (p == Pauli::Z) || (p == Pauli::Y);
+    pauli_xrow(0, i) = (p == Pauli::X) || (p == Pauli::Y);
+    pauli_zrow(0, i) = (p == Pauli::Z) || (p == Pauli::Y);
   }
   bool phase_flip = pauli.is_real_negative() ^ (half_pis == 3);
+  const BitMatrix::Word *px = pauli_xrow.row_data(0);
+  const BitMatrix::Word *pz = pauli_zrow.row_data(0);
+  unsigned n_words = xmat.words_per_row();
 
   for (unsigned i = 0; i < get_n_rows(); ++i) {
-    bool anti = false;
-    MatrixXb::RowXpr xr = xmat.row(i);
-    MatrixXb::RowXpr zr = zmat.row(i);
-    for (unsigned q = 0; q < n_qubits; ++q) {
-      anti ^= (xr(q) && pauli_zrow(q));
-      anti ^= (zr(q) && pauli_xrow(q));
-    }
+    BitMatrix::Word *xr = xmat.row_data(i);
+    BitMatrix::Word *zr = zmat.row_data(i);
+    bool anti = BitMatrix::and_parity(xr, pz, n_words) ^
+                BitMatrix::and_parity(zr, px, n_words);
     if (anti) {
-      row_mult(
-          xr, zr, phase(i), pauli_xrow.row(0), pauli_zrow.row(0), phase_flip,
-          i_, xr, zr, phase(i));
+      bool pw = phase(i);
+      row_mult(xr, zr, pw, px, pz, phase_flip, i_, xr, zr, pw);
+      phase(i) = pw;
     }
   }
 }
 
 MatrixXb SymplecticTableau::anticommuting_rows() const {
   unsigned n_rows = get_n_rows();
+  unsigned n_words = xmat.words_per_row();
   MatrixXb res = MatrixXb::Zero(n_rows, n_rows);
   for (unsigned i = 0; i < n_rows; ++i) {
     for (unsigned j = 0; j < i; ++j) {
-      bool anti = false;
-      for (unsigned q = 0; q < get_n_qubits(); ++q) {
-        anti ^= (xmat(i, q) && zmat(j, q));
-        anti ^= (xmat(j, q) && zmat(i, q));
-      }
+      bool anti = BitMatrix::and_parity(
+                      xmat.row_data(i), zmat.row_data(j), n_words) ^
+                  BitMatrix::and_parity(
+                      xmat.row_data(j), zmat.row_data(i), n_words);
       res(i, j) = anti;
       res(j, i) = anti;
     }
@@ -361,8 +270,8 @@ unsigned SymplecticTableau::rank() const {
   unsigned empty_rows = 0;
   unsigned n_rows = get_n_rows();
   for (unsigned i = 0; i < n_rows; ++i) {
-    if (copy.xmat.row(n_rows - 1 - i).isZero() &&
-        copy.zmat.row(n_rows - 1 - i).isZero())
+    if (copy.xmat.row_is_zero(n_rows - 1 - i) &&
+        copy.zmat.row_is_zero(n_rows - 1 - i))
       ++empty_rows;
     else
       break;
@@ -373,19 +282,17 @@ unsigned SymplecticTableau::rank() const {
 SymplecticTableau SymplecticTableau::conjugate() const {
   SymplecticTableau conj(*this);
   for (unsigned i = 0; i < get_n_rows(); ++i) {
-    unsigned sum = 0;
-    for (unsigned j = 0; j < get_n_qubits(); ++j) {
-      if (xmat(i, j) && zmat(i, j)) ++sum;
-    }
-    if (sum % 2 == 1) conj.phase(i) ^= true;
+    if (BitMatrix::and_parity(
+            xmat.row_data(i), zmat.row_data(i), xmat.words_per_row()))
+      conj.phase(i) ^= true;
   }
   return conj;
 }
 
 void SymplecticTableau::gaussian_form() {
   MatrixXb fullmat = MatrixXb::Zero(get_n_rows(), 2 * get_n_qubits());
-  fullmat(Eigen::all, Eigen::seq(0, Eigen::last, 2)) = xmat;
-  fullmat(Eigen::all, Eigen::seq(1, Eigen::last, 2)) = zmat;
+  fullmat(Eigen::all, Eigen::seq(0, Eigen::last, 2)) = xmat.to_matrix();
+  fullmat(Eigen::all, Eigen::seq(1, Eigen::last, 2)) = zmat.to_matrix();
   std::vector<std::pair<unsigned, unsigned>> row_ops =
       gaussian_elimination_row_ops(fullmat);
   for (const std::pair<unsigned, unsigned> &op : row_ops) {
@@ -393,36 +300,158 @@ void SymplecticTableau::gaussian_form() {
   }
 }
 
+SymplecticTableau SymplecticTableau::canonical_form() const {
+  SymplecticTableau canon(*this);
+  canon.gaussian_form();
+  // Rows reduced to +I come last in the Gaussian form
+  unsigned n_rows = canon.get_n_rows();
+  while (n_rows > 0 && canon.xmat.row_is_zero(n_rows - 1) &&
+         canon.zmat.row_is_zero(n_rows - 1) && !canon.phase(n_rows - 1)) {
+    --n_rows;
+  }
+  canon.xmat.conservative_resize(n_rows, canon.get_n_qubits());
+  canon.zmat.conservative_resize(n_rows, canon.get_n_qubits());
+  canon.phase.conservativeResize(n_rows);
+  return canon;
+}
+
+std::size_t SymplecticTableau::hash_value() const {
+  std::size_t seed = xmat.hash_value();
+  boost::hash_combine(seed, zmat.hash_value());
+  for (unsigned i = 0; i < phase.size(); ++i) {
+    boost::hash_combine(seed, phase(i));
+  }
+  return seed;
+}
+
+std::size_t SymplecticTableau::memory_usage() const {
+  return sizeof(SymplecticTableau) + xmat.memory_usage() - sizeof(xmat) +
+         zmat.memory_usage() - sizeof(zmat) + phase.size() * sizeof(bool);
+}
+
 void SymplecticTableau::row_mult(
-    const MatrixXb::RowXpr &xa, const MatrixXb::RowXpr &za, const bool &pa,
-    const MatrixXb::RowXpr &xb, const MatrixXb::RowXpr &zb, const bool &pb,
-    Complex phase, MatrixXb::RowXpr &xw, MatrixXb::RowXpr &zw, bool &pw) {
+    const BitMatrix::Word *xa, const BitMatrix::Word *za, bool pa,
+    const BitMatrix::Word *xb, const BitMatrix::Word *zb, bool pb,
+    Complex phase, BitMatrix::Word *xw, BitMatrix::Word *zw, bool &pw) {
   if (pa) phase *= -1;
   if (pb) phase *= -1;
-  for (unsigned i = 0; i < get_n_qubits(); i++) {
-    std::pair<BoolPauli, Complex> res =
-        BoolPauli::mult_lut.at({{xa(i), za(i)}, {xb(i), zb(i)}});
-    xw(i) = res.first.x;
-    zw(i) = res.first.z;
-    phase *= res.second;
+  const unsigned n_words = xmat.words_per_row();
+  const unsigned exponent = product_exponent(xa, za, xb, zb, n_words);
+  for (unsigned k = 0; k < n_words; ++k) {
+    xw[k] = xa[k] ^ xb[k];
+    zw[k] = za[k] ^ zb[k];
   }
+  for (unsigned e = 0; e < exponent; ++e) phase *= i_;
   pw = (phase == -1.);
 }
 
-void SymplecticTableau::col_mult(
-    const MatrixXb::ColXpr &a, const MatrixXb::ColXpr &b, bool flip,
-    MatrixXb::ColXpr &w, VectorXb &pw) {
-  for (unsigned i = 0; i < get_n_rows(); i++) {
-    pw(i) = pw(i) ^ (a(i) && (b(i) ^ flip));
-    w(i) = a(i) ^ b(i);
+unsigned SymplecticTableau::product_exponent(
+    const BitMatrix::Word *xa, const BitMatrix::Word *za,
+    const BitMatrix::Word *xb, const BitMatrix::Word *zb, unsigned n_words) {
+  // Each qubit contributes a factor of i (ZX, XY, YZ), -i (ZY, XZ, YX) or 1
+  // to the product (see BoolPauli::mult_lut); count these a word at a time.
+  unsigned exponent = 0;
+  for (unsigned k = 0; k < n_words; ++k) {
+    BitMatrix::Word x1 = xa[k], z1 = za[k], x2 = xb[k], z2 = zb[k];
+    BitMatrix::Word plus =
+        (~x1 & z1 & x2 & ~z2) | (x1 & ~z1 & x2 & z2) | (x1 & z1 & ~x2 & z2);
+    BitMatrix::Word minus =
+        (~x1 & z1 & x2 & z2) | (x1 & ~z1 & ~x2 & z2) | (x1 & z1 & x2 & ~z2);
+    exponent += std::popcount(plus) + 3 * std::popcount(minus);
+  }
+  return exponent % 4;
+}
+
+ColumnPackedTableau::ColumnPackedTableau(const SymplecticTableau &tab)
+    : xcols_(tab.xmat.transpose()),
+      zcols_(tab.zmat.transpose()),
+      phase_(1, tab.get_n_rows()) {
+  for (unsigned i = 0; i < tab.get_n_rows(); ++i) phase_(0, i) = tab.phase(i);
+}
+
+SymplecticTableau ColumnPackedTableau::to_tableau() const {
+  SymplecticTableau tab(PauliStabiliserVec{});
+  tab.xmat = xcols_.transpose();
+  tab.zmat = zcols_.transpose();
+  tab.phase = phase_.get_row(0).transpose();
+  return tab;
+}
+
+PauliStabiliser ColumnPackedTableau::get_pauli(unsigned i) const {
+  unsigned n_qubits = get_n_qubits();
+  std::vector<Pauli> str(n_qubits);
+  for (unsigned q = 0; q < n_qubits; ++q) {
+    str[q] = BoolPauli{xcols_(q, i), zcols_(q, i)}.to_pauli();
+  }
+  return PauliStabiliser(str, phase_(0, i) ? 2 : 0);
+}
+
+void ColumnPackedTableau::apply_S(unsigned qb) {
+  BitMatrix::Word *x = xcols_.row_data(qb);
+  BitMatrix::Word *z = zcols_.row_data(qb);
+  BitMatrix::Word *p = phase_.row_data(0);
+  for (unsigned k = 0; k < phase_.words_per_row(); ++k) {
+    p[k] ^= x[k] & z[k];
+    z[k] ^= x[k];
   }
 }
 
+void ColumnPackedTableau::apply_Z(unsigned qb) {
+  BitMatrix::xor_words(
+      xcols_.row_data(qb), phase_.row_data(0), phase_.words_per_row());
+}
+
+void ColumnPackedTableau::apply_V(unsigned qb) {
+  BitMatrix::Word *x = xcols_.row_data(qb);
+  BitMatrix::Word *z = zcols_.row_data(qb);
+  BitMatrix::Word *p = phase_.row_data(0);
+  for (unsigned k = 0; k < phase_.words_per_row(); ++k) {
+    p[k] ^= z[k] & ~x[k];
+    x[k] ^= z[k];
+  }
+}
+
+void ColumnPackedTableau::apply_X(unsigned qb) {
+  BitMatrix::xor_words(
+      zcols_.row_data(qb), phase_.row_data(0), phase_.words_per_row());
+}
+
+void ColumnPackedTableau::apply_H(unsigned qb) {
+  BitMatrix::Word *x = xcols_.row_data(qb);
+  BitMatrix::Word *z = zcols_.row_data(qb);
+  BitMatrix::Word *p = phase_.row_data(0);
+  for (unsigned k = 0; k < phase_.words_per_row(); ++k) {
+    p[k] ^= x[k] & z[k];
+    std::swap(x[k], z[k]);
+  }
+}
+
+void ColumnPackedTableau::apply_CX(unsigned qc, unsigned qt) {
+  if (qc == qt)
+    throw std::logic_error(
+        "Attempting to apply a CX with equal control and target in a tableau");
+  BitMatrix::Word *xc = xcols_.row_data(qc);
+  BitMatrix::Word *zc = zcols_.row_data(qc);
+  BitMatrix::Word *xt = xcols_.row_data(qt);
+  BitMatrix::Word *zt = zcols_.row_data(qt);
+  BitMatrix::Word *p = phase_.row_data(0);
+  for (unsigned k = 0; k < phase_.words_per_row(); ++k) {
+    p[k] ^= xc[k] & zt[k] & ~(xt[k] ^ zc[k]);
+    xt[k] ^= xc[k];
+    zc[k] ^= zt[k];
+  }
+}
+
+void ColumnPackedTableau::apply_gate(
+    OpType type, const std::vector<unsigned> &qbs) {
+  apply_gate_to(*this, type, qbs, "SymplecticTableau");
+}
+
 void to_json(nlohmann::json &j, const SymplecticTableau &tab) {
   j["nrows"] = tab.get_n_rows();
   j["nqubits"] = tab.get_n_qubits();
-  j["xmat"] = tab.xmat;
-  j["zmat"] = tab.zmat;
+  j["xmat"] = tab.xmat.to_matrix();
+  j["zmat"] = tab.zmat.to_matrix();
   j["phase"] = tab.phase;
 }
 
@@ -14,12 +14,17 @@
 
 #include "tket/Clifford/UnitaryTableau.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <boost/functional/hash.hpp>
 #include <stdexcept>
+#include <vector>
 
 #include "tkassert/Assert.hpp"
 #include "tket/Gate/OpPtrFunctions.hpp"
 #include "tket/OpType/OpTypeInfo.hpp"
 #include "tket/Ops/Op.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 
 namespace tket {
 
@@ -191,8 +196,8 @@ void UnitaryTableau::apply_H_at_front(const Qubit& qb) {
   bool temp = tab_.phase(uqb);
   tab_.phase(uqb) = tab_.phase(uqb + n_qubits);
   tab_.phase(uqb + n_qubits) = temp;
-  tab_.xmat.row(uqb).swap(tab_.xmat.row(uqb + n_qubits));
-  tab_.zmat.row(uqb).swap(tab_.zmat.row(uqb + n_qubits));
+  tab_.xmat.swap_rows(uqb, uqb + n_qubits);
+  tab_.zmat.swap_rows(uqb, uqb + n_qubits);
 }
 
 void UnitaryTableau::apply_H_at_end(const Qubit& qb) {
@@ -459,6 +464,109 @@ UnitaryTableau UnitaryTableau::dagger() const {
   return dag;
 }
 
+// Write the image under a unitary tableau of the Pauli string (x_in, z_in),
+// with phase i^exponent, into (x_out, z_out), which must not overlap the
+// input, and return the exponent of its phase.
+static unsigned image_of_string(
+    const SymplecticTableau& tab, const BitMatrix::Word* x_in,
+    const BitMatrix::Word* z_in, unsigned exponent, BitMatrix::Word* x_out,
+    BitMatrix::Word* z_out) {
+  const unsigned n_qubits = tab.get_n_qubits();
+  const unsigned n_words = tab.xmat.words_per_row();
+  std::fill(x_out, x_out + n_words, 0);
+  std::fill(z_out, z_out + n_words, 0);
+  const auto mult_row = [&](unsigned r) {
+    exponent += SymplecticTableau::product_exponent(
+        x_out, z_out, tab.xmat.row_data(r), tab.zmat.row_data(r), n_words);
+    if (tab.phase(r)) exponent += 2;
+    BitMatrix::xor_words(tab.xmat.row_data(r), x_out, n_words);
+    BitMatrix::xor_words(tab.zmat.row_data(r), z_out, n_words);
+  };
+  for (unsigned k = 0; k < n_words; ++k) {
+    const BitMatrix::Word xk = x_in[k];
+    const BitMatrix::Word zk = z_in[k];
+    for (BitMatrix::Word bits = xk | zk; bits != 0; bits &= bits - 1) {
+      const BitMatrix::Word bit = bits & -bits;
+      const unsigned q = k * BitMatrix::BITS_PER_WORD + std::countr_zero(bits);
+      if (xk & bit) mult_row(q);
+      if (zk & bit) {
+        mult_row(q + n_qubits);
+        // Y = iXZ
+        if (xk & bit) ++exponent;
+      }
+    }
+  }
+  return exponent % 4;
+}
+
+void UnitaryTableau::compose_aligned(
+    const UnitaryTableau& first, const UnitaryTableau& second,
+    UnitaryTableau& result) {
+  const unsigned nqb = first.qubits_.size();
+  if (second.qubits_.size() != nqb)
+    throw std::invalid_argument(
+        "Cannot compose aligned tableaux over different numbers of qubits");
+  if (&result == &first || &result == &second) {
+    UnitaryTableau separate(nqb);
+    compose_aligned(first, second, separate);
+    result = std::move(separate);
+    return;
+  }
+  if (result.qubits_.size() != nqb) result = UnitaryTableau(nqb);
+  const SymplecticTableau& ftab = first.tab_;
+  SymplecticTableau& rtab = result.tab_;
+  for (unsigned r = 0; r < 2 * nqb; ++r) {
+    unsigned exponent = image_of_string(
+        second.tab_, ftab.xmat.row_data(r), ftab.zmat.row_data(r),
+        ftab.phase(r) ? 2 : 0, rtab.xmat.row_data(r), rtab.zmat.row_data(r));
+    rtab.phase(r) = (exponent == 2);
+  }
+}
+
+void UnitaryTableau::dagger_aligned(UnitaryTableau& result) const {
+  const unsigned nqb = qubits_.size();
+  if (&result == this) {
+    UnitaryTableau separate(nqb);
+    dagger_aligned(separate);
+    result = std::move(separate);
+    return;
+  }
+  if (result.qubits_.size() != nqb) result = UnitaryTableau(nqb);
+  // As in dagger(), the inverse transposes the blocks of the tableau, with
+  // the x and z components of the diagonal blocks exchanged
+  SymplecticTableau& rtab = result.tab_;
+  for (unsigned r = 0; r < 2 * nqb; ++r) {
+    rtab.xmat.set_row_zero(r);
+    rtab.zmat.set_row_zero(r);
+  }
+  for (unsigned i = 0; i < nqb; ++i) {
+    for (unsigned j = 0; j < nqb; ++j) {
+      if (tab_.zmat(i + nqb, j)) rtab.xmat(j, i) = true;
+      if (tab_.zmat(i, j)) rtab.zmat(j, i) = true;
+      if (tab_.xmat(i + nqb, j)) rtab.xmat(j + nqb, i) = true;
+      if (tab_.xmat(i, j)) rtab.zmat(j + nqb, i) = true;
+    }
+  }
+  // Each row is then signed so that this tableau maps it back to +X_i or
+  // +Z_i; scratch space for the image fits on the stack for up to 64 qubits
+  const unsigned n_words = tab_.xmat.words_per_row();
+  BitMatrix::Word x_word, z_word;
+  std::vector<BitMatrix::Word> scratch;
+  BitMatrix::Word* x_image = &x_word;
+  BitMatrix::Word* z_image = &z_word;
+  if (n_words > 1) {
+    scratch.resize(2 * n_words);
+    x_image = scratch.data();
+    z_image = scratch.data() + n_words;
+  }
+  for (unsigned r = 0; r < 2 * nqb; ++r) {
+    unsigned exponent = image_of_string(
+        tab_, rtab.xmat.row_data(r), rtab.zmat.row_data(r), 0, x_image,
+        z_image);
+    rtab.phase(r) = (exponent == 2);
+  }
+}
+
 UnitaryTableau UnitaryTableau::transpose() const {
   return dagger().conjugate();
 }
@@ -474,15 +582,15 @@ std::ostream& operator<<(std::ostream& os, const UnitaryTableau& tab) {
   unsigned nqs = tab.qubits_.size();
   for (unsigned i = 0; i < nqs; ++i) {
     Qubit qi = tab.qubits_.right.at(i);
-    os << "X@" << qi.repr() << "\t->\t" << tab.tab_.xmat.row(i) << "   "
-       << tab.tab_.zmat.row(i) << "   " << tab.tab_.phase(i) << std::endl;
+    os << "X@" << qi.repr() << "\t->\t" << tab.tab_.xmat.get_row(i) << "   "
+       << tab.tab_.zmat.get_row(i) << "   " << tab.tab_.phase(i) << std::endl;
   }
   os << "--" << std::endl;
   for (unsigned i = 0; i < nqs; ++i) {
     Qubit qi = tab.qubits_.right.at(i);
-    os << "Z@" << qi.repr() << "\t->\t" << tab.tab_.xmat.row(i + nqs) << "   "
-       << tab.tab_.zmat.row(i + nqs) << "   " << tab.tab_.phase(i + nqs)
-       << std::endl;
+    os << "Z@" << qi.repr() << "\t->\t" << tab.tab_.xmat.get_row(i + nqs)
+       << "   " << tab.tab_.zmat.get_row(i + nqs) << "   "
+       << tab.tab_.phase(i + nqs) << std::endl;
   }
   return os;
 }
@@ -510,6 +618,41 @@ bool UnitaryTableau::operator==(const UnitaryTableau& other) const {
   return true;
 }
 
+std::size_t UnitaryTableau::hash_value() const {
+  // Hash in the order of the qubit names, as compared by operator==
+  std::size_t seed = 0;
+  std::vector<unsigned> order;
+  bool in_order = true;
+  for (const auto& entry : qubits_.left) {
+    boost::hash_combine(seed, entry.first);
+    in_order &= (entry.second == order.size());
+    order.push_back(entry.second);
+  }
+  if (in_order) {
+    boost::hash_combine(seed, tab_.hash_value());
+    return seed;
+  }
+  const unsigned nq = order.size();
+  SymplecticTableau permuted(tab_);
+  for (unsigned i = 0; i < nq; ++i) {
+    for (unsigned j = 0; j < nq; ++j) {
+      permuted.xmat(i, j) = tab_.xmat(order[i], order[j]);
+      permuted.zmat(i, j) = tab_.zmat(order[i], order[j]);
+      permuted.xmat(i + nq, j) = tab_.xmat(order[i] + nq, order[j]);
+      permuted.zmat(i + nq, j) = tab_.zmat(order[i] + nq, order[j]);
+    }
+    permuted.phase(i) = tab_.phase(order[i]);
+    permuted.phase(i + nq) = tab_.phase(order[i] + nq);
+  }
+  boost::hash_combine(seed, permuted.hash_value());
+  return seed;
+}
+
+std::size_t UnitaryTableau::memory_usage() const {
+  return sizeof(UnitaryTableau) + tab_.memory_usage() - sizeof(tab_) +
+         memory::multi_index_bytes(qubits_, 2);
+}
+
 void to_json(nlohmann::json& j, const UnitaryTableau& tab) {
   j["tab"] = tab.tab_;
   qubit_vector_t qbs;
@@ -709,15 +852,16 @@ std::ostream& operator<<(std::ostream& os, const UnitaryRevTableau& tab) {
   unsigned nqs = tab.tab_.qubits_.size();
   for (unsigned i = 0; i < nqs; ++i) {
     Qubit qi = tab.tab_.qubits_.right.at(i);
-    os << tab.tab_.tab_.xmat.row(i) << "   " << tab.tab_.tab_.zmat.row(i)
-       << "   " << tab.tab_.tab_.phase(i) << "\t->\t"
+    os << tab.tab_.tab_.xmat.get_row(i) << "   "
+       << tab.tab_.tab_.zmat.get_row(i) << "   " << tab.tab_.tab_.phase(i)
+       << "\t->\t"
        << "X@" << qi.repr() << std::endl;
   }
   os << "--" << std::endl;
   for (unsigned i = 0; i < nqs; ++i) {
     Qubit qi = tab.tab_.qubits_.right.at(i);
-    os << tab.tab_.tab_.xmat.row(i + nqs) << "   "
-       << tab.tab_.tab_.zmat.row(i + nqs) << "   "
+    os << tab.tab_.tab_.xmat.get_row(i + nqs) << "   "
+       << tab.tab_.tab_.zmat.get_row(i + nqs) << "   "
        << tab.tab_.tab_.phase(i + nqs) << "\t->\t"
        << "Z@" << qi.repr() << std::endl;
   }
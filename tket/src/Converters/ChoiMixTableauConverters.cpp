@@ -379,8 +379,12 @@ leading_column_gaussian_col_ops(const MatrixXb& source) {
   MatrixXb reordered = MatrixXb::Zero(source.rows(), col_list.size());
   for (unsigned c = 0; c < col_list.size(); ++c)
     reordered.col(c) = source.col(col_list.at(c));
+  // Large matrices use the Patel-Markov-Hayes block size for their size;
+  // small ones keep the default so that their circuits are unchanged
+  const unsigned n_cols = col_list.size();
   std::vector<std::pair<unsigned, unsigned>> reordered_ops =
-      gaussian_elimination_col_ops(reordered);
+      gaussian_elimination_col_ops(
+          reordered, (n_cols < 32) ? 6 : pmh_blocksize(n_cols));
   std::vector<std::pair<unsigned, unsigned>> res;
   for (const std::pair<unsigned, unsigned>& op : reordered_ops)
     res.push_back({col_list.at(op.first), col_list.at(op.second)});
@@ -424,7 +428,7 @@ void ChoiMixBuilder::diagonalise_segments() {
   }
 
   // All rows are diagonalised, so we can just focus on the Z matrix
-  if (tab.tab_.xmat != MatrixXb::Zero(tab.get_n_rows(), tab.get_n_boundaries()))
+  if (tab.tab_.xmat != BitMatrix(tab.get_n_rows(), tab.get_n_boundaries()))
     throw std::logic_error(
         "Diagonalisation in ChoiMixTableau synthesis failed");
 }
@@ -443,7 +447,8 @@ void ChoiMixBuilder::solve_postselected_subspace() {
   }
   unsigned n_ins = tab.get_n_inputs();
   unsigned n_outs = tab.get_n_outputs();
-  MatrixXb subtableau = tab.tab_.zmat.bottomRightCorner(n_postselected, n_ins);
+  MatrixXb subtableau =
+      tab.tab_.zmat.to_matrix().bottomRightCorner(n_postselected, n_ins);
   std::vector<std::pair<unsigned, unsigned>> col_ops =
       leading_column_gaussian_col_ops(subtableau);
   for (const std::pair<unsigned, unsigned>& op : col_ops) {
@@ -495,8 +500,8 @@ void ChoiMixBuilder::solve_initialised_subspace() {
   }
   unsigned n_ins = tab.get_n_inputs();
   unsigned n_outs = tab.get_n_outputs();
-  MatrixXb subtableau =
-      tab.tab_.zmat.bottomRightCorner(tab.get_n_rows() - n_collapsed, n_outs);
+  MatrixXb subtableau = tab.tab_.zmat.to_matrix().bottomRightCorner(
+      tab.get_n_rows() - n_collapsed, n_outs);
   std::vector<std::pair<unsigned, unsigned>> col_ops =
       leading_column_gaussian_col_ops(subtableau);
   for (const std::pair<unsigned, unsigned>& op : col_ops) {
@@ -537,7 +542,8 @@ void ChoiMixBuilder::solve_collapsed_subspace() {
   // minimal set of qubits using CX gates
   unsigned n_ins = tab.get_n_inputs();
   unsigned n_outs = tab.get_n_outputs();
-  MatrixXb subtableau = tab.tab_.zmat.topLeftCorner(tab.get_n_rows(), n_ins);
+  MatrixXb subtableau =
+      tab.tab_.zmat.to_matrix().topLeftCorner(tab.get_n_rows(), n_ins);
   std::vector<std::pair<unsigned, unsigned>> col_ops =
       leading_column_gaussian_col_ops(subtableau);
   for (const std::pair<unsigned, unsigned>& op : col_ops) {
@@ -556,7 +562,8 @@ void ChoiMixBuilder::solve_collapsed_subspace() {
   n_ins = tab.get_n_inputs();
   n_outs = tab.get_n_outputs();
   col_ops = gaussian_elimination_col_ops(
-      tab.tab_.zmat.topRightCorner(tab.get_n_rows(), n_outs));
+      tab.tab_.zmat.to_matrix().topRightCorner(tab.get_n_rows(), n_outs),
+      (n_outs < 32) ? 6 : pmh_blocksize(n_outs));
   for (const std::pair<unsigned, unsigned>& op : col_ops) {
     tab.tab_.apply_CX(n_ins + op.second, n_ins + op.first);
     ChoiMixTableau::col_key_t ctrl = tab.col_index_.right.at(n_ins + op.second);
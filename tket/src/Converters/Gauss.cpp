@@ -23,15 +23,11 @@ void CXMaker::row_add(unsigned r0, unsigned r1) {
     _circ.add_op<unsigned>(OpType::CX, {r0, r1});
 }
 
-void DiagMatrix::row_add(unsigned r0, unsigned r1) {
-  for (unsigned i = 0; i < _matrix.row(r0).size(); ++i) {
-    _matrix.row(r1)[i] ^= _matrix.row(r0)[i];
-  }
-}
+void DiagMatrix::row_add(unsigned r0, unsigned r1) { _matrix.xor_row(r0, r1); }
 
 void DiagMatrix::col_add(unsigned c0, unsigned c1) {
-  for (unsigned i = 0; i < _matrix.col(c0).size(); ++i) {
-    _matrix.col(c1)[i] ^= _matrix.col(c0)[i];
+  for (unsigned i = 0; i < n_rows(); ++i) {
+    _matrix(i, c1) ^= _matrix(i, c0);
   }
 }
 
@@ -44,7 +40,19 @@ void DiagMatrix::gauss(CXMaker& cxmaker, unsigned blocksize) {
   }
 }
 
-bool DiagMatrix::is_id() const { return _matrix.isIdentity(); }
+bool DiagMatrix::is_id() const {
+  for (unsigned i = 0; i < n_rows(); ++i) {
+    const BitMatrix::Word* row = _matrix.row_data(i);
+    for (unsigned k = 0; k < _matrix.words_per_row(); ++k) {
+      BitMatrix::Word expected = 0;
+      if (i < n_cols() && i / BitMatrix::BITS_PER_WORD == k) {
+        expected = BitMatrix::Word(1) << (i % BitMatrix::BITS_PER_WORD);
+      }
+      if (row[k] != expected) return false;
+    }
+  }
+  return true;
+}
 
 bool DiagMatrix::is_id_until_columns(unsigned limit) const {
   TKET_ASSERT(limit <= n_rows());
@@ -76,10 +84,10 @@ unsigned DiagMatrix::n_cols() const { return _matrix.cols(); }
 
 std::ostream& operator<<(std::ostream& out, const DiagMatrix& diam) {
   out << "give the DiagMatrix: " << std::endl;
-  for (unsigned i = 0; i < diam._matrix.row(0).size(); ++i) {
+  for (unsigned i = 0; i < diam.n_cols(); ++i) {
     out << " ";
-    for (unsigned j = 0; j < diam._matrix.row(0).size(); ++j) {
-      out << diam._matrix.row(i)[j] << ", ";
+    for (unsigned j = 0; j < diam.n_cols(); ++j) {
+      out << diam._matrix(i, j) << ", ";
     }
     out << std::endl;
   }
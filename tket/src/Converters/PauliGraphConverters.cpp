@@ -12,12 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
+#include <optional>
+
 #include "tket/Circuit/Boxes.hpp"
 #include "tket/Circuit/PauliExpBoxes.hpp"
 #include "tket/Converters/Converters.hpp"
 #include "tket/Converters/PhasePoly.hpp"
 #include "tket/Diagonalisation/Diagonalisation.hpp"
 #include "tket/Gate/Gate.hpp"
+#include "tket/PauliGraph/ConjugatePauliFunctions.hpp"
 
 namespace tket {
 
@@ -171,4 +175,172 @@ Circuit pauli_graph_to_pauli_exp_box_circuit_sets(
   return circ;
 }
 
+typedef std::vector<std::pair<OpType, std::vector<unsigned>>> IndexedGates;
+
+// Clifford gates mapping a Pauli string to Z on a target qubit in its
+// support: a change of basis on each qubit, then a star of CXs onto the
+// target.
+static IndexedGates reduction_gates(
+    const PauliStabiliser &pauli, unsigned target) {
+  IndexedGates gates;
+  for (unsigned q = 0; q < pauli.string.size(); ++q) {
+    if (pauli.string[q] == Pauli::X) {
+      gates.push_back({OpType::H, {q}});
+    } else if (pauli.string[q] == Pauli::Y) {
+      gates.push_back({OpType::V, {q}});
+    }
+  }
+  for (unsigned q = 0; q < pauli.string.size(); ++q) {
+    if (q != target && pauli.string[q] != Pauli::I) {
+      gates.push_back({OpType::CX, {q, target}});
+    }
+  }
+  return gates;
+}
+
+// Number of CXs needed to reduce a Pauli string to a single qubit.
+static unsigned cx_estimate(const PauliStabiliser &pauli) {
+  unsigned weight = 0;
+  for (Pauli p : pauli.string) {
+    if (p != Pauli::I) ++weight;
+  }
+  return weight == 0 ? 0 : weight - 1;
+}
+
+Circuit pauli_graph_to_circuit_lookahead(
+    const PauliGraph &pg, unsigned lookahead) {
+  lookahead = std::max(lookahead, 1u);
+  Circuit circ;
+  // The Clifford gates emitted so far, which are undone at the end
+  Circuit frame;
+  const std::set<Qubit> qbs = pg.cliff_.get_qubits();
+  const qubit_vector_t qubits(qbs.begin(), qbs.end());
+  std::map<Qubit, unsigned> qubit_index;
+  for (const Qubit &qb : qubits) {
+    qubit_index.insert({qb, (unsigned)qubit_index.size()});
+    circ.add_qubit(qb);
+    frame.add_qubit(qb);
+  }
+  for (const Bit &b : pg.bits_) {
+    circ.add_bit(b);
+  }
+
+  const std::vector<PauliVert> vertices = pg.vertices_in_order();
+  const unsigned n_gadgets = vertices.size();
+  if (n_gadgets != 0) {
+    PauliVIndex index = boost::get(boost::vertex_index, pg.graph_);
+    std::vector<unsigned> position(n_gadgets);
+    std::vector<unsigned> n_preds(n_gadgets);
+    PauliStabiliserVec rows;
+    for (unsigned i = 0; i < n_gadgets; ++i) {
+      position[boost::get(index, vertices[i])] = i;
+      n_preds[i] = boost::in_degree(vertices[i], pg.graph_);
+      const SpPauliStabiliser &tensor = pg.graph_[vertices[i]].tensor_;
+      std::vector<Pauli> str(qubits.size(), Pauli::I);
+      for (const std::pair<const Qubit, Pauli> &qp : tensor.string) {
+        str[qubit_index.at(qp.first)] = qp.second;
+      }
+      rows.push_back(PauliStabiliser(str, tensor.coeff));
+    }
+    // The strings of the gadgets as seen through the frame, kept up to date
+    // by applying each emitted Clifford gate to all of them at once
+    ColumnPackedTableau remaining(SymplecticTableau{rows});
+    std::vector<bool> done(n_gadgets, false);
+    unsigned first_pending = 0;
+    while (first_pending < n_gadgets) {
+      // The next few gadgets in causal order; those whose predecessors are
+      // all synthesised are the candidates, the rest only inform the cost
+      std::vector<std::pair<unsigned, PauliStabiliser>> window;
+      for (unsigned i = first_pending;
+           i < n_gadgets && window.size() < lookahead; ++i) {
+        if (!done[i]) window.push_back({i, remaining.get_pauli(i)});
+      }
+      // Score each candidate and target by the CXs to reduce it plus an
+      // estimate of the CXs to reduce the rest of the window afterwards
+      unsigned best_cost = std::numeric_limits<unsigned>::max();
+      unsigned best = 0;
+      std::optional<unsigned> best_target;
+      IndexedGates best_gates;
+      for (const std::pair<unsigned, PauliStabiliser> &candidate : window) {
+        if (n_preds[candidate.first] != 0) continue;
+        std::vector<std::optional<unsigned>> targets;
+        for (unsigned q = 0; q < qubits.size(); ++q) {
+          if (candidate.second.string[q] != Pauli::I) targets.push_back(q);
+        }
+        if (targets.empty()) targets.push_back(std::nullopt);
+        for (const std::optional<unsigned> &target : targets) {
+          IndexedGates gates;
+          if (target) gates = reduction_gates(candidate.second, *target);
+          unsigned cost = cx_estimate(candidate.second);
+          for (const std::pair<unsigned, PauliStabiliser> &other : window) {
+            if (other.first == candidate.first) continue;
+            PauliStabiliser conjugated = other.second;
+            for (const std::pair<OpType, std::vector<unsigned>> &gate :
+                 gates) {
+              if (gate.first == OpType::CX) {
+                conjugate_PauliTensor(
+                    conjugated, gate.first, gate.second[0], gate.second[1]);
+              } else {
+                conjugate_PauliTensor(
+                    conjugated, gate.first, gate.second[0], true);
+              }
+            }
+            cost += cx_estimate(conjugated);
+          }
+          if (cost < best_cost) {
+            best_cost = cost;
+            best = candidate.first;
+            best_target = target;
+            best_gates = std::move(gates);
+          }
+        }
+      }
+
+      // Emit the reduction, keeping it in the frame, then the rotation
+      for (const std::pair<OpType, std::vector<unsigned>> &gate : best_gates) {
+        qubit_vector_t args;
+        for (unsigned q : gate.second) args.push_back(qubits[q]);
+        circ.add_op<Qubit>(gate.first, args);
+        frame.add_op<Qubit>(gate.first, args);
+        remaining.apply_gate(gate.first, gate.second);
+      }
+      const Expr &angle = pg.graph_[vertices[best]].angle_;
+      const bool negative = remaining.get_pauli(best).coeff == 2;
+      if (best_target) {
+        circ.add_op<Qubit>(
+            OpType::Rz, negative ? -angle : angle, {qubits[*best_target]});
+      } else {
+        circ.add_phase(negative ? angle / 2 : -angle / 2);
+      }
+
+      done[best] = true;
+      boost::graph_traits<PauliDAG>::adjacency_iterator ai, a_end;
+      boost::tie(ai, a_end) =
+          boost::adjacent_vertices(vertices[best], pg.graph_);
+      for (; ai != a_end; ++ai) {
+        --n_preds[position[boost::get(index, *ai)]];
+      }
+      while (first_pending < n_gadgets && done[first_pending]) {
+        ++first_pending;
+      }
+    }
+  }
+
+  // Undo the frame and apply the final Clifford, resynthesised as a single
+  // tableau when that needs fewer CXs
+  Circuit cliff_circuit = frame.dagger();
+  cliff_circuit.append(unitary_rev_tableau_to_circuit(pg.cliff_));
+  Circuit resynthesised =
+      unitary_tableau_to_circuit(circuit_to_unitary_tableau(cliff_circuit));
+  if (resynthesised.count_gates(OpType::CX) <
+      cliff_circuit.count_gates(OpType::CX)) {
+    cliff_circuit = resynthesised;
+  }
+  circ.append(cliff_circuit);
+  for (auto it = pg.measures_.begin(); it != pg.measures_.end(); ++it) {
+    circ.add_measure(it->left, it->right);
+  }
+  return circ;
+}
+
 }  // namespace tket
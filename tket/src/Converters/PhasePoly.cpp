@@ -15,6 +15,7 @@
 #include "tket/Converters/PhasePoly.hpp"
 
 #include <algorithm>
+#include <boost/functional/hash.hpp>
 #include <stdexcept>
 #include <string>
 #include <tklog/TketLog.hpp>
@@ -145,25 +146,82 @@ Circuit gray_synth(
   return circ;
 }
 
+std::size_t PhasePolyBuilder::WordsHash::operator()(
+    const std::vector<BitMatrix::Word>& words) const {
+  return boost::hash_range(words.begin(), words.end());
+}
+
+PhasePolyBuilder::PhasePolyBuilder(unsigned n_qubits)
+    : parities_(n_qubits, n_qubits) {
+  for (unsigned i = 0; i < n_qubits; ++i) parities_(i, i) = true;
+}
+
+void PhasePolyBuilder::add_cx(unsigned control, unsigned target) {
+  parities_.xor_row(control, target);
+}
+
+void PhasePolyBuilder::add_rz(unsigned qubit, const Expr& angle) {
+  const BitMatrix::Word* row = parities_.row_data(qubit);
+  std::vector<BitMatrix::Word> key(row, row + parities_.words_per_row());
+  auto [it, inserted] = terms_.try_emplace(std::move(key), angle);
+  if (!inserted) it->second += angle;
+}
+
+void PhasePolyBuilder::clear() {
+  const unsigned n = parities_.rows();
+  parities_ = BitMatrix(n, n);
+  for (unsigned i = 0; i < n; ++i) parities_(i, i) = true;
+  terms_.clear();
+}
+
+PhasePolynomial PhasePolyBuilder::get_phase_polynomial() const {
+  const unsigned n = parities_.cols();
+  PhasePolynomial phase_polynomial;
+  for (const auto& [words, angle] : terms_) {
+    std::vector<bool> parity(n);
+    for (unsigned j = 0; j < n; ++j) {
+      parity[j] = (words[j / BitMatrix::BITS_PER_WORD] >>
+                   (j % BitMatrix::BITS_PER_WORD)) &
+                  1;
+    }
+    phase_polynomial.emplace(std::move(parity), angle);
+  }
+  return phase_polynomial;
+}
+
+MatrixXb PhasePolyBuilder::get_linear_transformation() const {
+  return parities_.to_matrix();
+}
+
 PhasePolyBox::PhasePolyBox(const Circuit& circ)
     : Box(OpType::PhasePolyBox), n_qubits_(circ.n_qubits()) {
-  Circuit newcirc(circ);
-
   // check for classical bits
-  if (newcirc.n_bits() != 0)
+  if (circ.n_bits() != 0)
     throw std::invalid_argument(
         "Cannot construct phase polynomial from classical controlled "
         "gates");
 
-  // check the gateset of the circuit
-  for (const Command& com : newcirc) {
+  signature_ = op_signature_t(n_qubits_, EdgeType::Quantum);
+  unsigned i = 0;
+  for (const Qubit& qb : circ.all_qubits()) {
+    qubit_indices_.insert({qb, i});
+    ++i;
+  }
+  PhasePolyBuilder builder(n_qubits_);
+  for (const Command& com : circ) {
     OpType ot = com.get_op_ptr()->get_type();
-
+    unit_vector_t qbs = com.get_args();
     switch (ot) {
       case OpType::CX: {
+        builder.add_cx(
+            qubit_indices_.left.at(Qubit(qbs[0])),
+            qubit_indices_.left.at(Qubit(qbs[1])));
         break;
       }
       case OpType::Rz: {
+        builder.add_rz(
+            qubit_indices_.left.at(Qubit(qbs[0])),
+            com.get_op_ptr()->get_params().at(0));
         break;
       }
       default: {
@@ -171,53 +229,16 @@ PhasePolyBox::PhasePolyBox(const Circuit& circ)
       }
     }
   }
-
-  // replace wireswaps with three CX
-  while (newcirc.has_implicit_wireswaps()) {
-    bool foundswap = false;
-
-    qubit_map_t perm = newcirc.implicit_qubit_permutation();
-    for (const std::pair<const Qubit, Qubit>& pair : perm) {
-      if (pair.first != pair.second) {
-        if (!foundswap) {
-          newcirc.replace_implicit_wire_swap(pair.first, pair.second);
-          foundswap = true;
-        }
-      }
-    }
-  }
-
-  // generate box
-  signature_ = op_signature_t(n_qubits_, EdgeType::Quantum);
-  unsigned i = 0;
-  for (const Qubit& qb : newcirc.all_qubits()) {
-    qubit_indices_.insert({qb, i});
-    ++i;
-  }
-  linear_transformation_ = MatrixXb::Identity(n_qubits_, n_qubits_);
-  for (const Command& com : newcirc) {
-    OpType ot = com.get_op_ptr()->get_type();
-    unit_vector_t qbs = com.get_args();
-    if (ot == OpType::CX) {
-      unsigned ctrl = qubit_indices_.left.at(Qubit(qbs[0]));
-      unsigned target = qubit_indices_.left.at(Qubit(qbs[1]));
-      for (unsigned j = 0; j < n_qubits_; ++j) {
-        linear_transformation_.row(target)[j] ^=
-            linear_transformation_.row(ctrl)[j];
-      }
-    } else if (ot == OpType::Rz) {
-      unsigned qb = qubit_indices_.left.at(Qubit(qbs[0]));
-      std::vector<bool> boolvec(n_qubits_);
-      for (unsigned j = 0; j < n_qubits_; ++j) {
-        boolvec[j] = linear_transformation_.row(qb)[j];
-      }
-      PhasePolynomial::iterator pp_it = phase_polynomial_.find(boolvec);
-      if (pp_it == phase_polynomial_.end())
-        phase_polynomial_[boolvec] = com.get_op_ptr()->get_params().at(0);
-      else
-        pp_it->second += com.get_op_ptr()->get_params().at(0);
-    } else
-      TKET_ASSERT(!"Only CXs and Rzs allowed in Phase Polynomials");
+  phase_polynomial_ = builder.get_phase_polynomial();
+
+  // The wire starting at each input ends at its image under the implicit
+  // permutation, which therefore permutes the rows of the linear
+  // transformation
+  const MatrixXb parities = builder.get_linear_transformation();
+  linear_transformation_ = MatrixXb(n_qubits_, n_qubits_);
+  for (const auto& [in, out] : circ.implicit_qubit_permutation()) {
+    linear_transformation_.row(qubit_indices_.left.at(out)) =
+        parities.row(qubit_indices_.left.at(in));
   }
 }
 
@@ -291,7 +312,7 @@ void PhasePolyBox::generate_circuit() const {
   std::list<phase_term_t> phases;
   for (phase_term_t phase : phase_polynomial_) phases.push_back(phase);
   Circuit circ = gray_synth(n_qubits_, phases, linear_transformation_);
-  circ_ = std::make_shared<Circuit>(circ);
+  circ_ = std::make_shared<Circuit>(std::move(circ));
 }
 
 Circuit PhasePolyBox::generate_circuit_with_original_placement() const {
@@ -376,7 +397,8 @@ Op_ptr PhasePolyBox::from_json(const nlohmann::json& j) {
 REGISTER_OPFACTORY(PhasePolyBox, PhasePolyBox)
 
 CircToPhasePolyConversion::CircToPhasePolyConversion(
-    const Circuit& circ, unsigned min_size) {
+    const Circuit& circ, unsigned min_size)
+    : box_(circ.n_qubits()) {
   min_size_ = min_size;
   circ_ = circ;
   box_size_ = 0;
@@ -389,6 +411,7 @@ CircToPhasePolyConversion::CircToPhasePolyConversion(
   unsigned i = 0;
   for (const Qubit& qb : circ_.all_qubits()) {
     qubit_indices_.insert({qb, i});
+    box_qubit_indices_.insert({Qubit(i), i});
     ++i;
   }
 
@@ -398,115 +421,45 @@ CircToPhasePolyConversion::CircToPhasePolyConversion(
     ++i;
   }
 
-  empty_circ_ = Circuit(circ_);
-
-  VertexList bin;
+  all_qu_ = circ_.all_qubits();
+}
 
-  BGL_FORALL_VERTICES(v, empty_circ_.dag, DAG) {
-    if (!empty_circ_.detect_boundary_Op(v)) {
-      bin.push_back(v);
-    }
+void CircToPhasePolyConversion::add_to_box(
+    const Op_ptr& op, const std::vector<unsigned>& args) {
+  if (op->get_type() == OpType::CX) {
+    box_.add_cx(args[0], args[1]);
+  } else {
+    box_.add_rz(args[0], op->get_params().at(0));
   }
-
-  empty_circ_.remove_vertices(
-      bin, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::Yes);
-
-  input_circ_ = Circuit(empty_circ_);
-  box_circ_ = Circuit(nq_);
-  post_circ_ = Circuit(empty_circ_);
-
-  all_qu_ = circ_.all_qubits();
+  box_gates_.push_back({op, args});
 }
 
 void CircToPhasePolyConversion::add_phase_poly_box() {
   qubit_types_.assign(nq_, QubitType::pre);
 
   if (box_size_ >= min_size_) {
-    PhasePolyBox ppbox(box_circ_);
+    PhasePolyBox ppbox(
+        nq_, box_qubit_indices_, box_.get_phase_polynomial(),
+        box_.get_linear_transformation());
     circ_.add_box(ppbox, all_qu_);
   } else {
-    for (const Command& com : box_circ_) {
-      OpType ot = com.get_op_ptr()->get_type();
-      unit_vector_t qbs = com.get_args();
-      switch (ot) {
-        case OpType::CX: {
-          unsigned ctrl = qubit_indices_.at(Qubit(qbs[0]));
-          unsigned target = qubit_indices_.at(Qubit(qbs[1]));
-          circ_.add_op<unsigned>(ot, {ctrl, target});
-          break;
-        }
-        case OpType::Rz: {
-          unsigned qb = qubit_indices_.at(Qubit(qbs[0]));
-          auto angle = com.get_op_ptr()->get_params().at(0);
-          circ_.add_op<unsigned>(ot, angle, {qb});
-          break;
-        }
-        default: {
-          // no other types should be in this circuit
-          TKET_ASSERT(!"invalid op type in phase poly box construction");
-        }
-      }
+    for (const auto& [op, args] : box_gates_) {
+      circ_.add_op<unsigned>(op, args);
     }
   }
 
-  for (const Command& post_com : post_circ_) {
-    OpType post_ot = post_com.get_op_ptr()->get_type();
-    // no other type should be in this list
-    bool expected = (post_ot == OpType::H) || (post_ot == OpType::Measure) ||
-                    (post_ot == OpType::Collapse) || (post_ot == OpType::Reset);
-    TKET_ASSERT(expected);
-    unit_vector_t qbs = post_com.get_args();
-    unsigned qb = qubit_indices_.at(Qubit(qbs[0]));
-    if (post_ot == OpType::Measure) {
-      unsigned b = bit_indices_.at(Bit(qbs[1]));
-      circ_.add_op<unsigned>(post_ot, {qb, b});
-    } else {
-      circ_.add_op<unsigned>(post_ot, {qb});
-    }
+  for (const auto& [op, args] : post_gates_) {
+    circ_.add_op<unsigned>(op, args);
   }
 
-  post_circ_ = Circuit(empty_circ_);
-  box_circ_ = Circuit(nq_);
+  box_.clear();
+  box_gates_.clear();
+  post_gates_.clear();
   box_size_ = 0;
 }
 
 void CircToPhasePolyConversion::convert() {
-  for (const Command& com : circ_) {
-    OpType ot = com.get_op_ptr()->get_type();
-    unit_vector_t qbs = com.get_args();
-    switch (ot) {
-      case OpType::CX: {
-        input_circ_.add_op<UnitID>(ot, {qbs[0], qbs[1]});
-        break;
-      }
-      case OpType::Rz: {
-        auto angle = com.get_op_ptr()->get_params().at(0);
-        input_circ_.add_op<UnitID>(ot, angle, {qbs[0]});
-        break;
-      }
-      case OpType::H:
-      case OpType::Collapse:
-      case OpType::Reset: {
-        input_circ_.add_op<UnitID>(ot, {qbs[0]});
-        break;
-      }
-      case OpType::Measure: {
-        input_circ_.add_op<UnitID>(ot, {qbs[0], qbs[1]});
-        break;
-      }
-      case OpType::Barrier: {
-        input_circ_.add_barrier(qbs);
-        break;
-      }
-      default: {
-        throw BadOpType(
-            "Please rebase with the compiler pass RebaseUFR to only CX, Rz, H, "
-            "measure, reset, collapse, barrier gates. Found gate of different "
-            "type",
-            ot);
-      }
-    }
-  }
+  const std::vector<Command> commands = circ_.get_commands();
 
   VertexList bin;
 
@@ -520,7 +473,7 @@ void CircToPhasePolyConversion::convert() {
       bin, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::Yes);
 
   /*
-this for loop checks all gates in the circuits and try to
+this loop streams once through the gates of the circuit and tries to
 find the biggest possible sub circuits which contains only
 CX+Rz Gates. This is done in a way that all qubits get
 marked if they are currently outside before (pre), in (in)
@@ -538,8 +491,9 @@ a qubit in the post state, the current box is added and a
 new box is started to which the current gate is added. All
 qubits states are reset to pre.
 */
-  for (const Command& com : input_circ_) {
-    OpType ot = com.get_op_ptr()->get_type();
+  for (const Command& com : commands) {
+    const Op_ptr op = com.get_op_ptr();
+    OpType ot = op->get_type();
     unit_vector_t qbs = com.get_args();
     switch (ot) {
       case OpType::Barrier: {
@@ -553,23 +507,23 @@ qubits states are reset to pre.
         unsigned target = qubit_indices_.at(Qubit(qbs[1]));
         if ((qubit_types_[ctrl] == QubitType::in) &&
             (qubit_types_[target] == QubitType::in)) {
-          box_circ_.add_op<unsigned>(OpType::CX, {ctrl, target});
+          add_to_box(op, {ctrl, target});
         } else if (
             (qubit_types_[ctrl] == QubitType::pre) &&
             (qubit_types_[target] == QubitType::in)) {
           qubit_types_[ctrl] = QubitType::in;
-          box_circ_.add_op<unsigned>(OpType::CX, {ctrl, target});
+          add_to_box(op, {ctrl, target});
         } else if (
             (qubit_types_[ctrl] == QubitType::in) &&
             (qubit_types_[target] == QubitType::pre)) {
           qubit_types_[target] = QubitType::in;
-          box_circ_.add_op<unsigned>(OpType::CX, {ctrl, target});
+          add_to_box(op, {ctrl, target});
         } else if (
             (qubit_types_[ctrl] == QubitType::pre) &&
             (qubit_types_[target] == QubitType::pre)) {
           qubit_types_[ctrl] = QubitType::in;
           qubit_types_[target] = QubitType::in;
-          box_circ_.add_op<unsigned>(OpType::CX, {ctrl, target});
+          add_to_box(op, {ctrl, target});
         } else if (
             (qubit_types_[ctrl] == QubitType::post) ||
             (qubit_types_[target] == QubitType::post)) {
@@ -577,7 +531,7 @@ qubits states are reset to pre.
 
           qubit_types_[ctrl] = QubitType::in;
           qubit_types_[target] = QubitType::in;
-          box_circ_.add_op<unsigned>(OpType::CX, {ctrl, target});
+          add_to_box(op, {ctrl, target});
         } else {
           // no other types should be in this list
           TKET_ASSERT(!"Invalid Qubit Type in Phase Poly Box creation");
@@ -587,22 +541,21 @@ qubits states are reset to pre.
       }
       case OpType::Rz: {
         unsigned qb = qubit_indices_.at(Qubit(qbs[0]));
-        auto angle = com.get_op_ptr()->get_params().at(0);
         switch (qubit_types_[qb]) {
           case QubitType::pre: {
-            box_circ_.add_op<unsigned>(OpType::Rz, angle, {qb});
+            add_to_box(op, {qb});
             qubit_types_[qb] = QubitType::in;
             break;
           }
           case QubitType::in: {
-            box_circ_.add_op<unsigned>(OpType::Rz, angle, {qb});
+            add_to_box(op, {qb});
             break;
           }
           case QubitType::post: {
             add_phase_poly_box();
 
             qubit_types_[qb] = QubitType::in;
-            box_circ_.add_op<unsigned>(OpType::Rz, angle, {qb});
+            add_to_box(op, {qb});
             break;
           }
           default: {
@@ -622,12 +575,12 @@ qubits states are reset to pre.
             break;
           }
           case QubitType::in: {
-            post_circ_.add_op<unsigned>(ot, {qb});
+            post_gates_.push_back({op, {qb}});
             qubit_types_[qb] = QubitType::post;
             break;
           }
           case QubitType::post: {
-            post_circ_.add_op<unsigned>(ot, {qb});
+            post_gates_.push_back({op, {qb}});
             break;
           }
           default: {
@@ -647,12 +600,12 @@ qubits states are reset to pre.
             break;
           }
           case QubitType::in: {
-            post_circ_.add_op<unsigned>(ot, {qb, b});
+            post_gates_.push_back({op, {qb, b}});
             qubit_types_[qb] = QubitType::post;
             break;
           }
           case QubitType::post: {
-            post_circ_.add_op<unsigned>(ot, {qb, b});
+            post_gates_.push_back({op, {qb, b}});
             break;
           }
           default: {
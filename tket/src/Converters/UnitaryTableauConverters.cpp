@@ -12,26 +12,83 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
 #include <stdexcept>
+#include <unordered_map>
 
 #include "tket/Converters/Converters.hpp"
+#include "tket/OpType/OpTypeFunctions.hpp"
 
 namespace tket {
 
 UnitaryTableau circuit_to_unitary_tableau(const Circuit& circ) {
-  UnitaryTableau tab(circ.all_qubits());
-  for (const Command& com : circ) {
-    auto args = com.get_args();
-    qubit_vector_t qbs = {args.begin(), args.end()};
-    tab.apply_gate_at_end(com.get_op_ptr()->get_type(), qbs);
+  const qubit_vector_t qubits = circ.all_qubits();
+  UnitaryTableau tab(qubits);
+  // Traverse the DAG in topological order, carrying the tableau column of
+  // each qubit along its wire so that no Qubit has to be looked up per gate,
+  // and apply the gates to a column-packed copy of the tableau.
+  static constexpr unsigned NOT_QUANTUM = std::numeric_limits<unsigned>::max();
+  std::unordered_map<Vertex, std::vector<unsigned>> port_columns;
+  std::unordered_map<Vertex, unsigned> n_unvisited_preds;
+  std::vector<Vertex> ready;
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+    unsigned n_preds = boost::in_degree(v, circ.dag);
+    if (n_preds == 0)
+      ready.push_back(v);
+    else
+      n_unvisited_preds.insert({v, n_preds});
   }
+  for (unsigned i = 0; i < qubits.size(); ++i) {
+    port_columns[circ.get_in(qubits[i])] = {i};
+  }
+  ColumnPackedTableau packed(tab.tab_);
+  std::vector<unsigned> columns;
+  while (!ready.empty()) {
+    Vertex v = ready.back();
+    ready.pop_back();
+    OpType type = circ.get_OpType_from_Vertex(v);
+    if (!is_boundary_type(type)) {
+      std::vector<unsigned>& ports = port_columns[v];
+      columns.clear();
+      for (const Edge& e : circ.get_in_edges(v)) {
+        unsigned col = NOT_QUANTUM;
+        if (circ.get_edgetype(e) == EdgeType::Quantum) {
+          col = port_columns.at(circ.source(e)).at(circ.get_source_port(e));
+          columns.push_back(col);
+        }
+        ports.push_back(col);
+      }
+      packed.apply_gate(type, columns);
+    }
+    BGL_FORALL_OUTEDGES(v, e, circ.dag, DAG) {
+      Vertex succ = circ.target(e);
+      if (--n_unvisited_preds.at(succ) == 0) ready.push_back(succ);
+    }
+  }
+  tab.tab_ = packed.to_tableau();
   return tab;
 }
 
+// Add a sequence of CXs to the circuit and apply them to the tableau, on a
+// column-packed copy so that each CX acts on whole words.
+template <typename Iterator>
+static void apply_cxs(
+    SymplecticTableau& tabl, Circuit& c, Iterator begin, Iterator end) {
+  ColumnPackedTableau packed(tabl);
+  for (Iterator it = begin; it != end; ++it) {
+    c.add_op<unsigned>(OpType::CX, {it->first, it->second});
+    packed.apply_CX(it->first, it->second);
+  }
+  tabl = packed.to_tableau();
+}
+
 Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
   SymplecticTableau tabl(tab.tab_);
   unsigned size = tabl.get_n_qubits();
   Circuit c(size);
+  // Block size for the Patel-Markov-Hayes CX synthesis of each linear step;
+  // small tableaux keep the default so that their circuits are unchanged
+  const unsigned blocksize = (size < 32) ? 6 : pmh_blocksize(size);
   /*
    * Aaronson-Gottesman: Improved Simulation of Stabilizer Circuits, Theorem 8
    * Any unitary stabilizer circuit has an equivalent circuit in canonical form
@@ -44,7 +101,7 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
    * Step 1: Use Hadamards (in our case, Vs) to make C (z rows of xmat_) have
    * full rank
    */
-  MatrixXb echelon = tabl.xmat.block(size, 0, size, size);
+  MatrixXb echelon = tabl.xmat.to_matrix().block(size, 0, size, size);
   std::map<unsigned, unsigned> leading_val_to_col;
   for (unsigned i = 0; i < size; i++) {
     for (unsigned j = 0; j < size; j++) {
@@ -65,7 +122,7 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
     c.add_op<unsigned>(OpType::V, {i});
     tabl.apply_V(i);
     tabl.apply_X(i);
-    echelon.col(i) = tabl.zmat.block(size, i, size, 1);
+    echelon.col(i) = tabl.zmat.to_matrix().block(size, i, size, 1);
     for (unsigned j = 0; j < size; j++) {
       if (echelon(j, i)) {
         if (leading_val_to_col.find(j) == leading_val_to_col.end()) {
@@ -88,12 +145,9 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
    * / A B \
    * \ I D /
    */
-  MatrixXb to_reduce = tabl.xmat.block(size, 0, size, size);
-  for (const std::pair<unsigned, unsigned>& qbs :
-       gaussian_elimination_col_ops(to_reduce)) {
-    c.add_op<unsigned>(OpType::CX, {qbs.first, qbs.second});
-    tabl.apply_CX(qbs.first, qbs.second);
-  }
+  std::vector<std::pair<unsigned, unsigned>> cxs = gaussian_elimination_col_ops(
+      tabl.xmat.to_matrix().block(size, 0, size, size), blocksize);
+  apply_cxs(tabl, c, cxs.begin(), cxs.end());
 
   /*
    * Step 3: Commutativity of the stabilizer implies that ID^T is symmetric,
@@ -102,7 +156,8 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
    * for some invertible M.
    */
   std::pair<MatrixXb, MatrixXb> zp_z_llt =
-      binary_LLT_decomposition(tabl.zmat.block(size, 0, size, size));
+      binary_LLT_decomposition(
+          tabl.zmat.to_matrix().block(size, 0, size, size));
   for (unsigned i = 0; i < size; i++) {
     if (zp_z_llt.second(i, i)) {
       c.add_op<unsigned>(OpType::S, {i});
@@ -117,14 +172,8 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
    * \ M M /
    * Note that when we map I to IM, we also map D to D(M^T)^{-1} = M.
    */
-  std::vector<std::pair<unsigned, unsigned>> m_to_i =
-      gaussian_elimination_col_ops(zp_z_llt.first);
-  for (std::vector<std::pair<unsigned, unsigned>>::reverse_iterator it =
-           m_to_i.rbegin();
-       it != m_to_i.rend(); it++) {
-    c.add_op<unsigned>(OpType::CX, {it->first, it->second});
-    tabl.apply_CX(it->first, it->second);
-  }
+  cxs = gaussian_elimination_col_ops(zp_z_llt.first, blocksize);
+  apply_cxs(tabl, c, cxs.rbegin(), cxs.rend());
 
   /*
    * Step 5: Apply phases to all n qubits to obtain
@@ -147,12 +196,9 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
    * \ I 0 /
    * By commutativity relations, IB^T = A0^T + I, therefore B = I.
    */
-  to_reduce = tabl.xmat.block(size, 0, size, size);
-  for (const std::pair<unsigned, unsigned>& qbs :
-       gaussian_elimination_col_ops(to_reduce)) {
-    c.add_op<unsigned>(OpType::CX, {qbs.first, qbs.second});
-    tabl.apply_CX(qbs.first, qbs.second);
-  }
+  cxs = gaussian_elimination_col_ops(
+      tabl.xmat.to_matrix().block(size, 0, size, size), blocksize);
+  apply_cxs(tabl, c, cxs.begin(), cxs.end());
 
   /*
    * Step 7: Use Hadamards to produce
@@ -170,7 +216,7 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
    * some invertible N.
    */
   std::pair<MatrixXb, MatrixXb> xp_z_llt =
-      binary_LLT_decomposition(tabl.zmat.block(0, 0, size, size));
+      binary_LLT_decomposition(tabl.zmat.to_matrix().block(0, 0, size, size));
   for (unsigned i = 0; i < size; i++) {
     if (xp_z_llt.second(i, i)) {
       c.add_op<unsigned>(OpType::S, {i});
@@ -184,14 +230,8 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
    * / N N \
    * \ 0 C /
    */
-  std::vector<std::pair<unsigned, unsigned>> n_to_i =
-      gaussian_elimination_col_ops(xp_z_llt.first);
-  for (std::vector<std::pair<unsigned, unsigned>>::reverse_iterator it =
-           n_to_i.rbegin();
-       it != n_to_i.rend(); it++) {
-    c.add_op<unsigned>(OpType::CX, {it->first, it->second});
-    tabl.apply_CX(it->first, it->second);
-  }
+  cxs = gaussian_elimination_col_ops(xp_z_llt.first, blocksize);
+  apply_cxs(tabl, c, cxs.rbegin(), cxs.rend());
 
   /*
    * Step 10: Use phases (S) to produce
@@ -212,11 +252,9 @@ Circuit unitary_tableau_to_circuit(const UnitaryTableau& tab) {
    * / I 0 \
    * \ 0 I /
    */
-  for (const std::pair<unsigned, unsigned>& qbs :
-       gaussian_elimination_col_ops(tabl.xmat.block(0, 0, size, size))) {
-    c.add_op<unsigned>(OpType::CX, {qbs.first, qbs.second});
-    tabl.apply_CX(qbs.first, qbs.second);
-  }
+  cxs = gaussian_elimination_col_ops(
+      tabl.xmat.to_matrix().block(0, 0, size, size), blocksize);
+  apply_cxs(tabl, c, cxs.begin(), cxs.end());
 
   /*
    * DELAYED STEPS: Set all phases to 0 by applying Z or X gates
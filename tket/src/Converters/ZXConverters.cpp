@@ -583,6 +583,170 @@ std::pair<ZXDiagram, BoundaryVertMap> circuit_to_zx(const Circuit& circ) {
   return {std::move(zxd), std::move(bmap)};
 }
 
+// The open end of a qubit wire in circuit_to_graphlike_zx
+struct GraphLikeWire {
+  // The input boundary, or the ZSpider at the end of the wire
+  ZXVert last;
+  bool at_input;
+  // Whether `last` is a spider adjacent to the input boundary
+  bool touches_input;
+  // Whether a Hadamard follows `last`
+  bool pending_h;
+  // Phase to be set on `last` once the wire moves on
+  std::optional<Expr> phase;
+};
+
+static void set_wire_phase(ZXDiagram& zxd, GraphLikeWire& w) {
+  if (w.phase) {
+    zxd.set_vertex_ZXGen_ptr(
+        w.last, std::make_shared<const PhasedGen>(ZXType::ZSpider, *w.phase));
+    w.phase = std::nullopt;
+  }
+}
+
+static void extend_wire(
+    ZXDiagram& zxd, GraphLikeWire& w, ZXWireType type, const ZXGen_ptr& id) {
+  set_wire_phase(zxd, w);
+  ZXVert s = zxd.add_vertex(id);
+  zxd.add_wire(w.last, s, type);
+  w.touches_input = w.at_input;
+  w.at_input = false;
+  w.last = s;
+}
+
+// The spider at the end of the wire with no Hadamard after it
+static ZXVert open_spider(
+    ZXDiagram& zxd, GraphLikeWire& w, const ZXGen_ptr& id) {
+  if (w.at_input) extend_wire(zxd, w, ZXWireType::Basic, id);
+  if (w.pending_h) {
+    extend_wire(zxd, w, ZXWireType::H, id);
+    w.pending_h = false;
+  }
+  return w.last;
+}
+
+ZXDiagram circuit_to_graphlike_zx(
+    const Circuit& circ, BoundaryVertMap* bmap) {
+  if (circ.n_bits() != 0)
+    throw Unsupported(
+        "Cannot convert a circuit with classical bits directly to a graphlike "
+        "ZX diagram");
+  ZXDiagram zxd;
+  const ZXGen_ptr id =
+      std::make_shared<const PhasedGen>(ZXType::ZSpider, 0.);
+  qubit_vector_t qubits = circ.all_qubits();
+  std::map<Qubit, unsigned> index;
+  std::vector<GraphLikeWire> wires;
+  wires.reserve(qubits.size());
+  for (const Qubit& q : qubits) {
+    ZXVert in = zxd.add_vertex(ZXType::Input);
+    zxd.add_boundary(in);
+    if (bmap) bmap->insert({in, circ.get_in(q)});
+    index.insert({q, (unsigned)wires.size()});
+    wires.push_back({in, true, false, false, std::nullopt});
+  }
+  // Scalars are for the doubled (CPM) diagram, where each H edge is an
+  // unnormalised Hadamard and each H gate contributes 1/2
+  double scalar = 1.;
+  auto hadamard = [&](GraphLikeWire& w) {
+    w.pending_h = !w.pending_h;
+    scalar *= w.pending_h ? 0.5 : 2.;
+  };
+  auto rotate_z = [&](GraphLikeWire& w, const Expr& angle) {
+    open_spider(zxd, w, id);
+    w.phase = w.phase ? *w.phase + angle : angle;
+  };
+  auto cz = [&](GraphLikeWire& a, GraphLikeWire& b) {
+    ZXVert sa = open_spider(zxd, a, id);
+    ZXVert sb = open_spider(zxd, b, id);
+    std::optional<Wire> existing = zxd.wire_between(sa, sb);
+    if (existing)
+      zxd.remove_wire(*existing);
+    else
+      zxd.add_wire(sa, sb, ZXWireType::H);
+  };
+
+  for (const Command& com : circ) {
+    Op_ptr op = com.get_op_ptr();
+    unit_vector_t args = com.get_args();
+    std::vector<GraphLikeWire*> ws;
+    for (const UnitID& u : args) ws.push_back(&wires[index.at(Qubit(u))]);
+    switch (op->get_type()) {
+      case OpType::noop:
+      case OpType::Barrier:
+        break;
+      case OpType::H:
+        hadamard(*ws[0]);
+        break;
+      case OpType::Z:
+        rotate_z(*ws[0], 1);
+        break;
+      case OpType::S:
+        rotate_z(*ws[0], 0.5);
+        break;
+      case OpType::Sdg:
+        rotate_z(*ws[0], -0.5);
+        break;
+      case OpType::T:
+        rotate_z(*ws[0], 0.25);
+        break;
+      case OpType::Tdg:
+        rotate_z(*ws[0], -0.25);
+        break;
+      case OpType::Rz:
+      case OpType::U1:
+        rotate_z(*ws[0], op->get_params()[0]);
+        break;
+      case OpType::X:
+      case OpType::Rx: {
+        hadamard(*ws[0]);
+        rotate_z(
+            *ws[0], (op->get_type() == OpType::X) ? Expr(1)
+                                                  : op->get_params()[0]);
+        hadamard(*ws[0]);
+        break;
+      }
+      case OpType::CZ:
+        cz(*ws[0], *ws[1]);
+        break;
+      case OpType::CX: {
+        hadamard(*ws[1]);
+        cz(*ws[0], *ws[1]);
+        hadamard(*ws[1]);
+        break;
+      }
+      case OpType::SWAP:
+        std::swap(*ws[0], *ws[1]);
+        break;
+      default:
+        throw Unsupported(
+            "Cannot convert OpType: " + op->get_name() +
+            " directly to a graphlike ZX diagram; use circuit_to_zx");
+    }
+  }
+
+  for (unsigned i = 0; i < qubits.size(); ++i) {
+    GraphLikeWire& w = wires[i];
+    if (w.pending_h) {
+      open_spider(zxd, w, id);
+    } else if (w.at_input || w.touches_input) {
+      // Each boundary needs its own spider, so an identity wire becomes a
+      // pair of Hadamard edges
+      open_spider(zxd, w, id);
+      extend_wire(zxd, w, ZXWireType::H, id);
+      extend_wire(zxd, w, ZXWireType::H, id);
+      scalar *= 0.25;
+    }
+    set_wire_phase(zxd, w);
+    ZXVert out = zxd.add_vertex(ZXType::Output);
+    zxd.add_boundary(out);
+    zxd.add_wire(w.last, out);
+    if (bmap) bmap->insert({out, circ.get_out(qubits[i])});
+  }
+  zxd.multiply_scalar(scalar);
+  return zxd;
+}
+
 void clean_frontier(
     ZXDiagram& diag, ZXVertVec& frontier, Circuit& circ,
     std::map<ZXVert, unsigned>& qubit_map) {
@@ -879,46 +1043,62 @@ Circuit zx_to_circuit(const ZXDiagram& d) {
           "Error during extraction from ZX diagram: diagram does not have "
           "gflow");
 
-    unsigned min = UINT_MAX;
-    ZXVert best;
+    // Isolating a frontier vertex only changes its own row of the
+    // biadjacency, so every solution which avoids the rows isolated so far
+    // stays valid. Extract all such candidates from this one elimination,
+    // smallest correction sets first.
+    ZXVertVec order;
     for (const ZXVert& v : to_solve) {
-      auto found = candidates.find(v);
-      if (found != candidates.end() && found->second.size() < min) {
-        min = found->second.size();
-        best = v;
-      }
+      if (candidates.find(v) != candidates.end()) order.push_back(v);
     }
-    ZXVertSeqSet g_best = candidates.at(best);
+    std::stable_sort(
+        order.begin(), order.end(), [&](const ZXVert& a, const ZXVert& b) {
+          return candidates.at(a).size() < candidates.at(b).size();
+        });
+    std::set<ZXVert> isolated;
+    for (const ZXVert& best : order) {
+      const ZXVertSeqSet& g_best = candidates.at(best);
+      bool clashes = false;
+      for (const ZXVert& f : g_best.get<TagSeq>()) {
+        if (isolated.find(f) != isolated.end()) {
+          clashes = true;
+          break;
+        }
+      }
+      if (clashes) continue;
 
-    ZXVert f_to_isolate = g_best.get<TagSeq>().front();
-    unsigned f_q = qubit_map.at(f_to_isolate);
-    for (const ZXVert& f : g_best.get<TagSeq>()) {
-      if (f != f_to_isolate) {
-        circ.add_op<unsigned>(OpType::CX, {f_q, qubit_map.at(f)});
+      ZXVert f_to_isolate = g_best.get<TagSeq>().front();
+      unsigned f_q = qubit_map.at(f_to_isolate);
+      for (const ZXVert& f : g_best.get<TagSeq>()) {
+        if (f != f_to_isolate) {
+          circ.add_op<unsigned>(OpType::CX, {f_q, qubit_map.at(f)});
+        }
       }
-    }
-    ZXVert out;
-    Wire w_out;
-    for (const Wire& w : diag.adj_wires(f_to_isolate)) {
-      ZXVert n = diag.other_end(w, f_to_isolate);
-      if (diag.get_zxtype(n) == ZXType::Output) {
-        out = n;
-        w_out = w;
-        break;
+      ZXVert out;
+      Wire w_out;
+      for (const Wire& w : diag.adj_wires(f_to_isolate)) {
+        ZXVert n = diag.other_end(w, f_to_isolate);
+        if (diag.get_zxtype(n) == ZXType::Output) {
+          out = n;
+          w_out = w;
+          break;
+        }
       }
-    }
-    diag.add_wire(
-        best, out,
-        (diag.get_wire_type(w_out) == ZXWireType::Basic) ? ZXWireType::H
-                                                         : ZXWireType::Basic);
-    diag.remove_vertex(f_to_isolate);
-    qubit_map.erase(qubit_map.find(f_to_isolate));
-    qubit_map.insert({best, f_q});
-    for (ZXVertVec::iterator it = frontier.begin(); it != frontier.end();
-         ++it) {
-      if (*it == f_to_isolate) {
-        *it = best;
-        break;
+      diag.add_wire(
+          best, out,
+          (diag.get_wire_type(w_out) == ZXWireType::Basic)
+              ? ZXWireType::H
+              : ZXWireType::Basic);
+      diag.remove_vertex(f_to_isolate);
+      isolated.insert(f_to_isolate);
+      qubit_map.erase(qubit_map.find(f_to_isolate));
+      qubit_map.insert({best, f_q});
+      for (ZXVertVec::iterator it = frontier.begin(); it != frontier.end();
+           ++it) {
+        if (*it == f_to_isolate) {
+          *it = best;
+          break;
+        }
       }
     }
 
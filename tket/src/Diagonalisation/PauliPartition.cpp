@@ -14,137 +14,137 @@
 
 #include "tket/Diagonalisation/PauliPartition.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
 #include <numeric>
+#include <thread>
 #include <tkassert/Assert.hpp>
 
-#include "tket/Graphs/AdjacencyData.hpp"
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
 #include "tket/Graphs/GraphColouring.hpp"
 #include "tket/Utils/GraphHeaders.hpp"
 
 namespace tket {
 
+// Number of consecutive terms whose pair checks form one unit of work.
+constexpr std::size_t pair_check_tile_rows = 64;
+
+// Pack the strings of some tensors over a common numbering of their qubits,
+// so that each pairwise check handles 64 qubits at a time.
+template <typename Tensor>
+static std::vector<PackedPauliMap> pack_strings(
+    const std::list<Tensor>& tensors) {
+  std::map<Qubit, unsigned> qubit_index;
+  for (const Tensor& tensor : tensors) {
+    for (const std::pair<const Qubit, Pauli>& qp : tensor.string) {
+      qubit_index.insert({qp.first, (unsigned)qubit_index.size()});
+    }
+  }
+  std::vector<PackedPauliMap> packed;
+  packed.reserve(tensors.size());
+  for (const Tensor& tensor : tensors) {
+    PackedPauliMap new_packed(qubit_index.size());
+    for (const std::pair<const Qubit, Pauli>& qp : tensor.string) {
+      new_packed.set(qubit_index.at(qp.first), qp.second);
+    }
+    packed.push_back(std::move(new_packed));
+  }
+  return packed;
+}
+
 PauliPartitionerGraph::PauliPartitionerGraph(
     const std::list<SpPauliString>& strings, PauliPartitionStrat strat) {
+  if (strat != PauliPartitionStrat::NonConflictingSets &&
+      strat != PauliPartitionStrat::CommutingSets) {
+    throw UnknownPauliPartitionStrat();
+  }
   pac_graph = {};
+  const std::vector<PackedPauliMap> packed = pack_strings(strings);
   for (const SpPauliString& tensor : strings) {
-    PauliACVertex new_vert = boost::add_vertex(tensor, pac_graph);
-    BGL_FORALL_VERTICES(v, pac_graph, PauliACGraph) {
-      if (v != new_vert) {
-        switch (strat) {
-          case (PauliPartitionStrat::NonConflictingSets): {
-            bool conflict = !tensor.conflicting_qubits(pac_graph[v]).empty();
-            if (conflict) boost::add_edge(new_vert, v, pac_graph);
-            break;
-          }
-          case (PauliPartitionStrat::CommutingSets): {
-            if (!tensor.commutes_with(pac_graph[v])) {
-              boost::add_edge(new_vert, v, pac_graph);
-            }
-            break;
-          }
-          default: {
-            throw UnknownPauliPartitionStrat();
+    boost::add_vertex(tensor, pac_graph);
+  }
+
+  // Check all pairs (i, j) with i < j, split into tiles of consecutive rows
+  // j which are shared between threads. Each tile collects its own edges, so
+  // the edges come out in the same order whatever the number of threads.
+  const std::size_t n = packed.size();
+  const std::size_t n_tiles =
+      (n + pair_check_tile_rows - 1) / pair_check_tile_rows;
+  std::vector<std::vector<std::pair<std::size_t, std::size_t>>> tile_edges(
+      n_tiles);
+  const auto adjacent = [&](std::size_t j, std::size_t i) {
+    if (strat == PauliPartitionStrat::CommutingSets) {
+      return !commuting_containers<PackedPauliMap>(packed[j], packed[i]);
+    }
+    return have_conflicting_indices(packed[j], packed[i]);
+  };
+  std::atomic<std::size_t> next_tile = 0;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const auto work = [&]() {
+    try {
+      for (std::size_t tile = next_tile++; tile < n_tiles; tile = next_tile++) {
+        const std::size_t end = std::min(n, (tile + 1) * pair_check_tile_rows);
+        for (std::size_t j = tile * pair_check_tile_rows; j < end; ++j) {
+          for (std::size_t i = 0; i < j; ++i) {
+            if (adjacent(j, i)) tile_edges[tile].emplace_back(j, i);
           }
         }
       }
+    } catch (...) {
+      // GCOVR_EXCL_START
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_tile = n_tiles;
+      // GCOVR_EXCL_STOP
     }
+  };
+  const std::size_t number_of_threads = std::min<std::size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), n_tiles);
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
   }
-}
-
-// Consider templatising this and putting it into the graph routines.
-// The purpose is to take a boost graph and convert it
-// into our format, ready for graph colouring.
-// Surely an insignificant overhead unless the graph is tiny.
-// MAYBE consider changing our graph colouring routines,
-// by templatising/converting to boost-style.
-class AbstractGraphData {
- public:
-  // All the conversion work is done inside the constructor.
-  explicit AbstractGraphData(const PauliACGraph& pac_graph);
-
-  // Return the ID of the string (and also assign a new ID if the string
-  // was not seen before); the eventual IDs will form an interval {0,1,2,...,n}.
-  std::size_t get_vertex_id(const SpPauliString& pauli_string);
-
-  typedef
-      // KEY: the Pauli string present in a vertex
-      // VALUE: an integer label for that vertex.
-      //      The labels will be a contiguous interval {0,1,2,...,m}.
-      std::map<SpPauliString, std::size_t>
-          VertexMap;
-
-  const graphs::AdjacencyData& get_adjacency_data() const;
-
-  const VertexMap& get_vertex_map() const;
-
- private:
-  graphs::AdjacencyData m_adjacency_data;
-  VertexMap m_vertex_map;
-};
-
-std::size_t AbstractGraphData::get_vertex_id(
-    const SpPauliString& pauli_string) {
-  const auto citer = m_vertex_map.find(pauli_string);
-  if (citer != m_vertex_map.cend()) {
-    return citer->second;
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);  // GCOVR_EXCL_LINE
   }
-  // Haven't seen this vertex before!
-  const auto new_id = m_vertex_map.size();
-  m_vertex_map[pauli_string] = new_id;
-  return new_id;
-}
-
-const AbstractGraphData::VertexMap& AbstractGraphData::get_vertex_map() const {
-  return m_vertex_map;
-}
-
-const graphs::AdjacencyData& AbstractGraphData::get_adjacency_data() const {
-  return m_adjacency_data;
-}
 
-AbstractGraphData::AbstractGraphData(const PauliACGraph& pac_graph)
-    : m_adjacency_data(boost::num_vertices(pac_graph)) {
-  const auto vertex_iterators = boost::vertices(pac_graph);
-  for (auto v_iter = vertex_iterators.first; v_iter != vertex_iterators.second;
-       ++v_iter) {
-    // NOTE: on Windows, *v_iter appears to be of type uint64,
-    // but presumably this is an internal Boost implementation detail
-    // and we cannot rely on this.
-    // (It might even be that the Boost vertex IDs are contiguous,
-    // just like ours, in which case this conversion
-    // is unnecessary - but again, we cannot rely on this).
-    const auto this_vertex_id = get_vertex_id(pac_graph[*v_iter]);
-    const auto neighbour_iterators =
-        boost::adjacent_vertices(*v_iter, pac_graph);
-
-    for (auto n_iter = neighbour_iterators.first;
-         n_iter != neighbour_iterators.second; ++n_iter) {
-      m_adjacency_data.add_edge(
-          this_vertex_id, get_vertex_id(pac_graph[*n_iter]));
+  std::vector<std::pair<std::size_t, std::size_t>> edges;
+  for (std::vector<std::pair<std::size_t, std::size_t>>& tile : tile_edges) {
+    for (const std::pair<std::size_t, std::size_t>& e : tile) {
+      boost::add_edge(e.first, e.second, pac_graph);
     }
+    edges.insert(edges.end(), tile.begin(), tile.end());
+    tile = {};
   }
+  adjacency = graphs::CompressedAdjacencyData(n, edges);
 }
 
 static std::map<unsigned, std::list<SpPauliString>>
-get_partitioned_paulis_for_exhaustive_method(const PauliACGraph& pac_graph) {
-  const AbstractGraphData data(pac_graph);
+get_partitioned_paulis_for_exhaustive_method(
+    const PauliACGraph& pac_graph,
+    const graphs::CompressedAdjacencyData& adjacency) {
   const graphs::GraphColouringResult colouring =
-      graphs::GraphColouringRoutines ::get_colouring(data.get_adjacency_data());
+      graphs::GraphColouringRoutines ::get_colouring(adjacency);
 
-  TKET_ASSERT(data.get_vertex_map().size() == colouring.colours.size());
+  TKET_ASSERT(boost::num_vertices(pac_graph) == colouring.colours.size());
 
   std::map<unsigned, std::list<SpPauliString>> colour_map;
 
-  for (const auto& entry : data.get_vertex_map()) {
-    const SpPauliString& vertex = entry.first;
-    const std::size_t id = entry.second;
-    TKET_ASSERT(id < colouring.colours.size());
-
-    // "id" is the index of this vertex.
-    const std::size_t colour = colouring.colours[id];
+  BGL_FORALL_VERTICES(v, pac_graph, PauliACGraph) {
+    // Vertices of pac_graph and adjacency are numbered alike.
+    const std::size_t colour = colouring.colours[v];
     TKET_ASSERT(colour < colouring.number_of_colours);
 
-    colour_map[colour].push_back(vertex);
+    colour_map[colour].push_back(pac_graph[v]);
   }
   if (!colour_map.empty()) {
     TKET_ASSERT(colour_map.size() == 1 + colour_map.crbegin()->first);
@@ -190,7 +190,8 @@ PauliPartitionerGraph::partition_paulis(GraphColourMethod method) const {
       return get_partitioned_paulis_for_largest_first_method(pac_graph);
 
     case GraphColourMethod::Exhaustive:
-      return get_partitioned_paulis_for_exhaustive_method(pac_graph);
+      return get_partitioned_paulis_for_exhaustive_method(
+          pac_graph, adjacency);
 
     case GraphColourMethod::Lazy:
       throw std::logic_error(
@@ -263,6 +264,67 @@ get_term_sequence_with_constructed_dependency_graph(
   return terms;
 }
 
+std::list<std::list<SpCxPauliTensor>> term_sequence_sorted_insertion(
+    const std::list<SpCxPauliTensor>& terms, PauliPartitionStrat strat) {
+  if (strat != PauliPartitionStrat::NonConflictingSets &&
+      strat != PauliPartitionStrat::CommutingSets) {
+    throw UnknownPauliPartitionStrat();
+  }
+  const std::vector<SpCxPauliTensor> term_vec(terms.begin(), terms.end());
+  const std::vector<PackedPauliMap> packed = pack_strings(terms);
+  std::vector<std::size_t> order(term_vec.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(
+      order.begin(), order.end(), [&](std::size_t i, std::size_t j) {
+        return std::abs(term_vec[i].coeff) > std::abs(term_vec[j].coeff);
+      });
+
+  struct Group {
+    std::vector<std::size_t> members;
+    // For non-conflicting sets, the Paulis of all members together; the
+    // members agree wherever they overlap, so this is a valid string.
+    PackedPauliMap combined;
+  };
+  std::vector<Group> groups;
+  for (std::size_t t : order) {
+    const PackedPauliMap& p = packed[t];
+    bool placed = false;
+    for (Group& group : groups) {
+      if (strat == PauliPartitionStrat::NonConflictingSets) {
+        if (have_conflicting_indices(p, group.combined)) continue;
+        std::vector<PackedPauliMap::Word> xs = group.combined.xs();
+        std::vector<PackedPauliMap::Word> zs = group.combined.zs();
+        for (unsigned k = 0; k < xs.size(); ++k) {
+          xs[k] |= p.xs()[k];
+          zs[k] |= p.zs()[k];
+        }
+        group.combined =
+            PackedPauliMap(p.size(), std::move(xs), std::move(zs));
+      } else {
+        bool commutes = true;
+        for (std::size_t m : group.members) {
+          if (!commuting_containers<PackedPauliMap>(p, packed[m])) {
+            commutes = false;
+            break;
+          }
+        }
+        if (!commutes) continue;
+      }
+      group.members.push_back(t);
+      placed = true;
+      break;
+    }
+    if (!placed) groups.push_back({{t}, p});
+  }
+
+  std::list<std::list<SpCxPauliTensor>> result;
+  for (const Group& group : groups) {
+    std::list<SpCxPauliTensor>& set = result.emplace_back();
+    for (std::size_t m : group.members) set.push_back(term_vec[m]);
+  }
+  return result;
+}
+
 std::list<std::list<SpPauliString>> term_sequence(
     const std::list<SpPauliString>& strings, PauliPartitionStrat strat,
     GraphColourMethod method) {
@@ -280,4 +342,82 @@ std::list<std::list<SpPauliString>> term_sequence(
   }
 }
 
+std::size_t PauliPartitionStream::PackedHash::operator()(
+    const PackedPauliMap& paulis) const {
+  std::size_t seed = 0;
+  hash_combine_paulis<PackedPauliMap>(seed, paulis);
+  return seed;
+}
+
+bool PauliPartitionStream::PackedEqual::operator()(
+    const PackedPauliMap& first, const PackedPauliMap& second) const {
+  return compare_containers<PackedPauliMap>(first, second) == 0;
+}
+
+PauliPartitionStream::PauliPartitionStream(PauliPartitionStrat strat)
+    : strat_(strat) {
+  if (strat != PauliPartitionStrat::NonConflictingSets &&
+      strat != PauliPartitionStrat::CommutingSets) {
+    throw UnknownPauliPartitionStrat();
+  }
+}
+
+std::size_t PauliPartitionStream::add_strings(
+    const std::list<SpPauliString>& strings) {
+  std::size_t n_new = 0;
+  for (const SpPauliString& string : strings) {
+    PackedPauliMap packed;
+    for (const std::pair<const Qubit, Pauli>& qp : string.string) {
+      auto [it, added] =
+          qubit_index_.insert({qp.first, (unsigned)qubits_.size()});
+      if (added) qubits_.push_back(qp.first);
+      packed.set(it->second, qp.second);
+    }
+    auto [it, added] = strings_.insert(std::move(packed));
+    if (!added) continue;
+    ++n_new;
+    const PackedPauliMap& p = *it;
+    bool placed = false;
+    for (Set& set : sets_) {
+      if (strat_ == PauliPartitionStrat::NonConflictingSets) {
+        if (have_conflicting_indices(p, set.combined)) continue;
+        for (unsigned qb = 0; qb < p.size(); ++qb) {
+          const Pauli pauli = p.get(qb);
+          if (pauli != Pauli::I) set.combined.set(qb, pauli);
+        }
+      } else {
+        bool commutes = true;
+        for (const PackedPauliMap* m : set.members) {
+          if (!commuting_containers<PackedPauliMap>(p, *m)) {
+            commutes = false;
+            break;
+          }
+        }
+        if (!commutes) continue;
+      }
+      set.members.push_back(&p);
+      placed = true;
+      break;
+    }
+    if (!placed) sets_.push_back({{&p}, p});
+  }
+  return n_new;
+}
+
+std::list<std::list<SpPauliString>> PauliPartitionStream::get_sets() const {
+  std::list<std::list<SpPauliString>> result;
+  for (const Set& set : sets_) {
+    std::list<SpPauliString>& terms = result.emplace_back();
+    for (const PackedPauliMap* m : set.members) {
+      QubitPauliMap qpm;
+      for (unsigned qb = 0; qb < m->size(); ++qb) {
+        const Pauli pauli = m->get(qb);
+        if (pauli != Pauli::I) qpm.insert({qubits_[qb], pauli});
+      }
+      terms.push_back(SpPauliString(qpm));
+    }
+  }
+  return result;
+}
+
 }  // namespace tket
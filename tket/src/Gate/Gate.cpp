@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <symengine/number.h>
 #include <tkrng/RNG.hpp>
 #include <vector>
 
@@ -28,6 +29,7 @@
 #include "tket/OpType/OpTypeInfo.hpp"
 #include "tket/Ops/Op.hpp"
 #include "tket/Utils/Expression.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 #include "tket/Utils/PauliTensor.hpp"
 
 namespace tket {
@@ -344,10 +346,15 @@ Op_ptr Gate::symbol_substitution(
   throw SubstitutionFailure(msg.str());
 }
 
-std::optional<double> Gate::is_identity() const {
+// Overload letting the checks below run directly on numeric parameters
+static std::optional<double> eval_expr(double x) { return x; }
+
+// Phase of a gate if it is the identity up to phase; T is Expr or double
+template <typename T>
+static std::optional<double> identity_phase(
+    OpType type, const T* params, std::size_t n_params) {
   static const std::optional<double> notid;
-  const std::vector<Expr>& params = get_params();
-  switch (get_type()) {
+  switch (type) {
     case OpType::noop: {
       return 0.;
     }
@@ -368,7 +375,7 @@ std::optional<double> Gate::is_identity() const {
     case OpType::ZZPhase:
     case OpType::XXPhase3:
     case OpType::ESWAP: {
-      Expr e = params[0];
+      const T& e = params[0];
       if (equiv_0(e, 4)) {
         return 0.;
       } else if (equiv_0(e + 2, 4)) {
@@ -381,7 +388,7 @@ std::optional<double> Gate::is_identity() const {
       return equiv_0(params[0]) ? 0. : notid;
     }
     case OpType::U3: {
-      Expr theta = params[0];
+      const T& theta = params[0];
       if (equiv_0(params[1] + params[2])) {
         if (equiv_0(theta, 4)) {
           return 0.;
@@ -399,7 +406,7 @@ std::optional<double> Gate::is_identity() const {
         return notid;
     }
     case OpType::TK1: {
-      Expr s = params[0] + params[2], t = params[1];
+      const T s = params[0] + params[2], t = params[1];
       if (equiv_0(s) && equiv_0(t)) {
         return (equiv_0(s, 4) ^ equiv_0(t, 4)) ? 1. : 0.;
       } else
@@ -407,7 +414,8 @@ std::optional<double> Gate::is_identity() const {
     }
     case OpType::TK2: {
       bool pi_phase = false;
-      for (const Expr& a : params) {
+      for (std::size_t i = 0; i < n_params; ++i) {
+        const T& a = params[i];
         if (equiv_0(a + 2, 4)) {
           pi_phase = !pi_phase;
         } else if (!equiv_0(a, 4)) {
@@ -435,10 +443,16 @@ std::optional<double> Gate::is_identity() const {
   }
 }
 
-bool Gate::is_clifford() const {
-  if (is_clifford_type(type_)) return true;
+std::optional<double> Gate::is_identity() const {
+  if (numeric_) return identity_phase(type_, values_.data(), params_.size());
+  return identity_phase(type_, params_.data(), params_.size());
+}
 
-  switch (type_) {
+// Whether a gate with non-Clifford type is Clifford; T is Expr or double
+template <typename T>
+static bool is_clifford_gate(
+    OpType type, const T* params, std::size_t n_params) {
+  switch (type) {
     case OpType::Rx:
     case OpType::Ry:
     case OpType::Rz:
@@ -453,20 +467,25 @@ bool Gate::is_clifford() const {
     case OpType::XXPhase3:
     case OpType::PhasedX:
     case OpType::NPhasedX:
-      return std::all_of(params_.begin(), params_.end(), [](const Expr& e) {
-        return equiv_0(4 * e);
-      });
+      return std::all_of(
+          params, params + n_params, [](const T& e) { return equiv_0(4 * e); });
     case OpType::ISWAP:
     case OpType::ESWAP:
-      return equiv_0(2 * params_.at(0));
+      return equiv_0(2 * params[0]);
     case OpType::PhasedISWAP:
     case OpType::FSim:
-      return equiv_0(4 * params_.at(0)) && equiv_0(2 * params_.at(1));
+      return equiv_0(4 * params[0]) && equiv_0(2 * params[1]);
     default:
       return false;
   }
 }
 
+bool Gate::is_clifford() const {
+  if (is_clifford_type(type_)) return true;
+  if (numeric_) return is_clifford_gate(type_, values_.data(), params_.size());
+  return is_clifford_gate(type_, params_.data(), params_.size());
+}
+
 bool Gate::has_symmetry(unsigned port1, unsigned port2) const {
   const auto n_q = n_qubits();
   if (port1 >= n_q || port2 >= n_q) {
@@ -728,7 +747,20 @@ std::vector<Expr> Gate::get_tk1_angles() const {
 
 std::vector<Expr> Gate::get_params() const { return params_; }
 
-SymSet Gate::free_symbols() const { return expr_free_symbols(get_params()); }
+std::optional<double> Gate::get_numeric_param(unsigned i) const {
+  if (i >= params_.size()) {
+    throw std::out_of_range("Gate parameter index out of range");
+  }
+  if (!numeric_) return std::nullopt;
+  return values_[i];
+}
+
+std::vector<double> Gate::get_numeric_params() const {
+  if (!numeric_) throw SymbolsNotSupported();
+  return {values_.begin(), values_.begin() + params_.size()};
+}
+
+SymSet Gate::free_symbols() const { return symbols_; }
 
 /**
  * @brief The commutation colour of TK1(a,b,c)
@@ -913,6 +945,11 @@ op_signature_t Gate::get_signature() const {
     return op_signature_t(n_qubits_, EdgeType::Quantum);
 }
 
+std::size_t Gate::memory_usage() const {
+  return sizeof(Gate) + memory::container_bytes(params_) +
+         memory::container_bytes(symbols_);
+}
+
 nlohmann::json Gate::serialize() const {
   nlohmann::json j;
   OpType optype = get_type();
@@ -965,15 +1002,32 @@ Eigen::MatrixXcd Gate::get_unitary() const {
 }
 
 Gate::Gate(OpType type, const std::vector<Expr>& params, unsigned n_qubits)
-    : Op(type), params_(params), n_qubits_(n_qubits) {
+    : Op(type),
+      params_(params),
+      n_qubits_(n_qubits),
+      values_{},
+      numeric_(params.size() <= values_.size()) {
   if (!is_gate_type(type)) {
     throw BadOpType(type);
   }
   if (params.size() != optypeinfo().at(type).n_params()) {
     throw InvalidParameterCount();
   }
+  for (std::size_t i = 0; numeric_ && i < params.size(); ++i) {
+    std::optional<double> x;
+    if (SymEngine::is_a_Number(*params[i].get_basic())) {
+      x = tket::eval_expr(params[i]);
+    }
+    if (x) {
+      values_[i] = *x;
+    } else {
+      numeric_ = false;
+    }
+  }
+  if (!numeric_) symbols_ = expr_free_symbols(params);
 }
 
-Gate::Gate() : Op(OpType::noop), params_() {}
+Gate::Gate()
+    : Op(OpType::noop), params_(), values_{}, numeric_(true), symbols_() {}
 
 }  // namespace tket
@@ -213,4 +213,18 @@ std::vector<TripletCd> GateUnitaryMatrix::get_unitary_triplets(
   return triplets;
 }
 
+std::optional<GateUnitaryStructure> GateUnitaryMatrix::get_unitary_structure(
+    const Gate& gate) {
+  const OpType op_type = gate.get_type();
+  // CCX is the only one of fixed size, so is treated as CnX.
+  const internal::GateUnitaryMatrixVariableQubits variable_qubits_data(
+      op_type == OpType::CCX ? OpType::CnX : op_type);
+  if (!variable_qubits_data.is_known_type()) return std::nullopt;
+  const auto parameters = GateUnitaryMatrixUtils::get_checked_parameters(gate);
+  GateUnitaryMatrixUtils::check_and_throw_upon_wrong_number_of_parameters(
+      op_type, gate.n_qubits(), parameters,
+      variable_qubits_data.get_number_of_parameters());
+  return variable_qubits_data.get_structure(parameters);
+}
+
 }  // namespace tket
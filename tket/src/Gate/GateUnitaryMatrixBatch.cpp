@@ -0,0 +1,221 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sstream>
+
+#include "tket/Gate/GateUnitaryMatrix.hpp"
+#include "tket/Gate/GateUnitaryMatrixError.hpp"
+#include "tket/OpType/OpDesc.hpp"
+#include "tket/Utils/Constants.hpp"
+
+// Matrices of the primitive parametrised gates for a whole batch of
+// parameter values at once. Each entry of the matrices is computed as an
+// Eigen array expression over the batch, so that the sines and cosines are
+// vectorised. The formulae are those of GateUnitaryMatrixPrimitives.cpp and
+// GateUnitaryMatrixComposites.cpp, multiplied out.
+
+namespace tket {
+
+namespace {
+
+using Array = Eigen::ArrayXd;
+using ArrayC = Eigen::ArrayXcd;
+
+// Half-angle of each value of one parameter, in radians
+Array half_angles(const Eigen::MatrixXd& parameters, unsigned i) {
+  return (0.5 * PI) * parameters.col(i).array();
+}
+
+ArrayC make_complex(const Array& re, const Array& im) {
+  ArrayC z(re.size());
+  z.real() = re;
+  z.imag() = im;
+  return z;
+}
+
+// Fill the matrix entries (row, col) of every gate
+struct Filler {
+  Eigen::MatrixXcd& out;
+  unsigned dim;
+
+  void set(unsigned row, unsigned col, const ArrayC& values) {
+    out.row(col * dim + row) = values.matrix().transpose();
+  }
+  void set(unsigned row, unsigned col, const Array& values) {
+    out.row(col * dim + row) = values.cast<Complex>().matrix().transpose();
+  }
+};
+
+void check_parameters(
+    OpType optype, const Eigen::MatrixXd& parameters, unsigned expected) {
+  if (parameters.cols() == expected) return;
+  std::stringstream ss;
+  ss << "Batch of " << OpDesc(optype).name() << " gates: expected " << expected
+     << " parameters but got " << parameters.cols();
+  throw GateUnitaryMatrixError(
+      ss.str(), GateUnitaryMatrixError::Cause::INPUT_ERROR);
+}
+
+}  // namespace
+
+Eigen::MatrixXcd GateUnitaryMatrix::get_unitaries(
+    OpType optype, const Eigen::MatrixXd& parameters) {
+  const Eigen::Index n = parameters.rows();
+  const Array zero = Array::Zero(n);
+  switch (optype) {
+    case OpType::Rx:
+    case OpType::Ry:
+    case OpType::Rz: {
+      check_parameters(optype, parameters, 1);
+      Eigen::MatrixXcd out = Eigen::MatrixXcd::Zero(4, n);
+      Filler f{out, 2};
+      const Array t = half_angles(parameters, 0);
+      const Array c = t.cos();
+      const Array s = t.sin();
+      if (optype == OpType::Rx) {
+        f.set(0, 0, c);
+        f.set(1, 1, c);
+        f.set(0, 1, make_complex(zero, -s));
+        f.set(1, 0, make_complex(zero, -s));
+      } else if (optype == OpType::Ry) {
+        f.set(0, 0, c);
+        f.set(1, 1, c);
+        f.set(0, 1, -s);
+        f.set(1, 0, s);
+      } else {
+        f.set(0, 0, make_complex(c, -s));
+        f.set(1, 1, make_complex(c, s));
+      }
+      return out;
+    }
+    case OpType::PhasedX: {
+      // Rz(b) Rx(a) Rz(-b)
+      check_parameters(optype, parameters, 2);
+      Eigen::MatrixXcd out(4, n);
+      Filler f{out, 2};
+      const Array a = half_angles(parameters, 0);
+      const Array b = PI * parameters.col(1).array();
+      const Array ca = a.cos();
+      const Array sa = a.sin();
+      const Array cb = b.cos();
+      const Array sb = b.sin();
+      f.set(0, 0, ca);
+      f.set(1, 1, ca);
+      // -i sin(a) exp(-+ i b)
+      f.set(0, 1, make_complex(-sa * sb, -sa * cb));
+      f.set(1, 0, make_complex(sa * sb, -sa * cb));
+      return out;
+    }
+    case OpType::TK1: {
+      // Rz(a) Rx(b) Rz(c)
+      check_parameters(optype, parameters, 3);
+      Eigen::MatrixXcd out(4, n);
+      Filler f{out, 2};
+      const Array a = half_angles(parameters, 0);
+      const Array b = half_angles(parameters, 1);
+      const Array c = half_angles(parameters, 2);
+      const Array cb = b.cos();
+      const Array sb = b.sin();
+      const Array sum = a + c;
+      const Array diff = a - c;
+      const Array cs = sum.cos();
+      const Array ss = sum.sin();
+      const Array cd = diff.cos();
+      const Array sd = diff.sin();
+      // cos(b) exp(-+ i (a + c))
+      f.set(0, 0, make_complex(cb * cs, -cb * ss));
+      f.set(1, 1, make_complex(cb * cs, cb * ss));
+      // -i sin(b) exp(-+ i (a - c))
+      f.set(0, 1, make_complex(-sb * sd, -sb * cd));
+      f.set(1, 0, make_complex(sb * sd, -sb * cd));
+      return out;
+    }
+    case OpType::XXPhase:
+    case OpType::YYPhase: {
+      check_parameters(optype, parameters, 1);
+      Eigen::MatrixXcd out = Eigen::MatrixXcd::Zero(16, n);
+      Filler f{out, 4};
+      const Array t = half_angles(parameters, 0);
+      const Array c = t.cos();
+      const Array s = t.sin();
+      for (unsigned i = 0; i < 4; ++i) f.set(i, i, c);
+      const ArrayC minus_is = make_complex(zero, -s);
+      f.set(1, 2, minus_is);
+      f.set(2, 1, minus_is);
+      const ArrayC corner =
+          optype == OpType::XXPhase ? minus_is : make_complex(zero, s);
+      f.set(0, 3, corner);
+      f.set(3, 0, corner);
+      return out;
+    }
+    case OpType::ZZPhase: {
+      check_parameters(optype, parameters, 1);
+      Eigen::MatrixXcd out = Eigen::MatrixXcd::Zero(16, n);
+      Filler f{out, 4};
+      const Array t = half_angles(parameters, 0);
+      const Array c = t.cos();
+      const Array s = t.sin();
+      f.set(0, 0, make_complex(c, -s));
+      f.set(3, 3, make_complex(c, -s));
+      f.set(1, 1, make_complex(c, s));
+      f.set(2, 2, make_complex(c, s));
+      return out;
+    }
+    case OpType::TK2: {
+      // XXPhase(a) YYPhase(b) ZZPhase(c), which acts on the span of |00>
+      // and |11> as exp(-i c) Rx(a - b) and on the span of |01> and |10> as
+      // exp(i c) Rx(a + b).
+      check_parameters(optype, parameters, 3);
+      Eigen::MatrixXcd out = Eigen::MatrixXcd::Zero(16, n);
+      Filler f{out, 4};
+      const Array a = half_angles(parameters, 0);
+      const Array b = half_angles(parameters, 1);
+      const Array c = half_angles(parameters, 2);
+      const Array diff = a - b;
+      const Array sum = a + b;
+      const Array cd = diff.cos();
+      const Array sd = diff.sin();
+      const Array cs = sum.cos();
+      const Array ss = sum.sin();
+      const Array cc = c.cos();
+      const Array sc = c.sin();
+      // cos(a - b) exp(-i c)
+      const ArrayC outer_diag = make_complex(cd * cc, -cd * sc);
+      // -i sin(a - b) exp(-i c)
+      const ArrayC outer_off = make_complex(-sd * sc, -sd * cc);
+      // cos(a + b) exp(i c)
+      const ArrayC inner_diag = make_complex(cs * cc, cs * sc);
+      // -i sin(a + b) exp(i c)
+      const ArrayC inner_off = make_complex(ss * sc, -ss * cc);
+      f.set(0, 0, outer_diag);
+      f.set(3, 3, outer_diag);
+      f.set(0, 3, outer_off);
+      f.set(3, 0, outer_off);
+      f.set(1, 1, inner_diag);
+      f.set(2, 2, inner_diag);
+      f.set(1, 2, inner_off);
+      f.set(2, 1, inner_off);
+      return out;
+    }
+    default: {
+      std::stringstream ss;
+      ss << "Batch unitaries are not implemented for "
+         << OpDesc(optype).name() << " gates";
+      throw GateUnitaryMatrixError(
+          ss.str(), GateUnitaryMatrixError::Cause::GATE_NOT_IMPLEMENTED);
+    }
+  }
+}
+
+}  // namespace tket
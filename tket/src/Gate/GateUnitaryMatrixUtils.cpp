@@ -119,8 +119,22 @@ void GateUnitaryMatrixUtils::check_and_throw_upon_wrong_number_of_parameters(
 
 std::vector<double> GateUnitaryMatrixUtils::get_checked_parameters(
     const Gate& gate) {
-  const std::vector<Expr> parameter_expressions = gate.get_params();
   const unsigned int number_of_qubits = gate.n_qubits();
+  if (gate.has_numeric_params()) {
+    std::vector<double> parameters = gate.get_numeric_params();
+    for (unsigned nn = 0; nn < parameters.size(); ++nn) {
+      if (!std::isfinite(parameters[nn])) {
+        std::stringstream ss;
+        ss << get_error_prefix(gate.get_name(), number_of_qubits, parameters)
+           << "parameter[" << nn << "] has non-finite value "
+           << parameters[nn];
+        throw GateUnitaryMatrixError(
+            ss.str(), GateUnitaryMatrixError::Cause::NON_FINITE_PARAMETER);
+      }
+    }
+    return parameters;
+  }
+  const std::vector<Expr> parameter_expressions = gate.get_params();
   std::vector<double> parameters(parameter_expressions.size());
   for (unsigned nn = 0; nn < parameters.size(); ++nn) {
     const auto optional_value = eval_expr(parameter_expressions[nn]);
@@ -14,6 +14,7 @@
 
 #include "GateUnitaryMatrixVariableQubits.hpp"
 
+#include <complex>
 #include <tkassert/Assert.hpp>
 
 #include "tket/Gate/GateUnitaryMatrixImplementations.hpp"
@@ -85,5 +86,39 @@ Eigen::MatrixXcd GateUnitaryMatrixVariableQubits::get_dense_unitary(
   }
 }
 
+GateUnitaryStructure GateUnitaryMatrixVariableQubits::get_structure(
+    const std::vector<double>& parameters) const {
+  TKET_ASSERT(known_type);
+  TKET_ASSERT(parameters.size() == number_of_parameters);
+  typedef GateUnitaryStructure::Kind Kind;
+  switch (op_type) {
+    case OpType::CnX:
+      return {Kind::Controlled, GateUnitaryMatrixImplementations::X()};
+    case OpType::CnY:
+      return {Kind::Controlled, GateUnitaryMatrixImplementations::Y()};
+    case OpType::CnZ:
+      return {Kind::Controlled, GateUnitaryMatrixImplementations::Z()};
+    case OpType::CnRy:
+      return {
+          Kind::Controlled,
+          GateUnitaryMatrixImplementations::Ry(parameters[0])};
+    case OpType::PhaseGadget: {
+      // As in PhaseGadget_diagonal_entries.
+      const std::complex<double> odd =
+          std::polar(1.0, 0.5 * PI * parameters[0]);
+      Eigen::Matrix2cd u = Eigen::Matrix2cd::Zero();
+      u(0, 0) = std::conj(odd);
+      u(1, 1) = odd;
+      return {Kind::ParityPhase, u};
+    }
+    case OpType::NPhasedX:
+      return {
+          Kind::Product, GateUnitaryMatrixImplementations::PhasedX(
+                             parameters[0], parameters[1])};
+    default:
+      TKET_ASSERT(false);
+  }
+}
+
 }  // namespace internal
 }  // namespace tket
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include "tket/Gate/GateUnitaryMatrix.hpp"
 #include "tket/OpType/OpType.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
 
@@ -39,6 +40,12 @@ class GateUnitaryMatrixVariableQubits {
   Eigen::MatrixXcd get_dense_unitary(
       unsigned number_of_qubits, const std::vector<double>& parameters) const;
 
+  /** As get_dense_unitary, but in structured form, which does not depend
+   *  on the number of qubits.
+   */
+  GateUnitaryStructure get_structure(
+      const std::vector<double>& parameters) const;
+
  private:
   const OpType op_type;
   bool known_type;
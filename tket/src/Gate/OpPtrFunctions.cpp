@@ -14,6 +14,14 @@
 
 #include "tket/Gate/OpPtrFunctions.hpp"
 
+#include <boost/functional/hash.hpp>
+#include <boost/pool/pool_alloc.hpp>
+#include <map>
+#include <mutex>
+#include <symengine/number.h>
+#include <utility>
+#include <vector>
+
 #include "tket/Gate/Gate.hpp"
 #include "tket/Gate/SymTable.hpp"
 #include "tket/Ops/BarrierOp.hpp"
@@ -21,6 +29,75 @@
 
 namespace tket {
 
+// Number of entries kept for gates with numeric parameters
+static constexpr std::size_t numeric_slots = 4096;
+
+// Gates are immutable, so equal gates can share one instance. Parameterless
+// gates are kept for the lifetime of the process, one for each type and
+// qubit count. Gates whose parameters are all numbers are kept in a
+// direct-mapped table indexed by a hash of the type and exact parameters, so
+// that a gate landing in an occupied slot replaces the one already there.
+class GateTable {
+ public:
+  Op_ptr get(OpType type, const std::vector<Expr>& params, unsigned n_qubits) {
+    if (params.empty()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Op_ptr& op = parameterless_[{type, n_qubits}];
+      if (!op) op = make_gate(type, params, n_qubits);
+      return op;
+    }
+    std::size_t seed = 0;
+    boost::hash_combine(seed, static_cast<unsigned>(type));
+    boost::hash_combine(seed, n_qubits);
+    for (const Expr& e : params) {
+      if (!SymEngine::is_a_Number(*e.get_basic())) {
+        return make_gate(type, params, n_qubits);
+      }
+      boost::hash_combine(seed, e.get_basic()->hash());
+    }
+    NumericEntry& entry = numeric_[seed % numeric_slots];
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (entry.op && entry.type == type && entry.n_qubits == n_qubits &&
+          entry.params == params) {
+        return entry.op;
+      }
+    }
+    Op_ptr op = make_gate(type, params, n_qubits);
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry = {type, n_qubits, params, op};
+    return op;
+  }
+
+ private:
+  struct NumericEntry {
+    OpType type;
+    unsigned n_qubits;
+    std::vector<Expr> params;
+    Op_ptr op;
+  };
+
+  static Op_ptr make_gate(
+      OpType type, const std::vector<Expr>& params, unsigned n_qubits) {
+    // Gates are created in large numbers, so take the object and its control
+    // block from a pool, like the DAG nodes that hold them.
+    return std::allocate_shared<Gate>(
+        boost::fast_pool_allocator<Gate>(), type, params, n_qubits);
+  }
+
+  std::mutex mutex_;
+  std::map<std::pair<OpType, unsigned>, Op_ptr> parameterless_;
+  std::vector<NumericEntry> numeric_ =
+      std::vector<NumericEntry>(numeric_slots);
+};
+
+static GateTable& gate_table() {
+  // Never destroyed, as the gates are allocated from a pool that may be
+  // destroyed first at exit
+  static GateTable* table = new GateTable();
+  return *table;
+}
+
 Op_ptr get_op_ptr(OpType chosen_type, const Expr& param, unsigned n_qubits) {
   return get_op_ptr(chosen_type, std::vector<Expr>{param}, n_qubits);
 }
@@ -29,7 +106,7 @@ Op_ptr get_op_ptr(
     OpType chosen_type, const std::vector<Expr>& params, unsigned n_qubits) {
   if (is_gate_type(chosen_type)) {
     SymTable::register_symbols(expr_free_symbols(params));
-    return std::make_shared<const Gate>(chosen_type, params, n_qubits);
+    return gate_table().get(chosen_type, params, n_qubits);
   } else if (is_barrier_type(chosen_type)) {
     return std::make_shared<const BarrierOp>();
   } else {
@@ -22,14 +22,16 @@
 
 namespace tket {
 
+static double atan2_bypi(double a, double b) {
+  if (std::abs(a) < EPS && std::abs(b) < EPS) return 0.;
+  return atan2(a, b) / PI;
+}
+
 static Expr atan2_bypi(const Expr &a, const Expr &b) {
   std::optional<double> va = eval_expr(a);
   std::optional<double> vb = eval_expr(b);
   if (va && vb) {
-    double vva = va.value();
-    double vvb = vb.value();
-    if (std::abs(vva) < EPS && std::abs(vvb) < EPS) return Expr(0.);
-    return atan2(vva, vvb) / PI;
+    return atan2_bypi(va.value(), vb.value());
   } else {
     // Convert symbolic zero to 0. This is a workaround for
     // https://github.com/symengine/symengine/issues/1875 .
@@ -40,14 +42,17 @@ static Expr atan2_bypi(const Expr &a, const Expr &b) {
   }
 }
 
+static double acos_bypi(double a) {
+  // avoid undefined values due to rounding
+  if (a >= 1.) return 0.;
+  if (a <= -1.) return 1.;
+  return acos(a) / PI;
+}
+
 static Expr acos_bypi(const Expr &a) {
   std::optional<double> va = eval_expr(a);
   if (va) {
-    double vva = va.value();
-    // avoid undefined values due to rounding
-    if (vva >= 1.) return 0.;
-    if (vva <= -1.) return 1.;
-    return acos(vva) / PI;
+    return acos_bypi(va.value());
   } else {
     return SymEngine::div(SymEngine::acos(a), SymEngine::pi);
   }
@@ -57,8 +62,8 @@ static Expr acos_bypi(const Expr &a) {
 // of the denominator, for example in expressions like (-a + b) / (a - b) where
 // a and b are symbolic. This function picks out the common cases.
 static Expr expr_div(const Expr &num, const Expr &den) {
-  if (approx_0(SymEngine::expand(num - den))) return 1;
-  if (approx_0(SymEngine::expand(num + den))) return -1;
+  if (approx_0(expand_expr(num - den))) return 1;
+  if (approx_0(expand_expr(num + den))) return -1;
   return SymEngine::div(num, den);
 }
 
@@ -124,7 +129,7 @@ static std::tuple<Expr, Expr, Expr> xyx_angles_from_coeffs(
   // 2 * atan2(B, A).
   // Finally, note that u must be well-defined because we have already dealt
   // with all cases where s = 0.
-  if (approx_0(SymEngine::expand(i * j + s * k))) {
+  if (approx_0(expand_expr(i * j + s * k))) {
     Expr u = expr_div(i, s);
     if (SymEngine::free_symbols(u).empty()) {
       Expr a = SymEngine::atan(u);
@@ -132,7 +137,7 @@ static std::tuple<Expr, Expr, Expr> xyx_angles_from_coeffs(
       Expr two_a_by_pi = SymEngine::div(2 * a, SymEngine::pi);
       return std::tuple<Expr, Expr, Expr>(two_a_by_pi, q, 0);
     }
-  } else if (approx_0(SymEngine::expand(i * j - s * k))) {
+  } else if (approx_0(expand_expr(i * j - s * k))) {
     Expr u = expr_div(i, s);
     if (SymEngine::free_symbols(u).empty()) {
       Expr a = SymEngine::atan(u);
@@ -145,12 +150,121 @@ static std::tuple<Expr, Expr, Expr> xyx_angles_from_coeffs(
   // Now the general case.
   Expr a = atan2_bypi(i, s);
   Expr b = atan2_bypi(k, j);
-  Expr q = acos_bypi(SymEngine::expand(s * s + i * i - j * j - k * k));
+  Expr q = acos_bypi(expand_expr(s * s + i * i - j * j - k * k));
   return std::tuple<Expr, Expr, Expr>(a - b, q, a + b);
 }
 
+// As above, for numeric coefficients.
+static std::tuple<double, double, double> xyx_angles_from_coeffs(
+    double s, double i, double j, double k) {
+  bool s_zero = std::abs(s) < EPS;
+  bool s_one = std::abs(s - 1) < EPS;
+  bool i_zero = std::abs(i) < EPS;
+  bool i_one = std::abs(i - 1) < EPS;
+  bool j_zero = std::abs(j) < EPS;
+  bool j_one = std::abs(j - 1) < EPS;
+  bool k_zero = std::abs(k) < EPS;
+  bool k_one = std::abs(k - 1) < EPS;
+  if (i_zero && j_zero && k_zero) {
+    if (s_one)
+      return {0, 0, 0};
+    else
+      return {2, 0, 0};
+  }
+  if (s_zero && j_zero && k_zero) {
+    if (i_one)
+      return {1, 0, 0};
+    else
+      return {3, 0, 0};
+  }
+  if (s_zero && i_zero && k_zero) {
+    if (j_one)
+      return {0, 1, 0};
+    else
+      return {0, 3, 0};
+  }
+  if (s_zero && i_zero && j_zero) {
+    if (k_one)
+      return {3, 1, 0};
+    else
+      return {1, 1, 0};
+  }
+  if (s_zero && i_zero) return {-2 * atan2_bypi(k, j), 1, 0};
+  if (s_zero && j_zero) return {0, 2 * atan2_bypi(k, i), 1};
+  if (s_zero && k_zero) return {0.5, 2 * atan2_bypi(j, i), 0.5};
+  if (i_zero && j_zero) return {-0.5, 2 * atan2_bypi(k, s), 0.5};
+  if (i_zero && k_zero) return {0, 2 * atan2_bypi(j, s), 0};
+  if (j_zero && k_zero) return {2 * atan2_bypi(i, s), 0, 0};
+
+  // Factorizable cases, matching the symbolic version exactly.
+  bool xy = std::abs(i * j + s * k) < EPS;
+  if (xy || std::abs(i * j - s * k) < EPS) {
+    double u = (std::abs(i - s) < EPS)   ? 1.
+               : (std::abs(i + s) < EPS) ? -1.
+                                         : i / s;
+    double two_a_by_pi = 2 * atan(u) / PI;
+    double q = 2 * atan2_bypi(j, s);
+    if (xy) return {two_a_by_pi, q, 0};
+    return {0, q, two_a_by_pi};
+  }
+
+  // Now the general case.
+  double a = atan2_bypi(i, s);
+  double b = atan2_bypi(k, j);
+  double q = acos_bypi(s * s + i * i - j * j - k * k);
+  return {a - b, q, a + b};
+}
+
+// Convert to an expression, keeping zeros exact.
+static Expr to_expr(double x) { return (x == 0.) ? Expr(0) : Expr(x); }
+
+// Numeric equivalents of cos_halfpi_times and sin_halfpi_times
+static double cos_halfpi(double a) { return std::cos(PI * fmodn(a, 4) / 2); }
+static double sin_halfpi(double a) { return std::sin(PI * fmodn(a, 4) / 2); }
+
 Rotation::Rotation(OpType optype, Expr a)
-    : i_(0), j_(0), k_(0), optype_(optype), a_(a) {
+    : i_(0),
+      j_(0),
+      k_(0),
+      optype_(optype),
+      a_(a),
+      numeric_(false),
+      ns_(1.),
+      ni_(0.),
+      nj_(0.),
+      nk_(0.),
+      na_(0.) {
+  std::optional<double> va = eval_expr(a);
+  if (va) {
+    numeric_ = true;
+    na_ = va.value();
+    if (approx_eq(na_, 0., 4)) {
+      rep_ = Rep::id;
+    } else if (approx_eq(na_, 2., 4)) {
+      rep_ = Rep::minus_id;
+      ns_ = -1.;
+    } else {
+      rep_ = Rep::orth_rot;
+      ns_ = cos_halfpi(na_);
+      double t = sin_halfpi(na_);
+      switch (optype) {
+        case OpType::Rx:
+          ni_ = t;
+          break;
+        case OpType::Ry:
+          nj_ = t;
+          break;
+        case OpType::Rz:
+          nk_ = t;
+          break;
+        default:
+          throw std::logic_error(
+              "Quaternions can only be constructed "
+              "from Rx, Ry or Rz rotations");
+      }
+    }
+    return;
+  }
   if (equiv_0(a, 4)) {
     rep_ = Rep::id;
     s_ = 1;
@@ -181,45 +295,74 @@ Rotation::Rotation(OpType optype, Expr a)
   }
 }
 
+void Rotation::make_symbolic() {
+  if (!numeric_) return;
+  numeric_ = false;
+  if (rep_ == Rep::id) {
+    s_ = 1;
+    i_ = j_ = k_ = 0;
+  } else if (rep_ == Rep::minus_id) {
+    s_ = -1;
+    i_ = j_ = k_ = 0;
+  } else {
+    s_ = to_expr(ns_);
+    i_ = to_expr(ni_);
+    j_ = to_expr(nj_);
+    k_ = to_expr(nk_);
+    a_ = to_expr(na_);
+  }
+}
+
 std::optional<Expr> Rotation::angle(OpType optype) const {
   if (rep_ == Rep::id) {
     return Expr(0);
   } else if (rep_ == Rep::minus_id) {
     return Expr(2);
   } else if (rep_ == Rep::orth_rot && optype_ == optype) {
-    return a_;
+    return numeric_ ? Expr(na_) : a_;
   } else {
     return std::nullopt;
   }
 }
 
+template <typename T>
+static std::tuple<T, T, T> pqp_angles_from_coeffs(
+    OpType p, OpType q, const T &s, const T &i, const T &j, const T &k) {
+  if (p == OpType::Rx && q == OpType::Ry) {
+    return xyx_angles_from_coeffs(s, i, j, k);
+  } else if (p == OpType::Ry && q == OpType::Rx) {
+    return xyx_angles_from_coeffs(s, j, i, -k);
+  } else if (p == OpType::Ry && q == OpType::Rz) {
+    return xyx_angles_from_coeffs(s, j, k, i);
+  } else if (p == OpType::Rz && q == OpType::Ry) {
+    return xyx_angles_from_coeffs(s, k, j, -i);
+  } else if (p == OpType::Rz && q == OpType::Rx) {
+    return xyx_angles_from_coeffs(s, k, i, j);
+  } else if (p == OpType::Rx && q == OpType::Rz) {
+    return xyx_angles_from_coeffs(s, i, k, -j);
+  } else {
+    throw std::logic_error("Axes must be a pair of X, Y, Z.");
+  }
+}
+
 std::tuple<Expr, Expr, Expr> Rotation::to_pqp(OpType p, OpType q) const {
   if (rep_ == Rep::id) {
     return {Expr(0), Expr(0), Expr(0)};
   } else if (rep_ == Rep::minus_id) {
     return {Expr(2), Expr(0), Expr(0)};
   } else if (rep_ == Rep::orth_rot) {
+    Expr a = numeric_ ? Expr(na_) : a_;
     if (optype_ == p) {
-      return {a_, Expr(0), Expr(0)};
+      return {a, Expr(0), Expr(0)};
     } else if (optype_ == q) {
-      return {Expr(0), a_, Expr(0)};
+      return {Expr(0), a, Expr(0)};
     }
   }
-  if (p == OpType::Rx && q == OpType::Ry) {
-    return xyx_angles_from_coeffs(s_, i_, j_, k_);
-  } else if (p == OpType::Ry && q == OpType::Rx) {
-    return xyx_angles_from_coeffs(s_, j_, i_, -k_);
-  } else if (p == OpType::Ry && q == OpType::Rz) {
-    return xyx_angles_from_coeffs(s_, j_, k_, i_);
-  } else if (p == OpType::Rz && q == OpType::Ry) {
-    return xyx_angles_from_coeffs(s_, k_, j_, -i_);
-  } else if (p == OpType::Rz && q == OpType::Rx) {
-    return xyx_angles_from_coeffs(s_, k_, i_, j_);
-  } else if (p == OpType::Rx && q == OpType::Rz) {
-    return xyx_angles_from_coeffs(s_, i_, k_, -j_);
-  } else {
-    throw std::logic_error("Axes must be a pair of X, Y, Z.");
+  if (numeric_) {
+    auto [a, b, c] = pqp_angles_from_coeffs(p, q, ns_, ni_, nj_, nk_);
+    return {to_expr(a), to_expr(b), to_expr(c)};
   }
+  return pqp_angles_from_coeffs(p, q, s_, i_, j_, k_);
 }
 
 // Table of compositions
@@ -254,6 +397,110 @@ static const std::map<
 
 void Rotation::apply(const Rotation &other) {
   if (other.rep_ == Rep::id) return;
+  if (numeric_ && other.numeric_) {
+    apply_numeric(other);
+  } else if (other.numeric_) {
+    Rotation symbolic = other;
+    symbolic.make_symbolic();
+    apply_symbolic(symbolic);
+  } else {
+    apply_symbolic(other);
+  }
+}
+
+void Rotation::apply_numeric(const Rotation &other) {
+  if (rep_ == Rep::id) {
+    *this = other;
+    return;
+  }
+
+  if (rep_ == Rep::minus_id) {
+    if (other.rep_ == Rep::minus_id) {
+      rep_ = Rep::id;
+      ns_ = 1.;
+      ni_ = nj_ = nk_ = 0.;
+    } else {
+      rep_ = other.rep_;
+      optype_ = other.optype_;
+      na_ = other.na_ + 2;
+      ns_ = -other.ns_;
+      ni_ = -other.ni_;
+      nj_ = -other.nj_, nk_ = -other.nk_;
+    }
+    return;
+  }
+
+  if (rep_ == Rep::orth_rot && other.rep_ == Rep::orth_rot) {
+    if (optype_ == other.optype_) {
+      na_ += other.na_;
+      if (approx_eq(na_, 0., 4)) {
+        rep_ = Rep::id;
+      } else if (approx_eq(na_, 0., 2)) {
+        rep_ = Rep::minus_id;
+      }
+    } else if (
+        (approx_eq(na_, 1., 4) || approx_eq(na_, -1., 4)) &&
+        (approx_eq(other.na_, 1., 4) || approx_eq(other.na_, -1., 4))) {
+      // We are in a subgroup of order 8
+      int m0 = approx_eq(na_, 1., 4) ? 1 : -1;
+      int m1 = approx_eq(other.na_, 1., 4) ? 1 : -1;
+      const std::pair<OpType, int> &prod =
+          product.at({optype_, m0, other.optype_, m1});
+      optype_ = prod.first;
+      na_ = prod.second;
+    } else
+      rep_ = Rep::quat;
+  } else
+    rep_ = Rep::quat;
+
+  double s1 = other.ns_ * ns_ - other.ni_ * ni_ - other.nj_ * nj_ -
+              other.nk_ * nk_;
+  double i1 = other.ns_ * ni_ + other.ni_ * ns_ + other.nj_ * nk_ -
+              other.nk_ * nj_;
+  double j1 = other.ns_ * nj_ - other.ni_ * nk_ + other.nj_ * ns_ +
+              other.nk_ * ni_;
+  double k1 = other.ns_ * nk_ + other.ni_ * nj_ - other.nj_ * ni_ +
+              other.nk_ * ns_;
+  ns_ = s1;
+  ni_ = i1;
+  nj_ = j1;
+  nk_ = k1;
+
+  if (rep_ == Rep::quat) {
+    // See if we can simplify the representation.
+    bool i_zero = std::abs(ni_) < EPS;
+    bool j_zero = std::abs(nj_) < EPS;
+    bool k_zero = std::abs(nk_) < EPS;
+    if (i_zero && j_zero && k_zero) {
+      if (std::abs(ns_ - 1) < EPS) {
+        rep_ = Rep::id;
+        ns_ = 1.;
+      } else {
+        rep_ = Rep::minus_id;
+        ns_ = -1.;
+      }
+      ni_ = nj_ = nk_ = 0.;
+    } else if (j_zero && k_zero) {
+      rep_ = Rep::orth_rot;
+      optype_ = OpType::Rx;
+      na_ = 2 * atan2_bypi(ni_, ns_);
+      nj_ = nk_ = 0.;
+    } else if (k_zero && i_zero) {
+      rep_ = Rep::orth_rot;
+      optype_ = OpType::Ry;
+      na_ = 2 * atan2_bypi(nj_, ns_);
+      nk_ = ni_ = 0.;
+    } else if (i_zero && j_zero) {
+      rep_ = Rep::orth_rot;
+      optype_ = OpType::Rz;
+      na_ = 2 * atan2_bypi(nk_, ns_);
+      ni_ = nj_ = 0.;
+    }
+  }
+}
+
+void Rotation::apply_symbolic(const Rotation &other) {
+  make_symbolic();
 
   if (rep_ == Rep::id) {
     rep_ = other.rep_;
@@ -311,10 +558,10 @@ void Rotation::apply(const Rotation &other) {
   Expr i1 = other.s_ * i_ + other.i_ * s_ + other.j_ * k_ - other.k_ * j_;
   Expr j1 = other.s_ * j_ - other.i_ * k_ + other.j_ * s_ + other.k_ * i_;
   Expr k1 = other.s_ * k_ + other.i_ * j_ - other.j_ * i_ + other.k_ * s_;
-  s_ = SymEngine::expand(s1);
-  i_ = SymEngine::expand(i1);
-  j_ = SymEngine::expand(j1);
-  k_ = SymEngine::expand(k1);
+  s_ = expand_expr(s1);
+  i_ = expand_expr(i1);
+  j_ = expand_expr(j1);
+  k_ = expand_expr(k1);
 
   if (rep_ == Rep::quat) {
     // See if we can simplify the representation.
@@ -355,6 +602,12 @@ std::ostream &operator<<(std::ostream &os, const Rotation &q) {
     return os << "I";
   } else if (q.rep_ == Rotation::Rep::minus_id) {
     return os << "-I";
+  } else if (q.numeric_) {
+    if (q.rep_ == Rotation::Rep::orth_rot) {
+      return os << OpDesc(q.optype_).name() << "(" << q.na_ << ")";
+    }
+    return os << q.ns_ << " + " << q.ni_ << " i + " << q.nj_
+              << " j + " << q.nk_ << " k";
   } else if (q.rep_ == Rotation::Rep::orth_rot) {
     return os << OpDesc(q.optype_).name() << "(" << q.a_ << ")";
   } else {
@@ -14,32 +14,81 @@
 
 #include "tket/Gate/SymTable.hpp"
 
+#include <array>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 namespace tket {
 
-std::unordered_set<std::string>& SymTable::get_registered_symbols() {
-  static std::unordered_set<std::string> symbols;
-  return symbols;
+namespace {
+
+constexpr std::size_t n_shards = 16;
+
+// Registered symbols by name, sharded by a hash of the name
+struct Shard {
+  std::mutex mutex;
+  std::unordered_map<std::string, Sym> symbols;
+};
+
+std::array<Shard, n_shards>& registry() {
+  // Never destroyed, as symbols may be registered during static destruction
+  static auto* shards = new std::array<Shard, n_shards>();
+  return *shards;
+}
+
+Shard& shard(const std::string& name) {
+  return registry()[std::hash<std::string>{}(name) % n_shards];
+}
+
+// Register a symbol unless one with its name is registered. Return the
+// registered symbol and whether it was added.
+std::pair<Sym, bool> insert(const std::string& name, const Sym& sym) {
+  Shard& sh = shard(name);
+  std::lock_guard<std::mutex> lock(sh.mutex);
+  auto [it, inserted] = sh.symbols.try_emplace(name, sym);
+  return {it->second, inserted};
 }
 
+}  // namespace
+
 Sym SymTable::fresh_symbol(const std::string& preferred) {
   std::string new_symbol = preferred;
   unsigned suffix = 0;
-  while (get_registered_symbols().find(new_symbol) !=
-         get_registered_symbols().cend()) {
+  while (true) {
+    Sym sym = SymEngine::symbol(new_symbol);
+    // Checking and registering a name is atomic, so concurrent callers never
+    // receive the same symbol.
+    if (insert(new_symbol, sym).second) return sym;
     suffix++;
     new_symbol = preferred + "_" + std::to_string(suffix);
   }
-  register_symbol(new_symbol);
-  return SymEngine::symbol(new_symbol);
 }
 
-void SymTable::register_symbol(const std::string& symbol) {
-  get_registered_symbols().insert(symbol);
+Sym SymTable::intern(const std::string& name) {
+  {
+    Shard& sh = shard(name);
+    std::lock_guard<std::mutex> lock(sh.mutex);
+    auto found = sh.symbols.find(name);
+    if (found != sh.symbols.end()) return found->second;
+  }
+  return insert(name, SymEngine::symbol(name)).first;
 }
 
+void SymTable::register_symbol(const std::string& symbol) { intern(symbol); }
+
 void SymTable::register_symbols(const SymSet& ss) {
   for (const auto& s : ss) {
-    get_registered_symbols().insert(s->get_name());
+    insert(s->get_name(), s);
+  }
+}
+
+void SymTable::clear() {
+  for (Shard& sh : registry()) {
+    std::lock_guard<std::mutex> lock(sh.mutex);
+    sh.symbols.clear();
   }
 }
 
@@ -0,0 +1,88 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Graphs/BitParallelBfs.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace tket::graphs {
+
+BitParallelBfs::BitParallelBfs(
+    std::size_t number_of_vertices,
+    const std::vector<std::pair<std::size_t, std::size_t>>& edges)
+    : m_number_of_vertices(number_of_vertices),
+      m_words_per_row((number_of_vertices + 63) / 64),
+      m_bits(number_of_vertices * m_words_per_row, 0) {
+  for (const auto& edge : edges) {
+    if (edge.first >= number_of_vertices ||
+        edge.second >= number_of_vertices) {
+      throw std::out_of_range("BitParallelBfs: invalid vertex");
+    }
+    m_bits[edge.first * m_words_per_row + edge.second / 64] |=
+        std::uint64_t(1) << (edge.second % 64);
+    m_bits[edge.second * m_words_per_row + edge.first / 64] |=
+        std::uint64_t(1) << (edge.first % 64);
+  }
+}
+
+bool BitParallelBfs::is_dense(
+    std::size_t number_of_vertices, std::size_t number_of_edges) {
+  // A search ORs one row (n/64 words) per vertex, where an adjacency-list
+  // search visits 2E neighbours; following an edge of the boost graph
+  // costs roughly as much as 8 words of the matrix.
+  const std::size_t words_per_row = (number_of_vertices + 63) / 64;
+  return number_of_vertices * words_per_row <= 16 * number_of_edges;
+}
+
+std::vector<std::size_t> BitParallelBfs::get_distances(
+    std::size_t root) const {
+  if (root >= m_number_of_vertices) {
+    throw std::out_of_range("BitParallelBfs: invalid root");
+  }
+  std::vector<std::size_t> distances(m_number_of_vertices, 0);
+  std::vector<std::uint64_t> visited(m_words_per_row, 0);
+  std::vector<std::uint64_t> frontier(m_words_per_row, 0);
+  std::vector<std::uint64_t> next(m_words_per_row);
+  visited[root / 64] = frontier[root / 64] = std::uint64_t(1) << (root % 64);
+
+  for (std::size_t distance = 1;; ++distance) {
+    std::fill(next.begin(), next.end(), 0);
+    for (std::size_t w = 0; w < m_words_per_row; ++w) {
+      for (std::uint64_t word = frontier[w]; word != 0; word &= word - 1) {
+        const std::size_t vertex = 64 * w + std::countr_zero(word);
+        const std::uint64_t* row = m_bits.data() + vertex * m_words_per_row;
+        for (std::size_t k = 0; k < m_words_per_row; ++k) {
+          next[k] |= row[k];
+        }
+      }
+    }
+    bool found_new_vertex = false;
+    for (std::size_t w = 0; w < m_words_per_row; ++w) {
+      next[w] &= ~visited[w];
+      visited[w] |= next[w];
+      for (std::uint64_t word = next[w]; word != 0; word &= word - 1) {
+        distances[64 * w + std::countr_zero(word)] = distance;
+        found_new_vertex = true;
+      }
+    }
+    if (!found_new_vertex) {
+      return distances;
+    }
+    frontier.swap(next);
+  }
+}
+
+}  // namespace tket::graphs
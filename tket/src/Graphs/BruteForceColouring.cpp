@@ -14,6 +14,8 @@
 
 #include "BruteForceColouring.hpp"
 
+#include <chrono>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <stdexcept>
@@ -52,6 +54,13 @@ struct BruteForceColouring::Impl {
   // KEY: is the vertex, VALUE: the colour
   map<std::size_t, std::size_t> colours;
 
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+  bool timed_out = false;
+
+  // Reading the clock is relatively expensive, so only do it
+  // once every this many backtracking steps.
+  static constexpr std::size_t STEPS_BETWEEN_CLOCK_CHECKS = 1024;
+
   // Fills in the colour possibilities,
   // possibly increasing suggested_number_of_colours.
   // Returns false if it failed.
@@ -126,8 +135,14 @@ struct BruteForceColouring::Impl {
     }
     const auto& nodes = priority.get_nodes();
     const std::size_t number_of_nodes = nodes.size();
+    std::size_t steps = 0;
 
     for (std::size_t current_node_index = 0;;) {
+      if (deadline && ++steps % STEPS_BETWEEN_CLOCK_CHECKS == 0 &&
+          std::chrono::steady_clock::now() > *deadline) {
+        timed_out = true;
+        return false;
+      }
       const auto& current_node = nodes[current_node_index];
       auto& current_colouring_node = colouring_data[current_node_index];
 
@@ -174,8 +189,10 @@ struct BruteForceColouring::Impl {
 BruteForceColouring::~BruteForceColouring() {}
 
 BruteForceColouring::BruteForceColouring(
-    const ColouringPriority& priority, std::size_t suggested_number_of_colours)
+    const ColouringPriority& priority, std::size_t suggested_number_of_colours,
+    const std::optional<std::chrono::steady_clock::time_point>& deadline)
     : m_pimpl(std::make_unique<BruteForceColouring::Impl>()) {
+  m_pimpl->deadline = deadline;
   const auto number_of_nodes = priority.get_nodes().size();
   if (suggested_number_of_colours >= number_of_nodes) {
     // We've been given permission to use many colours;
@@ -206,6 +223,10 @@ BruteForceColouring::BruteForceColouring(
         m_pimpl->fill_colour_map(priority);
         return;
       }
+      if (m_pimpl->timed_out) {
+        m_pimpl->colours.clear();
+        return;
+      }
       // It's impossible with this number of colours,
       // so try again with one more.
       // If we were really fancy we might consider
@@ -234,5 +255,7 @@ const map<std::size_t, std::size_t>& BruteForceColouring::get_colours() const {
   return m_pimpl->colours;
 }
 
+bool BruteForceColouring::timed_out() const { return m_pimpl->timed_out; }
+
 }  // namespace graphs
 }  // namespace tket
@@ -14,9 +14,11 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <optional>
 
 namespace tket {
 namespace graphs {
@@ -41,10 +43,14 @@ class BruteForceColouring {
    * @param suggested_number_of_colours A hint that you think this many colours
    * are needed. If you set it too high you may end up with a suboptimal
    * colouring, but it might be quicker.
+   * @param deadline If set, give up once this time has passed; then no
+   * colouring is returned, and timed_out() is true.
    */
   BruteForceColouring(
       const ColouringPriority& priority,
-      std::size_t suggested_number_of_colours = 0);
+      std::size_t suggested_number_of_colours = 0,
+      const std::optional<std::chrono::steady_clock::time_point>& deadline =
+          std::nullopt);
 
   /**
    * The colours found for this component (already calculated during
@@ -52,6 +58,12 @@ class BruteForceColouring {
    */
   const std::map<std::size_t, std::size_t>& get_colours() const;
 
+  /**
+   * Whether the deadline passed before a colouring was found,
+   * in which case get_colours() is empty.
+   */
+  bool timed_out() const;
+
   ~BruteForceColouring();
 
  private:
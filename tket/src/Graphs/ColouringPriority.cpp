@@ -19,6 +19,7 @@
 #include <tkassert/Assert.hpp>
 
 #include "tket/Graphs/AdjacencyData.hpp"
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
 
 using std::map;
 using std::set;
@@ -29,8 +30,9 @@ using std::vector;
 namespace tket {
 namespace graphs {
 
+template <class Adjacency>
 static void fill_initial_node_sequence(
-    ColouringPriority::Nodes& nodes, const AdjacencyData& adjacency_data,
+    ColouringPriority::Nodes& nodes, const Adjacency& adjacency_data,
     const set<std::size_t>& vertices_in_component,
     const set<std::size_t>& initial_clique) {
   nodes.reserve(vertices_in_component.size());
@@ -104,8 +106,9 @@ static void fill_initial_node_sequence(
 // Quadratic, but we're not afraid; the main brute force colouring is
 // exponential! Assumes that "fill_initial_node_sequence" has just been called.
 // Fills in "earlier_neighbour_node_indices".
+template <class Adjacency>
 static void fill_node_dependencies(
-    ColouringPriority::Nodes& nodes, const AdjacencyData& adjacency_data) {
+    ColouringPriority::Nodes& nodes, const Adjacency& adjacency_data) {
   for (std::size_t node_index = 1; node_index < nodes.size(); ++node_index) {
     auto& this_node = nodes[node_index];
 
@@ -190,6 +193,17 @@ ColouringPriority::ColouringPriority(
   fill_node_dependencies(m_nodes, adjacency_data);
 }
 
+ColouringPriority::ColouringPriority(
+    const CompressedAdjacencyData& adjacency_data,
+    const set<std::size_t>& vertices_in_component,
+    const set<std::size_t>& initial_clique)
+    : m_initial_clique(initial_clique) {
+  fill_initial_node_sequence(
+      m_nodes, adjacency_data, vertices_in_component, initial_clique);
+
+  fill_node_dependencies(m_nodes, adjacency_data);
+}
+
 const set<std::size_t>& ColouringPriority::get_initial_clique() const {
   return m_initial_clique;
 }
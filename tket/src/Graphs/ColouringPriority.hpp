@@ -23,6 +23,7 @@ namespace tket {
 namespace graphs {
 
 class AdjacencyData;
+class CompressedAdjacencyData;
 
 // TODO: if we only allow 64 colours
 // (which follows if, e.g., we only have <= 64 vertices),
@@ -73,6 +74,12 @@ class ColouringPriority {
       const std::set<std::size_t>& vertices_in_component,
       const std::set<std::size_t>& initial_clique);
 
+  /** As above, for a graph in compressed format. */
+  ColouringPriority(
+      const CompressedAdjacencyData& adjacency_data,
+      const std::set<std::size_t>& vertices_in_component,
+      const std::set<std::size_t>& initial_clique);
+
   /**
    * Contains extra data about a vertex. These node objects will be put into a
    * vector which defines the coluring order.
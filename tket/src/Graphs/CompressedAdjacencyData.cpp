@@ -0,0 +1,166 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <tkassert/Assert.hpp>
+
+#include "tket/Graphs/AdjacencyData.hpp"
+
+using std::size_t;
+using std::vector;
+
+namespace tket {
+namespace graphs {
+
+CompressedAdjacencyData::CompressedAdjacencyData(
+    std::size_t number_of_vertices)
+    : m_offsets(number_of_vertices + 1, 0) {
+  finish_construction();
+}
+
+CompressedAdjacencyData::CompressedAdjacencyData(
+    const AdjacencyData& adjacency_data) {
+  const std::size_t number_of_vertices =
+      adjacency_data.get_number_of_vertices();
+  m_offsets.reserve(number_of_vertices + 1);
+  m_offsets.push_back(0);
+  for (std::size_t i = 0; i < number_of_vertices; ++i) {
+    // The sets are already sorted, without duplicates.
+    const auto& neighbours = adjacency_data.get_neighbours(i);
+    m_neighbours.insert(
+        m_neighbours.end(), neighbours.cbegin(), neighbours.cend());
+    m_offsets.push_back(m_neighbours.size());
+  }
+  finish_construction();
+}
+
+CompressedAdjacencyData::CompressedAdjacencyData(
+    std::size_t number_of_vertices,
+    const vector<std::pair<std::size_t, std::size_t>>& edges) {
+  // First, count the degrees (including duplicates), to give the row sizes.
+  vector<std::size_t> row_ends(number_of_vertices, 0);
+  for (const auto& [i, j] : edges) {
+    // GCOVR_EXCL_START
+    TKET_ASSERT(
+        (i < number_of_vertices && j < number_of_vertices) ||
+        AssertMessage() << "CompressedAdjacencyData: edge (" << i << ", " << j
+                        << ") is invalid; there are only "
+                        << number_of_vertices << " vertices");
+    // GCOVR_EXCL_STOP
+    ++row_ends[i];
+    if (i != j) {
+      ++row_ends[j];
+    }
+  }
+  for (std::size_t i = 1; i < number_of_vertices; ++i) {
+    row_ends[i] += row_ends[i - 1];
+  }
+  vector<std::size_t> raw_neighbours(
+      number_of_vertices == 0 ? 0 : row_ends.back());
+
+  // Fill the rows backwards, so that row_ends become the row beginnings.
+  for (const auto& [i, j] : edges) {
+    raw_neighbours[--row_ends[i]] = j;
+    if (i != j) {
+      raw_neighbours[--row_ends[j]] = i;
+    }
+  }
+  // Now sort each row, and copy with duplicates removed.
+  m_offsets.reserve(number_of_vertices + 1);
+  m_offsets.push_back(0);
+  m_neighbours.reserve(raw_neighbours.size());
+  for (std::size_t i = 0; i < number_of_vertices; ++i) {
+    const auto row_begin = raw_neighbours.begin() + row_ends[i];
+    const auto row_end = i + 1 < number_of_vertices
+                             ? raw_neighbours.begin() + row_ends[i + 1]
+                             : raw_neighbours.end();
+    std::sort(row_begin, row_end);
+    std::unique_copy(row_begin, row_end, std::back_inserter(m_neighbours));
+    m_offsets.push_back(m_neighbours.size());
+  }
+  m_neighbours.shrink_to_fit();
+  finish_construction();
+}
+
+void CompressedAdjacencyData::finish_construction() {
+  const std::size_t number_of_vertices = get_number_of_vertices();
+
+  // Each edge i-j is counted twice, i->j and j->i, except for loops.
+  std::size_t loops = 0;
+  for (std::size_t i = 0; i < number_of_vertices; ++i) {
+    loops += edge_exists(i, i) ? 1 : 0;
+  }
+  m_number_of_edges = loops + (m_neighbours.size() - loops) / 2;
+
+  m_words_per_row = (number_of_vertices + 63) / 64;
+  if (number_of_vertices == 0 ||
+      m_words_per_row * number_of_vertices > m_neighbours.size()) {
+    return;
+  }
+  m_bit_matrix.assign(m_words_per_row * number_of_vertices, 0);
+  for (std::size_t i = 0; i < number_of_vertices; ++i) {
+    std::uint64_t* row = m_bit_matrix.data() + i * m_words_per_row;
+    for (std::size_t j : get_neighbours(i)) {
+      row[j / 64] |= std::uint64_t(1) << (j % 64);
+    }
+  }
+}
+
+std::span<const std::size_t> CompressedAdjacencyData::get_neighbours(
+    std::size_t vertex) const {
+  // GCOVR_EXCL_START
+  TKET_ASSERT(
+      vertex < get_number_of_vertices() ||
+      AssertMessage() << "CompressedAdjacencyData: get_neighbours called with "
+                         "invalid vertex "
+                      << vertex << "; there are only "
+                      << get_number_of_vertices() << " vertices");
+  // GCOVR_EXCL_STOP
+  return std::span<const std::size_t>(
+      m_neighbours.data() + m_offsets[vertex],
+      m_offsets[vertex + 1] - m_offsets[vertex]);
+}
+
+std::size_t CompressedAdjacencyData::get_number_of_vertices() const {
+  return m_offsets.size() - 1;
+}
+
+std::size_t CompressedAdjacencyData::get_number_of_edges() const {
+  return m_number_of_edges;
+}
+
+bool CompressedAdjacencyData::edge_exists(std::size_t i, std::size_t j) const {
+  // GCOVR_EXCL_START
+  TKET_ASSERT(
+      (i < get_number_of_vertices() && j < get_number_of_vertices()) ||
+      AssertMessage() << "edge_exists called with vertices " << i << ", " << j
+                      << ", but there are only " << get_number_of_vertices()
+                      << " vertices");
+  // GCOVR_EXCL_STOP
+  if (!m_bit_matrix.empty()) {
+    return (m_bit_matrix[i * m_words_per_row + j / 64] >> (j % 64)) & 1;
+  }
+  const auto neighbours = get_neighbours(i);
+  return std::binary_search(neighbours.begin(), neighbours.end(), j);
+}
+
+bool CompressedAdjacencyData::has_bit_matrix() const {
+  return !m_bit_matrix.empty();
+}
+
+}  // namespace graphs
+}  // namespace tket
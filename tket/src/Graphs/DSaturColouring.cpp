@@ -0,0 +1,112 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "DSaturColouring.hpp"
+
+#include <iterator>
+#include <set>
+#include <tkassert/Assert.hpp>
+#include <tuple>
+
+#include "tket/Graphs/AdjacencyData.hpp"
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
+
+using std::set;
+using std::vector;
+
+namespace tket {
+namespace graphs {
+
+template <class Adjacency>
+static void colour_impl(
+    const Adjacency& adjacency_data, const vector<std::size_t>& vertices,
+    vector<std::size_t>& colours) {
+  constexpr std::size_t UNCOLOURED = DSaturColouring::UNCOLOURED;
+  const std::size_t number_of_vertices =
+      adjacency_data.get_number_of_vertices();
+  TKET_ASSERT(colours.size() == number_of_vertices);
+
+  // Element v is the index of vertex v in "vertices",
+  // or UNCOLOURED if it is not to be coloured.
+  vector<std::size_t> local_index(number_of_vertices, UNCOLOURED);
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    TKET_ASSERT(colours[vertices[i]] == UNCOLOURED);
+    local_index[vertices[i]] = i;
+  }
+
+  // The distinct colours already used by neighbours of each vertex.
+  vector<set<std::size_t>> neighbour_colours(vertices.size());
+  vector<std::size_t> degrees(vertices.size());
+
+  // (saturation, degree, -vertex): the last element is the next to colour.
+  typedef std::tuple<std::size_t, std::size_t, std::size_t> Key;
+  const auto get_key = [&](std::size_t i) {
+    return Key(
+        neighbour_colours[i].size(), degrees[i], UNCOLOURED - vertices[i]);
+  };
+  set<Key> queue;
+
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    for (auto neighbour : adjacency_data.get_neighbours(vertices[i])) {
+      ++degrees[i];
+      if (colours[neighbour] != UNCOLOURED) {
+        neighbour_colours[i].insert(colours[neighbour]);
+      }
+    }
+    queue.insert(get_key(i));
+  }
+
+  while (!queue.empty()) {
+    const std::size_t vertex = UNCOLOURED - std::get<2>(*queue.crbegin());
+    queue.erase(std::prev(queue.end()));
+    const std::size_t i = local_index[vertex];
+
+    // The colours are sorted, so the first gap is the smallest free colour.
+    std::size_t colour = 0;
+    for (auto used_colour : neighbour_colours[i]) {
+      if (used_colour != colour) {
+        break;
+      }
+      ++colour;
+    }
+    colours[vertex] = colour;
+    neighbour_colours[i].clear();
+
+    for (auto neighbour : adjacency_data.get_neighbours(vertex)) {
+      const std::size_t j = local_index[neighbour];
+      if (j == UNCOLOURED || colours[neighbour] != UNCOLOURED ||
+          neighbour_colours[j].count(colour) != 0) {
+        continue;
+      }
+      queue.erase(get_key(j));
+      neighbour_colours[j].insert(colour);
+      queue.insert(get_key(j));
+    }
+  }
+}
+
+void DSaturColouring::colour(
+    const AdjacencyData& adjacency_data, const vector<std::size_t>& vertices,
+    vector<std::size_t>& colours) {
+  colour_impl(adjacency_data, vertices, colours);
+}
+
+void DSaturColouring::colour(
+    const CompressedAdjacencyData& adjacency_data,
+    const vector<std::size_t>& vertices, vector<std::size_t>& colours) {
+  colour_impl(adjacency_data, vertices, colours);
+}
+
+}  // namespace graphs
+}  // namespace tket
@@ -0,0 +1,60 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace tket {
+namespace graphs {
+
+class AdjacencyData;
+class CompressedAdjacencyData;
+
+/**
+ * The greedy "DSatur" colouring heuristic: repeatedly pick the uncoloured
+ * vertex with the most distinct colours among its neighbours (breaking ties
+ * by degree, then by smallest vertex), and give it the smallest colour not
+ * used by any neighbour. It takes O((V+E) log V) time, so it can be used
+ * on graphs far too large for BruteForceColouring, but the result
+ * need not be optimal.
+ */
+struct DSaturColouring {
+  /** The colour value meaning "not yet coloured". */
+  static constexpr std::size_t UNCOLOURED = static_cast<std::size_t>(-1);
+
+  /**
+   * Colour some vertices, respecting colours already assigned to
+   * their neighbours.
+   * @param adjacency_data The graph.
+   * @param vertices_to_colour The vertices to colour; each must currently
+   *  be UNCOLOURED.
+   * @param colours Element i is the colour of vertex i, or UNCOLOURED.
+   *  Vertices not in vertices_to_colour are left unchanged.
+   */
+  static void colour(
+      const AdjacencyData& adjacency_data,
+      const std::vector<std::size_t>& vertices_to_colour,
+      std::vector<std::size_t>& colours);
+
+  /** As above, for a graph in compressed format. */
+  static void colour(
+      const CompressedAdjacencyData& adjacency_data,
+      const std::vector<std::size_t>& vertices_to_colour,
+      std::vector<std::size_t>& colours);
+};
+
+}  // namespace graphs
+}  // namespace tket
@@ -0,0 +1,210 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Graphs/DynamicArticulationPoints.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <tkassert/Assert.hpp>
+
+namespace tket {
+namespace graphs {
+
+DynamicArticulationPoints::DynamicArticulationPoints(
+    std::size_t number_of_vertices,
+    const std::vector<std::pair<std::size_t, std::size_t>>& edges)
+    : m_neighbours(number_of_vertices),
+      m_removed(number_of_vertices, false),
+      m_number_of_vertices(number_of_vertices),
+      m_vertex_blocks(number_of_vertices),
+      m_discovery(number_of_vertices, 0),
+      m_low(number_of_vertices, 0) {
+  for (const auto& edge : edges) {
+    if (edge.first >= number_of_vertices ||
+        edge.second >= number_of_vertices) {
+      throw std::runtime_error("DynamicArticulationPoints: invalid vertex");
+    }
+    if (edge.first != edge.second) {
+      m_neighbours[edge.first].insert(edge.second);
+      m_neighbours[edge.second].insert(edge.first);
+    }
+  }
+  std::vector<std::size_t> vertices(number_of_vertices);
+  for (std::size_t i = 0; i < number_of_vertices; ++i) {
+    vertices[i] = i;
+  }
+  add_blocks(vertices);
+}
+
+void DynamicArticulationPoints::add_block(std::vector<std::size_t> block) {
+  std::size_t id;
+  if (m_unused_block_ids.empty()) {
+    id = m_blocks.size();
+    m_blocks.emplace_back();
+  } else {
+    id = m_unused_block_ids.back();
+    m_unused_block_ids.pop_back();
+  }
+  for (auto vertex : block) {
+    m_vertex_blocks[vertex].insert(id);
+  }
+  m_blocks[id] = std::move(block);
+}
+
+void DynamicArticulationPoints::update_status(std::size_t vertex) {
+  if (!m_removed[vertex] && m_vertex_blocks[vertex].size() >= 2) {
+    m_articulation_points.insert(vertex);
+  } else {
+    m_articulation_points.erase(vertex);
+  }
+}
+
+// The Hopcroft-Tarjan algorithm, iteratively (device graphs can have
+// long paths), restricted to the given vertices.
+void DynamicArticulationPoints::add_blocks(
+    const std::vector<std::size_t>& vertices) {
+  // Only vertices with discovery time 1 are "in the subgraph but not yet
+  // visited"; real discovery times then start from 2.
+  constexpr std::size_t UNVISITED = 1;
+  for (auto vertex : vertices) {
+    m_discovery[vertex] = UNVISITED;
+  }
+  std::size_t time = UNVISITED;
+
+  struct Frame {
+    std::size_t vertex;
+    std::size_t parent;
+    std::set<std::size_t>::const_iterator next_neighbour;
+  };
+  std::vector<Frame> frames;
+  std::vector<std::pair<std::size_t, std::size_t>> edge_stack;
+  const std::size_t NO_PARENT = std::numeric_limits<std::size_t>::max();
+
+  for (auto root : vertices) {
+    if (m_discovery[root] != UNVISITED) {
+      continue;
+    }
+    m_discovery[root] = m_low[root] = ++time;
+    frames.push_back({root, NO_PARENT, m_neighbours[root].cbegin()});
+
+    while (!frames.empty()) {
+      auto& frame = frames.back();
+      const std::size_t vertex = frame.vertex;
+      if (frame.next_neighbour != m_neighbours[vertex].cend()) {
+        const std::size_t neighbour = *frame.next_neighbour;
+        ++frame.next_neighbour;
+        if (m_discovery[neighbour] == 0) {
+          // Not in the subgraph.
+          continue;
+        }
+        if (m_discovery[neighbour] == UNVISITED) {
+          edge_stack.emplace_back(vertex, neighbour);
+          m_discovery[neighbour] = m_low[neighbour] = ++time;
+          // This invalidates "frame".
+          frames.push_back(
+              {neighbour, vertex, m_neighbours[neighbour].cbegin()});
+          continue;
+        }
+        if (neighbour != frame.parent &&
+            m_discovery[neighbour] < m_discovery[vertex]) {
+          edge_stack.emplace_back(vertex, neighbour);
+          m_low[vertex] = std::min(m_low[vertex], m_discovery[neighbour]);
+        }
+        continue;
+      }
+      // Finished with this vertex.
+      const std::size_t parent = frame.parent;
+      frames.pop_back();
+      if (parent == NO_PARENT) {
+        continue;
+      }
+      m_low[parent] = std::min(m_low[parent], m_low[vertex]);
+      if (m_low[vertex] < m_discovery[parent]) {
+        continue;
+      }
+      // The edges above (parent, vertex) on the stack form a block.
+      std::vector<std::size_t> block;
+      for (;;) {
+        TKET_ASSERT(!edge_stack.empty());
+        const auto edge = edge_stack.back();
+        edge_stack.pop_back();
+        block.push_back(edge.first);
+        block.push_back(edge.second);
+        if (edge.first == parent && edge.second == vertex) {
+          break;
+        }
+      }
+      std::sort(block.begin(), block.end());
+      block.erase(std::unique(block.begin(), block.end()), block.end());
+      add_block(std::move(block));
+    }
+  }
+  for (auto vertex : vertices) {
+    m_discovery[vertex] = 0;
+    update_status(vertex);
+  }
+}
+
+void DynamicArticulationPoints::remove_vertex(std::size_t vertex) {
+  TKET_ASSERT(vertex < m_removed.size());
+  if (m_removed[vertex]) {
+    return;
+  }
+  m_removed[vertex] = true;
+  --m_number_of_vertices;
+
+  // Every edge of the affected vertices lies within a single block,
+  // so the subgraph spanned by the blocks of "vertex" is exactly what
+  // must be re-split.
+  std::set<std::size_t> affected;
+  for (auto id : m_vertex_blocks[vertex]) {
+    for (auto other : m_blocks[id]) {
+      if (other != vertex) {
+        affected.insert(other);
+        m_vertex_blocks[other].erase(id);
+      }
+    }
+    m_blocks[id].clear();
+    m_unused_block_ids.push_back(id);
+  }
+  m_vertex_blocks[vertex].clear();
+  for (auto neighbour : m_neighbours[vertex]) {
+    m_neighbours[neighbour].erase(vertex);
+  }
+  m_neighbours[vertex].clear();
+  m_articulation_points.erase(vertex);
+  add_blocks(std::vector<std::size_t>(affected.cbegin(), affected.cend()));
+}
+
+bool DynamicArticulationPoints::contains(std::size_t vertex) const {
+  return vertex < m_removed.size() && !m_removed[vertex];
+}
+
+bool DynamicArticulationPoints::is_articulation_point(
+    std::size_t vertex) const {
+  return m_articulation_points.count(vertex) != 0;
+}
+
+const std::set<std::size_t>&
+DynamicArticulationPoints::get_articulation_points() const {
+  return m_articulation_points;
+}
+
+std::size_t DynamicArticulationPoints::get_number_of_vertices() const {
+  return m_number_of_vertices;
+}
+
+}  // namespace graphs
+}  // namespace tket
@@ -15,15 +15,22 @@
 #include "tket/Graphs/GraphColouring.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <limits>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 #include <tkassert/Assert.hpp>
 
 #include "BruteForceColouring.hpp"
 #include "ColouringPriority.hpp"
+#include "DSaturColouring.hpp"
 #include "tket/Graphs/AdjacencyData.hpp"
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
 #include "tket/Graphs/GraphRoutines.hpp"
 #include "tket/Graphs/LargeCliquesResult.hpp"
 
@@ -59,36 +66,54 @@ GraphColouringResult::GraphColouringResult(const vector<std::size_t>& _colours)
   }
 }
 
-// Also updates the number of colours used in "result".
-static void colour_single_component(
-    const AdjacencyData& adjacency_data,
+typedef std::optional<std::chrono::steady_clock::time_point> Deadline;
+
+// Colours one component, writing only the entries of "colours"
+// for its vertices. Returns the number of colours used.
+template <class Adjacency>
+static std::size_t colour_single_component(
+    const Adjacency& adjacency_data,
     const vector<set<std::size_t>>& connected_components,
     const vector<set<std::size_t>>& cliques, std::size_t component_index,
-    GraphColouringResult& result) {
-  result.number_of_colours =
-      std::max(result.number_of_colours, cliques[component_index].size());
+    std::size_t suggested_number_of_colours, const Deadline& deadline,
+    vector<std::size_t>& colours) {
+  const auto& component = connected_components[component_index];
+  map<std::size_t, std::size_t> partial_colour_map;
+  bool use_greedy_colouring =
+      deadline && std::chrono::steady_clock::now() > *deadline;
 
-  const ColouringPriority colouring_priority(
-      adjacency_data, connected_components[component_index],
-      cliques[component_index]);
+  if (!use_greedy_colouring) {
+    const ColouringPriority colouring_priority(
+        adjacency_data, component, cliques[component_index]);
 
-  const BruteForceColouring brute_force_colouring(
-      colouring_priority, result.number_of_colours);
-
-  const auto& partial_colour_map = brute_force_colouring.get_colours();
+    const BruteForceColouring brute_force_colouring(
+        colouring_priority, suggested_number_of_colours, deadline);
+    use_greedy_colouring = brute_force_colouring.timed_out();
+    partial_colour_map = brute_force_colouring.get_colours();
+  }
+  if (use_greedy_colouring) {
+    const vector<std::size_t> vertices(component.cbegin(), component.cend());
+    DSaturColouring::colour(adjacency_data, vertices, colours);
+    std::size_t number_of_colours = 0;
+    for (auto vertex : vertices) {
+      number_of_colours = std::max(number_of_colours, colours[vertex] + 1);
+    }
+    return number_of_colours;
+  }
+  std::size_t number_of_colours = 0;
 
   for (const auto& entry : partial_colour_map) {
     const auto& vertex = entry.first;
     const auto& colour = entry.second;
-    result.number_of_colours = std::max(result.number_of_colours, colour + 1);
+    number_of_colours = std::max(number_of_colours, colour + 1);
 
     // GCOVR_EXCL_START
     try {
-      if (vertex >= result.colours.size()) {
+      if (vertex >= colours.size()) {
         throw runtime_error("illegal vertex index");
       }
-      auto& colour_to_assign = result.colours[vertex];
-      if (colour_to_assign < result.colours.size()) {
+      auto& colour_to_assign = colours[vertex];
+      if (colour_to_assign < colours.size()) {
         stringstream ss;
         ss << "colour already assigned! Existing colour " << colour_to_assign;
         throw runtime_error(ss.str());
@@ -102,6 +127,55 @@ static void colour_single_component(
     }
     // GCOVR_EXCL_STOP
   }
+  return number_of_colours;
+}
+
+// Colours the components (already sorted by decreasing clique size)
+// concurrently. Each component is suggested the largest clique size,
+// which is what the serial colouring would reach anyway
+// before getting to it.
+template <class Adjacency>
+static void colour_components_in_parallel(
+    const Adjacency& adjacency_data,
+    const vector<set<std::size_t>>& connected_components,
+    const vector<set<std::size_t>>& cliques,
+    const vector<std::size_t>& component_indices, unsigned number_of_threads,
+    const Deadline& deadline, vector<std::size_t>& colours) {
+  const std::size_t suggested_number_of_colours =
+      cliques[component_indices[0]].size();
+  std::atomic<std::size_t> next_index = 0;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const auto work = [&]() {
+    try {
+      for (std::size_t index = next_index++; index < component_indices.size();
+           index = next_index++) {
+        colour_single_component(
+            adjacency_data, connected_components, cliques,
+            component_indices[index], suggested_number_of_colours, deadline,
+            colours);
+      }
+    } catch (...) {
+      // GCOVR_EXCL_START
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_index = component_indices.size();
+      // GCOVR_EXCL_STOP
+    }
+  };
+  vector<std::thread> workers;
+  for (unsigned i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);  // GCOVR_EXCL_LINE
+  }
 }
 
 // Check that everything was coloured,
@@ -123,8 +197,18 @@ static void check_final_colouring(GraphColouringResult& result) {
   }
 }
 
-GraphColouringResult GraphColouringRoutines::get_colouring(
-    const AdjacencyData& adjacency_data) {
+template <class Adjacency>
+static GraphColouringResult get_colouring_impl(
+    const Adjacency& adjacency_data, const GraphColouringOptions& options) {
+  Deadline deadline;
+  if (options.timeout_ms) {
+    deadline = std::chrono::steady_clock::now() +
+               std::chrono::milliseconds(*options.timeout_ms);
+  }
+  unsigned number_of_threads = options.number_of_threads;
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
   const auto connected_components =
       GraphRoutines::get_connected_components(adjacency_data);
   vector<set<std::size_t>> cliques(connected_components.size());
@@ -162,10 +246,23 @@ GraphColouringResult GraphColouringRoutines::get_colouring(
         adjacency_data.get_number_of_vertices(),
         std::numeric_limits<std::size_t>::max());
 
-    for (auto component_index : component_indices) {
-      colour_single_component(
-          adjacency_data, connected_components, cliques, component_index,
-          result);
+    number_of_threads = std::min<std::size_t>(
+        number_of_threads, component_indices.size());
+    if (number_of_threads > 1) {
+      colour_components_in_parallel(
+          adjacency_data, connected_components, cliques, component_indices,
+          number_of_threads, deadline, result.colours);
+    } else {
+      for (auto component_index : component_indices) {
+        result.number_of_colours = std::max(
+            result.number_of_colours, cliques[component_index].size());
+        result.number_of_colours = std::max(
+            result.number_of_colours,
+            colour_single_component(
+                adjacency_data, connected_components, cliques,
+                component_index, result.number_of_colours, deadline,
+                result.colours));
+      }
     }
     check_final_colouring(result);
     return result;
@@ -183,5 +280,113 @@ GraphColouringResult GraphColouringRoutines::get_colouring(
   }
 }
 
+template <class Adjacency>
+static GraphColouringResult get_greedy_colouring_impl(
+    const Adjacency& adjacency_data) {
+  const std::size_t number_of_vertices =
+      adjacency_data.get_number_of_vertices();
+  vector<std::size_t> vertices(number_of_vertices);
+  for (std::size_t i = 0; i < number_of_vertices; ++i) {
+    vertices[i] = i;
+  }
+  vector<std::size_t> colours(number_of_vertices, DSaturColouring::UNCOLOURED);
+  DSaturColouring::colour(adjacency_data, vertices, colours);
+  return GraphColouringResult(colours);
+}
+
+template <class Adjacency>
+static GraphColouringResult update_colouring_impl(
+    const Adjacency& adjacency_data, const vector<std::size_t>& previous) {
+  constexpr std::size_t UNCOLOURED = DSaturColouring::UNCOLOURED;
+  const std::size_t number_of_vertices =
+      adjacency_data.get_number_of_vertices();
+  vector<std::size_t> colours(number_of_vertices, UNCOLOURED);
+  std::copy_n(
+      previous.cbegin(), std::min(previous.size(), number_of_vertices),
+      colours.begin());
+
+  // Going upwards, every earlier vertex keeps its colour,
+  // so at most one endpoint of each clashing edge loses its colour.
+  for (std::size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+    if (colours[vertex] == UNCOLOURED) {
+      continue;
+    }
+    for (auto neighbour : adjacency_data.get_neighbours(vertex)) {
+      if (neighbour < vertex && colours[neighbour] == colours[vertex]) {
+        colours[vertex] = UNCOLOURED;
+        break;
+      }
+    }
+  }
+
+  // Relabel the surviving colours as 0,1,2,..., preserving their order.
+  map<std::size_t, std::size_t> relabelling;
+  for (auto colour : colours) {
+    if (colour != UNCOLOURED) {
+      relabelling.emplace(colour, 0);
+    }
+  }
+  std::size_t next_colour = 0;
+  for (auto& entry : relabelling) {
+    entry.second = next_colour++;
+  }
+  vector<std::size_t> vertices_to_colour;
+  for (std::size_t vertex = 0; vertex < number_of_vertices; ++vertex) {
+    if (colours[vertex] == UNCOLOURED) {
+      vertices_to_colour.push_back(vertex);
+    } else {
+      colours[vertex] = relabelling.at(colours[vertex]);
+    }
+  }
+  // The greedy colouring always takes the smallest colour not used by
+  // any neighbour, so it cannot introduce gaps.
+  DSaturColouring::colour(adjacency_data, vertices_to_colour, colours);
+  return GraphColouringResult(colours);
+}
+
+GraphColouringResult GraphColouringRoutines::get_colouring(
+    const AdjacencyData& adjacency_data) {
+  return get_colouring_impl(adjacency_data, GraphColouringOptions());
+}
+
+GraphColouringResult GraphColouringRoutines::get_colouring(
+    const CompressedAdjacencyData& adjacency_data) {
+  return get_colouring_impl(adjacency_data, GraphColouringOptions());
+}
+
+GraphColouringResult GraphColouringRoutines::get_colouring(
+    const AdjacencyData& adjacency_data,
+    const GraphColouringOptions& options) {
+  return get_colouring_impl(adjacency_data, options);
+}
+
+GraphColouringResult GraphColouringRoutines::get_colouring(
+    const CompressedAdjacencyData& adjacency_data,
+    const GraphColouringOptions& options) {
+  return get_colouring_impl(adjacency_data, options);
+}
+
+GraphColouringResult GraphColouringRoutines::get_greedy_colouring(
+    const AdjacencyData& adjacency_data) {
+  return get_greedy_colouring_impl(adjacency_data);
+}
+
+GraphColouringResult GraphColouringRoutines::get_greedy_colouring(
+    const CompressedAdjacencyData& adjacency_data) {
+  return get_greedy_colouring_impl(adjacency_data);
+}
+
+GraphColouringResult GraphColouringRoutines::update_colouring(
+    const AdjacencyData& adjacency_data,
+    const vector<std::size_t>& previous_colours) {
+  return update_colouring_impl(adjacency_data, previous_colours);
+}
+
+GraphColouringResult GraphColouringRoutines::update_colouring(
+    const CompressedAdjacencyData& adjacency_data,
+    const vector<std::size_t>& previous_colours) {
+  return update_colouring_impl(adjacency_data, previous_colours);
+}
+
 }  // namespace graphs
 }  // namespace tket
@@ -17,6 +17,7 @@
 #include <stack>
 
 #include "tket/Graphs/AdjacencyData.hpp"
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
 
 using std::map;
 using std::set;
@@ -26,8 +27,9 @@ using std::vector;
 namespace tket {
 namespace graphs {
 
-vector<set<std::size_t>> GraphRoutines::get_connected_components(
-    const AdjacencyData& adjacency_data) {
+template <class Adjacency>
+static vector<set<std::size_t>> get_connected_components_impl(
+    const Adjacency& adjacency_data) {
   set<std::size_t> vertices_seen;
   vector<set<std::size_t>> result;
   const std::size_t number_of_vertices =
@@ -65,5 +67,15 @@ vector<set<std::size_t>> GraphRoutines::get_connected_components(
   return result;
 }
 
+vector<set<std::size_t>> GraphRoutines::get_connected_components(
+    const AdjacencyData& adjacency_data) {
+  return get_connected_components_impl(adjacency_data);
+}
+
+vector<set<std::size_t>> GraphRoutines::get_connected_components(
+    const CompressedAdjacencyData& adjacency_data) {
+  return get_connected_components_impl(adjacency_data);
+}
+
 }  // namespace graphs
 }  // namespace tket
@@ -15,6 +15,7 @@
 #include "tket/Graphs/LargeCliquesResult.hpp"
 
 #include "tket/Graphs/AdjacencyData.hpp"
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
 
 using std::set;
 using std::size_t;
@@ -23,10 +24,12 @@ using std::vector;
 namespace tket {
 namespace graphs {
 
-LargeCliquesResult::LargeCliquesResult(
-    const AdjacencyData& adjacency_data,
+template <class Adjacency>
+static void fill_large_cliques(
+    const Adjacency& adjacency_data,
     const set<std::size_t>& vertices_in_component,
-    std::size_t internal_size_limit) {
+    std::size_t internal_size_limit, vector<set<std::size_t>>& cliques,
+    bool& cliques_are_definitely_max_size) {
   // ...and, before swapping, everything in here will have size one greater than
   // "result".
   vector<set<std::size_t>> extended_result;
@@ -64,7 +67,7 @@ LargeCliquesResult::LargeCliquesResult(
         // We have a new vertex; does it adjoin EVERY existing vertex?
         bool joins_every_vertex = true;
         for (std::size_t existing_v : clique) {
-          if (adjacency_data.get_neighbours(existing_v).count(new_v) == 0) {
+          if (!adjacency_data.edge_exists(existing_v, new_v)) {
             joins_every_vertex = false;
             break;
           }
@@ -93,5 +96,23 @@ LargeCliquesResult::LargeCliquesResult(
   cliques_are_definitely_max_size = false;
 }
 
+LargeCliquesResult::LargeCliquesResult(
+    const AdjacencyData& adjacency_data,
+    const set<std::size_t>& vertices_in_component,
+    std::size_t internal_size_limit) {
+  fill_large_cliques(
+      adjacency_data, vertices_in_component, internal_size_limit, cliques,
+      cliques_are_definitely_max_size);
+}
+
+LargeCliquesResult::LargeCliquesResult(
+    const CompressedAdjacencyData& adjacency_data,
+    const set<std::size_t>& vertices_in_component,
+    std::size_t internal_size_limit) {
+  fill_large_cliques(
+      adjacency_data, vertices_in_component, internal_size_limit, cliques,
+      cliques_are_definitely_max_size);
+}
+
 }  // namespace graphs
 }  // namespace tket
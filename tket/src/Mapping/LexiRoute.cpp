@@ -14,15 +14,24 @@
 
 #include "tket/Mapping/LexiRoute.hpp"
 
+#include <cmath>
+#include <limits>
+
 #include "tket/Mapping/MappingFrontier.hpp"
 #include "tket/Utils/Json.hpp"
+#include "tket/Utils/Trace.hpp"
 
 namespace tket {
 
 LexiRoute::LexiRoute(
     const ArchitecturePtr& _architecture,
-    MappingFrontier_ptr& _mapping_frontier)
-    : architecture_(_architecture), mapping_frontier_(_mapping_frontier) {
+    MappingFrontier_ptr& _mapping_frontier,
+    std::shared_ptr<LexiRouteSwapCache> _swap_cache,
+    std::shared_ptr<const LinkErrorDistances> _error_distances)
+    : architecture_(_architecture),
+      mapping_frontier_(_mapping_frontier),
+      swap_cache_(_swap_cache),
+      error_distances_(_error_distances) {
   // set initial logical->physical labelling
   for (const Qubit& qb : this->mapping_frontier_->circuit_.all_qubits()) {
     this->labelling_.insert({qb, qb});
@@ -771,6 +780,39 @@ void LexiRoute::remove_swaps_decreasing(swap_set_t& swaps) {
   }
 }
 
+void LexiRoute::remove_swaps_by_error(swap_set_t& swaps) {
+  std::vector<std::pair<Node, Node>> interactions;
+  for (const auto& p : this->interacting_uids_) {
+    Node first(this->labelling_[p.first]), second(this->labelling_[p.second]);
+    if (this->architecture_->node_exists(first) &&
+        this->architecture_->node_exists(second)) {
+      interactions.push_back({first, second});
+    }
+  }
+  std::map<swap_t, double> costs;
+  double min_cost = std::numeric_limits<double>::infinity();
+  for (const swap_t& swap : swaps) {
+    auto moved = [&swap](const Node& node) {
+      if (node == swap.first) return swap.second;
+      if (node == swap.second) return swap.first;
+      return node;
+    };
+    double cost =
+        this->error_distances_->get_swap_cost(swap.first, swap.second);
+    for (const std::pair<Node, Node>& interaction : interactions) {
+      cost += this->error_distances_->get_distance(
+          moved(interaction.first), moved(interaction.second));
+    }
+    costs.insert({swap, cost});
+    min_cost = std::min(min_cost, cost);
+  }
+  // allow for rounding in sums of logarithms
+  const double tolerance = 1e-12 * (1. + std::abs(min_cost));
+  for (const std::pair<const swap_t, double>& swap_cost : costs) {
+    if (swap_cost.second > min_cost + tolerance) swaps.erase(swap_cost.first);
+  }
+}
+
 bool LexiRoute::solve_labelling() {
   bool all_labelled = this->set_interacting_uids(
       AssignedOnly::No, CheckRoutingValidity::No, CheckLabellingValidity::Yes);
@@ -781,7 +823,10 @@ bool LexiRoute::solve_labelling() {
   return false;
 }
 
-bool LexiRoute::solve(unsigned lookahead) {
+bool LexiRoute::solve(
+    unsigned lookahead, unsigned n_threads,
+    std::optional<std::chrono::steady_clock::time_point> deadline) {
+  TKET_TRACE_SCOPE("LexiRoute::solve");
   // work out if valid
 
   bool all_labelled = this->set_interacting_uids(
@@ -798,9 +843,29 @@ bool LexiRoute::solve(unsigned lookahead) {
        this->mapping_frontier_->linear_boundary->get<TagKey>()) {
     copy.insert({pair.first, pair.second});
   }
-  swap_set_t candidate_swaps = this->get_candidate_swaps();
-  this->remove_swaps_decreasing(candidate_swaps);
+  // a frontier seen before under the same labelling reuses its swap
+  interacting_nodes_t frontier_nodes;
+  std::optional<swap_t> cached_swap;
+  if (this->swap_cache_) {
+    for (const auto& p : this->interacting_uids_) {
+      frontier_nodes.insert(
+          {Node(this->labelling_[p.first]), Node(this->labelling_[p.second])});
+    }
+    cached_swap = this->swap_cache_->find(frontier_nodes);
+  }
+  swap_set_t candidate_swaps;
+  if (cached_swap) {
+    candidate_swaps.insert(*cached_swap);
+  } else {
+    candidate_swaps = this->get_candidate_swaps();
+    this->remove_swaps_decreasing(candidate_swaps);
+    if (this->error_distances_) {
+      this->remove_swaps_by_error(candidate_swaps);
+    }
+  }
   TKET_ASSERT(candidate_swaps.size() != 0);
+  TKET_TRACE_COUNT("LexiRoute swap cache hits", cached_swap ? 1 : 0);
+  TKET_TRACE_HISTOGRAM("LexiRoute candidate swaps", candidate_swaps.size());
   // Only want to substitute a single swap
   // check next layer of interacting qubits and remove swaps until only one
   // lexicographically superior swap is left
@@ -809,6 +874,9 @@ bool LexiRoute::solve(unsigned lookahead) {
     // if 0, just take first swap rather than place
     if (this->interacting_uids_.size() == 0) {
       break;
+    } else if (deadline && std::chrono::steady_clock::now() > *deadline) {
+      // out of time, take the best swap so far
+      break;
     } else {
       interacting_nodes_t convert_uids;
       for (const auto& p : this->interacting_uids_) {
@@ -817,7 +885,7 @@ bool LexiRoute::solve(unsigned lookahead) {
              Node(this->labelling_[p.second])});
       }
       LexicographicalComparison lookahead_lc(this->architecture_, convert_uids);
-      lookahead_lc.remove_swaps_lexicographical(candidate_swaps);
+      lookahead_lc.remove_swaps_lexicographical(candidate_swaps, n_threads);
     }
     counter++;
     this->mapping_frontier_->advance_next_2qb_slice(lookahead);
@@ -832,6 +900,9 @@ bool LexiRoute::solve(unsigned lookahead) {
   --it;
 
   std::pair<Node, Node> chosen_swap = *it;
+  if (this->swap_cache_ && !cached_swap) {
+    this->swap_cache_->insert(frontier_nodes, chosen_swap);
+  }
   this->mapping_frontier_->set_linear_boundary(copy);
 
   this->set_interacting_uids(
@@ -16,20 +16,41 @@
 
 namespace tket {
 
-LexiRouteRoutingMethod::LexiRouteRoutingMethod(unsigned _max_depth)
-    : max_depth_(_max_depth){};
+LexiRouteRoutingMethod::LexiRouteRoutingMethod(
+    unsigned _max_depth, unsigned _n_threads, std::size_t _swap_cache_size)
+    : max_depth_(_max_depth),
+      n_threads_(_n_threads),
+      swap_cache_(
+          _swap_cache_size > 0
+              ? std::make_shared<LexiRouteSwapCache>(_swap_cache_size)
+              : nullptr){};
 
 std::pair<bool, unit_map_t> LexiRouteRoutingMethod::routing_method(
     MappingFrontier_ptr& mapping_frontier,
     const ArchitecturePtr& architecture) const {
-  LexiRoute lr(architecture, mapping_frontier);
-  return {lr.solve(this->max_depth_), {}};
+  if (this->n_threads_ > 1 && !architecture->get_distance_matrix()) {
+    architecture->precompute_distances(this->n_threads_);
+  }
+  LexiRoute lr(architecture, mapping_frontier, this->swap_cache_);
+  return {
+      lr.solve(
+          this->max_depth_, this->n_threads_, mapping_frontier->deadline_),
+      {}};
 }
 
 unsigned LexiRouteRoutingMethod::get_max_depth() const {
   return this->max_depth_;
 }
 
+unsigned LexiRouteRoutingMethod::get_n_threads() const {
+  return this->n_threads_;
+}
+
+std::shared_ptr<LexiRouteSwapCache> LexiRouteRoutingMethod::get_swap_cache()
+    const {
+  return this->swap_cache_;
+}
+
 nlohmann::json LexiRouteRoutingMethod::serialize() const {
   nlohmann::json j;
   j["depth"] = this->get_max_depth();
@@ -0,0 +1,81 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Mapping/LexiRouteSwapCache.hpp"
+
+#include <stdexcept>
+
+namespace tket {
+
+LexiRouteSwapCache::LexiRouteSwapCache(std::size_t capacity)
+    : capacity_(capacity), hits_(0), misses_(0) {
+  if (capacity == 0) {
+    throw std::invalid_argument("LexiRouteSwapCache capacity must be positive");
+  }
+}
+
+std::optional<swap_t> LexiRouteSwapCache::find(
+    const interacting_nodes_t& frontier) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = lookup_.find(frontier);
+  if (found == lookup_.end()) {
+    ++misses_;
+    return std::nullopt;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->second;
+}
+
+void LexiRouteSwapCache::insert(
+    const interacting_nodes_t& frontier, const swap_t& swap) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = lookup_.find(frontier);
+  if (found != lookup_.end()) {
+    found->second->second = swap;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return;
+  }
+  if (entries_.size() == capacity_) {
+    lookup_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.push_front({frontier, swap});
+  lookup_.insert({frontier, entries_.begin()});
+}
+
+std::size_t LexiRouteSwapCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+unsigned LexiRouteSwapCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+unsigned LexiRouteSwapCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+void LexiRouteSwapCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lookup_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+}  // namespace tket
@@ -14,13 +14,23 @@
 
 #include "tket/Mapping/LexicographicalComparison.hpp"
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <tkassert/Assert.hpp>
+
 namespace tket {
 
+// Fewer swaps than this per thread are not worth parallelising.
+static const std::size_t min_swaps_per_thread = 16;
+
 LexicographicalComparison::LexicographicalComparison(
     const ArchitecturePtr& _architecture,
     const interacting_nodes_t& _interacting_nodes)
-    : architecture_(_architecture), interacting_nodes_(_interacting_nodes) {
-  unsigned diameter = this->architecture_->get_diameter();
+    : architecture_(_architecture),
+      diameter_(_architecture->get_diameter()),
+      interacting_nodes_(_interacting_nodes) {
+  const unsigned diameter = this->diameter_;
 
   lexicographical_distances_t distance_vector(diameter, 0);
   for (const auto& interaction : this->interacting_nodes_) {
@@ -44,9 +54,7 @@ LexicographicalComparison::LexicographicalComparison(
 void LexicographicalComparison::increment_distances(
     lexicographical_distances_t& distances,
     const std::pair<Node, Node>& interaction, int increment) const {
-  const unsigned distances_index =
-      this->architecture_->get_diameter() -
-      this->architecture_->get_distance(interaction.first, interaction.second);
+  const unsigned distances_index = this->get_distances_index(interaction);
   if (distances[distances_index] == 0 && increment < 0) {
     throw LexicographicalComparisonError(
         "Negative increment value is larger than value held at index, "
@@ -63,44 +71,115 @@ LexicographicalComparison::get_lexicographical_distances() const {
   return this->lexicographical_distances;
 }
 
+unsigned LexicographicalComparison::get_distances_index(
+    const std::pair<Node, Node>& interaction) const {
+  return this->diameter_ - this->architecture_->get_distance(
+                               interaction.first, interaction.second);
+}
+
+void LexicographicalComparison::DistancesDelta::add(
+    const lexicographical_distances_t& base, unsigned index, int increment) {
+  unsigned i = 0;
+  while (i < this->size && this->changes[i].first < index) ++i;
+  if (i == this->size || this->changes[i].first != index) {
+    TKET_ASSERT(this->size < this->changes.size());
+    std::move_backward(
+        this->changes.begin() + i, this->changes.begin() + this->size,
+        this->changes.begin() + this->size + 1);
+    this->changes[i] = {index, 0};
+    ++this->size;
+  }
+  int& change = this->changes[i].second;
+  if (increment < 0 && int(base[index]) + change == 0) {
+    throw LexicographicalComparisonError(
+        "Negative increment value is larger than value held at index, "
+        "modification not allowed.");
+  }
+  change += increment;
+}
+
 /**
- * get_updated_distances
- * updates the "distance vector" (this->lexicographical_distances) to reflect
- * the distance between interacting logical qubits given that the logical qubits
- * present in "swap" have swapped physical qubits (Node)
+ * get_distances_delta
+ * finds the changes to the "distance vector" (this->lexicographical_distances)
+ * given that the logical qubits present in "swap" have swapped physical qubits
+ * (Node). Only the interactions of the two swapped nodes change, so this
+ * touches at most four entries.
  */
-lexicographical_distances_t LexicographicalComparison::get_updated_distances(
-    const swap_t& swap) const {
-  // make a copy of base lexicographical distances
-  lexicographical_distances_t copy = this->lexicographical_distances;
+LexicographicalComparison::DistancesDelta
+LexicographicalComparison::get_distances_delta(const swap_t& swap) const {
+  DistancesDelta delta;
   if (swap.first == swap.second) {
-    return copy;
+    return delta;
   }
+  const lexicographical_distances_t& base = this->lexicographical_distances;
   auto iq_it = this->interacting_nodes_.find(swap.first);
   // first condition => first node not interacting with self, so update
   // distances
   if (iq_it != this->interacting_nodes_.end()) {
     // update distances due to first swap node and qubit its interating with
     // (assuming swap)
-    Node interacting = iq_it->second;
+    const Node& interacting = iq_it->second;
     if (interacting != swap.second) {
-      increment_distances(copy, {swap.first, interacting}, -2);
+      delta.add(base, this->get_distances_index({swap.first, interacting}), -2);
       // updates distances due to second swap node and qubit first is
       // interacting with
-      increment_distances(copy, {swap.second, interacting}, 2);
+      delta.add(base, this->get_distances_index({swap.second, interacting}), 2);
     }
   }
   iq_it = this->interacting_nodes_.find(swap.second);
   // => second node not interacting with self
   if (iq_it != this->interacting_nodes_.end()) {
-    Node interacting = iq_it->second;
+    const Node& interacting = iq_it->second;
     if (interacting != swap.first) {
       // update distances due to second node and qubit its interacting with
-      increment_distances(copy, {swap.second, interacting}, -2);
+      delta.add(
+          base, this->get_distances_index({swap.second, interacting}), -2);
       // update distannces due to frist node and qubit second node is
       // interacting with
-      increment_distances(copy, {swap.first, interacting}, 2);
+      delta.add(base, this->get_distances_index({swap.first, interacting}), 2);
+    }
+  }
+  return delta;
+}
+
+int LexicographicalComparison::compare_deltas(
+    const DistancesDelta& a, const DistancesDelta& b) const {
+  // The updated vectors agree with the base vector, and so with each other,
+  // away from the changed indices, so compare at those in increasing order.
+  unsigned i = 0, j = 0;
+  while (i < a.size || j < b.size) {
+    unsigned index;
+    int change_a = 0, change_b = 0;
+    if (j == b.size ||
+        (i < a.size && a.changes[i].first <= b.changes[j].first)) {
+      index = a.changes[i].first;
+    } else {
+      index = b.changes[j].first;
+    }
+    if (i < a.size && a.changes[i].first == index) {
+      change_a = a.changes[i++].second;
     }
+    if (j < b.size && b.changes[j].first == index) {
+      change_b = b.changes[j++].second;
+    }
+    if (change_a != change_b) return (change_a < change_b) ? -1 : 1;
+  }
+  return 0;
+}
+
+/**
+ * get_updated_distances
+ * updates the "distance vector" (this->lexicographical_distances) to reflect
+ * the distance between interacting logical qubits given that the logical qubits
+ * present in "swap" have swapped physical qubits (Node)
+ */
+lexicographical_distances_t LexicographicalComparison::get_updated_distances(
+    const swap_t& swap) const {
+  // make a copy of base lexicographical distances
+  lexicographical_distances_t copy = this->lexicographical_distances;
+  const DistancesDelta delta = this->get_distances_delta(swap);
+  for (unsigned i = 0; i < delta.size; i++) {
+    copy[delta.changes[i].first] += delta.changes[i].second;
   }
   return copy;
 }
@@ -116,23 +195,55 @@ lexicographical_distances_t LexicographicalComparison::get_updated_distances(
  * Therefore swaps remaining in candidate_swaps after this process are
  * lexicographically identical for implied logical->physical qubit mapping and
  * interacting logical
+ * Distances are represented by their changes from
+ * this->lexicographical_distances, so each swap costs O(1) to score and
+ * compare rather than O(diameter).
  */
 void LexicographicalComparison::remove_swaps_lexicographical(
-    swap_set_t& candidate_swaps) const {
-  auto it = candidate_swaps.begin();
-  lexicographical_distances_t winning_distances =
-      this->get_updated_distances(*it);
-  swap_set_t preserved_swaps = {*it};
-  ++it;
-  for (; it != candidate_swaps.end(); ++it) {
-    lexicographical_distances_t comparison_distances =
-        this->get_updated_distances(*it);
+    swap_set_t& candidate_swaps, unsigned n_threads) const {
+  const std::vector<swap_t> swaps(
+      candidate_swaps.begin(), candidate_swaps.end());
+  std::vector<DistancesDelta> deltas(swaps.size());
+  // Distances are only read concurrently from a precomputed matrix, without
+  // touching the architecture's caches.
+  n_threads = std::min<std::size_t>(
+      n_threads, swaps.size() / min_swaps_per_thread);
+  if (n_threads > 1 && this->architecture_->get_distance_matrix()) {
+    std::vector<std::exception_ptr> errors(n_threads);
+    auto score = [&](unsigned first) {
+      try {
+        for (std::size_t i = first; i < swaps.size(); i += n_threads) {
+          deltas[i] = this->get_distances_delta(swaps[i]);
+        }
+      } catch (...) {
+        errors[first] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < n_threads; t++) {
+      threads.emplace_back(score, t);
+    }
+    score(0);
+    for (std::thread& thread : threads) thread.join();
+    for (const std::exception_ptr& error : errors) {
+      if (error) std::rethrow_exception(error);
+    }
+  } else {
+    for (std::size_t i = 0; i < swaps.size(); i++) {
+      deltas[i] = this->get_distances_delta(swaps[i]);
+    }
+  }
 
-    if (comparison_distances < winning_distances) {
-      preserved_swaps = {*it};
-      winning_distances = comparison_distances;
-    } else if (comparison_distances == winning_distances) {
-      preserved_swaps.insert(*it);
+  // Compare in the order of the set, as the serial search does.
+  std::size_t winner = 0;
+  swap_set_t preserved_swaps = {swaps[0]};
+  for (std::size_t i = 1; i < swaps.size(); i++) {
+    const int comparison = this->compare_deltas(deltas[i], deltas[winner]);
+    if (comparison < 0) {
+      preserved_swaps = {swaps[i]};
+      winner = i;
+    } else if (comparison == 0) {
+      preserved_swaps.insert(swaps[i]);
     }
   }
   candidate_swaps = preserved_swaps;
@@ -0,0 +1,85 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Mapping/LinkErrorDistances.hpp"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace tket {
+
+// Cost of a SWAP, as three gates, on a link with the given error.
+static double swap_cost(gate_error_t error) {
+  if (error >= 1.) return std::numeric_limits<double>::infinity();
+  return -3. * std::log1p(-error);
+}
+
+LinkErrorDistances::LinkErrorDistances(
+    const Architecture& architecture,
+    const DeviceCharacterisation& characterisation) {
+  std::vector<Node> nodes;
+  for (const Node& node : architecture.nodes()) {
+    index_.insert({node, nodes.size()});
+    nodes.push_back(node);
+  }
+  const unsigned n = nodes.size();
+  std::vector<std::vector<std::pair<unsigned, double>>> neighbours(n);
+  for (const Architecture::Connection& link :
+       architecture.get_all_edges_vec()) {
+    if (swap_costs_.contains(link)) continue;
+    const double cost = swap_cost(std::max(
+        characterisation.get_error(link),
+        characterisation.get_error({link.second, link.first})));
+    swap_costs_.insert({link, cost});
+    swap_costs_.insert({{link.second, link.first}, cost});
+    const unsigned i = index_.at(link.first), j = index_.at(link.second);
+    neighbours[i].push_back({j, cost});
+    neighbours[j].push_back({i, cost});
+  }
+
+  distances_.assign(n * n, std::numeric_limits<double>::infinity());
+  typedef std::pair<double, unsigned> entry_t;
+  for (unsigned source = 0; source < n; ++source) {
+    double* row = distances_.data() + source * n;
+    std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>>
+        queue;
+    row[source] = 0.;
+    queue.push({0., source});
+    while (!queue.empty()) {
+      const auto [distance, i] = queue.top();
+      queue.pop();
+      if (distance > row[i]) continue;
+      for (const auto& [j, cost] : neighbours[i]) {
+        if (distance + cost < row[j]) {
+          row[j] = distance + cost;
+          queue.push({row[j], j});
+        }
+      }
+    }
+  }
+}
+
+double LinkErrorDistances::get_swap_cost(
+    const Node& node0, const Node& node1) const {
+  return swap_costs_.at({node0, node1});
+}
+
+double LinkErrorDistances::get_distance(
+    const Node& node0, const Node& node1) const {
+  return distances_[index_.at(node0) * index_.size() + index_.at(node1)];
+}
+
+}  // namespace tket
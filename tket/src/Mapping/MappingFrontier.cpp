@@ -15,6 +15,7 @@
 #include "tket/Mapping/MappingFrontier.hpp"
 
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 #include "tket/Utils/UnitID.hpp"
 
 namespace tket {
@@ -187,6 +188,7 @@ MappingFrontier::MappingFrontier(const MappingFrontier& mapping_frontier)
   for (const Node& node : mapping_frontier.ancilla_nodes_) {
     this->ancilla_nodes_.insert(node);
   }
+  this->deadline_ = mapping_frontier.deadline_;
 }
 
 void MappingFrontier::advance_next_2qb_slice(unsigned max_advance) {
@@ -713,6 +715,8 @@ bool MappingFrontier::add_swap(const UnitID& uid_0, const UnitID& uid_1) {
   EdgeVec successors = this->circuit_.get_all_out_edges(swap_v);
   this->circuit_.dag[successors[0]].ports.first = 1;
   this->circuit_.dag[successors[1]].ports.first = 0;
+  this->circuit_.log_wire_change(this->circuit_.target(successors[0]));
+  this->circuit_.log_wire_change(this->circuit_.target(successors[1]));
 
   this->linear_boundary->replace(
       uid0_in_it, {uid_0, {this->circuit_.source(successors[1]), 0}});
@@ -892,8 +896,8 @@ void MappingFrontier::merge_ancilla(
      */
 
     // remove empty vertex wire, relabel dag vertices
-    this->circuit_.dag[back_v_in].op = get_op_ptr(OpType::noop);
-    this->circuit_.dag[back_v_out].op = get_op_ptr(OpType::noop);
+    this->circuit_.set_vertex_Op_ptr(back_v_in, get_op_ptr(OpType::noop));
+    this->circuit_.set_vertex_Op_ptr(back_v_out, get_op_ptr(OpType::noop));
 
     TKET_ASSERT(this->circuit_.n_in_edges(back_v_out) == 0);
     TKET_ASSERT(this->circuit_.n_out_edges(back_v_in) == 0);
@@ -1062,4 +1066,28 @@ bool MappingFrontier::valid_boundary_operation(
   return false;
 }
 
+std::size_t MappingFrontier::memory_usage() const {
+  std::size_t bytes = sizeof(MappingFrontier);
+  if (linear_boundary) {
+    bytes += memory::SHARED_CONTROL_OVERHEAD +
+             sizeof(unit_vertport_frontier_t) +
+             memory::multi_index_bytes(*linear_boundary, 2, 1);
+  }
+  if (boolean_boundary) {
+    bytes += memory::SHARED_CONTROL_OVERHEAD + sizeof(b_frontier_t) +
+             memory::multi_index_bytes(*boolean_boundary, 1, 1);
+    for (const std::pair<Bit, EdgeVec>& pair : *boolean_boundary) {
+      bytes += memory::container_bytes(pair.second);
+    }
+  }
+  bytes += memory::container_bytes(ancilla_nodes_) +
+           memory::container_bytes(reassignable_nodes_);
+  if (bimaps_) {
+    bytes += memory::SHARED_CONTROL_OVERHEAD + sizeof(unit_bimaps_t) +
+             memory::multi_index_bytes(bimaps_->initial, 2) +
+             memory::multi_index_bytes(bimaps_->final, 2);
+  }
+  return bytes;
+}
+
 }  // namespace tket
\ No newline at end of file
@@ -14,16 +14,30 @@
 
 #include "tket/Mapping/MappingManager.hpp"
 
+#include <exception>
+#include <memory>
+#include <thread>
+
 #include "tket/Architecture/BestTsaWithArch.hpp"
+#include "tket/Mapping/LexiRouteRoutingMethod.hpp"
 
 namespace tket {
 
+typedef std::chrono::steady_clock Clock;
+
+// Thrown by route_frontier once abandon_after_ has passed.
+class MappingManagerTimeout : public MappingManagerError {
+ public:
+  MappingManagerTimeout()
+      : MappingManagerError("Routing exceeded its time budget.") {}
+};
+
 MappingManager::MappingManager(const ArchitecturePtr& _architecture)
     : architecture_(_architecture) {}
 
 bool MappingManager::route_circuit(
-    Circuit& circuit,
-    const std::vector<RoutingMethodPtr>& routing_methods) const {
+    Circuit& circuit, const std::vector<RoutingMethodPtr>& routing_methods,
+    unsigned window_slices, unsigned timeout) const {
   // we make bimaps if not present
   unit_bimaps_t maps;
   for (const Qubit& qubit : circuit.all_qubits()) {
@@ -31,12 +45,14 @@ bool MappingManager::route_circuit(
     maps.final.left.insert({qubit, qubit});
   }
   return this->route_circuit_with_maps(
-      circuit, routing_methods, std::make_shared<unit_bimaps_t>(maps));
+      circuit, routing_methods, std::make_shared<unit_bimaps_t>(maps),
+      window_slices, timeout);
 }
 
 bool MappingManager::route_circuit_with_maps(
     Circuit& circuit, const std::vector<RoutingMethodPtr>& routing_methods,
-    std::shared_ptr<unit_bimaps_t> maps) const {
+    std::shared_ptr<unit_bimaps_t> maps, unsigned window_slices,
+    unsigned timeout) const {
   if (circuit.n_qubits() > this->architecture_->n_nodes()) {
     std::string error_string =
         "Circuit has" + std::to_string(circuit.n_qubits()) +
@@ -46,6 +62,14 @@ bool MappingManager::route_circuit_with_maps(
         "qubits than the Architecture.";
     throw MappingManagerError(error_string);
   }
+  std::optional<Clock::time_point> deadline;
+  if (timeout > 0) {
+    deadline = Clock::now() + std::chrono::milliseconds(timeout);
+  }
+  if (window_slices > 0) {
+    return this->route_circuit_in_windows(
+        circuit, routing_methods, maps, window_slices, deadline);
+  }
 
   /**
    * Before mapping we find the set of Circuit UnitID that are both
@@ -135,9 +159,18 @@ bool MappingManager::route_circuit_with_maps(
     mapping_frontier = std::make_shared<MappingFrontier>(circuit);
   }
   mapping_frontier->reassignable_nodes_ = reassignable_nodes;
+  mapping_frontier->deadline_ = deadline;
   // updates routed/un-routed boundary
   mapping_frontier->advance_frontier_boundary(this->architecture_);
 
+  bool circuit_modified =
+      this->route_frontier(mapping_frontier, routing_methods);
+  return (circuit_modified || modify_at_start);
+}
+
+bool MappingManager::route_frontier(
+    MappingFrontier_ptr mapping_frontier,
+    const std::vector<RoutingMethodPtr>& routing_methods) const {
   /**
    * Criteria for Routing being finished.
    * Each linear edge has reached end of Circuit.
@@ -156,14 +189,33 @@ bool MappingManager::route_circuit_with_maps(
     return true;
   };
 
+  // Once past the frontier's deadline, SWAPs are chosen by LexiRoute with no
+  // lookahead where possible, falling back to the given methods otherwise.
+  std::vector<RoutingMethodPtr> fallback_methods;
+  const std::vector<RoutingMethodPtr>* methods = &routing_methods;
+
+  // Constructed when first needed, then reused for every permutation.
+  std::unique_ptr<ReusableBestTsaWithArch> token_swapping;
+
   bool circuit_modified = !check_finish();
   while (!check_finish()) {
+    if (this->abandon_after_ && Clock::now() > *this->abandon_after_) {
+      throw MappingManagerTimeout();
+    }
+    if (fallback_methods.empty() && mapping_frontier->deadline_ &&
+        Clock::now() > *mapping_frontier->deadline_) {
+      fallback_methods.push_back(std::make_shared<LexiRouteRoutingMethod>(0));
+      fallback_methods.insert(
+          fallback_methods.end(), routing_methods.begin(),
+          routing_methods.end());
+      methods = &fallback_methods;
+    }
     // The order methods are passed in std::vector<RoutingMethod> is
     // the order they are run
     // If a method performs better but only on specific subcircuits,
     // rank it earlier in the passed vector
     bool valid_methods = false;
-    for (const auto& rm : routing_methods) {
+    for (const auto& rm : *methods) {
       // true => can use held routing method
       std::pair<bool, unit_map_t> bool_map =
           rm->routing_method(mapping_frontier, this->architecture_);
@@ -174,8 +226,12 @@ bool MappingManager::route_circuit_with_maps(
           for (const auto& x : bool_map.second) {
             node_map.insert({Node(x.first), Node(x.second)});
           }
+          if (!token_swapping) {
+            token_swapping = std::make_unique<ReusableBestTsaWithArch>(
+                *this->architecture_);
+          }
           for (const std::pair<Node, Node>& swap :
-               BestTsaWithArch::get_swaps(*this->architecture_, node_map)) {
+               token_swapping->get_swaps(node_map)) {
             mapping_frontier->add_swap(swap.first, swap.second);
           }
         }
@@ -189,6 +245,304 @@ bool MappingManager::route_circuit_with_maps(
     // find next routed/unrouted boundary given updates
     mapping_frontier->advance_frontier_boundary(this->architecture_);
   }
-  return (circuit_modified || modify_at_start);
+  return circuit_modified;
+}
+
+/**
+ * Vertices in the first n_slices slices of circ, in causal order.
+ */
+static std::vector<Vertex> get_window(const Circuit& circ, unsigned n_slices) {
+  std::shared_ptr<unit_frontier_t> u_frontier =
+      std::make_shared<unit_frontier_t>();
+  std::shared_ptr<b_frontier_t> b_frontier = std::make_shared<b_frontier_t>();
+  for (const Qubit& qubit : circ.all_qubits()) {
+    u_frontier->insert({qubit, circ.get_nth_out_edge(circ.get_in(qubit), 0)});
+  }
+  for (const Bit& bit : circ.all_bits()) {
+    Vertex in = circ.get_in(bit);
+    b_frontier->insert({bit, circ.get_nth_b_out_bundle(in, 0)});
+    u_frontier->insert({bit, circ.get_nth_out_edge(in, 0)});
+  }
+  std::vector<Vertex> window;
+  for (unsigned i = 0; i < n_slices; ++i) {
+    CutFrontier cut = circ.next_cut(u_frontier, b_frontier);
+    if (cut.slice->empty()) break;
+    window.insert(window.end(), cut.slice->begin(), cut.slice->end());
+    u_frontier = cut.u_frontier;
+    b_frontier = cut.b_frontier;
+  }
+  return window;
+}
+
+bool MappingManager::route_circuit_in_windows(
+    Circuit& circuit, const std::vector<RoutingMethodPtr>& routing_methods,
+    std::shared_ptr<unit_bimaps_t> maps, unsigned window_slices,
+    std::optional<std::chrono::steady_clock::time_point> deadline) const {
+  if (maps->initial.empty() && maps->final.empty()) {
+    for (const Qubit& qubit : circuit.all_qubits()) {
+      maps->initial.insert({qubit, qubit});
+      maps->final.insert({qubit, qubit});
+    }
+  }
+  // Each Circuit Qubit is labelled by its initial Node; find the logical
+  // Qubit it corresponds to, so that its current Node can be looked up in
+  // the final map as routing proceeds.
+  std::map<Qubit, UnitID> logical;
+  for (const Qubit& qubit : circuit.all_qubits()) {
+    if (!this->architecture_->node_exists(Node(qubit))) {
+      throw MappingManagerError(
+          "Windowed routing requires a placed Circuit, but " + qubit.repr() +
+          " is not an Architecture Node.");
+    }
+    auto it = maps->initial.right.find(qubit);
+    if (it == maps->initial.right.end() ||
+        maps->final.right.find(qubit) == maps->final.right.end()) {
+      throw MappingManagerError(
+          "Uid " + qubit.repr() + " not found in initial and final maps.");
+    }
+    logical.insert({qubit, it->second});
+  }
+
+  /**
+   * Windows of slices are moved from the front of circuit to their own
+   * Circuit, which is routed and then appended to routed. Each vertex is
+   * held by exactly one of these, so the DAG is never held twice and
+   * MappingFrontier only ever sees one window.
+   * Wires in routed are labelled by physical Node, so each window acts on
+   * the Node each logical Qubit has been permuted to so far.
+   */
+  Circuit routed;
+  std::optional<std::string> name = circuit.get_name();
+  if (name) routed.set_name(*name);
+  for (const Qubit& qubit : circuit.all_qubits()) {
+    routed.add_qubit(qubit);
+    if (circuit.is_created(qubit)) routed.qubit_create(qubit);
+  }
+  for (const Bit& bit : circuit.all_bits()) {
+    routed.add_bit(bit);
+  }
+
+  bool circuit_modified = false;
+  std::vector<Vertex> window_vertices = get_window(circuit, window_slices);
+  while (!window_vertices.empty()) {
+    Circuit window;
+    for (const Qubit& qubit : routed.all_qubits()) window.add_qubit(qubit);
+    for (const Bit& bit : circuit.all_bits()) window.add_bit(bit);
+    for (const Vertex& v : window_vertices) {
+      // Every predecessor of v has already been removed, so each in edge
+      // comes from an Input vertex.
+      std::vector<UnitID> args;
+      for (const Edge& e : circuit.get_in_edges(v)) {
+        UnitID unit = circuit.get_id_from_in(circuit.source(e));
+        if (unit.type() == UnitType::Qubit) {
+          unit = maps->final.left.at(logical.at(Qubit(unit)));
+        }
+        args.push_back(unit);
+      }
+      window.add_op<UnitID>(
+          circuit.get_Op_ptr_from_Vertex(v), args,
+          circuit.get_opgroup_from_Vertex(v));
+      circuit.remove_vertex(
+          v, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::Yes);
+    }
+    {
+      MappingFrontier_ptr mapping_frontier =
+          std::make_shared<MappingFrontier>(window, maps);
+      mapping_frontier->deadline_ = deadline;
+      mapping_frontier->advance_frontier_boundary(this->architecture_);
+      if (this->route_frontier(mapping_frontier, routing_methods)) {
+        circuit_modified = true;
+      }
+    }
+    routed.append(window);
+    window_vertices = get_window(circuit, window_slices);
+  }
+  // Anything left has no Quantum or Classical edges, e.g. Phase
+  VertexVec remaining;
+  BGL_FORALL_VERTICES(v, circuit.dag, DAG) {
+    if (!circuit.detect_boundary_Op(v)) remaining.push_back(v);
+  }
+  for (const Vertex& v : remaining) {
+    routed.add_op<UnitID>(
+        circuit.get_Op_ptr_from_Vertex(v), {},
+        circuit.get_opgroup_from_Vertex(v));
+  }
+  for (const Qubit& qubit : circuit.all_qubits()) {
+    if (circuit.is_discarded(qubit)) {
+      routed.qubit_discard(Qubit(maps->final.left.at(logical.at(qubit))));
+    }
+  }
+  routed.add_phase(circuit.get_phase());
+  circuit = std::move(routed);
+  return circuit_modified;
+}
+
+// Number of SWAP and BRIDGE gates in circ.
+static unsigned count_routing_gates(const Circuit& circ) {
+  return circ.count_gates(OpType::SWAP) + circ.count_gates(OpType::BRIDGE);
+}
+
+unsigned MappingManager::route_circuit_portfolio(
+    Circuit& circuit,
+    const std::vector<std::vector<RoutingMethodPtr>>& portfolio,
+    std::shared_ptr<unit_bimaps_t> maps, unsigned timeout) const {
+  if (portfolio.empty()) {
+    throw MappingManagerError("Routing portfolio is empty.");
+  }
+  const unsigned n_jobs = portfolio.size();
+  std::vector<Circuit> circuits(n_jobs, circuit);
+  std::vector<std::shared_ptr<unit_bimaps_t>> job_maps(n_jobs);
+  std::vector<std::exception_ptr> errors(n_jobs);
+  std::optional<Clock::time_point> abandon_after;
+  if (timeout > 0) {
+    abandon_after = Clock::now() + std::chrono::milliseconds(timeout);
+  }
+  auto job = [&](unsigned i) {
+    try {
+      // An Architecture caches distances as they are queried, so can only
+      // be shared once frozen.
+      ArchitecturePtr architecture =
+          this->architecture_->is_frozen()
+              ? this->architecture_
+              : std::make_shared<Architecture>(*this->architecture_);
+      MappingManager mm(architecture);
+      mm.abandon_after_ = abandon_after;
+      job_maps[i] = std::make_shared<unit_bimaps_t>(*maps);
+      mm.route_circuit_with_maps(circuits[i], portfolio[i], job_maps[i]);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(n_jobs);
+  for (unsigned i = 0; i < n_jobs; ++i) threads.emplace_back(job, i);
+  for (std::thread& thread : threads) thread.join();
+
+  std::optional<unsigned> best;
+  unsigned best_gates = 0, best_depth = 0;
+  for (unsigned i = 0; i < n_jobs; ++i) {
+    if (errors[i]) continue;
+    unsigned gates = count_routing_gates(circuits[i]);
+    unsigned depth = circuits[i].depth();
+    if (!best || gates < best_gates ||
+        (gates == best_gates && depth < best_depth)) {
+      best = i;
+      best_gates = gates;
+      best_depth = depth;
+    }
+  }
+  if (!best) {
+    // Report the first failure that is not a timeout, if any.
+    for (const std::exception_ptr& error : errors) {
+      try {
+        std::rethrow_exception(error);
+      } catch (const MappingManagerTimeout&) {
+      }
+    }
+    throw MappingManagerError(
+        "No configuration in the routing portfolio routed the Circuit within "
+        "its time budget.");
+  }
+  circuit = std::move(circuits[*best]);
+  *maps = *job_maps[*best];
+  return *best;
+}
+
+/**
+ * The commands of circ in reverse order, on the same units.
+ * Only the order of interactions matters for routing, so ops are not
+ * inverted.
+ */
+static Circuit reversed_circuit(const Circuit& circ) {
+  Circuit reversed = circ;
+  VertexList bin;
+  BGL_FORALL_VERTICES(v, reversed.dag, DAG) {
+    if (!reversed.detect_boundary_Op(v)) bin.push_back(v);
+  }
+  reversed.remove_vertices(
+      bin, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::Yes);
+  std::vector<Command> commands = circ.get_commands();
+  for (auto it = commands.rbegin(); it != commands.rend(); ++it) {
+    reversed.add_op<UnitID>(
+        it->get_op_ptr(), it->get_args(), it->get_opgroup());
+  }
+  return reversed;
+}
+
+bool MappingManager::route_circuit_bidirectional(
+    Circuit& circuit, const std::vector<RoutingMethodPtr>& routing_methods,
+    std::shared_ptr<unit_bimaps_t> maps, unsigned n_sweeps) const {
+  if (maps->initial.empty() && maps->final.empty()) {
+    for (const Qubit& qubit : circuit.all_qubits()) {
+      maps->initial.insert({qubit, qubit});
+      maps->final.insert({qubit, qubit});
+    }
+  }
+  // Key of each Circuit Qubit in the maps, so that the Node it finishes a
+  // forward sweep on can be looked up.
+  std::map<Qubit, UnitID> keys;
+  for (const Qubit& qubit : circuit.all_qubits()) {
+    auto it = maps->final.right.find(qubit);
+    if (it == maps->final.right.end()) {
+      throw MappingManagerError(
+          "Uid " + qubit.repr() + " not found in final map.");
+    }
+    keys.insert({qubit, it->second});
+  }
+  const Circuit reversed = reversed_circuit(circuit);
+
+  // Where each Circuit Qubit starts the next forward sweep.
+  std::map<Qubit, Qubit> placement;
+  Circuit best;
+  std::shared_ptr<unit_bimaps_t> best_maps;
+  bool best_modified = false;
+  unsigned best_gates = 0, best_depth = 0;
+  for (unsigned sweep = 0;; ++sweep) {
+    Circuit forward = circuit;
+    std::shared_ptr<unit_bimaps_t> forward_maps =
+        std::make_shared<unit_bimaps_t>(*maps);
+    bool modified = forward.rename_units(placement);
+    update_maps(forward_maps, placement, placement);
+    modified |=
+        this->route_circuit_with_maps(forward, routing_methods, forward_maps);
+    unsigned gates = count_routing_gates(forward);
+    unsigned depth = forward.depth();
+    if (!best_maps || gates < best_gates ||
+        (gates == best_gates && depth < best_depth)) {
+      best = forward;
+      best_maps = forward_maps;
+      best_modified = modified;
+      best_gates = gates;
+      best_depth = depth;
+    }
+    if (sweep == n_sweeps || best_gates == 0) break;
+
+    // Route the reversed Circuit from where the forward sweep finished.
+    std::map<Qubit, Qubit> finish;
+    for (const std::pair<const Qubit, UnitID>& qubit_key : keys) {
+      finish.insert(
+          {qubit_key.first,
+           Qubit(forward_maps->final.left.at(qubit_key.second))});
+    }
+    Circuit backward = reversed;
+    backward.rename_units(finish);
+    std::shared_ptr<unit_bimaps_t> backward_maps =
+        std::make_shared<unit_bimaps_t>();
+    for (const Qubit& qubit : backward.all_qubits()) {
+      backward_maps->initial.insert({qubit, qubit});
+      backward_maps->final.insert({qubit, qubit});
+    }
+    this->route_circuit_with_maps(backward, routing_methods, backward_maps);
+    placement.clear();
+    for (const std::pair<const Qubit, Qubit>& qubit_finish : finish) {
+      Qubit start(backward_maps->final.left.at(qubit_finish.second));
+      if (start != qubit_finish.first) {
+        placement.insert({qubit_finish.first, start});
+      }
+    }
+  }
+  circuit = std::move(best);
+  *maps = *best_maps;
+  return best_modified;
 }
-}  // namespace tket
\ No newline at end of file
+}  // namespace tket
@@ -14,6 +14,10 @@
 
 #include "tket/Mapping/MultiGateReorder.hpp"
 
+#include <functional>
+#include <limits>
+#include <queue>
+
 #include "tket/Circuit/DAGDefs.hpp"
 #include "tket/Mapping/MappingFrontier.hpp"
 
@@ -287,14 +291,217 @@ bool MultiGateReorder::solve(unsigned max_depth, unsigned max_size) {
   return modification_made;
 }
 
+namespace {
+// Summary of the operations left in place on a qubit between the point where
+// moved gates are inserted and the vertices examined so far
+enum class WireState {
+  // no operations
+  Empty,
+  // only operations commuting with every Pauli
+  Identity,
+  // operations commuting with one Pauli (and the identity)
+  Single,
+  // gates commuting with different Paulis
+  Mixed,
+  // some operation that commutes with nothing
+  Blocked
+};
+
+struct Wire {
+  // edge into which the next moved gate is inserted
+  Edge insert_edge;
+  WireState state = WireState::Empty;
+  // the Pauli when state is Single
+  Pauli colour = Pauli::I;
+};
+}  // namespace
+
+// Records an operation left in place on the wire
+static void add_to_wire(
+    Wire &wire, bool is_gate, const std::optional<Pauli> &colour) {
+  if (!is_gate || !colour) {
+    wire.state = WireState::Blocked;
+    return;
+  }
+  switch (wire.state) {
+    case WireState::Empty:
+    case WireState::Identity:
+      if (*colour == Pauli::I) {
+        wire.state = WireState::Identity;
+      } else {
+        wire.state = WireState::Single;
+        wire.colour = *colour;
+      }
+      return;
+    case WireState::Single:
+      if (*colour != Pauli::I && *colour != wire.colour) {
+        wire.state = WireState::Mixed;
+      }
+      return;
+    default:
+      return;
+  }
+}
+
+// Whether a gate port of the given colour commutes with every operation left
+// in place on the wire, as Gate::commutes_with_basis
+static bool commutes_through_wire(
+    const Wire &wire, const std::optional<Pauli> &colour) {
+  switch (wire.state) {
+    case WireState::Empty:
+      return true;
+    case WireState::Identity:
+      return colour.has_value();
+    case WireState::Single:
+      return colour && (*colour == Pauli::I || *colour == wire.colour);
+    case WireState::Mixed:
+      return colour == Pauli::I;
+    default:
+      return false;
+  }
+}
+
+bool MultiGateReorder::solve_scheduled(unsigned max_size) {
+  Circuit &circ = this->mapping_frontier_->circuit_;
+  // Quantum wires by unit
+  std::map<UnitID, Wire> wires;
+  // Unit on each linear in-port of the vertices reached
+  std::map<VertPort, UnitID> in_units;
+  // Number of in-edges of each vertex reached not yet crossed
+  std::map<Vertex, unsigned> waiting;
+  // Ready-list of (distance, index into ready_vertices)
+  typedef std::pair<unsigned, std::size_t> entry_t;
+  std::priority_queue<entry_t, std::vector<entry_t>, std::greater<entry_t>>
+      ready;
+  std::vector<Vertex> ready_vertices;
+
+  auto get_nodes = [&](const Vertex &v) {
+    std::vector<Node> nodes;
+    for (port_t port = 0; port < circ.n_ports(v); ++port) {
+      nodes.push_back(Node(in_units.at({v, port})));
+    }
+    return nodes;
+  };
+  // Greatest distance between consecutive nodes of a multi-qubit gate
+  auto distance = [&](const Vertex &v) {
+    if (!is_multiq_quantum_gate(circ, v)) return 0u;
+    const std::vector<Node> nodes = get_nodes(v);
+    unsigned d = 0;
+    for (unsigned i = 1; i < nodes.size(); ++i) {
+      if (!this->architecture_->node_exists(nodes[i - 1]) ||
+          !this->architecture_->node_exists(nodes[i])) {
+        return std::numeric_limits<unsigned>::max();
+      }
+      try {
+        d = std::max(
+            d, this->architecture_->get_distance(nodes[i - 1], nodes[i]));
+      } catch (const NodesNotConnected &) {
+        return std::numeric_limits<unsigned>::max();
+      }
+    }
+    return d;
+  };
+  auto cross = [&](const Edge &e) {
+    const Vertex v = circ.target(e);
+    auto it = waiting.insert({v, circ.n_in_edges(v)}).first;
+    if (--it->second == 0) {
+      ready.push({distance(v), ready_vertices.size()});
+      ready_vertices.push_back(v);
+    }
+  };
+
+  std::shared_ptr<unit_frontier_t> frontier_edges =
+      frontier_convert_vertport_to_edge(
+          circ, this->mapping_frontier_->linear_boundary);
+  for (const std::pair<UnitID, Edge> &pair :
+       frontier_edges->get<TagKey>()) {
+    if (circ.get_edgetype(pair.second) == EdgeType::Quantum) {
+      wires.insert({pair.first, {pair.second}});
+    }
+    in_units.insert(
+        {{circ.target(pair.second), circ.get_target_port(pair.second)},
+         pair.first});
+  }
+  for (const std::pair<UnitID, Edge> &pair :
+       frontier_edges->get<TagKey>()) {
+    cross(pair.second);
+  }
+  for (const std::pair<Bit, EdgeVec> &pair :
+       this->mapping_frontier_->boolean_boundary->get<TagKey>()) {
+    for (const Edge &e : pair.second) cross(e);
+  }
+
+  bool modification_made = false;
+  unsigned n_examined = 0;
+  while (!ready.empty() && n_examined < max_size) {
+    const Vertex v = ready_vertices[ready.top().second];
+    ready.pop();
+    if (circ.detect_final_Op(v)) continue;
+    ++n_examined;
+
+    bool move = false;
+    if (is_multiq_quantum_gate(circ, v) &&
+        this->mapping_frontier_->valid_boundary_operation(
+            this->architecture_, circ.get_Op_ptr_from_Vertex(v),
+            get_nodes(v))) {
+      move = true;
+      for (port_t port = 0; port < circ.n_ports(v) && move; ++port) {
+        move = commutes_through_wire(
+            wires.at(in_units.at({v, port})),
+            circ.commuting_basis(v, PortType::Target, port));
+      }
+    }
+
+    // Successors are released before any rewiring, which leaves their
+    // in-ports, and so the units on them, unchanged
+    for (const Edge &e : circ.get_all_out_edges(v)) {
+      if (circ.get_edgetype(e) != EdgeType::Boolean) {
+        in_units.insert(
+            {{circ.target(e), circ.get_target_port(e)},
+             in_units.at({v, circ.get_source_port(e)})});
+      }
+      cross(e);
+    }
+
+    if (move) {
+      EdgeVec src_edges = circ.get_in_edges(v);
+      EdgeVec dest_edges;
+      for (const Edge &e : src_edges) {
+        dest_edges.push_back(
+            wires.at(in_units.at({v, circ.get_target_port(e)})).insert_edge);
+      }
+      partial_rewire(v, circ, src_edges, dest_edges);
+      for (port_t port = 0; port < circ.n_ports(v); ++port) {
+        wires.at(in_units.at({v, port})).insert_edge =
+            circ.get_nth_out_edge(v, port);
+      }
+      modification_made = true;
+    } else {
+      const bool is_gate =
+          circ.get_Op_ptr_from_Vertex(v)->get_desc().is_gate();
+      for (const Edge &e : circ.get_in_edges_of_type(v, EdgeType::Quantum)) {
+        const port_t port = circ.get_target_port(e);
+        add_to_wire(
+            wires.at(in_units.at({v, port})), is_gate,
+            is_gate ? circ.commuting_basis(v, PortType::Target, port)
+                    : std::nullopt);
+      }
+    }
+  }
+  return modification_made;
+}
+
 MultiGateReorderRoutingMethod::MultiGateReorderRoutingMethod(
-    unsigned _max_depth, unsigned _max_size)
-    : max_depth_(_max_depth), max_size_(_max_size) {}
+    unsigned _max_depth, unsigned _max_size, bool _scheduled)
+    : max_depth_(_max_depth), max_size_(_max_size), scheduled_(_scheduled) {}
 
 std::pair<bool, unit_map_t> MultiGateReorderRoutingMethod::routing_method(
     MappingFrontier_ptr &mapping_frontier,
     const ArchitecturePtr &architecture) const {
   MultiGateReorder mr(architecture, mapping_frontier);
+  if (this->scheduled_) {
+    return {mr.solve_scheduled(this->max_size_), {}};
+  }
   return {mr.solve(this->max_depth_, this->max_size_), {}};
 }
 
@@ -306,10 +513,15 @@ unsigned MultiGateReorderRoutingMethod::get_max_size() const {
   return this->max_size_;
 }
 
+bool MultiGateReorderRoutingMethod::is_scheduled() const {
+  return this->scheduled_;
+}
+
 nlohmann::json MultiGateReorderRoutingMethod::serialize() const {
   nlohmann::json j;
   j["depth"] = this->max_depth_;
   j["size"] = this->max_size_;
+  if (this->scheduled_) j["scheduled"] = true;
   j["name"] = "MultiGateReorderRoutingMethod";
   return j;
 }
@@ -317,7 +529,8 @@ nlohmann::json MultiGateReorderRoutingMethod::serialize() const {
 MultiGateReorderRoutingMethod MultiGateReorderRoutingMethod::deserialize(
     const nlohmann::json &j) {
   return MultiGateReorderRoutingMethod(
-      j.at("depth").get<unsigned>(), j.at("size").get<unsigned>());
+      j.at("depth").get<unsigned>(), j.at("size").get<unsigned>(),
+      j.contains("scheduled") && j.at("scheduled").get<bool>());
 }
 
 }  // namespace tket
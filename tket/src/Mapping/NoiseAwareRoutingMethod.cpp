@@ -0,0 +1,67 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Mapping/NoiseAwareRoutingMethod.hpp"
+
+namespace tket {
+
+NoiseAwareRoutingMethod::NoiseAwareRoutingMethod(
+    const DeviceCharacterisation& _characterisation, unsigned _max_depth)
+    : characterisation_(_characterisation),
+      max_depth_(_max_depth),
+      distances_cache_(std::make_shared<DistancesCache>()) {}
+
+std::pair<bool, unit_map_t> NoiseAwareRoutingMethod::routing_method(
+    MappingFrontier_ptr& mapping_frontier,
+    const ArchitecturePtr& architecture) const {
+  std::shared_ptr<const LinkErrorDistances> distances;
+  {
+    DistancesCache& cache = *this->distances_cache_;
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    if (cache.architecture != architecture) {
+      cache.distances = std::make_shared<const LinkErrorDistances>(
+          *architecture, this->characterisation_);
+      cache.architecture = architecture;
+    }
+    distances = cache.distances;
+  }
+  LexiRoute lr(architecture, mapping_frontier, nullptr, distances);
+  return {lr.solve(this->max_depth_, 1, mapping_frontier->deadline_), {}};
+}
+
+unsigned NoiseAwareRoutingMethod::get_max_depth() const {
+  return this->max_depth_;
+}
+
+const DeviceCharacterisation& NoiseAwareRoutingMethod::get_characterisation()
+    const {
+  return this->characterisation_;
+}
+
+nlohmann::json NoiseAwareRoutingMethod::serialize() const {
+  nlohmann::json j;
+  j["depth"] = this->get_max_depth();
+  j["characterisation"] = this->characterisation_;
+  j["name"] = "NoiseAwareRoutingMethod";
+  return j;
+}
+
+NoiseAwareRoutingMethod NoiseAwareRoutingMethod::deserialize(
+    const nlohmann::json& j) {
+  return NoiseAwareRoutingMethod(
+      j.at("characterisation").get<DeviceCharacterisation>(),
+      j.at("depth").get<unsigned>());
+}
+
+}  // namespace tket
@@ -50,6 +50,9 @@ void from_json(const nlohmann::json& j, std::vector<RoutingMethodPtr>& rmp_v) {
     } else if (name == "MultiGateReorderRoutingMethod") {
       rmp_v.push_back(std::make_shared<MultiGateReorderRoutingMethod>(
           MultiGateReorderRoutingMethod::deserialize(c)));
+    } else if (name == "NoiseAwareRoutingMethod") {
+      rmp_v.push_back(std::make_shared<NoiseAwareRoutingMethod>(
+          NoiseAwareRoutingMethod::deserialize(c)));
     } else if (name == "BoxDecompositionRoutingMethod") {
       rmp_v.push_back(std::make_shared<BoxDecompositionRoutingMethod>(
           BoxDecompositionRoutingMethod::deserialize(c)));
@@ -14,80 +14,276 @@
 
 #include "tket/Mapping/Verification.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <thread>
+
+#include "tket/OpType/OpTypeFunctions.hpp"
+
 namespace tket {
+
+// Below this many checks per thread, threads cost more than they save
+static const std::size_t min_checks_per_thread = 4096;
+
+ConnectivityMatrix::ConnectivityMatrix(const Architecture &arch) {
+  for (const Node &node : arch.get_all_nodes_vec()) {
+    node_ids_.insert({node, node_ids_.size()});
+  }
+  const unsigned n = node_ids_.size();
+  n_words_ = (n + 63) / 64;
+  edges_.assign(n * n_words_, 0);
+  adjacent_.assign(n * n_words_, 0);
+  auto set = [this](std::vector<std::uint64_t> &bits, unsigned i, unsigned j) {
+    bits[i * n_words_ + j / 64] |= std::uint64_t{1} << (j % 64);
+  };
+  for (const Architecture::Connection &link : arch.get_all_edges_vec()) {
+    const unsigned i = node_ids_.at(link.first);
+    const unsigned j = node_ids_.at(link.second);
+    set(edges_, i, j);
+    set(adjacent_, i, j);
+    set(adjacent_, j, i);
+  }
+}
+
+std::optional<unsigned> ConnectivityMatrix::node_id(const Node &node) const {
+  auto it = node_ids_.find(node);
+  if (it == node_ids_.end()) return std::nullopt;
+  return it->second;
+}
+
+namespace {
+// A multi-qubit operation to check, on node ids
+struct NodeCheck {
+  enum class Kind : std::uint8_t {
+    // nodes[0] and nodes[1] adjacent
+    Undirected,
+    // edge from nodes[0] to nodes[1]
+    Directed,
+    // nodes[0] and nodes[2] both adjacent to nodes[1]
+    Bridge
+  };
+  Kind kind;
+  std::array<unsigned, 3> nodes;
+};
+}  // namespace
+
+static bool node_check_passes(
+    const NodeCheck &check, const ConnectivityMatrix &connectivity) {
+  const std::array<unsigned, 3> &n = check.nodes;
+  switch (check.kind) {
+    case NodeCheck::Kind::Undirected:
+      return connectivity.adjacent(n[0], n[1]);
+    case NodeCheck::Kind::Directed:
+      return connectivity.edge_exists(n[0], n[1]);
+    case NodeCheck::Kind::Bridge:
+      return connectivity.adjacent(n[0], n[1]) &&
+             connectivity.adjacent(n[1], n[2]);
+  }
+  return false;
+}
+// Whether a single command acts on qubits allowed by the architecture
+static bool command_respects_connectivity_constraints(
+    Op_ptr op, const unit_vector_t &qbs, const Architecture &arch,
+    bool directed, bool bridge_allowed) {
+  if (op->get_type() == OpType::Conditional) {
+    std::shared_ptr<const Conditional> cond_ptr =
+        std::dynamic_pointer_cast<const Conditional>(op);
+    op = cond_ptr->get_op();
+  }
+  if (op->get_type() == OpType::Barrier) return true;
+  if (op->get_type() == OpType::CircBox) {
+    std::shared_ptr<const Box> box_ptr =
+        std::dynamic_pointer_cast<const Box>(op);
+    Circuit box_circ = *box_ptr->to_circuit().get();
+    qubit_vector_t all_units = box_circ.all_qubits();
+    if (all_units.size() != qbs.size()) return false;
+    unit_map_t rename_map;
+    for (unsigned i = 0; i < all_units.size(); i++)
+      rename_map.insert({all_units[i], qbs[i]});
+    box_circ.rename_units(rename_map);
+    return respects_connectivity_constraints(
+        box_circ, arch, directed, bridge_allowed);
+  }
+  unsigned n_qbs = qbs.size();
+  switch (n_qbs) {
+    case 0:
+    case 1:
+      return true;
+    case 2: {
+      if (arch.get_distance(Node(qbs[0]), Node(qbs[1])) != 1) {
+        return false;
+      }
+      if (directed) {
+        OpType ot = op->get_type();
+        if ((ot == OpType::CX || ot == OpType::ECR) &&
+            !arch.edge_exists(Node(qbs[0]), Node(qbs[1])))
+          return false;
+      }
+      return true;
+    }
+    case 3: {
+      if (bridge_allowed) {
+        if (directed)
+          throw std::logic_error(
+              "BRIDGE ops are disallowed on a directed "
+              "architecture. They must be decomposed.");
+        if (op->get_type() == OpType::BRIDGE) {
+          return arch.get_distance(Node(qbs[0]), Node(qbs[1])) == 1 &&
+                 arch.get_distance(Node(qbs[1]), Node(qbs[2])) == 1;
+        }
+      }
+      return false;
+    }
+    default:
+      return false;
+  }
+}
+
 bool respects_connectivity_constraints(
     const Circuit &circ, const Architecture &arch, bool directed,
     bool bridge_allowed) {
-  unit_set_t qb_lookup;
+  return respects_connectivity_constraints(
+      circ, ConnectivityMatrix(arch), directed, bridge_allowed);
+}
+
+bool respects_connectivity_constraints(
+    const Circuit &circ, const ConnectivityMatrix &connectivity, bool directed,
+    bool bridge_allowed, unsigned n_threads) {
+  std::map<UnitID, unsigned> qubit_nodes;
   for (const Qubit &qb : circ.all_qubits()) {
-    if (!arch.node_exists(Node(qb))) return false;
-    qb_lookup.insert(qb);
+    std::optional<unsigned> id = connectivity.node_id(Node(qb));
+    if (!id) return false;
+    qubit_nodes.insert({qb, *id});
   }
-  for (Circuit::CommandIterator it = circ.begin(); it != circ.end(); ++it) {
-    const Command &com = *it;
-    unit_vector_t qbs;
-    for (const UnitID &arg : com.get_args()) {
-      if (qb_lookup.find(arg) != qb_lookup.end()) qbs.push_back(arg);
-    }
-    Op_ptr op = com.get_op_ptr();
-    if (op->get_type() == OpType::Conditional) {
-      std::shared_ptr<const Conditional> cond_ptr =
-          std::dynamic_pointer_cast<const Conditional>(op);
-      op = cond_ptr->get_op();
+
+  // Gather the multi-qubit operations, rejecting those that can never be
+  // valid as they are found
+  std::vector<NodeCheck> checks;
+  const bool gathered = circ.visit_commands([&](const CommandView &com) {
+    const Op_ptr *op = &com.op;
+    Op_ptr inner;
+    if ((*op)->get_type() == OpType::Conditional) {
+      inner = static_cast<const Conditional &>(**op).get_op();
+      op = &inner;
     }
-    if (op->get_type() == OpType::Barrier) continue;
-    if (op->get_type() == OpType::CircBox) {
-      std::shared_ptr<const Box> box_ptr =
-          std::dynamic_pointer_cast<const Box>(op);
-      Circuit box_circ = *box_ptr->to_circuit().get();
+    const OpType type = (*op)->get_type();
+    if (type == OpType::Barrier) return true;
+    if (type == OpType::CircBox) {
+      unit_vector_t qbs;
+      for (const UnitID &arg : com.args) {
+        if (qubit_nodes.contains(arg)) qbs.push_back(arg);
+      }
+      Circuit box_circ = *static_cast<const Box &>(**op).to_circuit();
       qubit_vector_t all_units = box_circ.all_qubits();
       if (all_units.size() != qbs.size()) return false;
       unit_map_t rename_map;
       for (unsigned i = 0; i < all_units.size(); i++)
         rename_map.insert({all_units[i], qbs[i]});
       box_circ.rename_units(rename_map);
-      if (!respects_connectivity_constraints(
-              box_circ, arch, directed, bridge_allowed))
-        return false;
-      continue;
+      return respects_connectivity_constraints(
+          box_circ, connectivity, directed, bridge_allowed);
+    }
+    NodeCheck check;
+    unsigned n_qbs = 0;
+    for (const UnitID &arg : com.args) {
+      auto it = qubit_nodes.find(arg);
+      if (it == qubit_nodes.end()) continue;
+      if (n_qbs == 3) return false;
+      check.nodes[n_qbs++] = it->second;
     }
-    unsigned n_qbs = qbs.size();
     switch (n_qbs) {
       case 0:
       case 1:
-        break;
-      case 2: {
-        if (arch.get_distance(Node(qbs[0]), Node(qbs[1])) != 1) {
-          return false;
-        }
-        if (directed) {
-          OpType ot = op->get_type();
-          if ((ot == OpType::CX || ot == OpType::ECR) &&
-              !arch.edge_exists(Node(qbs[0]), Node(qbs[1])))
-            return false;
-        }
+        return true;
+      case 2:
+        check.kind = (directed && (type == OpType::CX || type == OpType::ECR))
+                         ? NodeCheck::Kind::Directed
+                         : NodeCheck::Kind::Undirected;
+        checks.push_back(check);
+        return true;
+      default:
+        if (!bridge_allowed) return false;
+        if (directed)
+          throw std::logic_error(
+              "BRIDGE ops are disallowed on a directed "
+              "architecture. They must be decomposed.");
+        if (type != OpType::BRIDGE) return false;
+        check.kind = NodeCheck::Kind::Bridge;
+        checks.push_back(check);
+        return true;
+    }
+  });
+  if (!gathered) return false;
+
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  n_threads = std::max<std::size_t>(
+      1, std::min<std::size_t>(
+             n_threads, checks.size() / min_checks_per_thread));
+  std::atomic<bool> passed{true};
+  auto run_checks = [&](unsigned t) {
+    const std::size_t begin = checks.size() * t / n_threads;
+    const std::size_t end = checks.size() * (t + 1) / n_threads;
+    for (std::size_t i = begin; i < end; i++) {
+      if (!node_check_passes(checks[i], connectivity)) {
+        passed = false;
+        return;
+      }
+      if (i % 1024 == 0 && !passed.load(std::memory_order_relaxed)) return;
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned t = 1; t < n_threads; t++) {
+    threads.emplace_back(run_checks, t);
+  }
+  run_checks(0);
+  for (std::thread &thread : threads) thread.join();
+  return passed;
+}
+
+bool vertices_respect_connectivity_constraints(
+    const Circuit &circ, const VertexSet &verts, const Architecture &arch,
+    bool directed, bool bridge_allowed) {
+  // Qubit on each quantum out-port already traced back to the inputs
+  std::map<VertPort, UnitID> traced;
+  auto trace = [&](Edge e) {
+    std::vector<VertPort> path;
+    UnitID qb;
+    while (true) {
+      Vertex v = circ.source(e);
+      VertPort vp{v, circ.get_source_port(e)};
+      auto found = traced.find(vp);
+      if (found != traced.end()) {
+        qb = found->second;
         break;
       }
-      case 3: {
-        if (bridge_allowed) {
-          if (directed)
-            throw std::logic_error(
-                "BRIDGE ops are disallowed on a directed "
-                "architecture. They must be decomposed.");
-          if (op->get_type() == OpType::BRIDGE) {
-            if (arch.get_distance(Node(qbs[0]), Node(qbs[1])) != 1 ||
-                arch.get_distance(Node(qbs[1]), Node(qbs[2])) != 1) {
-              return false;
-            }
-          } else
-            return false;
-        } else
-          return false;
+      path.push_back(vp);
+      if (is_initial_q_type(circ.get_OpType_from_Vertex(v))) {
+        qb = circ.get_id_from_in(v);
         break;
       }
-      default:
-        return false;
+      e = circ.get_last_edge(v, e);
+    }
+    for (const VertPort &vp : path) traced.insert({vp, qb});
+    return qb;
+  };
+  for (const Vertex &v : verts) {
+    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+    if (is_initial_q_type(op->get_type())) {
+      if (!arch.node_exists(Node(circ.get_id_from_in(v)))) return false;
+      continue;
+    }
+    if (circ.detect_boundary_Op(v)) continue;
+    unit_vector_t qbs;
+    for (const Edge &e : circ.get_in_edges_of_type(v, EdgeType::Quantum)) {
+      qbs.push_back(trace(e));
     }
+    if (!command_respects_connectivity_constraints(
+            op, qbs, arch, directed, bridge_allowed))
+      return false;
   }
   return true;
 }
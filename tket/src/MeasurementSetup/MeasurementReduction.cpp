@@ -14,15 +14,25 @@
 
 #include "tket/MeasurementSetup/MeasurementReduction.hpp"
 
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
 namespace tket {
 
-MeasurementSetup measurement_reduction(
-    const std::list<SpPauliString>& strings, PauliPartitionStrat strat,
-    GraphColourMethod method, CXConfigType cx_config) {
+// Diagonalise each set of a partition and record where each string's result
+// is found
+static MeasurementSetup measure_partition(
+    const std::list<std::list<SpPauliString>>& all_terms,
+    CXConfigType cx_config) {
   std::set<Qubit> qubits;
-  for (const SpPauliString& qpt : strings) {
-    for (const std::pair<const Qubit, Pauli>& qb_p : qpt.string)
-      qubits.insert(qb_p.first);
+  for (const std::list<SpPauliString>& terms : all_terms) {
+    for (const SpPauliString& qpt : terms) {
+      for (const std::pair<const Qubit, Pauli>& qb_p : qpt.string)
+        qubits.insert(qb_p.first);
+    }
   }
 
   std::map<Qubit, unsigned> qb_location_map;
@@ -32,28 +42,68 @@ MeasurementSetup measurement_reduction(
     ++u;
   }
 
-  std::list<std::list<SpPauliString>> all_terms =
-      term_sequence(strings, strat, method);
-  MeasurementSetup ms;
-  unsigned i = 0;
-  for (const std::list<SpPauliString>& terms : all_terms) {
-    std::list<SpSymPauliTensor> gadgets;
-    for (const SpPauliString& string : terms) {
-      gadgets.push_back(string);
+  const std::vector<const std::list<SpPauliString>*> groups = [&]() {
+    std::vector<const std::list<SpPauliString>*> ptrs;
+    for (const std::list<SpPauliString>& terms : all_terms) {
+      ptrs.push_back(&terms);
     }
+    return ptrs;
+  }();
 
-    std::set<Qubit> mutable_qb_set(qubits);
-    Circuit cliff_circ = mutual_diagonalise(gadgets, mutable_qb_set, cx_config);
-    unsigned bit_count = 0;
-    for (const Qubit& qb : cliff_circ.all_qubits()) {
-      cliff_circ.add_bit(Bit(bit_count));
-      cliff_circ.add_measure(qb, Bit(bit_count));
-      ++bit_count;
+  // The groups are diagonalised independently, so share them between threads
+  std::vector<std::list<SpSymPauliTensor>> all_gadgets(groups.size());
+  std::vector<std::optional<Circuit>> circuits(groups.size());
+  std::atomic<std::size_t> next_index = 0;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const auto work = [&]() {
+    try {
+      for (std::size_t index = next_index++; index < groups.size();
+           index = next_index++) {
+        std::list<SpSymPauliTensor>& gadgets = all_gadgets[index];
+        for (const SpPauliString& string : *groups[index]) {
+          gadgets.push_back(string);
+        }
+        std::set<Qubit> mutable_qb_set(qubits);
+        Circuit cliff_circ =
+            mutual_diagonalise(gadgets, mutable_qb_set, cx_config);
+        unsigned bit_count = 0;
+        for (const Qubit& qb : cliff_circ.all_qubits()) {
+          cliff_circ.add_bit(Bit(bit_count));
+          cliff_circ.add_measure(qb, Bit(bit_count));
+          ++bit_count;
+        }
+        circuits[index] = std::move(cliff_circ);
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_index = groups.size();
     }
-    ms.add_measurement_circuit(cliff_circ);
+  };
+  const std::size_t number_of_threads = std::min<std::size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), groups.size());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
 
-    std::list<SpSymPauliTensor>::const_iterator gadgets_iter = gadgets.begin();
-    for (const SpPauliString& string : terms) {
+  // Assemble the results in partition order, independent of scheduling
+  MeasurementSetup ms;
+  for (unsigned i = 0; i < groups.size(); ++i) {
+    ms.add_measurement_circuit(*circuits[i]);
+    std::list<SpSymPauliTensor>::const_iterator gadgets_iter =
+        all_gadgets[i].begin();
+    for (const SpPauliString& string : *groups[i]) {
       SpPauliStabiliser stab(*gadgets_iter);  // Force coeff to be real
       std::vector<unsigned> bits;
       for (const std::pair<const Qubit, Pauli>& qp_pair : stab.string) {
@@ -63,10 +113,20 @@ MeasurementSetup measurement_reduction(
       ms.add_result_for_term(string, {i, bits, stab.is_real_negative()});
       ++gadgets_iter;
     }
-    ++i;
   }
 
   return ms;
 }
 
+MeasurementSetup measurement_reduction(
+    const std::list<SpPauliString>& strings, PauliPartitionStrat strat,
+    GraphColourMethod method, CXConfigType cx_config) {
+  return measure_partition(term_sequence(strings, strat, method), cx_config);
+}
+
+MeasurementSetup measurement_reduction(
+    const PauliPartitionStream& stream, CXConfigType cx_config) {
+  return measure_partition(stream.get_sets(), cx_config);
+}
+
 }  // namespace tket
@@ -14,6 +14,10 @@
 
 #include "tket/MeasurementSetup/MeasurementSetup.hpp"
 
+#include <bit>
+#include <stdexcept>
+#include <string>
+
 #include "tket/Converters/Converters.hpp"
 
 namespace tket {
@@ -44,8 +48,24 @@ void MeasurementSetup::add_result_for_term(
   result_map[term].push_back(result);
 }
 
+// Pack a string over a numbering of qubits, extending it with new qubits.
+static PackedPauliMap pack_paulis(
+    const QubitPauliMap &paulis, std::map<Qubit, unsigned> &qubit_index) {
+  PackedPauliMap packed;
+  for (const std::pair<const Qubit, Pauli> &qp : paulis) {
+    unsigned qb =
+        qubit_index.insert({qp.first, (unsigned)qubit_index.size()})
+            .first->second;
+    packed.set(qb, qp.second);
+  }
+  return packed;
+}
+
 bool MeasurementSetup::verify() const {
-  std::map<std::pair<unsigned, unsigned>, SpPauliStabiliser> pauli_map;
+  // Paulis measured onto each bit, packed over a common numbering of qubits
+  std::map<Qubit, unsigned> qubit_index;
+  std::vector<std::map<unsigned, PkPauliStabiliser>> pauli_map(
+      measurement_circs.size());
   // Identify Paulis measured onto each bit
   for (unsigned circ_id = 0; circ_id < measurement_circs.size(); ++circ_id) {
     Circuit circ = measurement_circs[circ_id];
@@ -60,23 +80,36 @@ bool MeasurementSetup::verify() const {
     }
     UnitaryRevTableau tab = circuit_to_unitary_rev_tableau(circ);
     for (const Qubit &qb : tab.get_qubits()) {
-      pauli_map.insert({{circ_id, readout[qb]}, tab.get_zrow(qb)});
+      SpPauliStabiliser row = tab.get_zrow(qb);
+      pauli_map[circ_id].insert(
+          {readout[qb], PkPauliStabiliser(
+                            pack_paulis(row.string, qubit_index), row.coeff)});
     }
   }
   for (const std::pair<const SpPauliString, std::vector<MeasurementBitMap>>
            &term : result_map) {
+    const PkPauliStabiliser term_tensor(
+        pack_paulis(term.first.string, qubit_index), 0);
     for (const MeasurementBitMap &bits : term.second) {
-      SpPauliStabiliser total;
+      PkPauliStabiliser total;
       for (unsigned bit : bits.bits) {
-        total = total * pauli_map[{bits.circ_index, bit}];
+        total = total * pauli_map.at(bits.circ_index)[bit];
       }
       if (bits.invert) total.coeff = (total.coeff + 2) % 4;
-      SpPauliStabiliser term_tensor(term.first);
       if (total != term_tensor) {
-        std::stringstream out;
-        out << "Invalid MeasurementSetup: expecting to measure "
-            << term_tensor.to_str() << "; actually measured " << total.to_str();
-        tket_log()->error(out.str());
+        std::vector<Qubit> qubits(qubit_index.size());
+        for (const std::pair<const Qubit, unsigned> &qi : qubit_index) {
+          qubits[qi.second] = qi.first;
+        }
+        QubitPauliMap measured_paulis;
+        for (unsigned qb = 0; qb < total.string.size(); ++qb) {
+          measured_paulis[qubits[qb]] = total.string.get(qb);
+        }
+        SpPauliStabiliser measured(measured_paulis, total.coeff);
+        TKET_LOG_ERROR(
+            "Invalid MeasurementSetup: expecting to measure "
+            << SpPauliStabiliser(term.first).to_str() << "; actually measured "
+            << measured.to_str());
         return false;
       }
     }
@@ -102,6 +135,123 @@ std::string MeasurementSetup::to_str() const {
   return ss.str();
 }
 
+ShotTable::ShotTable(unsigned n_bits) : n_shots_(0), columns_(n_bits) {}
+
+ShotTable::ShotTable(
+    unsigned n_bits, const std::vector<std::vector<bool>> &shots)
+    : ShotTable(n_bits) {
+  for (std::vector<Word> &column : columns_) {
+    column.reserve((shots.size() + BITS_PER_WORD - 1) / BITS_PER_WORD);
+  }
+  for (const std::vector<bool> &shot : shots) {
+    add_shot(shot);
+  }
+}
+
+void ShotTable::add_shot(const std::vector<bool> &shot) {
+  if (shot.size() != columns_.size()) {
+    throw std::invalid_argument(
+        "Shot has " + std::to_string(shot.size()) + " bits; expected " +
+        std::to_string(columns_.size()));
+  }
+  const unsigned offset = n_shots_ % BITS_PER_WORD;
+  for (unsigned b = 0; b < columns_.size(); ++b) {
+    if (offset == 0) columns_[b].push_back(0);
+    if (shot[b]) columns_[b].back() |= Word(1) << offset;
+  }
+  ++n_shots_;
+}
+
+MeasurementResultIndex::MeasurementResultIndex(const MeasurementSetup &setup)
+    : n_circuits_(setup.get_circs().size()) {
+  for (const std::pair<const SpPauliString, std::vector<MeasurementBitMap>>
+           &term : setup.get_result_map()) {
+    for (const std::pair<const Qubit, Pauli> &qp : term.first.string) {
+      qubit_index_.insert({qp.first, (unsigned)qubit_index_.size()});
+    }
+  }
+  index_.reserve(setup.get_result_map().size());
+  for (const std::pair<const SpPauliString, std::vector<MeasurementBitMap>>
+           &term : setup.get_result_map()) {
+    index_.insert({*pack(term.first), term.second});
+  }
+}
+
+std::optional<PkPauliString> MeasurementResultIndex::pack(
+    const SpPauliString &term) const {
+  PackedPauliMap packed(qubit_index_.size());
+  for (const std::pair<const Qubit, Pauli> &qp : term.string) {
+    if (qp.second == Pauli::I) continue;
+    std::map<Qubit, unsigned>::const_iterator found =
+        qubit_index_.find(qp.first);
+    if (found == qubit_index_.end()) return std::nullopt;
+    packed.set(found->second, qp.second);
+  }
+  return PkPauliString(packed);
+}
+
+const std::vector<MeasurementResultIndex::MeasurementBitMap> *
+MeasurementResultIndex::find(const PkPauliString &term) const {
+  auto found = index_.find(term);
+  return found == index_.end() ? nullptr : &found->second;
+}
+
+const std::vector<MeasurementResultIndex::MeasurementBitMap> *
+MeasurementResultIndex::find(const SpPauliString &term) const {
+  std::optional<PkPauliString> packed = pack(term);
+  return packed ? find(*packed) : nullptr;
+}
+
+std::vector<double> MeasurementResultIndex::expectation_values(
+    const std::vector<SpPauliString> &terms,
+    const std::vector<ShotTable> &shots) const {
+  if (shots.size() != n_circuits_) {
+    throw std::invalid_argument(
+        "Expected shots for " + std::to_string(n_circuits_) +
+        " measurement circuits; got " + std::to_string(shots.size()));
+  }
+  std::vector<double> values;
+  values.reserve(terms.size());
+  std::vector<const std::vector<ShotTable::Word> *> columns;
+  for (const SpPauliString &term : terms) {
+    const std::vector<MeasurementBitMap> *bit_maps = find(term);
+    if (!bit_maps) {
+      throw std::out_of_range(
+          "Term " + term.to_str() + " is not measured by the setup");
+    }
+    long long total = 0;
+    long long n_shots = 0;
+    for (const MeasurementBitMap &bit_map : *bit_maps) {
+      const ShotTable &table = shots.at(bit_map.circ_index);
+      columns.clear();
+      for (unsigned bit : bit_map.bits) {
+        columns.push_back(&table.column(bit));
+      }
+      // Count shots of odd parity, a word of shots at a time; bits beyond
+      // the last shot are clear so do not contribute
+      long long odd = 0;
+      const std::size_t n_words =
+          (table.n_shots() + ShotTable::BITS_PER_WORD - 1) /
+          ShotTable::BITS_PER_WORD;
+      for (std::size_t w = 0; w < n_words; ++w) {
+        ShotTable::Word parity = 0;
+        for (const std::vector<ShotTable::Word> *column : columns) {
+          parity ^= (*column)[w];
+        }
+        odd += std::popcount(parity);
+      }
+      const long long signed_sum = (long long)table.n_shots() - 2 * odd;
+      total += bit_map.invert ? -signed_sum : signed_sum;
+      n_shots += table.n_shots();
+    }
+    if (n_shots == 0) {
+      throw std::invalid_argument("No shots for term " + term.to_str());
+    }
+    values.push_back((double)total / n_shots);
+  }
+  return values;
+}
+
 void to_json(
     nlohmann::json &j, const MeasurementSetup::MeasurementBitMap &result) {
   j["circ_index"] = result.get_circ_index();
@@ -14,6 +14,7 @@
 
 #include "tket/Ops/ClassicalOps.hpp"
 
+#include <algorithm>
 #include <tkassert/Assert.hpp>
 
 #include "tket/OpType/OpType.hpp"
@@ -33,6 +34,28 @@ static uint32_t u32_from_boolvec(const std::vector<bool> &x) {
   return X;
 }
 
+static constexpr uint64_t all_lanes = ~uint64_t{0};
+
+// Evaluate a function of n bits, given by its truth table, on bit-sliced
+// inputs. The table is reduced by Shannon expansion on x[0], x[1], ...,
+// halving its size each round, so that this costs O(2^n) word operations.
+template <typename Table>
+static uint64_t sliced_lookup(
+    const std::vector<uint64_t> &x, unsigned n, const Table &table) {
+  std::vector<uint64_t> level(std::size_t{1} << n);
+  for (std::size_t r = 0; r < level.size(); r++) {
+    level[r] = table(r) ? all_lanes : 0;
+  }
+  for (unsigned k = 0; k < n; k++) {
+    const std::size_t half = level.size() / 2;
+    for (std::size_t r = 0; r < half; r++) {
+      level[r] = (x[k] & level[2 * r + 1]) | (~x[k] & level[2 * r]);
+    }
+    level.resize(half);
+  }
+  return level[0];
+}
+
 static nlohmann::json classical_to_json(const Op_ptr &op, const OpType &type) {
   nlohmann::json j_class;
   switch (type) {
@@ -166,6 +189,22 @@ ClassicalEvalOp::ClassicalEvalOp(
     const std::string &name)
     : ClassicalOp(type, n_i, n_io, n_o, name) {}
 
+std::vector<uint64_t> ClassicalEvalOp::eval_sliced(
+    const std::vector<uint64_t> &x) const {
+  std::vector<uint64_t> y(n_io_ + n_o_, 0);
+  std::vector<bool> x_k(x.size());
+  for (unsigned k = 0; k < 64; k++) {
+    for (unsigned i = 0; i < x.size(); i++) {
+      x_k[i] = (x[i] >> k) & 1;
+    }
+    std::vector<bool> y_k = eval(x_k);
+    for (unsigned j = 0; j < y.size(); j++) {
+      if (y_k[j]) y[j] |= uint64_t{1} << k;
+    }
+  }
+  return y;
+}
+
 nlohmann::json ClassicalOp::serialize() const {
   nlohmann::json j;
   j["type"] = get_type();
@@ -239,6 +278,20 @@ std::vector<bool> ClassicalTransformOp::eval(const std::vector<bool> &x) const {
   return y;
 }
 
+std::vector<uint64_t> ClassicalTransformOp::eval_sliced(
+    const std::vector<uint64_t> &x) const {
+  if (x.size() != n_io_) {
+    throw std::domain_error("Incorrect input size");
+  }
+  std::vector<uint64_t> y(n_io_);
+  for (unsigned j = 0; j < n_io_; j++) {
+    y[j] = sliced_lookup(x, n_io_, [this, j](std::size_t r) {
+      return (values_[r] >> j) & 1;
+    });
+  }
+  return y;
+}
+
 WASMOp::WASMOp(
     unsigned _n, unsigned _ww_n, std::vector<unsigned> _width_i_parameter,
     std::vector<unsigned> _width_o_parameter, const std::string &_func_name,
@@ -302,6 +355,18 @@ std::vector<bool> SetBitsOp::eval(const std::vector<bool> &x) const {
   return values_;
 }
 
+std::vector<uint64_t> SetBitsOp::eval_sliced(
+    const std::vector<uint64_t> &x) const {
+  if (!x.empty()) {
+    throw std::domain_error("Non-empty input");
+  }
+  std::vector<uint64_t> y(values_.size());
+  for (unsigned j = 0; j < y.size(); j++) {
+    y[j] = values_[j] ? all_lanes : 0;
+  }
+  return y;
+}
+
 std::vector<bool> CopyBitsOp::eval(const std::vector<bool> &x) const {
   if (x.size() != n_i_) {
     throw std::domain_error("Incorrect input size");
@@ -309,6 +374,14 @@ std::vector<bool> CopyBitsOp::eval(const std::vector<bool> &x) const {
   return x;
 }
 
+std::vector<uint64_t> CopyBitsOp::eval_sliced(
+    const std::vector<uint64_t> &x) const {
+  if (x.size() != n_i_) {
+    throw std::domain_error("Incorrect input size");
+  }
+  return x;
+}
+
 std::string RangePredicateOp::get_name(bool) const {
   std::stringstream name;
   name << name_ << "([" << a << "," << b << "])";
@@ -325,6 +398,30 @@ std::vector<bool> RangePredicateOp::eval(const std::vector<bool> &x) const {
   return y;
 }
 
+std::vector<uint64_t> RangePredicateOp::eval_sliced(
+    const std::vector<uint64_t> &x) const {
+  if (x.size() != n_i_) {
+    throw std::domain_error("Incorrect input size");
+  }
+  if (n_i_ > 32) {
+    throw std::domain_error("Vector of bool exceeds maximum size (32)");
+  }
+  // Compare the encoded number with both bounds, from the most significant
+  // bit down, tracking in which lanes it is still equal to each bound.
+  uint64_t above_a = 0, eq_a = all_lanes;
+  uint64_t below_b = 0, eq_b = all_lanes;
+  for (unsigned i = 32; i-- > 0;) {
+    const uint64_t x_i = (i < n_i_) ? x[i] : 0;
+    const uint64_t a_i = ((a >> i) & 1) ? all_lanes : 0;
+    const uint64_t b_i = ((b >> i) & 1) ? all_lanes : 0;
+    above_a |= eq_a & x_i & ~a_i;
+    eq_a &= ~(x_i ^ a_i);
+    below_b |= eq_b & ~x_i & b_i;
+    eq_b &= ~(x_i ^ b_i);
+  }
+  return {(above_a | eq_a) & (below_b | eq_b)};
+}
+
 bool RangePredicateOp::is_equal(const Op &op_other) const {
   const RangePredicateOp &other =
       dynamic_cast<const RangePredicateOp &>(op_other);
@@ -350,6 +447,15 @@ std::vector<bool> ExplicitPredicateOp::eval(const std::vector<bool> &x) const {
   return y;
 }
 
+std::vector<uint64_t> ExplicitPredicateOp::eval_sliced(
+    const std::vector<uint64_t> &x) const {
+  if (x.size() != n_i_) {
+    throw std::domain_error("Incorrect input size");
+  }
+  return {sliced_lookup(
+      x, n_i_, [this](std::size_t r) { return bool(values_[r]); })};
+}
+
 ExplicitModifierOp::ExplicitModifierOp(
     unsigned n, const std::vector<bool> &values, const std::string &name)
     : ModifyingOp(OpType::ExplicitModifier, n, name), values_(values) {
@@ -367,6 +473,15 @@ std::vector<bool> ExplicitModifierOp::eval(const std::vector<bool> &x) const {
   return y;
 }
 
+std::vector<uint64_t> ExplicitModifierOp::eval_sliced(
+    const std::vector<uint64_t> &x) const {
+  if (x.size() != n_i_ + 1) {
+    throw std::domain_error("Incorrect input size");
+  }
+  return {sliced_lookup(
+      x, n_i_ + 1, [this](std::size_t r) { return bool(values_[r]); })};
+}
+
 MultiBitOp::MultiBitOp(std::shared_ptr<const ClassicalEvalOp> op, unsigned n)
     : ClassicalEvalOp(
           OpType::MultiBit, n * op->get_n_i(), n * op->get_n_io(),
@@ -408,6 +523,23 @@ std::vector<bool> MultiBitOp::eval(const std::vector<bool> &x) const {
   return y;
 }
 
+std::vector<uint64_t> MultiBitOp::eval_sliced(
+    const std::vector<uint64_t> &x) const {
+  if (x.size() != n_i_ + n_io_) {
+    throw std::domain_error("Incorrect input size");
+  }
+  unsigned n_op_inputs = op_->get_n_i() + op_->get_n_io();
+  unsigned n_op_outputs = op_->get_n_io() + op_->get_n_o();
+  std::vector<uint64_t> y(n_io_ + n_o_);
+  for (unsigned i = 0; i < n_; i++) {
+    std::vector<uint64_t> x_i(
+        x.begin() + n_op_inputs * i, x.begin() + n_op_inputs * (i + 1));
+    std::vector<uint64_t> y_i = op_->eval_sliced(x_i);
+    std::copy(y_i.begin(), y_i.end(), y.begin() + n_op_outputs * i);
+  }
+  return y;
+}
+
 bool MultiBitOp::is_equal(const Op &op_other) const {
   const MultiBitOp &other = dynamic_cast<const MultiBitOp &>(op_other);
 
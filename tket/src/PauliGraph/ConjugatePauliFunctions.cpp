@@ -11,9 +11,9 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "tket/PauliGraph/ConjugatePauliFunctions.hpp"
 
+#include <array>
 #include <tkassert/Assert.hpp>
 
 #include "tket/OpType/OpTypeInfo.hpp"
@@ -21,126 +21,185 @@
 
 namespace tket {
 
-std::pair<Pauli, bool> conjugate_Pauli(OpType op, Pauli p, bool reverse) {
-  static const std::map<std::pair<OpType, Pauli>, std::pair<Pauli, bool>>
-      conj_lut{
-          {{OpType::H, Pauli::I}, {Pauli::I, false}},
-          {{OpType::H, Pauli::X}, {Pauli::Z, false}},
-          {{OpType::H, Pauli::Y}, {Pauli::Y, true}},
-          {{OpType::H, Pauli::Z}, {Pauli::X, false}},
-          {{OpType::S, Pauli::I}, {Pauli::I, false}},
-          {{OpType::S, Pauli::X}, {Pauli::Y, true}},
-          {{OpType::S, Pauli::Y}, {Pauli::X, false}},
-          {{OpType::S, Pauli::Z}, {Pauli::Z, false}},
-          {{OpType::Sdg, Pauli::I}, {Pauli::I, false}},
-          {{OpType::Sdg, Pauli::X}, {Pauli::Y, false}},
-          {{OpType::Sdg, Pauli::Y}, {Pauli::X, true}},
-          {{OpType::Sdg, Pauli::Z}, {Pauli::Z, false}},
-          {{OpType::V, Pauli::I}, {Pauli::I, false}},
-          {{OpType::V, Pauli::X}, {Pauli::X, false}},
-          {{OpType::V, Pauli::Y}, {Pauli::Z, true}},
-          {{OpType::V, Pauli::Z}, {Pauli::Y, false}},
-          {{OpType::Vdg, Pauli::I}, {Pauli::I, false}},
-          {{OpType::Vdg, Pauli::X}, {Pauli::X, false}},
-          {{OpType::Vdg, Pauli::Y}, {Pauli::Z, false}},
-          {{OpType::Vdg, Pauli::Z}, {Pauli::Y, true}},
-          {{OpType::X, Pauli::I}, {Pauli::I, false}},
-          {{OpType::X, Pauli::X}, {Pauli::X, false}},
-          {{OpType::X, Pauli::Y}, {Pauli::Y, true}},
-          {{OpType::X, Pauli::Z}, {Pauli::Z, true}},
-          {{OpType::Y, Pauli::I}, {Pauli::I, false}},
-          {{OpType::Y, Pauli::X}, {Pauli::X, true}},
-          {{OpType::Y, Pauli::Y}, {Pauli::Y, false}},
-          {{OpType::Y, Pauli::Z}, {Pauli::Z, true}},
-          {{OpType::Z, Pauli::I}, {Pauli::I, false}},
-          {{OpType::Z, Pauli::X}, {Pauli::X, true}},
-          {{OpType::Z, Pauli::Y}, {Pauli::Y, true}},
-          {{OpType::Z, Pauli::Z}, {Pauli::Z, false}}};
-
-  static const std::map<std::pair<OpType, Pauli>, std::pair<Pauli, bool>>
-      rev_conj_lut{
-          {{OpType::H, Pauli::I}, {Pauli::I, false}},
-          {{OpType::H, Pauli::X}, {Pauli::Z, false}},
-          {{OpType::H, Pauli::Y}, {Pauli::Y, true}},
-          {{OpType::H, Pauli::Z}, {Pauli::X, false}},
-          {{OpType::S, Pauli::I}, {Pauli::I, false}},
-          {{OpType::S, Pauli::X}, {Pauli::Y, false}},
-          {{OpType::S, Pauli::Y}, {Pauli::X, true}},
-          {{OpType::S, Pauli::Z}, {Pauli::Z, false}},
-          {{OpType::Sdg, Pauli::I}, {Pauli::I, false}},
-          {{OpType::Sdg, Pauli::X}, {Pauli::Y, true}},
-          {{OpType::Sdg, Pauli::Y}, {Pauli::X, false}},
-          {{OpType::Sdg, Pauli::Z}, {Pauli::Z, false}},
-          {{OpType::V, Pauli::I}, {Pauli::I, false}},
-          {{OpType::V, Pauli::X}, {Pauli::X, false}},
-          {{OpType::V, Pauli::Y}, {Pauli::Z, false}},
-          {{OpType::V, Pauli::Z}, {Pauli::Y, true}},
-          {{OpType::Vdg, Pauli::I}, {Pauli::I, false}},
-          {{OpType::Vdg, Pauli::X}, {Pauli::X, false}},
-          {{OpType::Vdg, Pauli::Y}, {Pauli::Z, true}},
-          {{OpType::Vdg, Pauli::Z}, {Pauli::Y, false}},
-          {{OpType::X, Pauli::I}, {Pauli::I, false}},
-          {{OpType::X, Pauli::X}, {Pauli::X, false}},
-          {{OpType::X, Pauli::Y}, {Pauli::Y, true}},
-          {{OpType::X, Pauli::Z}, {Pauli::Z, true}},
-          {{OpType::Y, Pauli::I}, {Pauli::I, false}},
-          {{OpType::Y, Pauli::X}, {Pauli::X, true}},
-          {{OpType::Y, Pauli::Y}, {Pauli::Y, false}},
-          {{OpType::Y, Pauli::Z}, {Pauli::Z, true}},
-          {{OpType::Z, Pauli::I}, {Pauli::I, false}},
-          {{OpType::Z, Pauli::X}, {Pauli::X, true}},
-          {{OpType::Z, Pauli::Y}, {Pauli::Y, true}},
-          {{OpType::Z, Pauli::Z}, {Pauli::Z, false}}};
-
-  if (reverse) {
-    return rev_conj_lut.at({op, p});
+namespace {
+
+/** Image of a Pauli under conjugation, and whether its sign flips. */
+struct PauliImage {
+  Pauli p;
+  bool flip;
+};
+
+/** Image of a pair of Paulis under a two-qubit conjugation. */
+struct PauliPairImage {
+  Pauli p0;
+  Pauli p1;
+  bool flip;
+};
+
+/**
+ * Forward conjugations --op--P--opdg-- by each single-qubit Clifford gate,
+ * indexed by conj_gate_index(op) and then by the Pauli I, X, Y, Z.
+ */
+constexpr std::array<std::array<PauliImage, 4>, 8> conj_table{{
+    // H
+    {{{Pauli::I, false},
+      {Pauli::Z, false},
+      {Pauli::Y, true},
+      {Pauli::X, false}}},
+    // S
+    {{{Pauli::I, false},
+      {Pauli::Y, true},
+      {Pauli::X, false},
+      {Pauli::Z, false}}},
+    // Sdg
+    {{{Pauli::I, false},
+      {Pauli::Y, false},
+      {Pauli::X, true},
+      {Pauli::Z, false}}},
+    // V
+    {{{Pauli::I, false},
+      {Pauli::X, false},
+      {Pauli::Z, true},
+      {Pauli::Y, false}}},
+    // Vdg
+    {{{Pauli::I, false},
+      {Pauli::X, false},
+      {Pauli::Z, false},
+      {Pauli::Y, true}}},
+    // X
+    {{{Pauli::I, false},
+      {Pauli::X, false},
+      {Pauli::Y, true},
+      {Pauli::Z, true}}},
+    // Y
+    {{{Pauli::I, false},
+      {Pauli::X, true},
+      {Pauli::Y, false},
+      {Pauli::Z, true}}},
+    // Z
+    {{{Pauli::I, false},
+      {Pauli::X, true},
+      {Pauli::Y, true},
+      {Pauli::Z, false}}},
+}};
+
+/**
+ * Conjugations by CX, indexed by the Paulis on the control and target.
+ */
+constexpr std::array<std::array<PauliPairImage, 4>, 4> cx_conj_table{{
+    {{{Pauli::I, Pauli::I, false},
+      {Pauli::I, Pauli::X, false},
+      {Pauli::Z, Pauli::Y, false},
+      {Pauli::Z, Pauli::Z, false}}},
+    {{{Pauli::X, Pauli::X, false},
+      {Pauli::X, Pauli::I, false},
+      {Pauli::Y, Pauli::Z, false},
+      {Pauli::Y, Pauli::Y, true}}},
+    {{{Pauli::Y, Pauli::X, false},
+      {Pauli::Y, Pauli::I, false},
+      {Pauli::X, Pauli::Z, true},
+      {Pauli::X, Pauli::Y, false}}},
+    {{{Pauli::Z, Pauli::I, false},
+      {Pauli::Z, Pauli::X, false},
+      {Pauli::I, Pauli::Y, false},
+      {Pauli::I, Pauli::Z, false}}},
+}};
+
+/**
+ * Row of conj_table for a gate. Reverse conjugation by a gate is forward
+ * conjugation by its inverse.
+ */
+unsigned conj_gate_index(OpType op, bool reverse) {
+  switch (op) {
+    case OpType::H:
+      return 0;
+    case OpType::S:
+      return reverse ? 2 : 1;
+    case OpType::Sdg:
+      return reverse ? 1 : 2;
+    case OpType::V:
+      return reverse ? 4 : 3;
+    case OpType::Vdg:
+      return reverse ? 3 : 4;
+    case OpType::X:
+      return 5;
+    case OpType::Y:
+      return 6;
+    case OpType::Z:
+      return 7;
+    default:
+      throw BadOpType(
+          "Conjugations of single-qubit Pauli strings only defined for "
+          "H, S, Sdg, V, Vdg, X, Y and Z",
+          op);
   }
-  return conj_lut.at({op, p});
+}
+
+void check_cx(OpType op) {
+  if (op != OpType::CX) {
+    throw BadOpType("Conjugations of Pauli strings only defined for CXs", op);
+  }
+}
+
+}  // namespace
+
+std::pair<Pauli, bool> conjugate_Pauli(OpType op, Pauli p, bool reverse) {
+  const PauliImage& img = conj_table[conj_gate_index(op, reverse)][p];
+  return {img.p, img.flip};
 }
 
 void conjugate_PauliTensor(
     SpPauliStabiliser& qpt, OpType op, const Qubit& q, bool reverse) {
+  const unsigned gate = conj_gate_index(op, reverse);
   QubitPauliMap::iterator it = qpt.string.find(q);
   if (it == qpt.string.end()) {
     return;
   }
-  std::pair<Pauli, bool> conj = conjugate_Pauli(op, it->second, reverse);
-  it->second = conj.first;
-  if (conj.second) {
+  const PauliImage& img = conj_table[gate][it->second];
+  it->second = img.p;
+  if (img.flip) {
+    qpt.coeff = (qpt.coeff + 2) % 4;
+  }
+}
+
+void conjugate_PauliTensor(
+    PauliStabiliser& qpt, OpType op, unsigned q, bool reverse) {
+  const unsigned gate = conj_gate_index(op, reverse);
+  if (q >= qpt.string.size()) {
+    return;
+  }
+  const PauliImage& img = conj_table[gate][qpt.string[q]];
+  qpt.string[q] = img.p;
+  if (img.flip) {
     qpt.coeff = (qpt.coeff + 2) % 4;
   }
 }
 
 void conjugate_PauliTensor(
     SpPauliStabiliser& qpt, OpType op, const Qubit& q0, const Qubit& q1) {
-  static const std::map<std::pair<Pauli, Pauli>, std::tuple<Pauli, Pauli, bool>>
-      cx_conj_lut{
-          {{Pauli::I, Pauli::I}, {Pauli::I, Pauli::I, false}},
-          {{Pauli::I, Pauli::X}, {Pauli::I, Pauli::X, false}},
-          {{Pauli::I, Pauli::Y}, {Pauli::Z, Pauli::Y, false}},
-          {{Pauli::I, Pauli::Z}, {Pauli::Z, Pauli::Z, false}},
-          {{Pauli::X, Pauli::I}, {Pauli::X, Pauli::X, false}},
-          {{Pauli::X, Pauli::X}, {Pauli::X, Pauli::I, false}},
-          {{Pauli::X, Pauli::Y}, {Pauli::Y, Pauli::Z, false}},
-          {{Pauli::X, Pauli::Z}, {Pauli::Y, Pauli::Y, true}},
-          {{Pauli::Y, Pauli::I}, {Pauli::Y, Pauli::X, false}},
-          {{Pauli::Y, Pauli::X}, {Pauli::Y, Pauli::I, false}},
-          {{Pauli::Y, Pauli::Y}, {Pauli::X, Pauli::Z, true}},
-          {{Pauli::Y, Pauli::Z}, {Pauli::X, Pauli::Y, false}},
-          {{Pauli::Z, Pauli::I}, {Pauli::Z, Pauli::I, false}},
-          {{Pauli::Z, Pauli::X}, {Pauli::Z, Pauli::X, false}},
-          {{Pauli::Z, Pauli::Y}, {Pauli::I, Pauli::Y, false}},
-          {{Pauli::Z, Pauli::Z}, {Pauli::I, Pauli::Z, false}},
-      };
-  if (op != OpType::CX) {
-    throw BadOpType("Conjugations of Pauli strings only defined for CXs", op);
+  check_cx(op);
+  Pauli p0 = qpt.get(q0);
+  Pauli p1 = qpt.get(q1);
+  const PauliPairImage& img = cx_conj_table[p0][p1];
+  qpt.set(q0, img.p0);
+  qpt.set(q1, img.p1);
+  if (img.flip) {
+    qpt.coeff = (qpt.coeff + 2) % 4;
   }
+}
+
+void conjugate_PauliTensor(
+    PauliStabiliser& qpt, OpType op, unsigned q0, unsigned q1) {
+  check_cx(op);
   Pauli p0 = qpt.get(q0);
   Pauli p1 = qpt.get(q1);
-  std::tuple<Pauli, Pauli, bool> conj = cx_conj_lut.at({p0, p1});
-  qpt.set(q0, std::get<0>(conj));
-  qpt.set(q1, std::get<1>(conj));
-  if (std::get<2>(conj)) {
+  if (p0 == Pauli::I && p1 == Pauli::I) {
+    return;
+  }
+  const PauliPairImage& img = cx_conj_table[p0][p1];
+  qpt.set(q0, img.p0);
+  qpt.set(q1, img.p1);
+  if (img.flip) {
     qpt.coeff = (qpt.coeff + 2) % 4;
   }
 }
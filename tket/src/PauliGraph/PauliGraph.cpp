@@ -14,12 +14,18 @@
 
 #include "tket/PauliGraph/PauliGraph.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <list>
+#include <set>
 #include <tkassert/Assert.hpp>
 
 #include "tket/Gate/Gate.hpp"
 #include "tket/OpType/OpType.hpp"
 #include "tket/Utils/GraphHeaders.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 #include "tket/Utils/PauliTensor.hpp"
+#include "tket/Utils/Trace.hpp"
 
 namespace tket {
 
@@ -77,8 +83,16 @@ PauliVert PauliGraph::target(const PauliEdge &edge) const {
   return boost::target(edge, graph_);
 }
 
+// Clifford multiple of a gate parameter, read numerically when possible
+static std::optional<unsigned> clifford_param(const Gate &gate, unsigned i) {
+  std::optional<double> x = gate.get_numeric_param(i);
+  if (x) return equiv_Clifford(*x);
+  return equiv_Clifford(gate.get_params().at(i));
+}
+
 void PauliGraph::apply_gate_at_end(
     const Gate &gate, const unit_vector_t &args) {
+  TKET_TRACE_SCOPE("PauliGraph::apply_gate_at_end");
   for (const UnitID &arg : args) {
     if (arg.type() == UnitType::Qubit) {
       if (measures_.left.find(Qubit(arg)) != measures_.left.end()) {
@@ -121,7 +135,7 @@ void PauliGraph::apply_gate_at_end(
     case OpType::Rz: {
       SpPauliStabiliser pauli = cliff_.get_zrow(qbs.at(0));
       Expr angle = gate.get_params().at(0);
-      std::optional<unsigned> cliff_angle = equiv_Clifford(angle);
+      std::optional<unsigned> cliff_angle = clifford_param(gate, 0);
       if (cliff_angle) {
         for (unsigned i = 0; i < cliff_angle.value(); i++) {
           cliff_.apply_gate_at_end(OpType::S, qbs);
@@ -133,7 +147,7 @@ void PauliGraph::apply_gate_at_end(
     case OpType::Rx: {
       SpPauliStabiliser pauli = cliff_.get_xrow(qbs.at(0));
       Expr angle = gate.get_params().at(0);
-      std::optional<unsigned> cliff_angle = equiv_Clifford(angle);
+      std::optional<unsigned> cliff_angle = clifford_param(gate, 0);
       if (cliff_angle) {
         for (unsigned i = 0; i < cliff_angle.value(); i++) {
           cliff_.apply_gate_at_end(OpType::V, qbs);
@@ -144,7 +158,7 @@ void PauliGraph::apply_gate_at_end(
     }
     case OpType::Ry: {
       Expr angle = gate.get_params().at(0);
-      std::optional<unsigned> cliff_angle = equiv_Clifford(angle);
+      std::optional<unsigned> cliff_angle = clifford_param(gate, 0);
       if (cliff_angle) {
         if (cliff_angle.value() != 0) {
           cliff_.apply_gate_at_end(OpType::V, qbs);
@@ -165,8 +179,8 @@ void PauliGraph::apply_gate_at_end(
       Expr beta = gate.get_params().at(1);
       SpPauliStabiliser zpauli = cliff_.get_zrow(qbs.at(0));
       SpPauliStabiliser xpauli = cliff_.get_xrow(qbs.at(0));
-      std::optional<unsigned> cliff_alpha = equiv_Clifford(alpha);
-      std::optional<unsigned> cliff_beta = equiv_Clifford(beta);
+      std::optional<unsigned> cliff_alpha = clifford_param(gate, 0);
+      std::optional<unsigned> cliff_beta = clifford_param(gate, 1);
       // Rz(-b)
       if (cliff_beta) {
         for (unsigned i = 0; i < cliff_beta.value(); i++) {
@@ -217,7 +231,7 @@ void PauliGraph::apply_gate_at_end(
     case OpType::PhaseGadget:
     case OpType::ZZPhase: {
       Expr angle = gate.get_params().at(0);
-      std::optional<unsigned> cliff_angle = equiv_Clifford(angle);
+      std::optional<unsigned> cliff_angle = clifford_param(gate, 0);
       if (cliff_angle) {
         if (cliff_angle.value() != 0) {
           QubitPauliMap qpm;
@@ -235,7 +249,7 @@ void PauliGraph::apply_gate_at_end(
     }
     case OpType::XXPhase: {
       Expr angle = gate.get_params().at(0);
-      std::optional<unsigned> cliff_angle = equiv_Clifford(angle);
+      std::optional<unsigned> cliff_angle = clifford_param(gate, 0);
       if (cliff_angle) {
         if (cliff_angle.value() != 0) {
           cliff_.apply_pauli_at_end(
@@ -251,7 +265,7 @@ void PauliGraph::apply_gate_at_end(
     }
     case OpType::YYPhase: {
       Expr angle = gate.get_params().at(0);
-      std::optional<unsigned> cliff_angle = equiv_Clifford(angle);
+      std::optional<unsigned> cliff_angle = clifford_param(gate, 0);
       if (cliff_angle) {
         if (cliff_angle.value() != 0) {
           cliff_.apply_pauli_at_end(
@@ -271,16 +285,140 @@ void PauliGraph::apply_gate_at_end(
   }
 }
 
+namespace {
+
+bool packed_commute(
+    const std::vector<std::uint64_t> &xs0,
+    const std::vector<std::uint64_t> &zs0,
+    const std::vector<std::uint64_t> &xs1,
+    const std::vector<std::uint64_t> &zs1) {
+  const unsigned n_words = std::min(xs0.size(), xs1.size());
+  std::uint64_t acc = 0;
+  for (unsigned k = 0; k < n_words; ++k) {
+    acc ^= (xs0[k] & zs1[k]) ^ (zs0[k] & xs1[k]);
+  }
+  return std::popcount(acc) % 2 == 0;
+}
+
+bool packed_equal(
+    const std::vector<std::uint64_t> &w0,
+    const std::vector<std::uint64_t> &w1) {
+  const std::vector<std::uint64_t> &shorter = w0.size() < w1.size() ? w0 : w1;
+  const std::vector<std::uint64_t> &longer = w0.size() < w1.size() ? w1 : w0;
+  for (unsigned k = 0; k < longer.size(); ++k) {
+    if (longer[k] != (k < shorter.size() ? shorter[k] : 0)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+PauliGraph::PackedGadget PauliGraph::pack_gadget(
+    const SpPauliStabiliser &pauli) {
+  std::vector<std::pair<unsigned, Pauli>> letters;
+  for (const std::pair<const Qubit, Pauli> &qp : pauli.string) {
+    if (qp.second == Pauli::I) continue;
+    auto [it, added] = qubit_index_.insert(
+        {qp.first, static_cast<unsigned>(qubit_index_.size())});
+    if (added) gadgets_on_qubit_.emplace_back();
+    letters.push_back({it->second, qp.second});
+  }
+  const unsigned n_words = (qubit_index_.size() + 63) / 64;
+  PackedGadget packed{
+      0, std::vector<std::uint64_t>(n_words, 0),
+      std::vector<std::uint64_t>(n_words, 0)};
+  for (const auto &[q, p] : letters) {
+    const std::uint64_t bit = std::uint64_t(1) << (q % 64);
+    if (p == Pauli::X || p == Pauli::Y) packed.xs[q / 64] |= bit;
+    if (p == Pauli::Z || p == Pauli::Y) packed.zs[q / 64] |= bit;
+  }
+  return packed;
+}
+
+void PauliGraph::index_gadget(const PauliVert &vert, PackedGadget packed) {
+  packed.order = next_order_++;
+  for (const std::pair<const Qubit, Pauli> &qp : graph_[vert].tensor_.string) {
+    if (qp.second == Pauli::I) continue;
+    gadgets_on_qubit_[qubit_index_.at(qp.first)][qp.second - 1].insert(
+        {packed.order, vert});
+  }
+  packed_.insert({vert, std::move(packed)});
+}
+
+void PauliGraph::unindex_gadget(const PauliVert &vert) {
+  const unsigned order = packed_.at(vert).order;
+  for (const std::pair<const Qubit, Pauli> &qp : graph_[vert].tensor_.string) {
+    if (qp.second == Pauli::I) continue;
+    gadgets_on_qubit_[qubit_index_.at(qp.first)][qp.second - 1].erase(order);
+  }
+  packed_.erase(vert);
+}
+
 void PauliGraph::apply_pauli_gadget_at_end(
     const SpPauliStabiliser &pauli, const Expr &angle) {
-  PauliVertSet to_search = end_line_;
+  PackedGadget packed = pack_gadget(pauli);
+
+  // Collect the gadgets the new one fails to commute with, and those with an
+  // identical string. Only gadgets sharing a qubit with a different Pauli can
+  // anticommute, and identical gadgets must appear in the index of any one
+  // qubit of the support, so we only look through the index of the qubits in
+  // the support.
+  std::set<PauliVert> anticommuting;
+  std::set<PauliVert> identical;
+  std::set<PauliVert> checked;
+  const GadgetsByOrder *fewest_same = nullptr;
+  for (const std::pair<const Qubit, Pauli> &qp : pauli.string) {
+    if (qp.second == Pauli::I) continue;
+    const std::array<GadgetsByOrder, 3> &on_qubit =
+        gadgets_on_qubit_[qubit_index_.at(qp.first)];
+    for (unsigned l = 0; l < 3; ++l) {
+      if (l == unsigned(qp.second) - 1) {
+        if (!fewest_same || on_qubit[l].size() < fewest_same->size())
+          fewest_same = &on_qubit[l];
+        continue;
+      }
+      for (const std::pair<const unsigned, PauliVert> &ov : on_qubit[l]) {
+        if (!checked.insert(ov.second).second) continue;
+        const PackedGadget &other = packed_.at(ov.second);
+        if (!packed_commute(packed.xs, packed.zs, other.xs, other.zs))
+          anticommuting.insert(ov.second);
+      }
+    }
+  }
+  // The oldest gadget that can affect the search. Gadgets before it commute
+  // with the new one and are not identical to it, so the search can stop
+  // there. A gadget with no support is compared against everything.
+  unsigned earliest = next_order_;
+  if (fewest_same) {
+    for (const std::pair<const unsigned, PauliVert> &ov : *fewest_same) {
+      const PackedGadget &other = packed_.at(ov.second);
+      if (packed_equal(packed.xs, other.xs) &&
+          packed_equal(packed.zs, other.zs)) {
+        identical.insert(ov.second);
+        earliest = std::min(earliest, ov.first);
+      }
+    }
+  } else {
+    earliest = 0;
+  }
+  for (const PauliVert &v : anticommuting) {
+    earliest = std::min(earliest, packed_.at(v).order);
+  }
+
+  // Search back from the end of the graph in reverse insertion order, so
+  // every child of a gadget is visited before it
+  std::map<unsigned, PauliVert> to_search;
+  for (const PauliVert &v : end_line_) {
+    const unsigned order = packed_.at(v).order;
+    if (order >= earliest) to_search.insert({order, v});
+  }
   PauliVertSet commuted;
   PauliVert new_vert = boost::add_vertex(graph_);
   graph_[new_vert] = {pauli, angle};
   while (!to_search.empty()) {
     // Get next candidate parent
-    PauliVert to_compare = *to_search.begin();
-    to_search.erase(to_search.begin());
+    PauliVert to_compare = std::prev(to_search.end())->second;
+    to_search.erase(std::prev(to_search.end()));
 
     // Check that we have already commuted past all of its children
     bool ready = true;
@@ -293,9 +431,12 @@ void PauliGraph::apply_pauli_gadget_at_end(
     if (!ready) continue;
 
     // Check if we can commute past it
-    SpPauliStabiliser compare_pauli = graph_[to_compare].tensor_;
-    if (pauli.commutes_with(compare_pauli)) {
-      if (pauli.string == compare_pauli.string) {
+    if (anticommuting.find(to_compare) == anticommuting.end()) {
+      const SpPauliStabiliser &compare_pauli = graph_[to_compare].tensor_;
+      const bool same = fewest_same
+                            ? identical.find(to_compare) != identical.end()
+                            : pauli.string == compare_pauli.string;
+      if (same) {
         // Identical strings - we can merge vertices
         if (pauli.is_real_negative() == compare_pauli.is_real_negative()) {
           graph_[to_compare].angle_ += angle;
@@ -316,14 +457,17 @@ void PauliGraph::apply_pauli_gadget_at_end(
             }
           }
           end_line_.erase(to_compare);
+          unindex_gadget(to_compare);
           boost::clear_vertex(to_compare, graph_);
           boost::remove_vertex(to_compare, graph_);
         }
         return;
       } else {
         // Commute and continue searching
-        PauliVertSet preds = get_predecessors(to_compare);
-        to_search.insert(preds.begin(), preds.end());
+        for (const PauliVert &v : get_predecessors(to_compare)) {
+          const unsigned order = packed_.at(v).order;
+          if (order >= earliest) to_search.insert({order, v});
+        }
         commuted.insert(to_compare);
       }
     } else {
@@ -334,6 +478,7 @@ void PauliGraph::apply_pauli_gadget_at_end(
   }
   end_line_.insert(new_vert);
   if (get_predecessors(new_vert).empty()) start_line_.insert(new_vert);
+  index_gadget(new_vert, std::move(packed));
 }
 
 void PauliGraph::to_graphviz_file(const std::string &filename) const {
@@ -392,4 +537,37 @@ void PauliGraph::sanity_check() const {
   }
 }
 
+std::size_t PauliGraph::memory_usage() const {
+  // The graph is laid out as for Circuit::memory_usage.
+  constexpr std::size_t vertex_bytes =
+      sizeof(PauliGadgetProperties) + sizeof(int) +
+      2 * sizeof(std::list<int>) + memory::LIST_NODE_OVERHEAD;
+  constexpr std::size_t edge_bytes =
+      2 * sizeof(PauliVert) + 3 * memory::LIST_NODE_OVERHEAD +
+      4 * sizeof(void *);
+
+  std::size_t bytes = sizeof(PauliGraph) + cliff_.memory_usage() -
+                      sizeof(cliff_) + boost::num_edges(graph_) * edge_bytes;
+  BGL_FORALL_VERTICES(v, graph_, PauliDAG) {
+    bytes += vertex_bytes + memory::container_bytes(graph_[v].tensor_.string);
+  }
+  bytes += memory::multi_index_bytes(measures_, 2);
+  bytes += memory::container_bytes(bits_);
+  bytes += memory::multi_index_bytes(start_line_, 1, 1) +
+           memory::multi_index_bytes(end_line_, 1, 1);
+  bytes += memory::container_bytes(packed_);
+  for (const auto &[vert, packed] : packed_) {
+    bytes += memory::container_bytes(packed.xs) +
+             memory::container_bytes(packed.zs);
+  }
+  bytes += memory::container_bytes(qubit_index_);
+  bytes += memory::container_bytes(gadgets_on_qubit_);
+  for (const std::array<GadgetsByOrder, 3> &gadgets : gadgets_on_qubit_) {
+    for (const GadgetsByOrder &by_order : gadgets) {
+      bytes += memory::container_bytes(by_order);
+    }
+  }
+  return bytes;
+}
+
 }  // namespace tket
@@ -12,7 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <unordered_map>
 
 #include "tket/Placement/Placement.hpp"
 #include "tket/Utils/HelperFunctions.hpp"
@@ -24,12 +31,19 @@ namespace tket {
 GraphPlacement::GraphPlacement(
     const Architecture& _architecture, unsigned _maximum_matches,
     unsigned _timeout, unsigned _maximum_pattern_gates,
-    unsigned _maximum_pattern_depth)
+    unsigned _maximum_pattern_depth, unsigned _search_threads,
+    double _pattern_depth_decay)
 
     : maximum_matches_(_maximum_matches),
       timeout_(_timeout),
       maximum_pattern_gates_(_maximum_pattern_gates),
-      maximum_pattern_depth_(_maximum_pattern_depth) {
+      maximum_pattern_depth_(_maximum_pattern_depth),
+      search_threads_(_search_threads),
+      pattern_depth_decay_(_pattern_depth_decay) {
+  if (!(_pattern_depth_decay >= 0 && _pattern_depth_decay < 1)) {
+    throw std::invalid_argument(
+        "GraphPlacement pattern depth decay must be in [0, 1).");
+  }
   architecture_ = _architecture;
   this->weighted_target_edges = this->default_target_weighting(architecture_);
   this->extended_target_graphs = {
@@ -39,6 +53,9 @@ GraphPlacement::GraphPlacement(
 
 const std::vector<GraphPlacement::WeightedEdge>
 GraphPlacement::default_pattern_weighting(const Circuit& circuit) const {
+  if (this->pattern_depth_decay_ > 0) {
+    return this->decayed_pattern_weighting(circuit);
+  }
   GraphPlacement::Frontier frontier(circuit);
   unsigned gate_counter = 0;
   std::vector<GraphPlacement::WeightedEdge> weights;
@@ -96,6 +113,88 @@ GraphPlacement::default_pattern_weighting(const Circuit& circuit) const {
   return weights;
 }
 
+const std::vector<GraphPlacement::WeightedEdge>
+GraphPlacement::decayed_pattern_weighting(const Circuit& circuit) const {
+  // Rather than slicing the circuit, the depth of each command (i.e. the
+  // index of its slice) is found from the depths of its units, visiting
+  // the commands in a topological order.
+  std::map<UnitID, unsigned> unit_depths;
+  std::map<Qubit, unsigned> qubit_indices;
+  for (const Qubit& qb : circuit.all_qubits()) {
+    qubit_indices.insert({qb, qubit_indices.size()});
+  }
+  struct Interaction {
+    unsigned weight;
+    // When it was first seen, to order equal weights.
+    unsigned index;
+    Qubit qubit0;
+    Qubit qubit1;
+  };
+  // Keyed by the qubit indices.
+  std::unordered_map<std::uint64_t, Interaction> interactions;
+  unsigned gate_counter = 0;
+  circuit.visit_commands([&](const CommandView& command) {
+    if (gate_counter >= this->maximum_pattern_gates_) return false;
+    unsigned depth = 0;
+    for (const UnitID& uid : command.args) {
+      auto it = unit_depths.find(uid);
+      if (it != unit_depths.end()) {
+        depth = std::max(depth, it->second);
+      }
+    }
+    for (const UnitID& uid : command.args) {
+      unit_depths[uid] = depth + 1;
+    }
+    if (depth >= this->maximum_pattern_depth_ ||
+        command.op->get_type() == OpType::Barrier) {
+      return true;
+    }
+    qubit_vector_t qubits;
+    for (const UnitID& uid : command.args) {
+      if (uid.type() == UnitType::Qubit) {
+        qubits.push_back(Qubit(uid));
+      }
+    }
+    if (qubits.size() > 2) {
+      throw std::invalid_argument(
+          "Can only weight for Circuits with maximum two qubit quantum "
+          "gates.");
+    }
+    if (qubits.size() < 2) return true;
+    const unsigned weight = std::max<long>(
+        1, std::lround(
+               this->maximum_pattern_depth_ *
+               std::pow(this->pattern_depth_decay_, depth)));
+    const std::uint64_t index0 = qubit_indices.at(qubits[0]);
+    const std::uint64_t index1 = qubit_indices.at(qubits[1]);
+    auto [it, inserted] = interactions.insert(
+        {(std::min(index0, index1) << 32) | std::max(index0, index1),
+         {weight, unsigned(interactions.size()), qubits[0], qubits[1]}});
+    if (!inserted) {
+      it->second.weight += weight;
+    }
+    gate_counter++;
+    return true;
+  });
+  std::vector<Interaction> sorted_interactions;
+  sorted_interactions.reserve(interactions.size());
+  for (const auto& entry : interactions) {
+    sorted_interactions.push_back(entry.second);
+  }
+  std::sort(
+      sorted_interactions.begin(), sorted_interactions.end(),
+      [](const Interaction& lhs, const Interaction& rhs) {
+        return lhs.weight > rhs.weight ||
+               (lhs.weight == rhs.weight && lhs.index < rhs.index);
+      });
+  std::vector<GraphPlacement::WeightedEdge> weights;
+  for (const Interaction& interaction : sorted_interactions) {
+    weights.push_back(
+        {interaction.qubit0, interaction.qubit1, interaction.weight, 0});
+  }
+  return weights;
+}
+
 const std::vector<GraphPlacement::WeightedEdge>
 GraphPlacement::default_target_weighting(
     Architecture& passed_architecture) const {
@@ -170,11 +269,10 @@ Architecture GraphPlacement::construct_target_graph(
   return architecture;
 }
 
-std::vector<boost::bimap<Qubit, Node>>
-GraphPlacement::get_all_weighted_subgraph_monomorphisms(
+void GraphPlacement::for_each_weighted_subgraph_monomorphism(
     const Circuit& circ_,
     const std::vector<GraphPlacement::WeightedEdge>& weighted_pattern_edges,
-    bool return_best) const {
+    const MonomorphismCallback& callback) const {
   // we routinely check time, and throw a runtime_error if breached
   const auto init_start = Clock::now();
   if (circ_.n_qubits() > this->architecture_.n_nodes()) {
@@ -183,7 +281,8 @@ GraphPlacement::get_all_weighted_subgraph_monomorphisms(
   }
   unsigned n_qubits = circ_.n_qubits();
   if (n_qubits == 0) {
-    return {{}};
+    callback({}, 0);
+    return;
   }
   /** The weighted subgraph monomorphism tool from TK-WSM is efficient at
    * returning nothing when no subgraph monomorphism can be found. The otherside
@@ -218,8 +317,10 @@ GraphPlacement::get_all_weighted_subgraph_monomorphisms(
    */
 
   if (weighted_pattern_edges.empty()) {
-    return {{}};
+    callback({}, 0);
+    return;
   }
+  std::lock_guard<std::mutex> lock(search_mutex_);
 
   if (std::chrono::duration_cast<std::chrono::milliseconds>(
           Clock::now() - init_start)
@@ -230,9 +331,9 @@ GraphPlacement::get_all_weighted_subgraph_monomorphisms(
   // We store pattern graphs as they're constructed, and check each of them in
   // less complex order when a new target graph is constructed
   std::vector<QubitGraph::UndirectedConnGraph> all_pattern_graphs;
-  std::vector<boost::bimap<Qubit, Node>> all_bimaps;
+  unsigned n_solutions = 0;
   unsigned incrementer = 0, last_edges = 0;
-  while (all_bimaps.empty()) {
+  while (n_solutions == 0) {
     // we check timeout not reached regularly
     if (std::chrono::duration_cast<std::chrono::milliseconds>(
             Clock::now() - init_start)
@@ -269,24 +370,24 @@ GraphPlacement::get_all_weighted_subgraph_monomorphisms(
     // a subgraph monomorphism for the new target graph
     // From more full to less full
     auto it = all_pattern_graphs.begin();
-    while (it != all_pattern_graphs.end() && all_bimaps.empty()) {
-      all_bimaps = get_weighted_subgraph_monomorphisms(
+    while (it != all_pattern_graphs.end() && n_solutions == 0) {
+      n_solutions = tket::for_each_weighted_subgraph_monomorphism(
           *it, extended_target_graphs[incrementer], this->maximum_matches_,
           this->timeout_ -
               std::chrono::duration_cast<std::chrono::milliseconds>(
                   Clock::now() - init_start)
                   .count(),
-          return_best);
+          callback, this->search_threads_,
+          this->get_target_graph_data(incrementer));
 
       ++it;
     }
     incrementer++;
   }
-  return all_bimaps;
 }
 
 std::map<Qubit, Node> GraphPlacement::convert_bimap(
-    boost::bimap<Qubit, Node>& bimap,
+    const boost::bimap<Qubit, Node>& bimap,
     const QubitGraph::UndirectedConnGraph& pattern_graph) const {
   /**
    * For each assignment, find Qubit on adjacent Node
@@ -334,20 +435,145 @@ std::map<Qubit, Node> GraphPlacement::convert_bimap(
   return out_map;
 }
 
-std::vector<std::map<Qubit, Node>> GraphPlacement::get_all_placement_maps(
-    const Circuit& circ_, unsigned matches) const {
-  std::vector<WeightedEdge> weighted_pattern_edges =
-      this->default_pattern_weighting(circ_);
-  std::vector<boost::bimap<Qubit, Node>> all_bimaps =
-      this->get_all_weighted_subgraph_monomorphisms(
-          circ_, weighted_pattern_edges, false);
+WeightedSubgraphMonomorphism::TargetGraphData*
+GraphPlacement::get_target_graph_data(unsigned index) const {
+  TKET_ASSERT(extended_target_graphs.size() > index);
+  if (target_graph_data.size() <= index) {
+    target_graph_data.resize(index + 1);
+  }
+  if (!target_graph_data[index]) {
+    target_graph_data[index] =
+        get_wsm_target_graph_data(extended_target_graphs[index]);
+  }
+  return target_graph_data[index].get();
+}
+
+std::vector<std::map<Qubit, Node>> GraphPlacement::convert_bimaps(
+    const std::vector<boost::bimap<Qubit, Node>>& all_bimaps,
+    const std::vector<WeightedEdge>& weighted_pattern_edges, unsigned n_qubits,
+    unsigned matches) const {
   std::vector<std::map<Qubit, Node>> all_qmaps;
   QubitGraph::UndirectedConnGraph pattern_graph =
-      this->construct_pattern_graph(weighted_pattern_edges, circ_.n_qubits())
+      this->construct_pattern_graph(weighted_pattern_edges, n_qubits)
           .get_undirected_connectivity();
   for (unsigned i = 0; i < all_bimaps.size() && i < matches; i++) {
     all_qmaps.push_back(convert_bimap(all_bimaps[i], pattern_graph));
   }
   return all_qmaps;
 }
+
+std::vector<std::map<Qubit, Node>> GraphPlacement::get_all_placement_maps(
+    const Circuit& circ_, unsigned matches) const {
+  std::vector<WeightedEdge> weighted_pattern_edges =
+      this->default_pattern_weighting(circ_);
+  // Keep only the best "matches" maps, ordered by decreasing WSM scalar
+  // product, earlier maps first if equal; the heap top is the worst kept.
+  struct Candidate {
+    boost::bimap<Qubit, Node> bimap;
+    std::uint64_t scalar_product;
+    unsigned index;
+  };
+  const auto is_better = [](const Candidate& lhs, const Candidate& rhs) {
+    return lhs.scalar_product > rhs.scalar_product ||
+           (lhs.scalar_product == rhs.scalar_product && lhs.index < rhs.index);
+  };
+  std::vector<Candidate> heap;
+  unsigned n_found = 0;
+  this->for_each_weighted_subgraph_monomorphism(
+      circ_, weighted_pattern_edges,
+      [&](const boost::bimap<Qubit, Node>& bimap,
+          std::uint64_t scalar_product) {
+        Candidate candidate{bimap, scalar_product, n_found++};
+        if (heap.size() < matches) {
+          heap.push_back(std::move(candidate));
+          std::push_heap(heap.begin(), heap.end(), is_better);
+        } else if (!heap.empty() && is_better(candidate, heap.front())) {
+          std::pop_heap(heap.begin(), heap.end(), is_better);
+          heap.back() = std::move(candidate);
+          std::push_heap(heap.begin(), heap.end(), is_better);
+        }
+        return true;
+      });
+  std::sort_heap(heap.begin(), heap.end(), is_better);
+  std::vector<boost::bimap<Qubit, Node>> all_bimaps;
+  for (Candidate& candidate : heap) {
+    all_bimaps.push_back(std::move(candidate.bimap));
+  }
+  return convert_bimaps(
+      all_bimaps, weighted_pattern_edges, circ_.n_qubits(), matches);
+}
+
+std::vector<std::map<Qubit, Node>>
+GraphPlacement::get_warm_start_placement_maps(
+    const Circuit& circ_, const std::map<Qubit, Node>& previous_map,
+    unsigned matches) const {
+  std::vector<WeightedEdge> weighted_pattern_edges =
+      this->default_pattern_weighting(circ_);
+  if (weighted_pattern_edges.empty() || previous_map.empty()) {
+    return this->get_all_placement_maps(circ_, matches);
+  }
+  // As the first attempt of for_each_weighted_subgraph_monomorphism.
+  QubitGraph::UndirectedConnGraph pattern_graph =
+      this->construct_pattern_graph(
+              weighted_pattern_edges, circ_.n_qubits() - 1)
+          .get_undirected_connectivity();
+  std::vector<std::pair<Qubit, Qubit>> interactions;
+  BGL_FORALL_EDGES(e, pattern_graph, QubitGraph::UndirectedConnGraph) {
+    interactions.emplace_back(
+        pattern_graph[boost::source(e, pattern_graph)],
+        pattern_graph[boost::target(e, pattern_graph)]);
+  }
+  const auto get_previous_node =
+      [&](const Qubit& qubit) -> std::optional<Node> {
+    auto it = previous_map.find(qubit);
+    if (it == previous_map.end() || !architecture_.node_exists(it->second)) {
+      return std::nullopt;
+    }
+    return it->second;
+  };
+
+  // Qubits with an interaction which the previous map does not satisfy.
+  std::set<Qubit> changed_qubits;
+  for (const auto& [q0, q1] : interactions) {
+    std::optional<Node> n0 = get_previous_node(q0);
+    std::optional<Node> n1 = get_previous_node(q1);
+    if (!n0 || !n1 ||
+        !(architecture_.edge_exists(*n0, *n1) ||
+          architecture_.edge_exists(*n1, *n0))) {
+      changed_qubits.insert(q0);
+      changed_qubits.insert(q1);
+    }
+  }
+  PlacementWarmStart warm_start;
+  if (changed_qubits.empty()) {
+    warm_start.initial_solution = previous_map;
+  } else {
+    // Give the search some room, around the changed qubits.
+    std::set<Qubit> free_qubits = changed_qubits;
+    for (const auto& [q0, q1] : interactions) {
+      if (changed_qubits.contains(q0) || changed_qubits.contains(q1)) {
+        free_qubits.insert(q0);
+        free_qubits.insert(q1);
+      }
+    }
+    for (const auto& [qubit, node] : previous_map) {
+      if (!free_qubits.contains(qubit) && architecture_.node_exists(node)) {
+        warm_start.fixed_assignments.insert({qubit, node});
+      }
+    }
+  }
+  std::vector<boost::bimap<Qubit, Node>> all_bimaps;
+  {
+    std::lock_guard<std::mutex> lock(search_mutex_);
+    all_bimaps = get_weighted_subgraph_monomorphisms(
+        pattern_graph, extended_target_graphs[0], this->maximum_matches_,
+        this->timeout_, false, this->search_threads_,
+        this->get_target_graph_data(0), &warm_start);
+  }
+  if (all_bimaps.empty()) {
+    return this->get_all_placement_maps(circ_, matches);
+  }
+  return convert_bimaps(
+      all_bimaps, weighted_pattern_edges, circ_.n_qubits(), matches);
+}
 }  // namespace tket
\ No newline at end of file
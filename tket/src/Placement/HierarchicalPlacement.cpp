@@ -0,0 +1,471 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <thread>
+
+#include "tket/Placement/Placement.hpp"
+
+namespace tket {
+
+typedef Architecture::UndirectedConnGraph UndirectedGraph;
+
+static constexpr unsigned unreachable = std::numeric_limits<unsigned>::max();
+
+// Breadth first distances from the nearest of the sources.
+static std::vector<unsigned> get_distances_from(
+    const UndirectedGraph& graph, const std::vector<unsigned>& sources) {
+  std::vector<unsigned> distances(boost::num_vertices(graph), unreachable);
+  std::queue<unsigned> queue;
+  for (unsigned v : sources) {
+    distances[v] = 0;
+    queue.push(v);
+  }
+  while (!queue.empty()) {
+    const unsigned v = queue.front();
+    queue.pop();
+    for (auto [it, end] = boost::adjacent_vertices(v, graph); it != end;
+         ++it) {
+      if (distances[*it] == unreachable) {
+        distances[*it] = distances[v] + 1;
+        queue.push(*it);
+      }
+    }
+  }
+  return distances;
+}
+
+// Split the vertices into connected regions of at most region_size.
+// Regions are grown breadth first, each from the first vertex not yet in a
+// region in a sweep outwards from a peripheral vertex of each component,
+// so that they are compact and all but the last of each component are full.
+static std::vector<std::vector<unsigned>> get_vertex_regions(
+    const UndirectedGraph& graph, unsigned region_size) {
+  const unsigned n_vertices = boost::num_vertices(graph);
+  std::vector<unsigned> sweep;
+  std::vector<bool> swept(n_vertices, false);
+  for (unsigned start = 0; start < n_vertices; ++start) {
+    if (swept[start]) continue;
+    const std::vector<unsigned> start_distances =
+        get_distances_from(graph, {start});
+    unsigned peripheral = start;
+    for (unsigned v = 0; v < n_vertices; ++v) {
+      if (start_distances[v] != unreachable &&
+          start_distances[v] > start_distances[peripheral]) {
+        peripheral = v;
+      }
+    }
+    const std::vector<unsigned> distances =
+        get_distances_from(graph, {peripheral});
+    std::vector<unsigned> component;
+    for (unsigned v = 0; v < n_vertices; ++v) {
+      if (distances[v] != unreachable) {
+        component.push_back(v);
+        swept[v] = true;
+      }
+    }
+    std::stable_sort(
+        component.begin(), component.end(), [&](unsigned v1, unsigned v2) {
+          return distances[v1] < distances[v2];
+        });
+    sweep.insert(sweep.end(), component.begin(), component.end());
+  }
+
+  std::vector<std::vector<unsigned>> regions;
+  // Set when a vertex is queued for the current region, or in a region.
+  std::vector<bool> taken(n_vertices, false);
+  for (unsigned seed : sweep) {
+    if (taken[seed]) continue;
+    std::vector<unsigned> region;
+    std::queue<unsigned> queue;
+    queue.push(seed);
+    taken[seed] = true;
+    while (!queue.empty() && region.size() < region_size) {
+      const unsigned v = queue.front();
+      queue.pop();
+      region.push_back(v);
+      for (auto [it, end] = boost::adjacent_vertices(v, graph); it != end;
+           ++it) {
+        if (!taken[*it]) {
+          taken[*it] = true;
+          queue.push(*it);
+        }
+      }
+    }
+    // Queued vertices which did not fit are left for later regions.
+    for (; !queue.empty(); queue.pop()) {
+      taken[queue.front()] = false;
+    }
+    regions.push_back(std::move(region));
+  }
+  return regions;
+}
+
+HierarchicalPlacement::HierarchicalPlacement(
+    const Architecture& _architecture, unsigned region_size,
+    unsigned maximum_matches, unsigned timeout, unsigned maximum_pattern_gates,
+    unsigned maximum_pattern_depth, unsigned threads)
+    : region_size_(region_size),
+      maximum_matches_(maximum_matches),
+      timeout_(timeout),
+      maximum_pattern_gates_(maximum_pattern_gates),
+      maximum_pattern_depth_(maximum_pattern_depth),
+      threads_(threads) {
+  if (region_size == 0) {
+    throw std::invalid_argument(
+        "HierarchicalPlacement region size must be positive.");
+  }
+  architecture_ = _architecture;
+  const UndirectedGraph graph = architecture_.get_undirected_connectivity();
+  const std::vector<std::vector<unsigned>> vertex_regions =
+      get_vertex_regions(graph, region_size);
+  for (const std::vector<unsigned>& vertex_region : vertex_regions) {
+    node_vector_t nodes;
+    for (unsigned v : vertex_region) {
+      nodes.push_back(graph[v]);
+    }
+    region_architectures_.push_back(architecture_.create_subarch(nodes));
+    regions_.push_back(std::move(nodes));
+  }
+  for (const std::vector<unsigned>& vertex_region : vertex_regions) {
+    const std::vector<unsigned> distances =
+        get_distances_from(graph, vertex_region);
+    std::vector<unsigned> region_distances;
+    for (const std::vector<unsigned>& other_region : vertex_regions) {
+      unsigned distance = unreachable;
+      for (unsigned v : other_region) {
+        distance = std::min(distance, distances[v]);
+      }
+      region_distances.push_back(distance);
+    }
+    region_distances_.push_back(std::move(region_distances));
+  }
+}
+
+// Interaction weights between qubits, by index.
+typedef std::vector<std::map<unsigned, unsigned>> QubitAdjacency;
+
+// Split the interacting qubits into parts of at most capacity qubits,
+// with a small total weight of interactions between different parts.
+// Each part is grown greedily from the heaviest remaining qubit, by the
+// qubit most strongly connected to it; then qubits are moved between parts
+// while that strictly reduces the weight between parts.
+static std::vector<unsigned> partition_qubits(
+    const QubitAdjacency& adjacency, unsigned capacity,
+    unsigned& n_parts) {
+  const unsigned n_qubits = adjacency.size();
+  constexpr unsigned unassigned = std::numeric_limits<unsigned>::max();
+  std::vector<unsigned> part_of(n_qubits, unassigned);
+  std::vector<unsigned> seeds;
+  std::vector<unsigned> total_weights(n_qubits, 0);
+  for (unsigned q = 0; q < n_qubits; ++q) {
+    for (const auto& entry : adjacency[q]) {
+      total_weights[q] += entry.second;
+    }
+    if (!adjacency[q].empty()) {
+      seeds.push_back(q);
+    }
+  }
+  std::stable_sort(seeds.begin(), seeds.end(), [&](unsigned q1, unsigned q2) {
+    return total_weights[q1] > total_weights[q2];
+  });
+  std::vector<unsigned> part_sizes;
+  auto seed_it = seeds.cbegin();
+  std::vector<long> gains(n_qubits, 0);
+  while (true) {
+    while (seed_it != seeds.cend() && part_of[*seed_it] != unassigned) {
+      ++seed_it;
+    }
+    if (seed_it == seeds.cend()) break;
+    const unsigned part = part_sizes.size();
+    part_sizes.push_back(0);
+    // Candidates to join the part, keyed by (-gain, qubit).
+    std::set<std::pair<long, unsigned>> candidates;
+    std::vector<unsigned> touched;
+    while (part_sizes[part] < capacity) {
+      unsigned q;
+      if (!candidates.empty()) {
+        q = candidates.begin()->second;
+        candidates.erase(candidates.begin());
+      } else {
+        while (seed_it != seeds.cend() && part_of[*seed_it] != unassigned) {
+          ++seed_it;
+        }
+        if (seed_it == seeds.cend()) break;
+        q = *seed_it;
+      }
+      part_of[q] = part;
+      ++part_sizes[part];
+      for (const auto& [neighbour, weight] : adjacency[q]) {
+        if (part_of[neighbour] != unassigned) continue;
+        if (gains[neighbour] == 0) {
+          touched.push_back(neighbour);
+        } else {
+          candidates.erase({-gains[neighbour], neighbour});
+        }
+        gains[neighbour] += weight;
+        candidates.insert({-gains[neighbour], neighbour});
+      }
+    }
+    for (unsigned q : touched) {
+      gains[q] = 0;
+    }
+  }
+
+  // Refine, a bounded number of times.
+  for (unsigned pass = 0; pass < 8; ++pass) {
+    bool moved = false;
+    for (unsigned q : seeds) {
+      std::map<unsigned, long> part_weights;
+      for (const auto& [neighbour, weight] : adjacency[q]) {
+        part_weights[part_of[neighbour]] += weight;
+      }
+      const unsigned current = part_of[q];
+      unsigned best = current;
+      long best_weight = part_weights[current];
+      for (const auto& [part, weight] : part_weights) {
+        if (weight > best_weight && part_sizes[part] < capacity) {
+          best = part;
+          best_weight = weight;
+        }
+      }
+      if (best != current) {
+        --part_sizes[current];
+        ++part_sizes[best];
+        part_of[q] = best;
+        moved = true;
+      }
+    }
+    if (!moved) break;
+  }
+  n_parts = part_sizes.size();
+  return part_of;
+}
+
+std::vector<std::map<Qubit, Node>>
+HierarchicalPlacement::get_all_placement_maps(
+    const Circuit& circ_, unsigned /*matches*/) const {
+  if (circ_.n_qubits() > this->architecture_.n_nodes()) {
+    throw std::invalid_argument(
+        "Circuit has more qubits than Architecture has nodes.");
+  }
+  const qubit_vector_t qubits = circ_.all_qubits();
+  std::map<Qubit, unsigned> qubit_indices;
+  for (const Qubit& qb : qubits) {
+    qubit_indices.insert({qb, qubit_indices.size()});
+  }
+  // The two qubit interactions, in a topological order.
+  std::vector<std::pair<unsigned, unsigned>> gates;
+  QubitAdjacency adjacency(qubits.size());
+  circ_.visit_commands([&](const CommandView& command) {
+    if (command.op->get_type() == OpType::Barrier) return true;
+    std::vector<unsigned> indices;
+    for (const UnitID& uid : command.args) {
+      if (uid.type() == UnitType::Qubit) {
+        indices.push_back(qubit_indices.at(Qubit(uid)));
+      }
+    }
+    if (indices.size() > 2) {
+      throw std::invalid_argument(
+          "Can only weight for Circuits with maximum two qubit quantum "
+          "gates.");
+    }
+    if (indices.size() == 2 && indices[0] != indices[1]) {
+      gates.emplace_back(indices[0], indices[1]);
+      ++adjacency[indices[0]][indices[1]];
+      ++adjacency[indices[1]][indices[0]];
+    }
+    return true;
+  });
+  if (gates.empty()) {
+    return {{}};
+  }
+
+  // Leave some room in each region, if there are enough regions;
+  // regions with a single Node cannot hold an interaction.
+  unsigned largest_region = 0;
+  for (const node_vector_t& region : this->regions_) {
+    largest_region = std::max<unsigned>(largest_region, region.size());
+  }
+  if (largest_region < 2) {
+    return {{}};
+  }
+  unsigned n_interacting = 0;
+  for (const auto& neighbours : adjacency) {
+    n_interacting += !neighbours.empty();
+  }
+  unsigned capacity = std::max(2u, (largest_region * 3) / 4);
+  unsigned n_large_regions = 0;
+  for (const node_vector_t& region : this->regions_) {
+    n_large_regions += region.size() >= capacity;
+  }
+  if ((n_interacting + capacity - 1) / capacity > n_large_regions) {
+    capacity = largest_region;
+  }
+  unsigned n_parts;
+  const std::vector<unsigned> part_of =
+      partition_qubits(adjacency, capacity, n_parts);
+  std::vector<std::vector<unsigned>> parts(n_parts);
+  for (unsigned q = 0; q < part_of.size(); ++q) {
+    if (!adjacency[q].empty()) {
+      parts[part_of[q]].push_back(q);
+    }
+  }
+  std::vector<std::vector<unsigned>> part_weights(
+      n_parts, std::vector<unsigned>(n_parts, 0));
+  for (const auto& [q0, q1] : gates) {
+    if (part_of[q0] != part_of[q1]) {
+      ++part_weights[part_of[q0]][part_of[q1]];
+      ++part_weights[part_of[q1]][part_of[q0]];
+    }
+  }
+
+  // Assign parts to regions, strongly connected parts first, each to the
+  // free region nearest the regions of the parts it interacts with.
+  const unsigned n_regions = this->regions_.size();
+  const unsigned far = this->architecture_.n_nodes();
+  const auto get_distance = [&](unsigned r1, unsigned r2) {
+    return std::min(far, this->region_distances_[r1][r2]);
+  };
+  std::vector<unsigned long> centralities(n_regions, 0);
+  for (unsigned r1 = 0; r1 < n_regions; ++r1) {
+    for (unsigned r2 = 0; r2 < n_regions; ++r2) {
+      centralities[r1] += get_distance(r1, r2);
+    }
+  }
+  constexpr unsigned no_region = std::numeric_limits<unsigned>::max();
+  std::vector<unsigned> region_of_part(n_parts, no_region);
+  std::vector<bool> assigned_part(n_parts, false);
+  std::vector<bool> used_region(n_regions, false);
+  std::vector<unsigned> assigned_parts;
+  for (unsigned count = 0; count < n_parts; ++count) {
+    unsigned part = no_region;
+    unsigned long part_connection = 0;
+    for (unsigned p = 0; p < n_parts; ++p) {
+      if (assigned_part[p]) continue;
+      unsigned long connection = 0;
+      for (unsigned other : assigned_parts) {
+        connection += part_weights[p][other];
+      }
+      if (part == no_region || connection > part_connection ||
+          (connection == part_connection &&
+           parts[p].size() > parts[part].size())) {
+        part = p;
+        part_connection = connection;
+      }
+    }
+    assigned_part[part] = true;
+    assigned_parts.push_back(part);
+    unsigned best_region = no_region;
+    unsigned long best_cost = 0;
+    for (unsigned r = 0; r < n_regions; ++r) {
+      if (used_region[r] || this->regions_[r].size() < parts[part].size()) {
+        continue;
+      }
+      unsigned long cost = 0;
+      for (unsigned other : assigned_parts) {
+        if (region_of_part[other] != no_region) {
+          cost += (unsigned long)part_weights[part][other] *
+                  get_distance(r, region_of_part[other]);
+        }
+      }
+      if (best_region == no_region || cost < best_cost ||
+          (cost == best_cost &&
+           centralities[r] < centralities[best_region])) {
+        best_region = r;
+        best_cost = cost;
+      }
+    }
+    // If no region is large enough, the part is left unplaced.
+    if (best_region != no_region) {
+      region_of_part[part] = best_region;
+      used_region[best_region] = true;
+    }
+  }
+
+  // Place each part inside its region.
+  std::vector<unsigned> placed_parts;
+  for (unsigned p = 0; p < n_parts; ++p) {
+    if (region_of_part[p] != no_region) {
+      placed_parts.push_back(p);
+    }
+  }
+  std::vector<std::map<Qubit, Node>> part_maps(placed_parts.size());
+  const auto place_part = [&](unsigned index) {
+    const unsigned part = placed_parts[index];
+    Circuit part_circuit;
+    for (unsigned q : parts[part]) {
+      part_circuit.add_qubit(qubits[q]);
+    }
+    unsigned n_gates = 0;
+    for (const auto& [q0, q1] : gates) {
+      if (n_gates >= this->maximum_pattern_gates_) break;
+      if (part_of[q0] == part && part_of[q1] == part) {
+        part_circuit.add_op<Qubit>(OpType::CZ, {qubits[q0], qubits[q1]});
+        ++n_gates;
+      }
+    }
+    GraphPlacement placement(
+        this->region_architectures_[region_of_part[part]],
+        this->maximum_matches_, this->timeout_, this->maximum_pattern_gates_,
+        this->maximum_pattern_depth_);
+    std::vector<std::map<Qubit, Node>> maps =
+        placement.get_all_placement_maps(part_circuit, 1);
+    if (!maps.empty()) {
+      part_maps[index] = std::move(maps[0]);
+    }
+  };
+  std::atomic<unsigned> next_index = 0;
+  std::exception_ptr exception;
+  std::mutex exception_mutex;
+  const auto work = [&]() {
+    for (unsigned index = next_index++; index < placed_parts.size();
+         index = next_index++) {
+      try {
+        place_part(index);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (!exception) {
+          exception = std::current_exception();
+        }
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  const unsigned n_workers = std::max<unsigned>(
+      1, std::min<unsigned>(this->threads_, placed_parts.size()));
+  for (unsigned i = 1; i < n_workers; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+  std::map<Qubit, Node> map;
+  for (const std::map<Qubit, Node>& part_map : part_maps) {
+    map.insert(part_map.begin(), part_map.end());
+  }
+  return {map};
+}
+
+}  // namespace tket
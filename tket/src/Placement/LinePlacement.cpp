@@ -90,6 +90,7 @@ std::map<Qubit, Node> LinePlacement::assign_lines_to_target_graph(
     line_pattern.pop_back();
   }
   Architecture copy = this->architecture_;
+  copy.thaw();
   node_set_t all_architecture_nodes = this->architecture_.nodes();
   node_set_t bad_nodes;
   for (const Node& node : all_architecture_nodes) {
@@ -13,9 +13,11 @@
 // limitations under the License.
 
 #include <tkwsm/EndToEndWrappers/MainSolver.hpp>
+#include <tkwsm/EndToEndWrappers/TargetGraphData.hpp>
 
 #include "RelabelledGraphWSM.hpp"
 #include "tket/Placement/Placement.hpp"
+#include "tket/Utils/Trace.hpp"
 
 namespace tket {
 
@@ -95,6 +97,26 @@ static void assign_isolated_pattern_vertices(
   }
 }
 
+// The full map for a solution from the solver, using the new labels.
+static boost::bimap<Qubit, Node> get_map(
+    const SolutionWSM& solution,
+    const RelabelledPatternGraph& relabelled_pattern_graph,
+    const RelabelledTargetGraph& relabelled_target_graph) {
+  boost::bimap<Qubit, Node> map;
+  for (const auto& relabelled_pv_tv : solution.assignments) {
+    map.insert(BimapValue(
+        relabelled_pattern_graph.get_original_vertices().at(
+            relabelled_pv_tv.first),
+        relabelled_target_graph.get_original_vertices().at(
+            relabelled_pv_tv.second)));
+  }
+  assign_isolated_pattern_vertices(
+      map, relabelled_pattern_graph, relabelled_target_graph);
+  TKET_ASSERT(
+      map.size() == relabelled_pattern_graph.get_original_vertices().size());
+  return map;
+}
+
 static void write_solver_solutions(
     std::vector<boost::bimap<Qubit, Node>>& all_maps,
     const std::vector<SolutionWSM>& solutions,
@@ -105,18 +127,8 @@ static void write_solver_solutions(
 
   for (unsigned ii = 0; ii < solutions.size(); ++ii) {
     const auto& solution = solutions[ii];
-    boost::bimap<Qubit, Node> map;
-    for (const auto& relabelled_pv_tv : solution.assignments) {
-      map.insert(BimapValue(
-          relabelled_pattern_graph.get_original_vertices().at(
-              relabelled_pv_tv.first),
-          relabelled_target_graph.get_original_vertices().at(
-              relabelled_pv_tv.second)));
-    }
-    assign_isolated_pattern_vertices(
-        map, relabelled_pattern_graph, relabelled_target_graph);
-    TKET_ASSERT(
-        map.size() == relabelled_pattern_graph.get_original_vertices().size());
+    const boost::bimap<Qubit, Node> map = get_map(
+        solution, relabelled_pattern_graph, relabelled_target_graph);
     unsigned original_size = reordering.size();
     for (unsigned i = 0;
          i < reordering.size() && reordering.size() == original_size; i++) {
@@ -148,32 +160,134 @@ static void write_solver_solutions(
     }
   }
 }
+// The relabelled (PV,TV) pairs, for the nonisolated pattern vertices only;
+// assignments of other qubits, or to unknown nodes, are dropped.
+static std::vector<std::pair<VertexWSM, VertexWSM>> get_relabelled_assignments(
+    const std::map<Qubit, Node>& map,
+    const RelabelledPatternGraph& relabelled_pattern_graph,
+    const RelabelledTargetGraph& relabelled_target_graph) {
+  std::vector<std::pair<VertexWSM, VertexWSM>> assignments;
+  for (const auto& [qubit, node] : map) {
+    const auto pv_opt =
+        relabelled_pattern_graph.get_relabelled_vertex_opt(qubit);
+    const auto tv_opt = relabelled_target_graph.get_relabelled_vertex_opt(node);
+    if (pv_opt && tv_opt &&
+        relabelled_pattern_graph.get_relabelled_nonisolated_vertices().count(
+            pv_opt.value()) != 0) {
+      assignments.emplace_back(pv_opt.value(), tv_opt.value());
+    }
+  }
+  return assignments;
+}
+
+static void set_warm_start(
+    MainSolverParameters& solver_parameters,
+    const PlacementWarmStart& warm_start,
+    const RelabelledPatternGraph& relabelled_pattern_graph,
+    const RelabelledTargetGraph& relabelled_target_graph) {
+  solver_parameters.fixed_assignments = get_relabelled_assignments(
+      warm_start.fixed_assignments, relabelled_pattern_graph,
+      relabelled_target_graph);
+
+  std::vector<std::pair<VertexWSM, VertexWSM>> initial_solution =
+      get_relabelled_assignments(
+          warm_start.initial_solution, relabelled_pattern_graph,
+          relabelled_target_graph);
+  if (initial_solution.size() !=
+      relabelled_pattern_graph.get_relabelled_nonisolated_vertices().size()) {
+    return;
+  }
+  // The solver throws on an invalid solution, so check it here;
+  // it must also agree with the fixed assignments.
+  const std::map<VertexWSM, VertexWSM> initial_map(
+      initial_solution.cbegin(), initial_solution.cend());
+  for (const auto& [pv, tv] : solver_parameters.fixed_assignments) {
+    if (initial_map.at(pv) != tv) {
+      return;
+    }
+  }
+  std::set<VertexWSM> used_tv;
+  for (const auto& entry : initial_map) {
+    if (!used_tv.insert(entry.second).second) {
+      return;
+    }
+  }
+  for (const auto& entry :
+       relabelled_pattern_graph.get_relabelled_edges_and_weights()) {
+    if (relabelled_target_graph.get_relabelled_edges_and_weights().count(
+            get_edge(
+                initial_map.at(entry.first.first),
+                initial_map.at(entry.first.second))) == 0) {
+      return;
+    }
+  }
+  solver_parameters.initial_solution = std::move(initial_solution);
+}
+
 /**
  * \cond Somehow doxygen 1.9.1 complains about this. Tell it to be quiet.
  */
 
+// Can we see immediately that there are no solutions?
+static bool is_trivially_insoluble(
+    const RelabelledPatternGraph& relabelled_pattern_graph,
+    const RelabelledTargetGraph& relabelled_target_graph) {
+  return relabelled_pattern_graph.get_relabelled_edges_and_weights().size() >
+             relabelled_target_graph.get_relabelled_edges_and_weights()
+                 .size() ||
+         relabelled_pattern_graph.get_relabelled_nonisolated_vertices()
+                 .size() >
+             relabelled_target_graph.get_relabelled_nonisolated_vertices()
+                 .size() ||
+         relabelled_pattern_graph.get_relabelled_isolated_vertices().size() +
+                 relabelled_pattern_graph.get_relabelled_nonisolated_vertices()
+                     .size() >
+             relabelled_target_graph.get_relabelled_isolated_vertices()
+                     .size() +
+                 relabelled_target_graph.get_relabelled_nonisolated_vertices()
+                     .size();
+}
+
+static std::unique_ptr<MainSolver> get_solver(
+    const RelabelledPatternGraph& relabelled_pattern_graph,
+    const RelabelledTargetGraph& relabelled_target_graph,
+    TargetGraphData* target_data,
+    const MainSolverParameters& solver_parameters) {
+  // The search runs in the constructor.
+  TKET_TRACE_SCOPE("MainSolver::solve");
+  return target_data == nullptr
+             ? std::make_unique<MainSolver>(
+                   relabelled_pattern_graph.get_relabelled_edges_and_weights(),
+                   relabelled_target_graph.get_relabelled_edges_and_weights(),
+                   solver_parameters)
+             : std::make_unique<MainSolver>(
+                   relabelled_pattern_graph.get_relabelled_edges_and_weights(),
+                   *target_data, solver_parameters);
+}
+
+static MainSolverParameters get_solver_parameters(
+    unsigned max_matches, unsigned timeout_ms, unsigned n_threads) {
+  MainSolverParameters solver_parameters;
+  solver_parameters.terminate_with_first_full_solution = false;
+  solver_parameters.for_multiple_full_solutions_the_max_number_to_obtain =
+      max_matches;
+  solver_parameters.timeout_ms = timeout_ms;
+  solver_parameters.number_of_threads = n_threads;
+  return solver_parameters;
+}
+
 std::vector<boost::bimap<Qubit, Node>> get_weighted_subgraph_monomorphisms(
     QubitGraph::UndirectedConnGraph& pattern_graph,
     Architecture::UndirectedConnGraph& target_graph, unsigned max_matches,
-    unsigned timeout_ms, bool return_best) {
+    unsigned timeout_ms, bool return_best, unsigned n_threads,
+    TargetGraphData* target_data, const PlacementWarmStart* warm_start) {
   std::vector<boost::bimap<Qubit, Node>> all_maps;
 
   const RelabelledPatternGraph relabelled_pattern_graph(pattern_graph);
   const RelabelledTargetGraph relabelled_target_graph(target_graph);
 
-  if (relabelled_pattern_graph.get_relabelled_edges_and_weights().size() >
-          relabelled_target_graph.get_relabelled_edges_and_weights().size() ||
-      relabelled_pattern_graph.get_relabelled_nonisolated_vertices().size() >
-          relabelled_target_graph.get_relabelled_nonisolated_vertices()
-              .size() ||
-
-      relabelled_pattern_graph.get_relabelled_isolated_vertices().size() +
-              relabelled_pattern_graph.get_relabelled_nonisolated_vertices()
-                  .size() >
-          relabelled_target_graph.get_relabelled_isolated_vertices().size() +
-              relabelled_target_graph.get_relabelled_nonisolated_vertices()
-                  .size()) {
-    // The problem is trivially insoluble.
+  if (is_trivially_insoluble(
+          relabelled_pattern_graph, relabelled_target_graph)) {
     return all_maps;
   }
 
@@ -185,21 +299,86 @@ std::vector<boost::bimap<Qubit, Node>> get_weighted_subgraph_monomorphisms(
     return all_maps;
   }
 
-  MainSolverParameters solver_parameters;
-  solver_parameters.terminate_with_first_full_solution = false;
-  solver_parameters.for_multiple_full_solutions_the_max_number_to_obtain =
-      max_matches;
-  solver_parameters.timeout_ms = timeout_ms;
-  const MainSolver main_solver(
-      relabelled_pattern_graph.get_relabelled_edges_and_weights(),
-      relabelled_target_graph.get_relabelled_edges_and_weights(),
+  MainSolverParameters solver_parameters =
+      get_solver_parameters(max_matches, timeout_ms, n_threads);
+  if (warm_start != nullptr) {
+    set_warm_start(
+        solver_parameters, *warm_start, relabelled_pattern_graph,
+        relabelled_target_graph);
+  }
+  const std::unique_ptr<MainSolver> main_solver_ptr = get_solver(
+      relabelled_pattern_graph, relabelled_target_graph, target_data,
       solver_parameters);
-  const auto& solution_data = main_solver.get_solution_data();
+  const auto& solution_data = main_solver_ptr->get_solution_data();
   write_solver_solutions(
       all_maps, solution_data.solutions, relabelled_pattern_graph,
       relabelled_target_graph, return_best);
   return all_maps;
 }
+
+unsigned for_each_weighted_subgraph_monomorphism(
+    QubitGraph::UndirectedConnGraph& pattern_graph,
+    Architecture::UndirectedConnGraph& target_graph, unsigned max_matches,
+    unsigned timeout_ms, const MonomorphismCallback& callback,
+    unsigned n_threads, TargetGraphData* target_data) {
+  const RelabelledPatternGraph relabelled_pattern_graph(pattern_graph);
+  const RelabelledTargetGraph relabelled_target_graph(target_graph);
+
+  if (is_trivially_insoluble(
+          relabelled_pattern_graph, relabelled_target_graph)) {
+    return 0;
+  }
+  if (relabelled_pattern_graph.get_relabelled_nonisolated_vertices().empty()) {
+    boost::bimap<Qubit, Node> map;
+    assign_isolated_pattern_vertices(
+        map, relabelled_pattern_graph, relabelled_target_graph);
+    callback(map, 0);
+    return 1;
+  }
+  unsigned number_of_solutions = 0;
+  MainSolverParameters solver_parameters =
+      get_solver_parameters(max_matches, timeout_ms, n_threads);
+  if (n_threads > 1) {
+    // The solver can only pass solutions on as they are found
+    // with a single thread, so pass them on once the search ends.
+    const std::unique_ptr<MainSolver> main_solver_ptr = get_solver(
+        relabelled_pattern_graph, relabelled_target_graph, target_data,
+        solver_parameters);
+    for (const SolutionWSM& solution :
+         main_solver_ptr->get_solution_data().solutions) {
+      ++number_of_solutions;
+      if (!callback(
+              get_map(
+                  solution, relabelled_pattern_graph, relabelled_target_graph),
+              solution.scalar_product)) {
+        break;
+      }
+    }
+    return number_of_solutions;
+  }
+  // The solver's original labels are those of the relabelled graphs,
+  // so the solutions convert as usual.
+  solver_parameters.solution_callback = [&](const SolutionWSM& solution) {
+    ++number_of_solutions;
+    return callback(
+        get_map(solution, relabelled_pattern_graph, relabelled_target_graph),
+        solution.scalar_product);
+  };
+  get_solver(
+      relabelled_pattern_graph, relabelled_target_graph, target_data,
+      solver_parameters);
+  return number_of_solutions;
+}
+
+std::shared_ptr<TargetGraphData> get_wsm_target_graph_data(
+    Architecture::UndirectedConnGraph& target_graph) {
+  const RelabelledTargetGraph relabelled_target_graph(target_graph);
+  if (relabelled_target_graph.get_relabelled_edges_and_weights().empty()) {
+    return nullptr;
+  }
+  return std::make_shared<TargetGraphData>(
+      relabelled_target_graph.get_relabelled_edges_and_weights());
+}
 /**
  * \endcond
  */
@@ -69,9 +69,7 @@ NeighbourPlacements::ResultVec NeighbourPlacements::get(
       ++n_unsuccessful;
     }
     if (n_unsuccessful == max_tries) {
-      std::stringstream ss;
-      ss << "Could not generate " << n << " distinct placements";
-      tket_log()->warn(ss.str());
+      TKET_LOG_WARN("Could not generate " << n << " distinct placements");
     }
   }
   return resvec;
@@ -104,9 +102,8 @@ NeighbourPlacements::Result NeighbourPlacements::gen_result(
   }
 
   if (n_unsuccessful == max_tries) {
-    std::stringstream ss;
-    ss << "Unable to generate " << dist << " swaps for given architecture";
-    tket_log()->warn(ss.str());
+    TKET_LOG_WARN(
+        "Unable to generate " << dist << " swaps for given architecture");
   }
 
   return convert_to_res(swaps.to_vector());
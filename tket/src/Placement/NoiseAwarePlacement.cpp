@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
 #include "tket/Placement/Placement.hpp"
 #include "tket/Utils/HelperFunctions.hpp"
 
@@ -23,10 +27,11 @@ NoiseAwarePlacement::NoiseAwarePlacement(
     std::optional<avg_link_errors_t> _link_errors,
     std::optional<avg_readout_errors_t> _readout_errors,
     unsigned _maximum_matches, unsigned _timeout,
-    unsigned _maximum_pattern_gates, unsigned _maximum_pattern_depth)
+    unsigned _maximum_pattern_gates, unsigned _maximum_pattern_depth,
+    unsigned _search_threads, double _pattern_depth_decay)
     : GraphPlacement(
           _architecture, _maximum_matches, _timeout, _maximum_pattern_gates,
-          _maximum_pattern_depth) {
+          _maximum_pattern_depth, _search_threads, _pattern_depth_decay) {
   architecture_ = _architecture;
   this->weighted_target_edges = this->default_target_weighting(architecture_);
   this->extended_target_graphs = {
@@ -36,106 +41,209 @@ NoiseAwarePlacement::NoiseAwarePlacement(
       _node_errors ? *_node_errors : avg_node_errors_t(),
       _link_errors ? *_link_errors : avg_link_errors_t(),
       _readout_errors ? *_readout_errors : avg_readout_errors_t()};
+  this->set_node_costs();
+}
+
+// constants for scaling single qubit error
+static constexpr double c1 = 0.5;
+static constexpr double d1 = 1 - 1 / c1;
+
+void NoiseAwarePlacement::set_node_costs() {
+  this->node_indices_.clear();
+  this->node_costs_.clear();
+  for (const Node& node : this->architecture_.get_all_nodes_vec()) {
+    this->node_indices_.insert({node, this->node_indices_.size()});
+  }
+  this->node_costs_.resize(this->node_indices_.size());
+  for (const auto& [node, index] : this->node_indices_) {
+    NodeCost& node_cost = this->node_costs_[index];
+    gate_error_t single_error = this->characterisation_.get_error(node);
+    node_cost.gate_cost = d1 + 1.0 / ((1.0 - single_error) + c1);
+    readout_error_t readout_error =
+        this->characterisation_.get_readout_error(node);
+    node_cost.readout_cost =
+        readout_error ? d1 + 1.0 / ((1.0 - readout_error) + c1) : 0.0;
+    for (const Node& neighbour :
+         this->architecture_.get_neighbour_nodes(node)) {
+      gate_error_t fwd_error =
+          this->characterisation_.get_error({node, neighbour});
+      gate_error_t bck_error =
+          this->characterisation_.get_error({neighbour, node});
+      if (fwd_error < 1.0 && bck_error < 1.0) {
+        node_cost.links.emplace_back(
+            this->node_indices_.at(neighbour), 1.0 - fwd_error,
+            1.0 - bck_error);
+      }
+    }
+  }
+}
+
+NoiseAwarePlacement::PatternCost NoiseAwarePlacement::get_pattern_cost(
+    const Circuit& circ_, const QubitGraph& q_graph) const {
+  PatternCost pattern_cost;
+  pattern_cost.trivial = circ_.n_gates() == 0 || circ_.n_qubits() == 0;
+  if (pattern_cost.trivial) {
+    return pattern_cost;
+  }
+  pattern_cost.approx_depth = circ_.n_gates() / circ_.n_qubits() + 1;
+  for (const Qubit& qb : circ_.all_qubits()) {
+    pattern_cost.qubit_indices.insert({qb, pattern_cost.qubit_indices.size()});
+  }
+  const unsigned n_qubits = pattern_cost.qubit_indices.size();
+  pattern_cost.weights.assign(n_qubits * n_qubits, 0);
+  for (const auto& [qb0, qb1] : q_graph.get_all_edges_vec()) {
+    const unsigned index = pattern_cost.qubit_indices.at(qb0) * n_qubits +
+                           pattern_cost.qubit_indices.at(qb1);
+    pattern_cost.weights[index] = q_graph.get_connection_weight(qb0, qb1);
+  }
+  return pattern_cost;
 }
 
 double NoiseAwarePlacement::cost_placement(
-    const boost::bimap<Qubit, Node>& map, const Circuit& circ_,
-    const QubitGraph& q_graph) const {
+    const boost::bimap<Qubit, Node>& map, const PatternCost& pattern_cost,
+    std::vector<unsigned>& node_qubits) const {
   double cost = 0.0;
-  if (circ_.n_gates() == 0 || circ_.n_qubits() == 0) {
+  if (pattern_cost.trivial) {
     return cost;
   }
-  const int approx_depth = circ_.n_gates() / circ_.n_qubits() + 1;
-  // constants for scaling single qubit error
-  constexpr double c1 = 0.5;
-  constexpr double d1 = 1 - 1 / c1;
+  const unsigned n_qubits = pattern_cost.qubit_indices.size();
+  // The (qubit, node) indices of the map, in the same order.
+  std::vector<std::pair<unsigned, unsigned>> assignments;
+  assignments.reserve(map.size());
   for (auto [qb, node] : map) {
-    node_set_t neighbours = this->architecture_.get_neighbour_nodes(node);
+    assignments.emplace_back(
+        pattern_cost.qubit_indices.at(qb), this->node_indices_.at(node));
+    node_qubits[assignments.back().second] = assignments.back().first;
+  }
+  auto place_interactions_boost = [&](unsigned edge_v) {
+    return this->maximum_pattern_depth_ - edge_v + 1;
+  };
+  for (auto [qubit, node] : assignments) {
+    const NodeCost& node_cost = this->node_costs_[node];
+    const unsigned* qubit_weights = &pattern_cost.weights[qubit * n_qubits];
     double edge_sum = 1.0;
-    for (const Node& neighbour : neighbours) {
-      double fwd_edge_weighting = 1.0, bck_edge_weighting = 1.0;
+    for (const auto& [neighbour, fwd_fidelity, bck_fidelity] :
+         node_cost.links) {
       // check if neighbour node is mapped
-      auto nei_qb_it = map.right.find(neighbour);
-      if (nei_qb_it == map.right.end()) continue;
-
-      auto place_interactions_boost = [&](unsigned edge_v) {
-        return this->maximum_pattern_depth_ - edge_v + 1;
-      };
-
+      const unsigned nei_qubit = node_qubits[neighbour];
+      if (nei_qubit == n_qubits) continue;
+      double fwd_edge_weighting = 1.0, bck_edge_weighting = 1.0;
       // check if either directed interaction exists
       // if edge is used by interaction in mapping, weight edge higher
-      unsigned edge_val = q_graph.get_connection_weight(qb, nei_qb_it->second);
+      unsigned edge_val = qubit_weights[nei_qubit];
       if (edge_val) {
         fwd_edge_weighting += place_interactions_boost(edge_val);
       } else {
-        edge_val = q_graph.get_connection_weight(nei_qb_it->second, qb);
+        edge_val = pattern_cost.weights[nei_qubit * n_qubits + qubit];
         if (edge_val) {
           bck_edge_weighting += place_interactions_boost(edge_val);
         }
       }
-      gate_error_t fwd_error =
-          this->characterisation_.get_error({node, neighbour});
-      gate_error_t bck_error =
-          this->characterisation_.get_error({neighbour, node});
-
-      if (fwd_error < 1.0 && bck_error < 1.0) {
-        edge_sum += fwd_edge_weighting * (1.0 - fwd_error);
-        edge_sum += bck_edge_weighting * (1.0 - bck_error);
-      }
+      edge_sum += fwd_edge_weighting * fwd_fidelity;
+      edge_sum += bck_edge_weighting * bck_fidelity;
     }
     // bigger edge sum -> smaller cost
     cost += 1.0 / (edge_sum);
     // add error rate of node
-    gate_error_t single_error = this->characterisation_.get_error(node);
-    cost += d1 + 1.0 / ((1.0 - single_error) + c1);
-    readout_error_t readout_error =
-        this->characterisation_.get_readout_error(node);
-    if (readout_error) {
-      cost += (d1 + 1.0 / ((1.0 - readout_error) + c1)) / (approx_depth * 20);
+    cost += node_cost.gate_cost;
+    if (node_cost.readout_cost) {
+      cost += node_cost.readout_cost / (pattern_cost.approx_depth * 20);
     }
   }
+  for (auto [qubit, node] : assignments) {
+    node_qubits[node] = n_qubits;
+  }
   return cost;
 }
 
-std::vector<boost::bimap<Qubit, Node>> NoiseAwarePlacement::rank_maps(
-    const std::vector<boost::bimap<Qubit, Node>>& placement_maps,
-    const Circuit& circ_,
-    const std::vector<GraphPlacement::WeightedEdge>& pattern_edges) const {
-  // each map is costed, sorted and returned
-  // only equal best costed maps are returned
-  std::vector<boost::bimap<Qubit, Node>> return_placement_maps;
-  double best_cost = 0;
-  QubitGraph q_graph =
-      this->construct_pattern_graph(pattern_edges, circ_.n_qubits());
-  for (const boost::bimap<Qubit, Node>& map : placement_maps) {
-    double cost = this->cost_placement(map, circ_, q_graph);
-    if (return_placement_maps.empty() || cost < best_cost) {
-      best_cost = cost;
-      return_placement_maps = {map};
-    } else if (cost == best_cost) {
-      return_placement_maps.push_back(map);
+std::vector<double> NoiseAwarePlacement::cost_placements(
+    const std::vector<boost::bimap<Qubit, Node>>& maps,
+    const PatternCost& pattern_cost) const {
+  std::vector<double> costs(maps.size());
+  const auto cost_range = [&](unsigned begin, unsigned end) {
+    std::vector<unsigned> node_qubits(
+        this->node_costs_.size(), pattern_cost.qubit_indices.size());
+    for (unsigned i = begin; i < end; i++) {
+      costs[i] = this->cost_placement(maps[i], pattern_cost, node_qubits);
     }
+  };
+  // Only worth splitting if each thread has a reasonable share.
+  constexpr unsigned min_maps_per_thread = 16;
+  const unsigned n_threads = std::max<unsigned>(
+      1, std::min<unsigned>(
+             this->search_threads_, maps.size() / min_maps_per_thread));
+  if (n_threads == 1) {
+    cost_range(0, maps.size());
+    return costs;
+  }
+  std::vector<std::thread> threads;
+  const unsigned chunk = (maps.size() + n_threads - 1) / n_threads;
+  for (unsigned begin = chunk; begin < maps.size(); begin += chunk) {
+    threads.emplace_back(
+        cost_range, begin, std::min<unsigned>(begin + chunk, maps.size()));
   }
-  return return_placement_maps;
+  cost_range(0, chunk);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return costs;
 }
 
 std::vector<std::map<Qubit, Node>> NoiseAwarePlacement::get_all_placement_maps(
     const Circuit& circ_, unsigned matches) const {
   std::vector<WeightedEdge> weighted_pattern_edges =
       this->default_pattern_weighting(circ_);
-  std::vector<boost::bimap<Qubit, Node>> placement_maps =
-      this->get_all_weighted_subgraph_monomorphisms(
-          circ_, weighted_pattern_edges, true);
-  std::vector<boost::bimap<Qubit, Node>> ranked_placement_maps =
-      this->rank_maps(placement_maps, circ_, weighted_pattern_edges);
-  std::vector<std::map<Qubit, Node>> all_qmaps;
-  QubitGraph::UndirectedConnGraph pattern_graph =
-      this->construct_pattern_graph(weighted_pattern_edges, circ_.n_qubits())
-          .get_undirected_connectivity();
-  for (unsigned i = 0; i < ranked_placement_maps.size() && i < matches; i++) {
-    all_qmaps.push_back(convert_bimap(ranked_placement_maps[i], pattern_graph));
-  }
-  return all_qmaps;
+  const PatternCost pattern_cost = this->get_pattern_cost(
+      circ_,
+      this->construct_pattern_graph(weighted_pattern_edges, circ_.n_qubits()));
+  // Only maps with the equal best WSM score are costed, and only the first
+  // "matches" of the equal best costed maps among them are kept.
+  // Maps are costed in batches, in the order they are found.
+  constexpr unsigned batch_size = 256;
+  std::vector<boost::bimap<Qubit, Node>> best_maps;
+  std::vector<boost::bimap<Qubit, Node>> batch;
+  std::uint64_t best_scalar_product = 0;
+  double best_cost = 0;
+  bool costed_any = false;
+  const auto cost_batch = [&]() {
+    const std::vector<double> costs =
+        this->cost_placements(batch, pattern_cost);
+    for (unsigned i = 0; i < batch.size(); i++) {
+      if (!costed_any || costs[i] < best_cost) {
+        costed_any = true;
+        best_cost = costs[i];
+        best_maps.clear();
+      } else if (costs[i] != best_cost) {
+        continue;
+      }
+      if (best_maps.size() < matches) {
+        best_maps.push_back(std::move(batch[i]));
+      }
+    }
+    batch.clear();
+  };
+  this->for_each_weighted_subgraph_monomorphism(
+      circ_, weighted_pattern_edges,
+      [&](const boost::bimap<Qubit, Node>& map, std::uint64_t scalar_product) {
+        const bool first = !costed_any && batch.empty();
+        if (!first && scalar_product < best_scalar_product) {
+          return true;
+        }
+        if (first || scalar_product > best_scalar_product) {
+          best_scalar_product = scalar_product;
+          costed_any = false;
+          best_maps.clear();
+          batch.clear();
+        }
+        batch.push_back(map);
+        if (batch.size() == batch_size) {
+          cost_batch();
+        }
+        return true;
+      });
+  cost_batch();
+  return convert_bimaps(
+      best_maps, weighted_pattern_edges, circ_.n_qubits(), matches);
 }
 
 DeviceCharacterisation NoiseAwarePlacement::get_characterisation() const {
@@ -145,6 +253,7 @@ DeviceCharacterisation NoiseAwarePlacement::get_characterisation() const {
 void NoiseAwarePlacement::set_characterisation(
     const DeviceCharacterisation& characterisation) {
   this->characterisation_ = characterisation;
+  this->set_node_costs();
 }
 
 }  // namespace tket
\ No newline at end of file
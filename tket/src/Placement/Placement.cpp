@@ -141,6 +141,8 @@ void to_json(nlohmann::json& j, const Placement::Ptr& placement_ptr) {
     j["maximum_pattern_gates"] = cast_placer->get_maximum_pattern_gates();
     j["maximum_pattern_depth"] = cast_placer->get_maximum_pattern_depth();
     j["characterisation"] = cast_placer->get_characterisation();
+    j["search_threads"] = cast_placer->get_search_threads();
+    j["pattern_depth_decay"] = cast_placer->get_pattern_depth_decay();
   } else if (
       std::shared_ptr<GraphPlacement> cast_placer =
           std::dynamic_pointer_cast<GraphPlacement>(placement_ptr)) {
@@ -149,6 +151,18 @@ void to_json(nlohmann::json& j, const Placement::Ptr& placement_ptr) {
     j["timeout"] = cast_placer->get_timeout();
     j["maximum_pattern_gates"] = cast_placer->get_maximum_pattern_gates();
     j["maximum_pattern_depth"] = cast_placer->get_maximum_pattern_depth();
+    j["search_threads"] = cast_placer->get_search_threads();
+    j["pattern_depth_decay"] = cast_placer->get_pattern_depth_decay();
+  } else if (
+      std::shared_ptr<HierarchicalPlacement> cast_placer =
+          std::dynamic_pointer_cast<HierarchicalPlacement>(placement_ptr)) {
+    j["type"] = "HierarchicalPlacement";
+    j["region_size"] = cast_placer->get_region_size();
+    j["matches"] = cast_placer->get_maximum_matches();
+    j["timeout"] = cast_placer->get_timeout();
+    j["maximum_pattern_gates"] = cast_placer->get_maximum_pattern_gates();
+    j["maximum_pattern_depth"] = cast_placer->get_maximum_pattern_depth();
+    j["threads"] = cast_placer->get_threads();
   } else {
     j["type"] = "Placement";
   }
@@ -162,8 +176,17 @@ void from_json(const nlohmann::json& j, Placement::Ptr& placement_ptr) {
     unsigned timeout = j.at("timeout").get<unsigned>();
     unsigned max_pattern_gates = j.at("maximum_pattern_gates").get<unsigned>();
     unsigned max_pattern_depth = j.at("maximum_pattern_depth").get<unsigned>();
+    unsigned search_threads = 1;
+    if (j.contains("search_threads")) {
+      search_threads = j.at("search_threads").get<unsigned>();
+    }
+    double pattern_depth_decay = 0;
+    if (j.contains("pattern_depth_decay")) {
+      pattern_depth_decay = j.at("pattern_depth_decay").get<double>();
+    }
     placement_ptr = std::make_shared<GraphPlacement>(
-        arc, matches, timeout, max_pattern_gates, max_pattern_depth);
+        arc, matches, timeout, max_pattern_gates, max_pattern_depth,
+        search_threads, pattern_depth_decay);
   } else if (classname == "LinePlacement") {
     unsigned max_pattern_gates = j.at("maximum_pattern_gates").get<unsigned>();
     unsigned max_pattern_depth = j.at("maximum_pattern_depth").get<unsigned>();
@@ -177,15 +200,34 @@ void from_json(const nlohmann::json& j, Placement::Ptr& placement_ptr) {
     unsigned max_pattern_depth = j.at("maximum_pattern_depth").get<unsigned>();
     DeviceCharacterisation characterisation =
         j.at("characterisation").get<DeviceCharacterisation>();
+    unsigned search_threads = 1;
+    if (j.contains("search_threads")) {
+      search_threads = j.at("search_threads").get<unsigned>();
+    }
+    double pattern_depth_decay = 0;
+    if (j.contains("pattern_depth_decay")) {
+      pattern_depth_decay = j.at("pattern_depth_decay").get<double>();
+    }
     avg_node_errors_t empty_node_errors = {};
     avg_readout_errors_t empty_readout_errors = {};
     avg_link_errors_t empty_link_errors = {};
     std::shared_ptr<NoiseAwarePlacement> nap =
         std::make_shared<NoiseAwarePlacement>(
             arc, empty_node_errors, empty_link_errors, empty_readout_errors,
-            matches, timeout, max_pattern_gates, max_pattern_depth);
+            matches, timeout, max_pattern_gates, max_pattern_depth,
+            search_threads, pattern_depth_decay);
     nap->set_characterisation(characterisation);
     placement_ptr = nap;
+  } else if (classname == "HierarchicalPlacement") {
+    unsigned region_size = j.at("region_size").get<unsigned>();
+    unsigned matches = j.at("matches").get<unsigned>();
+    unsigned timeout = j.at("timeout").get<unsigned>();
+    unsigned max_pattern_gates = j.at("maximum_pattern_gates").get<unsigned>();
+    unsigned max_pattern_depth = j.at("maximum_pattern_depth").get<unsigned>();
+    unsigned threads = j.at("threads").get<unsigned>();
+    placement_ptr = std::make_shared<HierarchicalPlacement>(
+        arc, region_size, matches, timeout, max_pattern_gates,
+        max_pattern_depth, threads);
   } else {
     placement_ptr = std::make_shared<Placement>(arc);
   }
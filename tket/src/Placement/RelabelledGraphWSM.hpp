@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <optional>
 #include <stdexcept>
 #include <tkassert/Assert.hpp>
 #include <tkwsm/Common/GeneralUtils.hpp>
@@ -88,9 +89,14 @@ class RelabelledGraphWSM {
     return m_original_vertices;
   }
 
+  // Null if the vertex is not in the graph.
+  std::optional<VertexWSM> get_relabelled_vertex_opt(
+      const VertexType& original_vertex) const {
+    return get_optional_value(m_old_to_new_vertex_map, original_vertex);
+  }
+
   VertexWSM get_relabelled_vertex(const VertexType& original_vertex) const {
-    const auto v_opt =
-        get_optional_value(m_old_to_new_vertex_map, original_vertex);
+    const auto v_opt = get_relabelled_vertex_opt(original_vertex);
     if (!v_opt) {
       throw std::runtime_error("Original vertex has no new label");
     }
@@ -0,0 +1,215 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Predicates/CachedPass.hpp"
+
+#include <boost/functional/hash.hpp>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <tklog/TketLog.hpp>
+
+#include "tket/Utils/Json.hpp"
+#include "tket/Utils/UnitID.hpp"
+
+namespace tket {
+
+static bool is_identity(const unit_bimap_t& m) {
+  for (const auto& entry : m.left) {
+    if (entry.first != entry.second) return false;
+  }
+  return true;
+}
+
+CachedPass::CachedPass(
+    const PassPtr& pass, std::size_t capacity,
+    const std::optional<std::string>& directory)
+    : pass_(pass),
+      config_(pass->get_config().dump()),
+      capacity_(capacity),
+      directory_(directory),
+      hits_(0),
+      misses_(0) {
+  if (capacity == 0) {
+    throw std::invalid_argument("CachedPass capacity must be positive");
+  }
+  std::tie(precons_, postcons_) = pass->get_conditions();
+}
+
+bool CachedPass::apply(
+    CompilationUnit& c_unit, SafetyMode safe_mode,
+    const PassCallback& before_apply, const PassCallback& after_apply) const {
+  if (!is_identity(c_unit.maps->initial) || !is_identity(c_unit.maps->final)) {
+    return pass_->apply(c_unit, safe_mode, before_apply, after_apply);
+  }
+  const std::size_t hash = c_unit.circ_.structural_hash();
+  std::optional<Entry> entry = find(hash, c_unit.circ_);
+  if (entry) {
+    // The same circuit satisfied the preconditions when it was compiled
+    before_apply(c_unit, get_config());
+    c_unit.circ_ = entry->output;
+    *c_unit.maps = entry->maps;
+    update_cache(c_unit, safe_mode);
+    after_apply(c_unit, get_config());
+    return entry->modified;
+  }
+  Circuit input = c_unit.circ_;
+  bool modified = pass_->apply(c_unit, safe_mode, before_apply, after_apply);
+  Entry result{input, c_unit.circ_, *c_unit.maps, modified};
+  insert(hash, result);
+  store(hash, result);
+  return modified;
+}
+
+bool CachedPass::apply_with_substitution(
+    CompilationUnit& c_unit, const symbol_map_t& symbol_map,
+    SafetyMode safe_mode) const {
+  bool modified = apply(c_unit, safe_mode);
+  c_unit.circ_.symbol_substitution(symbol_map);
+  c_unit.empty_cache();
+  c_unit.initialize_cache();
+  return modified;
+}
+
+std::string CachedPass::to_string() const {
+  return "***PassType: CachedPass***\n" + pass_->to_string();
+}
+
+nlohmann::json CachedPass::get_config() const { return pass_->get_config(); }
+
+std::size_t CachedPass::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+unsigned CachedPass::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+unsigned CachedPass::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+void CachedPass::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lookup_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+std::optional<CachedPass::Entry> CachedPass::find(
+    std::size_t hash, const Circuit& circ) const {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = lookup_.find(hash);
+    if (found != lookup_.end() && found->second->second.input == circ) {
+      ++hits_;
+      entries_.splice(entries_.begin(), entries_, found->second);
+      return found->second->second;
+    }
+  }
+  std::optional<Entry> entry = load(hash, circ);
+  if (entry) {
+    insert(hash, *entry);
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (entry) {
+    ++hits_;
+  } else {
+    ++misses_;
+  }
+  return entry;
+}
+
+void CachedPass::insert(std::size_t hash, const Entry& entry) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = lookup_.find(hash);
+  if (found != lookup_.end()) {
+    found->second->second = entry;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return;
+  }
+  if (entries_.size() == capacity_) {
+    lookup_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.push_front({hash, entry});
+  lookup_.insert({hash, entries_.begin()});
+}
+
+std::optional<CachedPass::Entry> CachedPass::load(
+    std::size_t hash, const Circuit& circ) const {
+  if (!directory_) return std::nullopt;
+  std::ifstream in(file_path(hash));
+  if (!in) return std::nullopt;
+  try {
+    nlohmann::json j = nlohmann::json::parse(in);
+    if (j.at("config").get<std::string>() != config_) return std::nullopt;
+    Circuit input = j.at("input").get<Circuit>();
+    if (!(input == circ)) return std::nullopt;
+    Entry entry{
+        input,
+        j.at("output").get<Circuit>(),
+        {unit_bimap_from_json(j.at("initial_map")),
+         unit_bimap_from_json(j.at("final_map"))},
+        j.at("modified").get<bool>()};
+    return entry;
+  } catch (const std::exception& e) {
+    TKET_LOG_WARN(
+        "Ignoring unreadable CachedPass file " << file_path(hash) << ": "
+                                               << e.what());
+    return std::nullopt;
+  }
+}
+
+void CachedPass::store(std::size_t hash, const Entry& entry) const {
+  if (!directory_) return;
+  nlohmann::json j;
+  j["config"] = config_;
+  j["input"] = entry.input;
+  j["output"] = entry.output;
+  j["initial_map"] = unit_bimap_to_json(entry.maps.initial);
+  j["final_map"] = unit_bimap_to_json(entry.maps.final);
+  j["modified"] = entry.modified;
+  // Write then rename, so that concurrent readers never see a partial file
+  const std::string path = file_path(hash);
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp" << std::hash<std::thread::id>{}(
+                                    std::this_thread::get_id());
+  {
+    std::ofstream out(tmp_path.str());
+    if (!out) {
+      TKET_LOG_WARN("Cannot write CachedPass file " << path);
+      return;
+    }
+    out << j.dump();
+  }
+  std::rename(tmp_path.str().c_str(), path.c_str());
+}
+
+std::string CachedPass::file_path(std::size_t hash) const {
+  std::size_t seed = std::hash<std::string>{}(config_);
+  boost::hash_combine(seed, hash);
+  std::stringstream ss;
+  ss << *directory_ << "/" << std::hex << seed << ".json";
+  return ss.str();
+}
+
+}  // namespace tket
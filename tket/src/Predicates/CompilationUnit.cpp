@@ -16,6 +16,7 @@
 
 #include <memory>
 
+#include "tket/Utils/Json.hpp"
 #include "tket/Utils/UnitID.hpp"
 namespace tket {
 
@@ -48,6 +49,76 @@ bool CompilationUnit::calc_predicate(const Predicate& pred) const {
   return pred.verify(circ_);
 }
 
+bool CompilationUnit::audit_predicate(const TypePredicatePair& pred) const {
+  const Circuit::ChangeLog* log = circ_.get_change_log();
+  std::map<std::type_index, AuditRecord>::const_iterator found =
+      audited_.find(pred.first);
+  bool incremental = false;
+  if (log && found != audited_.end() && found->second.log_id == log->id) {
+    try {
+      incremental = found->second.pred == pred.second ||
+                    found->second.pred->implies(*pred.second);
+    } catch (const IncorrectPredicate&) {
+    }
+  }
+  bool holds =
+      incremental
+          ? pred.second->verify_changes(circ_, *log, found->second.count)
+          : pred.second->verify(circ_);
+  if (holds && log) {
+    audited_[pred.first] = {pred.second, log->id, log->count};
+  } else {
+    audited_.erase(pred.first);
+  }
+  return holds;
+}
+
+nlohmann::json CompilationUnit::serialize() const {
+  nlohmann::json j;
+  j["circuit"] = circ_;
+  j["initial_map"] = unit_bimap_to_json(maps->initial);
+  j["final_map"] = unit_bimap_to_json(maps->final);
+  nlohmann::json targets = nlohmann::json::array();
+  for (const TypePredicatePair& pp : target_preds) {
+    targets.push_back(pp.second);
+  }
+  j["target_predicates"] = targets;
+  nlohmann::json satisfied = nlohmann::json::array();
+  for (const PredicateCache::value_type& entry : cache_) {
+    if (!entry.second.second) continue;
+    try {
+      satisfied.push_back(entry.second.first);
+    } catch (const PredicateNotSerializable&) {
+    }
+  }
+  j["satisfied_predicates"] = satisfied;
+  return j;
+}
+
+CompilationUnit CompilationUnit::deserialize(const nlohmann::json& j) {
+  CompilationUnit c_unit(j.at("circuit").get<Circuit>());
+  c_unit.maps->initial = unit_bimap_from_json(j.at("initial_map"));
+  c_unit.maps->final = unit_bimap_from_json(j.at("final_map"));
+  for (const nlohmann::json& pred : j.at("target_predicates")) {
+    c_unit.target_preds.insert(make_type_pair(pred.get<PredicatePtr>()));
+  }
+  // Trust the cache rather than checking the predicates again
+  for (const nlohmann::json& pred : j.at("satisfied_predicates")) {
+    TypePredicatePair pp = make_type_pair(pred.get<PredicatePtr>());
+    c_unit.cache_[pp.first] = {pp.second, true};
+  }
+  return c_unit;
+}
+
+std::vector<std::uint8_t> CompilationUnit::to_bytes() const {
+  return nlohmann::json::to_msgpack(serialize());
+}
+
+CompilationUnit CompilationUnit::from_bytes(
+    const std::vector<std::uint8_t>& bytes) {
+  return deserialize(nlohmann::json::from_msgpack(bytes));
+}
+
 bool CompilationUnit::check_all_predicates() const {
   for (const TypePredicatePair& ref_pred : target_preds) {
     if (!calc_predicate(*ref_pred.second)) return false;
@@ -14,15 +14,25 @@
 
 #include "tket/Predicates/CompilerPass.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
 #include <tklog/TketLog.hpp>
+#include <utility>
 
 #include "tket/Mapping/RoutingMethodJson.hpp"
 #include "tket/Predicates/PassGenerators.hpp"
 #include "tket/Predicates/PassLibrary.hpp"
+#include "tket/Transformations/Combinator.hpp"
 #include "tket/Transformations/ContextualReduction.hpp"
 #include "tket/Transformations/PauliOptimisation.hpp"
 #include "tket/Utils/Json.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 #include "tket/Utils/UnitID.hpp"
 
 namespace tket {
@@ -54,6 +64,56 @@ std::string BasePass::to_string() const {
   return str;
 };
 
+std::vector<bool> BasePass::apply_batch(
+    std::vector<CompilationUnit>& c_units, unsigned n_threads,
+    SafetyMode safe_mode) const {
+  const std::size_t n = c_units.size();
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const std::size_t number_of_threads =
+      std::min<std::size_t>(n_threads, std::max<std::size_t>(n, 1));
+  // Not std::vector<bool>, whose elements cannot be written concurrently
+  std::vector<char> results(n, false);
+  std::vector<std::exception_ptr> errors(n);
+  // With several threads, units after a failing one may already have been
+  // claimed, so keep the originals to restore them.
+  std::vector<std::optional<CompilationUnit>> originals(
+      number_of_threads > 1 ? n : 0);
+  std::atomic<std::size_t> next_index{0};
+  auto work = [&]() {
+    for (std::size_t index = next_index++; index < n; index = next_index++) {
+      if (!originals.empty()) originals[index].emplace(c_units[index]);
+      try {
+        results[index] = apply(c_units[index], safe_mode);
+      } catch (...) {
+        errors[index] = std::current_exception();
+        next_index = n;
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  // Units are claimed in order, so every unit before the first failure ran
+  for (std::size_t index = 0; index < n; ++index) {
+    if (errors[index]) {
+      for (std::size_t later = index + 1; later < n; ++later) {
+        if (!originals.empty() && originals[later]) {
+          c_units[later] = std::move(*originals[later]);
+        }
+      }
+      std::rethrow_exception(errors[index]);
+    }
+  }
+  return std::vector<bool>(results.begin(), results.end());
+}
+
 std::optional<PredicatePtr> BasePass::unsatisfied_precondition(
     const CompilationUnit& c_unit, SafetyMode safe_mode) const {
   for (const TypePredicatePair& pp : precons_) {
@@ -76,7 +136,7 @@ std::optional<PredicatePtr> BasePass::unsatisfied_precondition(
   }
   if (safe_mode == SafetyMode::Audit) {
     for (const TypePredicatePair& pp : precons_) {
-      if (!c_unit.calc_predicate(*pp.second)) return pp.second;
+      if (!c_unit.audit_predicate(pp)) return pp.second;
     }
   }
   return {};
@@ -98,7 +158,7 @@ void BasePass::update_cache(
     }
   }
   for (const TypePredicatePair& pp : postcons_.specific_postcons_) {
-    if (safe_mode == SafetyMode::Audit && !pp.second->verify(c_unit.circ_))
+    if (safe_mode == SafetyMode::Audit && !c_unit.audit_predicate(pp))
       throw UnsatisfiedPredicate(pp.second->to_string());
     std::pair<PredicatePtr, bool> cache_pair{pp.second, true};
     c_unit.cache_[pp.first] = cache_pair;
@@ -190,15 +250,30 @@ PassConditions BasePass::match_passes(const PassPtr& lhs, const PassPtr& rhs) {
 bool StandardPass::apply(
     CompilationUnit& c_unit, SafetyMode safe_mode,
     const PassCallback& before_apply, const PassCallback& after_apply) const {
+  c_unit.cancellation_token_.throw_if_cancelled();
+  // Transforms typically need at least a copy's worth of the circuit.
+  if (memory::get_budget()) memory::check_budget(c_unit.circ_.memory_usage());
   before_apply(c_unit, this->get_config());
+  // Let audits check only what the transform changes
+  if (safe_mode == SafetyMode::Audit) c_unit.circ_.record_changes();
   std::optional<PredicatePtr> unsatisfied_precon =
       unsatisfied_precondition(c_unit, safe_mode);
   if (unsatisfied_precon)
     throw UnsatisfiedPredicate(
         unsatisfied_precon.value()
             ->to_string());  // just raise warning in super-unsafe mode
-  // Allow trans_ to update the initial and final map
-  bool changed = trans_.apply_fn(c_unit.circ_, c_unit.maps);
+  bool changed;
+  try {
+    CancellationScope scope(c_unit.cancellation_token_);
+    // Allow trans_ to update the initial and final map
+    changed = trans_.apply_fn(c_unit.circ_, c_unit.maps);
+  } catch (const CompilationCancelled&) {
+    // The circuit may have been partly transformed
+    for (PredicateCache::value_type& entry : c_unit.cache_) {
+      entry.second.second = false;
+    }
+    throw;
+  }
   update_cache(c_unit, safe_mode);
   after_apply(c_unit, this->get_config());
   return changed;
@@ -227,7 +302,7 @@ PassPtr operator>>(const PassPtr& lhs, const PassPtr& rhs) {
   return sequence;
 }
 
-SequencePass::SequencePass(const std::vector<PassPtr>& ptvec) {
+SequencePass::SequencePass(const std::vector<PassPtr>& ptvec, bool fuse) {
   if (ptvec.size() == 0)
     throw std::logic_error("Cannot generate CompilerPass from empty list");
   std::vector<PassPtr>::const_iterator iter = ptvec.begin();
@@ -239,6 +314,60 @@ SequencePass::SequencePass(const std::vector<PassPtr>& ptvec) {
   this->precons_ = conditions.first;
   this->postcons_ = conditions.second;
   this->seq_ = ptvec;
+  this->fuse_ = fuse;
+  if (fuse) this->plan_ = fuse_local_rewrites(ptvec);
+}
+
+// StandardPasses that rewrite the circuit in place without renaming units
+static bool is_local_rewrite(const PassPtr& pass) {
+  static const std::set<std::string> local_rewrites = {
+      "CommuteThroughMultis",     "DecomposeBoxes",
+      "DecomposeBridges",         "DecomposeMultiQubitsCX",
+      "DecomposeSingleQubitsTK1", "EulerAngleReduction",
+      "NormaliseTK2",             "RebaseCustom",
+      "RebaseCustomViaTK2",       "RebaseTket",
+      "RebaseUFR",                "RemoveBarriers",
+      "RemoveRedundancies",       "SquashCustom",
+      "SquashRzPhasedX",          "SquashTK1",
+      "SynthesiseHQS",            "SynthesiseOQC",
+      "SynthesiseTK",             "SynthesiseTket",
+      "SynthesiseUMD",            "ZZPhaseToRz"};
+  if (!std::dynamic_pointer_cast<StandardPass>(pass)) return false;
+  const nlohmann::json& config = pass->get_config().at("StandardPass");
+  return local_rewrites.contains(config.value("name", ""));
+}
+
+std::vector<PassPtr> SequencePass::fuse_local_rewrites(
+    const std::vector<PassPtr>& ptvec) {
+  std::vector<PassPtr> plan;
+  std::vector<PassPtr>::const_iterator it = ptvec.begin();
+  while (it != ptvec.end()) {
+    std::vector<PassPtr>::const_iterator end = it;
+    while (end != ptvec.end() && is_local_rewrite(*end)) ++end;
+    if (end - it < 2) {
+      plan.push_back(*it);
+      ++it;
+      continue;
+    }
+    PassConditions conditions = (*it)->get_conditions();
+    std::vector<Transform> transforms;
+    nlohmann::json configs = nlohmann::json::array();
+    for (; it != end; ++it) {
+      if (!transforms.empty()) {
+        conditions = match_passes(conditions, (*it)->get_conditions());
+      }
+      transforms.push_back(
+          std::static_pointer_cast<StandardPass>(*it)->get_transform());
+      configs.push_back((*it)->get_config());
+    }
+    nlohmann::json config;
+    config["name"] = "FusedPass";
+    config["sequence"] = configs;
+    plan.push_back(std::make_shared<StandardPass>(
+        conditions.first, Transforms::sequence(transforms), conditions.second,
+        config));
+  }
+  return plan;
 }
 
 std::string SequencePass::to_string() const {
@@ -287,14 +416,21 @@ bool RepeatWithMetricPass::apply(
   unsigned currentVal = metric_(c_unit.get_circ_ref());
   CompilationUnit* c_unit_current = &c_unit;
   CompilationUnit c_unit_new = c_unit;
-  pass_->apply(
-      c_unit_new, safe_mode);  // I can't make it apply the pass to a copy
-                               // without copying the whole CompilationUnit
+  // I can't make it apply the pass to a copy without copying the whole
+  // CompilationUnit
+  pass_->apply(c_unit_new, safe_mode, before_apply, after_apply);
   unsigned newVal = metric_(c_unit_new.get_circ_ref());
   while (newVal < currentVal) {
     c_unit_current = &c_unit_new;
     currentVal = newVal;
     success = true;
+    try {
+      c_unit.get_cancellation_token().throw_if_cancelled();
+    } catch (const CompilationCancelled&) {
+      // Keep the best result so far
+      c_unit = c_unit_new;
+      throw;
+    }
     pass_->apply(c_unit_new, safe_mode, before_apply, after_apply);
     newVal = metric_(c_unit_new.get_circ_ref());
   }
@@ -438,6 +574,8 @@ void from_json(const nlohmann::json& j, PassPtr& pp) {
       pp = SimplifyMeasured();
     } else if (passname == "RemoveBarriers") {
       pp = RemoveBarriers();
+    } else if (passname == "CliffordBlockResynthesis") {
+      pp = CliffordBlockResynthesis();
     } else if (passname == "ComposePhasePolyBoxes") {
       pp = ComposePhasePolyBoxes(content.at("min_size").get<unsigned>());
     } else if (passname == "RebaseCustom") {
@@ -453,7 +591,15 @@ void from_json(const nlohmann::json& j, PassPtr& pp) {
     } else if (passname == "RoutingPass") {
       Architecture arc = content.at("architecture").get<Architecture>();
       std::vector<RoutingMethodPtr> con = content.at("routing_config");
-      pp = gen_routing_pass(arc, con);
+      unsigned refinement_sweeps = 0;
+      if (content.contains("refinement_sweeps")) {
+        refinement_sweeps = content.at("refinement_sweeps").get<unsigned>();
+      }
+      unsigned timeout = 0;
+      if (content.contains("timeout")) {
+        timeout = content.at("timeout").get<unsigned>();
+      }
+      pp = gen_routing_pass(arc, con, refinement_sweeps, timeout);
 
     } else if (passname == "PlacementPass") {
       pp = gen_placement_pass(content.at("placement").get<Placement::Ptr>());
@@ -476,6 +622,8 @@ void from_json(const nlohmann::json& j, PassPtr& pp) {
       pp = DecomposeBridges();
     } else if (passname == "CnXPairwiseDecomposition") {
       pp = CnXPairwiseDecomposition();
+    } else if (passname == "CnXAncillaDecomposition") {
+      pp = CnXAncillaDecomposition();
     } else if (passname == "RemoveImplicitQubitPermutation") {
       pp = RemoveImplicitQubitPermutation();
     } else if (passname == "OptimisePhaseGadgets") {
@@ -578,4 +726,12 @@ void from_json(const nlohmann::json& j, PassPtr& pp) {
   }
 }
 
+std::vector<std::uint8_t> pass_to_bytes(const PassPtr& pass) {
+  return nlohmann::json::to_msgpack(nlohmann::json(pass));
+}
+
+PassPtr pass_from_bytes(const std::vector<std::uint8_t>& bytes) {
+  return nlohmann::json::from_msgpack(bytes).get<PassPtr>();
+}
+
 }  // namespace tket
@@ -0,0 +1,287 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Predicates/DistributedCompilation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "tket/Predicates/CachedPass.hpp"
+
+namespace tket {
+
+// Replace every "architecture" member within a pass configuration.
+static void set_architectures(
+    nlohmann::json& config, const nlohmann::json& value) {
+  if (config.is_object()) {
+    for (auto it = config.begin(); it != config.end(); ++it) {
+      if (it.key() == "architecture") {
+        it.value() = value;
+      } else {
+        set_architectures(it.value(), value);
+      }
+    }
+  } else if (config.is_array()) {
+    for (nlohmann::json& element : config) {
+      set_architectures(element, value);
+    }
+  }
+}
+
+static std::vector<std::uint8_t> get_bytes(const nlohmann::json& j) {
+  const nlohmann::json::binary_t& bytes = j.get_binary();
+  return std::vector<std::uint8_t>(bytes.begin(), bytes.end());
+}
+
+// Run work(i) for i in [0, n) on up to n_threads threads, claiming indices
+// in order as threads become free.
+template <typename Work>
+static void share_out(std::size_t n, unsigned n_threads, const Work& work) {
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::atomic<std::size_t> next_index{0};
+  auto loop = [&]() {
+    for (std::size_t i = next_index++; i < n; i = next_index++) work(i);
+  };
+  const std::size_t number_of_threads =
+      std::min<std::size_t>(n_threads, std::max<std::size_t>(n, 1));
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    threads.emplace_back(loop);
+  }
+  loop();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+CompilationTask CompilationTask::make(
+    const std::string& id, const CompilationUnit& c_unit, const PassPtr& pass,
+    const std::optional<std::string>& architecture_id) {
+  CompilationTask task{
+      id, c_unit.to_bytes(), nlohmann::json(pass), architecture_id};
+  if (architecture_id) set_architectures(task.pass, *architecture_id);
+  return task;
+}
+
+nlohmann::json CompilationTask::serialize() const {
+  nlohmann::json j;
+  j["id"] = id;
+  j["unit"] = nlohmann::json::binary(unit);
+  j["pass"] = pass;
+  if (architecture_id) j["architecture_id"] = *architecture_id;
+  return j;
+}
+
+CompilationTask CompilationTask::deserialize(const nlohmann::json& j) {
+  CompilationTask task;
+  task.id = j.at("id").get<std::string>();
+  task.unit = get_bytes(j.at("unit"));
+  task.pass = j.at("pass");
+  if (j.contains("architecture_id")) {
+    task.architecture_id = j.at("architecture_id").get<std::string>();
+  }
+  return task;
+}
+
+CompilationUnit CompilationResult::get_unit() const {
+  if (error) {
+    throw std::runtime_error("Compilation task " + id + " failed: " + *error);
+  }
+  return CompilationUnit::from_bytes(unit);
+}
+
+nlohmann::json CompilationResult::serialize() const {
+  nlohmann::json j;
+  j["id"] = id;
+  j["unit"] = nlohmann::json::binary(unit);
+  j["modified"] = modified;
+  if (error) j["error"] = *error;
+  j["seconds"] = seconds;
+  return j;
+}
+
+CompilationResult CompilationResult::deserialize(const nlohmann::json& j) {
+  CompilationResult result;
+  result.id = j.at("id").get<std::string>();
+  result.unit = get_bytes(j.at("unit"));
+  result.modified = j.at("modified").get<bool>();
+  if (j.contains("error")) result.error = j.at("error").get<std::string>();
+  result.seconds = j.at("seconds").get<double>();
+  return result;
+}
+
+CompilationWorker::CompilationWorker(
+    unsigned n_threads, std::size_t cache_capacity)
+    : n_threads_(n_threads), cache_capacity_(cache_capacity) {}
+
+void CompilationWorker::add_architecture(
+    const std::string& id, const Architecture& arc) {
+  nlohmann::json j = architecture_to_json_with_precomputed(arc);
+  std::lock_guard<std::mutex> lock(mutex_);
+  architectures_[id] = std::move(j);
+}
+
+std::size_t CompilationWorker::n_passes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return passes_.size();
+}
+
+PassPtr CompilationWorker::get_pass(const CompilationTask& task) {
+  std::pair<std::optional<std::string>, std::string> key{
+      task.architecture_id, task.pass.dump()};
+  nlohmann::json config = task.pass;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = passes_.find(key);
+    if (found != passes_.end()) return found->second;
+    if (task.architecture_id) {
+      auto arc = architectures_.find(*task.architecture_id);
+      if (arc == architectures_.end()) {
+        throw std::out_of_range(
+            "Architecture " + *task.architecture_id + " is not registered");
+      }
+      set_architectures(config, arc->second);
+    }
+  }
+  // Deserialised outside the lock; if another thread gets there first, its
+  // pass is kept.
+  PassPtr pass =
+      std::make_shared<CachedPass>(config.get<PassPtr>(), cache_capacity_);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return passes_.try_emplace(std::move(key), pass).first->second;
+}
+
+CompilationResult CompilationWorker::compile(const CompilationTask& task) {
+  CompilationResult result;
+  result.id = task.id;
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    const PassPtr pass = get_pass(task);
+    CompilationUnit c_unit = CompilationUnit::from_bytes(task.unit);
+    result.modified = pass->apply(c_unit);
+    result.unit = c_unit.to_bytes();
+  } catch (const std::exception& e) {
+    result.error = e.what();
+  }
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return result;
+}
+
+std::vector<CompilationResult> CompilationWorker::run(
+    const std::vector<CompilationTask>& tasks) {
+  std::vector<CompilationResult> results(tasks.size());
+  share_out(tasks.size(), n_threads_, [&](std::size_t i) {
+    results[i] = compile(tasks[i]);
+  });
+  return results;
+}
+
+std::vector<std::uint8_t> CompilationWorker::handle(
+    const std::vector<std::uint8_t>& request) {
+  const nlohmann::json j_request = nlohmann::json::from_msgpack(request);
+  std::vector<CompilationTask> tasks;
+  for (const nlohmann::json& j : j_request.at("tasks")) {
+    tasks.push_back(CompilationTask::deserialize(j));
+  }
+  nlohmann::json reply;
+  reply["results"] = nlohmann::json::array();
+  for (const CompilationResult& result : run(tasks)) {
+    reply["results"].push_back(result.serialize());
+  }
+  return nlohmann::json::to_msgpack(reply);
+}
+
+CompilationCoordinator::CompilationCoordinator(
+    const std::vector<Channel>& workers, std::size_t batch_size)
+    : workers_(workers), batch_size_(batch_size) {
+  if (workers.empty()) {
+    throw std::invalid_argument("CompilationCoordinator needs a worker");
+  }
+  if (batch_size == 0) {
+    throw std::invalid_argument("Batch size must be positive");
+  }
+}
+
+std::vector<CompilationResult> CompilationCoordinator::run(
+    const std::vector<CompilationTask>& tasks) const {
+  const unsigned n_workers = workers_.size();
+  // Split each worker's share of the tasks into batches of task indices.
+  std::vector<std::vector<std::size_t>> shares(n_workers);
+  for (std::size_t i = 0; i < tasks.size(); i++) {
+    const std::string key =
+        tasks[i].architecture_id.value_or("") + tasks[i].pass.dump();
+    shares[std::hash<std::string>{}(key) % n_workers].push_back(i);
+  }
+  std::vector<std::vector<std::vector<std::size_t>>> batches(n_workers);
+  for (unsigned w = 0; w < n_workers; w++) {
+    for (std::size_t i = 0; i < shares[w].size(); i += batch_size_) {
+      const auto first = shares[w].begin() + i;
+      batches[w].emplace_back(
+          first, first + std::min(batch_size_, shares[w].size() - i));
+    }
+  }
+  std::vector<std::atomic<std::size_t>> next_batch(n_workers);
+
+  std::vector<CompilationResult> results(tasks.size());
+  auto send = [&](unsigned w, const std::vector<std::size_t>& batch) {
+    nlohmann::json request;
+    request["tasks"] = nlohmann::json::array();
+    for (std::size_t i : batch) {
+      request["tasks"].push_back(tasks[i].serialize());
+    }
+    try {
+      const std::vector<std::uint8_t> reply_bytes =
+          workers_[w](nlohmann::json::to_msgpack(request));
+      const nlohmann::json reply =
+          nlohmann::json::from_msgpack(reply_bytes).at("results");
+      if (reply.size() != batch.size()) {
+        throw std::runtime_error("wrong number of results");
+      }
+      for (std::size_t k = 0; k < batch.size(); k++) {
+        results[batch[k]] = CompilationResult::deserialize(reply[k]);
+      }
+    } catch (const std::exception& e) {
+      for (std::size_t i : batch) {
+        results[i] = CompilationResult();
+        results[i].id = tasks[i].id;
+        results[i].error = "Worker " + std::to_string(w) +
+                           " failed: " + std::string(e.what());
+      }
+    }
+    for (std::size_t i : batch) results[i].worker = w;
+  };
+  // Each worker takes its own batches first, then helps with the others'.
+  share_out(n_workers, n_workers, [&](std::size_t w) {
+    for (unsigned k = 0; k < n_workers; k++) {
+      const unsigned share = (w + k) % n_workers;
+      for (std::size_t b = next_batch[share]++; b < batches[share].size();
+           b = next_batch[share]++) {
+        send(w, batches[share][b]);
+      }
+    }
+  });
+  return results;
+}
+
+}  // namespace tket
@@ -214,10 +214,9 @@ PassPtr gen_placement_pass(const Placement::Ptr& placement_ptr) {
     try {
       changed = placement_ptr->place(circ, maps);
     } catch (const std::runtime_error& e) {
-      std::stringstream ss;
-      ss << "PlacementPass failed with message: " << e.what()
-         << " Fall back to LinePlacement.";
-      tket_log()->warn(ss.str());
+      TKET_LOG_WARN(
+          "PlacementPass failed with message: "
+          << e.what() << " Fall back to LinePlacement.");
       Placement::Ptr line_placement_ptr = std::make_shared<LinePlacement>(
           placement_ptr->get_architecture_ref());
       changed = line_placement_ptr->place(circ, maps);
@@ -284,6 +283,21 @@ PassPtr gen_default_mapping_pass(const Architecture& arc, bool delay_measures) {
   return return_pass;
 }
 
+PassPtr gen_fast_compile_pass(
+    const Architecture& arc, unsigned routing_timeout) {
+  Architecture frozen = arc;
+  frozen.freeze();
+  PassPtr route = gen_routing_pass(
+      frozen,
+      {std::make_shared<LexiLabellingMethod>(),
+       std::make_shared<LexiRouteRoutingMethod>(1)},
+      0, routing_timeout);
+  PassPtr local =
+      RebaseTket() >> SquashTK1() >> RemoveRedundancies() >> SquashTK1();
+  return DecomposeBoxes() >> local >> route >>
+         gen_naive_placement_pass(frozen) >> local;
+}
+
 PassPtr gen_cx_mapping_pass(
     const Architecture& arc, const Placement::Ptr& placement_ptr,
     const std::vector<RoutingMethodPtr>& config, bool directed_cx,
@@ -301,11 +315,16 @@ PassPtr gen_cx_mapping_pass(
 }
 
 PassPtr gen_routing_pass(
-    const Architecture& arc, const std::vector<RoutingMethodPtr>& config) {
+    const Architecture& arc, const std::vector<RoutingMethodPtr>& config,
+    unsigned refinement_sweeps, unsigned timeout) {
   Transform::Transformation trans = [=](Circuit& circ,
                                         std::shared_ptr<unit_bimaps_t> maps) {
     MappingManager mm(std::make_shared<Architecture>(arc));
-    return mm.route_circuit_with_maps(circ, config, maps);
+    if (refinement_sweeps > 0) {
+      return mm.route_circuit_bidirectional(
+          circ, config, maps, refinement_sweeps);
+    }
+    return mm.route_circuit_with_maps(circ, config, maps, 0, timeout);
   };
   Transform t = Transform(trans);
 
@@ -335,6 +354,8 @@ PassPtr gen_routing_pass(
   j["name"] = "RoutingPass";
   j["routing_config"] = config;
   j["architecture"] = arc;
+  j["refinement_sweeps"] = refinement_sweeps;
+  if (timeout > 0) j["timeout"] = timeout;
 
   return std::make_shared<StandardPass>(precons, t, pc, j);
 }
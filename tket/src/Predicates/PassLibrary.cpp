@@ -23,6 +23,7 @@
 #include "tket/Predicates/PassGenerators.hpp"
 #include "tket/Predicates/Predicates.hpp"
 #include "tket/Transformations/BasicOptimisation.hpp"
+#include "tket/Transformations/CliffordBlockResynthesis.hpp"
 #include "tket/Transformations/Decomposition.hpp"
 #include "tket/Transformations/MeasurePass.hpp"
 #include "tket/Transformations/OptimisationPass.hpp"
@@ -337,6 +338,22 @@ const PassPtr &RemoveBarriers() {
   return pp;
 }
 
+const PassPtr &CliffordBlockResynthesis() {
+  static const PassPtr pp([]() {
+    Transform t = Transforms::clifford_block_resynthesis();
+    PredicatePtrMap s_ps;
+    PredicateClassGuarantees g_postcons{
+        {typeid(GateSetPredicate), Guarantee::Clear},
+        {typeid(ConnectivityPredicate), Guarantee::Clear},
+        {typeid(DirectednessPredicate), Guarantee::Clear}};
+    PostConditions postcon{s_ps, g_postcons, Guarantee::Preserve};
+    nlohmann::json j;
+    j["name"] = "CliffordBlockResynthesis";
+    return std::make_shared<StandardPass>(s_ps, t, postcon, j);
+  }());
+  return pp;
+}
+
 const PassPtr &DelayMeasures(const bool allow_partial) {
   auto f = [](bool allow_partial) {
     Transform t = Transforms::delay_measures(allow_partial);
@@ -460,6 +477,20 @@ const PassPtr &CnXPairwiseDecomposition() {
   return pp;
 }
 
+const PassPtr &CnXAncillaDecomposition() {
+  static const PassPtr pp([]() {
+    Transform t = Transforms::cnx_ancilla_decomposition();
+    PredicatePtrMap s_ps;
+    PredicateClassGuarantees g_postcons{
+        {typeid(GateSetPredicate), Guarantee::Clear}};
+    PostConditions postcon{s_ps, g_postcons, Guarantee::Preserve};
+    nlohmann::json j;
+    j["name"] = "CnXAncillaDecomposition";
+    return std::make_shared<StandardPass>(s_ps, t, postcon, j);
+  }());
+  return pp;
+}
+
 const PassPtr &RemoveImplicitQubitPermutation() {
   static const PassPtr pp([]() {
     Transform t = Transform([](Circuit &circ) {
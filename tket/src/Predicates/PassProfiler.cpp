@@ -0,0 +1,151 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Predicates/PassProfiler.hpp"
+
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+namespace tket {
+
+static std::string pass_name(const nlohmann::json& config) {
+  std::string pass_class = config.value("pass_class", "BasePass");
+  if (pass_class == "StandardPass" && config.contains("StandardPass")) {
+    return config["StandardPass"].value("name", pass_class);
+  }
+  return pass_class;
+}
+
+static double microseconds(
+    std::chrono::steady_clock::time_point from,
+    std::chrono::steady_clock::time_point to) {
+  return std::chrono::duration<double, std::micro>(to - from).count();
+}
+
+PassProfiler::PassProfiler() : origin_(std::chrono::steady_clock::now()) {}
+
+PassCallback PassProfiler::before_apply() {
+  return [this](const CompilationUnit& c_unit, const nlohmann::json& config) {
+    begin(c_unit, config);
+  };
+}
+
+PassCallback PassProfiler::after_apply() {
+  return [this](const CompilationUnit& c_unit, const nlohmann::json&) {
+    end(c_unit);
+  };
+}
+
+bool PassProfiler::apply(
+    const PassPtr& pass, CompilationUnit& c_unit, SafetyMode safe_mode) {
+  return pass->apply(c_unit, safe_mode, before_apply(), after_apply());
+}
+
+void PassProfiler::begin(
+    const CompilationUnit& c_unit, const nlohmann::json& config) {
+  const Circuit& circ = c_unit.get_circ_ref();
+  Record record;
+  record.name = pass_name(config);
+  if (!stack_.empty()) record.parent = stack_.back().record;
+  record.gates_before = circ.n_gates();
+  record.depth_before = circ.depth();
+  record.gates_after = record.gates_before;
+  record.depth_after = record.depth_before;
+  record.duration_us = 0.;
+  record.modified = false;
+  const std::size_t hash_before = circ.structural_hash();
+  // Start the clock after measuring the circuit
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  record.start_us = microseconds(origin_, start);
+  records_.push_back(record);
+  stack_.push_back({records_.size() - 1, start, hash_before});
+}
+
+void PassProfiler::end(const CompilationUnit& c_unit) {
+  std::chrono::steady_clock::time_point stop =
+      std::chrono::steady_clock::now();
+  if (stack_.empty()) {
+    throw std::logic_error("PassProfiler: pass finished without starting");
+  }
+  Frame frame = stack_.back();
+  stack_.pop_back();
+  const Circuit& circ = c_unit.get_circ_ref();
+  Record& record = records_[frame.record];
+  record.duration_us = microseconds(frame.start, stop);
+  record.gates_after = circ.n_gates();
+  record.depth_after = circ.depth();
+  record.modified = circ.structural_hash() != frame.hash_before;
+}
+
+nlohmann::json PassProfiler::to_trace_json() const {
+  nlohmann::json events = nlohmann::json::array();
+  for (const Record& record : records_) {
+    nlohmann::json event;
+    event["name"] = record.name;
+    event["ph"] = "X";
+    event["ts"] = record.start_us;
+    event["dur"] = record.duration_us;
+    event["pid"] = 0;
+    event["tid"] = 0;
+    event["args"]["gates_before"] = record.gates_before;
+    event["args"]["gates_after"] = record.gates_after;
+    event["args"]["depth_before"] = record.depth_before;
+    event["args"]["depth_after"] = record.depth_after;
+    event["args"]["modified"] = record.modified;
+    events.push_back(event);
+  }
+  nlohmann::json j;
+  j["traceEvents"] = events;
+  j["displayTimeUnit"] = "ms";
+  return j;
+}
+
+std::string PassProfiler::to_folded_stacks() const {
+  // Time of each record not spent in its children
+  std::vector<double> self_us(records_.size());
+  for (std::size_t i = 0; i < records_.size(); ++i) {
+    self_us[i] += records_[i].duration_us;
+    if (records_[i].parent) {
+      self_us[*records_[i].parent] -= records_[i].duration_us;
+    }
+  }
+  // Parents start before their children, so their stacks are known first
+  std::vector<std::string> stacks(records_.size());
+  std::map<std::string, double> totals;
+  std::vector<std::string> order;
+  for (std::size_t i = 0; i < records_.size(); ++i) {
+    const Record& record = records_[i];
+    stacks[i] = record.parent ? stacks[*record.parent] + ";" + record.name
+                              : record.name;
+    auto inserted = totals.insert({stacks[i], 0.});
+    if (inserted.second) order.push_back(stacks[i]);
+    inserted.first->second += self_us[i];
+  }
+  std::stringstream ss;
+  for (const std::string& stack : order) {
+    long long us = static_cast<long long>(totals[stack] + 0.5);
+    ss << stack << " " << (us > 0 ? us : 0) << "\n";
+  }
+  return ss.str();
+}
+
+void PassProfiler::clear() {
+  records_.clear();
+  stack_.clear();
+  origin_ = std::chrono::steady_clock::now();
+}
+
+}  // namespace tket
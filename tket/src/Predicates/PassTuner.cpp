@@ -0,0 +1,154 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Predicates/PassTuner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "tket/Circuit/Conditional.hpp"
+
+namespace tket {
+
+PassTuner::PassTuner(
+    const std::vector<PassPtr>& candidates, const Metric& metric)
+    : candidates_(candidates), metric_(metric) {
+  if (candidates.empty()) {
+    throw std::invalid_argument("PassTuner needs at least one candidate");
+  }
+}
+
+unsigned PassTuner::tune(
+    CompilationUnit& c_unit, unsigned n_threads, SafetyMode safe_mode) const {
+  const std::size_t n = candidates_.size();
+  std::vector<std::optional<CompilationUnit>> results(n);
+  std::vector<double> scores(n);
+  std::vector<std::exception_ptr> errors(n);
+  std::atomic<std::size_t> next_index{0};
+  auto work = [&]() {
+    for (std::size_t index = next_index++; index < n; index = next_index++) {
+      try {
+        CompilationUnit trial = c_unit;
+        // Copies share their maps, so give each trial its own
+        trial.maps = std::make_shared<unit_bimaps_t>(*c_unit.maps);
+        candidates_[index]->apply(trial, safe_mode);
+        scores[index] = metric_(trial.get_circ_ref());
+        results[index] = std::move(trial);
+      } catch (...) {
+        errors[index] = std::current_exception();
+      }
+    }
+  };
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const std::size_t number_of_threads = std::min<std::size_t>(n_threads, n);
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  std::optional<unsigned> best;
+  for (unsigned i = 0; i < n; ++i) {
+    if (results[i] && (!best || scores[i] < scores[*best])) best = i;
+  }
+  if (!best) std::rethrow_exception(errors.front());
+  c_unit = std::move(*results[*best]);
+  return *best;
+}
+
+unsigned PassTuner::apply(
+    CompilationUnit& c_unit, const std::string& circuit_class,
+    unsigned n_threads, SafetyMode safe_mode) {
+  std::optional<unsigned> winner = get_winner(circuit_class);
+  if (winner) {
+    candidates_[*winner]->apply(c_unit, safe_mode);
+    return *winner;
+  }
+  unsigned best = tune(c_unit, n_threads, safe_mode);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Another thread may have tuned the same class meanwhile: keep the first
+  winners_.insert({circuit_class, best});
+  return best;
+}
+
+std::optional<unsigned> PassTuner::get_winner(
+    const std::string& circuit_class) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::map<std::string, unsigned>::const_iterator found =
+      winners_.find(circuit_class);
+  if (found == winners_.end()) return std::nullopt;
+  return found->second;
+}
+
+std::map<std::string, unsigned> PassTuner::get_winners() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return winners_;
+}
+
+void PassTuner::set_winner(
+    const std::string& circuit_class, unsigned candidate) {
+  if (candidate >= candidates_.size()) {
+    throw std::out_of_range("PassTuner has no such candidate");
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  winners_[circuit_class] = candidate;
+}
+
+PassTuner::Metric PassTuner::two_qubit_gate_count() {
+  return [](const Circuit& circ) {
+    return static_cast<double>(circ.count_n_qubit_gates(2));
+  };
+}
+
+PassTuner::Metric PassTuner::depth() {
+  return [](const Circuit& circ) { return static_cast<double>(circ.depth()); };
+}
+
+PassTuner::Metric PassTuner::infidelity(
+    const DeviceCharacterisation& characterisation) {
+  return [characterisation](const Circuit& circ) {
+    double fidelity = 1.;
+    for (const Command& com : circ) {
+      Op_ptr op = com.get_op_ptr();
+      if (op->get_type() == OpType::Conditional) {
+        op = static_cast<const Conditional&>(*op).get_op();
+      }
+      const OpType type = op->get_type();
+      const qubit_vector_t qubits = com.get_qubits();
+      double error = 0.;
+      if (type == OpType::Measure) {
+        error = characterisation.get_readout_error(Node(qubits.front()));
+      } else if (!op->get_desc().is_gate()) {
+        continue;
+      } else if (qubits.size() == 1) {
+        error = characterisation.get_error(Node(qubits[0]), type);
+      } else if (qubits.size() == 2) {
+        error = characterisation.get_error(
+            {Node(qubits[0]), Node(qubits[1])}, type);
+      }
+      fidelity *= 1. - error;
+    }
+    return 1. - fidelity;
+  };
+}
+
+}  // namespace tket
@@ -24,6 +24,36 @@
 
 namespace tket {
 
+bool Predicate::verify_changes(
+    const Circuit& circ, const Circuit::ChangeLog&, std::size_t) const {
+  return verify(circ);
+}
+
+// Vertices whose op changed after `since`, together with all vertices after
+// a changed wire, whose qubits may have changed
+static VertexSet changed_commands(
+    const Circuit& circ, const Circuit::ChangeLog& log, std::size_t since) {
+  VertexSet verts;
+  for (const std::pair<const Vertex, std::size_t>& change : log.ops) {
+    if (change.second > since) verts.insert(change.first);
+  }
+  VertexVec to_visit;
+  VertexSet visited;
+  for (const std::pair<const Vertex, std::size_t>& change : log.wires) {
+    if (change.second > since) to_visit.push_back(change.first);
+  }
+  while (!to_visit.empty()) {
+    Vertex v = to_visit.back();
+    to_visit.pop_back();
+    if (!visited.insert(v).second) continue;
+    verts.insert(v);
+    for (const Vertex& succ : circ.get_successors(v)) {
+      if (visited.find(succ) == visited.end()) to_visit.push_back(succ);
+    }
+  }
+  return verts;
+}
+
 template <typename T>
 static bool auto_implication(const T&, const Predicate& other) {
   try {
@@ -83,18 +113,33 @@ const std::string& predicate_name(std::type_index idx) {
 // PREDICATE METHODS//
 /////////////////////
 
+bool GateSetPredicate::allows(const Op_ptr& op) const {
+  OpDesc desc = op->get_desc();
+  if (desc.is_meta()) return true;
+  OpType type = op->get_type();
+  if (type == OpType::Conditional) {
+    const Conditional& cond = static_cast<const Conditional&>(*op);
+    type = cond.get_op()->get_type();
+  }
+  if (type == OpType::Phase) return true;
+  return find_in_set(type, allowed_types_);
+}
+
 bool GateSetPredicate::verify(const Circuit& circ) const {
   BGL_FORALL_VERTICES(v, circ.dag, DAG) {
-    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-    OpDesc desc = op->get_desc();
-    if (desc.is_meta()) continue;
-    OpType type = op->get_type();
-    if (type == OpType::Conditional) {
-      const Conditional& cond = static_cast<const Conditional&>(*op);
-      type = cond.get_op()->get_type();
-    }
-    if (type == OpType::Phase) continue;
-    if (!find_in_set(type, allowed_types_)) return false;
+    if (!allows(circ.get_Op_ptr_from_Vertex(v))) return false;
+  }
+  return true;
+}
+
+bool GateSetPredicate::verify_changes(
+    const Circuit& circ, const Circuit::ChangeLog& log,
+    std::size_t since) const {
+  if (log.all > since) return verify(circ);
+  for (const std::pair<const Vertex, std::size_t>& change : log.ops) {
+    if (change.second > since &&
+        !allows(circ.get_Op_ptr_from_Vertex(change.first)))
+      return false;
   }
   return true;
 }
@@ -168,31 +213,29 @@ std::string NoClassicalControlPredicate::to_string() const {
 }
 
 static bool fast_feed_forward_helper(
-    const Command& com, unit_set_t& unset_bits) {
+    const Op_ptr& op, std::span<const UnitID> args, unit_set_t& unset_bits) {
   // Allows conditionals from unset_bits
   // Encountering a measurement removed the bits from unset_bits
   // Returns whether or not a feed-forward conditional is found
   // Applies recursively for CircBoxes
-  if (com.get_op_ptr()->get_type() == OpType::Conditional) {
-    const Conditional& cond =
-        static_cast<const Conditional&>(*com.get_op_ptr());
-    unit_vector_t all_args = com.get_args();
-    unit_vector_t::iterator arg_it = all_args.begin();
+  if (op->get_type() == OpType::Conditional) {
+    const Conditional& cond = static_cast<const Conditional&>(*op);
     for (unsigned i = 0; i < cond.get_width(); ++i) {
-      if (unset_bits.find(*arg_it) == unset_bits.end()) return false;
-      ++arg_it;
+      if (unset_bits.find(args[i]) == unset_bits.end()) return false;
     }
-    unit_vector_t new_args = {arg_it, all_args.end()};
-    Command new_com = {cond.get_op(), new_args};
-    return fast_feed_forward_helper(new_com, unset_bits);
+    return fast_feed_forward_helper(
+        cond.get_op(), args.subspan(cond.get_width()), unset_bits);
   } else if (
-      com.get_op_ptr()->get_type() == OpType::CircBox ||
-      com.get_op_ptr()->get_type() == OpType::CustomGate) {
-    const Box& box = static_cast<const Box&>(*com.get_op_ptr());
+      op->get_type() == OpType::CircBox ||
+      op->get_type() == OpType::CustomGate) {
+    const Box& box = static_cast<const Box&>(*op);
     unit_map_t interface;
     unit_set_t inner_set;
     unsigned i = 0;
-    for (const Bit& b : com.get_bits()) {
+    op_signature_t sig = op->get_signature();
+    for (unsigned p = 0; p < sig.size(); ++p) {
+      if (sig[p] != EdgeType::Classical) continue;
+      Bit b(args[p]);
       Bit inner_bit(i);
       interface.insert({Bit(i), b});
       if (unset_bits.find(b) != unset_bits.end()) {
@@ -200,15 +243,17 @@ static bool fast_feed_forward_helper(
       }
       ++i;
     }
-    for (const Command& c : *box.to_circuit()) {
-      if (!fast_feed_forward_helper(c, inner_set)) return false;
+    if (!box.to_circuit()->visit_commands([&](const CommandView& c) {
+          return fast_feed_forward_helper(c.op, c.args, inner_set);
+        })) {
+      return false;
     }
     for (const std::pair<const UnitID, UnitID>& pair : interface) {
       if (inner_set.find(pair.first) == inner_set.end())
         unset_bits.erase(pair.second);
     }
-  } else if (com.get_op_ptr()->get_type() == OpType::Measure) {
-    unset_bits.erase(com.get_args().at(1));
+  } else if (op->get_type() == OpType::Measure) {
+    unset_bits.erase(args[1]);
   }
   return true;
 }
@@ -217,10 +262,9 @@ bool NoFastFeedforwardPredicate::verify(const Circuit& circ) const {
   if (circ.n_bits() == 0) return true;
   bit_vector_t all_bits = circ.all_bits();
   unit_set_t unset_bits = {all_bits.begin(), all_bits.end()};
-  for (const Command& com : circ) {
-    if (!fast_feed_forward_helper(com, unset_bits)) return false;
-  }
-  return true;
+  return circ.visit_commands([&](const CommandView& com) {
+    return fast_feed_forward_helper(com.op, com.args, unset_bits);
+  });
 }
 
 bool NoFastFeedforwardPredicate::implies(const Predicate& other) const {
@@ -334,6 +378,14 @@ bool ConnectivityPredicate::verify(const Circuit& circ) const {
   return respects_connectivity_constraints(circ, arch_, false, true);
 }
 
+bool ConnectivityPredicate::verify_changes(
+    const Circuit& circ, const Circuit::ChangeLog& log,
+    std::size_t since) const {
+  if (log.all > since) return verify(circ);
+  return vertices_respect_connectivity_constraints(
+      circ, changed_commands(circ, log, since), arch_, false, true);
+}
+
 bool ConnectivityPredicate::implies(const Predicate& other) const {
   try {
     const ConnectivityPredicate& other_c =
@@ -394,6 +446,14 @@ bool DirectednessPredicate::verify(const Circuit& circ) const {
   return respects_connectivity_constraints(circ, arch_, true, false);
 }
 
+bool DirectednessPredicate::verify_changes(
+    const Circuit& circ, const Circuit::ChangeLog& log,
+    std::size_t since) const {
+  if (log.all > since) return verify(circ);
+  return vertices_respect_connectivity_constraints(
+      circ, changed_commands(circ, log, since), arch_, true, false);
+}
+
 bool DirectednessPredicate::implies(const Predicate& other) const {
   try {
     const DirectednessPredicate& other_c =
@@ -609,12 +669,10 @@ std::string CommutableMeasuresPredicate::to_string() const {
 bool NoMidMeasurePredicate::verify(const Circuit& circ) const {
   if (circ.n_bits() == 0) return true;
   unit_set_t measured_units;
-  for (const Command& com : circ) {
-    if (!Transforms::DelayMeasures::check_only_end_measures(
-            com, measured_units))
-      return false;
-  }
-  return true;
+  return circ.visit_commands([&](const CommandView& com) {
+    return Transforms::DelayMeasures::check_only_end_measures(
+        com.op, com.args, measured_units);
+  });
 }
 
 bool NoMidMeasurePredicate::implies(const Predicate& other) const {
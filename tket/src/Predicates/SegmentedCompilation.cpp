@@ -0,0 +1,158 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Predicates/SegmentedCompilation.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "tket/Utils/Json.hpp"
+
+namespace tket {
+
+namespace {
+
+// Compiles segments of a stream of commands and writes out the results.
+class SegmentCompiler {
+ public:
+  SegmentCompiler(
+      std::ostream& out, const PassPtr& pass, std::size_t segment_size,
+      std::size_t overlap)
+      : out_(out),
+        pass_(pass),
+        segment_size_(segment_size),
+        overlap_(overlap),
+        n_commands_(0),
+        n_written_(0),
+        n_segments_(0),
+        phase_(0) {}
+
+  void add_command(const Command& com) {
+    add_to_segment(com);
+    n_commands_++;
+    if (n_commands_ == segment_size_) compile(overlap_);
+  }
+
+  // Compile and write out what remains, and return the phase introduced by
+  // the pass.
+  Expr finish() {
+    if (segment_.n_gates() > 0) compile(0);
+    return phase_;
+  }
+
+  unsigned n_segments() const { return n_segments_; }
+
+ private:
+  std::ostream& out_;
+  const PassPtr& pass_;
+  const std::size_t segment_size_;
+  const std::size_t overlap_;
+  Circuit segment_;
+  // Commands read into the segment, not counting those carried over
+  std::size_t n_commands_;
+  std::size_t n_written_;
+  unsigned n_segments_;
+  Expr phase_;
+
+  void add_to_segment(const Command& com) {
+    const unit_vector_t& args = com.get_args();
+    for (const UnitID& u : args) {
+      if (segment_.contains_unit(u)) continue;
+      switch (u.type()) {
+        case UnitType::Qubit:
+          segment_.add_qubit(Qubit(u));
+          break;
+        case UnitType::Bit:
+          segment_.add_bit(Bit(u));
+          break;
+        case UnitType::WasmState:
+          segment_.add_wasm_register(u.index().at(0) + 1);
+          break;
+      }
+    }
+    segment_.add_op(com.get_op_ptr(), args, com.get_opgroup());
+  }
+
+  // Compile the segment and write out all but its last `keep` layers, which
+  // start the next segment.
+  void compile(std::size_t keep) {
+    CompilationUnit cu(segment_);
+    pass_->apply(cu);
+    bool same_units = cu.get_circ_ref().n_units() == segment_.n_units();
+    for (const auto& [before, after] : cu.get_final_map_ref().left) {
+      same_units = same_units && before == after;
+    }
+    if (!same_units) {
+      throw std::logic_error(
+          "Segmented compilation needs a pass that keeps the units of the "
+          "circuit");
+    }
+    Circuit compiled = cu.get_circ_ref();
+    compiled.replace_all_implicit_wire_swaps();
+    phase_ += compiled.get_phase();
+    n_segments_++;
+
+    // Carry the commands within `keep` layers of the end of the segment.
+    // Every successor of a carried command is carried too, so the written
+    // commands come before all of them.
+    const std::vector<Command> commands = compiled.get_commands();
+    std::vector<bool> carry(commands.size());
+    std::map<UnitID, std::size_t> depth_after;
+    for (std::size_t i = commands.size(); i-- > 0;) {
+      std::size_t depth = 0;
+      for (const UnitID& u : commands[i].get_args()) {
+        depth = std::max(depth, depth_after[u]);
+      }
+      carry[i] = depth < keep;
+      for (const UnitID& u : commands[i].get_args()) depth_after[u] = depth + 1;
+    }
+    for (std::size_t i = 0; i < commands.size(); i++) {
+      if (carry[i]) continue;
+      out_ << (n_written_ == 0 ? "" : ",") << nlohmann::json(commands[i]);
+      n_written_++;
+    }
+    segment_ = Circuit();
+    for (std::size_t i = 0; i < commands.size(); i++) {
+      if (carry[i]) add_to_segment(commands[i]);
+    }
+    n_commands_ = 0;
+  }
+};
+
+}  // namespace
+
+unsigned compile_json_stream(
+    std::istream& in, std::ostream& out, const PassPtr& pass,
+    std::size_t segment_size, std::size_t overlap) {
+  if (segment_size == 0) {
+    throw std::invalid_argument("Segment size must be positive");
+  }
+  SegmentCompiler compiler(out, pass, segment_size, overlap);
+  out << "{\"commands\":[";
+  Circuit header = Circuit::from_json_stream(
+      in, [&compiler](const Command& com) { compiler.add_command(com); });
+  header.add_phase(compiler.finish());
+  out << "]";
+  nlohmann::json j = header;
+  j.erase("commands");
+  for (auto it = j.begin(); it != j.end(); ++it) {
+    out << "," << nlohmann::json(it.key()) << ":" << it.value();
+  }
+  out << "}";
+  return compiler.n_segments();
+}
+
+}  // namespace tket
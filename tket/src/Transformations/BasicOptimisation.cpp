@@ -14,7 +14,9 @@
 
 #include "tket/Transformations/BasicOptimisation.hpp"
 
+#include <array>
 #include <cmath>
+#include <deque>
 #include <optional>
 #include <tkassert/Assert.hpp>
 #include <vector>
@@ -26,6 +28,7 @@
 #include "tket/Circuit/DAGDefs.hpp"
 #include "tket/Transformations/Decomposition.hpp"
 #include "tket/Transformations/Transform.hpp"
+#include "tket/Transformations/TwoQubitBlockCache.hpp"
 #include "tket/Utils/EigenConfig.hpp"
 #include "tket/Utils/Expression.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
@@ -119,28 +122,14 @@ struct Interaction {
   VertexSet vertices;  // Vertices in interaction subcircuit
 };
 
-static bool replace_two_qubit_interaction(
-    Circuit &circ, Interaction &i, std::map<Qubit, Edge> &current_edges,
-    VertexList &bin, OpType target, double cx_fidelity, bool allow_swaps) {
-  EdgeVec in_edges = {i.e0, i.e1};
-  EdgeVec out_edges = {current_edges[i.q0], current_edges[i.q1]};
-  Edge next0, next1;
-  bool q0_is_out = is_final_q_type(
-      circ.get_OpType_from_Vertex(circ.target(current_edges[i.q0])));
-  bool q1_is_out = is_final_q_type(
-      circ.get_OpType_from_Vertex(circ.target(current_edges[i.q1])));
-  if (!q0_is_out) {
-    next0 = circ.get_next_edge(
-        circ.target(current_edges[i.q0]), current_edges[i.q0]);
-  }
-  if (!q1_is_out) {
-    next1 = circ.get_next_edge(
-        circ.target(current_edges[i.q1]), current_edges[i.q1]);
-  }
-  // Circuit to (potentially) substitute
-  Subcircuit sub = {in_edges, out_edges, i.vertices};
-  Circuit subc = circ.subcircuit(sub);
-
+/**
+ * KAK-decompose a circuit on two qubits, returning the result if it is worth
+ * substituting: when the circuit contains two-qubit gates other than the
+ * target, or (for CX) when it reduces the number of CX gates, or (for TK2)
+ * when it merges at least two two-qubit gates.
+ */
+static std::optional<Circuit> kak_resynthesise_block(
+    Circuit &subc, OpType target, double cx_fidelity, bool allow_swaps) {
   // Try to simplify using KAK
   Circuit replacement = subc;
   decompose_multi_qubits_TK2().apply(replacement);
@@ -176,11 +165,58 @@ static bool replace_two_qubit_interaction(
       substitute |= cnt_2qb >= 2;
     }
   }
+  if (!substitute) return std::nullopt;
+  return replacement;
+}
+
+/**
+ * As kak_resynthesise_block, looking the block up in the shared
+ * TwoQubitBlockCache first.
+ */
+static std::optional<Circuit> resynthesise_two_qubit_block(
+    Circuit &subc, OpType target, double cx_fidelity, bool allow_swaps) {
+  std::optional<TwoQubitBlockCache::Key> key =
+      TwoQubitBlockCache::make_key(subc, target, cx_fidelity, allow_swaps);
+  if (!key) {
+    return kak_resynthesise_block(subc, target, cx_fidelity, allow_swaps);
+  }
+  TwoQubitBlockCache &cache = TwoQubitBlockCache::shared();
+  std::optional<TwoQubitBlockCache::result_t> cached = cache.find(*key);
+  if (cached) return *cached;
+  std::optional<Circuit> replacement =
+      kak_resynthesise_block(subc, target, cx_fidelity, allow_swaps);
+  cache.insert(*key, replacement);
+  return replacement;
+}
 
-  if (substitute) {
+static bool replace_two_qubit_interaction(
+    Circuit &circ, Interaction &i, std::map<Qubit, Edge> &current_edges,
+    VertexList &bin, OpType target, double cx_fidelity, bool allow_swaps) {
+  EdgeVec in_edges = {i.e0, i.e1};
+  EdgeVec out_edges = {current_edges[i.q0], current_edges[i.q1]};
+  Edge next0, next1;
+  bool q0_is_out = is_final_q_type(
+      circ.get_OpType_from_Vertex(circ.target(current_edges[i.q0])));
+  bool q1_is_out = is_final_q_type(
+      circ.get_OpType_from_Vertex(circ.target(current_edges[i.q1])));
+  if (!q0_is_out) {
+    next0 = circ.get_next_edge(
+        circ.target(current_edges[i.q0]), current_edges[i.q0]);
+  }
+  if (!q1_is_out) {
+    next1 = circ.get_next_edge(
+        circ.target(current_edges[i.q1]), current_edges[i.q1]);
+  }
+  // Circuit to (potentially) substitute
+  Subcircuit sub = {in_edges, out_edges, i.vertices};
+  Circuit subc = circ.subcircuit(sub);
+  std::optional<Circuit> replacement =
+      resynthesise_two_qubit_block(subc, target, cx_fidelity, allow_swaps);
+
+  if (replacement) {
     // Substitute interaction with new circuit
     bin.insert(bin.end(), sub.verts.begin(), sub.verts.end());
-    circ.substitute(replacement, sub, Circuit::VertexDeletion::No);
+    circ.substitute(*replacement, sub, Circuit::VertexDeletion::No);
     if (!q0_is_out) {
       current_edges[i.q0] = circ.get_last_edge(circ.source(next0), next0);
     }
@@ -392,6 +428,159 @@ Transform two_qubit_squash(
   });
 }
 
+// Number of qubits (1 or 2) of a vertex that may be part of a block in
+// peephole_sweep, or 0 if it may not
+static unsigned sweepable_arity(const Circuit &circ, const Vertex &v) {
+  const Op_ptr o = circ.get_Op_ptr_from_Vertex(v);
+  OpType type = o->get_type();
+  if (is_classical_type(type) || is_projective_type(type) ||
+      is_boundary_type(type) || type == OpType::Barrier ||
+      type == OpType::Conditional || !o->free_symbols().empty()) {
+    return 0;
+  }
+  unsigned n_ins = circ.n_in_edges(v);
+  if (n_ins != circ.n_in_edges_of_type(v, EdgeType::Quantum)) return 0;
+  return (n_ins == 1 || n_ins == 2) ? n_ins : 0;
+}
+
+// A convex subcircuit on two wires, bounded by `in` and `out` on each wire
+struct TwoQubitBlock {
+  std::array<Edge, 2> in;
+  std::array<Edge, 2> out;
+  VertexSet verts;
+  unsigned n_2qb;
+};
+
+// Largest number of gates in a block considered by peephole_sweep
+static constexpr unsigned max_block_size = 64;
+
+/**
+ * Grow the largest block around a two-qubit vertex `v` containing only
+ * single-qubit gates on its wires and two-qubit gates between them.
+ */
+static TwoQubitBlock grow_two_qubit_block(
+    const Circuit &circ, const Vertex &v) {
+  TwoQubitBlock block;
+  EdgeVec ins = circ.get_in_edges_of_type(v, EdgeType::Quantum);
+  block.in = {ins[0], ins[1]};
+  block.out = {circ.get_next_edge(v, ins[0]), circ.get_next_edge(v, ins[1])};
+  block.verts = {v};
+  block.n_2qb = 1;
+  // Backwards
+  while (block.verts.size() < max_block_size) {
+    for (Edge &e : block.in) {
+      Vertex pred = circ.source(e);
+      while (block.verts.size() < max_block_size &&
+             sweepable_arity(circ, pred) == 1) {
+        block.verts.insert(pred);
+        e = circ.get_last_edge(pred, e);
+        pred = circ.source(e);
+      }
+    }
+    Vertex pred = circ.source(block.in[0]);
+    if (pred != circ.source(block.in[1]) ||
+        block.verts.size() >= max_block_size ||
+        sweepable_arity(circ, pred) != 2) {
+      break;
+    }
+    block.verts.insert(pred);
+    ++block.n_2qb;
+    block.in = {
+        circ.get_last_edge(pred, block.in[0]),
+        circ.get_last_edge(pred, block.in[1])};
+  }
+  // Forwards
+  while (block.verts.size() < max_block_size) {
+    for (Edge &e : block.out) {
+      Vertex succ = circ.target(e);
+      while (block.verts.size() < max_block_size &&
+             sweepable_arity(circ, succ) == 1) {
+        block.verts.insert(succ);
+        e = circ.get_next_edge(succ, e);
+        succ = circ.target(e);
+      }
+    }
+    Vertex succ = circ.target(block.out[0]);
+    if (succ != circ.target(block.out[1]) ||
+        block.verts.size() >= max_block_size ||
+        sweepable_arity(circ, succ) != 2) {
+      break;
+    }
+    block.verts.insert(succ);
+    ++block.n_2qb;
+    block.out = {
+        circ.get_next_edge(succ, block.out[0]),
+        circ.get_next_edge(succ, block.out[1])};
+  }
+  return block;
+}
+
+Transform peephole_sweep(OpType target_2qb_gate, bool allow_swaps) {
+  const std::set<OpType> accepted_ots{OpType::CX, OpType::TK2};
+  if (!accepted_ots.contains(target_2qb_gate)) {
+    throw BadOpType(
+        "peephole_sweep currently supports CX and TK2. Cannot decompose to",
+        target_2qb_gate);
+  }
+  return Transform([target_2qb_gate, allow_swaps](Circuit &circ) {
+    bool success = false;
+    VertexList bin;
+    VertexSet removed;
+    // Two-qubit vertices whose block has been considered since it last changed
+    VertexSet clean;
+    std::deque<Vertex> queue;
+    for (const Vertex &v : circ.vertices_in_order()) {
+      if (sweepable_arity(circ, v) == 2) queue.push_back(v);
+    }
+    while (!queue.empty()) {
+      Vertex v = queue.front();
+      queue.pop_front();
+      if (removed.contains(v) || clean.contains(v)) continue;
+      TwoQubitBlock block = grow_two_qubit_block(circ, v);
+      for (const Vertex &u : block.verts) {
+        if (sweepable_arity(circ, u) == 2) clean.insert(u);
+      }
+      if (block.n_2qb < 2) continue;
+      Subcircuit sub = {
+          {block.in[0], block.in[1]}, {block.out[0], block.out[1]},
+          block.verts};
+      Circuit subc = circ.subcircuit(sub);
+      std::optional<Circuit> replacement = resynthesise_two_qubit_block(
+          subc, target_2qb_gate, 1., allow_swaps);
+      if (!replacement) continue;
+      // The neighbours of the block survive the substitution
+      std::array<Vertex, 2> preds = {
+          circ.source(block.in[0]), circ.source(block.in[1])};
+      std::array<port_t, 2> pred_ports = {
+          circ.get_source_port(block.in[0]),
+          circ.get_source_port(block.in[1])};
+      std::array<Vertex, 2> succs = {
+          circ.target(block.out[0]), circ.target(block.out[1])};
+      circ.substitute(*replacement, sub, Circuit::VertexDeletion::No);
+      bin.insert(bin.end(), block.verts.begin(), block.verts.end());
+      removed.insert(block.verts.begin(), block.verts.end());
+      success = true;
+      // The new gates form an optimal block, so only the neighbours, whose
+      // blocks may now extend further, need revisiting
+      for (unsigned w = 0; w < 2; ++w) {
+        Edge e = circ.get_nth_out_edge(preds[w], pred_ports[w]);
+        while (circ.target(e) != succs[0] && circ.target(e) != succs[1]) {
+          Vertex n = circ.target(e);
+          if (sweepable_arity(circ, n) == 2) clean.insert(n);
+          e = circ.get_next_edge(n, e);
+        }
+      }
+      for (const Vertex &n : {preds[0], preds[1], succs[0], succs[1]}) {
+        if (clean.erase(n) > 0) queue.push_back(n);
+      }
+    }
+    circ.remove_vertices(
+        bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
+    success |= squash_1qb_to_tk1().apply(circ);
+    return success;
+  });
+}
+
 // Given a 'SWAP_chain', finds edge in chain (or qubit wire) with best fidelity
 // and rewires the associated single qubit vertex in to it
 static bool find_edge_rewire_vertex(
@@ -573,7 +762,8 @@ Transform absorb_Rz_NPhasedX() {
           std::vector<Expr> new_params = op->get_params();
           TKET_ASSERT(new_params.size() == 2);
           new_params[1] += absorb_rz;
-          circ.dag[v] = get_op_ptr(OpType::NPhasedX, new_params, arity);
+          circ.set_vertex_Op_ptr(
+              v, get_op_ptr(OpType::NPhasedX, new_params, arity));
 
           // Finally, adjust +-absorb_rz in Rz everywhere around
           for (unsigned i = 0; i < arity; ++i) {
@@ -708,62 +898,48 @@ Transform round_angles(unsigned n, bool only_zeros) {
     throw std::invalid_argument("Precision parameter must be less than 32.");
   }
   return Transform([n, only_zeros](Circuit &circ) {
-    bool changed = false;
+    const double pow2n = 1u << n;
+    VertexVec rewritten = rewrite_numeric_params(
+        circ, [pow2n, only_zeros](std::vector<double> &values) {
+          if (only_zeros) {
+            for (double &x : values) {
+              x = (pow2n * std::abs(x) < 0.5) ? 0. : x;
+            }
+          } else {
+            for (double &x : values) {
+              x = std::nearbyint(pow2n * x) / pow2n;
+            }
+          }
+        });
+
+    // Remove gates whose parameters have all been rounded to zero
     VertexSet bin;
-    const unsigned pow2n = 1 << n;
-    BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+    for (const Vertex &v : rewritten) {
       Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
       bool conditional = op->get_type() == OpType::Conditional;
       if (conditional) {
-        const Conditional &cond = static_cast<const Conditional &>(*op);
-        op = cond.get_op();
+        op = static_cast<const Conditional &>(*op).get_op();
       }
-      if (op->get_desc().is_gate()) {
-        std::vector<Expr> params = op->get_params();
-        if (!params.empty()) {
-          std::vector<Expr> new_params;
-          for (const Expr &e : params) {
-            std::optional<double> eval = eval_expr(e);
-            if (eval) {
-              if (only_zeros) {
-                new_params.push_back(
-                    pow2n * std::abs(eval.value()) < 0.5 ? 0. : e);
-              } else {
-                new_params.push_back(nearbyint(pow2n * eval.value()) / pow2n);
-              }
-            } else {
-              new_params.push_back(e);
-            }
-          }
-          if (params != new_params) {
-            unsigned n_qb = op->n_qubits();
-            Circuit replacement(n_qb);
-            if (std::any_of(
-                    new_params.begin(), new_params.end(),
-                    [](const Expr &e) { return (e != 0.); })) {
-              std::vector<Qubit> args;
-              for (unsigned i = 0; i < n_qb; i++) {
-                args.push_back(Qubit(i));
-              }
-              replacement.add_op(op->get_type(), new_params, args);
-            }
-            if (conditional) {
-              circ.substitute_conditional(
-                  replacement, v, Circuit::VertexDeletion::No);
-            } else {
-              circ.substitute(replacement, v, Circuit::VertexDeletion::No);
-            }
-            bin.insert(v);
-            changed = true;
-          }
-        }
+      std::vector<Expr> params = op->get_params();
+      if (std::any_of(params.begin(), params.end(), [](const Expr &e) {
+            return e != 0.;
+          })) {
+        continue;
+      }
+      if (conditional) {
+        circ.substitute_conditional(
+            Circuit(op->n_qubits()), v, Circuit::VertexDeletion::No);
+      } else {
+        circ.remove_vertex(
+            v, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::No);
       }
+      bin.insert(v);
     }
 
     circ.remove_vertices(
         bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
 
-    return changed;
+    return !rewritten.empty();
   });
 }
 
@@ -0,0 +1,315 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Transformations/CliffordBlockResynthesis.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Clifford/SymplecticTableau.hpp"
+#include "tket/Clifford/UnitaryTableau.hpp"
+#include "tket/Converters/Converters.hpp"
+#include "tket/OpType/OpType.hpp"
+#include "tket/Transformations/Transform.hpp"
+#include "tket/Utils/BitMatrix.hpp"
+
+namespace tket {
+
+namespace Transforms {
+
+// Number of CX gates needed for a Clifford gate, or std::nullopt if the gate
+// cannot be applied to a tableau.
+static std::optional<unsigned> clifford_cx_cost(OpType type) {
+  switch (type) {
+    case OpType::Z:
+    case OpType::X:
+    case OpType::Y:
+    case OpType::S:
+    case OpType::Sdg:
+    case OpType::V:
+    case OpType::SX:
+    case OpType::Vdg:
+    case OpType::SXdg:
+    case OpType::H:
+    case OpType::noop:
+      return 0;
+    case OpType::CX:
+    case OpType::CY:
+    case OpType::CZ:
+    case OpType::ZZMax:
+    case OpType::ECR:
+      return 1;
+    case OpType::ISWAPMax:
+      return 2;
+    case OpType::SWAP:
+      return 3;
+    case OpType::BRIDGE:
+      return 4;
+    default:
+      return std::nullopt;
+  }
+}
+
+// A vertex and one of its ports.
+typedef std::pair<Vertex, port_t> VertPort;
+
+// A convex subcircuit of Clifford gates, with its wires numbered locally.
+struct CliffordBlock {
+  unsigned n_wires = 0;
+  // Gates in topological order, acting on local wires
+  std::vector<std::pair<OpType, std::vector<unsigned>>> gates;
+  // The first vertex (and its in-port) and the last vertex (and its
+  // out-port) on each wire
+  std::vector<VertPort> firsts;
+  std::vector<VertPort> lasts;
+  VertexSet verts;
+  unsigned cx_cost = 0;
+  // Set when the block has been absorbed into another one
+  bool merged = false;
+};
+
+// Partition the Clifford gates of a circuit into maximal convex blocks.
+//
+// Vertices are visited in topological order. Each open block has a frontier
+// of outgoing wires; a Clifford gate joins (and merges) the open blocks
+// whose frontier it reads, while any other vertex closes them, so that no
+// path can leave a block and return to it.
+static std::vector<CliffordBlock> find_clifford_blocks(Circuit &circ) {
+  std::vector<CliffordBlock> blocks;
+  // Open frontier wires, keyed by the vertex and out-port they leave from
+  std::map<VertPort, std::pair<unsigned, unsigned>> frontier;
+  const auto merge_into = [&](unsigned target, unsigned other) {
+    CliffordBlock &t = blocks[target];
+    CliffordBlock &o = blocks[other];
+    const unsigned offset = t.n_wires;
+    for (unsigned w = 0; w < o.n_wires; ++w) {
+      frontier[o.lasts[w]] = {target, offset + w};
+    }
+    for (auto &[type, wires] : o.gates) {
+      for (unsigned &w : wires) w += offset;
+      t.gates.emplace_back(type, std::move(wires));
+    }
+    t.firsts.insert(t.firsts.end(), o.firsts.begin(), o.firsts.end());
+    t.lasts.insert(t.lasts.end(), o.lasts.begin(), o.lasts.end());
+    t.verts.insert(o.verts.begin(), o.verts.end());
+    t.n_wires += o.n_wires;
+    t.cx_cost += o.cx_cost;
+    o = CliffordBlock();
+    o.merged = true;
+  };
+  for (const Vertex &v : circ.vertices_in_order()) {
+    const EdgeVec ins = circ.get_in_edges(v);
+    std::vector<VertPort> sources;
+    for (const Edge &e : ins) {
+      sources.push_back({circ.source(e), circ.get_source_port(e)});
+    }
+    std::optional<unsigned> cost =
+        clifford_cx_cost(circ.get_OpType_from_Vertex(v));
+    if (ins.empty() || circ.get_opgroup_from_Vertex(v) ||
+        circ.n_in_edges_of_type(v, EdgeType::Quantum) != ins.size()) {
+      cost = std::nullopt;
+    }
+    std::set<unsigned> touched;
+    for (const VertPort &src : sources) {
+      auto found = frontier.find(src);
+      if (found != frontier.end()) touched.insert(found->second.first);
+    }
+    if (!cost) {
+      for (unsigned b : touched) {
+        for (const VertPort &last : blocks[b].lasts) frontier.erase(last);
+      }
+      continue;
+    }
+    unsigned target;
+    if (touched.empty()) {
+      target = blocks.size();
+      blocks.emplace_back();
+    } else {
+      target = *std::max_element(
+          touched.begin(), touched.end(), [&](unsigned a, unsigned b) {
+            return blocks[a].gates.size() < blocks[b].gates.size();
+          });
+      for (unsigned b : touched) {
+        if (b != target) merge_into(target, b);
+      }
+    }
+    CliffordBlock &block = blocks[target];
+    std::vector<unsigned> wires;
+    for (port_t p = 0; p < sources.size(); ++p) {
+      unsigned w;
+      auto found = frontier.find(sources[p]);
+      if (found != frontier.end()) {
+        w = found->second.second;
+        frontier.erase(found);
+      } else {
+        w = block.n_wires++;
+        block.firsts.push_back({v, p});
+        block.lasts.push_back({v, p});
+      }
+      block.lasts[w] = {v, p};
+      frontier[{v, p}] = {target, w};
+      wires.push_back(w);
+    }
+    block.gates.emplace_back(circ.get_OpType_from_Vertex(v), wires);
+    block.verts.insert(v);
+    block.cx_cost += *cost;
+  }
+  return blocks;
+}
+
+// Compute the unitary tableau of a block, on column-packed words.
+static SymplecticTableau block_tableau(const CliffordBlock &block) {
+  const unsigned n = block.n_wires;
+  MatrixXb xmat = MatrixXb::Zero(2 * n, n);
+  MatrixXb zmat = MatrixXb::Zero(2 * n, n);
+  xmat.topRows(n) = MatrixXb::Identity(n, n);
+  zmat.bottomRows(n) = MatrixXb::Identity(n, n);
+  ColumnPackedTableau packed(
+      SymplecticTableau(xmat, zmat, VectorXb::Zero(2 * n)));
+  for (const auto &[type, wires] : block.gates) {
+    packed.apply_gate(type, wires);
+  }
+  return packed.to_tableau();
+}
+
+// Compute the tableaux of several blocks, sharing them between threads.
+static std::vector<std::optional<SymplecticTableau>> block_tableaux(
+    const std::vector<const CliffordBlock *> &blocks) {
+  std::vector<std::optional<SymplecticTableau>> tableaux(blocks.size());
+  std::atomic<std::size_t> next_index = 0;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const auto work = [&]() {
+    try {
+      for (std::size_t index = next_index++; index < blocks.size();
+           index = next_index++) {
+        tableaux[index] = block_tableau(*blocks[index]);
+      }
+    } catch (...) {
+      // GCOVR_EXCL_START
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      next_index = blocks.size();
+      // GCOVR_EXCL_STOP
+    }
+  };
+  const std::size_t number_of_threads = std::min<std::size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), blocks.size());
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < number_of_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);  // GCOVR_EXCL_LINE
+  }
+  return tableaux;
+}
+
+// Circuits already synthesised, keyed by the words of their tableaux.
+typedef std::vector<BitMatrix::Word> TableauCacheKey;
+std::mutex tableau_cache_mutex;
+std::map<TableauCacheKey, Circuit> tableau_cache;
+// Bound the memory used by many different blocks.
+constexpr std::size_t max_tableau_cache_size = 1024;
+
+static TableauCacheKey tableau_key(const SymplecticTableau &tab) {
+  const unsigned n_rows = tab.get_n_rows();
+  TableauCacheKey key{tab.get_n_qubits()};
+  for (const BitMatrix *mat : {&tab.xmat, &tab.zmat}) {
+    for (unsigned r = 0; r < n_rows; ++r) {
+      const BitMatrix::Word *words = mat->row_data(r);
+      key.insert(key.end(), words, words + mat->words_per_row());
+    }
+  }
+  BitMatrix::Word phase_word = 0;
+  for (unsigned r = 0; r < n_rows; ++r) {
+    if (tab.phase(r)) phase_word |= BitMatrix::Word(1) << (r % 64);
+    if (r % 64 == 63 || r + 1 == n_rows) {
+      key.push_back(phase_word);
+      phase_word = 0;
+    }
+  }
+  return key;
+}
+
+// Synthesise a circuit from the tableau of a block.
+static Circuit synthesise_block(const SymplecticTableau &tab) {
+  TableauCacheKey key = tableau_key(tab);
+  {
+    std::lock_guard<std::mutex> lock(tableau_cache_mutex);
+    auto found = tableau_cache.find(key);
+    if (found != tableau_cache.end()) return found->second;
+  }
+  const unsigned n = tab.get_n_qubits();
+  const MatrixXb xmat = tab.xmat.to_matrix();
+  const MatrixXb zmat = tab.zmat.to_matrix();
+  UnitaryTableau utab(
+      xmat.topRows(n), zmat.topRows(n), tab.phase.head(n),
+      xmat.bottomRows(n), zmat.bottomRows(n), tab.phase.tail(n));
+  Circuit circ = unitary_tableau_to_circuit(utab);
+  std::lock_guard<std::mutex> lock(tableau_cache_mutex);
+  if (tableau_cache.size() >= max_tableau_cache_size) tableau_cache.clear();
+  tableau_cache.emplace(std::move(key), circ);
+  return circ;
+}
+
+Transform clifford_block_resynthesis() {
+  return Transform([](Circuit &circ) {
+    const std::vector<CliffordBlock> blocks = find_clifford_blocks(circ);
+    // Only blocks containing some two-qubit cost can be improved.
+    std::vector<const CliffordBlock *> candidates;
+    for (const CliffordBlock &block : blocks) {
+      if (!block.merged && block.cx_cost > 0) candidates.push_back(&block);
+    }
+    if (candidates.empty()) return false;
+    const std::vector<std::optional<SymplecticTableau>> tableaux =
+        block_tableaux(candidates);
+    bool success = false;
+    for (unsigned i = 0; i < candidates.size(); ++i) {
+      const CliffordBlock &block = *candidates[i];
+      const Circuit replacement = synthesise_block(*tableaux[i]);
+      if (replacement.count_gates(OpType::CX) >= block.cx_cost) continue;
+      EdgeVec q_in_hole, q_out_hole;
+      for (unsigned w = 0; w < block.n_wires; ++w) {
+        const auto &[first, in_port] = block.firsts[w];
+        const auto &[last, out_port] = block.lasts[w];
+        q_in_hole.push_back(circ.get_nth_in_edge(first, in_port));
+        q_out_hole.push_back(circ.get_nth_out_edge(last, out_port));
+      }
+      circ.substitute(
+          replacement, Subcircuit(q_in_hole, q_out_hole, block.verts));
+      success = true;
+    }
+    return success;
+  });
+}
+
+}  // namespace Transforms
+
+}  // namespace tket
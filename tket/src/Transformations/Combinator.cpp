@@ -15,8 +15,12 @@
 #include "tket/Transformations/Combinator.hpp"
 
 #include <memory>
+#include <numeric>
 
+#include "tket/Circuit/Boxes.hpp"
+#include "tket/Circuit/ConjugationBox.hpp"
 #include "tket/Transformations/Transform.hpp"
+#include "tket/Utils/Cancellation.hpp"
 
 namespace tket {
 
@@ -32,6 +36,7 @@ Transform sequence(std::vector<Transform> &tvec) {
     bool success = false;
     for (std::vector<Transform>::const_iterator it = tvec.begin();
          it != tvec.end(); ++it) {
+      throw_if_cancelled();
       success = it->apply_fn(circ, maps) || success;
     }
     return success;
@@ -41,7 +46,16 @@ Transform sequence(std::vector<Transform> &tvec) {
 Transform repeat(const Transform &trans) {
   return Transform([=](Circuit &circ, std::shared_ptr<unit_bimaps_t> maps) {
     bool success = false;
-    while (trans.apply_fn(circ, maps)) success = true;
+    // Stop once the circuit stops changing, even if the transform reports
+    // success
+    std::size_t hash = circ.structural_hash();
+    while (trans.apply_fn(circ, maps)) {
+      success = true;
+      throw_if_cancelled();
+      std::size_t new_hash = circ.structural_hash();
+      if (new_hash == hash) break;
+      hash = new_hash;
+    }
     return success;
   });
 }
@@ -59,6 +73,13 @@ Transform repeat_with_metric(
       currentCircuit = &newCircuit;
       currentVal = newVal;
       success = true;
+      try {
+        throw_if_cancelled();
+      } catch (const CompilationCancelled &) {
+        // Keep the best circuit so far
+        circ = newCircuit;
+        throw;
+      }
       trans.apply_fn(newCircuit, maps);
       newVal = eval(newCircuit);
     }
@@ -70,14 +91,57 @@ Transform repeat_with_metric(
 Transform repeat_while(const Transform &cond, const Transform &body) {
   return Transform([=](Circuit &circ, std::shared_ptr<unit_bimaps_t> maps) {
     bool success = false;
+    std::size_t hash = circ.structural_hash();
     while (cond.apply_fn(circ, maps)) {
       success = true;
+      throw_if_cancelled();
       body.apply_fn(circ, maps);
+      // Another iteration would do the same again
+      std::size_t new_hash = circ.structural_hash();
+      if (new_hash == hash) break;
+      hash = new_hash;
     }
     return success;
   });
 }
 
+static bool transform_conjugation_actions(
+    Circuit &circ, const Transform &trans) {
+  bool success = false;
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+    if (op->get_type() != OpType::ConjugationBox) continue;
+    throw_if_cancelled();
+    const ConjugationBox &box = static_cast<const ConjugationBox &>(*op);
+    Op_ptr action = box.get_action();
+    Circuit action_circ;
+    if (action->get_type() == OpType::CircBox) {
+      action_circ = *static_cast<const CircBox &>(*action).to_circuit();
+    } else {
+      action_circ = Circuit(action->get_signature().size());
+      std::vector<unsigned> args(action_circ.n_qubits());
+      std::iota(args.begin(), args.end(), 0);
+      action_circ.add_op<unsigned>(action, args);
+    }
+    bool changed = transform_conjugation_actions(action_circ, trans);
+    changed = trans.apply(action_circ) || changed;
+    if (!changed) continue;
+    action_circ.replace_all_implicit_wire_swaps();
+    circ.set_vertex_Op_ptr(
+        v, std::make_shared<ConjugationBox>(
+               box.get_compute(), std::make_shared<CircBox>(action_circ),
+               box.get_uncompute()));
+    success = true;
+  }
+  return success;
+}
+
+Transform conjugation_actions(const Transform &trans) {
+  return Transform([=](Circuit &circ) {
+    return transform_conjugation_actions(circ, trans);
+  });
+}
+
 }  // namespace Transforms
 
 }  // namespace tket
@@ -15,6 +15,7 @@
 #include "tket/Transformations/ContextualReduction.hpp"
 
 #include <algorithm>
+#include <boost/dynamic_bitset.hpp>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
@@ -83,15 +84,13 @@ static std::optional<Eigen::MatrixXcd> op_unitary(Op_ptr op) {
   try {
     return op->get_unitary();
   } catch (BadOpType &) {
-    std::stringstream ss;
-    ss << "Attempting to compute unitary for invalid type: " << op->get_name();
-    tket_log()->warn(ss.str());
+    TKET_LOG_WARN(
+        "Attempting to compute unitary for invalid type: " << op->get_name());
     return std::nullopt;
   } catch (SymbolsNotSupported &) {
-    std::stringstream ss;
-    ss << "Attempting to compute unitary for symbolic operation: "
-       << op->get_name();
-    tket_log()->warn(ss.str());
+    TKET_LOG_WARN(
+        "Attempting to compute unitary for symbolic operation: "
+        << op->get_name());
     return std::nullopt;
   }
   // Any other exception is unexpected.
@@ -117,24 +116,6 @@ static std::optional<unsigned> unique_unit_row(
   throw std::logic_error(ss.str());
 }
 
-/**
- * Return the set of v in F all of whose quantum in-edges are in qvals.
- */
-static VertexSet known_inputs_only(
-    const Circuit &circ, const VertexSet &F,
-    const std::map<Edge, bool> &qvals) {
-  VertexSet v_frontier;
-  for (const Vertex &v : F) {
-    EdgeVec v_q_inedges = circ.get_in_edges_of_type(v, EdgeType::Quantum);
-    if (std::all_of(
-            v_q_inedges.begin(), v_q_inedges.end(),
-            [&qvals](const Edge &e) { return qvals.find(e) != qvals.end(); })) {
-      v_frontier.insert(v);
-    }
-  }
-  return v_frontier;
-}
-
 Transform simplify_initial(
     AllowClassical allow_classical, CreateAllQubits create_all_qubits,
     std::shared_ptr<const Circuit> xcirc) {
@@ -143,110 +124,102 @@ Transform simplify_initial(
       circ.qubit_create_all();
     }
 
-    // Find all Create and Reset vertices.
-    VertexSet zeroing_vertices;
-    BGL_FORALL_VERTICES(v, circ.dag, DAG) {
-      OpType optype = circ.get_OpType_from_Vertex(v);
-      if (optype == OpType::Create || optype == OpType::Reset) {
-        zeroing_vertices.insert(v);
-      }
+    // Known computational basis states of the qubits, indexed as in
+    // all_qubits(). A single sweep through the commands in causal order is
+    // enough, since every predecessor of a vertex is visited before it.
+    qubit_vector_t qubits = circ.all_qubits();
+    std::map<Qubit, unsigned> qubit_index;
+    for (unsigned i = 0; i < qubits.size(); i++) {
+      qubit_index[qubits[i]] = i;
     }
-
-    // Partial map from quantum edges to values.
-    std::map<Edge, bool> qvals;
-
-    // Assign 0 values to all edges coming out of zeroing vertices, and
-    // construct the set of their target vertices.
-    VertexSet F;
-    for (auto z : zeroing_vertices) {
-      EdgeVec z_outedges = circ.get_all_out_edges(z);
-      TKET_ASSERT(z_outedges.size() == 1);
-      Edge z_out = z_outedges[0];
-      TKET_ASSERT(circ.get_edgetype(z_out) == EdgeType::Quantum);
-      qvals[z_out] = false;
-      F.insert(circ.target(z_out));
+    boost::dynamic_bitset<> known(qubits.size());
+    boost::dynamic_bitset<> value(qubits.size());
+    for (unsigned i = 0; i < qubits.size(); i++) {
+      if (circ.is_created(qubits[i])) known.set(i);
     }
 
-    // Construct frontier of vertices with all-known input values.
-    VertexSet v_frontier = known_inputs_only(circ, F, qvals);
-
     // Partial map from vertices to sequences of X gates to replace them.
     std::map<Vertex, std::vector<bool>> reductions;
 
     // Partial map from Measure vertices to bits to set after measure.
     std::map<Vertex, bool> measurebits;
 
-    while (!v_frontier.empty()) {
-      // Simplify vertices in the frontier that we can, and move it on.
-      F.clear();
-      for (const Vertex &v : v_frontier) {
-        // If there are any Boolean inputs to v, skip it.
-        if (circ.n_in_edges_of_type(v, EdgeType::Boolean) != 0) {
-          continue;
-        }
-
-        Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-        std::optional<Eigen::MatrixXcd> U = op_unitary(op);
-        bool is_measure = (op->get_type() == OpType::Measure);
-
-        if (!U && (!is_measure || allow_classical == AllowClassical::No)) {
-          continue;
-        }
+    for (const Command &cmd : circ.get_commands()) {
+      Vertex v = cmd.get_vertex();
+      qubit_vector_t v_qubits = cmd.get_qubits();
+      unsigned n_q = v_qubits.size();
+      std::vector<unsigned> q_indices(n_q);
+      bool all_known = n_q != 0;
+      for (unsigned i = 0; i < n_q; i++) {
+        q_indices[i] = qubit_index.at(v_qubits[i]);
+        all_known &= known[q_indices[i]];
+      }
+      auto forget = [&]() {
+        for (unsigned i : q_indices) known.reset(i);
+      };
+
+      Op_ptr op = cmd.get_op_ptr();
+      if (op->get_type() == OpType::Reset) {
+        TKET_ASSERT(n_q == 1);
+        known.set(q_indices[0]);
+        value.reset(q_indices[0]);
+        continue;
+      }
 
-        // Compute input state.
-        EdgeVec v_q_inedges = circ.get_in_edges_of_type(v, EdgeType::Quantum);
-        unsigned n_q = v_q_inedges.size();
-        std::vector<bool> v_invals(n_q);
-        for (unsigned i = 0; i < n_q; i++) {
-          v_invals[i] = qvals[v_q_inedges[i]];
-        }
+      // If there are any Boolean inputs to v, or any unknown quantum inputs,
+      // skip it.
+      if (!all_known || circ.n_in_edges_of_type(v, EdgeType::Boolean) != 0) {
+        forget();
+        continue;
+      }
 
-        if (U) {
-          // Compute relevant column J of U.
-          unsigned J = 0, pow2 = 1u << n_q;
-          for (unsigned i = 0; i < n_q; i++) {
-            pow2 >>= 1;
-            if (v_invals[i]) {
-              J |= pow2;
-            }
-          }
+      std::optional<Eigen::MatrixXcd> U = op_unitary(op);
+      bool is_measure = (op->get_type() == OpType::Measure);
 
-          // Check if there is a unique I s.t. |U(I,J)| == 1.
-          std::optional<unsigned> I = unique_unit_row(*U, J);
-          if (!I) continue;
+      if (!U && (!is_measure || allow_classical == AllowClassical::No)) {
+        forget();
+        continue;
+      }
 
-          // Convert I to a vector of bool
-          std::vector<bool> v_outvals(n_q);
-          for (unsigned i = 0; i < n_q; i++) {
-            v_outvals[i] = (*I >> (n_q - 1 - i)) & 1;
-          }
+      // Compute input state.
+      std::vector<bool> v_invals(n_q);
+      for (unsigned i = 0; i < n_q; i++) {
+        v_invals[i] = value[q_indices[i]];
+      }
 
-          // Label out-edges of v; construct equivalent X-gate rep.
-          EdgeVec v_outedges = circ.get_all_out_edges(v);
-          TKET_ASSERT(v_outedges.size() == n_q);
-          std::vector<bool> x_gates(n_q);
-          for (unsigned i = 0; i < n_q; i++) {
-            bool outval = v_outvals[i];
-            qvals[v_outedges[i]] = outval;
-            x_gates[i] = v_invals[i] ^ outval;
+      if (U) {
+        // Compute relevant column J of U.
+        unsigned J = 0, pow2 = 1u << n_q;
+        for (unsigned i = 0; i < n_q; i++) {
+          pow2 >>= 1;
+          if (v_invals[i]) {
+            J |= pow2;
           }
+        }
 
-          // Record vertex for later replacement with X-gates.
-          reductions[v] = x_gates;
+        // Check if there is a unique I s.t. |U(I,J)| == 1.
+        std::optional<unsigned> I = unique_unit_row(*U, J);
+        if (!I) {
+          forget();
+          continue;
+        }
 
-          // Add all successors of v to potential next frontier F.
-          for (const Edge &e : v_outedges) {
-            F.insert(circ.target(e));
-          }
-        } else {
-          TKET_ASSERT(allow_classical == AllowClassical::Yes);
-          TKET_ASSERT(n_q == 1);
-          measurebits[v] = v_invals[0];
+        // Record output values; construct equivalent X-gate rep.
+        std::vector<bool> x_gates(n_q);
+        for (unsigned i = 0; i < n_q; i++) {
+          bool outval = (*I >> (n_q - 1 - i)) & 1;
+          value[q_indices[i]] = outval;
+          x_gates[i] = v_invals[i] ^ outval;
         }
-      }
 
-      // Replace v_frontier with vertices from F having all-known inputs.
-      v_frontier = known_inputs_only(circ, F, qvals);
+        // Record vertex for later replacement with X-gates.
+        reductions[v] = x_gates;
+      } else {
+        TKET_ASSERT(allow_classical == AllowClassical::Yes);
+        TKET_ASSERT(n_q == 1);
+        measurebits[v] = v_invals[0];
+        forget();
+      }
     }
 
     // Perform substitutions.
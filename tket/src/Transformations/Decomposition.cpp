@@ -54,12 +54,13 @@ static bool convert_to_xyx(Circuit &circ);
 static bool convert_multiqs_TK2(Circuit &circ) {
   bool success = false;
   VertexList bin;
+  ReplacementTable replacements(TK2_circ_from_multiq);
   BGL_FORALL_VERTICES(v, circ.dag, DAG) {
     Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
     OpType optype = op->get_type();
     if (is_gate_type(optype) && !is_projective_type(optype) &&
         op->n_qubits() >= 2 && (optype != OpType::TK2)) {
-      Circuit in_circ = TK2_circ_from_multiq(op);
+      const Circuit &in_circ = replacements.get(op);
       Subcircuit sub = {
           {circ.get_in_edges(v)}, {circ.get_all_out_edges(v)}, {v}};
       bin.push_back(v);
@@ -80,12 +81,13 @@ static bool convert_multiqs_TK2(Circuit &circ) {
 static bool convert_multiqs_CX(Circuit &circ) {
   bool success = false;
   VertexList bin;
+  ReplacementTable replacements(CX_circ_from_multiq);
   BGL_FORALL_VERTICES(v, circ.dag, DAG) {
     Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
     OpType optype = op->get_type();
     if (is_gate_type(optype) && !is_projective_type(optype) &&
         op->n_qubits() >= 2 && (optype != OpType::CX)) {
-      Circuit in_circ = CX_circ_from_multiq(op);
+      const Circuit &in_circ = replacements.get(op);
       Subcircuit sub = {
           {circ.get_in_edges(v)}, {circ.get_all_out_edges(v)}, {v}};
       bin.push_back(v);
@@ -233,9 +235,10 @@ Transform decompose_ZYZ_to_TK1() {
             }
             std::vector<Expr> new_params = {
                 angle_3 + half, angle_2, angle_1 - half};
-            circ.dag[v] = {get_op_ptr(OpType::TK1, new_params)};
+            circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::TK1, new_params));
           } else {
-            circ.dag[v] = {get_op_ptr(OpType::TK1, {zero, zero, angle_1})};
+            circ.set_vertex_Op_ptr(
+                v, get_op_ptr(OpType::TK1, {zero, zero, angle_1}));
           }
         } else if (circ.get_OpType_from_Vertex(v) == OpType::Ry) {
           const Op_ptr v_g = circ.get_Op_ptr_from_Vertex(v);
@@ -251,7 +254,7 @@ Transform decompose_ZYZ_to_TK1() {
             bin.push_back(v2);
           }
           std::vector<Expr> new_params = {angle_3 + half, angle_2, -half};
-          circ.dag[v] = {get_op_ptr(OpType::TK1, new_params)};
+          circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::TK1, new_params));
         }
         e = circ.get_next_edge(v, e);
         v = circ.target(e);
@@ -474,18 +477,18 @@ Transform decompose_ZX_to_HQS1() {
           const Op_ptr next_g = circ.get_Op_ptr_from_Vertex(next_vert);
           Expr phi = next_g->get_params()[0];
           std::vector<Expr> params{theta, phi};
-          circ.dag[v].op = get_op_ptr(OpType::PhasedX, params);
+          circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::PhasedX, params));
           circ.remove_vertex(
               next_vert, Circuit::GraphRewiring::Yes,
               Circuit::VertexDeletion::No);
           to_bin.push_back(next_vert);
           Expr new_param = prev_g->get_params()[0] + phi;
-          circ.dag[prev_vert].op = get_op_ptr(OpType::Rz, new_param);
+          circ.set_vertex_Op_ptr(prev_vert, get_op_ptr(OpType::Rz, new_param));
         } else {
           // if no Rz, initialise a PhasedX op with theta=Rx.params[0],phi=0
           Expr phi(0);
           std::vector<Expr> params{theta, phi};
-          circ.dag[v].op = get_op_ptr(OpType::PhasedX, params);
+          circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::PhasedX, params));
         }
       }
     }
@@ -525,7 +528,7 @@ Transform decompose_MolmerSorensen() {
                 circ.get_nth_in_edge(last, 1) == outs[1]) {
               // Recognise exp(-i XX * angle * pi/2)
               const Op_ptr op_ptr = get_op_ptr(OpType::XXPhase, angle);
-              circ.dag[v] = {op_ptr};
+              circ.set_vertex_Op_ptr(v, op_ptr);
               bin.push_back(next);
               circ.remove_vertex(
                   next, Circuit::GraphRewiring::Yes,
@@ -913,7 +916,8 @@ Transform decompose_ZZPhase() {
           success = true;
           const Op_ptr g = circ.get_Op_ptr_from_Vertex(v);
           TKET_ASSERT(g->get_params().size() == 1);
-          circ.dag[v] = {get_op_ptr(OpType::ZZPhase, g->get_params()[0])};
+          circ.set_vertex_Op_ptr(
+              v, get_op_ptr(OpType::ZZPhase, g->get_params()[0]));
           break;
         }
         case OpType::XXPhase: {
@@ -1187,28 +1191,28 @@ Transform decompose_ZX_to_cliffords() {
             }
             case 1: {
               if (is_rz) {
-                circ.dag[v] = {get_op_ptr(OpType::S)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::S));
                 circ.add_phase(-0.25);
               } else {
-                circ.dag[v] = {get_op_ptr(OpType::V)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::V));
               }
               break;
             }
             case 2: {
               if (is_rz) {
-                circ.dag[v] = {get_op_ptr(OpType::Z)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::Z));
               } else {
-                circ.dag[v] = {get_op_ptr(OpType::X)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::X));
               }
               circ.add_phase(-0.5);
               break;
             }
             case 3: {
               if (is_rz) {
-                circ.dag[v] = {get_op_ptr(OpType::Sdg)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::Sdg));
                 circ.add_phase(-0.75);
               } else {
-                circ.dag[v] = {get_op_ptr(OpType::Vdg)};
+                circ.set_vertex_Op_ptr(v, get_op_ptr(OpType::Vdg));
                 circ.add_phase(1);
               }
               break;
@@ -1252,7 +1256,8 @@ Transform decompose_PhaseGadgets() {
             if (type == OpType::TK1) {
               t += g->get_params()[2];
             }
-            circ.dag[*it] = {get_op_ptr(OpType::PhaseGadget, {t}, 2)};
+            circ.set_vertex_Op_ptr(
+                *it, get_op_ptr(OpType::PhaseGadget, {t}, 2));
             if (type == OpType::U1) {
               circ.add_phase(t / 2);
             } else if (
@@ -1743,13 +1748,25 @@ unsigned n_distinct_beta(const Circuit &circ, const OptVertexVec &gates) {
     }
   }
 
+  // evaluate each expression once, rather than once per pair
+  std::vector<std::optional<double>> evals;
+  evals.reserve(vals.size());
+  for (const Expr &e : vals) {
+    evals.push_back(eval_expr(e));
+  }
+  // as equiv_expr, on the evaluated values
+  auto equiv = [&vals, &evals](unsigned i, unsigned j) {
+    if (!evals[i] || !evals[j]) return vals[i] == vals[j];
+    return approx_eq(*evals[i], *evals[j]);
+  };
+
   unsigned n_distinct = 0;
 
   // perform pairwise equivalence checks
   for (unsigned i = 0; i < vals.size(); ++i) {
     bool is_unique = true;
     for (unsigned j = i + 1; j < vals.size(); ++j) {
-      if (equiv_expr(vals[i], vals[j])) {
+      if (equiv(i, j)) {
         is_unique = false;
         break;
       }
@@ -2006,6 +2023,94 @@ Transform cnx_pairwise_decomposition() {
   });
 }
 
+Transform cnx_ancilla_decomposition() {
+  return Transform([](Circuit &circ) {
+    bool success = false;
+    const qubit_vector_t qubits = circ.all_qubits();
+    const unsigned n_qubits = qubits.size();
+    // For each qubit, the edge on its wire leaving the slices visited so far,
+    // and whether the qubit is known to be in the zero state there
+    std::vector<Edge> frontier(n_qubits);
+    std::vector<bool> zeroed(n_qubits);
+    for (unsigned q = 0; q < n_qubits; ++q) {
+      frontier[q] = circ.get_nth_out_edge(circ.get_in(qubits[q]), 0);
+      zeroed[q] = circ.is_created(qubits[q]);
+    }
+    // Every edge goes from a slice to a later one. A replacement is inserted
+    // on the wire of an idle qubit at an edge spanning the slice of the
+    // replaced gate, so this still holds and the DAG stays acyclic.
+    for (const Slice &slice : circ.get_slices()) {
+      const VertexSet in_slice(slice.begin(), slice.end());
+      std::vector<bool> busy(n_qubits);
+      for (unsigned q = 0; q < n_qubits; ++q) {
+        busy[q] = in_slice.contains(circ.target(frontier[q]));
+      }
+      for (const Vertex &v : slice) {
+        const Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+        if (op->get_type() != OpType::CnX || op->n_qubits() < 4) continue;
+        const unsigned n = op->n_qubits() - 1;
+        std::vector<unsigned> clean, dirty;
+        for (unsigned q = 0; q < n_qubits; ++q) {
+          if (!busy[q]) (zeroed[q] ? clean : dirty).push_back(q);
+        }
+        Circuit replacement;
+        std::vector<unsigned> ancillas;
+        if (clean.size() >= n - 2) {
+          replacement = CircPool::CnX_log_depth_decomp(n);
+          ancillas = clean;
+        } else if (n >= 4 && clean.size() + dirty.size() >= n - 2) {
+          // Fewer CX than the decompositions without ancillae only from 4
+          // controls
+          replacement = CircPool::CnX_vchain_decomp(n);
+          ancillas = dirty;
+          ancillas.insert(ancillas.end(), clean.begin(), clean.end());
+        } else {
+          continue;
+        }
+        ancillas.resize(n - 2);
+        std::vector<unsigned> wires;
+        for (const Edge &e : circ.get_in_edges(v)) {
+          unsigned q = 0;
+          while (frontier[q] != e) ++q;
+          wires.push_back(q);
+        }
+        EdgeVec in_edges, out_edges;
+        for (unsigned q : wires) {
+          in_edges.push_back(frontier[q]);
+          out_edges.push_back(circ.get_next_edge(v, frontier[q]));
+          zeroed[q] = false;
+        }
+        for (unsigned q : ancillas) {
+          in_edges.push_back(frontier[q]);
+          out_edges.push_back(frontier[q]);
+          busy[q] = true;
+          wires.push_back(q);
+        }
+        std::vector<VertPort> successors;
+        for (const Edge &e : out_edges) {
+          successors.push_back({circ.target(e), circ.get_target_port(e)});
+        }
+        circ.substitute(
+            replacement, Subcircuit{in_edges, out_edges, {v}},
+            Circuit::VertexDeletion::Yes);
+        for (unsigned i = 0; i < wires.size(); ++i) {
+          frontier[wires[i]] = circ.get_nth_in_edge(
+              successors[i].first, successors[i].second);
+        }
+        success = true;
+      }
+      for (unsigned q = 0; q < n_qubits; ++q) {
+        const Vertex next = circ.target(frontier[q]);
+        if (in_slice.contains(next)) {
+          zeroed[q] = circ.get_OpType_from_Vertex(next) == OpType::Reset;
+          frontier[q] = circ.get_next_edge(next, frontier[q]);
+        }
+      }
+    }
+    return success;
+  });
+}
+
 }  // namespace Transforms
 
 }  // namespace tket
@@ -37,26 +37,28 @@ Transform delay_measures(bool allow_partial) {
 namespace DelayMeasures {
 
 bool check_only_end_measures(const Command& com, unit_set_t& measured_units) {
-  OpType optype = com.get_op_ptr()->get_type();
+  const unit_vector_t args = com.get_args();
+  return check_only_end_measures(com.get_op_ptr(), args, measured_units);
+}
+
+bool check_only_end_measures(
+    const Op_ptr& op, std::span<const UnitID> args,
+    unit_set_t& measured_units) {
+  OpType optype = op->get_type();
   if (optype == OpType::Conditional) {
-    unit_vector_t all_args = com.get_args();
-    const Conditional& cond =
-        static_cast<const Conditional&>(*com.get_op_ptr());
-    unit_vector_t::iterator arg_it = all_args.begin();
+    const Conditional& cond = static_cast<const Conditional&>(*op);
     for (unsigned i = 0; i < cond.get_width(); ++i) {
-      if (measured_units.find(*arg_it) != measured_units.end()) return false;
-      ++arg_it;
+      if (measured_units.find(args[i]) != measured_units.end()) return false;
     }
-    unit_vector_t new_args = {arg_it, all_args.end()};
-    Command new_com = {cond.get_op(), new_args};
-    return check_only_end_measures(new_com, measured_units);
+    return check_only_end_measures(
+        cond.get_op(), args.subspan(cond.get_width()), measured_units);
   } else if (optype == OpType::CircBox || optype == OpType::CustomGate) {
-    const Box& box = static_cast<const Box&>(*com.get_op_ptr());
+    const Box& box = static_cast<const Box&>(*op);
     unit_map_t interface;
     unit_set_t inner_set;
     unsigned q_count = 0;
     unsigned b_count = 0;
-    for (const UnitID& u : com.get_args()) {
+    for (const UnitID& u : args) {
       UnitID inner_unit = (u.type() == UnitType::Qubit)
                               ? static_cast<UnitID>(Qubit(q_count++))
                               : static_cast<UnitID>(Bit(b_count++));
@@ -65,8 +67,10 @@ bool check_only_end_measures(const Command& com, unit_set_t& measured_units) {
         inner_set.insert(inner_unit);
       }
     }
-    for (const Command& c : *box.to_circuit()) {
-      if (!check_only_end_measures(c, inner_set)) return false;
+    if (!box.to_circuit()->visit_commands([&](const CommandView& c) {
+          return check_only_end_measures(c.op, c.args, inner_set);
+        })) {
+      return false;
     }
     for (const UnitID& u : inner_set) {
       measured_units.insert(interface.at(u));
@@ -74,12 +78,12 @@ bool check_only_end_measures(const Command& com, unit_set_t& measured_units) {
     return true;
   } else if (optype == OpType::Measure) {
     std::pair<unit_set_t::iterator, bool> q_inserted =
-        measured_units.insert(com.get_args().at(0));
+        measured_units.insert(args[0]);
     std::pair<unit_set_t::iterator, bool> c_inserted =
-        measured_units.insert(com.get_args().at(1));
+        measured_units.insert(args[1]);
     return q_inserted.second && c_inserted.second;
   } else {
-    for (const UnitID& a : com.get_args()) {
+    for (const UnitID& a : args) {
       if (measured_units.find(a) != measured_units.end()) return false;
     }
     return true;
@@ -76,8 +76,7 @@ Transform clifford_simp(bool allow_swaps) {
 }
 
 Transform synthesise_tk() {
-  Transform seq = commute_through_multis() >> remove_redundancies();
-  Transform rep = repeat(seq);
+  Transform rep = commute_and_remove_redundancies();
   Transform synth = decompose_multi_qubits_TK2() >> remove_redundancies() >>
                     rep >> squash_1qb_to_tk1();
   Transform small_part = remove_redundancies() >> rep >> squash_1qb_to_tk1();
@@ -87,8 +86,7 @@ Transform synthesise_tk() {
 }
 
 Transform synthesise_tket() {
-  Transform seq = commute_through_multis() >> remove_redundancies();
-  Transform rep = repeat(seq);
+  Transform rep = commute_and_remove_redundancies();
   Transform synth = decompose_multi_qubits_CX() >> remove_redundancies() >>
                     rep >> squash_1qb_to_tk1();
   Transform small_part = remove_redundancies() >> rep >> squash_1qb_to_tk1();
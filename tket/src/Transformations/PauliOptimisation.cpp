@@ -14,7 +14,9 @@
 
 #include "tket/Transformations/PauliOptimisation.hpp"
 
+#include "tket/ArchAwareSynth/SteinerTree.hpp"
 #include "tket/Circuit/CircUtils.hpp"
+#include "tket/Circuit/PauliExpBoxes.hpp"
 #include "tket/Converters/Converters.hpp"
 #include "tket/OpType/OpType.hpp"
 #include "tket/OpType/OpTypeInfo.hpp"
@@ -206,6 +208,10 @@ Transform synthesise_pauli_graph(
         circ = pauli_graph_to_pauli_exp_box_circuit_sets(pg, cx_config);
         break;
       }
+      case PauliSynthStrat::Lookahead: {
+        circ = pauli_graph_to_circuit_lookahead(pg);
+        break;
+      }
       default:
         TKET_ASSERT(!"Unknown Pauli Synthesis Strategy");
     }
@@ -218,6 +224,81 @@ Transform synthesise_pauli_graph(
   });
 }
 
+// The gadgets of a Pauli box, in order, over the qubits it acts on.
+static std::vector<SpSymPauliTensor> box_gadgets(
+    const Op &op, const qubit_vector_t &args) {
+  std::vector<SymPauliTensor> dense;
+  switch (op.get_type()) {
+    case OpType::PauliExpBox: {
+      const PauliExpBox &box = static_cast<const PauliExpBox &>(op);
+      dense.push_back(SymPauliTensor(box.get_paulis(), box.get_phase()));
+      break;
+    }
+    case OpType::PauliExpPairBox: {
+      const PauliExpPairBox &box = static_cast<const PauliExpPairBox &>(op);
+      auto [paulis0, paulis1] = box.get_paulis_pair();
+      auto [phase0, phase1] = box.get_phase_pair();
+      dense.push_back(SymPauliTensor(paulis0, phase0));
+      dense.push_back(SymPauliTensor(paulis1, phase1));
+      break;
+    }
+    case OpType::PauliExpCommutingSetBox: {
+      const PauliExpCommutingSetBox &box =
+          static_cast<const PauliExpCommutingSetBox &>(op);
+      dense = box.get_pauli_gadgets();
+      break;
+    }
+    default:
+      break;
+  }
+  std::vector<SpSymPauliTensor> gadgets;
+  for (const SymPauliTensor &gadget : dense) {
+    QubitPauliMap qpm;
+    for (unsigned i = 0; i != gadget.string.size(); ++i) {
+      qpm.insert({args[i], gadget.string[i]});
+    }
+    gadgets.push_back(SpSymPauliTensor(qpm, gadget.coeff));
+  }
+  return gadgets;
+}
+
+Transform steiner_pauli_gadgets(const Architecture &arch) {
+  return Transform([=](Circuit &circ) {
+    const aas::SteinerGadgetSynth synth(arch);
+    Circuit new_circ;
+    for (const Qubit &qb : circ.all_qubits()) new_circ.add_qubit(qb);
+    for (const Bit &b : circ.all_bits()) new_circ.add_bit(b);
+    const qubit_map_t permutation = circ.implicit_qubit_permutation();
+    bool changed = false;
+    for (const Command &com : circ) {
+      const Op_ptr op = com.get_op_ptr();
+      const unit_vector_t args = com.get_args();
+      std::vector<SpSymPauliTensor> gadgets =
+          box_gadgets(*op, qubit_vector_t(args.begin(), args.end()));
+      if (gadgets.empty()) {
+        new_circ.add_op<UnitID>(op, args, com.get_opgroup());
+        continue;
+      }
+      for (const SpSymPauliTensor &gadget : gadgets) {
+        synth.append_gadget(new_circ, gadget);
+      }
+      changed = true;
+    }
+    if (!changed) return false;
+    new_circ.add_phase(circ.get_phase());
+    std::optional<std::string> name = circ.get_name();
+    if (name) new_circ.set_name(*name);
+    // Nodes added for the Steiner trees are left in place
+    qubit_map_t full_permutation = permutation;
+    for (const Qubit &qb : new_circ.all_qubits()) {
+      full_permutation.insert({qb, qb});
+    }
+    new_circ.permute_boundary_output(full_permutation);
+    circ = new_circ;
+    return true;
+  });
+}
+
 Transform special_UCC_synthesis(PauliSynthStrat strat, CXConfigType cx_config) {
   return Transform([=](Circuit &circ) {
     Transform synther = synthesise_pauli_graph(strat, cx_config);
@@ -53,23 +53,27 @@ bool PhasedXFrontier::is_finished() {
 }
 
 std::set<unsigned> PhasedXFrontier::qubits_ending_in(const Vertex& v) const {
-  std::set<unsigned> qubits;
-  for (unsigned i = 0; i < circ_.n_qubits(); ++i) {
-    if (circ_.target(intervals_[i].second) == v) {
-      qubits.insert(i);
-    }
-  }
-  return qubits;
+  auto it = ending_in_.find(v);
+  if (it == ending_in_.end()) return {};
+  return it->second;
 }
 
 void PhasedXFrontier::squash_intervals() {
   for (unsigned i = 0; i < circ_.n_qubits(); ++i) {
-    squash_interval(i);
+    if (!squashed_[i]) {
+      squash_interval(i);
+      squashed_[i] = true;
+    }
   }
 }
 
 OptEdge PhasedXFrontier::get_beta_edge(unsigned i) const {
-  const auto& [start, end] = intervals_[i];
+  return beta_edge_in(intervals_[i]);
+}
+
+OptEdge PhasedXFrontier::beta_edge_in(
+    const std::pair<Edge, Edge>& interval) const {
+  const auto& [start, end] = interval;
   Edge e = start;
   while (e != end) {
     Vertex v = circ_.target(e);
@@ -83,10 +87,15 @@ OptEdge PhasedXFrontier::get_beta_edge(unsigned i) const {
 }
 
 OptEdgeVec PhasedXFrontier::get_all_beta_edges() const {
+  return beta_edges_in(intervals_);
+}
+
+OptEdgeVec PhasedXFrontier::beta_edges_in(
+    const std::vector<std::pair<Edge, Edge>>& intervals) const {
   OptEdgeVec beta_edges;
   std::vector<Vertex> beta_vertices;
-  for (unsigned i = 0; i < circ_.n_qubits(); ++i) {
-    OptEdge beta_e = get_beta_edge(i);
+  for (const std::pair<Edge, Edge>& interval : intervals) {
+    OptEdge beta_e = beta_edge_in(interval);
     beta_edges.push_back(beta_e);
     if (beta_e) {
       beta_vertices.push_back(circ_.target(*beta_e));
@@ -136,11 +145,9 @@ std::vector<Expr> PhasedXFrontier::get_all_betas() const {
 }
 
 void PhasedXFrontier::next_interval(unsigned i) {
-  auto& [start, end] = intervals_[i];
-
   // new interval
-  start = get_interval_start(end);
-  end = get_interval_end(start);
+  Edge new_start = get_interval_start(intervals_[i].second);
+  set_interval(i, new_start, get_interval_end(new_start));
 }
 
 void PhasedXFrontier::next_multiqb(const Vertex& v) {
@@ -151,6 +158,23 @@ void PhasedXFrontier::next_multiqb(const Vertex& v) {
   }
 }
 
+void PhasedXFrontier::set_interval(unsigned i, Edge start, Edge end) {
+  auto& [old_start, old_end] = intervals_[i];
+  Vertex old_target = circ_.target(old_end);
+  Vertex new_target = circ_.target(end);
+  if (old_target != new_target) {
+    auto it = ending_in_.find(old_target);
+    if (it != ending_in_.end()) {
+      it->second.erase(i);
+      if (it->second.empty()) ending_in_.erase(it);
+    }
+  }
+  ending_in_[new_target].insert(i);
+  old_start = start;
+  old_end = end;
+  squashed_[i] = false;
+}
+
 Edge PhasedXFrontier::get_interval_end(Edge e) const {
   Vertex v = circ_.target(e);
   while (!circ_.detect_final_Op(v) && !is_interval_boundary(v)) {
@@ -199,6 +223,8 @@ class PhasedXSquasher : public StandardSquasher {
 
 PhasedXFrontier::PhasedXFrontier(Circuit& circ)
     : intervals_(),
+      ending_in_(),
+      squashed_(circ.n_qubits(), false),
       circ_(circ),
       squasher_(std::make_unique<PhasedXSquasher>(), circ, false) {
   const unsigned n = circ_.n_qubits();
@@ -216,6 +242,7 @@ PhasedXFrontier::PhasedXFrontier(Circuit& circ)
     Edge start = e_vec.front();
     Edge end = get_interval_end(start);
     intervals_[i] = {start, end};
+    ending_in_[circ_.target(end)].insert(i);
   }
 }
 
@@ -276,18 +303,21 @@ void PhasedXFrontier::skip_global_gates(unsigned n) {
     if (count < n) {
       throw CircuitInvalidity("Did not find expected global gates");
     }
+    squashed_[i] = false;
   }
 }
 
 bool PhasedXFrontier::are_phasedx_left() const {
-  PhasedXFrontier copy = *this;
-  const unsigned n = circ_.n_qubits();
-  for (unsigned i = 0; i < n; ++i) {
-    copy.next_interval(i);
+  std::vector<std::pair<Edge, Edge>> next_intervals;
+  next_intervals.reserve(intervals_.size());
+  for (const auto& [start, end] : intervals_) {
+    Edge next_start = get_interval_start(end);
+    next_intervals.push_back({next_start, get_interval_end(next_start)});
   }
-  OptVertexVec all_phasedx = copy.get_all_beta_vertices();
-
-  return !all_nullopt(all_phasedx);
+  for (const OptEdge& e : beta_edges_in(next_intervals)) {
+    if (e) return true;
+  }
+  return false;
 }
 
 void PhasedXFrontier::insert_1_phasedx(unsigned i) {
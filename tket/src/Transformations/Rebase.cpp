@@ -14,12 +14,15 @@
 
 #include "tket/Transformations/Rebase.hpp"
 
+#include <map>
+#include <optional>
 #include <tkassert/Assert.hpp>
 #include <tklog/TketLog.hpp>
 
 #include "tket/Circuit/CircPool.hpp"
 #include "tket/Circuit/CircUtils.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Command.hpp"
 #include "tket/Gate/GatePtr.hpp"
 #include "tket/OpType/OpType.hpp"
 #include "tket/OpType/OpTypeFunctions.hpp"
@@ -27,6 +30,7 @@
 #include "tket/Transformations/BasicOptimisation.hpp"
 #include "tket/Transformations/Replacement.hpp"
 #include "tket/Transformations/Transform.hpp"
+#include "tket/Utils/Expression.hpp"
 
 namespace tket {
 
@@ -52,55 +56,148 @@ static Circuit rebase_op(
   }
 }
 
-static bool standard_rebase(
-    Circuit& circ, const OpTypeSet& allowed_gates,
-    const Circuit& cx_replacement,
+// Replacement of a single-qubit gate: the ops to apply in order, and a phase
+struct OneQubitReplacement {
+  std::vector<Op_ptr> ops;
+  Expr phase;
+  // Whether the replacement is a plain sequence of single-qubit ops
+  bool is_sequence;
+};
+
+typedef std::pair<OpType, std::vector<double>> one_qubit_key_t;
+
+// Table of replacements of gates with numeric parameters, built up during a
+// rebase. Each entry is computed once by rebase_op, so that repeated gates
+// reuse the same sequence of Op_ptr without building a replacement Circuit.
+typedef std::map<one_qubit_key_t, OneQubitReplacement> replacement_table_t;
+
+static std::optional<one_qubit_key_t> numeric_key(const Op_ptr& op) {
+  std::vector<double> params;
+  for (const Expr& e : op->get_params()) {
+    std::optional<double> x = eval_expr(e);
+    if (!x) return std::nullopt;
+    params.push_back(*x);
+  }
+  return one_qubit_key_t{op->get_type(), params};
+}
+
+static const OneQubitReplacement& find_replacement(
+    replacement_table_t& table, const one_qubit_key_t& key, const Op_ptr& op,
     const std::function<Circuit(const Expr&, const Expr&, const Expr&)>&
         tk1_replacement) {
+  auto found = table.find(key);
+  if (found != table.end()) return found->second;
+  Circuit c = rebase_op(as_gate_ptr(op), tk1_replacement);
+  OneQubitReplacement r{
+      {}, c.get_phase(), c.n_qubits() == 1 && c.n_bits() == 0};
+  for (const Command& cmd : c) {
+    if (cmd.get_args().size() != 1 || cmd.get_opgroup()) {
+      r.is_sequence = false;
+      break;
+    }
+    r.ops.push_back(cmd.get_op_ptr());
+  }
+  return table.insert({key, r}).first->second;
+}
+
+// Put a sequence of single-qubit ops in place of the op at `v`, reusing `v`
+// for the first one. An empty sequence removes `v`, adding it to `bin`.
+static void splice_replacement(
+    Circuit& circ, const Vertex& v, const OneQubitReplacement& r,
+    VertexSet& bin) {
+  circ.add_phase(r.phase);
+  if (r.ops.empty()) {
+    circ.remove_vertex(
+        v, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::No);
+    bin.insert(v);
+    return;
+  }
+  circ.set_vertex_Op_ptr(v, r.ops[0]);
+  Vertex last = v;
+  for (unsigned i = 1; i < r.ops.size(); ++i) {
+    Edge out = circ.get_nth_out_edge(last, 0);
+    Vertex next = circ.target(out);
+    port_t next_port = circ.get_target_port(out);
+    circ.remove_edge(out);
+    Vertex added = circ.add_vertex(r.ops[i]);
+    circ.add_edge({last, 0}, {added, 0}, EdgeType::Quantum);
+    circ.add_edge({added, 0}, {next, next_port}, EdgeType::Quantum);
+    last = added;
+  }
+}
+
+// Replace 0- and 1-qubit gates outside the gate set by converting to TK1 and
+// replacing. Unconditional gates with numeric parameters and no opgroup are
+// rewritten in place from a table of replacements; the rest are substituted.
+static bool rebase_single_qubit_gates(
+    Circuit& circ, const OpTypeSet& allowed_gates,
+    const std::function<Circuit(const Expr&, const Expr&, const Expr&)>&
+        tk1_replacement,
+    VertexSet& bin) {
   bool success = false;
-  VertexSet bin;
+  replacement_table_t table;
   for (const Vertex& v : circ.all_vertices()) {
+    if (bin.contains(v)) continue;
+    if (circ.n_in_edges_of_type(v, EdgeType::Quantum) > 1) continue;
     Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-    unsigned n_qubits = circ.n_in_edges_of_type(v, EdgeType::Quantum);
-    if (n_qubits <= 1) continue;
     bool conditional = op->get_type() == OpType::Conditional;
     if (conditional) {
       const Conditional& cond = static_cast<const Conditional&>(*op);
       op = cond.get_op();
     }
     OpType type = op->get_type();
-    if (allowed_gates.find(type) != allowed_gates.end() || type == OpType::CX ||
-        type == OpType::Barrier)
+    if (!is_gate_type(type) || is_projective_type(type) ||
+        allowed_gates.contains(type))
       continue;
+    success = true;
     // need to convert
-    Circuit replacement = CX_circ_from_multiq(op);
+    if (!conditional && type != OpType::Phase &&
+        circ.n_in_edges_of_type(v, EdgeType::Quantum) == 1 &&
+        !circ.get_opgroup_from_Vertex(v)) {
+      std::optional<one_qubit_key_t> key = numeric_key(op);
+      if (key) {
+        const OneQubitReplacement& r =
+            find_replacement(table, *key, op, tk1_replacement);
+        if (r.is_sequence) {
+          splice_replacement(circ, v, r, bin);
+          continue;
+        }
+      }
+    }
+    Circuit replacement = rebase_op(as_gate_ptr(op), tk1_replacement);
     if (conditional) {
       circ.substitute_conditional(replacement, v, Circuit::VertexDeletion::No);
     } else {
       circ.substitute(replacement, v, Circuit::VertexDeletion::No);
     }
     bin.insert(v);
-    success = true;
-  }
-  if (allowed_gates.find(OpType::CX) == allowed_gates.end()) {
-    const Op_ptr cx_op = get_op_ptr(OpType::CX);
-    success = circ.substitute_all(cx_replacement, cx_op) | success;
   }
+  return success;
+}
+
+static bool standard_rebase(
+    Circuit& circ, const OpTypeSet& allowed_gates,
+    const Circuit& cx_replacement,
+    const std::function<Circuit(const Expr&, const Expr&, const Expr&)>&
+        tk1_replacement) {
+  bool success = false;
+  VertexSet bin;
+  ReplacementTable replacements(CX_circ_from_multiq);
   for (const Vertex& v : circ.all_vertices()) {
-    if (bin.contains(v)) continue;
-    if (circ.n_in_edges_of_type(v, EdgeType::Quantum) > 1) continue;
     Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+    unsigned n_qubits = circ.n_in_edges_of_type(v, EdgeType::Quantum);
+    if (n_qubits <= 1) continue;
     bool conditional = op->get_type() == OpType::Conditional;
     if (conditional) {
       const Conditional& cond = static_cast<const Conditional&>(*op);
       op = cond.get_op();
     }
     OpType type = op->get_type();
-    if (!is_gate_type(type) || is_projective_type(type) ||
-        allowed_gates.find(type) != allowed_gates.end())
+    if (allowed_gates.find(type) != allowed_gates.end() || type == OpType::CX ||
+        type == OpType::Barrier)
       continue;
     // need to convert
-    Circuit replacement = rebase_op(as_gate_ptr(op), tk1_replacement);
+    const Circuit& replacement = replacements.get(op);
     if (conditional) {
       circ.substitute_conditional(replacement, v, Circuit::VertexDeletion::No);
     } else {
@@ -109,6 +206,13 @@ static bool standard_rebase(
     bin.insert(v);
     success = true;
   }
+  if (allowed_gates.find(OpType::CX) == allowed_gates.end()) {
+    const Op_ptr cx_op = get_op_ptr(OpType::CX);
+    success = circ.substitute_all(cx_replacement, cx_op) | success;
+  }
+  success = rebase_single_qubit_gates(
+                circ, allowed_gates, tk1_replacement, bin) |
+            success;
   circ.remove_vertices(
       bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
   return success;
@@ -122,27 +226,15 @@ static bool standard_rebase_via_tk2(
         tk2_replacement) {
   bool success = false;
   VertexSet bin;
-  // 1. Replace all multi-qubit gates outside the target gateset to TK2.
-  for (const Vertex& v : circ.all_vertices()) {
-    Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
-    unsigned n_qubits = circ.n_in_edges_of_type(v, EdgeType::Quantum);
-    if (n_qubits <= 1) continue;
-    bool conditional = op->get_type() == OpType::Conditional;
-    if (conditional) {
-      const Conditional& cond = static_cast<const Conditional&>(*op);
-      op = cond.get_op();
-    }
-    OpType type = op->get_type();
-    if (allowed_gates.contains(type) || type == OpType::Barrier) continue;
-    // need to convert
+  ReplacementTable replacements([&tk2_replacement](const Op_ptr op) {
     Circuit replacement = TK2_circ_from_multiq(op);
     // Find replacement Circuit for all TK2 gates
     VertexSet TK2_bin;
     for (const Vertex& u : replacement.all_vertices()) {
-      Op_ptr op = circ.get_Op_ptr_from_Vertex(u);
-      TKET_ASSERT(op->get_type() != OpType::Conditional);
-      if (op->get_type() == OpType::TK2) {
-        std::vector<Expr> params = op->get_params();
+      Op_ptr u_op = replacement.get_Op_ptr_from_Vertex(u);
+      TKET_ASSERT(u_op->get_type() != OpType::Conditional);
+      if (u_op->get_type() == OpType::TK2) {
+        std::vector<Expr> params = u_op->get_params();
         TKET_ASSERT(params.size() == 3);
         Circuit u_replacement =
             tk2_replacement(params[0], params[1], params[2]);
@@ -154,31 +246,22 @@ static bool standard_rebase_via_tk2(
     remove_redundancies().apply(replacement);
     replacement.remove_vertices(
         TK2_bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
-    if (conditional) {
-      circ.substitute_conditional(replacement, v, Circuit::VertexDeletion::No);
-    } else {
-      circ.substitute(replacement, v, Circuit::VertexDeletion::No);
-    }
-    bin.insert(v);
-    success = true;
-  }
-
-  // 2. Replace 0- and 1-qubit gates by converting to TK1 and replacing.
+    return replacement;
+  });
+  // 1. Replace all multi-qubit gates outside the target gateset to TK2.
   for (const Vertex& v : circ.all_vertices()) {
-    if (bin.contains(v)) continue;
-    if (circ.n_in_edges_of_type(v, EdgeType::Quantum) > 1) continue;
     Op_ptr op = circ.get_Op_ptr_from_Vertex(v);
+    unsigned n_qubits = circ.n_in_edges_of_type(v, EdgeType::Quantum);
+    if (n_qubits <= 1) continue;
     bool conditional = op->get_type() == OpType::Conditional;
     if (conditional) {
       const Conditional& cond = static_cast<const Conditional&>(*op);
       op = cond.get_op();
     }
     OpType type = op->get_type();
-    if (!is_gate_type(type) || is_projective_type(type) ||
-        allowed_gates.contains(type))
-      continue;
+    if (allowed_gates.contains(type) || type == OpType::Barrier) continue;
     // need to convert
-    Circuit replacement = rebase_op(as_gate_ptr(op), tk1_replacement);
+    const Circuit& replacement = replacements.get(op);
     if (conditional) {
       circ.substitute_conditional(replacement, v, Circuit::VertexDeletion::No);
     } else {
@@ -187,6 +270,11 @@ static bool standard_rebase_via_tk2(
     bin.insert(v);
     success = true;
   }
+
+  // 2. Replace 0- and 1-qubit gates by converting to TK1 and replacing.
+  success = rebase_single_qubit_gates(
+                circ, allowed_gates, tk1_replacement, bin) |
+            success;
   circ.remove_vertices(
       bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
   return success;
@@ -12,8 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <deque>
+#include <functional>
+#include <map>
 #include <optional>
+#include <tuple>
 
+#include "tket/Circuit/Conditional.hpp"
 #include "tket/Circuit/DAGDefs.hpp"
 #include "tket/Gate/Gate.hpp"
 #include "tket/Transformations/BasicOptimisation.hpp"
@@ -172,7 +177,7 @@ static bool try_join_rotations_and_detach_successor(
   Op_ptr op_new = get_op_ptr(
       vertex_op_descriptor.type(), {expr1 + expr2},
       circuit.get_in_edges(successor).size());
-  circuit.dag[vertex].op = op_new;
+  circuit.set_vertex_Op_ptr(vertex, op_new);
 
   // detach successor only (this adds vertex to list of vertices to check again,
   // so will be removed later if is identity)
@@ -272,4 +277,139 @@ bool redundancy_removal(Circuit &circuit) {
 
 Transform remove_redundancies() { return Transform(redundancy_removal); }
 
+// Memo of the Pauli basis with which each vertex port commutes. Entries are
+// checked against the op at the vertex, so an entry for a vertex whose op has
+// since been replaced (e.g. by merging rotations) is recomputed.
+class CommutationIndex {
+ public:
+  std::optional<Pauli> colour(
+      const Circuit &circuit, const Vertex &vertex, PortType port_type,
+      port_t port) {
+    const Op_ptr op = circuit.get_Op_ptr_from_Vertex(vertex);
+    const auto key = std::make_tuple(vertex, port_type, port);
+    auto found = colours_.find(key);
+    if (found != colours_.end() && found->second.first == op) {
+      return found->second.second;
+    }
+    std::optional<Pauli> c = circuit.commuting_basis(vertex, port_type, port);
+    colours_[key] = {op, c};
+    return c;
+  }
+
+  // As commute_through_multis: whether the source and target of an edge
+  // commute, where they are not both multi-qubit operations
+  bool ends_commute(const Circuit &circuit, const Edge &edge) {
+    const Vertex source = circuit.source(edge);
+    const Vertex target = circuit.target(edge);
+    if (circuit.n_in_edges(source) > 1 && circuit.n_in_edges(target) > 1) {
+      return false;
+    }
+    const auto [source_port, target_port] = circuit.get_ports(edge);
+    std::optional<Pauli> target_colour =
+        colour(circuit, target, PortType::Target, target_port);
+    Op_ptr source_op = circuit.get_Op_ptr_from_Vertex(source);
+    if (source_op->get_type() == OpType::Conditional) {
+      source_op = static_cast<const Conditional &>(*source_op).get_op();
+    }
+    if (!source_op->get_desc().is_gate()) {
+      return circuit.commutes_with_basis(
+          source, target_colour, PortType::Source, source_port);
+    }
+    // Gate::commutes_with_basis, from the memoised colour of the source
+    std::optional<Pauli> source_colour =
+        colour(circuit, source, PortType::Source, source_port);
+    if (!target_colour || !source_colour) return false;
+    return target_colour == Pauli::I || source_colour == Pauli::I ||
+           target_colour == source_colour;
+  }
+
+ private:
+  std::map<
+      std::tuple<Vertex, PortType, port_t>,
+      std::pair<Op_ptr, std::optional<Pauli>>>
+      colours_;
+};
+
+// Move a single-qubit operation back past the multi-qubit operations it
+// commutes with, calling `touch` on each vertex whose neighbourhood changes.
+// Return true iff it moved.
+static bool commute_single_to_front(
+    Circuit &circuit, const Vertex &vertex, CommutationIndex &index,
+    const std::function<void(const Vertex &)> &touch) {
+  if (circuit.n_in_edges(vertex) != 1 ||
+      circuit.n_in_edges_of_type(vertex, EdgeType::Quantum) != 1 ||
+      circuit.n_out_edges(vertex) != 1) {
+    return false;
+  }
+  bool moved = false;
+  Edge in = circuit.get_nth_in_edge(vertex, 0);
+  Vertex predecessor = circuit.source(in);
+  while (circuit.n_in_edges_of_type(predecessor, EdgeType::Quantum) > 1 &&
+         index.ends_commute(circuit, in)) {
+    const Edge boundary = circuit.get_last_edge(predecessor, in);
+    touch(predecessor);
+    touch(circuit.target(circuit.get_nth_out_edge(vertex, 0)));
+    circuit.remove_vertex(
+        vertex, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::No);
+    circuit.rewire(vertex, {boundary}, {EdgeType::Quantum});
+    moved = true;
+    in = circuit.get_nth_in_edge(vertex, 0);
+    predecessor = circuit.source(in);
+  }
+  // The new predecessor may now cancel with the vertex
+  if (moved) touch(predecessor);
+  return moved;
+}
+
+static bool commute_and_remove(Circuit &circuit) {
+  bool success = false;
+  CommutationIndex index;
+  VertexSet bin;
+  std::deque<Vertex> worklist;
+  VertexSet queued;
+  const std::function<void(const Vertex &)> touch = [&](const Vertex &v) {
+    if (!bin.contains(v) && queued.insert(v).second) {
+      worklist.push_back(v);
+    }
+  };
+  for (const Vertex &v : circuit.vertices_in_order()) {
+    touch(v);
+  }
+  while (!worklist.empty()) {
+    const Vertex vertex = worklist.front();
+    worklist.pop_front();
+    queued.erase(vertex);
+    if (bin.contains(vertex)) continue;
+    success |= commute_single_to_front(circuit, vertex, index, touch);
+    // Vertices that may meet new neighbours if the vertex or its successor
+    // is removed
+    VertexVec nearby = circuit.get_successors(vertex);
+    if (nearby.size() == 1) {
+      const VertexVec next = circuit.get_successors(nearby[0]);
+      nearby.insert(nearby.end(), next.begin(), next.end());
+    }
+    VertexDetachmentInfo detachmentInfo;
+    if (!try_detach_vertex(circuit, vertex, detachmentInfo)) continue;
+    success = true;
+    bin.insert(
+        detachmentInfo.detachedVertices.cbegin(),
+        detachmentInfo.detachedVertices.cend());
+    for (const Vertex &v : detachmentInfo.detachedVertexPredecessors) {
+      touch(v);
+    }
+    for (const Vertex &v : nearby) {
+      touch(v);
+    }
+    // A merged rotation stays in place and may now be an identity
+    touch(vertex);
+  }
+  circuit.remove_vertices(
+      bin, Circuit::GraphRewiring::No, Circuit::VertexDeletion::Yes);
+  return success;
+}
+
+Transform commute_and_remove_redundancies() {
+  return Transform(commute_and_remove);
+}
+
 }  // namespace tket::Transforms
@@ -14,6 +14,9 @@
 
 #include "tket/Transformations/Replacement.hpp"
 
+#include <optional>
+#include <utility>
+
 #include "tket/Circuit/CircPool.hpp"
 #include "tket/Circuit/CircUtils.hpp"
 #include "tket/Circuit/Circuit.hpp"
@@ -23,6 +26,7 @@
 #include "tket/OpType/OpTypeInfo.hpp"
 #include "tket/Transformations/Decomposition.hpp"
 #include "tket/Transformations/Transform.hpp"
+#include "tket/Utils/Expression.hpp"
 
 namespace tket {
 
@@ -119,6 +123,30 @@ Circuit CX_circ_from_multiq(const Op_ptr op) {
   }
 }
 
+ReplacementTable::ReplacementTable(std::function<Circuit(const Op_ptr)> build)
+    : build_(std::move(build)) {}
+
+const Circuit& ReplacementTable::get(const Op_ptr& op) {
+  if (!op->get_desc().is_gate()) {
+    uncached_ = build_(op);
+    return uncached_;
+  }
+  key_t key{op->get_type(), {}, op->n_qubits()};
+  for (const Expr& e : op->get_params()) {
+    std::optional<double> x = eval_expr(e);
+    if (!x) {
+      uncached_ = build_(op);
+      return uncached_;
+    }
+    std::get<1>(key).push_back(*x);
+  }
+  auto found = table_.find(key);
+  if (found == table_.end()) {
+    found = table_.emplace(std::move(key), build_(op)).first;
+  }
+  return found->second;
+}
+
 Circuit CX_ZX_circ_from_op(const Op_ptr op) {
   OpDesc desc = op->get_desc();
   if (!desc.is_gate())
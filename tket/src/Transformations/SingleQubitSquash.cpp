@@ -22,6 +22,7 @@
 #include "tket/Circuit/Circuit.hpp"
 #include "tket/Circuit/DAGDefs.hpp"
 #include "tket/Gate/Gate.hpp"
+#include "tket/Utils/Trace.hpp"
 
 namespace tket {
 
@@ -39,6 +40,7 @@ SingleQubitSquash::SingleQubitSquash(const SingleQubitSquash &other)
       reversed_(other.reversed_),
       always_squash_symbols_(other.always_squash_symbols_) {}
 bool SingleQubitSquash::squash() {
+  TKET_TRACE_SCOPE("SingleQubitSquash::squash");
   bool success = false;
 
   VertexVec inputs = circ_.q_inputs();
@@ -16,13 +16,20 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <string>
+#include <thread>
 #include <tkassert/Assert.hpp>
+#include <vector>
 
 #include "tket/Circuit/CircUtils.hpp"
 #include "tket/Circuit/Circuit.hpp"
@@ -146,6 +153,7 @@ class QISystem {
         target_2qb_gate_(target_2qb_gate),
         bin_(),
         interactions_(),
+        candidates_(),
         idx_(0) {}
 
   // Add a new interaction to the system consisting of a single edge, and
@@ -206,12 +214,11 @@ class QISystem {
     I->append(v);
   }
 
-  // Close an interaction, squashing it if possible, and erasing it from the
-  // set. Return true iff any substitution was made, and the (possibly new)
-  // vector of outgoing edges from the region of the interaction.
-  std::pair<bool, EdgeVec> close_interaction(int i) {
+  // Close an interaction, recording it as a candidate for resynthesis if it
+  // has two or three wires, and erase it from the set. Return the vector of
+  // outgoing edges from the region of the interaction.
+  EdgeVec close_interaction(int i) {
     iptr &I = interactions_.at(i);
-    bool changed = false;
     EdgeVec outs = I->out_edges();
     switch (I->n_wires()) {
       case 1:
@@ -219,27 +226,24 @@ class QISystem {
       case 2:
       case 3: {
         Subcircuit sub = I->subcircuit();
-        Circuit subc = circ_.subcircuit(sub);
-        Circuit replacement = candidate_sub(subc, target_2qb_gate_);
-        if (replacement.count_gates(target_2qb_gate_) <
-            subc.count_gates(target_2qb_gate_)) {
-          // 1. Collect data needed later to reconstruct the list of out-edges:
-          std::vector<std::pair<Vertex, port_t>> out_vertex_ports;
-          for (const Edge &e : outs) {
-            out_vertex_ports.push_back(
-                {circ_.target(e), circ_.get_target_port(e)});
-          }
-          // 2. Do the substitution:
-          VertexSet old_vertices = I->vertices();
-          bin_.insert(bin_.end(), old_vertices.begin(), old_vertices.end());
-          circ_.substitute(replacement, sub, Circuit::VertexDeletion::No);
-          // 3. Construct the new list of out-edges:
-          EdgeVec new_outs;
-          for (const auto &[v, p] : out_vertex_ports) {
-            new_outs.push_back(circ_.get_nth_in_edge(v, p));
-          }
-          changed = true;
-          outs = std::move(new_outs);
+        Candidate c;
+        c.vertices = I->vertices();
+        bool anchored = true;
+        for (const Edge &e : sub.q_in_hole) {
+          Vertex v = circ_.target(e);
+          anchored &= c.vertices.contains(v);
+          c.ins.push_back({v, circ_.get_target_port(e)});
+        }
+        for (const Edge &e : sub.q_out_hole) {
+          Vertex v = circ_.source(e);
+          anchored &= c.vertices.contains(v);
+          c.outs.push_back({v, circ_.get_source_port(e)});
+        }
+        // A wire with no vertices has no port to find its edge by once a
+        // neighbouring interaction is substituted, so leave it alone.
+        if (anchored) {
+          c.subc = circ_.subcircuit(sub);
+          candidates_.push_back(std::move(c));
         }
         break;
       }
@@ -247,29 +251,23 @@ class QISystem {
         TKET_ASSERT(!"Interaction with invalid number of wires");
     }
     interactions_.erase(i);
-    return {changed, outs};
+    return outs;
   }
 
-  // Close an interaction and spawn new ones on its outgoing edges. Return true
-  // iff any substitution is made.
-  bool close_interaction_and_spawn(int i) {
-    auto [changed, outs] = close_interaction(i);
-    for (const Edge &e : outs) {
+  // Close an interaction and spawn new ones on its outgoing edges.
+  void close_interaction_and_spawn(int i) {
+    for (const Edge &e : close_interaction(i)) {
       create_new_interaction_from_edge(e);
     }
-    return changed;
   }
 
   // Close all interactions that have v as a direct successor, and start new
-  // ones following them. Return true iff any substitution is made.
-  bool close_interactions_feeding_vertex(const Vertex &v) {
-    bool changed = false;
+  // ones following them.
+  void close_interactions_feeding_vertex(const Vertex &v) {
     std::vector<int> v_interactions = interactions_feeding_vertex(v);
 
     for (int i : v_interactions) {
-      auto [change, outs] = close_interaction(i);
-      changed |= change;
-      for (const Edge &e : outs) {
+      for (const Edge &e : close_interaction(i)) {
         if (circ_.target(e) != v) {
           create_new_interaction_from_edge(e);
         }
@@ -279,13 +277,10 @@ class QISystem {
     for (const Edge &e : circ_.get_out_edges_of_type(v, EdgeType::Quantum)) {
       create_new_interaction_from_edge(e);
     }
-
-    return changed;
   }
 
-  // Close all interactions. Return true iff any substitution is made.
-  bool close_all_interactions() {
-    bool changed = false;
+  // Close all interactions.
+  void close_all_interactions() {
     // Form set of keys.
     std::set<int> indices;
     for (const auto &pair : interactions_) {
@@ -293,8 +288,79 @@ class QISystem {
     }
     // Close each one.
     for (int i : indices) {
-      auto [change, outs] = close_interaction(i);
-      changed |= change;
+      close_interaction(i);
+    }
+  }
+
+  // Resynthesise the candidates in parallel, keeping each replacement that
+  // has fewer target gates. Only the first `max_candidates` are considered
+  // (all if 0), and none are started after the deadline.
+  void resynthesise_candidates(
+      unsigned max_candidates,
+      std::optional<std::chrono::steady_clock::time_point> deadline) {
+    std::size_t n = candidates_.size();
+    if (max_candidates != 0) {
+      n = std::min<std::size_t>(n, max_candidates);
+    }
+    if (n == 0) return;
+    std::atomic<std::size_t> next_index = 0;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    const auto work = [&]() {
+      try {
+        for (std::size_t index = next_index++; index < n;
+             index = next_index++) {
+          if (deadline && std::chrono::steady_clock::now() > *deadline) {
+            next_index = n;
+            break;
+          }
+          Candidate &c = candidates_[index];
+          Circuit replacement = candidate_sub(c.subc, target_2qb_gate_);
+          if (replacement.count_gates(target_2qb_gate_) <
+              c.subc.count_gates(target_2qb_gate_)) {
+            c.replacement = std::move(replacement);
+          }
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next_index = n;
+      }
+    };
+    const std::size_t number_of_threads = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()), n);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < number_of_threads; ++i) {
+      workers.emplace_back(work);
+    }
+    work();
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+
+  // Substitute the improved candidates, in the order they were closed.
+  // Return true iff any substitution is made.
+  bool substitute_candidates() {
+    bool changed = false;
+    for (Candidate &c : candidates_) {
+      if (!c.replacement) continue;
+      Subcircuit sub;
+      for (const auto &[v, p] : c.ins) {
+        sub.q_in_hole.push_back(circ_.get_nth_in_edge(v, p));
+      }
+      for (const auto &[v, p] : c.outs) {
+        sub.q_out_hole.push_back(circ_.get_nth_out_edge(v, p));
+      }
+      sub.verts = c.vertices;
+      bin_.insert(bin_.end(), c.vertices.begin(), c.vertices.end());
+      circ_.substitute(*c.replacement, sub, Circuit::VertexDeletion::No);
+      changed = true;
     }
     return changed;
   }
@@ -306,18 +372,36 @@ class QISystem {
   }
 
  private:
+  // A closed interaction, with its boundary held as the ports of its own
+  // vertices. These stay valid when neighbouring interactions are
+  // substituted, whereas the boundary edges themselves are replaced.
+  struct Candidate {
+    std::vector<std::pair<Vertex, port_t>> ins;
+    std::vector<std::pair<Vertex, port_t>> outs;
+    VertexSet vertices;
+    Circuit subc;
+    std::optional<Circuit> replacement;
+  };
+
   Circuit &circ_;
   OpType target_2qb_gate_;
   VertexList bin_;
   std::map<int, iptr> interactions_;
+  std::vector<Candidate> candidates_;
   int idx_;
 };
 
-Transform three_qubit_squash(OpType target_2qb_gate) {
-  return Transform([target_2qb_gate](Circuit &circ) {
-    bool changed = false;
+Transform three_qubit_squash(
+    OpType target_2qb_gate, unsigned max_candidates, unsigned timeout) {
+  return Transform([target_2qb_gate, max_candidates, timeout](Circuit &circ) {
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if (timeout != 0) {
+      deadline = std::chrono::steady_clock::now() +
+                 std::chrono::milliseconds(timeout);
+    }
 
-    // Step through the vertices in topological order.
+    // Step through the vertices in topological order, collecting candidate
+    // subcircuits without changing the circuit.
     QISystem Is(circ, target_2qb_gate);  // set of "live" interactions
     for (const Vertex &v : circ.vertices_in_order()) {
       const EdgeVec v_q_ins = circ.get_in_edges_of_type(v, EdgeType::Quantum);
@@ -352,7 +436,7 @@ Transform three_qubit_squash(OpType target_2qb_gate) {
           !circ.get_in_edges_of_type(v, EdgeType::Boolean).empty() ||
           optype == OpType::Barrier || optype == OpType::Reset ||
           optype == OpType::Collapse || !op->free_symbols().empty()) {
-        changed |= Is.close_interactions_feeding_vertex(v);
+        Is.close_interactions_feeding_vertex(v);
         continue;
       }
 
@@ -374,13 +458,17 @@ Transform three_qubit_squash(OpType target_2qb_gate) {
         } else {
           // Close one of the interactions meeting v.
           int i = Is.largest_interaction(v_Is);
-          changed |= Is.close_interaction_and_spawn(i);
+          Is.close_interaction_and_spawn(i);
         }
       }
     }
 
     // Close all remaining interactions.
-    changed |= Is.close_all_interactions();
+    Is.close_all_interactions();
+
+    // Resynthesise the candidates, which are disjoint, then substitute.
+    Is.resynthesise_candidates(max_candidates, deadline);
+    bool changed = Is.substitute_candidates();
 
     // Delete removed vertices.
     Is.destroy_bin();
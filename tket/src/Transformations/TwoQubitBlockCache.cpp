@@ -0,0 +1,128 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Transformations/TwoQubitBlockCache.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "tket/Utils/Expression.hpp"
+
+namespace tket {
+
+namespace Transforms {
+
+// Number of blocks remembered by the shared cache
+static constexpr std::size_t shared_capacity = 4096;
+
+bool TwoQubitBlockCache::Key::operator<(const Key& other) const {
+  return std::tie(gates, phase, target, cx_fidelity, allow_swaps) <
+         std::tie(
+             other.gates, other.phase, other.target, other.cx_fidelity,
+             other.allow_swaps);
+}
+
+TwoQubitBlockCache::TwoQubitBlockCache(std::size_t capacity)
+    : capacity_(capacity), hits_(0), misses_(0) {
+  if (capacity == 0) {
+    throw std::invalid_argument("TwoQubitBlockCache capacity must be positive");
+  }
+}
+
+TwoQubitBlockCache& TwoQubitBlockCache::shared() {
+  static TwoQubitBlockCache cache(shared_capacity);
+  return cache;
+}
+
+std::optional<TwoQubitBlockCache::Key> TwoQubitBlockCache::make_key(
+    const Circuit& block, OpType target, double cx_fidelity,
+    bool allow_swaps) {
+  std::optional<double> phase = eval_expr(block.get_phase());
+  if (!phase) return std::nullopt;
+  Key key{{}, *phase, target, cx_fidelity, allow_swaps};
+  qubit_vector_t qubits = block.all_qubits();
+  for (const Command& cmd : block) {
+    Op_ptr op = cmd.get_op_ptr();
+    if (!op->get_desc().is_gate()) return std::nullopt;
+    std::vector<double> params;
+    for (const Expr& e : op->get_params()) {
+      std::optional<double> x = eval_expr(e);
+      if (!x) return std::nullopt;
+      params.push_back(*x);
+    }
+    std::vector<unsigned> positions;
+    for (const Qubit& q : cmd.get_qubits()) {
+      auto found = std::find(qubits.begin(), qubits.end(), q);
+      positions.push_back(found - qubits.begin());
+    }
+    key.gates.push_back({op->get_type(), params, positions});
+  }
+  return key;
+}
+
+std::optional<TwoQubitBlockCache::result_t> TwoQubitBlockCache::find(
+    const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = lookup_.find(key);
+  if (found == lookup_.end()) {
+    ++misses_;
+    return std::nullopt;
+  }
+  ++hits_;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->second;
+}
+
+void TwoQubitBlockCache::insert(const Key& key, const result_t& result) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = lookup_.find(key);
+  if (found != lookup_.end()) {
+    found->second->second = result;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return;
+  }
+  if (entries_.size() == capacity_) {
+    lookup_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.push_front({key, result});
+  lookup_.insert({key, entries_.begin()});
+}
+
+std::size_t TwoQubitBlockCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+unsigned TwoQubitBlockCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+unsigned TwoQubitBlockCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+void TwoQubitBlockCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lookup_.clear();
+  hits_ = 0;
+  misses_ = 0;
+}
+
+}  // namespace Transforms
+
+}  // namespace tket
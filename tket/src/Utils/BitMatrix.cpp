@@ -0,0 +1,275 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Utils/BitMatrix.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <boost/functional/hash.hpp>
+#include <map>
+
+namespace tket {
+
+static unsigned get_words_per_row(unsigned cols) {
+  return (cols + BitMatrix::BITS_PER_WORD - 1) / BitMatrix::BITS_PER_WORD;
+}
+
+BitMatrix::BitMatrix() : rows_(0), cols_(0), words_per_row_(0), words_() {}
+
+BitMatrix::BitMatrix(unsigned rows, unsigned cols)
+    : rows_(rows),
+      cols_(cols),
+      words_per_row_(get_words_per_row(cols)),
+      words_(rows * words_per_row_, 0) {}
+
+BitMatrix::BitMatrix(const MatrixXb &matrix)
+    : BitMatrix(matrix.rows(), matrix.cols()) {
+  for (unsigned c = 0; c < cols_; ++c) {
+    for (unsigned r = 0; r < rows_; ++r) {
+      if (matrix(r, c)) (*this)(r, c) = true;
+    }
+  }
+}
+
+bool BitMatrix::operator==(const BitMatrix &other) const {
+  return rows_ == other.rows_ && cols_ == other.cols_ &&
+         words_ == other.words_;
+}
+
+std::size_t BitMatrix::hash_value() const {
+  std::size_t seed = 0;
+  boost::hash_combine(seed, rows_);
+  boost::hash_combine(seed, cols_);
+  for (Word w : words_) boost::hash_combine(seed, w);
+  return seed;
+}
+
+MatrixXb BitMatrix::to_matrix() const {
+  MatrixXb matrix(rows_, cols_);
+  for (unsigned c = 0; c < cols_; ++c) {
+    for (unsigned r = 0; r < rows_; ++r) {
+      matrix(r, c) = (*this)(r, c);
+    }
+  }
+  return matrix;
+}
+
+BitMatrix BitMatrix::transpose() const {
+  BitMatrix result(cols_, rows_);
+  for (unsigned r = 0; r < rows_; ++r) {
+    const Word *data = row_data(r);
+    for (unsigned k = 0; k < words_per_row_; ++k) {
+      // Visit only the set bits of each word.
+      for (Word word = data[k]; word != 0; word &= word - 1) {
+        result(k * BITS_PER_WORD + std::countr_zero(word), r) = true;
+      }
+    }
+  }
+  return result;
+}
+
+MatrixXb BitMatrix::get_row(unsigned row) const {
+  MatrixXb matrix(1, cols_);
+  for (unsigned c = 0; c < cols_; ++c) {
+    matrix(0, c) = (*this)(row, c);
+  }
+  return matrix;
+}
+
+bool BitMatrix::row_is_zero(unsigned row) const {
+  const Word *data = row_data(row);
+  return std::all_of(
+      data, data + words_per_row_, [](Word word) { return word == 0; });
+}
+
+void BitMatrix::set_row_zero(unsigned row) {
+  std::fill_n(row_data(row), words_per_row_, 0);
+}
+
+void BitMatrix::xor_row(unsigned from, unsigned to) {
+  xor_words(row_data(from), row_data(to), words_per_row_);
+}
+
+void BitMatrix::copy_row(unsigned from, unsigned to) {
+  std::copy_n(row_data(from), words_per_row_, row_data(to));
+}
+
+void BitMatrix::swap_rows(unsigned row1, unsigned row2) {
+  std::swap_ranges(
+      row_data(row1), row_data(row1) + words_per_row_, row_data(row2));
+}
+
+void BitMatrix::copy_col(unsigned from, unsigned to) {
+  for (unsigned r = 0; r < rows_; ++r) {
+    (*this)(r, to) = static_cast<bool>((*this)(r, from));
+  }
+}
+
+void BitMatrix::conservative_resize(unsigned rows, unsigned cols) {
+  BitMatrix resized(rows, cols);
+  const unsigned common_rows = std::min(rows, rows_);
+  const unsigned common_words =
+      std::min(words_per_row_, resized.words_per_row_);
+  for (unsigned r = 0; r < common_rows; ++r) {
+    std::copy_n(row_data(r), common_words, resized.row_data(r));
+    // Clear the entries beyond the new last column.
+    if (cols < cols_ && cols % BITS_PER_WORD != 0) {
+      resized.row_data(r)[resized.words_per_row_ - 1] &=
+          (Word(1) << (cols % BITS_PER_WORD)) - 1;
+    }
+  }
+  *this = std::move(resized);
+}
+
+bool BitMatrix::and_parity(const Word *a, const Word *b, unsigned n_words) {
+  Word acc = 0;
+  for (unsigned k = 0; k < n_words; ++k) acc ^= a[k] & b[k];
+  return std::popcount(acc) % 2 == 1;
+}
+
+BitMatrix::Word BitMatrix::get_bits(
+    unsigned row, unsigned start, unsigned length) const {
+  const Word *data = row_data(row);
+  const unsigned k = start / BITS_PER_WORD;
+  const unsigned offset = start % BITS_PER_WORD;
+  Word bits = data[k] >> offset;
+  if (offset != 0 && k + 1 < words_per_row_) {
+    bits |= data[k + 1] << (BITS_PER_WORD - offset);
+  }
+  if (length < BITS_PER_WORD) bits &= (Word(1) << length) - 1;
+  return bits;
+}
+
+// The entries of a row in columns [i0, i1), as a key for spotting repeated
+// sub-rows.
+static std::vector<BitMatrix::Word> get_chunk(
+    const BitMatrix &m, unsigned row, unsigned i0, unsigned i1) {
+  std::vector<BitMatrix::Word> chunk;
+  for (unsigned c = i0; c < i1; c += BitMatrix::BITS_PER_WORD) {
+    chunk.push_back(
+        m.get_bits(row, c, std::min(BitMatrix::BITS_PER_WORD, i1 - c)));
+  }
+  return chunk;
+}
+
+static bool is_zero_chunk(const std::vector<BitMatrix::Word> &chunk) {
+  return std::all_of(chunk.begin(), chunk.end(), [](BitMatrix::Word word) {
+    return word == 0;
+  });
+}
+
+/* see https://web.eecs.umich.edu/~imarkov/pubs/jour/qic08-cnot.pdf for a full
+ * explanation of this technique */
+/* K. Patel, I. Markov, J. Hayes. Optimal Synthesis of Linear Reversible
+        Circuits. QIC 2008 */
+std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_row_ops(
+    const BitMatrix &a, unsigned blocksize) {
+  std::vector<std::pair<unsigned, unsigned>> ops;
+  BitMatrix m = a;
+  unsigned rows = m.rows();
+  unsigned cols = m.cols();
+  std::vector<unsigned> pcols;  // columns in which we pivoted
+  unsigned pivot_row = 0;
+  unsigned ceiling = (cols + blocksize - 1) / blocksize;
+
+  // Get to upper echelon form
+  for (unsigned sec = 0; sec < ceiling; ++sec) {
+    unsigned i0 = sec * blocksize;
+    unsigned i1 = std::min(cols, (sec + 1) * blocksize);
+
+    // First eliminate repeated sub-rows of this section
+    std::map<std::vector<BitMatrix::Word>, unsigned> chunks;
+    for (unsigned r = pivot_row; r < rows; ++r) {
+      std::vector<BitMatrix::Word> chunk = get_chunk(m, r, i0, i1);
+      if (is_zero_chunk(chunk)) continue;
+      auto chunk_it = chunks.find(chunk);
+      if (chunk_it != chunks.end()) {
+        m.xor_row(chunk_it->second, r);
+        ops.push_back({chunk_it->second, r});
+      } else {
+        chunks.insert({std::move(chunk), r});
+      }
+    }
+    // Then do gaussian elimination on the remaining entries
+    for (unsigned col = i0; col < i1; ++col) {
+      unsigned first_1 = pivot_row;
+      while (first_1 < rows && !m(first_1, col)) {
+        ++first_1;
+      }
+      if (first_1 == rows) continue;
+
+      if (first_1 != pivot_row) {
+        m.xor_row(first_1, pivot_row);
+        ops.push_back({first_1, pivot_row});
+      }
+
+      for (unsigned r = std::max(pivot_row + 1, first_1); r < rows; ++r) {
+        if (m(r, col)) {
+          m.xor_row(pivot_row, r);
+          ops.push_back({pivot_row, r});
+        }
+      }
+
+      pcols.push_back(col);
+      ++pivot_row;
+    }
+  }
+
+  // The matrix is now upper triangular; reduce it to diagonal
+  --pivot_row;
+
+  for (unsigned sec = ceiling; sec-- > 0;) {
+    unsigned i0 = sec * blocksize;
+    unsigned i1 = std::min(cols, (sec + 1) * blocksize);
+
+    std::map<std::vector<BitMatrix::Word>, unsigned> chunks;
+    for (unsigned r = pivot_row + 1; r-- > 0;) {
+      std::vector<BitMatrix::Word> chunk = get_chunk(m, r, i0, i1);
+      if (is_zero_chunk(chunk)) continue;
+      auto chunk_it = chunks.find(chunk);
+      if (chunk_it != chunks.end()) {
+        m.xor_row(chunk_it->second, r);
+        ops.push_back({chunk_it->second, r});
+      } else {
+        chunks.insert({std::move(chunk), r});
+      }
+    }
+    while (!pcols.empty() && i0 <= pcols.back() && pcols.back() < i1) {
+      unsigned pcol = pcols.back();
+      pcols.pop_back();
+      for (unsigned r = 0; r < pivot_row; ++r) {
+        if (m(r, pcol)) {
+          m.xor_row(pivot_row, r);
+          ops.push_back({pivot_row, r});
+        }
+      }
+      --pivot_row;
+    }
+  }
+
+  return ops;
+}
+
+std::vector<std::pair<unsigned, unsigned>> gaussian_elimination_col_ops(
+    const BitMatrix &a, unsigned blocksize) {
+  return gaussian_elimination_row_ops(a.transpose(), blocksize);
+}
+
+unsigned pmh_blocksize(unsigned n) {
+  if (n < 2) return 1;
+  // Half of ceil(log2(n)), rounded up
+  return (std::bit_width(n - 1) + 1) / 2;
+}
+
+}  // namespace tket
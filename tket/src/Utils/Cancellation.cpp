@@ -0,0 +1,56 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Utils/Cancellation.hpp"
+
+namespace tket {
+
+static thread_local const CancellationToken* current_token = nullptr;
+
+CancellationToken::CancellationToken() : state_(std::make_shared<State>()) {}
+
+CancellationToken::CancellationToken(
+    std::chrono::steady_clock::duration timeout)
+    : CancellationToken() {
+  state_->deadline = std::chrono::steady_clock::now() + timeout;
+}
+
+void CancellationToken::cancel() const { state_->cancelled = true; }
+
+bool CancellationToken::is_cancelled() const {
+  if (state_->cancelled) return true;
+  if (state_->deadline &&
+      std::chrono::steady_clock::now() >= *state_->deadline) {
+    state_->cancelled = true;
+    return true;
+  }
+  return false;
+}
+
+void CancellationToken::throw_if_cancelled() const {
+  if (is_cancelled()) throw CompilationCancelled();
+}
+
+CancellationScope::CancellationScope(const CancellationToken& token)
+    : previous_(current_token) {
+  current_token = &token;
+}
+
+CancellationScope::~CancellationScope() { current_token = previous_; }
+
+void throw_if_cancelled() {
+  if (current_token) current_token->throw_if_cancelled();
+}
+
+}  // namespace tket
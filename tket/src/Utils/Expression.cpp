@@ -14,7 +14,12 @@
 
 #include "tket/Utils/Expression.hpp"
 
+#include <cctype>
+#include <cmath>
+#include <charconv>
+#include <locale>
 #include <optional>
+#include <sstream>
 
 #include "symengine/symengine_exception.h"
 #include "tket/Utils/Constants.hpp"
@@ -22,6 +27,54 @@
 
 namespace tket {
 
+// Plain decimals with more digits than this may be parsed by SymEngine to
+// more than double precision
+static constexpr std::size_t max_fast_decimal_digits = 15;
+// Plain integers with at most this many digits fit in an int
+static constexpr std::size_t max_fast_integer_digits = 9;
+
+static double parse_double(const std::string& s) {
+  double x = 0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  std::from_chars(s.data(), s.data() + s.size(), x);
+#else
+  std::istringstream ss(s);
+  ss.imbue(std::locale::classic());
+  ss >> x;
+#endif
+  return x;
+}
+
+Expr expr_from_string(const std::string& s) {
+  // Look for [-]digits[.digits]
+  std::size_t pos = (!s.empty() && s[0] == '-') ? 1 : 0;
+  const std::size_t start = pos;
+  while (pos < s.size() && std::isdigit(static_cast<unsigned char>(s[pos]))) {
+    ++pos;
+  }
+  const std::size_t n_int_digits = pos - start;
+  if (n_int_digits > 0 && pos == s.size()) {
+    // Leave leading zeros to the parser, which may not read them as decimal
+    if (n_int_digits <= max_fast_integer_digits &&
+        (n_int_digits == 1 || s[start] != '0')) {
+      int n = 0;
+      std::from_chars(s.data() + start, s.data() + s.size(), n);
+      return Expr(start == 0 ? n : -n);
+    }
+  } else if (n_int_digits > 0 && s[pos] == '.') {
+    const std::size_t point = pos++;
+    while (pos < s.size() &&
+           std::isdigit(static_cast<unsigned char>(s[pos]))) {
+      ++pos;
+    }
+    if (pos == s.size() && pos > point + 1 &&
+        n_int_digits + (pos - point - 1) <= max_fast_decimal_digits) {
+      return Expr(parse_double(s));
+    }
+  }
+  return Expr(s);
+}
+
 bool approx_0(const Expr& e, double tol) {
   std::optional<double> v = eval_expr(e);
   return v && (std::abs(v.value()) < tol);
@@ -34,8 +87,9 @@ double fmodn(double x, unsigned n) {
 }
 
 bool approx_eq(double x, double y, unsigned mod, double tol) {
-  double r = fmodn(x - y, mod);
-  return r < tol || r > mod - tol;
+  // Distance from x - y to the nearest multiple of mod
+  const double r = x - y;
+  return std::abs(r - mod * std::nearbyint(r / mod)) < tol;
 }
 
 SymSet expr_free_symbols(const Expr& e) {
@@ -76,10 +130,8 @@ std::optional<Complex> eval_expr_c(const Expr& e) {
   }
 }
 
-std::optional<double> eval_expr_mod(const Expr& e, unsigned n) {
-  std::optional<double> reduced_val = eval_expr(e);
-  if (!reduced_val) return std::nullopt;
-  double val = reduced_val.value();
+// Reduce modulo n, first rounding values close to a multiple of 0.25
+static double reduce_mod(double val, unsigned n) {
   double val4 = 4 * val;
   long nearest_val4 = std::lrint(val4);
   if (std::abs(val4 - nearest_val4) < 4 * EPS) {
@@ -88,6 +140,12 @@ std::optional<double> eval_expr_mod(const Expr& e, unsigned n) {
   return fmodn(val, n);
 }
 
+std::optional<double> eval_expr_mod(const Expr& e, unsigned n) {
+  std::optional<double> reduced_val = eval_expr(e);
+  if (!reduced_val) return std::nullopt;
+  return reduce_mod(reduced_val.value(), n);
+}
+
 // Evaluate cos(pi x / 12). If x is close to a multiple of pi/12, it is clamped
 // to that exact multiple and the return value is exact.
 // Is is assumed that 0 <= x < 24.
@@ -109,17 +167,31 @@ Expr cos_halfpi_times(const Expr& e) {
   if (x) {
     return cos_pi_by_12_times(12 * x.value());
   } else {
-    return SymEngine::cos(SymEngine::expand(e * SymEngine::pi / 2));
+    return SymEngine::cos(expand_expr(e * SymEngine::pi / 2));
   }
 }
 
 Expr sin_halfpi_times(const Expr& e) {
-  return cos_halfpi_times(SymEngine::expand(SymEngine::integer(1) - e));
+  return cos_halfpi_times(expand_expr(SymEngine::integer(1) - e));
+}
+
+Expr expand_expr(const Expr& e) {
+  const SymEngine::RCP<const SymEngine::Basic>& b = e.get_basic();
+  if (SymEngine::is_a_Number(*b) || SymEngine::is_a<SymEngine::Symbol>(*b)) {
+    return e;
+  }
+  thread_local SymEngine::umap_basic_basic cache;
+  auto found = cache.find(b);
+  if (found != cache.end()) return Expr(found->second);
+  Expr expanded = SymEngine::expand(e);
+  if (cache.size() >= max_expand_cache_size) cache.clear();
+  cache.emplace(b, expanded.get_basic());
+  return expanded;
 }
 
 Expr minus_times(const Expr& e) {
   Expr e1 = -e;
-  Expr e2 = SymEngine::expand(e1);
+  Expr e2 = expand_expr(e1);
 
   unsigned e1_size = e1.get_basic()->dumps().size();
   unsigned e2_size = e2.get_basic()->dumps().size();
@@ -144,10 +216,18 @@ bool equiv_0(const Expr& e, unsigned n, double tol) {
   return equiv_val(e, 0., n, tol);
 }
 
+bool equiv_0(double x, unsigned n, double tol) {
+  return approx_eq(x, 0., n, tol);
+}
+
 std::optional<unsigned> equiv_Clifford(const Expr& e, unsigned n, double tol) {
-  std::optional<double> eval = eval_expr_mod(e, n);
+  std::optional<double> eval = eval_expr(e);
   if (!eval) return std::nullopt;
-  double v_mod_n = eval.value();
+  return equiv_Clifford(eval.value(), n, tol);
+}
+
+std::optional<unsigned> equiv_Clifford(double x, unsigned n, double tol) {
+  double v_mod_n = reduce_mod(x, n);
   unsigned nearest = lround(v_mod_n * 2);
   if (std::abs(v_mod_n - (nearest * 0.5)) < tol)
     return nearest;
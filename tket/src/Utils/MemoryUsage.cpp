@@ -0,0 +1,172 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Utils/MemoryUsage.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace tket {
+namespace memory {
+
+// Plain atomics with constant initialisation, so that they are usable from
+// operator new before any dynamic initialisation has run.
+static std::atomic<std::size_t> current_bytes{0};
+static std::atomic<std::size_t> peak_bytes{0};
+static std::atomic<allocation_hook_t> hook{nullptr};
+// Zero means no budget.
+static std::atomic<std::size_t> budget_bytes{0};
+
+#ifdef TKET_TRACK_ALLOCATIONS
+
+static void record(std::ptrdiff_t bytes) {
+  if (bytes > 0) {
+    const std::size_t now =
+        current_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (now > peak && !peak_bytes.compare_exchange_weak(
+                             peak, now, std::memory_order_relaxed)) {
+    }
+  } else {
+    current_bytes.fetch_sub(-bytes, std::memory_order_relaxed);
+  }
+  const allocation_hook_t h = hook.load(std::memory_order_acquire);
+  if (h != nullptr) h(bytes);
+}
+
+// Each block is preceded by a header holding its size, so that unsized
+// deallocations can be counted.
+static constexpr std::size_t HEADER = alignof(std::max_align_t);
+
+static void *tracked_alloc(std::size_t size) noexcept {
+  void *p = std::malloc(size + HEADER);
+  if (p == nullptr) return nullptr;
+  *static_cast<std::size_t *>(p) = size;
+  record(static_cast<std::ptrdiff_t>(size));
+  return static_cast<char *>(p) + HEADER;
+}
+
+static void tracked_free(void *ptr) noexcept {
+  if (ptr == nullptr) return;
+  void *p = static_cast<char *>(ptr) - HEADER;
+  record(-static_cast<std::ptrdiff_t>(*static_cast<std::size_t *>(p)));
+  std::free(p);
+}
+
+static void *tracked_alloc_or_throw(std::size_t size) {
+  for (;;) {
+    void *p = tracked_alloc(size);
+    if (p != nullptr) return p;
+    const std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) throw std::bad_alloc();
+    handler();
+  }
+}
+
+bool allocation_tracking_enabled() { return true; }
+
+#else
+
+bool allocation_tracking_enabled() { return false; }
+
+#endif
+
+std::size_t allocated_bytes() {
+  return current_bytes.load(std::memory_order_relaxed);
+}
+
+std::size_t peak_allocated_bytes() {
+  return peak_bytes.load(std::memory_order_relaxed);
+}
+
+void reset_peak_allocated_bytes() {
+  peak_bytes.store(
+      current_bytes.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+}
+
+void set_allocation_hook(allocation_hook_t h) {
+  hook.store(h, std::memory_order_release);
+}
+
+void set_budget(std::optional<std::size_t> bytes) {
+  budget_bytes.store(bytes ? *bytes : 0, std::memory_order_relaxed);
+}
+
+std::optional<std::size_t> get_budget() {
+  const std::size_t bytes = budget_bytes.load(std::memory_order_relaxed);
+  if (bytes == 0) return std::nullopt;
+  return bytes;
+}
+
+void check_budget(std::size_t expected_bytes) {
+  const std::optional<std::size_t> budget = get_budget();
+  if (!budget) return;
+  const std::size_t current = allocated_bytes();
+  if (current + expected_bytes > *budget) {
+    throw MemoryBudgetExceeded(
+        "Memory budget of " + std::to_string(*budget) +
+        " bytes exceeded: " + std::to_string(current) +
+        " bytes allocated and " + std::to_string(expected_bytes) +
+        " more expected");
+  }
+}
+
+}  // namespace memory
+}  // namespace tket
+
+#ifdef TKET_TRACK_ALLOCATIONS
+
+// Replacements for the global allocation functions. The over-aligned forms
+// are left to the standard library, which pairs them with its own
+// deallocation functions.
+
+void *operator new(std::size_t size) {
+  return tket::memory::tracked_alloc_or_throw(size);
+}
+
+void *operator new[](std::size_t size) {
+  return tket::memory::tracked_alloc_or_throw(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return tket::memory::tracked_alloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return tket::memory::tracked_alloc(size);
+}
+
+void operator delete(void *ptr) noexcept { tket::memory::tracked_free(ptr); }
+
+void operator delete[](void *ptr) noexcept { tket::memory::tracked_free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  tket::memory::tracked_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+  tket::memory::tracked_free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  tket::memory::tracked_free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  tket::memory::tracked_free(ptr);
+}
+
+#endif
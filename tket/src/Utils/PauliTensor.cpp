@@ -14,6 +14,8 @@
 
 #include "tket/Utils/PauliTensor.hpp"
 
+#include <bit>
+#include <stdexcept>
 #include <tkassert/Assert.hpp>
 
 namespace tket {
@@ -38,6 +40,79 @@ Expr default_coeff<Expr>() {
   return 1;
 }
 
+static unsigned n_words_for(unsigned n_qubits) {
+  return (n_qubits + PackedPauliMap::BITS_PER_WORD - 1) /
+         PackedPauliMap::BITS_PER_WORD;
+}
+
+static Pauli pauli_from_bits(bool x, bool z) {
+  if (x) return z ? Pauli::Y : Pauli::X;
+  return z ? Pauli::Z : Pauli::I;
+}
+
+PackedPauliMap::PackedPauliMap(unsigned n_qubits)
+    : n_qubits_(n_qubits),
+      xs_(n_words_for(n_qubits), 0),
+      zs_(n_words_for(n_qubits), 0) {}
+
+PackedPauliMap::PackedPauliMap(
+    unsigned n_qubits, std::vector<Word> xs, std::vector<Word> zs)
+    : n_qubits_(n_qubits), xs_(std::move(xs)), zs_(std::move(zs)) {
+  if (xs_.size() != n_words_for(n_qubits) ||
+      zs_.size() != n_words_for(n_qubits))
+    throw std::invalid_argument(
+        "Bit-planes do not match the size of the PackedPauliMap");
+}
+
+PackedPauliMap::PackedPauliMap(const DensePauliMap &paulis)
+    : PackedPauliMap(paulis.size()) {
+  for (unsigned i = 0; i < paulis.size(); ++i) {
+    if (paulis[i] != Pauli::I) set(i, paulis[i]);
+  }
+}
+
+Pauli PackedPauliMap::get(unsigned qb) const {
+  if (qb >= n_qubits_) return Pauli::I;
+  const unsigned w = qb / BITS_PER_WORD;
+  const unsigned b = qb % BITS_PER_WORD;
+  return pauli_from_bits((xs_[w] >> b) & 1, (zs_[w] >> b) & 1);
+}
+
+void PackedPauliMap::set(unsigned qb, Pauli p) {
+  if (qb >= n_qubits_) resize(qb + 1);
+  const unsigned w = qb / BITS_PER_WORD;
+  const Word bit = Word(1) << (qb % BITS_PER_WORD);
+  if (p == Pauli::X || p == Pauli::Y)
+    xs_[w] |= bit;
+  else
+    xs_[w] &= ~bit;
+  if (p == Pauli::Z || p == Pauli::Y)
+    zs_[w] |= bit;
+  else
+    zs_[w] &= ~bit;
+}
+
+void PackedPauliMap::resize(unsigned n_qubits) {
+  xs_.resize(n_words_for(n_qubits), 0);
+  zs_.resize(n_words_for(n_qubits), 0);
+  n_qubits_ = n_qubits;
+  // Clear anything left beyond the new end when truncating
+  const unsigned tail = n_qubits % BITS_PER_WORD;
+  if (tail != 0) {
+    const Word mask = (Word(1) << tail) - 1;
+    xs_.back() &= mask;
+    zs_.back() &= mask;
+  }
+}
+
+void to_json(nlohmann::json &j, const PackedPauliMap &paulis) {
+  j = cast_container<PackedPauliMap, DensePauliMap>(paulis);
+}
+
+void from_json(const nlohmann::json &j, PackedPauliMap &paulis) {
+  paulis = PackedPauliMap(j.get<DensePauliMap>());
+}
+
 template <>
 QubitPauliMap cast_container<QubitPauliMap, QubitPauliMap>(
     const QubitPauliMap &cont) {
@@ -82,6 +157,43 @@ DensePauliMap cast_container<DensePauliMap, DensePauliMap>(
   return cont;
 }
 
+template <>
+PackedPauliMap cast_container<QubitPauliMap, PackedPauliMap>(
+    const QubitPauliMap &cont) {
+  return PackedPauliMap(cast_container<QubitPauliMap, DensePauliMap>(cont));
+}
+
+template <>
+PackedPauliMap cast_container<DensePauliMap, PackedPauliMap>(
+    const DensePauliMap &cont) {
+  return PackedPauliMap(cont);
+}
+
+template <>
+PackedPauliMap cast_container<PackedPauliMap, PackedPauliMap>(
+    const PackedPauliMap &cont) {
+  return cont;
+}
+
+template <>
+QubitPauliMap cast_container<PackedPauliMap, QubitPauliMap>(
+    const PackedPauliMap &cont) {
+  QubitPauliMap res;
+  for (unsigned i = 0; i < cont.size(); ++i) {
+    Pauli pi = cont.get(i);
+    if (pi != Pauli::I) res.insert({Qubit(i), pi});
+  }
+  return res;
+}
+
+template <>
+DensePauliMap cast_container<PackedPauliMap, DensePauliMap>(
+    const PackedPauliMap &cont) {
+  DensePauliMap res(cont.size());
+  for (unsigned i = 0; i < cont.size(); ++i) res[i] = cont.get(i);
+  return res;
+}
+
 template <>
 no_coeff_t cast_coeff<no_coeff_t, no_coeff_t>(const no_coeff_t &) {
   return {};
@@ -252,6 +364,26 @@ int compare_containers<DensePauliMap>(
   return (p2_it == second.end()) ? 0 : -1;
 }
 
+template <>
+int compare_containers<PackedPauliMap>(
+    const PackedPauliMap &first, const PackedPauliMap &second) {
+  // Find the first qubit on which the strings differ; shorter strings are
+  // padded with Pauli::I, whose planes are zero.
+  const unsigned n_words = std::max(first.xs().size(), second.xs().size());
+  for (unsigned k = 0; k < n_words; ++k) {
+    const PackedPauliMap::Word x1 = k < first.xs().size() ? first.xs()[k] : 0;
+    const PackedPauliMap::Word z1 = k < first.zs().size() ? first.zs()[k] : 0;
+    const PackedPauliMap::Word x2 = k < second.xs().size() ? second.xs()[k] : 0;
+    const PackedPauliMap::Word z2 = k < second.zs().size() ? second.zs()[k] : 0;
+    const PackedPauliMap::Word diff = (x1 ^ x2) | (z1 ^ z2);
+    if (diff == 0) continue;
+    const unsigned qb =
+        k * PackedPauliMap::BITS_PER_WORD + std::countr_zero(diff);
+    return (first.get(qb) < second.get(qb)) ? -1 : 1;
+  }
+  return 0;
+}
+
 template <>
 int compare_coeffs<no_coeff_t>(const no_coeff_t &, const no_coeff_t &) {
   return 0;
@@ -304,6 +436,30 @@ std::set<unsigned> common_indices(
   return common;
 }
 
+// Collect the indices of the set bits of a mask computed from the words of
+// two packed strings, over the words present in \p n_words.
+template <typename MaskFn>
+static std::set<unsigned> packed_indices(unsigned n_words, MaskFn mask) {
+  std::set<unsigned> indices;
+  for (unsigned k = 0; k < n_words; ++k) {
+    PackedPauliMap::Word m = mask(k);
+    while (m != 0) {
+      indices.insert(k * PackedPauliMap::BITS_PER_WORD + std::countr_zero(m));
+      m &= m - 1;
+    }
+  }
+  return indices;
+}
+
+std::set<unsigned> common_indices(
+    const PackedPauliMap &first, const PackedPauliMap &second) {
+  const std::vector<PackedPauliMap::Word> &x1 = first.xs(), &z1 = first.zs();
+  const std::vector<PackedPauliMap::Word> &x2 = second.xs(), &z2 = second.zs();
+  return packed_indices(std::min(x1.size(), x2.size()), [&](unsigned k) {
+    return (x1[k] | z1[k]) & ~(x1[k] ^ x2[k]) & ~(z1[k] ^ z2[k]);
+  });
+}
+
 std::set<Qubit> own_qubits(
     const QubitPauliMap &first, const QubitPauliMap &second) {
   std::set<Qubit> own;
@@ -328,6 +484,17 @@ std::set<unsigned> own_indices(
   return own;
 }
 
+std::set<unsigned> own_indices(
+    const PackedPauliMap &first, const PackedPauliMap &second) {
+  const std::vector<PackedPauliMap::Word> &x1 = first.xs(), &z1 = first.zs();
+  const std::vector<PackedPauliMap::Word> &x2 = second.xs(), &z2 = second.zs();
+  return packed_indices(x1.size(), [&](unsigned k) {
+    const PackedPauliMap::Word other =
+        k < x2.size() ? (x2[k] | z2[k]) : PackedPauliMap::Word(0);
+    return (x1[k] | z1[k]) & ~other;
+  });
+}
+
 std::set<Qubit> conflicting_qubits(
     const QubitPauliMap &first, const QubitPauliMap &second) {
   std::set<Qubit> conflicts;
@@ -353,6 +520,30 @@ std::set<unsigned> conflicting_indices(
   return conflicts;
 }
 
+// Qubits on which both strings are non-trivial and differ
+static PackedPauliMap::Word conflict_mask(
+    const PackedPauliMap &first, const PackedPauliMap &second, unsigned k) {
+  const PackedPauliMap::Word x1 = first.xs()[k], z1 = first.zs()[k];
+  const PackedPauliMap::Word x2 = second.xs()[k], z2 = second.zs()[k];
+  return (x1 | z1) & (x2 | z2) & ((x1 ^ x2) | (z1 ^ z2));
+}
+
+std::set<unsigned> conflicting_indices(
+    const PackedPauliMap &first, const PackedPauliMap &second) {
+  return packed_indices(
+      std::min(first.xs().size(), second.xs().size()),
+      [&](unsigned k) { return conflict_mask(first, second, k); });
+}
+
+bool have_conflicting_indices(
+    const PackedPauliMap &first, const PackedPauliMap &second) {
+  const unsigned n_words = std::min(first.xs().size(), second.xs().size());
+  for (unsigned k = 0; k < n_words; ++k) {
+    if (conflict_mask(first, second, k) != 0) return true;
+  }
+  return false;
+}
+
 template <>
 bool commuting_containers<QubitPauliMap>(
     const QubitPauliMap &first, const QubitPauliMap &second) {
@@ -365,6 +556,19 @@ bool commuting_containers<DensePauliMap>(
   return (conflicting_indices(first, second).size() % 2) == 0;
 }
 
+template <>
+bool commuting_containers<PackedPauliMap>(
+    const PackedPauliMap &first, const PackedPauliMap &second) {
+  // The strings anticommute on a qubit exactly when the symplectic product
+  // x1.z2 + z1.x2 is odd there
+  const unsigned n_words = std::min(first.xs().size(), second.xs().size());
+  PackedPauliMap::Word acc = 0;
+  for (unsigned k = 0; k < n_words; ++k) {
+    acc ^= (first.xs()[k] & second.zs()[k]) ^ (first.zs()[k] & second.xs()[k]);
+  }
+  return std::popcount(acc) % 2 == 0;
+}
+
 template <>
 void print_paulis<QubitPauliMap>(
     std::ostream &os, const QubitPauliMap &paulis) {
@@ -421,6 +625,13 @@ void print_paulis<DensePauliMap>(
   }
 }
 
+template <>
+void print_paulis<PackedPauliMap>(
+    std::ostream &os, const PackedPauliMap &paulis) {
+  print_paulis<DensePauliMap>(
+      os, cast_container<PackedPauliMap, DensePauliMap>(paulis));
+}
+
 template <>
 void print_coeff<no_coeff_t>(std::ostream &, const no_coeff_t &) {}
 
@@ -489,6 +700,21 @@ void hash_combine_paulis<DensePauliMap>(
   }
 }
 
+template <>
+void hash_combine_paulis<PackedPauliMap>(
+    std::size_t &seed, const PackedPauliMap &paulis) {
+  // Skip trailing identity words so padding does not change the hash
+  unsigned n_words = paulis.xs().size();
+  while (n_words > 0 && paulis.xs()[n_words - 1] == 0 &&
+         paulis.zs()[n_words - 1] == 0) {
+    --n_words;
+  }
+  for (unsigned k = 0; k < n_words; ++k) {
+    boost::hash_combine(seed, paulis.xs()[k]);
+    boost::hash_combine(seed, paulis.zs()[k]);
+  }
+}
+
 template <>
 void hash_combine_coeff<no_coeff_t>(std::size_t &, const no_coeff_t &) {}
 
@@ -526,6 +752,15 @@ unsigned n_ys<DensePauliMap>(const DensePauliMap &paulis) {
   return n;
 }
 
+template <>
+unsigned n_ys<PackedPauliMap>(const PackedPauliMap &paulis) {
+  unsigned n = 0;
+  for (unsigned k = 0; k < paulis.xs().size(); ++k) {
+    n += std::popcount(paulis.xs()[k] & paulis.zs()[k]);
+  }
+  return n;
+}
+
 const std::map<std::pair<Pauli, Pauli>, std::pair<quarter_turns_t, Pauli>> &
 get_mult_matrix() {
   static const std::map<
@@ -610,6 +845,34 @@ std::pair<quarter_turns_t, DensePauliMap> multiply_strings<DensePauliMap>(
   return {total_turns, result};
 }
 
+template <>
+std::pair<quarter_turns_t, PackedPauliMap> multiply_strings<PackedPauliMap>(
+    const PackedPauliMap &first, const PackedPauliMap &second) {
+  const PackedPauliMap &longer =
+      first.size() >= second.size() ? first : second;
+  const PackedPauliMap &shorter =
+      first.size() >= second.size() ? second : first;
+  std::vector<PackedPauliMap::Word> xs = longer.xs();
+  std::vector<PackedPauliMap::Word> zs = longer.zs();
+  // Each qubit contributes a factor of i (XY, YZ, ZX), -i (YX, ZY, XZ) or 1
+  // to the product (see get_mult_matrix()); count these a word at a time.
+  quarter_turns_t total_turns = 0;
+  for (unsigned k = 0; k < shorter.xs().size(); ++k) {
+    const PackedPauliMap::Word x1 = first.xs()[k], z1 = first.zs()[k];
+    const PackedPauliMap::Word x2 = second.xs()[k], z2 = second.zs()[k];
+    const PackedPauliMap::Word plus =
+        (~x1 & z1 & x2 & ~z2) | (x1 & ~z1 & x2 & z2) | (x1 & z1 & ~x2 & z2);
+    const PackedPauliMap::Word minus =
+        (~x1 & z1 & x2 & z2) | (x1 & ~z1 & ~x2 & z2) | (x1 & z1 & x2 & ~z2);
+    total_turns += std::popcount(plus) + 3 * std::popcount(minus);
+    xs[k] = x1 ^ x2;
+    zs[k] = z1 ^ z2;
+  }
+  return {
+      total_turns % 4,
+      PackedPauliMap(longer.size(), std::move(xs), std::move(zs))};
+}
+
 template <>
 no_coeff_t multiply_coeffs<no_coeff_t>(const no_coeff_t &, const no_coeff_t &) {
   return {};
@@ -731,4 +994,22 @@ CmplxSpMat to_sparse_matrix<DensePauliMap>(
       cast_container<DensePauliMap, QubitPauliMap>(paulis), qubits);
 }
 
+template <>
+CmplxSpMat to_sparse_matrix<PackedPauliMap>(const PackedPauliMap &paulis) {
+  return to_sparse_matrix<DensePauliMap>(
+      cast_container<PackedPauliMap, DensePauliMap>(paulis));
+}
+template <>
+CmplxSpMat to_sparse_matrix<PackedPauliMap>(
+    const PackedPauliMap &paulis, unsigned n_qubits) {
+  return to_sparse_matrix<DensePauliMap>(
+      cast_container<PackedPauliMap, DensePauliMap>(paulis), n_qubits);
+}
+template <>
+CmplxSpMat to_sparse_matrix<PackedPauliMap>(
+    const PackedPauliMap &paulis, const qubit_vector_t &qubits) {
+  return to_sparse_matrix<QubitPauliMap>(
+      cast_container<PackedPauliMap, QubitPauliMap>(paulis), qubits);
+}
+
 }  // namespace tket
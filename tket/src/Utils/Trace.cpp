@@ -0,0 +1,258 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/Utils/Trace.hpp"
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "tket/Utils/Json.hpp"
+
+namespace tket {
+namespace trace {
+
+static constexpr unsigned MAX_COUNTERS = 256;
+static constexpr unsigned MAX_HISTOGRAMS = 64;
+// Id given to counters and histograms registered beyond the maximum; they
+// record nothing.
+static constexpr unsigned NO_ID = unsigned(-1);
+
+namespace {
+
+struct Event {
+  const char *name;
+  std::uint64_t start_ns;
+  std::uint64_t duration_ns;
+};
+
+// Everything recorded by one thread. Only the owning thread writes; values
+// are atomics so that they can be read at any time. Since there is a single
+// writer, updates are plain loads and stores rather than read-modify-writes.
+struct ThreadData {
+  explicit ThreadData(unsigned tid_) : tid(tid_) {}
+
+  const unsigned tid;
+  std::array<std::atomic<std::uint64_t>, MAX_COUNTERS> counters{};
+  std::array<
+      std::array<std::atomic<std::uint64_t>, N_HISTOGRAM_BUCKETS>,
+      MAX_HISTOGRAMS>
+      histograms{};
+  // Allocated before the first event is published, and never reallocated.
+  std::unique_ptr<Event[]> events;
+  // Events below this index are complete and never rewritten (until reset).
+  std::atomic<std::size_t> n_events{0};
+  std::atomic<std::uint64_t> n_dropped{0};
+};
+
+struct Registry {
+  std::atomic<bool> enabled{false};
+  const std::chrono::steady_clock::time_point epoch =
+      std::chrono::steady_clock::now();
+  std::mutex mutex;
+  // Owned here rather than by the threads, so that records outlive them.
+  std::vector<std::unique_ptr<ThreadData>> threads;
+  std::vector<std::string> counter_names;
+  std::vector<std::string> histogram_names;
+};
+
+}  // namespace
+
+static Registry &registry() {
+  static Registry reg;
+  return reg;
+}
+
+static ThreadData &local_data() {
+  thread_local ThreadData *data = nullptr;
+  if (data == nullptr) {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.threads.push_back(std::make_unique<ThreadData>(reg.threads.size()));
+    data = reg.threads.back().get();
+  }
+  return *data;
+}
+
+static std::uint64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - registry().epoch)
+      .count();
+}
+
+static void bump(std::atomic<std::uint64_t> &x, std::uint64_t n) {
+  x.store(x.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+static unsigned register_name(
+    std::vector<std::string> &names, const char *name, unsigned max) {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (unsigned i = 0; i < names.size(); i++) {
+    if (names[i] == name) return i;
+  }
+  if (names.size() == max) return NO_ID;
+  names.push_back(name);
+  return names.size() - 1;
+}
+
+void set_enabled(bool enabled) {
+  registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool is_enabled() {
+  return registry().enabled.load(std::memory_order_relaxed);
+}
+
+void reset() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (const std::unique_ptr<ThreadData> &data : reg.threads) {
+    for (std::atomic<std::uint64_t> &c : data->counters) c.store(0);
+    for (auto &h : data->histograms) {
+      for (std::atomic<std::uint64_t> &b : h) b.store(0);
+    }
+    data->n_events.store(0);
+    data->n_dropped.store(0);
+  }
+}
+
+std::map<std::string, std::uint64_t> counter_totals() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::map<std::string, std::uint64_t> totals;
+  for (unsigned i = 0; i < reg.counter_names.size(); i++) {
+    std::uint64_t &total = totals[reg.counter_names[i]];
+    for (const std::unique_ptr<ThreadData> &data : reg.threads) {
+      total += data->counters[i].load(std::memory_order_relaxed);
+    }
+  }
+  return totals;
+}
+
+std::map<std::string, histogram_t> histogram_totals() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::map<std::string, histogram_t> totals;
+  for (unsigned i = 0; i < reg.histogram_names.size(); i++) {
+    histogram_t &total = totals[reg.histogram_names[i]];
+    total.fill(0);
+    for (const std::unique_ptr<ThreadData> &data : reg.threads) {
+      for (unsigned b = 0; b < N_HISTOGRAM_BUCKETS; b++) {
+        total[b] += data->histograms[i][b].load(std::memory_order_relaxed);
+      }
+    }
+  }
+  return totals;
+}
+
+std::uint64_t n_dropped_events() {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  std::uint64_t n = 0;
+  for (const std::unique_ptr<ThreadData> &data : reg.threads) {
+    n += data->n_dropped.load(std::memory_order_relaxed);
+  }
+  return n;
+}
+
+void write_chrome_trace(std::ostream &os) {
+  // Chrome trace timestamps are in microseconds.
+  auto to_us = [](std::uint64_t ns) { return ns / 1000.; };
+  nlohmann::json events = nlohmann::json::array();
+  {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const std::unique_ptr<ThreadData> &data : reg.threads) {
+      const std::size_t n = data->n_events.load(std::memory_order_acquire);
+      for (std::size_t i = 0; i < n; i++) {
+        const Event &e = data->events[i];
+        events.push_back(
+            {{"name", e.name},
+             {"cat", "tket"},
+             {"ph", "X"},
+             {"ts", to_us(e.start_ns)},
+             {"dur", to_us(e.duration_ns)},
+             {"pid", 1},
+             {"tid", data->tid}});
+      }
+    }
+  }
+  const double now = to_us(now_ns());
+  for (const auto &[name, total] : counter_totals()) {
+    events.push_back(
+        {{"name", name},
+         {"ph", "C"},
+         {"ts", now},
+         {"pid", 1},
+         {"args", {{"value", total}}}});
+  }
+  nlohmann::json other;
+  other["histograms"] = nlohmann::json::object();
+  for (const auto &[name, buckets] : histogram_totals()) {
+    other["histograms"][name] = buckets;
+  }
+  other["dropped_events"] = n_dropped_events();
+  nlohmann::json trace = {
+      {"traceEvents", events},
+      {"displayTimeUnit", "ns"},
+      {"otherData", other}};
+  os << trace.dump();
+}
+
+Counter::Counter(const char *name)
+    : id_(register_name(registry().counter_names, name, MAX_COUNTERS)) {}
+
+void Counter::add(std::uint64_t n) const {
+  if (id_ == NO_ID || !is_enabled()) return;
+  bump(local_data().counters[id_], n);
+}
+
+Histogram::Histogram(const char *name)
+    : id_(register_name(registry().histogram_names, name, MAX_HISTOGRAMS)) {}
+
+void Histogram::record(std::uint64_t value) const {
+  if (id_ == NO_ID || !is_enabled()) return;
+  bump(local_data().histograms[id_][std::bit_width(value)], 1);
+}
+
+ScopedTimer::ScopedTimer(const char *name) : name_(nullptr), start_ns_(0) {
+  if (is_enabled()) {
+    name_ = name;
+    start_ns_ = now_ns();
+  }
+}
+
+ScopedTimer::~ScopedTimer() {
+  if (name_ == nullptr) return;
+  const std::uint64_t end_ns = now_ns();
+  ThreadData &data = local_data();
+  const std::size_t i = data.n_events.load(std::memory_order_relaxed);
+  if (i == MAX_EVENTS_PER_THREAD) {
+    bump(data.n_dropped, 1);
+    return;
+  }
+  if (!data.events) {
+    data.events = std::make_unique<Event[]>(MAX_EVENTS_PER_THREAD);
+  }
+  data.events[i] = {name_, start_ns_, end_ns - start_ns_};
+  data.n_events.store(i + 1, std::memory_order_release);
+}
+
+}  // namespace trace
+}  // namespace tket
@@ -14,15 +14,77 @@
 
 #include "tket/Utils/UnitID.hpp"
 
+#include <mutex>
+#include <regex>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "tket/Utils/Json.hpp"
 
 namespace tket {
 
+namespace {
+
+struct UnitKey {
+  const std::string *name;
+  std::vector<unsigned> index;
+
+  bool operator==(const UnitKey &other) const {
+    return name == other.name && index == other.index;
+  }
+};
+
+struct UnitKeyHash {
+  std::size_t operator()(const UnitKey &key) const {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, key.name);
+    boost::hash_combine(seed, key.index);
+    return seed;
+  }
+};
+
+}  // namespace
+
+const UnitID::UnitData *UnitID::intern(
+    const std::string &name, const std::vector<unsigned> &index) {
+  // Construct on first use so that units may be created during static
+  // initialization; see the note on the register names below. Elements of
+  // node-based containers keep their addresses, so entries can be handed
+  // out as pointers.
+  struct Table {
+    std::mutex mutex;
+    std::unordered_set<std::string> names;
+    std::unordered_map<UnitKey, UnitData, UnitKeyHash> units;
+  };
+  static std::unique_ptr<Table> table = std::make_unique<Table>();
+
+  std::lock_guard<std::mutex> lock(table->mutex);
+  std::pair<std::unordered_set<std::string>::iterator, bool> name_inserted =
+      table->names.insert(name);
+  if (name_inserted.second) {
+    static const std::string id_regex_str = "[a-z][A-Za-z0-9_]*";
+    static const std::regex id_regex(id_regex_str);
+    if (!name.empty() && !std::regex_match(name, id_regex)) {
+      TKET_LOG_WARN(
+          "UnitID name '" << name << "' does not match '" << id_regex_str
+                          << "', as required for QASM conversion.");
+    }
+  }
+  const std::string *name_ptr = &*name_inserted.first;
+  UnitKey key{name_ptr, index};
+  std::unordered_map<UnitKey, UnitData, UnitKeyHash>::iterator found =
+      table->units.find(key);
+  if (found == table->units.end()) {
+    const unsigned handle = table->units.size();
+    found = table->units.emplace(key, UnitData{name_ptr, index, handle}).first;
+  }
+  return &found->second;
+}
+
 std::string UnitID::repr() const {
   std::stringstream str;
-  str << data_->name_;
+  str << *data_->name_;
   if (!data_->index_.empty()) {
     str << "[" << std::to_string(data_->index_[0]);
     for (unsigned i = 1; i < data_->index_.size(); i++) {
@@ -117,4 +179,38 @@ const std::string& c_debug_default_name() {
   return *regname;
 }
 
+nlohmann::json unit_bimap_to_json(const unit_bimap_t &m) {
+  nlohmann::json j = nlohmann::json::array();
+  for (const auto &entry : m.left) {
+    nlohmann::json pair = nlohmann::json::array();
+    for (const UnitID &u : {entry.first, entry.second}) {
+      pair.push_back({static_cast<int>(u.type()), u.reg_name(), u.index()});
+    }
+    j.push_back(pair);
+  }
+  return j;
+}
+
+static UnitID unit_from_json(const nlohmann::json &j) {
+  UnitType type = static_cast<UnitType>(j.at(0).get<int>());
+  std::string name = j.at(1).get<std::string>();
+  std::vector<unsigned> index = j.at(2).get<std::vector<unsigned>>();
+  switch (type) {
+    case UnitType::Qubit:
+      return Qubit(name, index);
+    case UnitType::Bit:
+      return Bit(name, index);
+    default:
+      return WasmState(name, index);
+  }
+}
+
+unit_bimap_t unit_bimap_from_json(const nlohmann::json &j) {
+  unit_bimap_t m;
+  for (const nlohmann::json &pair : j) {
+    m.insert({unit_from_json(pair.at(0)), unit_from_json(pair.at(1))});
+  }
+  return m;
+}
+
 }  // namespace tket
@@ -14,8 +14,10 @@
 
 #include "tket/ZX/Flow.hpp"
 
+#include <bit>
+
+#include "tket/Utils/BitMatrix.hpp"
 #include "tket/Utils/GraphHeaders.hpp"
-#include "tket/Utils/MatrixAnalysis.hpp"
 
 namespace tket {
 
@@ -65,59 +67,221 @@ void Flow::verify(const ZXDiagram& diag) const {
     ZXType type = diag.get_zxtype(u);
     if (is_boundary_type(type) || output_set.find(u) != output_set.end())
       continue;
-    ZXVertSeqSet uc = c(u);
-    ZXVertSeqSet uodd = odd(u, diag);
-    for (const ZXVert& v : uc.get<TagSeq>()) {
-      ZXType vt = diag.get_zxtype(v);
-      if (u != v && vt != ZXType::PX && vt != ZXType::PY && d(u) <= d(v))
-        throw ZXError("A qubit has an X correction in its past");
-      if (u != v && vt == ZXType::PY && d(u) <= d(v) &&
-          uodd.find(v) == uodd.end())
-        throw ZXError("A past Y vertex receives an X correction");
+    verify_vertex(diag, u);
+  }
+}
+
+void Flow::verify_vertex(const ZXDiagram& diag, const ZXVert& u) const {
+  ZXType type = diag.get_zxtype(u);
+  ZXVertSeqSet uc = c(u);
+  ZXVertSeqSet uodd = odd(u, diag);
+  for (const ZXVert& v : uc.get<TagSeq>()) {
+    ZXType vt = diag.get_zxtype(v);
+    if (u != v && vt != ZXType::PX && vt != ZXType::PY && d(u) <= d(v))
+      throw ZXError("A qubit has an X correction in its past");
+    if (u != v && vt == ZXType::PY && d(u) <= d(v) &&
+        uodd.find(v) == uodd.end())
+      throw ZXError("A past Y vertex receives an X correction");
+  }
+  for (const ZXVert& v : uodd.get<TagSeq>()) {
+    ZXType vt = diag.get_zxtype(v);
+    if (u != v && vt != ZXType::PY && vt != ZXType::PZ && d(u) <= d(v))
+      throw ZXError("A qubit has a Z correction in its past");
+    if (u != v && vt == ZXType::PY && d(u) <= d(v) && uc.find(v) == uc.end())
+      throw ZXError("A past Y vertex receives a Z correction");
+  }
+  bool self_x = (uc.find(u) != uc.end());
+  bool self_z = (uodd.find(u) != uodd.end());
+  switch (type) {
+    case ZXType::XY: {
+      if (self_x || !self_z)
+        throw ZXError("XY vertex must be corrected with a Z");
+      break;
     }
-    for (const ZXVert& v : uodd.get<TagSeq>()) {
-      ZXType vt = diag.get_zxtype(v);
-      if (u != v && vt != ZXType::PY && vt != ZXType::PZ && d(u) <= d(v))
-        throw ZXError("A qubit has a Z correction in its past");
-      if (u != v && vt == ZXType::PY && d(u) <= d(v) && uc.find(v) == uc.end())
-        throw ZXError("A past Y vertex receives a Z correction");
+    case ZXType::XZ: {
+      if (!self_x || !self_z)
+        throw ZXError("XZ vertex must be corrected with a Y");
+      break;
     }
-    bool self_x = (uc.find(u) != uc.end());
-    bool self_z = (uodd.find(u) != uodd.end());
-    switch (type) {
-      case ZXType::XY: {
-        if (self_x || !self_z)
-          throw ZXError("XY vertex must be corrected with a Z");
-        break;
-      }
-      case ZXType::XZ: {
-        if (!self_x || !self_z)
-          throw ZXError("XZ vertex must be corrected with a Y");
-        break;
-      }
-      case ZXType::YZ: {
-        if (!self_x || self_z)
-          throw ZXError("YZ vertex must be corrected with an X");
+    case ZXType::YZ: {
+      if (!self_x || self_z)
+        throw ZXError("YZ vertex must be corrected with an X");
+      break;
+    }
+    case ZXType::PX: {
+      if (!self_z) throw ZXError("PX vertex must be corrected with a Y or Z");
+      break;
+    }
+    case ZXType::PY: {
+      if (self_x == self_z)
+        throw ZXError("PY vertex must be corrected with an X or Z");
+      break;
+    }
+    case ZXType::PZ: {
+      if (!self_x)
+        throw ZXError("PZ vertex must be corrected with an X or Y");
+      break;
+    }
+    default:
+      throw ZXError("Invalid ZXType for MBQC diagram");
+  }
+}
+
+bool Flow::update(
+    const ZXDiagram& diag, const ZXVertVec& changed,
+    const ZXVertVec& removed) {
+  std::set<ZXVert> removed_set{removed.begin(), removed.end()};
+  for (const ZXVert& v : removed) {
+    c_.erase(v);
+    d_.erase(v);
+  }
+  std::set<ZXVert> inputs, output_set;
+  for (const ZXVert& i : diag.get_boundary(ZXType::Input))
+    inputs.insert(diag.neighbours(i).at(0));
+  for (const ZXVert& o : diag.get_boundary(ZXType::Output))
+    output_set.insert(diag.neighbours(o).at(0));
+
+  // Changed vertices and their neighbours; any correction set meeting these
+  // may no longer be valid
+  std::set<ZXVert> touched;
+  ZXVertVec pending;
+  for (const ZXVert& v : changed) {
+    touched.insert(v);
+    for (const ZXVert& n : diag.neighbours(v)) touched.insert(n);
+    if (is_boundary_type(diag.get_zxtype(v))) continue;
+    if (output_set.find(v) != output_set.end()) {
+      c_[v] = {};
+      d_[v] = 0;
+      continue;
+    }
+    auto found = d_.find(v);
+    if (found == d_.end() || found->second == 0) {
+      // New, or previously unmeasured at an output
+      c_.erase(v);
+      d_.erase(v);
+      pending.push_back(v);
+    }
+  }
+  // Vertices to check, and those which must be re-solved because their
+  // correction sets use removed vertices
+  std::set<ZXVert> to_check, to_solve;
+  unsigned max_depth = 0;
+  for (const std::pair<const ZXVert, ZXVertSeqSet>& uc : c_) {
+    max_depth = std::max(max_depth, d_.at(uc.first));
+    for (const ZXVert& v : uc.second.get<TagSeq>()) {
+      if (removed_set.find(v) != removed_set.end()) {
+        to_solve.insert(uc.first);
         break;
       }
-      case ZXType::PX: {
-        if (!self_z) throw ZXError("PX vertex must be corrected with a Y or Z");
-        break;
+      if (touched.find(v) != touched.end()) to_check.insert(uc.first);
+    }
+    if (touched.find(uc.first) != touched.end()) to_check.insert(uc.first);
+  }
+
+  // Give new vertices the smallest depth at which they can be corrected
+  const unsigned depth_limit = max_depth + pending.size() + 1;
+  for (unsigned depth = 1; !pending.empty(); ++depth) {
+    if (depth > depth_limit) return false;
+    ZXVertVec unsolved;
+    for (const ZXVert& v : pending) {
+      std::optional<ZXVertSeqSet> cv =
+          solve_at_depth(diag, v, depth, inputs, true);
+      if (!cv) cv = solve_at_depth(diag, v, depth, inputs, false);
+      if (cv) {
+        c_[v] = *cv;
+        d_[v] = depth;
+      } else {
+        unsolved.push_back(v);
       }
-      case ZXType::PY: {
-        if (self_x == self_z)
-          throw ZXError("PY vertex must be corrected with an X or Z");
-        break;
+    }
+    pending = unsolved;
+  }
+
+  // Re-solve any vertex whose conditions are now broken
+  for (const ZXVert& u : to_check) {
+    if (output_set.find(u) != output_set.end() ||
+        to_solve.find(u) != to_solve.end())
+      continue;
+    try {
+      verify_vertex(diag, u);
+    } catch (const ZXError&) {
+      to_solve.insert(u);
+    }
+  }
+  for (const ZXVert& u : to_solve) {
+    unsigned depth = d_.at(u);
+    std::optional<ZXVertSeqSet> cu =
+        solve_at_depth(diag, u, depth, inputs, true);
+    if (!cu) cu = solve_at_depth(diag, u, depth, inputs, false);
+    if (!cu) return false;
+    c_[u] = *cu;
+  }
+  return true;
+}
+
+std::optional<ZXVertSeqSet> Flow::solve_at_depth(
+    const ZXDiagram& diag, const ZXVert& u, unsigned depth,
+    const std::set<ZXVert>& inputs, bool local) const {
+  // As in identify_pauli_flow: non-input Xs and Ys, and non-inputs already
+  // solved, may correct; vertices not yet solved at this depth constrain the
+  // odd neighbourhood
+  auto solved_before = [&](const ZXVert& v) {
+    auto found = d_.find(v);
+    return found != d_.end() && found->second < depth && v != u;
+  };
+  auto is_corrector = [&](const ZXVert& v) {
+    ZXType type = diag.get_zxtype(v);
+    if (is_boundary_type(type) || inputs.find(v) != inputs.end()) return false;
+    return type == ZXType::PX || type == ZXType::PY || solved_before(v);
+  };
+
+  std::set<ZXVert> pool;
+  if (local) {
+    for (const ZXVert& n : diag.neighbours(u)) {
+      if (is_corrector(n)) pool.insert(n);
+      for (const ZXVert& nn : diag.neighbours(n)) {
+        if (is_corrector(nn)) pool.insert(nn);
       }
-      case ZXType::PZ: {
-        if (!self_x)
-          throw ZXError("PZ vertex must be corrected with an X or Y");
-        break;
+    }
+    auto found = c_.find(u);
+    if (found != c_.end()) {
+      for (const ZXVert& v : found->second.get<TagSeq>()) {
+        if (v != u && is_corrector(v)) pool.insert(v);
       }
-      default:
-        throw ZXError("Invalid ZXType for MBQC diagram");
     }
+  } else {
+    BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
+      if (is_corrector(v)) pool.insert(v);
+    }
+  }
+  // Only rows which a corrector or `u` itself can touch matter
+  std::set<ZXVert> rows{u};
+  if (local) {
+    for (const ZXVert& n : diag.neighbours(u)) rows.insert(n);
+    for (const ZXVert& v : pool) {
+      for (const ZXVert& n : diag.neighbours(v)) rows.insert(n);
+    }
+  } else {
+    BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) { rows.insert(v); }
   }
+
+  boost::bimap<ZXVert, unsigned> correctors, preserve, ys;
+  for (const ZXVert& v : pool) {
+    correctors.insert({v, (unsigned)correctors.size()});
+  }
+  for (const ZXVert& v : rows) {
+    ZXType type = diag.get_zxtype(v);
+    if (is_boundary_type(type) || solved_before(v)) continue;
+    if (type == ZXType::PY)
+      ys.insert({v, (unsigned)ys.size()});
+    else if (type != ZXType::PZ)
+      preserve.insert({v, (unsigned)preserve.size()});
+  }
+  std::map<ZXVert, ZXVertSeqSet> solution =
+      gauss_solve_correctors(diag, correctors, preserve, {u}, ys);
+  auto found = solution.find(u);
+  if (found == solution.end()) return std::nullopt;
+  return found->second;
 }
 
 void Flow::focus(const ZXDiagram& diag) {
@@ -283,6 +447,28 @@ Flow Flow::identify_causal_flow(const ZXDiagram& diag) {
   return fl;
 }
 
+// Calls `f` with the index of each nonzero entry in a row, in order
+template <typename F>
+static void for_each_set_bit(const BitMatrix& mat, unsigned row, F f) {
+  const BitMatrix::Word* data = mat.row_data(row);
+  for (unsigned k = 0; k < mat.words_per_row(); ++k) {
+    for (BitMatrix::Word w = data[k]; w != 0; w &= w - 1) {
+      f(k * BitMatrix::BITS_PER_WORD + std::countr_zero(w));
+    }
+  }
+}
+
+// The column of the first nonzero entry in a row, if any
+static std::optional<unsigned> first_set_bit(
+    const BitMatrix& mat, unsigned row) {
+  const BitMatrix::Word* data = mat.row_data(row);
+  for (unsigned k = 0; k < mat.words_per_row(); ++k) {
+    if (data[k] != 0)
+      return k * BitMatrix::BITS_PER_WORD + std::countr_zero(data[k]);
+  }
+  return std::nullopt;
+}
+
 std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
     const ZXDiagram& diag, const boost::bimap<ZXVert, unsigned>& correctors,
     const boost::bimap<ZXVert, unsigned>& preserve, const ZXVertVec& to_solve,
@@ -291,7 +477,10 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
   unsigned n_preserve = preserve.size();
   unsigned n_to_solve = to_solve.size();
   unsigned n_ys = ys.size();
-  MatrixXb mat = MatrixXb::Zero(n_preserve + n_ys, n_correctors + n_to_solve);
+  // The system is held as the adjacency matrix `lhs` and the right-hand sides
+  // `rhs`, with rows packed into words for the elimination
+  BitMatrix lhs(n_preserve + n_ys, n_correctors);
+  BitMatrix rhs(n_preserve + n_ys, n_to_solve);
   // Build adjacency matrix
   for (boost::bimap<ZXVert, unsigned>::const_iterator it = correctors.begin(),
                                                       end = correctors.end();
@@ -299,11 +488,11 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
     for (const ZXVert& n : diag.neighbours(it->left)) {
       auto in_past = preserve.left.find(n);
       if (in_past != preserve.left.end()) {
-        mat(in_past->second, it->right) = true;
+        lhs(in_past->second, it->right) = true;
       } else {
         auto in_ys = ys.left.find(n);
         if (in_ys != ys.left.end()) {
-          mat(n_preserve + in_ys->second, it->right) = true;
+          lhs(n_preserve + in_ys->second, it->right) = true;
         }
       }
     }
@@ -313,7 +502,7 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
        it != end; ++it) {
     auto found = correctors.left.find(it->left);
     if (found != correctors.left.end())
-      mat(n_preserve + it->right, found->second) = true;
+      lhs(n_preserve + it->right, found->second) = true;
   }
   // Add rhs
   for (unsigned i = 0; i < n_to_solve; ++i) {
@@ -321,11 +510,11 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
     switch (diag.get_zxtype(v)) {
       case ZXType::XY:
       case ZXType::PX: {
-        mat(preserve.left.at(v), n_correctors + i) = true;
+        rhs(preserve.left.at(v), i) = true;
         break;
       }
       case ZXType::XZ: {
-        mat(preserve.left.at(v), n_correctors + i) = true;
+        rhs(preserve.left.at(v), i) = true;
       }
       // fall through
       case ZXType::YZ:
@@ -333,17 +522,17 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
         for (const ZXVert& n : diag.neighbours(v)) {
           auto found = preserve.left.find(n);
           if (found != preserve.left.end())
-            mat(found->second, n_correctors + i) = true;
+            rhs(found->second, i) = true;
           else {
             found = ys.left.find(n);
             if (found != ys.left.end())
-              mat(n_preserve + found->second, n_correctors + i) = true;
+              rhs(n_preserve + found->second, i) = true;
           }
         }
         break;
       }
       case ZXType::PY: {
-        mat(n_preserve + ys.left.at(v), n_correctors + i) = true;
+        rhs(n_preserve + ys.left.at(v), i) = true;
         break;
       }
       default: {
@@ -355,43 +544,36 @@ std::map<ZXVert, ZXVertSeqSet> Flow::gauss_solve_correctors(
 
   // Gaussian elimination
   std::vector<std::pair<unsigned, unsigned>> row_ops =
-      gaussian_elimination_row_ops(
-          mat.block(0, 0, n_preserve + n_ys, n_correctors));
+      gaussian_elimination_row_ops(lhs);
   for (const std::pair<unsigned, unsigned>& op : row_ops) {
-    for (unsigned j = 0; j < n_correctors + n_to_solve; ++j) {
-      mat(op.second, j) ^= mat(op.first, j);
-    }
+    lhs.xor_row(op.first, op.second);
+    rhs.xor_row(op.first, op.second);
   }
 
   // Back substitution
-  // For each row i, pick a corrector j for which mat(i,j) == true, else
+  // For each row i, pick a corrector j for which lhs(i,j) == true, else
   // determine that row i has zero lhs
   std::map<unsigned, ZXVert> row_corrector;
   for (unsigned i = 0; i < n_preserve + n_ys; ++i) {
-    for (unsigned j = 0; j < n_correctors; ++j) {
-      if (mat(i, j)) {
-        row_corrector.insert({i, correctors.right.at(j)});
-        break;
-      }
-    }
+    std::optional<unsigned> j = first_set_bit(lhs, i);
+    if (j) row_corrector.insert({i, correctors.right.at(*j)});
   }
-  // For each past i, scan down column of rhs and for each mat(j,CI+i) == true,
+  // For each past i, scan down column of rhs and for each rhs(j,i) == true,
   // add corrector from row j or try next i if row j has zero lhs
+  const BitMatrix rhs_cols = rhs.transpose();
   std::map<ZXVert, ZXVertSeqSet> solved_flow;
   for (unsigned i = 0; i < n_to_solve; ++i) {
     bool fail = false;
     ZXVertSeqSet c_i;
-    for (unsigned j = 0; j < n_preserve + n_ys; ++j) {
-      if (mat(j, n_correctors + i)) {
-        auto found = row_corrector.find(j);
-        if (found == row_corrector.end()) {
-          fail = true;
-          break;
-        } else {
-          c_i.insert(found->second);
-        }
+    for_each_set_bit(rhs_cols, i, [&](unsigned j) {
+      if (fail) return;
+      auto found = row_corrector.find(j);
+      if (found == row_corrector.end()) {
+        fail = true;
+      } else {
+        c_i.insert(found->second);
       }
-    }
+    });
     if (!fail) {
       ZXVert v = to_solve.at(i);
       ZXType vt = diag.get_zxtype(v);
@@ -574,7 +756,7 @@ std::set<ZXVertSeqSet> Flow::identify_focussed_sets(const ZXDiagram& diag) {
     }
   }
 
-  MatrixXb mat = MatrixXb::Zero(n_preserve + n_ys, n_correctors);
+  BitMatrix mat(n_preserve + n_ys, n_correctors);
 
   // Build adjacency matrix
   for (boost::bimap<ZXVert, unsigned>::const_iterator it = correctors.begin(),
@@ -604,9 +786,7 @@ std::set<ZXVertSeqSet> Flow::identify_focussed_sets(const ZXDiagram& diag) {
   std::vector<std::pair<unsigned, unsigned>> row_ops =
       gaussian_elimination_row_ops(mat);
   for (const std::pair<unsigned, unsigned>& op : row_ops) {
-    for (unsigned j = 0; j < n_correctors; ++j) {
-      mat(op.second, j) ^= mat(op.first, j);
-    }
+    mat.xor_row(op.first, op.second);
   }
 
   // Back substitution
@@ -614,6 +794,7 @@ std::set<ZXVertSeqSet> Flow::identify_focussed_sets(const ZXDiagram& diag) {
   // mat(i,j) == true for a given i, so set row_corrector[i] = j; by Gaussian
   // Elimination this is the only entry in the column) or it describes the
   // focussed set generator {j} + {row_corrector[i] | mat(i,j) == true}
+  const BitMatrix cols = mat.transpose();
   std::set<ZXVertSeqSet> focussed;
   std::map<unsigned, ZXVert> row_corrector;
   for (boost::bimap<ZXVert, unsigned>::const_iterator it = correctors.begin(),
@@ -621,19 +802,17 @@ std::set<ZXVertSeqSet> Flow::identify_focussed_sets(const ZXDiagram& diag) {
        it != end; ++it) {
     ZXVertSeqSet fset{it->left};
     bool new_row_corrector = false;
-    for (unsigned i = 0; i < n_preserve + n_ys; ++i) {
-      if (mat(i, it->right)) {
-        auto inserted = row_corrector.insert({i, it->left});
-        if (inserted.second) {
-          // New row_corrector, so move to next column
-          new_row_corrector = true;
-          break;
-        } else {
-          // Non-correcting column
-          fset.insert(inserted.first->second);
-        }
+    for_each_set_bit(cols, it->right, [&](unsigned i) {
+      if (new_row_corrector) return;
+      auto inserted = row_corrector.insert({i, it->left});
+      if (inserted.second) {
+        // New row_corrector, so move to next column
+        new_row_corrector = true;
+      } else {
+        // Non-correcting column
+        fset.insert(inserted.first->second);
       }
-    }
+    });
     if (!new_row_corrector) focussed.insert({fset});
   }
 
@@ -0,0 +1,419 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/ZX/GraphLikeDiagram.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+
+#include "tket/Utils/GraphHeaders.hpp"
+
+namespace tket {
+
+namespace zx {
+
+typedef GraphLikeDiagram::Vert Vert;
+
+static constexpr Vert no_vert = std::numeric_limits<Vert>::max();
+
+/**
+ * Replace the sorted vector `ns` by its symmetric difference with the sorted
+ * vector `others`, ignoring `skip`.
+ */
+static void toggle(
+    std::vector<Vert>& ns, const std::vector<Vert>& others, Vert skip) {
+  std::vector<Vert> result;
+  result.reserve(ns.size() + others.size());
+  auto it = ns.begin();
+  for (Vert o : others) {
+    if (o == skip) continue;
+    while (it != ns.end() && *it < o) result.push_back(*it++);
+    if (it != ns.end() && *it == o) {
+      ++it;
+    } else {
+      result.push_back(o);
+    }
+  }
+  result.insert(result.end(), it, ns.end());
+  ns = std::move(result);
+}
+
+bool GraphLikeDiagram::can_convert(const ZXDiagram& diag) {
+  if (!diag.is_graphlike()) return false;
+  BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
+    if (diag.get_qtype(v) != QuantumType::Quantum) return false;
+  }
+  std::set<std::pair<ZXVert, ZXVert>> seen;
+  BGL_FORALL_EDGES(w, *diag.graph, ZXGraph) {
+    if (diag.get_qtype(w) != QuantumType::Quantum) return false;
+    ZXVert s = diag.source(w);
+    ZXVert t = diag.target(w);
+    if (s == t) return false;
+    if (!seen.insert({std::min(s, t), std::max(s, t)}).second) return false;
+  }
+  return true;
+}
+
+GraphLikeDiagram::GraphLikeDiagram(const ZXDiagram& diag)
+    : scalar_(diag.get_scalar()) {
+  if (!can_convert(diag)) {
+    throw ZXError(
+        "GraphLikeDiagram requires a quantum diagram in graphlike form with "
+        "no parallel wires or self-loops");
+  }
+  std::map<ZXVert, Vert> ids;
+  BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
+    ZXType type = diag.get_zxtype(v);
+    ids.insert({v, (Vert)types_.size()});
+    types_.push_back(type);
+    if (type == ZXType::ZSpider) {
+      phases_.push_back(diag.get_vertex_ZXGen<PhasedGen>(v).get_param());
+    } else {
+      phases_.push_back(0.);
+    }
+  }
+  neighbours_.resize(types_.size());
+  removed_.assign(types_.size(), false);
+  BGL_FORALL_EDGES(w, *diag.graph, ZXGraph) {
+    Vert s = ids.at(diag.source(w));
+    Vert t = ids.at(diag.target(w));
+    neighbours_[s].push_back(t);
+    neighbours_[t].push_back(s);
+  }
+  for (std::vector<Vert>& ns : neighbours_) std::sort(ns.begin(), ns.end());
+  for (const ZXVert& b : diag.boundary) boundary_.push_back(ids.at(b));
+}
+
+ZXDiagram GraphLikeDiagram::to_diagram() const {
+  ZXDiagram diag;
+  std::vector<ZXVert> verts(types_.size());
+  for (Vert b : boundary_) {
+    ZXVert v = diag.add_vertex(types_[b]);
+    diag.add_boundary(v);
+    verts[b] = v;
+  }
+  for (Vert v = 0; v < types_.size(); ++v) {
+    if (!removed_[v] && is_spider(v)) {
+      verts[v] = diag.add_vertex(ZXType::ZSpider, phases_[v]);
+    }
+  }
+  for (Vert v = 0; v < types_.size(); ++v) {
+    if (removed_[v]) continue;
+    for (Vert n : neighbours_[v]) {
+      if (n < v) continue;
+      ZXWireType type = (is_spider(v) && is_spider(n)) ? ZXWireType::H
+                                                       : ZXWireType::Basic;
+      diag.add_wire(verts[v], verts[n], type);
+    }
+  }
+  diag.multiply_scalar(scalar_);
+  return diag;
+}
+
+unsigned GraphLikeDiagram::n_spiders() const {
+  unsigned count = 0;
+  for (Vert v = 0; v < types_.size(); ++v) {
+    if (!removed_[v] && is_spider(v)) ++count;
+  }
+  return count;
+}
+
+unsigned GraphLikeDiagram::n_wires() const {
+  unsigned ends = 0;
+  for (const std::vector<Vert>& ns : neighbours_) ends += ns.size();
+  return ends / 2;
+}
+
+GraphLikeDiagram::Vert GraphLikeDiagram::add_spider(const Expr& phase) {
+  types_.push_back(ZXType::ZSpider);
+  phases_.push_back(phase);
+  neighbours_.emplace_back();
+  removed_.push_back(false);
+  return (Vert)types_.size() - 1;
+}
+
+void GraphLikeDiagram::add_wire(Vert u, Vert v) {
+  std::vector<Vert>& u_ns = neighbours_[u];
+  u_ns.insert(std::lower_bound(u_ns.begin(), u_ns.end(), v), v);
+  std::vector<Vert>& v_ns = neighbours_[v];
+  v_ns.insert(std::lower_bound(v_ns.begin(), v_ns.end(), u), u);
+}
+
+void GraphLikeDiagram::remove_wire(Vert u, Vert v) {
+  std::vector<Vert>& u_ns = neighbours_[u];
+  u_ns.erase(std::lower_bound(u_ns.begin(), u_ns.end(), v));
+  std::vector<Vert>& v_ns = neighbours_[v];
+  v_ns.erase(std::lower_bound(v_ns.begin(), v_ns.end(), u));
+}
+
+void GraphLikeDiagram::remove_vertex(Vert v) {
+  for (Vert n : neighbours_[v]) {
+    std::vector<Vert>& n_ns = neighbours_[n];
+    n_ns.erase(std::lower_bound(n_ns.begin(), n_ns.end(), v));
+  }
+  neighbours_[v].clear();
+  removed_[v] = true;
+}
+
+bool GraphLikeDiagram::is_spider(Vert v) const {
+  return types_[v] == ZXType::ZSpider;
+}
+
+bool GraphLikeDiagram::is_pauli(Vert v) const {
+  if (!is_spider(v)) return false;
+  std::optional<unsigned> pi2_mult = equiv_Clifford(phases_[v]);
+  return pi2_mult && ((*pi2_mult % 2) == 0);
+}
+
+bool GraphLikeDiagram::is_proper_clifford(Vert v) const {
+  if (!is_spider(v)) return false;
+  std::optional<unsigned> pi2_mult = equiv_Clifford(phases_[v]);
+  return pi2_mult && ((*pi2_mult % 2) == 1);
+}
+
+bool GraphLikeDiagram::is_interior(Vert v) const {
+  for (Vert n : neighbours_[v]) {
+    if (!is_spider(n)) return false;
+  }
+  return true;
+}
+
+void GraphLikeDiagram::complement(
+    const std::vector<Vert>& as, const std::vector<Vert>& bs) {
+  for (Vert a : as) toggle(neighbours_[a], bs, no_vert);
+  for (Vert b : bs) toggle(neighbours_[b], as, no_vert);
+}
+
+bool GraphLikeDiagram::remove_interior_cliffords() {
+  bool success = false;
+  std::deque<Vert> candidates;
+  std::vector<bool> queued(types_.size(), false);
+  for (Vert v = 0; v < types_.size(); ++v) {
+    if (removed_[v]) continue;
+    candidates.push_back(v);
+    queued[v] = true;
+  }
+  while (!candidates.empty()) {
+    Vert v = candidates.front();
+    candidates.pop_front();
+    queued[v] = false;
+    if (removed_[v] || !is_proper_clifford(v) || !is_interior(v)) continue;
+    // Local complementation about `v`
+    const std::vector<Vert> ns = neighbours_[v];
+    for (Vert x : ns) {
+      toggle(neighbours_[x], ns, x);
+      phases_[x] = phases_[x] - phases_[v];
+      // Changing the phase could introduce a new proper Clifford
+      if (!queued[x]) {
+        candidates.push_back(x);
+        queued[x] = true;
+      }
+    }
+    remove_vertex(v);
+    success = true;
+  }
+  return success;
+}
+
+/**
+ * Split the neighbourhoods of a pair of adjacent vertices `u` and `v` into
+ * those of `v` only, those of `u` only, and those of both.
+ */
+static void split_neighbourhoods(
+    const std::vector<Vert>& v_ns, const std::vector<Vert>& u_ns, Vert v,
+    Vert u, std::vector<Vert>& excl_v, std::vector<Vert>& excl_u,
+    std::vector<Vert>& joint) {
+  std::set_intersection(
+      v_ns.begin(), v_ns.end(), u_ns.begin(), u_ns.end(),
+      std::back_inserter(joint));
+  std::set_difference(
+      v_ns.begin(), v_ns.end(), u_ns.begin(), u_ns.end(),
+      std::back_inserter(excl_v));
+  excl_v.erase(std::lower_bound(excl_v.begin(), excl_v.end(), u));
+  std::set_difference(
+      u_ns.begin(), u_ns.end(), v_ns.begin(), v_ns.end(),
+      std::back_inserter(excl_u));
+  excl_u.erase(std::lower_bound(excl_u.begin(), excl_u.end(), v));
+}
+
+bool GraphLikeDiagram::remove_interior_paulis() {
+  bool success = false;
+  std::deque<Vert> candidates;
+  std::vector<bool> queued(types_.size(), false);
+  for (Vert v = 0; v < types_.size(); ++v) {
+    if (removed_[v]) continue;
+    candidates.push_back(v);
+    queued[v] = true;
+  }
+  while (!candidates.empty()) {
+    Vert v = candidates.front();
+    candidates.pop_front();
+    queued[v] = false;
+    if (removed_[v] || !is_pauli(v) || !is_interior(v)) continue;
+    // Look for an interior Pauli neighbour
+    Vert u = no_vert;
+    for (Vert n : neighbours_[v]) {
+      if (is_pauli(n) && is_interior(n)) {
+        u = n;
+        break;
+      }
+    }
+    if (u == no_vert) continue;
+    // Pivot about (`u`, `v`)
+    std::vector<Vert> excl_v, excl_u, joint;
+    split_neighbourhoods(
+        neighbours_[v], neighbours_[u], v, u, excl_v, excl_u, joint);
+    const Expr v_phase = phases_[v];
+    const Expr u_phase = phases_[u];
+    for (Vert j : joint) phases_[j] = phases_[j] + v_phase + u_phase + 1.;
+    for (Vert x : excl_u) phases_[x] = phases_[x] + v_phase;
+    for (Vert x : excl_v) phases_[x] = phases_[x] + u_phase;
+    complement(joint, excl_u);
+    complement(joint, excl_v);
+    complement(excl_u, excl_v);
+    remove_vertex(u);
+    remove_vertex(v);
+    for (const std::vector<Vert>* affected : {&joint, &excl_u, &excl_v}) {
+      for (Vert w : *affected) {
+        if (!queued[w]) {
+          candidates.push_back(w);
+          queued[w] = true;
+        }
+      }
+    }
+    success = true;
+  }
+  return success;
+}
+
+bool GraphLikeDiagram::gadgetise_interior_paulis() {
+  bool success = false;
+  const Vert n_candidates = types_.size();
+  for (Vert v = 0; v < n_candidates; ++v) {
+    if (removed_[v] || !is_pauli(v) || !is_interior(v)) continue;
+    // Check it isn't already the axis of a gadget
+    bool is_axis = false;
+    for (Vert n : neighbours_[v]) {
+      if (neighbours_[n].size() == 1) {
+        is_axis = true;
+        break;
+      }
+    }
+    if (is_axis) continue;
+    // Pick a neighbour for pivoting
+    Vert u = no_vert;
+    for (Vert n : neighbours_[v]) {
+      if (is_interior(n)) {
+        u = n;
+        break;
+      }
+    }
+    if (u == no_vert) continue;
+    std::vector<Vert> excl_v, excl_u, joint;
+    split_neighbourhoods(
+        neighbours_[v], neighbours_[u], v, u, excl_v, excl_u, joint);
+    const Expr v_phase = phases_[v];
+    for (Vert j : joint) phases_[j] = phases_[j] + v_phase + 1.;
+    for (Vert x : excl_u) phases_[x] = phases_[x] + v_phase;
+    std::optional<unsigned> pi2_mult = equiv_Clifford(v_phase);
+    phases_[u] = ((*pi2_mult % 4 == 0) ? 1. : -1.) * phases_[u];
+    phases_[v] = 0.;
+    complement(joint, excl_u);
+    complement(joint, excl_v);
+    complement(excl_u, excl_v);
+    // Leave `u` as a gadget on the axis `v`
+    const std::vector<Vert> u_ns = neighbours_[u];
+    for (Vert n : u_ns) {
+      if (n != v) remove_wire(u, n);
+    }
+    success = true;
+  }
+  return success;
+}
+
+bool GraphLikeDiagram::extend_at_boundary_paulis() {
+  bool success = false;
+  for (Vert b : boundary_) {
+    if (neighbours_[b].size() != 1) continue;
+    Vert u = neighbours_[b].front();
+    if (!is_pauli(u)) continue;
+    bool has_internal_pauli = false;
+    for (Vert w : neighbours_[u]) {
+      if (is_pauli(w) && is_interior(w)) {
+        has_internal_pauli = true;
+        break;
+      }
+    }
+    if (!has_internal_pauli) continue;
+    // We would like to pivot about (`u`, `w`) but `u` is by a boundary, so we
+    // extend it
+    Vert z1 = add_spider(0.);
+    Vert z2 = add_spider(phases_[u]);
+    remove_wire(u, b);
+    add_wire(u, z1);
+    add_wire(z1, z2);
+    add_wire(z2, b);
+    phases_[u] = 0.;
+    success = true;
+  }
+  return success;
+}
+
+bool GraphLikeDiagram::merge_gadgets() {
+  std::map<std::vector<Vert>, Vert> neighbour_lookup;
+  std::vector<Vert> to_remove;
+  for (Vert v = 0; v < types_.size(); ++v) {
+    if (removed_[v] || !is_spider(v) || neighbours_[v].size() != 1) continue;
+    Vert axis = neighbours_[v].front();
+    if (!is_spider(axis) || !equiv_expr(phases_[axis], 0.)) continue;
+    std::vector<Vert> key = neighbours_[axis];
+    key.erase(std::lower_bound(key.begin(), key.end(), v));
+    auto inserted = neighbour_lookup.insert({key, v});
+    if (!inserted.second) {
+      Vert other_gadget = inserted.first->second;
+      phases_[other_gadget] = phases_[other_gadget] + phases_[v];
+      to_remove.push_back(v);
+      to_remove.push_back(axis);
+    }
+  }
+  for (Vert v : to_remove) {
+    if (!removed_[v]) remove_vertex(v);
+  }
+  return !to_remove.empty();
+}
+
+bool GraphLikeDiagram::reduce() {
+  const auto reduce_once = [this]() {
+    bool success = false;
+    while (remove_interior_cliffords()) success = true;
+    success = extend_at_boundary_paulis() || success;
+    while (remove_interior_paulis()) success = true;
+    success = gadgetise_interior_paulis() || success;
+    return success;
+  };
+  bool success = reduce_once();
+  while (merge_gadgets()) {
+    success = true;
+    reduce_once();
+  }
+  return success;
+}
+
+}  // namespace zx
+
+}  // namespace tket
@@ -0,0 +1,517 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tket/ZX/TensorNetwork.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <thread>
+
+#include "tket/Utils/GraphHeaders.hpp"
+
+namespace tket {
+
+namespace zx {
+
+typedef Eigen::Matrix<Complex, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    RowMatrixXcd;
+
+// Largest number of indices of any intermediate tensor (16 bytes per entry)
+static constexpr unsigned max_tensor_rank = 26;
+
+// Smallest number of multiplications worth splitting between threads
+static constexpr std::size_t min_parallel_work = 1ul << 16;
+
+static double phase_mod_2(const Expr& param) {
+  std::optional<double> p = eval_expr_mod(param);
+  if (!p) {
+    throw ZXError(
+        "Cannot evaluate a ZXDiagram with symbolic parameter " +
+        param.__str__());
+  }
+  return *p;
+}
+
+static Eigen::VectorXcd phased_tensor(const PhasedGen& gen, unsigned rank) {
+  const std::size_t size = 1ul << rank;
+  Eigen::VectorXcd t = Eigen::VectorXcd::Zero(size);
+  switch (gen.get_type()) {
+    case ZXType::ZSpider: {
+      t(0) += 1.;
+      t(size - 1) += std::exp(i_ * PI * phase_mod_2(gen.get_param()));
+      break;
+    }
+    case ZXType::XSpider: {
+      Complex phase = std::exp(i_ * PI * phase_mod_2(gen.get_param()));
+      double constant = std::pow(std::sqrt(0.5), rank);
+      for (std::size_t i = 0; i < size; ++i) {
+        bool odd = __builtin_popcountll(i) % 2 == 1;
+        t(i) = (1. + (odd ? -phase : phase)) * constant;
+      }
+      break;
+    }
+    case ZXType::Hbox: {
+      std::optional<Complex> param = eval_expr_c(gen.get_param());
+      if (!param) {
+        throw ZXError(
+            "Cannot evaluate a ZXDiagram with symbolic parameter " +
+            gen.get_param().__str__());
+      }
+      t.setOnes();
+      t(size - 1) = *param;
+      break;
+    }
+    case ZXType::XY: {
+      t(0) += std::sqrt(0.5);
+      t(size - 1) +=
+          std::sqrt(0.5) * std::exp(-i_ * PI * phase_mod_2(gen.get_param()));
+      break;
+    }
+    case ZXType::XZ: {
+      double angle = PI * phase_mod_2(gen.get_param()) / 2.;
+      t(0) += std::cos(angle);
+      t(size - 1) += std::sin(angle);
+      break;
+    }
+    case ZXType::YZ: {
+      double angle = PI * phase_mod_2(gen.get_param()) / 2.;
+      t(0) += std::cos(angle);
+      t(size - 1) += -i_ * std::sin(angle);
+      break;
+    }
+    default: {
+      throw ZXError(
+          "Cannot evaluate phased generator " + gen.get_name() +
+          " to a tensor");
+    }
+  }
+  return t;
+}
+
+static Eigen::VectorXcd clifford_tensor(const CliffordGen& gen, unsigned rank) {
+  const std::size_t size = 1ul << rank;
+  Eigen::VectorXcd t = Eigen::VectorXcd::Zero(size);
+  switch (gen.get_type()) {
+    case ZXType::PX: {
+      t(0) += std::sqrt(0.5);
+      t(size - 1) += gen.get_param() ? -std::sqrt(0.5) : std::sqrt(0.5);
+      break;
+    }
+    case ZXType::PY: {
+      t(0) += std::sqrt(0.5);
+      t(size - 1) +=
+          gen.get_param() ? i_ * std::sqrt(0.5) : -i_ * std::sqrt(0.5);
+      break;
+    }
+    case ZXType::PZ: {
+      t(gen.get_param() ? size - 1 : 0) = 1.;
+      break;
+    }
+    default: {
+      throw ZXError(
+          "Cannot evaluate Clifford generator " + gen.get_name() +
+          " to a tensor");
+    }
+  }
+  return t;
+}
+
+static Eigen::VectorXcd generator_tensor(const ZXGen_ptr& gen, unsigned rank) {
+  ZXType type = gen->get_type();
+  if (is_phase_type(type)) {
+    return phased_tensor(static_cast<const PhasedGen&>(*gen), rank);
+  } else if (is_Clifford_gen_type(type)) {
+    return clifford_tensor(static_cast<const CliffordGen&>(*gen), rank);
+  } else if (type == ZXType::Triangle) {
+    Eigen::VectorXcd t(4);
+    // Indexed by (port 0, port 1)
+    t << 1., 1., 0., 1.;
+    return t;
+  } else if (type == ZXType::ZXBox) {
+    const ZXBox& box = static_cast<const ZXBox&>(*gen);
+    return tensor_from_quantum_diagram(*box.get_diagram());
+  }
+  throw ZXError(
+      "Cannot evaluate generator " + gen->get_name() + " to a tensor");
+}
+
+/**
+ * Reshape the tensor with the given indices into a matrix whose rows and
+ * columns are indexed by `rows` and `cols`.
+ */
+static RowMatrixXcd to_matrix(
+    const std::vector<unsigned>& indices, const Eigen::VectorXcd& data,
+    const std::vector<unsigned>& rows, const std::vector<unsigned>& cols) {
+  const unsigned rank = indices.size();
+  // For each index of the tensor, whether it becomes a row bit and its shift
+  std::vector<std::pair<bool, unsigned>> places;
+  for (unsigned ind : indices) {
+    auto r = std::find(rows.begin(), rows.end(), ind);
+    if (r != rows.end()) {
+      places.push_back({true, rows.size() - 1 - (r - rows.begin())});
+      continue;
+    }
+    auto c = std::find(cols.begin(), cols.end(), ind);
+    if (c == cols.end()) {
+      throw ZXError("Tensor index missing from reshape");
+    }
+    places.push_back({false, cols.size() - 1 - (c - cols.begin())});
+  }
+  RowMatrixXcd m(1ul << rows.size(), 1ul << cols.size());
+  for (std::size_t i = 0; i < (std::size_t)data.size(); ++i) {
+    std::size_t row = 0;
+    std::size_t col = 0;
+    for (unsigned k = 0; k < rank; ++k) {
+      if ((i >> (rank - 1 - k)) & 1) {
+        if (places[k].first) {
+          row |= 1ul << places[k].second;
+        } else {
+          col |= 1ul << places[k].second;
+        }
+      }
+    }
+    m(row, col) = data(i);
+  }
+  return m;
+}
+
+/**
+ * Compute `c = a * b`, splitting the larger dimension of `c` between threads
+ * when there is enough work.
+ */
+static void multiply(
+    const RowMatrixXcd& a, const RowMatrixXcd& b, RowMatrixXcd& c,
+    unsigned n_threads) {
+  const std::size_t work = a.rows() * a.cols() * b.cols();
+  const bool by_rows = c.rows() >= c.cols();
+  const Eigen::Index length = by_rows ? c.rows() : c.cols();
+  const unsigned n_blocks =
+      (unsigned)std::min<Eigen::Index>(n_threads, length);
+  if (n_blocks <= 1 || work < min_parallel_work) {
+    c.noalias() = a * b;
+    return;
+  }
+  auto run_block = [&](unsigned block) {
+    const Eigen::Index start = length * block / n_blocks;
+    const Eigen::Index size = length * (block + 1) / n_blocks - start;
+    if (by_rows) {
+      c.middleRows(start, size).noalias() = a.middleRows(start, size) * b;
+    } else {
+      c.middleCols(start, size).noalias() = a * b.middleCols(start, size);
+    }
+  };
+  std::vector<std::thread> workers;
+  for (unsigned block = 1; block < n_blocks; ++block) {
+    workers.emplace_back(run_block, block);
+  }
+  run_block(0);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * Contract two tensors over all of their shared indices. The indices of the
+ * result are those only in `a` followed by those only in `b`.
+ */
+static std::pair<std::vector<unsigned>, Eigen::VectorXcd> contract_pair(
+    const std::vector<unsigned>& a_indices, const Eigen::VectorXcd& a_data,
+    const std::vector<unsigned>& b_indices, const Eigen::VectorXcd& b_data,
+    unsigned n_threads) {
+  std::vector<unsigned> shared, left, right;
+  for (unsigned ind : a_indices) {
+    if (std::find(b_indices.begin(), b_indices.end(), ind) != b_indices.end()) {
+      shared.push_back(ind);
+    } else {
+      left.push_back(ind);
+    }
+  }
+  for (unsigned ind : b_indices) {
+    if (std::find(shared.begin(), shared.end(), ind) == shared.end()) {
+      right.push_back(ind);
+    }
+  }
+  if (left.size() + right.size() > max_tensor_rank) {
+    throw ZXError(
+        "Contracting the tensor network requires a tensor with more than " +
+        std::to_string(max_tensor_rank) + " indices");
+  }
+  RowMatrixXcd a = to_matrix(a_indices, a_data, left, shared);
+  RowMatrixXcd b = to_matrix(b_indices, b_data, shared, right);
+  RowMatrixXcd c(a.rows(), b.cols());
+  multiply(a, b, c, n_threads);
+  left.insert(left.end(), right.begin(), right.end());
+  return {left, Eigen::Map<const Eigen::VectorXcd>(c.data(), c.size())};
+}
+
+TensorNetwork::TensorNetwork(const ZXDiagram& diag) : n_indices_(0) {
+  std::optional<Complex> scalar = eval_expr_c(diag.get_scalar());
+  if (!scalar) {
+    throw ZXError(
+        "Cannot evaluate a ZXDiagram with symbolic scalar " +
+        diag.get_scalar().__str__());
+  }
+  scalar_ = std::sqrt(*scalar);
+  BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
+    std::optional<QuantumType> qtype = diag.get_qtype(v);
+    if (qtype && *qtype != QuantumType::Quantum) {
+      throw ZXError("TensorNetwork only supports quantum ZXDiagrams");
+    }
+  }
+  // Identifiers of the source and target ends of each wire. These coincide
+  // unless a tensor for the wire itself is needed: for Hadamard wires, for
+  // self-loops, and between two boundaries.
+  std::map<Wire, std::pair<unsigned, unsigned>> ends;
+  BGL_FORALL_EDGES(w, *diag.graph, ZXGraph) {
+    if (diag.get_qtype(w) != QuantumType::Quantum) {
+      throw ZXError("TensorNetwork only supports quantum ZXDiagrams");
+    }
+    ZXVert s = diag.source(w);
+    ZXVert t = diag.target(w);
+    unsigned s_ind = new_index();
+    ZXWireType type = diag.get_wire_type(w);
+    if (type == ZXWireType::Basic && s != t &&
+        !(is_boundary_type(diag.get_zxtype(s)) &&
+          is_boundary_type(diag.get_zxtype(t)))) {
+      ends.insert({w, {s_ind, s_ind}});
+      continue;
+    }
+    unsigned t_ind = new_index();
+    Eigen::VectorXcd data(4);
+    if (type == ZXWireType::H) {
+      data << 1., 1., 1., -1.;
+    } else {
+      data << 1., 0., 0., 1.;
+    }
+    tensors_.push_back({{s_ind, t_ind}, data});
+    ends.insert({w, {s_ind, t_ind}});
+  }
+  BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
+    ZXGen_ptr gen = diag.get_vertex_ZXGen_ptr(v);
+    if (is_boundary_type(gen->get_type())) continue;
+    // Port and identifier of each wire end at v
+    std::vector<std::pair<std::optional<unsigned>, unsigned>> v_ends;
+    for (const Wire& w : diag.adj_wires(v)) {
+      const std::pair<unsigned, unsigned>& w_ends = ends.at(w);
+      if (diag.source(w) == v) {
+        v_ends.push_back({diag.source_port(w), w_ends.first});
+      }
+      if (diag.target(w) == v) {
+        v_ends.push_back({diag.target_port(w), w_ends.second});
+      }
+    }
+    if (is_directed_type(gen->get_type())) {
+      std::sort(v_ends.begin(), v_ends.end());
+    }
+    std::vector<unsigned> indices;
+    for (const std::pair<std::optional<unsigned>, unsigned>& e : v_ends) {
+      indices.push_back(e.second);
+    }
+    tensors_.push_back({indices, generator_tensor(gen, indices.size())});
+  }
+  for (const ZXVert& b : diag.boundary) {
+    WireVec b_wires = diag.adj_wires(b);
+    if (b_wires.size() != 1) {
+      throw ZXError("Boundary vertex does not have degree 1");
+    }
+    const Wire& w = b_wires.front();
+    const std::pair<unsigned, unsigned>& w_ends = ends.at(w);
+    boundary_indices_.push_back(
+        diag.source(w) == b ? w_ends.first : w_ends.second);
+  }
+  fixed_.assign(boundary_indices_.size(), false);
+}
+
+unsigned TensorNetwork::new_index() { return n_indices_++; }
+
+void TensorNetwork::fix_boundary(unsigned i, bool value) {
+  if (i >= boundary_indices_.size()) {
+    throw ZXError(
+        "Boundary position " + std::to_string(i) +
+        " out of range for TensorNetwork");
+  }
+  if (fixed_[i]) {
+    throw ZXError(
+        "Boundary position " + std::to_string(i) + " is already fixed");
+  }
+  Eigen::VectorXcd data = Eigen::VectorXcd::Zero(2);
+  data(value ? 1 : 0) = 1.;
+  tensors_.push_back({{boundary_indices_[i]}, data});
+  fixed_[i] = true;
+}
+
+unsigned TensorNetwork::n_tensors() const { return tensors_.size(); }
+
+Eigen::VectorXcd TensorNetwork::contract(unsigned n_threads) const {
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  std::vector<Tensor> live = tensors_;
+  std::vector<bool> alive(live.size(), true);
+  // Tensors currently holding each index
+  std::map<unsigned, std::vector<std::size_t>> holders;
+  for (std::size_t t = 0; t < live.size(); ++t) {
+    for (unsigned ind : live[t].indices) holders[ind].push_back(t);
+  }
+  auto size_of = [](std::size_t rank) { return std::ldexp(1., (int)rank); };
+  auto merge = [&](std::size_t a, std::size_t b) {
+    std::pair<std::vector<unsigned>, Eigen::VectorXcd> merged = contract_pair(
+        live[a].indices, live[a].data, live[b].indices, live[b].data,
+        n_threads);
+    const std::size_t m = live.size();
+    for (std::size_t old : {a, b}) {
+      for (unsigned ind : live[old].indices) {
+        std::vector<std::size_t>& hs = holders.at(ind);
+        hs.erase(std::remove(hs.begin(), hs.end(), old), hs.end());
+      }
+      alive[old] = false;
+      live[old] = Tensor();
+    }
+    for (unsigned ind : merged.first) holders.at(ind).push_back(m);
+    live.push_back({merged.first, merged.second});
+    alive.push_back(true);
+  };
+
+  // Greedily contract the connected pair whose result grows the network least
+  while (true) {
+    std::optional<std::pair<std::size_t, std::size_t>> best;
+    double best_cost = 0.;
+    std::size_t best_rank = 0;
+    for (const std::pair<const unsigned, std::vector<std::size_t>>& h :
+         holders) {
+      if (h.second.size() != 2) continue;
+      std::size_t a = std::min(h.second[0], h.second[1]);
+      std::size_t b = std::max(h.second[0], h.second[1]);
+      const std::vector<unsigned>& a_inds = live[a].indices;
+      const std::vector<unsigned>& b_inds = live[b].indices;
+      std::size_t n_shared = 0;
+      for (unsigned ind : a_inds) {
+        if (std::find(b_inds.begin(), b_inds.end(), ind) != b_inds.end()) {
+          ++n_shared;
+        }
+      }
+      std::size_t rank = a_inds.size() + b_inds.size() - 2 * n_shared;
+      double cost = size_of(rank) - size_of(a_inds.size()) -
+                    size_of(b_inds.size());
+      if (!best || cost < best_cost ||
+          (cost == best_cost && rank < best_rank) ||
+          (cost == best_cost && rank == best_rank &&
+           std::make_pair(a, b) < *best)) {
+        best = {a, b};
+        best_cost = cost;
+        best_rank = rank;
+      }
+    }
+    if (!best) break;
+    merge(best->first, best->second);
+  }
+
+  // Take the outer product of the disconnected parts, smallest first
+  std::vector<std::size_t> parts;
+  for (std::size_t t = 0; t < live.size(); ++t) {
+    if (alive[t]) parts.push_back(t);
+  }
+  std::sort(parts.begin(), parts.end(), [&](std::size_t a, std::size_t b) {
+    return std::make_pair(live[a].indices.size(), a) <
+           std::make_pair(live[b].indices.size(), b);
+  });
+  Tensor result{{}, Eigen::VectorXcd::Ones(1)};
+  for (std::size_t t : parts) {
+    std::pair<std::vector<unsigned>, Eigen::VectorXcd> merged = contract_pair(
+        result.indices, result.data, live[t].indices, live[t].data,
+        n_threads);
+    result = {merged.first, merged.second};
+  }
+
+  std::vector<unsigned> open;
+  for (unsigned i = 0; i < boundary_indices_.size(); ++i) {
+    if (!fixed_[i]) open.push_back(boundary_indices_[i]);
+  }
+  if (result.indices.size() != open.size()) {
+    throw ZXError("TensorNetwork has indices not matching its boundary");
+  }
+  RowMatrixXcd ordered = to_matrix(result.indices, result.data, open, {});
+  return scalar_ * Eigen::Map<const Eigen::VectorXcd>(
+                       ordered.data(), ordered.size());
+}
+
+Eigen::VectorXcd tensor_from_quantum_diagram(
+    const ZXDiagram& diag, unsigned n_threads) {
+  return TensorNetwork(diag).contract(n_threads);
+}
+
+Eigen::MatrixXcd unitary_from_quantum_diagram(
+    const ZXDiagram& diag, unsigned n_threads) {
+  ZXVertVec boundary = diag.get_boundary();
+  // Shift of each boundary within the row or column index
+  std::vector<std::pair<bool, unsigned>> places;
+  unsigned n_in = 0;
+  unsigned n_out = 0;
+  for (const ZXVert& b : boundary) {
+    switch (diag.get_zxtype(b)) {
+      case ZXType::Input: {
+        places.push_back({false, n_in++});
+        break;
+      }
+      case ZXType::Output: {
+        places.push_back({true, n_out++});
+        break;
+      }
+      default: {
+        throw ZXError(
+            "unitary_from_quantum_diagram only supports Input and Output "
+            "boundaries");
+      }
+    }
+  }
+  Eigen::VectorXcd t = tensor_from_quantum_diagram(diag, n_threads);
+  Eigen::MatrixXcd u(1ul << n_out, 1ul << n_in);
+  const unsigned rank = boundary.size();
+  for (std::size_t i = 0; i < (std::size_t)t.size(); ++i) {
+    std::size_t row = 0;
+    std::size_t col = 0;
+    for (unsigned k = 0; k < rank; ++k) {
+      if ((i >> (rank - 1 - k)) & 1) {
+        if (places[k].first) {
+          row |= 1ul << (n_out - 1 - places[k].second);
+        } else {
+          col |= 1ul << (n_in - 1 - places[k].second);
+        }
+      }
+    }
+    u(row, col) = t(i);
+  }
+  return u;
+}
+
+Complex amplitude_from_quantum_diagram(
+    const ZXDiagram& diag, const std::vector<bool>& values,
+    unsigned n_threads) {
+  TensorNetwork network(diag);
+  if (values.size() != diag.get_boundary().size()) {
+    throw ZXError(
+        "Gave " + std::to_string(values.size()) + " values for " +
+        std::to_string(diag.get_boundary().size()) +
+        " boundaries of ZXDiagram");
+  }
+  for (unsigned i = 0; i < values.size(); ++i) {
+    network.fix_boundary(i, values[i]);
+  }
+  return network.contract(n_threads)(0);
+}
+
+}  // namespace zx
+
+}  // namespace tket
@@ -12,7 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <list>
+#include <unordered_set>
+
 #include "tket/Utils/GraphHeaders.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
 #include "tket/ZX/ZXDiagram.hpp"
 
 namespace tket {
@@ -49,6 +53,28 @@ unsigned ZXDiagram::n_vertices() const { return boost::num_vertices(*graph); }
 
 unsigned ZXDiagram::n_wires() const { return boost::num_edges(*graph); }
 
+std::size_t ZXDiagram::memory_usage() const {
+  // The graph is laid out as for Circuit::memory_usage, without vertex
+  // indices.
+  constexpr std::size_t vertex_bytes =
+      sizeof(ZXVertProperties) + 2 * sizeof(std::list<int>) +
+      memory::LIST_NODE_OVERHEAD;
+  constexpr std::size_t wire_bytes =
+      2 * sizeof(ZXVert) + sizeof(WireProperties) +
+      3 * memory::LIST_NODE_OVERHEAD + 4 * sizeof(void*);
+  std::size_t bytes = sizeof(ZXDiagram) + sizeof(ZXGraph) +
+                      n_vertices() * vertex_bytes + n_wires() * wire_bytes +
+                      memory::container_bytes(boundary);
+  std::unordered_set<const ZXGen*> gens;
+  BGL_FORALL_VERTICES(v, *graph, ZXGraph) {
+    const ZXGen_ptr& op = (*graph)[v].op;
+    if (op && gens.insert(op.get()).second) {
+      bytes += memory::SHARED_CONTROL_OVERHEAD + op->memory_usage();
+    }
+  }
+  return bytes;
+}
+
 unsigned ZXDiagram::count_vertices(ZXType type) const {
   unsigned count = 0;
   BGL_FORALL_VERTICES(v, *graph, ZXGraph) {
@@ -232,7 +258,7 @@ bool ZXDiagram::is_pauli_spider(const ZXVert& v) const {
   ZXGen_ptr op = get_vertex_ZXGen_ptr(v);
   if (!is_spider_type(op->get_type())) return false;
   const PhasedGen& bg = static_cast<const PhasedGen&>(*op);
-  std::optional<unsigned> pi2_mult = equiv_Clifford(bg.get_param());
+  std::optional<unsigned> pi2_mult = bg.get_clifford_multiple();
   return (pi2_mult && ((*pi2_mult % 2) == 0));
 }
 
@@ -240,7 +266,7 @@ bool ZXDiagram::is_proper_clifford_spider(const ZXVert& v) const {
   ZXGen_ptr op = get_vertex_ZXGen_ptr(v);
   if (!is_spider_type(op->get_type())) return false;
   const PhasedGen& bg = static_cast<const PhasedGen&>(*op);
-  std::optional<unsigned> pi2_mult = equiv_Clifford(bg.get_param());
+  std::optional<unsigned> pi2_mult = bg.get_clifford_multiple();
   return (pi2_mult && ((*pi2_mult % 2) == 1));
 }
 
@@ -14,9 +14,11 @@
 
 #include "tket/ZX/ZXGenerator.hpp"
 
+#include <cmath>
 #include <sstream>
 #include <tkassert/Assert.hpp>
 
+#include "tket/Utils/MemoryUsage.hpp"
 #include "tket/ZX/ZXDiagram.hpp"
 
 namespace tket {
@@ -243,13 +245,34 @@ bool BasicGen::is_equal(const ZXGen& other) const {
  * PhasedGen implementation
  */
 PhasedGen::PhasedGen(ZXType type, const Expr& param, QuantumType qtype)
-    : BasicGen(type, qtype), param_(param) {
+    : BasicGen(type, qtype),
+      param_(param),
+      numeric_param_(
+          (type == ZXType::Hbox) ? std::nullopt : eval_expr_mod(param)) {
   if (!is_phase_type(type)) {
     throw ZXError("Unsupported ZXType for PhasedGen");
   }
 }
 
-Expr PhasedGen::get_param() const { return param_; }
+const Expr& PhasedGen::get_param() const { return param_; }
+
+const std::optional<double>& PhasedGen::get_numeric_param() const {
+  return numeric_param_;
+}
+
+std::optional<unsigned> PhasedGen::get_clifford_multiple() const {
+  if (!numeric_param_) return equiv_Clifford(param_);
+  return equiv_Clifford(*numeric_param_);
+}
+
+Expr add_phase(
+    const PhasedGen& gen, const Expr& phase,
+    const std::optional<double>& numeric_phase) {
+  const std::optional<double>& gen_phase = gen.get_numeric_param();
+  if (gen_phase && numeric_phase)
+    return Expr(fmodn(*gen_phase + *numeric_phase, 2));
+  return gen.get_param() + phase;
+}
 
 SymSet PhasedGen::free_symbols() const { return expr_free_symbols(param_); }
 
@@ -436,6 +459,11 @@ bool ZXBox::is_equal(const ZXGen&) const {
   return false;
 }
 
+std::size_t ZXBox::memory_usage() const {
+  return sizeof(ZXBox) + memory::SHARED_CONTROL_OVERHEAD +
+         diag_->memory_usage();
+}
+
 unsigned ZXBox::n_ports() const { return diag_->get_boundary().size(); }
 
 std::vector<QuantumType> ZXBox::get_signature() const {
@@ -58,6 +58,14 @@ bool Rewrite::spider_fusion_fun(ZXDiagram& diag) {
      **/
     WireVec adj_vec = diag.adj_wires(v);
     std::list<Wire> adj_list{adj_vec.begin(), adj_vec.end()};
+    // Phases fused into `v` are accumulated here and the generator of `v`
+    // replaced once at the end, adding numerically while every phase is
+    // numeric
+    const PhasedGen& vspid = diag.get_vertex_ZXGen<PhasedGen>(v);
+    std::optional<double> numeric_phase = vspid.get_numeric_param();
+    Expr phase = vspid.get_param();
+    QuantumType qtype = *vspid.get_qtype();
+    bool fused = false;
     while (!adj_list.empty()) {
       Wire w = adj_list.front();
       adj_list.pop_front();
@@ -72,15 +80,18 @@ bool Rewrite::spider_fusion_fun(ZXDiagram& diag) {
       // The spiders `u` and `v` can be fused together
       // We merge into `v` and remove `u` so that we can efficiently continue to
       // search the neighbours
-      const PhasedGen& vspid = diag.get_vertex_ZXGen<PhasedGen>(v);
       const PhasedGen& uspid = diag.get_vertex_ZXGen<PhasedGen>(u);
-      ZXGen_ptr new_spid = std::make_shared<const PhasedGen>(
-          vtype, vspid.get_param() + uspid.get_param(),
-          (vspid.get_qtype() == QuantumType::Classical ||
-           uspid.get_qtype() == QuantumType::Classical)
-              ? QuantumType::Classical
-              : QuantumType::Quantum);
-      diag.set_vertex_ZXGen_ptr(v, new_spid);
+      const std::optional<double>& u_numeric = uspid.get_numeric_param();
+      if (numeric_phase && u_numeric) {
+        *numeric_phase = fmodn(*numeric_phase + *u_numeric, 2);
+      } else {
+        if (numeric_phase) phase = *numeric_phase;
+        phase = phase + uspid.get_param();
+        numeric_phase = std::nullopt;
+      }
+      if (uspid.get_qtype() == QuantumType::Classical)
+        qtype = QuantumType::Classical;
+      fused = true;
       for (const Wire& uw : diag.adj_wires(u)) {
         WireEnd u_end = diag.end_of(uw, u);
         ZXVert other = diag.other_end(uw, u);
@@ -109,6 +120,11 @@ bool Rewrite::spider_fusion_fun(ZXDiagram& diag) {
       bin.insert(u);
       success = true;
     }
+    if (fused) {
+      diag.set_vertex_ZXGen_ptr(
+          v, std::make_shared<const PhasedGen>(
+                 vtype, numeric_phase ? Expr(*numeric_phase) : phase, qtype));
+    }
   }
   for (ZXVert u : bin) {
     diag.remove_vertex(u);
@@ -148,7 +164,7 @@ bool Rewrite::self_loop_removal_fun(ZXDiagram& diag) {
     if ((n_pis % 2) == 1) {
       const PhasedGen& spid = diag.get_vertex_ZXGen<PhasedGen>(v);
       ZXGen_ptr new_spid = std::make_shared<const PhasedGen>(
-          vtype, spid.get_param() + 1., vqtype);
+          vtype, add_phase(spid, 1., 1.), vqtype);
       diag.set_vertex_ZXGen_ptr(v, new_spid);
     }
   }
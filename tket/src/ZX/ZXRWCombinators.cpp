@@ -12,12 +12,45 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "tket/Utils/GraphHeaders.hpp"
 #include "tket/ZX/Rewrite.hpp"
 
 namespace tket {
 
 namespace zx {
 
+void RewriteStatistics::record(
+    const std::string &name, bool success, double seconds,
+    unsigned vertices_before, unsigned wires_before, unsigned vertices_after,
+    unsigned wires_after) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  RewriteRecord &rec = records_[name];
+  ++rec.n_applications;
+  if (success) ++rec.n_successes;
+  rec.seconds += seconds;
+  rec.vertices_before += vertices_before;
+  rec.vertices_after += vertices_after;
+  rec.wires_before += wires_before;
+  rec.wires_after += wires_after;
+}
+
+std::map<std::string, RewriteRecord> RewriteStatistics::get_records() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return records_;
+}
+
+void RewriteStatistics::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  records_.clear();
+}
+
 Rewrite::Rewrite(const RewriteFun &fun) : apply(fun) {}
 
 Rewrite Rewrite::sequence(const std::vector<Rewrite> &rvec) {
@@ -71,6 +104,118 @@ Rewrite Rewrite::repeat_while(const Rewrite &cond, const Rewrite &body) {
   });
 }
 
+Rewrite Rewrite::parallel_components(const Rewrite &rw) {
+  return Rewrite([=](ZXDiagram &diag) {
+    // Label the connected components, in order of first appearance
+    std::map<ZXVert, unsigned> component;
+    std::vector<ZXVertVec> members;
+    BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
+      if (component.find(v) != component.end()) continue;
+      unsigned c = members.size();
+      members.push_back({v});
+      component.insert({v, c});
+      for (unsigned i = 0; i < members[c].size(); ++i) {
+        for (const ZXVert &n : diag.neighbours(members[c][i])) {
+          if (component.insert({n, c}).second) members[c].push_back(n);
+        }
+      }
+    }
+    if (members.size() < 2) return rw.apply(diag);
+
+    // Copy each component out, keeping vertices and boundary in their
+    // original order
+    std::vector<ZXDiagram> parts(members.size());
+    std::map<ZXVert, ZXVert> iso;
+    BGL_FORALL_VERTICES(v, *diag.graph, ZXGraph) {
+      ZXDiagram &part = parts[component.at(v)];
+      iso.insert({v, part.add_vertex(diag.get_vertex_ZXGen_ptr(v))});
+    }
+    BGL_FORALL_EDGES(w, *diag.graph, ZXGraph) {
+      unsigned c = component.at(diag.source(w));
+      parts[c].add_wire(
+          iso.at(diag.source(w)), iso.at(diag.target(w)),
+          diag.get_wire_info(w));
+    }
+    std::vector<std::pair<unsigned, unsigned>> boundary_pos;
+    for (const ZXVert &b : diag.boundary) {
+      unsigned c = component.at(b);
+      boundary_pos.push_back({c, (unsigned)parts[c].boundary.size()});
+      parts[c].boundary.push_back(iso.at(b));
+    }
+
+    // One flag per part, not std::vector<bool>, so workers never share a word
+    std::vector<unsigned char> success(parts.size(), 0);
+    std::atomic<std::size_t> next_index{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto work = [&]() {
+      try {
+        for (std::size_t index = next_index++; index < parts.size();
+             index = next_index++) {
+          success[index] = rw.apply(parts[index]);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next_index = parts.size();
+      }
+    };
+    const std::size_t number_of_threads = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()), parts.size());
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < number_of_threads; ++i) {
+      workers.emplace_back(work);
+    }
+    work();
+    for (std::thread &worker : workers) {
+      worker.join();
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    if (std::find(success.begin(), success.end(), 1) == success.end())
+      return false;
+
+    // Merge the rewritten components back together
+    ZXDiagram merged;
+    merged.multiply_scalar(diag.get_scalar());
+    std::vector<std::map<ZXVert, ZXVert>> merged_iso;
+    for (const ZXDiagram &part : parts) {
+      merged_iso.push_back(merged.copy_graph(part, false).first);
+    }
+    for (const std::pair<unsigned, unsigned> &pos : boundary_pos) {
+      const ZXVertVec &part_boundary = parts[pos.first].boundary;
+      if (pos.second >= part_boundary.size())
+        throw ZXError(
+            "Rewrite applied to a component changed the diagram boundary");
+      merged.boundary.push_back(
+          merged_iso[pos.first].at(part_boundary[pos.second]));
+    }
+    diag = std::move(merged);
+    return true;
+  });
+}
+
+Rewrite Rewrite::with_statistics(
+    const Rewrite &rw, const std::string &name,
+    const std::shared_ptr<RewriteStatistics> &stats) {
+  if (!stats) throw ZXError("Rewrite statistics collector is null");
+  return Rewrite([=](ZXDiagram &diag) {
+    unsigned vertices_before = diag.n_vertices();
+    unsigned wires_before = diag.n_wires();
+    auto start = std::chrono::steady_clock::now();
+    bool success = rw.apply(diag);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    stats->record(
+        name, success, elapsed.count(), vertices_before, wires_before,
+        diag.n_vertices(), diag.n_wires());
+    return success;
+  });
+}
+
 }  // namespace zx
 
 }  // namespace tket
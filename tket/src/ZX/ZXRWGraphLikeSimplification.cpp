@@ -35,6 +35,45 @@ static bool can_complement_neighbourhood(
   return true;
 }
 
+// A phase to add to spiders, with its value when it has no free symbols
+typedef std::pair<Expr, std::optional<double>> PhaseShift;
+
+// `scale` times the sum of the phases of `spids`, plus `constant`, computed
+// numerically when every phase is numeric
+static PhaseShift phase_shift(
+    const std::vector<const PhasedGen*>& spids, double scale = 1.,
+    double constant = 0.) {
+  double total = constant;
+  bool numeric = true;
+  for (const PhasedGen* spid : spids) {
+    const std::optional<double>& val = spid->get_numeric_param();
+    if (!val) {
+      numeric = false;
+      break;
+    }
+    total += scale * *val;
+  }
+  if (numeric) {
+    total = fmodn(total, 2);
+    return {total, total};
+  }
+  Expr sum = 0;
+  for (const PhasedGen* spid : spids) {
+    if (scale == 1.)
+      sum = sum + spid->get_param();
+    else if (scale == -1.)
+      sum = sum - spid->get_param();
+    else
+      sum = sum + scale * spid->get_param();
+  }
+  if (constant != 0.) sum = sum + constant;
+  return {sum, std::nullopt};
+}
+
+static PhaseShift phase_shift(const PhasedGen& spid, double scale = 1.) {
+  return phase_shift(std::vector<const PhasedGen*>{&spid}, scale);
+}
+
 bool Rewrite::remove_interior_cliffords_fun(ZXDiagram& diag) {
   if (!diag.is_graphlike()) return false;
   bool success = false;
@@ -50,6 +89,7 @@ bool Rewrite::remove_interior_cliffords_fun(ZXDiagram& diag) {
     QuantumType vqtype = *spid.get_qtype();
     ZXVertVec neighbours = diag.neighbours(v);
     if (!can_complement_neighbourhood(diag, vqtype, neighbours)) continue;
+    PhaseShift minus_phase = phase_shift(spid, -1.);
     // Found an internal proper clifford spider on which we can perform local
     // complementation
     /**
@@ -78,7 +118,8 @@ bool Rewrite::remove_interior_cliffords_fun(ZXDiagram& diag) {
         continue;
       // Update phase information
       ZXGen_ptr xi_new_op = std::make_shared<const PhasedGen>(
-          ZXType::ZSpider, xi_op.get_param() - spid.get_param(),
+          ZXType::ZSpider,
+          add_phase(xi_op, minus_phase.first, minus_phase.second),
           *xi_op.get_qtype());
       diag.set_vertex_ZXGen_ptr(*xi, xi_new_op);
       candidates.insert(
@@ -95,11 +136,12 @@ Rewrite Rewrite::remove_interior_cliffords() {
 }
 
 static void add_phase_to_vertices(
-    ZXDiagram& diag, const ZXVertSeqSet& verts, const Expr& phase) {
+    ZXDiagram& diag, const ZXVertSeqSet& verts, const PhaseShift& phase) {
   for (const ZXVert& v : verts.get<TagSeq>()) {
     const PhasedGen& old_spid = diag.get_vertex_ZXGen<PhasedGen>(v);
     ZXGen_ptr new_spid = std::make_shared<const PhasedGen>(
-        ZXType::ZSpider, old_spid.get_param() + phase, *old_spid.get_qtype());
+        ZXType::ZSpider, add_phase(old_spid, phase.first, phase.second),
+        *old_spid.get_qtype());
     diag.set_vertex_ZXGen_ptr(v, new_spid);
   }
 }
@@ -174,9 +216,9 @@ bool Rewrite::remove_interior_paulis_fun(ZXDiagram& diag) {
     const PhasedGen& u_spid = diag.get_vertex_ZXGen<PhasedGen>(u);
 
     add_phase_to_vertices(
-        diag, joint, v_spid.get_param() + u_spid.get_param() + 1.);
-    add_phase_to_vertices(diag, excl_u, v_spid.get_param());
-    add_phase_to_vertices(diag, excl_v, u_spid.get_param());
+        diag, joint, phase_shift({&v_spid, &u_spid}, 1., 1.));
+    add_phase_to_vertices(diag, excl_u, phase_shift(v_spid));
+    add_phase_to_vertices(diag, excl_v, phase_shift(u_spid));
 
     // Because `can_complement_neighbourhood` checks all neighbours,
     // v and u have the same QuantumType
@@ -186,7 +228,13 @@ bool Rewrite::remove_interior_paulis_fun(ZXDiagram& diag) {
 
     diag.remove_vertex(u);
     diag.remove_vertex(v);
-    candidates.erase(candidates.find(u));
+    auto found_u = candidates.find(u);
+    if (found_u != candidates.end()) candidates.erase(found_u);
+    // Only the vertices whose neighbourhoods were complemented can form new
+    // pairs, so requeue those rather than rescanning the whole diagram
+    for (const ZXVertSeqSet* affected : {&joint, &excl_u, &excl_v}) {
+      for (const ZXVert& w : affected->get<TagSeq>()) candidates.insert(w);
+    }
     success = true;
   }
   return success;
@@ -251,10 +299,11 @@ bool Rewrite::gadgetise_interior_paulis_fun(ZXDiagram& diag) {
     const PhasedGen& v_spid = diag.get_vertex_ZXGen<PhasedGen>(v);
     const PhasedGen& u_spid = diag.get_vertex_ZXGen<PhasedGen>(u);
 
-    add_phase_to_vertices(diag, joint, v_spid.get_param() + 1.);
-    add_phase_to_vertices(diag, excl_u, v_spid.get_param());
-    std::optional<unsigned> pi2_mult = equiv_Clifford(v_spid.get_param());
-    Expr new_phase = ((*pi2_mult % 4 == 0) ? 1. : -1.) * u_spid.get_param();
+    add_phase_to_vertices(diag, joint, phase_shift({&v_spid}, 1., 1.));
+    add_phase_to_vertices(diag, excl_u, phase_shift(v_spid));
+    std::optional<unsigned> pi2_mult = v_spid.get_clifford_multiple();
+    Expr new_phase =
+        phase_shift(u_spid, (*pi2_mult % 4 == 0) ? 1. : -1.).first;
     diag.set_vertex_ZXGen_ptr(
         u, std::make_shared<PhasedGen>(ZXType::ZSpider, new_phase, vqtype));
     diag.set_vertex_ZXGen_ptr(
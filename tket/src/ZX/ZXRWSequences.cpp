@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "tket/ZX/GraphLikeDiagram.hpp"
 #include "tket/ZX/Rewrite.hpp"
 
 namespace tket {
@@ -35,6 +36,16 @@ Rewrite Rewrite::reduce_graphlike_form() {
       {reduce, Rewrite::repeat_while(Rewrite::merge_gadgets(), reduce)});
 }
 
+Rewrite Rewrite::reduce_graphlike_form_compact() {
+  return Rewrite([](ZXDiagram& diag) {
+    if (!GraphLikeDiagram::can_convert(diag)) return false;
+    GraphLikeDiagram compact(diag);
+    if (!compact.reduce()) return false;
+    diag = compact.to_diagram();
+    return true;
+  });
+}
+
 Rewrite Rewrite::to_MBQC_diag() {
   return Rewrite::sequence(
       {Rewrite::rebase_to_mbqc(), Rewrite::extend_for_PX_outputs(),
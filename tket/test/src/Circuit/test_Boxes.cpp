@@ -70,10 +70,15 @@ SCENARIO("CircBox in-place symbol substitution") {
   double x = 0.125;
   double y = 0.250;
   symbol_map_t map = {{asym, x}, {bsym, y}};
+  CircBox copy(circ_box);
+  REQUIRE(copy.to_circuit() == circ_box.to_circuit());
   circ_box.symbol_substitution_in_place(map);
   SymSet sym_set1 = circ_box.free_symbols();
   CHECK(sym_set1.empty());
   REQUIRE(!circ_box.to_circuit()->is_symbolic());
+  // The copy, which shared the circuit, is unaffected.
+  REQUIRE(copy.to_circuit() != circ_box.to_circuit());
+  REQUIRE(copy.free_symbols().size() == 2);
 }
 
 SCENARIO("Using Boxes", "[boxes]") {
@@ -955,6 +960,26 @@ SCENARIO("QControlBox", "[boxes]") {
     std::shared_ptr<Circuit> d = correct_qbox.to_circuit();
     REQUIRE(*c == *d);
   }
+  GIVEN("distinct boxes controlling equal ops") {
+    QControlBox qcbox0(get_op_ptr(OpType::Ry, 0.3), 2, {1, 0});
+    QControlBox qcbox1(get_op_ptr(OpType::Ry, 0.3), 2, {1, 0});
+    QControlBox qcbox2(get_op_ptr(OpType::Ry, 0.3), 2, {0, 1});
+    QControlBox qcbox3(get_op_ptr(OpType::Ry, 0.4), 2, {1, 0});
+    std::shared_ptr<Circuit> c0 = qcbox0.to_circuit();
+    std::shared_ptr<Circuit> c1 = qcbox1.to_circuit();
+    // the circuits are equal but not shared
+    REQUIRE(c0 != c1);
+    REQUIRE(*c0 == *c1);
+    c1->add_op<unsigned>(OpType::X, {0});
+    REQUIRE(*qcbox0.to_circuit() != *c1);
+    // different control states and parameters are told apart
+    REQUIRE(*qcbox2.to_circuit() != *c0);
+    REQUIRE(*qcbox3.to_circuit() != *c0);
+    REQUIRE(tket_sim::get_unitary(*qcbox2.to_circuit())
+                .isApprox(*qcbox2.get_box_unitary()));
+    REQUIRE(tket_sim::get_unitary(*qcbox3.to_circuit())
+                .isApprox(*qcbox3.get_box_unitary()));
+  }
 }
 
 SCENARIO("Unitary3qBox", "[boxes]") {
@@ -974,6 +999,20 @@ SCENARIO("Unitary3qBox", "[boxes]") {
     Eigen::MatrixXcd U1 = tket_sim::get_unitary(*c);
     REQUIRE(U1.isApprox(U));
   }
+  GIVEN("Distinct boxes with the same matrix") {
+    const Eigen::MatrixXcd U = random_unitary(8, 2);
+    Unitary3qBox ubox0(U);
+    Unitary3qBox ubox1(U);
+    REQUIRE(ubox0.get_id() != ubox1.get_id());
+    std::shared_ptr<Circuit> c0 = ubox0.to_circuit();
+    std::shared_ptr<Circuit> c1 = ubox1.to_circuit();
+    // Equal circuits, which are not shared.
+    REQUIRE(c0 != c1);
+    REQUIRE(*c0 == *c1);
+    c0->add_op<unsigned>(OpType::X, {0});
+    REQUIRE(tket_sim::get_unitary(*c1).isApprox(U));
+    REQUIRE(tket_sim::get_unitary(*Unitary3qBox(U).to_circuit()).isApprox(U));
+  }
 }
 
 SCENARIO("Checking equality", "[boxes]") {
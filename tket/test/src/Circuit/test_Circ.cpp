@@ -12,16 +12,24 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <boost/graph/graph_traits.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <map>
 #include <memory>
 #include <sstream>
+#include <string>
 #include <unsupported/Eigen/MatrixFunctions>
 #include <vector>
 
 #include "../testutil.hpp"
 #include "tket/Circuit/CircUtils.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/CircuitArchive.hpp"
+#include "tket/Circuit/Conditional.hpp"
 #include "tket/Circuit/DAGDefs.hpp"
 #include "tket/Circuit/Simulation/CircuitSimulator.hpp"
 #include "tket/Gate/GatePtr.hpp"
@@ -1172,6 +1180,71 @@ SCENARIO("circuit equality ", "[equality]") {
   }
 }
 
+SCENARIO("Comparing circuits by canonical command lists") {
+  GIVEN("Circuits differing in the order of commuting commands") {
+    Circuit test1(2, 2);
+    test1.add_op<unsigned>(OpType::H, {0});
+    test1.add_conditional_gate<unsigned>(OpType::X, {}, {0}, {0}, 1);
+    test1.add_conditional_gate<unsigned>(OpType::Z, {}, {1}, {0}, 1);
+    test1.add_op<unsigned>(OpType::CX, {0, 1});
+    Circuit test2(2, 2);
+    test2.add_conditional_gate<unsigned>(OpType::Z, {}, {1}, {0}, 1);
+    test2.add_op<unsigned>(OpType::H, {0});
+    test2.add_conditional_gate<unsigned>(OpType::X, {}, {0}, {0}, 1);
+    test2.add_op<unsigned>(OpType::CX, {0, 1});
+    CanonicalCommands coms1 = test1.get_canonical_commands();
+    CanonicalCommands coms2 = test2.get_canonical_commands();
+    REQUIRE(coms1.ops.size() == 4);
+    CHECK(coms1.hash == coms2.hash);
+    CHECK(coms1.args == coms2.args);
+    CHECK(coms1.arg_offsets == coms2.arg_offsets);
+    for (unsigned i = 0; i < 4; i++) {
+      CHECK(*coms1.ops[i] == *coms2.ops[i]);
+    }
+    CHECK(test1.canonical_equality(test2));
+  }
+  GIVEN("Circuits with mismatches") {
+    Circuit test1(3);
+    test1.add_op<unsigned>(OpType::CX, {0, 1});
+    test1.add_op<unsigned>(OpType::Rz, 0.25, {2});
+    Circuit test2(test1);
+    CHECK(test1.canonical_equality(test2));
+    // Different arguments
+    Circuit test3(3);
+    test3.add_op<unsigned>(OpType::CX, {1, 0});
+    test3.add_op<unsigned>(OpType::Rz, 0.25, {2});
+    CHECK(
+        test1.get_canonical_commands().hash !=
+        test3.get_canonical_commands().hash);
+    CHECK_FALSE(test1.canonical_equality(test3));
+    // Different parameters, which only the op comparison detects
+    Circuit test4(3);
+    test4.add_op<unsigned>(OpType::CX, {0, 1});
+    test4.add_op<unsigned>(OpType::Rz, 0.5, {2});
+    CHECK(
+        test1.get_canonical_commands().hash ==
+        test4.get_canonical_commands().hash);
+    CHECK_FALSE(test1.canonical_equality(test4));
+    // Different phases, unless excepted
+    test2.add_phase(0.5);
+    CHECK_FALSE(test1.canonical_equality(test2));
+    CHECK(test1.canonical_equality(test2, {Circuit::Check::Phase}));
+    // Different opgroups
+    Circuit test5(3);
+    test5.add_op<unsigned>(OpType::CX, {0, 1}, "g");
+    test5.add_op<unsigned>(OpType::Rz, 0.25, {2});
+    CHECK_FALSE(test1.canonical_equality(test5));
+    // Different Phase ops
+    Circuit test6(test1);
+    test6.add_op<unsigned>(OpType::Phase, 0.25, {});
+    Circuit test7(test1);
+    test7.add_op<unsigned>(OpType::Phase, 0.5, {});
+    CHECK(test6.get_canonical_commands().ops.size() == 3);
+    CHECK(test6.canonical_equality(Circuit(test6)));
+    CHECK_FALSE(test6.canonical_equality(test7));
+  }
+}
+
 SCENARIO("Test that subcircuits are correctly generated") {
   GIVEN("A circuit with an interesting subgraph") {
     Circuit circ(3);
@@ -3369,5 +3442,438 @@ SCENARIO("Check decompose_boxes_recursively") {
   REQUIRE(cmds[3].get_op_ptr()->get_type() == OpType::CX);
 }
 
+SCENARIO("Decomposing shared nested boxes") {
+  Circuit inner(2);
+  inner.add_op<unsigned>(OpType::H, {0});
+  inner.add_op<unsigned>(OpType::CX, {0, 1});
+  CircBox inner_box(inner);
+  Circuit outer(2);
+  outer.add_box(inner_box, {0, 1});
+  outer.add_box(inner_box, {1, 0});
+  CircBox outer_box(outer);
+  GIVEN("Many instances of the same box") {
+    Circuit circ(2);
+    for (unsigned i = 0; i < 50; ++i) {
+      circ.add_box(outer_box, {i % 2, (i + 1) % 2});
+    }
+    REQUIRE(circ.decompose_boxes_recursively());
+    REQUIRE(circ.n_gates() == 200);
+    REQUIRE(circ.count_gates(OpType::CX) == 100);
+    REQUIRE(circ.count_gates(OpType::CircBox) == 0);
+    // The boxes themselves are unchanged
+    REQUIRE(outer_box.to_circuit()->count_gates(OpType::CircBox) == 2);
+  }
+  GIVEN("Boxes under a condition") {
+    Circuit circ(2, 1);
+    circ.add_box(outer_box, {0, 1});
+    Op_ptr cond = std::make_shared<Conditional>(
+        std::make_shared<CircBox>(outer_box), 1, 1);
+    circ.add_op<UnitID>(cond, {Bit(0), Qubit(0), Qubit(1)});
+    // Conditional vertices are not of an excluded type, at any depth
+    REQUIRE(circ.decompose_boxes_recursively({OpType::CircBox}));
+    std::vector<Command> cmds = circ.get_commands();
+    REQUIRE(cmds.size() == 5);
+    REQUIRE(cmds[0].get_op_ptr()->get_type() == OpType::CircBox);
+    for (unsigned i = 1; i < 5; ++i) {
+      REQUIRE(cmds[i].get_op_ptr()->get_type() == OpType::Conditional);
+      const Conditional& cond =
+          static_cast<const Conditional&>(*cmds[i].get_op_ptr());
+      REQUIRE(!cond.get_op()->get_desc().is_box());
+    }
+  }
+}
+
+SCENARIO("Binary serialisation of circuits") {
+  Circuit circ(3, 2, "binary");
+  Qubit a("a", {1, 2});
+  circ.add_qubit(a);
+  circ.add_phase(0.25);
+  Sym s = SymEngine::symbol("s");
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+  circ.add_op<unsigned>(OpType::Rx, Expr(s) * 2, {2});
+  circ.add_op<UnitID>(OpType::CRz, 1.5, {Qubit(0), a}, "group");
+  circ.add_op<unsigned>(OpType::CnX, {0, 1, 2});
+  Circuit inner(2);
+  inner.add_op<unsigned>(OpType::CX, {0, 1});
+  CircBox cbox(inner);
+  for (unsigned i = 0; i < 10; ++i) circ.add_box(cbox, {i % 3, (i + 1) % 3});
+  circ.add_barrier({0, 1});
+  circ.add_measure(0, 0);
+  circ.add_conditional_gate<unsigned>(OpType::X, {}, {1}, {0}, 1);
+  circ.add_op<unsigned>(OpType::SWAP, {1, 2});
+  circ.replace_SWAPs();
+  circ.qubit_create(Qubit(2));
+  circ.qubit_discard(Qubit(0));
+  std::vector<std::uint8_t> data = circ.to_binary();
+  Circuit loaded = Circuit::from_binary(data);
+  REQUIRE(loaded == circ);
+  REQUIRE(nlohmann::json(loaded) == nlohmann::json(circ));
+  // The box is stored once
+  REQUIRE(data.size() * 3 < nlohmann::json(circ).dump().size());
+  GIVEN("Invalid data") {
+    std::vector<std::uint8_t> truncated(data.begin(), data.end() - 1);
+    REQUIRE_THROWS_AS(Circuit::from_binary(truncated), CircuitInvalidity);
+    std::vector<std::uint8_t> bad_magic = data;
+    bad_magic[0] = 'X';
+    REQUIRE_THROWS_AS(Circuit::from_binary(bad_magic), CircuitInvalidity);
+    std::vector<std::uint8_t> trailing = data;
+    trailing.push_back(0);
+    REQUIRE_THROWS_AS(Circuit::from_binary(trailing), CircuitInvalidity);
+  }
+}
+
+SCENARIO("Circuit archives") {
+  std::map<std::string, Circuit> circuits;
+  for (unsigned i = 0; i < 20; ++i) {
+    Circuit circ(2, "c" + std::to_string(i));
+    circ.add_op<unsigned>(OpType::Rz, 0.1 * i, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circuits.insert({"circ_" + std::to_string(i), circ});
+  }
+  circuits.insert({"", Circuit(1)});
+  const std::string path =
+      (std::filesystem::temp_directory_path() / "tket_test_archive.tkca")
+          .string();
+  CircuitArchive::write(path, circuits);
+  {
+    const CircuitArchive archive(path);
+    REQUIRE(archive.size() == circuits.size());
+    std::vector<std::string> names;
+    for (const auto& [name, circ] : circuits) {
+      names.push_back(name);
+      REQUIRE(archive.contains(name));
+      REQUIRE(archive.get(name) == circ);
+    }
+    REQUIRE(archive.names() == names);
+    REQUIRE(archive.get(std::size_t{1}) == circuits.at("circ_0"));
+    REQUIRE_FALSE(archive.contains("circ_20"));
+    REQUIRE_THROWS_AS(archive.get("circ_20"), std::out_of_range);
+    REQUIRE_THROWS_AS(archive.get(circuits.size()), std::out_of_range);
+  }
+  GIVEN("Files that are not archives") {
+    {
+      std::ofstream out(path, std::ios::binary);
+      out << "TKCA";
+    }
+    REQUIRE_THROWS_AS(CircuitArchive(path), CircuitInvalidity);
+    std::filesystem::remove(path);
+    REQUIRE_THROWS_AS(CircuitArchive(path), std::runtime_error);
+  }
+  std::filesystem::remove(path);
+}
+
+SCENARIO("Structural hash of circuits") {
+  Circuit circ(3, 1);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::Rz, 0.25, {2});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_measure(1, 0);
+  circ.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {0}, 1);
+  const std::size_t with_params = circ.structural_hash();
+  const std::size_t without_params =
+      circ.structural_hash(Circuit::HashParams::No);
+  GIVEN("The same circuit built in a different order") {
+    Circuit circ2(3, 1);
+    circ2.add_op<unsigned>(OpType::Rz, 0.25, {2});
+    circ2.add_op<unsigned>(OpType::H, {0});
+    circ2.add_op<unsigned>(OpType::CX, {0, 1});
+    circ2.add_measure(1, 0);
+    circ2.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {0}, 1);
+    REQUIRE(circ2.structural_hash() == with_params);
+    REQUIRE(circ2.structural_hash(Circuit::HashParams::No) == without_params);
+  }
+  GIVEN("The same circuit with renamed units") {
+    Circuit circ2 = circ;
+    unit_map_t rename;
+    for (unsigned i = 0; i < 3; ++i) rename.insert({Qubit(i), Qubit("a", i)});
+    rename.insert({Bit(0), Bit("b", 0)});
+    circ2.rename_units(rename);
+    REQUIRE(circ2.structural_hash() == with_params);
+  }
+  GIVEN("A circuit differing only in parameters and phase") {
+    Circuit circ2(3, 1);
+    circ2.add_op<unsigned>(OpType::H, {0});
+    circ2.add_op<unsigned>(OpType::Rz, 0.5, {2});
+    circ2.add_op<unsigned>(OpType::CX, {0, 1});
+    circ2.add_measure(1, 0);
+    circ2.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {0}, 1);
+    circ2.add_phase(0.5);
+    REQUIRE(circ2.structural_hash() != with_params);
+    REQUIRE(circ2.structural_hash(Circuit::HashParams::No) == without_params);
+  }
+  GIVEN("A structurally different circuit") {
+    Circuit circ2(3, 1);
+    circ2.add_op<unsigned>(OpType::H, {0});
+    circ2.add_op<unsigned>(OpType::Rz, 0.25, {2});
+    circ2.add_op<unsigned>(OpType::CX, {1, 0});
+    circ2.add_measure(1, 0);
+    circ2.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {0}, 1);
+    REQUIRE(circ2.structural_hash(Circuit::HashParams::No) != without_params);
+  }
+  GIVEN("Boxes with equal contents") {
+    Circuit inner(2);
+    inner.add_op<unsigned>(OpType::CZ, {0, 1});
+    Circuit a(2), b(2);
+    a.add_box(CircBox(inner), {0, 1});
+    b.add_box(CircBox(inner), {0, 1});
+    REQUIRE(a.structural_hash() == b.structural_hash());
+  }
+}
+
+SCENARIO("Moving circuits") {
+  Circuit circ(2, 1);
+  circ.add_op<unsigned>(OpType::H, {0});
+  Vertex cx = circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_measure(1, 0);
+  circ.add_phase(0.5);
+  const Circuit copy = circ;
+  GIVEN("Move construction") {
+    Circuit moved(std::move(circ));
+    REQUIRE(moved == copy);
+    // Vertex descriptors survive the move.
+    REQUIRE(moved.get_OpType_from_Vertex(cx) == OpType::CX);
+    REQUIRE(circ.n_vertices() == 0);
+    REQUIRE(circ.n_qubits() == 0);
+  }
+  GIVEN("Move assignment") {
+    Circuit moved(3);
+    moved = std::move(circ);
+    REQUIRE(moved == copy);
+    REQUIRE(moved.get_OpType_from_Vertex(cx) == OpType::CX);
+    moved.add_op<unsigned>(OpType::X, {1});
+    REQUIRE(moved.n_gates() == 4);
+  }
+}
+
+SCENARIO("Visiting commands without constructing them") {
+  Circuit circ(3, 2);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_measure(1, 0);
+  circ.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {0}, 1);
+  circ.add_measure(2, 1);
+  circ.add_barrier({0, 1, 2});
+  circ.add_op<unsigned>(OpType::CZ, {2, 0});
+  std::map<Vertex, unit_vector_t> expected;
+  for (const Command& com : circ) {
+    expected[com.get_vertex()] = com.get_args();
+  }
+  GIVEN("A full visit") {
+    VertexSet seen;
+    REQUIRE(circ.visit_commands([&](const CommandView& com) {
+      REQUIRE(com.op == circ.get_Op_ptr_from_Vertex(com.vertex));
+      unit_vector_t args(com.args.begin(), com.args.end());
+      REQUIRE(args == expected.at(com.vertex));
+      // Predecessors are visited first.
+      for (const Vertex& pred : circ.get_predecessors(com.vertex)) {
+        if (expected.contains(pred)) REQUIRE(seen.contains(pred));
+      }
+      seen.insert(com.vertex);
+      return true;
+    }));
+    REQUIRE(seen.size() == expected.size());
+  }
+  GIVEN("A visit stopped early") {
+    unsigned n_visited = 0;
+    REQUIRE_FALSE(circ.visit_commands([&](const CommandView&) {
+      return ++n_visited < 3;
+    }));
+    REQUIRE(n_visited == 3);
+  }
+  GIVEN("A circuit with an op that has no arguments") {
+    Circuit circ2(2);
+    circ2.add_op<unsigned>(OpType::H, {0});
+    circ2.add_op<unsigned>(OpType::Phase, 0.25, {});
+    circ2.add_op<unsigned>(OpType::CX, {0, 1});
+    std::map<Vertex, unit_vector_t> expected2;
+    for (const Command& com : circ2.get_commands()) {
+      expected2[com.get_vertex()] = com.get_args();
+    }
+    REQUIRE(expected2.size() == 3);
+    std::map<Vertex, unit_vector_t> seen;
+    REQUIRE(circ2.visit_commands([&](const CommandView& com) {
+      seen[com.vertex] = unit_vector_t(com.args.begin(), com.args.end());
+      return true;
+    }));
+    REQUIRE(seen == expected2);
+  }
+}
+
+SCENARIO("Exporting commands as columns") {
+  Sym a = SymEngine::symbol("a");
+  Circuit circ(2, 1);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1}, "ent");
+  circ.add_op<unsigned>(OpType::Rz, Expr(a), {1});
+  circ.add_measure(1, 0);
+  circ.add_op<unsigned>(OpType::U2, std::vector<Expr>{0.5, 0.25}, {0}, "ent");
+  circ.add_conditional_gate<unsigned>(OpType::Rx, {0.5}, {0}, {0}, 1);
+  CommandColumns cols = circ.get_command_columns();
+  REQUIRE(cols.units == unit_vector_t{Qubit(0), Qubit(1), Bit(0)});
+  REQUIRE(cols.op_types.size() == circ.n_gates());
+  REQUIRE(cols.arg_offsets.size() == circ.n_gates() + 1);
+  REQUIRE(cols.param_offsets.size() == circ.n_gates() + 1);
+  REQUIRE(cols.opgroups == std::vector<std::string>{"ent"});
+  std::vector<OpType> visited;
+  circ.visit_commands([&](const CommandView& com) {
+    const std::size_t i = visited.size();
+    visited.push_back(com.op->get_type());
+    unit_vector_t args;
+    for (std::size_t k = cols.arg_offsets[i]; k < cols.arg_offsets[i + 1];
+         ++k) {
+      args.push_back(cols.units[cols.args[k]]);
+    }
+    REQUIRE(args == unit_vector_t(com.args.begin(), com.args.end()));
+    const std::size_t n_params =
+        cols.param_offsets[i + 1] - cols.param_offsets[i];
+    const double* params = cols.params.data() + cols.param_offsets[i];
+    switch (com.op->get_type()) {
+      case OpType::U2:
+        REQUIRE(n_params == 2);
+        REQUIRE(params[0] == 0.5);
+        REQUIRE(params[1] == 0.25);
+        break;
+      case OpType::Rz:
+        REQUIRE(n_params == 1);
+        REQUIRE(std::isnan(params[0]));
+        break;
+      default:
+        // Conditional gates are not gates
+        REQUIRE(n_params == 0);
+    }
+    const bool in_group =
+        com.op->get_type() == OpType::CX || com.op->get_type() == OpType::U2;
+    REQUIRE(cols.opgroup_ids[i] == (in_group ? 0 : -1));
+    return true;
+  });
+  REQUIRE(visited == cols.op_types);
+  GIVEN("A circuit with a Phase op") {
+    Circuit circ2(1);
+    circ2.add_op<unsigned>(OpType::X, {0});
+    circ2.add_op<unsigned>(OpType::Phase, 0.25, {});
+    CommandColumns cols2 = circ2.get_command_columns();
+    REQUIRE(cols2.op_types.size() == 2);
+    const auto it = std::find(
+        cols2.op_types.begin(), cols2.op_types.end(), OpType::Phase);
+    REQUIRE(it != cols2.op_types.end());
+    const std::size_t i = it - cols2.op_types.begin();
+    REQUIRE(cols2.arg_offsets[i] == cols2.arg_offsets[i + 1]);
+    REQUIRE(cols2.param_offsets[i + 1] - cols2.param_offsets[i] == 1);
+    REQUIRE(cols2.params[cols2.param_offsets[i]] == 0.25);
+  }
+}
+
+SCENARIO("Splitting circuits into independent components") {
+  GIVEN("A circuit with three components") {
+    Circuit circ;
+    register_t qreg = circ.add_q_register("a", 5);
+    circ.add_c_register("m", 2);
+    circ.add_op<UnitID>(OpType::H, {Qubit("a", 0)});
+    circ.add_op<UnitID>(OpType::CX, {Qubit("a", 0), Qubit("a", 2)});
+    circ.add_op<UnitID>(OpType::Rz, 0.5, {Qubit("a", 1)});
+    circ.add_op<UnitID>(OpType::CZ, {Qubit("a", 3), Qubit("a", 1)});
+    circ.add_op<UnitID>(OpType::Measure, {Qubit("a", 2), Bit("m", 1)});
+    circ.add_phase(0.25);
+    REQUIRE(qreg.size() == 5);
+    std::vector<CircuitComponent> components = circ.split_into_components();
+    // {a[0], a[2], m[1]}, {a[1], a[3]}, {a[4]}, {m[0]}
+    REQUIRE(components.size() == 4);
+    REQUIRE(components[0].circ.n_qubits() == 2);
+    REQUIRE(components[0].circ.n_bits() == 1);
+    REQUIRE(components[0].circ.n_gates() == 3);
+    REQUIRE(components[0].unit_map.at(Bit(0)) == Bit("m", 1));
+    REQUIRE(components[0].circ.get_phase() == 0.25);
+    REQUIRE(components[1].circ.n_gates() == 2);
+    REQUIRE(components[1].unit_map.at(Qubit(0)) == Qubit("a", 1));
+    REQUIRE(components[1].circ.is_simple());
+    REQUIRE(components[2].circ.n_gates() == 0);
+    REQUIRE(components[3].circ.n_bits() == 1);
+    Circuit recombined = Circuit::recombine_components(components);
+    REQUIRE(recombined == circ);
+  }
+  GIVEN("A circuit with conditional gates and a wire swap") {
+    Circuit circ(4, 1);
+    circ.add_measure(0, 0);
+    circ.add_conditional_gate<unsigned>(OpType::X, {}, {1}, {0}, 1);
+    circ.add_op<unsigned>(OpType::SWAP, {2, 3});
+    circ.replace_SWAPs();
+    REQUIRE(circ.has_implicit_wireswaps());
+    std::vector<CircuitComponent> components = circ.split_into_components();
+    REQUIRE(components.size() == 2);
+    REQUIRE(components[0].circ.n_qubits() == 2);
+    REQUIRE(components[1].circ.has_implicit_wireswaps());
+    Circuit recombined = Circuit::recombine_components(components);
+    REQUIRE(recombined == circ);
+  }
+  GIVEN("A circuit with a Phase op") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::H, {1});
+    circ.add_op<unsigned>(OpType::Phase, 0.25, {});
+    circ.add_phase(0.5);
+    std::vector<CircuitComponent> components = circ.split_into_components();
+    REQUIRE(components.size() == 2);
+    REQUIRE(components[0].circ.n_gates() == 0);
+    REQUIRE(components[0].circ.get_phase() == 0.75);
+    REQUIRE(components[1].circ.n_gates() == 1);
+    Circuit recombined = Circuit::recombine_components(components);
+    REQUIRE(recombined.get_phase() == 0.75);
+    REQUIRE(recombined.n_gates() == 1);
+  }
+}
+
+SCENARIO("Rewriting numeric parameters in bulk") {
+  Sym a = SymEngine::symbol("a");
+  Circuit circ(2, 1);
+  circ.add_op<unsigned>(OpType::Rz, 0.26, {0});
+  circ.add_op<unsigned>(OpType::Rx, 0.26, {1});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::PhasedX, {Expr(a), 0.74}, {0});
+  circ.add_op<unsigned>(OpType::Rz, 0.25, {1});
+  circ.add_conditional_gate<unsigned>(OpType::Rz, {0.26}, {0}, {0}, 1);
+  std::vector<double> seen;
+  VertexVec rewritten =
+      rewrite_numeric_params(circ, [&seen](std::vector<double> &values) {
+        seen = values;
+        for (double &x : values) {
+          x = std::nearbyint(4 * x) / 4;
+        }
+      });
+  // The symbolic parameter is not visited
+  REQUIRE(seen.size() == 5);
+  // Rz(0.25) is unchanged
+  REQUIRE(rewritten.size() == 4);
+  std::vector<Command> cmds = circ.get_commands();
+  REQUIRE(cmds.size() == 6);
+  for (const Command &cmd : cmds) {
+    Op_ptr op = cmd.get_op_ptr();
+    if (op->get_type() == OpType::Rz || op->get_type() == OpType::Rx) {
+      REQUIRE(test_equiv_val(op->get_params()[0], 0.25));
+    }
+    if (op->get_type() == OpType::PhasedX) {
+      REQUIRE(op->get_params()[0] == Expr(a));
+      REQUIRE(test_equiv_val(op->get_params()[1], 0.75));
+    }
+    if (op->get_type() == OpType::Conditional) {
+      const Conditional &cond = static_cast<const Conditional &>(*op);
+      REQUIRE(*cond.get_op() == *get_op_ptr(OpType::Rz, 0.25));
+      REQUIRE(cond.get_value() == 1);
+    }
+  }
+  GIVEN("Identical results") {
+    Circuit c(3);
+    for (unsigned q = 0; q < 3; ++q) {
+      c.add_op<unsigned>(OpType::Ry, 0.1 * (q + 1), {q});
+    }
+    VertexVec vs = rewrite_numeric_params(c, [](std::vector<double> &values) {
+      for (double &x : values) x = 0.5;
+    });
+    REQUIRE(vs.size() == 3);
+    // The rewritten gates share one op
+    REQUIRE(c.get_Op_ptr_from_Vertex(vs[0]) == c.get_Op_ptr_from_Vertex(vs[1]));
+    REQUIRE(c.get_Op_ptr_from_Vertex(vs[1]) == c.get_Op_ptr_from_Vertex(vs[2]));
+  }
+}
+
 }  // namespace test_Circ
 }  // namespace tket
@@ -0,0 +1,107 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/CircuitBuilder.hpp"
+#include "tket/Circuit/Conditional.hpp"
+#include "tket/Gate/OpPtrFunctions.hpp"
+
+namespace tket {
+namespace test_CircuitBuilder {
+
+SCENARIO("Building circuits in bulk") {
+  GIVEN("A circuit with quantum, classical and conditional operations") {
+    CircuitBuilder builder(3, 2);
+    builder.reserve(6, 11);
+    builder.add_op(OpType::H, {0});
+    builder.add_op(OpType::CX, {0, 1});
+    builder.add_op(OpType::Rz, {0.25}, {2});
+    builder.add_op(OpType::Measure, {1, 0});
+    builder.add_op(
+        std::make_shared<Conditional>(get_op_ptr(OpType::X), 1, 1), {0, 2});
+    builder.add_op(OpType::Measure, {2, 0});
+    REQUIRE(builder.n_ops() == 6);
+    Circuit built = builder.build();
+    built.assert_valid();
+
+    Circuit expected(3, 2);
+    expected.add_op<unsigned>(OpType::H, {0});
+    expected.add_op<unsigned>(OpType::CX, {0, 1});
+    expected.add_op<unsigned>(OpType::Rz, 0.25, {2});
+    expected.add_measure(1, 0);
+    expected.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {0}, 1);
+    expected.add_measure(2, 0);
+    REQUIRE(built == expected);
+    REQUIRE(built.n_edges() == expected.n_edges());
+  }
+  GIVEN("No operations") {
+    CircuitBuilder builder(2, 1);
+    REQUIRE(builder.build() == Circuit(2, 1));
+  }
+  GIVEN("Invalid operations") {
+    CircuitBuilder wrong_arity(2);
+    wrong_arity.add_op(OpType::H, {0});
+    wrong_arity.add_op(get_op_ptr(OpType::CX), {0});
+    REQUIRE_THROWS_AS(wrong_arity.build(), CircuitInvalidity);
+    CircuitBuilder out_of_range(2, 1);
+    out_of_range.add_op(OpType::Measure, {0, 1});
+    REQUIRE_THROWS_AS(out_of_range.build(), CircuitInvalidity);
+    CircuitBuilder repeated(2);
+    repeated.add_op(OpType::CX, {1, 1});
+    REQUIRE_THROWS_AS(repeated.build(), CircuitInvalidity);
+    CircuitBuilder barrier(2);
+    REQUIRE_THROWS_AS(barrier.add_op(OpType::Barrier, {0}), CircuitInvalidity);
+  }
+}
+
+SCENARIO("Building circuits from gate arrays") {
+  const std::vector<OpType> types{
+      OpType::H, OpType::CX, OpType::Rz, OpType::CCX, OpType::U2};
+  const std::vector<unsigned> qubits{0, 9, 9, 0, 1, 9, 2, 9, 9,
+                                     0, 1, 2, 1, 9, 9};
+  const std::vector<double> params{0., 0., 0., 0., 0.5, 0., 0., 0., 0.25, 1.};
+  CircuitBuilder builder(3);
+  builder.add_gates(types, qubits, 3, params, 2);
+  REQUIRE(builder.n_ops() == 5);
+  Circuit built = builder.build();
+  Circuit expected(3);
+  expected.add_op<unsigned>(OpType::H, {0});
+  expected.add_op<unsigned>(OpType::CX, {0, 1});
+  expected.add_op<unsigned>(OpType::Rz, 0.5, {2});
+  expected.add_op<unsigned>(OpType::CCX, {0, 1, 2});
+  expected.add_op<unsigned>(OpType::U2, std::vector<Expr>{0.25, 1.}, {1});
+  REQUIRE(built == expected);
+  GIVEN("Invalid gates") {
+    CircuitBuilder b(3);
+    REQUIRE_THROWS_AS(
+        b.add_gates({OpType::H, OpType::Measure}, {0, 0, 1, 0}, 2, {}, 0),
+        CircuitInvalidity);
+    REQUIRE_THROWS_AS(
+        b.add_gates({OpType::H, OpType::CX}, {0, 1}, 1, {}, 0),
+        CircuitInvalidity);
+    REQUIRE_THROWS_AS(
+        b.add_gates({OpType::Rz}, {0}, 1, {}, 0), CircuitInvalidity);
+    REQUIRE_THROWS_AS(
+        b.add_gates({OpType::CnX}, {0, 1}, 2, {}, 0), CircuitInvalidity);
+    REQUIRE_THROWS_AS(
+        b.add_gates({OpType::H}, {0, 1}, 1, {}, 0), CircuitInvalidity);
+    REQUIRE(b.n_ops() == 0);
+  }
+}
+
+}  // namespace test_CircuitBuilder
+}  // namespace tket
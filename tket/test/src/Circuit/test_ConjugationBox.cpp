@@ -25,6 +25,8 @@
 #include "tket/Circuit/ConjugationBox.hpp"
 #include "tket/Circuit/Simulation/CircuitSimulator.hpp"
 #include "tket/Gate/Rotation.hpp"
+#include "tket/Transformations/BasicOptimisation.hpp"
+#include "tket/Transformations/Combinator.hpp"
 
 namespace tket {
 namespace test_ConjugationBox {
@@ -161,5 +163,98 @@ SCENARIO("Test ConjugationBox Exceptions") {
         MessageContains("have the same number of qubits"));
   }
 }
+
+// An oracle of nested conjugations, and the same circuit without boxes
+static std::pair<Op_ptr, Circuit> nested_conjugation(
+    unsigned depth, bool explicit_uncompute) {
+  Circuit action(3);
+  action.add_op<unsigned>(OpType::CZ, {0, 2});
+  action.add_op<unsigned>(OpType::Rz, 0.3, {1});
+  Op_ptr op = std::make_shared<CircBox>(action);
+  Circuit flat = action;
+  for (unsigned i = 0; i < depth; ++i) {
+    Circuit compute(3);
+    compute.add_op<unsigned>(OpType::Ry, 0.1 * (i + 1), {i % 3});
+    compute.add_op<unsigned>(OpType::CX, {i % 3, (i + 1) % 3});
+    compute.add_op<unsigned>(OpType::CRz, 0.2, {(i + 2) % 3, i % 3});
+    Op_ptr compute_op = std::make_shared<CircBox>(compute);
+    if (explicit_uncompute) {
+      op = std::make_shared<ConjugationBox>(
+          compute_op, op, std::make_shared<CircBox>(compute.dagger()));
+    } else {
+      op = std::make_shared<ConjugationBox>(compute_op, op);
+    }
+    Circuit next = compute;
+    next.append(flat);
+    next.append(compute.dagger());
+    flat = next;
+  }
+  return {op, flat};
+}
+
+static void check_nested_conjugation(bool explicit_uncompute) {
+  auto [op, flat] = nested_conjugation(6, explicit_uncompute);
+  Circuit circ(3);
+  circ.add_op<unsigned>(op, {0, 1, 2});
+  // Simulation
+  REQUIRE(tket_sim::get_unitary(circ).isApprox(tket_sim::get_unitary(flat)));
+  Circuit circ_dagger(3);
+  circ_dagger.add_op<unsigned>(op->dagger(), {0, 1, 2});
+  REQUIRE(tket_sim::get_unitary(circ_dagger)
+              .isApprox(tket_sim::get_unitary(flat.dagger())));
+  // Decomposition, keeping the compute boxes
+  Circuit partial = circ;
+  REQUIRE(partial.decompose_boxes_recursively({OpType::CircBox}));
+  REQUIRE(partial.count_gates(OpType::ConjugationBox) == 0);
+  REQUIRE(partial.count_gates(OpType::CircBox) == 13);
+  REQUIRE(test_unitary_comparison(partial, flat));
+  // Full decomposition
+  REQUIRE(circ.decompose_boxes_recursively());
+  REQUIRE(circ.n_gates() == flat.n_gates());
+  REQUIRE(test_unitary_comparison(circ, flat));
+}
+
+SCENARIO("Simulating and decomposing nested ConjugationBoxes") {
+  GIVEN("Default uncompute") { check_nested_conjugation(false); }
+  GIVEN("Explicit uncompute") { check_nested_conjugation(true); }
+}
+
+SCENARIO("Transforming the actions of ConjugationBoxes") {
+  Circuit compute(2);
+  compute.add_op<unsigned>(OpType::CX, {0, 1});
+  compute.add_op<unsigned>(OpType::CX, {0, 1});
+  Op_ptr compute_op = std::make_shared<CircBox>(compute);
+  Circuit inner_action(2);
+  inner_action.add_op<unsigned>(OpType::H, {0});
+  inner_action.add_op<unsigned>(OpType::H, {0});
+  inner_action.add_op<unsigned>(OpType::Rz, 0.5, {1});
+  Op_ptr inner = std::make_shared<ConjugationBox>(
+      compute_op, std::make_shared<CircBox>(inner_action));
+  Op_ptr outer = std::make_shared<ConjugationBox>(compute_op, inner);
+  Circuit circ(2);
+  circ.add_op<unsigned>(outer, {0, 1});
+  const Circuit original = circ;
+
+  Transform t =
+      Transforms::conjugation_actions(Transforms::remove_redundancies());
+  REQUIRE(t.apply(circ));
+  REQUIRE(test_unitary_comparison(circ, original));
+  // The compute parts are untouched; the innermost action has been reduced.
+  const ConjugationBox &new_outer = static_cast<const ConjugationBox &>(
+      *circ.get_commands().front().get_op_ptr());
+  REQUIRE(*new_outer.get_compute() == *compute_op);
+  std::shared_ptr<Circuit> outer_action =
+      static_cast<const CircBox &>(*new_outer.get_action()).to_circuit();
+  REQUIRE(outer_action->n_gates() == 1);
+  const ConjugationBox &new_inner = static_cast<const ConjugationBox &>(
+      *outer_action->get_commands().front().get_op_ptr());
+  REQUIRE(*new_inner.get_compute() == *compute_op);
+  std::shared_ptr<Circuit> inner_action_circ =
+      static_cast<const CircBox &>(*new_inner.get_action()).to_circuit();
+  REQUIRE(inner_action_circ->n_gates() == 1);
+  REQUIRE(inner_action_circ->count_gates(OpType::Rz) == 1);
+  REQUIRE_FALSE(t.apply(circ));
+}
+
 }  // namespace test_ConjugationBox
 }  // namespace tket
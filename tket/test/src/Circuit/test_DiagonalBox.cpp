@@ -88,6 +88,32 @@ SCENARIO("Test DiagonalBox") {
       REQUIRE(cmds[i].get_args() == args);
     }
   }
+  GIVEN("diagonal implemented as a phase polynomial") {
+    std::vector<Eigen::VectorXcd> test_diagonals;
+    test_diagonals.push_back(Eigen::Vector2cd(-1, 1));
+    test_diagonals.push_back(Eigen::Vector4cd(1, 1, i_, i_));
+    for (unsigned i = 0; i < 3; i++) {
+      test_diagonals.push_back(random_diagonal(8, i));
+      test_diagonals.push_back(random_diagonal(32, i));
+    }
+    for (auto d : test_diagonals) {
+      DiagonalBox diag(d, true, DiagonalBoxSynthStrat::PhasePolynomial);
+      REQUIRE(diag.get_strat() == DiagonalBoxSynthStrat::PhasePolynomial);
+      std::shared_ptr<Circuit> c = diag.to_circuit();
+      for (const Command &cmd : c->get_commands()) {
+        const OpType type = cmd.get_op_ptr()->get_type();
+        REQUIRE((type == OpType::CX || type == OpType::Rz));
+      }
+      const Eigen::MatrixXcd U = tket_sim::get_unitary(*c);
+      Eigen::DiagonalMatrix<Complex, Eigen::Dynamic> D(d);
+      Eigen::MatrixXcd M = D.derived();
+      REQUIRE((U - M).cwiseAbs().sum() < ERR_EPS);
+    }
+    // a diagonal of phases on single qubits needs no CX
+    Eigen::Vector4cd product(1, i_, -1, -i_);
+    DiagonalBox diag(product, true, DiagonalBoxSynthStrat::PhasePolynomial);
+    REQUIRE(diag.to_circuit()->count_gates(OpType::CX) == 0);
+  }
   GIVEN("Non-unitary diagonal") {
     Eigen::Vector2cd diag(2. * i_, 1);
     REQUIRE_THROWS_MATCHES(
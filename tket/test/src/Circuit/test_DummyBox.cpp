@@ -50,6 +50,40 @@ SCENARIO("DummyBox") {
         ResourceBounds<unsigned>(5, 9)};
     CHECK(data == expected);
   }
+  GIVEN("A hierarchy of DummyBoxes") {
+    // Summarise a circuit as a DummyBox, then use that box twice in a larger
+    // circuit, and summarise that again.
+    Circuit inner(2);
+    inner.add_op<unsigned>(OpType::H, {0});
+    inner.add_op<unsigned>(OpType::CX, {0, 1});
+    inner.add_op<unsigned>(OpType::Rz, 0.5, {1});
+    DummyBox inner_box(2, 0, inner.get_resources());
+    Circuit middle(3);
+    middle.add_box(inner_box, {0, 1});
+    middle.add_box(inner_box, {1, 2});
+    middle.add_op<unsigned>(OpType::CZ, {0, 2});
+    const Circuit& cmiddle = middle;
+    DummyBox middle_box(3, 0, cmiddle.get_resources());
+    Circuit outer(3);
+    outer.add_op<unsigned>(OpType::X, {2});
+    outer.add_box(middle_box, {0, 1, 2});
+    const Circuit& couter = outer;
+    ResourceData data = couter.get_resources();
+    ResourceData expected{
+        {{OpType::H, ResourceBounds<unsigned>(2)},
+         {OpType::CX, ResourceBounds<unsigned>(2)},
+         {OpType::Rz, ResourceBounds<unsigned>(2)},
+         {OpType::CZ, ResourceBounds<unsigned>(1)},
+         {OpType::X, ResourceBounds<unsigned>(1)}},
+        ResourceBounds<unsigned>(8),
+        {{OpType::H, ResourceBounds<unsigned>(2)},
+         {OpType::CX, ResourceBounds<unsigned>(2)},
+         {OpType::Rz, ResourceBounds<unsigned>(2)},
+         {OpType::CZ, ResourceBounds<unsigned>(1)},
+         {OpType::X, ResourceBounds<unsigned>(1)}},
+        ResourceBounds<unsigned>(3)};
+    CHECK(data == expected);
+  }
 }
 
 }  // namespace tket
@@ -0,0 +1,122 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/FlatDAG.hpp"
+
+namespace tket {
+namespace test_FlatDAG {
+
+// Check that the flat representation agrees with the circuit DAG.
+static void check_matches(const Circuit& circ, const FlatDAG& flat) {
+  REQUIRE(flat.n_vertices() == circ.n_vertices());
+  REQUIRE(flat.n_edges() == circ.n_edges());
+  for (FlatDAG::index_t v = 0; v < flat.vertex_slots(); ++v) {
+    if (flat.is_removed(v)) continue;
+    Vertex vert = flat.get_vertex(v);
+    REQUIRE(flat.get_index(vert) == v);
+    REQUIRE(flat.get_optype(v) == circ.get_OpType_from_Vertex(vert));
+    EdgeVec ins = circ.get_in_edges(vert);
+    std::span<const FlatDAG::index_t> flat_ins = flat.in_edges(v);
+    REQUIRE(flat_ins.size() == ins.size());
+    for (unsigned p = 0; p < ins.size(); ++p) {
+      FlatDAG::index_t e = flat_ins[p];
+      REQUIRE(flat.target(e) == v);
+      REQUIRE(flat.target_port(e) == p);
+      REQUIRE(flat.get_vertex(flat.source(e)) == circ.source(ins[p]));
+      REQUIRE(flat.source_port(e) == circ.get_source_port(ins[p]));
+      REQUIRE(flat.get_edgetype(e) == circ.get_edgetype(ins[p]));
+    }
+    EdgeVec outs = circ.get_all_out_edges(vert);
+    std::span<const FlatDAG::index_t> flat_outs = flat.out_edges(v);
+    REQUIRE(flat_outs.size() == outs.size());
+    for (unsigned i = 0; i < outs.size(); ++i) {
+      FlatDAG::index_t e = flat_outs[i];
+      REQUIRE(flat.source(e) == v);
+      REQUIRE(flat.get_vertex(flat.target(e)) == circ.target(outs[i]));
+    }
+  }
+}
+
+SCENARIO("Building a FlatDAG from a circuit") {
+  GIVEN("A circuit with quantum, classical and Boolean wires") {
+    Circuit circ(3, 2);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::Rz, 0.25, {2});
+    circ.add_measure(1, 0);
+    circ.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {0}, 1);
+    circ.add_conditional_gate<unsigned>(OpType::Z, {}, {1}, {0}, 1);
+    circ.add_op<unsigned>(OpType::CZ, {1, 2});
+    FlatDAG flat(circ);
+    check_matches(circ, flat);
+    THEN("The topological order respects every edge") {
+      std::vector<FlatDAG::index_t> order = flat.topological_order();
+      REQUIRE(order.size() == flat.n_vertices());
+      std::vector<unsigned> position(flat.vertex_slots());
+      for (unsigned i = 0; i < order.size(); ++i) position[order[i]] = i;
+      for (FlatDAG::index_t v = 0; v < flat.vertex_slots(); ++v) {
+        for (FlatDAG::index_t e : flat.out_edges(v)) {
+          REQUIRE(position[v] < position[flat.target(e)]);
+        }
+      }
+    }
+    THEN("Vertices with Boolean edges cannot be removed") {
+      Vertex meas = *circ.get_gates_of_type(OpType::Measure).begin();
+      REQUIRE_THROWS_AS(
+          flat.remove_vertex(flat.get_index(meas)), CircuitInvalidity);
+      Vertex in = circ.get_in(Qubit(0));
+      REQUIRE_THROWS_AS(
+          flat.remove_vertex(flat.get_index(in)), CircuitInvalidity);
+    }
+  }
+}
+
+SCENARIO("Removing vertices from a FlatDAG and compacting") {
+  Circuit circ(2);
+  Vertex h0 = circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  Vertex h1 = circ.add_op<unsigned>(OpType::H, {1});
+  Vertex cx = circ.add_op<unsigned>(OpType::CX, {1, 0});
+  circ.add_op<unsigned>(OpType::T, {0});
+  FlatDAG flat(circ);
+  flat.remove_vertex(flat.get_index(h0));
+  flat.remove_vertex(flat.get_index(h1));
+  flat.remove_vertex(flat.get_index(cx));
+  REQUIRE(flat.n_removed_vertices() == 3);
+  REQUIRE_THROWS_AS(
+      flat.remove_vertex(flat.get_index(h0)), CircuitInvalidity);
+
+  // Apply the same removals to the circuit and compare.
+  std::vector<Vertex> removed = flat.removed_vertices();
+  REQUIRE(removed.size() == 3);
+  circ.remove_vertices(
+      VertexList(removed.begin(), removed.end()),
+      Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::Yes);
+  check_matches(circ, flat);
+
+  std::vector<FlatDAG::index_t> new_index = flat.compact();
+  REQUIRE(flat.n_removed_vertices() == 0);
+  REQUIRE(flat.vertex_slots() == circ.n_vertices());
+  REQUIRE(new_index.size() == circ.n_vertices() + 3);
+  REQUIRE_THROWS_AS(flat.get_index(h0), MissingVertex);
+  check_matches(circ, flat);
+  REQUIRE(flat.topological_order().size() == circ.n_vertices());
+}
+
+}  // namespace test_FlatDAG
+}  // namespace tket
@@ -203,6 +203,20 @@ SCENARIO("MultiplexedRotationBox decomposition", "[boxes]") {
     REQUIRE(cmds.size() == 1);
     REQUIRE(check_multiplexor(op_map, *c));
   }
+  GIVEN("MultiplexedRotationBox with six controls") {
+    ctrl_op_map_t op_map;
+    for (unsigned long long i = 0; i < 64; i++) {
+      if (i % 5 != 3) {
+        op_map.insert(
+            {dec_to_bin(i, 6), get_op_ptr(OpType::Ry, 0.01 * i * i - 0.3)});
+      }
+    }
+    MultiplexedRotationBox multiplexor(op_map);
+    std::shared_ptr<Circuit> c = multiplexor.to_circuit();
+    REQUIRE(c->n_gates() == 128);
+    REQUIRE(c->count_gates(OpType::CX) == 64);
+    REQUIRE(check_multiplexor(op_map, *c));
+  }
   GIVEN("MultiplexedRotationBox with symbols") {
     Sym a = SymTable::fresh_symbol("a");
     Expr expr_a(a);
@@ -19,7 +19,9 @@
 #include <tket/Gate/SymTable.hpp>
 
 #include "../testutil.hpp"
+#include "tket/Circuit/CircUtils.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/ConjugationBox.hpp"
 #include "tket/Circuit/PauliExpBoxes.hpp"
 
 namespace tket {
@@ -272,6 +274,31 @@ SCENARIO("Pauli gadgets", "[boxes]") {
     Expr p = pebox.get_phase();
     REQUIRE(p == ei);
   }
+  GIVEN("Gadgets differing only in angle") {
+    DensePauliMap string{Pauli::X, Pauli::Y, Pauli::Z};
+    PauliExpBox pbox0(SymPauliTensor(string, 0.3));
+    PauliExpBox pbox1(SymPauliTensor(string, 1.1));
+    Command cmd0 = pbox0.to_circuit()->get_commands()[0];
+    Command cmd1 = pbox1.to_circuit()->get_commands()[0];
+    const ConjugationBox &cbox0 =
+        static_cast<const ConjugationBox &>(*cmd0.get_op_ptr());
+    const ConjugationBox &cbox1 =
+        static_cast<const ConjugationBox &>(*cmd1.get_op_ptr());
+    THEN("The Clifford part of the decomposition is shared") {
+      REQUIRE(cbox0.get_compute() == cbox1.get_compute());
+      REQUIRE(cbox0.get_action() != cbox1.get_action());
+    }
+    THEN("Each box has the expected unitary") {
+      Circuit c0(3), c1(3);
+      c0.add_box(pbox0, {0, 1, 2});
+      c1.add_box(pbox1, {0, 1, 2});
+      Circuit ref0(3), ref1(3);
+      ref0.append(pauli_gadget(SymPauliTensor(string, 0.3)));
+      ref1.append(pauli_gadget(SymPauliTensor(string, 1.1)));
+      REQUIRE(test_unitary_comparison(c0, ref0));
+      REQUIRE(test_unitary_comparison(c1, ref1));
+    }
+  }
 }
 SCENARIO("Pauli gadget pairs", "[boxes]") {
   GIVEN("Basis Circuit check") {
@@ -292,6 +319,23 @@ SCENARIO("Pauli gadget pairs", "[boxes]") {
     empty_pbox_circuit->decompose_boxes_recursively();
     REQUIRE(*empty_pbox_circuit == empty_circuit);
   }
+  GIVEN("Pairs differing only in angles") {
+    DensePauliMap string0{Pauli::X, Pauli::Z};
+    // YY commutes with XZ, ZZ anticommutes with it
+    std::vector<DensePauliMap> others{
+        {Pauli::Y, Pauli::Y}, {Pauli::Z, Pauli::Z}};
+    for (const DensePauliMap &s1 : others) {
+      for (double a : {0.2, 0.7}) {
+        PauliExpPairBox pbox(
+            SymPauliTensor(string0, a), SymPauliTensor(s1, 1.3 - a));
+        Circuit c(2);
+        c.add_box(pbox, {0, 1});
+        Circuit ref = pauli_gadget_pair(
+            SymPauliTensor(string0, a), SymPauliTensor(s1, 1.3 - a));
+        REQUIRE(test_unitary_comparison(c, ref));
+      }
+    }
+  }
   GIVEN("Construction with two pauli strings of different length throws") {
     DensePauliMap pauli_string0{Pauli::X, Pauli::Z};
     DensePauliMap pauli_string1{Pauli::X, Pauli::Z, Pauli::I};
@@ -0,0 +1,147 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/SliceCache.hpp"
+
+namespace tket {
+namespace test_SliceCache {
+
+// Check that the cached slices agree with those computed from scratch.
+static void check_slices(const Circuit& circ, const SliceCache& cache) {
+  SliceVec slices = circ.get_slices();
+  REQUIRE(cache.depth() == slices.size());
+  for (unsigned i = 0; i < slices.size(); ++i) {
+    VertexSet expected(slices[i].begin(), slices[i].end());
+    REQUIRE(cache.get_slice(i + 1) == expected);
+    for (const Vertex& v : slices[i]) {
+      REQUIRE(cache.get_layer(v) == i + 1);
+    }
+  }
+  // Heights of an updated cache agree with those of a fresh one.
+  SliceCache fresh(circ);
+  unsigned max_height = 0;
+  BGL_FORALL_VERTICES(v, circ.dag, DAG) {
+    REQUIRE(cache.get_height(v) == fresh.get_height(v));
+    max_height = std::max(max_height, cache.get_height(v));
+  }
+  REQUIRE(max_height == cache.depth());
+}
+
+static bool is_barrier(Op_ptr op) { return op->get_type() == OpType::Barrier; }
+
+// Erase a vertex from the cache and the circuit, then update.
+static void remove_and_update(
+    Circuit& circ, SliceCache& cache, const Vertex& v) {
+  VertexVec succs;
+  for (const Edge& e : circ.get_all_out_edges(v)) {
+    succs.push_back(circ.target(e));
+  }
+  cache.erase(v);
+  circ.remove_vertex(
+      v, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::Yes);
+  cache.update(succs);
+}
+
+SCENARIO("Slices are cached and updated under local rewrites") {
+  GIVEN("A quantum circuit") {
+    Circuit circ(3);
+    Vertex h = circ.add_op<unsigned>(OpType::H, {0});
+    Vertex cx = circ.add_op<unsigned>(OpType::CX, {0, 1});
+    Vertex t = circ.add_op<unsigned>(OpType::T, {2});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::Rz, 0.5, {0});
+    circ.add_op<unsigned>(OpType::CZ, {0, 2});
+    SliceCache cache(circ);
+    check_slices(circ, cache);
+    REQUIRE(cache.depth() == circ.depth());
+    REQUIRE(cache.get_layer(circ.get_in(Qubit(0))) == 0);
+    REQUIRE(cache.get_layer(circ.get_out(Qubit(2))) == cache.depth());
+    REQUIRE(cache.get_height(circ.get_in(Qubit(0))) == cache.depth());
+    REQUIRE(cache.get_height(circ.get_out(Qubit(0))) == 0);
+    REQUIRE(cache.get_height(cx) == 2);
+    REQUIRE(cache.on_critical_path(cx));
+    REQUIRE(cache.on_critical_path(h));
+    REQUIRE_FALSE(cache.on_critical_path(t));
+    WHEN("A vertex is removed") {
+      remove_and_update(circ, cache, h);
+      check_slices(circ, cache);
+      REQUIRE_THROWS_AS(cache.get_layer(h), MissingVertex);
+    }
+    AND_WHEN("A vertex is substituted by a deeper circuit") {
+      VertexVec succs;
+      for (const Edge& e : circ.get_all_out_edges(cx)) {
+        succs.push_back(circ.target(e));
+      }
+      Circuit rep(2);
+      rep.add_op<unsigned>(OpType::H, {1});
+      rep.add_op<unsigned>(OpType::CZ, {0, 1});
+      rep.add_op<unsigned>(OpType::H, {1});
+      cache.erase(cx);
+      circ.substitute(rep, cx);
+      cache.update(succs);
+      check_slices(circ, cache);
+      REQUIRE(cache.depth() == 5);
+    }
+    AND_WHEN("Gates are appended") {
+      Vertex x = circ.add_op<unsigned>(OpType::X, {1});
+      VertexVec changed{x};
+      for (const Edge& e : circ.get_all_out_edges(x)) {
+        changed.push_back(circ.target(e));
+      }
+      cache.update(changed);
+      check_slices(circ, cache);
+    }
+  }
+  GIVEN("A circuit with conditional gates") {
+    Circuit circ(2, 1);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_measure(0, 0);
+    circ.add_op<unsigned>(OpType::H, {1});
+    circ.add_op<unsigned>(OpType::H, {1});
+    circ.add_op<unsigned>(OpType::H, {1});
+    Vertex cond =
+        circ.add_conditional_gate<unsigned>(OpType::X, {}, {1}, {0}, 1);
+    // This measurement must wait for the conditional read of the bit.
+    Vertex meas = circ.add_measure(0, 0);
+    SliceCache cache(circ);
+    check_slices(circ, cache);
+    REQUIRE(cache.get_layer(meas) > cache.get_layer(cond));
+    WHEN("A vertex before the reader is removed") {
+      Vertex h = circ.source(circ.get_nth_in_edge(cond, 1));
+      remove_and_update(circ, cache, h);
+      check_slices(circ, cache);
+    }
+  }
+  GIVEN("A circuit with barriers and a skip function") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_barrier({0, 1});
+    Vertex cx = circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_barrier({0, 1});
+    circ.add_op<unsigned>(OpType::X, {1});
+    SliceCache cache(circ, is_barrier);
+    REQUIRE(cache.depth() == circ.depth());
+    REQUIRE(cache.get_height(cx) == 1);
+    remove_and_update(circ, cache, cx);
+    REQUIRE(cache.depth() == circ.depth());
+    REQUIRE(cache.depth() == 2);
+  }
+}
+
+}  // namespace test_SliceCache
+}  // namespace tket
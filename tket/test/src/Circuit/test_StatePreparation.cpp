@@ -99,6 +99,49 @@ SCENARIO("Test state preparation") {
       }
     }
   }
+  GIVEN("sparse states") {
+    std::vector<Eigen::VectorXcd> test_states;
+    // GHZ state
+    Eigen::VectorXcd ghz = Eigen::VectorXcd::Zero(64);
+    ghz[0] = std::sqrt(0.5);
+    ghz[63] = -std::sqrt(0.5);
+    test_states.push_back(ghz);
+    // W state
+    Eigen::VectorXcd w = Eigen::VectorXcd::Zero(64);
+    for (unsigned i = 0; i < 6; i++) w[1ULL << i] = std::sqrt(1. / 6);
+    test_states.push_back(w);
+    // complex amplitudes on a few basis states
+    Eigen::VectorXcd sparse = Eigen::VectorXcd::Zero(128);
+    sparse[3] = Complex(0.5, 0.1);
+    sparse[40] = Complex(-0.3, 0.6);
+    sparse[41] = Complex(0.2, -0.2);
+    sparse[117] = Complex(0., 0.4);
+    sparse /= sparse.norm();
+    test_states.push_back(sparse);
+    for (auto psi : test_states) {
+      StatePreparationBox prep(psi);
+      std::shared_ptr<Circuit> c = prep.to_circuit();
+      REQUIRE(c->count_gates(OpType::MultiplexedRotationBox) == 0);
+      const Eigen::VectorXcd sv = tket_sim::get_statevector(*c);
+      REQUIRE((psi - sv).cwiseAbs().sum() < ERR_EPS);
+      StatePreparationBox inverse_prep(psi, true);
+      std::shared_ptr<Circuit> d = inverse_prep.to_circuit();
+      const Eigen::VectorXcd final_state = tket_sim::get_unitary(*d) * psi;
+      REQUIRE(std::abs(Complex(1, 0) - final_state[0]) < ERR_EPS);
+      for (unsigned i = 1; i < psi.size(); i++) {
+        REQUIRE(std::abs(final_state[i]) < ERR_EPS);
+      }
+    }
+    // real states need no complex rotations
+    StatePreparationBox w_prep(w);
+    for (const Command &cmd : w_prep.to_circuit()->get_commands()) {
+      Op_ptr op = cmd.get_op_ptr();
+      if (op->get_type() == OpType::QControlBox) {
+        op = static_cast<const QControlBox &>(*op).get_op();
+      }
+      REQUIRE(op->get_type() != OpType::Unitary1qBox);
+    }
+  }
   GIVEN("unnormalised vector") {
     Eigen::Vector2cd state(1, 1);
     REQUIRE_THROWS_MATCHES(
@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <tket/Circuit/Boxes.hpp>
 #include <tket/Circuit/Circuit.hpp>
+#include <tket/Circuit/Conditional.hpp>
+#include <tket/Circuit/SymbolBinding.hpp>
 #include <tket/Transformations/BasicOptimisation.hpp>
 #include <tket/Transformations/CliffordOptimisation.hpp>
 #include <tket/Transformations/OptimisationPass.hpp>
@@ -207,5 +210,94 @@ SCENARIO("Symbolic squashing, correctness") {
   }
 }
 
+SCENARIO("Detecting symbols") {
+  Sym asym = SymEngine::symbol("a");
+  Expr alpha(asym);
+  GIVEN("Ops") {
+    REQUIRE(get_op_ptr(OpType::Rz, alpha)->is_symbolic());
+    REQUIRE_FALSE(get_op_ptr(OpType::Rz, 0.5)->is_symbolic());
+    REQUIRE_FALSE(get_op_ptr(OpType::CX)->is_symbolic());
+    Conditional cond(get_op_ptr(OpType::Rx, 2 * alpha), 1, 1);
+    REQUIRE(cond.is_symbolic());
+    REQUIRE(cond.free_symbols() == SymSet{asym});
+  }
+  GIVEN("Circuits") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    REQUIRE_FALSE(circ.is_symbolic());
+    Circuit inner(1);
+    inner.add_op<unsigned>(OpType::Ry, alpha, {0});
+    circ.add_box(CircBox(inner), {1});
+    REQUIRE(circ.is_symbolic());
+    REQUIRE(circ.free_symbols() == SymSet{asym});
+    Circuit phased(1);
+    phased.add_phase(alpha);
+    REQUIRE(phased.is_symbolic());
+  }
+}
+
+SCENARIO("Binding plans") {
+  Sym asym = SymEngine::symbol("a");
+  Sym bsym = SymEngine::symbol("b");
+  Expr alpha(asym);
+  Expr beta(bsym);
+  Circuit circ(2);
+  circ.add_op<unsigned>(OpType::Rx, 2 * alpha, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::TK1, {alpha, 0.3, alpha * beta}, {1});
+  circ.add_op<unsigned>(OpType::ZZPhase, SymEngine::sin(beta), {0, 1});
+  circ.add_op<unsigned>(OpType::Rz, 0.25, {1});
+  circ.add_phase(alpha + beta);
+  Circuit inner(1);
+  inner.add_op<unsigned>(OpType::Ry, beta, {0});
+  circ.add_box(CircBox(inner), {1});
+
+  GIVEN("A plan") {
+    SymbolBindingPlan plan(circ, {asym, bsym});
+    // Four gate parameters and the phase
+    CHECK(plan.n_compiled_params() == 5);
+    THEN("Binding matches symbolic substitution") {
+      for (const std::vector<double> &values :
+           std::vector<std::vector<double>>{
+               {0.1, 0.7}, {-1.3, 2.2}, {0., 0.}}) {
+        Circuit expected = circ;
+        expected.symbol_substitution(
+            symbol_map_t{{asym, values[0]}, {bsym, values[1]}});
+        Circuit bound = plan.bind(values);
+        CHECK(bound.free_symbols().empty());
+        CHECK(tket_sim::get_unitary(bound).isApprox(
+            tket_sim::get_unitary(expected)));
+      }
+    }
+    THEN("The circuit is unchanged") {
+      CHECK_FALSE(circ.free_symbols().empty());
+      Circuit bound = plan.bind({0.5, 0.5});
+      CHECK(bound.n_gates() == circ.n_gates());
+    }
+    THEN("Batches are bound in order") {
+      std::vector<std::vector<double>> batch;
+      for (unsigned i = 0; i < 20; ++i) batch.push_back({0.1 * i, -0.2 * i});
+      std::vector<Circuit> bound = plan.bind_all(batch, 4);
+      REQUIRE(bound.size() == batch.size());
+      for (unsigned i = 0; i < batch.size(); ++i) {
+        CHECK(tket_sim::get_unitary(bound[i]).isApprox(
+            tket_sim::get_unitary(plan.bind(batch[i]))));
+      }
+    }
+    THEN("The number of values is checked") {
+      REQUIRE_THROWS_AS(plan.bind({0.5}), std::invalid_argument);
+      REQUIRE_THROWS_AS(
+          plan.bind_all({{0.5, 0.5}, {0.5}}), std::invalid_argument);
+    }
+  }
+  GIVEN("A plan without every symbol") {
+    REQUIRE_THROWS_AS(SymbolBindingPlan(circ, {asym}), std::invalid_argument);
+  }
+  GIVEN("A plan with a repeated symbol") {
+    REQUIRE_THROWS_AS(
+        SymbolBindingPlan(circ, {asym, bsym, asym}), std::invalid_argument);
+  }
+}
+
 }  // namespace test_Symbolic
 }  // namespace tket
@@ -517,6 +517,27 @@ SCENARIO("Three-qubit squash") {
     c.add_op<unsigned>(OpType::CX, {1, 0});
     CHECK(Transforms::three_qubit_squash().apply(c));
   }
+  GIVEN("A limit on the number of candidates") {
+    Circuit c(6);
+    for (unsigned i = 0; i < 21; i++) {
+      for (unsigned q = 0; q < 6; q += 3) {
+        c.add_op<unsigned>(OpType::H, {q + i % 3});
+        c.add_op<unsigned>(OpType::CX, {q + i % 3, q + (i + 1) % 3});
+        c.add_op<unsigned>(OpType::Rz, 0.25, {q + (i + 1) % 3});
+      }
+    }
+    Eigen::MatrixXcd U = tket_sim::get_unitary(c);
+    Circuit c_all = c;
+    Circuit c_one = c;
+    CHECK(Transforms::three_qubit_squash().apply(c_all));
+    CHECK(Transforms::three_qubit_squash(OpType::CX, 1).apply(c_one));
+    CHECK(c_one.count_gates(OpType::CX) > c_all.count_gates(OpType::CX));
+    CHECK(c_one.count_gates(OpType::CX) < c.count_gates(OpType::CX));
+    CHECK(tket_sim::compare_statevectors_or_unitaries(
+        U, tket_sim::get_unitary(c_all)));
+    CHECK(tket_sim::compare_statevectors_or_unitaries(
+        U, tket_sim::get_unitary(c_one)));
+  }
 }
 
 SCENARIO("Special cases") {
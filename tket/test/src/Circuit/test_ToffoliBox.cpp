@@ -162,6 +162,20 @@ SCENARIO("Test ToffoliBox") {
   REQUIRE((matrix - perm_matrix).cwiseAbs().sum() < ERR_EPS);
 }
 
+SCENARIO("Test ToffoliBox with many cycles") {
+  // 128 disjoint transpositions, synthesised in parallel
+  packed_state_perm_t perm;
+  for (std::uint32_t x = 0; x < 256; x++) {
+    perm.push_back({x, x ^ 1});
+  }
+  ToffoliBox box(8, perm, ToffoliBoxSynthStrat::Cycle);
+  Circuit circ = *box.to_circuit();
+  REQUIRE(circ.count_gates(OpType::CnX) == 128);
+  const auto matrix = tket_sim::get_unitary(circ);
+  const auto perm_matrix = permutation_matrix(box.get_permutation());
+  REQUIRE((matrix - perm_matrix).cwiseAbs().sum() < ERR_EPS);
+}
+
 SCENARIO("Test ToffoliBox Exceptions") {
   GIVEN("Invalid permutation") {
     state_perm_t perm;
@@ -198,6 +212,18 @@ SCENARIO("Test ToffoliBox Exceptions") {
         ToffoliBox(perm), std::invalid_argument,
         MessageContains("up to 32 bits"));
   }
+  GIVEN("Packed states out of range") {
+    packed_state_perm_t perm = {{0, 4}, {4, 0}};
+    REQUIRE_THROWS_MATCHES(
+        ToffoliBox(2, perm), std::invalid_argument,
+        MessageContains("with different sizes"));
+  }
+  GIVEN("Repeated packed states") {
+    packed_state_perm_t perm = {{0, 1}, {0, 1}, {1, 0}, {1, 0}};
+    REQUIRE_THROWS_MATCHES(
+        ToffoliBox(1, perm), std::invalid_argument,
+        MessageContains("is not complete"));
+  }
 }
 
 SCENARIO("Test constructors & transformations") {
@@ -214,6 +240,16 @@ SCENARIO("Test constructors & transformations") {
     REQUIRE(box_copy.get_strat() == ToffoliBoxSynthStrat::Cycle);
     REQUIRE(box_copy.get_permutation() == perm);
   }
+  GIVEN("packed permutation") {
+    packed_state_perm_t packed = {{3, 2}, {1, 3}, {2, 1}};
+    ToffoliBox box(2, packed);
+    REQUIRE(box.get_permutation() == perm);
+    const packed_state_perm_t sorted = {{1, 3}, {2, 1}, {3, 2}};
+    REQUIRE(box.get_packed_permutation() == sorted);
+    REQUIRE(box == ToffoliBox(perm));
+    packed.push_back({0, 0});
+    REQUIRE(ToffoliBox(2, packed) == box);
+  }
   GIVEN("Dagger") {
     ToffoliBox box(perm);
     Circuit circ1 = *box.to_circuit();
@@ -589,5 +589,57 @@ SCENARIO("Trivial unitary matrix identities") {
   }
 }
 
+SCENARIO("Unitaries of batches of gates") {
+  // KEY: op type
+  // VALUE: number of qubits and parameters
+  const std::map<OpType, std::pair<unsigned, unsigned>> data{
+      {OpType::Rx, {1, 1}},      {OpType::Ry, {1, 1}},
+      {OpType::Rz, {1, 1}},      {OpType::PhasedX, {1, 2}},
+      {OpType::TK1, {1, 3}},     {OpType::XXPhase, {2, 1}},
+      {OpType::YYPhase, {2, 1}}, {OpType::ZZPhase, {2, 1}},
+      {OpType::TK2, {2, 3}},
+  };
+  const unsigned n_gates = 17;
+  for (const auto& entry : data) {
+    const OpType type = entry.first;
+    const unsigned n_qubits = entry.second.first;
+    const unsigned n_params = entry.second.second;
+    const unsigned dim = 1u << n_qubits;
+    Eigen::MatrixXd parameters(n_gates, n_params);
+    for (unsigned k = 0; k < n_gates; ++k) {
+      for (unsigned i = 0; i < n_params; ++i) {
+        parameters(k, i) = -3.1 + 0.37 * k + 1.13 * i + 0.01 * k * i;
+      }
+    }
+    const Eigen::MatrixXcd unitaries =
+        GateUnitaryMatrix::get_unitaries(type, parameters);
+    REQUIRE(unitaries.rows() == dim * dim);
+    REQUIRE(unitaries.cols() == n_gates);
+    for (unsigned k = 0; k < n_gates; ++k) {
+      std::vector<double> row(n_params);
+      for (unsigned i = 0; i < n_params; ++i) row[i] = parameters(k, i);
+      const Eigen::MatrixXcd expected =
+          GateUnitaryMatrix::get_unitary(type, n_qubits, row);
+      const Eigen::MatrixXcd actual =
+          Eigen::Map<const Eigen::MatrixXcd>(unitaries.col(k).data(), dim, dim);
+      CHECK(actual.isApprox(expected));
+    }
+  }
+  GIVEN("An empty batch") {
+    const Eigen::MatrixXcd unitaries =
+        GateUnitaryMatrix::get_unitaries(OpType::TK2, Eigen::MatrixXd(0, 3));
+    CHECK(unitaries.rows() == 16);
+    CHECK(unitaries.cols() == 0);
+  }
+  GIVEN("Invalid input") {
+    REQUIRE_THROWS_AS(
+        GateUnitaryMatrix::get_unitaries(OpType::TK1, Eigen::MatrixXd(4, 2)),
+        GateUnitaryMatrixError);
+    REQUIRE_THROWS_AS(
+        GateUnitaryMatrix::get_unitaries(OpType::FSim, Eigen::MatrixXd(4, 2)),
+        GateUnitaryMatrixError);
+  }
+}
+
 }  // namespace test_GateUnitaryMatrix
 }  // namespace tket
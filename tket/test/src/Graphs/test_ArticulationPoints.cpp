@@ -14,12 +14,15 @@
 
 #include <algorithm>
 #include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/connected_components.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <iostream>
+#include <tkrng/RNG.hpp>
 #include <vector>
 
 #include "tket/Architecture/Architecture.hpp"
 #include "tket/Graphs/ArticulationPoints.hpp"
+#include "tket/Graphs/DynamicArticulationPoints.hpp"
 
 namespace tket {
 namespace graphs {
@@ -169,6 +172,105 @@ SCENARIO("Test APs in Architecture", "[architectures],[routing]") {
   REQUIRE(ap.find(Node(0)) == ap.end());
 }
 
+// The number of connected components among the vertices not removed.
+static std::size_t count_components(
+    const std::vector<std::set<std::size_t>>& neighbours,
+    std::vector<bool> removed) {
+  std::size_t components = 0;
+  for (std::size_t root = 0; root < neighbours.size(); ++root) {
+    if (removed[root]) continue;
+    ++components;
+    std::vector<std::size_t> stack{root};
+    removed[root] = true;
+    while (!stack.empty()) {
+      const auto vertex = stack.back();
+      stack.pop_back();
+      for (auto neighbour : neighbours[vertex]) {
+        if (!removed[neighbour]) {
+          removed[neighbour] = true;
+          stack.push_back(neighbour);
+        }
+      }
+    }
+  }
+  return components;
+}
+
+SCENARIO("Update articulation points as vertices are removed") {
+  RNG rng;
+  for (unsigned nn = 0; nn < 100; ++nn) {
+    const std::size_t n_vertices = 2 + rng.get_size_t(30);
+    const std::size_t n_edges = rng.get_size_t(2 * n_vertices);
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    std::vector<std::set<std::size_t>> neighbours(n_vertices);
+    // A random tree (so there are many articulation points),
+    // plus some extra edges.
+    for (std::size_t v = 1; v < n_vertices; ++v) {
+      edges.emplace_back(v, rng.get_size_t(v - 1));
+    }
+    for (std::size_t i = 0; i < n_edges; ++i) {
+      edges.emplace_back(
+          rng.get_size_t(n_vertices - 1), rng.get_size_t(n_vertices - 1));
+    }
+    for (auto [v1, v2] : edges) {
+      if (v1 != v2) {
+        neighbours[v1].insert(v2);
+        neighbours[v2].insert(v1);
+      }
+    }
+    DynamicArticulationPoints dynamic_aps(n_vertices, edges);
+    std::vector<bool> removed(n_vertices, false);
+
+    for (std::size_t n_removed = 0;; ++n_removed) {
+      REQUIRE(dynamic_aps.get_number_of_vertices() == n_vertices - n_removed);
+      const auto components = count_components(neighbours, removed);
+      std::set<std::size_t> expected_aps;
+      for (std::size_t v = 0; v < n_vertices; ++v) {
+        if (removed[v]) continue;
+        auto removed_copy = removed;
+        removed_copy[v] = true;
+        // An isolated vertex's component disappears; that doesn't count.
+        const std::size_t isolated = neighbours[v].empty() ? 1 : 0;
+        if (count_components(neighbours, removed_copy) + isolated >
+            components) {
+          expected_aps.insert(v);
+        }
+      }
+      INFO("nn=" << nn << ", n_removed=" << n_removed);
+      REQUIRE(dynamic_aps.get_articulation_points() == expected_aps);
+      if (n_removed == n_vertices) break;
+
+      std::size_t v;
+      do {
+        v = rng.get_size_t(n_vertices - 1);
+      } while (removed[v]);
+      dynamic_aps.remove_vertex(v);
+      REQUIRE(!dynamic_aps.contains(v));
+      removed[v] = true;
+      for (auto neighbour : neighbours[v]) {
+        neighbours[neighbour].erase(v);
+      }
+      neighbours[v].clear();
+    }
+  }
+}
+
+SCENARIO("Remove worst nodes from an architecture") {
+  // A ring with a tail and a leaf.
+  Architecture arc(
+      {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {3, 4}, {4, 5}, {5, 6}, {2, 7}});
+  const node_set_t removed = arc.remove_worst_nodes(4);
+  REQUIRE(removed.size() == 4);
+  REQUIRE(arc.n_nodes() == 4);
+  for (const Node& node : removed) {
+    REQUIRE(!arc.node_exists(node));
+  }
+  // What remains is still connected.
+  const auto graph = arc.get_undirected_connectivity();
+  std::vector<unsigned> component(boost::num_vertices(graph));
+  REQUIRE(boost::connected_components(graph, component.data()) == 1);
+}
+
 }  // namespace test_ArticulationPoints
 }  // namespace tests
 }  // namespace graphs
@@ -0,0 +1,130 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <tkrng/RNG.hpp>
+
+#include "tket/Graphs/AdjacencyData.hpp"
+#include "tket/Graphs/CompressedAdjacencyData.hpp"
+#include "tket/Graphs/GraphColouring.hpp"
+#include "tket/Graphs/GraphRoutines.hpp"
+#include "tket/Graphs/LargeCliquesResult.hpp"
+
+using std::vector;
+
+namespace tket {
+namespace graphs {
+namespace tests {
+
+static void require_same_graph(
+    const AdjacencyData& adjacency_data,
+    const CompressedAdjacencyData& compressed_data) {
+  const std::size_t number_of_vertices =
+      adjacency_data.get_number_of_vertices();
+  REQUIRE(compressed_data.get_number_of_vertices() == number_of_vertices);
+  REQUIRE(
+      compressed_data.get_number_of_edges() ==
+      adjacency_data.get_number_of_edges());
+  for (std::size_t i = 0; i < number_of_vertices; ++i) {
+    const auto& neighbours = adjacency_data.get_neighbours(i);
+    const auto compressed_neighbours = compressed_data.get_neighbours(i);
+    REQUIRE(
+        vector<std::size_t>(neighbours.cbegin(), neighbours.cend()) ==
+        vector<std::size_t>(
+            compressed_neighbours.begin(), compressed_neighbours.end()));
+    for (std::size_t j = 0; j < number_of_vertices; ++j) {
+      REQUIRE(
+          compressed_data.edge_exists(i, j) ==
+          adjacency_data.edge_exists(i, j));
+    }
+  }
+}
+
+SCENARIO("Compressed adjacency data agrees with AdjacencyData") {
+  GIVEN("An empty graph") {
+    const CompressedAdjacencyData compressed_data(5);
+    REQUIRE(compressed_data.get_number_of_vertices() == 5);
+    REQUIRE(compressed_data.get_number_of_edges() == 0);
+    REQUIRE(compressed_data.get_neighbours(4).empty());
+    REQUIRE(!compressed_data.edge_exists(0, 1));
+    REQUIRE(CompressedAdjacencyData().get_number_of_vertices() == 0);
+  }
+  GIVEN("Random graphs, sparse and dense") {
+    RNG rng;
+    for (std::size_t number_of_vertices : {10, 40, 130}) {
+      for (std::size_t edge_percentage : {2, 10, 50, 90}) {
+        vector<std::pair<std::size_t, std::size_t>> edges;
+        AdjacencyData adjacency_data(number_of_vertices);
+        for (std::size_t i = 0; i < number_of_vertices; ++i) {
+          for (std::size_t j = i + 1; j < number_of_vertices; ++j) {
+            if (rng.check_percentage(edge_percentage)) {
+              adjacency_data.add_edge(i, j);
+              // Duplicates, in either direction, are ignored.
+              edges.emplace_back(j, i);
+              if (rng.check_percentage(20)) {
+                edges.emplace_back(i, j);
+              }
+            }
+          }
+        }
+        rng.do_shuffle(edges);
+        const CompressedAdjacencyData compressed_data(
+            number_of_vertices, edges);
+        require_same_graph(adjacency_data, compressed_data);
+        const CompressedAdjacencyData converted_data(adjacency_data);
+        require_same_graph(adjacency_data, converted_data);
+        REQUIRE(
+            compressed_data.has_bit_matrix() ==
+            converted_data.has_bit_matrix());
+        if (edge_percentage >= 50) {
+          REQUIRE(compressed_data.has_bit_matrix());
+        }
+        if (edge_percentage <= 2 && number_of_vertices >= 130) {
+          REQUIRE(!compressed_data.has_bit_matrix());
+        }
+
+        // The graph routines give identical results.
+        REQUIRE(
+            GraphRoutines::get_connected_components(compressed_data) ==
+            GraphRoutines::get_connected_components(adjacency_data));
+        if (number_of_vertices <= 10 || edge_percentage <= 2) {
+          const auto colouring =
+              GraphColouringRoutines::get_colouring(compressed_data);
+          const auto expected_colouring =
+              GraphColouringRoutines::get_colouring(adjacency_data);
+          REQUIRE(
+              colouring.number_of_colours ==
+              expected_colouring.number_of_colours);
+          REQUIRE(colouring.colours == expected_colouring.colours);
+          for (std::size_t i = 0; i < number_of_vertices; ++i) {
+            for (std::size_t j : compressed_data.get_neighbours(i)) {
+              REQUIRE(colouring.colours[i] != colouring.colours[j]);
+            }
+          }
+        }
+        std::set<std::size_t> all_vertices;
+        for (std::size_t i = 0; i < number_of_vertices; ++i) {
+          all_vertices.insert(i);
+        }
+        REQUIRE(
+            LargeCliquesResult(compressed_data, all_vertices).cliques ==
+            LargeCliquesResult(adjacency_data, all_vertices).cliques);
+      }
+    }
+  }
+}
+
+}  // namespace tests
+}  // namespace graphs
+}  // namespace tket
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "boost/range/iterator_range_core.hpp"
+#include "tket/Graphs/BitParallelBfs.hpp"
 #include "tket/Graphs/DirectedGraph.hpp"
 #include "tket/Utils/UnitID.hpp"
 
@@ -117,6 +118,49 @@ SCENARIO("Disconnected graphs") {
   }
 }
 
+SCENARIO("Distances in dense graphs use the bit matrix search") {
+  using Conn = DirectedGraph<Node>::Connection;
+  // All pairs among 80 nodes except those with i+j divisible by 3,
+  // then a path hanging off node 0, and an isolated node.
+  std::vector<Conn> edges;
+  for (unsigned i = 0; i < 80; ++i) {
+    for (unsigned j = i + 1; j < 80; ++j) {
+      if ((i + j) % 3 != 0) edges.push_back({Node(i), Node(j)});
+    }
+  }
+  edges.push_back({Node(0), Node(80)});
+  for (unsigned i = 80; i < 90; ++i) {
+    edges.push_back({Node(i + 1), Node(i)});
+  }
+  const std::size_t n_edges = edges.size();
+  REQUIRE(BitParallelBfs::is_dense(91, n_edges));
+  REQUIRE_FALSE(BitParallelBfs::is_dense(4000, 4000));
+
+  DirectedGraph<Node> graph(edges);
+  graph.add_node(Node(100));
+  // The distances from an ordinary search of the adjacency lists.
+  const auto get_bfs_distances = [&graph](const Node& node) {
+    return run_bfs(
+               graph.get_node_index(node), graph.get_undirected_connectivity())
+        .get_dists();
+  };
+  for (const Node& node : graph.get_all_nodes_vec()) {
+    REQUIRE(graph.get_distances(node) == get_bfs_distances(node));
+  }
+  CHECK(graph.get_distance(Node(90), Node(1)) == 12);
+  CHECK_THROWS_AS(
+      graph.get_distance(Node(1), Node(100)), NodesNotConnected<Node>);
+
+  const auto matrix = graph.precompute_distances(2);
+  for (const Node& node : graph.get_all_nodes_vec()) {
+    const auto dists = get_bfs_distances(node);
+    const std::size_t i = graph.get_node_index(node);
+    for (std::size_t j = 0; j < dists.size(); ++j) {
+      REQUIRE((*matrix)(i, j) == dists[j]);
+    }
+  }
+}
+
 }  // namespace test_DirectedGraph
 }  // namespace tests
 }  // namespace graphs
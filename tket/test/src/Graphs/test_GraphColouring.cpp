@@ -362,6 +362,102 @@ SCENARIO("Test Mycielski graphs") {
   test_Mycielski_graph_sequence(graph, 2, 9);
 }
 
+// Disjoint copies of Mycielski graphs, so there are several components
+// (with different chromatic numbers) to colour.
+static AdjacencyData get_disjoint_Mycielski_graphs() {
+  vector<AdjacencyData> graphs;
+  graphs.emplace_back(2);
+  graphs.back().add_edge(0, 1);
+  for (int nn = 0; nn < 5; ++nn) {
+    graphs.push_back(get_Mycielski_graph(graphs.back()));
+  }
+  std::size_t number_of_vertices = 0;
+  for (const auto& graph : graphs) {
+    number_of_vertices += graph.get_number_of_vertices();
+  }
+  AdjacencyData result(number_of_vertices);
+  std::size_t offset = 0;
+  for (const auto& graph : graphs) {
+    for (std::size_t ii = 0; ii < graph.get_number_of_vertices(); ++ii) {
+      for (std::size_t jj : graph.get_neighbours(ii)) {
+        result.add_edge(offset + ii, offset + jj);
+      }
+    }
+    offset += graph.get_number_of_vertices();
+  }
+  return result;
+}
+
+SCENARIO("Parallel, time-limited, greedy and incremental colourings") {
+  const auto graph = get_disjoint_Mycielski_graphs();
+  const auto serial_colouring = GraphColouringRoutines::get_colouring(graph);
+  GraphTestingRoutines::require_valid_suboptimal_colouring(
+      serial_colouring, graph);
+  // The largest copy is the 7th graph in the sequence.
+  CHECK(serial_colouring.number_of_colours == 7);
+
+  GraphColouringOptions options;
+  options.number_of_threads = 4;
+  const auto parallel_colouring =
+      GraphColouringRoutines::get_colouring(graph, options);
+  GraphTestingRoutines::require_valid_suboptimal_colouring(
+      parallel_colouring, graph);
+  CHECK(parallel_colouring.number_of_colours == 7);
+
+  // With no time at all, every component is coloured greedily.
+  options.timeout_ms = 0;
+  for (options.number_of_threads = 1; options.number_of_threads <= 2;
+       ++options.number_of_threads) {
+    const auto rushed_colouring =
+        GraphColouringRoutines::get_colouring(graph, options);
+    GraphTestingRoutines::require_valid_suboptimal_colouring(
+        rushed_colouring, graph);
+    CHECK(rushed_colouring.number_of_colours >= 7);
+  }
+  const auto greedy_colouring =
+      GraphColouringRoutines::get_greedy_colouring(graph);
+  GraphTestingRoutines::require_valid_suboptimal_colouring(
+      greedy_colouring, graph);
+  CHECK(greedy_colouring.number_of_colours >= 7);
+
+  // Add a new vertex, and some edges which may clash.
+  AdjacencyData new_graph(graph.get_number_of_vertices() + 1);
+  for (std::size_t ii = 0; ii < graph.get_number_of_vertices(); ++ii) {
+    for (std::size_t jj : graph.get_neighbours(ii)) {
+      new_graph.add_edge(ii, jj);
+    }
+  }
+  const std::size_t new_vertex = graph.get_number_of_vertices();
+  const vector<std::pair<std::size_t, std::size_t>> new_edges{
+      {0, 2}, {1, 3}, {0, new_vertex}, {5, new_vertex}, {10, 40}};
+  for (const auto& edge : new_edges) {
+    new_graph.add_edge(edge.first, edge.second);
+  }
+  const auto updated_colouring = GraphColouringRoutines::update_colouring(
+      new_graph, serial_colouring.colours);
+  GraphTestingRoutines::require_valid_suboptimal_colouring(
+      updated_colouring, new_graph);
+  REQUIRE(updated_colouring.number_of_colours >= 7);
+  // Every colour class is large, so none is lost, and at most
+  // one vertex per new edge is recoloured.
+  std::size_t number_of_changes = 0;
+  for (std::size_t ii = 0; ii < graph.get_number_of_vertices(); ++ii) {
+    if (updated_colouring.colours[ii] != serial_colouring.colours[ii]) {
+      ++number_of_changes;
+    }
+  }
+  CHECK(number_of_changes <= new_edges.size());
+
+  // Remove vertices again (keeping only the first ones);
+  // the old colouring is still valid for the smaller graph.
+  const AdjacencyData small_graph(3);
+  const auto small_colouring = GraphColouringRoutines::update_colouring(
+      small_graph, updated_colouring.colours);
+  GraphTestingRoutines::require_valid_suboptimal_colouring(
+      small_colouring, small_graph);
+  CHECK(small_colouring.number_of_colours <= 3);
+}
+
 }  // namespace tests
 }  // namespace graphs
 }  // namespace tket
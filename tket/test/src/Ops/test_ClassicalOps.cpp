@@ -16,6 +16,7 @@
 
 #include "../testutil.hpp"
 #include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Conditional.hpp"
 #include "tket/Ops/ClassicalOps.hpp"
 #include "tket/Transformations/BasicOptimisation.hpp"
 #include "tket/Transformations/CliffordOptimisation.hpp"
@@ -526,6 +527,72 @@ SCENARIO("Pure classical operations") {
     REQUIRE(!y[0]);
     REQUIRE(y[1]);
   }
+  GIVEN("A classical circuit to evaluate") {
+    Circuit circ(0, 7);
+    circ.add_op<unsigned>(
+        std::make_shared<MultiBitOp>(AndOp(), 2), {0, 1, 2, 3, 4, 5});
+    circ.add_op<unsigned>(std::make_shared<CopyBitsOp>(1), {5, 6});
+    circ.add_op<unsigned>(
+        std::make_shared<Conditional>(XorWithOp(), 1, 1), {2, 0, 6});
+    circ.add_op<unsigned>(
+        std::make_shared<Conditional>(ClassicalX(), 1, 0), {2, 3});
+    for (unsigned n = 0; n < 16; n++) {
+      std::map<Bit, bool> values;
+      for (unsigned i = 0; i < 7; i++) values[Bit(i)] = false;
+      values[Bit(0)] = n & 1;
+      values[Bit(1)] = (n >> 1) & 1;
+      values[Bit(3)] = (n >> 2) & 1;
+      values[Bit(4)] = (n >> 3) & 1;
+      std::map<Bit, bool> out = circ.classical_eval(values);
+      const bool and0 = values[Bit(0)] && values[Bit(1)];
+      const bool and1 = values[Bit(3)] && values[Bit(4)];
+      REQUIRE(out[Bit(2)] == and0);
+      REQUIRE(out[Bit(5)] == and1);
+      REQUIRE(out[Bit(6)] == (and0 ? (values[Bit(0)] != and1) : and1));
+      REQUIRE(out[Bit(3)] == (and0 ? values[Bit(3)] : !values[Bit(3)]));
+    }
+  }
+  GIVEN("A classical circuit to evaluate on all inputs at once") {
+    // Bits 0-9 are inputs, bits 10-13 start at zero.
+    Circuit circ(0, 14);
+    circ.add_op<unsigned>(ClassicalCX(), {0, 1});
+    circ.add_op<unsigned>(
+        std::make_shared<RangePredicateOp>(3, 2, 5), {1, 2, 3, 10});
+    circ.add_op<unsigned>(
+        std::make_shared<MultiBitOp>(OrOp(), 2), {4, 5, 11, 6, 7, 12});
+    circ.add_op<unsigned>(XorWithOp(), {10, 8});
+    circ.add_op<unsigned>(
+        std::make_shared<Conditional>(
+            std::make_shared<SetBitsOp>(std::vector<bool>{1, 0}), 2, 2),
+        {11, 12, 9, 13});
+    circ.add_op<unsigned>(
+        std::make_shared<Conditional>(AndOp(), 1, 1), {9, 0, 2, 12});
+    circ.add_op<unsigned>(std::make_shared<CopyBitsOp>(1), {8, 4});
+    const unsigned n_inputs = 1u << 10;
+    std::map<Bit, std::vector<uint64_t>> sliced;
+    for (unsigned i = 0; i < 10; i++) {
+      std::vector<uint64_t> words(n_inputs / 64, 0);
+      for (unsigned n = 0; n < n_inputs; n++) {
+        if ((n >> i) & 1) words[n / 64] |= uint64_t{1} << (n % 64);
+      }
+      sliced[Bit(i)] = words;
+    }
+    std::map<Bit, std::vector<uint64_t>> sliced_out =
+        circ.classical_eval_sliced(sliced);
+    REQUIRE(sliced_out.size() == 14);
+    for (unsigned n = 0; n < n_inputs; n++) {
+      std::map<Bit, bool> values;
+      for (unsigned i = 0; i < 14; i++) values[Bit(i)] = (n >> i) & 1;
+      std::map<Bit, bool> out = circ.classical_eval(values);
+      for (unsigned i = 0; i < 14; i++) {
+        const bool lane = (sliced_out[Bit(i)][n / 64] >> (n % 64)) & 1;
+        REQUIRE(lane == out[Bit(i)]);
+      }
+    }
+    REQUIRE_THROWS_AS(
+        circ.classical_eval_sliced({{Bit(0), {0}}, {Bit(1), {0, 0}}}),
+        std::invalid_argument);
+  }
 }
 
 }  // namespace test_ClassicalOps
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
 
 #include "../testutil.hpp"
 #include "tket/Utils/Expression.hpp"
@@ -62,6 +63,33 @@ SCENARIO("Basic Expr evaluation", "[ops]") {
   }
 }
 
+SCENARIO("Numeric angle checks", "[ops]") {
+  GIVEN("Values close to zero") {
+    REQUIRE(equiv_0(0.));
+    REQUIRE(equiv_0(2.));
+    REQUIRE(equiv_0(-4. + 1e-12, 4));
+    REQUIRE(equiv_0(3.999999999999, 4));
+    REQUIRE_FALSE(equiv_0(2., 4));
+    REQUIRE_FALSE(equiv_0(0.1));
+    REQUIRE_FALSE(equiv_0(std::nan("")));
+  }
+  GIVEN("Clifford angles") {
+    REQUIRE(equiv_Clifford(0.5) == 1u);
+    REQUIRE(equiv_Clifford(-0.5) == 3u);
+    REQUIRE(equiv_Clifford(3.5, 4) == 7u);
+    REQUIRE(equiv_Clifford(1.0000000000001) == 2u);
+    REQUIRE_FALSE(equiv_Clifford(0.3));
+  }
+  GIVEN("Agreement with expressions") {
+    for (double x : {-3.75, -1., -0.25, 0., 0.1, 0.5, 1.5, 2.25, 7.}) {
+      for (unsigned n : {1u, 2u, 4u}) {
+        CHECK(equiv_0(x, n) == equiv_0(Expr(x), n));
+        CHECK(equiv_Clifford(x, n) == equiv_Clifford(Expr(x), n));
+      }
+    }
+  }
+}
+
 SCENARIO("Expression uniqueness", "[ops]") {
   GIVEN("Two equivalent constants") {
     Expr a(0.5);
@@ -95,5 +123,57 @@ SCENARIO("Expression uniqueness", "[ops]") {
   }
 }
 
+SCENARIO("Parsing expressions from strings", "[ops]") {
+  GIVEN("Strings read directly") {
+    for (const std::string str :
+         {"0", "3", "-12", "123456789", "0.5", "-0.25", "1.0", "-0.0",
+          "3.141592653589"}) {
+      Expr e = expr_from_string(str);
+      Expr parsed(str);
+      REQUIRE(e == parsed);
+      REQUIRE(ExprPtr(e)->get_type_code() == ExprPtr(parsed)->get_type_code());
+    }
+  }
+  GIVEN("Strings passed to the parser") {
+    for (const std::string str :
+         {"1234567890", "010", "1/2", "a", "-0.5*a", "sin(0.5)",
+          "0.12345678901234567"}) {
+      REQUIRE(expr_from_string(str) == Expr(str));
+    }
+  }
+  GIVEN("Serialised expressions") {
+    for (const Expr& e : {Expr(0.3), Expr(2), Expr(-1.5), Expr("a") * 0.5}) {
+      nlohmann::json j = e;
+      REQUIRE(j.get<Expr>() == e);
+    }
+  }
+}
+
+SCENARIO("Expanding expressions", "[ops]") {
+  Sym asym = SymEngine::symbol("a");
+  Sym bsym = SymEngine::symbol("b");
+  Expr a(asym);
+  Expr b(bsym);
+  GIVEN("Symbolic expressions") {
+    for (const Expr& e : {(a + b) * (a - b), 2 * (a + 1) - a, a * a, a}) {
+      Expr expanded = expand_expr(e);
+      REQUIRE(expanded == SymEngine::expand(e));
+      // Again, from the cache.
+      REQUIRE(expand_expr(e) == expanded);
+    }
+    REQUIRE(expand_expr((a + b) * (a - b) - a * a + b * b) == 0);
+  }
+  GIVEN("Numbers") {
+    REQUIRE(expand_expr(Expr(0.5)) == 0.5);
+    REQUIRE(expand_expr(Expr(3) * 2) == 6);
+  }
+  GIVEN("More expressions than the cache holds") {
+    for (std::size_t i = 0; i < max_expand_cache_size + 10; ++i) {
+      Expr e = (a + int(i)) * (a - int(i));
+      REQUIRE(expand_expr(e) == a * a - int(i * i));
+    }
+  }
+}
+
 }  // namespace test_Expression
 }  // namespace tket
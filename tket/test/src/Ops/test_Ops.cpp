@@ -14,7 +14,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <optional>
+#include <set>
 #include <stdexcept>
+#include <thread>
 #include <unsupported/Eigen/MatrixFunctions>
 
 #include "../testutil.hpp"
@@ -36,7 +38,7 @@
 namespace tket {
 namespace test_Ops {
 
-void clear_symbol_table() { SymTable::get_registered_symbols().clear(); }
+void clear_symbol_table() { SymTable::clear(); }
 
 SCENARIO("Check op retrieval overloads are working correctly.", "[ops]") {
   GIVEN("Transposes retrieval at the Op level") {
@@ -299,6 +301,63 @@ SCENARIO("Check op retrieval overloads are working correctly.", "[ops]") {
   }
 }
 
+SCENARIO("Sharing gate instances") {
+  GIVEN("Parameterless gates") {
+    REQUIRE(get_op_ptr(OpType::H) == get_op_ptr(OpType::H));
+    REQUIRE(get_op_ptr(OpType::CX) != get_op_ptr(OpType::CZ));
+    REQUIRE(
+        get_op_ptr(OpType::CnX, std::vector<Expr>{}, 3) !=
+        get_op_ptr(OpType::CnX, std::vector<Expr>{}, 4));
+    REQUIRE(get_op_ptr(OpType::CnX, std::vector<Expr>{}, 4)->n_qubits() == 4);
+  }
+  GIVEN("Gates with numeric parameters") {
+    REQUIRE(get_op_ptr(OpType::Rz, 0.5) == get_op_ptr(OpType::Rz, 0.5));
+    REQUIRE(get_op_ptr(OpType::Rz, 0.5) != get_op_ptr(OpType::Rx, 0.5));
+    // Parameters are compared exactly
+    Op_ptr half = get_op_ptr(OpType::Rz, Expr(1) / 2);
+    REQUIRE(half->get_params()[0] == Expr(1) / 2);
+    REQUIRE(get_op_ptr(OpType::Rz, 0.5)->get_params()[0] == Expr(0.5));
+  }
+  GIVEN("Gates with symbolic parameters") {
+    Sym a = SymEngine::symbol("a");
+    Op_ptr op0 = get_op_ptr(OpType::Rz, Expr(a));
+    Op_ptr op1 = get_op_ptr(OpType::Rz, Expr(a));
+    REQUIRE(op0 != op1);
+    REQUIRE(*op0 == *op1);
+  }
+}
+
+SCENARIO("Numeric gate parameters") {
+  GIVEN("Numeric parameters") {
+    Gate_ptr g = as_gate_ptr(get_op_ptr(
+        OpType::TK1, std::vector<Expr>{0.5, Expr(1) / 4, 2}));
+    REQUIRE(g->has_numeric_params());
+    REQUIRE(g->get_numeric_params() == std::vector<double>{0.5, 0.25, 2.});
+    REQUIRE(as_gate_ptr(get_op_ptr(OpType::H))->has_numeric_params());
+  }
+  GIVEN("Symbolic parameters") {
+    Sym a = SymEngine::symbol("a");
+    Gate_ptr g = as_gate_ptr(get_op_ptr(OpType::Rz, Expr(a)));
+    REQUIRE_FALSE(g->has_numeric_params());
+    REQUIRE_THROWS_AS(g->get_numeric_params(), SymbolsNotSupported);
+    // Constants are not numbers, so are evaluated symbolically
+    g = as_gate_ptr(get_op_ptr(OpType::Rz, Expr(SymEngine::pi)));
+    REQUIRE_FALSE(g->has_numeric_params());
+  }
+  GIVEN("Identities and Clifford gates") {
+    REQUIRE(get_op_ptr(OpType::Rx, 4.)->is_identity() == 0.);
+    REQUIRE(get_op_ptr(OpType::Rx, 2.)->is_identity() == 1.);
+    REQUIRE_FALSE(get_op_ptr(OpType::Rx, 0.3)->is_identity());
+    Op_ptr tk2 = get_op_ptr(OpType::TK2, std::vector<Expr>{2., 0., 4.});
+    REQUIRE(tk2->is_identity() == 1.);
+    REQUIRE(get_op_ptr(OpType::Phase, 0.3)->is_identity() == 0.3);
+    Op_ptr tk1 = get_op_ptr(OpType::TK1, std::vector<Expr>{0.5, 1.5, -0.5});
+    REQUIRE(tk1->is_clifford());
+    Op_ptr fsim = get_op_ptr(OpType::FSim, std::vector<Expr>{0.5, 0.25});
+    REQUIRE_FALSE(fsim->is_clifford());
+  }
+}
+
 SCENARIO("Examples for is_singleq_unitary") {
   GIVEN("Some true positives") {
     REQUIRE((get_op_ptr(OpType::Z))->get_desc().is_singleq_unitary());
@@ -559,6 +618,30 @@ SCENARIO("Check that fresh_symbol actually gives a unique symbol") {
     Sym x1 = SymTable::fresh_symbol("x");
     REQUIRE(x1->get_name() == "x_1");
   }
+  GIVEN("Fresh symbols requested from several threads") {
+    std::vector<std::vector<Sym>> syms(4);
+    std::vector<std::thread> workers;
+    for (std::vector<Sym> &s : syms) {
+      workers.emplace_back([&s]() {
+        for (unsigned i = 0; i < 100; ++i) {
+          s.push_back(SymTable::fresh_symbol("t"));
+        }
+      });
+    }
+    for (std::thread &worker : workers) worker.join();
+    std::set<std::string> names;
+    for (const std::vector<Sym> &s : syms) {
+      for (const Sym &sym : s) names.insert(sym->get_name());
+    }
+    REQUIRE(names.size() == 400);
+  }
+  GIVEN("Interned symbols") {
+    Sym y = SymTable::intern("y");
+    REQUIRE(SymTable::intern("y").get() == y.get());
+    REQUIRE(SymTable::fresh_symbol("y")->get_name() == "y_1");
+    Sym z = SymTable::fresh_symbol("z");
+    REQUIRE(SymTable::intern("z").get() == z.get());
+  }
 }
 
 SCENARIO("Custom Gates") {
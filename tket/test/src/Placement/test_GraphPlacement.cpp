@@ -12,8 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
 #include <random>
+#include <set>
 
 #include "../testutil.hpp"
 #include "tket/Placement/Placement.hpp"
@@ -290,6 +293,190 @@ SCENARIO("Base GraphPlacement class") {
       REQUIRE(pmap[Qubit(4)] == Node(4));
     }
   }
+  GIVEN("A multi-threaded search.") {
+    SquareGrid architecture(3, 4);
+    Circuit circuit(6);
+    add_2qb_gates(
+        circuit, OpType::CX,
+        {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 0}, {0, 3}, {1, 4}});
+    GraphPlacement sequential(architecture, 1000, 200000);
+    GraphPlacement parallel(architecture, 1000, 200000, 100, 100, 4);
+    REQUIRE(sequential.get_search_threads() == 1);
+    REQUIRE(parallel.get_search_threads() == 4);
+    std::vector<std::map<Qubit, Node>> sequential_maps =
+        sequential.get_all_placement_maps(circuit, 1000);
+    std::vector<std::map<Qubit, Node>> parallel_maps =
+        parallel.get_all_placement_maps(circuit, 1000);
+    REQUIRE(!parallel_maps.empty());
+    REQUIRE(parallel_maps.size() == sequential_maps.size());
+    std::set<std::map<Qubit, Node>> sequential_set(
+        sequential_maps.begin(), sequential_maps.end());
+    std::set<std::map<Qubit, Node>> parallel_set(
+        parallel_maps.begin(), parallel_maps.end());
+    REQUIRE(parallel_set == sequential_set);
+
+    Placement::Ptr placement_ptr = std::make_shared<GraphPlacement>(parallel);
+    nlohmann::json j = placement_ptr;
+    Placement::Ptr loaded = j.get<Placement::Ptr>();
+    REQUIRE(
+        std::dynamic_pointer_cast<GraphPlacement>(loaded)
+            ->get_search_threads() == 4);
+  }
+  GIVEN("Repeated placements reusing target graph data.") {
+    SquareGrid architecture(3, 3);
+    GraphPlacement placement(architecture, 1000, 200000);
+    Circuit circuit(5);
+    add_2qb_gates(
+        circuit, OpType::CX, {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 0}, {1, 3}});
+    Circuit other_circuit(4);
+    add_2qb_gates(other_circuit, OpType::CX, {{0, 1}, {1, 2}, {2, 3}, {3, 0}});
+    std::vector<std::map<Qubit, Node>> maps =
+        placement.get_all_placement_maps(circuit, 1000);
+    std::vector<std::map<Qubit, Node>> other_maps =
+        placement.get_all_placement_maps(other_circuit, 1000);
+    REQUIRE(!maps.empty());
+    REQUIRE(!other_maps.empty());
+    // Fresh placers must agree with the one whose cache is already filled.
+    REQUIRE(
+        placement.get_all_placement_maps(circuit, 1000) ==
+        GraphPlacement(architecture, 1000, 200000)
+            .get_all_placement_maps(circuit, 1000));
+    REQUIRE(placement.get_all_placement_maps(circuit, 1000) == maps);
+    REQUIRE(
+        placement.get_all_placement_maps(other_circuit, 1000) == other_maps);
+  }
+  GIVEN("Warm started placements.") {
+    SquareGrid architecture(3, 3);
+    GraphPlacement placement(architecture, 1000, 200000);
+    Circuit circuit(6);
+    add_2qb_gates(
+        circuit, OpType::CX, {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {3, 4}});
+    std::vector<std::map<Qubit, Node>> cold_maps =
+        placement.get_all_placement_maps(circuit, 1000);
+    REQUIRE(!cold_maps.empty());
+    std::map<Qubit, Node> previous_map =
+        placement.get_placement_map(circuit);
+
+    // Nothing has changed: the previous map is still good.
+    std::vector<std::map<Qubit, Node>> warm_maps =
+        placement.get_warm_start_placement_maps(circuit, previous_map, 1000);
+    REQUIRE(!warm_maps.empty());
+    REQUIRE(warm_maps.size() <= cold_maps.size());
+    for (const std::map<Qubit, Node>& map : warm_maps) {
+      REQUIRE(std::find(cold_maps.begin(), cold_maps.end(), map) !=
+              cold_maps.end());
+    }
+
+    // Add an interaction with a previously idle qubit.
+    Circuit changed_circuit = circuit;
+    add_2qb_gates(changed_circuit, OpType::CX, {{4, 5}});
+    warm_maps = placement.get_warm_start_placement_maps(
+        changed_circuit, previous_map, 1000);
+    REQUIRE(!warm_maps.empty());
+    for (const std::map<Qubit, Node>& map : warm_maps) {
+      std::set<Node> nodes;
+      for (const auto& [qubit, node] : map) {
+        REQUIRE(architecture.node_exists(node));
+        REQUIRE(nodes.insert(node).second);
+      }
+    }
+    // An empty previous map is simply a cold start.
+    REQUIRE(
+        placement.get_warm_start_placement_maps(changed_circuit, {}, 1000) ==
+        placement.get_all_placement_maps(changed_circuit, 1000));
+  }
+  GIVEN("Streamed placement candidates.") {
+    SquareGrid architecture(3, 3);
+    Circuit circuit(5);
+    add_2qb_gates(
+        circuit, OpType::CX, {{0, 1}, {1, 2}, {2, 3}, {3, 0}, {1, 4}});
+    GraphPlacement placement(architecture, 1000, 200000);
+    std::vector<std::map<Qubit, Node>> all_maps =
+        placement.get_all_placement_maps(circuit, 1000);
+    REQUIRE(all_maps.size() > 5);
+    // Keeping fewer candidates gives the best ones, in the same order.
+    for (unsigned matches : {1, 2, 5}) {
+      std::vector<std::map<Qubit, Node>> maps =
+          placement.get_all_placement_maps(circuit, matches);
+      REQUIRE(maps.size() == matches);
+      REQUIRE(std::equal(maps.begin(), maps.end(), all_maps.begin()));
+    }
+    REQUIRE(placement.get_placement_map(circuit) == all_maps[0]);
+
+    QubitGraph q_graph;
+    for (unsigned ii = 0; ii < 4; ++ii) {
+      q_graph.add_connection(Qubit(ii), Qubit((ii + 1) % 4), 1);
+    }
+    QubitGraph::UndirectedConnGraph pattern_graph =
+        q_graph.get_undirected_connectivity();
+    Architecture::UndirectedConnGraph target_graph =
+        architecture.get_undirected_connectivity();
+    std::vector<boost::bimap<Qubit, Node>> bimaps =
+        get_weighted_subgraph_monomorphisms(
+            pattern_graph, target_graph, 1000, 200000, false);
+    REQUIRE(bimaps.size() > 2);
+    std::set<boost::bimap<Qubit, Node>> streamed_bimaps;
+    REQUIRE(
+        for_each_weighted_subgraph_monomorphism(
+            pattern_graph, target_graph, 1000, 200000,
+            [&](const boost::bimap<Qubit, Node>& bimap, std::uint64_t) {
+              REQUIRE(streamed_bimaps.insert(bimap).second);
+              return true;
+            }) == bimaps.size());
+    REQUIRE(
+        streamed_bimaps ==
+        std::set<boost::bimap<Qubit, Node>>(bimaps.begin(), bimaps.end()));
+    // The callback can stop the search.
+    REQUIRE(
+        for_each_weighted_subgraph_monomorphism(
+            pattern_graph, target_graph, 1000, 200000,
+            [](const boost::bimap<Qubit, Node>&, std::uint64_t) {
+              return false;
+            }) == 1);
+  }
+  GIVEN("Pattern graphs weighted in a single pass with depth decay.") {
+    std::vector<std::pair<unsigned, unsigned>> edges = {{0, 1}};
+    Architecture small_architecture(edges);
+    REQUIRE_THROWS_AS(
+        GraphPlacement(small_architecture, 2000, 100, 100, 100, 1, 1.0),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        GraphPlacement(small_architecture, 2000, 100, 100, 100, 1, -0.5),
+        std::invalid_argument);
+    SquareGrid architecture(3, 3);
+    // A line of qubits, with conditional gates and a barrier.
+    Circuit circuit(6, 1);
+    add_2qb_gates(circuit, OpType::CX, {{0, 1}, {1, 2}, {2, 3}});
+    circuit.add_measure(0, 0);
+    circuit.add_conditional_gate<unsigned>(OpType::CZ, {}, {3, 4}, {0}, 1);
+    circuit.add_barrier({0, 1, 2, 3, 4, 5});
+    add_2qb_gates(circuit, OpType::CX, {{4, 5}, {3, 4}});
+    GraphPlacement placement(architecture, 1000, 200000, 1000, 1000, 1, 0.9);
+    REQUIRE(placement.get_pattern_depth_decay() == 0.9);
+    std::map<Qubit, Node> map = placement.get_placement_map(circuit);
+    REQUIRE(map.size() == 6);
+    for (unsigned i = 0; i < 5; ++i) {
+      REQUIRE(
+          (architecture.edge_exists(map[Qubit(i)], map[Qubit(i + 1)]) ||
+           architecture.edge_exists(map[Qubit(i + 1)], map[Qubit(i)])));
+    }
+    // A zero decay keeps the slice weighting.
+    GraphPlacement sliced(architecture, 1000, 200000, 1000, 1000);
+    REQUIRE(sliced.get_pattern_depth_decay() == 0);
+
+    Placement::Ptr placement_ptr = std::make_shared<GraphPlacement>(placement);
+    nlohmann::json j = placement_ptr;
+    Placement::Ptr loaded = j.get<Placement::Ptr>();
+    REQUIRE(
+        std::dynamic_pointer_cast<GraphPlacement>(loaded)
+            ->get_pattern_depth_decay() == 0.9);
+    REQUIRE(loaded->get_placement_map(circuit) == map);
+
+    // Three qubit gates are rejected, as for the slice weighting.
+    circuit.add_op<unsigned>(OpType::CCX, {0, 1, 2});
+    REQUIRE_THROWS_AS(
+        placement.get_placement_map(circuit), std::invalid_argument);
+  }
   GIVEN("A Circuit with a Barrier.") {
     Circuit circuit(3, 3);
     std::vector<std::pair<unsigned, unsigned>> edges = {{0, 1}, {1, 2}};
@@ -0,0 +1,117 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+
+#include "../testutil.hpp"
+#include "tket/Placement/Placement.hpp"
+
+namespace tket {
+SCENARIO("HierarchicalPlacement class") {
+  GIVEN("A grid Architecture split into regions.") {
+    SquareGrid architecture(10, 12);
+    HierarchicalPlacement placement(architecture, 30);
+    const std::vector<node_vector_t>& regions = placement.get_regions();
+    std::set<Node> covered;
+    for (const node_vector_t& region : regions) {
+      REQUIRE(!region.empty());
+      REQUIRE(region.size() <= 30);
+      for (const Node& node : region) {
+        REQUIRE(covered.insert(node).second);
+      }
+    }
+    REQUIRE(covered.size() == architecture.n_nodes());
+    REQUIRE_THROWS_AS(
+        HierarchicalPlacement(architecture, 0), std::invalid_argument);
+  }
+  GIVEN("A clustered Circuit on a grid Architecture.") {
+    SquareGrid architecture(10, 12);
+    // Four clusters of ten qubits, each a ring with a chord, joined in a
+    // chain by single interactions.
+    Circuit circuit(40);
+    for (unsigned cluster = 0; cluster < 4; ++cluster) {
+      const unsigned first = 10 * cluster;
+      for (unsigned i = 0; i < 10; ++i) {
+        circuit.add_op<unsigned>(
+            OpType::CX, {first + i, first + (i + 1) % 10});
+      }
+      circuit.add_op<unsigned>(OpType::CX, {first, first + 5});
+      if (cluster > 0) {
+        circuit.add_op<unsigned>(OpType::CX, {first - 1, first});
+      }
+    }
+    HierarchicalPlacement sequential(architecture, 30, 100, 60000);
+    std::vector<std::map<Qubit, Node>> maps =
+        sequential.get_all_placement_maps(circuit, 1);
+    REQUIRE(maps.size() == 1);
+    const std::map<Qubit, Node>& map = maps[0];
+    REQUIRE(map.size() == 40);
+    std::set<Node> image;
+    for (const auto& [qubit, node] : map) {
+      REQUIRE(architecture.node_exists(node));
+      REQUIRE(image.insert(node).second);
+    }
+    HierarchicalPlacement parallel(architecture, 30, 100, 60000, 100, 100, 4);
+    REQUIRE(parallel.get_all_placement_maps(circuit, 1)[0] == map);
+
+    Circuit placed = circuit;
+    REQUIRE(sequential.place(placed));
+    for (const Qubit& qubit : placed.all_qubits()) {
+      REQUIRE(architecture.node_exists(Node(qubit)));
+    }
+  }
+  GIVEN("A Circuit on an Architecture smaller than a region.") {
+    std::vector<std::pair<unsigned, unsigned>> edges = {
+        {0, 1}, {1, 2}, {2, 3}};
+    Architecture architecture(edges);
+    HierarchicalPlacement placement(architecture);
+    REQUIRE(placement.get_regions().size() == 1);
+    Circuit circuit(3);
+    circuit.add_op<unsigned>(OpType::CX, {0, 1});
+    circuit.add_op<unsigned>(OpType::CX, {1, 2});
+    std::map<Qubit, Node> map = placement.get_placement_map(circuit);
+    REQUIRE(map.size() == 3);
+    REQUIRE(architecture.valid_operation(
+        {map.at(Qubit(0)), map.at(Qubit(1))}));
+    REQUIRE(architecture.valid_operation(
+        {map.at(Qubit(1)), map.at(Qubit(2))}));
+  }
+  GIVEN("A Circuit with more qubits than the Architecture has Nodes.") {
+    std::vector<std::pair<unsigned, unsigned>> edges = {{0, 1}};
+    Architecture architecture(edges);
+    HierarchicalPlacement placement(architecture);
+    Circuit circuit(3);
+    REQUIRE_THROWS_AS(
+        placement.get_all_placement_maps(circuit, 1), std::invalid_argument);
+  }
+  GIVEN("Serialization.") {
+    SquareGrid architecture(4, 4);
+    Placement::Ptr placement_ptr = std::make_shared<HierarchicalPlacement>(
+        architecture, 8, 50, 200, 20, 30, 2);
+    nlohmann::json j = placement_ptr;
+    REQUIRE(j.at("type") == "HierarchicalPlacement");
+    Placement::Ptr loaded = j.get<Placement::Ptr>();
+    std::shared_ptr<HierarchicalPlacement> hierarchical =
+        std::dynamic_pointer_cast<HierarchicalPlacement>(loaded);
+    REQUIRE(hierarchical);
+    REQUIRE(hierarchical->get_region_size() == 8);
+    REQUIRE(hierarchical->get_maximum_matches() == 50);
+    REQUIRE(hierarchical->get_timeout() == 200);
+    REQUIRE(hierarchical->get_maximum_pattern_gates() == 20);
+    REQUIRE(hierarchical->get_maximum_pattern_depth() == 30);
+    REQUIRE(hierarchical->get_threads() == 2);
+  }
+}
+}  // namespace tket
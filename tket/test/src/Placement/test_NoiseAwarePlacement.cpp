@@ -408,5 +408,58 @@ SCENARIO("Base NoiseAwarePlacement class") {
     REQUIRE(map[Qubit(4)] == Node(1));
     REQUIRE(map[Qubit(5)] == Node(2));
   }
+  GIVEN("Costing placement maps with several threads.") {
+    SquareGrid architecture(4, 5);
+    std::mt19937 engine(7);
+    std::uniform_real_distribution<double> dist(0.0, 0.1);
+    avg_node_errors_t node_errors;
+    avg_readout_errors_t readout_errors;
+    for (const Node& node : architecture.get_all_nodes_vec()) {
+      node_errors[node] = dist(engine);
+      if (engine() % 2 == 0) {
+        readout_errors[node] = dist(engine);
+      }
+    }
+    avg_link_errors_t link_errors;
+    for (const auto& [n0, n1] : architecture.get_all_edges_vec()) {
+      // Just a few distinct values, so that there are ties.
+      link_errors[{n0, n1}] = 0.01 * (engine() % 3);
+      link_errors[{n1, n0}] = 0.01 * (engine() % 3);
+    }
+    Circuit circuit(6, 1);
+    add_2qb_gates(
+        circuit, OpType::CX,
+        {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {0, 1}, {2, 3}});
+    circuit.add_measure(Qubit(0), Bit(0));
+    NoiseAwarePlacement sequential(
+        architecture, node_errors, link_errors, readout_errors, 2000, 200000);
+    NoiseAwarePlacement parallel(
+        architecture, node_errors, link_errors, readout_errors, 2000, 200000,
+        100, 100, 4);
+    REQUIRE(parallel.get_search_threads() == 4);
+    std::vector<std::map<Qubit, Node>> sequential_maps =
+        sequential.get_all_placement_maps(circuit, 1000);
+    REQUIRE(!sequential_maps.empty());
+    REQUIRE(parallel.get_all_placement_maps(circuit, 1000) == sequential_maps);
+    REQUIRE(
+        parallel.get_placement_map(circuit) ==
+        sequential.get_placement_map(circuit));
+
+    // The costs follow changes in the characterisation.
+    DeviceCharacterisation uniform(avg_node_errors_t{}, avg_link_errors_t{});
+    parallel.set_characterisation(uniform);
+    sequential.set_characterisation(uniform);
+    REQUIRE(
+        parallel.get_all_placement_maps(circuit, 1000) ==
+        sequential.get_all_placement_maps(circuit, 1000));
+
+    Placement::Ptr placement_ptr =
+        std::make_shared<NoiseAwarePlacement>(parallel);
+    nlohmann::json j = placement_ptr;
+    Placement::Ptr loaded = j.get<Placement::Ptr>();
+    REQUIRE(
+        std::dynamic_pointer_cast<NoiseAwarePlacement>(loaded)
+            ->get_search_threads() == 4);
+  }
 }
 }  // namespace tket
\ No newline at end of file
@@ -18,16 +18,23 @@
 #include <catch2/catch_approx.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <numeric>
+#include <thread>
+#include <tuple>
 
 #include "../Gate/GatesData.hpp"
 #include "../testutil.hpp"
 #include "ComparisonFunctions.hpp"
 #include "tket/Circuit/CircPool.hpp"
 #include "tket/Circuit/CircUtils.hpp"
+#include "tket/Circuit/PauliExpBoxes.hpp"
 #include "tket/Circuit/Simulation/CircuitSimulator.hpp"
+#include "tket/Gate/Gate.hpp"
 #include "tket/Gate/GateUnitaryMatrix.hpp"
+#include "tket/Gate/GateUnitaryMatrixError.hpp"
 #include "tket/Gate/GateUnitaryMatrixUtils.hpp"
 #include "tket/Transformations/OptimisationPass.hpp"
+#include "tket/Transformations/Rebase.hpp"
 #include "tket/Transformations/Transform.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
 
@@ -144,6 +151,24 @@ SCENARIO("Simple circuits produce the correct statevectors") {
         tket_sim::get_statevector(circ), tket_sim::get_statevector(circ2)));
   }
 
+  GIVEN("A GHZ circuit on more qubits than fit in a full unitary") {
+    const unsigned n_qubits = 16;
+    Circuit circ(n_qubits);
+    circ.add_op<unsigned>(OpType::H, {0});
+    for (unsigned i = 1; i < n_qubits; ++i) {
+      circ.add_op<unsigned>(OpType::CX, {i - 1, i});
+    }
+    circ.add_op<unsigned>(OpType::CCX, {0, 7, 15});
+    const StateVector sv = tket_sim::get_statevector(circ);
+    REQUIRE(sv.size() == (1 << n_qubits));
+    // The CCX maps |11...1> to |11...10>.
+    REQUIRE(std::abs(sv(0) - 1. / std::sqrt(2.)) < ERR_EPS);
+    REQUIRE(std::abs(sv(sv.size() - 2) - 1. / std::sqrt(2.)) < ERR_EPS);
+    REQUIRE(std::abs(sv.norm() - 1.) < ERR_EPS);
+    REQUIRE_THROWS_AS(
+        tket_sim::get_statevector(circ, EPS, 15), GateUnitaryMatrixError);
+  }
+
   GIVEN("A circuit with 0 qubits and a global phase") {
     Circuit circ(0);
     circ.add_op<unsigned>(OpType::Phase, 0.125, {});
@@ -555,6 +580,225 @@ SCENARIO("Unitaries for controlled operations") {
   }
 }
 
+SCENARIO("Simulating repeated gates and boxes") {
+  GIVEN("A Trotterised circuit with equal but distinct boxes") {
+    Circuit circ(3);
+    Circuit decomposed(3);
+    const PauliExpBox reused(SymPauliTensor({Pauli::Z, Pauli::Z}, 0.1));
+    for (unsigned step = 0; step < 3; ++step) {
+      const std::vector<std::pair<PauliExpBox, std::vector<unsigned>>> terms{
+          {PauliExpBox(SymPauliTensor({Pauli::X, Pauli::Y}, 0.3)), {0, 1}},
+          {PauliExpBox(SymPauliTensor({Pauli::X, Pauli::Y}, 0.3)), {1, 2}},
+          {PauliExpBox(SymPauliTensor({Pauli::X, Pauli::Y}, 0.5)), {0, 2}},
+          {PauliExpBox(SymPauliTensor({Pauli::Y, Pauli::X}, 0.3)), {2, 0}},
+          {reused, {step % 2, 2}}};
+      for (const auto& [box, qubits] : terms) {
+        circ.add_box(box, qubits);
+        decomposed.append_qubits(*box.to_circuit(), qubits);
+      }
+      circ.add_op<unsigned>(OpType::Rz, 0.25, {step});
+      circ.add_op<unsigned>(OpType::Rz, 0.75, {step});
+      decomposed.add_op<unsigned>(OpType::Rz, 0.25, {step});
+      decomposed.add_op<unsigned>(OpType::Rz, 0.75, {step});
+    }
+    REQUIRE(tket_sim::compare_statevectors_or_unitaries(
+        tket_sim::get_unitary(circ), tket_sim::get_unitary(decomposed)));
+  }
+}
+
+SCENARIO("Comparing circuits on random states") {
+  GIVEN("Equivalent circuits") {
+    Circuit circ1(3);
+    circ1.add_op<unsigned>(OpType::CX, {0, 1});
+    circ1.add_op<unsigned>(OpType::SWAP, {1, 2});
+    circ1.add_op<unsigned>(OpType::Rz, 0.3, {0});
+    Circuit circ2(3);
+    circ2.add_op<unsigned>(OpType::H, {1});
+    circ2.add_op<unsigned>(OpType::CZ, {0, 1});
+    circ2.add_op<unsigned>(OpType::H, {1});
+    circ2.add_op<unsigned>(OpType::Rz, 0.3, {0});
+    circ2.add_op<unsigned>(OpType::SWAP, {1, 2});
+    circ2.replace_SWAPs();
+    REQUIRE(circ2.has_implicit_wireswaps());
+    REQUIRE(tket_sim::compare_on_random_states(circ1, circ2));
+    WHEN("There is a global phase difference") {
+      circ2.add_phase(0.25);
+      REQUIRE_FALSE(tket_sim::compare_on_random_states(circ1, circ2));
+      REQUIRE(tket_sim::compare_on_random_states(
+          circ1, circ2, tket_sim::PhaseEquivalence::UpToGlobalPhase));
+    }
+    WHEN("A gate is changed") {
+      circ2.add_op<unsigned>(OpType::Rz, 1e-3, {2});
+      REQUIRE_FALSE(tket_sim::compare_on_random_states(
+          circ1, circ2, tket_sim::PhaseEquivalence::UpToGlobalPhase));
+      REQUIRE(tket_sim::compare_on_random_states(
+          circ1, circ2, tket_sim::PhaseEquivalence::UpToGlobalPhase, 1e-2));
+    }
+  }
+  GIVEN("Circuits on different qubits") {
+    Circuit circ1(2);
+    Circuit circ2(3);
+    REQUIRE_FALSE(tket_sim::compare_on_random_states(circ1, circ2));
+  }
+  GIVEN("Circuits too large for a unitary") {
+    const unsigned n_qubits = 18;
+    Circuit circ1(n_qubits);
+    Circuit circ2(n_qubits);
+    for (unsigned i = 0; i + 1 < n_qubits; ++i) {
+      circ1.add_op<unsigned>(OpType::CX, {i, i + 1});
+      circ2.add_op<unsigned>(OpType::H, {i + 1});
+      circ2.add_op<unsigned>(OpType::CZ, {i, i + 1});
+      circ2.add_op<unsigned>(OpType::H, {i + 1});
+    }
+    REQUIRE(tket_sim::compare_on_random_states(circ1, circ2));
+  }
+}
+
+SCENARIO("Simulating with several threads") {
+  GIVEN("A circuit large enough to be split between threads") {
+    const unsigned n_qubits = 16;
+    Circuit circ(n_qubits);
+    for (unsigned i = 0; i < n_qubits; ++i) {
+      circ.add_op<unsigned>(OpType::H, {i});
+      circ.add_op<unsigned>(OpType::Rz, 0.1 * i, {i});
+    }
+    for (unsigned i = 0; i + 1 < n_qubits; ++i) {
+      circ.add_op<unsigned>(OpType::CX, {i, i + 1});
+      circ.add_op<unsigned>(OpType::TK2, {0.1, 0.2, 0.3}, {i + 1, i});
+    }
+    circ.add_op<unsigned>(OpType::CCX, {3, 9, 14});
+    REQUIRE(tket_sim::get_number_of_threads() == 1);
+    const StateVector sv1 = tket_sim::get_statevector(circ);
+    tket_sim::set_number_of_threads(4);
+    REQUIRE(tket_sim::get_number_of_threads() == 4);
+    const StateVector sv4 = tket_sim::get_statevector(circ);
+    tket_sim::set_number_of_threads(1);
+    // Results are identical, not just close.
+    REQUIRE(sv1 == sv4);
+  }
+  GIVEN("Several callers simulating at once") {
+    std::vector<Circuit> circs;
+    for (unsigned c = 0; c < 8; ++c) {
+      Circuit circ(5);
+      for (unsigned i = 0; i < 5; ++i) {
+        circ.add_op<unsigned>(OpType::Rx, 0.1 * (c + i), {i});
+      }
+      circ.add_op<unsigned>(OpType::CCX, {c % 5, (c + 1) % 5, (c + 3) % 5});
+      const PauliExpBox pbox(
+          SymPauliTensor({Pauli::X, Pauli::Y, Pauli::Z}, 0.05 * c));
+      circ.add_box(pbox, {0, 2, 4});
+      circs.push_back(circ);
+    }
+    std::vector<Eigen::MatrixXcd> expected;
+    for (const Circuit& circ : circs) {
+      expected.push_back(tket_sim::get_unitary(circ));
+    }
+    tket_sim::set_number_of_threads(4);
+    std::vector<Eigen::MatrixXcd> results(circs.size());
+    std::vector<std::thread> callers;
+    for (unsigned c = 0; c < circs.size(); ++c) {
+      callers.emplace_back([&, c]() {
+        for (unsigned r = 0; r < 10; ++r) {
+          results[c] = tket_sim::get_unitary(circs[c]);
+        }
+      });
+    }
+    for (std::thread& caller : callers) caller.join();
+    tket_sim::set_number_of_threads(1);
+    for (unsigned c = 0; c < circs.size(); ++c) {
+      REQUIRE(results[c] == expected[c]);
+    }
+  }
+}
+
+SCENARIO("Simulating gates with structured unitaries") {
+  // (type, parameters, qubits) on a 5-qubit circuit
+  const std::vector<
+      std::tuple<OpType, std::vector<double>, std::vector<unsigned>>>
+      gates{
+          {OpType::CnX, {}, {3, 0, 4}},
+          {OpType::CnY, {}, {1, 4, 2, 0}},
+          {OpType::CnZ, {}, {4, 1}},
+          {OpType::CCX, {}, {2, 0, 1}},
+          {OpType::CnRy, {0.37}, {0, 3, 1}},
+          {OpType::PhaseGadget, {0.21}, {4, 2, 0}},
+          {OpType::NPhasedX, {0.3, 1.7}, {3, 1, 4}},
+      };
+  for (const auto& [type, params, qubits] : gates) {
+    std::vector<Expr> exprs(params.begin(), params.end());
+    Gate gate(type, exprs, qubits.size());
+    const auto structure = GateUnitaryMatrix::get_unitary_structure(gate);
+    REQUIRE(structure);
+
+    // On qubits in order, the same as the dense unitary.
+    Circuit ordered(qubits.size());
+    std::vector<unsigned> ordered_qubits(qubits.size());
+    std::iota(ordered_qubits.begin(), ordered_qubits.end(), 0);
+    ordered.add_op<unsigned>(type, exprs, ordered_qubits);
+    CHECK(tket_sim::get_unitary(ordered).isApprox(
+        GateUnitaryMatrix::get_unitary(gate)));
+
+    // Among other gates, the same as its decomposition.
+    Circuit circ(5);
+    for (unsigned i = 0; i < 5; ++i) {
+      circ.add_op<unsigned>(OpType::TK1, {0.1 * i, 0.3, 0.7}, {i});
+    }
+    circ.add_op<unsigned>(type, exprs, qubits);
+    circ.add_op<unsigned>(OpType::CX, {qubits[0], qubits[1]});
+    Circuit rebased = circ;
+    Transforms::rebase_tket().apply(rebased);
+    CHECK(tket_sim::compare_statevectors_or_unitaries(
+        tket_sim::get_unitary(circ), tket_sim::get_unitary(rebased),
+        tket_sim::MatrixEquivalence::EQUAL_UP_TO_GLOBAL_PHASE));
+  }
+  GIVEN("Gates without structure") {
+    const Gate gate(OpType::CX, {}, 2);
+    CHECK_FALSE(GateUnitaryMatrix::get_unitary_structure(gate));
+  }
+}
+
+SCENARIO("Simulating a symbolic circuit at many points") {
+  Sym asym = SymEngine::symbol("a");
+  Sym bsym = SymEngine::symbol("b");
+  Expr a(asym);
+  Expr b(bsym);
+  Circuit circ(3);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::SWAP, {1, 2});
+  circ.add_op<unsigned>(OpType::Rz, 2 * a, {1});
+  circ.add_op<unsigned>(OpType::CX, {1, 2});
+  circ.add_op<unsigned>(OpType::TK1, {0.3, b, a + b}, {2});
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_phase(a);
+  circ.replace_SWAPs();
+  REQUIRE(circ.has_implicit_wireswaps());
+
+  Eigen::MatrixXd values(4, 2);
+  values << 0.1, 0.2, 0.6, 0.2, 0.1, -0.3, 1.5, 0.0;
+  const Eigen::MatrixXcd states =
+      tket_sim::get_statevectors(circ, {asym, bsym}, values);
+  const std::vector<Eigen::MatrixXcd> unitaries =
+      tket_sim::get_unitaries(circ, {asym, bsym}, values);
+  REQUIRE(states.cols() == values.rows());
+  REQUIRE(unitaries.size() == std::size_t(values.rows()));
+  for (Eigen::Index k = 0; k < values.rows(); ++k) {
+    Circuit bound = circ;
+    symbol_map_t map{{asym, values(k, 0)}, {bsym, values(k, 1)}};
+    bound.symbol_substitution(map);
+    CHECK(states.col(k).isApprox(tket_sim::get_statevector(bound)));
+    CHECK(unitaries[k].isApprox(tket_sim::get_unitary(bound)));
+  }
+  GIVEN("Wrong symbols") {
+    REQUIRE_THROWS_AS(
+        tket_sim::get_statevectors(circ, {asym}, values.leftCols(1)),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        tket_sim::get_statevectors(circ, {asym, bsym}, values.leftCols(1)),
+        std::invalid_argument);
+  }
+}
+
 SCENARIO("Handling internal qubit permutations") {
   GIVEN("A Clifford reduction introducing a wireswap") {
     Circuit circ(3);
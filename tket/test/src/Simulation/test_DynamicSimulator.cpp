@@ -0,0 +1,113 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "tket/Circuit/Boxes.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Conditional.hpp"
+#include "tket/Circuit/Simulation/DynamicSimulator.hpp"
+#include "tket/Ops/ClassicalOps.hpp"
+
+namespace tket {
+namespace test_DynamicSimulator {
+
+// Teleport Ry(angle)|0> from q[0] to q[2], and measure it into c[2].
+static Circuit teleportation(double angle) {
+  Circuit circ(3, 3);
+  circ.add_op<unsigned>(OpType::Ry, angle, {0});
+  circ.add_op<unsigned>(OpType::H, {1});
+  circ.add_op<unsigned>(OpType::CX, {1, 2});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_measure(0, 0);
+  circ.add_measure(1, 1);
+  circ.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {1}, 1);
+  circ.add_conditional_gate<unsigned>(OpType::Z, {}, {2}, {0}, 1);
+  circ.add_measure(2, 2);
+  return circ;
+}
+
+SCENARIO("Sampling circuits with mid-circuit measurement") {
+  GIVEN("Teleportation of a basis state") {
+    const Circuit circ = teleportation(1.);
+    const std::vector<std::vector<bool>> shots =
+        tket_sim::sample_dynamic_circuit(circ, 100);
+    REQUIRE(shots.size() == 100);
+    unsigned n_ones = 0;
+    for (const std::vector<bool>& shot : shots) {
+      REQUIRE(shot.size() == 3);
+      REQUIRE(shot[2]);
+      if (shot[0]) ++n_ones;
+    }
+    // The first two outcomes are uniformly random.
+    REQUIRE(n_ones > 20);
+    REQUIRE(n_ones < 80);
+    REQUIRE(tket_sim::sample_dynamic_circuit(circ, 100) == shots);
+    REQUIRE(tket_sim::sample_dynamic_circuit(circ, 100, 1) != shots);
+  }
+  GIVEN("Teleportation of a superposition") {
+    const Circuit circ = teleportation(0.5);
+    unsigned n_ones = 0;
+    for (const std::vector<bool>& shot :
+         tket_sim::sample_dynamic_circuit(circ, 200)) {
+      if (shot[2]) ++n_ones;
+    }
+    REQUIRE(n_ones > 60);
+    REQUIRE(n_ones < 140);
+  }
+  GIVEN("Repeat-until-success with reset") {
+    // Try to prepare |1> on q[0] by measuring |+> twice, copying the outcome
+    // into c[1] and flipping the qubit if both attempts failed.
+    Circuit circ(1, 3);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_measure(0, 0);
+    circ.add_op<unsigned>(std::make_shared<CopyBitsOp>(1), {0, 1});
+    circ.add_conditional_gate<unsigned>(OpType::Reset, {}, {0}, {1}, 0);
+    circ.add_conditional_gate<unsigned>(OpType::H, {}, {0}, {1}, 0);
+    circ.add_conditional_gate<unsigned>(OpType::Measure, {}, {0, 0}, {1}, 0);
+    circ.add_op<unsigned>(
+        std::make_shared<Conditional>(ClassicalX(), 2, 0), {0, 1, 2});
+    circ.add_conditional_gate<unsigned>(OpType::X, {}, {0}, {2}, 1);
+    circ.add_measure(0, 0);
+    for (const std::vector<bool>& shot :
+         tket_sim::sample_dynamic_circuit(circ, 50)) {
+      REQUIRE(shot[0]);
+    }
+  }
+  GIVEN("A box containing a measurement") {
+    Circuit inner(1, 1);
+    inner.add_op<unsigned>(OpType::X, {0});
+    inner.add_measure(0, 0);
+    Circuit circ(1, 1);
+    circ.add_box(CircBox(inner), {0, 0});
+    for (const std::vector<bool>& shot :
+         tket_sim::sample_dynamic_circuit(circ, 10)) {
+      REQUIRE(shot[0]);
+    }
+  }
+  GIVEN("Unsupported circuits") {
+    Circuit circ(2, 1);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::Collapse, {0});
+    REQUIRE_THROWS_AS(
+        tket_sim::sample_dynamic_circuit(circ, 10), Unsupported);
+    REQUIRE_THROWS_AS(
+        tket_sim::sample_dynamic_circuit(Circuit(3), 10, 5489, 2),
+        Unsupported);
+  }
+}
+
+}  // namespace test_DynamicSimulator
+}  // namespace tket
@@ -0,0 +1,103 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "tket/Characterisation/DeviceCharacterisation.hpp"
+#include "tket/Circuit/Boxes.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Simulation/NoisySimulator.hpp"
+
+namespace tket {
+namespace test_NoisySimulator {
+
+// A circuit on nodes 0 and 1 preparing a Bell state and measuring it.
+static Circuit bell_circuit() {
+  Circuit circ;
+  circ.add_qubit(Node(0));
+  circ.add_qubit(Node(1));
+  circ.add_bit(Bit(0));
+  circ.add_bit(Bit(1));
+  circ.add_op<UnitID>(OpType::H, {Node(0)});
+  circ.add_op<UnitID>(OpType::CX, {Node(0), Node(1)});
+  circ.add_op<UnitID>(OpType::Measure, {Node(0), Bit(0)});
+  circ.add_op<UnitID>(OpType::Measure, {Node(1), Bit(1)});
+  return circ;
+}
+
+SCENARIO("Sampling noisy circuits") {
+  GIVEN("A noiseless device") {
+    const Circuit circ = bell_circuit();
+    const std::vector<std::vector<bool>> shots =
+        tket_sim::sample_noisy_circuit(circ, DeviceCharacterisation(), 100);
+    REQUIRE(shots.size() == 100);
+    unsigned n_ones = 0;
+    for (const std::vector<bool>& shot : shots) {
+      REQUIRE(shot[0] == shot[1]);
+      if (shot[0]) ++n_ones;
+    }
+    REQUIRE(n_ones > 20);
+    REQUIRE(n_ones < 80);
+    REQUIRE(
+        tket_sim::sample_noisy_circuit(circ, DeviceCharacterisation(), 100) ==
+        shots);
+  }
+  GIVEN("Readout errors") {
+    const Circuit circ = bell_circuit();
+    const DeviceCharacterisation characterisation(
+        avg_node_errors_t{}, avg_link_errors_t{}, {{Node(1), 1.}});
+    for (const std::vector<bool>& shot :
+         tket_sim::sample_noisy_circuit(circ, characterisation, 50)) {
+      REQUIRE(shot[0] != shot[1]);
+    }
+  }
+  GIVEN("Gate errors") {
+    Circuit circ;
+    circ.add_qubit(Node(0));
+    circ.add_bit(Bit(0));
+    circ.add_op<UnitID>(OpType::T, {Node(0)});
+    circ.add_op<UnitID>(OpType::Measure, {Node(0), Bit(0)});
+    const DeviceCharacterisation characterisation(
+        avg_node_errors_t{{Node(0), 1.}});
+    // With certainty, one of X, Y or Z is applied after the T gate; two of
+    // them flip the outcome.
+    unsigned n_ones = 0;
+    for (const std::vector<bool>& shot :
+         tket_sim::sample_noisy_circuit(circ, characterisation, 300)) {
+      if (shot[0]) ++n_ones;
+    }
+    REQUIRE(n_ones > 150);
+    REQUIRE(n_ones < 250);
+    WHEN("Errors are specific to another gate") {
+      const DeviceCharacterisation op_characterisation(
+          op_node_errors_t{{Node(0), {{OpType::H, 1.}}}});
+      for (const std::vector<bool>& shot :
+           tket_sim::sample_noisy_circuit(circ, op_characterisation, 20)) {
+        REQUIRE_FALSE(shot[0]);
+      }
+    }
+  }
+  GIVEN("An unsupported operation") {
+    Circuit inner(1);
+    inner.add_op<unsigned>(OpType::X, {0});
+    Circuit circ(1);
+    circ.add_box(CircBox(inner), {0});
+    REQUIRE_THROWS_AS(
+        tket_sim::sample_noisy_circuit(circ, DeviceCharacterisation(), 1),
+        Unsupported);
+  }
+}
+
+}  // namespace test_NoisySimulator
+}  // namespace tket
@@ -0,0 +1,117 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+#include "../testutil.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Simulation/CircuitSimulator.hpp"
+#include "tket/Circuit/Simulation/PauliExpectation.hpp"
+
+namespace tket {
+namespace test_PauliExpectation {
+
+SCENARIO("Expectation values of Pauli operators") {
+  Circuit circ(3);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::Ry, 0.3, {2});
+  circ.add_op<unsigned>(OpType::CRx, 0.7, {1, 2});
+  circ.add_op<unsigned>(OpType::Rz, 0.4, {0});
+  const StateVector sv = tket_sim::get_statevector(circ);
+
+  GIVEN("Dense Pauli strings") {
+    const std::vector<SymPauliTensor> terms{
+        SymPauliTensor({Pauli::Z, Pauli::Z, Pauli::I}, 0.5),
+        SymPauliTensor({Pauli::X, Pauli::Y, Pauli::Z}, -1.2),
+        SymPauliTensor({Pauli::Y, Pauli::X, Pauli::X}, 0.3),
+        SymPauliTensor({Pauli::I, Pauli::I, Pauli::Y}, 2.),
+        SymPauliTensor({Pauli::X}, 0.7)};
+    Complex expected = 0.;
+    for (const SymPauliTensor& term : terms) {
+      SymPauliTensor padded = term;
+      padded.string.resize(3, Pauli::I);
+      expected += padded.state_expectation(sv);
+    }
+    const Complex value = tket_sim::get_operator_expectation_value(sv, terms);
+    REQUIRE(std::abs(value - expected) < ERR_EPS);
+    REQUIRE(std::abs(value.imag()) < ERR_EPS);
+    // The ZZ term alone: the first two qubits are in a Bell state.
+    REQUIRE(
+        std::abs(
+            tket_sim::get_operator_expectation_value(sv, {terms[0]}) - 0.5) <
+        ERR_EPS);
+  }
+  GIVEN("Sparse Pauli strings on a permuted register") {
+    const qubit_vector_t qubits{Qubit(2), Qubit(0), Qubit(1)};
+    const std::vector<SpSymPauliTensor> terms{
+        SpSymPauliTensor({{Qubit(1), Pauli::Y}, {Qubit(2), Pauli::X}}, 0.4),
+        SpSymPauliTensor(
+            {{Qubit(0), Pauli::X}, {Qubit(1), Pauli::X}, {Qubit(2), Pauli::Z}},
+            1.5)};
+    Complex expected = 0.;
+    for (const SpSymPauliTensor& term : terms) {
+      expected += term.state_expectation(sv, qubits);
+    }
+    REQUIRE(
+        std::abs(
+            tket_sim::get_operator_expectation_value(sv, terms, qubits) -
+            expected) < ERR_EPS);
+    REQUIRE_THROWS_AS(
+        tket_sim::get_operator_expectation_value(
+            sv, {SpSymPauliTensor({{Qubit(3), Pauli::Z}})}, qubits),
+        std::invalid_argument);
+  }
+  GIVEN("Several threads") {
+    std::vector<SymPauliTensor> terms;
+    for (unsigned i = 0; i < 64; ++i) {
+      terms.push_back(SymPauliTensor(
+          {Pauli(i % 4), Pauli((i / 4) % 4), Pauli((i / 16) % 4)}, 0.1 * i));
+    }
+    const Complex value = tket_sim::get_operator_expectation_value(sv, terms);
+    tket_sim::set_number_of_threads(4);
+    REQUIRE(tket_sim::get_operator_expectation_value(sv, terms) == value);
+    WHEN("Several callers share the threads") {
+      std::vector<Complex> values(8);
+      std::vector<std::thread> callers;
+      for (unsigned c = 0; c < values.size(); ++c) {
+        callers.emplace_back([&, c]() {
+          values[c] = tket_sim::get_operator_expectation_value(sv, terms);
+        });
+      }
+      for (std::thread& caller : callers) caller.join();
+      for (const Complex& v : values) REQUIRE(v == value);
+    }
+    tket_sim::set_number_of_threads(1);
+  }
+  GIVEN("Invalid input") {
+    Sym a = SymEngine::symbol("a");
+    REQUIRE_THROWS_AS(
+        tket_sim::get_operator_expectation_value(
+            sv, {SymPauliTensor({Pauli::Z}, Expr(a))}),
+        SymbolsNotSupported);
+    REQUIRE_THROWS_AS(
+        tket_sim::get_operator_expectation_value(
+            sv, {SymPauliTensor(DensePauliMap(4, Pauli::Z))}),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        tket_sim::get_operator_expectation_value(StateVector(3), {}),
+        std::invalid_argument);
+  }
+}
+
+}  // namespace test_PauliExpectation
+}  // namespace tket
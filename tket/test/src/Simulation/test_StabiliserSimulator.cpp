@@ -0,0 +1,89 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Circuit/Simulation/StabiliserSimulator.hpp"
+
+namespace tket {
+namespace test_StabiliserSimulator {
+
+SCENARIO("Sampling Clifford circuits") {
+  GIVEN("A deterministic circuit") {
+    Circuit circ(3, 3);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::S, {0});
+    circ.add_op<unsigned>(OpType::S, {0});
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 2});
+    circ.add_measure(0, 0);
+    circ.add_measure(1, 1);
+    circ.add_measure(2, 2);
+    const std::vector<std::vector<bool>> shots =
+        tket_sim::sample_stabiliser_circuit(circ, 10);
+    REQUIRE(shots.size() == 10);
+    for (const std::vector<bool>& shot : shots) {
+      REQUIRE(shot == std::vector<bool>{true, false, true});
+    }
+  }
+  GIVEN("A GHZ circuit") {
+    const unsigned n = 200;
+    Circuit circ(n, n);
+    circ.add_op<unsigned>(OpType::H, {0});
+    for (unsigned i = 1; i < n; ++i) {
+      circ.add_op<unsigned>(OpType::CX, {i - 1, i});
+    }
+    for (unsigned i = 0; i < n; ++i) circ.add_measure(i, i);
+    const std::vector<std::vector<bool>> shots =
+        tket_sim::sample_stabiliser_circuit(circ, 100);
+    unsigned n_ones = 0;
+    for (const std::vector<bool>& shot : shots) {
+      REQUIRE(shot == std::vector<bool>(n, shot[0]));
+      if (shot[0]) ++n_ones;
+    }
+    REQUIRE(n_ones > 20);
+    REQUIRE(n_ones < 80);
+    // The same seed gives the same samples.
+    REQUIRE(tket_sim::sample_stabiliser_circuit(circ, 100) == shots);
+  }
+  GIVEN("Resets and conditional gates") {
+    Circuit circ(2, 2);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_measure(0, 0);
+    // Copy the random outcome onto qubit 1, then clear qubit 0.
+    circ.add_conditional_gate<unsigned>(OpType::X, {}, {1}, {0}, 1);
+    circ.add_op<unsigned>(OpType::Reset, {0});
+    circ.add_measure(1, 1);
+    circ.add_measure(0, 0);
+    const std::vector<std::vector<bool>> shots =
+        tket_sim::sample_stabiliser_circuit(circ, 50);
+    bool seen_one = false;
+    for (const std::vector<bool>& shot : shots) {
+      REQUIRE_FALSE(shot[0]);
+      seen_one |= shot[1];
+    }
+    REQUIRE(seen_one);
+  }
+  GIVEN("A non-Clifford gate") {
+    Circuit circ(1, 1);
+    circ.add_op<unsigned>(OpType::T, {0});
+    circ.add_measure(0, 0);
+    REQUIRE_THROWS_AS(
+        tket_sim::sample_stabiliser_circuit(circ, 1), BadOpType);
+  }
+}
+
+}  // namespace test_StabiliserSimulator
+}  // namespace tket
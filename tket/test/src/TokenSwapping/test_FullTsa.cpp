@@ -14,10 +14,13 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <tktokenswap/HybridTsa.hpp>
+#include <tktokenswap/RiverFlowPathFinder.hpp>
 
 #include "TestUtils/ArchitectureEdgesReimplementation.hpp"
 #include "TestUtils/FullTsaTesting.hpp"
 #include "TestUtils/ProblemGeneration.hpp"
+#include "tket/Architecture/DistancesFromArchitecture.hpp"
+#include "tket/Architecture/NeighboursFromArchitecture.hpp"
 
 using std::vector;
 
@@ -254,6 +257,44 @@ SCENARIO("Full TSA: Random trees") {
       "[Winners: joint: 128 148 282 297 300 280  undisputed: 0 0 0 0 3 0]");
 }
 
+SCENARIO("Full TSA: a zero time budget falls back to the trivial TSA") {
+  const auto edges = get_square_grid_edges(3, 4, 4);
+  const Architecture arch(edges);
+  const ArchitectureMapping arch_mapping(arch, edges);
+  RNG rng;
+  const ProblemGenerator00 generator;
+  const auto problems = generator.get_problems(
+      "Grid(3,4,4)", arch_mapping.number_of_vertices(), rng,
+      "[Grid(3,4,4): 51492: v48 i1 f100 s1: 100 problems; 2378 tokens]");
+
+  DistancesFromArchitecture distances(arch_mapping);
+  NeighboursFromArchitecture neighbours(arch_mapping);
+  RiverFlowPathFinder path_finder(distances, neighbours, rng);
+  HybridTsa hybrid_tsa;
+  hybrid_tsa.get_options().timeout_ms = 0;
+  TrivialTSA trivial_tsa;
+  SwapList hybrid_swaps;
+  SwapList trivial_swaps;
+
+  for (const auto& problem : problems) {
+    auto hybrid_problem = problem;
+    hybrid_swaps.clear();
+    rng.set_seed();
+    path_finder.reset();
+    hybrid_tsa.append_partial_solution(
+        hybrid_swaps, hybrid_problem, distances, neighbours, path_finder);
+    REQUIRE(all_tokens_home(hybrid_problem));
+
+    auto trivial_problem = problem;
+    trivial_swaps.clear();
+    rng.set_seed();
+    path_finder.reset();
+    trivial_tsa.append_partial_solution(
+        trivial_swaps, trivial_problem, distances, neighbours, path_finder);
+    REQUIRE(hybrid_swaps.to_vector() == trivial_swaps.to_vector());
+  }
+}
+
 }  // namespace tests
 }  // namespace tsa_internal
 }  // namespace tket
@@ -15,6 +15,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include <sstream>
 #include <tkrng/RNG.hpp>
+#include <tktokenswap/VertexSwapResult.hpp>
 
 #include "tket/Architecture/BestTsaWithArch.hpp"
 
@@ -117,5 +118,106 @@ SCENARIO("get_swaps : swaps returned directly from architecture") {
   REQUIRE(nodes_copy == node_final_positions);
 }
 
+SCENARIO("Repeated get_swaps calls reusing the architecture data") {
+  const SquareGrid arch(4, 5);
+  const auto nodes = arch.get_all_nodes_vec();
+  ReusableBestTsaWithArch reusable_tsa(arch);
+  REQUIRE(reusable_tsa.get_arch_mapping().number_of_vertices() == 20);
+
+  BestTsaWithArch::NodeMapping node_mapping;
+  for (const Node& node : nodes) {
+    node_mapping[node] = node;
+  }
+  REQUIRE(reusable_tsa.get_swaps(node_mapping).empty());
+
+  RNG rng;
+  for (unsigned problem = 0; problem < 20; ++problem) {
+    // Move only some of the nodes, leaving the others free.
+    auto nodes_copy = nodes;
+    rng.do_shuffle(nodes_copy);
+    node_mapping.clear();
+    const std::size_t number_of_tokens = 1 + rng.get_size_t(nodes.size() - 1);
+    for (std::size_t ii = 0; ii < number_of_tokens; ++ii) {
+      node_mapping[nodes_copy[ii]] = nodes[ii];
+    }
+    const auto swaps = BestTsaWithArch::get_swaps(arch, node_mapping);
+    REQUIRE(reusable_tsa.get_swaps(node_mapping) == swaps);
+
+    // The same with raw vertices.
+    const ArchitectureMapping& arch_mapping = reusable_tsa.get_arch_mapping();
+    VertexMapping vertex_mapping;
+    for (const auto& [source, target] : node_mapping) {
+      vertex_mapping[arch_mapping.get_vertex(source)] =
+          arch_mapping.get_vertex(target);
+    }
+    SwapList raw_swaps;
+    reusable_tsa.append_solution(raw_swaps, vertex_mapping);
+    REQUIRE(raw_swaps.size() == swaps.size());
+    auto swap_it = swaps.cbegin();
+    for (auto id_opt = raw_swaps.front_id(); id_opt;
+         id_opt = raw_swaps.next(id_opt.value()), ++swap_it) {
+      const Swap& raw_swap = raw_swaps.at(id_opt.value());
+      REQUIRE(arch_mapping.get_node(raw_swap.first) == swap_it->first);
+      REQUIRE(arch_mapping.get_node(raw_swap.second) == swap_it->second);
+    }
+  }
+}
+
+SCENARIO("Solving a batch of problems on one architecture") {
+  SquareGrid arch(4, 5);
+  const ArchitectureMapping arch_mapping(arch);
+  const std::size_t number_of_vertices = arch_mapping.number_of_vertices();
+  RNG rng;
+  vector<VertexMapping> problems(30);
+  vector<std::size_t> targets(number_of_vertices);
+  for (std::size_t vv = 0; vv < number_of_vertices; ++vv) {
+    targets[vv] = vv;
+  }
+  for (auto& problem : problems) {
+    rng.do_shuffle(targets);
+    const std::size_t number_of_tokens =
+        1 + rng.get_size_t(number_of_vertices - 1);
+    for (std::size_t vv = 0; vv < number_of_tokens; ++vv) {
+      problem[vv] = targets[vv];
+    }
+  }
+  REQUIRE(BestTsaWithArch::solve_batch(arch_mapping, {}).empty());
+
+  // Unfrozen, so solved serially.
+  const auto results = BestTsaWithArch::solve_batch(arch_mapping, problems);
+  REQUIRE(results.size() == problems.size());
+  for (std::size_t index = 0; index < problems.size(); ++index) {
+    auto vertex_mapping = problems[index];
+    SwapList expected_swaps;
+    BestTsaWithArch::append_solution(
+        expected_swaps, vertex_mapping, arch_mapping);
+    const auto& result = results[index];
+    REQUIRE(result.swaps == expected_swaps.to_vector());
+    REQUIRE(result.swaps.size() >= result.swaps_lower_bound);
+    REQUIRE(2 * result.swaps_lower_bound >= result.total_home_distance);
+    REQUIRE(result.time_ms >= 0.0);
+
+    // The swaps really do solve the problem.
+    vertex_mapping = problems[index];
+    for (const Swap& swap : result.swaps) {
+      const tsa_internal::VertexSwapResult swap_result(swap, vertex_mapping);
+    }
+    REQUIRE(all_tokens_home(vertex_mapping));
+  }
+  // Frozen, so shared between threads; the results must not change.
+  arch.freeze();
+  for (unsigned n_threads : {2, 4}) {
+    const auto parallel_results =
+        BestTsaWithArch::solve_batch(arch_mapping, problems, n_threads);
+    REQUIRE(parallel_results.size() == results.size());
+    for (std::size_t index = 0; index < results.size(); ++index) {
+      REQUIRE(parallel_results[index].swaps == results[index].swaps);
+      REQUIRE(
+          parallel_results[index].total_home_distance ==
+          results[index].total_home_distance);
+    }
+  }
+}
+
 }  // namespace tests
 }  // namespace tket
@@ -0,0 +1,122 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+#include "../testutil.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Converters/Converters.hpp"
+#include "tket/Predicates/CompilationUnit.hpp"
+#include "tket/Predicates/PassLibrary.hpp"
+#include "tket/Transformations/CliffordBlockResynthesis.hpp"
+
+namespace tket {
+namespace test_CliffordBlockResynthesis {
+
+// Build a random Clifford circuit from a fixed seed.
+static Circuit random_clifford_circuit(
+    unsigned n_qubits, unsigned n_gates, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<unsigned> qb_dist(0, n_qubits - 1);
+  const std::vector<OpType> types{OpType::H,  OpType::S,    OpType::V,
+                                  OpType::CX, OpType::CZ,   OpType::SWAP,
+                                  OpType::CY, OpType::ZZMax};
+  std::uniform_int_distribution<unsigned> type_dist(0, types.size() - 1);
+  Circuit circ(n_qubits);
+  for (unsigned i = 0; i < n_gates; ++i) {
+    OpType type = types[type_dist(gen)];
+    unsigned a = qb_dist(gen);
+    if (type == OpType::H || type == OpType::S || type == OpType::V) {
+      circ.add_op<unsigned>(type, {a});
+    } else {
+      unsigned b = (a + 1 + qb_dist(gen) % (n_qubits - 1)) % n_qubits;
+      circ.add_op<unsigned>(type, {a, b});
+    }
+  }
+  return circ;
+}
+
+SCENARIO("Clifford blocks are resynthesised from their tableaux") {
+  GIVEN("A Clifford circuit followed by its inverse") {
+    Circuit circ = random_clifford_circuit(6, 80, 1);
+    circ.append(circ.dagger());
+    const UnitaryTableau tab = circuit_to_unitary_tableau(circ);
+    const unsigned n_cx = circ.count_gates(OpType::CX);
+    REQUIRE(Transforms::clifford_block_resynthesis().apply(circ));
+    REQUIRE(circuit_to_unitary_tableau(circ) == tab);
+    REQUIRE(circ.count_gates(OpType::CX) < n_cx);
+    REQUIRE(circ.count_gates(OpType::SWAP) == 0);
+    THEN("Running it again changes nothing") {
+      REQUIRE_FALSE(Transforms::clifford_block_resynthesis().apply(circ));
+      REQUIRE(circuit_to_unitary_tableau(circ) == tab);
+    }
+  }
+  GIVEN("Clifford blocks separated by non-Clifford gates") {
+    Circuit circ(3, 1);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::CZ, {0, 1});
+    circ.add_op<unsigned>(OpType::CZ, {0, 1});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::T, {1});
+    circ.add_op<unsigned>(OpType::SWAP, {0, 2});
+    circ.add_op<unsigned>(OpType::SWAP, {2, 0});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {2});
+    circ.add_op<unsigned>(OpType::CY, {0, 2});
+    circ.add_op<unsigned>(OpType::CY, {0, 2});
+    const Circuit original = circ;
+    REQUIRE(Transforms::clifford_block_resynthesis().apply(circ));
+    REQUIRE(test_unitary_comparison(original, circ, true));
+    REQUIRE(circ.count_gates(OpType::T) == 1);
+    REQUIRE(circ.count_gates(OpType::Rz) == 1);
+    REQUIRE(circ.count_gates(OpType::CX) < 4);
+    WHEN("A measurement is added") {
+      circ.add_measure(0, 0);
+      REQUIRE_FALSE(Transforms::clifford_block_resynthesis().apply(circ));
+      REQUIRE(circ.count_gates(OpType::Measure) == 1);
+    }
+  }
+  GIVEN("Gates in an opgroup") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::CX, {0, 1}, "group");
+    circ.add_op<unsigned>(OpType::CX, {0, 1}, "group");
+    REQUIRE_FALSE(Transforms::clifford_block_resynthesis().apply(circ));
+    REQUIRE(circ.count_gates(OpType::CX) == 2);
+  }
+  GIVEN("A circuit with nothing to improve") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    REQUIRE_FALSE(Transforms::clifford_block_resynthesis().apply(circ));
+    REQUIRE(circ.n_gates() == 2);
+  }
+  GIVEN("The compiler pass") {
+    Circuit circ(4);
+    for (unsigned i = 0; i < 3; ++i) {
+      circ.add_op<unsigned>(OpType::SWAP, {i, i + 1});
+      circ.add_op<unsigned>(OpType::SWAP, {i + 1, i});
+    }
+    const UnitaryTableau tab = circuit_to_unitary_tableau(circ);
+    CompilationUnit cu(circ);
+    REQUIRE(CliffordBlockResynthesis()->apply(cu));
+    REQUIRE(circuit_to_unitary_tableau(cu.get_circ_ref()) == tab);
+    REQUIRE(cu.get_circ_ref().count_gates(OpType::CX) == 0);
+  }
+}
+
+}  // namespace test_CliffordBlockResynthesis
+}  // namespace tket
@@ -0,0 +1,150 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+#include "tket/Utils/BitMatrix.hpp"
+
+namespace tket {
+namespace test_BitMatrix {
+
+static MatrixXb random_matrix(unsigned rows, unsigned cols, std::mt19937 &rng) {
+  MatrixXb m(rows, cols);
+  for (unsigned r = 0; r < rows; ++r) {
+    for (unsigned c = 0; c < cols; ++c) m(r, c) = rng() % 2;
+  }
+  return m;
+}
+
+SCENARIO("BitMatrix agrees with MatrixXb") {
+  std::mt19937 rng(1);
+  GIVEN("Matrices with rows shorter than and spanning several words") {
+    for (unsigned cols : {1, 63, 64, 65, 130}) {
+      const MatrixXb m = random_matrix(5, cols, rng);
+      BitMatrix bm(m);
+      REQUIRE(bm.rows() == 5);
+      REQUIRE(bm.cols() == cols);
+      REQUIRE(bm.words_per_row() == (cols + 63) / 64);
+      REQUIRE(bm.to_matrix() == m);
+      REQUIRE(bm.transpose().to_matrix() == m.transpose());
+      for (unsigned r = 0; r < 5; ++r) {
+        REQUIRE(bm.get_row(r) == m.row(r));
+        for (unsigned c = 0; c < cols; ++c) REQUIRE(bm(r, c) == m(r, c));
+      }
+    }
+  }
+  GIVEN("Row and column operations") {
+    MatrixXb m = random_matrix(4, 100, rng);
+    BitMatrix bm(m);
+    bm.xor_row(0, 1);
+    m.row(1) = m.row(0).array() != m.row(1).array();
+    bm.swap_rows(2, 3);
+    m.row(2).swap(m.row(3));
+    bm.copy_col(99, 3);
+    m.col(3) = m.col(99);
+    bm.copy_row(1, 0);
+    m.row(0) = m.row(1);
+    REQUIRE(bm.to_matrix() == m);
+    REQUIRE_FALSE(bm.row_is_zero(2));
+    bm.set_row_zero(2);
+    REQUIRE(bm.row_is_zero(2));
+    bm(3, 70) = true;
+    bm(3, 70) ^= true;
+    REQUIRE_FALSE(bm(3, 70));
+  }
+  GIVEN("Resizing") {
+    const MatrixXb m = random_matrix(3, 70, rng);
+    BitMatrix bm(m);
+    bm.conservative_resize(4, 130);
+    REQUIRE(bm.to_matrix().topLeftCorner(3, 70) == m);
+    REQUIRE(bm.to_matrix().rightCols(60).isZero());
+    REQUIRE(bm.row_is_zero(3));
+    bm.conservative_resize(2, 10);
+    REQUIRE(bm.to_matrix() == m.topLeftCorner(2, 10));
+    // Entries cut off by shrinking do not reappear on growing.
+    bm.conservative_resize(2, 70);
+    REQUIRE(bm.to_matrix().rightCols(60).isZero());
+    REQUIRE(bm == BitMatrix(MatrixXb(bm.to_matrix())));
+    REQUIRE(bm != BitMatrix(2, 70));
+  }
+  GIVEN("Hashing") {
+    const MatrixXb m = random_matrix(3, 100, rng);
+    BitMatrix bm(m);
+    REQUIRE(bm.hash_value() == BitMatrix(m).hash_value());
+    bm(2, 90) ^= true;
+    REQUIRE(bm.hash_value() != BitMatrix(m).hash_value());
+    REQUIRE(BitMatrix(2, 3).hash_value() != BitMatrix(3, 2).hash_value());
+  }
+  GIVEN("Parities of intersections") {
+    const MatrixXb m = random_matrix(2, 200, rng);
+    BitMatrix bm(m);
+    bool parity = false;
+    for (unsigned c = 0; c < 200; ++c) parity ^= m(0, c) && m(1, c);
+    REQUIRE(
+        BitMatrix::and_parity(
+            bm.row_data(0), bm.row_data(1), bm.words_per_row()) == parity);
+  }
+}
+
+SCENARIO("Gaussian elimination on bit-packed rows") {
+  std::mt19937 rng(2);
+  GIVEN("A random invertible matrix on several words") {
+    const unsigned n = 150;
+    MatrixXb m = MatrixXb::Identity(n, n);
+    for (unsigned k = 0; k < 20 * n; ++k) {
+      unsigned i = rng() % n, j = rng() % n;
+      if (i != j) m.row(j) = m.row(j).array() != m.row(i).array();
+    }
+    for (unsigned blocksize : {1u, 4u, 6u, 70u}) {
+      std::vector<std::pair<unsigned, unsigned>> ops =
+          gaussian_elimination_row_ops(BitMatrix(m), blocksize);
+      REQUIRE(ops == gaussian_elimination_row_ops(m, blocksize));
+      BitMatrix reduced(m);
+      for (const std::pair<unsigned, unsigned> &op : ops) {
+        reduced.xor_row(op.first, op.second);
+      }
+      REQUIRE(reduced.to_matrix() == MatrixXb::Identity(n, n));
+    }
+    // The block size suited to the size gives fewer operations
+    REQUIRE(pmh_blocksize(n) == 4);
+    REQUIRE(
+        gaussian_elimination_row_ops(BitMatrix(m), pmh_blocksize(n)).size() <
+        gaussian_elimination_row_ops(BitMatrix(m)).size());
+  }
+  GIVEN("A singular rectangular matrix") {
+    MatrixXb m = random_matrix(40, 90, rng);
+    m.row(0) = m.row(39);
+    BitMatrix reduced(m);
+    for (const std::pair<unsigned, unsigned> &op :
+         gaussian_elimination_row_ops(reduced, 5)) {
+      reduced.xor_row(op.first, op.second);
+    }
+    REQUIRE(reduced.row_is_zero(39));
+    // Each remaining row has a leading one to the right of the previous
+    int last_lead = -1;
+    for (unsigned r = 0; r < 39; ++r) {
+      int lead = 0;
+      while (!reduced(r, lead)) ++lead;
+      REQUIRE(lead > last_lead);
+      for (unsigned r2 = 0; r2 < 40; ++r2) {
+        if (r2 != r) REQUIRE_FALSE(reduced(r2, lead));
+      }
+      last_lead = lead;
+    }
+  }
+}
+
+}  // namespace test_BitMatrix
+}  // namespace tket
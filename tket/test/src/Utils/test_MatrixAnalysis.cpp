@@ -148,5 +148,25 @@ SCENARIO("Test unitary product") {
   }
 }
 
+SCENARIO("Permuting qubits in place") {
+  const Eigen::MatrixXcd m = random_unitary(8, 21).leftCols(3);
+  GIVEN("A non-trivial permutation") {
+    const qubit_map_t perm{
+        {Qubit(0), Qubit(1)}, {Qubit(1), Qubit(2)}, {Qubit(2), Qubit(0)}};
+    Eigen::MatrixXcd p = m;
+    const std::complex<double>* data = p.data();
+    apply_qubit_permutation_in_place(p, perm);
+    REQUIRE(p.isApprox(apply_qubit_permutation(m, perm)));
+    REQUIRE(p.data() == data);
+  }
+  GIVEN("The identity") {
+    const qubit_map_t perm{
+        {Qubit(0), Qubit(0)}, {Qubit(1), Qubit(1)}, {Qubit(2), Qubit(2)}};
+    Eigen::MatrixXcd p = m;
+    apply_qubit_permutation_in_place(p, perm);
+    REQUIRE(p == m);
+  }
+}
+
 }  // namespace test_MatrixAnalysis
 }  // namespace tket
@@ -0,0 +1,135 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <vector>
+
+#include "tket/Architecture/Architecture.hpp"
+#include "tket/Circuit/Boxes.hpp"
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Converters/Converters.hpp"
+#include "tket/Mapping/MappingFrontier.hpp"
+#include "tket/PauliGraph/PauliGraph.hpp"
+#include "tket/Predicates/CompilationUnit.hpp"
+#include "tket/Predicates/PassLibrary.hpp"
+#include "tket/Utils/MemoryUsage.hpp"
+#include "tket/ZX/ZXDiagram.hpp"
+
+namespace tket {
+namespace test_Utils {
+
+static Circuit layered_circuit(unsigned n_qubits, unsigned n_layers) {
+  Circuit circ(n_qubits);
+  for (unsigned l = 0; l < n_layers; l++) {
+    for (unsigned q = 0; q < n_qubits; q++) {
+      circ.add_op<unsigned>(OpType::Rz, 0.1 * (l + q), {q});
+    }
+    for (unsigned q = l % 2; q + 1 < n_qubits; q += 2) {
+      circ.add_op<unsigned>(OpType::CX, {q, q + 1});
+    }
+  }
+  return circ;
+}
+
+SCENARIO("Estimating the memory used by circuits") {
+  const Circuit small = layered_circuit(4, 2);
+  const Circuit large = layered_circuit(4, 20);
+  REQUIRE(small.memory_usage() > sizeof(Circuit));
+  REQUIRE(large.memory_usage() > small.memory_usage());
+  GIVEN("A copy") {
+    const Circuit copy(large);
+    REQUIRE(copy.memory_usage() == large.memory_usage());
+  }
+  GIVEN("Vertices sharing an op") {
+    Circuit shared(1);
+    Circuit distinct(1);
+    const Op_ptr op = get_op_ptr(OpType::Rz, 0.3);
+    for (unsigned i = 0; i < 10; i++) {
+      shared.add_op<unsigned>(op, {0});
+      distinct.add_op<unsigned>(OpType::Rz, 0.3, {0});
+    }
+    REQUIRE(shared.memory_usage() < distinct.memory_usage());
+  }
+  GIVEN("A box containing a circuit") {
+    Circuit outer(4);
+    const CircBox box(large);
+    outer.add_box(box, std::vector<unsigned>{0, 1, 2, 3});
+    REQUIRE(outer.memory_usage() > large.memory_usage());
+  }
+}
+
+SCENARIO("Estimating the memory used by other structures") {
+  GIVEN("A Pauli graph") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {0});
+    const PauliGraph pg1 = circuit_to_pauli_graph(circ);
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::Rx, 0.2, {1});
+    circ.add_op<unsigned>(OpType::Rz, 0.4, {2});
+    const PauliGraph pg3 = circuit_to_pauli_graph(circ);
+    REQUIRE(pg1.memory_usage() > sizeof(PauliGraph));
+    REQUIRE(pg3.memory_usage() > pg1.memory_usage());
+  }
+  GIVEN("A ZX diagram") {
+    zx::ZXDiagram diag(1, 1, 0, 0);
+    const std::size_t empty = diag.memory_usage();
+    const zx::ZXVert z = diag.add_vertex(zx::ZXType::ZSpider, 0.5);
+    diag.add_wire(diag.get_boundary()[0], z);
+    diag.add_wire(z, diag.get_boundary()[1]);
+    REQUIRE(diag.memory_usage() > empty);
+  }
+  GIVEN("An architecture with its distances") {
+    Architecture arc = RingArch(30);
+    const std::size_t thawed = arc.memory_usage();
+    arc.freeze(1);
+    // The distance matrix takes two bytes for each pair of nodes.
+    REQUIRE(arc.memory_usage() >= thawed + 30 * 30 * 2);
+  }
+  GIVEN("A mapping frontier") {
+    Circuit circ = layered_circuit(4, 2);
+    const MappingFrontier frontier(circ);
+    REQUIRE(frontier.memory_usage() > sizeof(MappingFrontier));
+  }
+}
+
+SCENARIO("Enforcing a memory budget") {
+  Circuit circ = layered_circuit(4, 4);
+  CompilationUnit cu(circ);
+  GIVEN("No budget") {
+    memory::check_budget(std::size_t(1) << 40);
+    REQUIRE_NOTHROW(SynthesiseTket()->apply(cu));
+  }
+  GIVEN("A budget too small for the circuit") {
+    memory::set_budget(memory::allocated_bytes() + 100);
+    REQUIRE_THROWS_AS(
+        SynthesiseTket()->apply(cu), memory::MemoryBudgetExceeded);
+    memory::set_budget(std::nullopt);
+    REQUIRE_NOTHROW(SynthesiseTket()->apply(cu));
+  }
+  GIVEN("Allocation tracking") {
+    if (memory::allocation_tracking_enabled()) {
+      const std::size_t before = memory::allocated_bytes();
+      const std::vector<char> block(1 << 20);
+      REQUIRE(memory::allocated_bytes() >= before + block.size());
+      REQUIRE(memory::peak_allocated_bytes() >= memory::allocated_bytes());
+    } else {
+      REQUIRE(memory::allocated_bytes() == 0);
+    }
+  }
+  memory::set_budget(std::nullopt);
+}
+
+}  // namespace test_Utils
+}  // namespace tket
@@ -0,0 +1,100 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "tket/Utils/Json.hpp"
+#include "tket/Utils/Trace.hpp"
+
+namespace tket {
+namespace test_Utils {
+
+SCENARIO("Recording trace events, counters and histograms") {
+  trace::reset();
+  const trace::Counter counter("test counter");
+  const trace::Histogram histogram("test histogram");
+  GIVEN("Recording switched off") {
+    trace::set_enabled(false);
+    {
+      const trace::ScopedTimer timer("test timer");
+      counter.add(5);
+      histogram.record(3);
+    }
+    REQUIRE(trace::counter_totals().at("test counter") == 0);
+    REQUIRE(trace::histogram_totals().at("test histogram")[2] == 0);
+  }
+  GIVEN("Several threads recording") {
+    trace::set_enabled(true);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < 4; t++) {
+      threads.emplace_back([&counter, &histogram] {
+        for (unsigned i = 0; i < 100; i++) {
+          const trace::ScopedTimer timer("test timer");
+          counter.add(2);
+          histogram.record(i);
+        }
+      });
+    }
+    for (std::thread &thread : threads) thread.join();
+    trace::set_enabled(false);
+    REQUIRE(trace::counter_totals().at("test counter") == 800);
+    const trace::histogram_t h = trace::histogram_totals().at("test histogram");
+    // Each thread records 0 once, 1 once, 2 and 3 twice, ..., 64 to 99 36
+    // times.
+    REQUIRE(h[0] == 4);
+    REQUIRE(h[1] == 4);
+    REQUIRE(h[2] == 8);
+    REQUIRE(h[7] == 4 * 36);
+    REQUIRE(h[8] == 0);
+    REQUIRE(trace::n_dropped_events() == 0);
+    WHEN("Writing a Chrome trace") {
+      std::stringstream ss;
+      trace::write_chrome_trace(ss);
+      const nlohmann::json j = nlohmann::json::parse(ss.str());
+      unsigned n_timer_events = 0;
+      for (const nlohmann::json &e : j.at("traceEvents")) {
+        if (e.at("name") == "test timer") {
+          REQUIRE(e.at("ph") == "X");
+          REQUIRE(e.at("dur").get<double>() >= 0);
+          n_timer_events++;
+        } else if (e.at("name") == "test counter") {
+          REQUIRE(e.at("ph") == "C");
+          REQUIRE(e.at("args").at("value") == 800);
+        }
+      }
+      REQUIRE(n_timer_events == 400);
+      REQUIRE(
+          j.at("otherData").at("histograms").at("test histogram").at(7) ==
+          4 * 36);
+    }
+    WHEN("Resetting") {
+      trace::reset();
+      REQUIRE(trace::counter_totals().at("test counter") == 0);
+      std::stringstream ss;
+      trace::write_chrome_trace(ss);
+      const nlohmann::json j = nlohmann::json::parse(ss.str());
+      for (const nlohmann::json &e : j.at("traceEvents")) {
+        REQUIRE(e.at("ph") != "X");
+      }
+    }
+  }
+  trace::set_enabled(false);
+  trace::reset();
+}
+
+}  // namespace test_Utils
+}  // namespace tket
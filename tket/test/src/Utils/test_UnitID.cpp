@@ -0,0 +1,59 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+
+#include "tket/Utils/UnitID.hpp"
+
+namespace tket {
+namespace test_Utils {
+
+SCENARIO("Interned UnitIDs") {
+  GIVEN("Units constructed separately with the same name and index") {
+    Qubit a("reg", 2, 3);
+    Qubit b("reg", {2, 3});
+    REQUIRE(a == b);
+    REQUIRE(a.handle() == b.handle());
+    REQUIRE(hash_value(a) == hash_value(b));
+    REQUIRE(a.repr() == "reg[2, 3]");
+    REQUIRE(Node(a) == a);
+  }
+  GIVEN("Units with different names or indices") {
+    REQUIRE(Qubit("reg", 0) != Qubit("reg", 1));
+    REQUIRE(Qubit("reg", 0) != Qubit("ref", 0));
+    REQUIRE(Qubit("reg", 0).handle() != Qubit("reg", 1).handle());
+  }
+  GIVEN("A set of units") {
+    // Ordering is lexicographic on name then index, regardless of the order
+    // in which units were first seen.
+    std::set<Qubit> qbs{
+        Qubit("z", 0), Qubit("b", 1), Qubit("b", 0), Qubit("a", 5),
+        Qubit("b", {0, 1})};
+    std::vector<Qubit> expected{
+        Qubit("a", 5), Qubit("b", 0), Qubit("b", {0, 1}), Qubit("b", 1),
+        Qubit("z", 0)};
+    REQUIRE(std::vector<Qubit>(qbs.begin(), qbs.end()) == expected);
+  }
+  GIVEN("A qubit and a bit with the same name and index") {
+    Qubit q("x", 0);
+    Bit c("x", 0);
+    REQUIRE(UnitID(q) == UnitID(c));
+    REQUIRE(q.type() == UnitType::Qubit);
+    REQUIRE(c.type() == UnitType::Bit);
+  }
+}
+
+}  // namespace test_Utils
+}  // namespace tket
@@ -479,6 +479,90 @@ SCENARIO("Test example sent by Korbinian Staudacher") {
   REQUIRE_NOTHROW(f.verify(diag));
 }
 
+SCENARIO("Pauli flow identification beyond a single word of vertices") {
+  // A cluster state on a 3 x 30 grid with alternating vertical links, so the
+  // linear systems have more than 64 rows and columns
+  const unsigned n_rows = 3, n_cols = 30;
+  ZXDiagram diag(n_rows, n_rows, 0, 0);
+  ZXVertVec ins = diag.get_boundary(ZXType::Input);
+  ZXVertVec outs = diag.get_boundary(ZXType::Output);
+  std::vector<ZXVertVec> grid(n_rows);
+  for (unsigned r = 0; r < n_rows; ++r) {
+    for (unsigned c = 0; c < n_cols; ++c) {
+      if (c + 1 == n_cols) {
+        grid[r].push_back(diag.add_vertex(ZXType::PX));
+      } else {
+        grid[r].push_back(diag.add_vertex(ZXType::XY, 0.1 * (r + c)));
+      }
+      if (c > 0) diag.add_wire(grid[r][c - 1], grid[r][c], ZXWireType::H);
+    }
+    diag.add_wire(ins.at(r), grid[r].front());
+    diag.add_wire(grid[r].back(), outs.at(r));
+  }
+  for (unsigned c = 1; c + 1 < n_cols; c += 2) {
+    unsigned r = (c / 2) % (n_rows - 1);
+    diag.add_wire(grid[r][c], grid[r + 1][c], ZXWireType::H);
+  }
+  REQUIRE(diag.is_MBQC());
+  Flow f = Flow::identify_pauli_flow(diag);
+  REQUIRE_NOTHROW(f.verify(diag));
+  for (unsigned r = 0; r < n_rows; ++r) CHECK(f.d(grid[r].back()) == 0);
+  std::set<ZXVertSeqSet> focussed = Flow::identify_focussed_sets(diag);
+  // Every measured vertex is determined, so nothing can be focussed
+  CHECK(focussed.empty());
+}
+
+SCENARIO("Updating a Pauli flow after local rewrites") {
+  // In - a - x - y - b - Out, with Hadamard wires between the vertices
+  ZXDiagram diag(1, 1, 0, 0);
+  ZXVert in = diag.get_boundary(ZXType::Input).front();
+  ZXVert out = diag.get_boundary(ZXType::Output).front();
+  ZXVert a = diag.add_vertex(ZXType::XY, 0.3);
+  ZXVert x = diag.add_vertex(ZXType::XY, 0.);
+  ZXVert y = diag.add_vertex(ZXType::XY, 0.);
+  ZXVert b = diag.add_vertex(ZXType::PX);
+  diag.add_wire(in, a);
+  diag.add_wire(a, x, ZXWireType::H);
+  diag.add_wire(x, y, ZXWireType::H);
+  diag.add_wire(y, b, ZXWireType::H);
+  diag.add_wire(b, out);
+  REQUIRE(diag.is_MBQC());
+  Flow f = Flow::identify_pauli_flow(diag);
+  REQUIRE_NOTHROW(f.verify(diag));
+  REQUIRE(f.d(a) == 3);
+
+  GIVEN("No changes") {
+    CHECK(f.update(diag, {}, {}));
+    REQUIRE_NOTHROW(f.verify(diag));
+  }
+  GIVEN("A forgotten correction set") {
+    f.c_[x] = {};
+    CHECK(f.update(diag, {x}, {}));
+    REQUIRE_NOTHROW(f.verify(diag));
+    CHECK(f.d(x) == 2);
+  }
+  GIVEN("Removing and reinserting an identity") {
+    diag.remove_vertex(x);
+    diag.remove_vertex(y);
+    diag.add_wire(a, b, ZXWireType::H);
+    CHECK(f.update(diag, {a, b}, {x, y}));
+    REQUIRE_NOTHROW(f.verify(diag));
+    CHECK(f.c(a).size() == 1);
+    CHECK(f.d(a) == 3);
+
+    diag.remove_wire(*diag.wire_between(a, b));
+    ZXVert x2 = diag.add_vertex(ZXType::XY, 0.);
+    ZXVert y2 = diag.add_vertex(ZXType::XY, 0.);
+    diag.add_wire(a, x2, ZXWireType::H);
+    diag.add_wire(x2, y2, ZXWireType::H);
+    diag.add_wire(y2, b, ZXWireType::H);
+    CHECK(f.update(diag, {a, b, x2, y2}, {}));
+    REQUIRE_NOTHROW(f.verify(diag));
+    CHECK(f.d(y2) == 1);
+    CHECK(f.d(x2) == 2);
+  }
+}
+
 }  // namespace test_flow
 
 }  // namespace zx
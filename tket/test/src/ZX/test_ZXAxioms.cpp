@@ -302,6 +302,53 @@ SCENARIO("Check rewrite combinators act the same as individual rewrites") {
   }
 }
 
+SCENARIO("Fusing spiders with numeric and symbolic phases") {
+  GIVEN("A chain of spiders with numeric phases") {
+    ZXDiagram diag(1, 1, 0, 0);
+    ZXVertVec ins = diag.get_boundary(ZXType::Input);
+    ZXVertVec outs = diag.get_boundary(ZXType::Output);
+    ZXVert prev = ins[0];
+    for (unsigned i = 0; i < 5; ++i) {
+      ZXVert z = diag.add_vertex(ZXType::ZSpider, 0.75);
+      diag.add_wire(prev, z);
+      prev = z;
+    }
+    diag.add_wire(prev, outs[0]);
+    CHECK(Rewrite::spider_fusion().apply(diag));
+    REQUIRE(diag.count_vertices(ZXType::ZSpider) == 1);
+    ZXVert z = diag.neighbours(ins[0]).at(0);
+    const PhasedGen& gen = diag.get_vertex_ZXGen<PhasedGen>(z);
+    REQUIRE(gen.get_numeric_param());
+    CHECK(*gen.get_numeric_param() == 1.75);
+    CHECK(gen.get_clifford_multiple() == std::nullopt);
+    CHECK(diag.get_vertex_ZXGen<PhasedGen>(z).get_param() == 1.75);
+  }
+  GIVEN("A chain including a symbolic phase") {
+    Sym a = SymEngine::symbol("a");
+    ZXDiagram diag(1, 1, 0, 0);
+    ZXVertVec ins = diag.get_boundary(ZXType::Input);
+    ZXVertVec outs = diag.get_boundary(ZXType::Output);
+    ZXVert z0 = diag.add_vertex(ZXType::ZSpider, 0.5);
+    ZXVert z1 = diag.add_vertex(ZXType::ZSpider, Expr(a));
+    ZXVert z2 = diag.add_vertex(ZXType::ZSpider, 1.);
+    diag.add_wire(ins[0], z0);
+    diag.add_wire(z0, z1);
+    diag.add_wire(z1, z2);
+    diag.add_wire(z2, outs[0]);
+    CHECK(Rewrite::spider_fusion().apply(diag));
+    REQUIRE(diag.count_vertices(ZXType::ZSpider) == 1);
+    ZXVert z = diag.neighbours(ins[0]).at(0);
+    const PhasedGen& gen = diag.get_vertex_ZXGen<PhasedGen>(z);
+    CHECK_FALSE(gen.get_numeric_param());
+    CHECK_FALSE(gen.get_clifford_multiple());
+    SymEngine::map_basic_basic sub_map;
+    sub_map[a] = Expr(0.25);
+    std::optional<double> val = eval_expr(gen.get_param().subs(sub_map));
+    REQUIRE(val);
+    CHECK(approx_eq(*val, 1.75));
+  }
+}
+
 }  // namespace test_ZXAxioms
 }  // namespace zx
 }  // namespace tket
@@ -18,6 +18,7 @@
 #include "../testutil.hpp"
 #include "tket/Converters/Converters.hpp"
 #include "tket/Gate/SymTable.hpp"
+#include "tket/ZX/Rewrite.hpp"
 namespace tket {
 namespace zx {
 namespace test_ZXConverters {
@@ -714,6 +715,45 @@ SCENARIO("Check converting circuits to diagrams") {
     REQUIRE_NOTHROW(zx.check_validity());
   }
 }
+SCENARIO("Converting circuits directly to graphlike diagrams") {
+  GIVEN("A circuit in the supported gate set") {
+    Circuit circ(4);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::T, {1});
+    circ.add_op<unsigned>(OpType::Rx, 0.3, {2});
+    circ.add_op<unsigned>(OpType::CZ, {1, 2});
+    circ.add_op<unsigned>(OpType::CZ, {1, 2});
+    circ.add_op<unsigned>(OpType::SWAP, {0, 2});
+    circ.add_op<unsigned>(OpType::Sdg, {0});
+    circ.add_op<unsigned>(OpType::H, {2});
+    circ.add_op<unsigned>(OpType::H, {2});
+    circ.add_op<unsigned>(OpType::CX, {2, 0});
+    circ.add_op<unsigned>(OpType::X, {1});
+    circ.add_op<unsigned>(OpType::Rz, 0.7, {1});
+    circ.add_op<unsigned>(OpType::H, {1});
+    boost::bimap<ZXVert, Vertex> bmap;
+    ZXDiagram diag = circuit_to_graphlike_zx(circ, &bmap);
+    REQUIRE_NOTHROW(diag.check_validity());
+    CHECK(diag.is_graphlike());
+    CHECK(diag.get_boundary().size() == 8);
+    CHECK(bmap.size() == 8);
+    CHECK_FALSE(Rewrite::io_extension().apply(diag));
+    CHECK_FALSE(Rewrite::separate_boundaries().apply(diag));
+    CHECK_FALSE(Rewrite::parallel_h_removal().apply(diag));
+    Rewrite::reduce_graphlike_form().apply(diag);
+    CHECK(Rewrite::to_MBQC_diag().apply(diag));
+    Circuit c = zx_to_circuit(diag);
+    CHECK(test_unitary_comparison(circ, c));
+  }
+  GIVEN("Unsupported circuits") {
+    Circuit circ(2, 1);
+    CHECK_THROWS_AS(circuit_to_graphlike_zx(circ), Unsupported);
+    Circuit ccx(3);
+    ccx.add_op<unsigned>(OpType::CCX, {0, 1, 2});
+    CHECK_THROWS_AS(circuit_to_graphlike_zx(ccx), Unsupported);
+  }
+}
 }  // namespace test_ZXConverters
 }  // namespace zx
 }  // namespace tket
@@ -19,6 +19,7 @@
 #include "tket/Converters/Converters.hpp"
 #include "tket/Transformations/Rebase.hpp"
 #include "tket/ZX/Flow.hpp"
+#include "tket/ZX/GraphLikeDiagram.hpp"
 #include "tket/ZX/Rewrite.hpp"
 
 namespace tket::zx::test_ZXExtraction {
@@ -279,4 +280,67 @@ SCENARIO("Round-trip Circuit-ZXDiagram-Circuit") {
   }
 }
 
+SCENARIO("Round-trip with compact graphlike reduction") {
+  GIVEN("Modular arithmetic") {
+    Circuit circ(5);
+    circ.add_op<unsigned>(OpType::CCX, {0, 1, 4});
+    circ.add_op<unsigned>(OpType::CCX, {2, 4, 3});
+    circ.add_op<unsigned>(OpType::CCX, {0, 1, 4});
+    Transforms::rebase_quil().apply(circ);
+    ZXDiagram diag;
+    boost::bimap<ZXVert, Vertex> bmap;
+    std::tie(diag, bmap) = circuit_to_zx(circ);
+    CHECK(Rewrite::to_graphlike_form().apply(diag));
+    GraphLikeDiagram compact(diag);
+    CHECK(compact.n_spiders() == diag.count_vertices(ZXType::ZSpider));
+    CHECK(compact.n_wires() == diag.n_wires());
+    ZXDiagram unchanged = compact.to_diagram();
+    REQUIRE_NOTHROW(unchanged.check_validity());
+    CHECK(unchanged.n_vertices() == diag.n_vertices());
+    CHECK(unchanged.n_wires() == diag.n_wires());
+
+    CHECK(Rewrite::reduce_graphlike_form_compact().apply(diag));
+    REQUIRE_NOTHROW(diag.check_validity());
+    CHECK(diag.is_graphlike());
+    CHECK(Rewrite::to_MBQC_diag().apply(diag));
+    Circuit c = zx_to_circuit(diag);
+    Transforms::rebase_quil().apply(c);
+    CHECK(test_unitary_comparison(circ, c));
+  }
+  GIVEN("A diagram which is not graphlike") {
+    ZXDiagram diag(1, 1, 0, 0);
+    ZXVertVec ins = diag.get_boundary(ZXType::Input);
+    ZXVertVec outs = diag.get_boundary(ZXType::Output);
+    ZXVert x = diag.add_vertex(ZXType::XSpider, 0.5);
+    diag.add_wire(ins[0], x);
+    diag.add_wire(x, outs[0]);
+    CHECK_FALSE(GraphLikeDiagram::can_convert(diag));
+    REQUIRE_THROWS_AS(GraphLikeDiagram(diag), ZXError);
+    CHECK_FALSE(Rewrite::reduce_graphlike_form_compact().apply(diag));
+  }
+}
+
+SCENARIO("Extracting a wide circuit") {
+  GIVEN("Layers of non-Clifford rotations and entangling gates") {
+    Circuit circ(6);
+    for (unsigned l = 0; l < 3; ++l) {
+      for (unsigned q = 0; q < 6; ++q) {
+        circ.add_op<unsigned>(OpType::H, {q});
+        circ.add_op<unsigned>(OpType::Rz, 0.1 * (q + 1) + 0.3 * l, {q});
+      }
+      for (unsigned q = l % 2; q + 1 < 6; q += 2) {
+        circ.add_op<unsigned>(OpType::CZ, {q, q + 1});
+      }
+    }
+    ZXDiagram diag;
+    boost::bimap<ZXVert, Vertex> bmap;
+    std::tie(diag, bmap) = circuit_to_zx(circ);
+    CHECK(Rewrite::to_graphlike_form().apply(diag));
+    Rewrite::reduce_graphlike_form().apply(diag);
+    CHECK(Rewrite::to_MBQC_diag().apply(diag));
+    Circuit c = zx_to_circuit(diag);
+    CHECK(test_unitary_comparison(circ, c));
+  }
+}
+
 }  // namespace tket::zx::test_ZXExtraction
@@ -13,9 +13,12 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <random>
 
+#include "../testutil.hpp"
 #include "tket/Converters/Converters.hpp"
 #include "tket/Transformations/Rebase.hpp"
+#include "tket/ZX/GraphLikeDiagram.hpp"
 #include "tket/ZX/Rewrite.hpp"
 
 namespace tket {
@@ -180,6 +183,122 @@ SCENARIO("Testing cases for internalising gadgets in MBQC") {
   }
 }
 
+SCENARIO("Pauli removal reaches a fixed point in a single application") {
+  // Interior Pauli spiders on a random graph, attached to the boundaries
+  // through non-Clifford spiders. Pivots keep creating new Pauli pairs among
+  // vertices which have already been checked.
+  std::mt19937 gen(3);
+  for (unsigned trial = 0; trial < 5; ++trial) {
+    const unsigned n_io = 4, n_interior = 30;
+    ZXDiagram diag(n_io, n_io, 0, 0);
+    ZXVertVec boundary = diag.get_boundary();
+    ZXVertVec edge_spiders, interior;
+    for (const ZXVert& b : boundary) {
+      ZXVert s = diag.add_vertex(ZXType::ZSpider, 0.25);
+      diag.add_wire(b, s);
+      edge_spiders.push_back(s);
+    }
+    for (unsigned i = 0; i < n_interior; ++i) {
+      interior.push_back(diag.add_vertex(ZXType::ZSpider, (gen() % 2) * 1.));
+    }
+    for (unsigned i = 0; i < n_interior; ++i) {
+      for (unsigned j = i + 1; j < n_interior; ++j) {
+        if (gen() % 6 == 0) {
+          diag.add_wire(interior[i], interior[j], ZXWireType::H);
+        }
+      }
+      diag.add_wire(
+          interior[i], edge_spiders[gen() % edge_spiders.size()],
+          ZXWireType::H);
+    }
+    REQUIRE(diag.is_graphlike());
+    GraphLikeDiagram compact(diag);
+    CHECK(Rewrite::remove_interior_paulis().apply(diag));
+    CHECK_FALSE(Rewrite::remove_interior_paulis().apply(diag));
+    REQUIRE_NOTHROW(diag.check_validity());
+    CHECK(compact.remove_interior_paulis());
+    CHECK_FALSE(compact.remove_interior_paulis());
+  }
+}
+
+SCENARIO("Simplifying disconnected components in parallel") {
+  GIVEN("A circuit made of two independent blocks") {
+    Circuit circ(4);
+    for (unsigned b = 0; b < 4; b += 2) {
+      circ.add_op<unsigned>(OpType::H, {b});
+      circ.add_op<unsigned>(OpType::CX, {b, b + 1});
+      circ.add_op<unsigned>(OpType::Rz, 0.3 + b, {b + 1});
+      circ.add_op<unsigned>(OpType::CX, {b + 1, b});
+      circ.add_op<unsigned>(OpType::Rz, 0.5, {b});
+      circ.add_op<unsigned>(OpType::CX, {b, b + 1});
+    }
+    ZXDiagram diag;
+    boost::bimap<ZXVert, Vertex> bmap;
+    std::tie(diag, bmap) = circuit_to_zx(circ);
+    CHECK(Rewrite::to_graphlike_form().apply(diag));
+    ZXDiagram serial = diag;
+    CHECK(Rewrite::reduce_graphlike_form().apply(serial));
+    CHECK(Rewrite::parallel_components(Rewrite::reduce_graphlike_form())
+              .apply(diag));
+    REQUIRE_NOTHROW(diag.check_validity());
+    CHECK(diag.get_boundary().size() == 8);
+    CHECK(diag.n_vertices() == serial.n_vertices());
+    CHECK(diag.n_wires() == serial.n_wires());
+    CHECK(Rewrite::to_MBQC_diag().apply(diag));
+    Circuit c = zx_to_circuit(diag);
+    CHECK(test_unitary_comparison(circ, c));
+  }
+  GIVEN("A connected diagram") {
+    ZXDiagram diag(1, 1, 0, 0);
+    ZXVertVec ins = diag.get_boundary(ZXType::Input);
+    ZXVertVec outs = diag.get_boundary(ZXType::Output);
+    ZXVert z = diag.add_vertex(ZXType::ZSpider, 0.3);
+    diag.add_wire(ins[0], z);
+    diag.add_wire(z, outs[0]);
+    CHECK_FALSE(Rewrite::parallel_components(Rewrite::spider_fusion())
+                    .apply(diag));
+    CHECK(diag.n_vertices() == 3);
+  }
+}
+
+SCENARIO("Recording statistics for rewrites") {
+  Circuit circ(3);
+  circ.add_op<unsigned>(OpType::CCX, {0, 1, 2});
+  Transforms::rebase_quil().apply(circ);
+  ZXDiagram diag;
+  boost::bimap<ZXVert, Vertex> bmap;
+  std::tie(diag, bmap) = circuit_to_zx(circ);
+  CHECK(Rewrite::to_graphlike_form().apply(diag));
+  unsigned n_vertices = diag.n_vertices();
+
+  auto stats = std::make_shared<RewriteStatistics>();
+  Rewrite clifford = Rewrite::with_statistics(
+      Rewrite::remove_interior_cliffords(), "clifford", stats);
+  Rewrite pauli = Rewrite::with_statistics(
+      Rewrite::remove_interior_paulis(), "pauli", stats);
+  Rewrite::repeat(Rewrite::sequence({clifford, pauli})).apply(diag);
+
+  std::map<std::string, RewriteRecord> records = stats->get_records();
+  REQUIRE(records.size() == 2);
+  const RewriteRecord& c_rec = records.at("clifford");
+  const RewriteRecord& p_rec = records.at("pauli");
+  CHECK(c_rec.n_applications == p_rec.n_applications);
+  CHECK(c_rec.n_applications >= 2);
+  CHECK(c_rec.n_successes < c_rec.n_applications);
+  CHECK(p_rec.n_successes < p_rec.n_applications);
+  CHECK(c_rec.seconds >= 0.);
+  unsigned long removed = c_rec.vertices_before - c_rec.vertices_after +
+                          p_rec.vertices_before - p_rec.vertices_after;
+  CHECK(removed > 0);
+  CHECK(removed == n_vertices - diag.n_vertices());
+
+  stats->clear();
+  CHECK(stats->get_records().empty());
+  REQUIRE_THROWS_AS(
+      Rewrite::with_statistics(Rewrite::spider_fusion(), "fusion", nullptr),
+      ZXError);
+}
+
 }  // namespace test_ZXSimp
 }  // namespace zx
 }  // namespace tket
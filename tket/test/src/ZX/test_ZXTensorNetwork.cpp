@@ -0,0 +1,145 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "../Simulation/ComparisonFunctions.hpp"
+#include "../testutil.hpp"
+#include "tket/Circuit/Simulation/CircuitSimulator.hpp"
+#include "tket/Converters/Converters.hpp"
+#include "tket/ZX/Rewrite.hpp"
+#include "tket/ZX/TensorNetwork.hpp"
+
+namespace tket {
+namespace zx {
+namespace test_ZXTensorNetwork {
+
+SCENARIO("Evaluating small diagrams") {
+  GIVEN("A pair of wires to test endianness") {
+    ZXDiagram diag(2, 2, 0, 0);
+    ZXVertVec ins = diag.get_boundary(ZXType::Input);
+    ZXVertVec outs = diag.get_boundary(ZXType::Output);
+    diag.add_wire(ins[0], outs[0]);
+    diag.add_wire(ins[1], outs[1], ZXWireType::H);
+    Eigen::MatrixXcd correct(4, 4);
+    correct << 1, 1, 0, 0, 1, -1, 0, 0, 0, 0, 1, 1, 0, 0, 1, -1;
+    Eigen::MatrixXcd evaluated = unitary_from_quantum_diagram(diag);
+    REQUIRE(evaluated.isApprox(correct));
+    REQUIRE(std::abs(amplitude_from_quantum_diagram(
+                         diag, {false, true, false, true}) +
+                     1.) < ERR_EPS);
+  }
+  GIVEN("A triangle") {
+    ZXDiagram diag(1, 1, 0, 0);
+    ZXVertVec boundary = diag.get_boundary();
+    ZXVert tri = diag.add_vertex(ZXType::Triangle);
+    diag.add_wire(
+        boundary[0], tri, ZXWireType::Basic, QuantumType::Quantum,
+        std::nullopt, 0);
+    diag.add_wire(
+        boundary[1], tri, ZXWireType::Basic, QuantumType::Quantum,
+        std::nullopt, 1);
+    Eigen::MatrixXcd correct(2, 2);
+    correct << 1, 0, 1, 1;
+    REQUIRE(unitary_from_quantum_diagram(diag).isApprox(correct));
+  }
+  GIVEN("A scalar diagram") {
+    ZXDiagram diag;
+    ZXVert z = diag.add_vertex(ZXType::ZSpider, 0.5);
+    diag.add_wire(z, z, ZXWireType::H);
+    diag.multiply_scalar(4.);
+    // A Hadamard self-loop adds a phase of 1
+    Eigen::VectorXcd t = tensor_from_quantum_diagram(diag);
+    REQUIRE(t.size() == 1);
+    REQUIRE(std::abs(t(0) - 2. * (1. - i_)) < ERR_EPS);
+  }
+  GIVEN("Unsupported diagrams") {
+    ZXDiagram diag(1, 1, 0, 0);
+    ZXVertVec boundary = diag.get_boundary();
+    Sym a = SymEngine::symbol("a");
+    ZXVert z = diag.add_vertex(ZXType::ZSpider, Expr(a));
+    diag.add_wire(boundary[0], z);
+    diag.add_wire(z, boundary[1]);
+    REQUIRE_THROWS_AS(TensorNetwork(diag), ZXError);
+    ZXDiagram classical(0, 0, 1, 1);
+    ZXVertVec c_boundary = classical.get_boundary();
+    classical.add_wire(
+        c_boundary[0], c_boundary[1], ZXWireType::Basic,
+        QuantumType::Classical);
+    REQUIRE_THROWS_AS(TensorNetwork(classical), ZXError);
+  }
+}
+
+SCENARIO("Evaluating diagrams from circuits") {
+  Circuit circ(3);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+  circ.add_op<unsigned>(OpType::CZ, {1, 2});
+  circ.add_op<unsigned>(OpType::Rx, 0.7, {2});
+  circ.add_op<unsigned>(OpType::T, {0});
+  circ.add_op<unsigned>(OpType::CX, {2, 0});
+  circ.add_op<unsigned>(OpType::H, {1});
+  ZXDiagram diag = circuit_to_zx(circ).first;
+  Eigen::MatrixXcd circ_u = tket_sim::get_unitary(circ);
+  Eigen::MatrixXcd diag_u = unitary_from_quantum_diagram(diag);
+  CHECK(tket_sim::compare_statevectors_or_unitaries(
+      circ_u, diag_u, tket_sim::MatrixEquivalence::EQUAL_UP_TO_GLOBAL_PHASE));
+  GIVEN("Multiple threads") {
+    REQUIRE(unitary_from_quantum_diagram(diag, 4).isApprox(diag_u));
+  }
+  GIVEN("A simplified diagram") {
+    Rewrite::to_graphlike_form().apply(diag);
+    Rewrite::reduce_graphlike_form().apply(diag);
+    REQUIRE(unitary_from_quantum_diagram(diag).isApprox(diag_u));
+  }
+}
+
+SCENARIO("Evaluating amplitudes of wide diagrams") {
+  // A GHZ state on more qubits than can be simulated as a unitary
+  const unsigned n = 24;
+  Circuit circ(n);
+  circ.add_op<unsigned>(OpType::H, {0});
+  for (unsigned q = 1; q < n; ++q) {
+    circ.add_op<unsigned>(OpType::CX, {q - 1, q});
+  }
+  ZXDiagram diag = circuit_to_zx(circ).first;
+  ZXVertVec boundary = diag.get_boundary();
+  std::vector<bool> zeros(boundary.size(), false);
+  std::vector<bool> ones(boundary.size(), false);
+  std::vector<bool> mixed(boundary.size(), false);
+  bool first_output = true;
+  for (unsigned i = 0; i < boundary.size(); ++i) {
+    if (diag.get_zxtype(boundary[i]) == ZXType::Output) {
+      ones[i] = true;
+      mixed[i] = first_output;
+      first_output = false;
+    }
+  }
+  Complex a0 = amplitude_from_quantum_diagram(diag, zeros);
+  Complex a1 = amplitude_from_quantum_diagram(diag, ones, 4);
+  REQUIRE(std::abs(std::abs(a0) - std::sqrt(0.5)) < ERR_EPS);
+  REQUIRE(std::abs(a1 - a0) < ERR_EPS);
+  REQUIRE(std::abs(amplitude_from_quantum_diagram(diag, mixed)) < ERR_EPS);
+  Rewrite::to_graphlike_form().apply(diag);
+  Rewrite::reduce_graphlike_form().apply(diag);
+  Complex b0 = amplitude_from_quantum_diagram(diag, zeros);
+  Complex b1 = amplitude_from_quantum_diagram(diag, ones);
+  REQUIRE(std::abs(b0 - a0) < ERR_EPS);
+  REQUIRE(std::abs(b1 - a1) < ERR_EPS);
+}
+
+}  // namespace test_ZXTensorNetwork
+}  // namespace zx
+}  // namespace tket
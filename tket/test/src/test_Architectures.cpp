@@ -133,6 +133,101 @@ SCENARIO("Diameters") {
   }
 }
 
+SCENARIO("Precomputed distance matrices") {
+  GIVEN("a square grid") {
+    const SquareGrid grid(4, 5, 2);
+    const node_vector_t nodes = grid.get_all_nodes_vec();
+    Architecture arc = grid;
+    REQUIRE(arc.get_distance_matrix() == nullptr);
+    std::shared_ptr<const DistanceMatrix> matrix = arc.precompute_distances(3);
+    REQUIRE(matrix->size() == nodes.size());
+    const Architecture copy = arc;
+    REQUIRE(copy.get_distance_matrix() == matrix);
+    for (const Node& n0 : nodes) {
+      for (const Node& n1 : nodes) {
+        const unsigned dist = grid.get_distance(n0, n1);
+        REQUIRE(copy.get_distance(n0, n1) == dist);
+        REQUIRE(
+            (*matrix)(copy.get_node_index(n0), copy.get_node_index(n1)) ==
+            dist);
+      }
+    }
+    WHEN("the architecture is modified") {
+      arc.add_connection(nodes.front(), nodes.back());
+      REQUIRE(arc.get_distance_matrix() == nullptr);
+      REQUIRE(arc.get_distance(nodes.front(), nodes.back()) == 1);
+      REQUIRE(copy.get_distance(nodes.front(), nodes.back()) > 1);
+    }
+  }
+  GIVEN("a disconnected architecture") {
+    Architecture arc({{0, 1}, {1, 2}, {3, 4}});
+    arc.precompute_distances();
+    REQUIRE(arc.get_distance(Node(0), Node(2)) == 2);
+    REQUIRE_THROWS_AS(
+        arc.get_distance(Node(0), Node(3)), NodesNotConnected<Node>);
+  }
+}
+
+SCENARIO("Frozen architectures") {
+  GIVEN("a ring") {
+    const RingArch ring(7);
+    Architecture arc = ring;
+    arc.freeze();
+    REQUIRE(arc.is_frozen());
+    REQUIRE(arc.get_distance_matrix() != nullptr);
+    REQUIRE(arc.get_diameter() == 3);
+    REQUIRE(arc.get_articulation_points() == ring.get_articulation_points());
+    for (const Node& n0 : ring.get_all_nodes_vec()) {
+      REQUIRE(arc.get_neighbour_nodes(n0) == ring.get_neighbour_nodes(n0));
+      REQUIRE(arc.get_distances(n0) == ring.get_distances(n0));
+    }
+    const Architecture copy = arc;
+    REQUIRE(copy.is_frozen());
+    REQUIRE_THROWS_AS(arc.add_connection(Node(0), Node(3)), std::logic_error);
+    REQUIRE_THROWS_AS(arc.remove_node(Node(0)), std::logic_error);
+  }
+  GIVEN("a disconnected architecture") {
+    Architecture arc({{0, 1}, {2, 3}});
+    arc.freeze();
+    CHECK_THROWS(arc.get_diameter());
+    CHECK_THROWS(arc.get_diameter());
+  }
+  GIVEN("a frozen copy being modified") {
+    Architecture arc({{0, 1}, {1, 2}});
+    arc.freeze();
+    Architecture copy = arc;
+    copy.thaw();
+    copy.add_connection(Node(0), Node(2));
+    REQUIRE(copy.get_distance(Node(0), Node(2)) == 1);
+    REQUIRE(copy.get_articulation_points().empty());
+    REQUIRE(arc.get_distance(Node(0), Node(2)) == 2);
+  }
+  GIVEN("serialisation with precomputed data") {
+    const SquareGrid grid(3, 4);
+    nlohmann::json j = architecture_to_json_with_precomputed(grid);
+    REQUIRE(j.at("precomputed").at("distances").size() == 66);
+    REQUIRE(j.at("precomputed").at("diameter") == 5);
+    Architecture loaded = j.get<Architecture>();
+    REQUIRE(loaded.is_frozen());
+    REQUIRE(loaded == grid);
+    REQUIRE(loaded.get_known_diameter() == 5);
+    REQUIRE(
+        loaded.get_articulation_points() == grid.get_articulation_points());
+    for (const Node& n0 : grid.get_all_nodes_vec()) {
+      REQUIRE(loaded.get_distances(n0) == grid.get_distances(n0));
+      REQUIRE(loaded.get_neighbour_nodes(n0) == grid.get_neighbour_nodes(n0));
+    }
+    // Without the precomputed data the loaded architecture is not frozen
+    j.erase("precomputed");
+    REQUIRE_FALSE(j.get<Architecture>().is_frozen());
+    Architecture line({{0, 1}, {1, 2}, {3, 4}});
+    nlohmann::json j_line = architecture_to_json_with_precomputed(line);
+    REQUIRE_FALSE(j_line.at("precomputed").contains("diameter"));
+    j_line["precomputed"]["distances"].push_back(1);
+    REQUIRE_THROWS_AS(j_line.get<Architecture>(), JsonError);
+  }
+}
+
 SCENARIO("connectivity") {
   GIVEN("simple architecture") {
     const Architecture archi(
@@ -162,6 +162,47 @@ SCENARIO(
   }
 }
 
+SCENARIO("Testing cached projector assertion synthesis") {
+  Eigen::MatrixXcd P1(2, 2);
+  P1 << 0, 0, 0, 1;
+  Eigen::MatrixXcd bell(4, 4);
+  bell << 0.5, 0, 0, 0.5, 0, 0, 0, 0, 0, 0, 0, 0, 0.5, 0, 0, 0.5;
+  Eigen::MatrixXcd P3 = Eigen::MatrixXcd::Zero(8, 8);
+  P3(0, 0) = 1;
+  P3(1, 1) = 1;
+  P3(7, 7) = 1;
+  GIVEN("Repeated synthesis of a projector") {
+    std::shared_ptr<const AssertionCircuit> first =
+        cached_projector_assertion(bell);
+    std::shared_ptr<const AssertionCircuit> second =
+        cached_projector_assertion(bell);
+    REQUIRE(first == second);
+    auto [c, expected_readouts] = projector_assertion_synthesis(bell);
+    c.decompose_boxes_recursively();
+    REQUIRE(first->circ == c);
+    REQUIRE(first->expected_readouts == expected_readouts);
+    ProjectorAssertionBox box(bell);
+    REQUIRE(*box.to_circuit() == first->circ);
+    REQUIRE(box.get_expected_readouts() == first->expected_readouts);
+  }
+  GIVEN("Parallel synthesis of several projectors") {
+    std::vector<std::shared_ptr<const AssertionCircuit>> results =
+        cached_projector_assertions({P1, bell, P3, P1, P3}, 3);
+    REQUIRE(results.size() == 5);
+    REQUIRE(results[0] == results[3]);
+    REQUIRE(results[2] == results[4]);
+    REQUIRE(results[1] == cached_projector_assertion(bell));
+    REQUIRE(results[0]->circ.n_qubits() == 1);
+    REQUIRE(results[2]->circ.n_qubits() == 3);
+    REQUIRE(results[2]->circ.count_gates(OpType::Unitary3qBox) == 0);
+  }
+  GIVEN("An invalid projector") {
+    Eigen::MatrixXcd Z = Eigen::MatrixXcd::Zero(2, 2);
+    REQUIRE_THROWS_AS(
+        cached_projector_assertions({P1, Z}, 2), CircuitInvalidity);
+  }
+}
+
 SCENARIO("Testing stabiliser based assertion") {
   GIVEN("Random stabilisers") {
     Circuit circ(3);
@@ -927,5 +927,117 @@ SCENARIO("Synthesis of circuits from ChoiMixTableaus") {
   }
 }
 
+SCENARIO("Canonical forms of ChoiMixTableaus") {
+  GIVEN("A tableau with its rows recombined") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::CZ, {1, 2});
+    circ.qubit_discard(Qubit(2));
+    ChoiMixTableau tab = circuit_to_cm_tableau(circ);
+    ChoiMixTableau other = tab;
+    other.tab_.row_mult(0, 1);
+    other.tab_.row_mult(2, 0);
+    REQUIRE_FALSE(tab == other);
+    REQUIRE(tab.canonical_form() == other.canonical_form());
+    REQUIRE(
+        tab.canonical_form().hash_value() ==
+        other.canonical_form().hash_value());
+    REQUIRE(tab.hash_value() == ChoiMixTableau(tab).hash_value());
+    WHEN("A different process is compared") {
+      other.apply_S(Qubit(0));
+      REQUIRE_FALSE(tab.canonical_form() == other.canonical_form());
+    }
+  }
+}
+
+SCENARIO("Sampling measurements from ChoiMixTableaus") {
+  RNG rng;
+  GIVEN("A GHZ state") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    ChoiMixTableau tab = circuit_to_cm_tableau(circ);
+    const ChoiMixTableau original = tab;
+    // The inputs are initialised in |0> for sampling
+    std::vector<std::vector<bool>> shots = tab.sample_measurements(200, rng);
+    REQUIRE(tab == original);
+    REQUIRE(shots.size() == 200);
+    unsigned n_ones = 0;
+    for (const std::vector<bool>& shot : shots) {
+      REQUIRE(shot.size() == 3);
+      REQUIRE(shot[0] == shot[1]);
+      REQUIRE(shot[1] == shot[2]);
+      n_ones += shot[0];
+    }
+    REQUIRE(n_ones > 50);
+    REQUIRE(n_ones < 150);
+    WHEN("Pauli observables are measured on the state") {
+      for (unsigned q = 0; q < 3; ++q) {
+        tab.post_select(Qubit(q), ChoiMixTableau::TableauSegment::Input);
+      }
+      const ChoiMixTableau state = tab;
+      SpPauliStabiliser xxx(
+          {{Qubit(0), Pauli::X}, {Qubit(1), Pauli::X}, {Qubit(2), Pauli::X}});
+      REQUIRE_FALSE(tab.measure_pauli(xxx, rng));
+      REQUIRE(tab == state);
+      SpPauliStabiliser minus_xxx = xxx;
+      minus_xxx.coeff = 2;
+      REQUIRE(tab.measure_pauli(minus_xxx, rng));
+      bool z0 = tab.measure_pauli(SpPauliStabiliser(Qubit(0), Pauli::Z), rng);
+      bool z2 = tab.measure_pauli(SpPauliStabiliser(Qubit(2), Pauli::Z), rng);
+      REQUIRE(z2 == z0);
+      for (const std::vector<bool>& shot : tab.sample_measurements(20, rng)) {
+        REQUIRE(shot == std::vector<bool>{z0, z0, z0});
+      }
+    }
+    WHEN("Invalid observables are measured") {
+      SpPauliStabiliser y(Qubit(0), Pauli::Y);
+      y.coeff = 1;
+      REQUIRE_THROWS_AS(tab.measure_pauli(y, rng), std::invalid_argument);
+      REQUIRE_THROWS_AS(
+          tab.measure_pauli(SpPauliStabiliser(Qubit(3), Pauli::Z), rng),
+          std::invalid_argument);
+    }
+  }
+  GIVEN("A unitary circuit with deterministic outcomes") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::X, {1});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::S, {0});
+    circ.add_op<unsigned>(OpType::S, {0});
+    circ.add_op<unsigned>(OpType::H, {0});
+    ChoiMixTableau tab = circuit_to_cm_tableau(circ);
+    for (const std::vector<bool>& shot : tab.sample_measurements(20, rng)) {
+      REQUIRE(shot == std::vector<bool>{true, true, true});
+    }
+  }
+  GIVEN("A mixed state") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    ChoiMixTableau tab = circuit_to_cm_tableau(circ);
+    for (unsigned q = 0; q < 2; ++q) {
+      tab.post_select(Qubit(q), ChoiMixTableau::TableauSegment::Input);
+    }
+    tab.discard_qubit(Qubit(1));
+    REQUIRE(tab.get_n_rows() == 0);
+    std::vector<bool> seen(2, false);
+    for (const std::vector<bool>& shot : tab.sample_measurements(50, rng)) {
+      REQUIRE(shot.size() == 1);
+      seen[shot[0]] = true;
+    }
+    REQUIRE(seen == std::vector<bool>{true, true});
+    // Z is not determined by the state, so its outcome becomes a stabilizer
+    bool z = tab.measure_pauli(SpPauliStabiliser(Qubit(0), Pauli::Z), rng);
+    REQUIRE(tab.get_n_rows() == 1);
+    for (const std::vector<bool>& shot : tab.sample_measurements(20, rng)) {
+      REQUIRE(shot[0] == z);
+    }
+  }
+}
+
 }  // namespace test_ChoiMixTableau
 }  // namespace tket
@@ -17,6 +17,7 @@
 #include "CircuitsForTesting.hpp"
 #include "Simulation/ComparisonFunctions.hpp"
 #include "tket/Circuit/Simulation/CircuitSimulator.hpp"
+#include "tket/Predicates/CompilerPass.hpp"
 #include "tket/Predicates/PassGenerators.hpp"
 #include "tket/Transformations/Combinator.hpp"
 #include "tket/Transformations/OptimisationPass.hpp"
@@ -62,5 +63,57 @@ SCENARIO("List sequencing") {
   }
 }
 
+SCENARIO("Repeating stops once the circuit stops changing") {
+  Circuit circ(2);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  // Replaces every H with a new H vertex, always reporting success
+  Circuit h(1);
+  h.add_op<unsigned>(OpType::H, {0});
+  unsigned n_calls = 0;
+  Transform replace_h([&n_calls, &h](Circuit& c) {
+    if (++n_calls > 10) return false;
+    VertexVec hs;
+    BGL_FORALL_VERTICES(v, c.dag, DAG) {
+      if (c.get_OpType_from_Vertex(v) == OpType::H) hs.push_back(v);
+    }
+    for (const Vertex& v : hs) {
+      c.substitute(h, v);
+    }
+    return true;
+  });
+  const Circuit original = circ;
+  GIVEN("Transforms::repeat") {
+    REQUIRE(Transforms::repeat(replace_h).apply(circ));
+    REQUIRE(n_calls == 1);
+    REQUIRE(circ == original);
+  }
+  GIVEN("Transforms::repeat_while") {
+    Transform always([](Circuit&) { return true; });
+    REQUIRE(Transforms::repeat_while(always, replace_h).apply(circ));
+    REQUIRE(n_calls == 1);
+  }
+  GIVEN("RepeatPass") {
+    PassPtr pass = std::make_shared<StandardPass>(
+        PredicatePtrMap{}, replace_h, PostConditions(),
+        nlohmann::json{{"name", "ReplaceH"}});
+    CompilationUnit cu(circ);
+    REQUIRE(std::make_shared<RepeatPass>(pass)->apply(cu));
+    REQUIRE(n_calls == 1);
+    n_calls = 0;
+    REQUIRE_FALSE(std::make_shared<RepeatPass>(pass, true)->apply(cu));
+    REQUIRE(n_calls == 1);
+  }
+  GIVEN("A transform that keeps changing the circuit") {
+    Transform add_x([](Circuit& c) {
+      if (c.n_gates() >= 5) return false;
+      c.add_op<unsigned>(OpType::X, {1});
+      return true;
+    });
+    REQUIRE(Transforms::repeat(add_x).apply(circ));
+    REQUIRE(circ.n_gates() == 5);
+  }
+}
+
 }  // namespace test_Combinators
 }  // namespace tket
@@ -14,7 +14,10 @@
 
 #include <algorithm>
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
 #include <memory>
+#include <sstream>
 #include <tkrng/RNG.hpp>
 #include <vector>
 
@@ -30,14 +33,20 @@
 #include "tket/OpType/OpTypeFunctions.hpp"
 #include "tket/Ops/ClassicalOps.hpp"
 #include "tket/Placement/Placement.hpp"
+#include "tket/Predicates/CachedPass.hpp"
 #include "tket/Predicates/CompilationUnit.hpp"
 #include "tket/Predicates/CompilerPass.hpp"
+#include "tket/Predicates/DistributedCompilation.hpp"
 #include "tket/Predicates/PassGenerators.hpp"
 #include "tket/Predicates/PassLibrary.hpp"
+#include "tket/Predicates/PassProfiler.hpp"
+#include "tket/Predicates/PassTuner.hpp"
+#include "tket/Predicates/SegmentedCompilation.hpp"
 #include "tket/Transformations/ContextualReduction.hpp"
 #include "tket/Transformations/MeasurePass.hpp"
 #include "tket/Transformations/OptimisationPass.hpp"
 #include "tket/Transformations/PauliOptimisation.hpp"
+#include "tket/Utils/Cancellation.hpp"
 #include "tket/Utils/Expression.hpp"
 #include "tket/Utils/UnitID.hpp"
 namespace tket {
@@ -495,6 +504,168 @@ SCENARIO("RepeatPass with strict checking") {
   CHECK(cu1.get_circ_ref() != circ);
 }
 
+SCENARIO("Apply a pass to a batch of compilation units") {
+  std::vector<Circuit> circs;
+  for (unsigned i = 0; i < 12; ++i) {
+    Circuit circ(3);
+    for (unsigned j = 0; j < 4 + i; ++j) {
+      circ.add_op<unsigned>(OpType::Rz, 0.1 * (i + j), {j % 3});
+      circ.add_op<unsigned>(OpType::CX, {j % 3, (j + 1) % 3});
+      circ.add_op<unsigned>(OpType::H, {(j + i) % 3});
+    }
+    circs.push_back(circ);
+  }
+  // One circuit the pass cannot improve
+  circs.push_back(Circuit(2));
+  PassPtr pp = FullPeepholeOptimise();
+  std::vector<CompilationUnit> serial, batch;
+  for (const Circuit& circ : circs) {
+    serial.emplace_back(circ);
+    batch.emplace_back(circ);
+  }
+  std::vector<bool> serial_results;
+  for (CompilationUnit& cu : serial) {
+    serial_results.push_back(pp->apply(cu));
+  }
+  GIVEN("Several threads") {
+    std::vector<bool> results = pp->apply_batch(batch, 4);
+    REQUIRE(results == serial_results);
+    REQUIRE_FALSE(results.back());
+    for (unsigned i = 0; i < circs.size(); ++i) {
+      REQUIRE(batch[i].get_circ_ref() == serial[i].get_circ_ref());
+    }
+  }
+  GIVEN("A single thread") {
+    std::vector<bool> results = pp->apply_batch(batch, 1);
+    REQUIRE(results == serial_results);
+    for (unsigned i = 0; i < circs.size(); ++i) {
+      REQUIRE(batch[i].get_circ_ref() == serial[i].get_circ_ref());
+    }
+  }
+  GIVEN("An empty batch") {
+    std::vector<CompilationUnit> empty;
+    REQUIRE(pp->apply_batch(empty).empty());
+  }
+  GIVEN("A unit that does not satisfy the preconditions") {
+    PredicatePtr gsp =
+        std::make_shared<GateSetPredicate>(OpTypeSet{OpType::CX});
+    PredicatePtrMap ppm{CompilationUnit::make_type_pair(gsp)};
+    PostConditions pc{{}, {}, Guarantee::Preserve};
+    PassPtr strict = std::make_shared<StandardPass>(
+        ppm, Transforms::id, pc, nlohmann::json{});
+    Circuit good(2);
+    good.add_op<unsigned>(OpType::CX, {0, 1});
+    std::vector<CompilationUnit> cus{good, circs[0], good};
+    REQUIRE_THROWS_AS(strict->apply_batch(cus, 2), UnsatisfiedPredicate);
+  }
+  GIVEN("A pass that fails on one unit") {
+    // Adds a phase, but fails on circuits with two qubits
+    Transform t([](Circuit& circ) {
+      if (circ.n_qubits() == 2) throw std::runtime_error("Two qubits");
+      circ.add_phase(0.5);
+      return true;
+    });
+    PostConditions pc{{}, {}, Guarantee::Preserve};
+    PassPtr failing = std::make_shared<StandardPass>(
+        PredicatePtrMap{}, t, pc, nlohmann::json{});
+    std::vector<CompilationUnit> cus;
+    for (unsigned i = 0; i < 8; ++i) cus.emplace_back(circs[i]);
+    cus.emplace_back(circs.back());
+    for (unsigned i = 0; i < 8; ++i) cus.emplace_back(circs[i]);
+    REQUIRE_THROWS_AS(failing->apply_batch(cus, 4), std::runtime_error);
+    // As in a serial loop, units before the failure are compiled and those
+    // after it are not.
+    for (unsigned i = 0; i < 8; ++i) {
+      REQUIRE(cus[i].get_circ_ref().get_phase() == 0.5);
+      REQUIRE(cus[9 + i].get_circ_ref() == circs[i]);
+    }
+  }
+}
+
+SCENARIO("CachedPass") {
+  SquareGrid grid(1, 5);
+  PassPtr route = gen_default_mapping_pass(grid, false);
+  Circuit circ(5);
+  add_2qb_gates(circ, OpType::CX, {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {3, 4}});
+  CompilationUnit expected(circ);
+  bool expected_rv = route->apply(expected);
+  GIVEN("Repeated circuits") {
+    auto cached = std::make_shared<CachedPass>(route, 2);
+    for (unsigned i = 0; i < 3; ++i) {
+      CompilationUnit cu(circ);
+      REQUIRE(cached->apply(cu) == expected_rv);
+      REQUIRE(cu.get_circ_ref() == expected.get_circ_ref());
+      REQUIRE(cu.get_initial_map_ref() == expected.get_initial_map_ref());
+      REQUIRE(cu.get_final_map_ref() == expected.get_final_map_ref());
+    }
+    REQUIRE(cached->misses() == 1);
+    REQUIRE(cached->hits() == 2);
+    REQUIRE(cached->size() == 1);
+    REQUIRE(cached->get_config() == route->get_config());
+    // A different circuit of the same shape is compiled afresh
+    Circuit other(5);
+    add_2qb_gates(other, OpType::CZ, {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {3, 4}});
+    CompilationUnit cu(other);
+    cached->apply(cu);
+    REQUIRE(cached->misses() == 2);
+    cached->clear();
+    REQUIRE(cached->size() == 0);
+    REQUIRE(cached->hits() == 0);
+  }
+  GIVEN("A unit that has already been routed") {
+    auto cached = std::make_shared<CachedPass>(route);
+    CompilationUnit cu(circ);
+    route->apply(cu);
+    cached->apply(cu);
+    REQUIRE(cached->hits() == 0);
+    REQUIRE(cached->misses() == 0);
+  }
+  GIVEN("A directory") {
+    std::filesystem::path dir =
+        std::filesystem::temp_directory_path() / "tket_test_CachedPass";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directory(dir);
+    {
+      CachedPass cached(route, 1, dir.string());
+      CompilationUnit cu(circ);
+      cached.apply(cu);
+      REQUIRE(cached.misses() == 1);
+    }
+    CachedPass reloaded(route, 1, dir.string());
+    CompilationUnit cu(circ);
+    REQUIRE(reloaded.apply(cu) == expected_rv);
+    REQUIRE(reloaded.hits() == 1);
+    REQUIRE(cu.get_circ_ref() == expected.get_circ_ref());
+    REQUIRE(cu.get_initial_map_ref() == expected.get_initial_map_ref());
+    REQUIRE(cu.get_final_map_ref() == expected.get_final_map_ref());
+    // Another pass does not pick up these results
+    CachedPass other(SynthesiseTket(), 1, dir.string());
+    CompilationUnit cu2(circ);
+    other.apply(cu2);
+    REQUIRE(other.misses() == 1);
+    std::filesystem::remove_all(dir);
+  }
+  GIVEN("A parameter sweep") {
+    Sym a = SymEngine::symbol("a");
+    Circuit templ(2);
+    templ.add_op<unsigned>(OpType::Rz, Expr(a), {0});
+    templ.add_op<unsigned>(OpType::CX, {0, 1});
+    templ.add_op<unsigned>(OpType::Rz, Expr(a), {0});
+    templ.add_op<unsigned>(OpType::CX, {0, 1});
+    CachedPass cached(SynthesiseTket());
+    for (double x : {0.1, 0.2, 0.3}) {
+      CompilationUnit cu(templ);
+      REQUIRE(cached.apply_with_substitution(cu, {{a, x}}));
+      REQUIRE(cu.get_circ_ref().free_symbols().empty());
+      Circuit point = templ;
+      point.symbol_substitution(symbol_map_t{{a, x}});
+      REQUIRE(test_unitary_comparison(point, cu.get_circ_ref(), true));
+    }
+    REQUIRE(cached.misses() == 1);
+    REQUIRE(cached.hits() == 2);
+  }
+}
+
 SCENARIO("Test RepeatWithMetricPass") {
   GIVEN("Monotonically decreasing pass") {
     PassPtr seq_p = RemoveRedundancies() >> CommuteThroughMultis();
@@ -2026,5 +2197,383 @@ SCENARIO(
     REQUIRE(cu.get_circ_ref().n_gates() == 1);
   }
 }
+SCENARIO("PassProfiler") {
+  Circuit circ(2);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  PassProfiler profiler;
+  GIVEN("Nested passes") {
+    PassPtr seq = std::make_shared<SequencePass>(std::vector<PassPtr>{
+        RemoveRedundancies(),
+        std::make_shared<RepeatPass>(RemoveRedundancies())});
+    CompilationUnit cu(circ);
+    REQUIRE(profiler.apply(seq, cu));
+    const std::vector<PassProfiler::Record>& records =
+        profiler.get_records();
+    REQUIRE(records.size() == 4);
+    CHECK(records[0].name == "SequencePass");
+    CHECK(records[1].name == "RemoveRedundancies");
+    CHECK(records[2].name == "RepeatPass");
+    CHECK(records[3].name == "RemoveRedundancies");
+    CHECK(!records[0].parent);
+    CHECK(records[1].parent == 0);
+    CHECK(records[3].parent == 2);
+    CHECK(records[1].modified);
+    CHECK(records[1].gates_before == 3);
+    CHECK(records[1].gates_after == 1);
+    CHECK(records[1].depth_after == 1);
+    CHECK(!records[3].modified);
+    CHECK(records[0].duration_us >= records[1].duration_us);
+    CHECK(records[2].start_us >= records[1].start_us);
+    nlohmann::json trace = profiler.to_trace_json();
+    REQUIRE(trace["traceEvents"].size() == 4);
+    CHECK(trace["traceEvents"][1]["ph"] == "X");
+    CHECK(trace["traceEvents"][1]["args"]["modified"] == true);
+    std::string folded = profiler.to_folded_stacks();
+    CHECK(folded.find("SequencePass ") != std::string::npos);
+    CHECK(
+        folded.find("SequencePass;RepeatPass;RemoveRedundancies ") !=
+        std::string::npos);
+    profiler.clear();
+    CHECK(profiler.get_records().empty());
+  }
+  GIVEN("A pass repeated with a metric") {
+    Transform::Metric metric = [](const Circuit& c) { return c.n_gates(); };
+    PassPtr rwm =
+        std::make_shared<RepeatWithMetricPass>(RemoveRedundancies(), metric);
+    CompilationUnit cu(circ);
+    profiler.apply(rwm, cu);
+    // Every application of the body is recorded
+    const std::vector<PassProfiler::Record>& records =
+        profiler.get_records();
+    REQUIRE(records.size() == 3);
+    CHECK(records[1].parent == 0);
+    CHECK(records[1].modified);
+    CHECK(!records[2].modified);
+  }
+}
+SCENARIO("Cancelling compilation") {
+  Circuit circ(2);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  GIVEN("Tokens") {
+    CancellationToken token;
+    REQUIRE_FALSE(token.is_cancelled());
+    CancellationToken copy = token;
+    copy.cancel();
+    REQUIRE(token.is_cancelled());
+    REQUIRE_THROWS_AS(token.throw_if_cancelled(), CompilationCancelled);
+    CancellationToken expired(std::chrono::seconds(0));
+    REQUIRE(expired.is_cancelled());
+    CancellationToken later(std::chrono::hours(1));
+    REQUIRE_FALSE(later.is_cancelled());
+    REQUIRE_NOTHROW(throw_if_cancelled());
+    {
+      CancellationScope scope(token);
+      REQUIRE_THROWS_AS(throw_if_cancelled(), CompilationCancelled);
+      {
+        CancellationScope inner(later);
+        REQUIRE_NOTHROW(throw_if_cancelled());
+      }
+      REQUIRE_THROWS_AS(throw_if_cancelled(), CompilationCancelled);
+    }
+    REQUIRE_NOTHROW(throw_if_cancelled());
+  }
+  GIVEN("A token cancelled before compiling") {
+    CompilationUnit cu(circ);
+    CancellationToken token;
+    token.cancel();
+    cu.set_cancellation_token(token);
+    REQUIRE_THROWS_AS(SynthesiseTket()->apply(cu), CompilationCancelled);
+    REQUIRE(cu.get_circ_ref() == circ);
+  }
+  GIVEN("A token cancelled during a transform") {
+    CancellationToken token;
+    Transform add_x([](Circuit& c) {
+      c.add_op<unsigned>(OpType::X, {1});
+      return true;
+    });
+    Transform cancel([token](Circuit&) {
+      token.cancel();
+      return false;
+    });
+    PredicatePtr gates = std::make_shared<GateSetPredicate>(
+        OpTypeSet{OpType::H, OpType::CX, OpType::X});
+    PassPtr pass = std::make_shared<StandardPass>(
+        PredicatePtrMap{}, add_x >> cancel >> add_x,
+        PostConditions({CompilationUnit::make_type_pair(gates)}),
+        nlohmann::json{{"name", "AddX"}});
+    CompilationUnit cu(circ, {gates});
+    cu.set_cancellation_token(token);
+    REQUIRE_THROWS_AS(pass->apply(cu), CompilationCancelled);
+    // The first transform was applied, but not the second
+    REQUIRE(cu.get_circ_ref().n_gates() == 4);
+    // Predicates are no longer assumed to hold
+    REQUIRE_FALSE(cu.get_cache_ref().begin()->second.second);
+  }
+  GIVEN("A repeated pass with a metric") {
+    CancellationToken token;
+    unsigned n_calls = 0;
+    Transform::Metric metric = [&n_calls, token](const Circuit& c) {
+      if (++n_calls == 2) token.cancel();
+      return c.n_gates();
+    };
+    PassPtr rwm =
+        std::make_shared<RepeatWithMetricPass>(RemoveRedundancies(), metric);
+    CompilationUnit cu(circ);
+    cu.set_cancellation_token(token);
+    REQUIRE_THROWS_AS(rwm->apply(cu), CompilationCancelled);
+    // The best result so far is kept
+    REQUIRE(cu.get_circ_ref().n_gates() == 1);
+  }
+}
+SCENARIO("Fusing local rewrites in a SequencePass") {
+  Circuit inner(2);
+  inner.add_op<unsigned>(OpType::H, {0});
+  inner.add_op<unsigned>(OpType::CX, {0, 1});
+  CircBox cbox(inner);
+  Circuit circ(2);
+  circ.add_box(cbox, {0, 1});
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::Rz, 0.25, {1});
+  circ.add_op<unsigned>(OpType::Rx, 0.5, {1});
+  circ.add_op<unsigned>(OpType::CZ, {0, 1});
+  std::vector<PassPtr> passes = {
+      DecomposeBoxes(), RebaseTket(), RemoveRedundancies(), SquashTK1(),
+      gen_clifford_simp_pass(), RemoveRedundancies()};
+  GIVEN("The plan") {
+    std::vector<PassPtr> plan = SequencePass::fuse_local_rewrites(passes);
+    REQUIRE(plan.size() == 3);
+    CHECK(plan[0]->get_config()["StandardPass"]["name"] == "FusedPass");
+    CHECK(plan[0]->get_config()["StandardPass"]["sequence"].size() == 4);
+    CHECK(plan[1] == passes[4]);
+    CHECK(plan[2] == passes[5]);
+  }
+  GIVEN("Applying the fused sequence") {
+    SequencePass seq(passes);
+    SequencePass fused(passes, true);
+    REQUIRE(fused.is_fused());
+    CHECK(fused.get_config() == seq.get_config());
+    CompilationUnit cu0(circ);
+    CompilationUnit cu1(circ);
+    CHECK(seq.apply(cu0) == fused.apply(cu1, SafetyMode::Audit));
+    CHECK(cu0.get_circ_ref() == cu1.get_circ_ref());
+    CHECK(cu1.check_all_predicates());
+  }
+}
+SCENARIO("PassTuner") {
+  Circuit circ(2);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+  PassPtr failing = CustomPass([](const Circuit&) -> Circuit {
+    throw std::runtime_error("Candidate failed");
+  });
+  std::vector<PassPtr> candidates = {DecomposeBoxes(), failing, SynthesiseTK()};
+  PassTuner tuner(candidates, PassTuner::two_qubit_gate_count());
+  GIVEN("Tuning on a circuit") {
+    CompilationUnit cu(circ);
+    REQUIRE(tuner.tune(cu, 2) == 2);
+    CHECK(cu.get_circ_ref().count_n_qubit_gates(2) == 0);
+    CHECK(tuner.get_winners().empty());
+  }
+  GIVEN("Recording winners per class of circuit") {
+    CompilationUnit cu0(circ);
+    REQUIRE(tuner.apply(cu0, "small") == 2);
+    REQUIRE(tuner.get_winner("small") == 2u);
+    CHECK(!tuner.get_winner("large"));
+    tuner.set_winner("large", 0);
+    CompilationUnit cu1(circ);
+    REQUIRE(tuner.apply(cu1, "large") == 0);
+    CHECK(cu1.get_circ_ref() == circ);
+    REQUIRE_THROWS_AS(tuner.set_winner("large", 3), std::out_of_range);
+  }
+  GIVEN("Only failing candidates") {
+    PassTuner bad({failing}, PassTuner::depth());
+    CompilationUnit cu(circ);
+    REQUIRE_THROWS_AS(bad.tune(cu), std::runtime_error);
+    CHECK(cu.get_circ_ref() == circ);
+  }
+  GIVEN("Estimated infidelity") {
+    DeviceCharacterisation characterisation(
+        {{Node("q", 0), 0.1}}, {{{Node("q", 0), Node("q", 1)}, 0.2}});
+    PassTuner::Metric metric = PassTuner::infidelity(characterisation);
+    Circuit c(2);
+    c.add_op<unsigned>(OpType::H, {0});
+    CHECK(std::abs(metric(c) - 0.1) < ERR_EPS);
+    c.add_op<unsigned>(OpType::CX, {0, 1});
+    CHECK(std::abs(metric(c) - 0.28) < ERR_EPS);
+    // No error is known on the reverse link
+    c.add_op<unsigned>(OpType::CX, {1, 0});
+    CHECK(std::abs(metric(c) - 0.28) < ERR_EPS);
+  }
+}
+SCENARIO("Compiling a JSON stream in segments") {
+  // Rotations on q[0] that only merge fully across segment boundaries, and
+  // pairs of CX gates that cancel.
+  Circuit circ(3, 1);
+  circ.set_name("segmented");
+  circ.add_phase(0.5);
+  for (unsigned i = 0; i < 20; i++) {
+    circ.add_op<unsigned>(OpType::Rz, 0.25, {0});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::H, {2});
+    circ.add_op<unsigned>(OpType::H, {2});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+  }
+  circ.add_op<unsigned>(OpType::Measure, {0, 0});
+  std::stringstream in;
+  in << nlohmann::json(circ);
+  GIVEN("A local pass") {
+    std::stringstream out;
+    REQUIRE(compile_json_stream(in, out, RemoveRedundancies(), 8, 2) > 10);
+    const Circuit result = nlohmann::json::parse(out.str()).get<Circuit>();
+    CompilationUnit cu(circ);
+    RemoveRedundancies()->apply(cu);
+    CHECK(result == cu.get_circ_ref());
+    CHECK(result.count_gates(OpType::CX) == 0);
+    CHECK(result.get_name() == "segmented");
+  }
+  GIVEN("A pass introducing implicit wire swaps") {
+    Circuit c(2);
+    for (unsigned i = 0; i < 6; i++) {
+      c.add_op<unsigned>(OpType::CX, {0, 1});
+      c.add_op<unsigned>(OpType::CX, {1, 0});
+      c.add_op<unsigned>(OpType::CX, {0, 1});
+      c.add_op<unsigned>(OpType::Rz, 0.1 * i, {0});
+    }
+    std::stringstream c_in;
+    c_in << nlohmann::json(c);
+    std::stringstream out;
+    compile_json_stream(c_in, out, FullPeepholeOptimise(), 10, 3);
+    const Circuit result = nlohmann::json::parse(out.str()).get<Circuit>();
+    REQUIRE(!result.has_implicit_wireswaps());
+    REQUIRE(test_unitary_comparison(c, result, true));
+  }
+  GIVEN("A pass renaming qubits") {
+    std::stringstream out;
+    PassPtr rename = gen_rename_qubits_pass({{Qubit(0), Qubit("a", 0)}});
+    REQUIRE_THROWS_AS(
+        compile_json_stream(in, out, rename, 8, 2), std::logic_error);
+  }
+  GIVEN("Empty segments") {
+    std::stringstream out;
+    REQUIRE_THROWS_AS(
+        compile_json_stream(in, out, RemoveRedundancies(), 0, 2),
+        std::invalid_argument);
+  }
+}
+SCENARIO("Compiling tasks on several workers") {
+  Circuit circ(3);
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::CX, {0, 2});
+  circ.add_op<unsigned>(OpType::CX, {1, 2});
+  const Architecture line({{Node(0), Node(1)}, {Node(1), Node(2)}});
+  const PassPtr routing = gen_default_mapping_pass(line, false);
+  std::vector<CompilationTask> tasks;
+  for (unsigned i = 0; i < 6; i++) {
+    const std::string n = std::to_string(i);
+    tasks.push_back(CompilationTask::make(
+        "route" + n, CompilationUnit(circ), routing, "line"));
+    tasks.push_back(CompilationTask::make(
+        "synth" + n, CompilationUnit(circ), SynthesiseTket()));
+  }
+  CompilationWorker worker0(2), worker1(1);
+  worker0.add_architecture("line", line);
+  worker1.add_architecture("line", line);
+  GIVEN("Working channels") {
+    tasks.push_back(CompilationTask::make(
+        "unknown", CompilationUnit(circ), routing, "ring"));
+    CompilationCoordinator coordinator(
+        {[&worker0](const std::vector<std::uint8_t>& request) {
+           return worker0.handle(request);
+         },
+         [&worker1](const std::vector<std::uint8_t>& request) {
+           return worker1.handle(request);
+         }},
+        4);
+    const std::vector<CompilationResult> results = coordinator.run(tasks);
+    REQUIRE(results.size() == 13);
+    CompilationUnit expected(circ);
+    SynthesiseTket()->apply(expected);
+    for (unsigned i = 0; i < 12; i++) {
+      REQUIRE(results[i].id == tasks[i].id);
+      REQUIRE(!results[i].error);
+      CHECK(results[i].seconds >= 0);
+      const CompilationUnit cu = results[i].get_unit();
+      if (i % 2 == 0) {
+        CHECK(ConnectivityPredicate(line).verify(cu.get_circ_ref()));
+      } else {
+        CHECK(cu.get_circ_ref() == expected.get_circ_ref());
+      }
+    }
+    REQUIRE(results[12].error);
+    REQUIRE_THROWS_AS(results[12].get_unit(), std::runtime_error);
+    // Each pass is deserialised at most once on each worker.
+    CHECK(worker0.n_passes() + worker1.n_passes() <= 4);
+  }
+  GIVEN("A broken channel") {
+    CompilationCoordinator coordinator(
+        {[](const std::vector<std::uint8_t>&) -> std::vector<std::uint8_t> {
+          throw std::runtime_error("connection lost");
+        }});
+    const std::vector<CompilationResult> results = coordinator.run(tasks);
+    for (const CompilationResult& result : results) {
+      REQUIRE(result.error == "Worker 0 failed: connection lost");
+    }
+  }
+  GIVEN("Tasks sent as bytes") {
+    const CompilationTask task = CompilationTask::deserialize(
+        nlohmann::json::from_msgpack(
+            nlohmann::json::to_msgpack(tasks[0].serialize())));
+    REQUIRE(task.id == "route0");
+    REQUIRE(task.unit == tasks[0].unit);
+    REQUIRE(task.architecture_id == "line");
+    const std::vector<CompilationResult> results = worker1.run({task});
+    REQUIRE(!results[0].error);
+    REQUIRE(results[0].modified);
+  }
+}
+SCENARIO("Fast compilation to an architecture") {
+  const SquareGrid grid(3, 4);
+  Circuit circ(10);
+  for (unsigned i = 0; i < 40; i++) {
+    circ.add_op<unsigned>(OpType::H, {i % 10});
+    circ.add_op<unsigned>(OpType::CX, {i % 10, (3 * i + 5) % 10});
+    circ.add_op<unsigned>(OpType::Rz, 0.1 * i, {(3 * i + 5) % 10});
+  }
+  circ.add_op<unsigned>(OpType::CCX, {0, 4, 8});
+  const PassPtr pass = gen_fast_compile_pass(grid);
+  CompilationUnit cu(circ);
+  REQUIRE(pass->apply(cu));
+  const Circuit& result = cu.get_circ_ref();
+  REQUIRE(ConnectivityPredicate(grid).verify(result));
+  REQUIRE(GateSetPredicate({OpType::CX, OpType::TK1}).verify(result));
+  GIVEN("A serialised pass") {
+    const nlohmann::json j = pass;
+    const PassPtr loaded = j.get<PassPtr>();
+    REQUIRE(nlohmann::json(loaded) == j);
+    CompilationUnit cu_loaded(circ);
+    loaded->apply(cu_loaded);
+    // The routing budget makes the result depend on timing, so only check
+    // that it is valid.
+    REQUIRE(ConnectivityPredicate(grid).verify(cu_loaded.get_circ_ref()));
+  }
+  GIVEN("No time for routing with lookahead") {
+    // With a budget of 1 ms, routing falls back to no lookahead as soon as
+    // the budget is exhausted, and still routes the whole circuit.
+    Circuit big(10);
+    for (unsigned i = 0; i < 2000; i++) {
+      big.add_op<unsigned>(OpType::CX, {i % 10, (7 * i + 3) % 10});
+    }
+    CompilationUnit cu_big(big);
+    gen_fast_compile_pass(grid, 1)->apply(cu_big);
+    REQUIRE(ConnectivityPredicate(grid).verify(cu_big.get_circ_ref()));
+  }
+}
 }  // namespace test_CompilerPass
 }  // namespace tket
@@ -191,6 +191,26 @@ SCENARIO("Create and Discard operations") {
     REQUIRE(c.count_gates(OpType::X) == 2);
     REQUIRE(c.count_gates(OpType::ESWAP) == 0);
   }
+  GIVEN("Circuit where known states are lost and regained") {
+    Circuit c(2, 1);
+    c.qubit_create_all();
+    c.add_op<unsigned>(OpType::X, {0});
+    c.add_op<unsigned>(OpType::Measure, {0, 0});
+    c.add_op<unsigned>(OpType::X, {0});
+    c.add_op<unsigned>(OpType::H, {1});
+    c.add_op<unsigned>(OpType::CX, {1, 0});
+    c.add_op<unsigned>(OpType::Reset, {0});
+    c.add_op<unsigned>(OpType::CX, {0, 1});
+    c.add_op<unsigned>(OpType::Reset, {1});
+    c.add_op<unsigned>(OpType::CX, {0, 1});
+    REQUIRE(Transforms::simplify_initial().apply(c));
+    REQUIRE(c.count_gates(OpType::Measure) == 0);
+    REQUIRE(c.count_gates(OpType::SetBits) == 1);
+    REQUIRE(c.count_gates(OpType::X) == 2);
+    REQUIRE(c.count_gates(OpType::H) == 1);
+    REQUIRE(c.count_gates(OpType::CX) == 2);
+    REQUIRE(c.count_gates(OpType::Reset) == 2);
+  }
   GIVEN("Permutation of computational basis defined by a Unitary2qBox") {
     Eigen::Matrix4cd m;
     m << 1, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0;
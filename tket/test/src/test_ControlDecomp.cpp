@@ -905,5 +905,96 @@ SCENARIO("Test cnx_pairwise_decomposition") {
   }
 }
 
+// CnX on the first n+1 of 2n-1 qubits
+static Circuit cnx_with_ancillas(unsigned n) {
+  Circuit circ(2 * n - 1);
+  std::vector<unsigned> args(n + 1);
+  std::iota(args.begin(), args.end(), 0);
+  circ.add_op<unsigned>(OpType::CnX, args);
+  return circ;
+}
+
+SCENARIO("Test CnX decompositions using ancillae") {
+  GIVEN("V-chain with borrowed qubits") {
+    for (unsigned n = 3; n < 6; ++n) {
+      Circuit circ = CircPool::CnX_vchain_decomp(n);
+      REQUIRE(circ.n_qubits() == 2 * n - 1);
+      REQUIRE(circ.count_gates(OpType::CX) == 12 * n - 18);
+      auto u = tket_sim::get_unitary(circ);
+      auto v = tket_sim::get_unitary(cnx_with_ancillas(n));
+      REQUIRE(u.isApprox(v));
+    }
+  }
+  GIVEN("Log-depth with ancillae in the zero state") {
+    for (unsigned n = 3; n < 6; ++n) {
+      Circuit circ = CircPool::CnX_log_depth_decomp(n);
+      REQUIRE(circ.n_qubits() == 2 * n - 1);
+      REQUIRE(circ.count_gates(OpType::CX) == 6 * n - 6);
+      auto u = tket_sim::get_unitary(circ);
+      auto v = tket_sim::get_unitary(cnx_with_ancillas(n));
+      // Ancillae are the least significant qubits
+      const unsigned n_anc_states = 1u << (n - 2);
+      for (unsigned i = 0; i < u.cols(); i += n_anc_states) {
+        REQUIRE(u.col(i).isApprox(v.col(i)));
+      }
+    }
+  }
+  GIVEN("Too few controls") {
+    REQUIRE_THROWS_AS(
+        CircPool::CnX_vchain_decomp(2), CircPool::ControlDecompError);
+    REQUIRE_THROWS_AS(
+        CircPool::CnX_log_depth_decomp(2), CircPool::ControlDecompError);
+  }
+}
+
+SCENARIO("Test cnx_ancilla_decomposition") {
+  GIVEN("A CnX with idle qubits in arbitrary states") {
+    Circuit circ(8);
+    circ.add_op<unsigned>(OpType::H, {6});
+    circ.add_op<unsigned>(OpType::CnX, {0, 1, 2, 3, 4});
+    circ.add_op<unsigned>(OpType::CX, {6, 5});
+    auto u = tket_sim::get_unitary(circ);
+    REQUIRE(Transforms::cnx_ancilla_decomposition().apply(circ));
+    REQUIRE(circ.count_gates(OpType::CnX) == 0);
+    REQUIRE(circ.count_gates(OpType::CX) == 12 * 4 - 18 + 1);
+    auto v = tket_sim::get_unitary(circ);
+    REQUIRE(u.isApprox(v));
+  }
+  GIVEN("A CnX with idle qubits in the zero state") {
+    Circuit circ(9);
+    for (unsigned q = 0; q < 5; ++q) {
+      circ.add_op<unsigned>(OpType::H, {q});
+    }
+    circ.add_op<unsigned>(OpType::CnX, {0, 1, 2, 3, 4, 5});
+    circ.qubit_create(Qubit(6));
+    circ.qubit_create(Qubit(7));
+    circ.qubit_create(Qubit(8));
+    auto sv = tket_sim::get_statevector(circ);
+    REQUIRE(Transforms::cnx_ancilla_decomposition().apply(circ));
+    REQUIRE(circ.count_gates(OpType::CnX) == 0);
+    REQUIRE(circ.count_gates(OpType::CX) == 6 * 5 - 6);
+    REQUIRE(sv.isApprox(tket_sim::get_statevector(circ)));
+  }
+  GIVEN("A CnX without enough idle qubits") {
+    Circuit circ(7);
+    circ.add_op<unsigned>(OpType::CnX, {0, 1, 2, 3, 4});
+    circ.add_op<unsigned>(OpType::CX, {5, 6});
+    REQUIRE_FALSE(Transforms::cnx_ancilla_decomposition().apply(circ));
+    REQUIRE(circ.count_gates(OpType::CnX) == 1);
+  }
+  GIVEN("Several CnX sharing idle qubits") {
+    Circuit circ(10);
+    circ.add_op<unsigned>(OpType::CnX, {0, 1, 2, 3, 4});
+    circ.add_op<unsigned>(OpType::CnX, {4, 3, 2, 1, 0});
+    circ.add_op<unsigned>(OpType::CX, {4, 5});
+    circ.add_op<unsigned>(OpType::CnX, {5, 6, 7, 8, 9});
+    auto u = tket_sim::get_unitary(circ);
+    REQUIRE(Transforms::cnx_ancilla_decomposition().apply(circ));
+    REQUIRE(circ.count_gates(OpType::CnX) == 0);
+    auto v = tket_sim::get_unitary(circ);
+    REQUIRE(u.isApprox(v));
+  }
+}
+
 }  // namespace test_ControlDecomp
 }  // namespace tket
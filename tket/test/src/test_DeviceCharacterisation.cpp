@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <optional>
 
 #include "tket/Characterisation/DeviceCharacterisation.hpp"
 #include "tket/OpType/OpDesc.hpp"
@@ -55,5 +56,74 @@ SCENARIO("Does Device correctly hold and return error information") {
   }
 }
 
+SCENARIO("Compiled characterisation lookups") {
+  const Node n0{0}, n1{1}, n2{2}, n3{3};
+  const op_node_errors_t node_errors{
+      {n0, {{OpType::X, 0.1}, {OpType::H, 0.2}}}, {n2, {{OpType::Rz, 0.3}}}};
+  const op_link_errors_t link_errors{
+      {{n0, n1}, {{OpType::CX, 0.4}}},
+      {{n1, n0}, {{OpType::CX, 0.5}, {OpType::ZZMax, 0.6}}},
+      {{n2, n1}, {{OpType::ZZMax, 0.7}}}};
+  const avg_readout_errors_t readout_errors{{n3, 0.8}};
+  const DeviceCharacterisation characterisation(
+      node_errors, link_errors, readout_errors);
+  const CompiledCharacterisation& compiled = characterisation.get_compiled();
+
+  GIVEN("Nodes") {
+    REQUIRE(compiled.n_nodes() == 4);
+    for (const Node& n : {n0, n1, n2, n3}) {
+      const std::optional<unsigned> id = compiled.node_id(n);
+      REQUIRE(id);
+      CHECK(compiled.get_node(*id) == n);
+    }
+    CHECK_FALSE(compiled.node_id(Node(4)));
+  }
+  GIVEN("Single-qubit errors") {
+    const unsigned i0 = *compiled.node_id(n0), i2 = *compiled.node_id(n2);
+    CHECK(compiled.get_error(i0, OpType::X) == 0.1);
+    CHECK(compiled.get_error(i0, OpType::H) == 0.2);
+    CHECK(compiled.get_error(i0, OpType::Rz) == 0.);
+    CHECK(compiled.get_error(i2, OpType::Rz) == 0.3);
+    CHECK(compiled.get_error(i2, OpType::Y) == 0.);
+    CHECK(characterisation.get_error(n0, OpType::H) == 0.2);
+    CHECK(characterisation.get_error(Node(4), OpType::H) == 0.);
+    CHECK(
+        characterisation.get_readout_error(n3) ==
+        compiled.get_readout_error(*compiled.node_id(n3)));
+    CHECK(characterisation.get_readout_error(n3) == 0.8);
+    CHECK(characterisation.get_readout_error(n0) == 0.);
+  }
+  GIVEN("Two-qubit errors") {
+    const unsigned i0 = *compiled.node_id(n0), i1 = *compiled.node_id(n1),
+                   i2 = *compiled.node_id(n2), i3 = *compiled.node_id(n3);
+    CHECK(compiled.get_error(i0, i1, OpType::CX) == 0.4);
+    CHECK(compiled.get_error(i1, i0, OpType::CX) == 0.5);
+    CHECK(compiled.get_error(i1, i0, OpType::ZZMax) == 0.6);
+    CHECK(compiled.get_error(i0, i1, OpType::ZZMax) == 0.);
+    CHECK(compiled.get_error(i2, i1, OpType::ZZMax) == 0.7);
+    CHECK(compiled.get_error(i1, i2, OpType::ZZMax) == 0.);
+    CHECK(compiled.get_error(i0, i3, OpType::CX) == 0.);
+    CHECK(characterisation.get_error({n1, n0}, OpType::ZZMax) == 0.6);
+    CHECK(characterisation.get_error({n1, Node(4)}, OpType::CX) == 0.);
+  }
+  GIVEN("Default errors") {
+    const DeviceCharacterisation avg_characterisation(
+        {{n0, 0.1}, {n1, 0.2}}, {{{n0, n1}, 0.3}}, {{n1, 0.4}});
+    CHECK(avg_characterisation.get_error(n0) == 0.1);
+    CHECK(avg_characterisation.get_error(n1, OpType::X) == 0.2);
+    CHECK(avg_characterisation.get_error({n0, n1}) == 0.3);
+    CHECK(avg_characterisation.get_error({n0, n1}, OpType::CX) == 0.3);
+    CHECK(avg_characterisation.get_error({n1, n0}) == 0.);
+    CHECK(avg_characterisation.get_readout_error(n1) == 0.4);
+  }
+  GIVEN("A JSON round trip") {
+    const nlohmann::json j = characterisation;
+    const DeviceCharacterisation loaded = j.get<DeviceCharacterisation>();
+    REQUIRE(loaded == characterisation);
+    CHECK(loaded.get_error({n2, n1}, OpType::ZZMax) == 0.7);
+    CHECK(loaded.get_readout_error(n3) == 0.8);
+  }
+}
+
 }  // namespace test_DeviceCharacterisation
 }  // namespace tket
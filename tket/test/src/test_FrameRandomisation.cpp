@@ -102,6 +102,34 @@ SCENARIO(
     std::vector<Cycle> cycles = fr_tester.get_cycles(circ);
     REQUIRE(cycles.size() == 50);
   }
+  GIVEN("A wide circuit with many layers.") {
+    const unsigned n_qubits = 60;
+    const unsigned n_layers = 100;
+    Circuit circ(n_qubits);
+    for (unsigned layer = 0; layer < n_layers; layer++) {
+      for (unsigned q = 0; q < n_qubits; q++) {
+        circ.add_op<unsigned>(OpType::X, {q});
+        circ.add_op<unsigned>(OpType::H, {q});
+      }
+      // alternate the pairing so that neighbouring layers overlap
+      for (unsigned q = layer % 2; q + 1 < n_qubits; q += 2) {
+        circ.add_op<unsigned>(OpType::CX, {q, q + 1});
+      }
+    }
+    std::vector<Cycle> cycles = fr_tester.get_cycles(circ);
+    // odd layers have one pair fewer, and leave the first and last qubits
+    // with a lone H
+    const unsigned n_pairs = n_qubits / 2;
+    REQUIRE(cycles.size() == n_layers * n_pairs + n_layers / 2);
+    unsigned n_coms = 0;
+    for (const Cycle& cycle : cycles) {
+      const unsigned size = cycle.size();
+      CHECK((size == 1 || size == 2));
+      CHECK(cycle.coms_.size() == 2 * size - 1);
+      n_coms += cycle.coms_.size();
+    }
+    REQUIRE(n_coms == circ.n_gates() - n_layers * n_qubits);
+  }
 }
 
 SCENARIO("Test that get_out_frame returns the expected result.") {
@@ -433,5 +461,97 @@ SCENARIO("Frame Randomisation non-real DAG") {
   }
 }
 
+SCENARIO("Sampling frames from a FrameTemplate") {
+  UniversalFrameRandomisation ufr;
+  Circuit circ(3);
+  circ.add_op<unsigned>(OpType::Rz, 0.2, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::H, {1});
+  circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+  circ.add_op<unsigned>(OpType::CX, {1, 2});
+  circ.add_op<unsigned>(OpType::T, {2});
+  circ.add_op<unsigned>(OpType::CX, {2, 0});
+  FrameTemplate frame_template = ufr.make_template(circ);
+  unsigned frame_qubits = 0;
+  for (unsigned size : frame_template.get_frame_sizes()) frame_qubits += size;
+  REQUIRE(frame_template.n_slots() == 2 * frame_qubits);
+  GIVEN("All frames") {
+    const std::vector<FrameSample> frames =
+        ufr.get_all_frames(frame_template);
+    const std::vector<Circuit> all_circuits = ufr.get_all_circuits(circ);
+    REQUIRE(frames.size() == all_circuits.size());
+    for (unsigned i = 0; i < frames.size(); i++) {
+      REQUIRE(frames[i].slot_types.size() == frame_template.n_slots());
+      REQUIRE(frame_template.materialise(frames[i]) == all_circuits[i]);
+    }
+  }
+  GIVEN("Sampled frames") {
+    const std::vector<FrameSample> frames =
+        ufr.sample_frames(frame_template, 200);
+    REQUIRE(frames.size() == 200);
+    unsigned n_daggered = 0;
+    std::vector<Circuit> circuits;
+    frame_template.for_each_circuit(frames, [&](const Circuit& c) {
+      REQUIRE(test_unitary_comparison(c, circ, true));
+      REQUIRE(Circuit::from_binary(c.to_binary()) == c);
+      n_daggered += frames[circuits.size()].daggered.size();
+      circuits.push_back(c);
+    });
+    REQUIRE(circuits.size() == 200);
+    REQUIRE(n_daggered > 0);
+    // Daggered gates are restored between samples, so order does not matter
+    for (unsigned i = frames.size(); i-- > 0;) {
+      REQUIRE(frame_template.materialise(frames[i]) == circuits[i]);
+    }
+  }
+}
+
+SCENARIO("Seeded parallel frame sampling") {
+  Circuit circ(3);
+  circ.add_op<unsigned>(OpType::Rz, 0.2, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::H, {1});
+  circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+  circ.add_op<unsigned>(OpType::CX, {1, 2});
+  GIVEN("UniversalFrameRandomisation") {
+    UniversalFrameRandomisation ufr;
+    const std::vector<Circuit> serial =
+        ufr.sample_randomisation_circuits(circ, 50, 7, 1);
+    REQUIRE(serial.size() == 50);
+    for (unsigned n_threads : {2, 3, 8}) {
+      REQUIRE(
+          ufr.sample_randomisation_circuits(circ, 50, 7, n_threads) == serial);
+    }
+    REQUIRE(ufr.sample_randomisation_circuits(circ, 50, 8, 2) != serial);
+    for (const Circuit& c : serial) {
+      REQUIRE(test_unitary_comparison(c, circ, true));
+    }
+    FrameTemplate frame_template = ufr.make_template(circ);
+    const std::vector<FrameSample> frames =
+        ufr.sample_frames(frame_template, 50, 7, 4);
+    REQUIRE(frames == ufr.sample_frames(frame_template, 50, 7, 1));
+    for (unsigned i = 0; i < frames.size(); i++) {
+      REQUIRE(frame_template.materialise(frames[i]) == serial[i]);
+    }
+  }
+  GIVEN("PowerCycle") {
+    Circuit clifford(3);
+    clifford.add_op<unsigned>(OpType::H, {0});
+    clifford.add_op<unsigned>(OpType::CX, {0, 1});
+    clifford.add_op<unsigned>(OpType::S, {2});
+    clifford.add_op<unsigned>(OpType::CX, {2, 1});
+    PowerCycle pc;
+    const std::vector<Circuit> serial = pc.sample_cycles(clifford, 3, 20, 5, 1);
+    REQUIRE(serial.size() == 20);
+    REQUIRE(pc.sample_cycles(clifford, 3, 20, 5, 4) == serial);
+    Circuit cubed = clifford;
+    cubed.append(clifford);
+    cubed.append(clifford);
+    for (const Circuit& c : serial) {
+      REQUIRE(test_unitary_comparison(c, cubed, true));
+    }
+  }
+}
+
 }  // namespace test_FrameRandomisation
 }  // namespace tket
\ No newline at end of file
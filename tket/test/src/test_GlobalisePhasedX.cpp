@@ -354,5 +354,55 @@ SCENARIO("globalise_PhasedX transform") {
   }
 }
 
+// Layers of PhasedX gates with varying angles, each followed by a brickwork
+// layer of CZ gates, as produced for neutral-atom devices
+static Circuit layered_circuit(unsigned n_qubits, unsigned n_layers) {
+  Circuit c(n_qubits);
+  for (unsigned l = 0; l < n_layers; ++l) {
+    for (unsigned q = 0; q < n_qubits; ++q) {
+      double alpha = ((7 * q + 13 * l) % 20) / 10.;
+      double beta = ((3 * q + 5 * l) % 8) / 4.;
+      c.add_op<unsigned>(OpType::PhasedX, {alpha, beta}, {q});
+    }
+    for (unsigned q = l % 2; q + 1 < n_qubits; q += 2) {
+      c.add_op<unsigned>(OpType::CZ, {q, q + 1});
+    }
+  }
+  return c;
+}
+
+static void check_globalised(const Circuit& c) {
+  BGL_FORALL_VERTICES(v, c.dag, DAG) {
+    OpType type = c.get_OpType_from_Vertex(v);
+    if (type == OpType::NPhasedX) {
+      REQUIRE(is_global(v, c));
+    } else if (c.detect_singleq_unitary_op(v)) {
+      REQUIRE(type == OpType::Rz);
+    }
+  }
+}
+
+SCENARIO("globalise_PhasedX on layered circuits") {
+  GIVEN("A layered 6-qb circuit") {
+    Circuit c1 = layered_circuit(6, 12);
+    Circuit c2 = c1;
+    REQUIRE(Transforms::globalise_PhasedX().apply(c2));
+    check_globalised(c2);
+    REQUIRE(c2.count_gates(OpType::CZ) == c1.count_gates(OpType::CZ));
+    auto u1 = tket_sim::get_unitary(c1);
+    auto u2 = tket_sim::get_unitary(c2);
+    REQUIRE(u1.isApprox(u2));
+  }
+}
+
+SCENARIO("globalise_PhasedX on a wide and deep circuit", "[.long]") {
+  Circuit c1 = layered_circuit(50, 5000);
+  Circuit c2 = c1;
+  REQUIRE(Transforms::globalise_PhasedX().apply(c2));
+  check_globalised(c2);
+  REQUIRE(c2.count_gates(OpType::CZ) == c1.count_gates(OpType::CZ));
+  REQUIRE(c2.count_gates(OpType::PhasedX) == 0);
+}
+
 }  // namespace test_GlobalisePhasedX
 }  // namespace tket
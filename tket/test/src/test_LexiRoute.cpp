@@ -1094,6 +1094,97 @@ SCENARIO(
   }
 }
 
+SCENARIO("LexiRouteRoutingMethod gives the same routing on several threads") {
+  Circuit circ(64);
+  for (unsigned i = 0; i < 300; ++i) {
+    const unsigned q0 = (i * 37) % 64;
+    const unsigned q1 = (q0 + 1 + (i * 11) % 63) % 64;
+    circ.add_op<unsigned>(OpType::CX, {q0, q1});
+  }
+  const SquareGrid grid(8, 8);
+  Circuit serial = circ;
+  MappingManager serial_mm(std::make_shared<Architecture>(grid));
+  REQUIRE(serial_mm.route_circuit(
+      serial, {std::make_shared<LexiLabellingMethod>(),
+               std::make_shared<LexiRouteRoutingMethod>(10)}));
+  Circuit parallel = circ;
+  ArchitecturePtr shared_arc = std::make_shared<Architecture>(grid);
+  shared_arc->freeze();
+  MappingManager parallel_mm(shared_arc);
+  REQUIRE(parallel_mm.route_circuit(
+      parallel, {std::make_shared<LexiLabellingMethod>(),
+                 std::make_shared<LexiRouteRoutingMethod>(10, 4)}));
+  REQUIRE(parallel == serial);
+}
+
+SCENARIO("LexiRouteSwapCache evicts least recently used frontiers") {
+  std::vector<Node> nodes;
+  for (unsigned i = 0; i < 4; i++) nodes.push_back(Node(i));
+  interacting_nodes_t f0 = {{nodes[0], nodes[2]}, {nodes[2], nodes[0]}};
+  interacting_nodes_t f1 = {{nodes[1], nodes[3]}, {nodes[3], nodes[1]}};
+  interacting_nodes_t f2 = {{nodes[0], nodes[3]}, {nodes[3], nodes[0]}};
+  LexiRouteSwapCache cache(2);
+  REQUIRE_FALSE(cache.find(f0));
+  cache.insert(f0, {nodes[0], nodes[1]});
+  cache.insert(f1, {nodes[1], nodes[2]});
+  REQUIRE(cache.find(f0) == swap_t{nodes[0], nodes[1]});
+  // f1 is now least recently used
+  cache.insert(f2, {nodes[2], nodes[3]});
+  REQUIRE(cache.size() == 2);
+  REQUIRE_FALSE(cache.find(f1));
+  REQUIRE(cache.find(f2) == swap_t{nodes[2], nodes[3]});
+  REQUIRE(cache.hits() == 2);
+  REQUIRE(cache.misses() == 2);
+  cache.clear();
+  REQUIRE(cache.size() == 0);
+  REQUIRE(cache.hits() == 0);
+  REQUIRE_THROWS_AS(LexiRouteSwapCache(0), std::invalid_argument);
+}
+
+SCENARIO("LexiRouteRoutingMethod reuses SWAPs for repeated layers") {
+  Circuit layer(16);
+  for (unsigned i = 0; i < 8; ++i) {
+    layer.add_op<unsigned>(OpType::CX, {i, 15 - i});
+    layer.add_op<unsigned>(OpType::Rz, 0.1, {15 - i});
+    layer.add_op<unsigned>(OpType::CX, {i, 15 - i});
+  }
+  Circuit circ(16);
+  for (unsigned t = 0; t < 20; ++t) circ.append(layer);
+  const SquareGrid grid(4, 4);
+  MappingManager mm(std::make_shared<Architecture>(grid));
+  std::shared_ptr<LexiRouteRoutingMethod> cached =
+      std::make_shared<LexiRouteRoutingMethod>(10, 1, 64);
+  REQUIRE(cached->get_swap_cache());
+  REQUIRE(mm.route_circuit(
+      circ, {std::make_shared<LexiLabellingMethod>(), cached}));
+  std::shared_ptr<LexiRouteSwapCache> cache = cached->get_swap_cache();
+  REQUIRE(cache->hits() + cache->misses() > 0);
+  REQUIRE(cache->size() <= cache->misses());
+  (Transforms::decompose_SWAP_to_CX() >> Transforms::decompose_BRIDGE_to_CX())
+      .apply(circ);
+  REQUIRE(respects_connectivity_constraints(circ, grid, false));
+  REQUIRE_FALSE(LexiRouteRoutingMethod().get_swap_cache());
+}
+
+SCENARIO("LexiRouteRoutingMethod with a time budget") {
+  Circuit circ(64);
+  for (unsigned i = 0; i < 300; ++i) {
+    const unsigned q0 = (i * 37) % 64;
+    const unsigned q1 = (q0 + 1 + (i * 11) % 63) % 64;
+    circ.add_op<unsigned>(OpType::CX, {q0, q1});
+  }
+  const SquareGrid grid(8, 8);
+  MappingManager mm(std::make_shared<Architecture>(grid));
+  REQUIRE(mm.route_circuit(
+      circ,
+      {std::make_shared<LexiLabellingMethod>(),
+       std::make_shared<LexiRouteRoutingMethod>(100)},
+      0, 1));
+  (Transforms::decompose_SWAP_to_CX() >> Transforms::decompose_BRIDGE_to_CX())
+      .apply(circ);
+  REQUIRE(respects_connectivity_constraints(circ, grid, false));
+}
+
 SCENARIO("Dense CX circuits route succesfully") {
   GIVEN(
       "Complex CX circuits for large directed architecture based off "
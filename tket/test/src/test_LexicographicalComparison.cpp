@@ -176,6 +176,33 @@ SCENARIO(
   }
 }
 
+SCENARIO(
+    "Test LexicographicalComparison::get_updated_distances against "
+    "recomputed distances") {
+  ArchitecturePtr grid = std::make_shared<SquareGrid>(4, 5);
+  const std::vector<Node> nodes = grid->get_all_nodes_vec();
+  interacting_nodes_t interactions;
+  for (unsigned i = 0; i + 13 < nodes.size(); i += 2) {
+    interactions[nodes[i]] = nodes[i + 13];
+    interactions[nodes[i + 13]] = nodes[i];
+  }
+  LexicographicalComparison lc_test(grid, interactions);
+  for (const auto& [n0, n1] : grid->get_all_edges_vec()) {
+    // Relabel the interactions as the swap does.
+    auto swapped = [&n0 = n0, &n1 = n1](const Node& n) {
+      return (n == n0) ? n1 : ((n == n1) ? n0 : n);
+    };
+    interacting_nodes_t swapped_interactions;
+    for (const auto& [a, b] : interactions) {
+      swapped_interactions[swapped(a)] = swapped(b);
+    }
+    REQUIRE(
+        lc_test.get_updated_distances({n0, n1}) ==
+        LexicographicalComparison(grid, swapped_interactions)
+            .get_lexicographical_distances());
+  }
+}
+
 SCENARIO("Test LexicographicalComparison::remove_swaps_lexicographical") {
   std::vector<Node> nodes = {
       Node("test_node", 0), Node("test_node", 1), Node("test_node", 2),
@@ -221,5 +248,28 @@ SCENARIO("Test LexicographicalComparison::remove_swaps_lexicographical") {
     lc_test.remove_swaps_lexicographical(candidate_swaps);
     REQUIRE(candidate_swaps.size() == 1);
   }
+  GIVEN("Many swaps, compared on several threads.") {
+    ArchitecturePtr grid = std::make_shared<SquareGrid>(8, 8);
+    const std::vector<Node> grid_nodes = grid->get_all_nodes_vec();
+    interacting_nodes_t interactions;
+    for (unsigned i = 0; i + 37 < grid_nodes.size(); i += 3) {
+      interactions[grid_nodes[i]] = grid_nodes[i + 37];
+      interactions[grid_nodes[i + 37]] = grid_nodes[i];
+    }
+    swap_set_t candidate_swaps;
+    for (const auto& [n0, n1] : grid->get_all_edges_vec()) {
+      candidate_swaps.insert({n0, n1});
+    }
+    REQUIRE(candidate_swaps.size() > 64);
+    swap_set_t serial = candidate_swaps;
+    LexicographicalComparison(grid, interactions)
+        .remove_swaps_lexicographical(serial);
+    grid->precompute_distances();
+    swap_set_t parallel = candidate_swaps;
+    LexicographicalComparison(grid, interactions)
+        .remove_swaps_lexicographical(parallel, 4);
+    REQUIRE(parallel == serial);
+    REQUIRE(serial.size() < candidate_swaps.size());
+  }
 }
 }  // namespace tket
@@ -13,10 +13,14 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
+#include "tket/Mapping/LexiLabelling.hpp"
+#include "tket/Mapping/LexiRoute.hpp"
 #include "tket/Mapping/MappingManager.hpp"
 
 namespace tket {
@@ -40,6 +44,17 @@ class TokenSwappingTester : public RoutingMethod {
   }
 };
 
+// Never finishes routing, slowly.
+class StallingRoutingMethod : public RoutingMethod {
+ public:
+  std::pair<bool, unit_map_t> routing_method(
+      MappingFrontier_ptr& /*mapping_frontier*/,
+      const ArchitecturePtr& /*architecture*/) const {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return {true, {}};
+  }
+};
+
 SCENARIO("Test MappingManager::route_circuit") {
   Node node0("test_node", 0), node1("test_node", 1), node2("test_node", 2);
   Architecture arc({{node0, node1}, {node1, node2}});
@@ -94,4 +109,263 @@ SCENARIO("Test MappingManager::route_circuit") {
     REQUIRE(*c2.get_op_ptr() == *get_op_ptr(OpType::CX));
   }
 }
+
+SCENARIO("Test MappingManager::route_circuit in windows") {
+  std::vector<Node> nodes;
+  for (unsigned i = 0; i < 6; i++) nodes.push_back(Node("test_node", i));
+  Architecture arc(
+      {{nodes[0], nodes[1]},
+       {nodes[1], nodes[2]},
+       {nodes[2], nodes[3]},
+       {nodes[3], nodes[4]},
+       {nodes[4], nodes[5]}});
+  ArchitecturePtr shared_arc = std::make_shared<Architecture>(arc);
+  MappingManager test_mm(shared_arc);
+  std::vector<RoutingMethodPtr> vrm = {
+      std::make_shared<LexiRouteRoutingMethod>()};
+
+  Circuit circ(6, 2);
+  for (unsigned i = 0; i < 8; i++) {
+    circ.add_op<unsigned>(OpType::CX, {0, 5});
+    circ.add_op<unsigned>(OpType::H, {2});
+    circ.add_op<unsigned>(OpType::CZ, {1, 4});
+    circ.add_op<unsigned>(OpType::CX, {3, 0});
+    circ.add_op<unsigned>(OpType::Rz, 0.25, {5});
+  }
+  circ.add_measure(0, 0);
+  circ.add_conditional_gate<unsigned>(OpType::CX, {}, {2, 5}, {0}, 1);
+  circ.add_measure(5, 1);
+  std::map<UnitID, UnitID> rename_map;
+  for (unsigned i = 0; i < 6; i++) rename_map.insert({Qubit(i), nodes[i]});
+  circ.rename_units(rename_map);
+  unsigned n_ops = circ.n_gates();
+
+  for (unsigned window_slices : {1, 3, 100}) {
+    GIVEN("Windows of " + std::to_string(window_slices) + " slices") {
+      Circuit routed = circ;
+      std::shared_ptr<unit_bimaps_t> maps = std::make_shared<unit_bimaps_t>();
+      for (const Qubit& q : routed.all_qubits()) {
+        maps->initial.insert({q, q});
+        maps->final.insert({q, q});
+      }
+      REQUIRE(test_mm.route_circuit_with_maps(
+          routed, vrm, maps, window_slices));
+      REQUIRE(routed.n_bits() == 2);
+      unsigned n_swaps = 0;
+      for (const Command& com : routed) {
+        if (com.get_op_ptr()->get_type() == OpType::SWAP) n_swaps++;
+        unit_vector_t qubits;
+        for (const UnitID& uid : com.get_args()) {
+          if (uid.type() == UnitType::Qubit) qubits.push_back(uid);
+        }
+        if (qubits.size() == 2) {
+          REQUIRE(arc.valid_operation({Node(qubits[0]), Node(qubits[1])}));
+        }
+      }
+      REQUIRE(routed.n_gates() == n_ops + n_swaps);
+      REQUIRE(n_swaps > 0);
+      for (const Qubit& q : circ.all_qubits()) {
+        REQUIRE(maps->initial.left.at(q) == q);
+        REQUIRE(shared_arc->node_exists(Node(maps->final.left.at(q))));
+      }
+    }
+  }
+  GIVEN("A time budget") {
+    // Nothing is routed until the budget runs out.
+    Circuit routed = circ;
+    std::vector<RoutingMethodPtr> stalling = {
+        std::make_shared<StallingRoutingMethod>()};
+    REQUIRE(test_mm.route_circuit(routed, stalling, 0, 20));
+    for (const Command& com : routed) {
+      unit_vector_t qubits;
+      for (const UnitID& uid : com.get_args()) {
+        if (uid.type() == UnitType::Qubit) qubits.push_back(uid);
+      }
+      if (qubits.size() == 2) {
+        REQUIRE(arc.valid_operation({Node(qubits[0]), Node(qubits[1])}));
+      }
+    }
+  }
+  GIVEN("An unplaced Circuit") {
+    Circuit unplaced(3);
+    unplaced.add_op<unsigned>(OpType::CX, {0, 2});
+    REQUIRE_THROWS_AS(
+        test_mm.route_circuit(unplaced, vrm, 2), MappingManagerError);
+  }
+}
+
+SCENARIO("Test MappingManager::route_circuit_portfolio") {
+  std::vector<Node> nodes;
+  for (unsigned i = 0; i < 6; i++) nodes.push_back(Node("test_node", i));
+  Architecture arc(
+      {{nodes[0], nodes[1]},
+       {nodes[1], nodes[2]},
+       {nodes[2], nodes[3]},
+       {nodes[3], nodes[4]},
+       {nodes[4], nodes[5]},
+       {nodes[5], nodes[0]}});
+  ArchitecturePtr shared_arc = std::make_shared<Architecture>(arc);
+  MappingManager test_mm(shared_arc);
+
+  Circuit circ(6);
+  for (unsigned i = 0; i < 4; i++) {
+    circ.add_op<unsigned>(OpType::CX, {0, 3});
+    circ.add_op<unsigned>(OpType::CX, {1, 4});
+    circ.add_op<unsigned>(OpType::CZ, {2, 5});
+    circ.add_op<unsigned>(OpType::CX, {0, 2});
+    circ.add_op<unsigned>(OpType::H, {4});
+  }
+  std::map<UnitID, UnitID> rename_map;
+  for (unsigned i = 0; i < 6; i++) rename_map.insert({Qubit(i), nodes[i]});
+  circ.rename_units(rename_map);
+  auto identity_maps = [&circ]() {
+    std::shared_ptr<unit_bimaps_t> maps = std::make_shared<unit_bimaps_t>();
+    for (const Qubit& q : circ.all_qubits()) {
+      maps->initial.insert({q, q});
+      maps->final.insert({q, q});
+    }
+    return maps;
+  };
+  RoutingMethodPtr stalling = std::make_shared<StallingRoutingMethod>();
+
+  GIVEN("LexiRoute with several lookaheads") {
+    std::vector<std::vector<RoutingMethodPtr>> portfolio;
+    std::vector<unsigned> n_swaps;
+    for (unsigned depth : {1, 3, 10, 100}) {
+      portfolio.push_back({std::make_shared<LexiRouteRoutingMethod>(depth)});
+      Circuit single = circ;
+      test_mm.route_circuit_with_maps(
+          single, portfolio.back(), identity_maps());
+      n_swaps.push_back(
+          single.count_gates(OpType::SWAP) +
+          single.count_gates(OpType::BRIDGE));
+    }
+    Circuit routed = circ;
+    std::shared_ptr<unit_bimaps_t> maps = identity_maps();
+    unsigned best = test_mm.route_circuit_portfolio(routed, portfolio, maps);
+    REQUIRE(best < portfolio.size());
+    unsigned routed_swaps = routed.count_gates(OpType::SWAP) +
+                            routed.count_gates(OpType::BRIDGE);
+    REQUIRE(routed_swaps == n_swaps[best]);
+    for (unsigned n : n_swaps) REQUIRE(routed_swaps <= n);
+    for (const Command& com : routed) {
+      if (com.get_args().size() == 2) {
+        REQUIRE(arc.valid_operation(
+            {Node(com.get_args()[0]), Node(com.get_args()[1])}));
+      }
+    }
+    REQUIRE(maps->initial.size() == 6);
+  }
+  GIVEN("A configuration that exceeds its time budget") {
+    std::vector<std::vector<RoutingMethodPtr>> portfolio = {
+        {stalling}, {std::make_shared<LexiRouteRoutingMethod>()}};
+    Circuit routed = circ;
+    REQUIRE(
+        test_mm.route_circuit_portfolio(
+            routed, portfolio, identity_maps(), 500) == 1);
+    REQUIRE(routed.count_gates(OpType::SWAP) > 0);
+  }
+  GIVEN("No configuration within the time budget") {
+    std::vector<std::vector<RoutingMethodPtr>> portfolio = {
+        {stalling}, {stalling}};
+    Circuit routed = circ;
+    REQUIRE_THROWS_AS(
+        test_mm.route_circuit_portfolio(routed, portfolio, identity_maps(), 20),
+        MappingManagerError);
+  }
+  GIVEN("A configuration that fails") {
+    std::vector<std::vector<RoutingMethodPtr>> portfolio = {
+        {std::make_shared<RoutingMethod>()}};
+    Circuit routed = circ;
+    REQUIRE_THROWS_AS(
+        test_mm.route_circuit_portfolio(routed, portfolio, identity_maps()),
+        MappingManagerError);
+  }
+}
+SCENARIO("Test MappingManager::route_circuit_bidirectional") {
+  std::vector<Node> nodes;
+  for (unsigned i = 0; i < 6; i++) nodes.push_back(Node("test_node", i));
+  Architecture arc(
+      {{nodes[0], nodes[1]},
+       {nodes[1], nodes[2]},
+       {nodes[2], nodes[3]},
+       {nodes[3], nodes[4]},
+       {nodes[4], nodes[5]}});
+  MappingManager test_mm(std::make_shared<Architecture>(arc));
+  std::vector<RoutingMethodPtr> methods = {
+      std::make_shared<LexiLabellingMethod>(),
+      std::make_shared<LexiRouteRoutingMethod>()};
+
+  Circuit circ(6, 1);
+  for (unsigned i = 0; i < 3; i++) {
+    circ.add_op<unsigned>(OpType::CX, {0, 5});
+    circ.add_op<unsigned>(OpType::CX, {1, 4});
+    circ.add_op<unsigned>(OpType::CZ, {2, 3});
+    circ.add_op<unsigned>(OpType::CX, {5, 1});
+    circ.add_op<unsigned>(OpType::H, {4});
+  }
+  circ.add_measure(0, 0);
+  auto identity_maps = [](const Circuit& c) {
+    std::shared_ptr<unit_bimaps_t> maps = std::make_shared<unit_bimaps_t>();
+    for (const Qubit& q : c.all_qubits()) {
+      maps->initial.insert({q, q});
+      maps->final.insert({q, q});
+    }
+    return maps;
+  };
+  auto n_routing_gates = [](const Circuit& c) {
+    return c.count_gates(OpType::SWAP) + c.count_gates(OpType::BRIDGE);
+  };
+  auto check_routed = [&](const Circuit& routed,
+                          const std::shared_ptr<unit_bimaps_t>& maps) {
+    for (const Command& com : routed) {
+      unit_vector_t args = com.get_args();
+      if (com.get_op_ptr()->get_type() != OpType::Measure &&
+          args.size() == 2) {
+        REQUIRE(arc.valid_operation({Node(args[0]), Node(args[1])}));
+      }
+    }
+    for (const Qubit& q : circ.all_qubits()) {
+      REQUIRE(arc.node_exists(Node(maps->initial.left.at(q))));
+      REQUIRE(arc.node_exists(Node(maps->final.left.at(q))));
+    }
+  };
+
+  GIVEN("An unplaced Circuit") {
+    Circuit once = circ;
+    test_mm.route_circuit_with_maps(once, methods, identity_maps(circ));
+    Circuit routed = circ;
+    std::shared_ptr<unit_bimaps_t> maps = identity_maps(circ);
+    REQUIRE(test_mm.route_circuit_bidirectional(routed, methods, maps, 3));
+    check_routed(routed, maps);
+    REQUIRE(n_routing_gates(routed) <= n_routing_gates(once));
+  }
+  GIVEN("A poorly placed Circuit") {
+    // Qubits interacting the most are placed far apart.
+    std::map<UnitID, UnitID> rename_map;
+    for (unsigned i = 0; i < 6; i++) rename_map.insert({Qubit(i), nodes[i]});
+    Circuit placed = circ;
+    placed.rename_units(rename_map);
+    std::shared_ptr<unit_bimaps_t> maps = identity_maps(circ);
+    update_maps(maps, rename_map, rename_map);
+    Circuit once = placed;
+    std::shared_ptr<unit_bimaps_t> once_maps =
+        std::make_shared<unit_bimaps_t>(*maps);
+    test_mm.route_circuit_with_maps(once, methods, once_maps);
+    REQUIRE(n_routing_gates(once) > 0);
+    WHEN("No sweeps are made") {
+      Circuit routed = placed;
+      test_mm.route_circuit_bidirectional(routed, methods, maps, 0);
+      REQUIRE(routed == once);
+      REQUIRE(maps->initial == once_maps->initial);
+      REQUIRE(maps->final == once_maps->final);
+    }
+    WHEN("Sweeps are made") {
+      Circuit routed = placed;
+      test_mm.route_circuit_bidirectional(routed, methods, maps, 4);
+      check_routed(routed, maps);
+      REQUIRE(n_routing_gates(routed) <= n_routing_gates(once));
+    }
+  }
+}
 }  // namespace tket
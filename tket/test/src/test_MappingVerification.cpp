@@ -15,6 +15,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "testutil.hpp"
+#include "tket/Circuit/Boxes.hpp"
 #include "tket/Mapping/LexiRoute.hpp"
 #include "tket/Mapping/MappingManager.hpp"
 #include "tket/Mapping/Verification.hpp"
@@ -111,4 +112,94 @@ SCENARIO(
     REQUIRE(respects_connectivity_constraints(circ, arc, false));
   }
 }
+
+SCENARIO("Checking connectivity against a ConnectivityMatrix") {
+  Architecture arc({{1, 0}, {1, 2}});
+  const ConnectivityMatrix connectivity(arc);
+  REQUIRE(connectivity.n_nodes() == 3);
+  const unsigned n0 = *connectivity.node_id(Node(0));
+  const unsigned n1 = *connectivity.node_id(Node(1));
+  const unsigned n2 = *connectivity.node_id(Node(2));
+  CHECK_FALSE(connectivity.node_id(Node(3)));
+  CHECK(connectivity.edge_exists(n1, n0));
+  CHECK_FALSE(connectivity.edge_exists(n0, n1));
+  CHECK(connectivity.adjacent(n0, n1));
+  CHECK_FALSE(connectivity.adjacent(n0, n2));
+  CHECK_FALSE(connectivity.adjacent(n0, n0));
+
+  GIVEN("Directed and undirected CX gates") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::H, {2});
+    Circuit circ_cz = circ;
+    circ_cz.add_op<unsigned>(OpType::CZ, {0, 2});
+    reassign_boundary(circ);
+    reassign_boundary(circ_cz);
+    CHECK(respects_connectivity_constraints(circ, connectivity, false));
+    CHECK_FALSE(respects_connectivity_constraints(circ, connectivity, true));
+    CHECK_FALSE(
+        respects_connectivity_constraints(circ_cz, connectivity, false));
+  }
+  GIVEN("A qubit not in the architecture") {
+    Circuit circ(4);
+    circ.add_op<unsigned>(OpType::CX, {1, 0});
+    reassign_boundary(circ);
+    CHECK_FALSE(respects_connectivity_constraints(circ, connectivity, false));
+  }
+  GIVEN("BRIDGE gates") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::BRIDGE, {0, 1, 2});
+    Circuit circ_bad = circ;
+    circ_bad.add_op<unsigned>(OpType::BRIDGE, {1, 0, 2});
+    reassign_boundary(circ);
+    reassign_boundary(circ_bad);
+    CHECK_FALSE(respects_connectivity_constraints(circ, connectivity, false));
+    CHECK(respects_connectivity_constraints(circ, connectivity, false, true));
+    REQUIRE_THROWS_AS(
+        respects_connectivity_constraints(circ, connectivity, true, true),
+        std::logic_error);
+    CHECK_FALSE(
+        respects_connectivity_constraints(circ_bad, connectivity, false, true));
+  }
+  GIVEN("Conditional gates and boxes") {
+    Circuit inner(2);
+    inner.add_op<unsigned>(OpType::CX, {1, 0});
+    Circuit circ(3, 1);
+    circ.add_conditional_gate<unsigned>(OpType::CX, {}, {1, 2}, {0}, 1);
+    circ.add_box(CircBox(inner), std::vector<unsigned>{0, 1});
+    Circuit circ_bad = circ;
+    circ_bad.add_box(CircBox(inner), std::vector<unsigned>{2, 0});
+    reassign_boundary(circ);
+    reassign_boundary(circ_bad);
+    CHECK(respects_connectivity_constraints(circ, connectivity, false));
+    CHECK(respects_connectivity_constraints(circ, connectivity, true));
+    CHECK_FALSE(
+        respects_connectivity_constraints(circ_bad, connectivity, false));
+  }
+  GIVEN("A large circuit, checked on several threads") {
+    const unsigned n = 20;
+    std::vector<std::pair<unsigned, unsigned>> edges;
+    for (unsigned i = 0; i + 1 < n; i++) edges.push_back({i, i + 1});
+    const Architecture line(edges);
+    const ConnectivityMatrix line_connectivity(line);
+    Circuit circ(n);
+    for (unsigned layer = 0; layer < 2000; layer++) {
+      for (unsigned i = layer % 2; i + 1 < n; i += 2) {
+        circ.add_op<unsigned>(OpType::CX, {i, i + 1});
+      }
+    }
+    Circuit circ_reversed = circ;
+    circ_reversed.add_op<unsigned>(OpType::CX, {n - 1, n - 2});
+    reassign_boundary(circ);
+    reassign_boundary(circ_reversed);
+    CHECK(respects_connectivity_constraints(circ, line, true));
+    CHECK(respects_connectivity_constraints(
+        circ, line_connectivity, true, false, 4));
+    CHECK_FALSE(respects_connectivity_constraints(circ_reversed, line, true));
+    CHECK_FALSE(respects_connectivity_constraints(
+        circ_reversed, line_connectivity, true, false, 4));
+    CHECK(respects_connectivity_constraints(
+        circ_reversed, line_connectivity, false, false, 0));
+  }
+}
 }  // namespace tket
@@ -98,5 +98,49 @@ SCENARIO("Some QubitOperators") {
   }
 }
 
+SCENARIO("Many groups are diagonalised consistently") {
+  GIVEN("Strings needing several measurement circuits") {
+    std::list<SpPauliString> pts;
+    for (unsigned q = 0; q < 6; ++q) {
+      for (Pauli p : {Pauli::X, Pauli::Y, Pauli::Z}) {
+        pts.push_back(
+            SpPauliString({{Qubit(q), p}, {Qubit((q + 1) % 6), Pauli::Z}}));
+        pts.push_back(
+            SpPauliString({{Qubit(q), p}, {Qubit((q + 2) % 6), Pauli::X}}));
+      }
+    }
+    for (PauliPartitionStrat strat :
+         {PauliPartitionStrat::NonConflictingSets,
+          PauliPartitionStrat::CommutingSets}) {
+      MeasurementSetup first = measurement_reduction(pts, strat);
+      MeasurementSetup second = measurement_reduction(pts, strat);
+      REQUIRE(first.get_circs().size() > 1);
+      REQUIRE(first.verify());
+      REQUIRE(first.get_circs() == second.get_circs());
+      REQUIRE(first.to_str() == second.to_str());
+    }
+  }
+}
+
+SCENARIO("Measurement reduction of streamed strings") {
+  GIVEN("Strings added in two chunks") {
+    Qubit q0(0), q1(1), q2(2);
+    std::list<SpPauliString> chunk0{
+        SpPauliString({q0, q1}, {Pauli::Z, Pauli::Z}),
+        SpPauliString({q0, q2}, {Pauli::X, Pauli::X})};
+    std::list<SpPauliString> chunk1{
+        SpPauliString({q1, q2}, {Pauli::Y, Pauli::Y}),
+        SpPauliString({q0, q1}, {Pauli::Z, Pauli::Z}),
+        SpPauliString(q2, Pauli::Z)};
+    PauliPartitionStream stream(PauliPartitionStrat::CommutingSets);
+    stream.add_strings(chunk0);
+    stream.add_strings(chunk1);
+    MeasurementSetup ms = measurement_reduction(stream);
+    REQUIRE(ms.verify());
+    REQUIRE(ms.get_result_map().size() == 4);
+    REQUIRE(ms.get_circs().size() == stream.n_sets());
+  }
+}
+
 }  // namespace test_MeasurementReduction
 }  // namespace tket
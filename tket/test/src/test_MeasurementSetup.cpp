@@ -389,5 +389,84 @@ SCENARIO("verify_measurement_setup") {
   }
 }
 
+SCENARIO("Indexed lookup and expectation values from shots") {
+  MeasurementSetup ms;
+  Circuit mc(2, 2);
+  mc.add_measure(0, 0);
+  mc.add_measure(1, 1);
+  ms.add_measurement_circuit(mc);
+  ms.add_measurement_circuit(mc);
+  Qubit q0(q_default_reg(), 0);
+  Qubit q1(q_default_reg(), 1);
+  SpPauliString ii;
+  SpPauliString zi({{q0, Pauli::Z}});
+  SpPauliString iz({{q1, Pauli::Z}});
+  SpPauliString zz({{q0, Pauli::Z}, {q1, Pauli::Z}});
+  ms.add_result_for_term(ii, {0, {}, false});
+  ms.add_result_for_term(zi, {0, {0}, false});
+  ms.add_result_for_term(zi, {1, {0}, false});
+  ms.add_result_for_term(iz, {1, {1}, true});
+  ms.add_result_for_term(zz, {0, {0, 1}, false});
+  REQUIRE(ms.verify());
+  MeasurementResultIndex index(ms);
+
+  GIVEN("Lookups of terms") {
+    REQUIRE(index.get_qubit_index().size() == 2);
+    const std::vector<MeasurementSetup::MeasurementBitMap>* found =
+        index.find(zi);
+    REQUIRE(found);
+    REQUIRE(found->size() == 2);
+    REQUIRE(index.find(zz)->front().get_bits().size() == 2);
+    REQUIRE(index.find(ii)->front().get_bits().empty());
+    REQUIRE_FALSE(index.find(SpPauliString({{q0, Pauli::X}})));
+    REQUIRE_FALSE(index.pack(SpPauliString({{Qubit(5), Pauli::Z}})));
+    REQUIRE_FALSE(index.find(SpPauliString({{Qubit(5), Pauli::Z}})));
+  }
+  GIVEN("Tables of shots") {
+    // Span more than one word of shots in the first circuit
+    std::vector<std::vector<bool>> shots0, shots1;
+    for (unsigned s = 0; s < 70; ++s) {
+      shots0.push_back({s % 2 == 0, s % 3 == 0});
+    }
+    for (unsigned s = 0; s < 5; ++s) {
+      shots1.push_back({true, s == 0});
+    }
+    std::vector<ShotTable> tables{ShotTable(2, shots0), ShotTable(2, shots1)};
+    REQUIRE(tables[0].n_shots() == 70);
+    REQUIRE(tables[0].column(0).size() == 2);
+
+    // Reference values computed shot by shot
+    const auto sign = [](bool b) { return b ? -1. : 1.; };
+    double zi_sum = 0., zz_sum = 0., iz_sum = 0.;
+    for (const std::vector<bool>& shot : shots0) {
+      zi_sum += sign(shot[0]);
+      zz_sum += sign(shot[0] != shot[1]);
+    }
+    for (const std::vector<bool>& shot : shots1) {
+      zi_sum += sign(shot[0]);
+      iz_sum -= sign(shot[1]);
+    }
+    std::vector<double> values =
+        index.expectation_values({ii, zi, iz, zz}, tables);
+    REQUIRE(values.size() == 4);
+    REQUIRE(values[0] == 1.);
+    REQUIRE(values[1] == zi_sum / 75);
+    REQUIRE(values[2] == iz_sum / 5);
+    REQUIRE(values[3] == zz_sum / 70);
+  }
+  GIVEN("Invalid inputs") {
+    std::vector<ShotTable> tables{ShotTable(2), ShotTable(2)};
+    REQUIRE_THROWS_AS(
+        tables[0].add_shot({true, false, true}), std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        index.expectation_values({zi}, {ShotTable(2)}), std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        index.expectation_values({SpPauliString({{q0, Pauli::X}})}, tables),
+        std::out_of_range);
+    REQUIRE_THROWS_AS(
+        index.expectation_values({zi}, tables), std::invalid_argument);
+  }
+}
+
 }  // namespace test_MeasurementSetup
 }  // namespace tket
@@ -276,6 +276,86 @@ SCENARIO("Reorder circuits with limited search space") {
   }
 }
 
+SCENARIO("Reorder circuits with a scheduled ready-list") {
+  std::vector<Node> nodes = {
+      Node("test_node", 0), Node("test_node", 1), Node("test_node", 2),
+      Node("node_test", 3)};
+
+  // n0 -- n1 -- n2 -- n3
+  Architecture architecture(
+      {{nodes[0], nodes[1]}, {nodes[1], nodes[2]}, {nodes[2], nodes[3]}});
+  ArchitecturePtr shared_arc = std::make_shared<Architecture>(architecture);
+  Circuit circ(4);
+  std::vector<Qubit> qubits = circ.all_qubits();
+  std::map<UnitID, UnitID> rename_map = {
+      {qubits[0], nodes[0]},
+      {qubits[1], nodes[1]},
+      {qubits[2], nodes[2]},
+      {qubits[3], nodes[3]}};
+  // Physically invalid operations
+  circ.add_op<UnitID>(OpType::CZ, {qubits[0], qubits[2]});
+  circ.add_op<UnitID>(OpType::CZ, {qubits[1], qubits[3]});
+
+  GIVEN("Many layers of commuting gates.") {
+    const unsigned n_layers = 10;
+    for (unsigned i = 0; i < n_layers; i++) {
+      circ.add_op<UnitID>(OpType::Rz, 0.1 * i, {qubits[0]});
+      // Physically valid operations
+      circ.add_op<UnitID>(OpType::CZ, {qubits[0], qubits[1]});
+      circ.add_op<UnitID>(OpType::ZZPhase, 0.3, {qubits[2], qubits[3]});
+      circ.add_op<UnitID>(OpType::CZ, {qubits[1], qubits[2]});
+    }
+    circ.rename_units(rename_map);
+    Circuit circ_copy(circ);
+    MappingFrontier_ptr mf = std::make_shared<MappingFrontier>(circ);
+    mf->advance_frontier_boundary(shared_arc);
+    MultiGateReorder mr(shared_arc, mf);
+    REQUIRE(mr.solve_scheduled(1000));
+    // All the valid gates are commuted to the front
+    std::vector<Command> commands = circ.get_commands();
+    for (unsigned i = 0; i < 3 * n_layers; i++) {
+      std::vector<Node> nodes;
+      for (auto arg : commands[i].get_args()) {
+        nodes.push_back(Node(arg));
+      }
+      REQUIRE(nodes.size() == 2);
+      REQUIRE(mf->valid_boundary_operation(
+          shared_arc, commands[i].get_op_ptr(), nodes));
+    }
+    const auto u = tket_sim::get_unitary(circ);
+    const auto u1 = tket_sim::get_unitary(circ_copy);
+    REQUIRE(tket_sim::compare_statevectors_or_unitaries(
+        u, u1, tket_sim::MatrixEquivalence::EQUAL));
+  }
+  GIVEN("A gate blocked by a non-commuting gate.") {
+    circ.add_op<UnitID>(OpType::H, {qubits[1]});
+    circ.add_op<UnitID>(OpType::CZ, {qubits[0], qubits[1]});
+    circ.rename_units(rename_map);
+    Circuit circ_copy(circ);
+    MappingFrontier_ptr mf = std::make_shared<MappingFrontier>(circ);
+    mf->advance_frontier_boundary(shared_arc);
+    MultiGateReorder mr(shared_arc, mf);
+    REQUIRE_FALSE(mr.solve_scheduled(1000));
+    REQUIRE(circ == circ_copy);
+  }
+  GIVEN("A limit on the number of gates examined.") {
+    // Physically valid operations
+    circ.add_op<UnitID>(OpType::CZ, {qubits[0], qubits[1]});
+    circ.add_op<UnitID>(OpType::CZ, {qubits[2], qubits[3]});
+    circ.rename_units(rename_map);
+    Circuit circ_copy(circ);
+    MappingFrontier_ptr mf = std::make_shared<MappingFrontier>(circ);
+    mf->advance_frontier_boundary(shared_arc);
+    MultiGateReorder mr(shared_arc, mf);
+    REQUIRE_FALSE(mr.solve_scheduled(2));
+    REQUIRE(mr.solve_scheduled(3));
+    const auto u = tket_sim::get_unitary(circ);
+    const auto u1 = tket_sim::get_unitary(circ_copy);
+    REQUIRE(tket_sim::compare_statevectors_or_unitaries(
+        u, u1, tket_sim::MatrixEquivalence::EQUAL));
+  }
+}
+
 SCENARIO("Test MultiGateReorderRoutingMethod") {
   std::vector<Node> nodes = {
       Node("test_node", 0), Node("test_node", 1), Node("test_node", 2),
@@ -404,6 +484,32 @@ SCENARIO("Test MappingManager with MultiGateReorderRoutingMethod") {
     REQUIRE(swap_c.get_args() == uids);
     REQUIRE(*swap_c.get_op_ptr() == *get_op_ptr(OpType::SWAP));
   }
+  GIVEN("Simple CZ, CX circuit, scheduled.") {
+    Circuit circ(4);
+    std::vector<Qubit> qubits = circ.all_qubits();
+
+    // Physically invalid operations
+    circ.add_op<UnitID>(OpType::CX, {qubits[0], qubits[2]});
+    circ.add_op<UnitID>(OpType::CX, {qubits[1], qubits[3]});
+    // Physically valid operations
+    circ.add_op<UnitID>(OpType::CX, {qubits[1], qubits[2]});
+    circ.add_op<UnitID>(OpType::CZ, {qubits[0], qubits[1]});
+    std::map<UnitID, UnitID> rename_map = {
+        {qubits[0], nodes[0]},
+        {qubits[1], nodes[1]},
+        {qubits[2], nodes[2]},
+        {qubits[3], nodes[3]}};
+    circ.rename_units(rename_map);
+    MappingManager mm(shared_arc);
+    std::vector<RoutingMethodPtr> vrm = {
+        std::make_shared<MultiGateReorderRoutingMethod>(10, 100, true),
+        std::make_shared<LexiRouteRoutingMethod>(10)};
+    mm.route_circuit(circ, vrm);
+    PredicatePtr routed_correctly =
+        std::make_shared<ConnectivityPredicate>(architecture);
+    REQUIRE(routed_correctly->verify(circ));
+    REQUIRE(circ.count_gates(OpType::SWAP) == 1);
+  }
 }
 
 SCENARIO("Test JSON serialisation for MultiGateReorderRoutingMethod") {
@@ -417,6 +523,18 @@ SCENARIO("Test JSON serialisation for MultiGateReorderRoutingMethod") {
     nlohmann::json j_rm_serialised = rm_loaded.serialize();
     REQUIRE(j_rm == j_rm_serialised);
   }
+  GIVEN("Scheduled MultiGateReorderRoutingMethod") {
+    nlohmann::json j_rm;
+    j_rm["name"] = "MultiGateReorderRoutingMethod";
+    j_rm["depth"] = 3;
+    j_rm["size"] = 100;
+    j_rm["scheduled"] = true;
+    MultiGateReorderRoutingMethod rm_loaded =
+        MultiGateReorderRoutingMethod::deserialize(j_rm);
+    REQUIRE(rm_loaded.is_scheduled());
+    nlohmann::json j_rm_serialised = rm_loaded.serialize();
+    REQUIRE(j_rm == j_rm_serialised);
+  }
 
   GIVEN("RoutingMethod vector") {
     nlohmann::json j_rms = {
@@ -0,0 +1,91 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+#include "tket/Mapping/MappingManager.hpp"
+#include "tket/Mapping/NoiseAwareRoutingMethod.hpp"
+#include "tket/Mapping/RoutingMethodJson.hpp"
+
+namespace tket {
+
+SCENARIO("LinkErrorDistances weights paths by link error") {
+  std::vector<Node> nodes;
+  for (unsigned i = 0; i < 4; i++) nodes.push_back(Node("test_node", i));
+  // n0 -- n1 -- n2 -- n3 -- n0, with a noisy link n0 -- n1
+  Architecture arc(
+      {{nodes[0], nodes[1]},
+       {nodes[1], nodes[2]},
+       {nodes[2], nodes[3]},
+       {nodes[3], nodes[0]}});
+  avg_link_errors_t link_errors = {
+      {{nodes[0], nodes[1]}, 0.5},
+      {{nodes[2], nodes[1]}, 0.01},
+      {{nodes[2], nodes[3]}, 0.01},
+      {{nodes[3], nodes[0]}, 0.01}};
+  DeviceCharacterisation characterisation({}, link_errors);
+  LinkErrorDistances distances(arc, characterisation);
+  const double good = -3. * std::log(0.99);
+  REQUIRE(
+      distances.get_swap_cost(nodes[1], nodes[0]) ==
+      Catch::Approx(-3. * std::log(0.5)));
+  REQUIRE(distances.get_swap_cost(nodes[1], nodes[2]) == Catch::Approx(good));
+  REQUIRE(distances.get_distance(nodes[0], nodes[0]) == 0.);
+  // The cheapest path avoids the noisy link.
+  REQUIRE(
+      distances.get_distance(nodes[0], nodes[1]) == Catch::Approx(3 * good));
+  REQUIRE(
+      distances.get_distance(nodes[0], nodes[2]) == Catch::Approx(2 * good));
+  REQUIRE_THROWS_AS(
+      distances.get_swap_cost(nodes[0], nodes[2]), std::out_of_range);
+
+  GIVEN("A Circuit routed with NoiseAwareRoutingMethod") {
+    Circuit circ(4);
+    circ.add_op<unsigned>(OpType::CX, {0, 2});
+    circ.add_op<unsigned>(OpType::CX, {1, 3});
+    circ.add_op<unsigned>(OpType::CX, {0, 2});
+    std::map<UnitID, UnitID> rename_map;
+    for (unsigned i = 0; i < 4; i++) rename_map.insert({Qubit(i), nodes[i]});
+    circ.rename_units(rename_map);
+    MappingManager mm(std::make_shared<Architecture>(arc));
+    REQUIRE(mm.route_circuit(
+        circ,
+        {std::make_shared<NoiseAwareRoutingMethod>(characterisation)}));
+    for (const Command& com : circ) {
+      unit_vector_t args = com.get_args();
+      REQUIRE(args.size() == 2);
+      REQUIRE(arc.valid_operation({Node(args[0]), Node(args[1])}));
+      if (com.get_op_ptr()->get_type() == OpType::SWAP) {
+        std::set<Node> swap_nodes = {Node(args[0]), Node(args[1])};
+        REQUIRE(swap_nodes != std::set<Node>{nodes[0], nodes[1]});
+      }
+    }
+  }
+  GIVEN("Serialization") {
+    std::vector<RoutingMethodPtr> methods = {
+        std::make_shared<NoiseAwareRoutingMethod>(characterisation, 5)};
+    nlohmann::json j = methods;
+    std::vector<RoutingMethodPtr> loaded =
+        j.get<std::vector<RoutingMethodPtr>>();
+    REQUIRE(loaded.size() == 1);
+    const NoiseAwareRoutingMethod& method =
+        static_cast<const NoiseAwareRoutingMethod&>(*loaded[0]);
+    REQUIRE(method.get_max_depth() == 5);
+    REQUIRE(method.get_characterisation() == characterisation);
+  }
+}
+
+}  // namespace tket
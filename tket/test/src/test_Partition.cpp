@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <limits>
+#include <random>
 
 #include "testutil.hpp"
 #include "tket/Diagonalisation/PauliPartition.hpp"
@@ -88,6 +90,132 @@ SCENARIO("Small sets of Gadgets are partitioned correctly") {
       }
     }
   }
+
+SCENARIO("Larger sets of gadgets are partitioned into valid sets") {
+  GIVEN("Random strings over many qubits") {
+    // Enough terms to span several tiles of pair checks
+    std::mt19937 gen(5);
+    std::set<SpPauliString> unique;
+    while (unique.size() < 300) {
+      QubitPauliMap qpm;
+      for (unsigned k = 0; k < 4; ++k) {
+        qpm[Qubit(gen() % 70)] = Pauli(1 + gen() % 3);
+      }
+      unique.insert(SpPauliString(qpm));
+    }
+    const std::list<SpPauliString> all_tensors(unique.begin(), unique.end());
+    for (GraphColourMethod colouring_method :
+         {GraphColourMethod::LargestFirst, GraphColourMethod::Exhaustive}) {
+      // Keep the exact colouring small
+      std::list<SpPauliString> tensors = all_tensors;
+      if (colouring_method == GraphColourMethod::Exhaustive) tensors.resize(80);
+      for (PauliPartitionStrat strat :
+           {PauliPartitionStrat::NonConflictingSets,
+            PauliPartitionStrat::CommutingSets}) {
+        std::list<std::list<SpPauliString>> terms =
+            term_sequence(tensors, strat, colouring_method);
+        unsigned total_terms = 0;
+        for (const std::list<SpPauliString>& set : terms) {
+          total_terms += set.size();
+          for (const SpPauliString& a : set) {
+            for (const SpPauliString& b : set) {
+              if (strat == PauliPartitionStrat::CommutingSets) {
+                REQUIRE(a.commutes_with(b));
+              } else {
+                REQUIRE(a.conflicting_qubits(b).empty());
+              }
+            }
+          }
+        }
+        REQUIRE(total_terms == tensors.size());
+      }
+    }
+  }
+}
+
+SCENARIO("Sorted insertion partitions weighted terms") {
+  GIVEN("Random weighted terms") {
+    std::mt19937 gen(7);
+    std::list<SpCxPauliTensor> terms;
+    for (unsigned t = 0; t < 200; ++t) {
+      QubitPauliMap qpm;
+      for (unsigned k = 0; k < 3; ++k) {
+        qpm[Qubit(gen() % 20)] = Pauli(1 + gen() % 3);
+      }
+      terms.push_back(SpCxPauliTensor(qpm, Complex(gen() % 1000, 0.)));
+    }
+    for (PauliPartitionStrat strat :
+         {PauliPartitionStrat::NonConflictingSets,
+          PauliPartitionStrat::CommutingSets}) {
+      std::list<std::list<SpCxPauliTensor>> sets =
+          term_sequence_sorted_insertion(terms, strat);
+      unsigned total_terms = 0;
+      double last_leader = std::numeric_limits<double>::infinity();
+      for (const std::list<SpCxPauliTensor>& set : sets) {
+        total_terms += set.size();
+        // Each set is started by the largest term not yet placed
+        REQUIRE(std::abs(set.front().coeff) <= last_leader);
+        last_leader = std::abs(set.front().coeff);
+        for (const SpCxPauliTensor& a : set) {
+          REQUIRE(std::abs(a.coeff) <= std::abs(set.front().coeff));
+          for (const SpCxPauliTensor& b : set) {
+            if (strat == PauliPartitionStrat::CommutingSets) {
+              REQUIRE(a.commutes_with(b));
+            } else {
+              REQUIRE(a.conflicting_qubits(b).empty());
+            }
+          }
+        }
+      }
+      REQUIRE(total_terms == terms.size());
+    }
+  }
+}
+
+SCENARIO("Strings are partitioned as they are streamed in") {
+  GIVEN("Chunks of random strings with repeats") {
+    std::mt19937 gen(11);
+    std::list<std::list<SpPauliString>> chunks;
+    std::list<SpPauliString> first_seen;
+    std::set<SpPauliString> seen;
+    for (unsigned c = 0; c < 8; ++c) {
+      std::list<SpPauliString>& chunk = chunks.emplace_back();
+      for (unsigned t = 0; t < 40; ++t) {
+        QubitPauliMap qpm;
+        for (unsigned k = 0; k < 2; ++k) {
+          qpm[Qubit(gen() % 90)] = Pauli(1 + gen() % 3);
+        }
+        SpPauliString string(qpm);
+        chunk.push_back(string);
+        if (seen.insert(string).second) first_seen.push_back(string);
+      }
+      // Repeat some strings within and across chunks
+      chunk.push_back(chunk.front());
+      chunk.push_back(chunks.front().back());
+    }
+    for (PauliPartitionStrat strat :
+         {PauliPartitionStrat::NonConflictingSets,
+          PauliPartitionStrat::CommutingSets}) {
+      PauliPartitionStream stream(strat);
+      std::size_t n_new = 0;
+      for (const std::list<SpPauliString>& chunk : chunks) {
+        n_new += stream.add_strings(chunk);
+      }
+      // Repeats are dropped
+      REQUIRE(n_new == first_seen.size());
+      REQUIRE(stream.n_strings() == first_seen.size());
+      // The sets match the lazy colouring of the distinct strings
+      std::list<std::list<SpPauliString>> expected =
+          term_sequence(first_seen, strat, GraphColourMethod::Lazy);
+      REQUIRE(stream.n_sets() == expected.size());
+      REQUIRE(stream.get_sets() == expected);
+    }
+  }
+  GIVEN("An unknown strategy") {
+    REQUIRE_THROWS_AS(
+        PauliPartitionStream(PauliPartitionStrat(7)),
+        UnknownPauliPartitionStrat);
+  }
 }
 
 }  // namespace test_Partition
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <set>
 
 #include "tket/ArchAwareSynth/Path.hpp"
 
@@ -928,6 +929,53 @@ SCENARIO("Check Hamiltonian path construction is correct") {
     }
   }
 }
+SCENARIO("Check the heuristic Hamiltonian path search") {
+  // Check that a path visits every node once, along connections.
+  const auto check_path = [](const Architecture &arch,
+                             const std::vector<Node> &path) {
+    REQUIRE(path.size() == arch.n_nodes());
+    REQUIRE(std::set<Node>(path.begin(), path.end()).size() == path.size());
+    for (unsigned i = 1; i < path.size(); ++i) {
+      REQUIRE(
+          (arch.edge_exists(path[i - 1], path[i]) ||
+           arch.edge_exists(path[i], path[i - 1])));
+    }
+  };
+  GIVEN("A grid") {
+    std::vector<std::pair<unsigned, unsigned>> edges;
+    const unsigned width = 7, height = 5;
+    for (unsigned row = 0; row < height; ++row) {
+      for (unsigned col = 0; col < width; ++col) {
+        const unsigned node = row * width + col;
+        if (col + 1 < width) edges.push_back({node, node + 1});
+        if (row + 1 < height) edges.push_back({node + width, node});
+      }
+    }
+    const Architecture arch(edges);
+    const auto path = aas::find_hampath_heuristic(arch, 8, 1);
+    REQUIRE(path);
+    check_path(arch, *path);
+    // The result does not depend on the number of threads.
+    REQUIRE(aas::find_hampath_heuristic(arch, 8, 4) == path);
+
+    const std::vector<Node> ham = aas::find_hampath(arch);
+    check_path(arch, ham);
+    // The second call uses the cached path.
+    REQUIRE(aas::find_hampath(arch) == ham);
+  }
+  GIVEN("Architectures without a path") {
+    const Architecture star(
+        {{Node(0), Node(1)}, {Node(0), Node(2)}, {Node(0), Node(3)}});
+    REQUIRE_FALSE(aas::find_hampath_heuristic(star));
+    Architecture disconnected({{Node(0), Node(1)}, {Node(2), Node(3)}});
+    REQUIRE_FALSE(aas::find_hampath_heuristic(disconnected));
+    REQUIRE_THROWS_AS(aas::find_hampath(disconnected), aas::NoHamiltonPath);
+  }
+  GIVEN("A single node") {
+    const Architecture arch(std::vector<Node>{Node(3)});
+    REQUIRE(aas::find_hampath(arch) == std::vector<Node>{Node(3)});
+  }
+}
 SCENARIO("Check iteration order construciton") {
   GIVEN("iteration order - simple example") {
     Architecture arch(
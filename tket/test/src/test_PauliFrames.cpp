@@ -0,0 +1,117 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+#include "tket/Circuit/Circuit.hpp"
+#include "tket/Clifford/PauliFrames.hpp"
+#include "tket/Clifford/UnitaryTableau.hpp"
+#include "tket/Converters/Converters.hpp"
+#include "tket/OpType/OpTypeInfo.hpp"
+
+namespace tket::test_PauliFrames {
+
+SCENARIO("Pauli frames propagate through Clifford circuits") {
+  GIVEN("Random frames and a random Clifford circuit") {
+    std::mt19937 gen(3);
+    const unsigned n_qubits = 5;
+    const unsigned n_shots = 130;
+    const std::vector<OpType> one_qubit_gates{
+        OpType::H, OpType::S, OpType::V, OpType::X, OpType::Z, OpType::Sdg};
+    const std::vector<OpType> two_qubit_gates{
+        OpType::CX, OpType::CZ, OpType::CY, OpType::ECR, OpType::SWAP,
+        OpType::ZZMax};
+    Circuit circ(n_qubits);
+    for (unsigned i = 0; i < 100; ++i) {
+      unsigned q0 = gen() % n_qubits;
+      std::vector<unsigned> args{q0};
+      OpType type;
+      if (gen() % 2 == 0) {
+        type = one_qubit_gates[gen() % one_qubit_gates.size()];
+      } else {
+        type = two_qubit_gates[gen() % two_qubit_gates.size()];
+        args.push_back((q0 + 1 + gen() % (n_qubits - 1)) % n_qubits);
+      }
+      circ.add_op<unsigned>(type, args);
+    }
+    circ.replace_SWAPs();
+    REQUIRE(circ.has_implicit_wireswaps());
+    PauliFrames frames(n_qubits, n_shots);
+    RNG rng;
+    for (unsigned q = 0; q < n_qubits; ++q) frames.randomise(q, rng);
+    std::vector<PauliStabiliser> initial;
+    for (unsigned s = 0; s < n_shots; ++s) {
+      initial.push_back(frames.get_frame(s));
+    }
+    frames.propagate(circ);
+    THEN("Each frame is conjugated by the circuit, up to sign") {
+      const UnitaryTableau tab = circuit_to_unitary_tableau(circ);
+      for (unsigned s = 0; s < n_shots; ++s) {
+        SpPauliStabiliser image =
+            tab.get_row_product(SpPauliStabiliser(initial[s].string));
+        PauliStabiliser frame = frames.get_frame(s);
+        for (unsigned q = 0; q < n_qubits; ++q) {
+          REQUIRE(frame.get(q) == image.get(Qubit(q)));
+        }
+      }
+    }
+    THEN("Padding beyond the last shot is left clear") {
+      for (unsigned s = n_shots; s < 192; ++s) {
+        for (unsigned q = 0; q < n_qubits; ++q) {
+          const unsigned w = s / BitMatrix::BITS_PER_WORD;
+          const unsigned b = s % BitMatrix::BITS_PER_WORD;
+          REQUIRE(((frames.x_planes().row_data(q)[w] >> b) & 1) == 0);
+          REQUIRE(((frames.z_planes().row_data(q)[w] >> b) & 1) == 0);
+        }
+      }
+    }
+  }
+  GIVEN("A circuit with measurements and resets") {
+    Circuit circ(3, 2);
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::Measure, {1, 0});
+    circ.add_op<unsigned>(OpType::Reset, {2});
+    circ.add_op<unsigned>(OpType::H, {2});
+    circ.add_op<unsigned>(OpType::Measure, {2, 1});
+    PauliFrames frames(3, 4);
+    frames.set_frame(0, {Pauli::X, Pauli::I, Pauli::I});
+    frames.set_frame(1, {Pauli::Z, Pauli::I, Pauli::I});
+    frames.set_frame(2, {Pauli::I, Pauli::Y, Pauli::Z});
+    frames.set_frame(3, {Pauli::I, Pauli::I, Pauli::X});
+    BitMatrix flips = frames.propagate(circ);
+    THEN("Only frames anticommuting with the measurement flip it") {
+      REQUIRE(flips.rows() == 2);
+      REQUIRE(flips(0, 0));
+      REQUIRE_FALSE(flips(0, 1));
+      REQUIRE(flips(0, 2));
+      REQUIRE_FALSE(flips(0, 3));
+    }
+    THEN("Resets clear the frames") {
+      for (unsigned s = 0; s < 4; ++s) {
+        REQUIRE_FALSE(flips(1, s));
+        REQUIRE(frames.get_frame(s).get(2) == Pauli::I);
+      }
+    }
+  }
+  GIVEN("Invalid circuits") {
+    PauliFrames frames(2, 10);
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::T, {0});
+    REQUIRE_THROWS_AS(frames.propagate(circ), BadOpType);
+    REQUIRE_THROWS_AS(frames.propagate(Circuit(3)), std::invalid_argument);
+  }
+}
+
+}  // namespace tket::test_PauliFrames
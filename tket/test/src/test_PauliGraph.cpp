@@ -212,6 +212,34 @@ SCENARIO("Correct creation of PauliGraphs") {
     PauliGraph pg = circuit_to_pauli_graph(circ);
     REQUIRE(pg.n_vertices() == 1);
   }
+  GIVEN("Gadgets merging past many commuting gadgets") {
+    Circuit circ(4);
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {0});
+    circ.add_op<unsigned>(OpType::Rx, 0.2, {0});
+    for (unsigned q = 1; q < 4; ++q) {
+      circ.add_op<unsigned>(OpType::Rz, 0.1, {q});
+      circ.add_op<unsigned>(OpType::Rx, 0.1, {q});
+    }
+    // Merges with the first Rx
+    circ.add_op<unsigned>(OpType::Rx, 0.4, {0});
+    // Blocked from the first Rz by the Rx
+    circ.add_op<unsigned>(OpType::Rz, 0.5, {0});
+    circ.add_op<unsigned>(OpType::ZZPhase, 0.3, {0, 3});
+    PauliGraph pg = circuit_to_pauli_graph(circ);
+    pg.sanity_check();
+    REQUIRE(pg.n_vertices() == 10);
+  }
+  GIVEN("Gadgets on qubits more than a word apart") {
+    Circuit circ(70);
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {69});
+    circ.add_op<unsigned>(OpType::Rx, 0.2, {0});
+    circ.add_op<unsigned>(OpType::Rz, 0.4, {69});
+    circ.add_op<unsigned>(OpType::XXPhase, 0.3, {0, 69});
+    circ.add_op<unsigned>(OpType::Rz, 0.1, {69});
+    PauliGraph pg = circuit_to_pauli_graph(circ);
+    pg.sanity_check();
+    REQUIRE(pg.n_vertices() == 4);
+  }
 }
 
 SCENARIO("TopSortIterator") {
@@ -279,6 +307,65 @@ SCENARIO("Synthesising PauliGraphs") {
   }
 }
 
+SCENARIO("Synthesising PauliGraphs within a Clifford frame") {
+  GIVEN("A UCCSD example") {
+    const auto& circ = CircuitsForTesting::get().uccsd;
+    const PauliGraph pg = circuit_to_pauli_graph(circ);
+    for (unsigned lookahead : {1u, 4u, 16u}) {
+      Circuit synth = pauli_graph_to_circuit_lookahead(pg, lookahead);
+      REQUIRE(test_unitary_comparison(circ, synth, true));
+    }
+  }
+  GIVEN("Gadgets with symbols, identities and Cliffords between them") {
+    Circuit circ(3);
+    Sym a = SymTable::fresh_symbol("a");
+    Sym b = SymTable::fresh_symbol("b");
+    PauliExpBox peb0({{Pauli::Z, Pauli::X, Pauli::Y}, Expr(a)});
+    PauliExpBox peb1({{Pauli::I, Pauli::I, Pauli::I}, 0.41});
+    PauliExpBox peb2({{Pauli::Y, Pauli::I, Pauli::X}, Expr(b)});
+    PauliExpBox peb3({{Pauli::X, Pauli::Z, Pauli::Z}, 0.83});
+    circ.add_box(peb0, {0, 1, 2});
+    circ.add_op<unsigned>(OpType::CX, {2, 0});
+    circ.add_op<unsigned>(OpType::S, {1});
+    circ.add_box(peb1, {0, 1, 2});
+    circ.add_box(peb2, {0, 1, 2});
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::Rz, 0.27, {0});
+    circ.add_box(peb3, {0, 1, 2});
+    PauliGraph pg = circuit_to_pauli_graph(circ);
+    Circuit synth = pauli_graph_to_circuit_lookahead(pg);
+    std::map<Sym, double, SymEngine::RCPBasicKeyLess> symbol_map = {
+        {a, 0.3112}, {b, -0.911}};
+    circ.symbol_substitution(symbol_map);
+    synth.symbol_substitution(symbol_map);
+    REQUIRE(test_unitary_comparison(circ, synth, true));
+  }
+  GIVEN("A sequence of overlapping gadgets") {
+    Circuit circ(5);
+    for (unsigned q = 0; q + 1 < 5; ++q) {
+      Pauli p = (q % 2 == 0) ? Pauli::Z : Pauli::X;
+      PauliExpBox peb({{p, Pauli::Z, p}, 0.1 * (q + 1)});
+      circ.add_box(peb, {q, q + 1, (q + 2) % 5});
+    }
+    PauliGraph pg = circuit_to_pauli_graph(circ);
+    Circuit synth = pauli_graph_to_circuit_lookahead(pg);
+    REQUIRE(test_unitary_comparison(circ, synth, true));
+  }
+  GIVEN("A circuit with end-of-circuit measurements") {
+    Circuit circ(2, 2);
+    circ.add_op<unsigned>(OpType::S, {0});
+    circ.add_op<unsigned>(OpType::V, {1});
+    circ.add_op<unsigned>(OpType::Rz, 0.2, {0});
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+    circ.add_op<unsigned>(OpType::Measure, {0, 1});
+    circ.add_op<unsigned>(OpType::Measure, {1, 0});
+    PauliGraph pg = circuit_to_pauli_graph(circ);
+    Circuit synth = pauli_graph_to_circuit_lookahead(pg);
+    std::map<Qubit, unsigned> correct_readout = {{Qubit(0), 1}, {Qubit(1), 0}};
+    REQUIRE(synth.qubit_readout() == correct_readout);
+  }
+}
+
 // Probably no special significance, just something repeated several times
 static void add_ops_to_prepend_1(Circuit& circ) {
   circ.add_op<unsigned>(OpType::Rx, 1.511, {2});
@@ -787,6 +874,54 @@ SCENARIO("Conjugating Cliffords through Pauli tensors") {
       }
     }
   }
+  GIVEN("Dense and sparse copies of every 2qb pauli tensor") {
+    const std::vector<Pauli> paulis{Pauli::I, Pauli::X, Pauli::Y, Pauli::Z};
+    const std::vector<OpType> gates{
+        OpType::H,   OpType::S, OpType::Sdg, OpType::V,
+        OpType::Vdg, OpType::X, OpType::Y,   OpType::Z};
+    Qubit qb0(0), qb1(1);
+    unsigned i0 = 0, i1 = 1;
+    THEN("The dense conjugations agree with the sparse ones") {
+      for (Pauli p0 : paulis) {
+        for (Pauli p1 : paulis) {
+          for (OpType ot : gates) {
+            for (bool reverse : {false, true}) {
+              SpPauliStabiliser sparse(DensePauliMap{p0, p1});
+              PauliStabiliser dense(DensePauliMap{p0, p1});
+              conjugate_PauliTensor(sparse, ot, qb1, reverse);
+              conjugate_PauliTensor(dense, ot, i1, reverse);
+              REQUIRE(dense.get(0) == sparse.get(qb0));
+              REQUIRE(dense.get(1) == sparse.get(qb1));
+              REQUIRE(dense.coeff == sparse.coeff);
+            }
+          }
+          SpPauliStabiliser sparse(DensePauliMap{p0, p1});
+          PauliStabiliser dense(DensePauliMap{p0, p1});
+          conjugate_PauliTensor(sparse, OpType::CX, qb0, qb1);
+          conjugate_PauliTensor(dense, OpType::CX, i0, i1);
+          REQUIRE(dense.get(0) == sparse.get(qb0));
+          REQUIRE(dense.get(1) == sparse.get(qb1));
+          REQUIRE(dense.coeff == sparse.coeff);
+        }
+      }
+    }
+    THEN("Reverse conjugation undoes forward conjugation") {
+      for (Pauli p : paulis) {
+        for (OpType ot : gates) {
+          std::pair<Pauli, bool> fwd = conjugate_Pauli(ot, p);
+          std::pair<Pauli, bool> back = conjugate_Pauli(ot, fwd.first, true);
+          REQUIRE(back.first == p);
+          REQUIRE(back.second == fwd.second);
+        }
+      }
+    }
+    THEN("Unsupported gates are rejected") {
+      PauliStabiliser dense(DensePauliMap{Pauli::X, Pauli::Z});
+      REQUIRE_THROWS_AS(conjugate_PauliTensor(dense, OpType::T, i0), BadOpType);
+      REQUIRE_THROWS_AS(
+          conjugate_PauliTensor(dense, OpType::CZ, i0, i1), BadOpType);
+    }
+  }
 }
 
 SCENARIO("Test greedy diagonalisation explicitly") {
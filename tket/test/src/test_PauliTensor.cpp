@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <random>
 
 #include "tket/Utils/PauliTensor.hpp"
 
@@ -619,5 +620,71 @@ SCENARIO("Test matrix evaluation") {
   }
 }
 
+SCENARIO("Bit-packed PauliTensor agrees with dense") {
+  GIVEN("Random strings spanning several words") {
+    std::mt19937 gen(1);
+    auto random_string = [&](unsigned n) {
+      DensePauliMap paulis(n);
+      for (Pauli &p : paulis) p = Pauli(gen() % 4);
+      return paulis;
+    };
+    for (unsigned t = 0; t < 50; ++t) {
+      DensePauliMap d0 = random_string(60 + gen() % 80);
+      DensePauliMap d1 = random_string(60 + gen() % 80);
+      if (t % 5 == 0) d1 = d0;
+      PauliStabiliser dense0(d0, gen() % 4), dense1(d1, gen() % 4);
+      PkPauliStabiliser packed0(d0, dense0.coeff), packed1(d1, dense1.coeff);
+      REQUIRE(packed0.size() == d0.size());
+      for (unsigned i = 0; i < d0.size() + 3; ++i) {
+        REQUIRE(packed0.get(i) == dense0.get(i));
+      }
+      REQUIRE(packed0.commutes_with(packed1) == dense0.commutes_with(dense1));
+      REQUIRE(packed0.compare(packed1) == dense0.compare(dense1));
+      REQUIRE(packed0.common_indices(packed1) == dense0.common_indices(dense1));
+      REQUIRE(packed0.own_indices(packed1) == dense0.own_indices(dense1));
+      REQUIRE(
+          packed0.conflicting_indices(packed1) ==
+          dense0.conflicting_indices(dense1));
+      REQUIRE(
+          have_conflicting_indices(packed0.string, packed1.string) ==
+          !dense0.conflicting_indices(dense1).empty());
+      REQUIRE(
+          (PauliStabiliser)(packed0 * packed1) ==
+          (PauliStabiliser)(dense0 * dense1));
+      packed0.transpose();
+      dense0.transpose();
+      REQUIRE(packed0.coeff == dense0.coeff);
+      REQUIRE(packed0.to_str() == dense0.to_str());
+    }
+  }
+  GIVEN("Strings differing only by padding") {
+    DensePauliMap d{Pauli::X, Pauli::I, Pauli::Z};
+    DensePauliMap padded = d;
+    padded.resize(100, Pauli::I);
+    PkPauliString p0(d), p1(padded);
+    REQUIRE(p0 == p1);
+    REQUIRE(p0.hash_value() == p1.hash_value());
+    p1.set(99, Pauli::Y);
+    REQUIRE(p0 < p1);
+    p1.set(99, Pauli::I);
+    p1.string.resize(2);
+    REQUIRE(p1.get(2) == Pauli::I);
+    REQUIRE(p0 != p1);
+  }
+  GIVEN("Casting and serialisation") {
+    SpCxPauliTensor sparse({{Qubit(0), Pauli::Y}, {Qubit(70), Pauli::X}}, 0.5);
+    PkCxPauliTensor packed = (PkCxPauliTensor)sparse;
+    REQUIRE(packed.get(0) == Pauli::Y);
+    REQUIRE(packed.get(70) == Pauli::X);
+    REQUIRE((SpCxPauliTensor)packed == sparse);
+    nlohmann::json j = packed;
+    REQUIRE(j.get<PkCxPauliTensor>() == packed);
+    PkCxPauliTensor small(DensePauliMap{Pauli::X, Pauli::Y}, 2.);
+    CHECK(small.to_sparse_matrix(3).isApprox(
+        CxPauliTensor(DensePauliMap{Pauli::X, Pauli::Y}, 2.)
+            .to_sparse_matrix(3)));
+  }
+}
+
 }  // namespace test_PauliTensor
 }  // namespace tket
@@ -114,6 +114,51 @@ SCENARIO("Test basic phase polynomial creation") {
     REQUIRE(basis_map == correct_basis_map);
   }
 }
+SCENARIO("Test PhasePolyBuilder") {
+  GIVEN("Parities spanning several words") {
+    unsigned n = 70;
+    PhasePolyBuilder builder(n);
+    for (unsigned i = 0; i + 1 < n; ++i) builder.add_cx(i, i + 1);
+    builder.add_rz(n - 1, 0.25);
+    builder.add_rz(0, 0.5);
+    builder.add_rz(n - 1, 0.25);
+    const PhasePolynomial phasepoly = builder.get_phase_polynomial();
+    REQUIRE(phasepoly.size() == 2);
+    REQUIRE(test_equiv_val(phasepoly.at(std::vector<bool>(n, true)), 0.5));
+    std::vector<bool> first(n, false);
+    first[0] = true;
+    REQUIRE(test_equiv_val(phasepoly.at(first), 0.5));
+    const MatrixXb lin = builder.get_linear_transformation();
+    for (unsigned i = 0; i < n; ++i) {
+      for (unsigned j = 0; j < n; ++j) {
+        REQUIRE(lin(i, j) == (j <= i));
+      }
+    }
+    builder.clear();
+    REQUIRE(builder.get_phase_polynomial().empty());
+    REQUIRE(builder.get_linear_transformation() == MatrixXb::Identity(n, n));
+  }
+  GIVEN("The same gates as a circuit") {
+    Circuit circ(4);
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+    circ.add_op<unsigned>(OpType::CX, {2, 1});
+    circ.add_op<unsigned>(OpType::CX, {1, 3});
+    circ.add_op<unsigned>(OpType::Rz, 0.7, {3});
+    PhasePolyBuilder builder(4);
+    builder.add_cx(0, 1);
+    builder.add_rz(1, 0.3);
+    builder.add_cx(2, 1);
+    builder.add_cx(1, 3);
+    builder.add_rz(3, 0.7);
+    PhasePolyBox ppbox(circ);
+    REQUIRE(builder.get_phase_polynomial() == ppbox.get_phase_polynomial());
+    REQUIRE(
+        builder.get_linear_transformation() ==
+        ppbox.get_linear_transformation());
+  }
+}
+
 SCENARIO("Test phase polynomial creation and decomposition") {
   GIVEN("default registers") {
     Circuit circ(3);
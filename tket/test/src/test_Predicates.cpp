@@ -695,5 +695,85 @@ SCENARIO("RemoveImplicitQubitPermutation") {
   REQUIRE(!no_mid_meas->verify(cu.get_circ_ref()));
 }
 
+SCENARIO("Checking predicates only where a circuit changed") {
+  Architecture arc({{0, 1}, {1, 0}, {1, 2}, {2, 1}});
+  PredicatePtr conn = std::make_shared<ConnectivityPredicate>(arc);
+  PredicatePtr dir = std::make_shared<DirectednessPredicate>(arc);
+  PredicatePtr gates =
+      std::make_shared<GateSetPredicate>(OpTypeSet{OpType::CX, OpType::SWAP});
+  Circuit circ;
+  for (unsigned i = 0; i < 3; ++i) circ.add_qubit(Node(i));
+  circ.add_op<UnitID>(OpType::SWAP, {Node(1), Node(2)});
+  circ.add_op<UnitID>(OpType::CX, {Node(0), Node(1)});
+  REQUIRE(conn->verify(circ));
+  REQUIRE(gates->verify(circ));
+  REQUIRE(circ.get_change_log() == nullptr);
+  circ.record_changes();
+  const Circuit::ChangeLog* log = circ.get_change_log();
+  REQUIRE(log != nullptr);
+  const std::size_t since = log->count;
+  REQUIRE(conn->verify_changes(circ, *log, since));
+  GIVEN("A new gate") {
+    Vertex v = circ.add_op<UnitID>(OpType::H, {Node(0)});
+    REQUIRE(log->ops.at(v) > since);
+    REQUIRE_FALSE(gates->verify_changes(circ, *log, since));
+    REQUIRE(conn->verify_changes(circ, *log, since));
+    Vertex w = circ.add_op<UnitID>(OpType::CX, {Node(2), Node(0)});
+    REQUIRE_FALSE(conn->verify_changes(circ, *log, since));
+    REQUIRE_FALSE(dir->verify_changes(circ, *log, since));
+    // Only changes after the last verification are checked
+    REQUIRE(gates->verify_changes(circ, *log, log->ops.at(v)));
+    circ.remove_vertex(
+        w, Circuit::GraphRewiring::Yes, Circuit::VertexDeletion::Yes);
+    REQUIRE(log->ops.count(w) == 0);
+    REQUIRE(conn->verify_changes(circ, *log, since));
+  }
+  GIVEN("Rewired gates") {
+    // The CX now acts on nodes 0 and 2
+    circ.replace_SWAPs();
+    REQUIRE(gates->verify_changes(circ, *log, since));
+    REQUIRE_FALSE(conn->verify_changes(circ, *log, since));
+    REQUIRE_FALSE(conn->verify(circ));
+  }
+  GIVEN("Renamed qubits") {
+    // The CX now acts on nodes 0 and 2
+    std::map<Qubit, Qubit> swap_names{{Node(1), Node(2)}, {Node(2), Node(1)}};
+    circ.rename_units(swap_names);
+    REQUIRE(log->all > since);
+    REQUIRE_FALSE(conn->verify_changes(circ, *log, since));
+  }
+  GIVEN("An assignment to the circuit") {
+    Circuit other(3);
+    circ = other;
+    REQUIRE(circ.get_change_log() == log);
+    REQUIRE(log->all > since);
+    REQUIRE(log->ops.empty());
+    REQUIRE_FALSE(conn->verify_changes(circ, *log, since));
+  }
+  GIVEN("A copy of the circuit") {
+    Circuit copy = circ;
+    REQUIRE(copy.get_change_log() == nullptr);
+    circ.stop_recording_changes();
+    REQUIRE(circ.get_change_log() == nullptr);
+  }
+  GIVEN("Passes applied in audit mode") {
+    Circuit c(3);
+    c.add_op<unsigned>(OpType::H, {0});
+    c.add_op<unsigned>(OpType::CX, {0, 2});
+    c.add_op<unsigned>(OpType::CX, {2, 1});
+    c.add_op<unsigned>(OpType::Rz, 0.3, {1});
+    c.add_op<unsigned>(OpType::CX, {0, 1});
+    PassPtr pp = gen_default_mapping_pass(arc) >>
+                 gen_decompose_routing_gates_to_cxs_pass(arc, true);
+    CompilationUnit cu_default(c);
+    CompilationUnit cu_audit(c);
+    pp->apply(cu_default);
+    pp->apply(cu_audit, SafetyMode::Audit);
+    REQUIRE(cu_audit.get_circ_ref() == cu_default.get_circ_ref());
+    REQUIRE(cu_audit.get_circ_ref().get_change_log() != nullptr);
+    REQUIRE(cu_audit.audit_predicate(CompilationUnit::make_type_pair(dir)));
+  }
+}
+
 }  // namespace test_Predicates
 }  // namespace tket
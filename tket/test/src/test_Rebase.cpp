@@ -24,6 +24,7 @@
 #include "tket/Transformations/BasicOptimisation.hpp"
 #include "tket/Transformations/Decomposition.hpp"
 #include "tket/Transformations/Rebase.hpp"
+#include "tket/Transformations/Replacement.hpp"
 #include "tket/Transformations/Transform.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
 
@@ -301,6 +302,42 @@ SCENARIO("Building rebases with rebase_factory") {
     correct.add_phase(0.125);
     REQUIRE(circ == correct);
   }
+  GIVEN("A circuit with repeated single-qubit gates") {
+    Circuit circ(3);
+    for (unsigned i = 0; i < 4; ++i) {
+      circ.add_op<unsigned>(OpType::H, {i % 3});
+      circ.add_op<unsigned>(OpType::Rx, 0.3, {(i + 1) % 3});
+      circ.add_op<unsigned>(OpType::CX, {i % 3, (i + 1) % 3});
+      circ.add_op<unsigned>(OpType::Z, {2});
+    }
+    circ.add_op<unsigned>(OpType::Ry, 0.7, {0}, "group");
+    Circuit original = circ;
+    REQUIRE(Transforms::rebase_quil().apply(circ));
+    REQUIRE(circ.count_gates(OpType::H) == 0);
+    REQUIRE(circ.count_gates(OpType::Ry) == 0);
+    REQUIRE(circ.count_gates(OpType::CZ) == 4);
+    REQUIRE(test_unitary_comparison(original, circ));
+    // Identical gates are rewritten to identical sequences
+    Circuit h_circ(1);
+    h_circ.add_op<unsigned>(OpType::H, {0});
+    h_circ.add_op<unsigned>(OpType::H, {0});
+    Transforms::rebase_quil().apply(h_circ);
+    std::vector<Command> cmds = h_circ.get_commands();
+    REQUIRE(cmds.size() % 2 == 0);
+    for (unsigned i = 0; i < cmds.size() / 2; ++i) {
+      REQUIRE(*cmds[i].get_op_ptr() == *cmds[i + cmds.size() / 2].get_op_ptr());
+    }
+  }
+  GIVEN("A symbolic single-qubit gate") {
+    Sym a = SymEngine::symbol("a");
+    Circuit circ(1);
+    circ.add_op<unsigned>(OpType::Ry, Expr(a), {0});
+    circ.add_op<unsigned>(OpType::Ry, 0.2, {0});
+    Transforms::rebase_quil().apply(circ);
+    REQUIRE(circ.count_gates(OpType::Ry) == 0);
+    REQUIRE(circ.count_gates(OpType::Rx) == 2);
+    REQUIRE(circ.is_symbolic());
+  }
 }
 
 SCENARIO("Decompose all boxes") {
@@ -566,5 +603,46 @@ SCENARIO("Decompose NPhasedX gates into PhasedX") {
   }
 }
 
+SCENARIO("Reusing replacements of repeated gates") {
+  GIVEN("A table of replacements") {
+    unsigned n_built = 0;
+    ReplacementTable table([&n_built](const Op_ptr op) {
+      ++n_built;
+      return CX_circ_from_multiq(op);
+    });
+    const Op_ptr crz = get_op_ptr(OpType::CRz, 0.3, 2);
+    const Circuit& first = table.get(crz);
+    REQUIRE(first == CX_circ_from_multiq(crz));
+    table.get(get_op_ptr(OpType::CRz, 0.3, 2));
+    REQUIRE(n_built == 1);
+    table.get(get_op_ptr(OpType::CRz, 0.4, 2));
+    table.get(get_op_ptr(OpType::CnX, std::vector<Expr>{}, 3));
+    table.get(get_op_ptr(OpType::CnX, std::vector<Expr>{}, 4));
+    REQUIRE(n_built == 4);
+    // Symbolic gates are built every time.
+    const Op_ptr symbolic = get_op_ptr(OpType::CRz, Expr("a"), 2);
+    table.get(symbolic);
+    table.get(symbolic);
+    REQUIRE(n_built == 6);
+  }
+  GIVEN("A circuit with repeated gates") {
+    Circuit circ(3);
+    for (unsigned i = 0; i < 3; ++i) {
+      circ.add_op<unsigned>(OpType::CRz, 0.3, {i, (i + 1) % 3});
+      circ.add_op<unsigned>(OpType::ZZPhase, 0.2, {(i + 1) % 3, i});
+      circ.add_op<unsigned>(OpType::CCX, {i, (i + 1) % 3, (i + 2) % 3});
+    }
+    Circuit rebased = circ;
+    REQUIRE(Transforms::rebase_tket().apply(rebased));
+    REQUIRE(rebased.count_gates(OpType::CRz) == 0);
+    REQUIRE(tket_sim::compare_statevectors_or_unitaries(
+        tket_sim::get_unitary(circ), tket_sim::get_unitary(rebased)));
+    Circuit via_tk2 = circ;
+    REQUIRE(Transforms::decompose_multi_qubits_TK2().apply(via_tk2));
+    REQUIRE(tket_sim::compare_statevectors_or_unitaries(
+        tket_sim::get_unitary(circ), tket_sim::get_unitary(via_tk2)));
+  }
+}
+
 }  // namespace test_Rebase
 }  // namespace tket
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <optional>
 
 #include "testutil.hpp"
 #include "tket/ArchAwareSynth/SteinerForest.hpp"
@@ -365,6 +366,78 @@ SCENARIO("Build a steiner Forest") {
     REQUIRE(oplist == oplist2);
   }
 }
+// Exhaustive search over copies of the forest, without memoisation
+static aas::CostedOperations naive_search(
+    const aas::PathHandler &path, aas::SteinerForest forest,
+    unsigned lookahead, aas::OperationList row_operations) {
+  forest.add_row_globally(
+      row_operations.back().first, row_operations.back().second);
+  if (lookahead == 0 || forest.current_trees.empty()) {
+    return {forest.global_cost, row_operations};
+  }
+  aas::OperationList operations = forest.operations_available_under_the_index(
+      path, forest.current_trees.rbegin()->first);
+  if (operations.empty()) return {forest.global_cost, row_operations};
+  std::optional<aas::CostedOperations> best;
+  for (const aas::Operation &op : operations) {
+    row_operations.push_back(op);
+    aas::CostedOperations candidate =
+        naive_search(path, forest, lookahead - 1, row_operations);
+    row_operations.pop_back();
+    if (!best || candidate.first < best->first ||
+        (candidate.first == best->first &&
+         candidate.second.size() < best->second.size())) {
+      best = candidate;
+    }
+  }
+  return *best;
+}
+
+SCENARIO("Lookahead search with memoisation and parallel candidates") {
+  GIVEN("A phase polynomial on a ring") {
+    const Architecture archi(
+        {{Node(0), Node(1)},
+         {Node(1), Node(2)},
+         {Node(2), Node(3)},
+         {Node(3), Node(4)},
+         {Node(4), Node(5)},
+         {Node(5), Node(0)}});
+    Circuit circ(6);
+    for (unsigned i = 0; i < 5; ++i) {
+      circ.add_op<unsigned>(OpType::CX, {i, i + 1});
+      circ.add_op<unsigned>(OpType::Rz, 0.1 * (i + 1), {i + 1});
+    }
+    circ.add_op<unsigned>(OpType::CX, {5, 0});
+    circ.add_op<unsigned>(OpType::Rz, 0.7, {0});
+    circ.add_op<unsigned>(OpType::CX, {2, 4});
+    circ.add_op<unsigned>(OpType::Rz, 0.9, {4});
+    PhasePolyBox ppbox(circ);
+    aas::PathHandler path(archi);
+    aas::PathHandler acyclic_path = path.construct_acyclic_handler();
+    aas::SteinerForest sf(acyclic_path, ppbox);
+    REQUIRE(!sf.current_trees.empty());
+    for (unsigned lookahead = 1; lookahead <= 3; ++lookahead) {
+      aas::CostedOperations best =
+          aas::best_operations_lookahead(acyclic_path, sf, lookahead);
+      aas::OperationList operations =
+          sf.operations_available_at_min_costs(acyclic_path);
+      std::optional<aas::CostedOperations> expected;
+      for (const aas::Operation &op : operations) {
+        aas::CostedOperations candidate =
+            naive_search(acyclic_path, sf, lookahead - 1, {op});
+        if (!expected || candidate.first < expected->first ||
+            (candidate.first == expected->first &&
+             candidate.second.size() < expected->second.size())) {
+          expected = candidate;
+        }
+      }
+      REQUIRE(best == *expected);
+    }
+    Circuit result = aas::phase_poly_synthesis(archi, ppbox, 3);
+    REQUIRE(test_unitary_comparison(circ, result));
+  }
+}
+
 SCENARIO("check error in steiner Forest") {
   GIVEN("lookahead 0 - phase_poly_synthesis_int") {
     const Architecture archi(
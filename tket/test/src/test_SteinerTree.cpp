@@ -13,8 +13,12 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <random>
 
+#include "testutil.hpp"
 #include "tket/ArchAwareSynth/SteinerTree.hpp"
+#include "tket/Circuit/PauliExpBoxes.hpp"
+#include "tket/Transformations/PauliOptimisation.hpp"
 
 namespace tket {
 
@@ -883,4 +887,111 @@ SCENARIO("Build some basic trees") {
     REQUIRE(cnot.valid_result());
   }
 }
+
+SCENARIO("Linear reversible synthesis on more than 64 qubits") {
+  std::mt19937 rng(4);
+  const unsigned n = 70;
+  MatrixXb mat = MatrixXb::Identity(n, n);
+  for (unsigned k = 0; k < 10 * n; ++k) {
+    unsigned i = rng() % n, j = rng() % n;
+    if (i != j) mat.row(j) = mat.row(j).array() != mat.row(i).array();
+  }
+  GIVEN("Gaussian elimination") {
+    DiagMatrix m(mat);
+    REQUIRE_FALSE(m.is_id());
+    CXMaker cxmaker(n);
+    m.gauss(cxmaker);
+    REQUIRE(m.is_id());
+    // Replaying the CXs as row additions reduces the original matrix
+    DiagMatrix replay(mat);
+    for (const Command& com : cxmaker._circ) {
+      qubit_vector_t qbs = com.get_qubits();
+      replay.row_add(qbs[0].index()[0], qbs[1].index()[0]);
+    }
+    REQUIRE(replay.is_id());
+  }
+  GIVEN("Swap-based CNOT synthesis on a line") {
+    std::vector<std::pair<Node, Node>> edges;
+    for (unsigned i = 0; i + 1 < n; ++i) {
+      edges.push_back({Node(i), Node(i + 1)});
+    }
+    aas::PathHandler handler{Architecture(edges)};
+    DiagMatrix CNOT_matrix(mat);
+    aas::CNotSwapSynth cnot(handler, CNOT_matrix);
+    REQUIRE(cnot.valid_result());
+  }
+}
+
+SCENARIO("Pauli gadgets synthesised along Steiner trees") {
+  // A 2x3 grid
+  Architecture arch(std::vector<std::pair<unsigned, unsigned>>{
+      {0, 1}, {1, 2}, {3, 4}, {4, 5}, {0, 3}, {1, 4}, {2, 5}});
+  const auto connected = [&](const Circuit& circ) {
+    for (const Command& com : circ) {
+      qubit_vector_t qbs = com.get_qubits();
+      if (qbs.size() < 2) continue;
+      if (qbs.size() > 2) return false;
+      if (!arch.edge_exists(Node(qbs[0]), Node(qbs[1])) &&
+          !arch.edge_exists(Node(qbs[1]), Node(qbs[0]))) {
+        return false;
+      }
+    }
+    return true;
+  };
+  GIVEN("Gadgets whose supports are not connected") {
+    Circuit circ;
+    for (unsigned i = 0; i < 6; ++i) circ.add_qubit(Node(i));
+    PauliExpBox peb0(SymPauliTensor({Pauli::X, Pauli::Z}, 0.3));
+    circ.add_box(peb0, qubit_vector_t{Node(0), Node(5)});
+    PauliExpBox peb1(SymPauliTensor({Pauli::Y}, 0.7));
+    circ.add_box(peb1, qubit_vector_t{Node(2)});
+    PauliExpBox peb2(
+        SymPauliTensor({Pauli::Z, Pauli::Y, Pauli::X, Pauli::I}, -0.4));
+    circ.add_box(peb2, qubit_vector_t{Node(0), Node(2), Node(4), Node(3)});
+    PauliExpPairBox pair(
+        SymPauliTensor({Pauli::Y, Pauli::X}, 0.15),
+        SymPauliTensor({Pauli::Z, Pauli::Z}, 0.25));
+    circ.add_box(pair, qubit_vector_t{Node(3), Node(2)});
+    PauliExpCommutingSetBox set(std::vector<SymPauliTensor>{
+        SymPauliTensor({Pauli::X, Pauli::X, Pauli::I}, 0.2),
+        SymPauliTensor({Pauli::Y, Pauli::Y, Pauli::Z}, 0.6)});
+    circ.add_box(set, qubit_vector_t{Node(5), Node(1), Node(3)});
+    circ.add_op<Qubit>(OpType::CX, {Node(0), Node(1)});
+
+    Circuit synth = circ;
+    REQUIRE(Transforms::steiner_pauli_gadgets(arch).apply(synth));
+    REQUIRE(synth.n_qubits() == 6);
+    REQUIRE(connected(synth));
+    REQUIRE(test_unitary_comparison(circ, synth));
+  }
+  GIVEN("Gadgets on a subset of the nodes") {
+    Circuit circ;
+    circ.add_qubit(Node(0));
+    circ.add_qubit(Node(2));
+    PauliExpBox peb(SymPauliTensor({Pauli::X, Pauli::Y}, 0.3));
+    circ.add_box(peb, qubit_vector_t{Node(0), Node(2)});
+    Circuit synth = circ;
+    REQUIRE(Transforms::steiner_pauli_gadgets(arch).apply(synth));
+    // The node between them is brought in and returned to its initial state
+    REQUIRE(synth.n_qubits() == 3);
+    REQUIRE(synth.count_gates(OpType::CX) == 6);
+    REQUIRE(connected(synth));
+    circ.add_qubit(Node(1));
+    REQUIRE(test_unitary_comparison(circ, synth));
+  }
+  GIVEN("A gadget on a qubit outside the architecture") {
+    Circuit circ(2);
+    PauliExpBox peb(SymPauliTensor({Pauli::X, Pauli::Y}, 0.3));
+    circ.add_box(peb, {0, 1});
+    REQUIRE_THROWS_AS(
+        Transforms::steiner_pauli_gadgets(arch).apply(circ),
+        CircuitInvalidity);
+  }
+  GIVEN("A circuit without Pauli boxes") {
+    Circuit circ;
+    circ.add_qubit(Node(0));
+    circ.add_op<Qubit>(OpType::H, {Node(0)});
+    REQUIRE_FALSE(Transforms::steiner_pauli_gadgets(arch).apply(circ));
+  }
+}
 }  // namespace tket
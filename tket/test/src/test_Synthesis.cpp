@@ -245,6 +245,41 @@ SCENARIO("Check commutation through multiqubit ops") {
   }
 }
 
+SCENARIO("Commuting and removing redundancies to a fixpoint") {
+  GIVEN("Gates that cancel through commuting multi-qubit gates") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {0});
+    circ.add_op<unsigned>(OpType::CZ, {0, 1});
+    circ.add_op<unsigned>(OpType::CX, {0, 2});
+    circ.add_op<unsigned>(OpType::X, {2});
+    circ.add_op<unsigned>(OpType::Rz, -0.3, {0});
+    circ.add_op<unsigned>(OpType::CX, {1, 2});
+    circ.add_op<unsigned>(OpType::X, {2});
+    Circuit repeated = circ;
+    REQUIRE(Transforms::commute_and_remove_redundancies().apply(circ));
+    Transforms::repeat(
+        Transforms::commute_through_multis() >>
+        Transforms::remove_redundancies())
+        .apply(repeated);
+    Circuit correct(3);
+    correct.add_op<unsigned>(OpType::CZ, {0, 1});
+    correct.add_op<unsigned>(OpType::CX, {0, 2});
+    correct.add_op<unsigned>(OpType::CX, {1, 2});
+    REQUIRE(circ == correct);
+    REQUIRE(repeated == correct);
+  }
+  GIVEN("Gates that do not commute") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::H, {0});
+    circ.add_op<unsigned>(OpType::Rz, 0.2, {1});
+    Circuit copy = circ;
+    REQUIRE_FALSE(Transforms::commute_and_remove_redundancies().apply(circ));
+    REQUIRE(circ == copy);
+  }
+}
+
 SCENARIO(
     "Generating Circuits and performing decomposition, basic optimisation "
     "and synthesis") {
@@ -909,6 +944,51 @@ SCENARIO("Testing general 1qb squash") {
   }
 }
 
+SCENARIO("Numeric and symbolic rotations agree") {
+  Sym a = SymEngine::symbol("alpha");
+  const std::vector<std::pair<OpType, double>> rots = {
+      {OpType::Rz, 0.3}, {OpType::Rx, 0.7}, {OpType::Ry, 1.1},
+      {OpType::Rz, 0.5}, {OpType::Rx, 1.}, {OpType::Ry, -0.25}};
+  Circuit original(1);
+  Rotation numeric;
+  // As numeric, but with the angle of the second rotation symbolic
+  Rotation symbolic;
+  for (unsigned i = 0; i < rots.size(); ++i) {
+    original.add_op<unsigned>(rots[i].first, rots[i].second, {0});
+    numeric.apply(Rotation(rots[i].first, rots[i].second));
+    symbolic.apply(
+        Rotation(rots[i].first, i == 1 ? Expr(a) : Expr(rots[i].second)));
+  }
+  symbol_map_t symbol_map;
+  symbol_map[a] = Expr(rots[1].second);
+  const std::vector<std::pair<OpType, OpType>> axes = {
+      {OpType::Rz, OpType::Rx},
+      {OpType::Rx, OpType::Ry},
+      {OpType::Ry, OpType::Rz}};
+  for (const std::pair<OpType, OpType>& pq : axes) {
+    auto [n1, n2, n3] = numeric.to_pqp(pq.first, pq.second);
+    auto [s1, s2, s3] = symbolic.to_pqp(pq.first, pq.second);
+    Circuit from_numeric(1);
+    from_numeric.add_op<unsigned>(pq.first, n1, {0});
+    from_numeric.add_op<unsigned>(pq.second, n2, {0});
+    from_numeric.add_op<unsigned>(pq.first, n3, {0});
+    Circuit from_symbolic(1);
+    from_symbolic.add_op<unsigned>(pq.first, s1, {0});
+    from_symbolic.add_op<unsigned>(pq.second, s2, {0});
+    from_symbolic.add_op<unsigned>(pq.first, s3, {0});
+    from_symbolic.symbol_substitution(symbol_map);
+    REQUIRE(test_unitary_comparison(from_numeric, original));
+    REQUIRE(test_unitary_comparison(from_symbolic, original));
+  }
+  GIVEN("Numeric rotations composing to the identity") {
+    Rotation r(OpType::Rx, 0.5);
+    r.apply(Rotation(OpType::Ry, 0.5));
+    r.apply(Rotation(OpType::Rx, -0.5));
+    r.apply(Rotation(OpType::Rz, 0.5));
+    REQUIRE(r.is_id());
+  }
+}
+
 SCENARIO("Decomposing TK1 into Rx, Ry") {
   Circuit circ(1);
   circ.add_op<unsigned>(OpType::TK1, {0.2, 0.2, 0.3}, {0});
@@ -26,6 +26,7 @@
 #include "tket/Transformations/BasicOptimisation.hpp"
 #include "tket/Transformations/Decomposition.hpp"
 #include "tket/Transformations/Transform.hpp"
+#include "tket/Transformations/TwoQubitBlockCache.hpp"
 #include "tket/Utils/EigenConfig.hpp"
 #include "tket/Utils/MatrixAnalysis.hpp"
 
@@ -705,6 +706,121 @@ SCENARIO("two_qubit_squash with classical ops") {
   }
 }
 
+SCENARIO("peephole_sweep") {
+  GIVEN("Blocks that merge once their neighbours are simplified") {
+    Circuit circ(3);
+    circ.add_op<unsigned>(OpType::CX, {0, 2});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+    circ.add_op<unsigned>(OpType::Rz, -0.3, {1});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::CX, {0, 2});
+    Circuit original = circ;
+    REQUIRE(Transforms::peephole_sweep().apply(circ));
+    REQUIRE(circ.count_gates(OpType::CX) == 0);
+    REQUIRE(test_unitary_comparison(circ, original));
+  }
+  GIVEN("A circuit with several interleaved blocks") {
+    Circuit circ(4);
+    for (unsigned i = 0; i < 3; ++i) {
+      circ.add_op<unsigned>(OpType::CX, {0, 1});
+      circ.add_op<unsigned>(OpType::Rx, 0.1 + i, {0});
+      circ.add_op<unsigned>(OpType::CZ, {1, 0});
+      circ.add_op<unsigned>(OpType::CX, {2, 3});
+      circ.add_op<unsigned>(OpType::Ry, 0.7, {3});
+      circ.add_op<unsigned>(OpType::CX, {3, 2});
+      circ.add_op<unsigned>(OpType::CX, {1, 2});
+    }
+    Circuit original = circ;
+    WHEN("Squashing to CX") {
+      REQUIRE(Transforms::peephole_sweep().apply(circ));
+      REQUIRE(circ.count_gates(OpType::CZ) == 0);
+      REQUIRE(test_unitary_comparison(circ, original));
+    }
+    WHEN("Squashing to TK2") {
+      REQUIRE(Transforms::peephole_sweep(OpType::TK2).apply(circ));
+      // Only the CX(1, 2) gates, each alone in its block, are left unchanged
+      REQUIRE(circ.count_gates(OpType::TK2) <= 6);
+      REQUIRE(circ.count_gates(OpType::CX) == 3);
+      REQUIRE(test_unitary_comparison(circ, original));
+    }
+  }
+  GIVEN("A symbolic gate between two-qubit gates") {
+    Circuit circ(2);
+    Sym a = SymEngine::symbol("alpha");
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::Rz, Expr(a), {1});
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    Transforms::peephole_sweep().apply(circ);
+    REQUIRE(circ.count_gates(OpType::CX) == 2);
+  }
+}
+
+SCENARIO("Caching two-qubit block resynthesis") {
+  GIVEN("Repeated identical blocks") {
+    Transforms::TwoQubitBlockCache &cache =
+        Transforms::TwoQubitBlockCache::shared();
+    cache.clear();
+    Circuit circ(4);
+    for (unsigned i = 0; i < 3; ++i) {
+      for (unsigned q = 0; q < 4; q += 2) {
+        circ.add_op<unsigned>(OpType::CX, {q, q + 1});
+        circ.add_op<unsigned>(OpType::Rz, 0.3, {q + 1});
+        circ.add_op<unsigned>(OpType::CX, {q, q + 1});
+        circ.add_op<unsigned>(OpType::Rx, 0.2, {q});
+        circ.add_op<unsigned>(OpType::CX, {q + 1, q});
+        circ.add_op<unsigned>(OpType::CX, {q, q + 1});
+      }
+      circ.add_op<unsigned>(OpType::H, {1});
+      circ.add_op<unsigned>(OpType::CZ, {1, 2});
+      circ.add_op<unsigned>(OpType::H, {1});
+    }
+    Circuit original = circ;
+    Circuit copy = circ;
+    REQUIRE(Transforms::two_qubit_squash().apply(circ));
+    REQUIRE(test_unitary_comparison(circ, original));
+    unsigned misses = cache.misses();
+    REQUIRE(misses > 0);
+    // Squashing the same circuit again finds every block in the cache
+    REQUIRE(Transforms::two_qubit_squash().apply(copy));
+    REQUIRE(cache.misses() == misses);
+    REQUIRE(cache.hits() > 0);
+    REQUIRE(circ == copy);
+  }
+  GIVEN("A small cache") {
+    Transforms::TwoQubitBlockCache cache(2);
+    Circuit block(2);
+    block.add_op<unsigned>(OpType::CX, {0, 1});
+    std::vector<Transforms::TwoQubitBlockCache::Key> keys;
+    for (double x : {0.1, 0.2, 0.3}) {
+      Circuit b = block;
+      b.add_op<unsigned>(OpType::Rz, x, {1});
+      keys.push_back(
+          *Transforms::TwoQubitBlockCache::make_key(b, OpType::CX, 1., true));
+    }
+    cache.insert(keys[0], std::nullopt);
+    cache.insert(keys[1], block);
+    REQUIRE(cache.find(keys[0]));
+    // The least recently used entry is evicted
+    cache.insert(keys[2], std::nullopt);
+    REQUIRE(cache.size() == 2);
+    REQUIRE_FALSE(cache.find(keys[1]));
+    std::optional<Transforms::TwoQubitBlockCache::result_t> found =
+        cache.find(keys[0]);
+    REQUIRE(found);
+    REQUIRE_FALSE(*found);
+    REQUIRE(cache.hits() == 2);
+    REQUIRE(cache.misses() == 1);
+  }
+  GIVEN("A symbolic block") {
+    Circuit block(2);
+    block.add_op<unsigned>(OpType::CX, {0, 1});
+    block.add_op<unsigned>(OpType::Rz, Expr(SymEngine::symbol("a")), {1});
+    REQUIRE_FALSE(
+        Transforms::TwoQubitBlockCache::make_key(block, OpType::CX, 1., true));
+  }
+}
+
 SCENARIO("Test qubit reversal") {
   GIVEN("A 4x4 matrix") {
     Eigen::Matrix4cd test, correct;
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <catch2/catch_test_macros.hpp>
+#include <random>
 #include <sstream>
 
 #include "testutil.hpp"
@@ -775,6 +776,191 @@ SCENARIO("Compare SymplecticTableau and UnitaryTableau") {
   }
 }
 
+SCENARIO("SymplecticTableau rows spanning several words") {
+  GIVEN("Random rows on more than 64 qubits") {
+    std::mt19937 rng(3);
+    const unsigned n_qubits = 150;
+    const std::vector<Pauli> paulis{Pauli::I, Pauli::X, Pauli::Y, Pauli::Z};
+    PauliStabiliserVec rows;
+    for (unsigned r = 0; r < 6; ++r) {
+      DensePauliMap str(n_qubits);
+      for (Pauli& p : str) p = paulis[rng() % 4];
+      rows.push_back(PauliStabiliser(str, 2 * (rng() % 2)));
+    }
+    SymplecticTableau tab(rows);
+    THEN("Row multiplication agrees with multiplying the Pauli strings") {
+      for (unsigned a = 0; a < rows.size(); ++a) {
+        for (unsigned w = 0; w < rows.size(); ++w) {
+          if (a == w) continue;
+          SymplecticTableau copy(tab);
+          copy.row_mult(a, w);
+          PauliStabiliser expected = rows[a] * rows[w];
+          PauliStabiliser result = copy.get_pauli(w);
+          CHECK(result.string == expected.string);
+          // Only real phases are recorded in the tableau
+          if (expected.coeff % 2 == 0) CHECK(result.coeff == expected.coeff);
+        }
+      }
+    }
+    THEN("Commutation and conjugation agree with the Pauli strings") {
+      MatrixXb anti = tab.anticommuting_rows();
+      SymplecticTableau conj = tab.conjugate();
+      for (unsigned a = 0; a < rows.size(); ++a) {
+        for (unsigned b = 0; b < rows.size(); ++b) {
+          CHECK(anti(a, b) == !rows[a].commutes_with(rows[b]));
+        }
+        unsigned n_ys = 0;
+        for (Pauli p : rows[a].string) n_ys += (p == Pauli::Y);
+        CHECK(conj.phase(a) == (tab.phase(a) ^ (n_ys % 2 == 1)));
+      }
+    }
+  }
+}
+
+SCENARIO("Fast conversion of large Clifford circuits to UnitaryTableau") {
+  GIVEN("A random Clifford circuit on more than 64 qubits") {
+    std::mt19937 rng(5);
+    const unsigned n_qubits = 100;
+    Circuit circ;
+    for (unsigned q = 0; q < n_qubits; ++q) {
+      circ.add_qubit(Qubit("node", n_qubits - q));
+    }
+    const qubit_vector_t qubits = circ.all_qubits();
+    const std::vector<OpType> one_qubit_gates{
+        OpType::H, OpType::S, OpType::V, OpType::X, OpType::Z, OpType::Sdg};
+    const std::vector<OpType> two_qubit_gates{
+        OpType::CX, OpType::CZ, OpType::CY, OpType::ECR, OpType::SWAP,
+        OpType::ZZMax};
+    UnitaryTableau expected(qubits);
+    UnitaryRevTableau expected_rev(qubits);
+    for (unsigned i = 0; i < 2000; ++i) {
+      unsigned q0 = rng() % n_qubits;
+      qubit_vector_t args{qubits[q0]};
+      OpType type;
+      if (rng() % 2 == 0) {
+        type = one_qubit_gates[rng() % one_qubit_gates.size()];
+      } else {
+        type = two_qubit_gates[rng() % two_qubit_gates.size()];
+        args.push_back(qubits[(q0 + 1 + rng() % (n_qubits - 1)) % n_qubits]);
+      }
+      circ.add_op<Qubit>(type, args);
+      expected.apply_gate_at_end(type, args);
+      expected_rev.apply_gate_at_end(type, args);
+    }
+    THEN("The tableaux match applying each gate in turn") {
+      REQUIRE(circuit_to_unitary_tableau(circ) == expected);
+      REQUIRE(circuit_to_unitary_rev_tableau(circ) == expected_rev);
+    }
+    THEN("The tableau can be synthesised back into a circuit") {
+      Circuit synth = unitary_tableau_to_circuit(expected);
+      REQUIRE(circuit_to_unitary_tableau(synth) == expected);
+    }
+  }
+  GIVEN("A circuit with a non-Clifford gate") {
+    Circuit circ(2);
+    circ.add_op<unsigned>(OpType::CX, {0, 1});
+    circ.add_op<unsigned>(OpType::T, {1});
+    REQUIRE_THROWS_AS(circuit_to_unitary_tableau(circ), BadOpType);
+  }
+}
+
+SCENARIO("Index-aligned composition and inversion of UnitaryTableau") {
+  std::mt19937 rng(11);
+  const auto random_tableau = [&](unsigned n_qubits) {
+    const std::vector<OpType> one_qubit_gates{
+        OpType::H, OpType::S, OpType::V, OpType::X, OpType::Z};
+    const std::vector<OpType> two_qubit_gates{
+        OpType::CX, OpType::CZ, OpType::CY, OpType::SWAP};
+    UnitaryTableau tab(n_qubits);
+    for (unsigned i = 0; i < 20 * n_qubits; ++i) {
+      unsigned q0 = rng() % n_qubits;
+      if (i % 2 == 0) {
+        tab.apply_gate_at_end(
+            one_qubit_gates[rng() % one_qubit_gates.size()], {Qubit(q0)});
+      } else {
+        unsigned q1 = (q0 + 1 + rng() % (n_qubits - 1)) % n_qubits;
+        tab.apply_gate_at_end(
+            two_qubit_gates[rng() % two_qubit_gates.size()],
+            {Qubit(q0), Qubit(q1)});
+      }
+    }
+    return tab;
+  };
+  for (unsigned n_qubits : {5, 64, 70}) {
+    GIVEN("Random tableaux over " + std::to_string(n_qubits) + " qubits") {
+      const UnitaryTableau first = random_tableau(n_qubits);
+      const UnitaryTableau second = random_tableau(n_qubits);
+      THEN("They agree with compose and dagger") {
+        UnitaryTableau result(n_qubits);
+        UnitaryTableau::compose_aligned(first, second, result);
+        REQUIRE(result == UnitaryTableau::compose(first, second));
+        // The destination can be reused
+        UnitaryTableau::compose_aligned(second, first, result);
+        REQUIRE(result == UnitaryTableau::compose(second, first));
+        first.dagger_aligned(result);
+        REQUIRE(result == first.dagger());
+        UnitaryTableau::compose_aligned(first, result, result);
+        REQUIRE(result == UnitaryTableau(n_qubits));
+      }
+      THEN("A destination of the wrong size is replaced") {
+        UnitaryTableau result(1);
+        second.dagger_aligned(result);
+        REQUIRE(result == second.dagger());
+      }
+    }
+  }
+  GIVEN("Tableaux of different sizes") {
+    UnitaryTableau result(2);
+    REQUIRE_THROWS_AS(
+        UnitaryTableau::compose_aligned(
+            UnitaryTableau(2), UnitaryTableau(3), result),
+        std::invalid_argument);
+  }
+}
+
+SCENARIO("Canonical forms and hashes of tableaux") {
+  GIVEN("Two generating sets of the same stabilizer group") {
+    // XX, ZZ and ZZ, -YY, XX generate the same group
+    SymplecticTableau tab(PauliStabiliserVec{
+        PauliStabiliser({Pauli::X, Pauli::X}, 0),
+        PauliStabiliser({Pauli::Z, Pauli::Z}, 0)});
+    SymplecticTableau other(PauliStabiliserVec{
+        PauliStabiliser({Pauli::Z, Pauli::Z}, 0),
+        PauliStabiliser({Pauli::Y, Pauli::Y}, 2),
+        PauliStabiliser({Pauli::X, Pauli::X}, 0)});
+    REQUIRE_FALSE(tab == other);
+    REQUIRE(tab.canonical_form() == other.canonical_form());
+    REQUIRE(other.canonical_form().get_n_rows() == 2);
+    REQUIRE(
+        tab.canonical_form().hash_value() ==
+        other.canonical_form().hash_value());
+    WHEN("A sign differs") {
+      other.phase(0) = true;
+      REQUIRE_FALSE(tab.canonical_form() == other.canonical_form());
+      REQUIRE(
+          tab.canonical_form().hash_value() !=
+          other.canonical_form().hash_value());
+    }
+  }
+  GIVEN("Unitary tableaux over differently ordered qubits") {
+    UnitaryTableau tab(qubit_vector_t{Qubit(0), Qubit(1), Qubit(2)});
+    UnitaryTableau other(qubit_vector_t{Qubit(2), Qubit(0), Qubit(1)});
+    for (UnitaryTableau* t : {&tab, &other}) {
+      t->apply_gate_at_end(OpType::H, {Qubit(0)});
+      t->apply_gate_at_end(OpType::CX, {Qubit(0), Qubit(2)});
+      t->apply_gate_at_end(OpType::S, {Qubit(1)});
+    }
+    REQUIRE(tab == other);
+    REQUIRE(tab.hash_value() == other.hash_value());
+    other.apply_gate_at_end(OpType::Z, {Qubit(1)});
+    REQUIRE(tab.hash_value() != other.hash_value());
+    REQUIRE(
+        UnitaryTableau(2).hash_value() !=
+        UnitaryTableau(qubit_vector_t{Qubit("a", 0), Qubit("a", 1)})
+            .hash_value());
+  }
+}
+
 SCENARIO("Tableau serialisation") {
   GIVEN("A circuit containing a tableau") {
     MatrixXb xx(3, 3);
@@ -15,6 +15,7 @@
 #include <boost/range/join.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <iostream>
+#include <sstream>
 
 #include "CircuitsForTesting.hpp"
 #include "testutil.hpp"
@@ -605,6 +606,14 @@ SCENARIO("Test Circuit serialization") {
         static_cast<const DiagonalBox&>(*new_c.get_commands()[0].get_op_ptr());
     REQUIRE((diag - box.get_diagonal()).cwiseAbs().sum() < ERR_EPS);
     REQUIRE(!box.is_upper_triangle());
+    REQUIRE(box.get_strat() == DiagonalBoxSynthStrat::Multiplexor);
+    DiagonalBox phase_poly_box(
+        diag, true, DiagonalBoxSynthStrat::PhasePolynomial);
+    nlohmann::json j_pp = std::make_shared<DiagonalBox>(phase_poly_box);
+    const Op_ptr new_pp = j_pp.get<Op_ptr>();
+    REQUIRE(
+        static_cast<const DiagonalBox&>(*new_pp).get_strat() ==
+        DiagonalBoxSynthStrat::PhasePolynomial);
   }
 
   GIVEN("PhasePolyBox") {
@@ -668,6 +677,95 @@ SCENARIO("Test Circuit serialization") {
   }
 }
 
+SCENARIO("Streaming circuit JSON") {
+  GIVEN("A circuit") {
+    Circuit c(3, 2, "stream");
+    const Qubit a("a", 1, 2);
+    c.add_qubit(a);
+    c.add_op<unsigned>(OpType::Rz, 0.2, {0});
+    c.add_op<unsigned>(OpType::CX, {0, 1}, "foo");
+    c.add_op<UnitID>(OpType::CnRy, 0.1, {Qubit(0), a, Qubit(2)});
+    c.add_op<unsigned>(OpType::Measure, {1, 0});
+    c.add_conditional_gate<unsigned>(OpType::X, {}, {2}, {0}, 1);
+    c.add_barrier({Qubit(0), a});
+    c.add_phase(0.3);
+    c.qubit_create(Qubit(1));
+    c.qubit_discard(a);
+    c.add_op<unsigned>(OpType::SWAP, {1, 2});
+    c.replace_SWAPs();
+    nlohmann::json j = c;
+    std::stringstream ss(j.dump());
+    Circuit streamed = Circuit::from_json_stream(ss);
+    REQUIRE(streamed == c);
+    REQUIRE(streamed == j.get<Circuit>());
+    REQUIRE(nlohmann::json(streamed) == j);
+  }
+  GIVEN("Members in a different order") {
+    std::stringstream ss(
+        R"({"qubits": [["q", [0]], ["q", [1]], ["r", [0]]], "bits": [],)"
+        R"( "commands": [{"op": {"type": "CX"},)"
+        R"( "args": [["q", [0]], ["q", [1]]]}],)"
+        R"( "implicit_permutation": [], "phase": "0.5"})");
+    Circuit streamed = Circuit::from_json_stream(ss);
+    Circuit c(2);
+    c.add_qubit(Qubit("r", 0));
+    c.add_op<unsigned>(OpType::CX, {0, 1});
+    c.add_phase(0.5);
+    REQUIRE(streamed == c);
+  }
+  GIVEN("Invalid documents") {
+    std::stringstream not_object("[]");
+    REQUIRE_THROWS_AS(Circuit::from_json_stream(not_object), JsonError);
+    std::stringstream truncated(R"({"phase": "0", "commands": [)");
+    REQUIRE_THROWS_AS(Circuit::from_json_stream(truncated), JsonError);
+    std::stringstream no_commands(
+        R"({"phase": "0", "qubits": [], "bits": [],)"
+        R"( "implicit_permutation": []})");
+    REQUIRE_THROWS_AS(Circuit::from_json_stream(no_commands), JsonError);
+  }
+}
+
+SCENARIO("Circuit JSON with a box table") {
+  Circuit inner(2);
+  inner.add_op<unsigned>(OpType::CX, {0, 1});
+  inner.add_op<unsigned>(OpType::Rz, 0.25, {1});
+  CircBox inner_box(inner);
+  Circuit outer(3);
+  outer.add_box(inner_box, {0, 1});
+  outer.add_box(inner_box, {1, 2});
+  CircBox outer_box(outer);
+  Circuit c(4, 1);
+  c.add_box(outer_box, {0, 1, 2});
+  c.add_box(outer_box, {1, 2, 3});
+  c.add_box(inner_box, {3, 0});
+  Op_ptr cond_box =
+      std::make_shared<Conditional>(std::make_shared<CircBox>(inner_box), 1, 1);
+  c.add_op<UnitID>(cond_box, {Bit(0), Qubit(0), Qubit(1)});
+  nlohmann::json j = circuit_to_json_with_box_table(c);
+  REQUIRE(j.at("boxes").size() == 2);
+  for (const nlohmann::json& j_com : j.at("commands")) {
+    REQUIRE(j_com.dump().find("\"circuit\"") == std::string::npos);
+  }
+  Circuit c2 = j.get<Circuit>();
+  REQUIRE(c2 == c);
+  std::vector<Command> coms = c2.get_commands();
+  REQUIRE(coms.size() == 4);
+  REQUIRE(coms[0].get_op_ptr() == coms[1].get_op_ptr());
+  const auto& cond = static_cast<const Conditional&>(*coms[3].get_op_ptr());
+  REQUIRE(cond.get_op() == coms[2].get_op_ptr());
+  std::stringstream ss(j.dump());
+  REQUIRE(Circuit::from_json_stream(ss) == c);
+  GIVEN("A circuit without boxes") {
+    Circuit plain(2);
+    plain.add_op<unsigned>(OpType::CX, {0, 1});
+    REQUIRE(circuit_to_json_with_box_table(plain) == nlohmann::json(plain));
+  }
+  GIVEN("A reference to a missing box") {
+    j.erase("boxes");
+    REQUIRE_THROWS_AS(j.get<Circuit>(), JsonError);
+  }
+}
+
 SCENARIO("Test device serializations") {
   GIVEN("Architecture") {
     Architecture arc({{0, 1}, {1, 2}});
@@ -909,6 +1007,7 @@ SCENARIO("Test compiler pass serializations") {
   COMPPASSJSONTEST(SimplifyMeasured, SimplifyMeasured())
   COMPPASSJSONTEST(ZZPhaseToRz, ZZPhaseToRz())
   COMPPASSJSONTEST(RemoveBarriers, RemoveBarriers())
+  COMPPASSJSONTEST(CliffordBlockResynthesis, CliffordBlockResynthesis())
   COMPPASSJSONTEST(ComposePhasePolyBoxes, ComposePhasePolyBoxes())
   COMPPASSJSONTEST(DecomposeBridges, DecomposeBridges())
   COMPPASSJSONTEST(
@@ -981,6 +1080,22 @@ SCENARIO("Test compiler pass serializations") {
     nlohmann::json j_loaded = loaded;
     REQUIRE(j_pp == j_loaded);
   }
+  GIVEN("RoutingPass with placement refinement") {
+    Circuit circ = CircuitsForTesting::get().uccsd;
+    CompilationUnit cu{circ};
+    PassPtr placement = gen_placement_pass(place);
+    placement->apply(cu);
+    CompilationUnit copy = cu;
+    PassPtr pp = gen_routing_pass(arc, rcon, 2);
+    nlohmann::json j_pp = pp;
+    REQUIRE(j_pp["StandardPass"]["refinement_sweeps"] == 2);
+    PassPtr loaded = j_pp.get<PassPtr>();
+    pp->apply(cu);
+    loaded->apply(copy);
+    REQUIRE(cu.get_circ_ref() == copy.get_circ_ref());
+    nlohmann::json j_loaded = loaded;
+    REQUIRE(j_pp == j_loaded);
+  }
   GIVEN("Routing with multiple routing methods") {
     RoutingMethodPtr mrmp =
         std::make_shared<MultiGateReorderRoutingMethod>(60, 80);
@@ -1165,6 +1280,38 @@ SCENARIO("Test compiler pass combinator serializations") {
   }
 }
 
+SCENARIO("Serialising compilation units") {
+  Circuit circ(2, 1);
+  circ.add_op<unsigned>(OpType::H, {0});
+  circ.add_op<unsigned>(OpType::CX, {0, 1});
+  circ.add_op<unsigned>(OpType::Rz, 0.3, {1});
+  circ.add_measure(1, 0);
+  PredicatePtr gateset = std::make_shared<GateSetPredicate>(
+      OpTypeSet{OpType::CX, OpType::TK1, OpType::Measure});
+  CompilationUnit cu(circ, std::vector<PredicatePtr>{gateset});
+  gen_rename_qubits_pass({{Qubit(0), Qubit("a", 0)}})->apply(cu);
+  RebaseTket()->apply(cu);
+  std::vector<std::uint8_t> bytes = cu.to_bytes();
+  CHECK(bytes.size() < cu.serialize().dump().size());
+  CompilationUnit loaded = CompilationUnit::from_bytes(bytes);
+  REQUIRE(loaded.get_circ_ref() == cu.get_circ_ref());
+  REQUIRE(loaded.get_initial_map_ref() == cu.get_initial_map_ref());
+  REQUIRE(loaded.get_final_map_ref() == cu.get_final_map_ref());
+  for (const auto& entry : cu.get_cache_ref()) {
+    if (entry.second.second) {
+      REQUIRE(loaded.get_cache_ref().at(entry.first).second);
+    }
+  }
+  REQUIRE(loaded.serialize() == cu.serialize());
+  // Resume the compilation from the loaded unit
+  PassPtr rest = pass_from_bytes(pass_to_bytes(SynthesiseTK()));
+  REQUIRE(nlohmann::json(rest) == nlohmann::json(SynthesiseTK()));
+  SynthesiseTK()->apply(cu);
+  rest->apply(loaded);
+  REQUIRE(loaded.get_circ_ref() == cu.get_circ_ref());
+  REQUIRE(loaded.check_all_predicates());
+}
+
 SCENARIO("Test PauliTensor serialization") {
   SpPauliString qps(
       {{Qubit(2), Pauli::X}, {Qubit(7), Pauli::Y}, {Qubit(0), Pauli::I}});
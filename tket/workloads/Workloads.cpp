@@ -0,0 +1,267 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Workloads.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tkrng/RNG.hpp>
+
+#include "tket/Circuit/PauliExpBoxes.hpp"
+#include "tket/Utils/PauliTensor.hpp"
+
+namespace tket {
+namespace workloads {
+
+// A random nonzero angle, as a multiple of 1/64 half-turns.
+static double random_angle(RNG &rng) { return rng.get_size_t(1, 127) / 64.; }
+
+// A random qubit other than q.
+static unsigned random_other_qubit(RNG &rng, unsigned n_qubits, unsigned q) {
+  return (q + 1 + rng.get_size_t(n_qubits - 2)) % n_qubits;
+}
+
+Circuit random_layered_circuit(
+    unsigned n_qubits, unsigned n_layers, std::size_t seed) {
+  RNG rng;
+  rng.set_seed(seed);
+  Circuit circ(n_qubits);
+  std::vector<unsigned> qubits(n_qubits);
+  std::iota(qubits.begin(), qubits.end(), 0);
+  for (unsigned layer = 0; layer < n_layers; layer++) {
+    rng.do_shuffle(qubits);
+    for (unsigned i = 0; i + 1 < n_qubits; i += 2) {
+      circ.add_op<unsigned>(OpType::CX, {qubits[i], qubits[i + 1]});
+    }
+    for (unsigned q = 0; q < n_qubits; q++) {
+      circ.add_op<unsigned>(OpType::Rz, random_angle(rng), {q});
+      circ.add_op<unsigned>(OpType::Rx, random_angle(rng), {q});
+    }
+  }
+  return circ;
+}
+
+Circuit random_clifford_circuit(
+    unsigned n_qubits, unsigned n_gates, std::size_t seed) {
+  return random_clifford_t_circuit(n_qubits, n_gates, 0, seed);
+}
+
+Circuit random_clifford_t_circuit(
+    unsigned n_qubits, unsigned n_gates, unsigned t_percentage,
+    std::size_t seed) {
+  RNG rng;
+  rng.set_seed(seed);
+  Circuit circ(n_qubits);
+  for (unsigned i = 0; i < n_gates; i++) {
+    const unsigned q = rng.get_size_t(n_qubits - 1);
+    if (t_percentage > 0 && rng.check_percentage(t_percentage)) {
+      circ.add_op<unsigned>(OpType::T, {q});
+      continue;
+    }
+    switch (rng.get_size_t(2)) {
+      case 0:
+        circ.add_op<unsigned>(OpType::H, {q});
+        break;
+      case 1:
+        circ.add_op<unsigned>(OpType::S, {q});
+        break;
+      default:
+        circ.add_op<unsigned>(
+            OpType::CX, {q, random_other_qubit(rng, n_qubits, q)});
+    }
+  }
+  return circ;
+}
+
+std::vector<std::pair<unsigned, unsigned>> random_graph(
+    unsigned n_nodes, unsigned n_edges, std::size_t seed) {
+  const std::size_t max_edges = std::size_t{n_nodes} * (n_nodes - 1) / 2;
+  if (n_nodes < 2 || n_edges > max_edges) {
+    throw std::invalid_argument(
+        "A graph with " + std::to_string(n_nodes) + " nodes cannot have " +
+        std::to_string(n_edges) + " edges");
+  }
+  RNG rng;
+  rng.set_seed(seed);
+  std::vector<std::pair<unsigned, unsigned>> edges;
+  edges.reserve(n_edges);
+  if (2 * std::size_t{n_edges} > max_edges) {
+    // Dense: shuffle the complete graph and take a prefix.
+    for (unsigned u = 0; u < n_nodes; u++) {
+      for (unsigned v = u + 1; v < n_nodes; v++) edges.push_back({u, v});
+    }
+    rng.do_shuffle(edges);
+    edges.resize(n_edges);
+    return edges;
+  }
+  // Sparse: rejection sampling needs fewer than two draws per edge.
+  std::set<std::pair<unsigned, unsigned>> seen;
+  while (edges.size() < n_edges) {
+    const unsigned u = rng.get_size_t(n_nodes - 1);
+    const unsigned v = random_other_qubit(rng, n_nodes, u);
+    const std::pair<unsigned, unsigned> edge = std::minmax(u, v);
+    if (seen.insert(edge).second) edges.push_back(edge);
+  }
+  return edges;
+}
+
+Circuit qaoa_circuit(
+    unsigned n_nodes, unsigned n_edges, unsigned n_rounds, std::size_t seed) {
+  const std::vector<std::pair<unsigned, unsigned>> edges =
+      random_graph(n_nodes, n_edges, seed);
+  RNG rng;
+  rng.set_seed(seed + 1);
+  Circuit circ(n_nodes);
+  for (unsigned q = 0; q < n_nodes; q++) {
+    circ.add_op<unsigned>(OpType::H, {q});
+  }
+  for (unsigned round = 0; round < n_rounds; round++) {
+    const double gamma = random_angle(rng);
+    const double beta = random_angle(rng);
+    for (const auto &[u, v] : edges) {
+      circ.add_op<unsigned>(OpType::ZZPhase, gamma, {u, v});
+    }
+    for (unsigned q = 0; q < n_nodes; q++) {
+      circ.add_op<unsigned>(OpType::Rx, beta, {q});
+    }
+  }
+  return circ;
+}
+
+namespace {
+
+struct PauliTerm {
+  std::vector<unsigned> qubits;
+  DensePauliMap paulis;
+  double coeff;
+};
+
+}  // namespace
+
+// Exponentiate a term as a gadget. Conjugating Z by H gives X, and by Sdg
+// followed by H gives Y.
+static void add_pauli_gadget(Circuit &circ, const PauliTerm &term) {
+  const std::vector<unsigned> &qbs = term.qubits;
+  const unsigned n = qbs.size();
+  for (unsigned i = 0; i < n; i++) {
+    const Pauli p = term.paulis[i];
+    if (p == Pauli::Y) circ.add_op<unsigned>(OpType::Sdg, {qbs[i]});
+    if (p != Pauli::Z) circ.add_op<unsigned>(OpType::H, {qbs[i]});
+  }
+  for (unsigned i = 0; i + 1 < n; i++) {
+    circ.add_op<unsigned>(OpType::CX, {qbs[i], qbs[i + 1]});
+  }
+  circ.add_op<unsigned>(OpType::Rz, term.coeff, {qbs[n - 1]});
+  for (unsigned i = n - 1; i > 0; i--) {
+    circ.add_op<unsigned>(OpType::CX, {qbs[i - 1], qbs[i]});
+  }
+  for (unsigned i = 0; i < n; i++) {
+    const Pauli p = term.paulis[i];
+    if (p != Pauli::Z) circ.add_op<unsigned>(OpType::H, {qbs[i]});
+    if (p == Pauli::Y) circ.add_op<unsigned>(OpType::S, {qbs[i]});
+  }
+}
+
+Circuit trotter_circuit(
+    unsigned n_qubits, unsigned n_terms, unsigned term_weight,
+    unsigned n_steps, std::size_t seed, bool boxed) {
+  if (term_weight == 0 || term_weight > n_qubits) {
+    throw std::invalid_argument(
+        "Term weight must be between 1 and the number of qubits");
+  }
+  RNG rng;
+  rng.set_seed(seed);
+  std::vector<PauliTerm> terms(n_terms);
+  for (PauliTerm &term : terms) {
+    // Sample the support without shuffling all the qubits, so that the cost
+    // is independent of n_qubits.
+    std::set<unsigned> support;
+    while (support.size() < term_weight) {
+      support.insert(rng.get_size_t(n_qubits - 1));
+    }
+    term.qubits.assign(support.begin(), support.end());
+    for (unsigned i = 0; i < term_weight; i++) {
+      term.paulis.push_back(Pauli(1 + rng.get_size_t(2)));
+    }
+    term.coeff = random_angle(rng);
+  }
+  std::vector<Op_ptr> boxes;
+  if (boxed) {
+    for (const PauliTerm &term : terms) {
+      boxes.push_back(std::make_shared<PauliExpBox>(
+          SymPauliTensor(term.paulis, term.coeff)));
+    }
+  }
+  Circuit circ(n_qubits);
+  for (unsigned step = 0; step < n_steps; step++) {
+    for (unsigned i = 0; i < n_terms; i++) {
+      if (boxed) {
+        circ.add_op<unsigned>(boxes[i], terms[i].qubits);
+      } else {
+        add_pauli_gadget(circ, terms[i]);
+      }
+    }
+  }
+  return circ;
+}
+
+Circuit qft_circuit(unsigned n_qubits, unsigned max_distance, bool swaps) {
+  Circuit circ(n_qubits);
+  for (unsigned i = 0; i < n_qubits; i++) {
+    circ.add_op<unsigned>(OpType::H, {i});
+    double angle = 0.5;
+    for (unsigned j = i + 1; j < n_qubits; j++, angle /= 2) {
+      if (max_distance != 0 && j - i > max_distance) break;
+      circ.add_op<unsigned>(OpType::CU1, angle, {j, i});
+    }
+  }
+  if (swaps) {
+    for (unsigned i = 0; i < n_qubits / 2; i++) {
+      circ.add_op<unsigned>(OpType::SWAP, {i, n_qubits - 1 - i});
+    }
+  }
+  return circ;
+}
+
+Circuit adder_circuit(unsigned n_bits) {
+  Circuit circ(2 * n_bits + 2);
+  const unsigned carry_out = 2 * n_bits + 1;
+  auto a = [](unsigned i) { return 1 + i; };
+  auto b = [n_bits](unsigned i) { return 1 + n_bits + i; };
+  // The running carry is held in the previous a qubit (or the carry in).
+  auto c = [](unsigned i) { return i; };
+  // Majority gate, leaving the carry out of bit i in a(i).
+  for (unsigned i = 0; i < n_bits; i++) {
+    circ.add_op<unsigned>(OpType::CX, {a(i), b(i)});
+    circ.add_op<unsigned>(OpType::CX, {a(i), c(i)});
+    circ.add_op<unsigned>(OpType::CCX, {c(i), b(i), a(i)});
+  }
+  if (n_bits > 0) {
+    circ.add_op<unsigned>(OpType::CX, {a(n_bits - 1), carry_out});
+  }
+  // UnMajority and Add gate, restoring a(i) and c(i) and writing the sum
+  // bit into b(i).
+  for (unsigned i = n_bits; i > 0; i--) {
+    circ.add_op<unsigned>(OpType::CCX, {c(i - 1), b(i - 1), a(i - 1)});
+    circ.add_op<unsigned>(OpType::CX, {a(i - 1), c(i - 1)});
+    circ.add_op<unsigned>(OpType::CX, {c(i - 1), b(i - 1)});
+  }
+  return circ;
+}
+
+}  // namespace workloads
+}  // namespace tket
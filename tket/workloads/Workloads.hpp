@@ -0,0 +1,151 @@
+// Copyright 2019-2023 Cambridge Quantum Computing
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+/**
+ * @file
+ * @brief Parameterised synthetic workloads, shared by the benchmarks and the
+ * property-based tests.
+ *
+ * Every generator is deterministic given its arguments: randomness comes
+ * from a tkrng RNG seeded with the given seed, so the same workload is
+ * produced on every platform. Random angles are multiples of 1/64 half-turns.
+ * All generators run in time linear in the size of the output, so they can
+ * be used to build circuits with thousands of qubits and millions of gates.
+ */
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "tket/Circuit/Circuit.hpp"
+
+namespace tket {
+namespace workloads {
+
+/**
+ * Random circuit of layers of CX gates on random disjoint pairs of qubits,
+ * each followed by an Rz and an Rx on every qubit with random angles.
+ *
+ * @param n_qubits number of qubits
+ * @param n_layers number of layers
+ * @param seed seed for the random number generator
+ */
+Circuit random_layered_circuit(
+    unsigned n_qubits, unsigned n_layers, std::size_t seed);
+
+/**
+ * Random Clifford circuit of H, S and CX gates.
+ *
+ * @param n_qubits number of qubits (at least 2)
+ * @param n_gates number of gates
+ * @param seed seed for the random number generator
+ */
+Circuit random_clifford_circuit(
+    unsigned n_qubits, unsigned n_gates, std::size_t seed);
+
+/**
+ * Random Clifford+T circuit of H, S, CX and T gates.
+ *
+ * Each gate is a T with probability \p t_percentage percent; the remaining
+ * gates are drawn uniformly from H, S and CX.
+ *
+ * @param n_qubits number of qubits (at least 2)
+ * @param n_gates number of gates
+ * @param t_percentage percentage of T gates
+ * @param seed seed for the random number generator
+ */
+Circuit random_clifford_t_circuit(
+    unsigned n_qubits, unsigned n_gates, unsigned t_percentage,
+    std::size_t seed);
+
+/**
+ * Random simple graph with a given number of edges.
+ *
+ * @param n_nodes number of nodes (at least 2)
+ * @param n_edges number of edges (at most n_nodes * (n_nodes - 1) / 2)
+ * @param seed seed for the random number generator
+ * @return the edges, each with the smaller node first, in random order
+ * @throws std::invalid_argument if there cannot be that many edges
+ */
+std::vector<std::pair<unsigned, unsigned>> random_graph(
+    unsigned n_nodes, unsigned n_edges, std::size_t seed);
+
+/**
+ * QAOA MaxCut ansatz on a random graph.
+ *
+ * Prepares the uniform superposition with H gates, then applies \p n_rounds
+ * rounds of a ZZPhase on every edge of the graph followed by an Rx mixer on
+ * every qubit. Each round has its own random pair of angles.
+ *
+ * @param n_nodes number of nodes (qubits)
+ * @param n_edges number of edges (ZZPhase gates per round)
+ * @param n_rounds number of QAOA rounds
+ * @param seed seed for the random number generator
+ */
+Circuit qaoa_circuit(
+    unsigned n_nodes, unsigned n_edges, unsigned n_rounds, std::size_t seed);
+
+/**
+ * First-order Trotterisation of a random Hamiltonian.
+ *
+ * The Hamiltonian is a sum of \p n_terms random Pauli strings, each acting
+ * non-trivially on \p term_weight distinct random qubits with a random
+ * coefficient. Each of the \p n_steps Trotter steps exponentiates every term
+ * in the same order, either as a PauliExpBox on the support of the term or
+ * as an explicit gadget: a basis change, a CX ladder onto the last qubit of
+ * the support, an Rz, and the inverse ladder and basis change.
+ *
+ * @param n_qubits number of qubits
+ * @param n_terms number of terms in the Hamiltonian
+ * @param term_weight number of non-identity Paulis per term
+ * @param n_steps number of Trotter steps
+ * @param seed seed for the random number generator
+ * @param boxed whether to emit PauliExpBoxes rather than gadgets
+ * @throws std::invalid_argument if \p term_weight is zero or exceeds
+ *   \p n_qubits
+ */
+Circuit trotter_circuit(
+    unsigned n_qubits, unsigned n_terms, unsigned term_weight,
+    unsigned n_steps, std::size_t seed, bool boxed = false);
+
+/**
+ * Quantum Fourier transform from H and CU1 gates.
+ *
+ * With \p max_distance nonzero this is the approximate QFT, which omits the
+ * controlled rotations between qubits more than \p max_distance apart, so
+ * that the gate count is linear rather than quadratic in \p n_qubits.
+ *
+ * @param n_qubits number of qubits
+ * @param max_distance largest distance between the qubits of a CU1, or 0
+ *   for the exact transform
+ * @param swaps whether to reverse the qubit order with SWAP gates at the end
+ */
+Circuit qft_circuit(
+    unsigned n_qubits, unsigned max_distance = 0, bool swaps = true);
+
+/**
+ * Cuccaro ripple-carry adder from CX and CCX gates.
+ *
+ * Acts on 2 * n_bits + 2 qubits: qubit 0 is the carry in, qubits 1 to n_bits
+ * hold a, the next n_bits qubits hold b, and the last qubit receives the
+ * carry out. The sum a + b (plus carry in) replaces b, little-endian.
+ *
+ * @param n_bits number of bits in each summand
+ */
+Circuit adder_circuit(unsigned n_bits);
+
+}  // namespace workloads
+}  // namespace tket